@@ -0,0 +1,348 @@
+"""This file contains compile-time benchmarks for the core passes, the parser
+and the bytecode, on synthetic IR that stresses their scaling: deep loop nests,
+wide functions, large constants, many symbols, many stack slots and many PDL
+patterns.
+
+These are python benchmarks from the point of view of MBR: they have no
+`compiler` function, and each runner returns the time taken by one run of the
+measured step, excluding the generation and the parsing of its input IR. Each
+runner also records the peak resident memory of the process after the run, in
+its `peak_memory_bytes` attribute.
+"""
+import io
+import resource
+import sys
+import time
+
+from mlir import ir
+from mlir.passmanager import PassManager
+
+
+def generate_deep_nest(depth):
+    """Returns a function with `depth` nested scf.for loops, each of which
+    computes an index with redundant arith ops.
+    """
+    lines = ["func.func @deep_nest(%n: index, %buf: memref<?xindex>) {"]
+    lines.append("  %c0 = arith.constant 0 : index")
+    lines.append("  %c1 = arith.constant 1 : index")
+    for i in range(depth):
+        indent = "  " * (i + 1)
+        lines.append(f"{indent}scf.for %i{i} = %c0 to %n step %c1 {{")
+        lines.append(f"{indent}  %a{i} = arith.addi %i{i}, %c0 : index")
+        lines.append(f"{indent}  %b{i} = arith.muli %a{i}, %c1 : index")
+        lines.append(f"{indent}  memref.store %b{i}, %buf[%i{i}] : memref<?xindex>")
+    for i in reversed(range(depth)):
+        lines.append("  " * (i + 1) + "}")
+    lines.append("  return")
+    lines.append("}")
+    return "\n".join(lines)
+
+
+def generate_wide_function(width):
+    """Returns a function with `width` independent chains of arith ops, half of
+    which are duplicates of the other half.
+    """
+    lines = ["func.func @wide(%x: i64, %y: i64) -> i64 {"]
+    lines.append("  %acc0 = arith.constant 0 : i64")
+    for i in range(width):
+        operand = "%x" if i % 2 == 0 else "%y"
+        lines.append(f"  %c{i} = arith.constant {i // 2} : i64")
+        lines.append(f"  %m{i} = arith.muli {operand}, %c{i} : i64")
+        lines.append(f"  %s{i} = arith.addi %m{i}, %c{i} : i64")
+        lines.append(f"  %acc{i + 1} = arith.xori %acc{i}, %s{i} : i64")
+    lines.append(f"  return %acc{width} : i64")
+    lines.append("}")
+    return "\n".join(lines)
+
+
+def generate_wide_loop(width):
+    """Returns a function with a loop whose body holds `width` chains of arith
+    ops depending on the induction variable, none of which can be hoisted.
+    """
+    lines = ["func.func @wide_loop(%n: index, %buf: memref<?xindex>) {"]
+    lines.append("  %c0 = arith.constant 0 : index")
+    lines.append("  %c1 = arith.constant 1 : index")
+    lines.append("  scf.for %i = %c0 to %n step %c1 {")
+    for i in range(width):
+        lines.append(f"    %a{i} = arith.addi %i, %c1 : index")
+        lines.append(f"    %m{i} = arith.muli %a{i}, %i : index")
+        lines.append(f"    memref.store %m{i}, %buf[%a{i}] : memref<?xindex>")
+    lines.append("  }")
+    lines.append("  return")
+    lines.append("}")
+    return "\n".join(lines)
+
+
+def generate_huge_constant(num_elements):
+    """Returns a function computing on a dense constant of `num_elements`
+    distinct elements.
+    """
+    values = ", ".join(str(i % 1000) for i in range(num_elements))
+    tensor_type = f"tensor<{num_elements}xi32>"
+    return "\n".join(
+        [
+            f"func.func @huge_constant() -> {tensor_type} {{",
+            f"  %cst = arith.constant dense<[{values}]> : {tensor_type}",
+            f"  %sum = arith.addi %cst, %cst : {tensor_type}",
+            f"  return %sum : {tensor_type}",
+            "}",
+        ]
+    )
+
+
+def generate_many_symbols(num_symbols):
+    """Returns `num_symbols` private functions, each calling the previous one,
+    and a public entry point calling the last one.
+    """
+    lines = [
+        "func.func private @f0(%x: i64) -> i64 {",
+        "  return %x : i64",
+        "}",
+    ]
+    for i in range(1, num_symbols):
+        lines.append(f"func.func private @f{i}(%x: i64) -> i64 {{")
+        lines.append(f"  %c = arith.constant {i} : i64")
+        lines.append(f"  %y = arith.addi %x, %c : i64")
+        lines.append(f"  %r = call @f{i - 1}(%y) : (i64) -> i64")
+        lines.append("  return %r : i64")
+        lines.append("}")
+    lines.append("func.func @main(%x: i64) -> i64 {")
+    lines.append(f"  %r = call @f{num_symbols - 1}(%x) : (i64) -> i64")
+    lines.append("  return %r : i64")
+    lines.append("}")
+    return "\n".join(lines)
+
+
+def generate_many_allocas(num_slots):
+    """Returns an LLVM function with `num_slots` stack slots, each of which is
+    conditionally stored to in one of a chain of `num_slots` diamonds and loaded
+    from at the join of its diamond. This is the shape of the functions imported
+    from frontends that spill every local variable.
+    """
+    lines = ["llvm.func @many_allocas(%cond: i1, %x: i32) -> i32 {"]
+    lines.append("  %one = llvm.mlir.constant(1 : i32) : i32")
+    lines.append("  %acc = llvm.alloca %one x i32 : (i32) -> !llvm.ptr")
+    for i in range(num_slots):
+        lines.append(f"  %a{i} = llvm.alloca %one x i32 : (i32) -> !llvm.ptr")
+        lines.append(f"  llvm.store %one, %a{i} : i32, !llvm.ptr")
+    lines.append("  llvm.store %x, %acc : i32, !llvm.ptr")
+    lines.append("  llvm.br ^d0")
+    for i in range(num_slots):
+        lines.append(f"^d{i}:")
+        lines.append(f"  llvm.cond_br %cond, ^t{i}, ^j{i}")
+        lines.append(f"^t{i}:")
+        lines.append(f"  llvm.store %x, %a{i} : i32, !llvm.ptr")
+        lines.append(f"  llvm.br ^j{i}")
+        lines.append(f"^j{i}:")
+        lines.append(f"  %l{i} = llvm.load %a{i} : !llvm.ptr -> i32")
+        lines.append(f"  %p{i} = llvm.load %acc : !llvm.ptr -> i32")
+        lines.append(f"  %s{i} = llvm.add %p{i}, %l{i} : i32")
+        lines.append(f"  llvm.store %s{i}, %acc : i32, !llvm.ptr")
+        lines.append(f"  llvm.br ^d{i + 1}")
+    lines.append(f"^d{num_slots}:")
+    lines.append("  %r = llvm.load %acc : !llvm.ptr -> i32")
+    lines.append("  llvm.return %r : i32")
+    lines.append("}")
+    return "\n".join(lines)
+
+
+def generate_pdl_patterns(num_patterns, num_roots):
+    """Returns `num_patterns` PDL patterns matching one of `num_roots` root
+    operations fed by a producer, with overlapping attribute and producer
+    checks. This is the shape of the pattern sets written in PDLL for a dialect
+    with many canonicalizations.
+    """
+    lines = []
+    for i in range(num_patterns):
+        lines.append("pdl.pattern : benefit(1) {")
+        lines.append("  %attr = attribute")
+        lines.append("  %type = type")
+        lines.append("  %input = operand")
+        lines.append(
+            f'  %producer = operation "test.producer{i % 7}"'
+            "(%input : !pdl.value) -> (%type : !pdl.type)"
+        )
+        lines.append("  %value = result 0 of %producer")
+        lines.append(
+            f'  %root = operation "test.op{i % num_roots}"'
+            f'(%value : !pdl.value) {{"attr{i % 5}" = %attr}}'
+        )
+        lines.append('  rewrite %root with "rewriter"')
+        lines.append("}")
+    return "\n".join(lines)
+
+
+def get_peak_memory_bytes():
+    """Returns the peak resident memory of the process, in bytes."""
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    # The peak is reported in bytes on macOS, and in kilobytes elsewhere.
+    return peak if sys.platform == "darwin" else peak * 1024
+
+
+def create_pass_runner(asm, pipeline):
+    """Returns an MBR runner timing one run of `pipeline` on a fresh module
+    parsed from `asm`.
+    """
+
+    def runner():
+        with ir.Context() as ctx:
+            module = ir.Module.parse(asm)
+            pm = PassManager.parse(pipeline)
+            start_time = time.perf_counter_ns()
+            pm.run(module.operation)
+            elapsed = time.perf_counter_ns() - start_time
+        runner.peak_memory_bytes = get_peak_memory_bytes()
+        return elapsed
+
+    return runner
+
+
+def create_pdl_runner(asm):
+    """Returns an MBR runner timing the conversion of the PDL patterns of `asm`
+    to their matcher. The runner also records the number of PDL interpreter ops
+    generated, which bounds the number of instructions the bytecode executes to
+    match an op, in its `num_matcher_ops` attribute.
+    """
+    pipeline = "builtin.module(convert-pdl-to-pdl-interp)"
+    with ir.Context():
+        module = ir.Module.parse(asm)
+        PassManager.parse(pipeline).run(module.operation)
+        num_matcher_ops = str(module).count("pdl_interp.")
+
+    runner = create_pass_runner(asm, pipeline)
+    runner.num_matcher_ops = num_matcher_ops
+    return runner
+
+
+def create_parser_runner(asm, use_bytecode):
+    """Returns an MBR runner timing the parsing of `asm`, from its textual form
+    or from its bytecode.
+    """
+    with ir.Context():
+        module = ir.Module.parse(asm)
+        if use_bytecode:
+            stream = io.BytesIO()
+            module.operation.write_bytecode(stream)
+            source = stream.getvalue()
+        else:
+            source = str(module)
+
+    def runner():
+        with ir.Context():
+            start_time = time.perf_counter_ns()
+            ir.Module.parse(source)
+            elapsed = time.perf_counter_ns() - start_time
+        runner.peak_memory_bytes = get_peak_memory_bytes()
+        return elapsed
+
+    return runner
+
+
+FUNC_PIPELINE = "builtin.module(func.func({}))"
+LLVM_PIPELINE = (
+    "builtin.module(convert-scf-to-cf,finalize-memref-to-llvm,"
+    "convert-arith-to-llvm,convert-func-to-llvm,reconcile-unrealized-casts)"
+)
+
+
+def benchmark_canonicalize_deep_nest():
+    """Benchmark for the canonicalizer on a deep loop nest."""
+    return None, create_pass_runner(
+        generate_deep_nest(200), FUNC_PIPELINE.format("canonicalize")
+    )
+
+
+def benchmark_canonicalize_wide_function():
+    """Benchmark for the canonicalizer on a wide function."""
+    return None, create_pass_runner(
+        generate_wide_function(20000), FUNC_PIPELINE.format("canonicalize")
+    )
+
+
+def benchmark_cse_wide_function():
+    """Benchmark for CSE on a wide function."""
+    return None, create_pass_runner(
+        generate_wide_function(20000), FUNC_PIPELINE.format("cse")
+    )
+
+
+def benchmark_cse_deep_nest():
+    """Benchmark for CSE on a deep loop nest."""
+    return None, create_pass_runner(
+        generate_deep_nest(200), FUNC_PIPELINE.format("cse")
+    )
+
+
+def benchmark_licm_wide_loop():
+    """Benchmark for the loop invariant code motion of a wide loop body. The
+    pass mostly queries the side-effect and speculation interfaces of the ops,
+    which makes it a benchmark of the interface dispatch.
+    """
+    return None, create_pass_runner(
+        generate_wide_loop(20000),
+        FUNC_PIPELINE.format("loop-invariant-code-motion"),
+    )
+
+
+def benchmark_inline_many_symbols():
+    """Benchmark for the inliner on a long chain of calls."""
+    return None, create_pass_runner(
+        generate_many_symbols(2000), "builtin.module(inline)"
+    )
+
+
+def benchmark_symbol_dce_many_symbols():
+    """Benchmark for the symbol DCE on many unreferenced symbols."""
+    return None, create_pass_runner(
+        generate_many_symbols(5000), "builtin.module(inline,symbol-dce)"
+    )
+
+
+def benchmark_mem2reg_many_allocas():
+    """Benchmark for mem2reg on a large CFG with many stack slots."""
+    return None, create_pass_runner(
+        generate_many_allocas(2000), "builtin.module(llvm.func(mem2reg))"
+    )
+
+
+def benchmark_pdl_to_pdl_interp_many_patterns():
+    """Benchmark for the generation of the matcher of a large pattern set."""
+    return None, create_pdl_runner(generate_pdl_patterns(500, 50))
+
+
+def benchmark_one_shot_bufferize_huge_constant():
+    """Benchmark for the one-shot bufferization of a large constant."""
+    return None, create_pass_runner(
+        generate_huge_constant(100000),
+        "builtin.module(one-shot-bufferize{bufferize-function-boundaries})",
+    )
+
+
+def benchmark_convert_to_llvm_deep_nest():
+    """Benchmark for the conversion to the LLVM dialect of a deep nest."""
+    return None, create_pass_runner(generate_deep_nest(200), LLVM_PIPELINE)
+
+
+def benchmark_convert_to_llvm_wide_function():
+    """Benchmark for the conversion to the LLVM dialect of a wide function."""
+    return None, create_pass_runner(generate_wide_function(20000), LLVM_PIPELINE)
+
+
+def benchmark_parse_text_wide_function():
+    """Benchmark for the parsing of the textual form of a wide function."""
+    return None, create_parser_runner(generate_wide_function(20000), False)
+
+
+def benchmark_parse_bytecode_wide_function():
+    """Benchmark for the parsing of the bytecode of a wide function."""
+    return None, create_parser_runner(generate_wide_function(20000), True)
+
+
+def benchmark_parse_text_huge_constant():
+    """Benchmark for the parsing of the textual form of a large constant."""
+    return None, create_parser_runner(generate_huge_constant(100000), False)
+
+
+def benchmark_parse_bytecode_huge_constant():
+    """Benchmark for the parsing of the bytecode of a large constant."""
+    return None, create_parser_runner(generate_huge_constant(100000), True)
@@ -0,0 +1,622 @@
+"""This file contains bandwidth benchmarks for the code generated by the sparse
+compiler. It runs a corpus of standard sparse kernels (SpMV, SpMM, SDDMM,
+SpGEMM and MTTKRP) for each of the CSR, DCSR and COO storage formats, both
+sequentially and with OpenMP on a range of thread counts, next to a STREAM
+triad that serves as the bandwidth baseline for each of those configurations.
+
+Besides timing, each runner records the number of bytes moved by one
+measurement in its `bytes_moved` attribute, from which MBR computes the
+achieved bandwidth and reports it relative to the STREAM baseline of the same
+`roofline_group`. The bytes moved are the compulsory traffic of the kernel:
+every storage array of the sparse operands and every dense input is read
+once, and every output is read once and written once.
+
+The OpenMP benchmarks need the `MLIR_OPENMP_RUNTIME` environment variable to
+point to the OpenMP runtime library, in addition to `MLIR_C_RUNNER_UTILS` and
+`MLIR_RUNNER_UTILS`.
+
+When the `MLIR_CUDA_RUNTIME` environment variable points to the CUDA runtime
+wrappers, the CSR SpMV and SpMM are also benchmarked with the direct GPU code
+generation, once for each mapping of the rows onto the GPU threads. These
+configurations have no STREAM baseline, and their timings include the copies
+between the host and the device.
+
+The conversions between sparse storage formats by the runtime library, such as
+the CSR to CSC transpose, are benchmarked for each of the strategies of the
+sparse compiler: through an intermediate COO tensor, and directly. These have
+no STREAM baseline either, as the runtime library picks its own number of
+threads.
+"""
+import ctypes
+import os
+
+import numpy as np
+
+from mlir import ir
+from mlir import runtime as rt
+from mlir.execution_engine import ExecutionEngine
+
+from common import create_random_sparse_np_tensor
+from common import get_shared_libs
+from common import setup_passes
+
+# The number of back-to-back kernel invocations timed by one measurement.
+# The sparse operands are converted from their dense numpy form on each call
+# of the compiled program, so this amortizes that conversion over enough
+# kernel invocations.
+KERNEL_ITERATIONS = 100
+
+# The sizes of the values and of the positions/coordinates, in bytes.
+VALUE_BYTES = 8
+INDEX_BYTES = 8
+
+# The number of elements of each STREAM triad array.
+STREAM_ARRAY_SIZE = 1 << 23
+
+# The storage formats, as functions from the rank of the tensor to its level
+# types.
+ENCODINGS = {
+    "csr": lambda rank: ["dense"] + ["compressed"] * (rank - 1),
+    "dcsr": lambda rank: ["compressed"] * rank,
+    "coo": lambda rank: ["compressed-nu"]
+    + ["singleton-nu"] * (rank - 2)
+    + ["singleton"],
+}
+
+SERIAL_OPTIONS = "parallelization-strategy=none"
+OPENMP_OPTIONS = (
+    "parallelization-strategy=any-storage-outer-loop"
+    " parallelization-backend=openmp"
+)
+GPU_OPTIONS = (
+    "parallelization-strategy=dense-outer-loop enable-runtime-library=false"
+    " gpu-triple=nvptx64-nvidia-cuda gpu-chip=sm_80 gpu-features=+ptx71"
+)
+
+# The mappings of the rows onto the GPU threads, and the kernels and storage
+# formats for which the direct GPU code generation applies.
+GPU_ROW_MAPPINGS = ["thread-per-row", "warp-per-row", "merge-path"]
+GPU_KERNELS = {("spmv", "csr"), ("spmm", "csr")}
+
+
+def get_thread_configs():
+    """Returns the `(name, number of threads, sparse compiler options, runtime
+    library environment variables)` of the CPU configurations to benchmark.
+    The number of threads is `None` for the sequential code, which does not
+    depend on the OpenMP runtime library.
+    """
+    num_cpus = os.cpu_count() or 1
+    thread_counts = sorted(
+        {1 << i for i in range(num_cpus.bit_length()) if 1 << i <= num_cpus}
+        | {num_cpus}
+    )
+    configs = [("serial", None, SERIAL_OPTIONS, [])]
+    for num_threads in thread_counts:
+        configs.append(
+            (f"omp{num_threads}", num_threads, OPENMP_OPTIONS, ["MLIR_OPENMP_RUNTIME"])
+        )
+    return configs
+
+
+def get_gpu_configs():
+    """Returns the GPU configurations to benchmark, in the same form as those
+    of `get_thread_configs`, or none when the CUDA runtime is not available.
+    """
+    if not os.getenv("MLIR_CUDA_RUNTIME"):
+        return []
+    return [
+        (
+            f"gpu_{mapping.replace('-', '_')}",
+            None,
+            f"{GPU_OPTIONS} gpu-row-mapping={mapping}",
+            ["MLIR_CUDA_RUNTIME"],
+        )
+        for mapping in GPU_ROW_MAPPINGS
+    ]
+
+
+class Kernel:
+    """A sparse kernel expressed as a `linalg.generic` operation on the
+    tensors `%arg0, %arg1, ...`, of which those with `density` set are sparse.
+    The region `body` computes `%res` from the block arguments `%in0, %in1,
+    ...` and `%out`. The output is sparse, with the same encoding as the
+    sparse operands, if `sparse_output` is set, and dense otherwise.
+    """
+
+    def __init__(
+        self, name, operands, output_shape, maps, iterators, body, sparse_output
+    ):
+        self.name = name
+        # A list of `(shape, density)`, with a `None` density if dense.
+        self.operands = operands
+        self.output_shape = output_shape
+        self.maps = maps
+        self.iterators = iterators
+        self.body = body
+        self.sparse_output = sparse_output
+
+    def rank(self):
+        return max(len(shape) for shape, density in self.operands if density)
+
+
+KERNELS = [
+    Kernel(
+        "spmv",
+        [([4096, 4096], 0.01), ([4096], None)],
+        [4096],
+        ["(i,j) -> (i,j)", "(i,j) -> (j)", "(i,j) -> (i)"],
+        ["parallel", "reduction"],
+        ["%0 = arith.mulf %in0, %in1 : f64", "%res = arith.addf %out, %0 : f64"],
+        sparse_output=False,
+    ),
+    Kernel(
+        "spmm",
+        [([2048, 2048], 0.01), ([2048, 64], None)],
+        [2048, 64],
+        ["(i,j,k) -> (i,k)", "(i,j,k) -> (k,j)", "(i,j,k) -> (i,j)"],
+        ["parallel", "parallel", "reduction"],
+        ["%0 = arith.mulf %in0, %in1 : f64", "%res = arith.addf %out, %0 : f64"],
+        sparse_output=False,
+    ),
+    Kernel(
+        "sddmm",
+        [([2048, 2048], 0.01), ([2048, 64], None), ([64, 2048], None)],
+        [2048, 2048],
+        [
+            "(i,j,k) -> (i,j)",
+            "(i,j,k) -> (i,k)",
+            "(i,j,k) -> (k,j)",
+            "(i,j,k) -> (i,j)",
+        ],
+        ["parallel", "parallel", "reduction"],
+        [
+            "%0 = arith.mulf %in1, %in2 : f64",
+            "%1 = arith.mulf %in0, %0 : f64",
+            "%res = arith.addf %out, %1 : f64",
+        ],
+        sparse_output=False,
+    ),
+    Kernel(
+        "spgemm",
+        [([1024, 1024], 0.01), ([1024, 1024], 0.01)],
+        [1024, 1024],
+        ["(i,j,k) -> (i,k)", "(i,j,k) -> (k,j)", "(i,j,k) -> (i,j)"],
+        ["parallel", "parallel", "reduction"],
+        ["%0 = arith.mulf %in0, %in1 : f64", "%res = arith.addf %out, %0 : f64"],
+        sparse_output=True,
+    ),
+    Kernel(
+        "mttkrp",
+        [([128, 128, 128], 0.01), ([128, 32], None), ([128, 32], None)],
+        [128, 32],
+        [
+            "(i,j,k,l) -> (i,k,l)",
+            "(i,j,k,l) -> (k,j)",
+            "(i,j,k,l) -> (l,j)",
+            "(i,j,k,l) -> (i,j)",
+        ],
+        ["parallel", "parallel", "reduction", "reduction"],
+        [
+            "%0 = arith.mulf %in0, %in1 : f64",
+            "%1 = arith.mulf %in2, %0 : f64",
+            "%res = arith.addf %out, %1 : f64",
+        ],
+        sparse_output=False,
+    ),
+]
+
+# Inserting into unordered levels is not supported, so there is no SpGEMM
+# with a COO output.
+UNSUPPORTED = {("spgemm", "coo")}
+
+# The sparse compiler options selecting each of the strategies of the
+# conversions between sparse tensors, all of which use the runtime library.
+S2S_STRATEGIES = {
+    "via_coo": "enable-runtime-library=true s2s-strategy=1",
+    "direct": "enable-runtime-library=true s2s-strategy=2",
+}
+
+# The conversions between sparse storage formats, as `(name, shape, density,
+# source level types, target level types, target dimToLvl map)`.
+CONVERSIONS = [
+    (
+        "csr_to_csc",
+        [4096, 4096],
+        0.01,
+        ["dense", "compressed"],
+        ["dense", "compressed"],
+        "(i,j) -> (j,i)",
+    ),
+]
+
+
+def tensor_type(shape, encoding=None):
+    """Returns the textual tensor type of f64 with the given `shape`."""
+    dims = "x".join(str(dim) for dim in shape)
+    return f"tensor<{dims}xf64{', #' + encoding if encoding else ''}>"
+
+
+def emit_kernel_module(kernel, lvl_types):
+    """Returns the textual module of a `main` function that converts the
+    sparse operands of `kernel` to the storage format with levels `lvl_types`
+    and then invokes the kernel once per element of its trailing timer buffer,
+    storing the nanoseconds taken by each invocation in it.
+    """
+    enc = "ENC"
+    operand_types = [
+        tensor_type(shape, enc if density else None)
+        for shape, density in kernel.operands
+    ]
+    out_type = tensor_type(kernel.output_shape, enc if kernel.sparse_output else None)
+    ins = ", ".join(f"%arg{i}" for i in range(len(kernel.operands)))
+    args = ", ".join(f"%arg{i}: {tp}" for i, tp in enumerate(operand_types))
+    block_args = ", ".join(f"%in{i}: f64" for i in range(len(kernel.operands)))
+    maps = ", ".join(f"affine_map<{m}>" for m in kernel.maps)
+    iterators = ", ".join(f'"{it}"' for it in kernel.iterators)
+    body = "\n        ".join(kernel.body)
+    quoted_lvl_types = ", ".join(f'"{lt}"' for lt in lvl_types)
+
+    # A sparse output is allocated by the kernel, a dense one is passed in.
+    if kernel.sparse_output:
+        kernel_args = args
+        init = f"%init = bufferization.alloc_tensor() : {out_type}"
+    else:
+        kernel_args = f"{args}, %init: {out_type}"
+        init = ""
+
+    # The main function takes the sparse operands in dense form.
+    main_args = ", ".join(
+        f"%dense{i}: {tensor_type(shape)}"
+        for i, (shape, _) in enumerate(kernel.operands)
+    )
+    # Only the sparse operands are converted, the dense ones are forwarded.
+    converts = "\n  ".join(
+        f"%arg{i} = sparse_tensor.convert %dense{i} : "
+        f"{tensor_type(shape)} to {operand_types[i]}"
+        for i, (shape, density) in enumerate(kernel.operands)
+        if density
+    )
+    call_args = ", ".join(
+        f"%arg{i}" if density else f"%dense{i}"
+        for i, (_, density) in enumerate(kernel.operands)
+    )
+    call_types = ", ".join(operand_types)
+    deallocs = "\n  ".join(
+        f"bufferization.dealloc_tensor %arg{i} : {operand_types[i]}"
+        for i, (_, density) in enumerate(kernel.operands)
+        if density
+    )
+
+    if kernel.sparse_output:
+        main_sig = f"({main_args}, %timers: memref<?xi64>)"
+        loop = f"""scf.for %iv = %c0 to %n step %c1 {{
+    %t0 = func.call @nanoTime() : () -> i64
+    %r = func.call @kernel({call_args}) : ({call_types}) -> {out_type}
+    %t1 = func.call @nanoTime() : () -> i64
+    %t = arith.subi %t1, %t0 : i64
+    memref.store %t, %timers[%iv] : memref<?xi64>
+    bufferization.dealloc_tensor %r : {out_type}
+  }}"""
+        ret = "return"
+    else:
+        main_sig = (
+            f"({main_args}, %out: {out_type}, %timers: memref<?xi64>)"
+            f" -> {out_type}"
+        )
+        loop = f"""%res = scf.for %iv = %c0 to %n step %c1
+      iter_args(%acc = %out) -> ({out_type}) {{
+    %t0 = func.call @nanoTime() : () -> i64
+    %r = func.call @kernel({call_args}, %acc)
+        : ({call_types}, {out_type}) -> {out_type}
+    %t1 = func.call @nanoTime() : () -> i64
+    %t = arith.subi %t1, %t0 : i64
+    memref.store %t, %timers[%iv] : memref<?xi64>
+    scf.yield %r : {out_type}
+  }}"""
+        ret = f"return %res : {out_type}"
+
+    return f"""
+#{enc} = #sparse_tensor.encoding<{{ lvlTypes = [ {quoted_lvl_types} ] }}>
+
+func.func private @nanoTime() -> i64 attributes {{llvm.emit_c_interface}}
+
+func.func @kernel({kernel_args}) -> {out_type} {{
+  {init}
+  %0 = linalg.generic {{
+      indexing_maps = [{maps}],
+      iterator_types = [{iterators}]}}
+      ins({ins} : {call_types}) outs(%init : {out_type}) {{
+    ^bb0({block_args}, %out: f64):
+        {body}
+        linalg.yield %res : f64
+  }} -> {out_type}
+  return %0 : {out_type}
+}}
+
+func.func @main{main_sig} attributes {{llvm.emit_c_interface}} {{
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %n = memref.dim %timers, %c0 : memref<?xi64>
+  {converts}
+  {loop}
+  {deallocs}
+  {ret}
+}}
+"""
+
+
+def emit_stream_triad_module():
+    """Returns the textual module of a `main` function that runs the STREAM
+    triad `a(i) = b(i) + 3 * c(i)` once per element of its trailing timer
+    buffer, storing the nanoseconds taken by each run in it. The loop is an
+    `scf.parallel`, like the loops that the sparse compiler parallelizes, so
+    that it goes through the same parallelization backend.
+    """
+    memref_type = f"memref<{STREAM_ARRAY_SIZE}xf64>"
+    return f"""
+func.func private @nanoTime() -> i64 attributes {{llvm.emit_c_interface}}
+
+func.func @main(%a: {memref_type}, %b: {memref_type}, %c: {memref_type},
+                %timers: memref<?xi64>) attributes {{llvm.emit_c_interface}} {{
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %size = arith.constant {STREAM_ARRAY_SIZE} : index
+  %scalar = arith.constant 3.0 : f64
+  %n = memref.dim %timers, %c0 : memref<?xi64>
+  scf.for %iv = %c0 to %n step %c1 {{
+    %t0 = func.call @nanoTime() : () -> i64
+    scf.parallel (%i) = (%c0) to (%size) step (%c1) {{
+      %bi = memref.load %b[%i] : {memref_type}
+      %ci = memref.load %c[%i] : {memref_type}
+      %0 = arith.mulf %scalar, %ci : f64
+      %1 = arith.addf %bi, %0 : f64
+      memref.store %1, %a[%i] : {memref_type}
+    }}
+    %t1 = func.call @nanoTime() : () -> i64
+    %t = arith.subi %t1, %t0 : i64
+    memref.store %t, %timers[%iv] : memref<?xi64>
+  }}
+  return
+}}
+"""
+
+
+def emit_conversion_module(shape, src_lvl_types, dst_lvl_types, dst_dim_to_lvl):
+    """Returns the textual module of a `main` function that converts its
+    dense argument to the source storage format, and then converts that to
+    the target storage format once per element of its trailing timer buffer,
+    storing the nanoseconds taken by each conversion in it.
+    """
+    src_type = tensor_type(shape, "SRC")
+    dst_type = tensor_type(shape, "DST")
+    quoted_src = ", ".join(f'"{lt}"' for lt in src_lvl_types)
+    quoted_dst = ", ".join(f'"{lt}"' for lt in dst_lvl_types)
+    return f"""
+#SRC = #sparse_tensor.encoding<{{ lvlTypes = [ {quoted_src} ] }}>
+#DST = #sparse_tensor.encoding<{{
+  lvlTypes = [ {quoted_dst} ],
+  dimToLvl = affine_map<{dst_dim_to_lvl}>
+}}>
+
+func.func private @nanoTime() -> i64 attributes {{llvm.emit_c_interface}}
+
+func.func @main(%dense: {tensor_type(shape)}, %timers: memref<?xi64>)
+    attributes {{llvm.emit_c_interface}} {{
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %n = memref.dim %timers, %c0 : memref<?xi64>
+  %src = sparse_tensor.convert %dense : {tensor_type(shape)} to {src_type}
+  scf.for %iv = %c0 to %n step %c1 {{
+    %t0 = func.call @nanoTime() : () -> i64
+    %dst = sparse_tensor.convert %src : {src_type} to {dst_type}
+    %t1 = func.call @nanoTime() : () -> i64
+    %t = arith.subi %t1, %t0 : i64
+    memref.store %t, %timers[%iv] : memref<?xi64>
+    bufferization.dealloc_tensor %dst : {dst_type}
+  }}
+  bufferization.dealloc_tensor %src : {src_type}
+  return
+}}
+"""
+
+
+def sparse_storage_bytes(lvl_types, tensor):
+    """Returns the number of bytes of the storage arrays of the numpy tensor
+    `tensor` in the storage format with levels `lvl_types`.
+    """
+    coordinates = np.transpose(np.nonzero(tensor))
+    nse = len(coordinates)
+    num_bytes = nse * VALUE_BYTES
+    parent_size = 1
+    for lvl, lvl_type in enumerate(lvl_types):
+        if lvl_type == "dense":
+            parent_size *= tensor.shape[lvl]
+            continue
+        if lvl_type == "compressed":
+            size = len(np.unique(coordinates[:, : lvl + 1], axis=0))
+        else:
+            size = nse
+        if lvl_type.startswith("compressed"):
+            num_bytes += (parent_size + 1) * INDEX_BYTES
+        num_bytes += size * INDEX_BYTES
+        parent_size = size
+    return num_bytes
+
+
+def get_memref_args(arrays):
+    """Returns the arguments for passing the numpy `arrays` as memrefs."""
+    return [
+        ctypes.pointer(ctypes.pointer(rt.get_ranked_memref_descriptor(array)))
+        for array in arrays
+    ]
+
+
+def make_compiler(module_str, num_threads, options, runtime_env_vars):
+    """Returns a compiler of the textual module `module_str` with the sparse
+    compiler `options`. The compiled program is linked against the runtime
+    libraries named by `runtime_env_vars`. When `num_threads` is set, the
+    last of these is the OpenMP runtime library, and the returned callable
+    invokes the program on `num_threads` threads.
+    """
+
+    def compiler():
+        with ir.Context(), ir.Location.unknown():
+            module = ir.Module.parse(module_str)
+            setup_passes(module, options)
+            env_vars = ["MLIR_C_RUNNER_UTILS", "MLIR_RUNNER_UTILS"]
+            env_vars += runtime_env_vars
+            shared_libs = get_shared_libs(env_vars)
+            engine = ExecutionEngine(module, 3, shared_libs=shared_libs)
+        if not num_threads:
+            return engine.invoke
+        # The library is already loaded by the execution engine, so this
+        # returns the same instance of it.
+        openmp = ctypes.CDLL(shared_libs[-1], mode=ctypes.RTLD_GLOBAL)
+
+        def invoke(*args):
+            openmp.omp_set_num_threads(num_threads)
+            return engine.invoke(*args)
+
+        return invoke
+
+    return compiler
+
+
+def make_runner(arguments, bytes_moved, roofline_group):
+    """Returns a runner that invokes the compiled `main` function on the
+    memrefs `arguments`, followed by a timer buffer, and returns the total
+    nanoseconds taken by the `KERNEL_ITERATIONS` timed invocations.
+    """
+
+    def runner(engine_invoke):
+        timers_ns = np.zeros(KERNEL_ITERATIONS, dtype=np.int64)
+        engine_invoke("main", *get_memref_args(arguments + [timers_ns]))
+        return int(np.sum(timers_ns))
+
+    runner.bytes_moved = bytes_moved * KERNEL_ITERATIONS
+    runner.roofline_group = roofline_group
+    return runner
+
+
+def make_kernel_benchmark(name, kernel, encoding, config):
+    """Returns the benchmark function `name` for `kernel` in `encoding` and
+    the thread configuration `config`.
+    """
+    config_name, num_threads, options, runtime_env_vars = config
+
+    def benchmark():
+        lvl_types = ENCODINGS[encoding](kernel.rank())
+        rng = np.random.default_rng(0)
+        operands = []
+        bytes_moved = 0
+        for shape, density in kernel.operands:
+            if density:
+                operand = create_random_sparse_np_tensor(shape, density, rng)
+                bytes_moved += sparse_storage_bytes(lvl_types, operand)
+            else:
+                operand = rng.uniform(1, 100, shape)
+                bytes_moved += operand.size * VALUE_BYTES
+            operands.append(operand)
+        if kernel.sparse_output:
+            # Only the nonzero structure of the product matters here.
+            output = np.matmul(operands[0] != 0.0, operands[1] != 0.0, dtype=np.float64)
+            bytes_moved += 2 * sparse_storage_bytes(lvl_types, output)
+            arguments = operands
+        else:
+            output = np.zeros(kernel.output_shape, np.float64)
+            bytes_moved += 2 * output.size * VALUE_BYTES
+            # The memref of the result comes first.
+            arguments = [output] + operands + [output]
+        module_str = emit_kernel_module(kernel, lvl_types)
+        compiler = make_compiler(module_str, num_threads, options, runtime_env_vars)
+        return compiler, make_runner(arguments, bytes_moved, config_name)
+
+    benchmark.__name__ = name
+    benchmark.__qualname__ = name
+    return benchmark
+
+
+def make_conversion_benchmark(name, conversion, options):
+    """Returns the benchmark function `name` for `conversion` with the
+    sparse compiler `options`. The bytes moved are those of the storage of
+    the source, which is read once, and of the target, which is written
+    once.
+    """
+    _, shape, density, src_lvl_types, dst_lvl_types, dst_dim_to_lvl = conversion
+
+    def benchmark():
+        rng = np.random.default_rng(0)
+        dense = create_random_sparse_np_tensor(shape, density, rng)
+        # Both formats of a matrix store the same arrays, only in different
+        # orders of the levels.
+        bytes_moved = sparse_storage_bytes(src_lvl_types, dense)
+        bytes_moved += sparse_storage_bytes(dst_lvl_types, np.transpose(dense))
+        module_str = emit_conversion_module(
+            shape, src_lvl_types, dst_lvl_types, dst_dim_to_lvl
+        )
+        compiler = make_compiler(module_str, None, options, [])
+        return compiler, make_runner([dense], bytes_moved, None)
+
+    benchmark.__name__ = name
+    benchmark.__qualname__ = name
+    return benchmark
+
+
+def make_stream_benchmark(name, config):
+    """Returns the STREAM triad benchmark function `name` for the thread
+    configuration `config`, which is the bandwidth baseline of that
+    configuration.
+    """
+    config_name, num_threads, options, runtime_env_vars = config
+
+    def benchmark():
+        rng = np.random.default_rng(0)
+        a = np.zeros(STREAM_ARRAY_SIZE, np.float64)
+        b = rng.uniform(1, 100, STREAM_ARRAY_SIZE)
+        c = rng.uniform(1, 100, STREAM_ARRAY_SIZE)
+        # STREAM counts the triad as reading two arrays and writing one.
+        bytes_moved = 3 * STREAM_ARRAY_SIZE * VALUE_BYTES
+        runner = make_runner([a, b, c], bytes_moved, config_name)
+        runner.roofline_baseline = True
+        compiler = make_compiler(
+            emit_stream_triad_module(), num_threads, options, runtime_env_vars
+        )
+        return compiler, runner
+
+    benchmark.__name__ = name
+    benchmark.__qualname__ = name
+    return benchmark
+
+
+def register_benchmarks():
+    """Defines a module-level benchmark function for each combination of
+    kernel, storage format and thread configuration, and the STREAM triad of
+    each thread configuration, so that MBR discovers them individually. The
+    GPU configurations only cover the kernels in `GPU_KERNELS`. The
+    conversions are defined once for each strategy of `S2S_STRATEGIES`.
+    """
+    for config in get_thread_configs():
+        config_name = config[0]
+        name = f"benchmark_stream_triad_{config_name}"
+        globals()[name] = make_stream_benchmark(name, config)
+        for kernel in KERNELS:
+            for encoding in ENCODINGS:
+                if (kernel.name, encoding) in UNSUPPORTED:
+                    continue
+                name = f"benchmark_{kernel.name}_{encoding}_{config_name}"
+                globals()[name] = make_kernel_benchmark(name, kernel, encoding, config)
+    for config in get_gpu_configs():
+        config_name = config[0]
+        for kernel in KERNELS:
+            for encoding in ENCODINGS:
+                if (kernel.name, encoding) not in GPU_KERNELS:
+                    continue
+                name = f"benchmark_{kernel.name}_{encoding}_{config_name}"
+                globals()[name] = make_kernel_benchmark(name, kernel, encoding, config)
+    for conversion in CONVERSIONS:
+        for strategy, options in S2S_STRATEGIES.items():
+            name = f"benchmark_convert_{conversion[0]}_{strategy}"
+            globals()[name] = make_conversion_benchmark(name, conversion, options)
+
+
+register_benchmarks()
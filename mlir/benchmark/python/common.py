@@ -1,4 +1,6 @@
 """Common utilities that are useful for all the benchmarks."""
+import os
+
 import numpy as np
 
 from mlir import ir
@@ -9,14 +11,27 @@ from mlir.dialects import scf
 from mlir.passmanager import PassManager
 
 
-def setup_passes(mlir_module):
-    """Setup pass pipeline parameters for benchmark functions."""
-    opt = (
-        "parallelization-strategy=none"
-        " vectorization-strategy=none vl=1 enable-simd-index32=False"
-    )
-    pipeline = f"sparse-compiler{{{opt}}}"
-    PassManager.parse(pipeline).run(mlir_module)
+def setup_passes(mlir_module, options="parallelization-strategy=none"):
+    """Setup pass pipeline parameters for benchmark functions. The `options`
+    are passed verbatim to the sparse compiler pipeline.
+    """
+    pipeline = f"builtin.module(sparse-compiler{{{options}}})"
+    PassManager.parse(pipeline).run(mlir_module.operation)
+
+
+def get_shared_libs(env_vars):
+    """Returns the paths of the shared libraries named by the environment
+    variables `env_vars`, asserting that each of them exists.
+    """
+    shared_libs = []
+    for env_var in env_vars:
+        shared_lib = os.getenv(env_var, "")
+        assert os.path.exists(shared_lib), (
+            f"{shared_lib} does not exist."
+            f" Please pass a valid value for {env_var} environment variable."
+        )
+        shared_libs.append(shared_lib)
+    return shared_libs
 
 
 def create_sparse_np_tensor(dimensions, number_of_elements):
@@ -37,6 +52,17 @@ def create_sparse_np_tensor(dimensions, number_of_elements):
     return tensor
 
 
+def create_random_sparse_np_tensor(dimensions, density, rng):
+    """Constructs a numpy tensor of dimensions `dimensions` in which each
+    element is nonzero with probability `density`. Unlike
+    `create_sparse_np_tensor`, this is vectorized, so that it scales to the
+    problem sizes needed for bandwidth measurements, and is deterministic for
+    a given numpy random generator `rng`.
+    """
+    mask = rng.random(dimensions) < density
+    return np.where(mask, rng.uniform(1, 100, dimensions), 0.0)
+
+
 def get_kernel_func_from_module(module: ir.Module) -> func.FuncOp:
     """Takes an mlir module object and extracts the function object out of it.
     This function only works for a module with one region, one block, and one
@@ -16,28 +16,37 @@
 #include "toy/Parser.h"
 #include "toy/Passes.h"
 
+#include "mlir/Bytecode/BytecodeWriter.h"
 #include "mlir/Dialect/Affine/Passes.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/LLVMIR/Transforms/Passes.h"
 #include "mlir/ExecutionEngine/ExecutionEngine.h"
 #include "mlir/ExecutionEngine/OptUtils.h"
 #include "mlir/IR/AsmState.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/IR/Verifier.h"
 #include "mlir/InitAllDialects.h"
 #include "mlir/Parser/Parser.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Pass/PassManager.h"
+#include "mlir/Support/Timing.h"
 #include "mlir/Target/LLVMIR/Dialect/Builtin/BuiltinToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Export.h"
 #include "mlir/Transforms/Passes.h"
 
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_ostream.h"
@@ -85,6 +94,24 @@ static cl::opt<enum Action> emitAction(
 
 static cl::opt<bool> enableOpt("opt", cl::desc("Enable optimizations"));
 
+static cl::opt<std::string> cacheDir(
+    "cache-dir",
+    cl::desc("Cache the module lowered to the LLVM dialect and the code "
+             "generated by the JIT in this directory, and reuse them in the "
+             "next runs"),
+    cl::value_desc("directory"));
+
+static cl::opt<unsigned> jitThreads(
+    "jit-threads",
+    cl::desc("Number of threads generating code in the JIT, 0 generates it "
+             "on the main thread"),
+    cl::init(0));
+
+static cl::opt<bool> benchmark(
+    "benchmark",
+    cl::desc("Report the time spent in each step of the compilation and of "
+             "the execution"));
+
 /// Returns a Toy AST resulting from parsing the file or a nullptr on error.
 std::unique_ptr<toy::ModuleAST> parseInputFile(llvm::StringRef filename) {
   llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> fileOrErr =
@@ -130,19 +157,97 @@ int loadMLIR(mlir::MLIRContext &context,
   return 0;
 }
 
+/// Returns the path of the cache entry holding the module lowered to the LLVM
+/// dialect, or an empty string if the lowered module cannot be cached. The
+/// entries are keyed on the contents of the input file and on the options
+/// affecting the lowering.
+std::string getLoweredModuleCachePath() {
+  // The standard input cannot be read twice, so it is never cached.
+  if (cacheDir.empty() || inputFilename == "-")
+    return "";
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> fileOrErr =
+      llvm::MemoryBuffer::getFile(inputFilename);
+  if (!fileOrErr)
+    return "";
+
+  llvm::SHA1 hasher;
+  hasher.update(LLVM_VERSION_STRING);
+  hasher.update(inputType == InputType::MLIR ? "mlir;" : "toy;");
+  hasher.update(enableOpt ? "opt;" : "noopt;");
+  hasher.update((*fileOrErr)->getBuffer());
+  llvm::SmallString<256> path(cacheDir);
+  llvm::sys::path::append(
+      path, llvm::toHex(hasher.final(), /*LowerCase=*/true) + ".mlirbc");
+  return std::string(path);
+}
+
+/// Loads the lowered module from the cache entry `path`. Returns false if the
+/// entry does not exist or cannot be read, in which case the input is
+/// compiled again.
+bool loadCachedModule(mlir::MLIRContext &context, llvm::StringRef path,
+                      mlir::OwningOpRef<mlir::ModuleOp> &module) {
+  if (!llvm::sys::fs::exists(path))
+    return false;
+
+  // The lowered module only contains operations of the LLVM dialect, which
+  // is not loaded yet since the lowering passes did not run.
+  context.getOrLoadDialect<mlir::LLVM::LLVMDialect>();
+  mlir::ScopedDiagnosticHandler silenceErrors(
+      &context, [](mlir::Diagnostic &) { return mlir::success(); });
+  module = mlir::parseSourceFile<mlir::ModuleOp>(path, &context);
+  return static_cast<bool>(module);
+}
+
+/// Stores the lowered module in the cache entry `path`. Failing to do so is
+/// not fatal: the next run will simply compile the input again.
+void storeCachedModule(mlir::ModuleOp module, llvm::StringRef path) {
+  std::error_code ec = llvm::sys::fs::create_directories(cacheDir);
+  // The output is written to a temporary file and then renamed, so that
+  // concurrent runs never observe a partially written entry.
+  llvm::Error error =
+      ec ? llvm::errorCodeToError(ec)
+         : llvm::writeToOutput(path, [&](llvm::raw_ostream &os) -> llvm::Error {
+             if (mlir::failed(mlir::writeBytecodeToFile(module, os)))
+               return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                              "failed to emit bytecode");
+             return llvm::Error::success();
+           });
+  if (error)
+    llvm::errs() << "Could not cache the lowered module in " << path << ": "
+                 << llvm::toString(std::move(error)) << "\n";
+}
+
 int loadAndProcessMLIR(mlir::MLIRContext &context,
-                       mlir::OwningOpRef<mlir::ModuleOp> &module) {
+                       mlir::OwningOpRef<mlir::ModuleOp> &module,
+                       mlir::TimingScope &timing) {
+  // Check to see what granularity of MLIR we are compiling to.
+  bool isLoweringToAffine = emitAction >= Action::DumpMLIRAffine;
+  bool isLoweringToLLVM = emitAction >= Action::DumpMLIRLLVM;
+
+  // Reuse the module lowered to the LLVM dialect by a previous run if any,
+  // which skips both the parser and the pass pipeline.
+  std::string cachePath;
+  if (isLoweringToLLVM)
+    cachePath = getLoweredModuleCachePath();
+  if (!cachePath.empty()) {
+    mlir::TimingScope cacheTiming = timing.nest("Load cached module");
+    if (loadCachedModule(context, cachePath, module))
+      return 0;
+  }
+
+  mlir::TimingScope parserTiming = timing.nest("Parser");
   if (int error = loadMLIR(context, module))
     return error;
+  parserTiming.stop();
 
   mlir::PassManager pm(module.get()->getName());
   // Apply any generic pass manager command line options and run the pipeline.
+  // The pass manager runs the nested pipelines on the functions in parallel,
+  // on the threads of the context, and reports the time spent in every pass
+  // when timing is enabled.
   if (mlir::failed(mlir::applyPassManagerCLOptions(pm)))
     return 4;
-
-  // Check to see what granularity of MLIR we are compiling to.
-  bool isLoweringToAffine = emitAction >= Action::DumpMLIRAffine;
-  bool isLoweringToLLVM = emitAction >= Action::DumpMLIRLLVM;
+  pm.enableTiming(timing);
 
   if (enableOpt || isLoweringToAffine) {
     // Inline all functions into main and then delete them.
@@ -185,6 +290,11 @@ int loadAndProcessMLIR(mlir::MLIRContext &context,
 
   if (mlir::failed(pm.run(*module)))
     return 4;
+
+  if (!cachePath.empty()) {
+    mlir::TimingScope cacheTiming = timing.nest("Store cached module");
+    storeCachedModule(*module, cachePath);
+  }
   return 0;
 }
 
@@ -246,7 +356,7 @@ int dumpLLVMIR(mlir::ModuleOp module) {
   return 0;
 }
 
-int runJit(mlir::ModuleOp module) {
+int runJit(mlir::ModuleOp module, mlir::TimingScope &timing) {
   // Initialize LLVM targets.
   llvm::InitializeNativeTarget();
   llvm::InitializeNativeTargetAsmPrinter();
@@ -262,14 +372,20 @@ int runJit(mlir::ModuleOp module) {
       /*targetMachine=*/nullptr);
 
   // Create an MLIR execution engine. The execution engine eagerly JIT-compiles
-  // the module.
+  // the module, optionally generating the code on multiple threads, and reuses
+  // the objects generated by previous runs from the cache directory.
   mlir::ExecutionEngineOptions engineOptions;
   engineOptions.transformer = optPipeline;
+  engineOptions.objectCacheDir = cacheDir;
+  engineOptions.numCompileThreads = jitThreads;
+  mlir::TimingScope compileTiming = timing.nest("JIT compilation");
   auto maybeEngine = mlir::ExecutionEngine::create(module, engineOptions);
   assert(maybeEngine && "failed to construct an execution engine");
   auto &engine = maybeEngine.get();
+  compileTiming.stop();
 
   // Invoke the JIT-compiled function.
+  mlir::TimingScope executionTiming = timing.nest("Execution");
   auto invocationResult = engine->invokePacked("main");
   if (invocationResult) {
     llvm::errs() << "JIT invocation failed\n";
@@ -284,6 +400,7 @@ int main(int argc, char **argv) {
   mlir::registerAsmPrinterCLOptions();
   mlir::registerMLIRContextCLOptions();
   mlir::registerPassManagerCLOptions();
+  mlir::registerDefaultTimingManagerCLOptions();
 
   cl::ParseCommandLineOptions(argc, argv, "toy compiler\n");
 
@@ -294,12 +411,20 @@ int main(int argc, char **argv) {
   mlir::DialectRegistry registry;
   mlir::func::registerAllExtensions(registry);
 
+  // Time the compilation and the execution when benchmarking, or when timing
+  // is requested with `-mlir-timing`. The report is printed on exit.
+  mlir::DefaultTimingManager tm;
+  mlir::applyDefaultTimingManagerCLOptions(tm);
+  if (benchmark)
+    tm.setEnabled(true);
+  mlir::TimingScope timing = tm.getRootScope();
+
   mlir::MLIRContext context(registry);
   // Load our Dialect in this MLIR Context.
   context.getOrLoadDialect<mlir::toy::ToyDialect>();
 
   mlir::OwningOpRef<mlir::ModuleOp> module;
-  if (int error = loadAndProcessMLIR(context, module))
+  if (int error = loadAndProcessMLIR(context, module, timing))
     return error;
 
   // If we aren't exporting to non-mlir, then we are done.
@@ -315,7 +440,7 @@ int main(int argc, char **argv) {
 
   // Otherwise, we must be running the jit.
   if (emitAction == Action::RunJIT)
-    return runJit(*module);
+    return runJit(*module, timing);
 
   llvm::errs() << "No action specified (parsing only?), use -emit=<action>\n";
   return -1;
@@ -561,6 +561,29 @@ mlirDenseElementsAttrGetRawData(MlirAttribute attr);
 // Resource blob attributes.
 //===----------------------------------------------------------------------===//
 
+/// Checks whether the given attribute is a dense resource elements attribute.
+MLIR_CAPI_EXPORTED bool
+mlirAttributeIsADenseResourceElements(MlirAttribute attr);
+
+/// Creates a dense resource elements attribute of the given shaped type whose
+/// blob references the given data without copying it. The data must remain
+/// valid until `deleter` is invoked with `userData` when the blob is released,
+/// e.g. when the resource is updated or the context is destroyed. `deleter`
+/// may be null if the data outlives the context. If `dataIsMutable` is false,
+/// the data is never modified through the blob.
+MLIR_CAPI_EXPORTED MlirAttribute mlirUnmanagedDenseResourceElementsAttrGet(
+    MlirType shapedType, MlirStringRef name, void *data, size_t dataLength,
+    size_t dataAlignment, bool dataIsMutable,
+    void (*deleter)(void *userData, const void *data, size_t size,
+                    size_t align),
+    void *userData);
+
+/// Returns the raw data of the blob of the given dense resource elements
+/// attribute and sets `size` to its size in bytes, or returns null if the
+/// blob is not available.
+MLIR_CAPI_EXPORTED const void *
+mlirDenseResourceElementsAttrGetRawData(MlirAttribute attr, intptr_t *size);
+
 MLIR_CAPI_EXPORTED MlirAttribute mlirUnmanagedDenseBoolResourceElementsAttrGet(
     MlirType shapedType, MlirStringRef name, intptr_t numElements,
     const int *elements);
@@ -132,6 +132,16 @@ MLIR_CAPI_EXPORTED MlirDialect mlirContextGetOrLoadDialect(MlirContext context,
 MLIR_CAPI_EXPORTED void mlirContextEnableMultithreading(MlirContext context,
                                                         bool enable);
 
+/// Sets the thread pool of the context, enabling multithreading. The pool is
+/// not owned by the context and must outlive it; it may be shared by multiple
+/// contexts, which then do not spawn threads of their own.
+MLIR_CAPI_EXPORTED void mlirContextSetThreadPool(MlirContext context,
+                                                 MlirLlvmThreadPool threadPool);
+
+/// Returns the number of threads of the thread pool of the context, or 1 if
+/// multithreading is disabled.
+MLIR_CAPI_EXPORTED unsigned mlirContextGetNumThreads(MlirContext context);
+
 /// Eagerly loads all available dialects registered with a context, making
 /// them available for use for IR construction.
 MLIR_CAPI_EXPORTED void
@@ -441,6 +451,13 @@ mlirBytecodeWriterConfigDesiredEmitVersion(MlirBytecodeWriterConfig flags,
 ///   - Result type inference is enabled and cannot be performed.
 MLIR_CAPI_EXPORTED MlirOperation mlirOperationCreate(MlirOperationState *state);
 
+/// Creates `n` operations from the `n` states, with the same semantics as as
+/// many calls to mlirOperationCreate, and stores them in the caller-provided
+/// `ops` array. Returns failure if any of the operations could not be created,
+/// in which case its entry in `ops` is null.
+MLIR_CAPI_EXPORTED MlirLogicalResult mlirOperationCreateN(
+    intptr_t n, MlirOperationState *states, MlirOperation *ops);
+
 /// Parses an operation, giving ownership to the caller. If parsing fails a null
 /// operation will be returned, and an error diagnostic emitted.
 ///
@@ -511,6 +528,11 @@ MLIR_CAPI_EXPORTED intptr_t mlirOperationGetNumOperands(MlirOperation op);
 MLIR_CAPI_EXPORTED MlirValue mlirOperationGetOperand(MlirOperation op,
                                                      intptr_t pos);
 
+/// Stores the operands of the operation in the caller-provided `operands`
+/// array, which must have room for mlirOperationGetNumOperands values.
+MLIR_CAPI_EXPORTED void mlirOperationGetOperands(MlirOperation op,
+                                                 MlirValue *operands);
+
 /// Sets the `pos`-th operand of the operation.
 MLIR_CAPI_EXPORTED void mlirOperationSetOperand(MlirOperation op, intptr_t pos,
                                                 MlirValue newValue);
@@ -522,6 +544,11 @@ MLIR_CAPI_EXPORTED intptr_t mlirOperationGetNumResults(MlirOperation op);
 MLIR_CAPI_EXPORTED MlirValue mlirOperationGetResult(MlirOperation op,
                                                     intptr_t pos);
 
+/// Stores the results of the operation in the caller-provided `results`
+/// array, which must have room for mlirOperationGetNumResults values.
+MLIR_CAPI_EXPORTED void mlirOperationGetResults(MlirOperation op,
+                                                MlirValue *results);
+
 /// Returns the number of successor blocks of the operation.
 MLIR_CAPI_EXPORTED intptr_t mlirOperationGetNumSuccessors(MlirOperation op);
 
@@ -551,6 +578,32 @@ MLIR_CAPI_EXPORTED void mlirOperationSetAttributeByName(MlirOperation op,
 MLIR_CAPI_EXPORTED bool mlirOperationRemoveAttributeByName(MlirOperation op,
                                                            MlirStringRef name);
 
+/// Traversal order for operation walk.
+enum MlirWalkOrder { MlirWalkPreOrder, MlirWalkPostOrder };
+typedef enum MlirWalkOrder MlirWalkOrder;
+
+/// Operation walk result: continue the walk, interrupt it, or skip the
+/// operations nested in the current one. Skipping only applies to pre-order
+/// walks.
+enum MlirWalkResult {
+  MlirWalkResultAdvance,
+  MlirWalkResultInterrupt,
+  MlirWalkResultSkip
+};
+typedef enum MlirWalkResult MlirWalkResult;
+
+/// Operation walker type. The handler is passed an (opaque) reference to an
+/// operation and a pointer to a `userData`.
+typedef MlirWalkResult (*MlirOperationWalkCallback)(MlirOperation,
+                                                    void *userData);
+
+/// Walks `op` and the operations nested in it in the given order, invoking
+/// `callback` on each of them and forwarding `userData`. Returns true if the
+/// walk was interrupted by the callback.
+MLIR_CAPI_EXPORTED bool mlirOperationWalk(MlirOperation op,
+                                          MlirOperationWalkCallback callback,
+                                          void *userData, MlirWalkOrder order);
+
 /// Prints an operation by sending chunks of the string representation and
 /// forwarding `userData to `callback`. Note that the callback may be called
 /// several times with consecutive chunks of the string.
@@ -646,6 +699,13 @@ MLIR_CAPI_EXPORTED MlirRegion mlirOperationGetFirstRegion(MlirOperation op);
 /// operation.
 MLIR_CAPI_EXPORTED MlirRegion mlirRegionGetNextInOperation(MlirRegion region);
 
+/// Walks the operations of the region and the operations nested in them in
+/// the given order, invoking `callback` on each of them and forwarding
+/// `userData`. Returns true if the walk was interrupted by the callback.
+MLIR_CAPI_EXPORTED bool mlirRegionWalk(MlirRegion region,
+                                       MlirOperationWalkCallback callback,
+                                       void *userData, MlirWalkOrder order);
+
 //===----------------------------------------------------------------------===//
 // Block API.
 //===----------------------------------------------------------------------===//
@@ -56,6 +56,7 @@ extern "C" {
   };                                                                           \
   typedef struct name name
 
+DEFINE_C_API_STRUCT(MlirLlvmThreadPool, void);
 DEFINE_C_API_STRUCT(MlirTypeID, const void);
 DEFINE_C_API_STRUCT(MlirTypeIDAllocator, void);
 
@@ -138,6 +139,24 @@ inline static MlirLogicalResult mlirLogicalResultFailure(void) {
   return res;
 }
 
+//===----------------------------------------------------------------------===//
+// MlirLlvmThreadPool.
+//===----------------------------------------------------------------------===//
+
+/// Creates an LLVM thread pool running at most `numThreads` threads, or as
+/// many threads as the hardware supports if `numThreads` is zero. The pool may
+/// be shared by multiple contexts through mlirContextSetThreadPool.
+MLIR_CAPI_EXPORTED MlirLlvmThreadPool
+mlirLlvmThreadPoolCreate(unsigned numThreads);
+
+/// Destroys an LLVM thread pool. The contexts using it must be destroyed
+/// first.
+MLIR_CAPI_EXPORTED void mlirLlvmThreadPoolDestroy(MlirLlvmThreadPool pool);
+
+/// Returns the maximum number of threads of an LLVM thread pool.
+MLIR_CAPI_EXPORTED unsigned
+mlirLlvmThreadPoolGetThreadCount(MlirLlvmThreadPool pool);
+
 //===----------------------------------------------------------------------===//
 // TypeID API.
 //===----------------------------------------------------------------------===//
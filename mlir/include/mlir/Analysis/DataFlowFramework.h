@@ -19,6 +19,7 @@
 #include "mlir/IR/Operation.h"
 #include "mlir/Support/StorageUniquer.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Allocator.h"
 #include "llvm/Support/TypeName.h"
 #include <queue>
 
@@ -194,6 +195,8 @@ class DataFlowAnalysis;
 /// TODO: Optimize the internal implementation of the solver.
 class DataFlowSolver {
 public:
+  ~DataFlowSolver();
+
   /// Load an analysis into the solver. Return the analysis instance.
   template <typename AnalysisT, typename... Args>
   AnalysisT *load(Args &&...args);
@@ -206,10 +209,13 @@ public:
   /// does not exist.
   template <typename StateT, typename PointT>
   const StateT *lookupState(PointT point) const {
-    auto it = analysisStates.find({ProgramPoint(point), TypeID::get<StateT>()});
-    if (it == analysisStates.end())
+    auto statesIt = analysisStates.find(TypeID::get<StateT>());
+    if (statesIt == analysisStates.end())
+      return nullptr;
+    auto it = statesIt->second.find(ProgramPoint(point));
+    if (it == statesIt->second.end())
       return nullptr;
-    return static_cast<const StateT *>(it->second.get());
+    return static_cast<const StateT *>(it->second);
   }
 
   /// Get a uniqued program point instance. If one is not present, it is
@@ -248,15 +254,38 @@ private:
   /// points.
   StorageUniquer uniquer;
 
-  /// A type-erased map of program points to associated analysis states for
-  /// first-class program points.
-  DenseMap<std::pair<ProgramPoint, TypeID>, std::unique_ptr<AnalysisState>>
-      analysisStates;
+  /// The analysis states of first-class program points, grouped by the type of
+  /// the states such that the keys of the per-point maps are the points alone.
+  /// The states are owned by `stateAllocator`.
+  DenseMap<TypeID, DenseMap<ProgramPoint, AnalysisState *>> analysisStates;
+
+  /// The allocator of the analysis states, which are destroyed along with the
+  /// solver.
+  llvm::BumpPtrAllocator stateAllocator;
 
   /// Allow the base child analysis class to access the internals of the solver.
   friend class DataFlowAnalysis;
 };
 
+/// Solve the data-flow analyses on `top` in parallel, by partitioning it into
+/// the operations isolated from above that are nested directly in its regions,
+/// e.g. the functions of a module. Each partition is solved by its own solver,
+/// into which `loadAnalyses` loads the children analyses, as the top-level
+/// operation of the analyses: the states of a partition only depend on its own
+/// program points, and the calls between partitions are handled as calls to
+/// external callables. Once a partition reaches its fixpoint,
+/// `processPartition` is invoked with it and its solver, e.g. to query the
+/// states and rewrite the partition.
+///
+/// The partitions are processed in parallel if multithreading is enabled in
+/// the context, so both callbacks must be thread-safe. If a region of `top`
+/// contains an operation with regions that is not isolated from above, `top`
+/// is solved as a single partition.
+LogicalResult solveIsolatedRegionsInParallel(
+    Operation *top, function_ref<void(DataFlowSolver &)> loadAnalyses,
+    function_ref<LogicalResult(Operation *, DataFlowSolver &)>
+        processPartition);
+
 //===----------------------------------------------------------------------===//
 // AnalysisState
 //===----------------------------------------------------------------------===//
@@ -445,15 +474,15 @@ AnalysisT *DataFlowSolver::load(Args &&...args) {
 
 template <typename StateT, typename PointT>
 StateT *DataFlowSolver::getOrCreateState(PointT point) {
-  std::unique_ptr<AnalysisState> &state =
-      analysisStates[{ProgramPoint(point), TypeID::get<StateT>()}];
+  AnalysisState *&state =
+      analysisStates[TypeID::get<StateT>()][ProgramPoint(point)];
   if (!state) {
-    state = std::unique_ptr<StateT>(new StateT(point));
+    state = new (stateAllocator.Allocate<StateT>()) StateT(point);
 #if LLVM_ENABLE_ABI_BREAKING_CHECKS
     state->debugName = llvm::getTypeName<StateT>();
 #endif // LLVM_ENABLE_ABI_BREAKING_CHECKS
   }
-  return static_cast<StateT *>(state.get());
+  return static_cast<StateT *>(state);
 }
 
 inline raw_ostream &operator<<(raw_ostream &os, const AnalysisState &state) {
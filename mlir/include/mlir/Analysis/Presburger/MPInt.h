@@ -203,6 +203,10 @@ public:
   MPInt divByPositive(const MPInt &o) const;
   MPInt &divByPositiveInPlace(const MPInt &o);
 
+  // Add the product `a * b` to this number. This saves the construction of the
+  // intermediate product in the row operations of matrices.
+  MPInt &addProduct(const MPInt &a, const MPInt &b);
+
   friend MPInt abs(const MPInt &x);
   friend MPInt gcdRange(ArrayRef<MPInt> range);
   friend MPInt ceilDiv(const MPInt &lhs, const MPInt &rhs);
@@ -493,6 +497,21 @@ MPInt::divByPositiveInPlace(const MPInt &o) {
   return *this = MPInt(detail::SlowMPInt(*this) / detail::SlowMPInt(o));
 }
 
+LLVM_ATTRIBUTE_ALWAYS_INLINE MPInt &MPInt::addProduct(const MPInt &a,
+                                                      const MPInt &b) {
+  if (LLVM_LIKELY(isSmall() && a.isSmall() && b.isSmall())) {
+    int64_t product, result;
+    bool overflow = detail::mulOverflow(a.getSmall(), b.getSmall(), product) ||
+                    detail::addOverflow(getSmall(), product, result);
+    if (LLVM_LIKELY(!overflow)) {
+      getSmall() = result;
+      return *this;
+    }
+  }
+  return *this = MPInt(detail::SlowMPInt(*this) +
+                       detail::SlowMPInt(a) * detail::SlowMPInt(b));
+}
+
 LLVM_ATTRIBUTE_ALWAYS_INLINE MPInt &MPInt::operator%=(const MPInt &o) {
   return *this = *this % o;
 }
@@ -150,6 +150,9 @@ public:
   /// Negate the specified row.
   void negateRow(unsigned row);
 
+  /// Multiply the specified row by `scale`.
+  void scaleRow(unsigned row, const MPInt &scale);
+
   /// Divide the first `nCols` of the specified row by their GCD.
   /// Returns the GCD of the first `nCols` of the specified row.
   MPInt normalizeRow(unsigned row, unsigned nCols);
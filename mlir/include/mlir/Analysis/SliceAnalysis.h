@@ -10,10 +10,13 @@
 #define MLIR_ANALYSIS_SLICEANALYSIS_H_
 
 #include <functional>
+#include <memory>
+#include <tuple>
 #include <vector>
 
 #include "mlir/Support/LLVM.h"
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SetVector.h"
 
 namespace mlir {
@@ -223,6 +226,61 @@ SetVector<Operation *> getSlice(Operation *op,
                                 BackwardSliceOptions backwardSliceOptions = {},
                                 ForwardSliceOptions forwardSliceOptions = {});
 
+/// A cache of the backward and forward slices of operations, for the
+/// heuristics querying the slices of many candidates on the same IR, e.g. for
+/// fusion or hoisting. The slices are computed as by `getBackwardSlice` and
+/// `getForwardSlice`, reusing the slices cached for the ops they reach.
+///
+/// The slices are cached per root and per `optionsKey`, which identifies the
+/// options they are computed with, as their filters cannot be compared: the
+/// queries using the same key must use equivalent filters. Any modification of
+/// the IR invalidates the cached slices, and requires clearing the cache.
+class SliceCache {
+public:
+  /// Return the backward slice of `op`, see `getBackwardSlice`.
+  ArrayRef<Operation *>
+  getBackwardSlice(Operation *op, const BackwardSliceOptions &options = {},
+                   const void *optionsKey = nullptr);
+
+  /// Return the forward slice of `op`, see `getForwardSlice`.
+  ArrayRef<Operation *>
+  getForwardSlice(Operation *op, const ForwardSliceOptions &options = {},
+                  const void *optionsKey = nullptr);
+
+  /// Return true if `op` is in the backward/forward slice of `root`. This is
+  /// answered from the order of the ops, without computing the slice, when
+  /// `op` comes after/before `root` in the same block of a region with SSA
+  /// dominance.
+  bool isInBackwardSlice(Operation *op, Operation *root,
+                         const BackwardSliceOptions &options = {},
+                         const void *optionsKey = nullptr);
+  bool isInForwardSlice(Operation *op, Operation *root,
+                        const ForwardSliceOptions &options = {},
+                        const void *optionsKey = nullptr);
+
+  /// Drop all of the cached slices.
+  void clear();
+
+private:
+  /// Return the slices of `op` including it, unless it is filtered out. The
+  /// backward slices are in postorder and the forward slices in topological
+  /// order, as returned by `getBackwardSlice` and `getForwardSlice`.
+  const SetVector<Operation *> &
+  getInclusiveBackwardSlice(Operation *op, const BackwardSliceOptions &options,
+                            const void *optionsKey);
+  const SetVector<Operation *> &
+  getInclusiveForwardSlice(Operation *op, const ForwardSliceOptions &options,
+                           const void *optionsKey);
+
+  /// The backward slices, keyed by root, options key and whether the block
+  /// arguments are omitted. The forward slices, keyed by root and options key.
+  using Key = std::tuple<Operation *, const void *, bool>;
+  DenseMap<Key, std::unique_ptr<SetVector<Operation *>>> backwardSlices;
+  DenseMap<std::pair<Operation *, const void *>,
+           std::unique_ptr<SetVector<Operation *>>>
+      forwardSlices;
+};
+
 /// Multi-root DAG topological sort.
 /// Performs a topological sort of the Operation in the `toSort` SetVector.
 /// Returns a topologically sorted SetVector.
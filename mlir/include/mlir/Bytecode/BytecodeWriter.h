@@ -48,6 +48,33 @@ public:
   /// Get the set desired bytecode version to emit.
   int64_t getDesiredBytecodeVersion() const;
 
+  /// Set whether each top-level section should be written to the output stream
+  /// as soon as it is finalized, instead of buffering the whole encoding until
+  /// the end of the write. This bounds the memory used by the writer to the
+  /// size of the largest section, and resource blobs are written directly from
+  /// their storage. On failure, the output stream may contain partial data.
+  void setStreamOutput(bool enable = true);
+
+  /// The formats the top-level sections may be compressed with.
+  enum class Compression { None, Zlib, Zstd };
+
+  /// Set the compression of the sections holding the IR, i.e. the strings, the
+  /// attributes and types, the operations and the properties. A section is
+  /// only compressed if this makes it smaller. Compression requires bytecode
+  /// version 6, and the writer fails if the format is not available in this
+  /// build of LLVM.
+  void setIRCompression(Compression compression);
+
+  /// Set the compression of the resource section. If `shuffleWidth` is greater
+  /// than 1, the section is transposed as elements of `shuffleWidth` bytes
+  /// before being compressed, which groups the bytes of the same significance
+  /// together. This usually compresses the numeric blobs much better, e.g.
+  /// with a width of 4 for f32 weights. The readers only decompress the
+  /// resource section on the first use of one of its blobs, if the buffer
+  /// holding the bytecode outlives them.
+  void setResourceCompression(Compression compression,
+                              unsigned shuffleWidth = 0);
+
   //===--------------------------------------------------------------------===//
   // Resources
   //===--------------------------------------------------------------------===//
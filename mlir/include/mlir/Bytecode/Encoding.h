@@ -45,8 +45,11 @@ enum BytecodeVersion {
   /// with the discardable attributes.
   kNativePropertiesEncoding = 5,
 
+  /// Support for compressing the top-level sections was added in version 6.
+  kSectionCompression = 6,
+
   /// The current bytecode version.
-  kVersion = 5,
+  kVersion = 6,
 
   /// An arbitrary value used to fill alignment padding.
   kAlignmentByte = 0xCB,
@@ -92,8 +95,28 @@ enum ID : uint8_t {
   /// The total number of section types.
   kNumSections = 9,
 };
+
+/// The flags encoded in the high bits of the section ID.
+enum Flags : uint8_t {
+  /// The section is aligned, and its alignment follows its length.
+  kHasAlignment = 0b10000000,
+
+  /// The section is compressed, and its compression follows its length.
+  kIsCompressed = 0b01000000,
+};
 } // namespace Section
 
+/// The formats of the compressed sections. The header of a compressed section
+/// holds its format, the width of the elements of its byte-shuffle filter or 0,
+/// its alignment and its decompressed size, and its data is the compressed
+/// data.
+namespace SectionCompression {
+enum Format : uint8_t {
+  kZlib = 1,
+  kZstd = 2,
+};
+} // namespace SectionCompression
+
 //===----------------------------------------------------------------------===//
 // IR Section
 //===----------------------------------------------------------------------===//
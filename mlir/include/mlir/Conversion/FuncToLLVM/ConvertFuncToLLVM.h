@@ -14,9 +14,14 @@
 #ifndef MLIR_CONVERSION_FUNCTOLLVM_CONVERTFUNCTOLLVM_H
 #define MLIR_CONVERSION_FUNCTOLLVM_CONVERTFUNCTOLLVM_H
 
+#include "mlir/Support/LLVM.h"
+#include "mlir/Support/LogicalResult.h"
+
 namespace mlir {
 
 class LLVMTypeConverter;
+class LowerToLLVMOptions;
+class ModuleOp;
 class RewritePatternSet;
 
 /// Collect the default pattern to convert a FuncOp to the LLVM dialect. If
@@ -33,6 +38,14 @@ void populateFuncToLLVMFuncOpConversionPattern(LLVMTypeConverter &converter,
 void populateFuncToLLVMConversionPatterns(LLVMTypeConverter &converter,
                                           RewritePatternSet &patterns);
 
+/// Prints to `os` a self-contained C header declaring the `_mlir_ciface_`
+/// wrappers of the functions of `module` with the `llvm.emit_c_interface`
+/// attribute, as lowered with `options`, and the memref descriptors they take.
+/// Returns failure if the type of a function has no C equivalent.
+LogicalResult emitCInterfaceHeader(ModuleOp module,
+                                   const LowerToLLVMOptions &options,
+                                   raw_ostream &os);
+
 } // namespace mlir
 
 #endif // MLIR_CONVERSION_FUNCTOLLVM_CONVERTFUNCTOLLVM_H
@@ -48,11 +48,15 @@ using LoweringCallback = std::function<std::unique_ptr<llvm::Module>(
     Operation *, llvm::LLVMContext &, StringRef)>;
 
 /// Collect a set of patterns to convert from the GPU dialect to LLVM and
-/// populate converter for gpu types.
+/// populate converter for gpu types. If `captureGraphs` is set, the sequences
+/// of kernel launches from a `gpu.wait async` to a `gpu.wait` are captured
+/// into graphs by the runtime, which replays them while the launches and
+/// their arguments are unchanged.
 void populateGpuToLLVMConversionPatterns(LLVMTypeConverter &converter,
                                          RewritePatternSet &patterns,
                                          StringRef gpuBinaryAnnotation = {},
-                                         bool kernelBarePtrCallConv = false);
+                                         bool kernelBarePtrCallConv = false,
+                                         bool captureGraphs = false);
 
 } // namespace mlir
 
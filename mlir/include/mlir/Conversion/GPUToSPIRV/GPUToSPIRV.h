@@ -26,7 +26,10 @@ class MMAMatrixType;
 
 /// Appends to a pattern list additional patterns for translating GPU Ops to
 /// SPIR-V ops. For a gpu.func to be converted, it should have a
-/// spirv.entry_point_abi attribute.
+/// spirv.entry_point_abi attribute. The uniform gpu.subgroup_reduce ops that
+/// cannot be converted into SPIR-V group ops, e.g. because the target lacks
+/// the capabilities of the group arithmetic, are converted into butterflies of
+/// subgroup shuffles.
 void populateGPUToSPIRVPatterns(SPIRVTypeConverter &typeConverter,
                                 RewritePatternSet &patterns);
 
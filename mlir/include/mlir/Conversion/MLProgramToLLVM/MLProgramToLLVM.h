@@ -0,0 +1,31 @@
+//===- MLProgramToLLVM.h - MLProgram to LLVM dialect conversion -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_CONVERSION_MLPROGRAMTOLLVM_MLPROGRAMTOLLVM_H
+#define MLIR_CONVERSION_MLPROGRAMTOLLVM_MLPROGRAMTOLLVM_H
+
+#include <memory>
+
+namespace mlir {
+class LLVMTypeConverter;
+class RewritePatternSet;
+class Pass;
+
+#define GEN_PASS_DECL_CONVERTMLPROGRAMTOLLVMPASS
+#include "mlir/Conversion/Passes.h.inc"
+
+namespace ml_program {
+/// Populate the patterns lowering the loads of the globals with external
+/// storage, once the globals are lowered to the `llvm.mlir.global` ops holding
+/// the address of their storage.
+void populateMLProgramToLLVMConversionPatterns(LLVMTypeConverter &converter,
+                                               RewritePatternSet &patterns);
+} // namespace ml_program
+} // namespace mlir
+
+#endif // MLIR_CONVERSION_MLPROGRAMTOLLVM_MLPROGRAMTOLLVM_H
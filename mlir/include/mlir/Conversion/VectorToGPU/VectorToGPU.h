@@ -39,6 +39,14 @@ LogicalResult convertVectorToMMAOps(RewriterBase &rewriter, Operation *rootOp);
 LogicalResult convertVectorToNVVMCompatibleMMASync(RewriterBase &rewriter,
                                                    Operation *rootOp);
 
+/// Convert vector ops nested under `rootOp` to `amdgpu.mfma` ops and to the
+/// per-lane loads and stores of their operands, following the 16x16 register
+/// layout of the mfma ops on a wave of 64 lanes. This will convert a slice of
+/// operations that can be legally lowered on this path while the rest of the
+/// vector operations are left untouched.
+LogicalResult convertVectorToAMDGPUCompatibleMFMA(RewriterBase &rewriter,
+                                                  Operation *rootOp);
+
 /// Convert from vector to GPU ops.
 std::unique_ptr<Pass> createConvertVectorToGPUPass(bool useNvGpu = false);
 
@@ -9,6 +9,8 @@
 #ifndef MLIR_DIALECT_AMX_TRANSFORMS_H
 #define MLIR_DIALECT_AMX_TRANSFORMS_H
 
+#include "mlir/IR/PatternMatch.h"
+
 namespace mlir {
 
 class LLVMConversionTarget;
@@ -24,6 +26,12 @@ void populateAMXLegalizeForLLVMExportPatterns(LLVMTypeConverter &converter,
 /// intrinsics.
 void configureAMXLegalizeForExportTarget(LLVMConversionTarget &target);
 
+/// Collect a set of patterns to rewrite the bf16 and int8 matmul contractions
+/// that fit in AMX tiles to AMX tile multiplications, packing the right-hand
+/// side in the VNNI layout.
+void populateAMXContractionLoweringPatterns(RewritePatternSet &patterns,
+                                            PatternBenefit benefit = 1);
+
 } // namespace mlir
 
 #endif // MLIR_DIALECT_AMX_TRANSFORMS_H
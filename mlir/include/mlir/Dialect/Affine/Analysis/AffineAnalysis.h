@@ -17,14 +17,18 @@
 
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/IR/Value.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallVector.h"
+#include <memory>
 #include <optional>
+#include <tuple>
 
 namespace mlir {
 class Operation;
 
 namespace affine {
 class AffineApplyOp;
+class AffineDependenceAnalysis;
 class AffineForOp;
 class AffineValueMap;
 class FlatAffineRelation;
@@ -48,17 +52,21 @@ void getSupportedReductions(
 
 /// Returns true if `forOp' is a parallel loop. If `parallelReductions` is
 /// provided, populates it with descriptors of the parallelizable reductions and
-/// treats them as not preventing parallelization.
+/// treats them as not preventing parallelization. If `dependences` is provided,
+/// the memory dependences are checked through it.
 bool isLoopParallel(
     AffineForOp forOp,
-    SmallVectorImpl<LoopReduction> *parallelReductions = nullptr);
+    SmallVectorImpl<LoopReduction> *parallelReductions = nullptr,
+    AffineDependenceAnalysis *dependences = nullptr);
 
 /// Returns true if `forOp' doesn't have memory dependences preventing
 /// parallelization. Memrefs that are allocated inside `forOp` do not impact its
 /// dependences and parallelism. This function does not check iter_args (for
 /// values other than memref types) and should be used only as a building block
-/// for complete parallelism-checking functions.
-bool isLoopMemoryParallel(AffineForOp forOp);
+/// for complete parallelism-checking functions. If `dependences` is provided,
+/// the dependences are checked through it.
+bool isLoopMemoryParallel(AffineForOp forOp,
+                          AffineDependenceAnalysis *dependences = nullptr);
 
 /// Returns in `affineApplyOps`, the sequence of those AffineApplyOp
 /// Operations that are reachable via a search starting from `operands` and
@@ -185,6 +193,60 @@ inline bool noDependence(DependenceResult result) {
   return result.value == DependenceResult::NoDependence;
 }
 
+/// Caches the access relations of memref accesses and the results of the
+/// dependence checks between pairs of accesses, such that the transforms that
+/// check the dependences between many pairs of accesses of the same loop nests
+/// build each access relation and check each pair only once. The analysis may
+/// be requested from the `AnalysisManager` and is then shared by the passes
+/// that preserve it.
+///
+/// The cached results are keyed by the operations of the accesses: they remain
+/// valid as long as these operations, their operands and their surrounding
+/// loops are not modified or erased. The transforms that modify them must
+/// invalidate the affected operations or clear the analysis.
+class AffineDependenceAnalysis {
+public:
+  AffineDependenceAnalysis();
+  explicit AffineDependenceAnalysis(Operation *op);
+  ~AffineDependenceAnalysis();
+
+  /// Checks the dependence between `srcAccess` and `dstAccess` at `loopDepth`
+  /// like `checkMemrefAccessDependence`, reusing the cached result if any.
+  DependenceResult
+  checkDependence(const MemRefAccess &srcAccess, const MemRefAccess &dstAccess,
+                  unsigned loopDepth,
+                  FlatAffineValueConstraints *dependenceConstraints = nullptr,
+                  bool allowRAR = false);
+
+  /// Drops the cached results of the accesses nested in `op`, or of `op`
+  /// itself if it is an access.
+  void invalidate(Operation *op);
+
+  /// Drops all the cached results.
+  void clear();
+
+private:
+  /// Returns the access relation of `access`, or null if it is not supported.
+  const FlatAffineRelation *getAccessRelation(const MemRefAccess &access);
+
+  /// The result of a dependence check, with the dependence constraints if they
+  /// were requested and the accesses are dependent.
+  struct CachedDependence {
+    DependenceResult::ResultEnum value;
+    std::unique_ptr<FlatAffineValueConstraints> constraints;
+  };
+
+  /// The access relations of the accesses, null where they are not supported.
+  DenseMap<Operation *, std::unique_ptr<FlatAffineRelation>> accessRelations;
+
+  /// The results of the dependence checks, keyed by the source and destination
+  /// operations, the loop depth and whether read-after-read dependences are
+  /// allowed.
+  DenseMap<std::tuple<Operation *, Operation *, unsigned, unsigned>,
+           CachedDependence>
+      dependences;
+};
+
 /// Returns in 'depCompsVec', dependence components for dependences between all
 /// load and store ops in loop nest rooted at 'forOp', at loop depths in range
 /// [1, maxLoopDepth].
@@ -84,6 +84,37 @@ bool isVectorizableLoopBody(AffineForOp loop, int *memRefDim,
 // the support.
 bool isOpwiseShiftValid(AffineForOp forOp, ArrayRef<uint64_t> shifts);
 
+/// The parameters of the target machine used by the loop nest cost model.
+struct LoopNestCostParams {
+  /// The size in bytes of the cache that holds the data reused by a loop.
+  uint64_t cacheSizeBytes = 512 * 1024;
+  /// The number of operations issued per cycle.
+  unsigned issueWidth = 4;
+  /// The number of bytes transferred from memory per cycle.
+  unsigned memoryBandwidth = 16;
+};
+
+/// The estimated cost of executing a loop nest.
+struct LoopNestCost {
+  /// The number of operation instances executed, excluding the loops.
+  uint64_t numOps = 0;
+  /// The number of bytes transferred from memory. The data accessed by a loop
+  /// whose memory footprint fits in the cache is transferred once per
+  /// execution of the loop, and the data accessed by the other loops is
+  /// transferred once per access.
+  uint64_t memoryTrafficBytes = 0;
+  /// The number of cycles, bounded below by the issue of the operations and by
+  /// the transfer of the memory traffic.
+  uint64_t cycles = 0;
+};
+
+/// Estimates the cost of executing the loop nest rooted at `forOp` on the
+/// target described by `params`. Returns std::nullopt if a loop of the nest
+/// has a non-constant trip count, or if an access of the nest has an element
+/// type of unknown size.
+std::optional<LoopNestCost>
+getLoopNestCost(AffineForOp forOp, const LoopNestCostParams &params = {});
+
 } // namespace affine
 } // namespace mlir
 
@@ -28,6 +28,7 @@ class Operation;
 class Value;
 
 namespace affine {
+class AffineDependenceAnalysis;
 class AffineForOp;
 class AffineValueMap;
 struct MemRefAccess;
@@ -393,12 +394,14 @@ bool buildSliceTripCountMap(
 /// nest surrounding ops in 'opsB', as a function of IVs and symbols of loop
 /// nest surrounding ops in 'opsA' at 'loopDepth'. Returns
 /// 'SliceComputationResult::Success' if union was computed correctly, an
-/// appropriate 'failure' otherwise.
+/// appropriate 'failure' otherwise. If 'dependences' is provided, the
+/// dependences between the pairs of ops are checked through it.
 // TODO: Change this API to take 'forOpA'/'forOpB'.
 SliceComputationResult
 computeSliceUnion(ArrayRef<Operation *> opsA, ArrayRef<Operation *> opsB,
                   unsigned loopDepth, unsigned numCommonLoops,
-                  bool isBackwardSlice, ComputationSliceState *sliceUnion);
+                  bool isBackwardSlice, ComputationSliceState *sliceUnion,
+                  AffineDependenceAnalysis *dependences = nullptr);
 
 /// Creates a clone of the computation contained in the loop nest surrounding
 /// 'srcOpInst', slices the iteration space of src loop based on slice bounds
@@ -555,6 +558,11 @@ unsigned getNumCommonSurroundingLoops(Operation &a, Operation &b);
 std::optional<int64_t> getMemoryFootprintBytes(AffineForOp forOp,
                                                int memorySpace = -1);
 
+/// Returns the size in bytes of the explicitly managed fast memory, as given
+/// by the `dlti.scratchpad_size_in_bytes` entry of the closest data layout
+/// specification that encloses `op` and has such an entry, if any.
+std::optional<uint64_t> getScratchpadSizeBytes(Operation *op);
+
 /// Returns the memref's element type's size in bytes where the elemental type
 /// is an int or float or a vector of such types.
 std::optional<int64_t> getMemRefIntOrFloatEltSizeInBytes(MemRefType memRefType);
@@ -24,6 +24,7 @@ namespace mlir {
 class Operation;
 
 namespace affine {
+class AffineDependenceAnalysis;
 class AffineForOp;
 struct ComputationSliceState;
 
@@ -107,14 +108,18 @@ private:
 /// loop nest rooted at 'dstForOp' at 'dstLoopDepth'. Returns FusionResult
 /// 'Success' if fusion of the src/dst loop nests is feasible (i.e. they are
 /// in the same block and dependences would not be violated). Otherwise
-/// returns a FusionResult explaining why fusion is not feasible.
+/// returns a FusionResult explaining why fusion is not feasible. If
+/// `dependences` is provided, the dependences between the accesses of the loop
+/// nests are checked through it, such that the checks at successive depths
+/// reuse the results.
 /// NOTE: This function is not feature complete and should only be used in
 /// testing.
 /// TODO: Update comments when this function is fully implemented.
 FusionResult
 canFuseLoops(AffineForOp srcForOp, AffineForOp dstForOp, unsigned dstLoopDepth,
              ComputationSliceState *srcSlice,
-             FusionStrategy fusionStrategy = FusionStrategy::Generic);
+             FusionStrategy fusionStrategy = FusionStrategy::Generic,
+             AffineDependenceAnalysis *dependences = nullptr);
 
 /// Fuses 'srcForOp' into 'dstForOp' with destination loop block insertion
 /// point and source slice loop bounds specified in 'srcSlice'.
@@ -112,6 +112,15 @@ createLoopUnrollAndJamPass(int unrollJamFactor = -1);
 /// memory hierarchy.
 std::unique_ptr<OperationPass<func::FuncOp>> createPipelineDataTransferPass();
 
+/// Creates a pass to insert software prefetches ahead of the vector transfer
+/// reads of innermost loops.
+std::unique_ptr<OperationPass<func::FuncOp>>
+createAffinePrefetchInsertionPass();
+
+/// Creates a pass to reorder, tile and parallelize the loops of affine nests
+/// along permutable bands.
+std::unique_ptr<OperationPass<func::FuncOp>> createAffineLoopSchedulingPass();
+
 /// Creates a pass to expand affine index operations into more fundamental
 /// operations (not necessarily restricted to Affine dialect).
 std::unique_ptr<Pass> createAffineExpandIndexOpsPass();
@@ -135,6 +135,11 @@ Value getReductionOp(AtomicRMWKind op, OpBuilder &builder, Location loc,
                      Value lhs, Value rhs);
 
 arith::CmpIPredicate invertPredicate(arith::CmpIPredicate pred);
+
+/// Returns the fast-math flags of the policy of the closest ancestor of `op`
+/// that has one, i.e. a FastMathFlagsAttr named
+/// ArithDialect::getFastMathPolicyAttrName(), or `none` if there is none.
+arith::FastMathFlags getFastMathPolicy(Operation *op);
 } // namespace arith
 } // namespace mlir
 
@@ -13,6 +13,7 @@
 
 namespace mlir {
 class DataFlowSolver;
+class ValueBoundsCache;
 
 namespace arith {
 
@@ -66,12 +67,20 @@ std::unique_ptr<Pass> createArithUnsignedWhenEquivalentPass();
 void populateIntRangeOptimizationsPatterns(RewritePatternSet &patterns,
                                            DataFlowSolver &solver);
 
+/// Add patterns that rewrite the signed index arithmetic as i32 arithmetic
+/// when the integer ranges of its operands and results fit in i32.
+void populateIndexNarrowingPatterns(RewritePatternSet &patterns,
+                                    DataFlowSolver &solver);
+
 /// Create a pass which do optimizations based on integer range analysis.
 std::unique_ptr<Pass> createIntRangeOptimizationsPass();
 
-/// Add patterns for integer bitwidth narrowing.
-void populateArithIntNarrowingPatterns(RewritePatternSet &patterns,
-                                       const ArithIntNarrowingOptions &options);
+/// Add patterns for integer bitwidth narrowing. The bounds of the index values
+/// are looked up in `boundsCache` if provided, which the driver applying the
+/// patterns must notify of the IR modifications.
+void populateArithIntNarrowingPatterns(
+    RewritePatternSet &patterns, const ArithIntNarrowingOptions &options,
+    ValueBoundsCache *boundsCache = nullptr);
 
 //===----------------------------------------------------------------------===//
 // Registration
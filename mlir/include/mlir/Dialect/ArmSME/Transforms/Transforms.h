@@ -9,6 +9,8 @@
 #ifndef MLIR_DIALECT_ARMSME_TRANSFORMS_H
 #define MLIR_DIALECT_ARMSME_TRANSFORMS_H
 
+#include "mlir/IR/PatternMatch.h"
+
 namespace mlir {
 
 class LLVMConversionTarget;
@@ -18,6 +20,14 @@ class RewritePatternSet;
 namespace arm_sme {
 void populateVectorTransferLoweringPatterns(LLVMTypeConverter &converter,
                                             RewritePatternSet &patterns);
+
+/// Collect a set of patterns to lower the 'vector.contract' ops that
+/// accumulate outer products into a scalable 2-D tile, read from and written
+/// to memory, to SME outer products into a ZA tile. They must be applied
+/// before the generic contraction lowering, which does not support scalable
+/// vectors.
+void populateVectorContractLoweringPatterns(RewritePatternSet &patterns,
+                                            PatternBenefit benefit = 1);
 } // namespace arm_sme
 
 /// Collect a set of patterns to lower ArmSME ops to ops that map to LLVM
@@ -29,10 +29,17 @@ using AsyncMinTaskSizeComputationFunction =
     std::function<Value(ImplicitLocOpBuilder, scf::ParallelOp)>;
 
 /// Add a pattern to the given pattern list to lower scf.parallel to async
-/// operations.
+/// operations. The parallel operations with at most `inlineThreshold`
+/// iterations are executed as a single block in the caller thread.
 void populateAsyncParallelForPatterns(
     RewritePatternSet &patterns, bool asyncDispatch, int32_t numWorkerThreads,
-    const AsyncMinTaskSizeComputationFunction &computeMinTaskSize);
+    const AsyncMinTaskSizeComputationFunction &computeMinTaskSize,
+    int32_t inlineThreshold = 0);
+
+/// Returns an estimate of the number of operations executed by one iteration
+/// of the body of `op`. The operations nested in scf.for loops with a static
+/// trip count are counted once per iteration of these loops.
+int64_t estimateParallelIterationCost(scf::ParallelOp op);
 
 } // namespace async
 } // namespace mlir
@@ -11,6 +11,7 @@
 
 #include "mlir/Dialect/Bufferization/IR/BufferizableOpInterface.h"
 #include "llvm/ADT/EquivalenceClasses.h"
+#include <optional>
 #include <string>
 
 namespace mlir {
@@ -39,6 +40,20 @@ struct OneShotBufferizationOptions : public BufferizationOptions {
   /// analysis.
   AnalysisHeuristic analysisHeuristic = AnalysisHeuristic::BottomUp;
 
+  /// Specifies whether the conflicts are detected incrementally. The reads and
+  /// in-place writes of every alias set are indexed and updated as the alias
+  /// sets are merged, and only the pairs of a read and a write that a decision
+  /// would bring into the same alias set are checked for conflicts, instead of
+  /// all the pairs of the alias sets. Every such pair is thus checked once for
+  /// the in-place decisions instead of once per analyzed OpOperand: the checks
+  /// that lead to in-place decisions take O(P + U log U) time, where P is the
+  /// number of pairs of a read and an in-place write in the final alias sets
+  /// and U the number of tensor uses, while the checks of out-of-place
+  /// decisions are bounded by the pairs across the alias sets they would
+  /// merge. This relies on the `isNotConflicting` interface methods not
+  /// reporting new conflicts for pairs of uses as more decisions are made.
+  bool incrementalConflictAnalysis = false;
+
   /// Specify the functions that should not be analyzed. copyBeforeWrite will be
   /// set to true when bufferizing them.
   llvm::ArrayRef<std::string> noAnalysisFuncFilter;
@@ -132,6 +147,24 @@ public:
   /// Reset cached data structures.
   void resetCache();
 
+  /// The uses of the values of an alias set, as indexed by the incremental
+  /// conflict analysis.
+  struct AliasSetUses {
+    /// The uses that read the buffer of the alias set.
+    DenseSet<OpOperand *> reads;
+
+    /// The uses that write the buffer of the alias set in-place.
+    DenseSet<OpOperand *> inPlaceWrites;
+
+    /// The values of the alias set whose buffer is not writable.
+    SmallVector<Value> nonWritableValues;
+  };
+
+  /// Return the uses of the alias set of `v`. The uses of all alias sets are
+  /// indexed on the first call, and kept up to date as OpOperands are decided
+  /// to bufferize in-place and alias sets are merged.
+  const AliasSetUses &getAliasSetUses(Value v);
+
   /// Union the alias sets of `v1` and `v2`.
   void unionAliasSets(Value v1, Value v2);
 
@@ -239,6 +272,10 @@ private:
   /// Cache definitions of tensor values.
   DenseMap<Value, SetVector<Value>> cachedDefinitions;
 
+  /// The uses of the alias sets, keyed by the leaders of the sets, if they
+  /// have been indexed.
+  std::optional<DenseMap<Value, AliasSetUses>> aliasSetUses;
+
   /// Set of all OpResults that were decided to bufferize in-place.
   llvm::DenseSet<OpOperand *> inplaceBufferized;
 
@@ -35,6 +35,13 @@ std::unique_ptr<Pass> createBufferHoistingPass();
 /// reallocations inside of loops.
 std::unique_ptr<Pass> createBufferLoopHoistingPass();
 
+/// Creates a pass that packs the static-shape allocations of the functions
+/// into a single buffer.
+std::unique_ptr<Pass> createBufferMemoryPlanningPass();
+
+/// Creates a pass that reuses freed buffers for subsequent allocations.
+std::unique_ptr<Pass> createBufferReusePass();
+
 // Options struct for BufferResultsToOutParams pass.
 // Note: defined only here, not in tablegen.
 struct BufferResultsToOutParamsOptions {
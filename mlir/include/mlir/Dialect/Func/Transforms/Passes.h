@@ -35,6 +35,9 @@ std::unique_ptr<Pass> createFuncBufferizePass();
 /// Pass to deduplicate functions.
 std::unique_ptr<Pass> createDuplicateFunctionEliminationPass();
 
+/// Pass to reduce the cost of passing memrefs to the private functions.
+std::unique_ptr<Pass> createRefineMemRefArgumentsPass();
+
 //===----------------------------------------------------------------------===//
 // Registration
 //===----------------------------------------------------------------------===//
@@ -60,11 +60,18 @@ void populateGpuGlobalIdPatterns(RewritePatternSet &patterns);
 void populateGpuShufflePatterns(RewritePatternSet &patterns);
 
 /// Collect a set of patterns to rewrite all-reduce ops within the GPU dialect.
-void populateGpuAllReducePatterns(RewritePatternSet &patterns);
+/// The values are reduced within each subgroup with shuffles, and the partial
+/// results of the subgroups are combined through workgroup memory. With
+/// `shuffleCombine`, every subgroup combines the partial results with shuffles
+/// instead of broadcasting the result of the first subgroup through workgroup
+/// memory, which saves a barrier.
+void populateGpuAllReducePatterns(RewritePatternSet &patterns,
+                                  bool shuffleCombine = false);
 
 /// Collect all patterns to rewrite ops within the GPU dialect.
-inline void populateGpuRewritePatterns(RewritePatternSet &patterns) {
-  populateGpuAllReducePatterns(patterns);
+inline void populateGpuRewritePatterns(RewritePatternSet &patterns,
+                                       bool allReduceShuffleCombine = false) {
+  populateGpuAllReducePatterns(patterns, allReduceShuffleCombine);
   populateGpuGlobalIdPatterns(patterns);
   populateGpuShufflePatterns(patterns);
 }
@@ -117,6 +124,10 @@ protected:
       *this, "gpu-binary-annotation",
       llvm::cl::desc("Annotation attribute string for GPU binary"),
       llvm::cl::init(getDefaultGpuBinaryAnnotation())};
+  Option<std::string> cacheDirectory{
+      *this, "cache-dir",
+      llvm::cl::desc("Directory of a cache of the binaries, keyed on the LLVM "
+                     "IR of the modules and the target options")};
 };
 } // namespace gpu
 
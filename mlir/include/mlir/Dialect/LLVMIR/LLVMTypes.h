@@ -126,7 +126,9 @@ public:
   /// Gets a new identified struct with the given body. The body _cannot_ be
   /// changed later. If a struct with the given name already exists, renames
   /// the struct by appending a `.` followed by a number to the name. Renaming
-  /// happens even if the existing struct has the same body.
+  /// happens even if the existing struct has the same body. The struct is
+  /// constructed with its body and reserved without locking, so that the
+  /// threads creating new structs concurrently do not serialize.
   static LLVMStructType getNewIdentified(MLIRContext *context, StringRef name,
                                          ArrayRef<Type> elements,
                                          bool isPacked = false);
@@ -182,6 +184,8 @@ public:
                               StringRef, bool);
   static LogicalResult verify(function_ref<InFlightDiagnostic()> emitError,
                               ArrayRef<Type> types, bool);
+  static LogicalResult verify(function_ref<InFlightDiagnostic()> emitError,
+                              StringRef, ArrayRef<Type> types, bool);
   using Base::verify;
 
   /// Hooks for DataLayoutTypeInterface. Should not be called directly. Obtain a
@@ -64,6 +64,27 @@ std::unique_ptr<OperationPass<func::FuncOp>> createLinalgBufferizePass();
 /// operations.
 std::unique_ptr<OperationPass<func::FuncOp>> createLinalgGeneralizationPass();
 
+/// Create a pass to tile linalg ops for the memory hierarchy of the target.
+std::unique_ptr<OperationPass<func::FuncOp>> createLinalgCacheTilingPass();
+
+/// Create a pass to tile and fuse the graph of linalg ops of a function.
+std::unique_ptr<OperationPass<func::FuncOp>> createLinalgTileAndFuseGraphPass();
+
+/// Create a pass to assign packed data layouts to the graph of linalg ops of
+/// a function.
+std::unique_ptr<OperationPass<func::FuncOp>>
+createLinalgDataLayoutAssignmentPass();
+
+/// Create a pass to replace register-level linalg tiles with calls to
+/// micro-kernels.
+std::unique_ptr<Pass> createLinalgUKernelDispatchPass();
+
+/// Create a pass to pack the constant weights once, in the module initializer.
+std::unique_ptr<Pass> createLinalgPrepackConstantWeightsPass();
+
+/// Create a pass to rewrite 3x3 2-D convolutions with the Winograd algorithm.
+std::unique_ptr<OperationPass<func::FuncOp>> createLinalgWinogradConv2DPass();
+
 /// Create a pass to convert Linalg operations to equivalent operations that
 /// work on primitive types, if possible.
 std::unique_ptr<Pass> createLinalgDetensorizePass();
@@ -25,6 +25,7 @@
 #include "mlir/Transforms/DialectConversion.h"
 #include "llvm/ADT/SmallBitVector.h"
 #include "llvm/ADT/SmallSet.h"
+#include "llvm/ADT/StringSet.h"
 
 namespace mlir {
 namespace bufferization {
@@ -722,6 +723,38 @@ FailureOr<StaticMultiSizeSpecification>
 computeStaticMultiTileSizes(LinalgOp op, unsigned dimension, int64_t targetSize,
                             int64_t divisor);
 
+/// The capacities of the memory hierarchy of the target, from which
+/// `computeCacheTileSizes` derives the tile sizes of each level.
+struct CacheHierarchy {
+  /// The sizes of the cache levels in bytes, from the innermost level out.
+  SmallVector<int64_t> cacheSizes;
+  /// The width of the vector registers in bits, and their number. The
+  /// register level is not tiled when either of them is zero.
+  int64_t vectorWidth = 0;
+  int64_t numVectorRegisters = 0;
+};
+
+/// Returns the memory hierarchy described by the `dlti.*_cache_size_in_bytes`,
+/// `dlti.vector_width_in_bits` and `dlti.num_vector_registers` entries of the
+/// data layout specs enclosing `op`. Cache levels are listed up to the first
+/// one that is not described.
+CacheHierarchy getCacheHierarchy(Operation *op);
+
+/// Computes the tile sizes of `op` for each level of the memory `hierarchy`,
+/// from the outermost level in, such that tiling `op` by each of them in
+/// turn yields tiles of which the data fit in half of the corresponding
+/// cache level, and an innermost tile of which the accumulators fit in half
+/// of the vector registers. The tile of each level is grown from the tile of
+/// the level inside it by doubling, one loop at a time, the size of the loop
+/// that adds the least data, which greedily maximizes the reuse of the data
+/// in the cache. The tile sizes are given for the full iteration space, with
+/// a zero for the loops that are not tiled at that level.
+///
+/// Fails when some indexing map of `op` is not a projected permutation, or
+/// when the hierarchy describes no level.
+FailureOr<SmallVector<SmallVector<int64_t>>>
+computeCacheTileSizes(LinalgOp op, const CacheHierarchy &hierarchy);
+
 /// Rewrite a TilingInterface `op` to a tiled `scf.forall`, applying
 /// tiling by `numThreads`.
 /// If non-empty, the `mapping` is added as an attribute to the
@@ -895,6 +928,39 @@ splitReduction(RewriterBase &b, LinalgOp op,
                const ControlSplitReductionFn &controlSplitReductionFn,
                bool useAlloc = false);
 
+/// Rewrite a reduction over a static dimension into a tree of reductions: each
+/// level is a linalg op reducing groups of `arity` adjacent elements in
+/// parallel, and the last op reduces the last `arity` elements. This is meant
+/// for the ops combining the partial reductions of `tileReductionUsingForall`
+/// or `splitReduction`, whose reduction over the number of partial results
+/// would otherwise run on a single thread.
+///
+/// Example (`arity = 2`):
+/// ```
+///  %r = linalg.generic {iterator_types = ["reduction"]}
+///    ins(%in : tensor<8xf32>) outs(%out : tensor<f32>)
+/// ```
+/// To:
+/// ```
+///  %0 = tensor.expand_shape %in [[0, 1]] : tensor<8xf32> into tensor<4x2xf32>
+///  %1 = linalg.generic {iterator_types = ["parallel", "reduction"]}
+///    ins(%0 : tensor<4x2xf32>) outs(%init0 : tensor<4xf32>)
+///  %2 = tensor.expand_shape %1 [[0, 1]] : tensor<4xf32> into tensor<2x2xf32>
+///  %3 = linalg.generic {iterator_types = ["parallel", "reduction"]}
+///    ins(%2 : tensor<2x2xf32>) outs(%init1 : tensor<2xf32>)
+///  %r = linalg.generic {iterator_types = ["reduction"]}
+///    ins(%3 : tensor<2xf32>) outs(%out : tensor<f32>)
+/// ```
+/// The op is returned unchanged, with no levels, if its reduction dimension is
+/// not larger than `arity`.
+struct TreeReductionResult {
+  /// The ops of the levels of the tree, from the leaves.
+  SmallVector<LinalgOp> levelOps;
+  LinalgOp resultCombiningLinalgOp;
+};
+FailureOr<TreeReductionResult>
+splitReductionIntoTree(RewriterBase &b, LinalgOp op, int64_t arity = 2);
+
 /// Scaling-based implementation of the split reduction transformation.
 /// Instead of introducing an ExpandShapeOp, this rewrites a reduction
 /// dimension `k` into `k * scale + kk`.
@@ -1085,6 +1151,31 @@ rewriteInIm2Col(RewriterBase &rewriter,
 FailureOr<std::pair<Operation *, Operation *>>
 rewriteInIm2Col(RewriterBase &rewriter, linalg::Conv2DNchwFchwOp convOp);
 
+/// Rewrite linalg.conv_2d_nhwc_hwcf with a 3x3 filter, unit strides and unit
+/// dilations with the minimal filtering algorithm F(m x m, 3 x 3) of
+/// Winograd, for the output tile sizes m = 2 and m = 4.
+///
+/// The filter g and the overlapping (m + 2) x (m + 2) tiles d of the input
+/// are transformed to U = G * g * GT and V = BT * d * B, which are multiplied
+/// by a batched matmul over the channels, for every position of the tiles.
+/// The products M are transformed back to the m x m tiles Y = AT * M * A of
+/// the output. This reduces the multiplications of a tile from 9 * m * m to
+/// (m + 2) * (m + 2), at the cost of the transforms, which are linalg.generic
+/// operations on small constant matrices. A constant filter is transformed
+/// at compile time. The input is padded and the output is sliced when the
+/// output sizes are not multiples of m.
+///
+/// On success, return the operation that accumulates the result into the
+/// output of the convolution.
+FailureOr<Operation *> winogradConv2D(RewriterBase &rewriter,
+                                      linalg::Conv2DNhwcHwcfOp convOp,
+                                      int64_t m);
+
+/// Same as the above but for linalg.conv_2d_nhwc_fhwc.
+FailureOr<Operation *> winogradConv2D(RewriterBase &rewriter,
+                                      linalg::Conv2DNhwcFhwcOp convOp,
+                                      int64_t m);
+
 //===----------------------------------------------------------------------===//
 // Rewrite patterns wrapping transformations.
 // TODO: every single such pattern should be a close to noop wrapper around a
@@ -1332,6 +1423,11 @@ void populateDecomposeConvolutionPatterns(RewritePatternSet &patterns,
 /// \see rewriteInIm2Col for more details.
 void populateConvertConv2DToImg2ColPatterns(RewritePatternSet &patterns);
 
+/// Populates patterns to rewrite the 3x3 linalg.conv_2d_nhwc_hwcf and
+/// linalg.conv_2d_nhwc_fhwc operations with the Winograd algorithm
+/// F(m x m, 3 x 3). \see winogradConv2D for more details.
+void populateWinogradConv2DPatterns(RewritePatternSet &patterns, int64_t m);
+
 /// Populates `patterns` with patterns that vectorize tensor.pad.
 /// These patterns are meant to apply in a complementary fashion. Benefits
 /// are used to encode a certain ordering of pattern application. To avoid
@@ -1392,6 +1488,35 @@ void populateDataLayoutPropagationPatterns(
     RewritePatternSet &patterns,
     const ControlPropagationFn &controlPackUnPackPropagation);
 
+/// Options of the assignment of packed data layouts to a graph of linalg ops.
+struct DataLayoutAssignmentOptions {
+  /// The inner tiles of the m, n and k loops of contractions, which default
+  /// to the tiles of linalg.mmt4d for f32 on CPUs.
+  SmallVector<int64_t, 3> mnkTileSizes = {8, 8, 1};
+  /// The inner tile of the channel loops of convolutions, which gives for
+  /// example the NCHWc layouts of linalg.conv_2d_nchw_fchw.
+  int64_t channelTileSize = 8;
+};
+
+/// Packs the contractions and convolutions on tensors nested in `op` with
+/// inner tiles that are chosen for the whole graph of linalg ops. The
+/// dimensions of the tensors that are indexed by the same loops of the linalg
+/// ops are assigned the same tile, which is the tile preferred by the first
+/// op of the graph that packs them, so that the layout produced by an op is
+/// the layout expected by its consumers. Only the loops whose static sizes
+/// are divisible by their tiles are packed, so that the pack ops need no
+/// padding. The pack and unpack ops inserted around the ops are left to the
+/// patterns of `populateDataLayoutAssignmentPropagationPatterns`, which
+/// cancel out those that meet through element-wise ops.
+void packLinalgOpsForDataLayout(RewriterBase &rewriter, Operation *op,
+                                const DataLayoutAssignmentOptions &options);
+
+/// Patterns to propagate the pack and unpack ops through element-wise
+/// linalg.generic and linalg.fill ops, and to fold the pairs of pack and
+/// unpack ops that cancel out.
+void populateDataLayoutAssignmentPropagationPatterns(
+    RewritePatternSet &patterns);
+
 /// Pattern to remove dead operands and results of `linalg.generic` operations.
 /// This is effectively DCE for a linalg op.
 void populateEraseUnusedOperandsAndResultsPatterns(RewritePatternSet &patterns);
@@ -1463,6 +1588,59 @@ void populateSplitReductionPattern(
     const ControlSplitReductionFn &controlSplitReductionFn,
     bool useAlloc = false);
 
+/// Options of the tiling and fusion of the graph of linalg ops.
+struct GraphFusionOptions {
+  /// The tile sizes of the loops of the roots of the fusion groups, of which
+  /// the reduction loops are never tiled. Missing sizes are zero, which
+  /// leaves the loops untiled.
+  SmallVector<int64_t> tileSizes;
+  /// The cost of moving an element of a tensor to or from memory, relative to
+  /// the cost of an op of the payload of a linalg op.
+  int64_t memoryCost = 16;
+};
+
+/// Partitions the linalg ops on tensors nested under `op` into fusion groups,
+/// and tiles and fuses each group into one loop nest. The groups are formed
+/// greedily from the last op of the graph, which becomes the root of its
+/// group, by fusing its producers through the slices of their results when
+/// this is cheaper than materializing them. A producer that is fused while it
+/// has other users either yields its value from the loop nest, when no slice
+/// of it is computed twice and the users follow the loop nest, or is also
+/// kept for these users. The cost of recomputing the producer is weighed
+/// against the cost of writing and reading back its result. The producers
+/// that are not fused are materialized, and become the roots of their own
+/// groups.
+void tileAndFuseLinalgGraph(RewriterBase &rewriter, Operation *op,
+                            const GraphFusionOptions &options);
+
+/// The micro-kernels that are available for linking, by the symbols of their
+/// functions without the `_mlir_ciface_` prefix of their C interfaces.
+class UKernelRegistry {
+public:
+  void insert(StringRef symbol) { symbols.insert(symbol); }
+  bool contains(StringRef symbol) const { return symbols.contains(symbol); }
+
+  /// Returns the registry of the micro-kernels of the `mlir_c_runner_utils`
+  /// library, as declared in `mlir/ExecutionEngine/MicroKernels.h`.
+  static UKernelRegistry getRunnerUtilsUKernels();
+
+private:
+  llvm::StringSet<> symbols;
+};
+
+/// Returns the symbol of the micro-kernel that computes `op`, of the form
+/// `mlir_ukernel_<op>_<lhs><rhs><acc>_<tile>` after the element types of the
+/// operands and the sizes of the tile, or std::nullopt when `op` is not a
+/// tile computed by micro-kernels. These are the `linalg.mmt4d` ops with the
+/// static inner tile sizes `M0xN0xK0`, and the `linalg.matmul` ops with the
+/// static sizes `MxN`, on buffers.
+std::optional<std::string> getUKernelSymbol(LinalgOp op);
+
+/// Patterns that replace the linalg ops of which `registry` has the
+/// micro-kernel with calls to it, and leave the others to vectorization.
+void populateUKernelDispatchPatterns(RewritePatternSet &patterns,
+                                     const UKernelRegistry &registry);
+
 } // namespace linalg
 } // namespace mlir
 
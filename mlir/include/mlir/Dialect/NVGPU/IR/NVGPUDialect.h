@@ -19,6 +19,13 @@
 #include "mlir/IR/OpDefinition.h"
 #include "mlir/Interfaces/SideEffectInterfaces.h"
 
+namespace mlir {
+namespace nvgpu {
+/// The maximum rank of the tensors that `nvgpu.tma.async.load` copies from.
+constexpr unsigned kMaxTmaTensorRank = 5;
+} // namespace nvgpu
+} // namespace mlir
+
 #define GET_TYPEDEF_CLASSES
 #include "mlir/Dialect/NVGPU/IR/NVGPUTypes.h.inc"
 
@@ -55,13 +55,25 @@ std::unique_ptr<Pass>
 createParallelLoopTilingPass(llvm::ArrayRef<int64_t> tileSize = {},
                              bool noMinMaxBounds = false);
 
+/// Creates a pass which software pipelines innermost for loops with a
+/// schedule derived from latency estimates.
+std::unique_ptr<Pass> createForLoopPipeliningPass();
+
 /// Creates a pass which folds arith ops on induction variable into
 /// loop range.
 std::unique_ptr<Pass> createForLoopRangeFoldingPass();
 
+/// Creates a pass which strength reduces the index computations of for loops
+/// that are linear in their induction variable.
+std::unique_ptr<Pass> createForLoopStrengthReductionPass();
+
 // Creates a pass which lowers for loops into while loops.
 std::unique_ptr<Pass> createForToWhileLoopPass();
 
+/// Creates a pass which converts the bufferized forall loops to parallel
+/// loops.
+std::unique_ptr<Pass> createForallToParallelLoopPass();
+
 //===----------------------------------------------------------------------===//
 // Registration
 //===----------------------------------------------------------------------===//
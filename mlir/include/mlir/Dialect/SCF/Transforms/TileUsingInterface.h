@@ -87,6 +87,26 @@ struct SCFTileAndFuseOptions {
     tilingOptions = options;
     return *this;
   }
+
+  /// Control function to decide whether the producer of the source of
+  /// `candidateSliceOp`, the untiled `originalProducer`, is fused into the
+  /// tiled loops. `isDestinationOperand` is true when the slice is taken of a
+  /// destination of the tiled loops. The function returns whether to fuse the
+  /// producer, and whether to also yield the value of the fused producer from
+  /// the tiled loops, so that it replaces the uses of the untiled producer
+  /// outside of them. The latter is only valid when no slice of the producer
+  /// is computed redundantly within the tiled loops. By default all producers
+  /// are fused, and none are yielded.
+  using ControlFnTy = std::function<std::tuple<bool, bool>(
+      tensor::ExtractSliceOp candidateSliceOp, OpResult originalProducer,
+      bool isDestinationOperand)>;
+  ControlFnTy fusionControlFn = [](tensor::ExtractSliceOp, OpResult, bool) {
+    return std::make_tuple(true, false);
+  };
+  SCFTileAndFuseOptions &setFusionControlFn(ControlFnTy controlFn) {
+    fusionControlFn = std::move(controlFn);
+    return *this;
+  }
 };
 
 /// Fuse the producer of the source of `candidateSliceOp` by computing the
@@ -168,7 +188,9 @@ struct SCFTileAndFuseResult {
   llvm::SetVector<Operation *> tiledAndFusedOps;
   /// The `scf.for` operations that iterate over the tiles.
   SmallVector<scf::ForOp> loops;
-  /// The replacement values to use for the tiled and fused operations.
+  /// The replacement values to use for the tiled and fused operations, which
+  /// are the results of the consumer and of the fused producers yielded by
+  /// the `fusionControlFn`.
   llvm::DenseMap<Value, Value> replacements;
 };
 
@@ -15,6 +15,7 @@
 
 #include "mlir/Dialect/SCF/Utils/AffineCanonicalizationUtils.h"
 #include "mlir/Support/LLVM.h"
+#include "mlir/Support/LogicalResult.h"
 #include "llvm/ADT/ArrayRef.h"
 
 namespace mlir {
@@ -36,6 +37,7 @@ namespace scf {
 
 class IfOp;
 class ForOp;
+class ForallOp;
 class ParallelOp;
 
 /// Fuses all adjacent scf.parallel operations with identical bounds and step
@@ -169,6 +171,16 @@ struct PipeliningOption {
 void populateSCFLoopPipeliningPatterns(RewritePatternSet &patterns,
                                        const PipeliningOption &options);
 
+/// Converts `forallOp` to an `scf.parallel` op with the same iteration space
+/// and body. The `scf.forall` op must be bufferized, i.e. without shared
+/// outputs, and must not have a mapping, which is reserved to the device
+/// lowerings. If `threadPerIteration` is set, the `scf.parallel` op is marked
+/// to run each iteration on its own thread, as is the intent of the
+/// `scf.forall` ops tiled to a number of threads.
+FailureOr<ParallelOp> forallToParallelLoop(RewriterBase &rewriter,
+                                           ForallOp forallOp,
+                                           bool threadPerIteration = true);
+
 /// Populate patterns for canonicalizing operations inside SCF loop bodies.
 /// At the moment, only affine.min/max computations with iteration variables,
 /// loop bounds and loop steps are canonicalized.
@@ -156,6 +156,7 @@ enum class Action : uint32_t {
   kEmptyCOO = 4,
   kToCOO = 5,
   kToIterator = 6,
+  kPack = 7,
 };
 
 /// This enum defines all the sparse representations supportable by
@@ -23,6 +23,14 @@ using namespace llvm::cl;
 namespace mlir {
 namespace sparse_tensor {
 
+/// Defines the runtime that the parallel loops generated by the sparsifier
+/// are lowered to by the "sparse-compiler" pipeline.
+enum class SparseParallelizationBackend {
+  kNone,   // Sequentialize the parallel loops.
+  kOpenMP, // Lower to OpenMP parallel and workshare constructs.
+  kAsync   // Lower to async compute tasks on the async runtime.
+};
+
 /// Options for the "sparse-compiler" pipeline.  So far this only contains
 /// a subset of the options that can be set for the underlying passes,
 /// because it must be manually kept in sync with the tablegen files
@@ -53,6 +61,20 @@ struct SparseCompilerOptions
               "any-storage-any-loop",
               "Enable sparse parallelization for any storage and loop."))};
 
+  PassOptions::Option<SparseParallelizationBackend> parallelizationBackend{
+      *this, "parallelization-backend",
+      ::llvm::cl::desc("Set the runtime to lower parallel loops to"),
+      ::llvm::cl::init(SparseParallelizationBackend::kNone),
+      llvm::cl::values(
+          clEnumValN(SparseParallelizationBackend::kNone, "none",
+                     "Sequentialize the parallel loops."),
+          clEnumValN(SparseParallelizationBackend::kOpenMP, "openmp",
+                     "Lower the parallel loops to OpenMP, which privatizes "
+                     "their reductions."),
+          clEnumValN(SparseParallelizationBackend::kAsync, "async",
+                     "Lower the parallel loops without reductions to async "
+                     "compute tasks, and sequentialize the others."))};
+
   PassOptions::Option<bool> enableIndexReduction{
       *this, "enable-index-reduction",
       desc("Enable dependent index reduction based algorithm to handle "
@@ -65,6 +87,24 @@ struct SparseCompilerOptions
       desc("Enable runtime library for manipulating sparse tensors"),
       init(true)};
 
+  PassOptions::Option<bool> enableGalloping{
+      *this, "enable-galloping",
+      desc("Forward the lagging levels of sparse intersections by a "
+           "galloping search"),
+      init(false)};
+
+  PassOptions::Option<mlir::SparseLoopOrderingStrategy> loopOrdering{
+      *this, "loop-ordering-strategy",
+      ::llvm::cl::desc("Set the loop ordering strategy"),
+      ::llvm::cl::init(mlir::SparseLoopOrderingStrategy::kDefault),
+      llvm::cl::values(
+          clEnumValN(mlir::SparseLoopOrderingStrategy::kDefault, "default",
+                     "Take the first order allowed by the iteration graph."),
+          clEnumValN(mlir::SparseLoopOrderingStrategy::kCostModel,
+                     "cost-model",
+                     "Take the loops with the fewest estimated iterations "
+                     "first."))};
+
   PassOptions::Option<bool> testBufferizationAnalysisOnly{
       *this, "test-bufferization-analysis-only",
       desc("Run only the inplacability analysis"), init(false)};
@@ -129,17 +169,44 @@ struct SparseCompilerOptions
                                            desc("GPU target architecture")};
   PassOptions::Option<std::string> gpuFeatures{*this, "gpu-features",
                                                desc("GPU target features")};
+  PassOptions::Option<SparseGPURowMapping> gpuRowMapping{
+      *this, "gpu-row-mapping",
+      ::llvm::cl::desc("Set the mapping of parallel loops onto GPU threads"),
+      ::llvm::cl::init(SparseGPURowMapping::kThreadPerRow),
+      llvm::cl::values(
+          clEnumValN(SparseGPURowMapping::kThreadPerRow, "thread-per-row",
+                     "Assign the rows cyclically to the threads."),
+          clEnumValN(SparseGPURowMapping::kWarpPerRow, "warp-per-row",
+                     "Assign the rows cyclically to the warps, which split "
+                     "the reduction over each row."),
+          clEnumValN(SparseGPURowMapping::kMergePath, "merge-path",
+                     "Assign each thread a run of rows with a balanced "
+                     "number of nonzeros."))};
 
   /// This option is used to enable GPU library generation.
   PassOptions::Option<bool> enableGPULibgen{
       *this, "enable-gpu-libgen",
       desc("Enables GPU acceleration by means of direct library calls (like "
            "cuSPARSE)")};
+  PassOptions::Option<GPUDataTransferStrategy> gpuDataTransfer{
+      *this, "gpu-data-transfer-strategy",
+      ::llvm::cl::desc(
+          "Set the data transfer strategy of the GPU library calls"),
+      ::llvm::cl::init(GPUDataTransferStrategy::kRegularDMA),
+      llvm::cl::values(
+          clEnumValN(GPUDataTransferStrategy::kRegularDMA, "regular-dma",
+                     "Copy from the pageable host buffers and wait for the "
+                     "copies on the host."),
+          clEnumValN(GPUDataTransferStrategy::kPinnedDMA, "pinned-dma",
+                     "Copy from the registered host buffers and chain the "
+                     "library calls to the copies."))};
 
   /// Projects out the options for `createSparsificationPass`.
   SparsificationOptions sparsificationOptions() const {
     return SparsificationOptions(parallelization, enableIndexReduction,
-                                 enableGPULibgen, enableRuntimeLibrary);
+                                 enableGPULibgen, enableRuntimeLibrary,
+                                 enableGalloping, loopOrdering,
+                                 gpuDataTransfer);
   }
 
   /// Projects out the options for `createSparseTensorConversionPass`.
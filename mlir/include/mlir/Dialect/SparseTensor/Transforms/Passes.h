@@ -44,22 +44,61 @@ enum class SparseParallelizationStrategy {
   // TODO: support reduction parallelization too?
 };
 
+/// Defines how the direct GPU code generation maps the iterations of an
+/// outermost parallel loop (typically, the rows of a CSR matrix) onto the
+/// GPU threads. `kThreadPerRow` assigns the rows cyclically to the threads.
+/// `kWarpPerRow` assigns the rows cyclically to the warps, splitting the
+/// sum reduction over each row between the lanes of a warp, which suits
+/// long rows. `kMergePath` assigns each thread a contiguous run of rows
+/// with about the same number of nonzeros, found by a binary search over
+/// the row positions, which suits rows of skewed lengths. Loops that do
+/// not fit the selected mapping fall back to `kThreadPerRow`.
+enum class SparseGPURowMapping { kThreadPerRow, kWarpPerRow, kMergePath };
+
+/// Defines how the loops of a sparse kernel are ordered among the orders
+/// allowed by its iteration graph. `kDefault` takes the filter loops, then
+/// the parallel loops, then the reduction loops, in no particular order
+/// within each kind. `kCostModel` takes the loop with the fewest estimated
+/// iterations first within each kind, which puts the loops over the
+/// sparsest levels outermost. The estimates follow from the level types,
+/// the static sizes and the densities attached to the kernel by its
+/// `sparse_tensor.density` attribute.
+enum class SparseLoopOrderingStrategy { kDefault, kCostModel };
+
+/// Defines how the GPU library calls transfer their buffers between the
+/// host and the device. `kRegularDMA` copies from the pageable host
+/// buffers, and blocks on the host until the copies complete before
+/// starting the library calls. `kPinnedDMA` registers the host buffers
+/// with the device for the duration of the calls, such that the copies
+/// are truly asynchronous, and chains the library calls to the copies on
+/// the device rather than blocking on the host.
+enum class GPUDataTransferStrategy { kRegularDMA, kPinnedDMA };
+
 #define GEN_PASS_DECL
 #include "mlir/Dialect/SparseTensor/Transforms/Passes.h.inc"
 
 /// Options for the Sparsification pass.
 struct SparsificationOptions {
   SparsificationOptions(SparseParallelizationStrategy p, bool idxReduc,
-                        bool gpuLibgen, bool enableRT)
+                        bool gpuLibgen, bool enableRT, bool gallop,
+                        SparseLoopOrderingStrategy o,
+                        GPUDataTransferStrategy t)
       : parallelizationStrategy(p), enableIndexReduction(idxReduc),
-        enableGPULibgen(gpuLibgen), enableRuntimeLibrary(enableRT) {}
+        enableGPULibgen(gpuLibgen), enableRuntimeLibrary(enableRT),
+        enableGalloping(gallop), loopOrderingStrategy(o),
+        gpuDataTransferStrategy(t) {}
   SparsificationOptions()
       : SparsificationOptions(SparseParallelizationStrategy::kNone, false,
-                              false, true) {}
+                              false, true, false,
+                              SparseLoopOrderingStrategy::kDefault,
+                              GPUDataTransferStrategy::kRegularDMA) {}
   SparseParallelizationStrategy parallelizationStrategy;
   bool enableIndexReduction;
   bool enableGPULibgen;
   bool enableRuntimeLibrary;
+  bool enableGalloping;
+  SparseLoopOrderingStrategy loopOrderingStrategy;
+  GPUDataTransferStrategy gpuDataTransferStrategy;
 };
 
 /// Sets up sparsification rewriting rules with the given options.
@@ -179,6 +218,12 @@ void populateStorageSpecifierToLLVMPatterns(TypeConverter &converter,
                                             RewritePatternSet &patterns);
 std::unique_ptr<Pass> createStorageSpecifierToLLVMPass();
 
+//===----------------------------------------------------------------------===//
+// The SparseEncodingAdvisor pass.
+//===----------------------------------------------------------------------===//
+
+std::unique_ptr<Pass> createSparseEncodingAdvisorPass();
+
 //===----------------------------------------------------------------------===//
 // Other rewriting rules and passes.
 //===----------------------------------------------------------------------===//
@@ -192,11 +237,13 @@ std::unique_ptr<Pass> createSparsificationAndBufferizationPass(
     bool enableVLAVectorization, bool enableSIMDIndex32);
 
 void populateSparseBufferRewriting(RewritePatternSet &patterns,
-                                   bool enableBufferInitialization);
+                                   bool enableBufferInitialization,
+                                   bool enableRuntimeSort = false);
 
 std::unique_ptr<Pass> createSparseBufferRewritePass();
 std::unique_ptr<Pass>
-createSparseBufferRewritePass(bool enableBufferInitialization);
+createSparseBufferRewritePass(bool enableBufferInitialization,
+                              bool enableRuntimeSort = false);
 
 void populateSparseVectorizationPatterns(RewritePatternSet &patterns,
                                          unsigned vectorLength,
@@ -209,13 +256,19 @@ std::unique_ptr<Pass> createSparseVectorizationPass(unsigned vectorLength,
                                                     bool enableSIMDIndex32);
 
 void populateSparseGPUCodegenPatterns(RewritePatternSet &patterns,
-                                      unsigned numThreads);
+                                      unsigned numThreads,
+                                      SparseGPURowMapping rowMapping);
 
-void populateSparseGPULibgenPatterns(RewritePatternSet &patterns,
-                                     bool enableRT);
+void populateSparseGPULibgenPatterns(
+    RewritePatternSet &patterns, bool enableRT,
+    GPUDataTransferStrategy gpuDataTransferStrategy =
+        GPUDataTransferStrategy::kRegularDMA);
 
 std::unique_ptr<Pass> createSparseGPUCodegenPass();
 std::unique_ptr<Pass> createSparseGPUCodegenPass(unsigned numThreads);
+std::unique_ptr<Pass>
+createSparseGPUCodegenPass(unsigned numThreads,
+                           SparseGPURowMapping rowMapping);
 
 //===----------------------------------------------------------------------===//
 // Registration.
@@ -45,6 +45,15 @@ void populateFoldTensorSubsetOpPatterns(RewritePatternSet &patterns);
 void populateMergeConsecutiveInsertExtractSlicePatterns(
     RewritePatternSet &patterns);
 
+/// Populates `patterns` with patterns that make the reads of the destination of
+/// a tensor.insert_slice op that follow it read from its result instead, when
+/// they read a subset that is disjoint from the inserted subset. The reads are
+/// thus forwarded along the chains of tensor.insert_slice ops, which can then
+/// bufferize in place instead of copying their destination. These patterns are
+/// in this separate entry point because the bufferization is sensitive to IR
+/// structure.
+void populateCoalesceInsertSliceChainPatterns(RewritePatternSet &patterns);
+
 /// Populates `patterns` with patterns that drop redundant tensor.insert_slice
 /// rank expansions.
 void populateDropRedundantInsertSliceRankExpansionPatterns(
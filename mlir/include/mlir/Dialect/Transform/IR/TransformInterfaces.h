@@ -16,6 +16,7 @@
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Support/LogicalResult.h"
+#include "llvm/ADT/StringMap.h"
 
 namespace mlir {
 namespace transform {
@@ -97,8 +98,23 @@ public:
   /// Returns true if the expensive checks are requested.
   bool getExpensiveChecksEnabled() const { return expensiveChecksEnabled; }
 
+  /// Selects `value` for the tunable parameters named `name` instead of their
+  /// default value, such that tuning drivers can apply variants of the same
+  /// transform IR.
+  TransformOptions &setTunableValue(StringRef name, Attribute value) {
+    tunableValues[name] = value;
+    return *this;
+  }
+
+  /// Returns the value selected for the tunable parameters named `name`, or
+  /// null if there is none.
+  Attribute getTunableValue(StringRef name) const {
+    return tunableValues.lookup(name);
+  }
+
 private:
   bool expensiveChecksEnabled = true;
+  llvm::StringMap<Attribute> tunableValues;
 };
 
 /// Entry point to the Transform dialect infrastructure. Applies the
@@ -56,6 +56,11 @@ struct UnrollVectorOptions {
     return *this;
   }
 
+  /// Set the native shapes to the shapes of the vector registers described by
+  /// the data layout specs enclosing each operation, see
+  /// `getRegisterNativeShape`.
+  UnrollVectorOptions &setNativeShapeFromDataLayout();
+
   /// Function that returns the traversal order (in terms of "for loop order",
   /// i.e. slowest varying dimension to fastest varying dimension) that should
   /// be used when unrolling the given operation into units of the native vector
@@ -70,6 +75,38 @@ struct UnrollVectorOptions {
   }
 };
 
+/// The vector registers of a target, from which the native shapes of the
+/// vector ops are derived.
+struct VectorRegisterInfo {
+  /// The width of the vector registers in bits. There is no native shape when
+  /// it is zero.
+  int64_t vectorWidth = 0;
+  /// The number of vector registers, of which half may hold the accumulators
+  /// of a contraction.
+  int64_t numVectorRegisters = 0;
+};
+
+/// Returns the vector registers described by the `dlti.vector_width_in_bits`
+/// and `dlti.num_vector_registers` entries of the data layout specs enclosing
+/// `op`. Clients that query the target differently, e.g. through an LLVM
+/// TargetMachine, may fill a `VectorRegisterInfo` themselves.
+VectorRegisterInfo getVectorRegisterInfo(Operation *op);
+
+/// Returns the shape to unroll `op` to so that its vectors fit in the vector
+/// registers `info`:
+///   - transfers and element-wise ops are unrolled to one register along the
+///     innermost dimension and to one element along the other ones;
+///   - contractions are unrolled to a block of accumulators of one register
+///     along the innermost dimension of the accumulator, and of as many rows
+///     as half of the registers along the next one, which is updated for one
+///     step of the reductions at a time. Contractions into a scalar are
+///     unrolled to one register along their innermost reduction.
+/// Every size divides the corresponding size of `op`, so that the ratio is
+/// integral. Returns std::nullopt for the other ops, for scalable vectors
+/// and when `info` describes no vector register.
+std::optional<SmallVector<int64_t>>
+getRegisterNativeShape(Operation *op, const VectorRegisterInfo &info);
+
 /// Canonicalization of a `vector.contraction %a, %b, %c` with row-major matmul
 /// semantics to a contraction with MMT semantics (matrix matrix multiplication
 /// with the RHS transposed). This specific form is meant to have the vector
@@ -105,7 +105,9 @@ LogicalResult splitFullAndPartialTransfer(
     scf::IfOp *ifOp = nullptr);
 
 /// Implements transfer op write to read forwarding and dead transfer write
-/// optimizations.
+/// optimizations. The accesses of each memref are indexed once, such that the
+/// transfers with constant indices, as in unrolled kernels, are only checked
+/// against the accesses that may overlap them.
 void transferOpflowOpt(RewriterBase &rewriter, Operation *rootOp);
 
 /// Cast away the leading unit dim, if exists, for the given contract op.
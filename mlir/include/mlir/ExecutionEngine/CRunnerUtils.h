@@ -478,6 +478,32 @@ extern "C" MLIR_CRUNNERUTILS_EXPORT void printBF16(uint16_t bits); // bits!
 extern "C" MLIR_CRUNNERUTILS_EXPORT void printFlops(double flops);
 extern "C" MLIR_CRUNNERUTILS_EXPORT double rtclock();
 
+//===----------------------------------------------------------------------===//
+// Runtime support library for the profile counters of code regions.
+//===----------------------------------------------------------------------===//
+// Returns the value of the cycle counter of the processor, or a count of
+// nanoseconds on processors whose counter is not readable.
+extern "C" MLIR_CRUNNERUTILS_EXPORT uint64_t mlirProfileReadCounter();
+// Adds one execution of the region `name`, which started when the counter had
+// the value `start`. The regions are identified by the address of their name.
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+mlirProfileRecordRegion(const char *name, uint64_t start);
+// Prints the number of executions and the counter ticks of the regions to
+// stderr, and clears them.
+extern "C" MLIR_CRUNNERUTILS_EXPORT void mlirProfilePrintReport();
+
+//===----------------------------------------------------------------------===//
+// Runtime support library for the globals with external storage.
+//===----------------------------------------------------------------------===//
+// Maps the `size` bytes at `offset` of the file at `path` and returns their
+// address, or aborts if they cannot be mapped. The pages are private: they are
+// read from the file when first accessed and shared with the other processes
+// mapping it, and if `isMutable` is nonzero they may be written to, which
+// copies them. The mapping lasts until the process exits.
+extern "C" MLIR_CRUNNERUTILS_EXPORT void *
+mlirMapExternalStorage(const char *path, int64_t offset, int64_t size,
+                       int32_t isMutable);
+
 //===----------------------------------------------------------------------===//
 // Runtime support library for random number generation.
 //===----------------------------------------------------------------------===//
@@ -497,4 +523,57 @@ extern "C" MLIR_CRUNNERUTILS_EXPORT void
 _mlir_ciface_stdSortF64(uint64_t n, StridedMemRefType<double, 1> *vref);
 extern "C" MLIR_CRUNNERUTILS_EXPORT void
 _mlir_ciface_stdSortF32(uint64_t n, StridedMemRefType<float, 1> *vref);
+
+//===----------------------------------------------------------------------===//
+// Runtime support library for the parallel and partial sorts.
+//===----------------------------------------------------------------------===//
+// Sorts the values with a stable merge sort on multiple threads.
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_parallelSortI64(uint64_t n, StridedMemRefType<int64_t, 1> *vref);
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_parallelSortF64(uint64_t n, StridedMemRefType<double, 1> *vref);
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_parallelSortF32(uint64_t n, StridedMemRefType<float, 1> *vref);
+
+// Sorts the unsigned integers with a radix sort.
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_radixSortIndex(uint64_t n, StridedMemRefType<uint64_t, 1> *vref);
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_radixSortU64(uint64_t n, StridedMemRefType<uint64_t, 1> *vref);
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_radixSortU32(uint64_t n, StridedMemRefType<uint32_t, 1> *vref);
+
+// Moves the `k` largest values to the front, in decreasing order.
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_topKI64(uint64_t n, uint64_t k,
+                     StridedMemRefType<int64_t, 1> *vref);
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_topKF64(uint64_t n, uint64_t k,
+                     StridedMemRefType<double, 1> *vref);
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_topKF32(uint64_t n, uint64_t k, StridedMemRefType<float, 1> *vref);
+
+// Sorts the records of `nx` index keys followed by `ny` other indices in the
+// lexicographic order of their keys, along with the values of `yref` if any,
+// with a stable sort on multiple threads. This implements the
+// `sparse_tensor.sort_coo` operator.
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_sortCOO(uint64_t n, uint64_t nx, uint64_t ny,
+                     StridedMemRefType<uint64_t, 1> *xyref);
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_sortCOOI64(uint64_t n, uint64_t nx, uint64_t ny,
+                        StridedMemRefType<uint64_t, 1> *xyref,
+                        StridedMemRefType<int64_t, 1> *yref);
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_sortCOOI32(uint64_t n, uint64_t nx, uint64_t ny,
+                        StridedMemRefType<uint64_t, 1> *xyref,
+                        StridedMemRefType<int32_t, 1> *yref);
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_sortCOOF64(uint64_t n, uint64_t nx, uint64_t ny,
+                        StridedMemRefType<uint64_t, 1> *xyref,
+                        StridedMemRefType<double, 1> *yref);
+extern "C" MLIR_CRUNNERUTILS_EXPORT void
+_mlir_ciface_sortCOOF32(uint64_t n, uint64_t nx, uint64_t ny,
+                        StridedMemRefType<uint64_t, 1> *xyref,
+                        StridedMemRefType<float, 1> *yref);
 #endif // MLIR_EXECUTIONENGINE_CRUNNERUTILS_H
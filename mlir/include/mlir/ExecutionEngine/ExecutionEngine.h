@@ -13,15 +13,19 @@
 #ifndef MLIR_EXECUTIONENGINE_EXECUTIONENGINE_H_
 #define MLIR_EXECUTIONENGINE_EXECUTIONENGINE_H_
 
+#include "mlir/ExecutionEngine/PooledAllocator.h"
 #include "mlir/Support/LLVM.h"
 #include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/DynamicLibrary.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/RWMutex.h"
 
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
 
 namespace llvm {
@@ -36,10 +40,26 @@ class MemoryBuffer;
 namespace mlir {
 
 class Operation;
+class SharedRuntimeLibraries;
 
 /// A simple object cache following Lang's LLJITWithObjectCache example.
+///
+/// When constructed with a cache directory, compiled objects are additionally
+/// persisted on disk. Entries are content-addressed: the file name is derived
+/// from the hash of the LLVM module and of a key describing the code
+/// generation configuration, so that different processes compiling the same
+/// module for the same target can share objects.
+///
+/// The cache is thread-safe and may be used by concurrent compilers.
 class SimpleObjectCache : public llvm::ObjectCache {
 public:
+  SimpleObjectCache() = default;
+
+  /// Creates an object cache backed by the directory `cacheDir`. The
+  /// `codeGenKey` is mixed into the hash of every entry and should uniquely
+  /// identify the target and code generation options used by the compiler.
+  SimpleObjectCache(StringRef cacheDir, StringRef codeGenKey);
+
   void notifyObjectCompiled(const llvm::Module *m,
                             llvm::MemoryBufferRef objBuffer) override;
   std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module *m) override;
@@ -51,7 +71,25 @@ public:
   bool isEmpty();
 
 private:
+  /// Returns the path of the on-disk entry for the given module.
+  std::string getCacheFilePath(const llvm::Module *m);
+
   llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> cachedObjects;
+
+  /// Directory holding the persistent entries, empty if the cache only lives
+  /// in memory.
+  std::string cacheDir;
+
+  /// Key identifying the code generation configuration.
+  std::string codeGenKey;
+
+  /// Paths of the on-disk entries computed so far, indexed by module
+  /// identifier. Computing a path requires hashing the whole module, so it is
+  /// done only once per module.
+  llvm::StringMap<std::string> cacheFilePaths;
+
+  /// Guards `cachedObjects` and `cacheFilePaths`.
+  std::mutex mutex;
 };
 
 struct ExecutionEngineOptions {
@@ -82,6 +120,13 @@ struct ExecutionEngineOptions {
   /// symbols with public visibility are available to the executed code.
   ArrayRef<StringRef> sharedLibPaths = {};
 
+  /// If `runtimeLibraries` is provided, the symbols of these libraries are
+  /// available to the compiled code in addition to the ones of
+  /// `sharedLibPaths`. Unlike the latter, the libraries are loaded and
+  /// initialized once for all the engines referencing them, and they are only
+  /// destroyed when the last of these engines is.
+  std::shared_ptr<SharedRuntimeLibraries> runtimeLibraries;
+
   /// Specifies an existing `sectionMemoryMapper` to be associated with the
   /// compiled code. If none is provided, a default memory mapper that directly
   /// calls into the operating system is used.
@@ -92,6 +137,36 @@ struct ExecutionEngineOptions {
   /// be dumped to a file via the `dumpToObjectFile` method.
   bool enableObjectDump = false;
 
+  /// If `objectCacheDir` is set, compiled objects are persisted in this
+  /// directory and reused by later executions instead of re-running code
+  /// generation. Entries are keyed on the hash of the LLVM module, the target
+  /// triple, CPU, CPU features and the code generation optimization level. The
+  /// directory is created if it does not exist.
+  StringRef objectCacheDir;
+
+  /// If `numCompileThreads` is non-zero, the JIT compiles code on that many
+  /// threads. Unless lazy compilation is enabled, the translated LLVM module
+  /// is split into as many partitions, each in its own LLVM context, that are
+  /// compiled concurrently.
+  unsigned numCompileThreads = 0;
+
+  /// If `enableLazyCompilation` is set, function bodies are only compiled when
+  /// they are first looked up, e.g. through `lookupPacked`, or called from
+  /// other JIT-compiled code. This reduces the time to first invocation for
+  /// modules where only few functions are used.
+  ///
+  /// Object dump requires all code to live in a single object and cannot be
+  /// combined with lazy or concurrent compilation.
+  bool enableLazyCompilation = false;
+
+  /// If `pooledAllocator` is set, the memory allocation functions called by
+  /// the compiled code, `mlirAlloc`, `mlirAlignedAlloc`, `mlirFree` and
+  /// `mlirAlignedFree`, and the generic allocation functions that
+  /// `memref.alloc` is lowered to with `use-generic-functions`, are served by
+  /// the pooled allocator configured with these options. The memory they
+  /// return must not be freed by the system allocator.
+  std::optional<runtime::PooledAllocatorOptions> pooledAllocator;
+
   /// If enable `enableGDBNotificationListener` is set, the JIT compiler will
   /// notify the llvm's global GDB notification listener.
   bool enableGDBNotificationListener = true;
@@ -99,6 +174,11 @@ struct ExecutionEngineOptions {
   /// If `enablePerfNotificationListener` is set, the JIT compiler will notify
   /// the llvm's global Perf notification listener.
   bool enablePerfNotificationListener = true;
+
+  /// If `printProfileReport` is set, the report of the profile counters added
+  /// by `-llvm-add-profile-counters` is printed when the engine is destroyed,
+  /// provided that a shared library defines `mlirProfilePrintReport`.
+  bool printProfileReport = false;
 };
 
 /// JIT-backed execution engine for MLIR. Assumes the IR can be converted to
@@ -125,6 +205,13 @@ public:
   static constexpr const char *const kLibraryDestroyFnName =
       "__mlir_execution_engine_destroy";
 
+  /// Name of the initializer of modules. If the module defines a function with
+  /// this name, without arguments and results, it is called once when the
+  /// module is loaded, before any other function is looked up. This is where,
+  /// for example, the constant weights are packed into globals owned by the
+  /// `ExecutionEngine`.
+  static constexpr const char *const kModuleInitFnName = "__mlir_module_init";
+
   /// Function type for init functions of shared libraries. The library may
   /// provide a list of symbols that it wants to make available to code run by
   /// the `ExecutionEngine`. If the two functions are not defined, only symbols
@@ -152,11 +239,17 @@ public:
 
   /// Looks up the original function with the given name and returns a
   /// pointer to it. This is not necesarily a packed function. Propagates
-  /// errors in case of failure.
+  /// errors in case of failure. The addresses found are cached, so that only
+  /// the first lookup of a name queries the JIT.
   llvm::Expected<void *> lookup(StringRef name) const;
 
   /// Invokes the function with the given name passing it the list of opaque
   /// pointers to the actual arguments.
+  ///
+  /// This is thread-safe: the engine may be invoked concurrently from multiple
+  /// threads, as well as re-entrantly from the compiled code, since no lock is
+  /// held while the function runs. The function itself must support being
+  /// called concurrently.
   llvm::Error invokePacked(StringRef name,
                            MutableArrayRef<void *> args = std::nullopt);
 
@@ -229,6 +322,10 @@ public:
           symbolMap);
 
 private:
+  /// The runtime libraries shared with other engines. They are declared first
+  /// for the compiled code to be destroyed before them.
+  std::shared_ptr<SharedRuntimeLibraries> runtimeLibraries;
+
   /// Ordering of llvmContext and jit is important for destruction purposes: the
   /// jit must be destroyed before the context.
   llvm::LLVMContext llvmContext;
@@ -248,9 +345,58 @@ private:
   /// Perf notification listener.
   llvm::JITEventListener *perfListener;
 
+  /// Whether to print the report of the profile counters on destruction.
+  bool printProfileReport = false;
+
   /// Destroy functions in the libraries loaded by the ExecutionEngine that are
   /// called when this ExecutionEngine is destructed.
   SmallVector<LibraryDestroyFn> destroyFns;
+
+  /// The addresses of the symbols looked up so far, and the mutex guarding
+  /// them.
+  mutable llvm::StringMap<void *> symbolCache;
+  mutable llvm::sys::SmartRWMutex<true> symbolCacheMutex;
+};
+
+/// A set of runtime libraries loaded once and shared by multiple execution
+/// engines, e.g. by the engines compiling the different modules of a program.
+/// The libraries implementing the loading and unloading protocol of
+/// `ExecutionEngineOptions::sharedLibPaths` are initialized when the set is
+/// loaded and destroyed with it, and the symbols they export are collected
+/// once for all the engines. The public symbols of the other libraries are
+/// resolved on demand, and cached as well.
+///
+/// The set is thread-safe and may be used by engines running concurrently.
+class SharedRuntimeLibraries {
+public:
+  ~SharedRuntimeLibraries();
+
+  /// Loads the libraries at the given paths. Returns an error if one of them
+  /// cannot be loaded.
+  static llvm::Expected<std::shared_ptr<SharedRuntimeLibraries>>
+  load(ArrayRef<StringRef> libPaths);
+
+  /// Returns the address of the runtime symbol with the given name, or nullptr
+  /// if none of the libraries defines it.
+  void *lookup(StringRef name);
+
+private:
+  SharedRuntimeLibraries() = default;
+
+  /// The symbols exported by the init functions of the libraries.
+  llvm::StringMap<void *> exportedSymbols;
+
+  /// The libraries without init function, whose public symbols are resolved
+  /// on demand.
+  SmallVector<llvm::sys::DynamicLibrary> libraries;
+
+  /// The destroy functions of the libraries, called upon destruction.
+  SmallVector<ExecutionEngine::LibraryDestroyFn> destroyFns;
+
+  /// The public symbols resolved so far, including the ones that were not
+  /// found, and the mutex guarding them.
+  llvm::StringMap<void *> resolvedSymbols;
+  std::mutex mutex;
 };
 
 } // namespace mlir
@@ -0,0 +1,51 @@
+//===- MicroKernels.h - Micro-kernels for linalg tiles ----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This header file declares the micro-kernels of the `mlir_c_runner_utils`
+// library, to which `-linalg-ukernel-dispatch` lowers the register-level
+// tiles of `linalg.mmt4d` and `linalg.matmul` ops. Each micro-kernel is
+// named `mlir_ukernel_<op>_<lhs><rhs><acc>_<tile>` after the op, the element
+// types of its operands, and the static sizes of the tile; and is called
+// through its `_mlir_ciface_` interface, with the operands in the order of
+// the op.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_EXECUTIONENGINE_MICROKERNELS_H
+#define MLIR_EXECUTIONENGINE_MICROKERNELS_H
+
+#include "mlir/ExecutionEngine/CRunnerUtils.h"
+
+extern "C" {
+
+/// Computes `acc += lhs * transpose(rhs)` on packed operands, where `lhs`
+/// is `M x K x M0 x K0`, `rhs` is `N x K x N0 x K0` and `acc` is
+/// `M x N x M0 x N0`, for the tile sizes `M0 x N0 x K0`.
+#define DECL_MMT4D(M0, N0, K0)                                                 \
+  MLIR_CRUNNERUTILS_EXPORT void                                                \
+      _mlir_ciface_mlir_ukernel_mmt4d_f32f32f32_##M0##x##N0##x##K0(            \
+          StridedMemRefType<float, 4> *lhs, StridedMemRefType<float, 4> *rhs,  \
+          StridedMemRefType<float, 4> *acc);
+DECL_MMT4D(8, 8, 1)
+DECL_MMT4D(16, 16, 1)
+#undef DECL_MMT4D
+
+/// Computes `acc += lhs * rhs` on a tile, where `lhs` is `M0 x K`, `rhs` is
+/// `K x N0` and `acc` is `M0 x N0`, for the tile sizes `M0 x N0`.
+#define DECL_MATMUL(M0, N0)                                                    \
+  MLIR_CRUNNERUTILS_EXPORT void                                                \
+      _mlir_ciface_mlir_ukernel_matmul_f32f32f32_##M0##x##N0(                  \
+          StridedMemRefType<float, 2> *lhs, StridedMemRefType<float, 2> *rhs,  \
+          StridedMemRefType<float, 2> *acc);
+DECL_MATMUL(8, 8)
+DECL_MATMUL(16, 16)
+#undef DECL_MATMUL
+
+} // extern "C"
+
+#endif // MLIR_EXECUTIONENGINE_MICROKERNELS_H
@@ -25,6 +25,23 @@ class TargetMachine;
 
 namespace mlir {
 
+/// The profile used for the profile-guided optimization of LLVM IR.
+struct ProfileUseOptions {
+  enum class Kind {
+    /// A profile collected from instrumented code and merged by llvm-profdata.
+    Instrumented,
+    /// A sample profile collected by a sampling profiler. The samples are
+    /// mapped to the code through its debug locations.
+    Sample,
+  };
+  Kind kind = Kind::Instrumented;
+  /// The path of the profile.
+  std::string profileFile;
+  /// The path of an optional file remapping the symbol names of the profile
+  /// to the names of the module.
+  std::string remappingFile;
+};
+
 /// Create a module transformer function for MLIR ExecutionEngine that runs
 /// LLVM IR passes corresponding to the given speed and size optimization
 /// levels (e.g. -O2 or -Os). If not null, `targetMachine` is used to
@@ -34,6 +51,13 @@ std::function<llvm::Error(llvm::Module *)>
 makeOptimizingTransformer(unsigned optLevel, unsigned sizeLevel,
                           llvm::TargetMachine *targetMachine);
 
+/// Create a module transformer function like above that additionally guides
+/// the optimizations by the given execution profile.
+std::function<llvm::Error(llvm::Module *)>
+makeOptimizingTransformer(unsigned optLevel, unsigned sizeLevel,
+                          llvm::TargetMachine *targetMachine,
+                          const ProfileUseOptions &profileOptions);
+
 } // namespace mlir
 
 #endif // MLIR_EXECUTIONENGINE_OPTUTILS_H
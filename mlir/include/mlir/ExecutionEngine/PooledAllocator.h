@@ -0,0 +1,85 @@
+//===- PooledAllocator.h - Pooled allocator for JIT code --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This header declares the allocator that the `ExecutionEngine` may substitute
+// for the system allocator in the allocation functions called by the code it
+// compiles. Small allocations are served from size classes whose free blocks
+// are cached per thread, allocations above a threshold are mapped directly and
+// backed by huge pages where the system supports it, and the allocations may
+// be counted per call site.
+//
+// The memory returned by the allocator must be freed by `pooledFree`.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_EXECUTIONENGINE_POOLEDALLOCATOR_H
+#define MLIR_EXECUTIONENGINE_POOLEDALLOCATOR_H
+
+#include <cstdint>
+#include <vector>
+
+namespace llvm {
+class raw_ostream;
+} // namespace llvm
+
+namespace mlir {
+namespace runtime {
+
+/// Options of the pooled allocator.
+struct PooledAllocatorOptions {
+  /// Allocations of at least `hugeAllocationThreshold` bytes bypass the size
+  /// classes and are mapped directly, backed by huge pages where supported.
+  uint64_t hugeAllocationThreshold = 2 * 1024 * 1024;
+
+  /// If `collectStatistics` is set, the allocations are counted per call site.
+  /// This serializes the allocations and is meant for diagnostics.
+  bool collectStatistics = false;
+};
+
+/// Statistics of the allocations made from one call site.
+struct AllocationSiteStatistics {
+  /// Return address of the calls to the allocation functions.
+  const void *site = nullptr;
+  uint64_t numAllocations = 0;
+  uint64_t numFrees = 0;
+  /// Number of bytes requested by all the allocations.
+  uint64_t allocatedBytes = 0;
+  /// Number of bytes allocated and not freed yet, and its maximum.
+  uint64_t liveBytes = 0;
+  uint64_t peakLiveBytes = 0;
+};
+
+/// Sets the options of the pooled allocator, which apply to the subsequent
+/// allocations of all the threads.
+void configurePooledAllocator(const PooledAllocatorOptions &options);
+
+/// Allocates `size` bytes aligned to 16 bytes. Returns null on failure.
+void *pooledAlloc(uint64_t size);
+
+/// Allocates `size` bytes aligned to `alignment`, which must be a power of 2.
+/// Returns null on failure.
+void *pooledAlignedAlloc(uint64_t alignment, uint64_t size);
+
+/// Frees memory returned by `pooledAlloc` or `pooledAlignedAlloc`, possibly
+/// on another thread.
+void pooledFree(void *ptr);
+
+/// Returns the statistics of the call sites, ordered by decreasing number of
+/// allocated bytes.
+std::vector<AllocationSiteStatistics> getPooledAllocatorStatistics();
+
+/// Clears the statistics of the call sites, except for their live bytes.
+void resetPooledAllocatorStatistics();
+
+/// Prints the statistics of the call sites to `os`.
+void printPooledAllocatorStatistics(llvm::raw_ostream &os);
+
+} // namespace runtime
+} // namespace mlir
+
+#endif // MLIR_EXECUTIONENGINE_POOLEDALLOCATOR_H
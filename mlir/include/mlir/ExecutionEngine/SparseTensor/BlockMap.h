@@ -0,0 +1,148 @@
+//===- BlockMap.h - Dimension-to-level mapping of blocked formats -*- C++ -*-=//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This header is not part of the public API.  It is placed in the
+// includes directory only because that's required by the implementations
+// of template-classes.
+//
+// This file defines the `BlockMap` class, which generalizes the
+// permutations of `PermutationRef` to the dimension-to-level mappings of
+// blocked storage formats such as BSR, where a dimension `d` is split into
+// the pair of levels `d floordiv b` and `d mod b`.
+//
+// This file is part of the lightweight runtime support library for sparse
+// tensor manipulations.  The functionality of the support library is meant
+// to simplify benchmarking, testing, and debugging MLIR code operating on
+// sparse tensors.  However, the provided functionality is **not** part of
+// core MLIR itself.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_EXECUTIONENGINE_SPARSETENSOR_BLOCKMAP_H
+#define MLIR_EXECUTIONENGINE_SPARSETENSOR_BLOCKMAP_H
+
+#include "mlir/ExecutionEngine/SparseTensor/ErrorHandling.h"
+
+#include <cassert>
+#include <cinttypes>
+#include <vector>
+
+namespace mlir {
+namespace sparse_tensor {
+namespace detail {
+
+/// A mapping between dimension-coordinates and level-coordinates, in which
+/// every dimension occurs at either one or two levels.  A dimension `d`
+/// which occurs at the two levels `l0 < l1` is blocked, with the level
+/// `l0` storing `d floordiv b` and the level `l1` storing `d mod b` for
+/// the block size `b = lvlSizes[l1]`.  Thus, the mapping is fully described
+/// by the `lvl2dim` and `lvlSizes` arrays that are already passed around
+/// by the runtime library; and for `lvlRank == dimRank` it is just the
+/// permutation `lvl2dim`.
+class BlockMap final {
+public:
+  /// Constructs the mapping described by `lvl2dim` and `lvlSizes`, which
+  /// must be valid for `lvlRank`.  Fails when some dimension occurs at no
+  /// level, or at more than two levels.
+  BlockMap(uint64_t dimRank, uint64_t lvlRank, const uint64_t *lvlSizes,
+           const uint64_t *lvl2dim)
+      : lvlRank(lvlRank), outerLvl(dimRank, kInvalidLvl),
+        innerLvl(dimRank, kInvalidLvl), blockSizes(dimRank, 0) {
+    assert(lvlSizes && "Got nullptr for level sizes");
+    assert(lvl2dim && "Got nullptr for level-to-dimension mapping");
+    for (uint64_t l = 0; l < lvlRank; ++l) {
+      const uint64_t d = lvl2dim[l];
+      if (d >= dimRank || innerLvl[d] != kInvalidLvl)
+        MLIR_SPARSETENSOR_FATAL("Invalid level-to-dimension mapping\n");
+      if (outerLvl[d] == kInvalidLvl) {
+        outerLvl[d] = l;
+      } else {
+        innerLvl[d] = l;
+        blockSizes[d] = lvlSizes[l];
+      }
+    }
+    for (uint64_t d = 0; d < dimRank; ++d)
+      if (outerLvl[d] == kInvalidLvl)
+        MLIR_SPARSETENSOR_FATAL("Dimension %" PRIu64 " has no level\n", d);
+  }
+
+  uint64_t getDimRank() const { return outerLvl.size(); }
+
+  uint64_t getLvlRank() const { return lvlRank; }
+
+  /// Returns true if some dimension is split into blocks.
+  bool isBlocked() const { return lvlRank != getDimRank(); }
+
+  /// Maps the `dimCoords` to the `lvlCoords`.
+  template <typename C>
+  void pushforward(const C *dimCoords, C *lvlCoords) const {
+    for (uint64_t d = 0, dimRank = getDimRank(); d < dimRank; ++d) {
+      const C c = dimCoords[d];
+      if (const uint64_t b = blockSizes[d]) {
+        lvlCoords[outerLvl[d]] = static_cast<C>(c / b);
+        lvlCoords[innerLvl[d]] = static_cast<C>(c % b);
+      } else {
+        lvlCoords[outerLvl[d]] = c;
+      }
+    }
+  }
+
+  /// Maps the `lvlCoords` back to the `dimCoords`.
+  template <typename C>
+  void pullback(const C *lvlCoords, C *dimCoords) const {
+    for (uint64_t d = 0, dimRank = getDimRank(); d < dimRank; ++d) {
+      const C c = lvlCoords[outerLvl[d]];
+      if (const uint64_t b = blockSizes[d])
+        dimCoords[d] = static_cast<C>(c * b + lvlCoords[innerLvl[d]]);
+      else
+        dimCoords[d] = c;
+    }
+  }
+
+  /// Reconstructs the dimension-sizes from the `lvlSizes` and the expected
+  /// `dimShape`.  The sizes of blocked dimensions cannot be recovered from
+  /// their level-sizes, since the last block may be padded, so these must
+  /// be given statically by the `dimShape`.
+  std::vector<uint64_t> getDimSizes(const uint64_t *dimShape,
+                                    const uint64_t *lvlSizes) const {
+    const uint64_t dimRank = getDimRank();
+    std::vector<uint64_t> dimSizes(dimRank);
+    for (uint64_t d = 0; d < dimRank; ++d) {
+      const uint64_t sz = lvlSizes[outerLvl[d]];
+      if (const uint64_t b = blockSizes[d]) {
+        if (dimShape[d] == 0 || (dimShape[d] + b - 1) / b != sz)
+          MLIR_SPARSETENSOR_FATAL("Blocked dimension %" PRIu64
+                                  " does not match its level sizes\n",
+                                  d);
+        dimSizes[d] = dimShape[d];
+      } else {
+        assert((dimShape[d] == 0 || dimShape[d] == sz) &&
+               "Dimension sizes do not match expected shape");
+        dimSizes[d] = sz;
+      }
+    }
+    return dimSizes;
+  }
+
+private:
+  static constexpr uint64_t kInvalidLvl = static_cast<uint64_t>(-1);
+  const uint64_t lvlRank;
+  // The level storing each dimension, or its blocks when blocked.
+  std::vector<uint64_t> outerLvl;
+  // The level storing the coordinates within the blocks of each blocked
+  // dimension, and `kInvalidLvl` for the others.
+  std::vector<uint64_t> innerLvl;
+  // The block size of each blocked dimension, and zero for the others.
+  std::vector<uint64_t> blockSizes;
+};
+
+} // namespace detail
+} // namespace sparse_tensor
+} // namespace mlir
+
+#endif // MLIR_EXECUTIONENGINE_SPARSETENSOR_BLOCKMAP_H
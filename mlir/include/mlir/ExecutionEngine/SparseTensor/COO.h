@@ -17,10 +17,13 @@
 #ifndef MLIR_EXECUTIONENGINE_SPARSETENSOR_COO_H
 #define MLIR_EXECUTIONENGINE_SPARSETENSOR_COO_H
 
+#include "mlir/ExecutionEngine/SparseTensor/Parallel.h"
+
 #include <algorithm>
 #include <cassert>
 #include <cinttypes>
 #include <functional>
+#include <limits>
 #include <vector>
 
 namespace mlir {
@@ -33,14 +36,10 @@ namespace sparse_tensor {
 /// and a rank-5 tensor element would look like
 ///   ({i,j,k,l,m}, a[i,j,k,l,m])
 ///
-/// The coordinates are represented as a (non-owning) pointer into
-/// a shared pool of coordinates, rather than being stored directly in
-/// this object.  This significantly improves performance because it:
-/// (1) reduces the per-element memory footprint, and (2) centralizes
-/// the memory management for coordinates.  The only downside is that
-/// the coordinates themselves cannot be retrieved without knowing the
-/// rank of the tensor to which this element belongs (and that rank is
-/// not stored in this object).
+/// This is only a view of an element of a `SparseTensorCOO`: the
+/// coordinates are represented as a (non-owning) pointer into the
+/// COO's packed coordinates, and thus cannot be retrieved without
+/// knowing the rank of the tensor to which this element belongs.
 template <typename V>
 struct Element final {
   Element(const uint64_t *coords, V val) : coords(coords), value(val){};
@@ -48,26 +47,6 @@ struct Element final {
   V value;
 };
 
-/// Closure object for `operator<` on `Element` with a given rank.
-template <typename V>
-struct ElementLT final {
-  ElementLT(uint64_t rank) : rank(rank) {}
-
-  /// Compares two elements a la `operator<`.
-  ///
-  /// Precondition: the elements must both be valid for `rank`.
-  bool operator()(const Element<V> &e1, const Element<V> &e2) const {
-    for (uint64_t d = 0; d < rank; ++d) {
-      if (e1.coords[d] == e2.coords[d])
-        continue;
-      return e1.coords[d] < e2.coords[d];
-    }
-    return false;
-  }
-
-  const uint64_t rank;
-};
-
 /// The type of callback functions which receive an element.  We avoid
 /// packaging the coordinates and value together as an `Element` object
 /// because this helps keep code somewhat cleaner.
@@ -75,33 +54,27 @@ template <typename V>
 using ElementConsumer =
     const std::function<void(const std::vector<uint64_t> &, V)> &;
 
+/// The type of callback functions which receive an element, along with
+/// the index of the thread which enumerates it.
+template <typename V>
+using ParallelElementConsumer =
+    const std::function<void(uint64_t, const std::vector<uint64_t> &, V)> &;
+
 /// A memory-resident sparse tensor in coordinate-scheme representation
-/// (a collection of `Element`s).  This data structure is used as
+/// (a collection of elements).  This data structure is used as
 /// an intermediate representation; e.g., for reading sparse tensors
 /// from external formats into memory, or for certain conversions between
 /// different `SparseTensorStorage` formats.
 ///
-/// This class provides all the typedefs required by the "Container"
-/// concept (<https://en.cppreference.com/w/cpp/named_req/Container>);
-/// however, beware that it cannot fully implement that concept since
-/// it cannot have a default ctor (because the `dimSizes` field is const).
-/// Thus these typedefs are provided for familiarity reasons, rather
-/// than as a proper implementation of the concept.
+/// The elements are stored as a struct of arrays: the coordinates of
+/// all elements are packed into a single array, with the `getRank()`
+/// coordinates of the `i`-th element starting at `i * getRank()`, and
+/// the values are stored in a separate array.  This avoids storing a
+/// pointer per element, and keeps the coordinates of consecutive
+/// elements adjacent in memory.
 template <typename V>
 class SparseTensorCOO final {
 public:
-  using value_type = const Element<V>;
-  using reference = value_type &;
-  using const_reference = reference;
-  // The types associated with `std::vector` differ significantly between
-  // C++11/17 vs C++20; so we explicitly defer to whatever `std::vector`
-  // says the types should be.
-  using vector_type = std::vector<Element<V>>;
-  using iterator = typename vector_type::const_iterator;
-  using const_iterator = iterator;
-  using difference_type = typename vector_type::difference_type;
-  using size_type = typename vector_type::size_type;
-
   /// Constructs a new coordinate-scheme sparse tensor with the given
   /// sizes and initial storage capacity.
   ///
@@ -131,7 +104,7 @@ public:
     for (uint64_t d = 0; d < dimRank; ++d)
       assert(dimSizes[d] > 0 && "Dimension size zero has trivial storage");
     if (capacity) {
-      elements.reserve(capacity);
+      values.reserve(capacity);
       coordinates.reserve(capacity * dimRank);
     }
   }
@@ -142,69 +115,156 @@ public:
   /// Gets the dimension-sizes array.
   const std::vector<uint64_t> &getDimSizes() const { return dimSizes; }
 
-  /// Gets the elements array.
-  const std::vector<Element<V>> &getElements() const { return elements; }
+  /// Gets the number of stored elements.
+  uint64_t getNSE() const { return values.size(); }
+
+  /// Gets the packed coordinates array.
+  const std::vector<uint64_t> &getCoordinates() const { return coordinates; }
+
+  /// Gets the values array.
+  const std::vector<V> &getValues() const { return values; }
+
+  /// Gets the coordinates of the `i`-th element.
+  const uint64_t *getCoords(uint64_t i) const {
+    assert(i < getNSE() && "Element is out of bounds");
+    return coordinates.data() + i * getRank();
+  }
+
+  /// Gets the value of the `i`-th element.
+  V getValue(uint64_t i) const {
+    assert(i < getNSE() && "Element is out of bounds");
+    return values[i];
+  }
 
-  /// Returns the `operator<` closure object for the COO's element type.
-  ElementLT<V> getElementLT() const { return ElementLT<V>(getRank()); }
+  /// Gets a view of the `i`-th element, which is invalidated by `add`
+  /// and `sort`.
+  Element<V> getElement(uint64_t i) const {
+    return Element<V>(getCoords(i), getValue(i));
+  }
 
   /// Adds an element to the tensor.  This method does not check whether
   /// `dimCoords` is already associated with a value, it adds it regardless.
   /// Resolving such conflicts is left up to clients of the iterator
   /// interface.
   ///
-  /// This method invalidates all iterators.
+  /// This method invalidates all element views.
   ///
   /// Asserts:
   /// * the `dimCoords` is valid for `getRank`.
   /// * the components of `dimCoords` are valid for `getDimSizes`.
   void add(const std::vector<uint64_t> &dimCoords, V val) {
-    const uint64_t *base = coordinates.data();
-    const uint64_t size = coordinates.size();
+    assert(dimCoords.size() == getRank() && "Element rank mismatch");
+    add(dimCoords.data(), val);
+  }
+
+  /// Adds an element to the tensor, as per the variant above.
+  ///
+  /// Precondition: `dimCoords` must be valid for `getRank`.
+  void add(const uint64_t *dimCoords, V val) {
     const uint64_t dimRank = getRank();
-    assert(dimCoords.size() == dimRank && "Element rank mismatch");
     for (uint64_t d = 0; d < dimRank; ++d) {
       assert(dimCoords[d] < dimSizes[d] &&
              "Coordinate is too large for the dimension");
       coordinates.push_back(dimCoords[d]);
     }
-    // This base only changes if `coordinates` was reallocated.  In which
-    // case, we need to correct all previous pointers into the vector.
-    // Note that this only happens if we did not set the initial capacity
-    // right, and then only for every internal vector reallocation (which
-    // with the doubling rule should only incur an amortized linear overhead).
-    const uint64_t *const newBase = coordinates.data();
-    if (newBase != base) {
-      for (uint64_t i = 0, n = elements.size(); i < n; ++i)
-        elements[i].coords = newBase + (elements[i].coords - base);
-      base = newBase;
-    }
-    // Add the new element and update the sorted bit.
-    const Element<V> addedElem(base + size, val);
-    if (!elements.empty() && isSorted)
-      isSorted = getElementLT()(elements.back(), addedElem);
-    elements.push_back(addedElem);
+    // Update the sorted bit.
+    const uint64_t nse = values.size();
+    if (nse != 0 && isSorted)
+      isSorted = isCoordsLess(getCoords(nse - 1), &coordinates[nse * dimRank]);
+    values.push_back(val);
   }
 
-  const_iterator begin() const { return elements.cbegin(); }
-  const_iterator end() const { return elements.cend(); }
-
   /// Sorts elements lexicographically by coordinates.  If a coordinate
   /// is mapped to multiple values, then the relative order of those
   /// values is unspecified.
   ///
-  /// This method invalidates all iterators.
+  /// This method invalidates all element views.
   void sort() {
     if (isSorted)
       return;
-    std::sort(elements.begin(), elements.end(), getElementLT());
+    const uint64_t nse = getNSE();
+    const uint64_t numThreads = detail::getNumThreads(nse, kMinSortChunkSize);
+    // Sort a permutation of the elements, rather than moving around the
+    // coordinates of each element.  When all the coordinates can be
+    // linearized in a `uint64_t`, we sort by that key instead, which
+    // avoids comparing the coordinates one dimension at a time.
+    std::vector<std::pair<uint64_t, uint64_t>> order(nse);
+    if (canLinearize()) {
+      detail::parallelInvoke(numThreads, [&](uint64_t t) {
+        const uint64_t end = (t + 1) * nse / numThreads;
+        for (uint64_t i = t * nse / numThreads; i < end; ++i)
+          order[i] = {linearize(getCoords(i)), i};
+      });
+      detail::parallelSort(order, std::less<>(), numThreads);
+    } else {
+      for (uint64_t i = 0; i < nse; ++i)
+        order[i] = {0, i};
+      detail::parallelSort(
+          order,
+          [this](const auto &lhs, const auto &rhs) {
+            return isCoordsLess(getCoords(lhs.second), getCoords(rhs.second));
+          },
+          numThreads);
+    }
+    // Apply the permutation.
+    const uint64_t dimRank = getRank();
+    std::vector<uint64_t> sortedCoordinates(coordinates.size());
+    std::vector<V> sortedValues(nse);
+    detail::parallelInvoke(numThreads, [&](uint64_t t) {
+      const uint64_t end = (t + 1) * nse / numThreads;
+      for (uint64_t i = t * nse / numThreads; i < end; ++i) {
+        const uint64_t *coords = getCoords(order[i].second);
+        std::copy(coords, coords + dimRank,
+                  sortedCoordinates.begin() + i * dimRank);
+        sortedValues[i] = values[order[i].second];
+      }
+    });
+    coordinates = std::move(sortedCoordinates);
+    values = std::move(sortedValues);
     isSorted = true;
   }
 
 private:
+  /// Compares the coordinates of two elements a la `operator<`.
+  bool isCoordsLess(const uint64_t *lhs, const uint64_t *rhs) const {
+    for (uint64_t d = 0, rank = getRank(); d < rank; ++d) {
+      if (lhs[d] == rhs[d])
+        continue;
+      return lhs[d] < rhs[d];
+    }
+    return false;
+  }
+
+  /// Returns true if the product of the dimension-sizes fits in a
+  /// `uint64_t`, so that the coordinates of every element can be
+  /// linearized.
+  bool canLinearize() const {
+    uint64_t size = 1;
+    for (const uint64_t sz : dimSizes) {
+      if (size > std::numeric_limits<uint64_t>::max() / sz)
+        return false;
+      size *= sz;
+    }
+    return true;
+  }
+
+  /// Linearizes the coordinates of an element in row-major order, which
+  /// preserves their lexicographic order.
+  ///
+  /// Precondition: `canLinearize` must hold.
+  uint64_t linearize(const uint64_t *coords) const {
+    uint64_t result = 0;
+    for (uint64_t d = 0, rank = getRank(); d < rank; ++d)
+      result = result * dimSizes[d] + coords[d];
+    return result;
+  }
+
+  /// The minimum number of elements sorted by a single thread.
+  static constexpr uint64_t kMinSortChunkSize = 1 << 16;
+
   const std::vector<uint64_t> dimSizes; // per-dimension sizes
-  std::vector<Element<V>> elements;     // all COO elements
-  std::vector<uint64_t> coordinates;    // shared coordinate pool
+  std::vector<uint64_t> coordinates;    // packed coordinates of all elements
+  std::vector<V> values;                // values of all elements
   bool isSorted;
 };
 
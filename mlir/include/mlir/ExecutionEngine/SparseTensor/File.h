@@ -15,6 +15,10 @@
 // (2) Formidable Repository of Open Sparse Tensors and Tools (FROSTT): *.tns
 //     http://frostt.io/tensors/file-formats.html
 //
+// It also implements reading and writing of a binary container format,
+// which holds the storage scheme of a `SparseTensorStorage` verbatim so
+// that it can be loaded back without any parsing, sorting, or assembly.
+//
 // This file is part of the lightweight runtime support library for sparse
 // tensor manipulations.  The functionality of the support library is meant
 // to simplify benchmarking, testing, and debugging MLIR code operating on
@@ -26,10 +30,22 @@
 #ifndef MLIR_EXECUTIONENGINE_SPARSETENSOR_FILE_H
 #define MLIR_EXECUTIONENGINE_SPARSETENSOR_FILE_H
 
+#include "mlir/ExecutionEngine/SparseTensor/Parallel.h"
+#include "mlir/ExecutionEngine/SparseTensor/BlockMap.h"
 #include "mlir/ExecutionEngine/SparseTensor/PermutationRef.h"
 #include "mlir/ExecutionEngine/SparseTensor/Storage.h"
 
+#include <charconv>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
 
 namespace mlir {
 namespace sparse_tensor {
@@ -80,6 +96,113 @@ inline V readValue(char **linePtr, bool isPattern) {
   return isPattern ? readValue<V, true>(linePtr) : readValue<V, false>(linePtr);
 }
 
+/// Skips the spaces and tabs beginning at `ptr`, without going past `end`.
+inline const char *skipBlanks(const char *ptr, const char *end) {
+  while (ptr != end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\r'))
+    ++ptr;
+  return ptr;
+}
+
+/// Returns the position following the end of the line containing `ptr`,
+/// or `end` if that is the last line.
+inline const char *skipLine(const char *ptr, const char *end) {
+  const void *eol = memchr(ptr, '\n', end - ptr);
+  return eol ? static_cast<const char *>(eol) + 1 : end;
+}
+
+/// Returns the position of the first line beginning at `ptr` that isn't
+/// blank, or `end` if there is none.
+inline const char *skipBlankLines(const char *ptr, const char *end) {
+  while (true) {
+    const char *next = skipBlanks(ptr, end);
+    if (next == end || *next != '\n')
+      return ptr;
+    ptr = next + 1;
+  }
+}
+
+/// Parses an unsigned integer from the buffer beginning at `ptr`, which
+/// is advanced past it.  Unlike `strtoul`, this never reads past `end`,
+/// which allows for parsing buffers that aren't null-terminated.
+inline uint64_t parseUnsigned(const char *&ptr, const char *end) {
+  ptr = skipBlanks(ptr, end);
+  uint64_t result = 0;
+  for (; ptr != end && *ptr >= '0' && *ptr <= '9'; ++ptr)
+    result = result * 10 + static_cast<uint64_t>(*ptr - '0');
+  return result;
+}
+
+/// Parses a floating-point number from the buffer beginning at `ptr`,
+/// which is advanced past it, without reading past `end`.
+inline double parseDouble(const char *&ptr, const char *end) {
+  ptr = skipBlanks(ptr, end);
+  // Copy the token to a null-terminated buffer for `strtod`.
+  char token[64];
+  uint64_t size = 0;
+  for (; ptr != end && size < sizeof(token) - 1 && *ptr != ' ' &&
+         *ptr != '\t' && *ptr != '\r' && *ptr != '\n';
+       ++ptr)
+    token[size++] = *ptr;
+  token[size] = '\0';
+  return strtod(token, nullptr);
+}
+
+/// Parses an element-value of non-complex type from the buffer beginning
+/// at `ptr`, as per `readValue`.
+template <typename V, bool IsPattern>
+inline std::enable_if_t<!is_complex<V>::value, V>
+parseValue(const char *&ptr, const char *end) {
+  if constexpr (IsPattern)
+    return 1.0;
+  return parseDouble(ptr, end);
+}
+
+/// Parses an element-value of complex type from the buffer beginning at
+/// `ptr`, as per `readValue`.
+template <typename V, bool IsPattern>
+inline std::enable_if_t<is_complex<V>::value, V>
+parseValue(const char *&ptr, const char *end) {
+  if constexpr (IsPattern)
+    return V(1.0, 1.0);
+  double re = parseDouble(ptr, end);
+  double im = parseDouble(ptr, end);
+  return V(re, im);
+}
+
+/// Returns true if the coordinates `lhs` are lexicographically greater
+/// than the coordinates `rhs`, both of which must be valid for `rank`.
+template <typename C>
+inline bool isCoordsGreater(const C *lhs, const C *rhs, uint64_t rank) {
+  for (uint64_t l = 0; l < rank; ++l)
+    if (lhs[l] != rhs[l])
+      return lhs[l] > rhs[l];
+  return false;
+}
+
+/// This class provides read-only access to the contents of a file.  The
+/// file is mapped into memory where supported, and is otherwise read into
+/// a heap-allocated buffer.
+class MappedFile final {
+public:
+  /// Maps the file `filename`.  Exits with an error if that fails.
+  explicit MappedFile(const char *filename);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /// Gets the contents of the file.
+  const char *getData() const { return data; }
+
+  /// Gets the size of the file in bytes.
+  uint64_t getSize() const { return size; }
+
+private:
+  char *data = nullptr;
+  uint64_t size = 0;
+  bool isMapped = false;
+};
+
 } // namespace detail
 
 //===----------------------------------------------------------------------===//
@@ -210,19 +333,18 @@ public:
   }
 
   /// Allocates a new COO object for `lvlSizes`, initializes it by reading
-  /// all the elements from the file and applying `dim2lvl` to their
-  /// dim-coordinates, and then closes the file.
+  /// all the elements from the file and mapping their dim-coordinates to
+  /// level-coordinates, and then closes the file.  The mapping is the
+  /// `BlockMap` described by `lvl2dim` and `lvlSizes`, and thus supports
+  /// both permutations and blocked formats.
   ///
   /// Preconditions:
-  /// * `lvlSizes` must be valid for `lvlRank`.
-  /// * `dim2lvl` must be valid for `getRank()`.
-  /// * `dim2lvl` maps `getDimSizes()`-coordinates to `lvlSizes`-coordinates.
+  /// * `lvlSizes` and `lvl2dim` must be valid for `lvlRank`.
+  /// * `lvl2dim` maps `lvlSizes`-coordinates to `getDimSizes()`-coordinates.
   /// * the file's actual value type can be read as `V`.
   ///
   /// Asserts:
   /// * `isValid()`
-  /// * `dim2lvl` is a permutation, and therefore also `lvlRank == getRank()`.
-  ///   (This requirement will be lifted once we functionalize `dim2lvl`.)
   //
   // NOTE: This method is factored out of `readSparseTensor` primarily to
   // reduce code bloat (since the bulk of the code doesn't care about the
@@ -230,7 +352,7 @@ public:
   // perfectly reasonable for clients to use.
   template <typename V>
   SparseTensorCOO<V> *readCOO(uint64_t lvlRank, const uint64_t *lvlSizes,
-                              const uint64_t *dim2lvl);
+                              const uint64_t *lvl2dim);
 
   /// Allocates a new sparse-tensor storage object with the given encoding,
   /// initializes it by reading all the elements from the file, and then
@@ -239,9 +361,8 @@ public:
   template <typename P, typename I, typename V>
   SparseTensorStorage<P, I, V> *
   readSparseTensor(uint64_t lvlRank, const uint64_t *lvlSizes,
-                   const DimLevelType *lvlTypes, const uint64_t *lvl2dim,
-                   const uint64_t *dim2lvl) {
-    auto *lvlCOO = readCOO<V>(lvlRank, lvlSizes, dim2lvl);
+                   const DimLevelType *lvlTypes, const uint64_t *lvl2dim) {
+    auto *lvlCOO = readCOO<V>(lvlRank, lvlSizes, lvl2dim);
     auto *tensor = SparseTensorStorage<P, I, V>::newFromCOO(
         getRank(), getDimSizes(), lvlRank, lvlTypes, lvl2dim, *lvlCOO);
     delete lvlCOO;
@@ -285,21 +406,31 @@ private:
   /// The internal implementation of `readCOO`.  We template over
   /// `IsPattern` in order to perform LICM without needing to duplicate the
   /// source code.
-  //
-  // TODO: We currently take the `dim2lvl` argument as a `PermutationRef`
-  // since that's what `readCOO` creates.  Once we update `readCOO` to
-  // functionalize the mapping, then this helper will just take that
-  // same function.
   template <typename V, bool IsPattern>
-  void readCOOLoop(uint64_t lvlRank, detail::PermutationRef dim2lvl,
+  void readCOOLoop(const detail::BlockMap &dim2lvl,
                    SparseTensorCOO<V> *lvlCOO);
 
+  /// A range of whole lines of the input file, holding the elements with
+  /// positions `[firstElement, firstElement + numElements)`.
+  struct ElementChunk {
+    const char *begin;
+    const char *end;
+    uint64_t firstElement;
+    uint64_t numElements;
+  };
+
+  /// Maps the remainder of the input file, which holds the elements, into
+  /// memory and splits it into chunks of whole lines that can be parsed
+  /// independently.  The chunks hold exactly `getNSE()` elements; any
+  /// trailing lines are ignored.
+  std::vector<ElementChunk> mapElementChunks();
+
   /// The internal implementation of `readToBuffers`.  We template over
   /// `IsPattern` in order to perform LICM without needing to duplicate the
   /// source code.
   template <typename C, typename V, bool IsPattern>
-  bool readToBuffersLoop(uint64_t lvlRank, detail::PermutationRef dim2lvl,
-                         C *lvlCoordinates, V *values);
+  bool readToBuffersLoop(const detail::BlockMap &dim2lvl, C *lvlCoordinates,
+                         V *values);
 
   /// Reads the MME header of a general sparse matrix of type real.
   void readMMEHeader();
@@ -311,8 +442,11 @@ private:
   void readExtFROSTTHeader();
 
   static constexpr int kColWidth = 1025;
+  /// The minimum number of bytes of elements parsed by a single thread.
+  static constexpr uint64_t kMinChunkSize = 1 << 20;
   const char *const filename;
   FILE *file = nullptr;
+  std::unique_ptr<detail::MappedFile> mappedFile;
   ValueKind valueKind_ = ValueKind::kInvalid;
   bool isSymmetric_ = false;
   uint64_t idata[512];
@@ -324,45 +458,35 @@ private:
 template <typename V>
 SparseTensorCOO<V> *SparseTensorReader::readCOO(uint64_t lvlRank,
                                                 const uint64_t *lvlSizes,
-                                                const uint64_t *dim2lvl) {
+                                                const uint64_t *lvl2dim) {
   assert(isValid() && "Attempt to readCOO() before readHeader()");
-  // Construct a `PermutationRef` for the `pushforward` below.
-  // TODO: This specific implementation does not generalize to arbitrary
-  // mappings, but once we functionalize the `dim2lvl` argument we can
-  // simply use that function instead.
-  const uint64_t dimRank = getRank();
-  assert(lvlRank == dimRank && "Rank mismatch");
-  detail::PermutationRef d2l(dimRank, dim2lvl);
+  const detail::BlockMap d2l(getRank(), lvlRank, lvlSizes, lvl2dim);
   // Prepare a COO object with the number of stored elems as initial capacity.
   auto *lvlCOO = new SparseTensorCOO<V>(lvlRank, lvlSizes, getNSE());
   // Do some manual LICM, to avoid assertions in the for-loop.
   const bool IsPattern = isPattern();
   if (IsPattern)
-    readCOOLoop<V, true>(lvlRank, d2l, lvlCOO);
+    readCOOLoop<V, true>(d2l, lvlCOO);
   else
-    readCOOLoop<V, false>(lvlRank, d2l, lvlCOO);
+    readCOOLoop<V, false>(d2l, lvlCOO);
   // Close the file and return the COO.
   closeFile();
   return lvlCOO;
 }
 
 template <typename V, bool IsPattern>
-void SparseTensorReader::readCOOLoop(uint64_t lvlRank,
-                                     detail::PermutationRef dim2lvl,
+void SparseTensorReader::readCOOLoop(const detail::BlockMap &dim2lvl,
                                      SparseTensorCOO<V> *lvlCOO) {
-  const uint64_t dimRank = getRank();
-  std::vector<uint64_t> dimCoords(dimRank);
-  std::vector<uint64_t> lvlCoords(lvlRank);
-  for (uint64_t nse = getNSE(), k = 0; k < nse; ++k) {
-    // We inline `readElement` here in order to avoid redundant
-    // assertions, since they're guaranteed by the call to `isValid()`
-    // and the construction of `dimCoords` above.
-    char *linePtr = readCoords(dimCoords.data());
-    const V value = detail::readValue<V, IsPattern>(&linePtr);
-    dim2lvl.pushforward(dimRank, dimCoords.data(), lvlCoords.data());
-    // TODO: <https://github.com/llvm/llvm-project/issues/54179>
-    lvlCOO->add(lvlCoords, value);
-  }
+  // Parse all of the elements in parallel into flat buffers, and then
+  // add them to the COO in order.
+  const uint64_t lvlRank = dim2lvl.getLvlRank();
+  const uint64_t nse = getNSE();
+  std::vector<uint64_t> lvlCoordinates(nse * lvlRank);
+  std::vector<V> values(nse);
+  readToBuffersLoop<uint64_t, V, IsPattern>(dim2lvl, lvlCoordinates.data(),
+                                            values.data());
+  for (uint64_t k = 0; k < nse; ++k)
+    lvlCOO->add(lvlCoordinates.data() + k * lvlRank, values[k]);
 }
 
 template <typename C, typename V>
@@ -370,19 +494,21 @@ bool SparseTensorReader::readToBuffers(uint64_t lvlRank,
                                        const uint64_t *dim2lvl,
                                        C *lvlCoordinates, V *values) {
   assert(isValid() && "Attempt to readCOO() before readHeader()");
-  // Construct a `PermutationRef` for the `pushforward` below.
-  // TODO: This specific implementation does not generalize to arbitrary
-  // mappings, but once we functionalize the `dim2lvl` argument we can
-  // simply use that function instead.
+  // TODO: The buffers are only ever read for permutations, so we take the
+  // `dim2lvl` argument as one and convert it into the equivalent `BlockMap`.
   const uint64_t dimRank = getRank();
   assert(lvlRank == dimRank && "Rank mismatch");
-  detail::PermutationRef d2l(dimRank, dim2lvl);
+  const detail::PermutationRef perm(dimRank, dim2lvl);
+  const std::vector<uint64_t> lvl2dim = perm.inverse();
+  const std::vector<uint64_t> lvlSizes =
+      perm.pushforward(dimRank, getDimSizes());
+  const detail::BlockMap d2l(dimRank, lvlRank, lvlSizes.data(),
+                             lvl2dim.data());
   // Do some manual LICM, to avoid assertions in the for-loop.
   bool isSorted =
       isPattern()
-          ? readToBuffersLoop<C, V, true>(lvlRank, d2l, lvlCoordinates, values)
-          : readToBuffersLoop<C, V, false>(lvlRank, d2l, lvlCoordinates,
-                                           values);
+          ? readToBuffersLoop<C, V, true>(d2l, lvlCoordinates, values)
+          : readToBuffersLoop<C, V, false>(d2l, lvlCoordinates, values);
 
   // Close the file and return isSorted.
   closeFile();
@@ -390,75 +516,525 @@ bool SparseTensorReader::readToBuffers(uint64_t lvlRank,
 }
 
 template <typename C, typename V, bool IsPattern>
-bool SparseTensorReader::readToBuffersLoop(uint64_t lvlRank,
-                                           detail::PermutationRef dim2lvl,
+bool SparseTensorReader::readToBuffersLoop(const detail::BlockMap &dim2lvl,
                                            C *lvlCoordinates, V *values) {
   const uint64_t dimRank = getRank();
-  const uint64_t nse = getNSE();
-  std::vector<C> dimCoords(dimRank);
-  // Read the first element with isSorted=false as a way to avoid accessing its
-  // previous element.
-  bool isSorted = false;
-  char *linePtr;
-  // We inline `readElement` here in order to avoid redundant assertions,
-  // since they're guaranteed by the call to `isValid()` and the construction
-  // of `dimCoords` above.
-  const auto readNextElement = [&]() {
-    linePtr = readCoords<C>(dimCoords.data());
-    dim2lvl.pushforward(dimRank, dimCoords.data(), lvlCoordinates);
-    *values = detail::readValue<V, IsPattern>(&linePtr);
-    if (isSorted) {
-      // Note that isSorted was set to false while reading the first element,
-      // to guarantee the safeness of using prevLvlCoords.
-      C *prevLvlCoords = lvlCoordinates - lvlRank;
-      // TODO: define a new CoordsLT which is like ElementLT but doesn't have
-      // the V parameter, and use it here.
-      for (uint64_t l = 0; l < lvlRank; ++l) {
-        if (prevLvlCoords[l] != lvlCoordinates[l]) {
-          if (prevLvlCoords[l] > lvlCoordinates[l])
-            isSorted = false;
-          break;
-        }
+  const uint64_t lvlRank = dim2lvl.getLvlRank();
+  // Parse the chunks of elements in parallel, each directly into its own
+  // slice of the buffers.
+  const std::vector<ElementChunk> chunks = mapElementChunks();
+  std::vector<uint8_t> isChunkSorted(chunks.size());
+  detail::parallelInvoke(chunks.size(), [&](uint64_t i) {
+    const ElementChunk &chunk = chunks[i];
+    std::vector<C> dimCoords(dimRank);
+    C *chunkCoordinates = lvlCoordinates + chunk.firstElement * lvlRank;
+    V *chunkValues = values + chunk.firstElement;
+    const char *ptr = chunk.begin;
+    bool isSorted = true;
+    for (uint64_t k = 0; k < chunk.numElements; ++k) {
+      ptr = detail::skipBlankLines(ptr, chunk.end);
+      for (uint64_t d = 0; d < dimRank; ++d) {
+        // Parse the 1-based coordinate, and store the 0-based coordinate.
+        const uint64_t c = detail::parseUnsigned(ptr, chunk.end);
+        dimCoords[d] = static_cast<C>(c - 1);
       }
+      *chunkValues = detail::parseValue<V, IsPattern>(ptr, chunk.end);
+      ptr = detail::skipLine(ptr, chunk.end);
+      dim2lvl.pushforward(dimCoords.data(), chunkCoordinates);
+      if (k != 0 && isSorted)
+        isSorted = !detail::isCoordsGreater(chunkCoordinates - lvlRank,
+                                            chunkCoordinates, lvlRank);
+      chunkCoordinates += lvlRank;
+      ++chunkValues;
     }
-    lvlCoordinates += lvlRank;
-    ++values;
-  };
-  readNextElement();
-  isSorted = true;
-  for (uint64_t n = 1; n < nse; ++n)
-    readNextElement();
+    isChunkSorted[i] = isSorted;
+  });
 
-  return isSorted;
+  // The elements are sorted if each of the chunks is, and if each chunk
+  // starts after the end of the previous one.
+  for (uint64_t i = 0, e = chunks.size(); i < e; ++i) {
+    if (!isChunkSorted[i])
+      return false;
+    const uint64_t first = chunks[i].firstElement;
+    if (first != 0 && chunks[i].numElements != 0 &&
+        detail::isCoordsGreater(lvlCoordinates + (first - 1) * lvlRank,
+                                lvlCoordinates + first * lvlRank, lvlRank))
+      return false;
+  }
+  return true;
+}
+
+namespace detail {
+
+/// Appends the textual form of `value` to `out`.  This matches the output
+/// of a `std::ostream` with the default flags, except that the 8-bit
+/// integers are written as numbers rather than as characters.
+template <typename V>
+inline void appendValue(std::string &out, V value) {
+  if constexpr (std::is_integral_v<V>) {
+    char buf[24];
+    const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out.append(buf, result.ptr);
+  } else if constexpr (std::is_floating_point_v<V>) {
+    // The `%g` conversion is what `std::ostream` uses for its default
+    // precision of 6.  Not all C++17 libraries implement `std::to_chars`
+    // for floating-point values with a precision.
+    char buf[32];
+    const int length =
+        snprintf(buf, sizeof(buf), "%g", static_cast<double>(value));
+    out.append(buf, length);
+  } else {
+    std::ostringstream os;
+    os << value;
+    out += os.str();
+  }
+}
+
+/// Appends an element in the extended FROSTT format to `out`, namely its
+/// one-based coordinates and its value on a line of their own.
+template <typename V>
+inline void appendElement(std::string &out, const uint64_t *dimCoords,
+                          uint64_t dimRank, V value) {
+  for (uint64_t d = 0; d < dimRank; ++d) {
+    appendValue(out, dimCoords[d] + 1);
+    out += ' ';
+  }
+  appendValue(out, value);
+  out += '\n';
+}
+
+/// Appends the dimension-rank, the number of stored elements, and the
+/// dimension-sizes lines of the extended FROSTT format to `out`.
+inline void appendMetaData(std::string &out, uint64_t dimRank, uint64_t nse,
+                           const uint64_t *dimSizes) {
+  assert(dimRank != 0 && "Trivial shape is not supported");
+  appendValue(out, dimRank);
+  out += ' ';
+  appendValue(out, nse);
+  out += '\n';
+  for (uint64_t d = 0; d < dimRank; ++d) {
+    appendValue(out, dimSizes[d]);
+    out += d == dimRank - 1 ? '\n' : ' ';
+  }
 }
 
+/// This class writes text to a file through a large buffer, such that the
+/// many small writes of the elements do not each go through the I/O library.
+class TextWriter final {
+public:
+  /// Opens `filename` for writing, or uses the standard output when the
+  /// filename is empty.
+  explicit TextWriter(const char *filename) : filename(filename) {
+    assert(filename && "Got nullptr for filename");
+    file = filename[0] == 0 ? stdout : fopen(filename, "w");
+    if (!file)
+      MLIR_SPARSETENSOR_FATAL("Cannot open %s\n", filename);
+    buffer.reserve(kCapacity);
+  }
+  ~TextWriter() {
+    flush();
+    if (file == stdout ? fflush(file) != 0 : fclose(file) != 0)
+      MLIR_SPARSETENSOR_FATAL("Cannot write %s\n", filename.c_str());
+  }
+
+  TextWriter(const TextWriter &) = delete;
+  TextWriter &operator=(const TextWriter &) = delete;
+
+  /// Returns the buffer to append text to.  Call `flushIfFull` after
+  /// appending to it.
+  std::string &getBuffer() { return buffer; }
+
+  /// Writes out the buffer once it holds enough text.
+  void flushIfFull() {
+    if (buffer.size() >= kCapacity)
+      flush();
+  }
+
+  /// Writes out the buffer, and then `text` without copying it.
+  void write(std::string_view text) {
+    flush();
+    writeRaw(text);
+  }
+
+  /// Writes out the buffer.
+  void flush() {
+    writeRaw(buffer);
+    buffer.clear();
+  }
+
+private:
+  static constexpr uint64_t kCapacity = 1 << 20;
+
+  void writeRaw(std::string_view text) {
+    if (!text.empty() &&
+        fwrite(text.data(), 1, text.size(), file) != text.size())
+      MLIR_SPARSETENSOR_FATAL("Cannot write %s\n", filename.c_str());
+  }
+
+  FILE *file;
+  const std::string filename;
+  std::string buffer;
+};
+
+/// The minimal number of elements which each thread formats when writing
+/// a sparse tensor in parallel.
+constexpr uint64_t kMinFormatChunkSize = 1 << 16;
+
+} // namespace detail
+
 /// Writes the sparse tensor to `filename` in extended FROSTT format.
+/// The elements are formatted in batches, in which each thread formats
+/// a contiguous range of elements into its own buffer, and the buffers
+/// are then written out in order.
 template <typename V>
 inline void writeExtFROSTT(const SparseTensorCOO<V> &coo,
                            const char *filename) {
   assert(filename && "Got nullptr for filename");
-  const auto &dimSizes = coo.getDimSizes();
-  const auto &elements = coo.getElements();
   const uint64_t dimRank = coo.getRank();
-  const uint64_t nse = elements.size();
-  std::fstream file;
-  file.open(filename, std::ios_base::out | std::ios_base::trunc);
-  assert(file.is_open());
-  file << "; extended FROSTT format\n" << dimRank << " " << nse << std::endl;
-  for (uint64_t d = 0; d < dimRank - 1; ++d)
-    file << dimSizes[d] << " ";
-  file << dimSizes[dimRank - 1] << std::endl;
-  for (uint64_t i = 0; i < nse; ++i) {
-    const auto &coords = elements[i].coords;
-    for (uint64_t d = 0; d < dimRank; ++d)
-      file << (coords[d] + 1) << " ";
-    file << elements[i].value << std::endl;
-  }
-  file.flush();
-  file.close();
-  assert(file.good());
+  const uint64_t nse = coo.getNSE();
+  detail::TextWriter writer(filename);
+  writer.getBuffer() += "; extended FROSTT format\n";
+  detail::appendMetaData(writer.getBuffer(), dimRank, nse,
+                         coo.getDimSizes().data());
+  const uint64_t numThreads =
+      detail::getNumThreads(nse, detail::kMinFormatChunkSize);
+  const uint64_t batchSize = numThreads * detail::kMinFormatChunkSize;
+  std::vector<std::string> chunks(numThreads);
+  for (uint64_t batchBegin = 0; batchBegin < nse; batchBegin += batchSize) {
+    const uint64_t batchEnd = std::min(nse, batchBegin + batchSize);
+    const uint64_t batchNSE = batchEnd - batchBegin;
+    detail::parallelInvoke(numThreads, [&](uint64_t t) {
+      std::string &chunk = chunks[t];
+      chunk.clear();
+      const uint64_t lo = batchBegin + batchNSE * t / numThreads;
+      const uint64_t hi = batchBegin + batchNSE * (t + 1) / numThreads;
+      for (uint64_t i = lo; i < hi; ++i)
+        detail::appendElement(chunk, coo.getCoords(i), dimRank,
+                              coo.getValue(i));
+    });
+    for (const std::string &chunk : chunks)
+      writer.write(chunk);
+  }
 }
 
+//===----------------------------------------------------------------------===//
+//
+// The binary container format consists of a sequence of native-endian
+// `uint64_t` fields and arrays, where each array is prefixed by its number
+// of elements and padded to a multiple of 8 bytes:
+//
+//   magic  sizeof(P)  sizeof(C)  valTp
+//   dimSizes[]  lvlSizes[]  lvlTypes[] (as `uint8_t`)  lvl2dim[]
+//   positions[0][]  coordinates[0][]  ...  positions[L-1][]  coordinates[L-1][]
+//   values[]
+//
+// The format is meant for quickly reloading tensors on the machine that
+// wrote them, and is therefore not portable across endianness.
+//
+//===----------------------------------------------------------------------===//
+
+namespace detail {
+
+/// The magic number which identifies the binary container format.
+constexpr char kBinaryMagic[8] = {'M', 'L', 'I', 'R', 'S', 'P', 'T', '1'};
+
+/// Rounds `numBytes` up to a multiple of 8.
+inline uint64_t alignTo8(uint64_t numBytes) { return (numBytes + 7) & ~7ull; }
+
+/// This class reads the fields of the binary container format from a
+/// mapped file, exiting with an error if the file is truncated.
+class BinaryReaderCursor final {
+public:
+  BinaryReaderCursor(const MappedFile &file, const char *filename)
+      : ptr(file.getData()), end(file.getData() + file.getSize()),
+        filename(filename) {}
+
+  /// Returns the next `numBytes` bytes, and advances past them and their
+  /// padding.
+  const char *read(uint64_t numBytes) {
+    const uint64_t remaining = static_cast<uint64_t>(end - ptr);
+    if (numBytes > remaining || alignTo8(numBytes) > remaining)
+      MLIR_SPARSETENSOR_FATAL("Corrupt binary sparse tensor file %s\n",
+                              filename);
+    const char *result = ptr;
+    ptr += alignTo8(numBytes);
+    return result;
+  }
+
+  uint64_t readU64() {
+    uint64_t result;
+    memcpy(&result, read(sizeof(uint64_t)), sizeof(uint64_t));
+    return result;
+  }
+
+  /// Reads a length-prefixed array into `out`.
+  template <typename T>
+  void readArray(std::vector<T> &out) {
+    const uint64_t size = readU64();
+    if (size > static_cast<uint64_t>(end - ptr) / sizeof(T))
+      MLIR_SPARSETENSOR_FATAL("Corrupt binary sparse tensor file %s\n",
+                              filename);
+    out.resize(size);
+    if (size != 0)
+      memcpy(out.data(), read(size * sizeof(T)), size * sizeof(T));
+  }
+
+private:
+  const char *ptr;
+  const char *const end;
+  const char *const filename;
+};
+
+/// This class writes the fields of the binary container format to a file.
+class BinaryWriter final {
+public:
+  explicit BinaryWriter(const char *filename) : filename(filename) {
+    file = fopen(filename, "wb");
+    if (!file)
+      MLIR_SPARSETENSOR_FATAL("Cannot open %s\n", filename);
+  }
+  ~BinaryWriter() {
+    if (fclose(file) != 0)
+      MLIR_SPARSETENSOR_FATAL("Cannot write %s\n", filename);
+  }
+
+  BinaryWriter(const BinaryWriter &) = delete;
+  BinaryWriter &operator=(const BinaryWriter &) = delete;
+
+  /// Writes `numBytes` bytes from `data`, followed by their padding.
+  void write(const void *data, uint64_t numBytes) {
+    static const char zeros[8] = {};
+    if (numBytes == 0)
+      return;
+    if (fwrite(data, 1, numBytes, file) != numBytes ||
+        fwrite(zeros, 1, alignTo8(numBytes) - numBytes, file) !=
+            alignTo8(numBytes) - numBytes)
+      MLIR_SPARSETENSOR_FATAL("Cannot write %s\n", filename);
+  }
+
+  void writeU64(uint64_t value) { write(&value, sizeof(uint64_t)); }
+
+  /// Writes a length-prefixed array.
+  template <typename T>
+  void writeArray(const T *data, uint64_t size) {
+    writeU64(size);
+    write(data, size * sizeof(T));
+  }
+
+private:
+  FILE *file;
+  const char *const filename;
+};
+
+} // namespace detail
+
+/// Writes the storage scheme of the sparse tensor to `filename` in the
+/// binary container format.
+template <typename P, typename C, typename V>
+inline void writeBinary(SparseTensorStorage<P, C, V> &tensor,
+                        PrimaryType valTp, const char *filename) {
+  assert(filename && "Got nullptr for filename");
+  const uint64_t lvlRank = tensor.getLvlRank();
+  const auto &dimSizes = tensor.getDimSizes();
+  const auto &lvlSizes = tensor.getLvlSizes();
+  const auto &lvl2dim = tensor.getLvl2Dim();
+  std::vector<uint8_t> lvlTypes;
+  lvlTypes.reserve(lvlRank);
+  for (const DimLevelType dlt : tensor.getLvlTypes())
+    lvlTypes.push_back(static_cast<uint8_t>(dlt));
+  detail::BinaryWriter writer(filename);
+  writer.write(detail::kBinaryMagic, sizeof(detail::kBinaryMagic));
+  writer.writeU64(sizeof(P));
+  writer.writeU64(sizeof(C));
+  writer.writeU64(static_cast<uint64_t>(valTp));
+  writer.writeArray(dimSizes.data(), dimSizes.size());
+  writer.writeArray(lvlSizes.data(), lvlSizes.size());
+  writer.writeArray(lvlTypes.data(), lvlTypes.size());
+  writer.writeArray(lvl2dim.data(), lvl2dim.size());
+  for (uint64_t l = 0; l < lvlRank; ++l) {
+    std::vector<P> *positions;
+    std::vector<C> *coordinates;
+    tensor.getPositions(&positions, l);
+    tensor.getCoordinates(&coordinates, l);
+    writer.writeArray(positions->data(), positions->size());
+    writer.writeArray(coordinates->data(), coordinates->size());
+  }
+  std::vector<V> *values;
+  tensor.getValues(&values);
+  writer.writeArray(values->data(), values->size());
+}
+
+/// Reads a sparse tensor from `filename` in the binary container format,
+/// verifying that it was written with the same types, and that its
+/// dimension-sizes match `dimShape` (where zero stands for a dynamic size).
+/// The storage scheme is loaded as is, rather than being reassembled.
+template <typename P, typename C, typename V>
+inline SparseTensorStorage<P, C, V> *
+readBinary(const char *filename, PrimaryType valTp, uint64_t dimRank,
+           const uint64_t *dimShape) {
+  assert(filename && "Got nullptr for filename");
+  assert(dimShape && "Got nullptr for dimension shape");
+  const detail::MappedFile file(filename);
+  detail::BinaryReaderCursor cursor(file, filename);
+  if (memcmp(cursor.read(sizeof(detail::kBinaryMagic)), detail::kBinaryMagic,
+             sizeof(detail::kBinaryMagic)) != 0)
+    MLIR_SPARSETENSOR_FATAL("Not a binary sparse tensor file: %s\n",
+                            filename);
+  if (cursor.readU64() != sizeof(P) || cursor.readU64() != sizeof(C) ||
+      cursor.readU64() != static_cast<uint64_t>(valTp))
+    MLIR_SPARSETENSOR_FATAL("Element types do not match in %s\n", filename);
+  std::vector<uint64_t> dimSizes, lvlSizes, lvl2dim;
+  std::vector<uint8_t> lvlTypeBytes;
+  cursor.readArray(dimSizes);
+  cursor.readArray(lvlSizes);
+  cursor.readArray(lvlTypeBytes);
+  cursor.readArray(lvl2dim);
+  const uint64_t lvlRank = lvlSizes.size();
+  if (dimSizes.size() != dimRank || lvlTypeBytes.size() != lvlRank ||
+      lvl2dim.size() != lvlRank)
+    MLIR_SPARSETENSOR_FATAL("Rank mismatch in %s\n", filename);
+  for (uint64_t d = 0; d < dimRank; ++d)
+    if (dimShape[d] != 0 && dimShape[d] != dimSizes[d])
+      MLIR_SPARSETENSOR_FATAL("Dimension size mismatch in %s\n", filename);
+  std::vector<DimLevelType> lvlTypes;
+  lvlTypes.reserve(lvlRank);
+  for (const uint8_t dlt : lvlTypeBytes)
+    lvlTypes.push_back(static_cast<DimLevelType>(dlt));
+  std::vector<std::vector<P>> positions(lvlRank);
+  std::vector<std::vector<C>> coordinates(lvlRank);
+  for (uint64_t l = 0; l < lvlRank; ++l) {
+    cursor.readArray(positions[l]);
+    cursor.readArray(coordinates[l]);
+  }
+  std::vector<V> values;
+  cursor.readArray(values);
+  return SparseTensorStorage<P, C, V>::newFromBuffers(
+      dimRank, dimSizes.data(), lvlRank, lvlSizes.data(), lvlTypes.data(),
+      lvl2dim.data(), std::move(positions), std::move(coordinates),
+      std::move(values));
+}
+
+/// Writes the elements of `coo` to `filename` in the binary container
+/// format, with a COO storage scheme of 64-bit positions and coordinates.
+template <typename V>
+inline void writeBinaryCOO(SparseTensorCOO<V> &coo, PrimaryType valTp,
+                           const char *filename) {
+  const uint64_t rank = coo.getRank();
+  std::vector<DimLevelType> lvlTypes(rank, DimLevelType::SingletonNu);
+  lvlTypes[0] = rank == 1 ? DimLevelType::Compressed
+                          : DimLevelType::CompressedNu;
+  if (rank > 1)
+    lvlTypes[rank - 1] = DimLevelType::Singleton;
+  std::vector<uint64_t> identity(rank);
+  std::iota(identity.begin(), identity.end(), 0);
+  std::unique_ptr<SparseTensorStorage<uint64_t, uint64_t, V>> tensor(
+      SparseTensorStorage<uint64_t, uint64_t, V>::newFromCOO(
+          rank, coo.getDimSizes().data(), rank, lvlTypes.data(),
+          identity.data(), coo));
+  writeBinary(*tensor, valTp, filename);
+}
+
+/// This class implements the streaming writer of the runtime library,
+/// which outputs the elements of a sparse tensor one at a time.  In the
+/// extended FROSTT format, the elements are formatted into the buffer of
+/// a `TextWriter`.  In the binary container format, the elements are
+/// collected into a COO, which is written out when the writer is deleted,
+/// since the storage scheme can only be built once all elements are known.
+class SparseTensorWriter final {
+public:
+  /// Creates a writer to `filename` in the extended FROSTT format, or in the
+  /// binary container format for values of type `binaryValTp` when it is
+  /// given.  An empty filename writes the text to the standard output.
+  explicit SparseTensorWriter(
+      const char *filename,
+      std::optional<PrimaryType> binaryValTp = std::nullopt)
+      : filename(filename), binaryValTp(binaryValTp) {
+    assert(filename && "Got nullptr for filename");
+    if (binaryValTp) {
+      if (filename[0] == 0)
+        MLIR_SPARSETENSOR_FATAL("Binary output requires a filename\n");
+      return;
+    }
+    text = std::make_unique<detail::TextWriter>(filename);
+    text->getBuffer() += "# extended FROSTT format\n";
+  }
+  ~SparseTensorWriter() {
+    if (!binaryValTp)
+      return;
+    if (!coo)
+      MLIR_SPARSETENSOR_FATAL("No metadata written to %s\n", filename.c_str());
+    coo->write(filename.c_str());
+  }
+
+  SparseTensorWriter(const SparseTensorWriter &) = delete;
+  SparseTensorWriter &operator=(const SparseTensorWriter &) = delete;
+
+  /// Outputs the dimension-rank, the number of stored elements, and the
+  /// dimension-sizes.
+  void writeMetaData(uint64_t dimRank, uint64_t nse,
+                     const uint64_t *dimSizes) {
+    if (binaryValTp) {
+      switch (*binaryValTp) {
+#define CASE(VNAME, V)                                                         \
+  case PrimaryType::k##VNAME:                                                  \
+    coo = std::make_unique<COOSink<V>>(*binaryValTp, dimRank, dimSizes, nse);  \
+    return;
+        MLIR_SPARSETENSOR_FOREVERY_V(CASE)
+#undef CASE
+      }
+      MLIR_SPARSETENSOR_FATAL("Unsupported value type: %d\n",
+                              static_cast<int>(*binaryValTp));
+    }
+    detail::appendMetaData(text->getBuffer(), dimRank, nse, dimSizes);
+    text->flushIfFull();
+  }
+
+  /// Outputs an element with the given dimension-coordinates and value,
+  /// whose type is `valTp`.
+  template <typename V>
+  void writeElement(PrimaryType valTp, uint64_t dimRank,
+                    const uint64_t *dimCoords, V value) {
+    if (!binaryValTp) {
+      detail::appendElement(text->getBuffer(), dimCoords, dimRank, value);
+      text->flushIfFull();
+      return;
+    }
+    if (!coo)
+      MLIR_SPARSETENSOR_FATAL("Elements written before the metadata of %s\n",
+                              filename.c_str());
+    if (valTp != *binaryValTp)
+      MLIR_SPARSETENSOR_FATAL("Element type mismatch in %s\n",
+                              filename.c_str());
+    auto &sink = static_cast<COOSink<V> &>(*coo);
+    assert(dimRank == sink.coo.getRank() && "Rank mismatch");
+    sink.coo.add(dimCoords, value);
+  }
+
+private:
+  /// The elements collected for the binary container format, behind a
+  /// base class which hides their value type.
+  struct COOSinkBase {
+    virtual ~COOSinkBase() = default;
+    virtual void write(const char *filename) = 0;
+  };
+  template <typename V>
+  struct COOSink final : public COOSinkBase {
+    COOSink(PrimaryType valTp, uint64_t dimRank, const uint64_t *dimSizes,
+            uint64_t nse)
+        : valTp(valTp), coo(dimRank, dimSizes, nse) {}
+    void write(const char *filename) override {
+      writeBinaryCOO(coo, valTp, filename);
+    }
+    const PrimaryType valTp;
+    SparseTensorCOO<V> coo;
+  };
+
+  const std::string filename;
+  const std::optional<PrimaryType> binaryValTp;
+  std::unique_ptr<detail::TextWriter> text;
+  std::unique_ptr<COOSinkBase> coo;
+};
+
 } // namespace sparse_tensor
 } // namespace mlir
 
@@ -0,0 +1,145 @@
+//===- Parallel.h - Multithreading helpers for the runtime ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This header is not part of the public API.  It is placed in the
+// includes directory only because that's required by the implementations
+// of template-classes.
+//
+// Since the runtime library cannot depend on LLVM's threading support,
+// this file provides the minimal helpers needed for splitting work between
+// `std::thread`s.
+//
+// This file is part of the lightweight runtime support library for sparse
+// tensor manipulations.  The functionality of the support library is meant
+// to simplify benchmarking, testing, and debugging MLIR code operating on
+// sparse tensors.  However, the provided functionality is **not** part of
+// core MLIR itself.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_EXECUTIONENGINE_SPARSETENSOR_PARALLEL_H
+#define MLIR_EXECUTIONENGINE_SPARSETENSOR_PARALLEL_H
+
+#include <algorithm>
+#include <cinttypes>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace mlir {
+namespace sparse_tensor {
+namespace detail {
+
+/// Returns the number of threads between which to split `numItems` items
+/// of work, such that each thread gets at least `minItemsPerThread` items
+/// to amortize its startup.  Always returns at least one.
+inline uint64_t getNumThreads(uint64_t numItems, uint64_t minItemsPerThread) {
+  const uint64_t numHardwareThreads =
+      std::max<uint64_t>(1, std::thread::hardware_concurrency());
+  return std::max<uint64_t>(
+      1, std::min(numHardwareThreads, numItems / minItemsPerThread));
+}
+
+/// Invokes `fn` on each of the thread positions in `[0, numThreads)`,
+/// each on its own thread.  The first one runs on the calling thread.
+inline void parallelInvoke(uint64_t numThreads,
+                           const std::function<void(uint64_t)> &fn) {
+  if (numThreads == 0)
+    return;
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+  for (uint64_t i = 1; i < numThreads; ++i)
+    threads.emplace_back(fn, i);
+  fn(0);
+  for (std::thread &thread : threads)
+    thread.join();
+}
+
+/// Writes the running sums of `counts` to `sums`, such that `sums[0] = 0`
+/// and `sums[i + 1] = sums[i] + counts[i]`, converting each sum with
+/// `cast`.  Each of `numThreads` threads first sums a contiguous range of
+/// `counts`, and then writes the running sums of its range, offset by the
+/// sums of the preceding ranges.
+template <typename T, typename Cast>
+inline void parallelPrefixSum(const std::vector<uint64_t> &counts, T *sums,
+                              uint64_t numThreads, Cast cast) {
+  const uint64_t size = counts.size();
+  sums[0] = cast(0);
+  if (numThreads <= 1 || size < numThreads) {
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < size; ++i) {
+      sum += counts[i];
+      sums[i + 1] = cast(sum);
+    }
+    return;
+  }
+  std::vector<uint64_t> offsets(numThreads + 1, 0);
+  parallelInvoke(numThreads, [&](uint64_t t) {
+    uint64_t sum = 0;
+    for (uint64_t i = t * size / numThreads, e = (t + 1) * size / numThreads;
+         i < e; ++i)
+      sum += counts[i];
+    offsets[t + 1] = sum;
+  });
+  for (uint64_t t = 0; t < numThreads; ++t)
+    offsets[t + 1] += offsets[t];
+  parallelInvoke(numThreads, [&](uint64_t t) {
+    uint64_t sum = offsets[t];
+    for (uint64_t i = t * size / numThreads, e = (t + 1) * size / numThreads;
+         i < e; ++i) {
+      sum += counts[i];
+      sums[i + 1] = cast(sum);
+    }
+  });
+}
+
+/// Sorts `data` by sorting `numThreads` runs of it in parallel, and then
+/// merging pairs of runs in parallel until a single one remains.  This
+/// requires `T` to be default-constructible, for the merge buffer.
+template <typename T, typename Compare>
+inline void parallelSort(std::vector<T> &data, Compare lt,
+                         uint64_t numThreads) {
+  const uint64_t size = data.size();
+  if (numThreads <= 1) {
+    std::sort(data.begin(), data.end(), lt);
+    return;
+  }
+  std::vector<uint64_t> bounds(numThreads + 1);
+  for (uint64_t i = 0; i <= numThreads; ++i)
+    bounds[i] = i * size / numThreads;
+  parallelInvoke(numThreads, [&](uint64_t i) {
+    std::sort(data.begin() + bounds[i], data.begin() + bounds[i + 1], lt);
+  });
+  // Merge back and forth between the data and a scratch buffer.
+  std::vector<T> scratch(size);
+  std::vector<T> *src = &data;
+  std::vector<T> *dst = &scratch;
+  while (bounds.size() > 2) {
+    const uint64_t numRuns = bounds.size() - 1;
+    parallelInvoke((numRuns + 1) / 2, [&](uint64_t i) {
+      const auto begin = src->begin() + bounds[2 * i];
+      const auto mid = src->begin() + bounds[std::min(2 * i + 1, numRuns)];
+      const auto end = src->begin() + bounds[std::min(2 * i + 2, numRuns)];
+      std::merge(begin, mid, mid, end, dst->begin() + bounds[2 * i], lt);
+    });
+    std::vector<uint64_t> mergedBounds;
+    for (uint64_t i = 0; i < numRuns; i += 2)
+      mergedBounds.push_back(bounds[i]);
+    mergedBounds.push_back(size);
+    bounds = std::move(mergedBounds);
+    std::swap(src, dst);
+  }
+  if (src != &data)
+    data.swap(scratch);
+}
+
+} // namespace detail
+} // namespace sparse_tensor
+} // namespace mlir
+
+#endif // MLIR_EXECUTIONENGINE_SPARSETENSOR_PARALLEL_H
@@ -37,8 +37,13 @@
 #include "mlir/ExecutionEngine/Float16bits.h"
 #include "mlir/ExecutionEngine/SparseTensor/ArithmeticUtils.h"
 #include "mlir/ExecutionEngine/SparseTensor/Attributes.h"
+#include "mlir/ExecutionEngine/SparseTensor/BlockMap.h"
 #include "mlir/ExecutionEngine/SparseTensor/COO.h"
 #include "mlir/ExecutionEngine/SparseTensor/ErrorHandling.h"
+#include "mlir/ExecutionEngine/SparseTensor/Parallel.h"
+
+#include <algorithm>
+#include <memory>
 
 namespace mlir {
 namespace sparse_tensor {
@@ -226,6 +231,11 @@ public:
   /// Gets the coordinate-value stored at the given level and position.
   virtual uint64_t getCrd(uint64_t lvl, uint64_t pos) const = 0;
 
+  /// Gets an address that uniquely identifies the `<P,C,V>` types of the
+  /// derived class.  Since the runtime library is built without RTTI, this
+  /// lets the derived class recover its type from the base class.
+  virtual const void *getTypeTag() const = 0;
+
   /// Gets primary storage.
 #define DECL_GETVALUES(VNAME, V) virtual void getValues(std::vector<V> **);
   MLIR_SPARSETENSOR_FOREVERY_V(DECL_GETVALUES)
@@ -259,6 +269,15 @@ public:
   /// Finishes insertion.
   virtual void endInsert() = 0;
 
+  /// Reserves capacity for `nse` stored values, so that inserting up to
+  /// that many values does not need to regrow the overhead storage.
+  virtual void reserve(uint64_t nse) = 0;
+
+  /// Removes all stored values while keeping the allocated capacity,
+  /// which returns the tensor to the state of a freshly allocated empty
+  /// one (cf., `SparseTensorStorage::newEmpty`).
+  virtual void clear() = 0;
+
 private:
   const std::vector<uint64_t> dimSizes;
   const std::vector<uint64_t> lvlSizes;
@@ -357,6 +376,8 @@ public:
   /// * `lvlRank == lvlCOO.getRank()`.
   /// * `lvlCOO.getDimSizes()` under the `lvl2dim` mapping is a refinement
   ///   of `dimShape`.
+  /// * the blocked dimensions of a blocked `lvl2dim` (see `BlockMap`) are
+  ///   static in `dimShape`.
   //
   // TODO: The ability to reconstruct dynamic dimensions-sizes does not
   // easily generalize to arbitrary `lvl2dim` mappings.  When compiling
@@ -403,8 +424,58 @@ public:
                       uint64_t srcRank, const uint64_t *src2lvl,
                       const SparseTensorStorageBase &source);
 
+  /// Allocates a new sparse tensor with the given encoding, taking
+  /// ownership of the given positions, coordinates, and values arrays.
+  /// This factory performs no sorting or conversion, which allows for
+  /// efficiently restoring a tensor from its own storage arrays.
+  ///
+  /// Preconditions:
+  /// * as per the `SparseTensorStorageBase` ctor.
+  /// * the arrays must hold a valid storage of a tensor with the
+  ///   given encoding, e.g. as obtained from `getPositions`,
+  ///   `getCoordinates`, and `getValues`.
+  ///
+  /// Asserts:
+  /// * `positions` and `coordinates` have `lvlRank` entries.
+  static SparseTensorStorage<P, C, V> *
+  newFromBuffers(uint64_t dimRank, const uint64_t *dimSizes, uint64_t lvlRank,
+                 const uint64_t *lvlSizes, const DimLevelType *lvlTypes,
+                 const uint64_t *lvl2dim,
+                 std::vector<std::vector<P>> &&positions,
+                 std::vector<std::vector<C>> &&coordinates,
+                 std::vector<V> &&values);
+
+  /// Allocates a new sparse tensor and initializes it from the buffers of
+  /// the `sparse_tensor.pack` operator: the positions and coordinates of
+  /// each level in storage order, where all the levels of a trailing COO
+  /// region share a single array of structures of coordinates, followed by
+  /// the values.  The sizes of the buffers are derived from the positions,
+  /// and their contents are copied without sorting, so the buffers may be
+  /// released after the call.
+  ///
+  /// Preconditions:
+  /// * as per the `SparseTensorStorageBase` ctor.
+  /// * the buffers must hold a valid storage of a tensor with the given
+  ///   encoding, whose levels are dense, compressed or singleton.
+  static SparseTensorStorage<P, C, V> *
+  packFromLvlBuffers(uint64_t dimRank, const uint64_t *dimSizes,
+                     uint64_t lvlRank, const uint64_t *lvlSizes,
+                     const DimLevelType *lvlTypes, const uint64_t *lvl2dim,
+                     const void *const *buffers);
+
   ~SparseTensorStorage() final = default;
 
+  const void *getTypeTag() const final { return &kTypeTag; }
+
+  /// Returns `source` if it has the same types as this class, and nullptr
+  /// otherwise.
+  static const SparseTensorStorage<P, C, V> *
+  castFrom(const SparseTensorStorageBase &source) {
+    if (source.getTypeTag() != &kTypeTag)
+      return nullptr;
+    return static_cast<const SparseTensorStorage<P, C, V> *>(&source);
+  }
+
   /// Partially specialize these getter methods based on template types.
   void getPositions(std::vector<P> **out, uint64_t lvl) final {
     assert(out && "Received nullptr for out parameter");
@@ -478,6 +549,44 @@ public:
       endPath(0);
   }
 
+  void reserve(uint64_t nse) final {
+    // Every level has at most as many entries as there are values below
+    // it, so `nse` bounds the entries of all levels.
+    const uint64_t lvlRank = getLvlRank();
+    uint64_t sz = 1;
+    for (uint64_t l = 0; l < lvlRank; ++l) {
+      if (isCompressedLvl(l)) {
+        positions[l].reserve(std::min(sz, nse) + 1);
+        coordinates[l].reserve(nse);
+        sz = nse;
+      } else if (isSingletonLvl(l)) {
+        coordinates[l].reserve(nse);
+        sz = nse;
+      } else { // Dense level.
+        const uint64_t lvlSize = getLvlSize(l);
+        sz = sz > nse / lvlSize ? nse : sz * lvlSize;
+      }
+    }
+    values.reserve(nse);
+  }
+
+  void clear() final {
+    const uint64_t lvlRank = getLvlRank();
+    bool allDense = true;
+    for (uint64_t l = 0; l < lvlRank; ++l) {
+      positions[l].clear();
+      coordinates[l].clear();
+      if (isCompressedLvl(l))
+        positions[l].push_back(0);
+      if (!isDenseLvl(l))
+        allDense = false;
+    }
+    if (allDense)
+      std::fill(values.begin(), values.end(), 0);
+    else
+      values.clear();
+  }
+
   /// Allocates a new enumerator for this class's `<P,C,V>` types and
   /// erase the `<P,C>` parts from the type.  Callers must make sure to
   /// delete the enumerator when they're done with it.
@@ -506,7 +615,7 @@ public:
     // TODO: This assertion assumes there are no stored zeros,
     // or if there are then that we don't filter them out.
     // Cf., <https://github.com/llvm/llvm-project/issues/54179>
-    assert(coo->getElements().size() == values.size());
+    assert(coo->getNSE() == values.size());
     return coo;
   }
 
@@ -590,37 +699,210 @@ private:
   /// coordinates arrays under the given per-level dense/sparse annotations.
   ///
   /// Preconditions:
-  /// * the `lvlElements` must be lexicographically sorted.
+  /// * the elements of `lvlCOO` must be lexicographically sorted.
   /// * the coordinates of every element are valid for `getLvlSizes()`
   ///   (i.e., equal rank and pointwise less-than).
-  void fromCOO(const std::vector<Element<V>> &lvlElements, uint64_t lo,
-               uint64_t hi, uint64_t l) {
+  void fromCOO(const SparseTensorCOO<V> &lvlCOO, uint64_t lo, uint64_t hi,
+               uint64_t l) {
     const uint64_t lvlRank = getLvlRank();
-    assert(l <= lvlRank && hi <= lvlElements.size());
+    assert(l <= lvlRank && hi <= lvlCOO.getNSE());
     // Once levels are exhausted, insert the numerical values.
     if (l == lvlRank) {
       assert(lo < hi);
-      values.push_back(lvlElements[lo].value);
+      values.push_back(lvlCOO.getValue(lo));
       return;
     }
     // Visit all elements in this interval.
-    uint64_t full = 0;
-    while (lo < hi) { // If `hi` is unchanged, then `lo < lvlElements.size()`.
+    const uint64_t full = appendSegments(lvlCOO, lo, hi, l, 0);
+    // Finalize the sparse position structure at this level.
+    finalizeSegment(l, full);
+  }
+
+  /// Appends the segments of the elements of `lvlCOO` in `[lo, hi)` at
+  /// level `l < getLvlRank()`, where `full` is as per `appendCrd`, but
+  /// without finalizing the level.  Returns the updated `full`.
+  uint64_t appendSegments(const SparseTensorCOO<V> &lvlCOO, uint64_t lo,
+                          uint64_t hi, uint64_t l, uint64_t full) {
+    while (lo < hi) { // If `hi` is unchanged, then `lo < lvlCOO.getNSE()`.
       // Find segment in interval with same coordinate at this level.
-      const uint64_t c = lvlElements[lo].coords[l];
+      const uint64_t c = lvlCOO.getCoords(lo)[l];
       uint64_t seg = lo + 1;
       if (isUniqueLvl(l))
-        while (seg < hi && lvlElements[seg].coords[l] == c)
+        while (seg < hi && lvlCOO.getCoords(seg)[l] == c)
           ++seg;
       // Handle segment in interval for sparse or dense level.
       appendCrd(l, full, c);
       full = c + 1;
-      fromCOO(lvlElements, lo, seg, l + 1);
+      fromCOO(lvlCOO, lo, seg, l + 1);
       // And move on to next segment in interval.
       lo = seg;
     }
-    // Finalize the sparse position structure at this level.
-    finalizeSegment(l, full);
+    return full;
+  }
+
+  /// Initializes the sparse tensor storage scheme as per `fromCOO`, by
+  /// splitting the elements of `lvlCOO` at the segment boundaries of the
+  /// first level into `numThreads` parts.  The storage of each part is
+  /// built concurrently, and then moved into place with its positions
+  /// shifted by the number of coordinates of the preceding parts.
+  ///
+  /// Preconditions are as per `fromCOO`, and the storage must be empty.
+  void parallelFromCOO(const SparseTensorCOO<V> &lvlCOO,
+                       uint64_t numThreads) {
+    const uint64_t lvlRank = getLvlRank();
+    const uint64_t nse = lvlCOO.getNSE();
+    assert(nse != 0 && values.empty());
+    // Split the elements without breaking up a segment of the first level.
+    std::vector<uint64_t> bounds(numThreads + 1, nse);
+    bounds[0] = 0;
+    for (uint64_t i = 1; i < numThreads; ++i) {
+      uint64_t b = std::max(bounds[i - 1], i * nse / numThreads);
+      if (isUniqueLvl(0))
+        while (b != 0 && b < nse &&
+               lvlCOO.getCoords(b)[0] == lvlCOO.getCoords(b - 1)[0])
+          ++b;
+      bounds[i] = b;
+    }
+    // Build the storage of each part.  Each part starts with the `0`-th
+    // level as left by the preceding element.
+    std::vector<std::unique_ptr<SparseTensorStorage<P, C, V>>> parts(
+        numThreads);
+    detail::parallelInvoke(numThreads, [&](uint64_t i) {
+      const uint64_t lo = bounds[i];
+      const uint64_t hi = bounds[i + 1];
+      if (lo == hi)
+        return;
+      parts[i].reset(new SparseTensorStorage<P, C, V>(
+          getDimRank(), getDimSizes().data(), lvlRank, getLvlSizes().data(),
+          getLvlTypes().data(), getLvl2Dim().data()));
+      parts[i]->values.reserve(hi - lo);
+      const uint64_t full = lo == 0 ? 0 : lvlCOO.getCoords(lo - 1)[0] + 1;
+      parts[i]->appendSegments(lvlCOO, lo, hi, 0, full);
+    });
+    // Compute where the arrays of each part start.
+    std::vector<std::vector<uint64_t>> posStart(numThreads),
+        crdStart(numThreads);
+    std::vector<uint64_t> valStart(numThreads);
+    std::vector<uint64_t> posSize(lvlRank), crdSize(lvlRank);
+    for (uint64_t l = 0; l < lvlRank; ++l) {
+      posSize[l] = positions[l].size();
+      crdSize[l] = coordinates[l].size();
+    }
+    uint64_t valSize = 0;
+    for (uint64_t i = 0; i < numThreads; ++i) {
+      if (!parts[i])
+        continue;
+      posStart[i] = posSize;
+      crdStart[i] = crdSize;
+      valStart[i] = valSize;
+      for (uint64_t l = 0; l < lvlRank; ++l) {
+        posSize[l] += parts[i]->positions[l].size();
+        crdSize[l] += parts[i]->coordinates[l].size();
+      }
+      valSize += parts[i]->values.size();
+    }
+    for (uint64_t l = 0; l < lvlRank; ++l) {
+      positions[l].resize(posSize[l]);
+      coordinates[l].resize(crdSize[l]);
+    }
+    values.resize(valSize);
+    // Copy the parts into place.
+    detail::parallelInvoke(numThreads, [&](uint64_t i) {
+      if (!parts[i])
+        return;
+      SparseTensorStorage<P, C, V> &part = *parts[i];
+      for (uint64_t l = 0; l < lvlRank; ++l) {
+        const std::vector<P> &partPositions = part.positions[l];
+        for (uint64_t k = 0, e = partPositions.size(); k < e; ++k)
+          positions[l][posStart[i][l] + k] = detail::checkOverflowCast<P>(
+              crdStart[i][l] + static_cast<uint64_t>(partPositions[k]));
+        std::copy(part.coordinates[l].begin(), part.coordinates[l].end(),
+                  coordinates[l].begin() + crdStart[i][l]);
+      }
+      std::copy(part.values.begin(), part.values.end(),
+                values.begin() + valStart[i]);
+      parts[i].reset();
+    });
+    // Finalize the first level, following its last coordinate.
+    finalizeSegment(0, lvlCOO.getCoords(nse - 1)[0] + 1);
+  }
+
+  /// The minimum number of elements assembled by a single thread.
+  static constexpr uint64_t kMinFromCOOChunkSize = 1 << 16;
+
+  /// The minimum number of elements transposed by a single thread.
+  static constexpr uint64_t kMinTransposeChunkSize = 1 << 16;
+
+  /// The minimum number of positions summed up by a single thread.
+  static constexpr uint64_t kMinPrefixSumChunkSize = 1 << 16;
+
+  /// The address identifying the types of this class.
+  static constexpr char kTypeTag = 0;
+
+  /// Initializes this tensor, whose levels are `dense` and `compressed`, as
+  /// the transpose of `source`, whose levels are the same.  This is a
+  /// counting sort of the elements by their coordinate at the second level,
+  /// done in parallel over ranges of rows of `source` with per-thread
+  /// counts, so that the coordinates of each segment remain ordered.
+  void transposeFrom(const SparseTensorStorage<P, C, V> &source) {
+    const uint64_t numRows = source.getLvlSizes()[0];
+    const uint64_t numCols = source.getLvlSizes()[1];
+    assert(getLvlSizes()[0] == numCols && getLvlSizes()[1] == numRows &&
+           "Level-sizes do not match the transpose");
+    const std::vector<P> &srcPositions = source.positions[1];
+    const std::vector<C> &srcCoordinates = source.coordinates[1];
+    const uint64_t nse = source.values.size();
+    if (numRows > 0)
+      (void)detail::checkOverflowCast<C>(numRows - 1);
+    // The counts of the threads take as much memory as the elements at
+    // most.
+    const uint64_t numThreads = std::min(
+        detail::getNumThreads(nse, kMinTransposeChunkSize),
+        std::max<uint64_t>(1, nse / std::max<uint64_t>(1, numCols)));
+    // Split the rows into ranges of about as many elements.
+    std::vector<uint64_t> rowBounds(numThreads + 1, numRows);
+    rowBounds[0] = 0;
+    for (uint64_t t = 1; t < numThreads; ++t)
+      rowBounds[t] = std::lower_bound(srcPositions.begin(),
+                                      srcPositions.begin() + numRows,
+                                      t * nse / numThreads) -
+                     srcPositions.begin();
+    std::vector<std::vector<uint64_t>> offsets(
+        numThreads, std::vector<uint64_t>(numCols, 0));
+    detail::parallelInvoke(numThreads, [&](uint64_t t) {
+      std::vector<uint64_t> &counts = offsets[t];
+      for (uint64_t p = srcPositions[rowBounds[t]],
+                    end = srcPositions[rowBounds[t + 1]];
+           p < end; ++p)
+        ++counts[srcCoordinates[p]];
+    });
+    // Turn the counts into the starting positions of the threads in each
+    // segment, in the order of the threads.
+    std::vector<P> &positionsL = positions[1];
+    positionsL.assign(numCols + 1, 0);
+    uint64_t pos = 0;
+    for (uint64_t c = 0; c < numCols; ++c) {
+      for (uint64_t t = 0; t < numThreads; ++t) {
+        const uint64_t count = offsets[t][c];
+        offsets[t][c] = pos;
+        pos += count;
+      }
+      positionsL[c + 1] = detail::checkOverflowCast<P>(pos);
+    }
+    std::vector<C> &coordinatesL = coordinates[1];
+    coordinatesL.resize(nse);
+    values.resize(nse);
+    detail::parallelInvoke(numThreads, [&](uint64_t t) {
+      std::vector<uint64_t> &next = offsets[t];
+      for (uint64_t r = rowBounds[t]; r < rowBounds[t + 1]; ++r) {
+        for (uint64_t p = srcPositions[r], end = srcPositions[r + 1]; p < end;
+             ++p) {
+          const uint64_t q = next[srcCoordinates[p]]++;
+          coordinatesL[q] = static_cast<C>(r);
+          values[q] = source.values[p];
+        }
+      }
+    });
   }
 
   /// Finalizes the sparse position structure at this level.
@@ -785,6 +1067,27 @@ public:
   /// must copy it if they want to keep it.
   virtual void forallElements(ElementConsumer<V> yield) = 0;
 
+  /// Gets the number of threads between which `forallElementsInParallel`
+  /// may split the enumeration, such that each thread gets at least
+  /// `minItemsPerThread` elements.  Always returns at least one.
+  virtual uint64_t getMaxNumThreads(uint64_t minItemsPerThread) const {
+    return 1;
+  }
+
+  /// Enumerates all elements of the source tensor as per `forallElements`,
+  /// but splits them between `numThreads` threads, which must not exceed
+  /// `getMaxNumThreads`.  Each thread enumerates a contiguous range of the
+  /// elements in order, and passes its index to the callback along with
+  /// each element.
+  virtual void forallElementsInParallel(uint64_t numThreads,
+                                        ParallelElementConsumer<V> yield) {
+    assert(numThreads == 1 && "Cannot enumerate in parallel");
+    forallElements(
+        [&](const std::vector<uint64_t> &trgCoords, V val) {
+          yield(0, trgCoords, val);
+        });
+  }
+
 protected:
   const SparseTensorStorageBase &src;
   std::vector<uint64_t> trgSizes;  // in target order.
@@ -813,7 +1116,35 @@ public:
   ~SparseTensorEnumerator() final = default;
 
   void forallElements(ElementConsumer<V> yield) final {
-    forallElements(yield, 0, 0);
+    forallElements(yield, this->trgCursor, 0, 0);
+  }
+
+  uint64_t getMaxNumThreads(uint64_t minItemsPerThread) const final {
+    const auto &src = static_cast<const StorageImpl &>(this->src);
+    const std::pair<uint64_t, uint64_t> range = getLvl0Range();
+    return std::max<uint64_t>(
+        1, std::min(detail::getNumThreads(src.values.size(), minItemsPerThread),
+                    range.second - range.first));
+  }
+
+  void forallElementsInParallel(uint64_t numThreads,
+                                ParallelElementConsumer<V> yield) final {
+    assert(numThreads != 0 && numThreads <= getMaxNumThreads(1) &&
+           "Too many threads");
+    // Split the positions of the `0`-level between the threads, each of
+    // which uses its own cursor.
+    const uint64_t lo = getLvl0Range().first;
+    const uint64_t hi = getLvl0Range().second;
+    detail::parallelInvoke(numThreads, [&](uint64_t t) {
+      std::vector<uint64_t> cursor(this->getTrgRank());
+      const std::function<void(const std::vector<uint64_t> &, V)> consumer =
+          [&](const std::vector<uint64_t> &trgCoords, V val) {
+            yield(t, trgCoords, val);
+          };
+      forallElementsInLvl0Range(consumer, cursor,
+                                lo + (hi - lo) * t / numThreads,
+                                lo + (hi - lo) * (t + 1) / numThreads);
+    });
   }
 
 private:
@@ -827,19 +1158,48 @@ private:
   // `trgCursor` buffers in this object, but we may want to benchmark
   // that against using `std::calloc` to stack-allocate them instead.
   //
-  /// The recursive component of the public `forallElements`.
-  void forallElements(ElementConsumer<V> yield, uint64_t parentPos,
-                      uint64_t l) {
+  /// Gets the range of the positions of the `0`-level, or an empty range
+  /// if the level is singleton or not yet assembled.
+  std::pair<uint64_t, uint64_t> getLvl0Range() const {
+    const auto &src = static_cast<const StorageImpl &>(this->src);
+    if (src.isDenseLvl(0))
+      return {0, src.getLvlSizes()[0]};
+    const std::vector<P> &positions0 = src.positions[0];
+    if (src.isCompressedLvl(0) && positions0.size() >= 2)
+      return {static_cast<uint64_t>(positions0[0]),
+              static_cast<uint64_t>(positions0[1])};
+    return {0, 0};
+  }
+
+  /// Enumerates the elements below the positions of the `0`-level in
+  /// `[lo, hi)`, as per the recursive `forallElements`.
+  void forallElementsInLvl0Range(ElementConsumer<V> yield,
+                                 std::vector<uint64_t> &cursor, uint64_t lo,
+                                 uint64_t hi) {
+    const auto &src = static_cast<const StorageImpl &>(this->src);
+    const bool isCompressed0 = src.isCompressedLvl(0);
+    uint64_t &cursor0 = cursor[this->lvl2trg[0]];
+    for (uint64_t pos = lo; pos < hi; ++pos) {
+      cursor0 = isCompressed0 ? static_cast<uint64_t>(src.coordinates[0][pos])
+                              : pos;
+      forallElements(yield, cursor, pos, 1);
+    }
+  }
+
+  /// The recursive component of the public `forallElements`, which fills
+  /// in the given `cursor`.
+  void forallElements(ElementConsumer<V> yield, std::vector<uint64_t> &cursor,
+                      uint64_t parentPos, uint64_t l) {
     // Recover the `<P,C,V>` type parameters of `src`.
     const auto &src = static_cast<const StorageImpl &>(this->src);
     if (l == src.getLvlRank()) {
       assert(parentPos < src.values.size() &&
              "Value position is out of bounds");
       // TODO: <https://github.com/llvm/llvm-project/issues/54179>
-      yield(this->trgCursor, src.values[parentPos]);
+      yield(cursor, src.values[parentPos]);
       return;
     }
-    uint64_t &cursorL = this->trgCursor[this->lvl2trg[l]];
+    uint64_t &cursorL = cursor[this->lvl2trg[l]];
     const auto dlt = src.getLvlType(l); // Avoid redundant bounds checking.
     if (isCompressedDLT(dlt)) {
       // Look up the bounds of the `l`-level segment determined by the
@@ -854,18 +1214,18 @@ private:
       assert(pstop <= coordinatesL.size() && "Stop position is out of bounds");
       for (uint64_t pos = pstart; pos < pstop; ++pos) {
         cursorL = static_cast<uint64_t>(coordinatesL[pos]);
-        forallElements(yield, pos, l + 1);
+        forallElements(yield, cursor, pos, l + 1);
       }
     } else if (isSingletonDLT(dlt)) {
       cursorL = src.getCrd(l, parentPos);
-      forallElements(yield, parentPos, l + 1);
+      forallElements(yield, cursor, parentPos, l + 1);
     } else { // Dense level.
       ASSERT_DENSE_DLT(dlt);
       const uint64_t sz = src.getLvlSizes()[l];
       const uint64_t pstart = parentPos * sz;
       for (uint64_t c = 0; c < sz; ++c) {
         cursorL = c;
-        forallElements(yield, pstart + c, l + 1);
+        forallElements(yield, cursor, pstart + c, l + 1);
       }
     }
   }
@@ -908,12 +1268,44 @@ public:
   /// Asserts:
   /// * `enumerator.getTrgRank() == getLvlRank()`.
   /// * `enumerator.getTrgSizes() == lvlSizes`.
+  ///
+  /// The elements are counted in parallel when the enumerator supports
+  /// it, with each thread counting into its own statistics, which are then
+  /// summed up.  The number of threads is such that each thread counts at
+  /// least as many elements as there are statistics to sum up.
   template <typename V>
   void initialize(SparseTensorEnumeratorBase<V> &enumerator) {
     assert(enumerator.getTrgRank() == getLvlRank() && "Tensor rank mismatch");
     assert(enumerator.getTrgSizes() == lvlSizes && "Tensor size mismatch");
-    enumerator.forallElements(
-        [this](const std::vector<uint64_t> &lvlCoords, V) { add(lvlCoords); });
+    uint64_t numCounts = 0;
+    for (const auto &lvlNNZ : nnz)
+      numCounts += lvlNNZ.size();
+    const uint64_t numThreads = enumerator.getMaxNumThreads(
+        std::max(kMinCountChunkSize, numCounts));
+    if (numThreads == 1) {
+      enumerator.forallElements(
+          [this](const std::vector<uint64_t> &lvlCoords, V) {
+            add(nnz, lvlCoords);
+          });
+      return;
+    }
+    std::vector<LvlCounts> partials(numThreads, nnz);
+    enumerator.forallElementsInParallel(
+        numThreads,
+        [this, &partials](uint64_t t, const std::vector<uint64_t> &lvlCoords,
+                          V) { add(partials[t], lvlCoords); });
+    accumulate(partials);
+  }
+
+  /// Gets the statistics of the compressed level `l`, which are the
+  /// number of its coordinates below each of the positions of the
+  /// preceding level, in order.  These are the statistics which
+  /// `forallCoords(l, yield)` passes to the callback.
+  const std::vector<uint64_t> &getLvlNNZ(uint64_t l) const {
+    assert(l < getLvlRank() && "Level out of bounds");
+    assert(isCompressedDLT(lvlTypes[l]) &&
+           "Cannot look up non-compressed levels");
+    return nnz[l];
   }
 
   /// The type of callback functions which receive an nnz-statistic.
@@ -931,7 +1323,15 @@ private:
   /// to avoid spurious templating over `V`.  And this method is private
   /// to avoid needing to re-assert validity of `lvlCoords` (which is
   /// guaranteed by `forallElements`).
-  void add(const std::vector<uint64_t> &lvlCoords);
+  using LvlCounts = std::vector<std::vector<uint64_t>>;
+
+  /// The minimal number of elements which each thread counts.
+  static constexpr uint64_t kMinCountChunkSize = 1 << 16;
+
+  void add(LvlCounts &counts, const std::vector<uint64_t> &lvlCoords) const;
+
+  /// Sums up the statistics counted by the threads into `nnz`, in parallel.
+  void accumulate(const std::vector<LvlCounts> &partials);
 
   /// Recursive component of the public `forallCoords`.
   void forallCoords(NNZConsumer yield, uint64_t stopLvl, uint64_t parentPos,
@@ -940,7 +1340,7 @@ private:
   // All of these are in the target storage-order.
   const std::vector<uint64_t> &lvlSizes;
   const std::vector<DimLevelType> &lvlTypes;
-  std::vector<std::vector<uint64_t>> nnz;
+  LvlCounts nnz;
 };
 
 //===----------------------------------------------------------------------===//
@@ -955,21 +1355,84 @@ SparseTensorStorage<P, C, V> *SparseTensorStorage<P, C, V>::newFromCOO(
   assert(lvl2dim && "Got nullptr for level-to-dimension mapping");
   const auto &lvlSizes = lvlCOO.getDimSizes();
   assert(lvlRank == lvlSizes.size() && "Level-rank mismatch");
-  // Must reconstruct `dimSizes` from `lvlSizes`.  While this is easy
-  // enough to do when `lvl2dim` is a permutation, this approach will
-  // not work for more general mappings; so we will need to move this
-  // computation off to codegen.
-  std::vector<uint64_t> dimSizes(dimRank);
-  for (uint64_t l = 0; l < lvlRank; ++l) {
-    const uint64_t d = lvl2dim[l];
-    assert((dimShape[d] == 0 || dimShape[d] == lvlSizes[l]) &&
-           "Dimension sizes do not match expected shape");
-    dimSizes[d] = lvlSizes[l];
-  }
+  // Must reconstruct `dimSizes` from `lvlSizes`.  This works for both
+  // permutations and blocked formats, but more general mappings will
+  // need to move this computation off to codegen.
+  const detail::BlockMap d2l(dimRank, lvlRank, lvlSizes.data(), lvl2dim);
+  const std::vector<uint64_t> dimSizes =
+      d2l.getDimSizes(dimShape, lvlSizes.data());
   return new SparseTensorStorage<P, C, V>(dimRank, dimSizes.data(), lvlRank,
                                           lvlTypes, lvl2dim, lvlCOO);
 }
 
+template <typename P, typename C, typename V>
+SparseTensorStorage<P, C, V> *SparseTensorStorage<P, C, V>::newFromBuffers(
+    uint64_t dimRank, const uint64_t *dimSizes, uint64_t lvlRank,
+    const uint64_t *lvlSizes, const DimLevelType *lvlTypes,
+    const uint64_t *lvl2dim, std::vector<std::vector<P>> &&positions,
+    std::vector<std::vector<C>> &&coordinates, std::vector<V> &&values) {
+  assert(positions.size() == lvlRank && "Positions rank mismatch");
+  assert(coordinates.size() == lvlRank && "Coordinates rank mismatch");
+  auto *tensor = new SparseTensorStorage<P, C, V>(
+      dimRank, dimSizes, lvlRank, lvlSizes, lvlTypes, lvl2dim);
+  tensor->positions = std::move(positions);
+  tensor->coordinates = std::move(coordinates);
+  tensor->values = std::move(values);
+  return tensor;
+}
+
+template <typename P, typename C, typename V>
+SparseTensorStorage<P, C, V> *SparseTensorStorage<P, C, V>::packFromLvlBuffers(
+    uint64_t dimRank, const uint64_t *dimSizes, uint64_t lvlRank,
+    const uint64_t *lvlSizes, const DimLevelType *lvlTypes,
+    const uint64_t *lvl2dim, const void *const *buffers) {
+  assert(buffers && "Received nullptr for the buffers");
+  auto *tensor = new SparseTensorStorage<P, C, V>(
+      dimRank, dimSizes, lvlRank, lvlSizes, lvlTypes, lvl2dim);
+  // The trailing COO region starts at a compressed level only followed by
+  // singleton levels, and spans at least two levels.
+  uint64_t cooStart = lvlRank;
+  for (uint64_t l = 0; l + 1 < lvlRank && cooStart == lvlRank; ++l)
+    if (isCompressedDLT(lvlTypes[l]) &&
+        std::all_of(lvlTypes + l + 1, lvlTypes + lvlRank, isSingletonDLT))
+      cooStart = l;
+  uint64_t bufIdx = 0;
+  // The number of entries of the current level.
+  uint64_t size = 1;
+  const C *cooCoordinates = nullptr;
+  for (uint64_t l = 0; l < lvlRank; ++l) {
+    const DimLevelType dlt = lvlTypes[l];
+    if (isDenseDLT(dlt)) {
+      size *= lvlSizes[l];
+      continue;
+    }
+    if (isCompressedDLT(dlt)) {
+      const P *positionsL = static_cast<const P *>(buffers[bufIdx++]);
+      tensor->positions[l].assign(positionsL, positionsL + size + 1);
+      size = positionsL[size];
+    } else if (!isSingletonDLT(dlt)) {
+      MLIR_SPARSETENSOR_FATAL("unsupported level type: %d\n",
+                              static_cast<uint8_t>(dlt));
+    }
+    std::vector<C> &coordinatesL = tensor->coordinates[l];
+    if (l < cooStart) {
+      const C *crd = static_cast<const C *>(buffers[bufIdx++]);
+      coordinatesL.assign(crd, crd + size);
+      continue;
+    }
+    // Splits the array of structures of the trailing COO region.
+    if (l == cooStart)
+      cooCoordinates = static_cast<const C *>(buffers[bufIdx++]);
+    const uint64_t cooRank = lvlRank - cooStart;
+    coordinatesL.resize(size);
+    for (uint64_t i = 0; i < size; ++i)
+      coordinatesL[i] = cooCoordinates[i * cooRank + l - cooStart];
+  }
+  const V *values = static_cast<const V *>(buffers[bufIdx]);
+  tensor->values.assign(values, values + size);
+  return tensor;
+}
+
 template <typename P, typename C, typename V>
 SparseTensorStorage<P, C, V> *SparseTensorStorage<P, C, V>::newFromSparseTensor(
     uint64_t dimRank, const uint64_t *dimShape, uint64_t lvlRank,
@@ -987,6 +1450,36 @@ SparseTensorStorage<P, C, V> *SparseTensorStorage<P, C, V>::newFromSparseTensor(
            "Dimension-sizes do not match expected shape");
   }
 #endif
+  // Convert directly between the storages of the same types, when the levels
+  // are kept in order or are the rows and columns of a matrix.
+  if (const auto *src = castFrom(source)) {
+    const auto &srcLvl2Dim = src->getLvl2Dim();
+    const auto &srcLvlTypes = src->getLvlTypes();
+    bool isIdentity = lvlRank == src->getLvlRank();
+    for (uint64_t l = 0; isIdentity && l < lvlRank; ++l)
+      isIdentity = src2lvl[srcLvl2Dim[l]] == l &&
+                   srcLvlTypes[l] == lvlTypes[l] &&
+                   src->getLvlSize(l) == lvlSizes[l];
+    if (isIdentity) {
+      auto *tensor = new SparseTensorStorage<P, C, V>(
+          dimRank, dimSizes.data(), lvlRank, lvlSizes, lvlTypes, lvl2dim);
+      tensor->positions = src->positions;
+      tensor->coordinates = src->coordinates;
+      tensor->values = src->values;
+      return tensor;
+    }
+    const bool isTranspose =
+        lvlRank == 2 && src->getLvlRank() == 2 &&
+        src2lvl[srcLvl2Dim[0]] == 1 && src2lvl[srcLvl2Dim[1]] == 0 &&
+        isDenseDLT(srcLvlTypes[0]) && isCompressedDLT(srcLvlTypes[1]) &&
+        isDenseDLT(lvlTypes[0]) && isCompressedDLT(lvlTypes[1]);
+    if (isTranspose) {
+      auto *tensor = new SparseTensorStorage<P, C, V>(
+          dimRank, dimSizes.data(), lvlRank, lvlSizes, lvlTypes, lvl2dim);
+      tensor->transposeFrom(*src);
+      return tensor;
+    }
+  }
   SparseTensorEnumeratorBase<V> *lvlEnumerator;
   source.newEnumerator(&lvlEnumerator, lvlRank, lvlSizes, srcRank, src2lvl);
   auto *tensor = new SparseTensorStorage<P, C, V>(
@@ -1044,11 +1537,15 @@ SparseTensorStorage<P, C, V>::SparseTensorStorage( // NOLINT
   // Ensure the preconditions of `fromCOO`.  (One is already ensured by
   // using `lvlSizes = lvlCOO.getDimSizes()` in the ctor above.)
   lvlCOO.sort();
-  // Now actually insert the `elements`.
-  const auto &elements = lvlCOO.getElements();
-  const uint64_t nse = elements.size();
-  values.reserve(nse);
-  fromCOO(elements, 0, nse, 0);
+  // Now actually insert the elements.
+  const uint64_t nse = lvlCOO.getNSE();
+  const uint64_t numThreads = detail::getNumThreads(nse, kMinFromCOOChunkSize);
+  if (numThreads > 1) {
+    parallelFromCOO(lvlCOO, numThreads);
+  } else {
+    values.reserve(nse);
+    fromCOO(lvlCOO, 0, nse, 0);
+  }
 }
 
 template <typename P, typename C, typename V>
@@ -1069,15 +1566,17 @@ SparseTensorStorage<P, C, V>::SparseTensorStorage(
     for (uint64_t l = 0; l < lvlRank; ++l) {
       const auto dlt = lvlTypes[l]; // Avoid redundant bounds checking.
       if (isCompressedDLT(dlt)) {
-        positions[l].reserve(parentSz + 1);
-        positions[l].push_back(0);
-        uint64_t currentPos = 0;
-        nnz.forallCoords(l, [this, &currentPos, l](uint64_t n) {
-          currentPos += n;
-          appendPos(l, currentPos);
-        });
-        assert(positions[l].size() == parentSz + 1 &&
-               "Final positions size doesn't match allocated size");
+        // The positions are the running sums of the statistics of the
+        // level, which follow the lexicographic order of the preceding
+        // levels.
+        const std::vector<uint64_t> &lvlNNZ = nnz.getLvlNNZ(l);
+        assert(lvlNNZ.size() == parentSz &&
+               "Statistics size doesn't match allocated size");
+        positions[l].resize(parentSz + 1);
+        detail::parallelPrefixSum(
+            lvlNNZ, positions[l].data(),
+            detail::getNumThreads(parentSz, kMinPrefixSumChunkSize),
+            [](uint64_t pos) { return detail::checkOverflowCast<P>(pos); });
         // That assertion entails `assembledSize(parentSz, l)`
         // is now in a valid state.  That is, `positions[l][parentSz]`
         // equals the present value of `currentPos`, which is the
@@ -56,6 +56,9 @@ extern "C" {
 /// kSparseToSparse STS             STS, copied from the STS source
 /// kToIterator     STS             Iterator, call @getNext to use and
 ///                                 @delSparseTensorIterator to free.
+/// kPack           void** buffers  STS, copied from the level buffers and
+///                                 the values buffer, in the order of the
+///                                 fields of the `sparse_tensor.pack` op.
 MLIR_CRUNNERUTILS_EXPORT void *_mlir_ciface_newSparseTensor( // NOLINT
     StridedMemRefType<index_type, 1> *dimSizesRef,
     StridedMemRefType<index_type, 1> *lvlSizesRef,
@@ -153,9 +156,25 @@ MLIR_CRUNNERUTILS_EXPORT void endInsert(void *tensor);
 MLIR_SPARSETENSOR_FOREVERY_V(DECL_OUTSPARSETENSOR)
 #undef DECL_OUTSPARSETENSOR
 
-/// Releases the memory for the tensor-storage object.
+/// Releases the memory for the tensor-storage object.  When the tensor
+/// was allocated empty while the pool of sparse tensors is enabled, it
+/// is instead returned to the pool (cf., `setSparseTensorPoolCapacity`).
 MLIR_CRUNNERUTILS_EXPORT void delSparseTensor(void *tensor);
 
+/// Tensor-storage method to reserve capacity for the given number of
+/// stored values, so that inserting them does not regrow the storage.
+MLIR_CRUNNERUTILS_EXPORT void reserveSparseTensor(void *tensor,
+                                                  index_type nse);
+
+/// Sets how many released empty tensors to pool for reuse.  While the
+/// pool is enabled, `delSparseTensor` keeps the storage of the tensors
+/// allocated by `Action::kEmpty` (clearing their contents), and the next
+/// allocation with the same types, sizes, and level-types reuses it
+/// rather than starting over from fresh buffers.  The pool is disabled by
+/// default, and a capacity of zero disables it again (freeing the pooled
+/// tensors).
+MLIR_CRUNNERUTILS_EXPORT void setSparseTensorPoolCapacity(index_type capacity);
+
 /// Releases the memory for the coordinate-scheme object.
 #define DECL_DELCOO(VNAME, V)                                                  \
   MLIR_CRUNNERUTILS_EXPORT void delSparseTensorCOO##VNAME(void *coo);
@@ -242,7 +261,9 @@ MLIR_CRUNNERUTILS_EXPORT void *_mlir_ciface_createCheckedSparseTensorReader(
 
 /// Constructs a new sparse-tensor storage object with the given encoding,
 /// initializes it by reading all the elements from the file, and then
-/// closes the file.
+/// closes the file.  Besides permutations, the `lvl2dimRef` may describe
+/// a blocked format by mapping two levels to the same dimension, in which
+/// case the level-size of the second one is the block size.
 MLIR_CRUNNERUTILS_EXPORT void *_mlir_ciface_newSparseTensorFromReader(
     void *p, StridedMemRefType<index_type, 1> *lvlSizesRef,
     StridedMemRefType<DimLevelType, 1> *lvlTypesRef,
@@ -250,6 +271,21 @@ MLIR_CRUNNERUTILS_EXPORT void *_mlir_ciface_newSparseTensorFromReader(
     StridedMemRefType<index_type, 1> *dim2lvlRef, OverheadType posTp,
     OverheadType crdTp, PrimaryType valTp);
 
+/// Constructs a new sparse-tensor storage object by loading the file written
+/// by `outSparseTensorBinary`, validating that it was written with the given
+/// types and that its dimension-sizes match the expected `dimShapeRef`.
+MLIR_CRUNNERUTILS_EXPORT void *_mlir_ciface_newSparseTensorFromBinaryFile(
+    char *filename, StridedMemRefType<index_type, 1> *dimShapeRef,
+    OverheadType posTp, OverheadType crdTp, PrimaryType valTp);
+
+/// Tensor-storage method to write its storage scheme to file in the binary
+/// container format, which `newSparseTensorFromBinaryFile` loads back.
+MLIR_CRUNNERUTILS_EXPORT void outSparseTensorBinary(void *tensor,
+                                                    char *filename,
+                                                    OverheadType posTp,
+                                                    OverheadType crdTp,
+                                                    PrimaryType valTp);
+
 /// Returns the rank of the sparse tensor being read.
 MLIR_CRUNNERUTILS_EXPORT index_type getSparseTensorReaderRank(void *p);
 
@@ -299,14 +335,19 @@ MLIR_SPARSETENSOR_FOREVERY_V(DECL_GETNEXT)
           MLIR_SPARSETENSOR_FOREVERY_V_O(DECL_GETNEXT)
 #undef DECL_GETNEXT
 
-using SparseTensorWriter = std::ostream;
-
 /// Creates a SparseTensorWriter for outputing a sparse tensor to a file with
-/// the given file name. When the file name is empty, std::cout is used.
-//
-// Only the extended FROSTT format is supported currently.
+/// the given file name in the extended FROSTT format. When the file name is
+/// empty, the standard output is used.
 MLIR_CRUNNERUTILS_EXPORT void *createSparseTensorWriter(char *filename);
 
+/// Creates a SparseTensorWriter for outputing a sparse tensor with values of
+/// type `valTp` to a file with the given file name in the binary container
+/// format, which `newSparseTensorFromBinaryFile` loads back with `index`
+/// positions and coordinates. The file is written when the writer is
+/// released.
+MLIR_CRUNNERUTILS_EXPORT void *
+createSparseTensorBinaryWriter(char *filename, PrimaryType valTp);
+
 /// Finalizes the outputing of a sparse tensor to a file and releases the
 /// SparseTensorWriter.
 MLIR_CRUNNERUTILS_EXPORT void delSparseTensorWriter(void *p);
@@ -318,6 +318,16 @@ public:
       return HeapAsmResourceBlob::allocate(size, align);
     });
   }
+
+  /// A function returning a parsed blob, or failure after emitting an error.
+  using LazyBlobFn = llvm::unique_function<FailureOr<AsmResourceBlob>()>;
+
+  /// Return a function parsing the resource entry represented by a binary
+  /// blob when invoked, if the parser can defer the parsing of the blob, e.g.
+  /// to only decompress it on its first use. The function may be invoked after
+  /// the parsing completed, on any thread. Returns null if the parsing of the
+  /// blob cannot be deferred, in which case `parseAsBlob` should be used.
+  virtual LazyBlobFn parseAsLazyBlob() const { return nullptr; }
 };
 
 //===----------------------------------------------------------------------===//
@@ -475,6 +485,28 @@ public:
   /// Returns if the parser should verify the IR after parsing.
   bool shouldVerifyAfterParse() const { return verifyAfterParse; }
 
+  /// Returns if the parser should parse isolated regions, such as function
+  /// bodies, in parallel on the thread pool of the context. This is only
+  /// effective when multi-threading is enabled on the context. When reading
+  /// bytecode, every isolated region is parsed in parallel. When parsing the
+  /// textual format, only the bodies of the isolated function operations are,
+  /// and not when populating an AsmParserState or completing code.
+  bool shouldParseInParallel() const { return parseInParallel; }
+
+  /// Set whether the parser should parse isolated regions in parallel.
+  void setParseInParallel(bool enable = true) { parseInParallel = enable; }
+
+  /// Returns if the bytecode reader should replace the locations of the
+  /// operations and block arguments with `UnknownLoc`. The location attributes
+  /// are then never parsed nor uniqued in the context, which is useful for
+  /// compilations that never emit diagnostics. When parsing in parallel, every
+  /// attribute of the bytecode is still parsed upfront. This does not apply to
+  /// the textual format.
+  bool shouldDropLocations() const { return dropLocations; }
+
+  /// Set whether the bytecode reader should drop the locations.
+  void setDropLocations(bool enable = true) { dropLocations = enable; }
+
   /// Return the resource parser registered to the given name, or nullptr if no
   /// parser with `name` is registered.
   AsmResourceParser *getResourceParser(StringRef name) const {
@@ -507,6 +539,8 @@ public:
 private:
   MLIRContext *context;
   bool verifyAfterParse;
+  bool parseInParallel = false;
+  bool dropLocations = false;
   DenseMap<StringRef, std::unique_ptr<AsmResourceParser>> resourceParsers;
   FallbackAsmResourceMap *fallbackResourceMap;
 };
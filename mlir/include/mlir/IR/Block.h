@@ -21,9 +21,13 @@ class BitVector;
 } // namespace llvm
 
 namespace mlir {
+class OperationName;
 class TypeRange;
 template <typename ValueRangeT>
 class ValueTypeRange;
+namespace detail {
+struct OpNameIndex;
+} // namespace detail
 
 /// `Block` represents an ordered list of `Operation`s.
 class Block : public IRObjectWithUseList<BlockOperand>,
@@ -171,6 +175,12 @@ public:
   /// Recomputes the ordering of child operations within the block.
   void recomputeOpOrder();
 
+  /// Recomputes the ordering of the child operations in the smallest window
+  /// around `op` whose indices can be spread apart, falling back to the whole
+  /// block. This keeps the amortized cost of repeated insertions at the same
+  /// point from growing linearly with the size of the block.
+  void recomputeOpOrderAround(Operation *op);
+
   /// This class provides iteration over the held operations of a block for a
   /// specific operation type.
   template <typename OpT>
@@ -193,6 +203,23 @@ public:
     return detail::op_filter_iterator<OpT, iterator>(end(), end());
   }
 
+  /// Return the operations named `name` within this block, in the order they
+  /// appear in the block. The first call builds an index of the operations of
+  /// the block by name, which is then kept up to date as operations are
+  /// inserted into and removed from the block, such that the later calls only
+  /// visit the matching operations.
+  ArrayRef<Operation *> getOpsWithName(OperationName name);
+  ArrayRef<Operation *> getOpsWithName(StringRef name);
+
+  /// Return a range over the operations within this block that are of 'OpT',
+  /// through the index of the operations by name. Unlike `getOps`, 'OpT' must
+  /// be a concrete operation class, not an interface.
+  template <typename OpT>
+  auto getIndexedOps() {
+    return llvm::map_range(getOpsWithName(OpT::getOperationName()),
+                           [](Operation *op) { return cast<OpT>(op); });
+  }
+
   /// Return an iterator range over the operation within this block excluding
   /// the terminator operation at the end.
   iterator_range<iterator> without_terminator() {
@@ -362,10 +389,21 @@ private:
   /// This is the list of arguments to the block.
   std::vector<BlockArgument> arguments;
 
+  /// The index of the operations by name, built on the first call to
+  /// `getOpsWithName`.
+  std::unique_ptr<detail::OpNameIndex> opNameIndex;
+
+  /// Update the index of the operations by name, if any, when `op` is
+  /// inserted into or removed from this block, or moved within it.
+  void addToOpNameIndex(Operation *op);
+  void removeFromOpNameIndex(Operation *op);
+  void invalidateOpNameIndexOrder(Operation *op);
+
   Block(Block &) = delete;
   void operator=(Block &) = delete;
 
   friend struct llvm::ilist_traits<Block>;
+  friend struct llvm::ilist_traits<Operation>;
 };
 } // namespace mlir
 
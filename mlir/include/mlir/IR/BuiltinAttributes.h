@@ -829,6 +829,15 @@ using DenseF32ResourceElementsAttr =
 using DenseF64ResourceElementsAttr =
     detail::DenseResourceElementsAttrBase<double>;
 
+/// Release the data of the blobs of the builtin dialect resource manager of
+/// `context` that are not referenced by a DenseResourceElementsAttr nested
+/// within `roots`. The attributes are uniqued and live as long as the context,
+/// but the data of their blobs can be released once no live IR refers to them,
+/// leaving their handles without a blob. `roots` must therefore hold all of
+/// the live IR of the context. Returns the number of bytes released.
+size_t releaseUnreferencedDenseResources(MLIRContext *context,
+                                         ArrayRef<Operation *> roots);
+
 //===----------------------------------------------------------------------===//
 // BoolAttr
 //===----------------------------------------------------------------------===//
@@ -21,6 +21,7 @@
 #include "llvm/ADT/Twine.h"
 #include "llvm/Support/RWMutex.h"
 #include "llvm/Support/SMLoc.h"
+#include <mutex>
 #include <optional>
 
 namespace mlir {
@@ -39,12 +40,40 @@ public:
     StringRef getKey() const { return key; }
 
     /// Return the blob owned by this entry if one has been initialized. Returns
-    /// nullptr otherwise.
-    const AsmResourceBlob *getBlob() const { return blob ? &*blob : nullptr; }
-    AsmResourceBlob *getBlob() { return blob ? &*blob : nullptr; }
+    /// nullptr otherwise. A lazily loaded blob is loaded on the first call.
+    const AsmResourceBlob *getBlob() const {
+      loadLazyBlob();
+      return blob ? &*blob : nullptr;
+    }
+    AsmResourceBlob *getBlob() {
+      loadLazyBlob();
+      return blob ? &*blob : nullptr;
+    }
 
     /// Set the blob owned by this entry.
-    void setBlob(AsmResourceBlob &&newBlob) { blob = std::move(newBlob); }
+    void setBlob(AsmResourceBlob &&newBlob) {
+      lazyBlob.reset();
+      blob = std::move(newBlob);
+    }
+
+    /// Set the function loading the blob of this entry on the first access to
+    /// it, which may happen on any thread. If the function fails, the entry
+    /// has no blob.
+    void setLazyBlob(AsmParsedResourceEntry::LazyBlobFn loadFn) {
+      blob.reset();
+      lazyBlob = std::make_unique<LazyBlob>();
+      lazyBlob->loadFn = std::move(loadFn);
+    }
+
+    /// Returns true if the blob of this entry is lazily loaded and has not
+    /// been loaded yet.
+    bool hasUnloadedBlob() const { return lazyBlob && lazyBlob->loadFn; }
+
+    /// Release the blob owned by this entry, if any.
+    void releaseBlob() {
+      lazyBlob.reset();
+      blob.reset();
+    }
 
   private:
     BlobEntry() = default;
@@ -61,8 +90,30 @@ public:
     /// The key used for this blob.
     StringRef key;
 
-    /// The blob that is referenced by this entry if it is valid.
-    std::optional<AsmResourceBlob> blob;
+    /// Load the blob of this entry if it is lazily loaded.
+    void loadLazyBlob() const {
+      if (!lazyBlob)
+        return;
+      std::call_once(lazyBlob->loaded, [this] {
+        FailureOr<AsmResourceBlob> loadedBlob = lazyBlob->loadFn();
+        lazyBlob->loadFn = nullptr;
+        if (succeeded(loadedBlob))
+          blob = std::move(*loadedBlob);
+      });
+    }
+
+    /// The state of a lazily loaded blob.
+    struct LazyBlob {
+      std::once_flag loaded;
+      AsmParsedResourceEntry::LazyBlobFn loadFn;
+    };
+
+    /// The blob that is referenced by this entry if it is valid. It is set by
+    /// `loadLazyBlob` on the first access to a lazily loaded blob.
+    mutable std::optional<AsmResourceBlob> blob;
+
+    /// The state of the blob of this entry if it is lazily loaded.
+    std::unique_ptr<LazyBlob> lazyBlob;
 
     /// Allow access to the constructors.
     friend DialectResourceBlobManager;
@@ -80,6 +131,11 @@ public:
   /// asserts that an entry for the given name exists in the manager.
   void update(StringRef name, AsmResourceBlob &&newBlob);
 
+  /// Update the entry defined by the provided name with a blob loaded by
+  /// `loadFn` on the first access to it. This method asserts that an entry for
+  /// the given name exists in the manager.
+  void updateLazily(StringRef name, AsmParsedResourceEntry::LazyBlobFn loadFn);
+
   /// Insert a new entry with the provided name and optional blob data. The name
   /// may be modified during insertion if another entry already exists with that
   /// name. Returns the inserted entry.
@@ -93,6 +149,16 @@ public:
     return HandleT(&entry, dialect);
   }
 
+  /// Release the blobs of the entries for which `shouldRelease` returns true.
+  /// The entries themselves are kept, as handles to them may still be held,
+  /// but no longer have a blob. Returns the number of bytes released.
+  size_t releaseBlobs(function_ref<bool(const BlobEntry &)> shouldRelease);
+
+  /// Return the total size in bytes of the data of the blobs held by this
+  /// manager. The lazily loaded blobs that were not loaded yet are not
+  /// counted, and are not loaded.
+  size_t getTotalBlobSize();
+
 private:
   /// A mutex to protect access to the blob map.
   llvm::sys::SmartRWMutex<true> blobMapLock;
@@ -150,6 +216,13 @@ public:
     getBlobManager().update(name, std::move(newBlob));
   }
 
+  /// Update the entry defined by the provided name with a blob loaded by
+  /// `loadFn` on the first access to it. This method asserts that an entry for
+  /// the given name exists in the manager.
+  void updateLazily(StringRef name, AsmParsedResourceEntry::LazyBlobFn loadFn) {
+    getBlobManager().updateLazily(name, std::move(loadFn));
+  }
+
   /// Insert a new resource blob entry with the provided name and optional blob
   /// data. The name may be modified during insertion if another entry already
   /// exists with that name. Returns a dialect specific handle to the inserted
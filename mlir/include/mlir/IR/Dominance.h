@@ -49,6 +49,19 @@ public:
   void invalidate();
   void invalidate(Region *region);
 
+  /// Update the dominance info for CFG changes that were already applied to
+  /// the IR, without recomputing the dominator trees of the affected regions.
+  /// `insertEdge` and `deleteEdge` update the tree of the region of `from` for
+  /// the insertion or deletion of the edge from `from` to its successor `to`,
+  /// and `applyUpdates` for a batch of such changes in `region`. Blocks are
+  /// added by inserting their incoming edges, and are removed from the tree by
+  /// deleting them before the blocks are erased. The regions whose entry block
+  /// changed are invalidated.
+  void insertEdge(Block *from, Block *to);
+  void deleteEdge(Block *from, Block *to);
+  void applyUpdates(Region *region,
+                    ArrayRef<typename DomTree::UpdateType> updates);
+
   /// Finds the nearest common dominator block for the two given blocks a
   /// and b. If no common dominator can be found, this function will return
   /// nullptr.
@@ -164,6 +164,14 @@ public:
   /// this call in this case.
   void setThreadPool(llvm::ThreadPool &pool);
 
+  /// Return the thread pool shared by the contexts of the process, which is
+  /// created on first use. The contexts that do not have an external thread
+  /// pool use it instead of creating their own when the command line flag
+  /// `--mlir-shared-thread-pool` is set; it may also be set explicitly with
+  /// `setThreadPool`. The parallel loops of contexts sharing a pool are
+  /// scheduled by their `ParallelPriority`, see Threading.h.
+  static llvm::ThreadPool &getSharedThreadPool();
+
   /// Return the number of threads used by the thread pool in this context. The
   /// number of computed hardware threads can change over the lifetime of a
   /// process based on affinity changes, so users should use the number of
@@ -193,6 +201,35 @@ public:
   /// emitting diagnostics.
   void printStackTraceOnDiagnostic(bool enable);
 
+  /// The policies applied by `FusedLoc::get` to the locations it fuses, which
+  /// bound the growth of the fused locations as operations get merged.
+  enum class FusedLocPolicy {
+    /// Flatten the nested fused locations with the same metadata, and drop the
+    /// duplicate and unknown locations.
+    Default,
+    /// Also flatten the nested fused locations with a different metadata,
+    /// whose metadata is dropped.
+    Flatten,
+    /// Flatten as `Flatten` does, and reduce the call site locations to their
+    /// outermost caller.
+    DropToCallSite,
+  };
+
+  /// Return the policy applied to the fused locations.
+  FusedLocPolicy getFusedLocPolicy();
+
+  /// Set the policy applied to the fused locations.
+  void setFusedLocPolicy(FusedLocPolicy policy);
+
+  /// Return the maximum number of locations of a fused location, or 0 if the
+  /// number is not bounded.
+  unsigned getMaxFusedLocations();
+
+  /// Set the maximum number of locations of a fused location, 0 meaning that
+  /// it is not bounded. The first locations are kept when the fused locations
+  /// exceed it.
+  void setMaxFusedLocations(unsigned maxLocations);
+
   /// Return a sorted array containing the information about all registered
   /// operations.
   ArrayRef<RegisteredOperationName> getRegisteredOperations();
@@ -0,0 +1,48 @@
+//===- ModifiedOpsListener.h - Track modified operations --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_IR_MODIFIEDOPSLISTENER_H
+#define MLIR_IR_MODIFIEDOPSLISTENER_H
+
+#include "mlir/IR/PatternMatch.h"
+#include "llvm/ADT/DenseSet.h"
+
+namespace mlir {
+
+/// This class represents a rewriter listener that records the operations that
+/// were modified, for example so that only these operations are re-verified
+/// afterwards (see `verifyIncrementally`). An operation is recorded when it is
+/// inserted or modified in place, and the parent operation of a created block
+/// or of an erased operation is recorded as the structure of its regions
+/// changed. Erased operations are dropped from the recorded operations.
+class ModifiedOpsListener : public RewriterBase::Listener {
+public:
+  void notifyOperationInserted(Operation *op) override;
+  void notifyBlockCreated(Block *block) override;
+  void notifyOperationModified(Operation *op) override;
+  void notifyOperationRemoved(Operation *op) override;
+
+  /// Return the operations that were recorded as modified.
+  SmallVector<Operation *> getModifiedOps() const {
+    return llvm::to_vector(modifiedOps);
+  }
+
+  /// Returns true if no operation was recorded as modified.
+  bool empty() const { return modifiedOps.empty(); }
+
+  /// Clear the recorded operations.
+  void clear() { modifiedOps.clear(); }
+
+private:
+  /// The set of operations recorded as modified.
+  DenseSet<Operation *> modifiedOps;
+};
+
+} // namespace mlir
+
+#endif // MLIR_IR_MODIFIEDOPSLISTENER_H
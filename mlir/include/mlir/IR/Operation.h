@@ -898,7 +898,7 @@ private:
             OpaqueProperties properties, bool hasOperandStorage);
 
   // Operations are deleted through the destroy() member because they are
-  // allocated with malloc.
+  // allocated with malloc, or within an OperationArena.
   ~Operation();
 
   /// Returns the additional size necessary for allocating the given objects
@@ -982,7 +982,11 @@ private:
 
   const unsigned numResults;
   const unsigned numSuccs;
-  const unsigned numRegions : 23;
+  const unsigned numRegions : 22;
+
+  /// This bit signals whether this operation was allocated within an
+  /// `OperationArena`, in which case its memory is owned by the arena.
+  bool isArenaAllocated : 1;
 
   /// This bit signals whether this operation has an operand storage or not. The
   /// operand storage may be elided for operations that are known to never have
@@ -1009,6 +1013,9 @@ private:
   // allow block to access the 'orderIndex' field.
   friend class Block;
 
+  // allow the arena to tear down the operations allocated within it.
+  friend class OperationArena;
+
   // allow value to access the 'ResultStorage' methods.
   friend class Value;
 
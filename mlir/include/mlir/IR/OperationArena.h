@@ -0,0 +1,89 @@
+//===- OperationArena.h - Arena allocation of operations --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines an arena that operations may be allocated from, allowing
+// for a whole tree of operations to be torn down at once.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_IR_OPERATIONARENA_H
+#define MLIR_IR_OPERATIONARENA_H
+
+#include "mlir/Support/LLVM.h"
+#include "llvm/Support/Allocator.h"
+
+namespace mlir {
+class Operation;
+
+/// This class represents an arena of memory that operations can be allocated
+/// from. Operations created on a thread while an arena is active on it (see
+/// `OperationArena::Scope`) are bump-pointer allocated within the arena, along
+/// with their inline operands, results, successors and regions.
+///
+/// Operations allocated in an arena keep their usual semantics: they may be
+/// erased individually, in which case they are destroyed eagerly but their
+/// memory is only reclaimed when the arena is reset. The main benefit of an
+/// arena is `destroyAndReset`, which tears down a whole tree of operations
+/// without unlinking every use and freeing every operation one at a time.
+///
+/// The arena, and the operations allocated within it, are not thread-safe: an
+/// arena must only be active on a single thread at a time. Operations created
+/// on other threads, e.g. by passes running in parallel, are allocated as
+/// usual.
+class OperationArena {
+public:
+  OperationArena() = default;
+  OperationArena(const OperationArena &) = delete;
+  OperationArena &operator=(const OperationArena &) = delete;
+
+  /// This class makes the given arena active on the current thread for the
+  /// duration of its lifetime, restoring the previously active arena (if any)
+  /// on destruction.
+  class Scope {
+  public:
+    Scope(OperationArena &arena);
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+    ~Scope();
+
+  private:
+    OperationArena *previous;
+  };
+
+  /// Return the arena active on the current thread, or nullptr if there is
+  /// none.
+  static OperationArena *getActive();
+
+  /// Allocate `size` bytes of `alignment` aligned memory.
+  void *allocate(size_t size, size_t alignment) {
+    return allocator.Allocate(size, alignment);
+  }
+
+  /// Destroy `root` and all of the operations nested within it, then reset the
+  /// arena. Operations nested within `root` must only use values defined
+  /// within `root`, which is always the case for operations that are isolated
+  /// from above, and the results of `root` must not have any uses. Any other
+  /// operation allocated in the arena must already have been destroyed.
+  /// Operations that were not allocated in the arena are destroyed as usual.
+  void destroyAndReset(Operation *root);
+
+  /// Return the total number of bytes allocated by the arena.
+  size_t getBytesAllocated() const { return allocator.getBytesAllocated(); }
+
+private:
+  /// Release the resources held by the operations nested within `op` that are
+  /// not owned by the arena, and by `op` itself if `releaseOp` is true.
+  static void releaseResources(Operation *op, bool releaseOp);
+
+  /// The allocator used for the operations.
+  llvm::BumpPtrAllocator allocator;
+};
+
+} // namespace mlir
+
+#endif // MLIR_IR_OPERATIONARENA_H
@@ -1043,6 +1043,11 @@ public:
                  ValueRange values);
   ~OperandStorage();
 
+  /// Deallocate the storage if it was dynamically allocated, without removing
+  /// the operands from the use lists of their values. This is only valid when
+  /// the values are being destroyed along with the storage.
+  void releaseWithoutUnlinking();
+
   /// Replace the operands contained in the storage with the ones provided in
   /// 'values'.
   void setOperands(Operation *owner, ValueRange values);
@@ -1101,6 +1106,12 @@ public:
   /// elements.
   OpPrintingFlags &elideLargeElementsAttrs(int64_t largeElementLimit = 16);
 
+  /// Enables the printing of large non-splat elements attributes as a hex
+  /// string of their raw data, which is much faster to print and parse than
+  /// the list of elements. The `largeElementLimit` is used to configure what
+  /// is considered to be a "large" ElementsAttr, and -1 disables the hex form.
+  OpPrintingFlags &printElementsAttrWithHexIfLarger(int64_t largeElementLimit);
+
   /// Enable or disable printing of debug information (based on `enable`). If
   /// 'prettyForm' is set to true, debug information is printed in a more
   /// readable 'pretty' form. Note: The IR generated with 'prettyForm' is not
@@ -1125,12 +1136,25 @@ public:
   /// Print users of values as comments.
   OpPrintingFlags &printValueUsers();
 
+  /// Print the isolated operations nested in the top-level operation in
+  /// parallel, e.g. the functions of a module, and concatenate them in order.
+  /// This has no effect when the multithreading of the context is disabled,
+  /// or when the locations of the printed operations are recorded.
+  OpPrintingFlags &printInParallel(bool enable = true);
+
   /// Return if the given ElementsAttr should be elided.
   bool shouldElideElementsAttr(ElementsAttr attr) const;
 
   /// Return the size limit for printing large ElementsAttr.
   std::optional<int64_t> getLargeElementsAttrLimit() const;
 
+  /// Return if the given ElementsAttr should be printed as a hex string.
+  bool shouldPrintElementsAttrWithHex(ElementsAttr attr) const;
+
+  /// Return the size limit for printing ElementsAttr as a hex string, or -1 if
+  /// the hex form is disabled.
+  int64_t getElementsAttrHexLimit() const;
+
   /// Return if debug information should be printed.
   bool shouldPrintDebugInfo() const;
 
@@ -1152,11 +1176,18 @@ public:
   /// Return if the printer should print users of values.
   bool shouldPrintValueUsers() const;
 
+  /// Return if the printer should print isolated operations in parallel.
+  bool shouldPrintInParallel() const;
+
 private:
   /// Elide large elements attributes if the number of elements is larger than
   /// the upper limit.
   std::optional<int64_t> elementsAttrElementLimit;
 
+  /// Print non-splat elements attributes as a hex string if the number of
+  /// elements is larger than this limit, unless it is -1.
+  int64_t elementsAttrHexElementLimit;
+
   /// Print debug information.
   bool printDebugInfoFlag : 1;
   bool printDebugInfoPrettyFormFlag : 1;
@@ -1175,6 +1206,9 @@ private:
 
   /// Print users of values.
   bool printValueUsersFlag : 1;
+
+  /// Print isolated operations in parallel.
+  bool printInParallelFlag : 1;
 };
 
 //===----------------------------------------------------------------------===//
@@ -13,6 +13,8 @@
 #ifndef MLIR_IR_OWNINGOPREF_H
 #define MLIR_IR_OWNINGOPREF_H
 
+#include "mlir/IR/OperationArena.h"
+#include <memory>
 #include <utility>
 
 namespace mlir {
@@ -32,16 +34,21 @@ public:
 
   OwningOpRef(std::nullptr_t = nullptr) : op(nullptr) {}
   OwningOpRef(OpTy op) : op(op) {}
-  OwningOpRef(OwningOpRef &&other) : op(other.release()) {}
-  ~OwningOpRef() {
-    if (op)
-      op->erase();
+  /// Create a reference owning both `op` and the arena it was allocated in. On
+  /// destruction, the op is torn down at once along with the arena, see
+  /// `OperationArena::destroyAndReset`.
+  OwningOpRef(OpTy op, std::unique_ptr<OperationArena> arena)
+      : op(op), arena(std::move(arena)) {}
+  OwningOpRef(OwningOpRef &&other)
+      : op(other.op), arena(std::move(other.arena)) {
+    other.op = nullptr;
   }
+  ~OwningOpRef() { destroy(); }
 
   /// Assign from another op reference.
   OwningOpRef &operator=(OwningOpRef &&other) {
-    if (op)
-      op->erase();
+    destroy();
+    arena = std::move(other.arena);
     op = other.release();
     return *this;
   }
@@ -60,17 +67,38 @@ public:
   explicit operator bool() const { return op; }
 
   /// Downcast to generic operation.
-  operator OwningOpRef<Operation *>() && { return release().getOperation(); }
+  operator OwningOpRef<Operation *>() && {
+    std::unique_ptr<OperationArena> ownedArena = std::move(arena);
+    return {release().getOperation(), std::move(ownedArena)};
+  }
 
-  /// Release the referenced op.
+  /// Release the referenced op. If an arena is attached, it is intentionally
+  /// leaked given that the released op must remain valid.
   OpTy release() {
+    (void)arena.release();
     OpTy released(nullptr);
     std::swap(released, op);
     return released;
   }
 
 private:
+  /// Destroy the held op, if any.
+  void destroy() {
+    if (!op)
+      return;
+    if (!arena)
+      return op->erase();
+    if constexpr (std::is_pointer<OpTy>::value)
+      arena->destroyAndReset(op);
+    else
+      arena->destroyAndReset(op.getOperation());
+    arena.reset();
+  }
+
   OpTy op;
+
+  /// The arena owning the memory of the held op, if any.
+  std::unique_ptr<OperationArena> arena;
 };
 
 } // namespace mlir
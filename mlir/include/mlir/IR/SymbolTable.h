@@ -283,6 +283,7 @@ public:
 
 private:
   friend class LockedSymbolTableCollection;
+  friend class SymbolUseIndex;
 
   /// The constructed symbol tables nested within this table.
   DenseMap<Operation *, std::unique_ptr<SymbolTable>> symbolTables;
@@ -379,6 +380,55 @@ private:
   DenseMap<Operation *, SetVector<Operation *>> symbolToUsers;
 };
 
+//===----------------------------------------------------------------------===//
+// SymbolUseIndex
+//===----------------------------------------------------------------------===//
+
+/// This class represents an index of the symbol uses held by the operations
+/// directly nested within a tree of symbol tables, resolved to the symbols
+/// that they reference. The indexed symbol tables are the provided symbol table
+/// operation and, recursively, all of the symbol tables directly nested within
+/// an indexed symbol table. The index is built once, in parallel when
+/// multi-threading is enabled, allowing for clients to query the use graph of
+/// the symbols without re-walking the IR. The index is not updated when the IR
+/// is modified.
+class SymbolUseIndex {
+public:
+  /// Build an index for the symbol tables nested within, and including,
+  /// `symbolTableOp`. The symbol tables used to resolve the uses are cached in
+  /// the provided symbol table collection, which must not be accessed by any
+  /// other thread while the index is being built.
+  SymbolUseIndex(SymbolTableCollection &symbolTable, Operation *symbolTableOp);
+
+  /// Return the symbols referenced by `op`, which must be directly nested
+  /// within one of the indexed symbol tables. References to unknown symbols
+  /// are ignored. Returns failure if `op` contains potentially unknown symbol
+  /// tables, meaning that its symbol uses can't be reliably computed.
+  FailureOr<ArrayRef<Operation *>> getReferencedSymbols(Operation *op) const;
+
+  /// Return the indexed operations that reference the provided symbol.
+  ArrayRef<Operation *> getUsers(Operation *symbol) const {
+    auto it = symbolToUsers.find(symbol);
+    return it != symbolToUsers.end() ? ArrayRef<Operation *>(it->second)
+                                     : std::nullopt;
+  }
+
+  /// Return the indexed symbol tables, in breadth-first order.
+  ArrayRef<Operation *> getSymbolTableOps() const { return symbolTableOps; }
+
+private:
+  /// The indexed symbol table operations.
+  SmallVector<Operation *> symbolTableOps;
+
+  /// A map of indexed operations to the symbols that they reference, or
+  /// std::nullopt if the uses of the operation could not be computed.
+  DenseMap<Operation *, std::optional<SmallVector<Operation *, 2>>>
+      opToSymbols;
+
+  /// A map of symbol operations to the indexed operations that use them.
+  DenseMap<Operation *, SmallVector<Operation *, 2>> symbolToUsers;
+};
+
 //===----------------------------------------------------------------------===//
 // SymbolTable Trait Types
 //===----------------------------------------------------------------------===//
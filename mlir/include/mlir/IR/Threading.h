@@ -21,21 +21,101 @@
 #include "llvm/ADT/Sequence.h"
 #include "llvm/Support/ThreadPool.h"
 #include <atomic>
+#include <functional>
 
 namespace mlir {
 
+/// The priority of the parallel processing started by a thread. When several
+/// parallel loops share a thread pool, e.g. the ones of the contexts using the
+/// same pool, the tasks of the loops of lower priority yield between two
+/// elements to the tasks of higher priority queued after them. This lets the
+/// latency-critical work of a process pre-empt its background work.
+enum class ParallelPriority : unsigned { Background, Default, Critical };
+
+/// Sets the priority of the parallel loops started on the current thread, and
+/// of the loops nested in them, for the lifetime of the scope.
+class ParallelPriorityScope {
+public:
+  explicit ParallelPriorityScope(ParallelPriority priority);
+  ~ParallelPriorityScope();
+
+private:
+  unsigned previousLevel;
+};
+
+namespace detail {
+/// Tracks the tasks queued on a thread pool by the parallel loops, by
+/// scheduling level. The level of a loop combines its priority with its
+/// nesting depth, so that the tasks of an outer loop yield to the tasks of the
+/// loops nested in its elements as well. The latter are thus processed first,
+/// which unblocks their waiting parent sooner, instead of the nested loops
+/// running serially on the thread waiting for them.
+class ParallelTaskQueue {
+public:
+  /// Returns the queue tracking the tasks of the given thread pool.
+  static ParallelTaskQueue &get(llvm::ThreadPool &threadPool);
+
+  /// Returns the level of the tasks of the loops started on the current
+  /// thread.
+  static unsigned getCurrentLevel();
+
+  /// Notifies that a task of the given level is queued.
+  void notifyQueued(unsigned level) { ++numQueued[level]; }
+
+  /// Notifies that a task of the given level starts.
+  void notifyStarted(unsigned level) { --numQueued[level]; }
+
+  /// Returns true if a task of the given level running on the current thread
+  /// should yield to the queued tasks of higher levels. The tasks run by a
+  /// thread waiting for their loop never yield, as the thread only processes
+  /// the tasks of that loop.
+  bool shouldYield(unsigned level) const;
+
+  /// Waits for the tasks of the given group, participating in their processing
+  /// if the current thread is a worker of the pool.
+  static void wait(llvm::ThreadPoolTaskGroup &group);
+
+  /// Sets the scheduling state of the current thread for the loops nested in a
+  /// task of the given level, for the lifetime of the scope.
+  class TaskScope {
+  public:
+    explicit TaskScope(unsigned level);
+    ~TaskScope();
+
+  private:
+    unsigned previousLevel;
+  };
+
+  /// The number of nesting depths distinguished within a priority.
+  static constexpr unsigned kNumDepths = 4;
+  static constexpr unsigned kNumLevels =
+      kNumDepths * (static_cast<unsigned>(ParallelPriority::Critical) + 1);
+
+private:
+  std::atomic<unsigned> numQueued[kNumLevels] = {};
+};
+} // namespace detail
+
 /// Invoke the given function on the elements between [begin, end)
-/// asynchronously. If the given function returns a failure when processing any
-/// of the elements, execution is stopped and a failure is returned from this
-/// function. This means that in the case of failure, not all elements of the
-/// range will be processed. Diagnostics emitted during processing are ordered
-/// relative to the element's position within [begin, end). If the provided
-/// context does not have multi-threading enabled, this function always
-/// processes elements sequentially.
+/// asynchronously, starting the processing of the elements in the order given
+/// by `schedule`. `schedule` is either empty, in which case the elements are
+/// started in order, or a permutation of the indices of the elements. This is
+/// useful to start the processing of the more expensive elements first. If
+/// the given function returns a failure when processing any of the elements,
+/// execution is stopped and a failure is returned from this function. This
+/// means that in the case of failure, not all elements of the range will be
+/// processed. Diagnostics emitted during processing are ordered relative to
+/// the element's position within [begin, end), regardless of the schedule. If
+/// the provided context does not have multi-threading enabled, this function
+/// always processes elements sequentially and in order.
 template <typename IteratorT, typename FuncT>
 LogicalResult failableParallelForEach(MLIRContext *context, IteratorT begin,
-                                      IteratorT end, FuncT &&func) {
+                                      IteratorT end,
+                                      ArrayRef<unsigned> schedule,
+                                      FuncT &&func) {
   unsigned numElements = static_cast<unsigned>(std::distance(begin, end));
+  assert((schedule.empty() || schedule.size() == numElements) &&
+         "expected the schedule to cover each element");
   if (numElements == 0)
     return success();
 
@@ -48,36 +128,67 @@ LogicalResult failableParallelForEach(MLIRContext *context, IteratorT begin,
     return success();
   }
 
+  // Otherwise, process the elements in parallel.
+  llvm::ThreadPool &threadPool = context->getThreadPool();
+  llvm::ThreadPoolTaskGroup tasksGroup(threadPool);
+  detail::ParallelTaskQueue &queue = detail::ParallelTaskQueue::get(threadPool);
+  unsigned level = detail::ParallelTaskQueue::getCurrentLevel();
+
   // Build a wrapper processing function that properly initializes a parallel
-  // diagnostic handler.
+  // diagnostic handler. Between two elements, the task yields to the tasks of
+  // higher levels by requeuing itself behind them.
   ParallelDiagnosticHandler handler(context);
   std::atomic<unsigned> curIndex(0);
   std::atomic<bool> processingFailed(false);
+  std::function<void()> queueTask;
   auto processFn = [&] {
+    queue.notifyStarted(level);
+    detail::ParallelTaskQueue::TaskScope scope(level);
     while (!processingFailed) {
       unsigned index = curIndex++;
       if (index >= numElements)
         break;
+      if (!schedule.empty())
+        index = schedule[index];
       handler.setOrderIDForThread(index);
       if (failed(func(*std::next(begin, index))))
         processingFailed = true;
       handler.eraseOrderIDForThread();
+      if (curIndex < numElements && queue.shouldYield(level))
+        return queueTask();
     }
   };
+  queueTask = [&] {
+    queue.notifyQueued(level);
+    tasksGroup.async(processFn);
+  };
 
-  // Otherwise, process the elements in parallel.
-  llvm::ThreadPool &threadPool = context->getThreadPool();
-  llvm::ThreadPoolTaskGroup tasksGroup(threadPool);
   size_t numActions = std::min(numElements, threadPool.getThreadCount());
   for (unsigned i = 0; i < numActions; ++i)
-    tasksGroup.async(processFn);
+    queueTask();
   // If the current thread is a worker thread from the pool, then waiting for
   // the task group allows the current thread to also participate in processing
   // tasks from the group, which avoid any deadlock/starvation.
-  tasksGroup.wait();
+  detail::ParallelTaskQueue::wait(tasksGroup);
   return failure(processingFailed);
 }
 
+/// Invoke the given function on the elements between [begin, end)
+/// asynchronously. If the given function returns a failure when processing any
+/// of the elements, execution is stopped and a failure is returned from this
+/// function. This means that in the case of failure, not all elements of the
+/// range will be processed. Diagnostics emitted during processing are ordered
+/// relative to the element's position within [begin, end). If the provided
+/// context does not have multi-threading enabled, this function always
+/// processes elements sequentially.
+template <typename IteratorT, typename FuncT>
+LogicalResult failableParallelForEach(MLIRContext *context, IteratorT begin,
+                                      IteratorT end, FuncT &&func) {
+  return failableParallelForEach(context, begin, end,
+                                 /*schedule=*/std::nullopt,
+                                 std::forward<FuncT>(func));
+}
+
 /// Invoke the given function on the elements in the provided range
 /// asynchronously. If the given function returns a failure when processing any
 /// of the elements, execution is stopped and a failure is returned from this
@@ -21,6 +21,8 @@ namespace mlir {
 
 class Operation;
 template <typename OperandType>
+class IRObjectWithUseList;
+template <typename OperandType>
 class ValueUseIterator;
 template <typename UseIteratorT, typename OperandType>
 class ValueUserIterator;
@@ -111,6 +113,10 @@ protected:
 private:
   /// The operation owner of this operand.
   Operation *const owner;
+
+  /// Allow the use lists to update their chains in bulk.
+  template <typename OperandType>
+  friend class mlir::IRObjectWithUseList;
 };
 } // namespace detail
 
@@ -174,6 +180,9 @@ private:
 
   /// Insert this operand into the given use list.
   void insertIntoCurrent() { insertInto(DerivedT::getUseList(value)); }
+
+  /// Allow the use list of the value to update the operands in bulk.
+  friend IRObjectWithUseList<DerivedT>;
 };
 
 //===----------------------------------------------------------------------===//
@@ -201,8 +210,25 @@ public:
   void replaceAllUsesWith(ValueT &&newValue) {
     assert((!newValue || this != OperandType::getUseList(newValue)) &&
            "cannot RAUW a value with itself");
-    while (!use_empty())
-      use_begin()->set(newValue);
+    if (use_empty())
+      return;
+
+    // Update the uses in a single pass over the use-list, instead of unlinking
+    // and relinking them one at a time. The uses are pushed to the front of the
+    // use-list of `newValue`, so that they end up in the same order as if they
+    // were updated with `set`.
+    IRObjectWithUseList<OperandType> *newUseList =
+        OperandType::getUseList(newValue);
+    detail::IROperandBase *use = firstUse;
+    while (use) {
+      detail::IROperandBase *next = use->nextUse;
+      static_cast<OperandType *>(use)->value = newValue;
+      use->linkTo(newUseList->firstUse);
+      newUseList->firstUse = use;
+      use = next;
+    }
+    newUseList->firstUse->back = &newUseList->firstUse;
+    firstUse = nullptr;
   }
 
   /// Shuffle the use-list chain according to the provided indices vector, which
@@ -250,6 +276,24 @@ public:
   /// Returns true if this value has no uses.
   bool use_empty() const { return firstUse == nullptr; }
 
+  /// Returns true if this value has exactly `n` uses. Only the first `n + 1`
+  /// uses are visited.
+  bool hasNUses(unsigned n) const {
+    detail::IROperandBase *use = firstUse;
+    for (; use && n != 0; --n)
+      use = use->nextUse;
+    return n == 0 && !use;
+  }
+
+  /// Returns true if this value has `n` uses or more. Only the first `n` uses
+  /// are visited.
+  bool hasNUsesOrMore(unsigned n) const {
+    detail::IROperandBase *use = firstUse;
+    for (; use && n != 0; --n)
+      use = use->nextUse;
+    return n == 0;
+  }
+
   //===--------------------------------------------------------------------===//
   // Users
   //===--------------------------------------------------------------------===//
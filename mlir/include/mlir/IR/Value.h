@@ -211,6 +211,12 @@ public:
   /// Returns true if this value has no uses.
   bool use_empty() const { return impl->use_empty(); }
 
+  /// Returns true if this value has exactly `n` uses.
+  bool hasNUses(unsigned n) const { return impl->hasNUses(n); }
+
+  /// Returns true if this value has `n` uses or more.
+  bool hasNUsesOrMore(unsigned n) const { return impl->hasNUsesOrMore(n); }
+
   //===--------------------------------------------------------------------===//
   // Users
 
@@ -9,6 +9,8 @@
 #ifndef MLIR_IR_VERIFIER_H
 #define MLIR_IR_VERIFIER_H
 
+#include "mlir/Support/LLVM.h"
+
 namespace mlir {
 struct LogicalResult;
 class Operation;
@@ -21,6 +23,15 @@ class Operation;
 /// on nested operations.
 LogicalResult verify(Operation *op, bool verifyRecursively = true);
 
+/// Perform the checks of `verify` on `root`, but only for the operations that
+/// may have been invalidated by modifying the given operations: the modified
+/// operations and the operations nested within them, the users of their
+/// results, and their ancestors up to `root`. Modified operations that are not
+/// nested within `root` are ignored. This assumes that `root` was valid before
+/// the modifications, and that no other operation was modified since.
+LogicalResult verifyIncrementally(Operation *root,
+                                  ArrayRef<Operation *> modifiedOps);
+
 } // namespace mlir
 
 #endif
@@ -173,7 +173,6 @@ void walk(Operation *op, function_ref<void(Operation *)> callback,
   if (order == WalkOrder::PreOrder)
     callback(op);
 
-  // TODO: This walk should be iterative over the operations.
   for (auto &region : Iterator::makeIterable(*op)) {
     for (auto &block : Iterator::makeIterable(region)) {
       // Early increment here in the case where the operation is erased.
@@ -187,6 +186,13 @@ void walk(Operation *op, function_ref<void(Operation *)> callback,
     callback(op);
 }
 
+/// The forward walk over the operations is iterative, with an explicit stack
+/// instead of recursion, such that deeply nested IR cannot overflow the stack.
+template <>
+void walk<ForwardIterator>(Operation *op,
+                           function_ref<void(Operation *)> callback,
+                           WalkOrder order);
+
 /// Walk all of the regions, blocks, or operations nested under (and including)
 /// the given operation. The order in which regions, blocks and operations at
 /// the same nesting level are visited (e.g., lexicographical or reverse
@@ -265,7 +271,6 @@ WalkResult walk(Operation *op, function_ref<WalkResult(Operation *)> callback,
       return WalkResult::interrupt();
   }
 
-  // TODO: This walk should be iterative over the operations.
   for (auto &region : Iterator::makeIterable(*op)) {
     for (auto &block : Iterator::makeIterable(region)) {
       // Early increment here in the case where the operation is erased.
@@ -282,6 +287,14 @@ WalkResult walk(Operation *op, function_ref<WalkResult(Operation *)> callback,
   return WalkResult::advance();
 }
 
+/// The forward walk over the operations is iterative, with an explicit stack
+/// instead of recursion, such that deeply nested IR cannot overflow the stack.
+template <>
+WalkResult
+walk<ForwardIterator>(Operation *op,
+                      function_ref<WalkResult(Operation *)> callback,
+                      WalkOrder order);
+
 // Below are a set of functions to walk nested operations. Users should favor
 // the direct `walk` methods on the IR classes(Operation/Block/etc) over these
 // methods. They are also templated to allow for statically dispatching based
@@ -12,9 +12,11 @@
 #include "mlir/Analysis/FlatLinearValueConstraints.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/OpDefinition.h"
+#include "mlir/IR/PatternMatch.h"
 #include "mlir/IR/Value.h"
 #include "mlir/Interfaces/DestinationStyleOpInterface.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Allocator.h"
 
 #include <queue>
 
@@ -205,6 +207,8 @@ public:
   AffineExpr getExpr(int64_t constant);
 
 protected:
+  friend class ValueBoundsCache;
+
   /// Dimension identifier to indicate a value is index-typed. This is used for
   /// internal data structures/API only.
   static constexpr int64_t kIndexValue = -1;
@@ -214,6 +218,22 @@ protected:
 
   ValueBoundsConstraintSet(MLIRContext *ctx);
 
+  /// Implementations of `computeBound` and `computeConstantBound`, which also
+  /// collect the owners of the values visited in `visitedOps`, if provided.
+  static LogicalResult
+  computeBoundImpl(AffineMap &resultMap, ValueDimList &mapOperands,
+                   presburger::BoundType type, Value value,
+                   std::optional<int64_t> dim, StopConditionFn stopCondition,
+                   bool closedUB, SmallPtrSetImpl<Operation *> *visitedOps);
+  static FailureOr<int64_t>
+  computeConstantBoundImpl(presburger::BoundType type, AffineMap map,
+                           ValueDimList mapOperands,
+                           StopConditionFn stopCondition, bool closedUB,
+                           SmallPtrSetImpl<Operation *> *visitedOps);
+
+  /// Record the owner of the given value in `visitedOps`, if set.
+  void recordVisit(Value value);
+
   /// Iteratively process all elements on the worklist until an index-typed
   /// value or shaped value meets `stopCondition`. Such values are not processed
   /// any further.
@@ -264,6 +284,92 @@ protected:
 
   /// Builder for constructing affine expressions.
   Builder builder;
+
+  /// The owners of the values visited while populating the constraint set, the
+  /// modification of which invalidates the bounds computed from it.
+  SmallPtrSetImpl<Operation *> *visitedOps = nullptr;
+};
+
+/// A cache of the bounds computed by `ValueBoundsConstraintSet`, for the
+/// transformations issuing many overlapping queries on the same IR. A cached
+/// bound is invalidated when an op of the backward slice it was computed from
+/// is modified, replaced or erased, which the cache observes as a rewriter
+/// listener, e.g. through `GreedyRewriteConfig::listener`.
+///
+/// Only the queries without a custom stop condition are cached. Note: The IR
+/// modifications that are not notified to the listener, e.g. replacing the
+/// uses of a value with `Value::replaceAllUsesWith`, require clearing the
+/// cache.
+class ValueBoundsCache : public RewriterBase::Listener {
+public:
+  /// See `ValueBoundsConstraintSet::computeConstantBound`, without a stop
+  /// condition.
+  FailureOr<int64_t>
+  computeConstantBound(presburger::BoundType type, Value value,
+                       std::optional<int64_t> dim = std::nullopt,
+                       bool closedUB = false);
+  FailureOr<int64_t> computeConstantBound(presburger::BoundType type,
+                                          AffineMap map,
+                                          ValueDimList mapOperands,
+                                          bool closedUB = false);
+
+  /// See `ValueBoundsConstraintSet::areEqual`.
+  FailureOr<bool> areEqual(Value value1, Value value2,
+                           std::optional<int64_t> dim1 = std::nullopt,
+                           std::optional<int64_t> dim2 = std::nullopt);
+
+  /// See `ValueBoundsConstraintSet::computeDependentBound`.
+  LogicalResult computeDependentBound(AffineMap &resultMap,
+                                      ValueDimList &mapOperands,
+                                      presburger::BoundType type, Value value,
+                                      std::optional<int64_t> dim,
+                                      ValueDimList dependencies,
+                                      bool closedUB = false);
+
+  /// Drop all of the cached bounds.
+  void clear();
+
+  /// Return the number of queries answered from the cache, and computed.
+  unsigned getNumHits() const { return numHits; }
+  unsigned getNumMisses() const { return numMisses; }
+
+  /// Invalidate the bounds computed from the notified ops.
+  using RewriterBase::Listener::notifyOperationReplaced;
+  void notifyOperationModified(Operation *op) override { invalidate(op); }
+  void notifyOperationReplaced(Operation *op, ValueRange) override {
+    invalidate(op);
+  }
+  void notifyOperationRemoved(Operation *op) override;
+
+private:
+  /// A computed bound, either constant or expressed as an affine map of the
+  /// given operands.
+  struct CachedBound {
+    LogicalResult status = failure();
+    int64_t constant = 0;
+    AffineMap map;
+    ValueDimList mapOperands;
+  };
+  using Key = ArrayRef<uintptr_t>;
+
+  /// Return the bound cached for `key`, or compute it with `compute`, which
+  /// collects the ops that the bound depends on, and cache it.
+  CachedBound
+  lookupOrCompute(ArrayRef<uintptr_t> key, ArrayRef<Value> keyValues,
+                  function_ref<CachedBound(SmallPtrSetImpl<Operation *> &)>
+                      compute);
+
+  /// Invalidate the bounds computed from `op`.
+  void invalidate(Operation *op);
+
+  /// The cached bounds, and the keys of the bounds computed from each op. The
+  /// keys are owned by `allocator`.
+  DenseMap<Key, CachedBound> bounds;
+  DenseMap<Operation *, SmallVector<Key>> keysByOp;
+  llvm::BumpPtrAllocator allocator;
+
+  unsigned numHits = 0;
+  unsigned numMisses = 0;
 };
 
 } // namespace mlir
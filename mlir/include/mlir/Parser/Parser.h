@@ -17,8 +17,11 @@
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/OwningOpRef.h"
 #include <cstddef>
+#include <optional>
 
 namespace llvm {
+struct Align;
+class MemoryBuffer;
 class SourceMgr;
 class SMDiagnostic;
 class StringRef;
@@ -83,6 +86,18 @@ inline OwningOpRef<ContainerOpT> constructContainerOpForParserIfNecessary(
 }
 } // namespace detail
 
+/// Open the file specified by `filename` so that it can be parsed by
+/// `parseSourceFile`. Files containing MLIR bytecode are memory mapped without
+/// requiring a null terminator, so that when the returned buffer is owned by a
+/// shared source manager, resource blobs reference the mapped pages directly
+/// instead of being copied into the context. Other files are read into a null
+/// terminated buffer, as required by the textual parser. If `alignment` is
+/// provided, the returned buffer is aligned to it. On failure, null is returned
+/// and `errorMessage` is populated if it is non-null.
+std::unique_ptr<llvm::MemoryBuffer>
+openSourceFile(llvm::StringRef filename, std::string *errorMessage = nullptr,
+               std::optional<llvm::Align> alignment = std::nullopt);
+
 /// This parses the file specified by the indicated SourceMgr and appends parsed
 /// operations to the given block. If the block is non-empty, the operations are
 /// placed before the current terminator. If parsing is successful, success is
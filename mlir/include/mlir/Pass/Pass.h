@@ -14,9 +14,12 @@
 #include "mlir/Support/LogicalResult.h"
 #include "llvm/ADT/PointerIntPair.h"
 #include "llvm/ADT/Statistic.h"
+#include <memory>
 #include <optional>
 
 namespace mlir {
+class ModifiedOpsListener;
+
 namespace detail {
 class OpToOpPassAdaptor;
 struct OpPassManagerImpl;
@@ -43,6 +46,10 @@ struct PassExecutionState {
   /// This is a callback in the PassManager that allows to schedule dynamic
   /// pipelines that will be rooted at the provided operation.
   function_ref<LogicalResult(OpPassManager &, Operation *)> pipelineExecutor;
+
+  /// The listener recording the operations modified by the current execution,
+  /// if the pass requested one.
+  std::shared_ptr<ModifiedOpsListener> modifiedOpsListener;
 };
 } // namespace detail
 
@@ -246,6 +253,15 @@ protected:
     getPassState().preservedAnalyses.preserve(id);
   }
 
+  /// Return a listener that records the operations modified by the current
+  /// execution of this pass. By requesting this listener, a pass declares that
+  /// it only modifies the IR through rewriters notifying it, e.g. by setting it
+  /// as the `listener` of a `GreedyRewriteConfig`. When the verifier runs after
+  /// the pass, this allows for only re-verifying the IR that may have been
+  /// invalidated by the recorded modifications, instead of all of the IR
+  /// nested within the current operation.
+  ModifiedOpsListener &getModifiedOpsListener();
+
   /// Returns the analysis for the given parent operation if it exists.
   template <typename AnalysisT>
   std::optional<std::reference_wrapper<AnalysisT>>
@@ -18,9 +18,14 @@
 #include "llvm/Support/raw_ostream.h"
 
 #include <functional>
+#include <memory>
 #include <vector>
 #include <optional>
 
+namespace llvm {
+class MemoryBuffer;
+} // namespace llvm
+
 namespace mlir {
 class AnalysisManager;
 class MLIRContext;
@@ -203,6 +208,32 @@ enum class PassDisplayMode {
   Pipeline,
 };
 
+/// This class represents a cache of the results of running nested pass
+/// pipelines, used to avoid rerunning a pipeline on an operation that it has
+/// already been run on. Entries are keyed on a fingerprint of the pipeline and
+/// of the operation it runs on, and hold the resultant operation encoded as
+/// bytecode. Implementations must be thread-safe, as nested pipelines may run
+/// in parallel.
+class PassPipelineCache {
+public:
+  virtual ~PassPipelineCache();
+
+  /// Return the entry stored for the given key, or nullptr if there is none.
+  virtual std::unique_ptr<llvm::MemoryBuffer> lookup(StringRef key) = 0;
+
+  /// Store `result` as the entry for the given key.
+  virtual void insert(StringRef key, StringRef result) = 0;
+};
+
+/// Create a pipeline cache that holds its entries in memory.
+std::unique_ptr<PassPipelineCache> createInMemoryPassPipelineCache();
+
+/// Create a pipeline cache that holds its entries as files within the given
+/// directory, which is created if necessary. Such a cache may be shared by
+/// multiple processes.
+std::unique_ptr<PassPipelineCache>
+createDirectoryPassPipelineCache(StringRef directory);
+
 /// The main pass manager and pipeline builder.
 class PassManager : public OpPassManager {
 public:
@@ -228,6 +259,25 @@ public:
   /// manager on construction.
   LogicalResult run(Operation *op);
 
+  /// Run the passes within this manager on the provided operation, one nested
+  /// operation at a time. The pipeline must only be made of nested pass
+  /// managers, i.e. no pass may be anchored on `op` itself. For each operation
+  /// nested directly within `op`, `prepare` is invoked before any nested
+  /// pipeline runs on it, then every nested pipeline that can be scheduled on
+  /// it is run in order, and finally `release` is invoked. Unlike `run`, all
+  /// nested pipelines complete on an operation before the next one is
+  /// processed, and nested operations are processed sequentially.
+  ///
+  /// This allows for materializing lazily loaded operations just before they
+  /// are transformed (e.g. with `BytecodeReader::materialize`), and writing out
+  /// and erasing them afterwards, keeping the memory footprint proportional to
+  /// the largest nested operation rather than to `op`. `release` may erase the
+  /// operation it is given. Crash reproducer generation is not supported in
+  /// this mode.
+  LogicalResult
+  runStreaming(Operation *op, function_ref<LogicalResult(Operation *)> prepare,
+               function_ref<LogicalResult(Operation *)> release = nullptr);
+
   /// Return an instance of the context.
   MLIRContext *getContext() const { return context; }
 
@@ -235,7 +285,8 @@ public:
   /// of a crash or a pass failure. `outputFile` is a .mlir filename used to
   /// write the generated reproducer. If `genLocalReproducer` is true, the pass
   /// manager will attempt to generate a local reproducer that contains the
-  /// smallest pipeline.
+  /// smallest pipeline, and only the operation the failing pass ran on along
+  /// with declarations of the symbols it references.
   void enableCrashReproducerGeneration(StringRef outputFile,
                                        bool genLocalReproducer = false);
 
@@ -265,6 +316,18 @@ public:
   /// Runs the verifier after each individual pass.
   void enableVerifier(bool enabled = true);
 
+  /// Enable caching the results of the nested pipelines of this pass manager
+  /// within `cache`. Before running a nested pipeline on an operation that is
+  /// isolated from above, the operation is fingerprinted together with the
+  /// pipeline, and if the cache holds a result for that fingerprint it is
+  /// spliced in place of the operation body instead of running the pipeline.
+  /// The fingerprint is computed from the bytecode encoding of the operation,
+  /// which includes its locations and the versions of the dialects it uses.
+  /// Note that the diagnostics and statistics produced while running a
+  /// pipeline are not replayed when its result is found in the cache. Passing
+  /// nullptr disables caching.
+  void enablePipelineCache(std::shared_ptr<PassPipelineCache> cache);
+
   //===--------------------------------------------------------------------===//
   // Instrumentations
   //===--------------------------------------------------------------------===//
@@ -295,10 +358,18 @@ public:
     ///       above.
     /// * 'opPrintingFlags' sets up the printing flags to use when printing the
     ///   IR.
+    /// * 'printAsynchronously' signals that the IR should be printed on a
+    ///   background thread, from a clone of the printed operation, instead of
+    ///   blocking the pipeline. The streams provided to the print callbacks
+    ///   must then outlive the instrumentation.
+    /// * 'bytecodeDirectory', if not empty, signals that the IR should be
+    ///   written as bytecode to a new file of this directory for each dump,
+    ///   with only the dump header and the file path printed to the stream.
     explicit IRPrinterConfig(
         bool printModuleScope = false, bool printAfterOnlyOnChange = false,
         bool printAfterOnlyOnFailure = false,
-        OpPrintingFlags opPrintingFlags = OpPrintingFlags());
+        OpPrintingFlags opPrintingFlags = OpPrintingFlags(),
+        bool printAsynchronously = false, StringRef bytecodeDirectory = {});
     virtual ~IRPrinterConfig();
 
     /// A hook that may be overridden by a derived config that checks if the IR
@@ -331,6 +402,13 @@ public:
     /// Returns the printing flags to be used to print the IR.
     OpPrintingFlags getOpPrintingFlags() const { return opPrintingFlags; }
 
+    /// Returns true if the IR should be printed on a background thread.
+    bool shouldPrintAsynchronously() const { return printAsynchronously; }
+
+    /// Returns the directory to write the IR to as bytecode, or an empty string
+    /// if the IR should be printed to the stream.
+    StringRef getBytecodeDirectory() const { return bytecodeDirectory; }
+
   private:
     /// A flag that indicates if the IR should be printed at module scope.
     bool printModuleScope;
@@ -345,6 +423,13 @@ public:
 
     /// Flags to control printing behavior.
     OpPrintingFlags opPrintingFlags;
+
+    /// A flag that indicates if the IR should be printed on a background
+    /// thread.
+    bool printAsynchronously;
+
+    /// The directory to write the IR to as bytecode, if not empty.
+    std::string bytecodeDirectory;
   };
 
   /// Add an instrumentation to print the IR before and after pass execution,
@@ -368,6 +453,10 @@ public:
   /// * 'out' corresponds to the stream to output the printed IR to.
   /// * 'opPrintingFlags' sets up the printing flags to use when printing the
   ///   IR.
+  /// * 'printAsynchronously' signals that the IR should be printed on a
+  ///   background thread, from a clone of the printed operation.
+  /// * 'bytecodeDirectory', if not empty, signals that the IR should be
+  ///   written as bytecode to a new file of this directory for each dump.
   void enableIRPrinting(
       std::function<bool(Pass *, Operation *)> shouldPrintBeforePass =
           [](Pass *, Operation *) { return true; },
@@ -375,7 +464,8 @@ public:
           [](Pass *, Operation *) { return true; },
       bool printModuleScope = true, bool printAfterOnlyOnChange = true,
       bool printAfterOnlyOnFailure = false, raw_ostream &out = llvm::errs(),
-      OpPrintingFlags opPrintingFlags = OpPrintingFlags());
+      OpPrintingFlags opPrintingFlags = OpPrintingFlags(),
+      bool printAsynchronously = false, StringRef bytecodeDirectory = {});
 
   //===--------------------------------------------------------------------===//
   // Pass Timing
@@ -416,16 +506,39 @@ public:
   void
   enableStatistics(PassDisplayMode displayMode = PassDisplayMode::Pipeline);
 
+  //===--------------------------------------------------------------------===//
+  // Pass Memory Report
+
+  /// Add an instrumentation to report, for each pass, the changes of the
+  /// memory allocated by malloc, of the memory of the uniqued attributes and
+  /// types and of the builtin locations among them, of the data of the builtin
+  /// resource blobs, and of the number of operations. The changes are summed
+  /// over the runs of each pass, and reported to `os` when the pass manager is
+  /// destroyed. With multi-threading enabled, the process-wide changes include
+  /// those of the passes running concurrently.
+  void enableMemoryReport(raw_ostream &os = llvm::errs());
+
 private:
   /// Dump the statistics of the passes within this pass manager.
   void dumpStatistics();
 
+  /// Check that the pass manager can run on the given operation, and prepare
+  /// the context and the pipeline for execution.
+  LogicalResult initializeForRun(Operation *op);
+
   /// Run the pass manager with crash recovery enabled.
   LogicalResult runWithCrashRecovery(Operation *op, AnalysisManager am);
 
   /// Run the passes of the pass manager, and return the result.
   LogicalResult runPasses(Operation *op, AnalysisManager am);
 
+  /// Run the nested pipelines of the pass manager on each operation nested
+  /// within `op`, see `runStreaming`.
+  LogicalResult
+  runStreamingPasses(Operation *op, AnalysisManager am,
+                     function_ref<LogicalResult(Operation *)> prepare,
+                     function_ref<LogicalResult(Operation *)> release);
+
   /// Context this PassManager was initialized with.
   MLIRContext *context;
 
@@ -439,6 +552,9 @@ private:
   /// generate reproducers.
   std::unique_ptr<detail::PassCrashReproducerGenerator> crashReproGenerator;
 
+  /// An optional cache for the results of the nested pipelines.
+  std::shared_ptr<PassPipelineCache> pipelineCache;
+
   /// A hash key used to detect when reinitialization is necessary.
   llvm::hash_code initializationKey =
       DenseMapInfo<llvm::hash_code>::getTombstoneKey();
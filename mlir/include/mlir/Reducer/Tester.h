@@ -17,10 +17,12 @@
 #ifndef MLIR_REDUCER_TESTER_H
 #define MLIR_REDUCER_TESTER_H
 
+#include <mutex>
 #include <vector>
 
 #include "mlir/IR/BuiltinOps.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Program.h"
@@ -29,7 +31,8 @@ namespace mlir {
 
 /// This class is used to keep track of the testing environment of the tool. It
 /// contains a method to run the interestingness testing script on a MLIR test
-/// case file.
+/// case file. The results of the script are cached by the IR of the tested
+/// modules, and the modules may be tested from several threads.
 class Tester {
 public:
   enum class Interestingness {
@@ -42,7 +45,7 @@ public:
 
   /// Runs the interestingness testing script on a MLIR test case file. Returns
   /// true if the interesting behavior is present in the test case or false
-  /// otherwise.
+  /// otherwise. The script is only run once for identical modules.
   std::pair<Interestingness, size_t> isInteresting(ModuleOp module) const;
 
   /// Return whether the file in the given path is interesting.
@@ -51,6 +54,10 @@ public:
 private:
   StringRef testScript;
   ArrayRef<std::string> testScriptArgs;
+
+  /// The interestingness of the tested modules, keyed by their IR.
+  mutable llvm::StringMap<Interestingness> resultCache;
+  mutable std::mutex resultCacheMutex;
 };
 
 } // namespace mlir
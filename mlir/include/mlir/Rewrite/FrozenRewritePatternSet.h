@@ -28,6 +28,8 @@ public:
   /// A map of operation specific native patterns.
   using OpSpecificNativePatternListT =
       DenseMap<OperationName, std::vector<RewritePattern *>>;
+  /// A list of native patterns, stable sorted by decreasing benefit.
+  using SortedNativePatternListT = std::vector<const RewritePattern *>;
 
   FrozenRewritePatternSet();
   FrozenRewritePatternSet(FrozenRewritePatternSet &&patterns) = default;
@@ -64,6 +66,18 @@ public:
     return llvm::make_pointee_range(nativeList);
   }
 
+  /// Return the native patterns that may match an operation named `opName`,
+  /// i.e. its op specific patterns followed by the "match any" patterns of the
+  /// same benefit, stable sorted by decreasing static benefit. Patterns that
+  /// are impossible to match are not included.
+  ArrayRef<const RewritePattern *>
+  getSortedNativePatterns(OperationName opName) const {
+    auto it = impl->sortedNativePatternMap.find(opName);
+    if (it != impl->sortedNativePatternMap.end())
+      return it->second;
+    return impl->sortedAnyOpPatterns;
+  }
+
   /// Return the compiled PDL bytecode held by this list. Returns null if
   /// there are no PDL patterns within the list.
   const detail::PDLByteCode *getPDLByteCode() const {
@@ -85,6 +99,16 @@ private:
     /// operation.
     NativePatternListT nativeAnyOpPatterns;
 
+    /// The candidate native patterns of each operation that has op specific
+    /// patterns, sorted by static benefit. This is computed once when freezing
+    /// so that applicators using the static benefits don't need to sort the
+    /// patterns of every operation again.
+    DenseMap<OperationName, SortedNativePatternListT> sortedNativePatternMap;
+
+    /// The "match any" native patterns, sorted by static benefit. These are the
+    /// candidates of operations without op specific patterns.
+    SortedNativePatternListT sortedAnyOpPatterns;
+
     /// The bytecode containing the compiled PDL patterns.
     std::unique_ptr<detail::PDLByteCode> pdlByteCode;
   };
@@ -17,6 +17,9 @@
 #include "mlir/Rewrite/FrozenRewritePatternSet.h"
 
 #include "mlir/IR/Action.h"
+#include "llvm/ADT/StringMap.h"
+#include <chrono>
+#include <mutex>
 
 namespace mlir {
 class PatternRewriter;
@@ -44,6 +47,47 @@ private:
   const Pattern &pattern;
 };
 
+/// This class collects profiling information about the application of patterns
+/// and folders: how often each of them was attempted, how often it succeeded
+/// and how much time was spent in it. Patterns are keyed by their debug name,
+/// folders by the name of the folded operation. A single profile may be shared
+/// by several applicators running on different threads.
+class PatternProfile {
+public:
+  using Duration = std::chrono::nanoseconds;
+
+  /// The information recorded for a single pattern or folder.
+  struct Entry {
+    uint64_t numAttempts = 0;
+    uint64_t numSuccesses = 0;
+    Duration time = Duration::zero();
+  };
+
+  /// Record an attempt to apply `pattern` that took `time`.
+  void recordPatternApplication(const Pattern &pattern, bool succeeded,
+                                Duration time);
+
+  /// Record an attempt to fold an operation named `name` that took `time`.
+  void recordFold(OperationName name, bool succeeded, Duration time);
+
+  /// Print the recorded information, sorted by decreasing time, to `os`.
+  void print(raw_ostream &os) const;
+
+  /// Clear all of the recorded information.
+  void clear();
+
+private:
+  /// Record an attempt in the given set of entries.
+  void record(llvm::StringMap<Entry> &entries, StringRef name, bool succeeded,
+              Duration time);
+
+  /// The recorded information for patterns and folders.
+  llvm::StringMap<Entry> patterns, folds;
+
+  /// A mutex used to guard the recorded information.
+  mutable std::mutex mutex;
+};
+
 /// This class manages the application of a group of rewrite patterns, with a
 /// user-provided cost model.
 class PatternApplicator {
@@ -76,14 +120,18 @@ public:
   void applyCostModel(CostModel model);
 
   /// Apply the default cost model that solely uses the pattern's static
-  /// benefit.
-  void applyDefaultCostModel() {
-    applyCostModel([](const Pattern &pattern) { return pattern.getBenefit(); });
-  }
+  /// benefit. This uses the candidate patterns resolved for each operation when
+  /// the pattern list was frozen, and is much cheaper than an equivalent call
+  /// to `applyCostModel`.
+  void applyDefaultCostModel();
 
   /// Walk all of the patterns within the applicator.
   void walkAllPatterns(function_ref<void(const Pattern &)> walk);
 
+  /// Record the application of patterns into the given profile, or stop
+  /// profiling if `profile` is null.
+  void setProfile(PatternProfile *newProfile) { profile = newProfile; }
+
 private:
   /// The list that owns the patterns used within this applicator.
   const FrozenRewritePatternSet &frozenPatternList;
@@ -94,6 +142,11 @@ private:
   SmallVector<const RewritePattern *, 1> anyOpPatterns;
   /// The mutable state used during execution of the PDL bytecode.
   std::unique_ptr<detail::PDLByteCodeMutableState> mutableByteCodeState;
+  /// If set, the native patterns are taken from the sorted lists of the frozen
+  /// pattern list instead of `patterns` and `anyOpPatterns`.
+  bool useSortedNativePatterns = false;
+  /// An optional profile that the application of patterns is recorded into.
+  PatternProfile *profile = nullptr;
 };
 
 } // namespace mlir
@@ -14,6 +14,7 @@
 #define MLIR_SUPPORT_FILEUTILITIES_H_
 
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace llvm {
@@ -37,6 +38,18 @@ std::unique_ptr<llvm::MemoryBuffer>
 openInputFile(llvm::StringRef inputFilename, llvm::Align alignment,
               std::string *errorMessage = nullptr);
 
+/// Open the file specified by its name for reading, preferring to memory map
+/// its contents. Unlike `openInputFile`, the returned buffer is not guaranteed
+/// to be null terminated, which allows files of any size to be mapped. This is
+/// suitable for binary formats such as MLIR bytecode, but not for the textual
+/// parser. If `alignment` is provided, it is only used when the file cannot be
+/// mapped (mapped files are page aligned). Write the error message to
+/// `errorMessage` if errors occur and `errorMessage` is not nullptr.
+std::unique_ptr<llvm::MemoryBuffer>
+openInputFileForMapping(llvm::StringRef inputFilename,
+                        std::optional<llvm::Align> alignment = std::nullopt,
+                        std::string *errorMessage = nullptr);
+
 /// Open the file specified by its name for writing. Write the error message to
 /// `errorMessage` if errors occur and `errorMessage` is not nullptr.
 std::unique_ptr<llvm::ToolOutputFile>
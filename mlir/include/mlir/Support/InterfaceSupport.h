@@ -178,6 +178,8 @@ public:
     for (auto &it : interfaces)
       free(it.second);
     interfaces = std::move(rhs.interfaces);
+    lookupKeys = std::move(rhs.lookupKeys);
+    lookupConcepts = std::move(rhs.lookupConcepts);
     return *this;
   }
   ~InterfaceMap() {
@@ -250,18 +252,44 @@ private:
     return lhs.getAsOpaquePointer() < rhs.getAsOpaquePointer();
   }
 
+  /// Returns the bucket of the lookup table to start probing from for the
+  /// given interface id.
+  static unsigned getBucket(const void *key, unsigned numBuckets) {
+    auto value = reinterpret_cast<uintptr_t>(key);
+    return (unsigned(value >> 4) ^ unsigned(value >> 9)) & (numBuckets - 1);
+  }
+
+  /// Rebuild the lookup table from the registered interfaces.
+  void rebuildLookupTable();
+
   /// Returns an instance of the concept object for the given interface id if it
   /// was registered to this map, null otherwise.
   void *lookup(TypeID id) const {
-    const auto *it =
-        llvm::lower_bound(interfaces, id, [](const auto &it, TypeID id) {
-          return compare(it.first, id);
-        });
-    return (it != interfaces.end() && it->first == id) ? it->second : nullptr;
+    // The lookup table is at most half full, so the probing always reaches
+    // either the key or an empty bucket.
+    const void *key = id.getAsOpaquePointer();
+    unsigned numBuckets = lookupKeys.size();
+    if (numBuckets == 0)
+      return nullptr;
+    for (unsigned bucket = getBucket(key, numBuckets);;
+         bucket = (bucket + 1) & (numBuckets - 1)) {
+      const void *bucketKey = lookupKeys[bucket];
+      if (bucketKey == key)
+        return lookupConcepts[bucket];
+      if (!bucketKey)
+        return nullptr;
+    }
   }
 
   /// A list of interface instances, sorted by TypeID.
   SmallVector<std::pair<TypeID, void *>> interfaces;
+
+  /// An open addressing hash table of the interface instances, with a power of
+  /// two number of buckets, built when the interfaces are registered. The keys
+  /// are kept apart from the concepts, so that the probing of the common maps
+  /// with a few interfaces only touches a single cache line.
+  SmallVector<const void *, 0> lookupKeys;
+  SmallVector<void *, 0> lookupConcepts;
 };
 
 template <typename ConcreteType, typename ValueT, typename Traits,
@@ -131,6 +131,9 @@ public:
       return allocator.identifyObject(ptr).has_value();
     }
 
+    /// Return the number of bytes allocated by this allocator.
+    size_t getBytesAllocated() const { return allocator.getBytesAllocated(); }
+
   private:
     /// The raw allocator for type storage objects.
     llvm::BumpPtrAllocator allocator;
@@ -142,6 +145,16 @@ public:
   /// Set the flag specifying if multi-threading is disabled within the uniquer.
   void disableMultithreading(bool disable = true);
 
+  /// Return the number of bytes allocated for the storage instances of this
+  /// uniquer and the data they own. The instances are never destroyed before
+  /// the uniquer, so this only grows over the lifetime of the uniquer.
+  size_t getBytesAllocated();
+
+  /// Return the number of bytes allocated for the instances of the parametric
+  /// storage class registered with `id` and the data they own, or 0 if no
+  /// such class is registered.
+  size_t getBytesAllocated(TypeID id);
+
   /// Register a new parametric storage class, this is necessary to create
   /// instances of this class type. `id` is the type identifier that will be
   /// used to identify this type when creating instances of it via 'get'.
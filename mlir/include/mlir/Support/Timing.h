@@ -349,6 +349,11 @@ public:
     /// In this mode the results are displayed in a tree view, with child timers
     /// nested under their parents.
     Tree,
+
+    /// In this mode each execution of a timer is recorded, and the results are
+    /// displayed as a timeline in the Chrome Trace Event JSON format, with one
+    /// track per thread. This can be loaded in `chrome://tracing` or Perfetto.
+    Trace,
   };
 
   DefaultTimingManager();
@@ -19,6 +19,7 @@
 
 namespace llvm {
 class MemoryBuffer;
+class ThreadPool;
 } // namespace llvm
 
 namespace mlir {
@@ -41,6 +42,21 @@ splitAndProcessBuffer(std::unique_ptr<llvm::MemoryBuffer> originalBuffer,
                       ChunkBufferHandler processChunkBuffer, raw_ostream &os,
                       bool enableSplitting = true,
                       bool insertMarkerInOutput = false);
+
+using ParallelChunkBufferHandler = function_ref<LogicalResult(
+    std::unique_ptr<llvm::MemoryBuffer> chunkBuffer, raw_ostream &os,
+    raw_ostream &diagOS)>;
+
+/// Splits the specified buffer on a marker (`// -----`) as
+/// `splitAndProcessBuffer` does, but processes the chunks concurrently on
+/// `threadPool`. Each chunk writes its output to `os` and its diagnostics to
+/// `diagOS`, which are buffered and written to `os` and `llvm::errs()` in the
+/// order of the chunks once they are all processed. `processChunkBuffer` must
+/// be safe to call from multiple threads at once.
+LogicalResult splitAndProcessBufferInParallel(
+    std::unique_ptr<llvm::MemoryBuffer> originalBuffer,
+    ParallelChunkBufferHandler processChunkBuffer, raw_ostream &os,
+    llvm::ThreadPool &threadPool, bool insertMarkerInOutput = false);
 } // namespace mlir
 
 #endif // MLIR_SUPPORT_TOOLUTILITIES_H
@@ -27,6 +27,18 @@ class Operation;
 std::unique_ptr<llvm::Module>
 translateModuleToLLVMIR(Operation *module, llvm::LLVMContext &llvmContext,
                         llvm::StringRef name = "LLVMDialectModule");
+
+/// Translate operation that satisfies LLVM dialect module requirements into an
+/// LLVM IR module living in the given context, translating the function
+/// definitions in parallel over up to `numShards` modules that are then linked
+/// together. The definitions that reference symbols local to the module, or
+/// that are not translated independently of the rest of the module, stay in
+/// the first shard.
+std::unique_ptr<llvm::Module>
+translateModuleToLLVMIRInParallel(Operation *module,
+                                  llvm::LLVMContext &llvmContext,
+                                  unsigned numShards,
+                                  llvm::StringRef name = "LLVMDialectModule");
 } // namespace mlir
 
 #endif // MLIR_TARGET_LLVMIR_EXPORT_H
@@ -35,11 +35,18 @@ class ModuleOp;
 /// implementation of the LLVMImportDialectInterface. It returns nullptr if the
 /// translation fails and reports errors using the error handler registered with
 /// the MLIR context. The `emitExpensiveWarnings` option controls if expensive
-/// but uncritical diagnostics should be emitted.
+/// but uncritical diagnostics should be emitted. The `importDebugInfo` and
+/// `importLoopAnnotations` options control if debug information and loop
+/// annotations are imported, or dropped to speed up the import. The
+/// `importFunctionsInParallel` option imports the function bodies concurrently
+/// if multithreading is enabled in the context.
 OwningOpRef<ModuleOp>
 translateLLVMIRToModule(std::unique_ptr<llvm::Module> llvmModule,
                         MLIRContext *context,
-                        bool emitExpensiveWarnings = true);
+                        bool emitExpensiveWarnings = true,
+                        bool importDebugInfo = true,
+                        bool importLoopAnnotations = true,
+                        bool importFunctionsInParallel = false);
 
 /// Translate the given LLVM data layout into an MLIR equivalent using the DLTI
 /// dialect.
@@ -20,6 +20,8 @@
 #include "mlir/Target/LLVMIR/LLVMImportInterface.h"
 #include "mlir/Target/LLVMIR/TypeFromLLVM.h"
 
+#include <mutex>
+
 namespace llvm {
 class BasicBlock;
 class CallBase;
@@ -46,7 +48,8 @@ class LoopAnnotationImporter;
 class ModuleImport {
 public:
   ModuleImport(ModuleOp mlirModule, std::unique_ptr<llvm::Module> llvmModule,
-               bool emitExpensiveWarnings);
+               bool emitExpensiveWarnings, bool importDebugInfo = true,
+               bool importLoopAnnotations = true);
 
   /// Calls the LLVMImportInterface initialization that queries the registered
   /// dialect interfaces for the supported LLVM IR intrinsics and metadata kinds
@@ -57,6 +60,10 @@ public:
   /// Converts all functions of the LLVM module to MLIR functions.
   LogicalResult convertFunctions();
 
+  /// Converts all functions of the LLVM module to MLIR functions, importing
+  /// the function bodies concurrently on the thread pool of the context.
+  LogicalResult convertFunctionsInParallel();
+
   /// Converts all comdat selectors of the LLVM module to MLIR comdat
   /// operations.
   LogicalResult convertComdats();
@@ -167,6 +174,14 @@ public:
   /// Imports `func` into the current module.
   LogicalResult processFunction(llvm::Function *func);
 
+  /// Creates the function operation of `func`, with its attributes and
+  /// metadata, at the end of the current module. Returns null if `func` is an
+  /// intrinsic that converts to an operation rather than a function.
+  LLVMFuncOp createFunctionOp(llvm::Function *func);
+
+  /// Imports the body of the function definition `func` into `funcOp`.
+  LogicalResult processFunctionBody(llvm::Function *func, LLVMFuncOp funcOp);
+
   /// Converts function attributes of LLVM Function `func` into LLVM dialect
   /// attributes of LLVMFuncOp `funcOp`.
   void processFunctionAttributes(llvm::Function *func, LLVMFuncOp funcOp);
@@ -209,6 +224,11 @@ public:
   lookupAliasScopeAttrs(const llvm::MDNode *node) const;
 
 private:
+  /// Creates an importer of function bodies that shares the module-level
+  /// mappings of `parent`, to import functions concurrently with other
+  /// importers. `constantMutex` serializes the conversion of constants.
+  ModuleImport(const ModuleImport &parent, std::mutex &constantMutex);
+
   /// Clears the block and value mapping before processing a new region.
   void clearBlockAndValueMapping() {
     valueMapping.clear();
@@ -369,6 +389,15 @@ private:
   /// emitted. Avoids generating warnings for unhandled debug intrinsics and
   /// metadata that otherwise dominate the translation time for large inputs.
   bool emitExpensiveWarnings;
+  /// Options to control if the debug information and the loop annotations
+  /// are imported. Dropping them speeds up the import of large modules whose
+  /// users do not need them.
+  bool importDebugInfo;
+  bool importLoopAnnotations;
+  /// The mutex serializing the conversion of constants when functions are
+  /// imported concurrently, since converting an LLVM constant may create other
+  /// constants in the LLVM context. Null if importing sequentially.
+  std::mutex *constantMutex = nullptr;
 };
 
 } // namespace LLVM
@@ -17,6 +17,7 @@
 #include "mlir/Support/LLVM.h"
 
 namespace mlir {
+struct LogicalResult;
 class MLIRContext;
 
 namespace spirv {
@@ -29,6 +30,14 @@ class ModuleOp;
 OwningOpRef<spirv::ModuleOp> deserialize(ArrayRef<uint32_t> binary,
                                          MLIRContext *context);
 
+/// Deserializes each of the given SPIR-V `binaries` into the module at the
+/// same position in `modules`, in parallel if multithreading is enabled in
+/// `context`. The binaries are not copied. Returns failure if any binary fails
+/// to deserialize, whose module is then null.
+LogicalResult
+deserialize(ArrayRef<ArrayRef<uint32_t>> binaries, MLIRContext *context,
+            SmallVectorImpl<OwningOpRef<spirv::ModuleOp>> &modules);
+
 } // namespace spirv
 } // namespace mlir
 
@@ -14,6 +14,7 @@
 #define MLIR_TARGET_SPIRV_SERIALIZATION_H
 
 #include "mlir/Support/LLVM.h"
+#include "llvm/ADT/SmallVector.h"
 
 namespace mlir {
 struct LogicalResult;
@@ -35,6 +36,14 @@ struct SerializationOptions {
 LogicalResult serialize(ModuleOp module, SmallVectorImpl<uint32_t> &binary,
                         const SerializationOptions &options = {});
 
+/// Serializes each of the given SPIR-V `modules` and writes to the binary at
+/// the same position in `binaries`. The modules are serialized in parallel if
+/// multithreading is enabled in their context. Returns failure if any module
+/// fails to serialize.
+LogicalResult serialize(ArrayRef<ModuleOp> modules,
+                        SmallVectorImpl<SmallVector<uint32_t, 0>> &binaries,
+                        const SerializationOptions &options = {});
+
 } // namespace spirv
 } // namespace mlir
 
@@ -141,6 +141,27 @@ public:
   }
   bool shouldSplitInputFile() const { return splitInputFileFlag; }
 
+  /// Set whether to process the chunks of a split input file concurrently,
+  /// each in its own context. The output and the diagnostics of the chunks are
+  /// emitted in the order of the chunks.
+  MlirOptMainConfig &splitInputFileInParallel(bool parallel = true) {
+    splitInputFileInParallelFlag = parallel;
+    return *this;
+  }
+  bool shouldSplitInputFileInParallel() const {
+    return splitInputFileInParallelFlag;
+  }
+
+  /// Set whether to run the pass pipeline on one lazily loaded operation at a
+  /// time. This requires a bytecode input and a pipeline made of nested pass
+  /// managers: the operations nested within the top-level operation are only
+  /// materialized just before their nested pipelines run.
+  MlirOptMainConfig &streamLazyOps(bool stream = true) {
+    streamLazyOpsFlag = stream;
+    return *this;
+  }
+  bool shouldStreamLazyOps() const { return streamLazyOpsFlag; }
+
   /// Disable implicit addition of a top-level module op during parsing.
   MlirOptMainConfig &useExplicitModule(bool useExplicitModule) {
     useExplicitModuleFlag = useExplicitModule;
@@ -210,6 +231,12 @@ protected:
   /// process each chunk independently.
   bool splitInputFileFlag = false;
 
+  /// Process the chunks of a split input file concurrently.
+  bool splitInputFileInParallelFlag = false;
+
+  /// Run the pass pipeline on one lazily loaded operation at a time.
+  bool streamLazyOpsFlag = false;
+
   /// Use an explicit top-level module op during parsing.
   bool useExplicitModuleFlag = false;
 
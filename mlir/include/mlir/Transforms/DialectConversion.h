@@ -14,8 +14,12 @@
 #define MLIR_TRANSFORMS_DIALECTCONVERSION_H_
 
 #include "mlir/Rewrite/FrozenRewritePatternSet.h"
+#include "mlir/Support/ThreadLocalCache.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/StringMap.h"
+#include "llvm/Support/RWMutex.h"
+#include <atomic>
 #include <type_traits>
 
 namespace mlir {
@@ -37,6 +41,25 @@ class Value;
 /// registered using addConversion and addMaterialization, respectively.
 class TypeConverter {
 public:
+  TypeConverter() = default;
+  /// Copy the registered callbacks of `other`, but not its caches.
+  TypeConverter(const TypeConverter &other)
+      : conversions(other.conversions),
+        argumentMaterializations(other.argumentMaterializations),
+        sourceMaterializations(other.sourceMaterializations),
+        targetMaterializations(other.targetMaterializations),
+        typeAttributeConversions(other.typeAttributeConversions) {}
+  TypeConverter &operator=(const TypeConverter &other) {
+    conversions = other.conversions;
+    argumentMaterializations = other.argumentMaterializations;
+    sourceMaterializations = other.sourceMaterializations;
+    targetMaterializations = other.targetMaterializations;
+    typeAttributeConversions = other.typeAttributeConversions;
+    cachedDirectConversions.clear();
+    cachedMultiConversions.clear();
+    return *this;
+  }
+
   /// This class provides all of the information necessary to convert a type
   /// signature.
   class SignatureConversion {
@@ -213,6 +236,21 @@ public:
         wrapTypeAttributeConversion<T, A>(std::forward<FnT>(callback)));
   }
 
+  /// This struct contains statistics about the use of the conversion caches.
+  struct CacheStatistics {
+    /// The number of type conversions that were found in the caches.
+    uint64_t numHits = 0;
+    /// The number of type conversions that invoked the conversion callbacks.
+    uint64_t numMisses = 0;
+  };
+
+  /// Return the statistics about the use of the conversion caches since this
+  /// type converter was created.
+  CacheStatistics getCacheStatistics() const {
+    return {numCacheHits.load(std::memory_order_relaxed),
+            numCacheMisses.load(std::memory_order_relaxed)};
+  }
+
   /// Convert the given type. This function should return failure if no valid
   /// conversion exists, success otherwise. If the new set of types is empty,
   /// the type is removed and any usages of the existing value are expected to
@@ -429,10 +467,20 @@ private:
   DenseMap<Type, Type> cachedDirectConversions;
   /// This cache stores the successful 1->N conversions, where N != 1.
   DenseMap<Type, SmallVector<Type, 2>> cachedMultiConversions;
+  /// A mutex guarding the caches above, which allows for a type converter to
+  /// be shared by conversions running on different threads. Once the common
+  /// types have been converted, the caches are mostly read, which only
+  /// requires a shared lock.
+  llvm::sys::SmartRWMutex<true> cacheMutex;
+
+  /// The number of conversions that were found, or not found, in the caches.
+  std::atomic<uint64_t> numCacheHits = 0;
+  std::atomic<uint64_t> numCacheMisses = 0;
 
   /// Stores the types that are being converted in the case when convertType
-  /// is being called recursively to convert nested types.
-  SmallVector<Type, 2> conversionCallStack;
+  /// is being called recursively to convert nested types. Each thread has its
+  /// own call stack.
+  ThreadLocalCache<SmallVector<Type, 2>> conversionCallStack;
 };
 
 //===----------------------------------------------------------------------===//
@@ -971,6 +1019,31 @@ public:
   /// or dynamic legality callbacks returned None.
   bool isIllegal(Operation *op) const;
 
+  /// Mark the legality of the given operations as only depending on their name
+  /// and on the types of their operands and results, and not e.g. on their
+  /// attributes, regions or surrounding IR. This also applies to the callbacks
+  /// deciding whether they are recursively legal. The legality of these
+  /// operations is cached during a conversion, so that the dynamic legality
+  /// callbacks are only invoked once per type signature.
+  void markOpLegalityTypeBased(OperationName name) {
+    typeBasedLegalityOps.insert(name);
+  }
+  template <typename OpT>
+  void markOpLegalityTypeBased() {
+    markOpLegalityTypeBased(OperationName(OpT::getOperationName(), &ctx));
+  }
+  template <typename OpT, typename OpT2, typename... OpTs>
+  void markOpLegalityTypeBased() {
+    markOpLegalityTypeBased<OpT>();
+    markOpLegalityTypeBased<OpT2, OpTs...>();
+  }
+
+  /// Returns true if the legality of operations named `name` only depends on
+  /// their name and types, see `markOpLegalityTypeBased`.
+  bool isOpLegalityTypeBased(OperationName name) const {
+    return typeBasedLegalityOps.contains(name);
+  }
+
 private:
   /// Set the dynamic legality callback for the given operation.
   void setLegalityCallback(OperationName name,
@@ -1016,6 +1089,9 @@ private:
   /// An optional legality callback for unknown operations.
   DynamicLegalityCallbackFn unknownLegalityFn;
 
+  /// The set of operations whose legality only depends on their types.
+  DenseSet<OperationName> typeBasedLegalityOps;
+
   /// The current context this target applies to.
   MLIRContext &ctx;
 };
@@ -1059,6 +1135,31 @@ void registerConversionPDLFunctions(RewritePatternSet &patterns);
 /// ConversionPatternRewriter, to see what additional constraints are imposed on
 /// the use of the PatternRewriter.
 
+/// This class allows control over how a dialect conversion is performed.
+struct ConversionConfig {
+  /// If set to false, the conversion does not keep the information needed to
+  /// roll back the in-place modifications of operations. This is cheaper for
+  /// conversions where patterns never fail after modifying the IR, and whose
+  /// results can always be legalized. A conversion that would need to roll
+  /// back an in-place modification fails instead, and leaves the IR in a
+  /// state that must be discarded.
+  bool allowPatternRollback = true;
+
+  /// If set to true, the bodies of the ops isolated from above nested directly
+  /// in the converted ops, e.g. the functions of a module, are converted
+  /// concurrently before the remaining ops are converted serially. This is
+  /// only valid if:
+  ///   - the patterns applied to the ops nested in the isolated ops do not
+  ///     modify the IR outside of them, e.g. by inserting symbols;
+  ///   - the type converters used by the patterns are thread-safe, including
+  ///     their user-provided conversions and materializations;
+  ///   - the converted ops themselves are legal, otherwise the conversion runs
+  ///     serially.
+  /// On failure, the IR may be left partially converted even if the patterns
+  /// can be rolled back.
+  bool convertIsolatedOpsInParallel = false;
+};
+
 /// Apply a partial conversion on the given operations and all nested
 /// operations. This method converts as many operations to the target as
 /// possible, ignoring operations that failed to legalize. This method only
@@ -1075,6 +1176,16 @@ LogicalResult
 applyPartialConversion(Operation *op, ConversionTarget &target,
                        const FrozenRewritePatternSet &patterns,
                        DenseSet<Operation *> *unconvertedOps = nullptr);
+LogicalResult
+applyPartialConversion(ArrayRef<Operation *> ops, ConversionTarget &target,
+                       const FrozenRewritePatternSet &patterns,
+                       const ConversionConfig &config,
+                       DenseSet<Operation *> *unconvertedOps = nullptr);
+LogicalResult
+applyPartialConversion(Operation *op, ConversionTarget &target,
+                       const FrozenRewritePatternSet &patterns,
+                       const ConversionConfig &config,
+                       DenseSet<Operation *> *unconvertedOps = nullptr);
 
 /// Apply a complete conversion on the given operations, and all nested
 /// operations. This method returns failure if the conversion of any operation
@@ -1085,6 +1196,13 @@ LogicalResult applyFullConversion(ArrayRef<Operation *> ops,
                                   const FrozenRewritePatternSet &patterns);
 LogicalResult applyFullConversion(Operation *op, ConversionTarget &target,
                                   const FrozenRewritePatternSet &patterns);
+LogicalResult applyFullConversion(ArrayRef<Operation *> ops,
+                                  ConversionTarget &target,
+                                  const FrozenRewritePatternSet &patterns,
+                                  const ConversionConfig &config);
+LogicalResult applyFullConversion(Operation *op, ConversionTarget &target,
+                                  const FrozenRewritePatternSet &patterns,
+                                  const ConversionConfig &config);
 
 /// Apply an analysis conversion on the given operations, and all nested
 /// operations. This method analyzes which operations would be successfully
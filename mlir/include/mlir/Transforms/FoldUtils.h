@@ -89,19 +89,33 @@ private:
                                    SmallVectorImpl<Value> &results,
                                    ArrayRef<OpFoldResult> foldResults);
 
-  /// Try to get or create a new constant entry. On success this returns the
-  /// constant operation, nullptr otherwise.
-  Operation *tryGetOrCreateConstant(ConstantMap &uniquedConstants,
+  /// Try to get or create a new constant entry in `insertRegion`, whose
+  /// constants are `uniquedConstants`. On success this returns the constant
+  /// operation, nullptr otherwise.
+  Operation *tryGetOrCreateConstant(Region *insertRegion,
+                                    ConstantMap &uniquedConstants,
                                     Dialect *dialect, Attribute value,
                                     Type type, Location loc);
 
+  /// The bookkeeping of a constant owned by this folder. The key of the
+  /// constant is kept such that removing it neither folds the constant again
+  /// nor walks up the parents of the constant to find its insertion region.
+  struct ConstantInfo {
+    /// The region the constant was uniqued in.
+    Region *insertRegion;
+    /// The value the constant was uniqued with.
+    Attribute value;
+    /// The dialects the constant is referenced by, given that many dialects
+    /// may generate the same constant.
+    SmallVector<Dialect *, 2> dialects;
+  };
+
   /// A mapping between an insertion region and the constants that have been
   /// created within it.
   DenseMap<Region *, ConstantMap> foldScopes;
 
-  /// This map tracks all of the dialects that an operation is referenced by;
-  /// given that many dialects may generate the same constant.
-  DenseMap<Operation *, SmallVector<Dialect *, 2>> referencedDialects;
+  /// The constants owned by this folder.
+  DenseMap<Operation *, ConstantInfo> ownedConstants;
 
   /// A collection of dialect folder interfaces.
   DialectInterfaceCollection<DialectFoldInterface> interfaces;
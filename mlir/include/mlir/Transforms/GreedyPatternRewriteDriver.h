@@ -17,6 +17,7 @@
 #include "mlir/Rewrite/FrozenRewritePatternSet.h"
 
 namespace mlir {
+class PatternProfile;
 
 /// This enum controls which ops are put on the worklist during a greedy
 /// pattern rewrite.
@@ -79,6 +80,31 @@ public:
 
   /// An optional listener that should be notified about IR modifications.
   RewriterBase::Listener *listener = nullptr;
+
+  /// When set to true and multi-threading is enabled on the context, the
+  /// regions of ops that are isolated from above and nested within the
+  /// simplified region are simplified concurrently, each by its own driver.
+  /// The remaining ops of the simplified region are processed afterwards,
+  /// without rescanning the nested isolated regions. Setting this flag
+  /// declares that the patterns, the folders of the ops and the listener (if
+  /// any) are thread-safe.
+  ///
+  /// Note: Only applicable when simplifying entire regions.
+  bool processIsolatedRegionsInParallel = false;
+
+  /// When set to true, the iterations after the first one only revisit the ops
+  /// that were inserted, modified or enqueued by the previous iteration,
+  /// instead of all the ops of the region. The region is still fully rescanned
+  /// after its simplification, which may modify ops without notifying the
+  /// driver. This is a heuristic: patterns that inspect ops other than their
+  /// root and its neighbours may miss some opportunities.
+  ///
+  /// Note: Only applicable when simplifying entire regions.
+  bool revisitChangedOpsOnly = false;
+
+  /// An optional profile that the attempts to apply patterns and to fold ops
+  /// are recorded into.
+  PatternProfile *profile = nullptr;
 };
 
 //===----------------------------------------------------------------------===//
@@ -13,6 +13,7 @@
 
 namespace mlir {
 
+class AliasAnalysis;
 class LoopLikeOpInterface;
 class Operation;
 class Region;
@@ -70,6 +71,35 @@ size_t moveLoopInvariantCode(
 /// methods provided by the interface.
 size_t moveLoopInvariantCode(LoopLikeOpInterface loopLike);
 
+/// Move loop invariant code out of a loop-like op, including the reads of
+/// memory that no op of the loop may write. An op is considered as a read if
+/// all of its memory effects are reads of values, and `aliasAnalysis` is used
+/// to check that none of these values may alias the memory written, allocated
+/// or freed within the loop. Ops with unknown effects are considered as
+/// writing all memory. As reads are not speculatable in general, e.g. a load
+/// may be out of bounds when the loop does not execute, they are only hoisted
+/// out of loops known to execute at least one iteration.
+///
+/// Example:
+///
+/// ```mlir
+/// scf.for %i = %c0 to %c8 step %c1 {
+///   %v = memref.load %a[%c0] : memref<8xf32>
+///   memref.store %v, %b[%i] : memref<8xf32>
+/// }
+/// ```
+///
+/// After LICM, if `%a` and `%b` do not alias:
+///
+/// ```mlir
+/// %v = memref.load %a[%c0] : memref<8xf32>
+/// scf.for %i = %c0 to %c8 step %c1 {
+///   memref.store %v, %b[%i] : memref<8xf32>
+/// }
+/// ```
+size_t moveLoopInvariantCode(LoopLikeOpInterface loopLike,
+                             AliasAnalysis &aliasAnalysis);
+
 } // end namespace mlir
 
 #endif // MLIR_TRANSFORMS_LOOPINVARIANTCODEMOTIONUTILS_H
@@ -44,10 +44,12 @@ private:
 };
 
 /// Attempts to promote the memory slots of the provided allocators. Succeeds if
-/// at least one memory slot was promoted.
+/// at least one memory slot was promoted. The dominance information is shared
+/// by the promotion of all the slots, and remains valid after promotion as the
+/// CFG is not modified.
 LogicalResult
 tryToPromoteMemorySlots(ArrayRef<PromotableAllocationOpInterface> allocators,
-                        RewriterBase &rewriter,
+                        RewriterBase &rewriter, DominanceInfo &dominance,
                         Mem2RegStatistics statistics = {});
 
 } // namespace mlir
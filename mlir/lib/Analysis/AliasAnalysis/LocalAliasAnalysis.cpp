@@ -245,6 +245,26 @@ getAllocEffectFor(Value value,
   return success();
 }
 
+/// The name of the argument attribute marking the function arguments that do
+/// not alias the memory accessed through the other arguments.
+static constexpr StringLiteral kNoAliasAttrName = "llvm.noalias";
+
+/// Returns the function of which `value` is an argument, or null if `value` is
+/// not a function argument.
+static FunctionOpInterface getArgumentOwner(Value value) {
+  auto arg = dyn_cast<BlockArgument>(value);
+  if (!arg || !arg.getOwner()->isEntryBlock())
+    return nullptr;
+  return dyn_cast<FunctionOpInterface>(arg.getOwner()->getParentOp());
+}
+
+/// Returns true if `value` is a function argument with the `llvm.noalias`
+/// attribute.
+static bool isNoAliasArgument(FunctionOpInterface function, Value value) {
+  return function.getArgAttr(cast<BlockArgument>(value).getArgNumber(),
+                             kNoAliasAttrName) != nullptr;
+}
+
 /// Given the two values, return their aliasing behavior.
 AliasResult LocalAliasAnalysis::aliasImpl(Value lhs, Value rhs) {
   if (lhs == rhs)
@@ -281,9 +301,19 @@ AliasResult LocalAliasAnalysis::aliasImpl(Value lhs, Value rhs) {
   bool lhsHasAlloc = succeeded(getAllocEffectFor(lhs, lhsAlloc, lhsAllocScope));
   bool rhsHasAlloc = succeeded(getAllocEffectFor(rhs, rhsAlloc, rhsAllocScope));
   if (lhsHasAlloc == rhsHasAlloc) {
-    // If both values have an allocation effect we know they don't alias, and if
-    // neither have an effect we can't make an assumptions.
-    return lhsHasAlloc ? AliasResult::NoAlias : AliasResult::MayAlias;
+    // If both values have an allocation effect we know they don't alias.
+    if (lhsHasAlloc)
+      return AliasResult::NoAlias;
+
+    // If neither have an effect, two different arguments of a function don't
+    // alias if one of them is marked as `noalias`. Otherwise we can't make any
+    // assumptions.
+    FunctionOpInterface lhsFunction = getArgumentOwner(lhs);
+    if (lhsFunction && lhsFunction == getArgumentOwner(rhs) &&
+        (isNoAliasArgument(lhsFunction, lhs) ||
+         isNoAliasArgument(lhsFunction, rhs)))
+      return AliasResult::NoAlias;
+    return AliasResult::MayAlias;
   }
 
   // When we reach this point we have one value with a known allocation effect,
@@ -7,6 +7,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "mlir/Analysis/DataFlowFramework.h"
+#include "mlir/IR/Threading.h"
 #include "llvm/Support/Debug.h"
 
 #define DEBUG_TYPE "dataflow"
@@ -75,6 +76,13 @@ Location ProgramPoint::getLoc() const {
 // DataFlowSolver
 //===----------------------------------------------------------------------===//
 
+DataFlowSolver::~DataFlowSolver() {
+  // The allocator releases the memory of the states without destroying them.
+  for (auto &statesIt : analysisStates)
+    for (auto &it : statesIt.second)
+      it.second->~AnalysisState();
+}
+
 LogicalResult DataFlowSolver::initializeAndRun(Operation *top) {
   // Initialize the analyses.
   for (DataFlowAnalysis &analysis : llvm::make_pointee_range(childAnalyses)) {
@@ -114,6 +122,34 @@ void DataFlowSolver::propagateIfChanged(AnalysisState *state,
   }
 }
 
+LogicalResult mlir::solveIsolatedRegionsInParallel(
+    Operation *top, function_ref<void(DataFlowSolver &)> loadAnalyses,
+    function_ref<LogicalResult(Operation *, DataFlowSolver &)>
+        processPartition) {
+  // The operations without regions contain no program point that the
+  // partitions may depend on, as the partitions are isolated from above.
+  SmallVector<Operation *> partitions;
+  bool isPartitioned = llvm::all_of(top->getRegions(), [&](Region &region) {
+    return llvm::all_of(region.getOps(), [&](Operation &op) {
+      if (op.getNumRegions() == 0)
+        return true;
+      partitions.push_back(&op);
+      return op.hasTrait<OpTrait::IsIsolatedFromAbove>();
+    });
+  });
+  if (!isPartitioned)
+    partitions.assign({top});
+
+  return failableParallelForEach(
+      top->getContext(), partitions, [&](Operation *partition) {
+        DataFlowSolver solver;
+        loadAnalyses(solver);
+        if (failed(solver.initializeAndRun(partition)))
+          return failure();
+        return processPartition(partition, solver);
+      });
+}
+
 //===----------------------------------------------------------------------===//
 // DataFlowAnalysis
 //===----------------------------------------------------------------------===//
@@ -15,6 +15,7 @@
 #include "mlir/IR/Operation.h"
 #include "mlir/IR/Region.h"
 #include "mlir/IR/Value.h"
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SetOperations.h"
 #include "llvm/ADT/SetVector.h"
@@ -23,6 +24,29 @@
 using namespace mlir;
 
 namespace {
+/// Numbers the values that are used in a block other than the one defining
+/// them. These are the only values the live-in and live-out sets can contain,
+/// such that the sets can be represented by dense bit vectors over them during
+/// the fixpoint iteration.
+struct ValueNumbering {
+  /// Numbers `value` if it is not numbered yet.
+  void insert(Value value) {
+    if (numbers.try_emplace(value, values.size()).second)
+      values.push_back(value);
+  }
+
+  /// Returns the number of `value`, if it is numbered.
+  std::optional<unsigned> lookup(Value value) const {
+    auto it = numbers.find(value);
+    if (it == numbers.end())
+      return std::nullopt;
+    return it->second;
+  }
+
+  DenseMap<Value, unsigned> numbers;
+  SmallVector<Value> values;
+};
+
 /// Builds and holds block information during the construction phase.
 struct BlockInfoBuilder {
   using ValueSetT = Liveness::ValueSetT;
@@ -76,21 +100,38 @@ struct BlockInfoBuilder {
     llvm::set_subtract(useValues, defValues);
   }
 
+  /// Initializes the bit vectors from the value sets, once all the values that
+  /// may be live across blocks are numbered. The value sets are released.
+  void initBitVectors(const ValueNumbering &numbering) {
+    unsigned numValues = numbering.values.size();
+    inBits.resize(numValues);
+    outBits.resize(numValues);
+    useBits.resize(numValues);
+    defBits.resize(numValues);
+    for (Value value : useValues)
+      useBits.set(*numbering.lookup(value));
+    for (Value value : outValues)
+      outBits.set(*numbering.lookup(value));
+    for (Value value : defValues)
+      if (std::optional<unsigned> number = numbering.lookup(value))
+        defBits.set(*number);
+    useValues.clear();
+    outValues.clear();
+    defValues.clear();
+  }
+
   /// Updates live-in information of the current block. To do so it uses the
   /// default liveness-computation formula: newIn = use union out \ def. The
   /// methods returns true, if the set has changed (newIn != in), false
   /// otherwise.
   bool updateLiveIn() {
-    ValueSetT newIn = useValues;
-    llvm::set_union(newIn, outValues);
-    llvm::set_subtract(newIn, defValues);
-
-    // It is sufficient to check the set sizes (instead of their contents) since
-    // the live-in set can only grow monotonically during all update operations.
-    if (newIn.size() == inValues.size())
+    llvm::BitVector newIn = useBits;
+    newIn |= outBits;
+    newIn.reset(defBits);
+    if (newIn == inBits)
       return false;
 
-    inValues = std::move(newIn);
+    inBits = std::move(newIn);
     return true;
   }
 
@@ -100,17 +141,14 @@ struct BlockInfoBuilder {
   void updateLiveOut(const DenseMap<Block *, BlockInfoBuilder> &builders) {
     for (Block *succ : block->getSuccessors()) {
       const BlockInfoBuilder &builder = builders.find(succ)->second;
-      llvm::set_union(outValues, builder.inValues);
+      outBits |= builder.inBits;
     }
   }
 
   /// The current block.
   Block *block{nullptr};
 
-  /// The set of all live in values.
-  ValueSetT inValues;
-
-  /// The set of all live out values.
+  /// The set of all live out values, before the fixpoint iteration.
   ValueSetT outValues;
 
   /// The set of all defined values.
@@ -118,21 +156,33 @@ struct BlockInfoBuilder {
 
   /// The set of all used values.
   ValueSetT useValues;
+
+  /// The bit vectors of the live in, live out, defined and used values, over
+  /// the numbered values.
+  llvm::BitVector inBits, outBits, defBits, useBits;
 };
 } // namespace
 
 /// Builds the internal liveness block mapping.
 static void buildBlockMapping(Operation *operation,
-                              DenseMap<Block *, BlockInfoBuilder> &builders) {
-  SetVector<Block *> toProcess;
-
+                              DenseMap<Block *, BlockInfoBuilder> &builders,
+                              ValueNumbering &numbering) {
+  SmallVector<Block *> blocks;
   operation->walk<WalkOrder::PreOrder>([&](Block *block) {
     BlockInfoBuilder &builder =
         builders.try_emplace(block, block).first->second;
+    blocks.push_back(block);
+    for (Value value : builder.useValues)
+      numbering.insert(value);
+  });
 
+  SetVector<Block *> toProcess;
+  for (Block *block : blocks) {
+    BlockInfoBuilder &builder = builders[block];
+    builder.initBitVectors(numbering);
     if (builder.updateLiveIn())
       toProcess.insert(block->pred_begin(), block->pred_end());
-  });
+  }
 
   // Propagate the in and out-value sets (fixpoint iteration).
   while (!toProcess.empty()) {
@@ -160,7 +210,8 @@ Liveness::Liveness(Operation *op) : operation(op) { build(); }
 void Liveness::build() {
   // Build internal block mapping.
   DenseMap<Block *, BlockInfoBuilder> builders;
-  buildBlockMapping(operation, builders);
+  ValueNumbering numbering;
+  buildBlockMapping(operation, builders, numbering);
 
   // Store internal block data.
   for (auto &entry : builders) {
@@ -168,8 +219,10 @@ void Liveness::build() {
     LivenessBlockInfo &info = blockMapping[entry.first];
 
     info.block = builder.block;
-    info.inValues = std::move(builder.inValues);
-    info.outValues = std::move(builder.outValues);
+    for (unsigned number : builder.inBits.set_bits())
+      info.inValues.insert(numbering.values[number]);
+    for (unsigned number : builder.outBits.set_bits())
+      info.outValues.insert(numbering.values[number]);
   }
 }
 
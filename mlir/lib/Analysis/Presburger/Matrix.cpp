@@ -201,7 +201,7 @@ void Matrix::addToRow(unsigned row, ArrayRef<MPInt> rowVec,
   if (scale == 0)
     return;
   for (unsigned col = 0; col < nColumns; ++col)
-    at(row, col) += scale * rowVec[col];
+    at(row, col).addProduct(scale, rowVec[col]);
 }
 
 void Matrix::addToColumn(unsigned sourceColumn, unsigned targetColumn,
@@ -209,7 +209,7 @@ void Matrix::addToColumn(unsigned sourceColumn, unsigned targetColumn,
   if (scale == 0)
     return;
   for (unsigned row = 0, e = getNumRows(); row < e; ++row)
-    at(row, targetColumn) += scale * at(row, sourceColumn);
+    at(row, targetColumn).addProduct(scale, at(row, sourceColumn));
 }
 
 void Matrix::negateColumn(unsigned column) {
@@ -222,6 +222,13 @@ void Matrix::negateRow(unsigned row) {
     at(row, column) = -at(row, column);
 }
 
+void Matrix::scaleRow(unsigned row, const MPInt &scale) {
+  if (scale == 1)
+    return;
+  for (unsigned column = 0, e = getNumColumns(); column < e; ++column)
+    at(row, column) *= scale;
+}
+
 MPInt Matrix::normalizeRow(unsigned row, unsigned cols) {
   return normalizeRange(getRow(row).slice(0, cols));
 }
@@ -955,15 +955,16 @@ void SimplexBase::pivot(unsigned pivotRow, unsigned pivotCol) {
       continue;
     if (tableau(row, pivotCol) == 0) // Nothing to do.
       continue;
-    tableau(row, 0) *= tableau(pivotRow, 0);
+    MPInt coeff = tableau(row, pivotCol);
+    tableau.scaleRow(row, tableau(pivotRow, 0));
     for (unsigned col = 1, numCols = getNumColumns(); col < numCols; ++col) {
-      if (col == pivotCol)
+      // The zero entries of the pivot row leave the scaled entries unchanged.
+      if (col == pivotCol || tableau(pivotRow, col) == 0)
         continue;
       // Add rather than subtract because the pivot row has been negated.
-      tableau(row, col) = tableau(row, col) * tableau(pivotRow, 0) +
-                          tableau(row, pivotCol) * tableau(pivotRow, col);
+      tableau(row, col).addProduct(coeff, tableau(pivotRow, col));
     }
-    tableau(row, pivotCol) *= tableau(pivotRow, pivotCol);
+    tableau(row, pivotCol) = coeff * tableau(pivotRow, pivotCol);
     tableau.normalizeRow(row);
   }
 }
@@ -13,6 +13,7 @@
 #include "mlir/Analysis/SliceAnalysis.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Operation.h"
+#include "mlir/IR/RegionKindInterface.h"
 #include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Support/LLVM.h"
 #include "llvm/ADT/SetVector.h"
@@ -24,9 +25,13 @@
 
 using namespace mlir;
 
+/// Returns the slice cached for the given op, which includes it, or null.
+using CachedSliceFn = function_ref<const SetVector<Operation *> *(Operation *)>;
+
 static void
 getForwardSliceImpl(Operation *op, SetVector<Operation *> *forwardSlice,
-                    SliceOptions::TransitiveFilter filter = nullptr) {
+                    SliceOptions::TransitiveFilter filter = nullptr,
+                    CachedSliceFn getCachedSlice = nullptr) {
   if (!op)
     return;
 
@@ -36,15 +41,25 @@ getForwardSliceImpl(Operation *op, SetVector<Operation *> *forwardSlice,
   if (filter && !filter(op))
     return;
 
+  // The cached slices are in topological order, the reverse of the postorder
+  // built here. The ops already in `forwardSlice` are skipped, as they are
+  // when traversing the uses.
+  if (getCachedSlice) {
+    if (const SetVector<Operation *> *cachedSlice = getCachedSlice(op)) {
+      forwardSlice->insert(cachedSlice->rbegin(), cachedSlice->rend());
+      return;
+    }
+  }
+
   for (Region &region : op->getRegions())
     for (Block &block : region)
       for (Operation &blockOp : block)
         if (forwardSlice->count(&blockOp) == 0)
-          getForwardSliceImpl(&blockOp, forwardSlice, filter);
+          getForwardSliceImpl(&blockOp, forwardSlice, filter, getCachedSlice);
   for (Value result : op->getResults()) {
     for (Operation *userOp : result.getUsers())
       if (forwardSlice->count(userOp) == 0)
-        getForwardSliceImpl(userOp, forwardSlice, filter);
+        getForwardSliceImpl(userOp, forwardSlice, filter, getCachedSlice);
   }
 
   forwardSlice->insert(op);
@@ -80,7 +95,8 @@ void mlir::getForwardSlice(Value root, SetVector<Operation *> *forwardSlice,
 
 static void getBackwardSliceImpl(Operation *op,
                                  SetVector<Operation *> *backwardSlice,
-                                 BackwardSliceOptions options) {
+                                 const BackwardSliceOptions &options,
+                                 CachedSliceFn getCachedSlice = nullptr) {
   if (!op || op->hasTrait<OpTrait::IsIsolatedFromAbove>())
     return;
 
@@ -90,11 +106,21 @@ static void getBackwardSliceImpl(Operation *op,
   if (options.filter && !options.filter(op))
     return;
 
+  // The cached slices are in postorder too. The ops already in
+  // `backwardSlice` are skipped, as they are when traversing the defs.
+  if (getCachedSlice) {
+    if (const SetVector<Operation *> *cachedSlice = getCachedSlice(op)) {
+      backwardSlice->insert(cachedSlice->begin(), cachedSlice->end());
+      return;
+    }
+  }
+
   for (const auto &en : llvm::enumerate(op->getOperands())) {
     auto operand = en.value();
     if (auto *definingOp = operand.getDefiningOp()) {
       if (backwardSlice->count(definingOp) == 0)
-        getBackwardSliceImpl(definingOp, backwardSlice, options);
+        getBackwardSliceImpl(definingOp, backwardSlice, options,
+                             getCachedSlice);
     } else if (auto blockArg = dyn_cast<BlockArgument>(operand)) {
       if (options.omitBlockArguments)
         continue;
@@ -107,7 +133,7 @@ static void getBackwardSliceImpl(Operation *op,
       if (parentOp && backwardSlice->count(parentOp) == 0) {
         assert(parentOp->getNumRegions() == 1 &&
                parentOp->getRegion(0).getBlocks().size() == 1);
-        getBackwardSliceImpl(parentOp, backwardSlice, options);
+        getBackwardSliceImpl(parentOp, backwardSlice, options, getCachedSlice);
       }
     } else {
       llvm_unreachable("No definingOp and not a block argument.");
@@ -164,6 +190,105 @@ SetVector<Operation *> mlir::getSlice(Operation *op,
   return topologicalSort(slice);
 }
 
+//===----------------------------------------------------------------------===//
+// SliceCache
+//===----------------------------------------------------------------------===//
+
+/// Returns true if `op` and `root` are in the same block of a region with SSA
+/// dominance, where the slices follow the order of the ops.
+static bool areInSameSSABlock(Operation *op, Operation *root) {
+  Block *block = op->getBlock();
+  return block && block == root->getBlock() &&
+         mayHaveSSADominance(*block->getParent());
+}
+
+const SetVector<Operation *> &
+SliceCache::getInclusiveBackwardSlice(Operation *op,
+                                      const BackwardSliceOptions &options,
+                                      const void *optionsKey) {
+  Key key(op, optionsKey, options.omitBlockArguments);
+  auto it = backwardSlices.find(key);
+  if (it != backwardSlices.end())
+    return *it->second;
+
+  auto getCachedSlice =
+      [&](Operation *sliceOp) -> const SetVector<Operation *> * {
+    auto sliceIt = backwardSlices.find(
+        Key(sliceOp, optionsKey, options.omitBlockArguments));
+    return sliceIt == backwardSlices.end() ? nullptr : sliceIt->second.get();
+  };
+  auto slice = std::make_unique<SetVector<Operation *>>();
+  getBackwardSliceImpl(op, slice.get(), options, getCachedSlice);
+  return *backwardSlices.try_emplace(key, std::move(slice)).first->second;
+}
+
+const SetVector<Operation *> &
+SliceCache::getInclusiveForwardSlice(Operation *op,
+                                     const ForwardSliceOptions &options,
+                                     const void *optionsKey) {
+  auto it = forwardSlices.find({op, optionsKey});
+  if (it != forwardSlices.end())
+    return *it->second;
+
+  auto getCachedSlice =
+      [&](Operation *sliceOp) -> const SetVector<Operation *> * {
+    auto sliceIt = forwardSlices.find({sliceOp, optionsKey});
+    return sliceIt == forwardSlices.end() ? nullptr : sliceIt->second.get();
+  };
+  SetVector<Operation *> postorder;
+  getForwardSliceImpl(op, &postorder, options.filter, getCachedSlice);
+  std::vector<Operation *> v(postorder.takeVector());
+  auto slice = std::make_unique<SetVector<Operation *>>(v.rbegin(), v.rend());
+  return *forwardSlices.try_emplace({op, optionsKey}, std::move(slice))
+              .first->second;
+}
+
+ArrayRef<Operation *>
+SliceCache::getBackwardSlice(Operation *op, const BackwardSliceOptions &options,
+                             const void *optionsKey) {
+  ArrayRef<Operation *> slice =
+      getInclusiveBackwardSlice(op, options, optionsKey).getArrayRef();
+  // The op comes last in its postorder slice, unless it was filtered out.
+  return options.inclusive || slice.empty() ? slice : slice.drop_back();
+}
+
+ArrayRef<Operation *>
+SliceCache::getForwardSlice(Operation *op, const ForwardSliceOptions &options,
+                            const void *optionsKey) {
+  ArrayRef<Operation *> slice =
+      getInclusiveForwardSlice(op, options, optionsKey).getArrayRef();
+  // The op comes first in its topologically ordered slice, unless it was
+  // filtered out.
+  return options.inclusive || slice.empty() ? slice : slice.drop_front();
+}
+
+bool SliceCache::isInBackwardSlice(Operation *op, Operation *root,
+                                   const BackwardSliceOptions &options,
+                                   const void *optionsKey) {
+  if (op == root)
+    return options.inclusive &&
+           !getInclusiveBackwardSlice(root, options, optionsKey).empty();
+  if (areInSameSSABlock(op, root) && !op->isBeforeInBlock(root))
+    return false;
+  return getInclusiveBackwardSlice(root, options, optionsKey).count(op);
+}
+
+bool SliceCache::isInForwardSlice(Operation *op, Operation *root,
+                                  const ForwardSliceOptions &options,
+                                  const void *optionsKey) {
+  if (op == root)
+    return options.inclusive &&
+           !getInclusiveForwardSlice(root, options, optionsKey).empty();
+  if (areInSameSSABlock(op, root) && op->isBeforeInBlock(root))
+    return false;
+  return getInclusiveForwardSlice(root, options, optionsKey).count(op);
+}
+
+void SliceCache::clear() {
+  backwardSlices.clear();
+  forwardSlices.clear();
+}
+
 namespace {
 /// DFS post-order implementation that maintains a global count to work across
 /// multiple invocations, to help implement topological sort on multi-root DAGs.
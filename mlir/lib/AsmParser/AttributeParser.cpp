@@ -23,6 +23,9 @@
 #include "mlir/IR/IntegerSet.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/Endian.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
 #include <optional>
 
 using namespace mlir;
@@ -447,12 +450,13 @@ Attribute Parser::parseDecOrHexAttr(Type type, bool isNegative) {
 //===----------------------------------------------------------------------===//
 
 /// Parse elements values stored within a hex string. On success, the values are
-/// stored into 'result'.
+/// decoded into 'result'.
 static ParseResult parseElementAttrHexValues(Parser &parser, Token tok,
-                                             std::string &result) {
-  if (std::optional<std::string> value = tok.getHexStringValue()) {
-    result = std::move(*value);
-    return success();
+                                             SmallVectorImpl<char> &result) {
+  if (std::optional<size_t> size = tok.getHexStringSize()) {
+    result.resize(*size);
+    if (tok.decodeHexStringValue(result))
+      return success();
   }
   return parser.emitError(
       tok.getLoc(), "expected string containing hex digits starting with `0x`");
@@ -491,6 +495,12 @@ private:
   /// Build a Dense attribute with hex data for the given type.
   DenseElementsAttr getHexAttr(SMLoc loc, ShapedType type);
 
+  /// Build a Dense attribute of 8, 16, 32 or 64-bit integers, or of f32 or f64
+  /// values, by converting the parsed elements directly into its raw buffer.
+  /// Returns null if the element type is not supported or if an element is
+  /// invalid, in which case the generic path reports the error.
+  DenseElementsAttr getRawIntOrFloatAttr(ShapedType type);
+
   /// Parse a single element, returning failure if it isn't a valid element
   /// literal. For example:
   /// parseElement(1) -> Success, 1
@@ -505,6 +515,12 @@ private:
   ///   parseList([[1, [2, 3]], [4, [5]]]) -> Failure
   ParseResult parseList(SmallVectorImpl<int64_t> &dims);
 
+  /// Scan a list of decimal numbers that does not contain nested lists, e.g.
+  /// [1, -2.0, 3], directly from the source buffer instead of lexing one token
+  /// at a time. Returns false without consuming anything if the list contains
+  /// anything else, such as comments or hexadecimal literals.
+  bool scanNumberList(SmallVectorImpl<int64_t> &dims);
+
   /// Parse a literal that was printed as a hex string.
   ParseResult parseHexElements();
 
@@ -561,6 +577,10 @@ DenseElementsAttr TensorLiteralParser::getAttr(SMLoc loc, ShapedType type) {
     return nullptr;
   }
 
+  // Convert the common element types directly into the raw buffer.
+  if (DenseElementsAttr attr = getRawIntOrFloatAttr(type))
+    return attr;
+
   // Handle complex types in the specific element type cases below.
   bool isComplex = false;
   if (ComplexType complexTy = dyn_cast<ComplexType>(eltType)) {
@@ -718,11 +738,11 @@ DenseElementsAttr TensorLiteralParser::getHexAttr(SMLoc loc, ShapedType type) {
     return nullptr;
   }
 
-  std::string data;
+  SmallVector<char, 0> data;
   if (parseElementAttrHexValues(p, *hexStorage, data))
     return nullptr;
 
-  ArrayRef<char> rawData(data.data(), data.size());
+  ArrayRef<char> rawData(data);
   bool detectedSplat = false;
   if (!DenseElementsAttr::isValidRawBuffer(type, rawData, detectedSplat)) {
     p.emitError(loc) << "elements hex data size is invalid for provided type: "
@@ -746,6 +766,83 @@ DenseElementsAttr TensorLiteralParser::getHexAttr(SMLoc loc, ShapedType type) {
   return DenseElementsAttr::getFromRawBuffer(type, rawData);
 }
 
+DenseElementsAttr TensorLiteralParser::getRawIntOrFloatAttr(ShapedType type) {
+  Type eltType = type.getElementType();
+  bool isFloat = eltType.isF32() || eltType.isF64();
+  if (storage.empty() || (!isFloat && !isa<IntegerType, IndexType>(eltType)))
+    return nullptr;
+  unsigned width = eltType.isIndex() ? IndexType::kInternalStorageBitWidth
+                                     : eltType.getIntOrFloatBitWidth();
+  if (width != 8 && width != 16 && width != 32 && width != 64)
+    return nullptr;
+
+  // The bounds of the magnitudes of the positive and negative values.
+  uint64_t maxValue = std::numeric_limits<uint64_t>::max() >> (64 - width);
+  uint64_t signBit = uint64_t(1) << (width - 1);
+  bool isUnsigned = eltType.isUnsignedInteger();
+  if (eltType.isSignedInteger() || eltType.isIndex())
+    maxValue = signBit - 1;
+
+  std::vector<char> rawData(storage.size() * width / 8);
+  char *out = rawData.data();
+  for (const auto &[isNegative, token] : storage) {
+    if (isFloat) {
+      if (!token.is(Token::floatliteral))
+        return nullptr;
+      std::optional<double> value = token.getFloatingPointValue();
+      if (!value)
+        return nullptr;
+      double result = isNegative ? -*value : *value;
+      if (width == 64) {
+        std::memcpy(out, &result, sizeof(double));
+      } else {
+        if (std::abs(result) > std::numeric_limits<float>::max())
+          return nullptr;
+        float narrowed = static_cast<float>(result);
+        std::memcpy(out, &narrowed, sizeof(float));
+      }
+      out += width / 8;
+      continue;
+    }
+
+    if (!token.is(Token::integer))
+      return nullptr;
+    StringRef spelling = token.getSpelling();
+    bool isHex = spelling.size() > 1 && spelling[1] == 'x';
+    uint64_t magnitude;
+    if (spelling.getAsInteger(isHex ? 0 : 10, magnitude))
+      return nullptr;
+    if (isNegative ? (isUnsigned || magnitude == 0 || magnitude > signBit)
+                   : magnitude > maxValue)
+      return nullptr;
+    uint64_t value = isNegative ? -magnitude : magnitude;
+    switch (width) {
+    case 8:
+      *out = static_cast<char>(value);
+      break;
+    case 16: {
+      auto narrowed = static_cast<uint16_t>(value);
+      std::memcpy(out, &narrowed, sizeof(uint16_t));
+      break;
+    }
+    case 32: {
+      auto narrowed = static_cast<uint32_t>(value);
+      std::memcpy(out, &narrowed, sizeof(uint32_t));
+      break;
+    }
+    default:
+      std::memcpy(out, &value, sizeof(uint64_t));
+      break;
+    }
+    out += width / 8;
+  }
+
+  bool detectedSplat = false;
+  if (!DenseElementsAttr::isValidRawBuffer(type, rawData, detectedSplat))
+    return nullptr;
+  return DenseElementsAttr::getFromRawBuffer(type, rawData);
+}
+
 ParseResult TensorLiteralParser::parseElement() {
   switch (p.getToken().getKind()) {
   // Parse a boolean element.
@@ -795,6 +892,9 @@ ParseResult TensorLiteralParser::parseElement() {
 ///   parseList([[1, 2], 3]) -> Failure
 ///   parseList([[1, [2, 3]], [4, [5]]]) -> Failure
 ParseResult TensorLiteralParser::parseList(SmallVectorImpl<int64_t> &dims) {
+  if (scanNumberList(dims))
+    return success();
+
   auto checkDims = [&](const SmallVectorImpl<int64_t> &prevDims,
                        const SmallVectorImpl<int64_t> &newDims) -> ParseResult {
     if (prevDims == newDims)
@@ -831,6 +931,74 @@ ParseResult TensorLiteralParser::parseList(SmallVectorImpl<int64_t> &dims) {
   return success();
 }
 
+bool TensorLiteralParser::scanNumberList(SmallVectorImpl<int64_t> &dims) {
+  // The code completion relies on the tokens produced by the lexer.
+  if (p.getState().codeCompleteContext)
+    return false;
+
+  // The source buffers are null terminated, which stops the scan.
+  const char *ptr = p.getToken().getLoc().getPointer();
+  assert(*ptr == '[' && "expected the start of a list");
+  ++ptr;
+  auto skipWhitespace = [&]() {
+    while (*ptr == ' ' || *ptr == '\t' || *ptr == '\n' || *ptr == '\r')
+      ++ptr;
+  };
+  auto skipDigits = [&]() {
+    while (llvm::isDigit(*ptr))
+      ++ptr;
+  };
+
+  // Scan the elements with the same grammar as the lexer uses for decimal
+  // numbers.
+  size_t numStored = storage.size();
+  int64_t size = 0;
+  while (true) {
+    skipWhitespace();
+    bool isNegative = *ptr == '-';
+    if (isNegative) {
+      ++ptr;
+      skipWhitespace();
+    }
+    const char *start = ptr;
+    if (!llvm::isDigit(*ptr) || (ptr[0] == '0' && ptr[1] == 'x'))
+      break;
+    skipDigits();
+    Token::Kind kind = Token::integer;
+    if (*ptr == '.') {
+      kind = Token::floatliteral;
+      ++ptr;
+      skipDigits();
+      if ((*ptr == 'e' || *ptr == 'E') &&
+          (llvm::isDigit(ptr[1]) ||
+           ((ptr[1] == '-' || ptr[1] == '+') && llvm::isDigit(ptr[2])))) {
+        ptr += 2;
+        skipDigits();
+      }
+    }
+    storage.emplace_back(isNegative,
+                         Token(kind, StringRef(start, ptr - start)));
+    ++size;
+
+    skipWhitespace();
+    if (*ptr == ',') {
+      ++ptr;
+      continue;
+    }
+    if (*ptr != ']')
+      break;
+
+    p.resetToken(ptr + 1);
+    dims.clear();
+    dims.push_back(size);
+    return true;
+  }
+
+  // Leave the list to the lexer.
+  storage.erase(storage.begin() + numStored, storage.end());
+  return false;
+}
+
 //===----------------------------------------------------------------------===//
 // DenseArrayAttr Parser
 //===----------------------------------------------------------------------===//
@@ -19,6 +19,8 @@
 #include "mlir/IR/AsmState.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Dialect.h"
+#include "mlir/IR/FunctionInterfaces.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/IR/Verifier.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/ScopeExit.h"
@@ -331,6 +333,7 @@ Parser::parseResourceHandle(const OpAsmDialectInterface *dialect,
   if (failed(parseOptionalKeyword(&name)))
     return emitError("expected identifier key for 'resource' entry");
   auto &resources = getState().symbols.dialectResources;
+  std::lock_guard<std::mutex> lock(getState().symbols.dialectResourcesMutex);
 
   // If this is the first time encountering this handle, ask the dialect to
   // resolve a reference to this handle. This allows for us to remap the name of
@@ -593,6 +596,17 @@ public:
                               ArrayRef<Argument> entryArguments,
                               bool isIsolatedNameScope);
 
+  /// Parse the region of an isolated function operation into 'region'. When
+  /// parsing in parallel, the body of the region is skipped and 'region' only
+  /// holds an empty placeholder block until `parseDeferredRegions` is called.
+  ParseResult parseDeferrableRegion(Region &region,
+                                    ArrayRef<Argument> entryArguments,
+                                    bool isIsolatedNameScope);
+
+  /// Parse the bodies of the deferred regions in parallel. This must be called
+  /// after every top-level operation and alias definition was parsed.
+  ParseResult parseDeferredRegions();
+
   //===--------------------------------------------------------------------===//
   // Block Parsing
   //===--------------------------------------------------------------------===//
@@ -638,6 +652,36 @@ private:
     SMLoc loc;
   };
 
+  /// This class represents a region whose body is parsed after all of the
+  /// top-level operations.
+  struct DeferredRegion {
+    /// The region to parse the body into.
+    Region *region;
+    /// The location of the '{' that starts the region.
+    SMLoc loc;
+    /// The entry block arguments of the region.
+    SmallVector<Argument> entryArguments;
+    /// Whether the naming scope of the region is isolated from those above.
+    bool isIsolatedNameScope;
+    /// The default dialects of the operations enclosing the region.
+    SmallVector<StringRef> defaultDialectStack;
+  };
+
+  /// Parse the body of a deferred region, and resolve the forward references
+  /// it contains.
+  ParseResult parseDeferredRegion(DeferredRegion &deferred);
+
+  /// Load the dialect named by the prefix of the given token, if any, before
+  /// the bodies that reference it are parsed in parallel.
+  void loadReferencedDialect(const Token &tok);
+
+  /// Emit an error for each forward reference to a value that is left.
+  ParseResult checkForwardRefPlaceholders();
+
+  /// Resolve the deferred locations of the operations and block arguments
+  /// nested under 'region'.
+  ParseResult resolveDeferredLocations(Region &region);
+
   /// Returns the info for a block at the current scope for the given name.
   BlockDefinition &getBlockInfoByName(StringRef name) {
     return blocksByName.back()[name];
@@ -711,6 +755,16 @@ private:
   /// of this location.
   std::vector<DeferredLocInfo> deferredLocsReferences;
 
+  /// Whether the bodies of the isolated function operations are deferred to
+  /// be parsed in parallel.
+  bool deferIsolatedRegions;
+
+  /// The regions whose bodies were skipped, in the order of the source file.
+  std::vector<DeferredRegion> deferredRegions;
+
+  /// The dialects that were loaded for the deferred regions.
+  llvm::StringSet<> referencedDialects;
+
   /// The builder used when creating parsed operation instances.
   OpBuilder opBuilder;
 
@@ -723,7 +777,11 @@ MLIR_DECLARE_EXPLICIT_TYPE_ID(OperationParser::DeferredLocInfo *)
 MLIR_DEFINE_EXPLICIT_TYPE_ID(OperationParser::DeferredLocInfo *)
 
 OperationParser::OperationParser(ParserState &state, ModuleOp topLevelOp)
-    : Parser(state), opBuilder(topLevelOp.getRegion()), topLevelOp(topLevelOp) {
+    : Parser(state),
+      deferIsolatedRegions(state.config.shouldParseInParallel() &&
+                           getContext()->isMultithreadingEnabled() &&
+                           !state.asmState && !state.codeCompleteContext),
+      opBuilder(topLevelOp.getRegion()), topLevelOp(topLevelOp) {
   // The top level operation starts a new name scope.
   pushSSANameScope(/*isIsolated=*/true);
 
@@ -754,21 +812,45 @@ OperationParser::~OperationParser() {
 ParseResult OperationParser::finalize() {
   // Check for any forward references that are left.  If we find any, error
   // out.
-  if (!forwardRefPlaceholders.empty()) {
-    SmallVector<const char *, 4> errors;
-    // Iteration over the map isn't deterministic, so sort by source location.
-    for (auto entry : forwardRefPlaceholders)
-      errors.push_back(entry.second.getPointer());
-    llvm::array_pod_sort(errors.begin(), errors.end());
+  if (checkForwardRefPlaceholders())
+    return failure();
 
-    for (const char *entry : errors) {
-      auto loc = SMLoc::getFromPointer(entry);
-      emitError(loc, "use of undeclared SSA value name");
-    }
+  // Resolve the locations of any deferred operations.
+  if (resolveDeferredLocations(topLevelOp->getRegion(0)))
+    return failure();
+
+  // Pop the top level name scope.
+  if (failed(popSSANameScope()))
+    return failure();
+
+  // Verify that the parsed operations are valid.
+  if (state.config.shouldVerifyAfterParse() && failed(verify(topLevelOp)))
     return failure();
+
+  // If we are populating the parser state, finalize the top-level operation.
+  if (state.asmState)
+    state.asmState->finalize(topLevelOp);
+  return success();
+}
+
+ParseResult OperationParser::checkForwardRefPlaceholders() {
+  if (forwardRefPlaceholders.empty())
+    return success();
+
+  SmallVector<const char *, 4> errors;
+  // Iteration over the map isn't deterministic, so sort by source location.
+  for (auto entry : forwardRefPlaceholders)
+    errors.push_back(entry.second.getPointer());
+  llvm::array_pod_sort(errors.begin(), errors.end());
+
+  for (const char *entry : errors) {
+    auto loc = SMLoc::getFromPointer(entry);
+    emitError(loc, "use of undeclared SSA value name");
   }
+  return failure();
+}
 
-  // Resolve the locations of any deferred operations.
+ParseResult OperationParser::resolveDeferredLocations(Region &region) {
   auto &attributeAliases = state.symbols.attributeAliasDefinitions;
   auto locID = TypeID::get<DeferredLocInfo *>();
   auto resolveLocation = [&, this](auto &opOrArgument) -> LogicalResult {
@@ -787,31 +869,28 @@ ParseResult OperationParser::finalize() {
     opOrArgument.setLoc(locAttr);
     return success();
   };
+  auto resolveArgLocations = [&](Region &region) -> LogicalResult {
+    for (Block &block : region.getBlocks())
+      for (BlockArgument arg : block.getArguments())
+        if (failed(resolveLocation(arg)))
+          return failure();
+    return success();
+  };
 
-  auto walkRes = topLevelOp->walk([&](Operation *op) {
-    if (failed(resolveLocation(*op)))
-      return WalkResult::interrupt();
-    for (Region &region : op->getRegions())
-      for (Block &block : region.getBlocks())
-        for (BlockArgument arg : block.getArguments())
-          if (failed(resolveLocation(arg)))
-            return WalkResult::interrupt();
-    return WalkResult::advance();
-  });
-  if (walkRes.wasInterrupted())
-    return failure();
-
-  // Pop the top level name scope.
-  if (failed(popSSANameScope()))
-    return failure();
-
-  // Verify that the parsed operations are valid.
-  if (state.config.shouldVerifyAfterParse() && failed(verify(topLevelOp)))
+  if (failed(resolveArgLocations(region)))
     return failure();
-
-  // If we are populating the parser state, finalize the top-level operation.
-  if (state.asmState)
-    state.asmState->finalize(topLevelOp);
+  for (Block &block : region) {
+    auto walkRes = block.walk([&](Operation *op) {
+      if (failed(resolveLocation(*op)))
+        return WalkResult::interrupt();
+      for (Region &nestedRegion : op->getRegions())
+        if (failed(resolveArgLocations(nestedRegion)))
+          return WalkResult::interrupt();
+      return WalkResult::advance();
+    });
+    if (walkRes.wasInterrupted())
+      return failure();
+  }
   return success();
 }
 
@@ -1478,10 +1557,11 @@ public:
   CustomOpAsmParser(
       SMLoc nameLoc, ArrayRef<OperationParser::ResultRecord> resultIDs,
       function_ref<ParseResult(OpAsmParser &, OperationState &)> parseAssembly,
-      bool isIsolatedFromAbove, StringRef opName, OperationParser &parser)
+      bool isIsolatedFromAbove, bool isDeferrable, StringRef opName,
+      OperationParser &parser)
       : AsmParserImpl<OpAsmParser>(nameLoc, parser), resultIDs(resultIDs),
         parseAssembly(parseAssembly), isIsolatedFromAbove(isIsolatedFromAbove),
-        opName(opName), parser(parser) {
+        isDeferrable(isDeferrable), opName(opName), parser(parser) {
     (void)isIsolatedFromAbove; // Only used in assert, silence unused warning.
   }
 
@@ -1752,6 +1832,9 @@ public:
     (void)isIsolatedFromAbove;
     assert((!enableNameShadowing || isIsolatedFromAbove) &&
            "name shadowing is only allowed on isolated regions");
+    if (isDeferrable)
+      return parser.parseDeferrableRegion(region, arguments,
+                                          enableNameShadowing);
     if (parser.parseRegion(region, arguments, enableNameShadowing))
       return failure();
     return success();
@@ -1870,6 +1953,9 @@ private:
   /// The abstract information of the operation.
   function_ref<ParseResult(OpAsmParser &, OperationState &)> parseAssembly;
   bool isIsolatedFromAbove;
+
+  /// Whether the regions of the operation may be parsed in parallel.
+  bool isDeferrable;
   StringRef opName;
 
   /// The backing operation parser.
@@ -1926,11 +2012,16 @@ OperationParser::parseCustomOperation(ArrayRef<ResultRecord> resultIDs) {
   // RegisteredOperationName or from the Dialect.
   OperationName::ParseAssemblyFn parseAssemblyFn;
   bool isIsolatedFromAbove = false;
+  bool isDeferrable = false;
 
   StringRef defaultDialect = "";
   if (auto opInfo = opNameInfo->getRegisteredInfo()) {
     parseAssemblyFn = opInfo->getParseAssemblyFn();
     isIsolatedFromAbove = opInfo->hasTrait<OpTrait::IsIsolatedFromAbove>();
+    // Only the regions of functions are deferred, as their parsers do not
+    // inspect the body after parsing it.
+    isDeferrable =
+        isIsolatedFromAbove && opInfo->hasInterface<FunctionOpInterface>();
     auto *iface = opInfo->getInterface<OpAsmOpInterface>();
     if (iface && !iface->getDefaultDialect().empty())
       defaultDialect = iface->getDefaultDialect();
@@ -1983,7 +2074,8 @@ OperationParser::parseCustomOperation(ArrayRef<ResultRecord> resultIDs) {
   // Have the op implementation take a crack and parsing this.
   CleanupOpStateRegions guard{opState};
   CustomOpAsmParser opAsmParser(opLoc, resultIDs, parseAssemblyFn,
-                                isIsolatedFromAbove, opName, *this);
+                                isIsolatedFromAbove, isDeferrable, opName,
+                                *this);
   if (opAsmParser.parseOperation(opState))
     return nullptr;
 
@@ -2098,6 +2190,105 @@ ParseResult OperationParser::parseRegion(Region &region,
   return success();
 }
 
+ParseResult
+OperationParser::parseDeferrableRegion(Region &region,
+                                       ArrayRef<Argument> entryArguments,
+                                       bool isIsolatedNameScope) {
+  if (!deferIsolatedRegions || getToken().isNot(Token::l_brace))
+    return parseRegion(region, entryArguments, isIsolatedNameScope);
+
+  // Skip to the matching '}', and load the dialects referenced along the way
+  // as dialects cannot be loaded while parsing in parallel. If the region is
+  // not terminated, parse it right away to report the error.
+  Token lBraceTok = getToken();
+  consumeToken(Token::l_brace);
+  for (unsigned depth = 1; depth != 0;) {
+    switch (getToken().getKind()) {
+    case Token::eof:
+      resetToken(lBraceTok.getLoc().getPointer());
+      return parseRegion(region, entryArguments, isIsolatedNameScope);
+    case Token::error:
+      return failure();
+    case Token::l_brace:
+      ++depth;
+      break;
+    case Token::r_brace:
+      --depth;
+      break;
+    default:
+      loadReferencedDialect(getToken());
+      break;
+    }
+    consumeToken();
+  }
+
+  // Custom parsers may check that the region is not empty, so the body starts
+  // with a placeholder block that is dropped when the body is parsed.
+  region.push_back(new Block());
+  deferredRegions.push_back(
+      {&region, lBraceTok.getLoc(),
+       SmallVector<Argument>(entryArguments.begin(), entryArguments.end()),
+       isIsolatedNameScope, state.defaultDialectStack});
+  return success();
+}
+
+void OperationParser::loadReferencedDialect(const Token &tok) {
+  StringRef name;
+  switch (tok.getKind()) {
+  case Token::bare_identifier:
+    name = tok.getSpelling();
+    break;
+  case Token::exclamation_identifier:
+  case Token::hash_identifier:
+    name = tok.getSpelling().drop_front();
+    break;
+  case Token::string:
+    name = tok.getSpelling().drop_front().drop_back();
+    break;
+  default:
+    return;
+  }
+  size_t dotPos = name.find('.');
+  if (dotPos == StringRef::npos)
+    return;
+  name = name.take_front(dotPos);
+  if (referencedDialects.insert(name).second)
+    getContext()->getOrLoadDialect(name);
+}
+
+ParseResult OperationParser::parseDeferredRegions() {
+  if (deferredRegions.empty())
+    return success();
+
+  // Each region is parsed by a separate parser, which only reads the symbols
+  // of the top-level parser. The line cache of the source manager was already
+  // built when encoding the locations of the top-level operations.
+  auto parseOne = [&](DeferredRegion &deferred) -> LogicalResult {
+    ParserState regionState(getSourceMgr(), state.config, state.symbols,
+                            /*asmState=*/nullptr,
+                            /*codeCompleteContext=*/nullptr);
+    regionState.defaultDialectStack = deferred.defaultDialectStack;
+    OperationParser regionParser(regionState, cast<ModuleOp>(topLevelOp));
+    regionParser.deferIsolatedRegions = false;
+    regionParser.resetToken(deferred.loc.getPointer());
+    return regionParser.parseDeferredRegion(deferred);
+  };
+  LogicalResult result =
+      failableParallelForEach(getContext(), deferredRegions, parseOne);
+  deferredRegions.clear();
+  return result;
+}
+
+ParseResult OperationParser::parseDeferredRegion(DeferredRegion &deferred) {
+  deferred.region->getBlocks().clear();
+  if (parseRegion(*deferred.region, deferred.entryArguments,
+                  deferred.isIsolatedNameScope) ||
+      checkForwardRefPlaceholders() ||
+      resolveDeferredLocations(*deferred.region))
+    return failure();
+  return popSSANameScope();
+}
+
 ParseResult OperationParser::parseRegionBody(Region &region, SMLoc startLoc,
                                              ArrayRef<Argument> entryArguments,
                                              bool isIsolatedNameScope) {
@@ -2465,24 +2656,29 @@ public:
 
   FailureOr<AsmResourceBlob>
   parseAsBlob(BlobAllocatorFn allocator) const final {
-    // Blob data within then textual format is represented as a hex string.
-    // TODO: We could avoid an additional alloc+copy here if we pre-allocated
-    // the buffer to use during hex processing.
-    std::optional<std::string> blobData =
-        value.is(Token::string) ? value.getHexStringValue() : std::nullopt;
-    if (!blobData)
+    // Blob data within then textual format is represented as a hex string,
+    // which is decoded directly into the memory of the blob.
+    std::optional<size_t> blobSize =
+        value.is(Token::string) ? value.getHexStringSize() : std::nullopt;
+    auto emitInvalidHexError = [&] {
       return p.emitError(value.getLoc(),
                          "expected hex string blob for key '" + key + "'");
+    };
+    if (!blobSize)
+      return emitInvalidHexError();
 
     // Extract the alignment of the blob data, which gets stored at the
     // beginning of the string.
-    if (blobData->size() < sizeof(uint32_t)) {
+    if (*blobSize < sizeof(uint32_t)) {
       return p.emitError(value.getLoc(),
                          "expected hex string blob for key '" + key +
                              "' to encode alignment in first 4 bytes");
     }
     llvm::support::ulittle32_t align;
-    memcpy(&align, blobData->data(), sizeof(uint32_t));
+    if (!value.decodeHexStringValue(
+            MutableArrayRef<char>(reinterpret_cast<char *>(&align),
+                                  sizeof(uint32_t))))
+      return emitInvalidHexError();
     if (align && !llvm::isPowerOf2_32(align)) {
       return p.emitError(value.getLoc(),
                          "expected hex string blob for key '" + key +
@@ -2492,17 +2688,19 @@ public:
     }
 
     // Get the data portion of the blob.
-    StringRef data = StringRef(*blobData).drop_front(sizeof(uint32_t));
-    if (data.empty())
+    size_t dataSize = *blobSize - sizeof(uint32_t);
+    if (dataSize == 0)
       return AsmResourceBlob();
 
-    // Allocate memory for the blob using the provided allocator and copy the
+    // Allocate memory for the blob using the provided allocator and decode the
     // data into it.
-    AsmResourceBlob blob = allocator(data.size(), align);
+    AsmResourceBlob blob = allocator(dataSize, align);
     assert(llvm::isAddrAligned(llvm::Align(align), blob.getData().data()) &&
            blob.isMutable() &&
            "blob allocator did not return a properly aligned address");
-    memcpy(blob.getMutableData().data(), data.data(), data.size());
+    if (!value.decodeHexStringValue(blob.getMutableData(),
+                                    /*offset=*/sizeof(uint32_t)))
+      return emitInvalidHexError();
     return blob;
   }
 
@@ -2687,7 +2885,7 @@ ParseResult TopLevelOperationParser::parse(Block *topLevelBlock,
 
     // If we got to the end of the file, then we're done.
     case Token::eof: {
-      if (opParser.finalize())
+      if (opParser.parseDeferredRegions() || opParser.finalize())
         return failure();
 
       // Splice the blocks of the parsed operation over to the provided
@@ -14,6 +14,8 @@
 #include "mlir/IR/OpImplementation.h"
 #include "llvm/ADT/StringMap.h"
 
+#include <mutex>
+
 namespace mlir {
 class OpAsmDialectInterface;
 
@@ -36,6 +38,10 @@ struct SymbolState {
   DenseMap<const OpAsmDialectInterface *,
            llvm::StringMap<std::pair<std::string, AsmDialectResourceHandle>>>
       dialectResources;
+
+  /// A mutex guarding the dialect resources, which may be declared by the
+  /// regions parsed in parallel.
+  std::mutex dialectResourcesMutex;
 };
 
 //===----------------------------------------------------------------------===//
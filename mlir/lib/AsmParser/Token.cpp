@@ -11,7 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "Token.h"
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringExtras.h"
+#include <array>
 #include <optional>
 
 using namespace mlir;
@@ -128,19 +130,52 @@ std::string Token::getStringValue() const {
 /// Given a token containing a hex string literal, return its value or
 /// std::nullopt if the token does not contain a valid hex string.
 std::optional<std::string> Token::getHexStringValue() const {
+  std::optional<size_t> size = getHexStringSize();
+  if (!size)
+    return std::nullopt;
+  std::string hex(*size, '\0');
+  if (!decodeHexStringValue(MutableArrayRef<char>(hex.data(), hex.size())))
+    return std::nullopt;
+  return hex;
+}
+
+std::optional<size_t> Token::getHexStringSize() const {
   assert(getKind() == string);
 
-  // Get the internal string data, without the quotes.
+  // Get the internal string data, without the quotes. We expect the hex string
+  // to start with `0x` and have an even number of hex nibbles (nibbles should
+  // come in pairs).
   StringRef bytes = getSpelling().drop_front().drop_back();
-
-  // Try to extract the binary data from the hex string. We expect the hex
-  // string to start with `0x` and have an even number of hex nibbles (nibbles
-  // should come in pairs).
-  std::string hex;
-  if (!bytes.consume_front("0x") || (bytes.size() & 1) ||
-      !llvm::tryGetFromHex(bytes, hex))
+  if (!bytes.consume_front("0x") || (bytes.size() & 1))
     return std::nullopt;
-  return hex;
+  return bytes.size() / 2;
+}
+
+bool Token::decodeHexStringValue(MutableArrayRef<char> result,
+                                 size_t offset) const {
+  // The value of each hex digit, with a bit set above the 4 bits of the value
+  // for other characters so that the digits are checked once per string.
+  static const std::array<uint8_t, 256> digitValues = [] {
+    std::array<uint8_t, 256> values;
+    values.fill(0x10);
+    for (unsigned c = 0; c != values.size(); ++c)
+      if (llvm::isHexDigit(static_cast<char>(c)))
+        values[c] = llvm::hexDigitValue(static_cast<char>(c));
+    return values;
+  }();
+
+  // Skip the quote and the `0x` prefix.
+  const uint8_t *digits = getSpelling().bytes_begin() + 3 + 2 * offset;
+  assert(getSpelling().size() >= 4 + 2 * (offset + result.size()) &&
+         "decoding past the end of the hex string");
+  uint8_t invalid = 0;
+  for (size_t i = 0, e = result.size(); i != e; ++i) {
+    uint8_t high = digitValues[digits[2 * i]];
+    uint8_t low = digitValues[digits[2 * i + 1]];
+    invalid |= high | low;
+    result[i] = static_cast<char>((high << 4) | low);
+  }
+  return !(invalid & 0x10);
 }
 
 /// Given a token containing a symbol reference, return the unescaped string
@@ -111,6 +111,19 @@ public:
   /// digits.
   std::optional<std::string> getHexStringValue() const;
 
+  /// Given a token containing a string literal, return the number of bytes
+  /// encoded by its hex digits, or std::nullopt if it does not start with `0x`
+  /// or has an odd number of digits.
+  std::optional<size_t> getHexStringSize() const;
+
+  /// Given a token containing a hex string literal, decode the bytes starting
+  /// at `offset` into `result`, which must be within the size returned by
+  /// `getHexStringSize`. Returns false if the decoded digits are not all hex
+  /// digits. This allows decoding large hex strings directly into their final
+  /// storage.
+  bool decodeHexStringValue(MutableArrayRef<char> result,
+                            size_t offset = 0) const;
+
   /// Given a token containing a symbol reference, return the unescaped string
   /// value.
   std::string getSymbolReference() const;
@@ -8,6 +8,7 @@
 
 #include "mlir-c/ExecutionEngine.h"
 #include "mlir/Bindings/Python/PybindAdaptors.h"
+#include "llvm/ADT/SmallVector.h"
 
 namespace py = pybind11;
 using namespace mlir;
@@ -61,12 +62,99 @@ private:
   std::vector<py::object> referencedObjects;
 };
 
+/// A function of an ExecutionEngine bound to the kinds of its arguments, which
+/// are buffers passed either as ranked memrefs, i.e. by a pointer to a memref
+/// descriptor built from the buffer, or by a pointer to their data. Calls
+/// unpack the buffers without going through ctypes and release the GIL while
+/// the function executes.
+class PyPreparedCall {
+public:
+  /// The rank of the arguments passed by a pointer to their data.
+  static constexpr int kPointerArgument = -1;
+
+  PyPreparedCall(void (*func)(void **), std::vector<int> argRanks)
+      : func(func), argRanks(std::move(argRanks)) {}
+
+  void call(const py::args &args) {
+    if (args.size() != argRanks.size())
+      throw py::value_error("expected " + std::to_string(argRanks.size()) +
+                            " arguments, got " + std::to_string(args.size()));
+
+    // The descriptors of the memref arguments are stored consecutively in
+    // `descriptors`, as words of the size of a pointer.
+    static_assert(sizeof(int64_t) == sizeof(void *),
+                  "memref descriptors are built for 64-bit targets");
+    llvm::SmallVector<py::buffer_info, 4> buffers;
+    buffers.reserve(args.size());
+    size_t numDescriptorWords = 0;
+    for (auto [index, arg] : llvm::enumerate(args)) {
+      if (!py::isinstance<py::buffer>(arg))
+        throw py::type_error("argument " + std::to_string(index) +
+                             " does not support the buffer protocol");
+      buffers.push_back(py::reinterpret_borrow<py::buffer>(arg).request());
+      int rank = argRanks[index];
+      if (rank == kPointerArgument)
+        continue;
+      if (buffers.back().ndim != rank)
+        throw py::value_error("argument " + std::to_string(index) +
+                              " is expected to have rank " +
+                              std::to_string(rank) + ", got " +
+                              std::to_string(buffers.back().ndim));
+      numDescriptorWords += 3 + 2 * rank;
+    }
+
+    llvm::SmallVector<int64_t, 32> descriptors(numDescriptorWords);
+    llvm::SmallVector<void *, 4> descriptorPtrs(args.size());
+    llvm::SmallVector<void *, 4> packedArgs(args.size());
+    int64_t *descriptor = descriptors.data();
+    for (auto [index, buffer] : llvm::enumerate(buffers)) {
+      int rank = argRanks[index];
+      if (rank == kPointerArgument) {
+        packedArgs[index] = buffer.ptr;
+        continue;
+      }
+      // The allocated and aligned pointers, the offset, the sizes and the
+      // strides in number of elements.
+      descriptor[0] = reinterpret_cast<int64_t>(buffer.ptr);
+      descriptor[1] = reinterpret_cast<int64_t>(buffer.ptr);
+      descriptor[2] = 0;
+      for (int dim = 0; dim < rank; ++dim) {
+        if (buffer.strides[dim] % buffer.itemsize != 0)
+          throw py::value_error("argument " + std::to_string(index) +
+                                " has strides that are not a multiple of "
+                                "its element size");
+        descriptor[3 + dim] = buffer.shape[dim];
+        descriptor[3 + rank + dim] = buffer.strides[dim] / buffer.itemsize;
+      }
+      descriptorPtrs[index] = descriptor;
+      packedArgs[index] = &descriptorPtrs[index];
+      descriptor += 3 + 2 * rank;
+    }
+
+    py::gil_scoped_release release;
+    func(packedArgs.data());
+  }
+
+private:
+  void (*func)(void **);
+  std::vector<int> argRanks;
+};
+
 } // namespace
 
 /// Create the `mlir.execution_engine` module here.
 PYBIND11_MODULE(_mlirExecutionEngine, m) {
   m.doc() = "MLIR Execution Engine";
 
+  //----------------------------------------------------------------------------
+  // Mapping of a prepared call of a function of the ExecutionEngine
+  //----------------------------------------------------------------------------
+  py::class_<PyPreparedCall>(m, "PreparedCall", py::module_local())
+      .def("__call__", &PyPreparedCall::call,
+           "Calls the function with buffers (e.g. numpy arrays) as "
+           "arguments. The buffers are passed by reference and the GIL is "
+           "released during the call.");
+
   //----------------------------------------------------------------------------
   // Mapping of the top-level PassManager
   //----------------------------------------------------------------------------
@@ -109,6 +197,29 @@ PYBIND11_MODULE(_mlirExecutionEngine, m) {
           },
           py::arg("func_name"),
           "Lookup function `func` in the ExecutionEngine.")
+      .def(
+          "raw_prepare",
+          [](PyExecutionEngine &executionEngine, const std::string &func,
+             const std::vector<std::optional<int>> &argRanks) {
+            auto *res = mlirExecutionEngineLookupPacked(
+                executionEngine.get(),
+                mlirStringRefCreate(func.c_str(), func.size()));
+            if (!res)
+              throw std::runtime_error("Unknown function " + func);
+            std::vector<int> ranks;
+            ranks.reserve(argRanks.size());
+            for (std::optional<int> rank : argRanks) {
+              if (rank && *rank < 0)
+                throw py::value_error("memref ranks must be non-negative");
+              ranks.push_back(rank.value_or(PyPreparedCall::kPointerArgument));
+            }
+            return PyPreparedCall(reinterpret_cast<void (*)(void **)>(res),
+                                  std::move(ranks));
+          },
+          py::arg("func_name"), py::arg("arg_ranks"), py::keep_alive<0, 1>(),
+          "Binds function `func` in the ExecutionEngine to the kinds of its "
+          "arguments. An argument of integer rank is passed as a memref of "
+          "that rank, and an argument of rank None by a pointer to its data.")
       .def(
           "raw_register_runtime",
           [](PyExecutionEngine &executionEngine, const std::string &name,
@@ -9,6 +9,7 @@
 #ifndef MLIR_BINDINGS_PYTHON_GLOBALS_H
 #define MLIR_BINDINGS_PYTHON_GLOBALS_H
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -24,6 +25,20 @@
 namespace mlir {
 namespace python {
 
+/// The construction metadata of an operation class (deriving from OpView), as
+/// declared by its ODS-generated class attributes.
+struct PyOpViewClassInfo {
+  /// The value of `OPERATION_NAME`.
+  std::string name;
+  /// The values of `_ODS_OPERAND_SEGMENTS` and `_ODS_RESULT_SEGMENTS`, which
+  /// are none if the operation has no variadic operands or results.
+  std::optional<std::vector<int>> operandSegmentSpec;
+  std::optional<std::vector<int>> resultSegmentSpec;
+  /// The value of `_ODS_REGIONS`.
+  int minRegionCount;
+  bool hasNoVariadicRegions;
+};
+
 /// Globals that are always accessible once the extension has been initialized.
 class PyGlobals {
 public:
@@ -100,6 +115,12 @@ public:
   std::optional<pybind11::object>
   lookupOperationClass(llvm::StringRef operationName);
 
+  /// Returns the construction metadata of an operation class (deriving from
+  /// OpView). The class attributes are read on the first lookup of the class
+  /// only, and the returned reference remains valid until the import cache is
+  /// cleared.
+  const PyOpViewClassInfo &lookupOpViewClassInfo(const pybind11::object &cls);
+
 private:
   static PyGlobals *instance;
   /// Module name prefixes to search under for dialect implementation modules.
@@ -122,6 +143,11 @@ private:
   /// maintained on lookup as a shadow of operationClassMap in order for repeat
   /// lookups of the classes to only incur the cost of one hashtable lookup.
   llvm::StringMap<pybind11::object> operationClassMapCache;
+  /// Cache of operation class to its construction metadata. The keys are kept
+  /// alive by the first element of the values.
+  llvm::DenseMap<PyObject *, std::pair<pybind11::object,
+                                       std::unique_ptr<PyOpViewClassInfo>>>
+      opViewClassInfoCache;
 };
 
 } // namespace python
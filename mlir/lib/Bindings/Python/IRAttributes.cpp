@@ -16,6 +16,7 @@
 #include "mlir-c/BuiltinAttributes.h"
 #include "mlir-c/BuiltinTypes.h"
 #include "mlir/Bindings/Python/PybindAdaptors.h"
+#include "llvm/ADT/ScopeExit.h"
 
 namespace py = pybind11;
 using namespace mlir;
@@ -69,6 +70,30 @@ Raises:
     type or if the buffer does not meet expectations.
 )";
 
+static const char kDenseResourceElementsAttrGetFromBufferDocstring[] =
+    R"(Gets a DenseResourceElementsAttr from a Python buffer or array.
+
+The attribute references the memory of the buffer without copying it, and
+keeps the buffer alive until the resource is released, e.g. when the context
+is destroyed. The buffer must be contiguous, and its contents must match the
+MLIR internal representation of the elements of `type`.
+
+Args:
+  array: The array or buffer to reference.
+  name: The name of the resource, which is uniqued within the context.
+  type: The shaped type of the attribute.
+  alignment: The alignment of the data, which defaults to the size of the
+    buffer items.
+  is_mutable: Whether the data may be modified through the resource.
+  context: Explicit context, if not from context manager.
+
+Returns:
+  DenseResourceElementsAttr on success.
+
+Raises:
+  ValueError: If the type is not shaped or the buffer is not contiguous.
+)";
+
 namespace {
 
 static MlirStringRef toMlirStringRef(const std::string &s) {
@@ -711,69 +736,77 @@ public:
   intptr_t dunderLen() { return mlirElementsAttrGetNumElements(*this); }
 
   py::buffer_info accessBuffer() {
-    MlirType shapedType = mlirAttributeGetType(*this);
+    return getBufferInfo(
+        mlirAttributeGetType(*this),
+        const_cast<void *>(mlirDenseElementsAttrGetRawData(*this)),
+        mlirDenseElementsAttrIsSplat(*this));
+  }
+
+  /// Returns the buffer info for read-only access to the elements of the given
+  /// shaped type stored at `data`, where a splat stores a single element.
+  static py::buffer_info getBufferInfo(MlirType shapedType, void *data,
+                                       bool isSplat) {
     MlirType elementType = mlirShapedTypeGetElementType(shapedType);
-    std::string format;
 
     if (mlirTypeIsAF32(elementType)) {
       // f32
-      return bufferInfo<float>(shapedType);
+      return bufferInfo<float>(shapedType, data, isSplat);
     }
     if (mlirTypeIsAF64(elementType)) {
       // f64
-      return bufferInfo<double>(shapedType);
+      return bufferInfo<double>(shapedType, data, isSplat);
     }
     if (mlirTypeIsAF16(elementType)) {
       // f16
-      return bufferInfo<uint16_t>(shapedType, "e");
+      return bufferInfo<uint16_t>(shapedType, data, isSplat, "e");
     }
     if (mlirTypeIsAIndex(elementType)) {
       // Same as IndexType::kInternalStorageBitWidth
-      return bufferInfo<int64_t>(shapedType);
+      return bufferInfo<int64_t>(shapedType, data, isSplat);
     }
     if (mlirTypeIsAInteger(elementType) &&
         mlirIntegerTypeGetWidth(elementType) == 32) {
       if (mlirIntegerTypeIsSignless(elementType) ||
           mlirIntegerTypeIsSigned(elementType)) {
         // i32
-        return bufferInfo<int32_t>(shapedType);
+        return bufferInfo<int32_t>(shapedType, data, isSplat);
       }
       if (mlirIntegerTypeIsUnsigned(elementType)) {
         // unsigned i32
-        return bufferInfo<uint32_t>(shapedType);
+        return bufferInfo<uint32_t>(shapedType, data, isSplat);
       }
     } else if (mlirTypeIsAInteger(elementType) &&
                mlirIntegerTypeGetWidth(elementType) == 64) {
       if (mlirIntegerTypeIsSignless(elementType) ||
           mlirIntegerTypeIsSigned(elementType)) {
         // i64
-        return bufferInfo<int64_t>(shapedType);
+        return bufferInfo<int64_t>(shapedType, data, isSplat);
       }
       if (mlirIntegerTypeIsUnsigned(elementType)) {
         // unsigned i64
-        return bufferInfo<uint64_t>(shapedType);
+        return bufferInfo<uint64_t>(shapedType, data, isSplat);
       }
     } else if (mlirTypeIsAInteger(elementType) &&
                mlirIntegerTypeGetWidth(elementType) == 8) {
       if (mlirIntegerTypeIsSignless(elementType) ||
           mlirIntegerTypeIsSigned(elementType)) {
         // i8
-        return bufferInfo<int8_t>(shapedType);
+        return bufferInfo<int8_t>(shapedType, data, isSplat);
       }
       if (mlirIntegerTypeIsUnsigned(elementType)) {
         // unsigned i8
-        return bufferInfo<uint8_t>(shapedType);
+        return bufferInfo<uint8_t>(shapedType, data, isSplat);
       }
     } else if (mlirTypeIsAInteger(elementType) &&
                mlirIntegerTypeGetWidth(elementType) == 16) {
       if (mlirIntegerTypeIsSignless(elementType) ||
           mlirIntegerTypeIsSigned(elementType)) {
         // i16
-        return bufferInfo<int16_t>(shapedType);
+        return bufferInfo<int16_t>(shapedType, data, isSplat);
       }
       if (mlirIntegerTypeIsUnsigned(elementType)) {
         // unsigned i16
-        return bufferInfo<uint16_t>(shapedType);
+        return bufferInfo<uint16_t>(shapedType, data, isSplat);
       }
     }
 
@@ -827,20 +860,17 @@ private:
   }
 
   template <typename Type>
-  py::buffer_info bufferInfo(MlirType shapedType,
-                             const char *explicitFormat = nullptr) {
+  static py::buffer_info bufferInfo(MlirType shapedType, void *data,
+                                    bool isSplat,
+                                    const char *explicitFormat = nullptr) {
     intptr_t rank = mlirShapedTypeGetRank(shapedType);
-    // Prepare the data for the buffer_info.
-    // Buffer is configured for read-only access below.
-    Type *data = static_cast<Type *>(
-        const_cast<void *>(mlirDenseElementsAttrGetRawData(*this)));
     // Prepare the shape for the buffer_info.
     SmallVector<intptr_t, 4> shape;
     for (intptr_t i = 0; i < rank; ++i)
       shape.push_back(mlirShapedTypeGetDimSize(shapedType, i));
     // Prepare the strides for the buffer_info.
     SmallVector<intptr_t, 4> strides;
-    if (mlirDenseElementsAttrIsSplat(*this)) {
+    if (isSplat) {
       // Splats are special, only the single value is stored.
       strides.assign(rank, 0);
     } else {
@@ -1026,6 +1056,85 @@ public:
   }
 };
 
+/// Dense resource elements attribute, whose elements are stored in a blob that
+/// may reference the memory of a Python buffer without copying it.
+class PyDenseResourceElementsAttribute
+    : public PyConcreteAttribute<PyDenseResourceElementsAttribute> {
+public:
+  static constexpr IsAFunctionTy isaFunction =
+      mlirAttributeIsADenseResourceElements;
+  static constexpr const char *pyClassName = "DenseResourceElementsAttr";
+  using PyConcreteAttribute::PyConcreteAttribute;
+
+  static PyDenseResourceElementsAttribute
+  getFromBuffer(py::buffer buffer, const std::string &name, const PyType &type,
+                std::optional<size_t> alignment, bool isMutable,
+                DefaultingPyMlirContext contextWrapper) {
+    if (!mlirTypeIsAShaped(type)) {
+      throw py::value_error(
+          "Constructing a DenseResourceElementsAttr requires a ShapedType.");
+    }
+
+    // Do not request any conversion, which would copy the memory that the
+    // blob references.
+    int flags = PyBUF_STRIDES;
+    std::unique_ptr<Py_buffer> view = std::make_unique<Py_buffer>();
+    if (PyObject_GetBuffer(buffer.ptr(), view.get(), flags) != 0)
+      throw py::error_already_set();
+
+    // Release the buffer if the attribute is not created.
+    auto releaseBuffer = llvm::make_scope_exit([&]() {
+      if (view)
+        PyBuffer_Release(view.get());
+    });
+
+    if (!PyBuffer_IsContiguous(view.get(), 'A'))
+      throw py::value_error("Contiguous buffer is required.");
+
+    // Default to the alignment of the elements of the buffer.
+    size_t dataAlignment = alignment.value_or(view->itemsize);
+
+    // The blob owns the view of the buffer, which keeps the buffer alive until
+    // the blob is released, e.g. when the context is destroyed.
+    auto deleter = [](void *userData, const void *data, size_t size,
+                      size_t align) {
+      py::gil_scoped_acquire acquire;
+      Py_buffer *ownedView = static_cast<Py_buffer *>(userData);
+      PyBuffer_Release(ownedView);
+      delete ownedView;
+    };
+    MlirAttribute attr = mlirUnmanagedDenseResourceElementsAttrGet(
+        type, toMlirStringRef(name), view->buf, view->len, dataAlignment,
+        isMutable, deleter, static_cast<void *>(view.get()));
+    view.release();
+    return PyDenseResourceElementsAttribute(contextWrapper->getRef(), attr);
+  }
+
+  py::buffer_info accessBuffer() {
+    intptr_t size;
+    const void *data = mlirDenseResourceElementsAttrGetRawData(*this, &size);
+    if (!data)
+      throw py::value_error("The blob of the resource is not available.");
+    MlirType shapedType = mlirAttributeGetType(*this);
+    py::buffer_info info = PyDenseElementsAttribute::getBufferInfo(
+        shapedType, const_cast<void *>(data), /*isSplat=*/false);
+    if (info.size * info.itemsize != size)
+      throw py::value_error("The size of the blob of the resource does not "
+                            "match its type.");
+    return info;
+  }
+
+  static void bindDerived(ClassTy &c) {
+    c.def_static("get_from_buffer",
+                 PyDenseResourceElementsAttribute::getFromBuffer,
+                 py::arg("array"), py::arg("name"), py::arg("type"),
+                 py::arg("alignment") = py::none(),
+                 py::arg("is_mutable") = false, py::arg("context") = py::none(),
+                 kDenseResourceElementsAttrGetFromBufferDocstring)
+        .def_buffer(&PyDenseResourceElementsAttribute::accessBuffer);
+  }
+};
+
 class PyTypeAttribute : public PyConcreteAttribute<PyTypeAttribute> {
 public:
   static constexpr IsAFunctionTy isaFunction = mlirAttributeIsAType;
@@ -1195,6 +1304,7 @@ void mlir::python::populateIRAttributes(py::module &m) {
   PyBoolAttribute::bind(m);
   PyDenseElementsAttribute::bind(m);
   PyDenseFPElementsAttribute::bind(m);
+  PyDenseResourceElementsAttribute::bind(m);
   PyDenseIntElementsAttribute::bind(m);
   PyGlobals::get().registerTypeCaster(
       mlirDenseIntOrFPElementsAttrGetTypeID(),
@@ -570,6 +570,8 @@ PyMlirContext::~PyMlirContext() {
   py::gil_scoped_acquire acquire;
   getLiveContexts().erase(context.ptr);
   mlirContextDestroy(context);
+  // Only release the thread pool once the context no longer uses it.
+  threadPool = py::object();
 }
 
 py::object PyMlirContext::getCapsule() {
@@ -624,6 +626,11 @@ size_t PyMlirContext::clearLiveOperations() {
 
 size_t PyMlirContext::getLiveModuleCount() { return liveModules.size(); }
 
+void PyMlirContext::setThreadPool(py::object pool) {
+  mlirContextSetThreadPool(get(), pool.cast<PyThreadPool &>().get());
+  threadPool = std::move(pool);
+}
+
 pybind11::object PyMlirContext::contextEnter() {
   return PyThreadContextEntry::pushContext(*this);
 }
@@ -647,23 +654,21 @@ py::object PyMlirContext::attachDiagnosticHandler(py::object callback) {
   // guaranteed to be known to pybind.
   auto handlerCallback =
       +[](MlirDiagnostic diagnostic, void *userData) -> MlirLogicalResult {
+    // Since this can be called from arbitrary C++ contexts, always get the
+    // gil, including for creating the diagnostic object.
+    py::gil_scoped_acquire gil;
     PyDiagnostic *pyDiagnostic = new PyDiagnostic(diagnostic);
     py::object pyDiagnosticObject =
         py::cast(pyDiagnostic, py::return_value_policy::take_ownership);
 
     auto *pyHandler = static_cast<PyDiagnosticHandler *>(userData);
     bool result = false;
-    {
-      // Since this can be called from arbitrary C++ contexts, always get the
-      // gil.
-      py::gil_scoped_acquire gil;
-      try {
-        result = py::cast<bool>(pyHandler->callback(pyDiagnostic));
-      } catch (std::exception &e) {
-        fprintf(stderr, "MLIR Python Diagnostic handler raised exception: %s\n",
-                e.what());
-        pyHandler->hadError = true;
-      }
+    try {
+      result = py::cast<bool>(pyHandler->callback(pyDiagnostic));
+    } catch (std::exception &e) {
+      fprintf(stderr, "MLIR Python Diagnostic handler raised exception: %s\n",
+              e.what());
+      pyHandler->hadError = true;
     }
 
     pyDiagnostic->invalidate();
@@ -695,6 +700,9 @@ MlirLogicalResult PyMlirContext::ErrorCapture::handler(MlirDiagnostic diag,
   if (mlirDiagnosticGetSeverity(diag) != MlirDiagnosticError)
     return mlirLogicalResultFailure();
 
+  // The diagnostic may be emitted while the GIL is released, e.g. by a pass
+  // manager, and capturing it creates Python objects.
+  py::gil_scoped_acquire gil;
   self->errors.emplace_back(PyDiagnostic(diag).getInfo());
   return mlirLogicalResultSuccess();
 }
@@ -1284,7 +1292,8 @@ py::object PyOperation::create(const std::string &name,
   llvm::SmallVector<MlirValue, 4> mlirOperands;
   llvm::SmallVector<MlirType, 4> mlirResults;
   llvm::SmallVector<MlirBlock, 4> mlirSuccessors;
-  llvm::SmallVector<std::pair<std::string, MlirAttribute>, 4> mlirAttributes;
+  llvm::SmallVector<std::pair<llvm::StringRef, MlirAttribute>, 4>
+      mlirAttributes;
 
   // General parameter validation.
   if (regions < 0)
@@ -1314,27 +1323,33 @@ py::object PyOperation::create(const std::string &name,
   if (attributes) {
     mlirAttributes.reserve(attributes->size());
     for (auto &it : *attributes) {
-      std::string key;
-      try {
-        key = it.first.cast<std::string>();
-      } catch (py::cast_error &err) {
+      // The keys reference the UTF-8 representation of the strings, which is
+      // owned by the dictionary, rather than copies.
+      if (!PyUnicode_Check(it.first.ptr())) {
         std::string msg = "Invalid attribute key (not a string) when "
                           "attempting to create the operation \"" +
-                          name + "\" (" + err.what() + ")";
+                          name + "\"";
         throw py::cast_error(msg);
       }
+      Py_ssize_t keySize;
+      const char *keyData = PyUnicode_AsUTF8AndSize(it.first.ptr(), &keySize);
+      if (!keyData)
+        throw py::error_already_set();
+      llvm::StringRef key(keyData, keySize);
       try {
         auto &attribute = it.second.cast<PyAttribute &>();
         // TODO: Verify attribute originates from the same context.
-        mlirAttributes.emplace_back(std::move(key), attribute);
+        mlirAttributes.emplace_back(key, attribute);
       } catch (py::reference_cast_error &) {
         // This exception seems thrown when the value is "None".
         std::string msg =
-            "Found an invalid (`None`?) attribute value for the key \"" + key +
-            "\" when attempting to create the operation \"" + name + "\"";
+            "Found an invalid (`None`?) attribute value for the key \"" +
+            key.str() + "\" when attempting to create the operation \"" +
+            name + "\"";
         throw py::cast_error(msg);
       } catch (py::cast_error &err) {
-        std::string msg = "Invalid attribute value for the key \"" + key +
+        std::string msg = "Invalid attribute value for the key \"" +
+                          key.str() +
                           "\" when attempting to create the operation \"" +
                           name + "\" (" + err.what() + ")";
         throw py::cast_error(msg);
@@ -1441,23 +1456,22 @@ PyOpView::buildGeneric(const py::object &cls, py::list resultTypeList,
                        DefaultingPyLocation location,
                        const py::object &maybeIp) {
   PyMlirContextRef context = location->getContext();
-  // Class level operation construction metadata.
-  std::string name = py::cast<std::string>(cls.attr("OPERATION_NAME"));
+  // Class level operation construction metadata, which is cached per class.
   // Operand and result segment specs are either none, which does no
   // variadic unpacking, or a list of ints with segment sizes, where each
   // element is either a positive number (typically 1 for a scalar) or -1 to
   // indicate that it is derived from the length of the same-indexed operand
   // or result (implying that it is a list at that position).
-  py::object operandSegmentSpecObj = cls.attr("_ODS_OPERAND_SEGMENTS");
-  py::object resultSegmentSpecObj = cls.attr("_ODS_RESULT_SEGMENTS");
+  const PyOpViewClassInfo &classInfo =
+      PyGlobals::get().lookupOpViewClassInfo(cls);
+  const std::string &name = classInfo.name;
 
   std::vector<int32_t> operandSegmentLengths;
   std::vector<int32_t> resultSegmentLengths;
 
   // Validate/determine region count.
-  auto opRegionSpec = py::cast<std::tuple<int, bool>>(cls.attr("_ODS_REGIONS"));
-  int opMinRegionCount = std::get<0>(opRegionSpec);
-  bool opHasNoVariadicRegions = std::get<1>(opRegionSpec);
+  int opMinRegionCount = classInfo.minRegionCount;
+  bool opHasNoVariadicRegions = classInfo.hasNoVariadicRegions;
   if (!regions) {
     regions = opMinRegionCount;
   }
@@ -1479,7 +1493,7 @@ PyOpView::buildGeneric(const py::object &cls, py::list resultTypeList,
   // Unpack results.
   std::vector<PyType *> resultTypes;
   resultTypes.reserve(resultTypeList.size());
-  if (resultSegmentSpecObj.is_none()) {
+  if (!classInfo.resultSegmentSpec) {
     // Non-variadic result unpacking.
     for (const auto &it : llvm::enumerate(resultTypeList)) {
       try {
@@ -1495,7 +1509,7 @@ PyOpView::buildGeneric(const py::object &cls, py::list resultTypeList,
     }
   } else {
     // Sized result unpacking.
-    auto resultSegmentSpec = py::cast<std::vector<int>>(resultSegmentSpecObj);
+    const std::vector<int> &resultSegmentSpec = *classInfo.resultSegmentSpec;
     if (resultSegmentSpec.size() != resultTypeList.size()) {
       throw py::value_error((llvm::Twine("Operation \"") + name +
                              "\" requires " +
@@ -1564,7 +1578,7 @@ PyOpView::buildGeneric(const py::object &cls, py::list resultTypeList,
   // Unpack operands.
   std::vector<PyValue *> operands;
   operands.reserve(operands.size());
-  if (operandSegmentSpecObj.is_none()) {
+  if (!classInfo.operandSegmentSpec) {
     // Non-sized operand unpacking.
     for (const auto &it : llvm::enumerate(operandList)) {
       try {
@@ -1580,7 +1594,7 @@ PyOpView::buildGeneric(const py::object &cls, py::list resultTypeList,
     }
   } else {
     // Sized operand unpacking.
-    auto operandSegmentSpec = py::cast<std::vector<int>>(operandSegmentSpecObj);
+    const std::vector<int> &operandSegmentSpec = *classInfo.operandSegmentSpec;
     if (operandSegmentSpec.size() != operandList.size()) {
       throw py::value_error((llvm::Twine("Operation \"") + name +
                              "\" requires " +
@@ -2390,6 +2404,16 @@ void mlir::python::populateIRCore(py::module &m) {
       .def("__enter__", &PyDiagnosticHandler::contextEnter)
       .def("__exit__", &PyDiagnosticHandler::contextExit);
 
+  //----------------------------------------------------------------------------
+  // Mapping of the LLVM thread pool.
+  //----------------------------------------------------------------------------
+  py::class_<PyThreadPool>(m, "ThreadPool", py::module_local())
+      .def(py::init<unsigned>(), py::arg("num_threads") = 0,
+           "Creates a thread pool running at most `num_threads` threads, or as "
+           "many threads as the hardware supports if zero")
+      .def_property_readonly("max_concurrency",
+                             &PyThreadPool::getMaxConcurrency);
+
   //----------------------------------------------------------------------------
   // Mapping of MlirContext.
   // Note that this is exported as _BaseContext. The containing, Python level
@@ -2458,6 +2482,17 @@ void mlir::python::populateIRCore(py::module &m) {
             mlirContextEnableMultithreading(self.get(), enable);
           },
           py::arg("enable"))
+      .def("set_thread_pool", &PyMlirContext::setThreadPool, py::arg("pool"),
+           "Sets the thread pool of the context, enabling multithreading. The "
+           "pool may be shared by multiple contexts, which then do not spawn "
+           "threads of their own.")
+      .def_property_readonly(
+          "num_threads",
+          [](PyMlirContext &self) {
+            return mlirContextGetNumThreads(self.get());
+          },
+          "Returns the number of threads of the thread pool of the context, "
+          "or 1 if multithreading is disabled.")
       .def(
           "is_registered_operation",
           [](PyMlirContext &self, std::string &name) {
@@ -96,12 +96,14 @@ void PyGlobals::registerDialectImpl(const std::string &dialectNamespace,
 void PyGlobals::registerOperationImpl(const std::string &operationName,
                                       py::object pyClass) {
   py::object &found = operationClassMap[operationName];
-  if (found) {
+  if (found && !found.is_none()) {
     throw std::runtime_error((llvm::Twine("Operation '") + operationName +
                               "' is already registered.")
                                  .str());
   }
   found = std::move(pyClass);
+  // Drop the negative cache entry of a previous lookup.
+  operationClassMapCache.erase(operationName);
 }
 
 std::optional<py::function>
@@ -200,6 +202,7 @@ PyGlobals::lookupOperationClass(llvm::StringRef operationName) {
     }
     // Negative cache.
     operationClassMap[operationName] = py::none();
+    operationClassMapCache[operationName] = py::none();
     return std::nullopt;
   }
 }
@@ -208,4 +211,30 @@ void PyGlobals::clearImportCache() {
   loadedDialectModulesCache.clear();
   operationClassMapCache.clear();
   typeCasterMapCache.clear();
+  opViewClassInfoCache.clear();
+}
+
+const PyOpViewClassInfo &
+PyGlobals::lookupOpViewClassInfo(const py::object &cls) {
+  auto foundIt = opViewClassInfoCache.find(cls.ptr());
+  if (foundIt != opViewClassInfoCache.end())
+    return *foundIt->second.second;
+
+  auto info = std::make_unique<PyOpViewClassInfo>();
+  info->name = py::cast<std::string>(cls.attr("OPERATION_NAME"));
+  py::object operandSegmentSpecObj = cls.attr("_ODS_OPERAND_SEGMENTS");
+  if (!operandSegmentSpecObj.is_none())
+    info->operandSegmentSpec =
+        py::cast<std::vector<int>>(operandSegmentSpecObj);
+  py::object resultSegmentSpecObj = cls.attr("_ODS_RESULT_SEGMENTS");
+  if (!resultSegmentSpecObj.is_none())
+    info->resultSegmentSpec = py::cast<std::vector<int>>(resultSegmentSpecObj);
+  std::tie(info->minRegionCount, info->hasNoVariadicRegions) =
+      py::cast<std::tuple<int, bool>>(cls.attr("_ODS_REGIONS"));
+
+  // Reading the class attributes may have re-entered and populated the entry.
+  auto &entry = opViewClassInfoCache[cls.ptr()];
+  if (!entry.second)
+    entry = std::make_pair(cls, std::move(info));
+  return *entry.second;
 }
@@ -155,6 +155,27 @@ private:
   FrameKind frameKind;
 };
 
+/// Wrapper around an LLVM thread pool, which may be shared by multiple
+/// contexts for their thread counts not to multiply.
+class PyThreadPool {
+public:
+  PyThreadPool(unsigned numThreads)
+      : threadPool(mlirLlvmThreadPoolCreate(numThreads)) {}
+  PyThreadPool(const PyThreadPool &) = delete;
+  PyThreadPool(PyThreadPool &&) = delete;
+  ~PyThreadPool() { mlirLlvmThreadPoolDestroy(threadPool); }
+
+  MlirLlvmThreadPool get() { return threadPool; }
+
+  /// Returns the maximum number of threads of the pool.
+  unsigned getMaxConcurrency() {
+    return mlirLlvmThreadPoolGetThreadCount(threadPool);
+  }
+
+private:
+  MlirLlvmThreadPool threadPool;
+};
+
 /// Wrapper around MlirContext.
 using PyMlirContextRef = PyObjectRef<PyMlirContext>;
 class PyMlirContext {
@@ -213,6 +234,10 @@ public:
   /// Used for testing.
   size_t getLiveModuleCount();
 
+  /// Sets the thread pool of the context, which must be a PyThreadPool. The
+  /// context keeps a reference to the pool for as long as it uses it.
+  void setThreadPool(pybind11::object pool);
+
   /// Enter and exit the context manager.
   pybind11::object contextEnter();
   void contextExit(const pybind11::object &excType,
@@ -257,6 +282,9 @@ private:
 
   bool emitErrorDiagnostics = false;
 
+  // The PyThreadPool set on the context, if any.
+  pybind11::object threadPool;
+
   MlirContext context;
   friend class PyModule;
   friend class PyOperation;
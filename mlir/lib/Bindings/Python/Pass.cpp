@@ -118,15 +118,26 @@ void mlir::python::populatePassManagerSubmodule(py::module &m) {
           "run",
           [](PyPassManager &passManager, PyOperationBase &op) {
             PyMlirContext::ErrorCapture errors(op.getOperation().getContext());
-            MlirLogicalResult status = mlirPassManagerRunOnOp(
-                passManager.get(), op.getOperation().get());
+            MlirOperation operation = op.getOperation().get();
+            MlirLogicalResult status;
+            {
+              // Let the other Python threads run, e.g. to compile other
+              // modules, while the pipeline runs. The diagnostic handlers
+              // reacquire the GIL.
+              py::gil_scoped_release release;
+              status = mlirPassManagerRunOnOp(passManager.get(), operation);
+            }
             if (mlirLogicalResultIsFailure(status))
               throw MLIRError("Failure while executing pass pipeline",
                               errors.take());
           },
           py::arg("operation"),
           "Run the pass manager on the provided operation, raising an "
-          "MLIRError on failure.")
+          "MLIRError on failure. The GIL is released while the passes run, so "
+          "that pass managers may run concurrently from multiple threads, "
+          "provided that each runs on its own operation and that the IR it "
+          "runs on is not accessed meanwhile. A pass manager may only run on "
+          "one thread at a time.")
       .def(
           "__str__",
           [](PyPassManager &self) {
@@ -15,6 +15,7 @@
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/OpImplementation.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/IR/Verifier.h"
 #include "mlir/IR/Visitors.h"
 #include "mlir/Support/LLVM.h"
@@ -25,13 +26,16 @@
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/Endian.h"
+#include "llvm/Support/MemAlloc.h"
 #include "llvm/Support/MemoryBufferRef.h"
 #include "llvm/Support/SaveAndRestore.h"
 #include "llvm/Support/SourceMgr.h"
 #include <cstddef>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <optional>
 
@@ -90,6 +94,18 @@ static bool isSectionOptional(bytecode::Section::ID sectionID, int version) {
 //===----------------------------------------------------------------------===//
 
 namespace {
+/// The header of a compressed top-level section.
+struct CompressedSectionInfo {
+  /// The format of the compressed data.
+  bytecode::SectionCompression::Format format;
+  /// The width of the elements of the byte-shuffle filter applied before
+  /// compression, or 0 if it wasn't applied.
+  uint64_t shuffleWidth;
+  /// The alignment and the size of the decompressed data.
+  uint64_t alignment;
+  uint64_t size;
+};
+
 class EncodingReader {
 public:
   explicit EncodingReader(ArrayRef<uint8_t> contents, Location fileLoc)
@@ -259,20 +275,24 @@ public:
   }
 
   /// Parse a section header, placing the kind of section in `sectionID` and the
-  /// contents of the section in `sectionData`.
-  LogicalResult parseSection(bytecode::Section::ID &sectionID,
-                             ArrayRef<uint8_t> &sectionData) {
-    uint8_t sectionIDAndHasAlignment;
+  /// contents of the section in `sectionData`. If `compression` is provided,
+  /// the section may be compressed, in which case the header of its compressed
+  /// data is placed in `compression` and the compressed data in `sectionData`.
+  LogicalResult
+  parseSection(bytecode::Section::ID &sectionID, ArrayRef<uint8_t> &sectionData,
+               std::optional<CompressedSectionInfo> *compression = nullptr) {
+    uint8_t sectionIDAndFlags;
     uint64_t length;
-    if (failed(parseByte(sectionIDAndHasAlignment)) ||
-        failed(parseVarInt(length)))
+    if (failed(parseByte(sectionIDAndFlags)) || failed(parseVarInt(length)))
       return failure();
 
-    // Extract the section ID and whether the section is aligned. The high bit
-    // of the ID is the alignment flag.
-    sectionID = static_cast<bytecode::Section::ID>(sectionIDAndHasAlignment &
-                                                   0b01111111);
-    bool hasAlignment = sectionIDAndHasAlignment & 0b10000000;
+    // Extract the section ID and whether the section is aligned or compressed,
+    // which are flagged by the high bits of the ID.
+    sectionID = static_cast<bytecode::Section::ID>(
+        sectionIDAndFlags & ~(bytecode::Section::kHasAlignment |
+                              bytecode::Section::kIsCompressed));
+    bool hasAlignment = sectionIDAndFlags & bytecode::Section::kHasAlignment;
+    bool isCompressed = sectionIDAndFlags & bytecode::Section::kIsCompressed;
 
     // Check that the section is actually valid before trying to process its
     // data.
@@ -287,7 +307,35 @@ public:
     }
 
     // Parse the actual section data.
-    return parseBytes(static_cast<size_t>(length), sectionData);
+    if (failed(parseBytes(static_cast<size_t>(length), sectionData)))
+      return failure();
+    if (compression)
+      compression->reset();
+    if (!isCompressed)
+      return success();
+    if (!compression)
+      return emitError("unexpected compressed section: ",
+                       unsigned(sectionID));
+
+    // Parse the header of the compressed data.
+    EncodingReader headerReader(sectionData, fileLoc);
+    uint8_t format;
+    CompressedSectionInfo info;
+    if (failed(headerReader.parseByte(format)) ||
+        failed(headerReader.parseVarInt(info.shuffleWidth)) ||
+        failed(headerReader.parseVarInt(info.alignment)) ||
+        failed(headerReader.parseVarInt(info.size)))
+      return failure();
+    if (format != bytecode::SectionCompression::kZlib &&
+        format != bytecode::SectionCompression::kZstd)
+      return emitError("unknown section compression format: ",
+                       unsigned(format));
+    if (!llvm::isPowerOf2_64(info.alignment))
+      return emitError("expected alignment to be a power-of-two");
+    info.format = static_cast<bytecode::SectionCompression::Format>(format);
+    *compression = info;
+    sectionData = sectionData.take_back(headerReader.size());
+    return success();
   }
 
   Location getLoc() const { return fileLoc; }
@@ -357,6 +405,106 @@ static LogicalResult parseEntry(EncodingReader &reader, RangeT &entries,
   return resolveEntry(reader, entries, entryIdx, entry, entryStr);
 }
 
+//===----------------------------------------------------------------------===//
+// DecompressedSection
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// This class holds the decompressed data of a compressed top-level section.
+/// The section is decompressed once on the first request of its data, which
+/// may happen on any thread, into a buffer aligned as the section requires.
+class DecompressedSection {
+public:
+  DecompressedSection(ArrayRef<uint8_t> compressedData,
+                      const CompressedSectionInfo &info)
+      : compressedData(compressedData), info(info) {}
+  DecompressedSection(const DecompressedSection &) = delete;
+  DecompressedSection &operator=(const DecompressedSection &) = delete;
+  ~DecompressedSection() {
+    if (data)
+      llvm::deallocate_buffer(data, info.size, info.alignment);
+  }
+
+  /// Return the decompressed data of the section, decompressing it if it
+  /// wasn't already. Returns failure if the section could not be
+  /// decompressed, in which case `getError` returns the reason.
+  FailureOr<ArrayRef<uint8_t>> getData() {
+    std::call_once(decompressed, [this] { decompress(); });
+    if (!error.empty())
+      return failure();
+    return ArrayRef<uint8_t>(data, info.size);
+  }
+
+  /// Return the reason the section could not be decompressed.
+  StringRef getError() const { return error; }
+
+  /// Return the size of the decompressed data.
+  uint64_t getSize() const { return info.size; }
+
+private:
+  /// Decompress the section into `data`, or set `error` on failure.
+  void decompress();
+
+  /// The compressed data of the section, which is only referenced until it is
+  /// decompressed.
+  ArrayRef<uint8_t> compressedData;
+  CompressedSectionInfo info;
+
+  /// The decompressed data of the section, of `info.size` bytes.
+  uint8_t *data = nullptr;
+  std::string error;
+  std::once_flag decompressed;
+};
+} // namespace
+
+void DecompressedSection::decompress() {
+  bool isZstd = info.format == bytecode::SectionCompression::kZstd;
+  if (isZstd ? !llvm::compression::zstd::isAvailable()
+             : !llvm::compression::zlib::isAvailable()) {
+    error = (isZstd ? "zstd" : "zlib") +
+            std::string(" compression is not available in this build");
+    return;
+  }
+
+  // The shuffled data is decompressed into a temporary buffer, from which the
+  // filter is reverted.
+  SmallVector<uint8_t> shuffledData;
+  uint8_t *buffer = static_cast<uint8_t *>(
+      llvm::allocate_buffer(info.size, info.alignment));
+  uint8_t *decompressedData = buffer;
+  if (info.shuffleWidth > 1) {
+    shuffledData.resize(info.size);
+    decompressedData = shuffledData.data();
+  }
+
+  size_t size = info.size;
+  llvm::Error err =
+      isZstd ? llvm::compression::zstd::decompress(compressedData,
+                                                   decompressedData, size)
+             : llvm::compression::zlib::decompress(compressedData,
+                                                   decompressedData, size);
+  if (err || size != info.size) {
+    error = err ? llvm::toString(std::move(err))
+                : "unexpected size of the decompressed data";
+    llvm::deallocate_buffer(buffer, info.size, info.alignment);
+    return;
+  }
+
+  // Revert the byte-shuffle filter, the trailing bytes that don't form a
+  // complete element were left in place.
+  if (info.shuffleWidth > 1) {
+    size_t width = info.shuffleWidth;
+    size_t numElements = size / width;
+    for (size_t i = 0; i < numElements; ++i)
+      for (size_t j = 0; j < width; ++j)
+        buffer[i * width + j] = shuffledData[j * numElements + i];
+    std::copy(shuffledData.begin() + numElements * width, shuffledData.end(),
+              buffer + numElements * width);
+  }
+  data = buffer;
+  compressedData = {};
+}
+
 //===----------------------------------------------------------------------===//
 // StringSectionReader
 //===----------------------------------------------------------------------===//
@@ -535,7 +683,8 @@ public:
              MutableArrayRef<BytecodeDialect> dialects,
              StringSectionReader &stringReader, ArrayRef<uint8_t> sectionData,
              ArrayRef<uint8_t> offsetSectionData, DialectReader &dialectReader,
-             const std::shared_ptr<llvm::SourceMgr> &bufferOwnerRef);
+             const std::shared_ptr<llvm::SourceMgr> &bufferOwnerRef,
+             const std::shared_ptr<DecompressedSection> &decompressedSection);
 
   /// Parse a dialect resource handle from the resource section.
   LogicalResult parseResourceHandle(EncodingReader &reader,
@@ -551,16 +700,24 @@ private:
 
 class ParsedResourceEntry : public AsmParsedResourceEntry {
 public:
-  ParsedResourceEntry(StringRef key, AsmResourceEntryKind kind,
-                      EncodingReader &reader, StringSectionReader &stringReader,
-                      const std::shared_ptr<llvm::SourceMgr> &bufferOwnerRef)
-      : key(key), kind(kind), reader(reader), stringReader(stringReader),
-        bufferOwnerRef(bufferOwnerRef) {}
+  /// Construct the entry of the `size` bytes at `offset` in the resource
+  /// section. The data of the section is `sectionData`, unless the section is
+  /// compressed, in which case it is decompressed from `decompressedSection`
+  /// when the entry is parsed.
+  ParsedResourceEntry(
+      StringRef key, AsmResourceEntryKind kind, Location fileLoc,
+      ArrayRef<uint8_t> sectionData,
+      const std::shared_ptr<DecompressedSection> &decompressedSection,
+      uint64_t offset, uint64_t size, StringSectionReader &stringReader,
+      const std::shared_ptr<llvm::SourceMgr> &bufferOwnerRef)
+      : key(key), kind(kind), fileLoc(fileLoc), sectionData(sectionData),
+        decompressedSection(decompressedSection), offset(offset), size(size),
+        stringReader(stringReader), bufferOwnerRef(bufferOwnerRef) {}
   ~ParsedResourceEntry() override = default;
 
   StringRef getKey() const final { return key; }
 
-  InFlightDiagnostic emitError() const final { return reader.emitError(); }
+  InFlightDiagnostic emitError() const final { return ::emitError(fileLoc); }
 
   AsmResourceEntryKind getKind() const final { return kind; }
 
@@ -570,7 +727,8 @@ public:
                          << toString(kind) << " entry instead";
 
     bool value;
-    if (failed(reader.parseByte(value)))
+    FailureOr<EncodingReader *> reader = getReader();
+    if (failed(reader) || failed((*reader)->parseByte(value)))
       return failure();
     return value;
   }
@@ -580,7 +738,8 @@ public:
                          << toString(kind) << " entry instead";
 
     StringRef string;
-    if (failed(stringReader.parseString(reader, string)))
+    FailureOr<EncodingReader *> reader = getReader();
+    if (failed(reader) || failed(stringReader.parseString(**reader, string)))
       return failure();
     return string.str();
   }
@@ -591,9 +750,16 @@ public:
       return emitError() << "expected a blob resource entry, but found a "
                          << toString(kind) << " entry instead";
 
+    // The blobs of a compressed section point into the decompressed data.
+    FailureOr<EncodingReader *> reader = getReader();
+    if (failed(reader))
+      return failure();
+    if (decompressedSection)
+      return parseDecompressedBlob(**reader, decompressedSection);
+
     ArrayRef<uint8_t> data;
     uint64_t alignment;
-    if (failed(reader.parseBlobAndAlignment(data, alignment)))
+    if (failed((*reader)->parseBlobAndAlignment(data, alignment)))
       return failure();
 
     // If we have an extendable reference to the buffer owner, we don't need to
@@ -620,23 +786,96 @@ public:
     return blob;
   }
 
+  /// The blobs of a compressed section are parsed lazily, such that the
+  /// section is only decompressed when one of them is first used. This
+  /// requires the compressed data to outlive the reader, unless the section
+  /// was already decompressed.
+  LazyBlobFn parseAsLazyBlob() const final {
+    if (kind != AsmResourceEntryKind::Blob || !decompressedSection)
+      return nullptr;
+    return [decompressedSection = decompressedSection,
+            bufferOwnerRef = bufferOwnerRef, fileLoc = fileLoc, offset = offset,
+            size = size, key = key.str()]() -> FailureOr<AsmResourceBlob> {
+      FailureOr<ArrayRef<uint8_t>> data = decompressedSection->getData();
+      if (failed(data))
+        return ::emitError(fileLoc)
+               << "failed to decompress the resource section: "
+               << decompressedSection->getError();
+      EncodingReader reader(data->slice(offset, size), fileLoc);
+      FailureOr<AsmResourceBlob> blob =
+          parseDecompressedBlob(reader, decompressedSection);
+      if (succeeded(blob) && !reader.empty())
+        return reader.emitError("unexpected trailing bytes in resource entry '",
+                                key, "'");
+      return blob;
+    };
+  }
+
+  /// Returns true if the entry was parsed, but not in its entirety.
+  bool hasTrailingBytes() const { return reader && !reader->empty(); }
+
 private:
+  /// Return the reader of the data of the entry, decompressing the resource
+  /// section if necessary.
+  FailureOr<EncodingReader *> getReader() const {
+    if (reader)
+      return &*reader;
+    ArrayRef<uint8_t> data = sectionData;
+    if (decompressedSection) {
+      FailureOr<ArrayRef<uint8_t>> decompressedData =
+          decompressedSection->getData();
+      if (failed(decompressedData))
+        return emitError() << "failed to decompress the resource section: "
+                           << decompressedSection->getError();
+      data = *decompressedData;
+    }
+    return &reader.emplace(data.slice(offset, size), fileLoc);
+  }
+
+  /// Parse a blob from the decompressed data of a section, which is referenced
+  /// by the blob and kept alive with it.
+  static FailureOr<AsmResourceBlob> parseDecompressedBlob(
+      EncodingReader &reader,
+      std::shared_ptr<DecompressedSection> decompressedSection) {
+    ArrayRef<uint8_t> data;
+    uint64_t alignment;
+    if (failed(reader.parseBlobAndAlignment(data, alignment)))
+      return failure();
+    ArrayRef<char> charData(reinterpret_cast<const char *>(data.data()),
+                            data.size());
+    return UnmanagedAsmResourceBlob::allocateWithAlign(
+        charData, alignment,
+        [decompressedSection = std::move(decompressedSection)](
+            void *, size_t, size_t) {});
+  }
+
   StringRef key;
   AsmResourceEntryKind kind;
-  EncodingReader &reader;
+  Location fileLoc;
+  ArrayRef<uint8_t> sectionData;
+  const std::shared_ptr<DecompressedSection> &decompressedSection;
+  uint64_t offset, size;
   StringSectionReader &stringReader;
   const std::shared_ptr<llvm::SourceMgr> &bufferOwnerRef;
+
+  /// The reader of the data of the entry, created when the entry is parsed.
+  mutable std::optional<EncodingReader> reader;
 };
 } // namespace
 
+/// Parse a group of resources from the offset section. `sectionOffset` is the
+/// offset of the group in the resource section, of `sectionSize` bytes, and is
+/// advanced past the group.
 template <typename T>
-static LogicalResult
-parseResourceGroup(Location fileLoc, bool allowEmpty,
-                   EncodingReader &offsetReader, EncodingReader &resourceReader,
-                   StringSectionReader &stringReader, T *handler,
-                   const std::shared_ptr<llvm::SourceMgr> &bufferOwnerRef,
-                   function_ref<StringRef(StringRef)> remapKey = {},
-                   function_ref<LogicalResult(StringRef)> processKeyFn = {}) {
+static LogicalResult parseResourceGroup(
+    Location fileLoc, bool allowEmpty, EncodingReader &offsetReader,
+    ArrayRef<uint8_t> sectionData,
+    const std::shared_ptr<DecompressedSection> &decompressedSection,
+    uint64_t sectionSize, uint64_t &sectionOffset,
+    StringSectionReader &stringReader, T *handler,
+    const std::shared_ptr<llvm::SourceMgr> &bufferOwnerRef,
+    function_ref<StringRef(StringRef)> remapKey = {},
+    function_ref<LogicalResult(StringRef)> processKeyFn = {}) {
   uint64_t numResources;
   if (failed(offsetReader.parseVarInt(numResources)))
     return failure();
@@ -644,13 +883,17 @@ parseResourceGroup(Location fileLoc, bool allowEmpty,
   for (uint64_t i = 0; i < numResources; ++i) {
     StringRef key;
     AsmResourceEntryKind kind;
-    uint64_t resourceOffset;
-    ArrayRef<uint8_t> data;
+    uint64_t resourceSize;
     if (failed(stringReader.parseString(offsetReader, key)) ||
-        failed(offsetReader.parseVarInt(resourceOffset)) ||
-        failed(offsetReader.parseByte(kind)) ||
-        failed(resourceReader.parseBytes(resourceOffset, data)))
+        failed(offsetReader.parseVarInt(resourceSize)) ||
+        failed(offsetReader.parseByte(kind)))
       return failure();
+    if (resourceSize > sectionSize - sectionOffset)
+      return emitError(fileLoc, "attempting to parse ", resourceSize,
+                       " bytes when only ", sectionSize - sectionOffset,
+                       " remain");
+    uint64_t resourceOffset = sectionOffset;
+    sectionOffset += resourceSize;
 
     // Process the resource key.
     if ((processKeyFn && failed(processKeyFn(key))))
@@ -658,7 +901,7 @@ parseResourceGroup(Location fileLoc, bool allowEmpty,
 
     // If the resource data is empty and we allow it, don't error out when
     // parsing below, just skip it.
-    if (allowEmpty && data.empty())
+    if (allowEmpty && resourceSize == 0)
       continue;
 
     // Ignore the entry if we don't have a valid handler.
@@ -666,15 +909,15 @@ parseResourceGroup(Location fileLoc, bool allowEmpty,
       continue;
 
     // Otherwise, parse the resource value.
-    EncodingReader entryReader(data, fileLoc);
     key = remapKey(key);
-    ParsedResourceEntry entry(key, kind, entryReader, stringReader,
-                              bufferOwnerRef);
+    ParsedResourceEntry entry(key, kind, fileLoc, sectionData,
+                              decompressedSection, resourceOffset,
+                              resourceSize, stringReader, bufferOwnerRef);
     if (failed(handler->parseResource(entry)))
       return failure();
-    if (!entryReader.empty()) {
-      return entryReader.emitError(
-          "unexpected trailing bytes in resource entry '", key, "'");
+    if (entry.hasTrailingBytes()) {
+      return emitError(fileLoc, "unexpected trailing bytes in resource entry '",
+                       key, "'");
     }
   }
   return success();
@@ -685,10 +928,18 @@ LogicalResult ResourceSectionReader::initialize(
     MutableArrayRef<BytecodeDialect> dialects,
     StringSectionReader &stringReader, ArrayRef<uint8_t> sectionData,
     ArrayRef<uint8_t> offsetSectionData, DialectReader &dialectReader,
-    const std::shared_ptr<llvm::SourceMgr> &bufferOwnerRef) {
+    const std::shared_ptr<llvm::SourceMgr> &bufferOwnerRef,
+    const std::shared_ptr<DecompressedSection> &decompressedSection) {
   EncodingReader resourceReader(sectionData, fileLoc);
   EncodingReader offsetReader(offsetSectionData, fileLoc);
 
+  // The entries are parsed from their offsets in the resource section, which
+  // may be compressed and only decompressed on demand.
+  uint64_t sectionOffset = 0;
+  uint64_t sectionSize = decompressedSection
+                             ? decompressedSection->getSize()
+                             : static_cast<uint64_t>(sectionData.size());
+
   // Read the number of external resource providers.
   uint64_t numExternalResourceGroups;
   if (failed(offsetReader.parseVarInt(numExternalResourceGroups)))
@@ -705,9 +956,10 @@ LogicalResult ResourceSectionReader::initialize(
       return it->second;
     };
 
-    return parseResourceGroup(fileLoc, allowEmpty, offsetReader, resourceReader,
-                              stringReader, handler, bufferOwnerRef, resolveKey,
-                              keyFn);
+    return parseResourceGroup(
+        fileLoc, allowEmpty, offsetReader, sectionData, decompressedSection,
+        sectionSize, sectionOffset, stringReader, handler, bufferOwnerRef,
+        resolveKey, keyFn);
   };
 
   // Read the external resources from the bytecode.
@@ -812,6 +1064,19 @@ public:
   }
   Type resolveType(size_t index) { return resolveEntry(types, index, "Type"); }
 
+  /// Resolve all of the attribute and type entries. After this, the reader
+  /// only serves already resolved entries and may be used from multiple
+  /// threads.
+  LogicalResult resolveAll() {
+    for (size_t i = 0, e = types.size(); i != e; ++i)
+      if (!resolveType(i))
+        return failure();
+    for (size_t i = 0, e = attributes.size(); i != e; ++i)
+      if (!resolveAttribute(i))
+        return failure();
+    return success();
+  }
+
   /// Parse a reference to an attribute or type using the given reader.
   LogicalResult parseAttribute(EncodingReader &reader, Attribute &result) {
     uint64_t attrIdx;
@@ -820,6 +1085,16 @@ public:
     result = resolveAttribute(attrIdx);
     return success(!!result);
   }
+  /// Skip over a reference to an attribute using the given reader, without
+  /// resolving the attribute.
+  LogicalResult skipAttribute(EncodingReader &reader) {
+    uint64_t attrIdx;
+    if (failed(reader.parseVarInt(attrIdx)))
+      return failure();
+    if (attrIdx >= attributes.size())
+      return reader.emitError("invalid Attribute index: ", attrIdx);
+    return success();
+  }
   LogicalResult parseOptionalAttribute(EncodingReader &reader,
                                        Attribute &result) {
     uint64_t attrIdx;
@@ -1242,6 +1517,7 @@ LogicalResult AttrTypeReader::parseCustomEntry(Entry<T> &entry,
 /// This class is used to read a bytecode buffer and translate it into MLIR.
 class mlir::BytecodeReader::Impl {
   struct RegionReadState;
+  struct IRParseState;
   using LazyLoadableOpsInfo =
       std::list<std::pair<Operation *, RegionReadState>>;
   using LazyLoadableOpsMap =
@@ -1316,24 +1592,41 @@ private:
   LogicalResult materialize(LazyLoadableOpsMap::iterator it) {
     assert(it != lazyLoadableOpsMap.end() &&
            "materialize called on non-materializable op");
-    valueScopes.emplace_back();
-    std::vector<RegionReadState> regionStack;
-    regionStack.push_back(std::move(it->getSecond()->second));
+    RegionReadState readState = std::move(it->getSecond()->second);
     lazyLoadableOps.erase(it->getSecond());
     lazyLoadableOpsMap.erase(it);
+    return materialize(mainState, std::move(readState));
+  }
+
+  /// Parse the regions described by `readState`, using the given parse state.
+  LogicalResult materialize(IRParseState &state, RegionReadState &&readState) {
+    state.valueScopes.emplace_back();
+    std::vector<RegionReadState> regionStack;
+    regionStack.push_back(std::move(readState));
 
     while (!regionStack.empty())
-      if (failed(parseRegions(regionStack, regionStack.back())))
+      if (failed(parseRegions(state, regionStack, regionStack.back())))
         return failure();
     return success();
   }
 
+  /// Materialize all of the deferred operations in parallel, using a separate
+  /// parse state for each of them.
+  LogicalResult materializeAllInParallel();
+
   /// Return the context for this config.
   MLIRContext *getContext() const { return config.getContext(); }
 
   /// Parse the bytecode version.
   LogicalResult parseVersion(EncodingReader &reader);
 
+  /// Decompress the compressed top-level sections, replacing their data in
+  /// `sectionDatas`. The resource section is only decompressed on demand if
+  /// the input buffer outlives the reader.
+  LogicalResult decompressSections(
+      MutableArrayRef<std::optional<ArrayRef<uint8_t>>> sectionDatas,
+      ArrayRef<std::optional<CompressedSectionInfo>> sectionCompressions);
+
   //===--------------------------------------------------------------------===//
   // Dialect Section
 
@@ -1345,6 +1638,11 @@ private:
   FailureOr<OperationName> parseOpName(EncodingReader &reader,
                                        std::optional<bool> &wasRegistered);
 
+  /// Load the dialect of the given operation name entry and resolve the
+  /// operation name.
+  LogicalResult resolveOpName(EncodingReader &reader,
+                              BytecodeOperationName &opName);
+
   //===--------------------------------------------------------------------===//
   // Attribute/Type Section
 
@@ -1357,6 +1655,16 @@ private:
     return attrTypeReader.parseType(reader, result);
   }
 
+  /// Parse the location of an operation or block argument, which is replaced
+  /// by an unknown location without being resolved if the config drops the
+  /// locations.
+  LogicalResult parseLocation(EncodingReader &reader, LocationAttr &result) {
+    if (!config.shouldDropLocations())
+      return parseAttribute(reader, result);
+    result = UnknownLoc::get(getContext());
+    return attrTypeReader.skipAttribute(reader);
+  }
+
   //===--------------------------------------------------------------------===//
   // Resource Section
 
@@ -1404,29 +1712,33 @@ private:
   };
 
   LogicalResult parseIRSection(ArrayRef<uint8_t> sectionData, Block *block);
-  LogicalResult parseRegions(std::vector<RegionReadState> &regionStack,
+  LogicalResult parseRegions(IRParseState &state,
+                             std::vector<RegionReadState> &regionStack,
                              RegionReadState &readState);
-  FailureOr<Operation *> parseOpWithoutRegions(EncodingReader &reader,
+  FailureOr<Operation *> parseOpWithoutRegions(IRParseState &state,
+                                               EncodingReader &reader,
                                                RegionReadState &readState,
                                                bool &isIsolatedFromAbove);
 
-  LogicalResult parseRegion(RegionReadState &readState);
-  LogicalResult parseBlockHeader(EncodingReader &reader,
+  LogicalResult parseRegion(IRParseState &state, RegionReadState &readState);
+  LogicalResult parseBlockHeader(IRParseState &state, EncodingReader &reader,
                                  RegionReadState &readState);
-  LogicalResult parseBlockArguments(EncodingReader &reader, Block *block);
+  LogicalResult parseBlockArguments(IRParseState &state,
+                                    EncodingReader &reader, Block *block);
 
   //===--------------------------------------------------------------------===//
   // Value Processing
 
   /// Parse an operand reference using the given reader. Returns nullptr in the
   /// case of failure.
-  Value parseOperand(EncodingReader &reader);
+  Value parseOperand(IRParseState &state, EncodingReader &reader);
 
   /// Sequentially define the given value range.
-  LogicalResult defineValues(EncodingReader &reader, ValueRange values);
+  LogicalResult defineValues(IRParseState &state, EncodingReader &reader,
+                             ValueRange values);
 
   /// Create a value to use for a forward reference.
-  Value createForwardRef();
+  Value createForwardRef(IRParseState &state);
 
   //===--------------------------------------------------------------------===//
   // Use-list order helpers
@@ -1492,6 +1804,26 @@ private:
     SmallVector<unsigned, 4> nextValueIDs;
   };
 
+  /// This struct contains the state used to parse a tree of regions. Isolated
+  /// regions are self-contained, which allows for parsing them in parallel
+  /// with a separate state each.
+  struct IRParseState {
+    /// The current set of available IR value scopes.
+    std::vector<ValueScope> valueScopes;
+
+    /// Worklist of values with custom use-list orders to process before the
+    /// end of the parsing.
+    DenseMap<void *, UseListOrderStorage> valueToUseListMap;
+
+    /// A block containing the set of operations defined to create forward
+    /// references.
+    Block forwardRefOps;
+
+    /// A block containing previously created, and no longer used, forward
+    /// reference operations.
+    Block openForwardRefOps;
+  };
+
   /// The configuration of the parser.
   const ParserConfig &config;
 
@@ -1524,30 +1856,23 @@ private:
   /// The reader used to process resources within the bytecode.
   ResourceSectionReader resourceReader;
 
-  /// Worklist of values with custom use-list orders to process before the end
-  /// of the parsing.
-  DenseMap<void *, UseListOrderStorage> valueToUseListMap;
-
   /// The table of strings referenced within the bytecode file.
   StringSectionReader stringReader;
 
   /// The table of properties referenced by the operation in the bytecode file.
   PropertiesSectionReader propertiesReader;
 
-  /// The current set of available IR value scopes.
-  std::vector<ValueScope> valueScopes;
+  /// The parse state used for the regions parsed on the main thread.
+  IRParseState mainState;
+
+  /// The parse states used for the regions parsed in parallel. They are kept
+  /// alive until the reader is destroyed, together with `mainState`, as the
+  /// parsed IR may still refer to their forward references on failure.
+  std::vector<std::unique_ptr<IRParseState>> parallelStates;
 
   /// The global pre-order operation ordering.
   DenseMap<Operation *, unsigned> operationIDs;
 
-  /// A block containing the set of operations defined to create forward
-  /// references.
-  Block forwardRefOps;
-
-  /// A block containing previously created, and no longer used, forward
-  /// reference operations.
-  Block openForwardRefOps;
-
   /// An operation state used when instantiating forward references.
   OperationState forwardRefOpState;
 
@@ -1557,6 +1882,12 @@ private:
   /// The optional owning source manager, which when present may be used to
   /// extend the lifetime of the input buffer.
   const std::shared_ptr<llvm::SourceMgr> &bufferOwnerRef;
+
+  /// The decompressed top-level sections, which are kept alive until the
+  /// reader is destroyed as the lazily loaded IR is parsed from them. The
+  /// resource section is also kept alive by the blobs referencing it.
+  SmallVector<std::shared_ptr<DecompressedSection>> decompressedSections;
+  std::shared_ptr<DecompressedSection> decompressedResourceSection;
 };
 
 LogicalResult BytecodeReader::Impl::read(
@@ -1585,12 +1916,19 @@ LogicalResult BytecodeReader::Impl::read(
   // Parse the raw data for each of the top-level sections of the bytecode.
   std::optional<ArrayRef<uint8_t>>
       sectionDatas[bytecode::Section::kNumSections];
+  std::optional<CompressedSectionInfo>
+      sectionCompressions[bytecode::Section::kNumSections];
   while (!reader.empty()) {
     // Read the next section from the bytecode.
     bytecode::Section::ID sectionID;
     ArrayRef<uint8_t> sectionData;
-    if (failed(reader.parseSection(sectionID, sectionData)))
+    std::optional<CompressedSectionInfo> compression;
+    if (failed(reader.parseSection(sectionID, sectionData, &compression)))
       return failure();
+    if (compression && version < bytecode::kSectionCompression) {
+      return reader.emitError("unexpected compressed section in bytecode <",
+                              int(bytecode::kSectionCompression));
+    }
 
     // Check for duplicate sections, we only expect one instance of each.
     if (sectionDatas[sectionID]) {
@@ -1598,6 +1936,7 @@ LogicalResult BytecodeReader::Impl::read(
                               ::toString(sectionID));
     }
     sectionDatas[sectionID] = sectionData;
+    sectionCompressions[sectionID] = compression;
   }
   // Check that all of the required sections were found.
   for (int i = 0; i < bytecode::Section::kNumSections; ++i) {
@@ -1607,6 +1946,8 @@ LogicalResult BytecodeReader::Impl::read(
                               ::toString(sectionID));
     }
   }
+  if (failed(decompressSections(sectionDatas, sectionCompressions)))
+    return failure();
 
   // Process the string section first.
   if (failed(stringReader.initialize(
@@ -1639,6 +1980,43 @@ LogicalResult BytecodeReader::Impl::read(
   return parseIRSection(*sectionDatas[bytecode::Section::kIR], block);
 }
 
+LogicalResult BytecodeReader::Impl::decompressSections(
+    MutableArrayRef<std::optional<ArrayRef<uint8_t>>> sectionDatas,
+    ArrayRef<std::optional<CompressedSectionInfo>> sectionCompressions) {
+  SmallVector<std::pair<bytecode::Section::ID, DecompressedSection *>>
+      eagerSections;
+  for (unsigned i = 0, e = sectionCompressions.size(); i < e; ++i) {
+    if (!sectionCompressions[i])
+      continue;
+    auto sectionID = static_cast<bytecode::Section::ID>(i);
+    auto section = std::make_shared<DecompressedSection>(
+        *sectionDatas[i], *sectionCompressions[i]);
+    decompressedSections.push_back(section);
+
+    // The resource section is parsed from its decompressed data, which the
+    // blobs reference.
+    if (sectionID == bytecode::Section::kResource) {
+      decompressedResourceSection = section;
+      if (bufferOwnerRef)
+        continue;
+    }
+    eagerSections.emplace_back(sectionID, section.get());
+  }
+
+  // The sections are independent, decompress them in parallel.
+  parallelForEach(getContext(), eagerSections,
+                  [](auto &it) { (void)it.second->getData(); });
+  for (auto &[sectionID, section] : eagerSections) {
+    FailureOr<ArrayRef<uint8_t>> data = section->getData();
+    if (failed(data)) {
+      return emitError(fileLoc, "failed to decompress top-level section ")
+             << ::toString(sectionID) << ": " << section->getError();
+    }
+    sectionDatas[sectionID] = *data;
+  }
+  return success();
+}
+
 LogicalResult BytecodeReader::Impl::parseVersion(EncodingReader &reader) {
   if (failed(reader.parseVarInt(version)))
     return failure();
@@ -1779,30 +2157,36 @@ BytecodeReader::Impl::parseOpName(EncodingReader &reader,
   wasRegistered = opName->wasRegistered;
   // Check to see if this operation name has already been resolved. If we
   // haven't, load the dialect and build the operation name.
-  if (!opName->opName) {
-    // Load the dialect and its version.
-    DialectReader dialectReader(attrTypeReader, stringReader, resourceReader,
-                                reader);
-    if (failed(opName->dialect->load(dialectReader, getContext())))
-      return failure();
-    // If the opName is empty, this is because we use to accept names such as
-    // `foo` without any `.` separator. We shouldn't tolerate this in textual
-    // format anymore but for now we'll be backward compatible. This can only
-    // happen with unregistered dialects.
-    if (opName->name.empty()) {
-      if (opName->dialect->getLoadedDialect())
-        return emitError(fileLoc) << "has an empty opname for dialect '"
-                                  << opName->dialect->name << "'\n";
-
-      opName->opName.emplace(opName->dialect->name, getContext());
-    } else {
-      opName->opName.emplace((opName->dialect->name + "." + opName->name).str(),
-                             getContext());
-    }
-  }
+  if (!opName->opName && failed(resolveOpName(reader, *opName)))
+    return failure();
   return *opName->opName;
 }
 
+LogicalResult
+BytecodeReader::Impl::resolveOpName(EncodingReader &reader,
+                                    BytecodeOperationName &opName) {
+  // Load the dialect and its version.
+  DialectReader dialectReader(attrTypeReader, stringReader, resourceReader,
+                              reader);
+  if (failed(opName.dialect->load(dialectReader, getContext())))
+    return failure();
+  // If the opName is empty, this is because we use to accept names such as
+  // `foo` without any `.` separator. We shouldn't tolerate this in textual
+  // format anymore but for now we'll be backward compatible. This can only
+  // happen with unregistered dialects.
+  if (opName.name.empty()) {
+    if (opName.dialect->getLoadedDialect())
+      return emitError(fileLoc) << "has an empty opname for dialect '"
+                                << opName.dialect->name << "'\n";
+
+    opName.opName.emplace(opName.dialect->name, getContext());
+  } else {
+    opName.opName.emplace((opName.dialect->name + "." + opName.name).str(),
+                          getContext());
+  }
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // Resource Section
 
@@ -1828,7 +2212,8 @@ LogicalResult BytecodeReader::Impl::parseResourceSection(
                               reader);
   return resourceReader.initialize(fileLoc, config, dialects, stringReader,
                                    *resourceData, *resourceOffsetData,
-                                   dialectReader, bufferOwnerRef);
+                                   dialectReader, bufferOwnerRef,
+                                   decompressedResourceSection);
 }
 
 //===----------------------------------------------------------------------===//
@@ -1879,7 +2264,7 @@ LogicalResult BytecodeReader::Impl::sortUseListOrder(Value value) {
     return success();
 
   bool hasIncomingOrder =
-      valueToUseListMap.contains(value.getAsOpaquePointer());
+      mainState.valueToUseListMap.contains(value.getAsOpaquePointer());
 
   // Compute the current order of the use-list with respect to the global
   // ordering. Detect if the order is already sorted while doing so.
@@ -1920,7 +2305,7 @@ LogicalResult BytecodeReader::Impl::sortUseListOrder(Value value) {
 
   // Pull the custom order info from the map.
   UseListOrderStorage customOrder =
-      valueToUseListMap.at(value.getAsOpaquePointer());
+      mainState.valueToUseListMap.at(value.getAsOpaquePointer());
   SmallVector<unsigned, 4> shuffle = std::move(customOrder.indices);
   uint64_t numUses =
       std::distance(value.getUses().begin(), value.getUses().end());
@@ -2001,21 +2386,44 @@ BytecodeReader::Impl::parseIRSection(ArrayRef<uint8_t> sectionData,
   // A stack of operation regions currently being read from the bytecode.
   std::vector<RegionReadState> regionStack;
 
+  // Isolated regions are encoded as separate sections since the lazy loading
+  // version, which allows for parsing them in parallel. In this mode, the IR
+  // section is first parsed with every isolated region deferred like lazy
+  // loading does, and the deferred regions are then parsed on the thread pool
+  // of the context. All the entries shared between the regions are resolved
+  // upfront, so that workers only read from the tables of the reader.
+  bool parseInParallel = config.shouldParseInParallel() && !lazyLoading &&
+                         version >= bytecode::kLazyLoading &&
+                         getContext()->isMultithreadingEnabled();
+  if (parseInParallel) {
+    if (failed(attrTypeReader.resolveAll()))
+      return failure();
+    for (BytecodeOperationName &opName : opNames)
+      if (!opName.opName && failed(resolveOpName(reader, opName)))
+        return failure();
+    lazyLoading = true;
+  }
+
   // Parse the top-level block using a temporary module operation.
   OwningOpRef<ModuleOp> moduleOp = ModuleOp::create(fileLoc);
   regionStack.emplace_back(*moduleOp, &reader, /*isIsolatedFromAbove=*/true);
   regionStack.back().curBlocks.push_back(moduleOp->getBody());
   regionStack.back().curBlock = regionStack.back().curRegion->begin();
-  if (failed(parseBlockHeader(reader, regionStack.back())))
+  if (failed(parseBlockHeader(mainState, reader, regionStack.back())))
     return failure();
-  valueScopes.emplace_back();
-  valueScopes.back().push(regionStack.back());
+  mainState.valueScopes.emplace_back();
+  mainState.valueScopes.back().push(regionStack.back());
 
   // Iteratively parse regions until everything has been resolved.
   while (!regionStack.empty())
-    if (failed(parseRegions(regionStack, regionStack.back())))
+    if (failed(parseRegions(mainState, regionStack, regionStack.back())))
       return failure();
-  if (!forwardRefOps.empty()) {
+  if (parseInParallel) {
+    lazyLoading = false;
+    if (failed(materializeAllInParallel()))
+      return failure();
+  }
+  if (!mainState.forwardRefOps.empty()) {
     return reader.emitError(
         "not all forward unresolved forward operand references");
   }
@@ -2048,8 +2456,40 @@ BytecodeReader::Impl::parseIRSection(ArrayRef<uint8_t> sectionData,
   return success();
 }
 
+LogicalResult BytecodeReader::Impl::materializeAllInParallel() {
+  // Take the deferred regions out of the lazy loading lists.
+  std::vector<std::pair<Operation *, RegionReadState>> deferredOps;
+  deferredOps.reserve(lazyLoadableOps.size());
+  for (auto &[op, readState] : lazyLoadableOps)
+    deferredOps.emplace_back(op, std::move(readState));
+  lazyLoadableOps.clear();
+  lazyLoadableOpsMap.clear();
+
+  parallelStates.resize(deferredOps.size());
+  for (std::unique_ptr<IRParseState> &state : parallelStates)
+    state = std::make_unique<IRParseState>();
+  if (failed(failableParallelForEachN(
+          getContext(), 0, deferredOps.size(), [&](size_t index) {
+            return materialize(*parallelStates[index],
+                               std::move(deferredOps[index].second));
+          })))
+    return failure();
+
+  // Check that every forward reference was resolved, and merge the use-list
+  // orders to process.
+  for (std::unique_ptr<IRParseState> &state : parallelStates) {
+    if (!state->forwardRefOps.empty())
+      return emitError(fileLoc,
+                       "not all forward unresolved forward operand references");
+    for (auto &[value, order] : state->valueToUseListMap)
+      mainState.valueToUseListMap.try_emplace(value, std::move(order));
+  }
+  return success();
+}
+
 LogicalResult
-BytecodeReader::Impl::parseRegions(std::vector<RegionReadState> &regionStack,
+BytecodeReader::Impl::parseRegions(IRParseState &state,
+                                   std::vector<RegionReadState> &regionStack,
                                    RegionReadState &readState) {
   // Process regions, blocks, and operations until the end or if a nested
   // region is encountered. In this case we push a new state in regionStack and
@@ -2060,7 +2500,7 @@ BytecodeReader::Impl::parseRegions(std::vector<RegionReadState> &regionStack,
     // interrupted to recurse down in a nested region and we resume the current
     // block after processing the nested region.
     if (readState.curBlock == Region::iterator()) {
-      if (failed(parseRegion(readState)))
+      if (failed(parseRegion(state, readState)))
         return failure();
 
       // If the region is empty, there is nothing to more to do.
@@ -2075,8 +2515,8 @@ BytecodeReader::Impl::parseRegions(std::vector<RegionReadState> &regionStack,
         // Read in the next operation. We don't read its regions directly, we
         // handle those afterwards as necessary.
         bool isIsolatedFromAbove = false;
-        FailureOr<Operation *> op =
-            parseOpWithoutRegions(reader, readState, isIsolatedFromAbove);
+        FailureOr<Operation *> op = parseOpWithoutRegions(
+            state, reader, readState, isIsolatedFromAbove);
         if (failed(op))
           return failure();
 
@@ -2112,7 +2552,7 @@ BytecodeReader::Impl::parseRegions(std::vector<RegionReadState> &regionStack,
 
           // If the op is isolated from above, push a new value scope.
           if (isIsolatedFromAbove)
-            valueScopes.emplace_back();
+            state.valueScopes.emplace_back();
           return success();
         }
       }
@@ -2120,20 +2560,21 @@ BytecodeReader::Impl::parseRegions(std::vector<RegionReadState> &regionStack,
       // Move to the next block of the region.
       if (++readState.curBlock == readState.curRegion->end())
         break;
-      if (failed(parseBlockHeader(reader, readState)))
+      if (failed(parseBlockHeader(state, reader, readState)))
         return failure();
     } while (true);
 
     // Reset the current block and any values reserved for this region.
     readState.curBlock = {};
-    valueScopes.back().pop(readState);
+    state.valueScopes.back().pop(readState);
   }
 
   // When the regions have been fully parsed, pop them off of the read stack. If
   // the regions were isolated from above, we also pop the last value scope.
   if (readState.isIsolatedFromAbove) {
-    assert(!valueScopes.empty() && "Expect a valueScope after reading region");
-    valueScopes.pop_back();
+    assert(!state.valueScopes.empty() &&
+           "Expect a valueScope after reading region");
+    state.valueScopes.pop_back();
   }
   assert(!regionStack.empty() && "Expect a regionStack after reading region");
   regionStack.pop_back();
@@ -2141,7 +2582,8 @@ BytecodeReader::Impl::parseRegions(std::vector<RegionReadState> &regionStack,
 }
 
 FailureOr<Operation *>
-BytecodeReader::Impl::parseOpWithoutRegions(EncodingReader &reader,
+BytecodeReader::Impl::parseOpWithoutRegions(IRParseState &state,
+                                            EncodingReader &reader,
                                             RegionReadState &readState,
                                             bool &isIsolatedFromAbove) {
   // Parse the name of the operation.
@@ -2158,7 +2600,7 @@ BytecodeReader::Impl::parseOpWithoutRegions(EncodingReader &reader,
 
   /// Parse the location.
   LocationAttr opLoc;
-  if (failed(parseAttribute(reader, opLoc)))
+  if (failed(parseLocation(reader, opLoc)))
     return failure();
 
   // With the location and name resolved, we can start building the operation
@@ -2216,7 +2658,7 @@ BytecodeReader::Impl::parseOpWithoutRegions(EncodingReader &reader,
       return failure();
     opState.operands.resize(numOperands);
     for (int i = 0, e = numOperands; i < e; ++i)
-      if (!(opState.operands[i] = parseOperand(reader)))
+      if (!(opState.operands[i] = parseOperand(state, reader)))
         return failure();
   }
 
@@ -2261,7 +2703,8 @@ BytecodeReader::Impl::parseOpWithoutRegions(EncodingReader &reader,
   readState.curBlock->push_back(op);
 
   // If the operation had results, update the value references.
-  if (op->getNumResults() && failed(defineValues(reader, op->getResults())))
+  if (op->getNumResults() &&
+      failed(defineValues(state, reader, op->getResults())))
     return failure();
 
   /// Store a map for every value that received a custom use-list order from the
@@ -2269,15 +2712,17 @@ BytecodeReader::Impl::parseOpWithoutRegions(EncodingReader &reader,
   if (resultIdxToUseListMap.has_value()) {
     for (size_t idx = 0; idx < op->getNumResults(); idx++) {
       if (resultIdxToUseListMap->contains(idx)) {
-        valueToUseListMap.try_emplace(op->getResult(idx).getAsOpaquePointer(),
-                                      resultIdxToUseListMap->at(idx));
+        state.valueToUseListMap.try_emplace(
+            op->getResult(idx).getAsOpaquePointer(),
+            resultIdxToUseListMap->at(idx));
       }
     }
   }
   return op;
 }
 
-LogicalResult BytecodeReader::Impl::parseRegion(RegionReadState &readState) {
+LogicalResult BytecodeReader::Impl::parseRegion(IRParseState &state,
+                                                RegionReadState &readState) {
   EncodingReader &reader = *readState.reader;
 
   // Parse the number of blocks in the region.
@@ -2305,22 +2750,24 @@ LogicalResult BytecodeReader::Impl::parseRegion(RegionReadState &readState) {
   }
 
   // Prepare the current value scope for this region.
-  valueScopes.back().push(readState);
+  state.valueScopes.back().push(readState);
 
   // Parse the entry block of the region.
   readState.curBlock = readState.curRegion->begin();
-  return parseBlockHeader(reader, readState);
+  return parseBlockHeader(state, reader, readState);
 }
 
 LogicalResult
-BytecodeReader::Impl::parseBlockHeader(EncodingReader &reader,
+BytecodeReader::Impl::parseBlockHeader(IRParseState &state,
+                                       EncodingReader &reader,
                                        RegionReadState &readState) {
   bool hasArgs;
   if (failed(reader.parseVarIntWithFlag(readState.numOpsRemaining, hasArgs)))
     return failure();
 
   // Parse the arguments of the block.
-  if (hasArgs && failed(parseBlockArguments(reader, &*readState.curBlock)))
+  if (hasArgs &&
+      failed(parseBlockArguments(state, reader, &*readState.curBlock)))
     return failure();
 
   // Uselist orders are available since version 3 of the bytecode.
@@ -2342,14 +2789,16 @@ BytecodeReader::Impl::parseBlockHeader(EncodingReader &reader,
 
   for (size_t idx = 0; idx < blk.getNumArguments(); idx++)
     if (argIdxToUseListMap->contains(idx))
-      valueToUseListMap.try_emplace(blk.getArgument(idx).getAsOpaquePointer(),
-                                    argIdxToUseListMap->at(idx));
+      state.valueToUseListMap.try_emplace(
+          blk.getArgument(idx).getAsOpaquePointer(),
+          argIdxToUseListMap->at(idx));
 
   // We don't parse the operations of the block here, that's done elsewhere.
   return success();
 }
 
-LogicalResult BytecodeReader::Impl::parseBlockArguments(EncodingReader &reader,
+LogicalResult BytecodeReader::Impl::parseBlockArguments(IRParseState &state,
+                                                        EncodingReader &reader,
                                                         Block *block) {
   // Parse the value ID for the first argument, and the number of arguments.
   uint64_t numArgs;
@@ -2372,39 +2821,41 @@ LogicalResult BytecodeReader::Impl::parseBlockArguments(EncodingReader &reader,
       if (failed(reader.parseVarIntWithFlag(typeIdx, hasLoc)) ||
           !(argType = attrTypeReader.resolveType(typeIdx)))
         return failure();
-      if (hasLoc && failed(parseAttribute(reader, argLoc)))
+      if (hasLoc && failed(parseLocation(reader, argLoc)))
         return failure();
     } else {
       // All args has type and location.
       if (failed(parseType(reader, argType)) ||
-          failed(parseAttribute(reader, argLoc)))
+          failed(parseLocation(reader, argLoc)))
         return failure();
     }
     argTypes.push_back(argType);
     argLocs.push_back(argLoc);
   }
   block->addArguments(argTypes, argLocs);
-  return defineValues(reader, block->getArguments());
+  return defineValues(state, reader, block->getArguments());
 }
 
 //===----------------------------------------------------------------------===//
 // Value Processing
 
-Value BytecodeReader::Impl::parseOperand(EncodingReader &reader) {
-  std::vector<Value> &values = valueScopes.back().values;
+Value BytecodeReader::Impl::parseOperand(IRParseState &state,
+                                         EncodingReader &reader) {
+  std::vector<Value> &values = state.valueScopes.back().values;
   Value *value = nullptr;
   if (failed(parseEntry(reader, values, value, "value")))
     return Value();
 
   // Create a new forward reference if necessary.
   if (!*value)
-    *value = createForwardRef();
+    *value = createForwardRef(state);
   return *value;
 }
 
-LogicalResult BytecodeReader::Impl::defineValues(EncodingReader &reader,
+LogicalResult BytecodeReader::Impl::defineValues(IRParseState &state,
+                                                 EncodingReader &reader,
                                                  ValueRange newValues) {
-  ValueScope &valueScope = valueScopes.back();
+  ValueScope &valueScope = state.valueScopes.back();
   std::vector<Value> &values = valueScope.values;
 
   unsigned &valueID = valueScope.nextValueIDs.back();
@@ -2428,26 +2879,28 @@ LogicalResult BytecodeReader::Impl::defineValues(EncodingReader &reader,
       // Assert that this is a forward reference operation. Given how we compute
       // definition ids (incrementally as we parse), it shouldn't be possible
       // for the value to be defined any other way.
-      assert(forwardRefOp && forwardRefOp->getBlock() == &forwardRefOps &&
+      assert(forwardRefOp &&
+             forwardRefOp->getBlock() == &state.forwardRefOps &&
              "value index was already defined?");
 
       oldValue.replaceAllUsesWith(newValue);
-      forwardRefOp->moveBefore(&openForwardRefOps, openForwardRefOps.end());
+      forwardRefOp->moveBefore(&state.openForwardRefOps,
+                               state.openForwardRefOps.end());
     }
   }
   return success();
 }
 
-Value BytecodeReader::Impl::createForwardRef() {
+Value BytecodeReader::Impl::createForwardRef(IRParseState &state) {
   // Check for an avaliable existing operation to use. Otherwise, create a new
   // fake operation to use for the reference.
-  if (!openForwardRefOps.empty()) {
-    Operation *op = &openForwardRefOps.back();
-    op->moveBefore(&forwardRefOps, forwardRefOps.end());
+  if (!state.openForwardRefOps.empty()) {
+    Operation *op = &state.openForwardRefOps.back();
+    op->moveBefore(&state.forwardRefOps, state.forwardRefOps.end());
   } else {
-    forwardRefOps.push_back(Operation::create(forwardRefOpState));
+    state.forwardRefOps.push_back(Operation::create(forwardRefOpState));
   }
-  return forwardRefOps.back().getResult(0);
+  return state.forwardRefOps.back().getResult(0);
 }
 
 //===----------------------------------------------------------------------===//
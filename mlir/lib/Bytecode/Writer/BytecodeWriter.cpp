@@ -20,8 +20,9 @@
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
-#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/Endian.h"
+#include "llvm/Support/raw_ostream.h"
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -47,6 +48,19 @@ struct BytecodeWriterConfig::Impl {
   /// The producer of the bytecode.
   StringRef producer;
 
+  /// Whether top-level sections are written out as soon as they are finalized.
+  bool streamOutput = false;
+
+  /// The compression of the IR and resource sections.
+  BytecodeWriterConfig::Compression irCompression =
+      BytecodeWriterConfig::Compression::None;
+  BytecodeWriterConfig::Compression resourceCompression =
+      BytecodeWriterConfig::Compression::None;
+
+  /// The width of the elements of the byte-shuffle filter applied to the
+  /// resource section before compression, or 0 if it isn't applied.
+  unsigned resourceShuffleWidth = 0;
+
   /// A collection of non-dialect resource printers.
   SmallVector<std::unique_ptr<AsmResourcePrinter>> externalResourcePrinters;
 };
@@ -73,6 +87,20 @@ int64_t BytecodeWriterConfig::getDesiredBytecodeVersion() const {
   return impl->bytecodeVersion;
 }
 
+void BytecodeWriterConfig::setStreamOutput(bool enable) {
+  impl->streamOutput = enable;
+}
+
+void BytecodeWriterConfig::setIRCompression(Compression compression) {
+  impl->irCompression = compression;
+}
+
+void BytecodeWriterConfig::setResourceCompression(Compression compression,
+                                                  unsigned shuffleWidth) {
+  impl->resourceCompression = compression;
+  impl->resourceShuffleWidth = shuffleWidth;
+}
+
 //===----------------------------------------------------------------------===//
 // EncodingEmitter
 //===----------------------------------------------------------------------===//
@@ -92,8 +120,15 @@ public:
   /// Write the current contents to the provided stream.
   void writeTo(raw_ostream &os) const;
 
+  /// Write the current contents to the provided stream and release them. The
+  /// flushed data still counts towards the size of the encoding, so that the
+  /// alignment of subsequently emitted data is preserved.
+  void flush(raw_ostream &os);
+
   /// Return the current size of the encoded buffer.
-  size_t size() const { return prevResultSize + currentResult.size(); }
+  size_t size() const {
+    return flushedSize + prevResultSize + currentResult.size();
+  }
 
   //===--------------------------------------------------------------------===//
   // Emission
@@ -101,9 +136,9 @@ public:
 
   /// Backpatch a byte in the result buffer at the given offset.
   void patchByte(uint64_t offset, uint8_t value) {
-    assert(offset < size() && offset >= prevResultSize &&
+    assert(offset < size() && offset >= flushedSize + prevResultSize &&
            "cannot patch previously emitted data");
-    currentResult[offset - prevResultSize] = value;
+    currentResult[offset - flushedSize - prevResultSize] = value;
   }
 
   /// Emit the provided blob of data, which is owned by the caller and is
@@ -209,8 +244,28 @@ public:
   // Section Emission
 
   /// Emit a nested section of the given code, whose contents are encoded in the
-  /// provided emitter.
-  void emitSection(bytecode::Section::ID code, EncodingEmitter &&emitter) {
+  /// provided emitter. The section is compressed with `compression` if this
+  /// makes it smaller, after applying a byte-shuffle filter with elements of
+  /// `shuffleWidth` bytes if it is greater than 1.
+  void emitSection(bytecode::Section::ID code, EncodingEmitter &&emitter,
+                   BytecodeWriterConfig::Compression compression =
+                       BytecodeWriterConfig::Compression::None,
+                   unsigned shuffleWidth = 0) {
+    assert(emitter.flushedSize == 0 && "cannot emit a flushed section");
+
+    // Emit the compressed section if it is smaller. Its header holds the
+    // alignment of the section, which applies to the decompressed data.
+    EncodingEmitter compressedEmitter;
+    if (compression != BytecodeWriterConfig::Compression::None &&
+        compressSection(emitter, compression, shuffleWidth,
+                        compressedEmitter)) {
+      emitByte(code | bytecode::Section::kIsCompressed);
+      emitVarInt(compressedEmitter.size());
+      appendResult(std::move(currentResult));
+      appendResult(std::move(compressedEmitter.currentResult));
+      return;
+    }
+
     // Emit the section code and length. The high bit of the code is used to
     // indicate whether the section alignment is present, so save an offset to
     // it.
@@ -227,7 +282,7 @@ public:
 
         // Indicate that we needed to align the section, the high bit of the
         // code field is used for this.
-        currentResult[codeOffset] |= 0b10000000;
+        currentResult[codeOffset] |= bytecode::Section::kHasAlignment;
       } else {
         // Otherwise, if we happen to be at a compatible offset, we just
         // remember that we need this alignment.
@@ -246,6 +301,14 @@ public:
   }
 
 private:
+  /// Encode the contents of `emitter` compressed with `compression` into
+  /// `result`, which holds the header of the compressed section followed by
+  /// the compressed data. Returns false if the compressed section is not
+  /// smaller.
+  bool compressSection(const EncodingEmitter &emitter,
+                       BytecodeWriterConfig::Compression compression,
+                       unsigned shuffleWidth, EncodingEmitter &result);
+
   /// Emit the given value using a variable width encoding. This method is a
   /// fallback when the number of bytes needed to encode the value is greater
   /// than 1. We mark it noinline here so that the single byte hot path isn't
@@ -279,6 +342,9 @@ private:
   /// This enables O(1) size checks of the current encoding.
   size_t prevResultSize = 0;
 
+  /// The total size of the buffers that were already written out by `flush`.
+  size_t flushedSize = 0;
+
   /// The highest required alignment for the start of this section.
   unsigned requiredAlignment = 1;
 };
@@ -532,6 +598,64 @@ void EncodingEmitter::writeTo(raw_ostream &os) const {
   os.write((const char *)currentResult.data(), currentResult.size());
 }
 
+void EncodingEmitter::flush(raw_ostream &os) {
+  writeTo(os);
+  flushedSize += prevResultSize + currentResult.size();
+  prevResultSize = 0;
+  prevResultList.clear();
+  prevResultStorage.clear();
+  currentResult.clear();
+}
+
+/// Transpose `data` as a matrix of elements of `width` bytes, such that the
+/// bytes of the same significance of the elements are contiguous. The trailing
+/// bytes that don't form a complete element are left in place.
+static void shuffleBytes(ArrayRef<uint8_t> data, unsigned width,
+                         SmallVectorImpl<uint8_t> &result) {
+  size_t numElements = data.size() / width;
+  result.resize(data.size());
+  for (size_t i = 0; i < numElements; ++i)
+    for (unsigned j = 0; j < width; ++j)
+      result[j * numElements + i] = data[i * width + j];
+  std::copy(data.begin() + numElements * width, data.end(),
+            result.begin() + numElements * width);
+}
+
+bool EncodingEmitter::compressSection(
+    const EncodingEmitter &emitter,
+    BytecodeWriterConfig::Compression compression, unsigned shuffleWidth,
+    EncodingEmitter &result) {
+  SmallVector<uint8_t> data;
+  data.reserve(emitter.size());
+  for (ArrayRef<uint8_t> prevResult : emitter.prevResultList)
+    llvm::append_range(data, prevResult);
+  llvm::append_range(data, emitter.currentResult);
+  if (shuffleWidth > 1) {
+    SmallVector<uint8_t> shuffledData;
+    shuffleBytes(data, shuffleWidth, shuffledData);
+    data = std::move(shuffledData);
+  } else {
+    shuffleWidth = 0;
+  }
+
+  SmallVector<uint8_t> compressedData;
+  bytecode::SectionCompression::Format format;
+  if (compression == BytecodeWriterConfig::Compression::Zstd) {
+    format = bytecode::SectionCompression::kZstd;
+    llvm::compression::zstd::compress(data, compressedData);
+  } else {
+    format = bytecode::SectionCompression::kZlib;
+    llvm::compression::zlib::compress(data, compressedData);
+  }
+
+  result.emitByte(format);
+  result.emitVarInt(shuffleWidth);
+  result.emitVarInt(emitter.requiredAlignment);
+  result.emitVarInt(data.size());
+  result.emitBytes(compressedData);
+  return result.size() < emitter.size();
+}
+
 void EncodingEmitter::emitMultiByteVarInt(uint64_t value) {
   // Compute the number of bytes needed to encode the value. Each byte can hold
   // up to 7-bits of data. We only check up to the number of bits we can encode
@@ -642,24 +766,52 @@ LogicalResult BytecodeWriter::write(Operation *rootOp, raw_ostream &os) {
            << static_cast<int64_t>(bytecode::kVersion) << ']';
   emitter.emitVarInt(config.bytecodeVersion);
 
+  // Check that the requested compression can be honored.
+  for (BytecodeWriterConfig::Compression compression :
+       {config.irCompression, config.resourceCompression}) {
+    if (compression == BytecodeWriterConfig::Compression::None)
+      continue;
+    if (config.bytecodeVersion < bytecode::kSectionCompression)
+      return rootOp->emitError(
+          "section compression is incompatible with bytecode <6");
+    bool isZstd = compression == BytecodeWriterConfig::Compression::Zstd;
+    if (isZstd ? !llvm::compression::zstd::isAvailable()
+               : !llvm::compression::zlib::isAvailable())
+      return rootOp->emitError()
+             << (isZstd ? "zstd" : "zlib")
+             << " compression is not available in this build";
+  }
+
   // Emit the producer.
   emitter.emitNulTerminatedString(config.producer);
 
+  // When streaming, write out each top-level section as soon as it is
+  // finalized.
+  auto flushSection = [&] {
+    if (config.streamOutput)
+      emitter.flush(os);
+  };
+
   // Emit the dialect section.
   writeDialectSection(emitter);
+  flushSection();
 
   // Emit the attributes and types section.
   writeAttrTypeSection(emitter);
+  flushSection();
 
   // Emit the IR section.
   if (failed(writeIRSection(emitter, rootOp)))
     return failure();
+  flushSection();
 
   // Emit the resources section.
   writeResourceSection(rootOp, emitter);
+  flushSection();
 
   // Emit the string section.
   writeStringSection(emitter);
+  flushSection();
 
   // Emit the properties section.
   if (config.bytecodeVersion >= bytecode::kNativePropertiesEncoding)
@@ -808,8 +960,9 @@ void BytecodeWriter::writeAttrTypeSection(EncodingEmitter &emitter) {
 
   // Emit the sections to the stream.
   emitter.emitSection(bytecode::Section::kAttrTypeOffset,
-                      std::move(offsetEmitter));
-  emitter.emitSection(bytecode::Section::kAttrType, std::move(attrTypeEmitter));
+                      std::move(offsetEmitter), config.irCompression);
+  emitter.emitSection(bytecode::Section::kAttrType, std::move(attrTypeEmitter),
+                      config.irCompression);
 }
 
 //===----------------------------------------------------------------------===//
@@ -1080,7 +1233,8 @@ LogicalResult BytecodeWriter::writeIRSection(EncodingEmitter &emitter,
   if (failed(writeOp(irEmitter, op)))
     return failure();
 
-  emitter.emitSection(bytecode::Section::kIR, std::move(irEmitter));
+  emitter.emitSection(bytecode::Section::kIR, std::move(irEmitter),
+                      config.irCompression);
   return success();
 }
 
@@ -1185,7 +1339,8 @@ void BytecodeWriter::writeResourceSection(Operation *op,
 
   emitter.emitSection(bytecode::Section::kResourceOffset,
                       std::move(resourceOffsetEmitter));
-  emitter.emitSection(bytecode::Section::kResource, std::move(resourceEmitter));
+  emitter.emitSection(bytecode::Section::kResource, std::move(resourceEmitter),
+                      config.resourceCompression, config.resourceShuffleWidth);
 }
 
 //===----------------------------------------------------------------------===//
@@ -1194,7 +1349,8 @@ void BytecodeWriter::writeResourceSection(Operation *op,
 void BytecodeWriter::writeStringSection(EncodingEmitter &emitter) {
   EncodingEmitter stringEmitter;
   stringSection.write(stringEmitter);
-  emitter.emitSection(bytecode::Section::kString, std::move(stringEmitter));
+  emitter.emitSection(bytecode::Section::kString, std::move(stringEmitter),
+                      config.irCompression);
 }
 
 //===----------------------------------------------------------------------===//
@@ -1204,7 +1360,7 @@ void BytecodeWriter::writePropertiesSection(EncodingEmitter &emitter) {
   EncodingEmitter propertiesEmitter;
   propertiesSection.write(propertiesEmitter);
   emitter.emitSection(bytecode::Section::kProperties,
-                      std::move(propertiesEmitter));
+                      std::move(propertiesEmitter), config.irCompression);
 }
 
 //===----------------------------------------------------------------------===//
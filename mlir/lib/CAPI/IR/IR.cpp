@@ -80,6 +80,18 @@ void mlirContextEnableMultithreading(MlirContext context, bool enable) {
   return unwrap(context)->enableMultithreading(enable);
 }
 
+void mlirContextSetThreadPool(MlirContext context,
+                              MlirLlvmThreadPool threadPool) {
+  // The pool can only be replaced while multithreading is disabled.
+  MLIRContext *ctx = unwrap(context);
+  ctx->disableMultithreading();
+  ctx->setThreadPool(*unwrap(threadPool));
+}
+
+unsigned mlirContextGetNumThreads(MlirContext context) {
+  return unwrap(context)->getNumThreads();
+}
+
 void mlirContextLoadAllAvailableDialects(MlirContext context) {
   unwrap(context)->loadAllAvailableDialects();
 }
@@ -387,6 +399,16 @@ MlirOperation mlirOperationCreate(MlirOperationState *state) {
   return result;
 }
 
+MlirLogicalResult mlirOperationCreateN(intptr_t n, MlirOperationState *states,
+                                       MlirOperation *ops) {
+  bool succeeded = true;
+  for (intptr_t i = 0; i < n; ++i) {
+    ops[i] = mlirOperationCreate(&states[i]);
+    succeeded &= !mlirOperationIsNull(ops[i]);
+  }
+  return wrap(success(succeeded));
+}
+
 MlirOperation mlirOperationCreateParse(MlirContext context,
                                        MlirStringRef sourceStr,
                                        MlirStringRef sourceName) {
@@ -458,6 +480,37 @@ MlirRegion mlirRegionGetNextInOperation(MlirRegion region) {
   return wrap(static_cast<Region *>(nullptr));
 }
 
+/// Walks `op` and its nested operations with the C callback.
+static WalkResult walkWithCallback(Operation *op,
+                                   MlirOperationWalkCallback callback,
+                                   void *userData, MlirWalkOrder order) {
+  return detail::walk<ForwardIterator>(
+      op,
+      [&](Operation *nestedOp) -> WalkResult {
+        switch (callback(wrap(nestedOp), userData)) {
+        case MlirWalkResultAdvance:
+          return WalkResult::advance();
+        case MlirWalkResultInterrupt:
+          return WalkResult::interrupt();
+        case MlirWalkResultSkip:
+          return WalkResult::skip();
+        }
+        llvm_unreachable("unknown walk result");
+      },
+      order == MlirWalkPreOrder ? WalkOrder::PreOrder : WalkOrder::PostOrder);
+}
+
+bool mlirRegionWalk(MlirRegion region, MlirOperationWalkCallback callback,
+                    void *userData, MlirWalkOrder order) {
+  for (Block &block : *unwrap(region)) {
+    // Early increment here in the case where the operation is erased.
+    for (Operation &op : llvm::make_early_inc_range(block))
+      if (walkWithCallback(&op, callback, userData, order).wasInterrupted())
+        return true;
+  }
+  return false;
+}
+
 MlirOperation mlirOperationGetNextInBlock(MlirOperation op) {
   return wrap(unwrap(op)->getNextNode());
 }
@@ -470,6 +523,11 @@ MlirValue mlirOperationGetOperand(MlirOperation op, intptr_t pos) {
   return wrap(unwrap(op)->getOperand(static_cast<unsigned>(pos)));
 }
 
+void mlirOperationGetOperands(MlirOperation op, MlirValue *operands) {
+  llvm::transform(unwrap(op)->getOperands(), operands,
+                  [](Value operand) { return wrap(operand); });
+}
+
 void mlirOperationSetOperand(MlirOperation op, intptr_t pos,
                              MlirValue newValue) {
   unwrap(op)->setOperand(static_cast<unsigned>(pos), unwrap(newValue));
@@ -483,6 +541,11 @@ MlirValue mlirOperationGetResult(MlirOperation op, intptr_t pos) {
   return wrap(unwrap(op)->getResult(static_cast<unsigned>(pos)));
 }
 
+void mlirOperationGetResults(MlirOperation op, MlirValue *results) {
+  llvm::transform(unwrap(op)->getResults(), results,
+                  [](Value result) { return wrap(result); });
+}
+
 intptr_t mlirOperationGetNumSuccessors(MlirOperation op) {
   return static_cast<intptr_t>(unwrap(op)->getNumSuccessors());
 }
@@ -514,6 +577,12 @@ bool mlirOperationRemoveAttributeByName(MlirOperation op, MlirStringRef name) {
   return !!unwrap(op)->removeAttr(unwrap(name));
 }
 
+bool mlirOperationWalk(MlirOperation op, MlirOperationWalkCallback callback,
+                       void *userData, MlirWalkOrder order) {
+  return walkWithCallback(unwrap(op), callback, userData, order)
+      .wasInterrupted();
+}
+
 void mlirOperationPrint(MlirOperation op, MlirStringCallback callback,
                         void *userData) {
   detail::CallbackOstream stream(callback, userData);
@@ -20,6 +20,22 @@ bool mlirStringRefEqual(MlirStringRef string, MlirStringRef other) {
          llvm::StringRef(other.data, other.length);
 }
 
+//===----------------------------------------------------------------------===//
+// LLVM ThreadPool API.
+//===----------------------------------------------------------------------===//
+
+MlirLlvmThreadPool mlirLlvmThreadPoolCreate(unsigned numThreads) {
+  return wrap(new llvm::ThreadPool(llvm::hardware_concurrency(numThreads)));
+}
+
+void mlirLlvmThreadPoolDestroy(MlirLlvmThreadPool pool) {
+  delete unwrap(pool);
+}
+
+unsigned mlirLlvmThreadPoolGetThreadCount(MlirLlvmThreadPool pool) {
+  return unwrap(pool)->getThreadCount();
+}
+
 //===----------------------------------------------------------------------===//
 // TypeID API.
 //===----------------------------------------------------------------------===//
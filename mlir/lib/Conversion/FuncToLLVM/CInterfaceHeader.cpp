@@ -0,0 +1,210 @@
+//===- CInterfaceHeader.cpp - Emit the C header of the C wrappers ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file emits the C declarations of the `_mlir_ciface_` wrappers that the
+// lowering of the functions with the `llvm.emit_c_interface` attribute
+// creates, together with the memref descriptor structs they take, such that
+// the code compiled ahead of time can be called from C or C++ without MLIR.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Conversion/FuncToLLVM/ConvertFuncToLLVM.h"
+#include "mlir/Conversion/LLVMCommon/LoweringOptions.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace mlir;
+
+namespace {
+/// Emits the declarations of the C wrappers of the functions of a module.
+class CInterfaceHeaderEmitter {
+public:
+  explicit CInterfaceHeaderEmitter(const LowerToLLVMOptions &options)
+      : indexType(("int" + Twine(options.getIndexBitwidth()) + "_t").str()) {}
+
+  /// Records the declaration of the C wrapper of `funcOp`.
+  LogicalResult addFunction(func::FuncOp funcOp);
+
+  /// Prints the header to `os`.
+  void print(raw_ostream &os);
+
+private:
+  /// Returns the C type of the scalars of type `type`, or an empty string if
+  /// they have no C type.
+  std::string getScalarType(Type type);
+
+  /// Returns the C type of the values of type `type`, which are passed by
+  /// value or as fields of descriptors, and defines the structs it needs.
+  /// Returns an empty string if there is no such C type.
+  std::string getValueType(Type type);
+
+  /// The C type of the index values.
+  std::string indexType;
+
+  /// The definitions of the structs, and the declarations of the wrappers.
+  llvm::SetVector<std::string> structs;
+  SmallVector<std::string> functions;
+};
+} // namespace
+
+std::string CInterfaceHeaderEmitter::getScalarType(Type type) {
+  if (type.isIndex())
+    return indexType;
+  if (type.isInteger(1))
+    return "bool";
+  if (auto intType = dyn_cast<IntegerType>(type)) {
+    unsigned width = intType.getWidth();
+    if (width != 8 && width != 16 && width != 32 && width != 64)
+      return "";
+    return ((intType.isUnsigned() ? "uint" : "int") + Twine(width) + "_t")
+        .str();
+  }
+  // The half-precision values are passed by their bits.
+  if (type.isF16() || type.isBF16())
+    return "uint16_t";
+  if (type.isF32())
+    return "float";
+  if (type.isF64())
+    return "double";
+  return "";
+}
+
+std::string CInterfaceHeaderEmitter::getValueType(Type type) {
+  if (isa<UnrankedMemRefType>(type)) {
+    structs.insert("typedef struct {\n  " + indexType +
+                   " rank;\n  void *descriptor;\n} mlir_unranked_memref;\n");
+    return "mlir_unranked_memref";
+  }
+  auto memrefType = dyn_cast<MemRefType>(type);
+  if (!memrefType)
+    return getScalarType(type);
+
+  // The descriptors are named after the rank and the element type, such that
+  // the memrefs of different shapes share them.
+  Type elementType = memrefType.getElementType();
+  std::string elementCType = getScalarType(elementType);
+  if (elementCType.empty())
+    return "";
+  std::string elementName;
+  llvm::raw_string_ostream nameOs(elementName);
+  elementType.print(nameOs);
+  int64_t rank = memrefType.getRank();
+  std::string name =
+      ("mlir_memref_" + Twine(rank) + "d_" + nameOs.str()).str();
+
+  std::string definition;
+  llvm::raw_string_ostream os(definition);
+  os << "typedef struct {\n";
+  os << "  " << elementCType << " *allocated;\n";
+  os << "  " << elementCType << " *aligned;\n";
+  os << "  " << indexType << " offset;\n";
+  if (rank != 0) {
+    os << "  " << indexType << " sizes[" << rank << "];\n";
+    os << "  " << indexType << " strides[" << rank << "];\n";
+  }
+  os << "} " << name << ";\n";
+  structs.insert(os.str());
+  return name;
+}
+
+LogicalResult CInterfaceHeaderEmitter::addFunction(func::FuncOp funcOp) {
+  FunctionType type = funcOp.getFunctionType();
+  std::string declaration;
+  llvm::raw_string_ostream os(declaration);
+  auto emitUnsupported = [&](Type type) {
+    return funcOp.emitError()
+           << "cannot declare the C interface of a function with a " << type;
+  };
+
+  // The results are returned by value if there is a single scalar, and
+  // otherwise written to a struct passed by pointer as the first argument.
+  std::string resultType = "void";
+  std::string resultArg;
+  if (type.getNumResults() == 1 && !isa<BaseMemRefType>(type.getResult(0))) {
+    resultType = getScalarType(type.getResult(0));
+    if (resultType.empty())
+      return emitUnsupported(type.getResult(0));
+  } else if (type.getNumResults() == 1) {
+    resultArg = getValueType(type.getResult(0));
+    if (resultArg.empty())
+      return emitUnsupported(type.getResult(0));
+  } else if (type.getNumResults() > 1) {
+    std::string resultsName = (funcOp.getName() + "_results").str();
+    std::string definition;
+    llvm::raw_string_ostream defOs(definition);
+    defOs << "typedef struct {\n";
+    for (auto [index, result] : llvm::enumerate(type.getResults())) {
+      std::string fieldType = getValueType(result);
+      if (fieldType.empty())
+        return emitUnsupported(result);
+      defOs << "  " << fieldType << " result" << index << ";\n";
+    }
+    defOs << "} " << resultsName << ";\n";
+    structs.insert(defOs.str());
+    resultArg = resultsName;
+  }
+
+  os << resultType << " _mlir_ciface_" << funcOp.getName() << "(";
+  ListSeparator sep;
+  if (!resultArg.empty())
+    os << sep << resultArg << " *result";
+  for (auto [index, input] : llvm::enumerate(type.getInputs())) {
+    std::string argType = getValueType(input);
+    if (argType.empty())
+      return emitUnsupported(input);
+    // The descriptors are passed by pointer.
+    os << sep << argType << (isa<BaseMemRefType>(input) ? " *" : " ") << "arg"
+       << index;
+  }
+  if (type.getNumInputs() == 0 && resultArg.empty())
+    os << "void";
+  os << ");\n";
+  functions.push_back(os.str());
+  return success();
+}
+
+void CInterfaceHeaderEmitter::print(raw_ostream &os) {
+  os << "// Declarations of the C interface of the functions of an MLIR "
+        "module.\n\n";
+  os << "#pragma once\n\n";
+  os << "#include <stdbool.h>\n";
+  os << "#include <stdint.h>\n\n";
+  os << "#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n";
+  // The structs may also be defined by the headers of other modules.
+  for (StringRef definition : structs) {
+    StringRef name = definition.rtrim("\n;").rsplit(' ').second;
+    std::string guard = "MLIR_C_INTERFACE_" + name.upper();
+    os << "#ifndef " << guard << "\n#define " << guard << "\n"
+       << definition << "#endif\n\n";
+  }
+  for (StringRef declaration : functions)
+    os << declaration;
+  os << "\n#ifdef __cplusplus\n}\n#endif\n";
+}
+
+LogicalResult mlir::emitCInterfaceHeader(ModuleOp module,
+                                         const LowerToLLVMOptions &options,
+                                         raw_ostream &os) {
+  CInterfaceHeaderEmitter emitter(options);
+  // The functions lowered with the bare pointer calling convention have no C
+  // wrappers.
+  if (!options.useBarePtrCallConv) {
+    for (auto funcOp : module.getOps<func::FuncOp>()) {
+      if (!funcOp->hasAttr(LLVM::LLVMDialect::getEmitCWrapperAttrName()))
+        continue;
+      if (failed(emitter.addFunction(funcOp)))
+        return failure();
+    }
+  }
+  emitter.print(os);
+  return success();
+}
@@ -20,6 +20,7 @@
 #include "mlir/Conversion/LLVMCommon/ConversionTarget.h"
 #include "mlir/Conversion/LLVMCommon/Pattern.h"
 #include "mlir/Conversion/LLVMCommon/VectorPattern.h"
+#include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/LLVMIR/FunctionCallUtils.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
@@ -33,6 +34,7 @@
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/IR/TypeUtilities.h"
+#include "mlir/Support/FileUtilities.h"
 #include "mlir/Support/LogicalResult.h"
 #include "mlir/Support/MathExtras.h"
 #include "mlir/Transforms/DialectConversion.h"
@@ -44,6 +46,7 @@
 #include "llvm/IR/Type.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/ToolOutputFile.h"
 #include <algorithm>
 #include <functional>
 
@@ -409,6 +412,16 @@ protected:
         for (size_t j = 0; j < mapping->size; ++j)
           newArgAttrs[mapping->inputNo + j] =
               DictionaryAttr::get(rewriter.getContext(), {});
+
+        // The memory of a ranked memref is accessed through the aligned
+        // pointer of its expanded descriptor, which can carry its `noalias`
+        // attribute. The allocated pointer aliases the aligned one, so it
+        // can't.
+        if (isa<MemRefType>(funcOp.getArgumentTypes()[i]) &&
+            attrsDict.get(LLVM::LLVMDialect::getNoAliasAttrName()))
+          newArgAttrs[mapping->inputNo + 1] = rewriter.getDictionaryAttr(
+              rewriter.getNamedAttr(LLVM::LLVMDialect::getNoAliasAttrName(),
+                                    rewriter.getUnitAttr()));
       }
       attributes.push_back(rewriter.getNamedAttr(
           funcOp.getArgAttrsAttrName(), rewriter.getArrayAttr(newArgAttrs)));
@@ -759,6 +772,21 @@ struct ConvertFuncToLLVMPass
     options.dataLayout = llvm::DataLayout(this->dataLayout);
     options.useOpaquePointers = useOpaquePointers;
 
+    // The header is emitted from the types of the functions before their
+    // conversion.
+    if (!cInterfaceHeader.empty()) {
+      std::string errorMessage;
+      std::unique_ptr<llvm::ToolOutputFile> output =
+          openOutputFile(cInterfaceHeader, &errorMessage);
+      if (!output) {
+        m.emitError() << errorMessage;
+        return signalPassFailure();
+      }
+      if (failed(emitCInterfaceHeader(m, options, output->os())))
+        return signalPassFailure();
+      output->keep();
+    }
+
     LLVMTypeConverter typeConverter(&getContext(), options,
                                     &dataLayoutAnalysis);
 
@@ -769,10 +797,23 @@ struct ConvertFuncToLLVMPass
     arith::populateArithToLLVMConversionPatterns(typeConverter, patterns);
     cf::populateControlFlowToLLVMConversionPatterns(typeConverter, patterns);
 
+    // The lowering of `cf.assert` declares `abort` in the module, which cannot
+    // be done while the function bodies are converted concurrently.
+    ConversionConfig config;
+    config.convertIsolatedOpsInParallel =
+        parallelConversion &&
+        !m.walk([](cf::AssertOp) { return WalkResult::interrupt(); })
+             .wasInterrupted();
+
     LLVMConversionTarget target(getContext());
-    if (failed(applyPartialConversion(m, target, std::move(patterns))))
+    if (failed(applyPartialConversion(m, target, std::move(patterns), config)))
       signalPassFailure();
 
+    TypeConverter::CacheStatistics cacheStats =
+        typeConverter.getCacheStatistics();
+    numTypeConversionCacheHits += cacheStats.numHits;
+    numTypeConversionCacheMisses += cacheStats.numMisses;
+
     m->setAttr(LLVM::LLVMDialect::getDataLayoutAttrName(),
                StringAttr::get(m.getContext(), this->dataLayout));
   }
@@ -136,6 +136,30 @@ protected:
           llvmPointerPointerType, /* void **kernelParams */
           llvmPointerPointerType  /* void **extra */
       }};
+  FunctionCallBuilder graphBeginCallBuilder = {
+      "mgpuGraphBegin",
+      llvmPointerType /* void *recording */,
+      {llvmPointerType /* void **cache */}};
+  FunctionCallBuilder graphLaunchKernelCallBuilder = {
+      "mgpuGraphLaunchKernel",
+      llvmVoidType,
+      {
+          llvmPointerType,        /* void *recording */
+          llvmPointerType,        /* void *module data */
+          llvmPointerType,        /* char *name */
+          llvmIntPtrType,         /* intptr_t gridXDim */
+          llvmIntPtrType,         /* intptr_t gridyDim */
+          llvmIntPtrType,         /* intptr_t gridZDim */
+          llvmIntPtrType,         /* intptr_t blockXDim */
+          llvmIntPtrType,         /* intptr_t blockYDim */
+          llvmIntPtrType,         /* intptr_t blockZDim */
+          llvmInt32Type,          /* unsigned int sharedMemBytes */
+          llvmPointerPointerType, /* void **kernelParams */
+          llvmIntPtrType,         /* intptr_t numParams */
+          llvmIntPtrType          /* intptr_t paramsSize */
+      }};
+  FunctionCallBuilder graphEndCallBuilder = {
+      "mgpuGraphEnd", llvmVoidType, {llvmPointerType /* void *recording */}};
   FunctionCallBuilder streamCreateCallBuilder = {
       "mgpuStreamCreate", llvmPointerType /* void *stream */, {}};
   FunctionCallBuilder streamDestroyCallBuilder = {
@@ -390,17 +414,26 @@ private:
 };
 
 /// A rewrite pattern to convert gpu.wait async operations into a GPU runtime
-/// call. Currently it supports CUDA and ROCm (HIP).
+/// call. Currently it supports CUDA and ROCm (HIP). If `captureGraphs` is set,
+/// the ops that start a sequence of kernel launches begin a graph recording
+/// instead, which is only supported by CUDA.
 class ConvertWaitAsyncOpToGpuRuntimeCallPattern
     : public ConvertOpToGpuRuntimeCallPattern<gpu::WaitOp> {
 public:
-  ConvertWaitAsyncOpToGpuRuntimeCallPattern(LLVMTypeConverter &typeConverter)
-      : ConvertOpToGpuRuntimeCallPattern<gpu::WaitOp>(typeConverter) {}
+  ConvertWaitAsyncOpToGpuRuntimeCallPattern(LLVMTypeConverter &typeConverter,
+                                            bool captureGraphs)
+      : ConvertOpToGpuRuntimeCallPattern<gpu::WaitOp>(typeConverter),
+        captureGraphs(captureGraphs) {}
 
 private:
+  Value generateGraphCache(Location loc, ModuleOp module,
+                           OpBuilder &builder) const;
+
   LogicalResult
   matchAndRewrite(gpu::WaitOp waitOp, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override;
+
+  bool captureGraphs;
 };
 
 /// A rewrite patter to convert gpu.launch_func operations into a sequence of
@@ -428,7 +461,8 @@ public:
 
 private:
   Value generateParamsArray(gpu::LaunchFuncOp launchOp, OpAdaptor adaptor,
-                            OpBuilder &builder) const;
+                            OpBuilder &builder, Value *numParams = nullptr,
+                            Value *paramsSize = nullptr) const;
   Value generateKernelNameConstant(StringRef moduleName, StringRef name,
                                    Location loc, OpBuilder &builder) const;
 
@@ -684,7 +718,7 @@ void GpuToLLVMConversionPass::runOnOperation() {
   populateAsyncStructuralTypeConversionsAndLegality(converter, patterns,
                                                     target);
   populateGpuToLLVMConversionPatterns(converter, patterns, gpuBinaryAnnotation,
-                                      kernelBarePtrCallConv);
+                                      kernelBarePtrCallConv, captureGraphs);
 
   if (failed(
           applyPartialConversion(getOperation(), target, std::move(patterns))))
@@ -982,7 +1016,12 @@ LogicalResult ConvertWaitOpToGpuRuntimeCallPattern::matchAndRewrite(
   Location loc = waitOp.getLoc();
 
   for (auto operand : adaptor.getOperands()) {
-    if (isDefinedByCallTo(operand, streamCreateCallBuilder.functionName)) {
+    if (isDefinedByCallTo(operand, graphBeginCallBuilder.functionName)) {
+      // The converted operand's definition began a graph recording, which
+      // launches the graph and synchronizes with it.
+      graphEndCallBuilder.create(loc, rewriter, {operand});
+    } else if (isDefinedByCallTo(operand,
+                                 streamCreateCallBuilder.functionName)) {
       // The converted operand's definition created a stream.
       streamSynchronizeCallBuilder.create(loc, rewriter, {operand});
       streamDestroyCallBuilder.create(loc, rewriter, {operand});
@@ -998,11 +1037,67 @@ LogicalResult ConvertWaitOpToGpuRuntimeCallPattern::matchAndRewrite(
   return success();
 }
 
+// Returns whether the token of `waitOp` starts a sequence of async kernel
+// launches in the block of `waitOp`, each of which only depends on the
+// previous one, that ends with a `gpu.wait` of the last launch.
+static bool startsLaunchSequence(gpu::WaitOp waitOp) {
+  Value token = waitOp.getAsyncToken();
+  unsigned numLaunches = 0;
+  while (token.hasOneUse()) {
+    Operation *user = *token.getUsers().begin();
+    if (user->getBlock() != waitOp->getBlock())
+      return false;
+    if (auto endOp = dyn_cast<gpu::WaitOp>(user))
+      return numLaunches && !endOp.getAsyncToken() &&
+             endOp.getAsyncDependencies().size() == 1;
+    auto launchOp = dyn_cast<gpu::LaunchFuncOp>(user);
+    if (!launchOp || !launchOp.getAsyncToken() ||
+        launchOp.getAsyncDependencies().size() != 1)
+      return false;
+    token = launchOp.getAsyncToken();
+    ++numLaunches;
+  }
+  return false;
+}
+
+// Creates a null-initialized LLVM global in `module` that the runtime caches
+// the graph of a launch sequence in, and returns its address:
+//
+// llvm.mlir.global internal @gpu_graph_cache(0 : i64) : i64
+Value ConvertWaitAsyncOpToGpuRuntimeCallPattern::generateGraphCache(
+    Location loc, ModuleOp module, OpBuilder &builder) const {
+  std::string name = "gpu_graph_cache";
+  for (unsigned i = 0; module.lookupSymbol(name); ++i)
+    name = llvm::formatv("gpu_graph_cache_{0}", i);
+
+  LLVM::GlobalOp global;
+  {
+    OpBuilder::InsertionGuard guard(builder);
+    builder.setInsertionPointToStart(module.getBody());
+    global = builder.create<LLVM::GlobalOp>(
+        loc, llvmIntPtrType, /*isConstant=*/false, LLVM::Linkage::Internal,
+        name, builder.getIntegerAttr(llvmIntPtrType, 0));
+  }
+  Value address = builder.create<LLVM::AddressOfOp>(
+      loc, getTypeConverter()->getPointerType(llvmIntPtrType),
+      global.getSymNameAttr());
+  if (!getTypeConverter()->useOpaquePointers())
+    address = builder.create<LLVM::BitcastOp>(loc, llvmPointerType, address);
+  return address;
+}
+
 // Converts `gpu.wait async` to runtime calls. The converted op creates a new
 // stream that is synchronized with stream/event operands. The operands are
 // destroyed. That is, it assumes that it is not used afterwards or elsewhere.
 // Otherwise we will get a runtime error. Eventually, we should guarantee this
 // property.
+//
+// When capturing graphs, the op that starts a sequence of kernel launches
+// begins a graph recording instead, which the launches add to and which the
+// `gpu.wait` ending the sequence replays:
+//
+// %0 = llvm.mlir.addressof @gpu_graph_cache
+// %1 = call %graphBegin(%0)
 LogicalResult ConvertWaitAsyncOpToGpuRuntimeCallPattern::matchAndRewrite(
     gpu::WaitOp waitOp, OpAdaptor adaptor,
     ConversionPatternRewriter &rewriter) const {
@@ -1011,6 +1106,16 @@ LogicalResult ConvertWaitAsyncOpToGpuRuntimeCallPattern::matchAndRewrite(
 
   Location loc = waitOp.getLoc();
 
+  if (captureGraphs && waitOp.getAsyncDependencies().empty() &&
+      startsLaunchSequence(waitOp)) {
+    Value cache =
+        generateGraphCache(loc, waitOp->getParentOfType<ModuleOp>(), rewriter);
+    auto recording =
+        graphBeginCallBuilder.create(loc, rewriter, {cache}).getResult();
+    rewriter.replaceOp(waitOp, {recording});
+    return success();
+  }
+
   auto insertionPoint = rewriter.saveInsertionPoint();
   SmallVector<Value, 1> events;
   for (auto pair :
@@ -1054,8 +1159,12 @@ LogicalResult ConvertWaitAsyncOpToGpuRuntimeCallPattern::matchAndRewrite(
 //   %elementPtr = llvm.getelementptr %array[i]
 //   llvm.store %fieldPtr, %elementPtr
 // return %array
+//
+// The number of parameters and the size of the struct are returned in
+// `numParams` and `paramsSize` if they are provided.
 Value ConvertLaunchFuncOpToGpuRuntimeCallPattern::generateParamsArray(
-    gpu::LaunchFuncOp launchOp, OpAdaptor adaptor, OpBuilder &builder) const {
+    gpu::LaunchFuncOp launchOp, OpAdaptor adaptor, OpBuilder &builder,
+    Value *numParams, Value *paramsSize) const {
   auto loc = launchOp.getLoc();
   auto numKernelOperands = launchOp.getNumKernelOperands();
   SmallVector<Value, 4> arguments;
@@ -1104,6 +1213,17 @@ Value ConvertLaunchFuncOpToGpuRuntimeCallPattern::generateParamsArray(
           builder.create<LLVM::BitcastOp>(loc, llvmPointerType, fieldPtr);
     builder.create<LLVM::StoreOp>(loc, fieldPtr, elementPtr);
   }
+  if (numParams)
+    *numParams =
+        builder.create<LLVM::ConstantOp>(loc, llvmIntPtrType, numArguments);
+  if (paramsSize) {
+    // The size of the struct is the offset of the next struct from null.
+    auto nullPtr = builder.create<LLVM::NullOp>(
+        loc, getTypeConverter()->getPointerType(structType));
+    auto gep = builder.create<LLVM::GEPOp>(loc, nullPtr.getType(), structType,
+                                           nullPtr, ArrayRef<LLVM::GEPArg>{1});
+    *paramsSize = builder.create<LLVM::PtrToIntOp>(loc, llvmIntPtrType, gep);
+  }
   return arrayPtr;
 }
 
@@ -1148,6 +1268,16 @@ Value ConvertLaunchFuncOpToGpuRuntimeCallPattern::generateKernelNameConstant(
 //
 // If the op is async, the stream corresponds to the (single) async dependency
 // as well as the async token the op produces.
+//
+// If the async dependency is a graph recording, the launch is added to the
+// recording instead. The module is then loaded by the runtime, and stays
+// loaded for the graph to be replayed:
+//
+// %0 = call %binarygetter
+// %1 = <see generateKernelNameConstant>
+// %2 = <see generateParamsArray>
+// call %graphLaunchKernel(%recording, %0, %1, <launchOp operands 0..5>, 0, %2,
+//                         <number and size of the parameters>)
 LogicalResult ConvertLaunchFuncOpToGpuRuntimeCallPattern::matchAndRewrite(
     gpu::LaunchFuncOp launchOp, OpAdaptor adaptor,
     ConversionPatternRewriter &rewriter) const {
@@ -1187,6 +1317,31 @@ LogicalResult ConvertLaunchFuncOpToGpuRuntimeCallPattern::matchAndRewrite(
       loc, rewriter, nameBuffer.str(), binaryAttr.getValue(),
       LLVM::Linkage::Internal, getTypeConverter()->useOpaquePointers());
 
+  Value zero = rewriter.create<LLVM::ConstantOp>(loc, llvmInt32Type, 0);
+  Value dynamicSharedMemorySize = launchOp.getDynamicSharedMemorySize()
+                                      ? launchOp.getDynamicSharedMemorySize()
+                                      : zero;
+  if (!adaptor.getAsyncDependencies().empty() &&
+      isDefinedByCallTo(adaptor.getAsyncDependencies().front(),
+                        graphBeginCallBuilder.functionName)) {
+    Value recording = adaptor.getAsyncDependencies().front();
+    auto kernelName = generateKernelNameConstant(
+        launchOp.getKernelModuleName().getValue(),
+        launchOp.getKernelName().getValue(), loc, rewriter);
+    Value numParams, paramsSize;
+    auto kernelParams = generateParamsArray(launchOp, adaptor, rewriter,
+                                            &numParams, &paramsSize);
+    graphLaunchKernelCallBuilder.create(
+        loc, rewriter,
+        {recording, data, kernelName, adaptor.getGridSizeX(),
+         adaptor.getGridSizeY(), adaptor.getGridSizeZ(),
+         adaptor.getBlockSizeX(), adaptor.getBlockSizeY(),
+         adaptor.getBlockSizeZ(), dynamicSharedMemorySize, kernelParams,
+         numParams, paramsSize});
+    rewriter.replaceOp(launchOp, {recording});
+    return success();
+  }
+
   auto module = moduleLoadCallBuilder.create(loc, rewriter, data);
   // Get the function from the module. The name corresponds to the name of
   // the kernel function.
@@ -1195,7 +1350,6 @@ LogicalResult ConvertLaunchFuncOpToGpuRuntimeCallPattern::matchAndRewrite(
       launchOp.getKernelName().getValue(), loc, rewriter);
   auto function = moduleGetFunctionCallBuilder.create(
       loc, rewriter, {module.getResult(), kernelName});
-  Value zero = rewriter.create<LLVM::ConstantOp>(loc, llvmInt32Type, 0);
   Value stream =
       adaptor.getAsyncDependencies().empty()
           ? streamCreateCallBuilder.create(loc, rewriter, {}).getResult()
@@ -1203,9 +1357,6 @@ LogicalResult ConvertLaunchFuncOpToGpuRuntimeCallPattern::matchAndRewrite(
   // Create array of pointers to kernel arguments.
   auto kernelParams = generateParamsArray(launchOp, adaptor, rewriter);
   auto nullpointer = rewriter.create<LLVM::NullOp>(loc, llvmPointerPointerType);
-  Value dynamicSharedMemorySize = launchOp.getDynamicSharedMemorySize()
-                                      ? launchOp.getDynamicSharedMemorySize()
-                                      : zero;
   launchKernelCallBuilder.create(
       loc, rewriter,
       {function.getResult(), adaptor.getGridSizeX(), adaptor.getGridSizeY(),
@@ -1780,7 +1931,8 @@ LogicalResult ConvertSDDMMOpToGpuRuntimeCallPattern::matchAndRewrite(
 void mlir::populateGpuToLLVMConversionPatterns(LLVMTypeConverter &converter,
                                                RewritePatternSet &patterns,
                                                StringRef gpuBinaryAnnotation,
-                                               bool kernelBarePtrCallConv) {
+                                               bool kernelBarePtrCallConv,
+                                               bool captureGraphs) {
   addOpaquePointerConversion<gpu::AsyncTokenType>(converter);
   addOpaquePointerConversion<gpu::SparseDnTensorHandleType>(converter);
   addOpaquePointerConversion<gpu::SparseSpMatHandleType>(converter);
@@ -1792,7 +1944,6 @@ void mlir::populateGpuToLLVMConversionPatterns(LLVMTypeConverter &converter,
                ConvertMemcpyOpToGpuRuntimeCallPattern,
                ConvertMemsetOpToGpuRuntimeCallPattern,
                ConvertSetDefaultDeviceOpToGpuRuntimeCallPattern,
-               ConvertWaitAsyncOpToGpuRuntimeCallPattern,
                ConvertWaitOpToGpuRuntimeCallPattern,
                ConvertAsyncYieldToGpuRuntimeCallPattern,
                ConvertCreateDnTensorOpToGpuRuntimeCallPattern,
@@ -1808,6 +1959,8 @@ void mlir::populateGpuToLLVMConversionPatterns(LLVMTypeConverter &converter,
                ConvertSpMMOpToGpuRuntimeCallPattern,
                ConvertSDDMMBufferSizeOpToGpuRuntimeCallPattern,
                ConvertSDDMMOpToGpuRuntimeCallPattern>(converter);
+  patterns.add<ConvertWaitAsyncOpToGpuRuntimeCallPattern>(converter,
+                                                          captureGraphs);
   patterns.add<ConvertLaunchFuncOpToGpuRuntimeCallPattern>(
       converter, gpuBinaryAnnotation, kernelBarePtrCallConv);
   patterns.add<EraseGpuModuleOpPattern>(&converter.getContext());
@@ -21,6 +21,7 @@
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Matchers.h"
 #include "mlir/Transforms/DialectConversion.h"
+#include "llvm/Support/MathExtras.h"
 #include <optional>
 
 using namespace mlir;
@@ -577,6 +578,112 @@ public:
   }
 };
 
+/// Returns true if the values of `type` can be combined with `opType` by the
+/// ops of createShuffleReduceCombiner.
+static bool isShuffleReduceSupported(gpu::AllReduceOperation opType,
+                                     Type type) {
+  using ReduceType = gpu::AllReduceOperation;
+  if (isa<FloatType>(type))
+    return opType == ReduceType::ADD || opType == ReduceType::MUL ||
+           opType == ReduceType::MIN || opType == ReduceType::MAX;
+  // The bitwise ops do not accept booleans.
+  return isa<IntegerType>(type) && !type.isInteger(1);
+}
+
+/// Creates the SPIR-V op combining `lhs` and `rhs` with `opType`.
+static Value createShuffleReduceCombiner(OpBuilder &builder, Location loc,
+                                         gpu::AllReduceOperation opType,
+                                         Value lhs, Value rhs, bool forShader) {
+  using ReduceType = gpu::AllReduceOperation;
+  Type type = lhs.getType();
+  if (isa<FloatType>(type)) {
+    switch (opType) {
+    case ReduceType::ADD:
+      return builder.create<spirv::FAddOp>(loc, lhs, rhs);
+    case ReduceType::MUL:
+      return builder.create<spirv::FMulOp>(loc, lhs, rhs);
+    case ReduceType::MIN:
+      if (forShader)
+        return builder.create<spirv::GLFMinOp>(loc, lhs, rhs);
+      return builder.create<spirv::CLFMinOp>(loc, lhs, rhs);
+    case ReduceType::MAX:
+      if (forShader)
+        return builder.create<spirv::GLFMaxOp>(loc, lhs, rhs);
+      return builder.create<spirv::CLFMaxOp>(loc, lhs, rhs);
+    default:
+      llvm_unreachable("unsupported reduction of floats");
+    }
+  }
+
+  switch (opType) {
+  case ReduceType::ADD:
+    return builder.create<spirv::IAddOp>(loc, lhs, rhs);
+  case ReduceType::MUL:
+    return builder.create<spirv::IMulOp>(loc, lhs, rhs);
+  case ReduceType::MIN:
+    if (forShader)
+      return builder.create<spirv::GLSMinOp>(loc, lhs, rhs);
+    return builder.create<spirv::CLSMinOp>(loc, lhs, rhs);
+  case ReduceType::MAX:
+    if (forShader)
+      return builder.create<spirv::GLSMaxOp>(loc, lhs, rhs);
+    return builder.create<spirv::CLSMaxOp>(loc, lhs, rhs);
+  case ReduceType::AND:
+    return builder.create<spirv::BitwiseAndOp>(loc, lhs, rhs);
+  case ReduceType::OR:
+    return builder.create<spirv::BitwiseOrOp>(loc, lhs, rhs);
+  case ReduceType::XOR:
+    return builder.create<spirv::BitwiseXorOp>(loc, lhs, rhs);
+  }
+  llvm_unreachable("unhandled reduction op");
+}
+
+/// Pattern to convert a uniform gpu.subgroup_reduce op into a butterfly of
+/// spirv.GroupNonUniformShuffleXor ops. This has a lower benefit than the
+/// conversion into a SPIR-V group op, and serves the reductions without group
+/// ops and the targets without the group arithmetic capabilities.
+class GPUSubgroupReduceShuffleConversion final
+    : public OpConversionPattern<gpu::SubgroupReduceOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(gpu::SubgroupReduceOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    // The shuffles read the values of all the invocations of the subgroup.
+    if (!op.getUniform())
+      return rewriter.notifyMatchFailure(op, "non-uniform reduction");
+
+    const spirv::TargetEnv &targetEnv =
+        getTypeConverter<SPIRVTypeConverter>()->getTargetEnv();
+    unsigned subgroupSize =
+        targetEnv.getAttr().getResourceLimits().getSubgroupSize();
+    if (!llvm::isPowerOf2_32(subgroupSize))
+      return rewriter.notifyMatchFailure(
+          op, "target subgroup size is not a power of 2");
+    if (!isShuffleReduceSupported(op.getOp(), adaptor.getValue().getType()))
+      return rewriter.notifyMatchFailure(op, "unsupported reduction type");
+    bool forShader = targetEnv.allows(spirv::Capability::Shader);
+
+    // After log2(subgroupSize) steps, each invocation has combined the values
+    // of all the invocations whose ids differ from its own in any bit.
+    Location loc = op.getLoc();
+    auto scope = rewriter.getAttr<spirv::ScopeAttr>(spirv::Scope::Subgroup);
+    Value result = adaptor.getValue();
+    for (unsigned offset = 1; offset < subgroupSize; offset <<= 1) {
+      Value mask = rewriter.create<spirv::ConstantOp>(
+          loc, rewriter.getI32Type(), rewriter.getI32IntegerAttr(offset));
+      Value shuffled = rewriter.create<spirv::GroupNonUniformShuffleXorOp>(
+          loc, scope, result, mask);
+      result = createShuffleReduceCombiner(rewriter, loc, op.getOp(), result,
+                                           shuffled, forShader);
+    }
+
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
 //===----------------------------------------------------------------------===//
 // GPU To SPIRV Patterns.
 //===----------------------------------------------------------------------===//
@@ -601,4 +708,6 @@ void mlir::populateGPUToSPIRVPatterns(SPIRVTypeConverter &typeConverter,
                                       spirv::BuiltIn::SubgroupSize>,
       WorkGroupSizeConversion, GPUAllReduceConversion,
       GPUSubgroupReduceConversion>(typeConverter, patterns.getContext());
+  patterns.add<GPUSubgroupReduceShuffleConversion>(
+      typeConverter, patterns.getContext(), /*benefit=*/0);
 }
@@ -0,0 +1,225 @@
+//===- MLProgramToLLVM.cpp - MLProgram to LLVM dialect conversion ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Conversion/MLProgramToLLVM/MLProgramToLLVM.h"
+
+#include "mlir/Conversion/LLVMCommon/MemRefBuilder.h"
+#include "mlir/Conversion/LLVMCommon/Pattern.h"
+#include "mlir/Conversion/LLVMCommon/TypeConverter.h"
+#include "mlir/Dialect/LLVMIR/FunctionCallUtils.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Dialect/MLProgram/IR/MLProgram.h"
+#include "mlir/IR/FunctionInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+#define GEN_PASS_DEF_CONVERTMLPROGRAMTOLLVMPASS
+#include "mlir/Conversion/Passes.h.inc"
+} // namespace mlir
+
+using namespace mlir;
+using namespace mlir::ml_program;
+
+/// The module initializer called by the `ExecutionEngine`, see
+/// `ExecutionEngine::kModuleInitFnName`.
+static constexpr StringLiteral kModuleInitFnName = "__mlir_module_init";
+
+/// The function of the C runner utils mapping the external storage.
+static constexpr StringLiteral kMapExternalStorageFnName =
+    "mlirMapExternalStorage";
+
+/// Returns the `llvm.mlir.global` a global with external storage was lowered
+/// to, or null if `global` does not refer to one.
+static LLVM::GlobalOp getLoweredGlobal(Operation *op, SymbolRefAttr global) {
+  return SymbolTable::lookupNearestSymbolFrom<LLVM::GlobalOp>(op, global);
+}
+
+namespace {
+/// Lowers a load of a global with external storage to a load of the address
+/// of its storage, described as a memref of static shape.
+template <typename LoadOp>
+struct GlobalLoadOpLowering : public ConvertOpToLLVMPattern<LoadOp> {
+  using ConvertOpToLLVMPattern<LoadOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(LoadOp op, typename LoadOp::Adaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto type = dyn_cast<MemRefType>(op.getResult().getType());
+    LLVM::GlobalOp global = getLoweredGlobal(op, op.getGlobalAttr());
+    if (!type || !global)
+      return rewriter.notifyMatchFailure(
+          op, "expected a load of a memref global with external storage");
+
+    Location loc = op.getLoc();
+    auto ptrType = LLVM::LLVMPointerType::get(op.getContext());
+    Value address =
+        rewriter.create<LLVM::AddressOfOp>(loc, ptrType, global.getSymName());
+    Value storage = rewriter.create<LLVM::LoadOp>(loc, ptrType, address);
+    Value descriptor = MemRefDescriptor::fromStaticShape(
+        rewriter, loc, *this->getTypeConverter(), type, storage);
+    rewriter.replaceOp(op, descriptor);
+    return success();
+  }
+};
+} // namespace
+
+void mlir::ml_program::populateMLProgramToLLVMConversionPatterns(
+    LLVMTypeConverter &converter, RewritePatternSet &patterns) {
+  patterns.add<GlobalLoadOpLowering<GlobalLoadOp>,
+               GlobalLoadOpLowering<GlobalLoadConstOp>>(converter);
+}
+
+//===----------------------------------------------------------------------===//
+// Pass Definition
+//===----------------------------------------------------------------------===//
+
+/// Checks that `global` has a supported type and is only loaded from.
+static LogicalResult verifyExternalStorageGlobal(GlobalOp global,
+                                                 ModuleOp module) {
+  auto type = dyn_cast<MemRefType>(global.getType());
+  if (!type || !type.hasStaticShape() || !type.getLayout().isIdentity() ||
+      type.getMemorySpace())
+    return global.emitOpError()
+           << "with external storage must have a statically shaped memref "
+              "type with the identity layout";
+
+  std::optional<SymbolTable::UseRange> uses =
+      SymbolTable::getSymbolUses(global, module);
+  if (!uses)
+    return global.emitOpError() << "has unknown uses";
+  for (SymbolTable::SymbolUse use : *uses) {
+    if (!isa<GlobalLoadOp, GlobalLoadConstOp>(use.getUser()))
+      return use.getUser()->emitOpError()
+             << "cannot use the global with external storage "
+             << global.getSymName();
+  }
+  return success();
+}
+
+/// Returns the entry block of the module initializer, creating the
+/// initializer if the module does not define it.
+static FailureOr<Block *> getOrCreateModuleInit(ModuleOp module) {
+  Operation *init = SymbolTable::lookupSymbolIn(module, kModuleInitFnName);
+  if (init) {
+    auto initFn = dyn_cast<FunctionOpInterface>(init);
+    if (!initFn || initFn.isExternal())
+      return init->emitOpError()
+             << "expected to define the module initializer";
+    return &initFn.getFunctionBody().front();
+  }
+
+  MLIRContext *ctx = module.getContext();
+  auto builder = OpBuilder::atBlockEnd(module.getBody());
+  auto initFn = builder.create<LLVM::LLVMFuncOp>(
+      module.getLoc(), kModuleInitFnName,
+      LLVM::LLVMFunctionType::get(LLVM::LLVMVoidType::get(ctx), {}));
+  Block *entry = initFn.addEntryBlock();
+  builder.setInsertionPointToStart(entry);
+  builder.create<LLVM::ReturnOp>(module.getLoc(), ValueRange());
+  return entry;
+}
+
+/// Maps the storage of `global` in the initializer being built by `builder`,
+/// and replaces `global` by an `llvm.mlir.global` holding its address.
+static void lowerExternalStorageGlobal(GlobalOp global, OpBuilder &builder,
+                                       LLVM::LLVMFuncOp mapFn) {
+  Location loc = global.getLoc();
+  auto storage = cast<ExternalStorageAttr>(global.getValueAttr());
+  auto ptrType = LLVM::LLVMPointerType::get(builder.getContext());
+
+  // The path is passed as a C string.
+  std::string path = storage.getPath().str();
+  path.push_back('\0');
+  Value pathPtr = LLVM::createGlobalString(
+      loc, builder, (global.getSymName() + "_external_storage_path").str(),
+      path, LLVM::Linkage::Internal, /*useOpaquePointers=*/true);
+  Type i64Type = builder.getI64Type(), i32Type = builder.getI32Type();
+  Value offset = builder.create<LLVM::ConstantOp>(
+      loc, i64Type, builder.getI64IntegerAttr(storage.getOffset()));
+  Value size = builder.create<LLVM::ConstantOp>(
+      loc, i64Type, builder.getI64IntegerAttr(storage.getSize()));
+  Value isMutable = builder.create<LLVM::ConstantOp>(
+      loc, i32Type, builder.getI32IntegerAttr(global.getIsMutable()));
+  Value address =
+      builder
+          .create<LLVM::CallOp>(loc, mapFn,
+                                ValueRange{pathPtr, offset, size, isMutable})
+          .getResult();
+  Value globalPtr =
+      builder.create<LLVM::AddressOfOp>(loc, ptrType, global.getSymName());
+  builder.create<LLVM::StoreOp>(loc, address, globalPtr);
+
+  // The address is null until the module is initialized.
+  OpBuilder globalBuilder(global);
+  auto lowered = globalBuilder.create<LLVM::GlobalOp>(
+      loc, ptrType, /*isConstant=*/false,
+      global.isPrivate() ? LLVM::Linkage::Internal : LLVM::Linkage::External,
+      global.getSymName(), Attribute());
+  globalBuilder.createBlock(&lowered.getInitializerRegion());
+  Value null = globalBuilder.create<LLVM::NullOp>(loc, ptrType);
+  globalBuilder.create<LLVM::ReturnOp>(loc, null);
+  global.erase();
+}
+
+namespace {
+struct ConvertMLProgramToLLVMPass
+    : public impl::ConvertMLProgramToLLVMPassBase<ConvertMLProgramToLLVMPass> {
+  using Base::Base;
+
+  void runOnOperation() override;
+};
+} // namespace
+
+void ConvertMLProgramToLLVMPass::runOnOperation() {
+  ModuleOp module = getOperation();
+  MLIRContext *ctx = &getContext();
+  SmallVector<GlobalOp> globals;
+  for (GlobalOp global : module.getOps<GlobalOp>()) {
+    if (!isa_and_nonnull<ExternalStorageAttr>(global.getValueAttr()))
+      continue;
+    if (failed(verifyExternalStorageGlobal(global, module)))
+      return signalPassFailure();
+    globals.push_back(global);
+  }
+  if (globals.empty())
+    return;
+
+  // Map the storage before the rest of the module initializer runs.
+  FailureOr<Block *> init = getOrCreateModuleInit(module);
+  if (failed(init))
+    return signalPassFailure();
+  auto ptrType = LLVM::LLVMPointerType::get(ctx);
+  LLVM::LLVMFuncOp mapFn = LLVM::lookupOrCreateFn(
+      module, kMapExternalStorageFnName,
+      {ptrType, IntegerType::get(ctx, 64), IntegerType::get(ctx, 64),
+       IntegerType::get(ctx, 32)},
+      ptrType);
+  auto builder = OpBuilder::atBlockBegin(*init);
+  for (GlobalOp global : globals)
+    lowerExternalStorageGlobal(global, builder, mapFn);
+
+  // Set LLVM lowering options.
+  LowerToLLVMOptions options(ctx);
+  if (indexBitwidth != kDeriveIndexBitwidthFromDataLayout)
+    options.overrideIndexBitwidth(indexBitwidth);
+  LLVMTypeConverter typeConverter(ctx, options);
+
+  // Lower the loads of the lowered globals.
+  ConversionTarget target(*ctx);
+  target.addLegalDialect<LLVM::LLVMDialect>();
+  target.addDynamicallyLegalOp<GlobalLoadOp>([](GlobalLoadOp op) {
+    return !getLoweredGlobal(op, op.getGlobalAttr());
+  });
+  target.addDynamicallyLegalOp<GlobalLoadConstOp>([](GlobalLoadConstOp op) {
+    return !getLoweredGlobal(op, op.getGlobalAttr());
+  });
+  RewritePatternSet patterns(ctx);
+  populateMLProgramToLLVMConversionPatterns(typeConverter, patterns);
+  if (failed(applyPartialConversion(module, target, std::move(patterns))))
+    signalPassFailure();
+}
@@ -688,11 +688,286 @@ struct NVGPUAsyncWaitLowering
   }
 };
 
+/// Emits the PTX `asmString` as inline assembly with side effects, taking the
+/// `operands` with the `constraints`.
+static LLVM::InlineAsmOp createPtxAsm(ConversionPatternRewriter &rewriter,
+                                      Location loc, TypeRange resultTypes,
+                                      ValueRange operands, StringRef asmString,
+                                      StringRef constraints) {
+  auto asmDialectAttr = LLVM::AsmDialectAttr::get(rewriter.getContext(),
+                                                  LLVM::AsmDialect::AD_ATT);
+  return rewriter.create<LLVM::InlineAsmOp>(
+      loc, resultTypes, operands, asmString, constraints,
+      /*has_side_effects=*/true, /*is_align_stack=*/false,
+      /*asm_dialect=*/asmDialectAttr, /*operand_attrs=*/ArrayAttr());
+}
+
+/// Returns the 32-bit shared memory address that the PTX instructions take
+/// for `ptr`, a pointer to shared memory.
+static Value getSharedAddress(ConversionPatternRewriter &rewriter, Location loc,
+                              Value ptr) {
+  return rewriter.create<LLVM::PtrToIntOp>(loc, rewriter.getI32Type(), ptr);
+}
+
+/// Base class of the lowerings of the ops that take an mbarrier.
+template <typename SourceOp>
+struct MBarrierOpLowering : public ConvertOpToLLVMPattern<SourceOp> {
+  using ConvertOpToLLVMPattern<SourceOp>::ConvertOpToLLVMPattern;
+
+protected:
+  /// Returns the pointer to the mbarrier at `indices` of `barriers`.
+  Value getBarrierPtr(ConversionPatternRewriter &rewriter, Location loc,
+                      Value barriers, Value adaptedBarriers,
+                      ValueRange indices) const {
+    return this->getStridedElementPtr(loc,
+                                      cast<MemRefType>(barriers.getType()),
+                                      adaptedBarriers, indices, rewriter);
+  }
+};
+
+struct NVGPUMBarrierInitLowering
+    : public MBarrierOpLowering<nvgpu::MBarrierInitOp> {
+  using MBarrierOpLowering<nvgpu::MBarrierInitOp>::MBarrierOpLowering;
+
+  LogicalResult
+  matchAndRewrite(nvgpu::MBarrierInitOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op->getLoc();
+    Value barrier = getBarrierPtr(rewriter, loc, op.getBarriers(),
+                                  adaptor.getBarriers(), adaptor.getIndices());
+    Value count = rewriter.create<LLVM::TruncOp>(loc, rewriter.getI32Type(),
+                                                 adaptor.getCount());
+    rewriter.replaceOpWithNewOp<NVVM::MBarrierInitSharedOp>(op, barrier,
+                                                            count);
+    return success();
+  }
+};
+
+struct NVGPUMBarrierArriveExpectTxLowering
+    : public MBarrierOpLowering<nvgpu::MBarrierArriveExpectTxOp> {
+  using MBarrierOpLowering<
+      nvgpu::MBarrierArriveExpectTxOp>::MBarrierOpLowering;
+
+  LogicalResult
+  matchAndRewrite(nvgpu::MBarrierArriveExpectTxOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op->getLoc();
+    Value barrier = getBarrierPtr(rewriter, loc, op.getBarriers(),
+                                  adaptor.getBarriers(), adaptor.getIndices());
+    Value txCount = rewriter.create<LLVM::TruncOp>(loc, rewriter.getI32Type(),
+                                                   adaptor.getTxCount());
+    createPtxAsm(rewriter, loc, {},
+                 {getSharedAddress(rewriter, loc, barrier), txCount},
+                 "mbarrier.arrive.expect_tx.shared::cta.b64 _, [$0], $1;",
+                 "r,r");
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+struct NVGPUMBarrierTryWaitParityLowering
+    : public MBarrierOpLowering<nvgpu::MBarrierTryWaitParityOp> {
+  using MBarrierOpLowering<
+      nvgpu::MBarrierTryWaitParityOp>::MBarrierOpLowering;
+
+  LogicalResult
+  matchAndRewrite(nvgpu::MBarrierTryWaitParityOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op->getLoc();
+    Value barrier = getBarrierPtr(rewriter, loc, op.getBarriers(),
+                                  adaptor.getBarriers(), adaptor.getIndices());
+    Value phase = rewriter.create<LLVM::ZExtOp>(loc, rewriter.getI32Type(),
+                                                adaptor.getPhase());
+    // `mbarrier.try_wait` returns when the phase completes or after a time
+    // limit, hence the loop. The label is local to the braces.
+    const char *asmStr =
+        "{\n"
+        ".reg .pred p;\n"
+        "LAB_WAIT:\n"
+        "mbarrier.try_wait.parity.shared::cta.b64 p, [$0], $1;\n"
+        "@!p bra.uni LAB_WAIT;\n"
+        "}\n";
+    createPtxAsm(rewriter, loc, {},
+                 {getSharedAddress(rewriter, loc, barrier), phase}, asmStr,
+                 "r,r");
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+struct NVGPUTmaAsyncLoadLowering
+    : public MBarrierOpLowering<nvgpu::TmaAsyncLoadOp> {
+  using MBarrierOpLowering<nvgpu::TmaAsyncLoadOp>::MBarrierOpLowering;
+
+  LogicalResult
+  matchAndRewrite(nvgpu::TmaAsyncLoadOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op->getLoc();
+    auto dstMemrefType = cast<MemRefType>(op.getDst().getType());
+    Value zero = createIndexConstant(rewriter, loc, 0);
+    SmallVector<Value> dstIndices(dstMemrefType.getRank(), zero);
+    Value dst = getStridedElementPtr(loc, dstMemrefType, adaptor.getDst(),
+                                     dstIndices, rewriter);
+    Value barrier =
+        getBarrierPtr(rewriter, loc, op.getBarriers(), adaptor.getBarriers(),
+                      adaptor.getBarrierIndices());
+
+    // PTX takes the coordinates from the innermost dimension.
+    SmallVector<Value> asmVals{getSharedAddress(rewriter, loc, dst),
+                               adaptor.getTensorMap()};
+    for (Value coordinate : llvm::reverse(adaptor.getCoordinates()))
+      asmVals.push_back(rewriter.create<LLVM::TruncOp>(
+          loc, rewriter.getI32Type(), coordinate));
+    asmVals.push_back(getSharedAddress(rewriter, loc, barrier));
+
+    size_t rank = adaptor.getCoordinates().size();
+    std::string asmStr;
+    llvm::raw_string_ostream ss(asmStr);
+    ss << "cp.async.bulk.tensor." << rank
+       << "d.shared::cluster.global.mbarrier::complete_tx::bytes [$0], [$1, {";
+    for (size_t i = 0; i < rank; ++i)
+      ss << (i ? ", " : "") << "$" << i + 2;
+    ss << "}], [$" << rank + 2 << "];";
+    std::string constraints = "r,l";
+    for (size_t i = 0; i <= rank; ++i)
+      constraints += ",r";
+
+    createPtxAsm(rewriter, loc, {}, asmVals, ss.str(), constraints);
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+struct NVGPUWarpgroupGenerateDescriptorLowering
+    : public ConvertOpToLLVMPattern<nvgpu::WarpgroupGenerateDescriptorOp> {
+  using ConvertOpToLLVMPattern<
+      nvgpu::WarpgroupGenerateDescriptorOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(nvgpu::WarpgroupGenerateDescriptorOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op->getLoc();
+    auto memrefType = cast<MemRefType>(op.getTensor().getType());
+    Value zero = createIndexConstant(rewriter, loc, 0);
+    SmallVector<Value> indices(memrefType.getRank(), zero);
+    Value ptr = getStridedElementPtr(loc, memrefType, adaptor.getTensor(),
+                                     indices, rewriter);
+
+    // The descriptor holds the start address and the byte offsets in units of
+    // 16 bytes on 14 bits each, at bits 0, 16 and 32, and the swizzling mode
+    // at bits 62-63.
+    uint64_t swizzleMode = 0;
+    switch (op.getSwizzle()) {
+    case 128:
+      swizzleMode = 1;
+      break;
+    case 64:
+      swizzleMode = 2;
+      break;
+    case 32:
+      swizzleMode = 3;
+      break;
+    }
+    uint64_t staticBits = ((op.getLeadingByteOffset() >> 4) << 16) |
+                          ((op.getStrideByteOffset() >> 4) << 32) |
+                          (swizzleMode << 62);
+
+    Type i64Type = rewriter.getI64Type();
+    auto createConstant = [&](uint64_t value) -> Value {
+      return rewriter.create<LLVM::ConstantOp>(
+          loc, i64Type, rewriter.getIntegerAttr(i64Type, value));
+    };
+    Value address = rewriter.create<LLVM::PtrToIntOp>(loc, i64Type, ptr);
+    Value maskedAddress =
+        rewriter.create<LLVM::AndOp>(loc, address, createConstant(0x3FFFF));
+    Value startAddress =
+        rewriter.create<LLVM::LShrOp>(loc, maskedAddress, createConstant(4));
+    rewriter.replaceOpWithNewOp<LLVM::OrOp>(op, startAddress,
+                                            createConstant(staticBits));
+    return success();
+  }
+};
+
+struct NVGPUWarpgroupMmaLowering
+    : public ConvertOpToLLVMPattern<nvgpu::WarpgroupMmaOp> {
+  using ConvertOpToLLVMPattern<nvgpu::WarpgroupMmaOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(nvgpu::WarpgroupMmaOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op->getLoc();
+    auto vectorType = cast<VectorType>(op.getMatrixC().getType());
+    int64_t numAccumulators = vectorType.getNumElements();
+    Type f32Type = rewriter.getF32Type();
+    Type i32Type = rewriter.getI32Type();
+    auto getPosition = [&](int64_t i) -> Value {
+      return rewriter.create<LLVM::ConstantOp>(loc, i32Type,
+                                               rewriter.getI32IntegerAttr(i));
+    };
+
+    // The accumulators are both the outputs and the first inputs, then come
+    // the descriptors and the predicate that enables the accumulation.
+    SmallVector<Value> asmVals;
+    for (int64_t i = 0; i < numAccumulators; ++i)
+      asmVals.push_back(rewriter.create<LLVM::ExtractElementOp>(
+          loc, adaptor.getMatrixC(), getPosition(i)));
+    asmVals.push_back(adaptor.getDescriptorA());
+    asmVals.push_back(adaptor.getDescriptorB());
+    asmVals.push_back(getPosition(1));
+
+    StringRef ptxType = op.getOperandType().isF16() ? "f16" : "bf16";
+    std::string asmStr;
+    llvm::raw_string_ostream ss(asmStr);
+    ss << "{\n"
+       << ".reg .pred p;\n"
+       << "setp.ne.b32 p, $" << 2 * numAccumulators + 2 << ", 0;\n"
+       << "wgmma.fence.sync.aligned;\n"
+       << "wgmma.mma_async.sync.aligned.m64n" << 2 * numAccumulators
+       << "k16.f32." << ptxType << "." << ptxType << " {";
+    for (int64_t i = 0; i < numAccumulators; ++i)
+      ss << (i ? ", " : "") << "$" << i;
+    ss << "}, $" << 2 * numAccumulators << ", $" << 2 * numAccumulators + 1
+       << ", p, 1, 1, " << (op.getTransposeA() ? 1 : 0) << ", "
+       << (op.getTransposeB() ? 1 : 0) << ";\n"
+       << "wgmma.commit_group.sync.aligned;\n"
+       << "wgmma.wait_group.sync.aligned 0;\n"
+       << "}\n";
+
+    std::string constraints;
+    llvm::raw_string_ostream cs(constraints);
+    for (int64_t i = 0; i < numAccumulators; ++i)
+      cs << (i ? "," : "") << "=f";
+    for (int64_t i = 0; i < numAccumulators; ++i)
+      cs << "," << i;
+    cs << ",l,l,r";
+
+    auto resultType = LLVM::LLVMStructType::getLiteral(
+        getContext(), SmallVector<Type>(numAccumulators, f32Type));
+    LLVM::InlineAsmOp asmOp = createPtxAsm(rewriter, loc, resultType, asmVals,
+                                           ss.str(), cs.str());
+
+    Value result = rewriter.create<LLVM::UndefOp>(
+        loc, typeConverter->convertType(vectorType));
+    for (int64_t i = 0; i < numAccumulators; ++i) {
+      Value accumulator =
+          rewriter.create<LLVM::ExtractValueOp>(loc, asmOp.getRes(), i);
+      result = rewriter.create<LLVM::InsertElementOp>(loc, result, accumulator,
+                                                      getPosition(i));
+    }
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
 } // namespace
 
 void mlir::populateNVGPUToNVVMConversionPatterns(LLVMTypeConverter &converter,
                                                  RewritePatternSet &patterns) {
   patterns.add<MmaSyncOptoNVVM, MmaLdMatrixOpToNVVM, NVGPUAsyncCopyLowering,
                NVGPUAsyncCreateGroupLowering, NVGPUAsyncWaitLowering,
-               NVGPUMmaSparseSyncLowering>(converter);
+               NVGPUMmaSparseSyncLowering, NVGPUMBarrierInitLowering,
+               NVGPUMBarrierArriveExpectTxLowering,
+               NVGPUMBarrierTryWaitParityLowering, NVGPUTmaAsyncLoadLowering,
+               NVGPUWarpgroupGenerateDescriptorLowering,
+               NVGPUWarpgroupMmaLowering>(converter);
 }
@@ -724,6 +724,11 @@ struct OrderedPredicate {
   /// opposed to those shared across patterns.
   unsigned secondary = 0;
 
+  /// The number of occurrences of this predicate among the patterns reaching
+  /// the matcher node being built, which is the primary sum restricted to
+  /// these patterns.
+  unsigned count = 0;
+
   /// The tie breaking ID, used to preserve a deterministic (insertion) order
   /// among all the predicates with the same priority, depth, and position /
   /// predicate dependency.
@@ -737,15 +742,17 @@ struct OrderedPredicate {
   /// model.
   bool operator<(const OrderedPredicate &rhs) const {
     // Sort by:
+    // * higher number of occurrences among the patterns of the node
     // * higher first and secondary order sums
     // * lower depth
     // * lower position dependency
     // * lower predicate dependency
     // * lower tie breaking ID
     auto *rhsPos = rhs.position;
-    return std::make_tuple(primary, secondary, rhsPos->getOperationDepth(),
-                           rhsPos->getKind(), rhs.question->getKind(), rhs.id) >
-           std::make_tuple(rhs.primary, rhs.secondary,
+    return std::make_tuple(count, primary, secondary,
+                           rhsPos->getOperationDepth(), rhsPos->getKind(),
+                           rhs.question->getKind(), rhs.id) >
+           std::make_tuple(rhs.count, rhs.primary, rhs.secondary,
                            position->getOperationDepth(), position->getKind(),
                            question->getKind(), id);
   }
@@ -779,67 +786,59 @@ struct OrderedPredicateList {
 };
 } // namespace
 
-/// Returns true if the given matcher refers to the same predicate as the given
-/// ordered predicate. This means that the position and questions of the two
-/// match.
-static bool isSamePredicate(MatcherNode *node, OrderedPredicate *predicate) {
-  return node->getPosition() == predicate->position &&
-         node->getQuestion() == predicate->question;
-}
+/// Build the matcher tree of the given patterns. The predicates are checked
+/// in the order of their number of occurrences among the patterns reaching
+/// each node, which factors out the predicates shared by the most patterns on
+/// every path of the tree, e.g. the name of the root operation. The patterns
+/// that do not check the chosen predicate are matched on the failure path of
+/// its node.
+static std::unique_ptr<MatcherNode>
+buildMatcherTree(ArrayRef<OrderedPredicateList *> lists) {
+  // Count the occurrences of the predicates left to check by the patterns.
+  SmallVector<OrderedPredicate *> candidates;
+  for (OrderedPredicateList *list : lists)
+    for (OrderedPredicate *predicate : list->predicates)
+      predicate->count = 0;
+  SmallVector<OrderedPredicateList *> matched;
+  for (OrderedPredicateList *list : lists) {
+    if (list->predicates.empty())
+      matched.push_back(list);
+    for (OrderedPredicate *predicate : list->predicates)
+      if (predicate->count++ == 0)
+        candidates.push_back(predicate);
+  }
 
-/// Get or insert a child matcher for the given parent switch node, given a
-/// predicate and parent pattern.
-std::unique_ptr<MatcherNode> &getOrCreateChild(SwitchNode *node,
-                                               OrderedPredicate *predicate,
-                                               pdl::PatternOp pattern) {
-  assert(isSamePredicate(node, predicate) &&
-         "expected matcher to equal the given predicate");
-
-  auto it = predicate->patternToAnswer.find(pattern);
-  assert(it != predicate->patternToAnswer.end() &&
-         "expected pattern to exist in predicate");
-  return node->getChildren().insert({it->second, nullptr}).first->second;
-}
+  std::unique_ptr<MatcherNode> node;
+  if (!candidates.empty()) {
+    OrderedPredicate *best = *llvm::min_element(
+        candidates, [](OrderedPredicate *lhs, OrderedPredicate *rhs) {
+          return *lhs < *rhs;
+        });
 
-/// Build the matcher CFG by "pushing" patterns through by sorted predicate
-/// order. A pattern will traverse as far as possible using common predicates
-/// and then either diverge from the CFG or reach the end of a branch and start
-/// creating new nodes.
-static void propagatePattern(std::unique_ptr<MatcherNode> &node,
-                             OrderedPredicateList &list,
-                             std::vector<OrderedPredicate *>::iterator current,
-                             std::vector<OrderedPredicate *>::iterator end) {
-  if (current == end) {
-    // We've hit the end of a pattern, so create a successful result node.
-    node =
-        std::make_unique<SuccessNode>(list.pattern, list.root, std::move(node));
-
-    // If the pattern doesn't contain this predicate, ignore it.
-  } else if (!list.predicates.contains(*current)) {
-    propagatePattern(node, list, std::next(current), end);
-
-    // If the current matcher node is invalid, create a new one for this
-    // position and continue propagation.
-  } else if (!node) {
-    // Create a new node at this position and continue
-    node = std::make_unique<SwitchNode>((*current)->position,
-                                        (*current)->question);
-    propagatePattern(
-        getOrCreateChild(cast<SwitchNode>(&*node), *current, list.pattern),
-        list, std::next(current), end);
-
-    // If the matcher has already been created, and it is for this predicate we
-    // continue propagation to the child.
-  } else if (isSamePredicate(node.get(), *current)) {
-    propagatePattern(
-        getOrCreateChild(cast<SwitchNode>(&*node), *current, list.pattern),
-        list, std::next(current), end);
-
-    // If the matcher doesn't match the current predicate, insert a branch as
-    // the common set of matchers has diverged.
-  } else {
-    propagatePattern(node->getFailureNode(), list, current, end);
+    // Partition the patterns by their answer to the predicate.
+    llvm::MapVector<Qualifier *, SmallVector<OrderedPredicateList *>> children;
+    SmallVector<OrderedPredicateList *> unchecked;
+    for (OrderedPredicateList *list : lists) {
+      if (list->predicates.erase(best))
+        children[best->patternToAnswer.lookup(list->pattern)].push_back(list);
+      else if (!list->predicates.empty())
+        unchecked.push_back(list);
+    }
+
+    auto switchNode =
+        std::make_unique<SwitchNode>(best->position, best->question);
+    for (auto &it : children)
+      switchNode->getChildren()[it.first] = buildMatcherTree(it.second);
+    switchNode->getFailureNode() = buildMatcherTree(unchecked);
+    node = std::move(switchNode);
   }
+
+  // The patterns without predicates left to check succeed before the others
+  // are matched, the last one first.
+  for (OrderedPredicateList *list : matched)
+    node = std::make_unique<SuccessNode>(list->pattern, list->root,
+                                         std::move(node));
+  return node;
 }
 
 /// Fold any switch nodes nested under `node` to boolean nodes when possible.
@@ -945,20 +944,11 @@ MatcherNode::generateMatcherTree(ModuleOp module, PredicateBuilder &builder,
       predicate->secondary += total;
   }
 
-  // Sort the set of predicates now that the cost primary and secondary sums
-  // have been computed.
-  std::vector<OrderedPredicate *> ordered;
-  ordered.reserve(uniqued.size());
-  for (auto &ip : uniqued)
-    ordered.push_back(&ip);
-  llvm::sort(ordered, [](OrderedPredicate *lhs, OrderedPredicate *rhs) {
-    return *lhs < *rhs;
-  });
-
-  // Build the matchers for each of the pattern predicate lists.
-  std::unique_ptr<MatcherNode> root;
-  for (OrderedPredicateList &list : lists)
-    propagatePattern(root, list, ordered.begin(), ordered.end());
+  // Build the matchers now that the cost primary and secondary sums have been
+  // computed.
+  SmallVector<OrderedPredicateList *> listPtrs = llvm::to_vector(
+      llvm::map_range(lists, [](OrderedPredicateList &list) { return &list; }));
+  std::unique_ptr<MatcherNode> root = buildMatcherTree(listPtrs);
 
   // Collapse the graph and insert the exit node.
   foldSwitchToBool(root);
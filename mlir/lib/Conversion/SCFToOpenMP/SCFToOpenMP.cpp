@@ -314,6 +314,45 @@ static omp::ReductionDeclareOp declareReduction(PatternRewriter &builder,
                       builder.getIntegerAttr(type, 1));
   }
 
+  // Match min/max reductions, as produced by the lowering of affine.parallel
+  // reductions, which also cannot be expressed with atomicrmw for floats.
+  if (matchSimpleReduction<arith::MaxFOp, LLVM::MaxNumOp>(reduction)) {
+    return createDecl(builder, symbolTable, reduce,
+                      minMaxValueForFloat(type, /*min=*/true));
+  }
+  if (matchSimpleReduction<arith::MinFOp, LLVM::MinNumOp>(reduction)) {
+    return createDecl(builder, symbolTable, reduce,
+                      minMaxValueForFloat(type, /*min=*/false));
+  }
+  if (matchSimpleReduction<arith::MaxSIOp, LLVM::SMaxOp>(reduction)) {
+    omp::ReductionDeclareOp decl =
+        createDecl(builder, symbolTable, reduce,
+                   minMaxValueForSignedInt(type, /*min=*/true));
+    return addAtomicRMW(builder, LLVM::AtomicBinOp::max, decl, reduce,
+                        useOpaquePointers);
+  }
+  if (matchSimpleReduction<arith::MinSIOp, LLVM::SMinOp>(reduction)) {
+    omp::ReductionDeclareOp decl =
+        createDecl(builder, symbolTable, reduce,
+                   minMaxValueForSignedInt(type, /*min=*/false));
+    return addAtomicRMW(builder, LLVM::AtomicBinOp::min, decl, reduce,
+                        useOpaquePointers);
+  }
+  if (matchSimpleReduction<arith::MaxUIOp, LLVM::UMaxOp>(reduction)) {
+    omp::ReductionDeclareOp decl =
+        createDecl(builder, symbolTable, reduce,
+                   minMaxValueForUnsignedInt(type, /*min=*/true));
+    return addAtomicRMW(builder, LLVM::AtomicBinOp::umax, decl, reduce,
+                        useOpaquePointers);
+  }
+  if (matchSimpleReduction<arith::MinUIOp, LLVM::UMinOp>(reduction)) {
+    omp::ReductionDeclareOp decl =
+        createDecl(builder, symbolTable, reduce,
+                   minMaxValueForUnsignedInt(type, /*min=*/false));
+    return addAtomicRMW(builder, LLVM::AtomicBinOp::umin, decl, reduce,
+                        useOpaquePointers);
+  }
+
   // Match select-based min/max reductions.
   bool isMin;
   if (matchSelectReduction<arith::CmpFOp, arith::SelectOp>(
@@ -341,7 +380,7 @@ static omp::ReductionDeclareOp declareReduction(PatternRewriter &builder,
           reduction, {arith::CmpIPredicate::ult, arith::CmpIPredicate::ule},
           {arith::CmpIPredicate::ugt, arith::CmpIPredicate::uge}, isMin) ||
       matchSelectReduction<LLVM::ICmpOp, LLVM::SelectOp>(
-          reduction, {LLVM::ICmpPredicate::ugt, LLVM::ICmpPredicate::ule},
+          reduction, {LLVM::ICmpPredicate::ult, LLVM::ICmpPredicate::ule},
           {LLVM::ICmpPredicate::ugt, LLVM::ICmpPredicate::uge}, isMin)) {
     omp::ReductionDeclareOp decl = createDecl(
         builder, symbolTable, reduce, minMaxValueForUnsignedInt(type, !isMin));
@@ -355,13 +394,75 @@ static omp::ReductionDeclareOp declareReduction(PatternRewriter &builder,
 
 namespace {
 
+/// The schedule of the worksharing loops created from scf.parallel.
+struct LoopSchedule {
+  std::optional<omp::ClauseScheduleKind> kind;
+  /// The chunk size, if positive.
+  int64_t chunkSize = 0;
+  /// Whether the chunks of the innermost loops are multiples of the SIMD
+  /// width.
+  bool simd = false;
+};
+
 struct ParallelOpLowering : public OpRewritePattern<scf::ParallelOp> {
 
   bool useOpaquePointers;
+  LoopSchedule schedule;
 
-  ParallelOpLowering(MLIRContext *context, bool useOpaquePointers)
+  ParallelOpLowering(MLIRContext *context, bool useOpaquePointers,
+                     LoopSchedule schedule)
       : OpRewritePattern<scf::ParallelOp>(context),
-        useOpaquePointers(useOpaquePointers) {}
+        useOpaquePointers(useOpaquePointers), schedule(schedule) {}
+
+  /// Sets the schedule clause of `loop`, converted from `parallelOp`.
+  void setSchedule(omp::WsLoopOp loop, scf::ParallelOp parallelOp,
+                   PatternRewriter &rewriter) const {
+    bool isInnermost = !parallelOp.getBody()
+                            ->walk([](LoopLikeOpInterface) {
+                              return WalkResult::interrupt();
+                            })
+                            .wasInterrupted();
+    bool useSimd = schedule.simd && isInnermost;
+    if (!schedule.kind && schedule.chunkSize <= 0 && !useSimd)
+      return;
+
+    MLIRContext *context = rewriter.getContext();
+    loop.setScheduleValAttr(omp::ClauseScheduleKindAttr::get(
+        context, schedule.kind.value_or(omp::ClauseScheduleKind::Static)));
+    if (schedule.chunkSize > 0) {
+      OpBuilder::InsertionGuard guard(rewriter);
+      rewriter.setInsertionPoint(loop);
+      Value chunk = rewriter.create<LLVM::ConstantOp>(
+          loop.getLoc(), rewriter.getIntegerType(64),
+          rewriter.getI64IntegerAttr(schedule.chunkSize));
+      loop.getScheduleChunkVarMutable().assign(chunk);
+    }
+    if (useSimd)
+      loop.setSimdModifierAttr(UnitAttr::get(context));
+  }
+
+  /// Sets the number of threads of `ompParallel`, converted from
+  /// `parallelOp`, to the number of iterations of the loop if it is marked to
+  /// run each iteration on its own thread.
+  void setNumThreads(omp::ParallelOp ompParallel, scf::ParallelOp parallelOp,
+                     PatternRewriter &rewriter) const {
+    if (!parallelOp->hasAttr(scf::ParallelOp::getThreadPerIterationAttrName()))
+      return;
+
+    OpBuilder::InsertionGuard guard(rewriter);
+    rewriter.setInsertionPoint(ompParallel);
+    ImplicitLocOpBuilder b(parallelOp.getLoc(), rewriter);
+    Value numIterations = b.create<arith::ConstantIndexOp>(1);
+    for (auto [lb, ub, step] :
+         llvm::zip(parallelOp.getLowerBound(), parallelOp.getUpperBound(),
+                   parallelOp.getStep())) {
+      Value range = b.createOrFold<arith::SubIOp>(ub, lb);
+      Value tripCount = b.createOrFold<arith::CeilDivSIOp>(range, step);
+      numIterations = b.createOrFold<arith::MulIOp>(numIterations, tripCount);
+    }
+    ompParallel.getNumThreadsVarMutable().assign(
+        b.createOrFold<arith::IndexCastOp>(b.getI32Type(), numIterations));
+  }
 
   LogicalResult matchAndRewrite(scf::ParallelOp parallelOp,
                                 PatternRewriter &rewriter) const override {
@@ -411,6 +512,7 @@ struct ParallelOpLowering : public OpRewritePattern<scf::ParallelOp> {
 
     // Create the parallel wrapper.
     auto ompParallel = rewriter.create<omp::ParallelOp>(loc);
+    setNumThreads(ompParallel, parallelOp, rewriter);
     {
 
       OpBuilder::InsertionGuard guard(rewriter);
@@ -423,6 +525,7 @@ struct ParallelOpLowering : public OpRewritePattern<scf::ParallelOp> {
             parallelOp.getLoc(), parallelOp.getLowerBound(),
             parallelOp.getUpperBound(), parallelOp.getStep());
         rewriter.create<omp::TerminatorOp>(loc);
+        setSchedule(loop, parallelOp, rewriter);
 
         rewriter.inlineRegionBefore(parallelOp.getRegion(), loop.getRegion(),
                                     loop.getRegion().begin());
@@ -464,14 +567,16 @@ struct ParallelOpLowering : public OpRewritePattern<scf::ParallelOp> {
 };
 
 /// Applies the conversion patterns in the given function.
-static LogicalResult applyPatterns(ModuleOp module, bool useOpaquePointers) {
+static LogicalResult applyPatterns(ModuleOp module, bool useOpaquePointers,
+                                   LoopSchedule schedule) {
   ConversionTarget target(*module.getContext());
   target.addIllegalOp<scf::ReduceOp, scf::ReduceReturnOp, scf::ParallelOp>();
   target.addLegalDialect<omp::OpenMPDialect, LLVM::LLVMDialect,
                          memref::MemRefDialect>();
 
   RewritePatternSet patterns(module.getContext());
-  patterns.add<ParallelOpLowering>(module.getContext(), useOpaquePointers);
+  patterns.add<ParallelOpLowering>(module.getContext(), useOpaquePointers,
+                                   schedule);
   FrozenRewritePatternSet frozen(std::move(patterns));
   return applyPartialConversion(module, target, frozen);
 }
@@ -484,7 +589,17 @@ struct SCFToOpenMPPass
 
   /// Pass entry point.
   void runOnOperation() override {
-    if (failed(applyPatterns(getOperation(), useOpaquePointers)))
+    LoopSchedule loopSchedule;
+    if (!schedule.empty()) {
+      loopSchedule.kind = omp::symbolizeClauseScheduleKind(schedule);
+      if (!loopSchedule.kind) {
+        getOperation().emitError() << "invalid schedule '" << schedule << "'";
+        return signalPassFailure();
+      }
+    }
+    loopSchedule.chunkSize = chunkSize;
+    loopSchedule.simd = simd;
+    if (failed(applyPatterns(getOperation(), useOpaquePointers, loopSchedule)))
       signalPassFailure();
   }
 };
@@ -299,17 +299,29 @@ public:
 
     if (isQuantized) {
       auto quantizationInfo = *op.getQuantizationInfo();
-      auto iZp = rewriter.getI32IntegerAttr(quantizationInfo.getInputZp());
-      auto kZp = rewriter.getI32IntegerAttr(quantizationInfo.getWeightZp());
-
-      auto iZpVal = rewriter.create<arith::ConstantOp>(loc, iZp);
-      auto kZpVal = rewriter.create<arith::ConstantOp>(loc, kZp);
-      Value conv =
-          rewriter
-              .create<LinalgConvQOp>(
-                  loc, resultTy, ValueRange{input, weight, iZpVal, kZpVal},
-                  ValueRange{zeroTensor}, strideAttr, dilationAttr)
-              ->getResult(0);
+      Value conv;
+      // Without zero points, the quantized convolution is a plain convolution
+      // sign extending its operands, which vectorizes to contractions of the
+      // narrow integers that the backends lower to dot product instructions.
+      if (quantizationInfo.getInputZp() == 0 &&
+          quantizationInfo.getWeightZp() == 0) {
+        conv = rewriter
+                   .create<LinalgConvOp>(
+                       loc, resultTy, ValueRange{input, weight},
+                       ValueRange{zeroTensor}, strideAttr, dilationAttr)
+                   ->getResult(0);
+      } else {
+        auto iZp = rewriter.getI32IntegerAttr(quantizationInfo.getInputZp());
+        auto kZp = rewriter.getI32IntegerAttr(quantizationInfo.getWeightZp());
+
+        auto iZpVal = rewriter.create<arith::ConstantOp>(loc, iZp);
+        auto kZpVal = rewriter.create<arith::ConstantOp>(loc, kZp);
+        conv = rewriter
+                   .create<LinalgConvQOp>(
+                       loc, resultTy, ValueRange{input, weight, iZpVal, kZpVal},
+                       ValueRange{zeroTensor}, strideAttr, dilationAttr)
+                   ->getResult(0);
+      }
       Value result = linalgIntBroadcastExtSIAdd(rewriter, loc, bias, conv,
                                                 biasEmptyTensor, indexingMaps);
       rewriter.replaceOp(op, result);
@@ -535,18 +547,21 @@ public:
                            .create<linalg::FillOp>(loc, ValueRange{zero},
                                                    ValueRange{emptyTensor})
                            .result();
-    if (!op.getQuantizationInfo()) {
+    // Without zero points, the quantized matmul is a plain matmul sign
+    // extending its operands.
+    auto quantizationInfo = op.getQuantizationInfo();
+    if (!quantizationInfo ||
+        (quantizationInfo->getAZp() == 0 && quantizationInfo->getBZp() == 0)) {
       rewriter.replaceOpWithNewOp<linalg::BatchMatmulOp>(
           op, TypeRange{op.getType()},
           ValueRange{adaptor.getA(), adaptor.getB()}, ValueRange{zeroTensor});
       return success();
     }
 
-    auto quantizationInfo = *op.getQuantizationInfo();
     auto aZp = rewriter.create<arith::ConstantOp>(
-        loc, rewriter.getI32IntegerAttr(quantizationInfo.getAZp()));
+        loc, rewriter.getI32IntegerAttr(quantizationInfo->getAZp()));
     auto bZp = rewriter.create<arith::ConstantOp>(
-        loc, rewriter.getI32IntegerAttr(quantizationInfo.getBZp()));
+        loc, rewriter.getI32IntegerAttr(quantizationInfo->getBZp()));
     rewriter.replaceOpWithNewOp<linalg::QuantizedBatchMatmulOp>(
         op, TypeRange{op.getType()},
         ValueRange{adaptor.getA(), adaptor.getB(), aZp, bZp}, zeroTensor);
@@ -649,17 +664,28 @@ public:
     }
 
     auto quantizationInfo = *op.getQuantizationInfo();
-    auto inputZp = rewriter.create<arith::ConstantOp>(
-        loc, rewriter.getI32IntegerAttr(quantizationInfo.getInputZp()));
-    auto outputZp = rewriter.create<arith::ConstantOp>(
-        loc, rewriter.getI32IntegerAttr(quantizationInfo.getWeightZp()));
-    Value matmul =
-        rewriter
-            .create<linalg::QuantizedMatmulOp>(
-                loc, TypeRange{op.getType()},
-                ValueRange{input, transposedWeight, inputZp, outputZp},
-                zeroTensor)
-            ->getResult(0);
+    Value matmul;
+    // Without zero points, the quantized matmul is a plain matmul sign
+    // extending its operands.
+    if (quantizationInfo.getInputZp() == 0 &&
+        quantizationInfo.getWeightZp() == 0) {
+      matmul = rewriter
+                   .create<linalg::MatmulOp>(
+                       loc, TypeRange{op.getType()},
+                       ValueRange{input, transposedWeight}, zeroTensor)
+                   ->getResult(0);
+    } else {
+      auto inputZp = rewriter.create<arith::ConstantOp>(
+          loc, rewriter.getI32IntegerAttr(quantizationInfo.getInputZp()));
+      auto outputZp = rewriter.create<arith::ConstantOp>(
+          loc, rewriter.getI32IntegerAttr(quantizationInfo.getWeightZp()));
+      matmul = rewriter
+                   .create<linalg::QuantizedMatmulOp>(
+                       loc, TypeRange{op.getType()},
+                       ValueRange{input, transposedWeight, inputZp, outputZp},
+                       zeroTensor)
+                   ->getResult(0);
+    }
     Value result = linalgIntBroadcastExtSIAdd(rewriter, loc, bias, matmul,
                                               biasEmptyTensor, indexingMaps);
     rewriter.replaceOp(op, result);
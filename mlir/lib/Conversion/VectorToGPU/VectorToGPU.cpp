@@ -15,6 +15,7 @@
 #include <type_traits>
 
 #include "mlir/Analysis/SliceAnalysis.h"
+#include "mlir/Dialect/AMDGPU/IR/AMDGPUDialect.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/GPU/IR/GPUDialect.h"
@@ -1295,6 +1296,348 @@ LogicalResult mlir::convertVectorToNVVMCompatibleMMASync(RewriterBase &rewriter,
   return success();
 }
 
+//===----------------------------------------------------------------------===//
+// Conversion to AMDGPU mfma operations
+//===----------------------------------------------------------------------===//
+
+/// The number of lanes of a wave on the CDNA GPUs, which execute the mfma ops.
+static constexpr int64_t kMfmaWaveSize = 64;
+/// The size of the M and N dimensions of the converted mfma ops.
+static constexpr int64_t kMfmaTileSize = 16;
+
+namespace {
+/// The operands of a mfma op, whose fragments have different layouts.
+enum class MfmaOperand { A, B, C };
+} // namespace
+
+/// Returns the size of the K dimension of the 16x16xK single-block mfma op
+/// on sources of `elementType` accumulating into `accElementType`, or 0 if
+/// there is no such op.
+static int64_t getMfmaK(Type elementType, Type accElementType) {
+  if (elementType.isF32() && accElementType.isF32())
+    return 4;
+  if (elementType.isF16() && accElementType.isF32())
+    return 16;
+  if (elementType.isInteger(8) && accElementType.isInteger(32))
+    return 16;
+  return 0;
+}
+
+/// Returns the coordinates in the tile of `operand` of the `i`-th value held
+/// by `laneId`, for a 16x16xK mfma op. The 16 rows of A and the 16 columns
+/// of B and C are spread over the lanes modulo 16, while the groups of 16
+/// lanes hold consecutive slices of the K dimension of A and B, and of the
+/// rows of C.
+static std::pair<Value, Value> getMfmaCoordinates(OpBuilder &b, Location loc,
+                                                  MfmaOperand operand,
+                                                  int64_t k, Value laneId,
+                                                  int64_t i) {
+  Value tileSize = b.create<arith::ConstantIndexOp>(loc, kMfmaTileSize);
+  Value lane = b.create<arith::RemUIOp>(loc, laneId, tileSize);
+  Value group = b.create<arith::DivUIOp>(loc, laneId, tileSize);
+  int64_t groupSize = operand == MfmaOperand::C ? 4 : k / 4;
+  Value slice = b.create<arith::AddIOp>(
+      loc,
+      b.create<arith::MulIOp>(
+          loc, group, b.create<arith::ConstantIndexOp>(loc, groupSize)),
+      b.create<arith::ConstantIndexOp>(loc, i));
+  if (operand == MfmaOperand::A)
+    return {lane, slice};
+  return {slice, lane};
+}
+
+/// Returns the type of the fragment of `operand` held by each lane.
+static Type getMfmaFragmentType(MfmaOperand operand, int64_t k,
+                                Type elementType) {
+  int64_t numValues = operand == MfmaOperand::C ? 4 : k / 4;
+  if (numValues == 1)
+    return elementType;
+  return VectorType::get({numValues}, elementType);
+}
+
+/// Returns the id of the current lane within its wave, assuming that the
+/// waves are made of consecutive linearized thread ids.
+static Value getMfmaLaneId(OpBuilder &b, Location loc) {
+  Type indexType = b.getIndexType();
+  Value tidX = b.create<gpu::ThreadIdOp>(loc, indexType, gpu::Dimension::x);
+  Value tidY = b.create<gpu::ThreadIdOp>(loc, indexType, gpu::Dimension::y);
+  Value tidZ = b.create<gpu::ThreadIdOp>(loc, indexType, gpu::Dimension::z);
+  Value dimX = b.create<gpu::BlockDimOp>(loc, indexType, gpu::Dimension::x);
+  Value dimY = b.create<gpu::BlockDimOp>(loc, indexType, gpu::Dimension::y);
+  Value linearId = b.create<arith::AddIOp>(
+      loc,
+      b.create<arith::MulIOp>(
+          loc,
+          b.create<arith::AddIOp>(
+              loc, b.create<arith::MulIOp>(loc, tidZ, dimY), tidY),
+          dimX),
+      tidX);
+  return b.create<arith::RemUIOp>(
+      loc, linearId, b.create<arith::ConstantIndexOp>(loc, kMfmaWaveSize));
+}
+
+/// Returns true if `xferOp` accesses a 2-D tile of a memref with a unit
+/// minor stride, without masks or out-of-bounds accesses, along the two minor
+/// dimensions of the memref in either order.
+template <typename TransferOpType>
+static bool transferSupportsMfma(TransferOpType xferOp) {
+  auto memrefType = dyn_cast<MemRefType>(xferOp.getShapedType());
+  if (!memrefType || !vector::isLastMemrefDimUnitStride(memrefType) ||
+      xferOp.getVectorType().getRank() != 2 || xferOp.getMask() ||
+      xferOp.hasOutOfBoundsDim())
+    return false;
+  int64_t rank = memrefType.getRank();
+  AffineMap map = xferOp.getPermutationMap();
+  MLIRContext *ctx = xferOp.getContext();
+  return map == AffineMap::getMinorIdentityMap(rank, 2, ctx) ||
+         map == AffineMap::get(rank, 0,
+                               {getAffineDimExpr(rank - 1, ctx),
+                                getAffineDimExpr(rank - 2, ctx)},
+                               ctx);
+}
+
+/// Returns the indices of the memref element at `coordinates` of the vector
+/// of `xferOp`.
+template <typename TransferOpType>
+static SmallVector<Value> getMfmaXferIndices(OpBuilder &b,
+                                             TransferOpType xferOp,
+                                             std::pair<Value, Value> coords) {
+  Location loc = xferOp.getLoc();
+  SmallVector<Value> indices(xferOp.getIndices().begin(),
+                             xferOp.getIndices().end());
+  int64_t rank = indices.size();
+  bool isTransposed = !xferOp.getPermutationMap().isMinorIdentity();
+  Value row = isTransposed ? coords.second : coords.first;
+  Value col = isTransposed ? coords.first : coords.second;
+  indices[rank - 2] = b.create<arith::AddIOp>(loc, indices[rank - 2], row);
+  indices[rank - 1] = b.create<arith::AddIOp>(loc, indices[rank - 1], col);
+  return indices;
+}
+
+/// Returns true if the values of a fragment of `operand` are contiguous in
+/// the memref accessed by `xferOp`.
+template <typename TransferOpType>
+static bool isMfmaFragmentContiguous(TransferOpType xferOp,
+                                     MfmaOperand operand) {
+  // The values of the fragments of A are along the columns of the tile, and
+  // the values of the fragments of B and C along its rows.
+  bool isTransposed = !xferOp.getPermutationMap().isMinorIdentity();
+  return (operand == MfmaOperand::A) != isTransposed;
+}
+
+/// Returns true if `op` is a row-major 16x16xK contraction that maps to an
+/// mfma op.
+static bool contractSupportsMfma(vector::ContractionOp op) {
+  if (op.getKind() != vector::CombiningKind::ADD)
+    return false;
+  using MapList = ArrayRef<ArrayRef<AffineExpr>>;
+  auto infer = [](MapList m) { return AffineMap::inferFromExprList(m); };
+  AffineExpr m, n, k;
+  bindDims(op.getContext(), m, n, k);
+  if (op.getIndexingMapsArray() != infer({{m, k}, {k, n}, {m, n}}))
+    return false;
+  VectorType lhsType = op.getLhsType();
+  VectorType rhsType = op.getRhsType();
+  auto accType = dyn_cast<VectorType>(op.getAccType());
+  if (!accType || lhsType.getElementType() != rhsType.getElementType())
+    return false;
+  int64_t mfmaK =
+      getMfmaK(lhsType.getElementType(), accType.getElementType());
+  return mfmaK != 0 &&
+         lhsType.getShape() == ArrayRef<int64_t>{kMfmaTileSize, mfmaK} &&
+         rhsType.getShape() == ArrayRef<int64_t>{mfmaK, kMfmaTileSize} &&
+         accType.getShape() == ArrayRef<int64_t>{kMfmaTileSize, kMfmaTileSize};
+}
+
+/// Returns true if the accumulator `acc` of a convertible contraction can be
+/// distributed to the lanes.
+static bool accSupportsMfma(Value acc,
+                            const llvm::SetVector<Operation *> &contracts) {
+  Operation *def = acc.getDefiningOp();
+  if (auto readOp = dyn_cast_or_null<vector::TransferReadOp>(def))
+    return transferSupportsMfma(readOp);
+  if (auto constantOp = dyn_cast_or_null<arith::ConstantOp>(def))
+    return isa<SplatElementsAttr>(constantOp.getValue());
+  return def && contracts.contains(def);
+}
+
+/// Returns true if the result of a convertible contraction is only written to
+/// memory or accumulated into by other convertible contractions.
+static bool resultSupportsMfma(vector::ContractionOp op,
+                               const llvm::SetVector<Operation *> &contracts) {
+  return llvm::all_of(op->getUses(), [&](OpOperand &use) {
+    if (auto writeOp = dyn_cast<vector::TransferWriteOp>(use.getOwner()))
+      return use.get() == writeOp.getVector() && transferSupportsMfma(writeOp);
+    return contracts.contains(use.getOwner()) &&
+           use.getOperandNumber() == 2;
+  });
+}
+
+namespace {
+/// Converts the convertible contractions and their operands to mfma ops on
+/// the fragments of the lanes.
+class MfmaConverter {
+public:
+  explicit MfmaConverter(RewriterBase &rewriter) : rewriter(rewriter) {}
+
+  /// Returns the fragment of `operand` for `value`, creating the loads at the
+  /// definition of `value`.
+  Value getFragment(Value value, MfmaOperand operand, int64_t k);
+
+  /// Converts `op` to an mfma op.
+  void convertContract(vector::ContractionOp op);
+
+  /// Converts `op` to stores of the fragments of the lanes.
+  void convertTransferWrite(vector::TransferWriteOp op);
+
+private:
+  RewriterBase &rewriter;
+  /// The fragments of the converted values, for each kind of operand.
+  DenseMap<std::pair<Value, int>, Value> fragments;
+};
+} // namespace
+
+Value MfmaConverter::getFragment(Value value, MfmaOperand operand,
+                                 int64_t k) {
+  Value &fragment = fragments[{value, static_cast<int>(operand)}];
+  if (fragment)
+    return fragment;
+
+  OpBuilder::InsertionGuard g(rewriter);
+  Operation *def = value.getDefiningOp();
+  Location loc = def->getLoc();
+  Type elementType = cast<VectorType>(value.getType()).getElementType();
+  auto fragmentType = getMfmaFragmentType(operand, k, elementType);
+  auto vectorType = dyn_cast<VectorType>(fragmentType);
+  int64_t numValues = vectorType ? vectorType.getNumElements() : 1;
+
+  // The constant accumulators are splats of vector fragments.
+  if (auto constantOp = dyn_cast<arith::ConstantOp>(def)) {
+    rewriter.setInsertionPoint(constantOp);
+    auto splat = cast<SplatElementsAttr>(constantOp.getValue());
+    fragment = rewriter.create<arith::ConstantOp>(
+        loc, DenseElementsAttr::get(vectorType,
+                                    splat.getSplatValue<Attribute>()));
+    return fragment;
+  }
+
+  auto readOp = cast<vector::TransferReadOp>(def);
+  rewriter.setInsertionPoint(readOp);
+  Value laneId = getMfmaLaneId(rewriter, loc);
+  // Load the contiguous fragments at once, and the others value by value.
+  if (isMfmaFragmentContiguous(readOp, operand) || numValues == 1) {
+    SmallVector<Value> indices = getMfmaXferIndices(
+        rewriter, readOp,
+        getMfmaCoordinates(rewriter, loc, operand, k, laneId, 0));
+    fragment = vectorType ? rewriter.create<vector::LoadOp>(
+                                loc, vectorType, readOp.getSource(), indices)
+                          : rewriter.create<memref::LoadOp>(
+                                loc, readOp.getSource(), indices);
+    return fragment;
+  }
+  fragment = rewriter.create<vector::SplatOp>(
+      loc, rewriter.create<arith::ConstantOp>(
+               loc, rewriter.getZeroAttr(elementType)),
+      vectorType);
+  for (int64_t i = 0; i < numValues; ++i) {
+    SmallVector<Value> indices = getMfmaXferIndices(
+        rewriter, readOp,
+        getMfmaCoordinates(rewriter, loc, operand, k, laneId, i));
+    Value element =
+        rewriter.create<memref::LoadOp>(loc, readOp.getSource(), indices);
+    fragment = rewriter.create<vector::InsertOp>(loc, element, fragment,
+                                                 rewriter.getI64ArrayAttr(i));
+  }
+  return fragment;
+}
+
+void MfmaConverter::convertContract(vector::ContractionOp op) {
+  int64_t k = op.getLhsType().getShape()[1];
+  Value a = getFragment(op.getLhs(), MfmaOperand::A, k);
+  Value b = getFragment(op.getRhs(), MfmaOperand::B, k);
+  Value c = getFragment(op.getAcc(), MfmaOperand::C, k);
+  OpBuilder::InsertionGuard g(rewriter);
+  rewriter.setInsertionPoint(op);
+  Value d = rewriter.create<amdgpu::MFMAOp>(
+      op.getLoc(), c.getType(), kMfmaTileSize, kMfmaTileSize, k, /*blocks=*/1,
+      a, b, c);
+  fragments[{op.getResult(), static_cast<int>(MfmaOperand::C)}] = d;
+}
+
+void MfmaConverter::convertTransferWrite(vector::TransferWriteOp op) {
+  Value fragment = fragments.lookup(
+      {op.getVector(), static_cast<int>(MfmaOperand::C)});
+  assert(fragment && "expected the fragment of a converted contraction");
+  OpBuilder::InsertionGuard g(rewriter);
+  rewriter.setInsertionPoint(op);
+  Location loc = op.getLoc();
+  Value laneId = getMfmaLaneId(rewriter, loc);
+  int64_t numValues = cast<VectorType>(fragment.getType()).getNumElements();
+  for (int64_t i = 0; i < numValues; ++i) {
+    SmallVector<Value> indices = getMfmaXferIndices(
+        rewriter, op,
+        getMfmaCoordinates(rewriter, loc, MfmaOperand::C, 0, laneId, i));
+    Value element =
+        rewriter.create<vector::ExtractOp>(loc, fragment, ArrayRef<int64_t>{i});
+    rewriter.create<memref::StoreOp>(loc, element, op.getSource(), indices);
+  }
+  rewriter.eraseOp(op);
+}
+
+LogicalResult mlir::convertVectorToAMDGPUCompatibleMFMA(RewriterBase &rewriter,
+                                                        Operation *rootOp) {
+  // Collect the contractions whose operands and results can be distributed to
+  // the lanes, removing those that depend on or feed other ops until a fixed
+  // point is reached.
+  llvm::SetVector<Operation *> contracts;
+  rootOp->walk([&](vector::ContractionOp op) {
+    auto isSupportedRead = [](Value value) {
+      auto readOp = value.getDefiningOp<vector::TransferReadOp>();
+      return readOp && transferSupportsMfma(readOp);
+    };
+    if (contractSupportsMfma(op) && isSupportedRead(op.getLhs()) &&
+        isSupportedRead(op.getRhs()))
+      contracts.insert(op);
+  });
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (Operation *op : SmallVector<Operation *>(contracts.getArrayRef())) {
+      auto contractOp = cast<vector::ContractionOp>(op);
+      if (accSupportsMfma(contractOp.getAcc(), contracts) &&
+          resultSupportsMfma(contractOp, contracts))
+        continue;
+      contracts.remove(op);
+      changed = true;
+    }
+  }
+
+  MfmaConverter converter(rewriter);
+  SmallVector<vector::TransferWriteOp> writeOps;
+  for (Operation *op : contracts) {
+    converter.convertContract(cast<vector::ContractionOp>(op));
+    for (Operation *user : op->getUsers())
+      if (auto writeOp = dyn_cast<vector::TransferWriteOp>(user))
+        writeOps.push_back(writeOp);
+  }
+  for (vector::TransferWriteOp writeOp : writeOps)
+    converter.convertTransferWrite(writeOp);
+
+  // Erase the contractions, from the last ones, and their dead operands.
+  for (Operation *op : llvm::reverse(contracts)) {
+    llvm::SetVector<Operation *> defs;
+    for (Value operand : op->getOperands())
+      if (Operation *def = operand.getDefiningOp())
+        defs.insert(def);
+    rewriter.eraseOp(op);
+    for (Operation *def : defs)
+      if (def->use_empty() && !contracts.contains(def) &&
+          isa<vector::TransferReadOp, arith::ConstantOp>(def))
+        rewriter.eraseOp(def);
+  }
+  return success();
+}
+
 namespace {
 
 struct ConvertVectorToGPUPass
@@ -1312,6 +1655,12 @@ struct ConvertVectorToGPUPass
       return signalPassFailure();
 
     IRRewriter rewriter(&getContext());
+    if (useAmdgpu.getValue()) {
+      if (failed(
+              convertVectorToAMDGPUCompatibleMFMA(rewriter, getOperation())))
+        return signalPassFailure();
+      return;
+    }
     if (useNvGpu.getValue()) {
       if (failed(
               convertVectorToNVVMCompatibleMMASync(rewriter, getOperation())))
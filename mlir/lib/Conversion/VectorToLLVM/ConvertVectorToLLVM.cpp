@@ -765,16 +765,23 @@ public:
     if (!isa<FloatType>(eltType))
       return failure();
 
+    // The reductions nested in a fast-math policy that allows reassociation
+    // are reassociated too.
+    bool reassociate =
+        reassociateFPReductions ||
+        arith::bitEnumContainsAll(arith::getFastMathPolicy(reductionOp),
+                                  arith::FastMathFlags::reassoc);
+
     // Floating-point reductions: add/mul/min/max
     Value result;
     if (kind == vector::CombiningKind::ADD) {
       result = lowerReductionWithStartValue<LLVM::vector_reduce_fadd,
                                             ReductionNeutralZero>(
-          rewriter, loc, llvmType, operand, acc, reassociateFPReductions);
+          rewriter, loc, llvmType, operand, acc, reassociate);
     } else if (kind == vector::CombiningKind::MUL) {
       result = lowerReductionWithStartValue<LLVM::vector_reduce_fmul,
                                             ReductionNeutralFPOne>(
-          rewriter, loc, llvmType, operand, acc, reassociateFPReductions);
+          rewriter, loc, llvmType, operand, acc, reassociate);
     } else if (kind == vector::CombiningKind::MINF) {
       // FIXME: MLIR's 'minf' and LLVM's 'vector_reduce_fmin' do not handle
       // NaNs/-0.0/+0.0 in the same way.
@@ -69,6 +69,12 @@ void LowerVectorToLLVMPass::runOnOperation() {
     RewritePatternSet patterns(&getContext());
     populateVectorToVectorCanonicalizationPatterns(patterns);
     populateVectorBroadcastLoweringPatterns(patterns);
+    // The contractions that map to AMX tile multiplications or to SME outer
+    // products take precedence over their generic lowering.
+    if (amx)
+      populateAMXContractionLoweringPatterns(patterns, /*benefit=*/2);
+    if (armSME)
+      arm_sme::populateVectorContractLoweringPatterns(patterns, /*benefit=*/2);
     populateVectorContractLoweringPatterns(patterns, VectorTransformsOptions());
     populateVectorMaskOpLoweringPatterns(patterns);
     populateVectorShapeCastLoweringPatterns(patterns);
@@ -0,0 +1,92 @@
+//===- ActionProfiler.cpp -  Profiling Actions *- C++ -*-=====================//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Debug/Observers/ActionProfiler.h"
+#include "mlir/IR/Action.h"
+#include "mlir/IR/Operation.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <optional>
+
+using namespace mlir;
+using namespace mlir::tracing;
+
+//===----------------------------------------------------------------------===//
+// ActionProfiler
+//===----------------------------------------------------------------------===//
+
+ActionProfiler::ActionProfiler(raw_ostream &os)
+    : os(os), startTime(std::chrono::steady_clock::now()) {
+  os << "[";
+}
+
+ActionProfiler::~ActionProfiler() {
+  os << "\n]\n";
+  os.flush();
+}
+
+void ActionProfiler::beforeExecute(const ActionActiveStack *action,
+                                   Breakpoint *breakpoint, bool willExecute) {
+  // Skipped actions don't have a span.
+  if (willExecute)
+    print(action, "B");
+}
+
+void ActionProfiler::afterExecute(const ActionActiveStack *action) {
+  print(action, "E");
+}
+
+void ActionProfiler::print(const ActionActiveStack *action, StringRef phase) {
+  // Compute the timestamp and thread before acquiring the lock, so that they
+  // are not skewed by contention.
+  auto timestamp = std::chrono::duration<double, std::micro>(
+                       std::chrono::steady_clock::now() - startTime)
+                       .count();
+  auto threadId = static_cast<int64_t>(llvm::get_threadid());
+
+  // Annotate the start of the span with the description of the action, and
+  // the operation it applies to if any.
+  bool isBegin = phase == "B";
+  std::string desc;
+  std::optional<StringRef> opName;
+  if (isBegin) {
+    llvm::raw_string_ostream descOS(desc);
+    action->getAction().print(descOS);
+    for (const IRUnit &unit : action->getAction().getContextIRUnits()) {
+      if (auto *op = llvm::dyn_cast_if_present<Operation *>(unit)) {
+        opName = op->getName().getStringRef();
+        break;
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (printComma)
+    os << ",";
+  printComma = true;
+  os << "\n";
+
+  llvm::json::OStream json(os);
+  json.object([&] {
+    json.attribute("name", action->getAction().getTag());
+    json.attribute("cat", "action");
+    json.attribute("ph", phase);
+    json.attribute("pid", 0);
+    json.attribute("tid", threadId);
+    json.attribute("ts", timestamp);
+    if (isBegin) {
+      json.attributeObject("args", [&] {
+        json.attribute("desc", desc);
+        if (opName)
+          json.attribute("op", *opName);
+      });
+    }
+  });
+}
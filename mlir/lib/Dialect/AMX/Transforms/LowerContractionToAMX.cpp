@@ -0,0 +1,233 @@
+//===- LowerContractionToAMX.cpp - Lower vector.contract to AMX tile ops --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the rewrite of the bf16 and int8 matmul contractions
+// that fit in AMX tiles to the AMX tile multiplications. The right-hand side
+// of the contractions is packed in the VNNI layout expected by the tile
+// multiplications, in which the elements of consecutive rows of a column are
+// interleaved into 32-bit groups.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/AMX/Transforms.h"
+
+#include "mlir/Dialect/AMX/AMXDialect.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/Utils/StructuredOpsUtils.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/PatternMatch.h"
+
+using namespace mlir;
+using namespace mlir::amx;
+
+/// The maximal number of rows of a tile.
+static constexpr int64_t kMaxTileRows = 16;
+/// The maximal number of bytes of a row of a tile.
+static constexpr int64_t kMaxTileRowBytes = 64;
+
+/// Returns true when `vecType` fits in a tile.
+static bool fitsInTile(VectorType vecType) {
+  int64_t rowBytes =
+      vecType.getDimSize(1) * vecType.getElementTypeBitWidth() / 8;
+  return vecType.getDimSize(0) <= kMaxTileRows &&
+         rowBytes <= kMaxTileRowBytes && rowBytes % 4 == 0;
+}
+
+/// Returns true when the transfer `xferOp` of a tile can be replaced by a
+/// tile load or store, i.e. when it accesses the rows of a 2-D memref whose
+/// elements are contiguous, in bounds and without mask.
+static bool isTileTransfer(VectorTransferOpInterface xferOp) {
+  auto memrefType = dyn_cast<MemRefType>(xferOp.getShapedType());
+  return memrefType && memrefType.getRank() == 2 &&
+         vector::isLastMemrefDimUnitStride(memrefType) &&
+         xferOp.getVectorType().getRank() == 2 &&
+         xferOp.permutation_map().isMinorIdentity() && !xferOp.getMask() &&
+         !xferOp.hasOutOfBoundsDim();
+}
+
+/// Returns the scope of the buffers of the tiles that are stored to memory.
+static Block *getBufferScope(Operation *op) {
+  Operation *scope =
+      op->getParentWithTrait<OpTrait::AutomaticAllocationScope>();
+  if (!scope || scope->getNumRegions() != 1 || scope->getRegion(0).empty())
+    return nullptr;
+  return &scope->getRegion(0).front();
+}
+
+/// Allocates a buffer for a tile of type `vecType` at the start of `scope`,
+/// so that the buffer is allocated once even within loops.
+static Value createTileBuffer(RewriterBase &rewriter, Location loc,
+                              Block *scope, VectorType vecType) {
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPointToStart(scope);
+  auto bufferType =
+      MemRefType::get(vecType.getShape(), vecType.getElementType());
+  return rewriter.create<memref::AllocaOp>(loc, bufferType);
+}
+
+/// Loads `value` into a tile. The transfers of tiles are loaded directly from
+/// their memrefs, and the other values go through a buffer.
+static Value loadTile(RewriterBase &rewriter, Location loc, Block *scope,
+                      Value value) {
+  auto vecType = cast<VectorType>(value.getType());
+  if (auto readOp = value.getDefiningOp<vector::TransferReadOp>()) {
+    if (isTileTransfer(readOp))
+      return rewriter.create<TileLoadOp>(loc, vecType, readOp.getSource(),
+                                         readOp.getIndices());
+  }
+  Value buffer = createTileBuffer(rewriter, loc, scope, vecType);
+  Value vecBuffer = rewriter.create<vector::TypeCastOp>(loc, buffer);
+  rewriter.create<memref::StoreOp>(loc, value, vecBuffer, ValueRange{});
+  Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+  return rewriter.create<TileLoadOp>(loc, vecType, buffer,
+                                     ValueRange{zero, zero});
+}
+
+/// Packs the KxN right-hand side `rhs` into the (K/vnni)x(N*vnni) VNNI
+/// layout, in which every row holds `vnni` consecutive rows of `rhs`
+/// interleaved column by column.
+static Value packVNNI(RewriterBase &rewriter, Location loc, Value rhs,
+                      int64_t vnni) {
+  auto rhsType = cast<VectorType>(rhs.getType());
+  int64_t k = rhsType.getDimSize(0), n = rhsType.getDimSize(1);
+  Type elementType = rhsType.getElementType();
+  Value split = rewriter.create<vector::ShapeCastOp>(
+      loc, VectorType::get({k / vnni, vnni, n}, elementType), rhs);
+  Value interleaved = rewriter.create<vector::TransposeOp>(
+      loc, split, ArrayRef<int64_t>{0, 2, 1});
+  return rewriter.create<vector::ShapeCastOp>(
+      loc, VectorType::get({k / vnni, n * vnni}, elementType), interleaved);
+}
+
+/// Returns the operand of the extension `value` of an i8 or bf16 vector, or
+/// `value` itself when it is not extended. Sets `isZext` when the extension
+/// is unsigned.
+static Value getUnextended(Value value, bool &isZext) {
+  isZext = false;
+  Operation *defOp = value.getDefiningOp();
+  if (!isa_and_nonnull<arith::ExtFOp, arith::ExtSIOp, arith::ExtUIOp>(defOp))
+    return value;
+  Value in = defOp->getOperand(0);
+  Type elementType = getElementTypeOrSelf(in.getType());
+  if (!elementType.isBF16() && !elementType.isInteger(8))
+    return value;
+  isZext = isa<arith::ExtUIOp>(defOp);
+  return in;
+}
+
+namespace {
+
+/// Rewrites a vector.contract of a row-major MxK and KxN bf16 (resp. i8)
+/// matmul into an MxN f32 (resp. i32) accumulator into an AMX tile
+/// multiplication, when the operands fit in tiles. The i8 operands are
+/// expected to be sign or zero extended to i32 before the contraction.
+struct ContractionToAMXPattern
+    : public OpRewritePattern<vector::ContractionOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(vector::ContractionOp contractOp,
+                                PatternRewriter &rewriter) const override {
+    if (contractOp.getKind() != vector::CombiningKind::ADD)
+      return rewriter.notifyMatchFailure(contractOp, "expected an addition");
+    if (cast<vector::MaskableOpInterface>(contractOp.getOperation())
+            .isMasked())
+      return rewriter.notifyMatchFailure(contractOp, "unsupported mask");
+    if (!isRowMajorMatmul(contractOp.getIndexingMapsAttr()))
+      return rewriter.notifyMatchFailure(contractOp,
+                                         "expected a row-major matmul");
+    auto accType = dyn_cast<VectorType>(contractOp.getAccType());
+    if (!accType || accType.isScalable())
+      return rewriter.notifyMatchFailure(contractOp, "expected a vector acc");
+
+    bool isZextLhs, isZextRhs;
+    Value lhs = getUnextended(contractOp.getLhs(), isZextLhs);
+    Value rhs = getUnextended(contractOp.getRhs(), isZextRhs);
+    auto lhsType = cast<VectorType>(lhs.getType());
+    auto rhsType = cast<VectorType>(rhs.getType());
+    Type lhsElementType = lhsType.getElementType();
+    Type rhsElementType = rhsType.getElementType();
+    Type accElementType = accType.getElementType();
+    // The i8 operands must be extended, since the contraction of i8 operands
+    // into an i32 accumulator does not specify how they are extended.
+    bool isFloat = lhsElementType.isBF16() && rhsElementType.isBF16() &&
+                   accElementType.isF32();
+    bool isInteger = lhsElementType.isInteger(8) &&
+                     rhsElementType.isInteger(8) &&
+                     accElementType.isInteger(32) &&
+                     lhs != contractOp.getLhs() && rhs != contractOp.getRhs();
+    if (!isFloat && !isInteger)
+      return rewriter.notifyMatchFailure(
+          contractOp, "expected bf16 or extended i8 operands");
+
+    // The VNNI layout groups the elements of the right-hand side by 32 bits.
+    int64_t vnni = isFloat ? 2 : 4;
+    int64_t k = lhsType.getDimSize(1), n = rhsType.getDimSize(1);
+    if (k % vnni != 0)
+      return rewriter.notifyMatchFailure(contractOp,
+                                         "reduction not divisible by VNNI");
+    auto vnniType =
+        VectorType::get({k / vnni, n * vnni}, rhsType.getElementType());
+    if (!fitsInTile(lhsType) || !fitsInTile(vnniType) || !fitsInTile(accType))
+      return rewriter.notifyMatchFailure(contractOp, "does not fit in tiles");
+    Block *scope = getBufferScope(contractOp);
+    if (!scope)
+      return rewriter.notifyMatchFailure(contractOp,
+                                         "no scope for the tile buffers");
+
+    Location loc = contractOp.getLoc();
+    Value lhsTile = loadTile(rewriter, loc, scope, lhs);
+    Value rhsTile =
+        loadTile(rewriter, loc, scope, packVNNI(rewriter, loc, rhs, vnni));
+    Value acc = contractOp.getAcc();
+    Value accTile;
+    if (matchPattern(acc, m_AnyZeroFloat()) || matchPattern(acc, m_Zero()))
+      accTile = rewriter.create<TileZeroOp>(loc, accType);
+    else
+      accTile = loadTile(rewriter, loc, scope, acc);
+
+    Value result;
+    if (isFloat) {
+      result =
+          rewriter.create<TileMulFOp>(loc, accType, lhsTile, rhsTile, accTile);
+    } else {
+      result = rewriter.create<TileMulIOp>(
+          loc, accType, lhsTile, rhsTile, accTile,
+          isZextLhs ? rewriter.getUnitAttr() : nullptr,
+          isZextRhs ? rewriter.getUnitAttr() : nullptr);
+    }
+
+    // Store the result directly when it is only written to memory.
+    if (contractOp->hasOneUse()) {
+      auto writeOp =
+          dyn_cast<vector::TransferWriteOp>(*contractOp->user_begin());
+      if (writeOp && isTileTransfer(writeOp)) {
+        rewriter.create<TileStoreOp>(loc, writeOp.getSource(),
+                                     writeOp.getIndices(), result);
+        rewriter.eraseOp(writeOp);
+        rewriter.eraseOp(contractOp);
+        return success();
+      }
+    }
+    Value buffer = createTileBuffer(rewriter, loc, scope, accType);
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    rewriter.create<TileStoreOp>(loc, buffer, ValueRange{zero, zero}, result);
+    Value vecBuffer = rewriter.create<vector::TypeCastOp>(loc, buffer);
+    rewriter.replaceOpWithNewOp<memref::LoadOp>(contractOp, vecBuffer,
+                                                ValueRange{});
+    return success();
+  }
+};
+
+} // namespace
+
+void mlir::populateAMXContractionLoweringPatterns(RewritePatternSet &patterns,
+                                                  PatternBenefit benefit) {
+  patterns.add<ContractionToAMXPattern>(patterns.getContext(), benefit);
+}
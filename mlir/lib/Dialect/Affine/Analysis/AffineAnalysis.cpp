@@ -96,7 +96,8 @@ void mlir::affine::getSupportedReductions(
 /// provided, populates it with descriptors of the parallelizable reductions and
 /// treats them as not preventing parallelization.
 bool mlir::affine::isLoopParallel(
-    AffineForOp forOp, SmallVectorImpl<LoopReduction> *parallelReductions) {
+    AffineForOp forOp, SmallVectorImpl<LoopReduction> *parallelReductions,
+    AffineDependenceAnalysis *dependences) {
   unsigned numIterArgs = forOp.getNumIterOperands();
 
   // Loop is not parallel if it has SSA loop-carried dependences and reduction
@@ -114,7 +115,7 @@ bool mlir::affine::isLoopParallel(
   }
 
   // Check memory dependences.
-  return isLoopMemoryParallel(forOp);
+  return isLoopMemoryParallel(forOp, dependences);
 }
 
 /// Returns true if `v` is allocated locally to `enclosingOp` -- i.e., it is
@@ -133,7 +134,8 @@ static bool isLocallyDefined(Value v, Operation *enclosingOp) {
   return viewOp && isLocallyDefined(viewOp.getViewSource(), enclosingOp);
 }
 
-bool mlir::affine::isLoopMemoryParallel(AffineForOp forOp) {
+bool mlir::affine::isLoopMemoryParallel(
+    AffineForOp forOp, AffineDependenceAnalysis *dependences) {
   // Any memref-typed iteration arguments are treated as serializing.
   if (llvm::any_of(forOp.getResultTypes(),
                    [](Type type) { return isa<BaseMemRefType>(type); }))
@@ -168,13 +170,19 @@ bool mlir::affine::isLoopMemoryParallel(AffineForOp forOp) {
   // Dep check depth would be number of enclosing loops + 1.
   unsigned depth = getNestingDepth(forOp) + 1;
 
+  // Build the access relation of each op once, even when no analysis is
+  // provided.
+  AffineDependenceAnalysis localDependences;
+  if (!dependences)
+    dependences = &localDependences;
+
   // Check dependences between all pairs of ops in 'loadAndStoreOps'.
   for (auto *srcOp : loadAndStoreOps) {
     MemRefAccess srcAccess(srcOp);
     for (auto *dstOp : loadAndStoreOps) {
       MemRefAccess dstAccess(dstOp);
       DependenceResult result =
-          checkMemrefAccessDependence(srcAccess, dstAccess, depth);
+          dependences->checkDependence(srcAccess, dstAccess, depth);
       if (result.value != DependenceResult::NoDependence)
         return false;
     }
@@ -509,6 +517,80 @@ void MemRefAccess::getAccessMap(AffineValueMap *accessMap) const {
   accessMap->reset(map, operands);
 }
 
+/// Returns the result of the dependence check between `srcAccess` and
+/// `dstAccess` if it is known without their access relations.
+static std::optional<DependenceResult>
+checkDependencePreconditions(const MemRefAccess &srcAccess,
+                             const MemRefAccess &dstAccess, bool allowRAR) {
+  // Return 'NoDependence' if these accesses do not access the same memref.
+  if (srcAccess.memref != dstAccess.memref)
+    return DependenceResult::NoDependence;
+
+  // Return 'NoDependence' if one of these accesses is not an
+  // AffineWriteOpInterface.
+  if (!allowRAR && !isa<AffineWriteOpInterface>(srcAccess.opInst) &&
+      !isa<AffineWriteOpInterface>(dstAccess.opInst))
+    return DependenceResult::NoDependence;
+
+  // We can't analyze further if the ops lie in different affine scopes or have
+  // no common block in an affine scope.
+  if (getAffineScope(srcAccess.opInst) != getAffineScope(dstAccess.opInst))
+    return DependenceResult::Failure;
+  if (!getCommonBlockInAffineScope(srcAccess.opInst, dstAccess.opInst))
+    return DependenceResult::Failure;
+  return std::nullopt;
+}
+
+/// Checks the dependence between `srcAccess` and `dstAccess` from their access
+/// relations `srcRel` and `dstRel`, which is modified into the dependence
+/// relation.
+static DependenceResult checkDependenceOfRelations(
+    const MemRefAccess &srcAccess, const MemRefAccess &dstAccess,
+    const FlatAffineRelation &srcRel, FlatAffineRelation &dstRel,
+    unsigned loopDepth, FlatAffineValueConstraints *dependenceConstraints,
+    SmallVector<DependenceComponent, 2> *dependenceComponents, bool allowRAR) {
+  FlatAffineValueConstraints srcDomain = srcRel.getDomainSet();
+  FlatAffineValueConstraints dstDomain = dstRel.getDomainSet();
+
+  // Return 'NoDependence' if loopDepth > numCommonLoops and if the ancestor
+  // operation of 'srcAccess' does not properly dominate the ancestor
+  // operation of 'dstAccess' in the same common operation block.
+  // Note: this check is skipped if 'allowRAR' is true, because because RAR
+  // deps can exist irrespective of lexicographic ordering b/w src and dst.
+  unsigned numCommonLoops = getNumCommonLoops(srcDomain, dstDomain);
+  assert(loopDepth <= numCommonLoops + 1);
+  if (!allowRAR && loopDepth > numCommonLoops &&
+      !srcAppearsBeforeDstInAncestralBlock(srcAccess, dstAccess)) {
+    return DependenceResult::NoDependence;
+  }
+
+  // Compute the dependence relation by composing `srcRel` with the inverse of
+  // `dstRel`. Doing this builds a relation between iteration domain of
+  // `srcAccess` to the iteration domain of `dstAccess` which access the same
+  // memory locations.
+  dstRel.inverse();
+  dstRel.compose(srcRel);
+
+  // Add 'src' happens before 'dst' ordering constraints.
+  addOrderingConstraints(srcDomain, dstDomain, loopDepth, &dstRel);
+
+  // Return 'NoDependence' if the solution space is empty: no dependence.
+  if (dstRel.isEmpty())
+    return DependenceResult::NoDependence;
+
+  // Compute dependence direction vector and return true.
+  if (dependenceComponents != nullptr)
+    computeDirectionVector(srcDomain, dstDomain, loopDepth, &dstRel,
+                           dependenceComponents);
+
+  LLVM_DEBUG(llvm::dbgs() << "Dependence polyhedron:\n");
+  LLVM_DEBUG(dstRel.dump());
+
+  if (dependenceConstraints)
+    *dependenceConstraints = dstRel;
+  return DependenceResult::HasDependence;
+}
+
 // Builds a flat affine constraint system to check if there exists a dependence
 // between memref accesses 'srcAccess' and 'dstAccess'.
 // Returns 'NoDependence' if the accesses can be definitively shown not to
@@ -604,22 +686,9 @@ DependenceResult mlir::affine::checkMemrefAccessDependence(
   LLVM_DEBUG(srcAccess.opInst->dump());
   LLVM_DEBUG(dstAccess.opInst->dump());
 
-  // Return 'NoDependence' if these accesses do not access the same memref.
-  if (srcAccess.memref != dstAccess.memref)
-    return DependenceResult::NoDependence;
-
-  // Return 'NoDependence' if one of these accesses is not an
-  // AffineWriteOpInterface.
-  if (!allowRAR && !isa<AffineWriteOpInterface>(srcAccess.opInst) &&
-      !isa<AffineWriteOpInterface>(dstAccess.opInst))
-    return DependenceResult::NoDependence;
-
-  // We can't analyze further if the ops lie in different affine scopes or have
-  // no common block in an affine scope.
-  if (getAffineScope(srcAccess.opInst) != getAffineScope(dstAccess.opInst))
-    return DependenceResult::Failure;
-  if (!getCommonBlockInAffineScope(srcAccess.opInst, dstAccess.opInst))
-    return DependenceResult::Failure;
+  if (std::optional<DependenceResult> result =
+          checkDependencePreconditions(srcAccess, dstAccess, allowRAR))
+    return *result;
 
   // Create access relation from each MemRefAccess.
   FlatAffineRelation srcRel, dstRel;
@@ -628,46 +697,9 @@ DependenceResult mlir::affine::checkMemrefAccessDependence(
   if (failed(dstAccess.getAccessRelation(dstRel)))
     return DependenceResult::Failure;
 
-  FlatAffineValueConstraints srcDomain = srcRel.getDomainSet();
-  FlatAffineValueConstraints dstDomain = dstRel.getDomainSet();
-
-  // Return 'NoDependence' if loopDepth > numCommonLoops and if the ancestor
-  // operation of 'srcAccess' does not properly dominate the ancestor
-  // operation of 'dstAccess' in the same common operation block.
-  // Note: this check is skipped if 'allowRAR' is true, because because RAR
-  // deps can exist irrespective of lexicographic ordering b/w src and dst.
-  unsigned numCommonLoops = getNumCommonLoops(srcDomain, dstDomain);
-  assert(loopDepth <= numCommonLoops + 1);
-  if (!allowRAR && loopDepth > numCommonLoops &&
-      !srcAppearsBeforeDstInAncestralBlock(srcAccess, dstAccess)) {
-    return DependenceResult::NoDependence;
-  }
-
-  // Compute the dependence relation by composing `srcRel` with the inverse of
-  // `dstRel`. Doing this builds a relation between iteration domain of
-  // `srcAccess` to the iteration domain of `dstAccess` which access the same
-  // memory locations.
-  dstRel.inverse();
-  dstRel.compose(srcRel);
-
-  // Add 'src' happens before 'dst' ordering constraints.
-  addOrderingConstraints(srcDomain, dstDomain, loopDepth, &dstRel);
-
-  // Return 'NoDependence' if the solution space is empty: no dependence.
-  if (dstRel.isEmpty())
-    return DependenceResult::NoDependence;
-
-  // Compute dependence direction vector and return true.
-  if (dependenceComponents != nullptr)
-    computeDirectionVector(srcDomain, dstDomain, loopDepth, &dstRel,
-                           dependenceComponents);
-
-  LLVM_DEBUG(llvm::dbgs() << "Dependence polyhedron:\n");
-  LLVM_DEBUG(dstRel.dump());
-
-  if (dependenceConstraints)
-    *dependenceConstraints = dstRel;
-  return DependenceResult::HasDependence;
+  return checkDependenceOfRelations(srcAccess, dstAccess, srcRel, dstRel,
+                                    loopDepth, dependenceConstraints,
+                                    dependenceComponents, allowRAR);
 }
 
 /// Gathers dependence components for dependences between all ops in loop nest
@@ -703,3 +735,86 @@ void mlir::affine::getDependenceComponents(
     }
   }
 }
+
+AffineDependenceAnalysis::AffineDependenceAnalysis() = default;
+
+AffineDependenceAnalysis::AffineDependenceAnalysis(Operation *op) {}
+
+AffineDependenceAnalysis::~AffineDependenceAnalysis() = default;
+
+const FlatAffineRelation *
+AffineDependenceAnalysis::getAccessRelation(const MemRefAccess &access) {
+  auto [it, inserted] = accessRelations.try_emplace(access.opInst);
+  if (inserted) {
+    auto rel = std::make_unique<FlatAffineRelation>();
+    if (succeeded(access.getAccessRelation(*rel)))
+      it->second = std::move(rel);
+  }
+  return it->second.get();
+}
+
+DependenceResult AffineDependenceAnalysis::checkDependence(
+    const MemRefAccess &srcAccess, const MemRefAccess &dstAccess,
+    unsigned loopDepth, FlatAffineValueConstraints *dependenceConstraints,
+    bool allowRAR) {
+  auto key = std::make_tuple(srcAccess.opInst, dstAccess.opInst, loopDepth,
+                             static_cast<unsigned>(allowRAR));
+  auto it = dependences.find(key);
+  // The results cached without the dependence constraints are reused unless
+  // the constraints of a dependence are requested.
+  if (it != dependences.end() &&
+      (!dependenceConstraints || it->second.constraints ||
+       it->second.value != DependenceResult::HasDependence)) {
+    if (dependenceConstraints && it->second.constraints)
+      *dependenceConstraints = *it->second.constraints;
+    return it->second.value;
+  }
+
+  auto cacheResult = [&](DependenceResult result) {
+    CachedDependence &cached = dependences[key];
+    cached.value = result.value;
+    if (dependenceConstraints && hasDependence(result))
+      cached.constraints =
+          std::make_unique<FlatAffineValueConstraints>(*dependenceConstraints);
+    return result;
+  };
+
+  if (std::optional<DependenceResult> result =
+          checkDependencePreconditions(srcAccess, dstAccess, allowRAR))
+    return cacheResult(*result);
+
+  // The relations are owned by the cache, such that their addresses remain
+  // valid when it grows.
+  const FlatAffineRelation *srcRel = getAccessRelation(srcAccess);
+  const FlatAffineRelation *dstRel = getAccessRelation(dstAccess);
+  if (!srcRel || !dstRel)
+    return cacheResult(DependenceResult::Failure);
+
+  FlatAffineRelation dependenceRel = *dstRel;
+  return cacheResult(checkDependenceOfRelations(
+      srcAccess, dstAccess, *srcRel, dependenceRel, loopDepth,
+      dependenceConstraints, /*dependenceComponents=*/nullptr, allowRAR));
+}
+
+void AffineDependenceAnalysis::invalidate(Operation *op) {
+  SmallPtrSet<Operation *, 8> accessOps;
+  op->walk([&](Operation *nestedOp) {
+    if (isa<AffineReadOpInterface, AffineWriteOpInterface>(nestedOp)) {
+      accessRelations.erase(nestedOp);
+      accessOps.insert(nestedOp);
+    }
+  });
+  if (accessOps.empty())
+    return;
+  for (auto it = dependences.begin(), e = dependences.end(); it != e;) {
+    auto current = it++;
+    if (accessOps.contains(std::get<0>(current->first)) ||
+        accessOps.contains(std::get<1>(current->first)))
+      dependences.erase(current);
+  }
+}
+
+void AffineDependenceAnalysis::clear() {
+  accessRelations.clear();
+  dependences.clear();
+}
@@ -16,6 +16,7 @@
 #include "mlir/Dialect/Affine/Analysis/AffineAnalysis.h"
 #include "mlir/Dialect/Affine/Analysis/AffineStructures.h"
 #include "mlir/Dialect/Affine/Analysis/NestedMatcher.h"
+#include "mlir/Dialect/Affine/Analysis/Utils.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Affine/IR/AffineValueMap.h"
 #include "mlir/Support/MathExtras.h"
@@ -406,3 +407,67 @@ bool mlir::affine::isOpwiseShiftValid(AffineForOp forOp,
   }
   return true;
 }
+
+/// Accumulates in `cost` the number of operations and the memory traffic of
+/// one execution of `forOp`. Returns failure if the cost cannot be estimated.
+static LogicalResult addLoopNestCost(AffineForOp forOp,
+                                     const LoopNestCostParams &params,
+                                     LoopNestCost &cost) {
+  std::optional<uint64_t> tripCount = getConstantTripCount(forOp);
+  if (!tripCount)
+    return failure();
+
+  // The operations of the body, and the loops nested in it, possibly under
+  // affine.if operations.
+  LoopNestCost bodyCost;
+  WalkResult result =
+      forOp.getBody()->walk<WalkOrder::PreOrder>([&](Operation *op) {
+        if (auto nestedForOp = dyn_cast<AffineForOp>(op)) {
+          if (failed(addLoopNestCost(nestedForOp, params, bodyCost)))
+            return WalkResult::interrupt();
+          return WalkResult::skip();
+        }
+        if (isa<AffineYieldOp>(op))
+          return WalkResult::advance();
+        ++bodyCost.numOps;
+        Value memRef;
+        if (auto readOp = dyn_cast<AffineReadOpInterface>(op))
+          memRef = readOp.getMemRef();
+        else if (auto writeOp = dyn_cast<AffineWriteOpInterface>(op))
+          memRef = writeOp.getMemRef();
+        else
+          return WalkResult::advance();
+        std::optional<int64_t> eltSize = getMemRefIntOrFloatEltSizeInBytes(
+            cast<MemRefType>(memRef.getType()));
+        if (!eltSize)
+          return WalkResult::interrupt();
+        bodyCost.memoryTrafficBytes += *eltSize;
+        return WalkResult::advance();
+      });
+  if (result.wasInterrupted())
+    return failure();
+
+  cost.numOps += *tripCount * bodyCost.numOps;
+  // The data of a loop that fits in the cache is only transferred once.
+  std::optional<int64_t> footprint = getMemoryFootprintBytes(forOp);
+  if (footprint && static_cast<uint64_t>(*footprint) <= params.cacheSizeBytes)
+    cost.memoryTrafficBytes +=
+        std::min<uint64_t>(*footprint,
+                           *tripCount * bodyCost.memoryTrafficBytes);
+  else
+    cost.memoryTrafficBytes += *tripCount * bodyCost.memoryTrafficBytes;
+  return success();
+}
+
+std::optional<LoopNestCost>
+mlir::affine::getLoopNestCost(AffineForOp forOp,
+                              const LoopNestCostParams &params) {
+  LoopNestCost cost;
+  if (failed(addLoopNestCost(forOp, params, cost)))
+    return std::nullopt;
+  cost.cycles = std::max(
+      llvm::divideCeil(cost.numOps, std::max(params.issueWidth, 1u)),
+      llvm::divideCeil(cost.memoryTrafficBytes,
+                       std::max(params.memoryBandwidth, 1u)));
+  return cost;
+}
@@ -18,6 +18,7 @@
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Affine/IR/AffineValueMap.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/DLTI/DLTI.h"
 #include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/IntegerSet.h"
 #include "llvm/ADT/SmallPtrSet.h"
@@ -1289,7 +1290,12 @@ SliceComputationResult
 mlir::affine::computeSliceUnion(ArrayRef<Operation *> opsA,
                                 ArrayRef<Operation *> opsB, unsigned loopDepth,
                                 unsigned numCommonLoops, bool isBackwardSlice,
-                                ComputationSliceState *sliceUnion) {
+                                ComputationSliceState *sliceUnion,
+                                AffineDependenceAnalysis *dependences) {
+  AffineDependenceAnalysis localDependences;
+  if (!dependences)
+    dependences = &localDependences;
+
   // Compute the union of slice bounds between all pairs in 'opsA' and
   // 'opsB' in 'sliceUnionCst'.
   FlatAffineValueConstraints sliceUnionCst;
@@ -1312,10 +1318,9 @@ mlir::affine::computeSliceUnion(ArrayRef<Operation *> opsA,
                               isa<AffineReadOpInterface>(dstAccess.opInst);
       FlatAffineValueConstraints dependenceConstraints;
       // Check dependence between 'srcAccess' and 'dstAccess'.
-      DependenceResult result = checkMemrefAccessDependence(
+      DependenceResult result = dependences->checkDependence(
           srcAccess, dstAccess, /*loopDepth=*/numCommonLoops + 1,
-          &dependenceConstraints, /*dependenceComponents=*/nullptr,
-          /*allowRAR=*/readReadAccesses);
+          &dependenceConstraints, /*allowRAR=*/readReadAccesses);
       if (result.value == DependenceResult::Failure) {
         LLVM_DEBUG(llvm::dbgs() << "Dependence check failed\n");
         return SliceComputationResult::GenericFailure;
@@ -1830,6 +1835,23 @@ std::optional<int64_t> mlir::affine::getMemoryFootprintBytes(AffineForOp forOp,
       std::next(Block::iterator(forInst)), memorySpace);
 }
 
+std::optional<uint64_t> mlir::affine::getScratchpadSizeBytes(Operation *op) {
+  StringAttr identifier = StringAttr::get(
+      op->getContext(), DLTIDialect::kDataLayoutScratchpadSizeKey);
+  for (Operation *parent = op; parent; parent = parent->getParentOp()) {
+    auto iface = dyn_cast<DataLayoutOpInterface>(parent);
+    if (!iface)
+      continue;
+    DataLayoutSpecInterface spec = iface.getDataLayoutSpec();
+    if (!spec)
+      continue;
+    if (DataLayoutEntryInterface entry = spec.getSpecForIdentifier(identifier))
+      if (auto value = dyn_cast<IntegerAttr>(entry.getValue()))
+        return value.getValue().getZExtValue();
+  }
+  return std::nullopt;
+}
+
 /// Returns whether a loop is parallel and contains a reduction loop.
 bool mlir::affine::isLoopParallelAndContainsReduction(AffineForOp forOp) {
   SmallVector<LoopReduction> reductions;
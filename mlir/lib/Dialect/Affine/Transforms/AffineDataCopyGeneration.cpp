@@ -110,10 +110,13 @@ void AffineDataCopyGeneration::runOnBlock(Block *block,
   if (block->empty())
     return;
 
+  // Without an explicit capacity, the fast memory is bounded by the size of
+  // the scratchpad memory specified by the data layout, if any.
   uint64_t fastMemCapacityBytes =
       fastMemoryCapacity != std::numeric_limits<uint64_t>::max()
           ? fastMemoryCapacity * 1024
-          : fastMemoryCapacity;
+          : getScratchpadSizeBytes(block->getParentOp())
+                .value_or(fastMemoryCapacity);
   AffineCopyOptions copyOptions = {generateDma, slowMemorySpace,
                                    fastMemorySpace, tagMemorySpace,
                                    fastMemCapacityBytes};
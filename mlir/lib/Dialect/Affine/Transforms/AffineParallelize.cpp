@@ -61,14 +61,23 @@ void AffineParallelize::runOnOperation() {
   func::FuncOp f = getOperation();
 
   // The walker proceeds in pre-order to process the outer loops first
-  // and control the number of outer parallel loops.
+  // and control the number of outer parallel loops. The loops of a nest check
+  // the dependences between the same accesses, whose relations are shared
+  // through the dependence analysis.
+  AffineDependenceAnalysis &dependences =
+      getAnalysis<AffineDependenceAnalysis>();
   std::vector<ParallelizationCandidate> parallelizableLoops;
   f.walk<WalkOrder::PreOrder>([&](AffineForOp loop) {
     SmallVector<LoopReduction> reductions;
-    if (isLoopParallel(loop, parallelReductions ? &reductions : nullptr))
+    if (isLoopParallel(loop, parallelReductions ? &reductions : nullptr,
+                       &dependences))
       parallelizableLoops.emplace_back(loop, std::move(reductions));
   });
 
+  // Nothing changes without parallel loops.
+  if (parallelizableLoops.empty())
+    return markAllAnalysesPreserved();
+
   for (const ParallelizationCandidate &candidate : parallelizableLoops) {
     unsigned numParentParallelOps = 0;
     AffineForOp loop = candidate.loop;
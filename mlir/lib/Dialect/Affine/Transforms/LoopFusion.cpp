@@ -12,6 +12,7 @@
 
 #include "mlir/Dialect/Affine/Passes.h"
 
+#include "mlir/Dialect/Affine/Analysis/AffineAnalysis.h"
 #include "mlir/Dialect/Affine/Analysis/AffineStructures.h"
 #include "mlir/Dialect/Affine/Analysis/LoopAnalysis.h"
 #include "mlir/Dialect/Affine/Analysis/Utils.h"
@@ -849,15 +850,21 @@ public:
   // The amount of additional computation that is tolerated while fusing
   // pair-wise as a fraction of the total computation.
   double computeToleranceThreshold;
+  // The dependences between the accesses of the loop nests, which are checked
+  // again for each fusion depth and candidate. They are cleared whenever loop
+  // nests are fused, since fusion clones and erases accesses.
+  AffineDependenceAnalysis *dependences;
 
   using Node = MemRefDependenceGraph::Node;
 
   GreedyFusion(MemRefDependenceGraph *mdg, unsigned localBufSizeThreshold,
                std::optional<unsigned> fastMemorySpace, bool maximalFusion,
-               double computeToleranceThreshold)
+               double computeToleranceThreshold,
+               AffineDependenceAnalysis *dependences)
       : mdg(mdg), localBufSizeThreshold(localBufSizeThreshold),
         fastMemorySpace(fastMemorySpace), maximalFusion(maximalFusion),
-        computeToleranceThreshold(computeToleranceThreshold) {}
+        computeToleranceThreshold(computeToleranceThreshold),
+        dependences(dependences) {}
 
   /// Initializes 'worklist' with nodes from 'mdg'.
   void init() {
@@ -1044,7 +1051,8 @@ public:
         for (unsigned i = 1; i <= dstLoopDepthTest; ++i) {
           FusionResult result = affine::canFuseLoops(
               srcAffineForOp, dstAffineForOp,
-              /*dstLoopDepth=*/i, &depthSliceUnions[i - 1], strategy);
+              /*dstLoopDepth=*/i, &depthSliceUnions[i - 1], strategy,
+              dependences);
 
           if (result.value == FusionResult::Success)
             maxLegalFusionDepth = i;
@@ -1110,6 +1118,7 @@ public:
         }
 
         // Fuse computation slice of 'srcLoopNest' into 'dstLoopNest'.
+        dependences->clear();
         fuseLoops(srcAffineForOp, dstAffineForOp, bestSlice);
         dstNodeChanged = true;
 
@@ -1264,7 +1273,8 @@ public:
       for (unsigned i = 1; i <= dstLoopDepthTest; ++i) {
         FusionResult result = affine::canFuseLoops(
             sibAffineForOp, dstAffineForOp,
-            /*dstLoopDepth=*/i, &depthSliceUnions[i - 1], strategy);
+            /*dstLoopDepth=*/i, &depthSliceUnions[i - 1], strategy,
+            dependences);
 
         if (result.value == FusionResult::Success)
           maxLegalFusionDepth = i;
@@ -1294,6 +1304,7 @@ public:
       // further inside `fuseLoops`.
       bool isInnermostInsertion = (bestDstLoopDepth == dstLoopDepthTest);
       // Fuse computation slice of 'sibLoopNest' into 'dstLoopNest'.
+      dependences->clear();
       affine::fuseLoops(sibAffineForOp, dstAffineForOp,
                         depthSliceUnions[bestDstLoopDepth - 1],
                         isInnermostInsertion);
@@ -1488,7 +1499,8 @@ void LoopFusion::runOnBlock(Block *block) {
     fastMemorySpaceOpt = fastMemorySpace;
   unsigned localBufSizeThresholdBytes = localBufSizeThreshold * 1024;
   GreedyFusion fusion(&g, localBufSizeThresholdBytes, fastMemorySpaceOpt,
-                      maximalFusion, computeToleranceThreshold);
+                      maximalFusion, computeToleranceThreshold,
+                      &getAnalysis<AffineDependenceAnalysis>());
 
   if (affineFusionMode == FusionMode::ProducerConsumer)
     fusion.runProducerConsumerFusionOnly();
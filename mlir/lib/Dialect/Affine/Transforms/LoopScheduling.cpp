@@ -0,0 +1,329 @@
+//===- LoopScheduling.cpp - Schedule affine loop nests in permutable bands ===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass that reorders the loops of perfectly nested
+// affine.for nests into permutable bands, tiles the bands and parallelizes
+// the outermost parallel loop, after the approach of the Pluto scheduler.
+//
+// The hyperplanes of the schedule are restricted to the loops of the nest,
+// i.e. the schedule is a permutation of the loops: skewed hyperplanes would
+// produce non-hyperrectangular nests, which the tiling utilities do not
+// support. The hyperplanes are chosen greedily from the outermost. A band is
+// extended with a loop along which all the dependences that are not carried
+// by the outer bands have non-negative distances, which keeps the band fully
+// permutable and hence tilable, and among those with the loop whose maximal
+// distance is the smallest, which minimizes the reuse distances in the sense
+// of the Pluto cost function. The dependences with positive distances along a
+// loop of a band are carried by it and do not constrain the inner bands.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Affine/Passes.h"
+
+#include "mlir/Dialect/Affine/Analysis/AffineAnalysis.h"
+#include "mlir/Dialect/Affine/Analysis/AffineStructures.h"
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Affine/IR/AffineValueMap.h"
+#include "mlir/Dialect/Affine/LoopUtils.h"
+#include "mlir/Dialect/Affine/Utils.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "llvm/ADT/Sequence.h"
+#include "llvm/Support/Debug.h"
+
+#include <limits>
+
+namespace mlir {
+namespace affine {
+#define GEN_PASS_DEF_AFFINELOOPSCHEDULING
+#include "mlir/Dialect/Affine/Passes.h.inc"
+} // namespace affine
+} // namespace mlir
+
+#define DEBUG_TYPE "affine-loop-schedule"
+
+using namespace mlir;
+using namespace mlir::affine;
+
+namespace {
+/// The bounds of the distances of a dependence along the loops of a nest.
+/// The unbounded distances are represented by the extreme values.
+struct LoopDependence {
+  SmallVector<int64_t> lb;
+  SmallVector<int64_t> ub;
+};
+
+/// A permutation of the loops of a nest, partitioned in permutable bands.
+struct LoopSchedule {
+  /// The position in the original nest of the loop at each position.
+  SmallVector<unsigned> order;
+  /// The number of loops of each band, from the outermost.
+  SmallVector<unsigned> bandSizes;
+};
+
+struct AffineLoopScheduling
+    : public affine::impl::AffineLoopSchedulingBase<AffineLoopScheduling> {
+  void runOnOperation() override;
+
+private:
+  void scheduleNest(AffineForOp rootForOp);
+};
+} // namespace
+
+/// Collects the dependences between the accesses nested in `loops`, a perfect
+/// nest, with their distances along the loops. Returns failure if the nest
+/// has side effects other than affine accesses or if the dependences cannot
+/// be computed.
+static LogicalResult
+getLoopDependences(ArrayRef<AffineForOp> loops,
+                   SmallVectorImpl<LoopDependence> &dependences) {
+  SmallVector<Operation *> accessOps;
+  WalkResult walkResult = loops.front().walk([&](Operation *op) {
+    if (isa<AffineReadOpInterface, AffineWriteOpInterface>(op))
+      accessOps.push_back(op);
+    else if (!isa<AffineForOp, AffineYieldOp, AffineIfOp>(op) &&
+             !isMemoryEffectFree(op))
+      return WalkResult::interrupt();
+    return WalkResult::advance();
+  });
+  if (walkResult.wasInterrupted())
+    return failure();
+
+  unsigned numLoops = loops.size();
+  for (Operation *srcOp : accessOps) {
+    MemRefAccess srcAccess(srcOp);
+    for (Operation *dstOp : accessOps) {
+      MemRefAccess dstAccess(dstOp);
+      // The dependences carried by the loops nested in the band have zero
+      // distances along it and do not constrain the schedule.
+      for (unsigned depth = 1; depth <= numLoops; ++depth) {
+        SmallVector<DependenceComponent, 2> components;
+        DependenceResult result = checkMemrefAccessDependence(
+            srcAccess, dstAccess, depth, /*dependenceConstraints=*/nullptr,
+            &components);
+        if (result.value == DependenceResult::Failure)
+          return failure();
+        if (!hasDependence(result))
+          continue;
+        LoopDependence &dependence = dependences.emplace_back();
+        for (const DependenceComponent &component :
+             ArrayRef(components).take_front(numLoops)) {
+          dependence.lb.push_back(
+              component.lb.value_or(std::numeric_limits<int64_t>::min()));
+          dependence.ub.push_back(
+              component.ub.value_or(std::numeric_limits<int64_t>::max()));
+        }
+      }
+    }
+  }
+  return success();
+}
+
+/// Computes the schedule of a nest of `numLoops` loops with `dependences`.
+static LoopSchedule computeSchedule(unsigned numLoops,
+                                    ArrayRef<LoopDependence> dependences) {
+  LoopSchedule schedule;
+  SmallVector<bool> isScheduled(numLoops, false);
+  // The dependences that are not carried by the outer bands.
+  SmallVector<const LoopDependence *> activeDependences;
+  for (const LoopDependence &dependence : dependences)
+    activeDependences.push_back(&dependence);
+
+  while (schedule.order.size() < numLoops) {
+    unsigned bandSize = 0;
+    while (schedule.order.size() < numLoops) {
+      std::optional<unsigned> bestLoop;
+      int64_t bestCost = 0;
+      for (unsigned loop = 0; loop < numLoops; ++loop) {
+        if (isScheduled[loop])
+          continue;
+        bool isLegal = true;
+        int64_t cost = 0;
+        for (const LoopDependence *dependence : activeDependences) {
+          if (dependence->lb[loop] < 0) {
+            isLegal = false;
+            break;
+          }
+          cost = std::max(cost, dependence->ub[loop]);
+        }
+        if (isLegal && (!bestLoop || cost < bestCost)) {
+          bestLoop = loop;
+          bestCost = cost;
+        }
+      }
+      if (!bestLoop)
+        break;
+      isScheduled[*bestLoop] = true;
+      schedule.order.push_back(*bestLoop);
+      ++bandSize;
+    }
+
+    // None of the remaining loops can start a band: keep them in their
+    // original order, which preserves the dependences, in bands of one loop.
+    if (bandSize == 0) {
+      for (unsigned loop = 0; loop < numLoops; ++loop) {
+        if (isScheduled[loop])
+          continue;
+        schedule.order.push_back(loop);
+        schedule.bandSizes.push_back(1);
+      }
+      break;
+    }
+
+    schedule.bandSizes.push_back(bandSize);
+    ArrayRef<unsigned> band = ArrayRef(schedule.order).take_back(bandSize);
+    llvm::erase_if(activeDependences, [&](const LoopDependence *dependence) {
+      return llvm::any_of(
+          band, [&](unsigned loop) { return dependence->lb[loop] > 0; });
+    });
+  }
+  return schedule;
+}
+
+/// Returns the number of accesses nested in `forOp` that only vary with its
+/// induction variable along their innermost dimension.
+static unsigned getNumContiguousAccesses(AffineForOp forOp) {
+  unsigned numAccesses = 0;
+  Value iv = forOp.getInductionVar();
+  forOp.walk([&](Operation *op) {
+    if (!isa<AffineReadOpInterface, AffineWriteOpInterface>(op))
+      return;
+    AffineValueMap accessMap;
+    MemRefAccess(op).getAccessMap(&accessMap);
+    unsigned numResults = accessMap.getNumResults();
+    if (numResults == 0 || !accessMap.isFunctionOf(numResults - 1, iv))
+      return;
+    for (unsigned i = 0; i + 1 < numResults; ++i)
+      if (accessMap.isFunctionOf(i, iv))
+        return;
+    ++numAccesses;
+  });
+  return numAccesses;
+}
+
+/// Moves the loop of `loops`, a perfect nest of intra-tile loops of a band,
+/// with the most contiguous accesses to the innermost position, and updates
+/// `loops` to the new order.
+static void sinkContiguousLoop(MutableArrayRef<AffineForOp> loops) {
+  unsigned innermost = loops.size() - 1;
+  unsigned bestLoop = innermost;
+  unsigned bestNumAccesses = getNumContiguousAccesses(loops[innermost]);
+  for (unsigned loop = 0; loop < innermost; ++loop) {
+    unsigned numAccesses = getNumContiguousAccesses(loops[loop]);
+    if (numAccesses > bestNumAccesses) {
+      bestLoop = loop;
+      bestNumAccesses = numAccesses;
+    }
+  }
+  if (bestLoop == innermost)
+    return;
+
+  SmallVector<unsigned> permMap;
+  for (unsigned loop = 0; loop <= innermost; ++loop) {
+    if (loop == bestLoop)
+      permMap.push_back(innermost);
+    else
+      permMap.push_back(loop < bestLoop ? loop : loop - 1);
+  }
+  permuteLoops(loops, permMap);
+  std::rotate(loops.begin() + bestLoop, loops.begin() + bestLoop + 1,
+              loops.end());
+}
+
+void AffineLoopScheduling::scheduleNest(AffineForOp rootForOp) {
+  SmallVector<AffineForOp> loops;
+  getPerfectlyNestedLoops(loops, rootForOp);
+  if (loops.size() < 2)
+    return;
+  // The loops of the nest can be permuted and tiled if their bounds are
+  // defined above the nest.
+  for (AffineForOp forOp : loops) {
+    if (forOp.getNumIterOperands() != 0 ||
+        llvm::any_of(forOp->getOperands(), [&](Value operand) {
+          return !rootForOp.isDefinedOutsideOfLoop(operand);
+        }))
+      return;
+  }
+
+  SmallVector<LoopDependence> dependences;
+  if (failed(getLoopDependences(loops, dependences))) {
+    LLVM_DEBUG(llvm::dbgs() << "[" DEBUG_TYPE "] unknown dependences in "
+                            << rootForOp << "\n");
+    return;
+  }
+  LoopSchedule schedule = computeSchedule(loops.size(), dependences);
+  LLVM_DEBUG({
+    llvm::dbgs() << "[" DEBUG_TYPE "] loop order:";
+    for (unsigned loop : schedule.order)
+      llvm::dbgs() << " " << loop;
+    llvm::dbgs() << ", band sizes:";
+    for (unsigned bandSize : schedule.bandSizes)
+      llvm::dbgs() << " " << bandSize;
+    llvm::dbgs() << "\n";
+  });
+
+  SmallVector<unsigned> permMap(loops.size());
+  SmallVector<AffineForOp> nest;
+  for (auto [position, loop] : llvm::enumerate(schedule.order)) {
+    permMap[loop] = position;
+    nest.push_back(loops[loop]);
+  }
+  if (!llvm::equal(schedule.order, llvm::seq<unsigned>(0, loops.size())))
+    permuteLoops(loops, permMap);
+
+  // Tile the bands of several loops, and within the innermost band move the
+  // intra-tile loop with the most contiguous accesses innermost.
+  if (tileSize != 0) {
+    SmallVector<AffineForOp> tiledNest;
+    unsigned position = 0;
+    for (auto [index, bandSize] : llvm::enumerate(schedule.bandSizes)) {
+      MutableArrayRef<AffineForOp> band =
+          MutableArrayRef(nest).slice(position, bandSize);
+      position += bandSize;
+      SmallVector<unsigned> tileSizes(bandSize, tileSize);
+      SmallVector<AffineForOp> tiledBand;
+      if (bandSize < 2 ||
+          failed(tilePerfectlyNested(band, tileSizes, &tiledBand))) {
+        llvm::append_range(tiledNest, band);
+        continue;
+      }
+      if (index + 1 == schedule.bandSizes.size())
+        sinkContiguousLoop(MutableArrayRef(tiledBand).drop_front(bandSize));
+      llvm::append_range(tiledNest, tiledBand);
+    }
+    nest = std::move(tiledNest);
+  }
+
+  if (!parallelize)
+    return;
+  for (AffineForOp forOp : nest) {
+    if (isLoopParallel(forOp)) {
+      (void)affineParallelize(forOp);
+      break;
+    }
+  }
+}
+
+void AffineLoopScheduling::runOnOperation() {
+  // Schedule the outermost nests, which are not nested in other loops.
+  SmallVector<AffineForOp> rootForOps;
+  getOperation().walk([&](AffineForOp forOp) {
+    Operation *parentOp = forOp->getParentOp();
+    while (parentOp && !isa<AffineForOp, AffineParallelOp>(parentOp))
+      parentOp = parentOp->getParentOp();
+    if (!parentOp)
+      rootForOps.push_back(forOp);
+  });
+  for (AffineForOp rootForOp : rootForOps)
+    scheduleNest(rootForOp);
+}
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::affine::createAffineLoopSchedulingPass() {
+  return std::make_unique<AffineLoopScheduling>();
+}
@@ -45,6 +45,12 @@ struct PipelineDataTransfer
   void runOnOperation() override;
   void runOnAffineForOp(AffineForOp forOp);
 
+  /// Returns the number of buffers to allocate for each of the fast memory
+  /// buffers `memRefs` written by the DMAs of `forOp`, whose trip count is
+  /// `tripCount`.
+  unsigned getNumBuffers(AffineForOp forOp, ArrayRef<Value> memRefs,
+                         uint64_t tripCount);
+
   std::vector<AffineForOp> forOps;
 };
 
@@ -69,29 +75,31 @@ static unsigned getTagMemRefPos(Operation &dmaOp) {
   return 0;
 }
 
-/// Doubles the buffer of the supplied memref on the specified 'affine.for'
-/// operation by adding a leading dimension of size two to the memref.
+/// Multiplies the buffer of the supplied memref on the specified 'affine.for'
+/// operation by adding a leading dimension of size `numBuffers` to the memref.
 /// Replaces all uses of the old memref by the new one while indexing the newly
-/// added dimension by the loop IV of the specified 'affine.for' operation
-/// modulo 2. Returns false if such a replacement cannot be performed.
-static bool doubleBuffer(Value oldMemRef, AffineForOp forOp) {
+/// added dimension by the iteration number of the specified 'affine.for'
+/// operation modulo `numBuffers`. Returns false if such a replacement cannot
+/// be performed.
+static bool multiBuffer(Value oldMemRef, AffineForOp forOp,
+                        unsigned numBuffers) {
   auto *forBody = forOp.getBody();
   OpBuilder bInner(forBody, forBody->begin());
 
-  // Doubles the shape with a leading dimension extent of 2.
-  auto doubleShape = [&](MemRefType oldMemRefType) -> MemRefType {
-    // Add the leading dimension in the shape for the double buffer.
+  // Multiplies the shape with a leading dimension extent of `numBuffers`.
+  auto multiplyShape = [&](MemRefType oldMemRefType) -> MemRefType {
+    // Add the leading dimension in the shape for the multiple buffers.
     ArrayRef<int64_t> oldShape = oldMemRefType.getShape();
     SmallVector<int64_t, 4> newShape(1 + oldMemRefType.getRank());
-    newShape[0] = 2;
+    newShape[0] = numBuffers;
     std::copy(oldShape.begin(), oldShape.end(), newShape.begin() + 1);
     return MemRefType::Builder(oldMemRefType).setShape(newShape).setLayout({});
   };
 
   auto oldMemRefType = cast<MemRefType>(oldMemRef.getType());
-  auto newMemRefType = doubleShape(oldMemRefType);
+  auto newMemRefType = multiplyShape(oldMemRefType);
 
-  // The double buffer is allocated right before 'forOp'.
+  // The multiple buffer is allocated right before 'forOp'.
   OpBuilder bOuter(forOp);
   // Put together alloc operands for any dynamic dimensions of the memref.
   SmallVector<Value, 4> allocOperands;
@@ -105,26 +113,26 @@ static bool doubleBuffer(Value oldMemRef, AffineForOp forOp) {
   Value newMemRef = bOuter.create<memref::AllocOp>(
       forOp.getLoc(), newMemRefType, allocOperands);
 
-  // Create 'iv mod 2' value to index the leading dimension.
+  // Create 'iv mod numBuffers' value to index the leading dimension.
   auto d0 = bInner.getAffineDimExpr(0);
   int64_t step = forOp.getStep();
-  auto modTwoMap =
-      AffineMap::get(/*dimCount=*/1, /*symbolCount=*/0, d0.floorDiv(step) % 2);
-  auto ivModTwoOp = bInner.create<AffineApplyOp>(forOp.getLoc(), modTwoMap,
-                                                 forOp.getInductionVar());
+  auto modMap = AffineMap::get(/*dimCount=*/1, /*symbolCount=*/0,
+                               d0.floorDiv(step) % numBuffers);
+  auto ivModOp = bInner.create<AffineApplyOp>(forOp.getLoc(), modMap,
+                                              forOp.getInductionVar());
 
   // replaceAllMemRefUsesWith will succeed unless the forOp body has
   // non-dereferencing uses of the memref (dealloc's are fine though).
   if (failed(replaceAllMemRefUsesWith(
           oldMemRef, newMemRef,
-          /*extraIndices=*/{ivModTwoOp},
+          /*extraIndices=*/{ivModOp},
           /*indexRemap=*/AffineMap(),
           /*extraOperands=*/{},
           /*symbolOperands=*/{},
           /*domOpFilter=*/&*forOp.getBody()->begin()))) {
     LLVM_DEBUG(
-        forOp.emitError("memref replacement for double buffering failed"));
-    ivModTwoOp.erase();
+        forOp.emitError("memref replacement for multi-buffering failed"));
+    ivModOp.erase();
     return false;
   }
   // Insert the dealloc op right after the for loop.
@@ -134,6 +142,38 @@ static bool doubleBuffer(Value oldMemRef, AffineForOp forOp) {
   return true;
 }
 
+unsigned PipelineDataTransfer::getNumBuffers(AffineForOp forOp,
+                                             ArrayRef<Value> memRefs,
+                                             uint64_t tripCount) {
+  // At least two buffers are needed to overlap the transfers with the
+  // computation, and more than one per iteration are never used.
+  unsigned numBuffers = std::max<uint64_t>(
+      2, std::min<uint64_t>(maxBuffers, std::max<uint64_t>(tripCount, 2)));
+
+  // As for the copy generation, the buffers of the loop may use all of the
+  // fast memory capacity.
+  std::optional<uint64_t> capacityBytes;
+  if (fastMemoryCapacity != std::numeric_limits<uint64_t>::max())
+    capacityBytes = fastMemoryCapacity * 1024;
+  else
+    capacityBytes = getScratchpadSizeBytes(forOp);
+  if (!capacityBytes)
+    return numBuffers;
+
+  uint64_t iterationBytes = 0;
+  for (Value memRef : memRefs) {
+    std::optional<uint64_t> sizeInBytes =
+        getIntOrFloatMemRefSizeInBytes(cast<MemRefType>(memRef.getType()));
+    if (!sizeInBytes)
+      return 2;
+    iterationBytes += *sizeInBytes;
+  }
+  if (iterationBytes == 0)
+    return numBuffers;
+  return std::max<uint64_t>(
+      2, std::min<uint64_t>(numBuffers, *capacityBytes / iterationBytes));
+}
+
 /// Returns success if the IR is in a valid state.
 void PipelineDataTransfer::runOnOperation() {
   // Do a post order walk so that inner loop DMAs are processed first. This is
@@ -258,23 +298,36 @@ void PipelineDataTransfer::runOnAffineForOp(AffineForOp forOp) {
     return;
   }
 
-  // Double the buffers for the higher memory space memref's.
+  // Multiply the buffers for the higher memory space memref's.
   // Identify memref's to replace by scanning through all DMA start
   // operations. A DMA start operation has two memref's - the one from the
-  // higher level of memory hierarchy is the one to double buffer.
-  // TODO: check whether double-buffering is even necessary.
+  // higher level of memory hierarchy is the one to multi-buffer. The number
+  // of buffers is bounded by the fast memory capacity available to the
+  // buffers of an iteration.
+  // TODO: check whether multi-buffering is even necessary.
   // TODO: make this work with different layouts: assuming here that
-  // the dimension we are adding here for the double buffering is the outermost
+  // the dimension we are adding here for the multi-buffering is the outermost
   // dimension.
+  SmallVector<Value, 4> fastMemRefs;
+  for (auto &pair : startWaitPairs) {
+    Value memRef = pair.first->getOperand(
+        cast<AffineDmaStartOp>(pair.first).getFasterMemPos());
+    if (!llvm::is_contained(fastMemRefs, memRef))
+      fastMemRefs.push_back(memRef);
+  }
+  unsigned numBuffers =
+      getNumBuffers(forOp, fastMemRefs, *mayBeConstTripCount);
+  LLVM_DEBUG(llvm::dbgs() << "using " << numBuffers << " buffers\n");
+
   for (auto &pair : startWaitPairs) {
     auto *dmaStartOp = pair.first;
     Value oldMemRef = dmaStartOp->getOperand(
         cast<AffineDmaStartOp>(dmaStartOp).getFasterMemPos());
-    if (!doubleBuffer(oldMemRef, forOp)) {
-      // Normally, double buffering should not fail because we already checked
+    if (!multiBuffer(oldMemRef, forOp, numBuffers)) {
+      // Normally, multi-buffering should not fail because we already checked
       // that there are no uses outside.
       LLVM_DEBUG(llvm::dbgs()
-                     << "double buffering failed for" << dmaStartOp << "\n";);
+                     << "multi-buffering failed for" << dmaStartOp << "\n";);
       // IR still valid and semantically correct.
       return;
     }
@@ -297,12 +350,12 @@ void PipelineDataTransfer::runOnAffineForOp(AffineForOp forOp) {
     }
   }
 
-  // Double the buffers for tag memrefs.
+  // Multiply the buffers for tag memrefs.
   for (auto &pair : startWaitPairs) {
     auto *dmaFinishOp = pair.second;
     Value oldTagMemRef = dmaFinishOp->getOperand(getTagMemRefPos(*dmaFinishOp));
-    if (!doubleBuffer(oldTagMemRef, forOp)) {
-      LLVM_DEBUG(llvm::dbgs() << "tag double buffering failed\n";);
+    if (!multiBuffer(oldTagMemRef, forOp, numBuffers)) {
+      LLVM_DEBUG(llvm::dbgs() << "tag multi-buffering failed\n";);
       return;
     }
     // If the old tag has no uses or a single dealloc use, remove it.
@@ -320,7 +373,7 @@ void PipelineDataTransfer::runOnAffineForOp(AffineForOp forOp) {
     }
   }
 
-  // Double buffering would have invalidated all the old DMA start/wait insts.
+  // Multi-buffering would have invalidated all the old DMA start/wait insts.
   startWaitPairs.clear();
   findMatchingStartFinishInsts(forOp, startWaitPairs);
 
@@ -348,10 +401,12 @@ void PipelineDataTransfer::runOnAffineForOp(AffineForOp forOp) {
       }
     }
   }
-  // Everything else (including compute ops and dma finish) are shifted by one.
+  // Everything else (including compute ops and dma finish) are shifted by one
+  // less than the number of buffers, such that the DMAs are started as many
+  // iterations ahead as there are spare buffers.
   for (auto &op : forOp.getBody()->without_terminator())
     if (!instShiftMap.contains(&op))
-      instShiftMap[&op] = 1;
+      instShiftMap[&op] = numBuffers - 1;
 
   // Get shifts stored in map.
   SmallVector<uint64_t, 8> shifts(forOp.getBody()->getOperations().size());
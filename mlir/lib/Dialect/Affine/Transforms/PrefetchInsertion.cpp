@@ -0,0 +1,197 @@
+//===- PrefetchInsertion.cpp - Insert prefetches ahead of vector reads ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass that inserts software prefetches ahead of the
+// vector transfer reads of the innermost affine.for and scf.for loops. The
+// data read by an iteration is prefetched a number of iterations ahead, such
+// that the prefetches cover a fixed number of bytes ahead of the reads. The
+// number of bytes accessed by an iteration is derived from the vectors of the
+// transfers, and from the memref regions of the affine accesses.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Affine/Passes.h"
+
+#include "mlir/Dialect/Affine/Analysis/LoopAnalysis.h"
+#include "mlir/Dialect/Affine/Analysis/Utils.h"
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Interfaces/DataLayoutInterfaces.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "llvm/Support/Debug.h"
+
+namespace mlir {
+namespace affine {
+#define GEN_PASS_DEF_AFFINEPREFETCHINSERTION
+#include "mlir/Dialect/Affine/Passes.h.inc"
+} // namespace affine
+} // namespace mlir
+
+#define DEBUG_TYPE "affine-prefetch-insertion"
+
+using namespace mlir;
+using namespace mlir::affine;
+
+namespace {
+struct AffinePrefetchInsertion
+    : public affine::impl::AffinePrefetchInsertionBase<
+          AffinePrefetchInsertion> {
+  void runOnOperation() override;
+
+private:
+  void insertPrefetches(Operation *loop, Block *body, Value iv);
+};
+} // namespace
+
+/// Returns the number of bytes accessed by one iteration of `loop`, whose
+/// body is `body`.
+static int64_t getIterationFootprintBytes(Operation *loop, Block *body) {
+  DataLayout layout = DataLayout::closest(loop);
+  int64_t bytes = 0;
+  body->walk([&](Operation *op) {
+    if (auto xferOp = dyn_cast<VectorTransferOpInterface>(op)) {
+      if (isa<MemRefType>(xferOp.getShapedType()))
+        bytes += layout.getTypeSize(xferOp.getVectorType());
+    } else if (auto loadOp = dyn_cast<memref::LoadOp>(op)) {
+      bytes += layout.getTypeSize(loadOp.getType());
+    } else if (auto storeOp = dyn_cast<memref::StoreOp>(op)) {
+      bytes += layout.getTypeSize(storeOp.getValueToStore().getType());
+    }
+  });
+  // The affine accesses are accounted for by the regions they access over
+  // the whole loop, evenly divided among its iterations.
+  if (auto forOp = dyn_cast<AffineForOp>(loop)) {
+    std::optional<int64_t> footprint = getMemoryFootprintBytes(forOp);
+    std::optional<uint64_t> tripCount = getConstantTripCount(forOp);
+    if (footprint && tripCount && *tripCount > 0)
+      bytes += llvm::divideCeil(*footprint, *tripCount);
+  }
+  return bytes;
+}
+
+/// Returns the value of `value`, defined in the loop body `body`, at the
+/// iteration ahead whose induction variable is mapped by `mapping`. Clones the
+/// ops of `body` that compute it, and returns a null value when `value`
+/// depends on ops that cannot be cloned.
+static Value getValueAhead(OpBuilder &builder, Value value, Block *body,
+                           IRMapping &mapping) {
+  if (Value mapped = mapping.lookupOrNull(value))
+    return mapped;
+  // The values defined outside of the loop do not depend on the iteration.
+  if (value.getParentBlock() != body)
+    return value;
+  Operation *op = value.getDefiningOp();
+  if (!op || op->getNumRegions() != 0 || !isMemoryEffectFree(op))
+    return Value();
+  for (Value operand : op->getOperands())
+    if (!getValueAhead(builder, operand, body, mapping))
+      return Value();
+  Operation *clone = builder.clone(*op, mapping);
+  return clone->getResult(cast<OpResult>(value).getResultNumber());
+}
+
+void AffinePrefetchInsertion::insertPrefetches(Operation *loop, Block *body,
+                                               Value iv) {
+  SmallVector<vector::TransferReadOp> reads;
+  for (auto readOp : body->getOps<vector::TransferReadOp>()) {
+    // Only the reads that move with the loop are prefetched.
+    if (isa<MemRefType>(readOp.getShapedType()) &&
+        llvm::any_of(readOp.getIndices(), [&](Value index) {
+          return index == iv || index.getParentBlock() == body;
+        }))
+      reads.push_back(readOp);
+  }
+  if (reads.empty())
+    return;
+  int64_t iterationBytes = getIterationFootprintBytes(loop, body);
+  if (iterationBytes <= 0)
+    return;
+  int64_t distance = llvm::divideCeil(lookaheadBytes, iterationBytes);
+  LLVM_DEBUG(llvm::dbgs() << "[" DEBUG_TYPE "] prefetching " << distance
+                          << " iterations ahead of " << iterationBytes
+                          << " bytes per iteration in\n"
+                          << *loop << "\n");
+
+  // Compute the induction variable `distance` iterations ahead.
+  OpBuilder builder = OpBuilder::atBlockBegin(body);
+  Location loc = loop->getLoc();
+  Value aheadIv;
+  if (auto forOp = dyn_cast<AffineForOp>(loop)) {
+    AffineExpr d0 = builder.getAffineDimExpr(0);
+    aheadIv = builder.create<AffineApplyOp>(
+        loc, AffineMap::get(1, 0, d0 + distance * forOp.getStep()), iv);
+  } else {
+    auto forOp = cast<scf::ForOp>(loop);
+    Value offset = builder.createOrFold<arith::MulIOp>(
+        loc, forOp.getStep(),
+        builder.create<arith::ConstantIndexOp>(loc, distance));
+    aheadIv = builder.create<arith::AddIOp>(loc, iv, offset);
+  }
+
+  IRMapping mapping;
+  mapping.map(iv, aheadIv);
+  SmallVector<std::pair<Value, SmallVector<Value>>> prefetched;
+  for (vector::TransferReadOp readOp : reads) {
+    builder.setInsertionPoint(readOp);
+    SmallVector<Value> indices;
+    for (Value index : readOp.getIndices()) {
+      Value aheadIndex = getValueAhead(builder, index, body, mapping);
+      if (!aheadIndex)
+        break;
+      indices.push_back(aheadIndex);
+    }
+    if (indices.size() != readOp.getIndices().size())
+      continue;
+    // Prefetch the data of the reads of the same elements once.
+    auto key = std::make_pair(readOp.getSource(), indices);
+    if (llvm::is_contained(prefetched, key))
+      continue;
+    prefetched.push_back(key);
+    builder.create<memref::PrefetchOp>(readOp.getLoc(), readOp.getSource(),
+                                       indices, /*isWrite=*/false,
+                                       localityHint, /*isDataCache=*/true);
+  }
+}
+
+void AffinePrefetchInsertion::runOnOperation() {
+  if (lookaheadBytes <= 0 || localityHint > 3) {
+    getOperation().emitError("expected a positive lookahead and a locality "
+                             "hint between 0 and 3");
+    return signalPassFailure();
+  }
+
+  // Collect the innermost loops first, as the insertion adds ops to them.
+  SmallVector<Operation *> innermostLoops;
+  getOperation().walk([&](Operation *op) {
+    if (!isa<AffineForOp, scf::ForOp>(op))
+      return;
+    bool hasNestedLoop = false;
+    op->walk([&](LoopLikeOpInterface nested) {
+      hasNestedLoop |= nested.getOperation() != op;
+    });
+    if (!hasNestedLoop)
+      innermostLoops.push_back(op);
+  });
+
+  for (Operation *loop : innermostLoops) {
+    if (auto forOp = dyn_cast<AffineForOp>(loop))
+      insertPrefetches(forOp, forOp.getBody(), forOp.getInductionVar());
+    else if (auto forOp = dyn_cast<scf::ForOp>(loop))
+      insertPrefetches(forOp, forOp.getBody(), forOp.getInductionVar());
+  }
+}
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::affine::createAffinePrefetchInsertionPass() {
+  return std::make_unique<AffinePrefetchInsertion>();
+}
@@ -184,7 +184,8 @@ gatherLoadsAndStores(AffineForOp forOp,
 // TODO: Generalize this check for sibling and more generic fusion scenarios.
 // TODO: Support forward slice fusion.
 static unsigned getMaxLoopDepth(ArrayRef<Operation *> srcOps,
-                                ArrayRef<Operation *> dstOps) {
+                                ArrayRef<Operation *> dstOps,
+                                AffineDependenceAnalysis &dependences) {
   if (dstOps.empty())
     // Expected at least one memory operation.
     // TODO: Revisit this case with a specific example.
@@ -226,9 +227,8 @@ static unsigned getMaxLoopDepth(ArrayRef<Operation *> srcOps,
       unsigned numCommonLoops =
           getNumCommonSurroundingLoops(*srcOpInst, *dstOpInst);
       for (unsigned d = 1; d <= numCommonLoops + 1; ++d) {
-        // TODO: Cache dependence analysis results, check cache here.
         DependenceResult result =
-            checkMemrefAccessDependence(srcAccess, dstAccess, d);
+            dependences.checkDependence(srcAccess, dstAccess, d);
         if (hasDependence(result)) {
           // Store minimum loop depth and break because we want the min 'd' at
           // which there is a dependence.
@@ -250,7 +250,12 @@ FusionResult mlir::affine::canFuseLoops(AffineForOp srcForOp,
                                         AffineForOp dstForOp,
                                         unsigned dstLoopDepth,
                                         ComputationSliceState *srcSlice,
-                                        FusionStrategy fusionStrategy) {
+                                        FusionStrategy fusionStrategy,
+                                        AffineDependenceAnalysis *dependences) {
+  AffineDependenceAnalysis localDependences;
+  if (!dependences)
+    dependences = &localDependences;
+
   // Return 'failure' if 'dstLoopDepth == 0'.
   if (dstLoopDepth == 0) {
     LLVM_DEBUG(llvm::dbgs() << "Cannot fuse loop nests at depth 0\n");
@@ -297,7 +302,7 @@ FusionResult mlir::affine::canFuseLoops(AffineForOp srcForOp,
   if (fusionStrategy.getStrategy() == FusionStrategy::ProducerConsumer) {
     // TODO: 'getMaxLoopDepth' does not support forward slice fusion.
     assert(isSrcForOpBeforeDstForOp && "Unexpected forward slice fusion");
-    if (getMaxLoopDepth(opsA, opsB) < dstLoopDepth) {
+    if (getMaxLoopDepth(opsA, opsB, *dependences) < dstLoopDepth) {
       LLVM_DEBUG(llvm::dbgs() << "Fusion would violate loop dependences\n");
       return FusionResult::FailFusionDependence;
     }
@@ -339,7 +344,7 @@ FusionResult mlir::affine::canFuseLoops(AffineForOp srcForOp,
   // from 'forOpA' and 'forOpB'.
   SliceComputationResult sliceComputationResult = affine::computeSliceUnion(
       strategyOpsA, opsB, dstLoopDepth, numCommonLoops,
-      isSrcForOpBeforeDstForOp, srcSlice);
+      isSrcForOpBeforeDstForOp, srcSlice, dependences);
   if (sliceComputationResult.value == SliceComputationResult::GenericFailure) {
     LLVM_DEBUG(llvm::dbgs() << "computeSliceUnion failed\n");
     return FusionResult::FailPrecondition;
@@ -659,7 +659,8 @@ LogicalResult mlir::affine::normalizeAffineFor(AffineForOp op,
 /// inside of the innermost common surrounding affine loop between the two
 /// accesses.
 static bool mustReachAtInnermost(const MemRefAccess &srcAccess,
-                                 const MemRefAccess &destAccess) {
+                                 const MemRefAccess &destAccess,
+                                 AffineDependenceAnalysis &dependences) {
   // Affine dependence analysis is possible only if both ops in the same
   // AffineScope.
   if (getAffineScope(srcAccess.opInst) != getAffineScope(destAccess.opInst))
@@ -668,7 +669,7 @@ static bool mustReachAtInnermost(const MemRefAccess &srcAccess,
   unsigned nsLoops =
       getNumCommonSurroundingLoops(*srcAccess.opInst, *destAccess.opInst);
   DependenceResult result =
-      checkMemrefAccessDependence(srcAccess, destAccess, nsLoops + 1);
+      dependences.checkDependence(srcAccess, destAccess, nsLoops + 1);
   return hasDependence(result);
 }
 
@@ -676,7 +677,8 @@ static bool mustReachAtInnermost(const MemRefAccess &srcAccess,
 /// scope of the outermost `minSurroundingLoops` loops that surround them.
 /// `srcMemOp` and `destMemOp` are expected to be affine read/write ops.
 static bool mayHaveEffect(Operation *srcMemOp, Operation *destMemOp,
-                          unsigned minSurroundingLoops) {
+                          unsigned minSurroundingLoops,
+                          AffineDependenceAnalysis &dependences) {
   MemRefAccess srcAccess(srcMemOp);
   MemRefAccess destAccess(destMemOp);
 
@@ -689,11 +691,9 @@ static bool mayHaveEffect(Operation *srcMemOp, Operation *destMemOp,
   if (srcAccess.memref == destAccess.memref &&
       srcScope == getAffineScope(destMemOp)) {
     unsigned nsLoops = getNumCommonSurroundingLoops(*srcMemOp, *destMemOp);
-    FlatAffineValueConstraints dependenceConstraints;
     for (unsigned d = nsLoops + 1; d > minSurroundingLoops; d--) {
-      DependenceResult result = checkMemrefAccessDependence(
-          srcAccess, destAccess, d, &dependenceConstraints,
-          /*dependenceComponents=*/nullptr);
+      DependenceResult result =
+          dependences.checkDependence(srcAccess, destAccess, d);
       // A dependence failure or the presence of a dependence implies a
       // side effect.
       if (!noDependence(result))
@@ -708,7 +708,12 @@ static bool mayHaveEffect(Operation *srcMemOp, Operation *destMemOp,
 }
 
 template <typename EffectType, typename T>
-bool mlir::affine::hasNoInterveningEffect(Operation *start, T memOp) {
+bool mlir::affine::hasNoInterveningEffect(
+    Operation *start, T memOp, AffineDependenceAnalysis *dependences) {
+  AffineDependenceAnalysis localDependences;
+  if (!dependences)
+    dependences = &localDependences;
+
   auto isLocallyAllocated = [](Value memref) {
     auto *defOp = memref.getDefiningOp();
     return defOp && hasSingleEffect<MemoryEffects::Allocate>(defOp, memref);
@@ -759,7 +764,7 @@ bool mlir::affine::hasNoInterveningEffect(Operation *start, T memOp) {
         // smaller number of surrounding loops before.
         unsigned minSurroundingLoops =
             getNumCommonSurroundingLoops(*start, *memOp);
-        if (mayHaveEffect(op, memOp, minSurroundingLoops))
+        if (mayHaveEffect(op, memOp, minSurroundingLoops, *dependences))
           hasSideEffect = true;
         return;
       }
@@ -864,7 +869,8 @@ bool mlir::affine::hasNoInterveningEffect(Operation *start, T memOp) {
 /// `loadOpsToErase` and its memref will be added to `memrefsToErase`.
 static LogicalResult forwardStoreToLoad(
     AffineReadOpInterface loadOp, SmallVectorImpl<Operation *> &loadOpsToErase,
-    SmallPtrSetImpl<Value> &memrefsToErase, DominanceInfo &domInfo) {
+    SmallPtrSetImpl<Value> &memrefsToErase, DominanceInfo &domInfo,
+    AffineDependenceAnalysis &dependences) {
 
   // The store op candidate for forwarding that satisfies all conditions
   // to replace the load, if any.
@@ -896,12 +902,13 @@ static LogicalResult forwardStoreToLoad(
     // guarantees this for accesses in the same block. The load could be in a
     // nested block that is unreachable.
     if (storeOp->getBlock() != loadOp->getBlock() &&
-        !mustReachAtInnermost(srcAccess, destAccess))
+        !mustReachAtInnermost(srcAccess, destAccess, dependences))
       continue;
 
     // 4. Ensure there is no intermediate operation which could replace the
     // value in memory.
-    if (!affine::hasNoInterveningEffect<MemoryEffects::Write>(storeOp, loadOp))
+    if (!affine::hasNoInterveningEffect<MemoryEffects::Write>(storeOp, loadOp,
+                                                              &dependences))
       continue;
 
     // We now have a candidate for forwarding.
@@ -931,7 +938,8 @@ static LogicalResult forwardStoreToLoad(
 template bool
 mlir::affine::hasNoInterveningEffect<mlir::MemoryEffects::Read,
                                      affine::AffineReadOpInterface>(
-    mlir::Operation *, affine::AffineReadOpInterface);
+    mlir::Operation *, affine::AffineReadOpInterface,
+    AffineDependenceAnalysis *);
 
 // This attempts to find stores which have no impact on the final result.
 // A writing op writeA will be eliminated if there exists an op writeB if
@@ -940,7 +948,8 @@ mlir::affine::hasNoInterveningEffect<mlir::MemoryEffects::Read,
 // 3) There is no potential read between writeA and writeB.
 static void findUnusedStore(AffineWriteOpInterface writeA,
                             SmallVectorImpl<Operation *> &opsToErase,
-                            PostDominanceInfo &postDominanceInfo) {
+                            PostDominanceInfo &postDominanceInfo,
+                            AffineDependenceAnalysis &dependences) {
 
   for (Operation *user : writeA.getMemRef().getUsers()) {
     // Only consider writing operations.
@@ -969,7 +978,8 @@ static void findUnusedStore(AffineWriteOpInterface writeA,
 
     // There cannot be an operation which reads from memory between
     // the two writes.
-    if (!affine::hasNoInterveningEffect<MemoryEffects::Read>(writeA, writeB))
+    if (!affine::hasNoInterveningEffect<MemoryEffects::Read>(writeA, writeB,
+                                                             &dependences))
       continue;
 
     opsToErase.push_back(writeA);
@@ -985,7 +995,8 @@ static void findUnusedStore(AffineWriteOpInterface writeA,
 // 3) There is no write between loadA and loadB.
 static void loadCSE(AffineReadOpInterface loadA,
                     SmallVectorImpl<Operation *> &loadOpsToErase,
-                    DominanceInfo &domInfo) {
+                    DominanceInfo &domInfo,
+                    AffineDependenceAnalysis &dependences) {
   SmallVector<AffineReadOpInterface, 4> loadCandidates;
   for (auto *user : loadA.getMemRef().getUsers()) {
     auto loadB = dyn_cast<AffineReadOpInterface>(user);
@@ -1006,7 +1017,7 @@ static void loadCSE(AffineReadOpInterface loadA,
 
     // 3. There is no write between loadA and loadB.
     if (!affine::hasNoInterveningEffect<MemoryEffects::Write>(
-            loadB.getOperation(), loadA))
+            loadB.getOperation(), loadA, &dependences))
       continue;
 
     // Check if two values have the same shape. This is needed for affine vector
@@ -1064,7 +1075,12 @@ static void loadCSE(AffineReadOpInterface loadA,
 // than dealloc) remain.
 //
 void mlir::affine::affineScalarReplace(func::FuncOp f, DominanceInfo &domInfo,
-                                       PostDominanceInfo &postDomInfo) {
+                                       PostDominanceInfo &postDomInfo,
+                                       AffineDependenceAnalysis *dependences) {
+  AffineDependenceAnalysis localDependences;
+  if (!dependences)
+    dependences = &localDependences;
+
   // Load op's whose results were replaced by those forwarded from stores.
   SmallVector<Operation *, 8> opsToErase;
 
@@ -1073,22 +1089,27 @@ void mlir::affine::affineScalarReplace(func::FuncOp f, DominanceInfo &domInfo,
 
   // Walk all load's and perform store to load forwarding.
   f.walk([&](AffineReadOpInterface loadOp) {
-    if (failed(
-            forwardStoreToLoad(loadOp, opsToErase, memrefsToErase, domInfo))) {
-      loadCSE(loadOp, opsToErase, domInfo);
+    if (failed(forwardStoreToLoad(loadOp, opsToErase, memrefsToErase, domInfo,
+                                  *dependences))) {
+      loadCSE(loadOp, opsToErase, domInfo, *dependences);
     }
   });
 
   // Erase all load op's whose results were replaced with store fwd'ed ones.
+  // The operands of the remaining accesses may have changed as well.
+  if (!opsToErase.empty())
+    dependences->clear();
   for (auto *op : opsToErase)
     op->erase();
   opsToErase.clear();
 
   // Walk all store's and perform unused store elimination
   f.walk([&](AffineWriteOpInterface storeOp) {
-    findUnusedStore(storeOp, opsToErase, postDomInfo);
+    findUnusedStore(storeOp, opsToErase, postDomInfo, *dependences);
   });
   // Erase all store op's which don't impact the program
+  if (!opsToErase.empty())
+    dependences->clear();
   for (auto *op : opsToErase)
     op->erase();
 
@@ -45,6 +45,16 @@ void arith::ArithDialect::initialize() {
   addInterfaces<ArithInlinerInterface>();
 }
 
+arith::FastMathFlags arith::getFastMathPolicy(Operation *op) {
+  for (Operation *ancestor = op->getParentOp(); ancestor;
+       ancestor = ancestor->getParentOp()) {
+    if (auto policy = ancestor->getAttrOfType<FastMathFlagsAttr>(
+            ArithDialect::getFastMathPolicyAttrName()))
+      return policy.getValue();
+  }
+  return FastMathFlags::none;
+}
+
 /// Materialize an integer or floating point constant.
 Operation *arith::ArithDialect::materializeConstant(OpBuilder &builder,
                                                     Attribute value, Type type,
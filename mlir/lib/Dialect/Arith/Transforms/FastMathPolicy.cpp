@@ -0,0 +1,56 @@
+//===- FastMathPolicy.cpp - Apply fast-math policies to the FP ops --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Arith/Transforms/Passes.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+
+namespace mlir::arith {
+#define GEN_PASS_DEF_ARITHFASTMATHPOLICY
+#include "mlir/Dialect/Arith/Transforms/Passes.h.inc"
+} // namespace mlir::arith
+
+using namespace mlir;
+using namespace mlir::arith;
+
+namespace {
+struct ArithFastMathPolicyPass final
+    : impl::ArithFastMathPolicyBase<ArithFastMathPolicyPass> {
+  using ArithFastMathPolicyBase::ArithFastMathPolicyBase;
+
+  void runOnOperation() override {
+    Operation *root = getOperation();
+    std::optional<FastMathFlags> rootFlags = symbolizeFastMathFlags(flags);
+    if (!rootFlags) {
+      root->emitError() << "invalid fast-math flags '" << flags << "'";
+      return signalPassFailure();
+    }
+
+    // Record the policy of the anchor op, for the later transformations to
+    // follow it too.
+    MLIRContext *context = &getContext();
+    StringRef policyAttrName = ArithDialect::getFastMathPolicyAttrName();
+    if (*rootFlags != FastMathFlags::none && !root->hasAttr(policyAttrName))
+      root->setAttr(policyAttrName,
+                    FastMathFlagsAttr::get(context, *rootFlags));
+
+    root->walk([&](ArithFastMathInterface op) {
+      FastMathFlags policy = getFastMathPolicy(op);
+      if (policy == FastMathFlags::none)
+        return;
+      FastMathFlags opFlags = FastMathFlags::none;
+      if (FastMathFlagsAttr attr = op.getFastMathFlagsAttr())
+        opFlags = attr.getValue();
+      if ((opFlags | policy) == opFlags)
+        return;
+      op->setAttr(op.getFastMathAttrName(),
+                  FastMathFlagsAttr::get(context, opFlags | policy));
+    });
+  }
+};
+} // namespace
@@ -43,8 +43,8 @@ namespace {
 template <typename SourceOp>
 struct NarrowingPattern : OpRewritePattern<SourceOp> {
   NarrowingPattern(MLIRContext *ctx, const ArithIntNarrowingOptions &options,
-                   PatternBenefit benefit = 1)
-      : OpRewritePattern<SourceOp>(ctx, benefit),
+                   ValueBoundsCache *boundsCache, PatternBenefit benefit = 1)
+      : OpRewritePattern<SourceOp>(ctx, benefit), boundsCache(boundsCache),
         supportedBitwidths(options.bitwidthsSupported.begin(),
                            options.bitwidthsSupported.end()) {
     assert(!supportedBitwidths.empty() && "Invalid options");
@@ -87,6 +87,10 @@ struct NarrowingPattern : OpRewritePattern<SourceOp> {
     return failure();
   }
 
+protected:
+  // The cache of the index value bounds, if any.
+  ValueBoundsCache *boundsCache;
+
 private:
   // Supported integer bitwidths in the ascending order.
   llvm::SmallVector<unsigned, 6> supportedBitwidths;
@@ -443,14 +447,23 @@ struct IndexCastPattern final : NarrowingPattern<CastOp> {
     // Check the lower bound in both the signed and unsigned cast case. We
     // conservatively assume that even unsigned casts may be performed on
     // negative indices.
-    FailureOr<int64_t> lb = ValueBoundsConstraintSet::computeConstantBound(
-        presburger::BoundType::LB, in);
+    FailureOr<int64_t> lb =
+        this->boundsCache
+            ? this->boundsCache->computeConstantBound(presburger::BoundType::LB,
+                                                      in)
+            : ValueBoundsConstraintSet::computeConstantBound(
+                  presburger::BoundType::LB, in);
     if (failed(lb))
       return failure();
 
-    FailureOr<int64_t> ub = ValueBoundsConstraintSet::computeConstantBound(
-        presburger::BoundType::UB, in, /*dim=*/std::nullopt,
-        /*stopCondition=*/nullptr, /*closedUB=*/true);
+    FailureOr<int64_t> ub =
+        this->boundsCache
+            ? this->boundsCache->computeConstantBound(
+                  presburger::BoundType::UB, in, /*dim=*/std::nullopt,
+                  /*closedUB=*/true)
+            : ValueBoundsConstraintSet::computeConstantBound(
+                  presburger::BoundType::UB, in, /*dim=*/std::nullopt,
+                  /*stopCondition=*/nullptr, /*closedUB=*/true);
     if (failed(ub))
       return failure();
 
@@ -750,10 +763,14 @@ struct ArithIntNarrowingPass final
   void runOnOperation() override {
     Operation *op = getOperation();
     MLIRContext *ctx = op->getContext();
+    // The index casts of the same values query overlapping bounds.
+    ValueBoundsCache boundsCache;
     RewritePatternSet patterns(ctx);
     populateArithIntNarrowingPatterns(
-        patterns, ArithIntNarrowingOptions{bitwidthsSupported});
-    if (failed(applyPatternsAndFoldGreedily(op, std::move(patterns))))
+        patterns, ArithIntNarrowingOptions{bitwidthsSupported}, &boundsCache);
+    GreedyRewriteConfig config;
+    config.listener = &boundsCache;
+    if (failed(applyPatternsAndFoldGreedily(op, std::move(patterns), config)))
       signalPassFailure();
   }
 };
@@ -763,8 +780,9 @@ struct ArithIntNarrowingPass final
 // Public API
 //===----------------------------------------------------------------------===//
 
-void populateArithIntNarrowingPatterns(
-    RewritePatternSet &patterns, const ArithIntNarrowingOptions &options) {
+void populateArithIntNarrowingPatterns(RewritePatternSet &patterns,
+                                       const ArithIntNarrowingOptions &options,
+                                       ValueBoundsCache *boundsCache) {
   // Add commute patterns with a higher benefit. This is to expose more
   // optimization opportunities to narrowing patterns.
   patterns.add<ExtensionOverBroadcast, ExtensionOverExtract,
@@ -772,12 +790,12 @@ void populateArithIntNarrowingPatterns(
                ExtensionOverInsert, ExtensionOverInsertElement,
                ExtensionOverInsertStridedSlice, ExtensionOverShapeCast,
                ExtensionOverTranspose, ExtensionOverFlatTranspose>(
-      patterns.getContext(), options, PatternBenefit(2));
+      patterns.getContext(), options, boundsCache, PatternBenefit(2));
 
   patterns.add<AddIPattern, SubIPattern, MulIPattern, DivSIPattern,
                DivUIPattern, MaxSIPattern, MaxUIPattern, MinSIPattern,
                MinUIPattern, SIToFPPattern, UIToFPPattern, IndexCastSIPattern,
-               IndexCastUIPattern>(patterns.getContext(), options);
+               IndexCastUIPattern>(patterns.getContext(), options, boundsCache);
 }
 
 } // namespace mlir::arith
@@ -13,6 +13,8 @@
 #include "mlir/Analysis/DataFlow/DeadCodeAnalysis.h"
 #include "mlir/Analysis/DataFlow/IntegerRangeAnalysis.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 namespace mlir::arith {
@@ -155,8 +157,85 @@ private:
   DataFlowSolver &solver;
 };
 
+/// Erases the runtime assertions whose condition is known to hold, e.g. the
+/// checks of the runtime verification whose comparisons were folded above.
+struct EraseTrueAssert : public OpRewritePattern<cf::AssertOp> {
+  EraseTrueAssert(MLIRContext *context, DataFlowSolver &s)
+      : OpRewritePattern<cf::AssertOp>(context), solver(s) {}
+
+  LogicalResult matchAndRewrite(cf::AssertOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!matchPattern(op.getArg(), m_One())) {
+      auto *result =
+          solver.lookupState<dataflow::IntegerValueRangeLattice>(op.getArg());
+      if (!result || result->getValue().isUninitialized())
+        return failure();
+      std::optional<APInt> value =
+          result->getValue().getValue().getConstantValue();
+      if (!value || !value->isOne())
+        return failure();
+    }
+    rewriter.eraseOp(op);
+    return success();
+  }
+
+private:
+  DataFlowSolver &solver;
+};
+
+/// Rewrites a signed index operation as an i32 operation when its operands
+/// and results are in the range of i32, in which case the wrapping of the
+/// narrower operation cannot change the results.
+template <typename OpTy>
+struct NarrowIndexOp : public OpRewritePattern<OpTy> {
+  NarrowIndexOp(MLIRContext *context, DataFlowSolver &s)
+      : OpRewritePattern<OpTy>(context), solver(s) {}
+
+  LogicalResult matchAndRewrite(OpTy op,
+                                PatternRewriter &rewriter) const override {
+    if (!isa<IndexType>(op.getType()) || !fitsInI32(op.getResult()) ||
+        !llvm::all_of(op->getOperands(),
+                      [&](Value operand) { return fitsInI32(operand); }))
+      return failure();
+
+    Location loc = op.getLoc();
+    Type i32Type = rewriter.getI32Type();
+    SmallVector<Value, 2> operands;
+    for (Value operand : op->getOperands()) {
+      // Reuse the i32 values of the operands that were already narrowed.
+      auto castOp = operand.getDefiningOp<arith::IndexCastOp>();
+      if (castOp && castOp.getIn().getType() == i32Type)
+        operands.push_back(castOp.getIn());
+      else
+        operands.push_back(
+            rewriter.create<arith::IndexCastOp>(loc, i32Type, operand));
+    }
+    Value narrowed = rewriter.create<OpTy>(loc, operands[0], operands[1]);
+    rewriter.replaceOpWithNewOp<arith::IndexCastOp>(op, op.getType(), narrowed);
+    return success();
+  }
+
+private:
+  /// Returns true if `value` is known to be in the range of i32.
+  bool fitsInI32(Value value) const {
+    auto castOp = value.getDefiningOp<arith::IndexCastOp>();
+    if (castOp && castOp.getIn().getType().isInteger(32))
+      return true;
+    auto *result =
+        solver.lookupState<dataflow::IntegerValueRangeLattice>(value);
+    if (!result || result->getValue().isUninitialized())
+      return false;
+    const ConstantIntRanges &range = result->getValue().getValue();
+    return range.smin().getSignificantBits() <= 32 &&
+           range.smax().getSignificantBits() <= 32;
+  }
+
+  DataFlowSolver &solver;
+};
+
 struct IntRangeOptimizationsPass
     : public arith::impl::ArithIntRangeOptsBase<IntRangeOptimizationsPass> {
+  using Base::Base;
 
   void runOnOperation() override {
     Operation *op = getOperation();
@@ -169,6 +248,10 @@ struct IntRangeOptimizationsPass
 
     RewritePatternSet patterns(ctx);
     populateIntRangeOptimizationsPatterns(patterns, solver);
+    if (narrowIndexMath) {
+      populateIndexNarrowingPatterns(patterns, solver);
+      arith::IndexCastOp::getCanonicalizationPatterns(patterns, ctx);
+    }
 
     if (failed(applyPatternsAndFoldGreedily(op, std::move(patterns))))
       signalPassFailure();
@@ -178,7 +261,15 @@ struct IntRangeOptimizationsPass
 
 void mlir::arith::populateIntRangeOptimizationsPatterns(
     RewritePatternSet &patterns, DataFlowSolver &solver) {
-  patterns.add<ConvertCmpOp>(patterns.getContext(), solver);
+  patterns.add<ConvertCmpOp, EraseTrueAssert>(patterns.getContext(), solver);
+}
+
+void mlir::arith::populateIndexNarrowingPatterns(RewritePatternSet &patterns,
+                                                 DataFlowSolver &solver) {
+  patterns.add<NarrowIndexOp<arith::AddIOp>, NarrowIndexOp<arith::SubIOp>,
+               NarrowIndexOp<arith::MulIOp>, NarrowIndexOp<arith::DivSIOp>,
+               NarrowIndexOp<arith::RemSIOp>, NarrowIndexOp<arith::MinSIOp>,
+               NarrowIndexOp<arith::MaxSIOp>>(patterns.getContext(), solver);
 }
 
 std::unique_ptr<Pass> mlir::arith::createIntRangeOptimizationsPass() {
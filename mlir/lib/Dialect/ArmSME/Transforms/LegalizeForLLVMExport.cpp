@@ -53,7 +53,10 @@ void mlir::populateArmSMELegalizeForLLVMExportPatterns(
 void mlir::configureArmSMELegalizeForExportTarget(
     LLVMConversionTarget &target) {
   target.addLegalOp<scf::ForOp, scf::YieldOp, arm_sme::aarch64_sme_zero,
-                    arm_sme::aarch64_sme_str, arm_sme::aarch64_sme_za_enable,
+                    arm_sme::aarch64_sme_str, arm_sme::aarch64_sme_mopa,
+                    arm_sme::aarch64_sme_read_horiz,
+                    arm_sme::aarch64_sme_write_horiz,
+                    arm_sme::aarch64_sme_za_enable,
                     arm_sme::aarch64_sme_za_disable>();
 
   // Mark 'func.func' ops as legal if either:
@@ -103,9 +103,178 @@ struct TransferWriteToArmSMEZeroLowering
     return success();
   }
 };
+
+/// Returns true if the transfer 'xferOp' accesses the rows of a 2-D memref
+/// in bounds and without mask, so that they can be accessed by 1-D loads and
+/// stores.
+static bool isRowTransfer(VectorTransferOpInterface xferOp) {
+  auto memRefType = dyn_cast<MemRefType>(xferOp.getShapedType());
+  return memRefType && memRefType.getRank() == 2 &&
+         xferOp.getVectorType().getRank() == 2 &&
+         xferOp.permutation_map().isMinorIdentity() && !xferOp.getMask() &&
+         !xferOp.hasOutOfBoundsDim();
+}
+
+/// Lower 'vector.contract' ops that accumulate the outer products of the rows
+/// of two 'vector<Kx[N]xT>' column-major and row-major operands into a
+/// 'vector<[N]x[N]xT>' tile to SME outer products into the ZA0 tile of
+/// elements 'T', where 'T' is f32 or f64 and N is the minimal number of
+/// elements of a tile slice. The operands are read from memory and the result
+/// is written to memory, so that the tile is only moved in and out of ZA:
+///
+///   zero {za0} (or write the accumulator rows to the slices of za0)
+///   for k = 0; k < K; ++k
+///     fmopa za0, row k of lhs, row k of rhs
+///   for slice = 0; slice < N * vscale; ++slice
+///     store the slice of za0 to the result row
+///
+struct VectorContractToArmSMELowering
+    : public OpRewritePattern<vector::ContractionOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(vector::ContractionOp contractOp,
+                                PatternRewriter &rewriter) const override {
+    if (contractOp.getKind() != vector::CombiningKind::ADD)
+      return failure();
+    if (cast<vector::MaskableOpInterface>(contractOp.getOperation())
+            .isMasked())
+      return failure();
+
+    using MapList = ArrayRef<ArrayRef<AffineExpr>>;
+    AffineExpr m, n, k;
+    bindDims(contractOp.getContext(), m, n, k);
+    if (contractOp.getIndexingMapsArray() !=
+        AffineMap::inferFromExprList(MapList{{k, m}, {k, n}, {m, n}}))
+      return failure();
+
+    auto accType = dyn_cast<VectorType>(contractOp.getAccType());
+    if (!accType)
+      return failure();
+    Type elemType = accType.getElementType();
+    if (!elemType.isF32() && !elemType.isF64())
+      return failure();
+    int64_t minNumSliceElts = 128 / elemType.getIntOrFloatBitWidth();
+    if (accType.getShape() != ArrayRef<int64_t>({minNumSliceElts,
+                                                 minNumSliceElts}) ||
+        accType.getScalableDims() != ArrayRef<bool>({true, true}))
+      return failure();
+    VectorType lhsType = contractOp.getLhsType();
+    if (contractOp.getRhsType() != lhsType ||
+        lhsType.getElementType() != elemType ||
+        lhsType.getDimSize(1) != minNumSliceElts ||
+        lhsType.getScalableDims() != ArrayRef<bool>({false, true}))
+      return failure();
+
+    auto lhsRead = contractOp.getLhs().getDefiningOp<vector::TransferReadOp>();
+    auto rhsRead = contractOp.getRhs().getDefiningOp<vector::TransferReadOp>();
+    if (!lhsRead || !rhsRead || !isRowTransfer(lhsRead) ||
+        !isRowTransfer(rhsRead))
+      return failure();
+    auto accRead = contractOp.getAcc().getDefiningOp<vector::TransferReadOp>();
+    auto accConstant = contractOp.getAcc().getDefiningOp<arith::ConstantOp>();
+    bool isZeroAcc =
+        accConstant && isSplatZero(elemType, dyn_cast<DenseElementsAttr>(
+                                                 accConstant.getValueAttr()));
+    if (!isZeroAcc && (!accRead || !isRowTransfer(accRead)))
+      return failure();
+    if (!contractOp->hasOneUse())
+      return failure();
+    auto write = dyn_cast<vector::TransferWriteOp>(*contractOp->user_begin());
+    if (!write || !isRowTransfer(write))
+      return failure();
+
+    Location loc = contractOp.getLoc();
+    auto sliceType =
+        VectorType::get({minNumSliceElts}, elemType, /*scalableDims=*/true);
+    auto predicateType = VectorType::get(
+        {minNumSliceElts}, rewriter.getI1Type(), /*scalableDims=*/true);
+    Value ptrue = rewriter.create<arith::ConstantOp>(
+        loc, DenseElementsAttr::get(predicateType, true));
+    Value tile = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getI32Type(), rewriter.getI32IntegerAttr(0));
+    auto lowerBound = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    auto step = rewriter.create<arith::ConstantIndexOp>(loc, 1);
+    auto minElems =
+        rewriter.create<arith::ConstantIndexOp>(loc, minNumSliceElts);
+    auto vscale =
+        rewriter.create<vector::VectorScaleOp>(loc, rewriter.getIndexType());
+    auto numSlices = rewriter.create<arith::MulIOp>(loc, minElems, vscale);
+
+    // Returns the indices of the row 'offset' of the 2-D transfer 'xferOp'.
+    auto getRowIndices = [&](OpBuilder &b, VectorTransferOpInterface xferOp,
+                             Value offset) -> SmallVector<Value> {
+      SmallVector<Value> indices(xferOp.indices());
+      indices[0] = b.create<arith::AddIOp>(loc, indices[0], offset);
+      return indices;
+    };
+
+    // Initialize ZA0 with the accumulator.
+    if (isZeroAcc) {
+      // ZA0.S overlaps ZA0.D and ZA4.D, while ZA0.D is ZA0.D itself.
+      int32_t zeroMask = elemType.isF32() ? 0x11 : 0x01;
+      auto mask = rewriter.create<arith::ConstantOp>(
+          loc, rewriter.getI32Type(), rewriter.getI32IntegerAttr(zeroMask));
+      rewriter.create<arm_sme::aarch64_sme_zero>(loc, mask);
+    } else {
+      rewriter.create<scf::ForOp>(
+          loc, lowerBound, numSlices, step, ValueRange{},
+          [&](OpBuilder &b, Location loc, Value slice, ValueRange) {
+            Value row = b.create<vector::LoadOp>(
+                loc, sliceType, accRead.getSource(),
+                getRowIndices(b, accRead, slice));
+            Value sliceI32 =
+                b.create<arith::IndexCastUIOp>(loc, b.getI32Type(), slice);
+            b.create<arm_sme::aarch64_sme_write_horiz>(loc, tile, sliceI32,
+                                                       ptrue, row);
+            b.create<scf::YieldOp>(loc);
+          });
+    }
+
+    // Accumulate the outer products of the rows of the operands.
+    auto reductionSize =
+        rewriter.create<arith::ConstantIndexOp>(loc, lhsType.getDimSize(0));
+    rewriter.create<scf::ForOp>(
+        loc, lowerBound, reductionSize, step, ValueRange{},
+        [&](OpBuilder &b, Location loc, Value iv, ValueRange) {
+          Value lhsRow =
+              b.create<vector::LoadOp>(loc, sliceType, lhsRead.getSource(),
+                                       getRowIndices(b, lhsRead, iv));
+          Value rhsRow =
+              b.create<vector::LoadOp>(loc, sliceType, rhsRead.getSource(),
+                                       getRowIndices(b, rhsRead, iv));
+          b.create<arm_sme::aarch64_sme_mopa>(loc, tile, ptrue, ptrue, lhsRow,
+                                              rhsRow);
+          b.create<scf::YieldOp>(loc);
+        });
+
+    // Store the slices of ZA0 to the rows of the result.
+    Value passthru = rewriter.create<arith::ConstantOp>(
+        loc, sliceType, rewriter.getZeroAttr(sliceType));
+    rewriter.create<scf::ForOp>(
+        loc, lowerBound, numSlices, step, ValueRange{},
+        [&](OpBuilder &b, Location loc, Value slice, ValueRange) {
+          Value sliceI32 =
+              b.create<arith::IndexCastUIOp>(loc, b.getI32Type(), slice);
+          Value row = b.create<arm_sme::aarch64_sme_read_horiz>(
+              loc, sliceType, passthru, ptrue, tile, sliceI32);
+          b.create<vector::StoreOp>(loc, row, write.getSource(),
+                                    getRowIndices(b, write, slice));
+          b.create<scf::YieldOp>(loc);
+        });
+
+    rewriter.eraseOp(write);
+    rewriter.eraseOp(contractOp);
+    return success();
+  }
+};
 } // namespace
 
 void mlir::arm_sme::populateVectorTransferLoweringPatterns(
     LLVMTypeConverter &converter, RewritePatternSet &patterns) {
   patterns.add<TransferWriteToArmSMEZeroLowering>(converter);
 }
+
+void mlir::arm_sme::populateVectorContractLoweringPatterns(
+    RewritePatternSet &patterns, PatternBenefit benefit) {
+  patterns.add<VectorContractToArmSMELowering>(patterns.getContext(), benefit);
+}
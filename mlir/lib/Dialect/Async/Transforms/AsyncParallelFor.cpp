@@ -18,6 +18,7 @@
 #include "mlir/Dialect/Async/Transforms.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/ImplicitLocOpBuilder.h"
 #include "mlir/IR/Matchers.h"
@@ -25,6 +26,7 @@
 #include "mlir/Support/LLVM.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "mlir/Transforms/RegionUtils.h"
+#include "llvm/Support/MathExtras.h"
 #include <utility>
 
 namespace mlir {
@@ -116,10 +118,12 @@ struct AsyncParallelForRewrite : public OpRewritePattern<scf::ParallelOp> {
 public:
   AsyncParallelForRewrite(
       MLIRContext *ctx, bool asyncDispatch, int32_t numWorkerThreads,
-      AsyncMinTaskSizeComputationFunction computeMinTaskSize)
+      AsyncMinTaskSizeComputationFunction computeMinTaskSize,
+      int32_t inlineThreshold)
       : OpRewritePattern(ctx), asyncDispatch(asyncDispatch),
         numWorkerThreads(numWorkerThreads),
-        computeMinTaskSize(std::move(computeMinTaskSize)) {}
+        computeMinTaskSize(std::move(computeMinTaskSize)),
+        inlineThreshold(inlineThreshold) {}
 
   LogicalResult matchAndRewrite(scf::ParallelOp op,
                                 PatternRewriter &rewriter) const override;
@@ -128,6 +132,7 @@ private:
   bool asyncDispatch;
   int32_t numWorkerThreads;
   AsyncMinTaskSizeComputationFunction computeMinTaskSize;
+  int32_t inlineThreshold;
 };
 
 struct ParallelComputeFunctionType {
@@ -728,8 +733,12 @@ AsyncParallelForRewrite::matchAndRewrite(scf::ParallelOp op,
 
   // Computing minTaskSize emits IR and can be implemented as executing a cost
   // model on the body of the scf.parallel. Thus it needs to be computed before
-  // the body of the scf.parallel has been manipulated.
-  Value minTaskSize = computeMinTaskSize(b, op);
+  // the body of the scf.parallel has been manipulated. The loops marked to run
+  // each iteration on its own thread have tasks of a single iteration.
+  bool threadPerIteration =
+      op->hasAttr(scf::ParallelOp::getThreadPerIterationAttrName());
+  Value minTaskSize = threadPerIteration ? b.create<arith::ConstantIndexOp>(1)
+                                         : computeMinTaskSize(b, op);
 
   // Make sure that all constants will be inside the parallel operation body to
   // reduce the number of parallel compute function arguments.
@@ -864,6 +873,15 @@ AsyncParallelForRewrite::matchAndRewrite(scf::ParallelOp op,
     Value bs1 = b.create<arith::MaxSIOp>(bs0, minTaskSize);
     Value blockSize = b.create<arith::MinSIOp>(tripCount, bs1);
 
+    // Execute the small parallel operations as a single block, for which the
+    // dispatch calls the parallel compute function in the caller thread.
+    if (inlineThreshold > 0 && !threadPerIteration) {
+      Value isSmallLoop = b.create<arith::CmpIOp>(
+          arith::CmpIPredicate::sle, tripCount,
+          b.create<arith::ConstantIndexOp>(inlineThreshold));
+      blockSize = b.create<arith::SelectOp>(isSmallLoop, tripCount, blockSize);
+    }
+
     // Dispatch parallel compute function using async recursive work splitting,
     // or by submitting compute task sequentially from a caller thread.
     auto doDispatch = asyncDispatch ? doAsyncDispatch : doSequentialDispatch;
@@ -934,8 +952,13 @@ void AsyncParallelForPass::runOnOperation() {
   populateAsyncParallelForPatterns(
       patterns, asyncDispatch, numWorkerThreads,
       [&](ImplicitLocOpBuilder builder, scf::ParallelOp op) {
-        return builder.create<arith::ConstantIndexOp>(minTaskSize);
-      });
+        if (!costModel)
+          return builder.create<arith::ConstantIndexOp>(minTaskSize);
+        int64_t cost = estimateParallelIterationCost(op);
+        return builder.create<arith::ConstantIndexOp>(
+            llvm::divideCeil(std::max<int64_t>(minTaskSize, 1), cost));
+      },
+      inlineThreshold);
   if (failed(applyPatternsAndFoldGreedily(getOperation(), std::move(patterns))))
     signalPassFailure();
 }
@@ -953,8 +976,32 @@ std::unique_ptr<Pass> mlir::createAsyncParallelForPass(bool asyncDispatch,
 
 void mlir::async::populateAsyncParallelForPatterns(
     RewritePatternSet &patterns, bool asyncDispatch, int32_t numWorkerThreads,
-    const AsyncMinTaskSizeComputationFunction &computeMinTaskSize) {
+    const AsyncMinTaskSizeComputationFunction &computeMinTaskSize,
+    int32_t inlineThreshold) {
   MLIRContext *ctx = patterns.getContext();
   patterns.add<AsyncParallelForRewrite>(ctx, asyncDispatch, numWorkerThreads,
-                                        computeMinTaskSize);
+                                        computeMinTaskSize, inlineThreshold);
+}
+
+int64_t mlir::async::estimateParallelIterationCost(scf::ParallelOp op) {
+  uint64_t cost = 0;
+  op.getLoopBody().walk([&](Operation *nested) {
+    if (nested->hasTrait<OpTrait::ConstantLike>() ||
+        nested->hasTrait<OpTrait::IsTerminator>())
+      return;
+    uint64_t numExecutions = 1;
+    for (Operation *parent = nested->getParentOp(); parent != op;
+         parent = parent->getParentOp()) {
+      auto forOp = dyn_cast<scf::ForOp>(parent);
+      if (!forOp)
+        continue;
+      std::optional<int64_t> tripCount = constantTripCount(
+          forOp.getLowerBound(), forOp.getUpperBound(), forOp.getStep());
+      if (tripCount && *tripCount > 0)
+        numExecutions = llvm::SaturatingMultiply(
+            numExecutions, static_cast<uint64_t>(*tripCount));
+    }
+    cost = llvm::SaturatingAdd(cost, numExecutions);
+  });
+  return std::clamp<uint64_t>(cost, 1, std::numeric_limits<int32_t>::max());
 }
@@ -39,6 +39,10 @@ public:
 private:
   LogicalResult optimizeReferenceCounting(
       Value value, llvm::SmallDenseMap<Operation *, Operation *> &cancellable);
+
+  /// Coalesces the reference counting operations of the same value that
+  /// follow each other in `block`, without other uses of the value in between.
+  void coalesceReferenceCounting(Block &block);
 };
 
 } // namespace
@@ -184,6 +188,74 @@ LogicalResult AsyncRuntimeRefCountingOptPass::optimizeReferenceCounting(
   return success();
 }
 
+/// Returns the reference counted value and the signed change of its reference
+/// count if `op` is an `add_ref` or a `drop_ref` operation.
+static std::optional<std::pair<Value, int64_t>>
+getReferenceCountChange(Operation *op) {
+  if (auto addRef = dyn_cast<RuntimeAddRefOp>(op))
+    return std::make_pair(addRef.getOperand(), addRef.getCount());
+  if (auto dropRef = dyn_cast<RuntimeDropRefOp>(op))
+    return std::make_pair(dropRef.getOperand(), -dropRef.getCount());
+  return std::nullopt;
+}
+
+void AsyncRuntimeRefCountingOptPass::coalesceReferenceCounting(Block &block) {
+  // The last reference counting operation of each value, if the value has no
+  // other use after it.
+  llvm::SmallDenseMap<Value, Operation *> pending;
+
+  for (Operation &op : llvm::make_early_inc_range(block)) {
+    std::optional<std::pair<Value, int64_t>> change =
+        getReferenceCountChange(&op);
+    if (!change) {
+      // Any other use of a value, including from a nested region, might rely
+      // on the references added before it, or consume one of them.
+      op.walk([&](Operation *nested) {
+        for (Value operand : nested->getOperands())
+          pending.erase(operand);
+      });
+      continue;
+    }
+
+    auto [value, count] = *change;
+    auto it = pending.find(value);
+    if (it == pending.end()) {
+      pending[value] = &op;
+      continue;
+    }
+    Operation *prev = it->second;
+    int64_t prevCount = getReferenceCountChange(prev)->second;
+
+    // A `drop_ref` might destroy the value, and no `add_ref` can be moved
+    // before it.
+    if (prevCount < 0 && count > 0) {
+      it->second = &op;
+      continue;
+    }
+
+    // Replace both operations with a single one at the position of the
+    // `add_ref`, or of the last `drop_ref`, which only extends the lifetime of
+    // the value.
+    int64_t total = prevCount + count;
+    OpBuilder builder(prevCount > 0 ? prev : &op);
+    Operation *coalesced = nullptr;
+    if (total > 0)
+      coalesced = builder.create<RuntimeAddRefOp>(
+          op.getLoc(), value, builder.getI64IntegerAttr(total));
+    else if (total < 0)
+      coalesced = builder.create<RuntimeDropRefOp>(
+          op.getLoc(), value, builder.getI64IntegerAttr(-total));
+    prev->erase();
+    op.erase();
+    numErased += coalesced ? 1 : 2;
+
+    if (coalesced)
+      it->second = coalesced;
+    else
+      pending.erase(it);
+  }
+}
+
 void AsyncRuntimeRefCountingOptPass::runOnOperation() {
   Operation *op = getOperation();
 
@@ -229,6 +301,23 @@ void AsyncRuntimeRefCountingOptPass::runOnOperation() {
     kv.first->erase();
     kv.second->erase();
   }
+  numErased += 2 * cancellable.size();
+
+  op->walk([&](Block *block) { coalesceReferenceCounting(*block); });
+
+  if (reportRemaining) {
+    op->walk([](func::FuncOp func) {
+      if (func.isExternal())
+        return;
+      unsigned numRefCountingOps = 0;
+      func.walk([&](Operation *nested) {
+        if (isa<RuntimeAddRefOp, RuntimeDropRefOp>(nested))
+          ++numRefCountingOps;
+      });
+      func.emitRemark() << numRefCountingOps
+                        << " reference counting operations remaining";
+    });
+  }
 }
 
 std::unique_ptr<Pass> mlir::createAsyncRuntimeRefCountingOptPass() {
@@ -0,0 +1,241 @@
+//===- BufferMemoryPlanning.cpp - Pack allocations into a static arena ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass that replaces the static-shape allocations of
+// the entry block of a function by views into a single buffer, the arena. The
+// lifetime of an allocation spans from the allocation to the last use of any
+// of its aliases, and allocations whose lifetimes do not overlap are assigned
+// overlapping offsets in the arena. The arena is allocated at the start of the
+// function, or optionally passed as an additional argument by the callers of
+// the functions that are not called within the module.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Bufferization/Transforms/Passes.h"
+
+#include "mlir/Analysis/Liveness.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Bufferization/Transforms/BufferViewFlowAnalysis.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Interfaces/DataLayoutInterfaces.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "llvm/Support/MathExtras.h"
+
+namespace mlir {
+namespace bufferization {
+#define GEN_PASS_DEF_BUFFERMEMORYPLANNING
+#include "mlir/Dialect/Bufferization/Transforms/Passes.h.inc"
+} // namespace bufferization
+} // namespace mlir
+
+using namespace mlir;
+using namespace mlir::bufferization;
+
+namespace {
+
+/// An allocation placed in the arena. The allocation is live from the
+/// operation at position `start` to the operation at position `end` of the
+/// entry block, both included.
+struct ArenaSlot {
+  memref::AllocOp allocOp;
+  int64_t start;
+  int64_t end;
+  int64_t size;
+  int64_t alignment;
+  int64_t offset = 0;
+};
+
+} // namespace
+
+/// Returns true when the allocation `allocOp` can be placed in the arena, i.e.
+/// when it has a static shape, an identity layout and the default memory
+/// space, when none of its aliases is returned, and when it is only freed
+/// directly.
+static bool
+canPlaceInArena(memref::AllocOp allocOp,
+                const BufferViewFlowAnalysis::ValueSetT &aliases) {
+  MemRefType type = allocOp.getType();
+  if (!type.hasStaticShape() || !type.getLayout().isIdentity() ||
+      type.getMemorySpace())
+    return false;
+  for (Value alias : aliases) {
+    for (Operation *user : alias.getUsers()) {
+      if (isa<func::ReturnOp>(user))
+        return false;
+      if (hasEffect<MemoryEffects::Free>(user, alias) &&
+          (!isa<memref::DeallocOp>(user) || alias != allocOp.getResult()))
+        return false;
+    }
+  }
+  return true;
+}
+
+/// Returns the position in `entryBlock` of the last operation that uses one of
+/// the `aliases`, or of the terminator when one of them outlives the block.
+static int64_t
+getLastUsePosition(Block &entryBlock, const LivenessBlockInfo *livenessInfo,
+                   const BufferViewFlowAnalysis::ValueSetT &aliases,
+                   const DenseMap<Operation *, int64_t> &positions,
+                   Operation *allocOp) {
+  Operation *terminator = &entryBlock.back();
+  Operation *last = allocOp;
+  for (Value alias : aliases) {
+    Operation *end;
+    if (alias.getParentBlock() == &entryBlock) {
+      end = livenessInfo->getEndOperation(alias, alias.getDefiningOp());
+    } else {
+      // The aliases defined in nested regions are live within the operation
+      // of the entry block that holds them, and the others are live in the
+      // successors of the entry block.
+      Operation *parentOp = alias.getParentRegion()->getParentOp();
+      if (Operation *defOp = alias.getDefiningOp())
+        parentOp = defOp;
+      end = entryBlock.findAncestorOpInBlock(*parentOp);
+      if (!end)
+        end = terminator;
+    }
+    if (last->isBeforeInBlock(end))
+      last = end;
+  }
+  return positions.lookup(last);
+}
+
+/// Assigns the offsets of the `slots` in the arena, such that the slots whose
+/// lifetimes overlap do not overlap in the arena, and returns the size of the
+/// arena. The largest slots are placed first, each at the lowest offset that
+/// does not overlap with the slots already placed.
+static int64_t assignOffsets(MutableArrayRef<ArenaSlot> slots) {
+  llvm::stable_sort(slots, [](const ArenaSlot &lhs, const ArenaSlot &rhs) {
+    return lhs.size > rhs.size;
+  });
+  int64_t arenaSize = 0;
+  for (auto [index, slot] : llvm::enumerate(slots)) {
+    SmallVector<const ArenaSlot *> live;
+    for (const ArenaSlot &placed : slots.take_front(index))
+      if (placed.start <= slot.end && slot.start <= placed.end)
+        live.push_back(&placed);
+    llvm::sort(live, [](const ArenaSlot *lhs, const ArenaSlot *rhs) {
+      return lhs->offset < rhs->offset;
+    });
+    int64_t offset = 0;
+    for (const ArenaSlot *placed : live) {
+      if (llvm::alignTo(offset, slot.alignment) + slot.size <= placed->offset)
+        break;
+      offset = std::max(offset, placed->offset + placed->size);
+    }
+    slot.offset = llvm::alignTo(offset, slot.alignment);
+    arenaSize = std::max(arenaSize, slot.offset + slot.size);
+  }
+  return arenaSize;
+}
+
+/// Places the static-shape allocations of the entry block of `funcOp` in an
+/// arena, which is passed as a trailing argument when `useWorkspace` is set.
+static void planFunctionMemory(func::FuncOp funcOp, int64_t alignment,
+                               bool useWorkspace) {
+  Block &entryBlock = funcOp.front();
+  BufferViewFlowAnalysis aliasAnalysis(funcOp);
+  Liveness liveness(funcOp);
+  const LivenessBlockInfo *livenessInfo = liveness.getLiveness(&entryBlock);
+  DataLayout layout = DataLayout::closest(funcOp);
+
+  DenseMap<Operation *, int64_t> positions;
+  for (auto [position, op] : llvm::enumerate(entryBlock))
+    positions[&op] = position;
+
+  SmallVector<ArenaSlot> slots;
+  for (auto allocOp : entryBlock.getOps<memref::AllocOp>()) {
+    BufferViewFlowAnalysis::ValueSetT aliases =
+        aliasAnalysis.resolve(allocOp.getResult());
+    if (!canPlaceInArena(allocOp, aliases))
+      continue;
+    MemRefType type = allocOp.getType();
+    ArenaSlot slot;
+    slot.allocOp = allocOp;
+    slot.start = positions.lookup(allocOp);
+    slot.end = getLastUsePosition(entryBlock, livenessInfo, aliases, positions,
+                                  allocOp);
+    slot.size = type.getNumElements() *
+                layout.getTypeSize(type.getElementType());
+    slot.alignment =
+        std::max<int64_t>(alignment, allocOp.getAlignment().value_or(1));
+    slots.push_back(slot);
+  }
+  // A single allocation that stays in the function is not worth an arena.
+  if (slots.empty() || (slots.size() == 1 && !useWorkspace))
+    return;
+
+  int64_t arenaSize = assignOffsets(slots);
+  int64_t arenaAlignment = alignment;
+  for (const ArenaSlot &slot : slots)
+    arenaAlignment = std::max(arenaAlignment, slot.alignment);
+
+  Location loc = funcOp.getLoc();
+  auto arenaType =
+      MemRefType::get({arenaSize}, IntegerType::get(funcOp.getContext(), 8));
+  OpBuilder builder = OpBuilder::atBlockBegin(&entryBlock);
+  Value arena;
+  if (useWorkspace) {
+    funcOp.insertArgument(funcOp.getNumArguments(), arenaType,
+                          /*argAttrs=*/nullptr, loc);
+    arena = entryBlock.getArguments().back();
+  } else {
+    arena = builder.create<memref::AllocOp>(
+        loc, arenaType, builder.getI64IntegerAttr(arenaAlignment));
+    for (Block &block : funcOp.getBody()) {
+      if (auto returnOp = dyn_cast<func::ReturnOp>(block.getTerminator())) {
+        builder.setInsertionPoint(returnOp);
+        builder.create<memref::DeallocOp>(loc, arena);
+      }
+    }
+  }
+
+  for (const ArenaSlot &slot : slots) {
+    memref::AllocOp allocOp = slot.allocOp;
+    for (Operation *user : llvm::make_early_inc_range(allocOp->getUsers()))
+      if (isa<memref::DeallocOp>(user))
+        user->erase();
+    builder.setInsertionPoint(allocOp);
+    Value shift = builder.create<arith::ConstantIndexOp>(allocOp.getLoc(),
+                                                         slot.offset);
+    Value view = builder.create<memref::ViewOp>(
+        allocOp.getLoc(), allocOp.getType(), arena, shift, ValueRange{});
+    allocOp.replaceAllUsesWith(view);
+    allocOp.erase();
+  }
+}
+
+namespace {
+struct BufferMemoryPlanningPass
+    : public bufferization::impl::BufferMemoryPlanningBase<
+          BufferMemoryPlanningPass> {
+  void runOnOperation() override {
+    ModuleOp moduleOp = getOperation();
+    if (alignment == 0 || !llvm::isPowerOf2_64(alignment)) {
+      moduleOp.emitError("expected the alignment to be a power of 2");
+      return signalPassFailure();
+    }
+    SymbolTableCollection symbolTables;
+    SymbolUserMap symbolUsers(symbolTables, moduleOp);
+    for (auto funcOp : moduleOp.getOps<func::FuncOp>()) {
+      if (funcOp.isExternal())
+        continue;
+      // The functions called within the module keep their signature.
+      bool useWorkspace =
+          useWorkspaceArgument && symbolUsers.getUsers(funcOp).empty();
+      planFunctionMemory(funcOp, alignment, useWorkspace);
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<Pass> mlir::bufferization::createBufferMemoryPlanningPass() {
+  return std::make_unique<BufferMemoryPlanningPass>();
+}
@@ -0,0 +1,205 @@
+//===- BufferReuse.cpp - Reuse dead buffers for new allocations -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass that replaces allocations by buffers that were
+// freed before them in the same block. A freed buffer is reused when neither
+// it nor any of its aliases is live after it is freed, and when it has the
+// type of the new allocation. The dynamic sizes are compared at runtime, and
+// the new buffer is only allocated when they differ.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Bufferization/Transforms/Passes.h"
+
+#include "mlir/Analysis/Liveness.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Bufferization/Transforms/BufferViewFlowAnalysis.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+
+namespace mlir {
+namespace bufferization {
+#define GEN_PASS_DEF_BUFFERREUSE
+#include "mlir/Dialect/Bufferization/Transforms/Passes.h.inc"
+} // namespace bufferization
+} // namespace mlir
+
+using namespace mlir;
+using namespace mlir::bufferization;
+
+/// Returns true if the buffer freed by `deallocOp` may be reused after it,
+/// i.e. when it is allocated in the block of `deallocOp`, and when none of its
+/// aliases is live after `deallocOp` or freed by another op.
+static bool isRecyclable(memref::DeallocOp deallocOp,
+                         const BufferViewFlowAnalysis &aliasAnalysis,
+                         const Liveness &liveness) {
+  Value buffer = deallocOp.getMemref();
+  auto allocOp = buffer.getDefiningOp<memref::AllocOp>();
+  if (!allocOp || allocOp->getBlock() != deallocOp->getBlock() ||
+      !allocOp.getType().getLayout().isIdentity())
+    return false;
+  for (Value alias : aliasAnalysis.resolve(buffer)) {
+    if (!liveness.isDeadAfter(alias, deallocOp))
+      return false;
+    for (Operation *user : alias.getUsers())
+      if (user != deallocOp && hasEffect<MemoryEffects::Free>(user, alias))
+        return false;
+  }
+  return true;
+}
+
+/// Returns true if the buffer of type `bufferType` and alignment
+/// `bufferAlignment` may be reused for `allocOp`, provided that their dynamic
+/// sizes are equal.
+static bool isCompatible(MemRefType bufferType, uint64_t bufferAlignment,
+                         memref::AllocOp allocOp) {
+  MemRefType type = allocOp.getType();
+  if (bufferType.getElementType() != type.getElementType() ||
+      bufferType.getRank() != type.getRank() ||
+      bufferType.getMemorySpace() != type.getMemorySpace() ||
+      !type.getLayout().isIdentity())
+    return false;
+  if (allocOp.getAlignment().value_or(0) > bufferAlignment)
+    return false;
+  for (auto [bufferSize, size] :
+       llvm::zip_equal(bufferType.getShape(), type.getShape()))
+    if (!ShapedType::isDynamic(bufferSize) && !ShapedType::isDynamic(size) &&
+        bufferSize != size)
+      return false;
+  return true;
+}
+
+/// Casts `buffer` to `type` if needed.
+static Value castIfNeeded(OpBuilder &builder, Location loc, Value buffer,
+                          MemRefType type) {
+  if (buffer.getType() == type)
+    return buffer;
+  return builder.create<memref::CastOp>(loc, type, buffer);
+}
+
+/// Replaces `allocOp` by the buffer freed by `deallocOp`. When their sizes are
+/// not known to be equal, the buffer is only reused when the sizes are equal
+/// at runtime, and freed otherwise. Returns the buffer that replaces
+/// `allocOp`.
+static Value reuseBuffer(memref::DeallocOp deallocOp, memref::AllocOp allocOp) {
+  Value buffer = deallocOp.getMemref();
+  auto bufferType = cast<MemRefType>(buffer.getType());
+  MemRefType type = allocOp.getType();
+  Location loc = allocOp.getLoc();
+  OpBuilder builder(allocOp);
+
+  // Compare the sizes that are dynamic in either of the types.
+  Value sameSizes;
+  unsigned dynamicSizeIndex = 0;
+  for (int64_t dim = 0, rank = type.getRank(); dim < rank; ++dim) {
+    if (!bufferType.isDynamicDim(dim) && !type.isDynamicDim(dim))
+      continue;
+    Value size =
+        type.isDynamicDim(dim)
+            ? allocOp.getDynamicSizes()[dynamicSizeIndex++]
+            : builder.create<arith::ConstantIndexOp>(loc, type.getDimSize(dim))
+                  .getResult();
+    Value bufferSize =
+        bufferType.isDynamicDim(dim)
+            ? builder.create<memref::DimOp>(loc, buffer, dim).getResult()
+            : builder
+                  .create<arith::ConstantIndexOp>(loc,
+                                                  bufferType.getDimSize(dim))
+                  .getResult();
+    Value sameSize = builder.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::eq, bufferSize, size);
+    sameSizes = sameSizes
+                    ? builder.create<arith::AndIOp>(loc, sameSizes, sameSize)
+                    : sameSize;
+  }
+
+  Value reused;
+  if (!sameSizes) {
+    reused = castIfNeeded(builder, loc, buffer, type);
+  } else {
+    auto ifOp = builder.create<scf::IfOp>(loc, TypeRange{type}, sameSizes,
+                                          /*withElseRegion=*/true);
+    OpBuilder thenBuilder = ifOp.getThenBodyBuilder();
+    thenBuilder.create<scf::YieldOp>(
+        loc, castIfNeeded(thenBuilder, loc, buffer, type));
+    OpBuilder elseBuilder = ifOp.getElseBodyBuilder();
+    elseBuilder.create<memref::DeallocOp>(loc, buffer);
+    Operation *newAllocOp = elseBuilder.clone(*allocOp);
+    elseBuilder.create<scf::YieldOp>(loc, newAllocOp->getResults());
+    reused = ifOp.getResult(0);
+  }
+  allocOp.replaceAllUsesWith(reused);
+  allocOp.erase();
+  deallocOp.erase();
+  return reused;
+}
+
+/// Reuses the buffers freed in `block` for the subsequent allocations of
+/// `block`, starting with the most recently freed ones.
+static void reuseBuffersInBlock(Block &block,
+                                DenseSet<Operation *> &recyclable) {
+  SmallVector<memref::DeallocOp> freed;
+  DenseMap<Value, uint64_t> alignments;
+  auto getAlignment = [&](Value buffer) -> uint64_t {
+    if (auto allocOp = buffer.getDefiningOp<memref::AllocOp>())
+      return allocOp.getAlignment().value_or(0);
+    return alignments.lookup(buffer);
+  };
+
+  for (Operation &op : llvm::make_early_inc_range(block)) {
+    if (auto deallocOp = dyn_cast<memref::DeallocOp>(op)) {
+      if (recyclable.contains(deallocOp))
+        freed.push_back(deallocOp);
+      continue;
+    }
+    auto allocOp = dyn_cast<memref::AllocOp>(op);
+    if (!allocOp)
+      continue;
+    auto it = llvm::find_if(llvm::reverse(freed), [&](memref::DeallocOp d) {
+      Value buffer = d.getMemref();
+      return isCompatible(cast<MemRefType>(buffer.getType()),
+                          getAlignment(buffer), allocOp);
+    });
+    if (it == freed.rend())
+      continue;
+    uint64_t alignment = allocOp.getAlignment().value_or(0);
+    memref::DeallocOp deallocOp = *it;
+    freed.erase(std::next(it).base());
+    recyclable.erase(deallocOp);
+    alignments[reuseBuffer(deallocOp, allocOp)] = alignment;
+  }
+}
+
+namespace {
+struct BufferReusePass
+    : public bufferization::impl::BufferReuseBase<BufferReusePass> {
+  void runOnOperation() override {
+    func::FuncOp funcOp = getOperation();
+    DenseSet<Operation *> recyclable;
+    {
+      BufferViewFlowAnalysis aliasAnalysis(funcOp);
+      Liveness liveness(funcOp);
+      funcOp.walk([&](memref::DeallocOp deallocOp) {
+        if (isRecyclable(deallocOp, aliasAnalysis, liveness))
+          recyclable.insert(deallocOp);
+      });
+    }
+
+    SmallVector<Block *> blocks;
+    funcOp.walk([&](Block *block) { blocks.push_back(block); });
+    for (Block *block : blocks)
+      reuseBuffersInBlock(*block, recyclable);
+  }
+};
+} // namespace
+
+std::unique_ptr<Pass> mlir::bufferization::createBufferReusePass() {
+  return std::make_unique<BufferReusePass>();
+}
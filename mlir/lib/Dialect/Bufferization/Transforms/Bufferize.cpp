@@ -209,6 +209,7 @@ struct OneShotBufferizePass
       opt.copyBeforeWrite = copyBeforeWrite;
       opt.createDeallocs = createDeallocs;
       opt.dumpAliasSets = dumpAliasSets;
+      opt.incrementalConflictAnalysis = incrementalConflictAnalysis;
       opt.setFunctionBoundaryTypeConversion(
           parseLayoutMapOption(functionBoundaryTypeConversion));
       if (mustInferMemorySpace)
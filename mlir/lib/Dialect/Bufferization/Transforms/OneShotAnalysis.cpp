@@ -162,7 +162,10 @@ void OneShotAnalysisState::bufferizeInPlace(OpOperand &operand) {
     return;
   inplaceBufferized.insert(&operand);
   for (AliasingOpResult alias : getAliasingOpResults(operand))
-    aliasInfo.unionSets(alias.opResult, operand.get());
+    unionAliasSets(alias.opResult, operand.get());
+  if (aliasSetUses && bufferizesToMemoryWrite(operand))
+    (*aliasSetUses)[aliasInfo.getLeaderValue(operand.get())]
+        .inPlaceWrites.insert(&operand);
   ++statNumTensorInPlace;
 }
 
@@ -175,6 +178,8 @@ void OneShotAnalysisState::bufferizeOutOfPlace(OpOperand &operand) {
 void OneShotAnalysisState::createAliasInfoEntry(Value v) {
   aliasInfo.insert(v);
   equivalentInfo.insert(v);
+  // The new value may add uses to existing alias sets.
+  aliasSetUses.reset();
 }
 
 // Gather yielded tensors in `yieldedTensors` by querying all aliases. This is
@@ -246,6 +251,10 @@ bool OneShotAnalysisState::isTensorYielded(Value tensor) const {
 }
 
 bool OneShotAnalysisState::isValueWritten(Value value) const {
+  if (aliasSetUses) {
+    auto it = aliasSetUses->find(aliasInfo.getLeaderValue(value));
+    return it != aliasSetUses->end() && !it->second.inPlaceWrites.empty();
+  }
   bool isWritten = false;
   applyOnAliases(value, [&](Value val) {
     for (OpOperand &use : val.getUses())
@@ -271,7 +280,28 @@ bool OneShotAnalysisState::isWritable(Value value) const {
 }
 
 void OneShotAnalysisState::unionAliasSets(Value v1, Value v2) {
+  Value leader1 = aliasInfo.getLeaderValue(v1);
+  Value leader2 = aliasInfo.getLeaderValue(v2);
   aliasInfo.unionSets(v1, v2);
+  if (!aliasSetUses || leader1 == leader2)
+    return;
+
+  // Move the uses of the merged set into the set of the new leader, inserting
+  // the uses of the smallest set into the largest one.
+  Value leader = aliasInfo.getLeaderValue(v1);
+  Value merged = leader == leader1 ? leader2 : leader1;
+  auto it = aliasSetUses->find(merged);
+  assert(it != aliasSetUses->end() && "expected an indexed alias set");
+  AliasSetUses mergedUses = std::move(it->second);
+  aliasSetUses->erase(it);
+  AliasSetUses &uses = (*aliasSetUses)[leader];
+  if (mergedUses.reads.size() + mergedUses.inPlaceWrites.size() >
+      uses.reads.size() + uses.inPlaceWrites.size())
+    std::swap(uses, mergedUses);
+  uses.reads.insert(mergedUses.reads.begin(), mergedUses.reads.end());
+  uses.inPlaceWrites.insert(mergedUses.inPlaceWrites.begin(),
+                            mergedUses.inPlaceWrites.end());
+  llvm::append_range(uses.nonWritableValues, mergedUses.nonWritableValues);
 }
 
 void OneShotAnalysisState::unionEquivalenceClasses(Value v1, Value v2) {
@@ -629,41 +659,91 @@ static void getAliasingInplaceWrites(DenseSet<OpOperand *> &res, Value root,
   });
 }
 
+/// Return true if `use` reads the buffer of the value it uses.
+static bool isAliasingRead(OpOperand &use, const OneShotAnalysisState &state) {
+  // Read of the used value.
+  if (state.bufferizesToMemoryRead(use))
+    return true;
+
+  // Read of a dependent value in the SSA use-def chain. E.g.:
+  //
+  // %0 = ...
+  // %1 = tensor.extract_slice %0 {not_analyzed_yet}
+  // "read"(%1)
+  //
+  // In the above example, getAliasingReads(%0) includes the first OpOperand
+  // of the tensor.extract_slice op. The extract_slice itself does not read
+  // but its aliasing result is eventually fed into an op that does.
+  //
+  // Note: This is considered a "read" only if the use does not bufferize to
+  // a memory write. (We already ruled out memory reads. In case of a memory
+  // write, the buffer would be entirely overwritten; in the above example
+  // there would then be no flow of data from the extract_slice operand to
+  // its result's uses.)
+  if (state.bufferizesToMemoryWrite(use))
+    return false;
+  AliasingOpResultList aliases = state.getAliasingOpResults(use);
+  return llvm::any_of(aliases, [&](AliasingOpResult a) {
+    return state.isValueRead(a.opResult);
+  });
+}
+
 // Helper function to iterate on aliases of `root` and capture the reads.
 static void getAliasingReads(DenseSet<OpOperand *> &res, Value root,
                              const OneShotAnalysisState &state) {
   state.applyOnAliases(root, [&](Value alias) {
-    for (auto &use : alias.getUses()) {
-      // Read of a value that aliases root.
-      if (state.bufferizesToMemoryRead(use)) {
+    for (auto &use : alias.getUses())
+      if (isAliasingRead(use, state))
         res.insert(&use);
-        continue;
-      }
+  });
+}
 
-      // Read of a dependent value in the SSA use-def chain. E.g.:
-      //
-      // %0 = ...
-      // %1 = tensor.extract_slice %0 {not_analyzed_yet}
-      // "read"(%1)
-      //
-      // In the above example, getAliasingReads(%0) includes the first OpOperand
-      // of the tensor.extract_slice op. The extract_slice itself does not read
-      // but its aliasing result is eventually fed into an op that does.
-      //
-      // Note: This is considered a "read" only if the use does not bufferize to
-      // a memory write. (We already ruled out memory reads. In case of a memory
-      // write, the buffer would be entirely overwritten; in the above example
-      // there would then be no flow of data from the extract_slice operand to
-      // its result's uses.)
-      if (!state.bufferizesToMemoryWrite(use)) {
-        AliasingOpResultList aliases = state.getAliasingOpResults(use);
-        if (llvm::any_of(aliases, [&](AliasingOpResult a) {
-              return state.isValueRead(a.opResult);
-            }))
-          res.insert(&use);
-      }
+/// Return the distinct alias sets that bufferizing `operand` inplace merges.
+static SmallVector<const OneShotAnalysisState::AliasSetUses *>
+getMergedAliasSetUses(OpOperand &operand, OneShotAnalysisState &state) {
+  SmallVector<const OneShotAnalysisState::AliasSetUses *> aliasSets;
+  auto addAliasSet = [&](Value value) {
+    const OneShotAnalysisState::AliasSetUses *uses =
+        &state.getAliasSetUses(value);
+    if (!llvm::is_contained(aliasSets, uses))
+      aliasSets.push_back(uses);
+  };
+  addAliasSet(operand.get());
+  for (AliasingOpResult alias : state.getAliasingOpResults(operand))
+    addAliasSet(alias.opResult);
+  return aliasSets;
+}
+
+/// Incremental version of `wouldCreateReadAfterWriteInterference`. The reads
+/// and writes of the same alias set were checked when they were brought into
+/// the set, so only the pairs across the alias sets that bufferizing `operand`
+/// inplace merges and the pairs with the write of `operand` are checked.
+static bool wouldCreateReadAfterWriteInterferenceIncremental(
+    OpOperand &operand, const DominanceInfo &domInfo,
+    OneShotAnalysisState &state) {
+  // Note: The alias set uses are not invalidated by the checks below, which do
+  // not make bufferization decisions.
+  SmallVector<const OneShotAnalysisState::AliasSetUses *> aliasSets =
+      getMergedAliasSetUses(operand, state);
+  for (const OneShotAnalysisState::AliasSetUses *readSet : aliasSets) {
+    for (const OneShotAnalysisState::AliasSetUses *writeSet : aliasSets) {
+      if (readSet == writeSet || writeSet->inPlaceWrites.empty())
+        continue;
+      if (hasReadAfterWriteInterference(readSet->reads,
+                                        writeSet->inPlaceWrites, domInfo,
+                                        state))
+        return true;
     }
-  });
+  }
+  if (!state.bufferizesToMemoryWrite(operand) || state.isInPlace(operand))
+    return false;
+  DenseSet<OpOperand *> operandWrite;
+  operandWrite.insert(&operand);
+  for (const OneShotAnalysisState::AliasSetUses *readSet : aliasSets)
+    if (hasReadAfterWriteInterference(readSet->reads, operandWrite, domInfo,
+                                      state))
+      return true;
+  return false;
 }
 
 /// Return true if bufferizing `operand` inplace would create a conflict. A read
@@ -698,6 +778,10 @@ static void getAliasingReads(DenseSet<OpOperand *> &res, Value root,
 static bool wouldCreateReadAfterWriteInterference(
     OpOperand &operand, const DominanceInfo &domInfo,
     OneShotAnalysisState &state, bool checkConsistencyOnly = false) {
+  if (state.getOptions().incrementalConflictAnalysis && !checkConsistencyOnly)
+    return wouldCreateReadAfterWriteInterferenceIncremental(operand, domInfo,
+                                                            state);
+
   // Collect reads and writes of all aliases of OpOperand and OpResult.
   DenseSet<OpOperand *> usesRead, usesWrite;
   getAliasingReads(usesRead, operand.get(), state);
@@ -738,6 +822,28 @@ wouldCreateWriteToNonWritableBuffer(OpOperand &operand,
   bool foundWrite =
       !checkConsistencyOnly && state.bufferizesToMemoryWrite(operand);
 
+  if (state.getOptions().incrementalConflictAnalysis && !checkConsistencyOnly) {
+    SmallVector<const OneShotAnalysisState::AliasSetUses *> aliasSets =
+        getMergedAliasSetUses(operand, state);
+    foundWrite |= llvm::any_of(
+        aliasSets, [](const OneShotAnalysisState::AliasSetUses *uses) {
+          return !uses->inPlaceWrites.empty();
+        });
+    if (!foundWrite)
+      return false;
+    bool foundReadOnly = false;
+    for (const OneShotAnalysisState::AliasSetUses *uses : aliasSets) {
+      for (Value value : uses->nonWritableValues) {
+        foundReadOnly = true;
+        if (state.getOptions().printConflicts)
+          annotateNonWritableTensor(value);
+      }
+    }
+    if (foundReadOnly)
+      LLVM_DEBUG(llvm::dbgs() << "=> NOT WRITABLE\n");
+    return foundReadOnly;
+  }
+
   if (!foundWrite) {
     // Collect writes of all aliases of OpOperand and OpResult.
     DenseSet<OpOperand *> usesWrite;
@@ -782,7 +888,36 @@ OneShotAnalysisState::findDefinitionsCached(Value value) {
   return cachedDefinitions[value];
 }
 
-void OneShotAnalysisState::resetCache() { cachedDefinitions.clear(); }
+void OneShotAnalysisState::resetCache() {
+  cachedDefinitions.clear();
+  aliasSetUses.reset();
+}
+
+const OneShotAnalysisState::AliasSetUses &
+OneShotAnalysisState::getAliasSetUses(Value v) {
+  if (!aliasSetUses) {
+    aliasSetUses.emplace();
+    for (auto it = aliasInfo.begin(), e = aliasInfo.end(); it != e; ++it) {
+      if (!it->isLeader())
+        continue;
+      AliasSetUses &uses = (*aliasSetUses)[it->getData()];
+      for (Value alias : llvm::make_range(aliasInfo.member_begin(it),
+                                          aliasInfo.member_end())) {
+        for (OpOperand &use : alias.getUses()) {
+          if (isAliasingRead(use, *this))
+            uses.reads.insert(&use);
+          if (isInplaceMemoryWrite(use, *this))
+            uses.inPlaceWrites.insert(&use);
+        }
+        if (!isWritable(alias))
+          uses.nonWritableValues.push_back(alias);
+      }
+    }
+  }
+  auto it = aliasSetUses->find(aliasInfo.getLeaderValue(v));
+  assert(it != aliasSetUses->end() && "expected an indexed alias set");
+  return it->second;
+}
 
 /// Determine if `operand` can be bufferized in-place.
 static LogicalResult
@@ -890,6 +1025,10 @@ static void equivalenceAnalysis(Operation *op, OneShotAnalysisState &state) {
 
 LogicalResult OneShotAnalysisState::analyzeOp(Operation *op,
                                               const DominanceInfo &domInfo) {
+  // The analysis of the previously analyzed ops, e.g. of called functions,
+  // may have refined the reads and writes of the uses since they were indexed.
+  aliasSetUses.reset();
+
   // Collect ops so we can build our own reverse traversal.
   SmallVector<Operation *> ops;
   op->walk([&](Operation *op) {
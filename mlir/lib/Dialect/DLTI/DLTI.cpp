@@ -347,6 +347,19 @@ public:
     if (entryName == DLTIDialect::kDataLayoutAllocaMemorySpaceKey ||
         entryName == DLTIDialect::kDataLayoutStackAlignmentKey)
       return success();
+    if (entryName == DLTIDialect::kDataLayoutL1CacheSizeKey ||
+        entryName == DLTIDialect::kDataLayoutL2CacheSizeKey ||
+        entryName == DLTIDialect::kDataLayoutL3CacheSizeKey ||
+        entryName == DLTIDialect::kDataLayoutScratchpadSizeKey ||
+        entryName == DLTIDialect::kDataLayoutVectorWidthKey ||
+        entryName == DLTIDialect::kDataLayoutNumVectorRegistersKey) {
+      auto value = llvm::dyn_cast<IntegerAttr>(entry.getValue());
+      if (value && value.getValue().isStrictlyPositive())
+        return success();
+      return emitError(loc) << "'" << entryName
+                            << "' data layout entry is expected to be a "
+                               "positive integer";
+    }
     return emitError(loc) << "unknown data layout entry name: " << entryName;
   }
 };
@@ -0,0 +1,180 @@
+//===- RefineMemRefArguments.cpp - Refine the memref arguments of calls ---===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements an interprocedural pass that reduces the cost of
+// passing memrefs to the private functions: the unused memref arguments are
+// dropped, the static shapes and layouts known at all the call sites are
+// propagated into the callees, and the callees whose memrefs are all of a
+// static shape and layout are marked to use the bare pointer calling
+// convention when lowered to the LLVM dialect.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Func/Transforms/Passes.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/IR/SymbolTable.h"
+
+namespace mlir {
+namespace func {
+#define GEN_PASS_DEF_REFINEMEMREFARGUMENTSPASS
+#include "mlir/Dialect/Func/Transforms/Passes.h.inc"
+} // namespace func
+} // namespace mlir
+
+using namespace mlir;
+
+/// The attribute of the functions that the LLVM lowering converts with the
+/// bare pointer calling convention.
+static constexpr StringLiteral kBarePtrAttrName = "llvm.bareptr";
+
+/// Returns true if `type` is a memref of a static shape, strides and offset,
+/// which can be passed as a bare pointer.
+static bool hasStaticLayout(Type type) {
+  auto memrefType = dyn_cast<MemRefType>(type);
+  if (!memrefType || !memrefType.hasStaticShape())
+    return false;
+  int64_t offset;
+  SmallVector<int64_t> strides;
+  if (failed(getStridesAndOffset(memrefType, strides, offset)))
+    return false;
+  return !ShapedType::isDynamic(offset) &&
+         llvm::none_of(strides, ShapedType::isDynamic);
+}
+
+/// Returns the value passed as `operand`, looking through the casts that
+/// erase static information.
+static Value getCastSource(Value operand) {
+  if (auto castOp = operand.getDefiningOp<memref::CastOp>())
+    return castOp.getSource();
+  return operand;
+}
+
+/// Drops the unused memref arguments of `funcOp` and refines the types of the
+/// others to the type passed by all the `calls`. Returns true if the function
+/// changed.
+static bool refineArguments(func::FuncOp funcOp,
+                            ArrayRef<func::CallOp> calls) {
+  bool changed = false;
+  Block &entryBlock = funcOp.front();
+  for (unsigned i = funcOp.getNumArguments(); i-- > 0;) {
+    BlockArgument arg = funcOp.getArgument(i);
+    auto type = dyn_cast<MemRefType>(arg.getType());
+    if (!type)
+      continue;
+    if (arg.use_empty()) {
+      funcOp.eraseArgument(i);
+      for (func::CallOp callOp : calls)
+        callOp->eraseOperand(i);
+      changed = true;
+      continue;
+    }
+
+    // The callers must all pass the same type, compatible with the one of
+    // the argument.
+    if (calls.empty())
+      continue;
+    Type refinedType = getCastSource(calls.front().getOperand(i)).getType();
+    if (refinedType == type || !isa<MemRefType>(refinedType) ||
+        !memref::CastOp::areCastCompatible(refinedType, type) ||
+        llvm::any_of(calls, [&](func::CallOp callOp) {
+          return getCastSource(callOp.getOperand(i)).getType() != refinedType;
+        }))
+      continue;
+
+    // Cast the refined argument back for the existing uses, which folds the
+    // static information into them.
+    arg.setType(refinedType);
+    auto builder = OpBuilder::atBlockBegin(&entryBlock);
+    auto castOp = builder.create<memref::CastOp>(arg.getLoc(), type, arg);
+    arg.replaceAllUsesExcept(castOp.getResult(), castOp);
+    for (func::CallOp callOp : calls)
+      callOp->setOperand(i, getCastSource(callOp.getOperand(i)));
+    changed = true;
+  }
+  if (changed)
+    funcOp.setType(FunctionType::get(funcOp.getContext(),
+                                     entryBlock.getArgumentTypes(),
+                                     funcOp.getResultTypes()));
+  return changed;
+}
+
+namespace {
+struct RefineMemRefArgumentsPass
+    : public func::impl::RefineMemRefArgumentsPassBase<
+          RefineMemRefArgumentsPass> {
+  using Base::Base;
+
+  /// Collects the calls of the functions of the module, and the names of the
+  /// functions that are referenced by other ops than calls. Returns failure
+  /// if the uses of the symbols are unknown.
+  LogicalResult
+  collectCalls(ModuleOp module,
+               DenseMap<StringAttr, SmallVector<func::CallOp>> &calls,
+               DenseSet<StringAttr> &escapingFuncs) {
+    std::optional<SymbolTable::UseRange> uses =
+        SymbolTable::getSymbolUses(&module.getBodyRegion());
+    if (!uses)
+      return failure();
+    for (const SymbolTable::SymbolUse &use : *uses) {
+      StringAttr name = use.getSymbolRef().getRootReference();
+      auto callOp = dyn_cast<func::CallOp>(use.getUser());
+      if (callOp && callOp.getCalleeAttr() == use.getSymbolRef())
+        calls[name].push_back(callOp);
+      else
+        escapingFuncs.insert(name);
+    }
+    return success();
+  }
+
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+    auto isRefinable = [](func::FuncOp funcOp,
+                          const DenseSet<StringAttr> &escapingFuncs) {
+      return funcOp.isPrivate() && !funcOp.isExternal() &&
+             !escapingFuncs.contains(funcOp.getSymNameAttr());
+    };
+
+    // Refining the arguments of a function exposes static types to the
+    // functions it calls, so iterate until no function changes.
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      DenseMap<StringAttr, SmallVector<func::CallOp>> calls;
+      DenseSet<StringAttr> escapingFuncs;
+      if (failed(collectCalls(module, calls, escapingFuncs)))
+        return;
+      for (func::FuncOp funcOp : module.getOps<func::FuncOp>())
+        if (isRefinable(funcOp, escapingFuncs))
+          changed |= refineArguments(funcOp, calls[funcOp.getSymNameAttr()]);
+    }
+
+    if (!useBarePtrCallConv)
+      return;
+    DenseMap<StringAttr, SmallVector<func::CallOp>> calls;
+    DenseSet<StringAttr> escapingFuncs;
+    if (failed(collectCalls(module, calls, escapingFuncs)))
+      return;
+    for (func::FuncOp funcOp : module.getOps<func::FuncOp>()) {
+      if (!isRefinable(funcOp, escapingFuncs))
+        continue;
+      auto isBarePtrCompatible = [](Type type) {
+        return !isa<BaseMemRefType>(type) || hasStaticLayout(type);
+      };
+      FunctionType funcType = funcOp.getFunctionType();
+      if (llvm::all_of(funcType.getInputs(), isBarePtrCompatible) &&
+          llvm::all_of(funcType.getResults(), isBarePtrCompatible))
+        funcOp->setAttr(kBarePtrAttrName, UnitAttr::get(&getContext()));
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<Pass> mlir::func::createRefineMemRefArgumentsPass() {
+  return std::make_unique<RefineMemRefArgumentsPass>();
+}
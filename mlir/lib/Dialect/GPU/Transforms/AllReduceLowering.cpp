@@ -16,9 +16,11 @@
 #include "mlir/Dialect/GPU/IR/GPUDialect.h"
 #include "mlir/Dialect/GPU/Transforms/Passes.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/PatternMatch.h"
+#include "mlir/IR/TypeUtilities.h"
 #include "mlir/Pass/Pass.h"
 
 using namespace mlir;
@@ -29,9 +31,10 @@ struct GpuAllReduceRewriter {
   using AccumulatorFactory = std::function<Value(Value, Value)>;
 
   GpuAllReduceRewriter(gpu::GPUFuncOp funcOp, gpu::AllReduceOp reduceOp,
-                       PatternRewriter &rewriter)
+                       PatternRewriter &rewriter, bool shuffleCombine)
       : funcOp(funcOp), reduceOp(reduceOp), rewriter(rewriter),
-        loc(reduceOp.getLoc()), valueType(reduceOp.getValue().getType()),
+        shuffleCombine(shuffleCombine), loc(reduceOp.getLoc()),
+        valueType(reduceOp.getValue().getType()),
         indexType(IndexType::get(reduceOp.getContext())),
         int32Type(IntegerType::get(reduceOp.getContext(), /*width=*/32)) {}
 
@@ -62,6 +65,25 @@ struct GpuAllReduceRewriter {
   ///     %result = load %workgroup_buffer[%zero]
   ///     return %result
   ///
+  /// With `shuffleCombine`, every subgroup reduces the values from workgroup
+  /// memory instead, and the result of its first lane is broadcasted to the
+  /// other lanes with a shuffle. This saves the second barrier and the second
+  /// round trip through workgroup memory.
+  ///
+  ///     ...
+  ///     gpu.barrier
+  ///     %is_valid_lane = arith.cmpi "slt" %lane_id, %num_subgroups
+  ///     cf.cond_br %is_valid_lane, ^then2, ^else2
+  ///   ^then2:
+  ///     %partial_reduce = load %workgroup_buffer[%lane_id]
+  ///     %all_reduce = `createSubgroupReduce(%partial_reduce)`
+  ///     cf.br ^continue2(%all_reduce)
+  ///   ^else2:
+  ///     cf.br ^continue2(%subgroup_reduce)
+  ///   ^continue2(%lane_result):
+  ///     %result = gpu.shuffle idx %lane_result, %zero, %active_lanes
+  ///     return %result
+  ///
   void rewrite() {
     rewriter.setInsertionPoint(reduceOp);
 
@@ -119,6 +141,36 @@ struct GpuAllReduceRewriter {
     Value biasedBlockSize =
         create<arith::AddIOp>(int32Type, workgroupSize, subgroupMask);
     Value numSubgroups = getDivideBySubgroupSize(biasedBlockSize);
+
+    if (shuffleCombine) {
+      // Use the first numSubgroups lanes of each subgroup to reduce the
+      // intermediate results, and broadcast the result from the first lane.
+      Value isValidLane = create<arith::CmpIOp>(arith::CmpIPredicate::slt,
+                                                laneId, numSubgroups);
+      createIf(
+          isValidLane,
+          [&] {
+            Value index = create<arith::IndexCastOp>(indexType, laneId);
+            Value value = create<memref::LoadOp>(valueType, buffer, index);
+            return SmallVector<Value, 1>{createSubgroupReduce(
+                numSubgroups, laneId, value, accumFactory)};
+          },
+          [&] { return SmallVector<Value, 1>{subgroupReduce}; });
+      Value laneResult = rewriter.getInsertionBlock()->getArgument(0);
+      Value subgroupSize =
+          create<arith::ConstantIntOp>(kSubgroupSize, int32Type);
+      Value isPartialSubgroup = create<arith::CmpIOp>(
+          arith::CmpIPredicate::slt, activeWidth, subgroupSize);
+      Value activeLanes =
+          create<arith::SelectOp>(isPartialSubgroup, activeWidth, subgroupSize);
+      Value zero = create<arith::ConstantIntOp>(0, int32Type);
+      Value result = createShuffle(laneResult, zero, activeLanes,
+                                   gpu::ShuffleMode::IDX)
+                         .first;
+      rewriter.replaceOp(reduceOp, result);
+      return;
+    }
+
     Value isValidSubgroup = create<arith::CmpIOp>(arith::CmpIPredicate::slt,
                                                   invocationIdx, numSubgroups);
 
@@ -214,7 +266,7 @@ private:
 
   /// Returns an accumulator factory that creates an op specified by opName.
   AccumulatorFactory getFactory(gpu::AllReduceOperation opName) {
-    bool isFloatingPoint = isa<FloatType>(valueType);
+    bool isFloatingPoint = isa<FloatType>(getElementTypeOrSelf(valueType));
     switch (opName) {
     case gpu::AllReduceOperation::ADD:
       return isFloatingPoint ? getFactory<arith::AddFOp>()
@@ -325,7 +377,6 @@ private:
     Value subgroupSize = create<arith::ConstantIntOp>(kSubgroupSize, int32Type);
     Value isPartialSubgroup = create<arith::CmpIOp>(arith::CmpIPredicate::slt,
                                                     activeWidth, subgroupSize);
-    std::array<Type, 2> shuffleType = {valueType, rewriter.getI1Type()};
 
     createIf(
         isPartialSubgroup,
@@ -337,15 +388,15 @@ private:
           // in the first lane.
           for (int i = 1; i < kSubgroupSize; i <<= 1) {
             Value offset = create<arith::ConstantIntOp>(i, int32Type);
-            auto shuffleOp = create<gpu::ShuffleOp>(
-                shuffleType, value, offset, activeWidth, gpu::ShuffleMode::XOR);
+            Value shuffled, isValid;
+            std::tie(shuffled, isValid) = createShuffle(
+                value, offset, activeWidth, gpu::ShuffleMode::XOR);
             // Skip the accumulation if the shuffle op read from a lane outside
             // of the active range.
             createIf(
-                shuffleOp.getResult(1),
+                isValid,
                 [&] {
-                  return SmallVector<Value, 1>{
-                      accumFactory(value, shuffleOp.getResult(0))};
+                  return SmallVector<Value, 1>{accumFactory(value, shuffled)};
                 },
                 [&] { return llvm::ArrayRef(value); });
             value = rewriter.getInsertionBlock()->getArgument(0);
@@ -359,16 +410,70 @@ private:
           Value value = operand;
           for (int i = 1; i < kSubgroupSize; i <<= 1) {
             Value offset = create<arith::ConstantIntOp>(i, int32Type);
-            auto shuffleOp =
-                create<gpu::ShuffleOp>(shuffleType, value, offset, subgroupSize,
-                                       gpu::ShuffleMode::XOR);
-            value = accumFactory(value, shuffleOp.getResult(0));
+            Value shuffled = createShuffle(value, offset, subgroupSize,
+                                           gpu::ShuffleMode::XOR)
+                                 .first;
+            value = accumFactory(value, shuffled);
           }
           return SmallVector<Value, 1>{value};
         });
     return rewriter.getInsertionBlock()->getArgument(0);
   }
 
+  /// Creates a shuffle of `value` and returns the shuffled value and its
+  /// validity. The shuffle only supports 32 and 64-bit types, so the 16-bit
+  /// values and the vectors of up to 32 bits, such as f16 and vector<2xf16>,
+  /// are packed into an i32 around it. A vector<2xf16> is thus reduced with
+  /// a single shuffle and packed arithmetic per step.
+  std::pair<Value, Value> createShuffle(Value value, Value offset, Value width,
+                                        gpu::ShuffleMode mode) {
+    Type type = value.getType();
+    Type elementType = getElementTypeOrSelf(type);
+    auto vectorType = dyn_cast<VectorType>(type);
+    unsigned bitwidth = 0;
+    bool isScalarOrVector = !vectorType || vectorType.getRank() == 1;
+    if (elementType.isIntOrFloat() && isScalarOrVector)
+      bitwidth = elementType.getIntOrFloatBitWidth() *
+                 (vectorType ? vectorType.getNumElements() : 1);
+    bool isPacked = vectorType ? bitwidth != 0 && bitwidth <= 32
+                               : bitwidth != 0 && bitwidth < 32;
+    if (!isPacked) {
+      std::array<Type, 2> shuffleType = {type, rewriter.getI1Type()};
+      auto shuffleOp =
+          create<gpu::ShuffleOp>(shuffleType, value, offset, width, mode);
+      return {shuffleOp.getShuffleResult(), shuffleOp.getValid()};
+    }
+
+    // Pack the value into an i32.
+    Type intType = rewriter.getIntegerType(bitwidth);
+    Value packed = value;
+    if (vectorType) {
+      packed = create<vector::BitCastOp>(VectorType::get({1}, intType), packed);
+      packed = create<vector::ExtractOp>(packed, ArrayRef<int64_t>{0});
+    } else if (isa<FloatType>(type)) {
+      packed = create<arith::BitcastOp>(intType, packed);
+    }
+    if (bitwidth < 32)
+      packed = create<arith::ExtUIOp>(int32Type, packed);
+
+    std::array<Type, 2> shuffleType = {int32Type, rewriter.getI1Type()};
+    auto shuffleOp =
+        create<gpu::ShuffleOp>(shuffleType, packed, offset, width, mode);
+
+    // Unpack the shuffled value.
+    Value shuffled = shuffleOp.getShuffleResult();
+    if (bitwidth < 32)
+      shuffled = create<arith::TruncIOp>(intType, shuffled);
+    if (vectorType) {
+      shuffled =
+          create<vector::BroadcastOp>(VectorType::get({1}, intType), shuffled);
+      shuffled = create<vector::BitCastOp>(vectorType, shuffled);
+    } else if (isa<FloatType>(type)) {
+      shuffled = create<arith::BitcastOp>(type, shuffled);
+    }
+    return {shuffled, shuffleOp.getValid()};
+  }
+
   /// Returns value divided by the subgroup size (i.e. 32).
   Value getDivideBySubgroupSize(Value value) {
     Value subgroupSize = create<arith::ConstantIntOp>(kSubgroupSize, int32Type);
@@ -378,6 +483,7 @@ private:
   gpu::GPUFuncOp funcOp;
   gpu::AllReduceOp reduceOp;
   PatternRewriter &rewriter;
+  bool shuffleCombine;
 
   Location loc;
   Type valueType;
@@ -388,8 +494,9 @@ private:
 };
 
 struct GpuAllReduceConversion : public RewritePattern {
-  explicit GpuAllReduceConversion(MLIRContext *context)
-      : RewritePattern(gpu::GPUFuncOp::getOperationName(), 1, context) {}
+  GpuAllReduceConversion(MLIRContext *context, bool shuffleCombine)
+      : RewritePattern(gpu::GPUFuncOp::getOperationName(), 1, context),
+        shuffleCombine(shuffleCombine) {}
 
   LogicalResult matchAndRewrite(Operation *op,
                                 PatternRewriter &rewriter) const override {
@@ -409,13 +516,18 @@ struct GpuAllReduceConversion : public RewritePattern {
           op, "Non uniform reductions are not supported yet.");
 
     for (gpu::AllReduceOp reduceOp : reduceOps)
-      GpuAllReduceRewriter(funcOp, reduceOp, rewriter).rewrite();
+      GpuAllReduceRewriter(funcOp, reduceOp, rewriter, shuffleCombine)
+          .rewrite();
 
     return success();
   }
+
+private:
+  bool shuffleCombine;
 };
 } // namespace
 
-void mlir::populateGpuAllReducePatterns(RewritePatternSet &patterns) {
-  patterns.add<GpuAllReduceConversion>(patterns.getContext());
+void mlir::populateGpuAllReducePatterns(RewritePatternSet &patterns,
+                                        bool shuffleCombine) {
+  patterns.add<GpuAllReduceConversion>(patterns.getContext(), shuffleCombine);
 }
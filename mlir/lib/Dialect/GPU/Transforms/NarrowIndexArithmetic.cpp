@@ -0,0 +1,116 @@
+//===- NarrowIndexArithmetic.cpp - Narrow the index math of kernels -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass that rewrites the index arithmetic of the GPU
+// kernels as i32 arithmetic where the integer range analysis proves it safe.
+//
+// The analysis runs on the closest op isolated from above of each kernel, i.e.
+// on the `gpu.func` or on the function holding the `gpu.launch`, for the
+// ranges of the launch sizes to be known. It extends the integer range
+// analysis with the sizes of the memrefs, which bound the loops iterating over
+// them. The narrowing patterns are then applied to the ops of the kernel only.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/GPU/Transforms/Passes.h"
+
+#include "mlir/Analysis/DataFlow/DeadCodeAnalysis.h"
+#include "mlir/Analysis/DataFlow/IntegerRangeAnalysis.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Arith/Transforms/Passes.h"
+#include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "llvm/ADT/MapVector.h"
+
+namespace mlir {
+#define GEN_PASS_DEF_GPUNARROWINDEXARITHMETICPASS
+#include "mlir/Dialect/GPU/Transforms/Passes.h.inc"
+} // namespace mlir
+
+using namespace mlir;
+using namespace mlir::dataflow;
+
+namespace {
+/// An integer range analysis that bounds the results of `memref.dim` by the
+/// static sizes of the memrefs, or by `maxDimSize` for their dynamic sizes.
+class KernelIntegerRangeAnalysis : public IntegerRangeAnalysis {
+public:
+  KernelIntegerRangeAnalysis(DataFlowSolver &solver, int64_t maxDimSize)
+      : IntegerRangeAnalysis(solver), maxDimSize(maxDimSize) {}
+
+  void visitOperation(Operation *op,
+                      ArrayRef<const IntegerValueRangeLattice *> operands,
+                      ArrayRef<IntegerValueRangeLattice *> results) override {
+    auto dimOp = dyn_cast<memref::DimOp>(op);
+    if (!dimOp)
+      return IntegerRangeAnalysis::visitOperation(op, operands, results);
+
+    int64_t umin = 0, umax = maxDimSize;
+    auto memrefType = dyn_cast<MemRefType>(dimOp.getSource().getType());
+    std::optional<int64_t> index = dimOp.getConstantIndex();
+    if (memrefType && index && *index >= 0 && *index < memrefType.getRank() &&
+        !memrefType.isDynamicDim(*index))
+      umin = umax = memrefType.getDimSize(*index);
+    else if (maxDimSize <= 0)
+      return setAllToEntryStates(results);
+
+    unsigned width = IndexType::kInternalStorageBitWidth;
+    ConstantIntRanges range = ConstantIntRanges::fromSigned(
+        APInt(width, umin, /*isSigned=*/true),
+        APInt(width, umax, /*isSigned=*/true));
+    propagateIfChanged(results[0],
+                       results[0]->join(IntegerValueRange(range)));
+  }
+
+private:
+  int64_t maxDimSize;
+};
+
+struct GpuNarrowIndexArithmeticPass
+    : public impl::GpuNarrowIndexArithmeticPassBase<
+          GpuNarrowIndexArithmeticPass> {
+  using Base::Base;
+
+  void runOnOperation() override {
+    // Group the kernels by the op the analysis runs on.
+    llvm::MapVector<Operation *, SmallVector<Operation *>> kernels;
+    getOperation()->walk([&](Operation *op) {
+      if (isa<gpu::GPUFuncOp>(op))
+        kernels[op].push_back(op);
+      else if (isa<gpu::LaunchOp>(op))
+        kernels[op->getParentWithTrait<OpTrait::IsIsolatedFromAbove>()]
+            .push_back(op);
+    });
+
+    MLIRContext *ctx = &getContext();
+    for (auto &[root, rootKernels] : kernels) {
+      DataFlowSolver solver;
+      solver.load<DeadCodeAnalysis>();
+      solver.load<KernelIntegerRangeAnalysis>(maxMemrefDimSize.getValue());
+      if (failed(solver.initializeAndRun(root)))
+        return signalPassFailure();
+
+      RewritePatternSet patterns(ctx);
+      arith::populateIndexNarrowingPatterns(patterns, solver);
+      arith::IndexCastOp::getCanonicalizationPatterns(patterns, ctx);
+      FrozenRewritePatternSet frozenPatterns(std::move(patterns));
+
+      // Only rewrite the ops nested in the kernels, where the narrowed
+      // arithmetic executes on the device.
+      SmallVector<Operation *> ops;
+      for (Operation *kernel : rootKernels)
+        for (Region &region : kernel->getRegions())
+          region.walk([&](Operation *op) { ops.push_back(op); });
+      GreedyRewriteConfig config;
+      config.strictMode = GreedyRewriteStrictness::ExistingAndNewOps;
+      (void)applyOpPatternsAndFold(ops, frozenPatterns, config);
+    }
+  }
+};
+} // namespace
@@ -17,6 +17,7 @@
 #include "mlir/Dialect/GPU/IR/GPUDialect.h"
 #include "mlir/Dialect/GPU/Transforms/ParallelLoopMapper.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/AffineMap.h"
 
 namespace mlir {
@@ -51,10 +52,24 @@ gpu::setMappingAttr(ParallelOp ploopOp,
 namespace gpu {
 namespace {
 enum MappingLevel { MapGrid = 0, MapBlock = 1, Sequential = 2 };
+
+/// The order in which the dimensions of a parallel loop are mapped to the x, y
+/// and z hardware ids.
+enum class MappingPolicy { OutermostFirst, InnermostFirst };
+
+/// The policy and the limits to map the parallel loops with.
+struct MappingOptions {
+  MappingPolicy policy = MappingPolicy::OutermostFirst;
+  int64_t maxThreadsPerBlock = 1024;
+};
 } // namespace
 
 static constexpr int kNumHardwareIds = 3;
 
+/// The maximal sizes of the blocks in the x, y and z dimensions, common to the
+/// NVIDIA and AMD GPUs.
+static constexpr int64_t kMaxBlockSizes[kNumHardwareIds] = {1024, 1024, 64};
+
 /// Bounded increment on MappingLevel. Increments to the next
 /// level unless Sequential was already reached.
 static MappingLevel &operator++(MappingLevel &mappingLevel) {
@@ -103,24 +118,57 @@ static Processor getHardwareIdForMapping(MappingLevel level, int dimension) {
   return Processor::Sequential;
 }
 
+/// Returns the trip count of the `dim`-th loop of `parallelOp`, if its bounds
+/// and step are constant.
+static std::optional<int64_t> getConstantTripCount(ParallelOp parallelOp,
+                                                    unsigned dim) {
+  std::optional<int64_t> lb =
+      getConstantIntValue(parallelOp.getLowerBound()[dim]);
+  std::optional<int64_t> ub =
+      getConstantIntValue(parallelOp.getUpperBound()[dim]);
+  std::optional<int64_t> step = getConstantIntValue(parallelOp.getStep()[dim]);
+  if (!lb || !ub || !step || *step <= 0)
+    return std::nullopt;
+  return llvm::divideCeil(std::max<int64_t>(*ub - *lb, 0), *step);
+}
+
 /// Add mapping information to the given parallel loop. Do not add
 /// mapping information if the loop already has it. Also, don't
 /// start a mapping at a nested loop.
-static void mapParallelOp(ParallelOp parallelOp,
+static void mapParallelOp(ParallelOp parallelOp, const MappingOptions &options,
                           MappingLevel mappingLevel = MapGrid) {
   // Do not try to add a mapping to already mapped loops or nested loops.
   if (parallelOp->getAttr(getMappingAttrName()) ||
       ((mappingLevel == MapGrid) && parallelOp->getParentOfType<ParallelOp>()))
     return;
 
+  // Assign the hardware ids to the dimensions in the order of the policy. At
+  // the block level, the dimensions whose constant trip counts exceed the
+  // remaining block sizes stay sequential.
+  int numLoops = parallelOp.getNumLoops();
+  SmallVector<Processor, 4> processors(numLoops, Processor::Sequential);
+  int numHardwareIds = 0;
+  int64_t numThreads = 1;
+  for (int i = 0; i < numLoops && numHardwareIds < kNumHardwareIds; ++i) {
+    int dim =
+        options.policy == MappingPolicy::InnermostFirst ? numLoops - 1 - i : i;
+    if (mappingLevel == MapBlock) {
+      std::optional<int64_t> tripCount = getConstantTripCount(parallelOp, dim);
+      if (tripCount && (*tripCount > kMaxBlockSizes[numHardwareIds] ||
+                        numThreads * *tripCount > options.maxThreadsPerBlock))
+        continue;
+      numThreads *= tripCount.value_or(1);
+    }
+    processors[dim] = getHardwareIdForMapping(mappingLevel, numHardwareIds++);
+  }
+
   MLIRContext *ctx = parallelOp.getContext();
   Builder b(ctx);
   SmallVector<ParallelLoopDimMappingAttr, 4> attrs;
-  attrs.reserve(parallelOp.getNumLoops());
-  for (int i = 0, e = parallelOp.getNumLoops(); i < e; ++i) {
+  attrs.reserve(numLoops);
+  for (Processor processor : processors) {
     attrs.push_back(b.getAttr<ParallelLoopDimMappingAttr>(
-        getHardwareIdForMapping(mappingLevel, i), b.getDimIdentityMap(),
-        b.getDimIdentityMap()));
+        processor, b.getDimIdentityMap(), b.getDimIdentityMap()));
   }
   (void)setMappingAttr(parallelOp, attrs);
   ++mappingLevel;
@@ -128,16 +176,29 @@ static void mapParallelOp(ParallelOp parallelOp,
   // walk but just iterate over the operations.
   for (Operation &op : *parallelOp.getBody()) {
     if (ParallelOp nested = dyn_cast<ParallelOp>(op))
-      mapParallelOp(nested, mappingLevel);
+      mapParallelOp(nested, options, mappingLevel);
   }
 }
 
 namespace {
 struct GpuMapParallelLoopsPass
     : public impl::GpuMapParallelLoopsPassBase<GpuMapParallelLoopsPass> {
+  using Base::Base;
+
   void runOnOperation() override {
+    MappingOptions options;
+    if (mappingPolicyStr == "innermost-first") {
+      options.policy = MappingPolicy::InnermostFirst;
+    } else if (mappingPolicyStr != "outermost-first") {
+      getOperation()->emitError()
+          << "invalid mapping policy '" << mappingPolicyStr << "'";
+      return signalPassFailure();
+    }
+    options.maxThreadsPerBlock = maxThreadsPerBlock;
     for (Region &region : getOperation()->getRegions()) {
-      region.walk([](ParallelOp parallelOp) { mapParallelOp(parallelOp); });
+      region.walk([&](ParallelOp parallelOp) {
+        mapParallelOp(parallelOp, options);
+      });
     }
   }
 };
@@ -10,6 +10,12 @@
 // into a binary blob that can be executed on a GPU. The binary blob is added
 // as a string attribute to the gpu module.
 //
+// The blobs may be cached in a directory, in files named after a hash of the
+// LLVM IR of the module and of the target options. The files are written
+// atomically, such that concurrent compilations may share the directory. The
+// hash does not cover the version of the tools that serialize the ISA, e.g.
+// ptxas, and the cache must be cleared when they change.
+//
 //===----------------------------------------------------------------------===//
 
 #include "mlir/Dialect/GPU/Transforms/Passes.h"
@@ -18,8 +24,13 @@
 #include "mlir/Target/LLVMIR/Dialect/GPU/GPUToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Export.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetMachine.h"
 
@@ -62,6 +73,43 @@ gpu::SerializeToBlobPass::translateToISA(llvm::Module &llvmModule,
   return stream.str();
 }
 
+/// Returns the name of the cache file of the blob of `llvmModule`, which is
+/// the hash of the module and of the target options `targetOptions`.
+static std::string getCacheFileName(const llvm::Module &llvmModule,
+                                    ArrayRef<StringRef> targetOptions) {
+  std::string ir;
+  llvm::raw_string_ostream os(ir);
+  llvmModule.print(os, /*AAW=*/nullptr);
+  llvm::SHA256 hasher;
+  hasher.update(os.str());
+  for (StringRef option : targetOptions) {
+    hasher.update(StringRef("\0", 1));
+    hasher.update(option);
+  }
+  return llvm::toHex(hasher.result(), /*LowerCase=*/true) + ".bin";
+}
+
+/// Writes `blob` to the cache file `path` through a temporary file, such that
+/// readers never see a partial file. Failures only leave the blob uncached.
+static void writeCacheFile(StringRef path, ArrayRef<char> blob) {
+  if (llvm::sys::fs::create_directories(llvm::sys::path::parent_path(path)))
+    return;
+  int fd;
+  SmallString<128> tempPath;
+  if (llvm::sys::fs::createUniqueFile(path + "-%%%%%%%%.tmp", fd, tempPath))
+    return;
+  bool failed;
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os.write(blob.data(), blob.size());
+    os.close();
+    failed = os.has_error();
+    os.clear_error();
+  }
+  if (failed || llvm::sys::fs::rename(tempPath, path))
+    llvm::sys::fs::remove(tempPath);
+}
+
 void gpu::SerializeToBlobPass::runOnOperation() {
   // Lower the module to an LLVM IR module using a separate context to enable
   // multi-threaded processing.
@@ -70,6 +118,26 @@ void gpu::SerializeToBlobPass::runOnOperation() {
   if (!llvmModule)
     return signalPassFailure();
 
+  // Reuse the cached blob of the module if there is one.
+  SmallString<128> cachePath;
+  if (!cacheDirectory.empty()) {
+    std::string optLevelString = std::to_string(optLevel.getValue());
+    cachePath = cacheDirectory;
+    llvm::sys::path::append(
+        cachePath, getCacheFileName(*llvmModule, {getArgument(), triple, chip,
+                                                  features, optLevelString}));
+    if (auto buffer = llvm::MemoryBuffer::getFile(
+            cachePath, /*IsText=*/false, /*RequiresNullTerminator=*/false)) {
+      LLVM_DEBUG(llvm::dbgs() << "Reusing cached binary " << cachePath
+                              << " for module "
+                              << getOperation().getNameAttr() << "\n");
+      getOperation()->setAttr(
+          gpuBinaryAnnotation,
+          StringAttr::get(&getContext(), (*buffer)->getBuffer()));
+      return;
+    }
+  }
+
   // Lower the LLVM IR module to target ISA.
   std::unique_ptr<llvm::TargetMachine> targetMachine = createTargetMachine();
   if (!targetMachine)
@@ -93,6 +161,8 @@ void gpu::SerializeToBlobPass::runOnOperation() {
   std::unique_ptr<std::vector<char>> blob = serializeISA(targetISA);
   if (!blob)
     return signalPassFailure();
+  if (!cachePath.empty())
+    writeCacheFile(cachePath, *blob);
 
   // Add the blob as module attribute.
   auto attr =
@@ -87,18 +87,28 @@ void SerializeToCubinPass::getDependentDialects(
   gpu::SerializeToBlobPass::getDependentDialects(registry);
 }
 
+// Retains the primary context of the first device in `context`.
+static CUresult retainPrimaryContext(CUcontext &context) {
+  if (CUresult status = cuInit(0))
+    return status;
+  CUdevice device;
+  if (CUresult status = cuDeviceGet(&device, 0))
+    return status;
+  return cuDevicePrimaryCtxRetain(&context, device);
+}
+
 std::unique_ptr<std::vector<char>>
 SerializeToCubinPass::serializeISA(const std::string &isa) {
   Location loc = getOperation().getLoc();
   char jitErrorBuffer[4096] = {0};
 
-  RETURN_ON_CUDA_ERROR(cuInit(0));
-
-  // Linking requires a device context.
-  CUdevice device;
-  RETURN_ON_CUDA_ERROR(cuDeviceGet(&device, 0));
-  CUcontext context;
-  RETURN_ON_CUDA_ERROR(cuCtxCreate(&context, 0, device));
+  // Linking requires a device context. The primary context is retained once
+  // and shared by the modules that are serialized concurrently, since creating
+  // a context per module is expensive.
+  static CUcontext context = nullptr;
+  static CUresult contextStatus = retainPrimaryContext(context);
+  RETURN_ON_CUDA_ERROR(contextStatus);
+  RETURN_ON_CUDA_ERROR(cuCtxPushCurrent(context));
   CUlinkState linkState;
 
   CUjit_option jitOptions[] = {CU_JIT_ERROR_LOG_BUFFER,
@@ -130,7 +140,7 @@ SerializeToCubinPass::serializeISA(const std::string &isa) {
 
   // This will also destroy the cubin data.
   RETURN_ON_CUDA_ERROR(cuLinkDestroy(linkState));
-  RETURN_ON_CUDA_ERROR(cuCtxDestroy(context));
+  RETURN_ON_CUDA_ERROR(cuCtxPopCurrent(nullptr));
 
   return result;
 }
@@ -0,0 +1,250 @@
+//===- StreamAssignment.cpp - Assign async GPU ops to streams -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass that distributes the chains of async GPU ops
+// created by `gpu-async-region` over a bounded number of streams.
+//
+// A chain starts with a `gpu.wait async` without dependencies, threads its
+// token through async ops of the same block, and ends with a `gpu.wait` that
+// synchronizes the host. Each op of a chain only depends on the earlier ops
+// that access a buffer it accesses, if one of them writes it. The ops are
+// assigned to streams in order, preferably to the stream of a dependency that
+// is the last op of its stream, or else to an unused stream, or else to the
+// least recently used stream. An op waits for its dependencies on other
+// streams through a `gpu.wait async` joining the streams, unless the
+// dependencies are known to be complete from an earlier join. To this end,
+// the ops and the streams track the position in each stream up to which the
+// ops are known to be complete, i.e. vector clocks. The `gpu.wait` that ends
+// the chain synchronizes all of its streams.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/GPU/Transforms/Passes.h"
+
+#include "mlir/Analysis/AliasAnalysis.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "mlir/IR/Builders.h"
+
+namespace mlir {
+#define GEN_PASS_DEF_GPUSTREAMASSIGNMENTPASS
+#include "mlir/Dialect/GPU/Transforms/Passes.h.inc"
+} // namespace mlir
+
+using namespace mlir;
+
+namespace {
+/// An op of a chain, with the buffers it accesses and its position in the
+/// streams.
+struct ChainOp {
+  gpu::AsyncOpInterface op;
+  SmallVector<Value> reads;
+  SmallVector<Value> writes;
+  unsigned stream = 0;
+  /// 1-based position of the op in its stream.
+  unsigned position = 0;
+  /// The positions in each stream up to which the ops are known to be
+  /// complete when this op completes.
+  SmallVector<unsigned> clock;
+};
+
+/// A stream that executes ops of a chain.
+struct Stream {
+  /// The token of the last op of the stream.
+  Value token;
+  /// The index in the chain of the last op of the stream.
+  unsigned tail = 0;
+  /// The positions in each stream up to which the ops are known to be
+  /// complete when the last op of this stream completes.
+  SmallVector<unsigned> clock;
+};
+
+class GpuStreamAssignmentPass
+    : public impl::GpuStreamAssignmentPassBase<GpuStreamAssignmentPass> {
+public:
+  using Base::Base;
+  void runOnOperation() override;
+};
+} // namespace
+
+/// Returns the ops of the chain started by `startOp` and the `gpu.wait` that
+/// ends it, or an empty chain when the tokens are used otherwise.
+static std::pair<SmallVector<gpu::AsyncOpInterface>, gpu::WaitOp>
+getChain(gpu::WaitOp startOp) {
+  SmallVector<gpu::AsyncOpInterface> chain;
+  Value token = startOp.getAsyncToken();
+  while (token.hasOneUse()) {
+    Operation *user = *token.getUsers().begin();
+    if (user->getBlock() != startOp->getBlock())
+      break;
+    if (auto waitOp = dyn_cast<gpu::WaitOp>(user)) {
+      if (waitOp.getAsyncToken() || waitOp.getAsyncDependencies().size() != 1)
+        break;
+      return {chain, waitOp};
+    }
+    auto asyncOp = dyn_cast<gpu::AsyncOpInterface>(user);
+    if (!asyncOp || !asyncOp.getAsyncToken() ||
+        asyncOp.getAsyncDependencies().size() != 1)
+      break;
+    chain.push_back(asyncOp);
+    token = asyncOp.getAsyncToken();
+  }
+  return {};
+}
+
+/// Collects the buffers that `op` reads and writes. Besides `gpu.memcpy`, the
+/// ops are assumed to read and write all their memref operands and results,
+/// and kernels to only access memory through their memref arguments.
+static void getAccesses(Operation *op, SmallVectorImpl<Value> &reads,
+                        SmallVectorImpl<Value> &writes) {
+  if (auto memcpyOp = dyn_cast<gpu::MemcpyOp>(op)) {
+    reads.push_back(memcpyOp.getSrc());
+    writes.push_back(memcpyOp.getDst());
+    return;
+  }
+  auto isMemRef = [](Value value) {
+    return isa<BaseMemRefType>(value.getType());
+  };
+  llvm::append_range(writes,
+                     llvm::make_filter_range(op->getOperands(), isMemRef));
+  llvm::append_range(writes,
+                     llvm::make_filter_range(op->getResults(), isMemRef));
+}
+
+/// Returns true if `op` must execute after `pred`, which is earlier in the
+/// chain.
+static bool dependsOn(const ChainOp &op, const ChainOp &pred,
+                      AliasAnalysis &aliasAnalysis) {
+  // The non-token results of `pred`, e.g. sparse handles, must be ready.
+  if (llvm::any_of(op.op->getOperands(), [&](Value operand) {
+        return operand.getDefiningOp() == pred.op;
+      }))
+    return true;
+  auto mayAlias = [&](ArrayRef<Value> lhs, ArrayRef<Value> rhs) {
+    return llvm::any_of(lhs, [&](Value a) {
+      return llvm::any_of(
+          rhs, [&](Value b) { return !aliasAnalysis.alias(a, b).isNo(); });
+    });
+  };
+  return mayAlias(pred.writes, op.writes) || mayAlias(pred.writes, op.reads) ||
+         mayAlias(pred.reads, op.writes);
+}
+
+/// Distributes the ops of the chain `chain`, started by `startOp` and ended by
+/// `endOp`, over at most `numStreams` streams.
+static void assignStreams(gpu::WaitOp startOp,
+                          ArrayRef<gpu::AsyncOpInterface> chain,
+                          gpu::WaitOp endOp, unsigned numStreams,
+                          AliasAnalysis &aliasAnalysis) {
+  SmallVector<ChainOp> chainOps;
+  for (gpu::AsyncOpInterface op : chain) {
+    ChainOp &chainOp = chainOps.emplace_back();
+    chainOp.op = op;
+    getAccesses(op, chainOp.reads, chainOp.writes);
+  }
+
+  SmallVector<Stream> streams;
+  // The tokens of the streams that were replaced by joins, which the end of
+  // the chain synchronizes and releases as well.
+  SmallVector<Value> retiredTokens;
+  OpBuilder builder(startOp);
+  for (auto [index, chainOp] : llvm::enumerate(chainOps)) {
+    SmallVector<unsigned> preds;
+    for (unsigned pred = 0; pred < index; ++pred)
+      if (dependsOn(chainOp, chainOps[pred], aliasAnalysis))
+        preds.push_back(pred);
+
+    // Choose the stream of the latest dependency that ends its stream, or an
+    // unused stream, or the least recently used stream.
+    std::optional<unsigned> streamIndex;
+    for (unsigned pred : llvm::reverse(preds)) {
+      if (streams[chainOps[pred].stream].tail == pred) {
+        streamIndex = chainOps[pred].stream;
+        break;
+      }
+    }
+    if (!streamIndex && streams.size() < numStreams) {
+      streamIndex = streams.size();
+      streams.emplace_back().clock.assign(numStreams, 0);
+    }
+    if (!streamIndex) {
+      auto *leastRecentlyUsed = llvm::min_element(
+          streams, [](const Stream &lhs, const Stream &rhs) {
+            return lhs.tail < rhs.tail;
+          });
+      streamIndex = std::distance(streams.begin(), leastRecentlyUsed);
+    }
+    Stream &stream = streams[*streamIndex];
+
+    // Wait for the dependencies on the other streams that are not known to be
+    // complete, from the latest one.
+    SmallVector<Value> dependencies;
+    if (stream.token)
+      dependencies.push_back(stream.token);
+    for (unsigned pred : llvm::reverse(preds)) {
+      const ChainOp &predOp = chainOps[pred];
+      if (stream.clock[predOp.stream] >= predOp.position)
+        continue;
+      dependencies.push_back(predOp.op.getAsyncToken());
+      for (auto [position, predPosition] :
+           llvm::zip_equal(stream.clock, predOp.clock))
+        position = std::max(position, predPosition);
+    }
+
+    // The first op of the chain keeps the token of the chain start. The first
+    // op of the other streams, and the ops that wait for other streams, use a
+    // new stream created by a `gpu.wait async`.
+    Value token;
+    if (index == 0) {
+      token = startOp.getAsyncToken();
+    } else if (stream.token && dependencies.size() == 1) {
+      token = stream.token;
+    } else {
+      builder.setInsertionPoint(chainOp.op);
+      token = builder
+                  .create<gpu::WaitOp>(chainOp.op.getLoc(),
+                                       builder.getType<gpu::AsyncTokenType>(),
+                                       dependencies)
+                  .getAsyncToken();
+      if (stream.token)
+        retiredTokens.push_back(stream.token);
+    }
+    chainOp.op->setOperand(
+        chainOp.op.getAsyncDependencies().getBeginOperandIndex(), token);
+
+    chainOp.stream = *streamIndex;
+    chainOp.position = ++stream.clock[*streamIndex];
+    chainOp.clock = stream.clock;
+    stream.token = chainOp.op.getAsyncToken();
+    stream.tail = index;
+  }
+
+  SmallVector<Value> endTokens;
+  for (const Stream &stream : streams)
+    endTokens.push_back(stream.token);
+  llvm::append_range(endTokens, retiredTokens);
+  endOp.getAsyncDependenciesMutable().assign(endTokens);
+}
+
+void GpuStreamAssignmentPass::runOnOperation() {
+  if (numStreams == 0) {
+    getOperation().emitError("expected at least one stream");
+    return signalPassFailure();
+  }
+  AliasAnalysis &aliasAnalysis = getAnalysis<AliasAnalysis>();
+  SmallVector<gpu::WaitOp> startOps;
+  getOperation().walk([&](gpu::WaitOp waitOp) {
+    if (waitOp.getAsyncToken() && waitOp.getAsyncDependencies().empty())
+      startOps.push_back(waitOp);
+  });
+  for (gpu::WaitOp startOp : startOps) {
+    auto [chain, endOp] = getChain(startOp);
+    if (chain.size() > 1)
+      assignStreams(startOp, chain, endOp, numStreams, aliasAnalysis);
+  }
+}
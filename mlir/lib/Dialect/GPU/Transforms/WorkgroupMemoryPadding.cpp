@@ -0,0 +1,253 @@
+//===- WorkgroupMemoryPadding.cpp - Pad the rows of workgroup buffers -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass that pads the rows of the buffers in workgroup
+// memory whose column accesses cause bank conflicts.
+//
+// Workgroup memory is divided in banks of 4 bytes, such that consecutive words
+// are in consecutive banks, and the accesses of a warp to distinct words of a
+// bank are serialized. Accesses wider than a word are processed in phases of
+// as many threads as fit in the 128 bytes of one access to all the banks. When
+// the threads access a column of a buffer, i.e. when the innermost index of
+// the access is the same for all threads while an outer index depends on the
+// thread, the row size of a buffer that is an even multiple of the access
+// width maps several threads of a phase to the same bank. Padding the rows by
+// the access width maps them to distinct banks.
+//
+// The buffers are the workgroup attributions of `gpu.func` and `gpu.launch`
+// and the allocations in workgroup memory, as created by the GPU and Linalg
+// promotions. A buffer is padded by enlarging its innermost dimension, and its
+// users access it through a subview of its original shape. The buffers whose
+// users may not accept the strided layout of the subview are left untouched.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/GPU/Transforms/Passes.h"
+
+#include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Interfaces/DestinationStyleOpInterface.h"
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
+
+namespace mlir {
+#define GEN_PASS_DEF_GPUPADWORKGROUPMEMORYPASS
+#include "mlir/Dialect/GPU/Transforms/Passes.h.inc"
+} // namespace mlir
+
+using namespace mlir;
+
+/// The width of the banks, and the width of the narrowest access considered.
+constexpr int64_t kBankWidthBytes = 4;
+/// The width of the widest access of a thread, into which wider vector
+/// accesses are split.
+constexpr int64_t kMaxAccessWidthBytes = 16;
+
+namespace {
+class GpuPadWorkgroupMemoryPass
+    : public impl::GpuPadWorkgroupMemoryPassBase<GpuPadWorkgroupMemoryPass> {
+public:
+  void runOnOperation() override;
+
+private:
+  /// Returns true if `value` varies with the x dimension of the thread id,
+  /// i.e. across the threads of a warp.
+  bool dependsOnThreadId(Value value);
+
+  /// Records the accesses of the users of `view`, a view of a buffer in
+  /// workgroup memory, and the subviews through which they access it. Returns
+  /// failure if a user may not accept a change of the layout of `view`.
+  LogicalResult collectAccesses(Value view,
+                                SmallVectorImpl<memref::SubViewOp> &subviews,
+                                int64_t &columnAccessWidth);
+
+  /// Pads the rows of `buffer` if the column accesses of its users cause bank
+  /// conflicts. `builder` is positioned where the view of the padded buffer
+  /// can be created.
+  void padBuffer(Value buffer, OpBuilder &builder);
+
+  DenseMap<Value, bool> threadIdDependence;
+};
+} // namespace
+
+bool GpuPadWorkgroupMemoryPass::dependsOnThreadId(Value value) {
+  auto it = threadIdDependence.find(value);
+  if (it != threadIdDependence.end())
+    return it->second;
+  // Break the cycles through loop-carried values.
+  threadIdDependence[value] = false;
+
+  bool result = false;
+  if (auto arg = dyn_cast<BlockArgument>(value)) {
+    // The loops mapped to threads start at an offset of the thread id.
+    Operation *parentOp = arg.getOwner()->getParentOp();
+    if (auto launchOp = dyn_cast<gpu::LaunchOp>(parentOp))
+      result = arg == launchOp.getThreadIds().x;
+    else if (auto forOp = dyn_cast<scf::ForOp>(parentOp))
+      result = arg == forOp.getInductionVar() &&
+               dependsOnThreadId(forOp.getLowerBound());
+  } else if (auto threadIdOp = value.getDefiningOp<gpu::ThreadIdOp>()) {
+    result = threadIdOp.getDimension() == gpu::Dimension::x;
+  } else if (value.getDefiningOp<gpu::LaneIdOp>()) {
+    result = true;
+  } else if (value.getDefiningOp()->getNumRegions() == 0) {
+    result = llvm::any_of(value.getDefiningOp()->getOperands(),
+                          [&](Value operand) {
+                            return dependsOnThreadId(operand);
+                          });
+  }
+  threadIdDependence[value] = result;
+  return result;
+}
+
+LogicalResult GpuPadWorkgroupMemoryPass::collectAccesses(
+    Value view, SmallVectorImpl<memref::SubViewOp> &subviews,
+    int64_t &columnAccessWidth) {
+  auto viewType = cast<MemRefType>(view.getType());
+  int64_t elementBytes = viewType.getElementTypeBitWidth() / 8;
+  auto getRowBytes = [&](VectorType vectorType) {
+    if (vectorType.getRank() == 0)
+      return elementBytes;
+    return elementBytes * vectorType.getShape().back();
+  };
+  for (Operation *user : view.getUsers()) {
+    // The innermost indices of the accesses and the number of bytes they
+    // access along the innermost dimension.
+    ValueRange indices;
+    int64_t accessBytes = elementBytes;
+    if (auto loadOp = dyn_cast<memref::LoadOp>(user)) {
+      indices = loadOp.getIndices();
+    } else if (auto storeOp = dyn_cast<memref::StoreOp>(user)) {
+      indices = storeOp.getIndices();
+    } else if (auto loadOp = dyn_cast<vector::LoadOp>(user)) {
+      indices = loadOp.getIndices();
+      accessBytes = getRowBytes(loadOp.getVectorType());
+    } else if (auto storeOp = dyn_cast<vector::StoreOp>(user)) {
+      indices = storeOp.getIndices();
+      accessBytes = getRowBytes(storeOp.getVectorType());
+    } else if (auto transferOp = dyn_cast<VectorTransferOpInterface>(user)) {
+      indices = transferOp.indices();
+      // The vector of a transposing transfer spans the rows, which the thread
+      // accesses one element at a time.
+      if (transferOp.permutation_map().isMinorIdentity())
+        accessBytes = getRowBytes(transferOp.getVectorType());
+    } else if (auto subviewOp = dyn_cast<memref::SubViewOp>(user)) {
+      // The rank-reducing subviews would drop the dimension of the rows.
+      if (subviewOp.getType().getRank() != viewType.getRank())
+        return failure();
+      subviews.push_back(subviewOp);
+      if (failed(collectAccesses(subviewOp.getResult(), subviews,
+                                 columnAccessWidth)))
+        return failure();
+      continue;
+    } else if (isa<memref::CopyOp, memref::DeallocOp>(user)) {
+      continue;
+    } else if (auto dpsOp = dyn_cast<DestinationStyleOpInterface>(user)) {
+      // Structured ops on buffers accept any strided layout, and the mapping
+      // of their iterations to threads is unknown.
+      if (!dpsOp.hasBufferSemantics())
+        return failure();
+      continue;
+    } else {
+      return failure();
+    }
+
+    if (indices.empty() || dependsOnThreadId(indices.back()) ||
+        llvm::none_of(indices.drop_back(),
+                      [&](Value index) { return dependsOnThreadId(index); }))
+      continue;
+    columnAccessWidth = std::max(columnAccessWidth, accessBytes);
+  }
+  return success();
+}
+
+void GpuPadWorkgroupMemoryPass::padBuffer(Value buffer, OpBuilder &builder) {
+  auto type = dyn_cast<MemRefType>(buffer.getType());
+  if (!type || type.getRank() < 2 || !type.hasStaticShape() ||
+      !type.getLayout().isIdentity() || !type.getElementType().isIntOrFloat() ||
+      type.getElementTypeBitWidth() % 8 != 0)
+    return;
+
+  SmallVector<memref::SubViewOp> subviews;
+  int64_t columnAccessWidth = 0;
+  if (failed(collectAccesses(buffer, subviews, columnAccessWidth)) ||
+      columnAccessWidth == 0)
+    return;
+
+  // The threads of a phase access the same bank when the row size is an even
+  // multiple of the access width, a power of 2 between the bank width and the
+  // widest access.
+  int64_t elementBytes = type.getElementTypeBitWidth() / 8;
+  int64_t accessWidth = std::clamp<int64_t>(
+      llvm::NextPowerOf2(columnAccessWidth) / 2,
+      std::max(kBankWidthBytes, elementBytes),
+      std::max(kMaxAccessWidthBytes, elementBytes));
+  int64_t rowBytes = type.getShape().back() * elementBytes;
+  if (rowBytes % accessWidth != 0 || (rowBytes / accessWidth) % 2 != 0)
+    return;
+
+  SmallVector<int64_t> paddedShape(type.getShape());
+  paddedShape.back() += accessWidth / elementBytes;
+  buffer.setType(MemRefType::get(paddedShape, type.getElementType(),
+                                 MemRefLayoutAttrInterface{},
+                                 type.getMemorySpace()));
+
+  // The users access the padded buffer through a view of the original shape,
+  // except for the deallocations.
+  SmallVector<int64_t> offsets(type.getRank(), 0);
+  SmallVector<int64_t> strides(type.getRank(), 1);
+  auto viewOp = builder.create<memref::SubViewOp>(
+      buffer.getLoc(), buffer, offsets, type.getShape(), strides);
+  buffer.replaceUsesWithIf(viewOp.getResult(), [&](OpOperand &operand) {
+    return operand.getOwner() != viewOp &&
+           !isa<memref::DeallocOp>(operand.getOwner());
+  });
+
+  // Update the layouts of the subviews, whose sources precede them.
+  for (memref::SubViewOp subviewOp : subviews) {
+    subviewOp.getResult().setType(cast<MemRefType>(
+        memref::SubViewOp::inferResultType(subviewOp.getSourceType(),
+                                           subviewOp.getMixedOffsets(),
+                                           subviewOp.getMixedSizes(),
+                                           subviewOp.getMixedStrides())));
+  }
+}
+
+void GpuPadWorkgroupMemoryPass::runOnOperation() {
+  SmallVector<std::pair<Value, Block *>> attributions;
+  SmallVector<memref::AllocOp> allocOps;
+  getOperation()->walk([&](Operation *op) {
+    if (auto funcOp = dyn_cast<gpu::GPUFuncOp>(op)) {
+      for (BlockArgument arg : funcOp.getWorkgroupAttributions())
+        attributions.emplace_back(arg, &funcOp.getBody().front());
+    } else if (auto launchOp = dyn_cast<gpu::LaunchOp>(op)) {
+      for (BlockArgument arg : launchOp.getWorkgroupAttributions())
+        attributions.emplace_back(arg, &launchOp.getBody().front());
+    } else if (auto allocOp = dyn_cast<memref::AllocOp>(op)) {
+      auto memorySpace = dyn_cast_or_null<gpu::AddressSpaceAttr>(
+          allocOp.getType().getMemorySpace());
+      if (memorySpace &&
+          memorySpace.getValue() == gpu::GPUDialect::getWorkgroupAddressSpace())
+        allocOps.push_back(allocOp);
+    }
+  });
+
+  OpBuilder builder(&getContext());
+  for (auto [attribution, body] : attributions) {
+    builder.setInsertionPointToStart(body);
+    padBuffer(attribution, builder);
+  }
+  for (memref::AllocOp allocOp : allocOps) {
+    builder.setInsertionPointAfter(allocOp);
+    padBuffer(allocOp.getResult(), builder);
+  }
+}
@@ -486,17 +486,23 @@ LLVMStructType LLVMStructType::getNewIdentified(MLIRContext *context,
                                                 StringRef name,
                                                 ArrayRef<Type> elements,
                                                 bool isPacked) {
-  std::string stringName = name.str();
-  unsigned counter = 0;
-  do {
-    auto type = LLVMStructType::getIdentified(context, stringName);
-    if (type.isInitialized() || failed(type.setBody(elements, isPacked))) {
-      counter += 1;
-      stringName = (Twine(name) + "." + std::to_string(counter)).str();
-      continue;
+  // Each thread resumes the search for a free name after the names it has
+  // already seen in use, which remain in use.
+  auto *dialect = context->getLoadedDialect<LLVMDialect>();
+  unsigned &counter = (*dialect->newIdentifiedStructSuffixes)[name];
+  for (;; ++counter) {
+    std::string stringName =
+        counter == 0 ? name.str()
+                     : (Twine(name) + "." + std::to_string(counter)).str();
+
+    // The struct is constructed with its body if the name is free, and is
+    // only reserved by the first of the threads that may race for it.
+    auto type = Base::get(context, StringRef(stringName), elements, isPacked);
+    if (type.getImpl()->reserve()) {
+      ++counter;
+      return type;
     }
-    return type;
-  } while (true);
+  }
 }
 
 LLVMStructType LLVMStructType::getLiteral(MLIRContext *context,
@@ -556,6 +562,12 @@ LLVMStructType::verify(function_ref<InFlightDiagnostic()> emitError,
   return success();
 }
 
+LogicalResult
+LLVMStructType::verify(function_ref<InFlightDiagnostic()> emitError,
+                       StringRef, ArrayRef<Type> types, bool isPacked) {
+  return verify(emitError, types, isPacked);
+}
+
 unsigned
 LLVMStructType::getTypeSizeInBits(const DataLayout &dataLayout,
                                   DataLayoutEntryListRef params) const {
@@ -20,6 +20,7 @@
 
 #include "llvm/ADT/Bitfields.h"
 #include "llvm/ADT/PointerIntPair.h"
+#include <atomic>
 
 namespace mlir {
 namespace LLVM {
@@ -45,7 +46,10 @@ namespace detail {
 ///   - a bit indicating whether the identified struct is intentionally opaque;
 ///   - a bit indicating whether the identified struct has been initialized.
 /// Uninitialized structs are considered opaque by the user, and can be mutated.
-/// Initialized and still opaque structs cannot be mutated.
+/// Initialized and still opaque structs cannot be mutated. The identified
+/// structs created by `getNewIdentified` are constructed with their body, such
+/// that they are initialized without a mutation, and are reserved by a single
+/// caller.
 ///
 /// The struct storage consists of:
 ///   - immutable part:
@@ -71,15 +75,21 @@ public:
     /// Constructs a key for an identified struct.
     Key(StringRef name, bool opaque, ArrayRef<Type> types = std::nullopt)
         : types(types), name(name), identified(true), packed(false),
-          opaque(opaque) {}
+          opaque(opaque), withBody(false) {}
+    /// Constructs a key for a new identified struct, which is constructed with
+    /// the given body.
+    Key(StringRef name, ArrayRef<Type> body, bool packed)
+        : types(body), name(name), identified(true), packed(packed),
+          opaque(false), withBody(true) {}
     /// Constructs a key for a literal struct.
     Key(ArrayRef<Type> types, bool packed)
-        : types(types), identified(false), packed(packed), opaque(false) {}
+        : types(types), identified(false), packed(packed), opaque(false),
+          withBody(false) {}
 
     /// Checks a specific property of the struct.
     bool isIdentified() const { return identified; }
     bool isPacked() const {
-      assert(!isIdentified() &&
+      assert((!isIdentified() || isWithBody()) &&
              "'packed' bit is not part of the key for identified structs");
       return packed;
     }
@@ -88,6 +98,9 @@ public:
              "'opaque' bit is meaningless on literal structs");
       return opaque;
     }
+    /// Checks whether the key constructs an identified struct with its body.
+    /// This bit only participates in construction.
+    bool isWithBody() const { return withBody; }
 
     /// Returns the identifier of a key for identified structs.
     StringRef getIdentifier() const {
@@ -140,6 +153,8 @@ public:
 
     /// Copies dynamically-sized components of the key into the given allocator.
     Key copyIntoAllocator(TypeStorageAllocator &allocator) const {
+      if (isWithBody())
+        return Key(allocator.copyInto(name), allocator.copyInto(types), packed);
       if (isIdentified())
         return Key(allocator.copyInto(name), opaque);
       return Key(allocator.copyInto(types), packed);
@@ -151,6 +166,7 @@ public:
     bool identified;
     bool packed;
     bool opaque;
+    bool withBody;
   };
   using KeyTy = Key;
 
@@ -225,6 +241,21 @@ public:
                                                 key.isOpaque());
     llvm::Bitfield::set<MutableFlagOpaque>(identifiedBodySizeAndFlags,
                                            key.isOpaque());
+
+    // If the struct is being constructed with its body, i.e. by
+    // `getNewIdentified`, mark it as initialized with this body and let the
+    // caller reserve it. The body is published with the storage, and its
+    // construction does not need to mutate it afterwards.
+    if (key.isWithBody()) {
+      ArrayRef<Type> body = key.getIdentifiedStructBody();
+      llvm::Bitfield::set<MutableFlagInitialized>(identifiedBodySizeAndFlags,
+                                                  true);
+      llvm::Bitfield::set<MutableFlagPacked>(identifiedBodySizeAndFlags,
+                                             key.isPacked());
+      identifiedBodyArray = body.data();
+      setIdentifiedBodySize(body.size());
+      reservable.store(true, std::memory_order_relaxed);
+    }
   }
 
   /// Hook into the type uniquing infrastructure.
@@ -259,6 +290,12 @@ public:
     return success();
   }
 
+  /// Reserves an identified struct constructed with its body. This succeeds for
+  /// a single caller, without locking, and fails for the other structs.
+  bool reserve() {
+    return reservable.exchange(false, std::memory_order_relaxed);
+  }
+
   /// Returns the key for the current storage.
   Key getAsKey() const {
     if (isIdentified())
@@ -327,6 +364,9 @@ private:
   /// Number of the types contained in an identified struct combined with
   /// mutable flags. Must only be used through the Mutable* bitfields.
   unsigned identifiedBodySizeAndFlags = 0;
+
+  /// Whether the struct was constructed with its body and is not reserved yet.
+  std::atomic<bool> reservable{false};
 };
 } // end namespace detail
 } // end namespace LLVM
@@ -0,0 +1,132 @@
+//===- ProfileCounters.cpp - Add profile counters to functions ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/LLVMIR/Transforms/ProfileCounters.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Interfaces/FunctionInterfaces.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+namespace LLVM {
+#define GEN_PASS_DEF_LLVMPROFILECOUNTERS
+#include "mlir/Dialect/LLVMIR/Transforms/Passes.h.inc"
+} // namespace LLVM
+} // namespace mlir
+
+using namespace mlir;
+
+/// The runtime functions of the C runner utils that read the counter and
+/// record the execution of a region.
+static constexpr StringLiteral kReadCounterFnName = "mlirProfileReadCounter";
+static constexpr StringLiteral kRecordRegionFnName = "mlirProfileRecordRegion";
+
+namespace {
+class ProfileCountersPass
+    : public LLVM::impl::LLVMProfileCountersBase<ProfileCountersPass> {
+public:
+  using Base::Base;
+  void runOnOperation() override;
+
+private:
+  /// Reads the counter and materializes the name of a region at the insertion
+  /// point of `builder`, and returns the name and the start value.
+  std::pair<Value, Value> enterRegion(OpBuilder &builder, Location loc,
+                                      StringRef name);
+
+  /// Records the execution of a region at the insertion point of `builder`.
+  void exitRegion(OpBuilder &builder, Location loc,
+                  std::pair<Value, Value> region);
+
+  Type charPtrType;
+  unsigned numRegions = 0;
+};
+} // namespace
+
+std::pair<Value, Value> ProfileCountersPass::enterRegion(OpBuilder &builder,
+                                                         Location loc,
+                                                         StringRef name) {
+  std::string symbolName =
+      ("__mlir_profile_name_" + Twine(numRegions++)).str();
+  Value namePtr = LLVM::createGlobalString(
+      loc, builder, symbolName, (name + Twine('\0')).str(),
+      LLVM::Linkage::Internal, useOpaquePointers);
+  Value start = builder
+                    .create<LLVM::CallOp>(loc, builder.getI64Type(),
+                                          kReadCounterFnName, ValueRange())
+                    .getResult();
+  return {namePtr, start};
+}
+
+void ProfileCountersPass::exitRegion(OpBuilder &builder, Location loc,
+                                     std::pair<Value, Value> region) {
+  builder.create<LLVM::CallOp>(loc, TypeRange(), kRecordRegionFnName,
+                               ValueRange{region.first, region.second});
+}
+
+void ProfileCountersPass::runOnOperation() {
+  ModuleOp module = getOperation();
+  MLIRContext *ctx = &getContext();
+  charPtrType = useOpaquePointers
+                    ? LLVM::LLVMPointerType::get(ctx)
+                    : LLVM::LLVMPointerType::get(IntegerType::get(ctx, 8));
+
+  SmallVector<FunctionOpInterface> funcOps;
+  for (auto funcOp : module.getOps<FunctionOpInterface>())
+    if (!funcOp.isExternal())
+      funcOps.push_back(funcOp);
+
+  // Declare the runtime functions.
+  OpBuilder builder = OpBuilder::atBlockEnd(module.getBody());
+  Type i64Type = builder.getI64Type();
+  if (!module.lookupSymbol(kReadCounterFnName))
+    builder.create<LLVM::LLVMFuncOp>(
+        module.getLoc(), kReadCounterFnName,
+        LLVM::LLVMFunctionType::get(i64Type, {}));
+  if (!module.lookupSymbol(kRecordRegionFnName))
+    builder.create<LLVM::LLVMFuncOp>(
+        module.getLoc(), kRecordRegionFnName,
+        LLVM::LLVMFunctionType::get(LLVM::LLVMVoidType::get(ctx),
+                                    {charPtrType, i64Type}));
+
+  for (FunctionOpInterface funcOp : funcOps) {
+    StringRef funcName = SymbolTable::getSymbolName(funcOp).getValue();
+    Region &body = funcOp.getFunctionBody();
+
+    // Count the outermost loops, in the order of the function.
+    if (instrumentLoops) {
+      SmallVector<LoopLikeOpInterface> loops;
+      funcOp->walk<WalkOrder::PreOrder>([&](LoopLikeOpInterface loop) {
+        loops.push_back(loop);
+        return WalkResult::skip();
+      });
+      for (auto [index, loop] : llvm::enumerate(loops)) {
+        builder.setInsertionPoint(loop);
+        std::pair<Value, Value> region = enterRegion(
+            builder, loop.getLoc(),
+            (funcName + ":loop" + Twine(index)).str());
+        builder.setInsertionPointAfter(loop);
+        exitRegion(builder, loop.getLoc(), region);
+      }
+    }
+
+    // Count the function from its entry to each of its returns.
+    builder.setInsertionPointToStart(&body.front());
+    std::pair<Value, Value> region =
+        enterRegion(builder, funcOp.getLoc(), funcName);
+    for (Block &block : body) {
+      Operation *terminator = block.getTerminator();
+      if (!terminator->hasTrait<OpTrait::ReturnLike>())
+        continue;
+      builder.setInsertionPoint(terminator);
+      exitRegion(builder, terminator->getLoc(), region);
+    }
+  }
+}
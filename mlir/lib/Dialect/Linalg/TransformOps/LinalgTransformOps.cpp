@@ -2218,6 +2218,46 @@ DiagnosedSilenceableFailure transform::SplitReductionOp::applyToOne(
   return DiagnosedSilenceableFailure::success();
 }
 
+//===----------------------------------------------------------------------===//
+// SplitReductionIntoTreeOp
+//===----------------------------------------------------------------------===//
+
+DiagnosedSilenceableFailure transform::SplitReductionIntoTreeOp::apply(
+    transform::TransformRewriter &rewriter,
+    transform::TransformResults &results, transform::TransformState &state) {
+  SmallVector<Operation *> treeOps;
+  SmallVector<Operation *> combiningOps;
+  for (Operation *target : state.getPayloadOps(getTarget())) {
+    auto linalgOp = dyn_cast<LinalgOp>(target);
+    if (!linalgOp)
+      return emitDefiniteFailure() << "expected a Linalg op";
+    rewriter.setInsertionPoint(target);
+    FailureOr<TreeReductionResult> treeResult =
+        splitReductionIntoTree(rewriter, linalgOp, getArity());
+    if (failed(treeResult))
+      return emitDefaultDefiniteFailure(target);
+    llvm::append_range(treeOps, treeResult->levelOps);
+    combiningOps.push_back(treeResult->resultCombiningLinalgOp);
+  }
+  results.set(cast<OpResult>(getTreeOps()), treeOps);
+  results.set(cast<OpResult>(getCombiningLinalgOp()), combiningOps);
+  return DiagnosedSilenceableFailure::success();
+}
+
+void transform::SplitReductionIntoTreeOp::getEffects(
+    SmallVectorImpl<MemoryEffects::EffectInstance> &effects) {
+  consumesHandle(getTarget(), effects);
+  producesHandle(getTreeOps(), effects);
+  producesHandle(getCombiningLinalgOp(), effects);
+  modifiesPayload(effects);
+}
+
+LogicalResult transform::SplitReductionIntoTreeOp::verify() {
+  if (getArity() <= 1)
+    return emitOpError() << "expects an arity greater than 1";
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // TileReductionUsingScfOp
 //===----------------------------------------------------------------------===//
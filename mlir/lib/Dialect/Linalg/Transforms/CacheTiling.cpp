@@ -0,0 +1,304 @@
+//===- CacheTiling.cpp - Tiling for the memory hierarchy ------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements an analytical model that chooses the tile sizes of
+// linalg ops for the cache and register levels of the target, as described
+// by its data layout, and the pass that tiles the ops with these sizes
+// through the TilingInterface.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Linalg/Passes.h"
+
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/DLTI/DLTI.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SCF/Transforms/TileUsingInterface.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Interfaces/DataLayoutInterfaces.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Debug.h"
+
+namespace mlir {
+#define GEN_PASS_DEF_LINALGCACHETILING
+#include "mlir/Dialect/Linalg/Passes.h.inc"
+} // namespace mlir
+
+#define DEBUG_TYPE "linalg-cache-tiling"
+
+using namespace mlir;
+using namespace mlir::linalg;
+
+/// Returns the integer entry `key` of the closest data layout spec that
+/// encloses `op` and has such an entry, or zero if there is none.
+static int64_t lookupIntegerEntry(Operation *op, StringRef key) {
+  StringAttr identifier = StringAttr::get(op->getContext(), key);
+  for (Operation *parent = op; parent; parent = parent->getParentOp()) {
+    auto iface = dyn_cast<DataLayoutOpInterface>(parent);
+    if (!iface)
+      continue;
+    DataLayoutSpecInterface spec = iface.getDataLayoutSpec();
+    if (!spec)
+      continue;
+    if (DataLayoutEntryInterface entry = spec.getSpecForIdentifier(identifier))
+      if (auto value = dyn_cast<IntegerAttr>(entry.getValue()))
+        return value.getInt();
+  }
+  return 0;
+}
+
+CacheHierarchy mlir::linalg::getCacheHierarchy(Operation *op) {
+  CacheHierarchy hierarchy;
+  for (StringRef key : {DLTIDialect::kDataLayoutL1CacheSizeKey,
+                        DLTIDialect::kDataLayoutL2CacheSizeKey,
+                        DLTIDialect::kDataLayoutL3CacheSizeKey}) {
+    int64_t size = lookupIntegerEntry(op, key);
+    if (size <= 0)
+      break;
+    hierarchy.cacheSizes.push_back(size);
+  }
+  hierarchy.vectorWidth =
+      lookupIntegerEntry(op, DLTIDialect::kDataLayoutVectorWidthKey);
+  hierarchy.numVectorRegisters =
+      lookupIntegerEntry(op, DLTIDialect::kDataLayoutNumVectorRegistersKey);
+  return hierarchy;
+}
+
+namespace {
+/// The data of a tile of a linalg op, computed from the loops that index
+/// each of its operands.
+class TileFootprint {
+public:
+  explicit TileFootprint(LinalgOp op) {
+    DataLayout layout = DataLayout::closest(op);
+    for (OpOperand &operand : op->getOpOperands()) {
+      AffineMap map = op.getMatchingIndexingMap(&operand);
+      OperandInfo &info = operands.emplace_back();
+      for (unsigned i = 0, e = map.getNumResults(); i < e; ++i)
+        info.loops.push_back(map.getDimPosition(i));
+      info.elementBytes =
+          layout.getTypeSize(getElementTypeOrSelf(operand.get().getType()));
+    }
+  }
+
+  /// Returns the number of bytes of the data of the tile with the given
+  /// sizes, counting every operand once.
+  int64_t getBytes(ArrayRef<int64_t> tileSizes) const {
+    int64_t bytes = 0;
+    for (const OperandInfo &info : operands) {
+      int64_t operandBytes = info.elementBytes;
+      for (unsigned loop : info.loops)
+        operandBytes *= tileSizes[loop];
+      bytes += operandBytes;
+    }
+    return bytes;
+  }
+
+private:
+  struct OperandInfo {
+    SmallVector<unsigned> loops;
+    int64_t elementBytes;
+  };
+  SmallVector<OperandInfo> operands;
+};
+} // namespace
+
+/// Grows the `tileSizes` by doubling, one at a time, the size of one of the
+/// `loops` that are smaller than their static `loopRanges`, for as long as
+/// the tile `fits`. Each time, the loop that adds the least data to the
+/// `footprint` of the tile is chosen, which maximizes the ratio of the
+/// iterations of the tile to its data.
+static void growTile(SmallVectorImpl<int64_t> &tileSizes,
+                     ArrayRef<int64_t> loopRanges, ArrayRef<unsigned> loops,
+                     const TileFootprint &footprint,
+                     function_ref<bool(ArrayRef<int64_t>)> fits) {
+  SmallVector<int64_t> candidate;
+  while (true) {
+    std::optional<unsigned> bestLoop;
+    int64_t bestSize = 0, bestBytes = 0;
+    for (unsigned loop : loops) {
+      int64_t range = loopRanges[loop];
+      if (tileSizes[loop] == range)
+        continue;
+      int64_t size = tileSizes[loop] * 2;
+      if (!ShapedType::isDynamic(range))
+        size = std::min(size, range);
+      candidate.assign(tileSizes.begin(), tileSizes.end());
+      candidate[loop] = size;
+      if (!fits(candidate))
+        continue;
+      int64_t bytes = footprint.getBytes(candidate);
+      if (!bestLoop || bytes < bestBytes) {
+        bestLoop = loop;
+        bestSize = size;
+        bestBytes = bytes;
+      }
+    }
+    if (!bestLoop)
+      return;
+    tileSizes[*bestLoop] = bestSize;
+  }
+}
+
+FailureOr<SmallVector<SmallVector<int64_t>>>
+mlir::linalg::computeCacheTileSizes(LinalgOp op,
+                                    const CacheHierarchy &hierarchy) {
+  bool tileRegisters =
+      hierarchy.vectorWidth > 0 && hierarchy.numVectorRegisters > 0;
+  if (hierarchy.cacheSizes.empty() && !tileRegisters)
+    return failure();
+  if (!llvm::all_of(op.getIndexingMapsArray(), [](AffineMap map) {
+        return map.isProjectedPermutation();
+      }))
+    return failure();
+  unsigned numLoops = op.getNumLoops();
+  SmallVector<int64_t> loopRanges = op.getStaticLoopRanges();
+  if (numLoops == 0 || llvm::is_contained(loopRanges, 0))
+    return failure();
+  SmallVector<utils::IteratorType> iterators = op.getIteratorTypesArray();
+  TileFootprint footprint(op);
+
+  // The tile sizes of each level, from the innermost level out.
+  SmallVector<SmallVector<int64_t>> levels;
+  SmallVector<int64_t> tileSizes(numLoops, 1);
+  if (tileRegisters) {
+    // Keep a tile of the first init in vector registers, vectorized along
+    // the loop that indexes its contiguous dimension, and grow it along the
+    // other parallel loops for as long as it fits in half of the registers.
+    // The other half is left for the vectors of the inputs.
+    OpOperand *init = op.getDpsInitOperand(0);
+    AffineMap map = op.getMatchingIndexingMap(init);
+    unsigned rank = map.getNumResults();
+    if (rank > 0 &&
+        isParallelIterator(iterators[map.getDimPosition(rank - 1)])) {
+      unsigned vectorLoop = map.getDimPosition(rank - 1);
+      unsigned elementBits = DataLayout::closest(op).getTypeSizeInBits(
+          getElementTypeOrSelf(init->get().getType()));
+      int64_t lanes =
+          std::max<int64_t>(1, hierarchy.vectorWidth / elementBits);
+      int64_t range = loopRanges[vectorLoop];
+      tileSizes[vectorLoop] =
+          ShapedType::isDynamic(range) ? lanes : std::min(lanes, range);
+      SmallVector<unsigned> loops;
+      for (unsigned i = 0; i + 1 < rank; ++i)
+        if (isParallelIterator(iterators[map.getDimPosition(i)]))
+          loops.push_back(map.getDimPosition(i));
+      int64_t maxAccumulators = hierarchy.numVectorRegisters / 2;
+      growTile(tileSizes, loopRanges, loops, footprint,
+               [&](ArrayRef<int64_t> sizes) {
+                 int64_t elements = 1;
+                 for (unsigned i = 0; i < rank; ++i)
+                   elements *= sizes[map.getDimPosition(i)];
+                 return llvm::divideCeil(elements, lanes) <= maxAccumulators;
+               });
+      levels.push_back(tileSizes);
+    }
+  }
+  // Grow the tile of each cache level from the tile of the level inside it,
+  // for as long as its data fit in half of the cache. The other half is left
+  // for the data streamed through the cache and for conflict misses.
+  SmallVector<unsigned> allLoops = llvm::to_vector(llvm::seq<unsigned>(0, numLoops));
+  for (int64_t cacheSize : hierarchy.cacheSizes) {
+    growTile(tileSizes, loopRanges, allLoops, footprint,
+             [&](ArrayRef<int64_t> sizes) {
+               return footprint.getBytes(sizes) <= cacheSize / 2;
+             });
+    levels.push_back(tileSizes);
+  }
+
+  // List the levels from the outermost level in, with a zero for the loops
+  // that are not tiled, and drop the levels that tile nothing.
+  SmallVector<SmallVector<int64_t>> result;
+  for (SmallVector<int64_t> &level : llvm::reverse(levels)) {
+    for (unsigned loop = 0; loop < numLoops; ++loop)
+      if (level[loop] == loopRanges[loop])
+        level[loop] = 0;
+    if (llvm::all_of(level, [](int64_t size) { return size == 0; }) ||
+        (!result.empty() && result.back() == level))
+      continue;
+    result.push_back(level);
+  }
+  LLVM_DEBUG({
+    llvm::dbgs() << "tile sizes of " << op->getName() << ":\n";
+    for (ArrayRef<int64_t> level : result) {
+      llvm::dbgs() << "  ";
+      llvm::interleaveComma(level, llvm::dbgs());
+      llvm::dbgs() << "\n";
+    }
+  });
+  return result;
+}
+
+/// Tiles `op` by each of the `levels` of tile sizes in turn, from the
+/// outermost level in, tiling the tiled op of each level by the next one.
+static LogicalResult tileForLevels(RewriterBase &rewriter, TilingInterface op,
+                                   ArrayRef<SmallVector<int64_t>> levels) {
+  Operation *current = op;
+  SmallVector<int64_t> enclosing(levels.front().size(), 0);
+  for (ArrayRef<int64_t> level : levels) {
+    // Only tile the loops of which the tile shrinks at this level, since
+    // the others already span the tile of the enclosing level.
+    SmallVector<int64_t> tileSizes(level.size(), 0);
+    for (unsigned loop = 0, e = level.size(); loop < e; ++loop)
+      if (level[loop] != enclosing[loop])
+        tileSizes[loop] = level[loop];
+    enclosing.assign(level.begin(), level.end());
+
+    rewriter.setInsertionPoint(current);
+    scf::SCFTilingOptions options;
+    options.setTileSizes(tileSizes);
+    FailureOr<scf::SCFTilingResult> tilingResult = scf::tileUsingSCFForOp(
+        rewriter, cast<TilingInterface>(current), options);
+    if (failed(tilingResult))
+      return failure();
+    if (current->getNumResults())
+      rewriter.replaceOp(current, tilingResult->replacements);
+    else
+      rewriter.eraseOp(current);
+    current = tilingResult->tiledOps.back();
+  }
+  return success();
+}
+
+namespace {
+
+struct LinalgCacheTilingPass
+    : public impl::LinalgCacheTilingBase<LinalgCacheTilingPass> {
+  void runOnOperation() override;
+};
+
+} // namespace
+
+void LinalgCacheTilingPass::runOnOperation() {
+  func::FuncOp func = getOperation();
+  SmallVector<LinalgOp> candidates;
+  func.walk([&](LinalgOp op) { candidates.push_back(op); });
+  IRRewriter rewriter(&getContext());
+  for (LinalgOp op : candidates) {
+    auto tilingOp = dyn_cast<TilingInterface>(op.getOperation());
+    if (!tilingOp)
+      continue;
+    FailureOr<SmallVector<SmallVector<int64_t>>> levels =
+        computeCacheTileSizes(op, getCacheHierarchy(op));
+    if (failed(levels) || levels->empty())
+      continue;
+    if (failed(tileForLevels(rewriter, tilingOp, *levels))) {
+      op->emitOpError("failed to tile for the memory hierarchy");
+      return signalPassFailure();
+    }
+  }
+}
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::createLinalgCacheTilingPass() {
+  return std::make_unique<LinalgCacheTilingPass>();
+}
@@ -0,0 +1,268 @@
+//===- DataLayoutAssignment.cpp - Assign packed layouts to linalg graphs --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the assignment of packed layouts to the tensors of a
+// graph of linalg ops. The dimensions of the tensors that are indexed by the
+// same loops are partitioned into classes, and every class is assigned one
+// inner tile, so that the layout produced by an op is the layout expected by
+// its consumers. The contractions and convolutions are then packed, and the
+// pack and unpack ops are propagated through the element-wise ops between
+// them until they cancel out.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Linalg/Passes.h"
+
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/Linalg/Utils/Utils.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "llvm/ADT/IntEqClasses.h"
+#include "llvm/Support/Debug.h"
+
+namespace mlir {
+#define GEN_PASS_DEF_LINALGDATALAYOUTASSIGNMENT
+#include "mlir/Dialect/Linalg/Passes.h.inc"
+} // namespace mlir
+
+#define DEBUG_TYPE "linalg-data-layout-assignment"
+
+using namespace mlir;
+using namespace mlir::linalg;
+
+namespace {
+
+/// The classes of the dimensions of the tensors, where two dimensions are in
+/// the same class when they are indexed by the same loop of a linalg op.
+class TensorDimClasses {
+public:
+  /// Joins the dimensions of the operands and results of `op` that are
+  /// indexed by the same loops.
+  void join(LinalgOp op);
+
+  /// Returns the class of the dimensions indexed by `loop` in `op`, or
+  /// std::nullopt when no operand of `op` is indexed by `loop` alone.
+  std::optional<unsigned> getLoopClass(LinalgOp op, unsigned loop);
+
+private:
+  unsigned getId(Value value, unsigned dim);
+
+  llvm::DenseMap<std::pair<Value, unsigned>, unsigned> ids;
+  llvm::IntEqClasses classes;
+};
+
+} // namespace
+
+unsigned TensorDimClasses::getId(Value value, unsigned dim) {
+  auto [it, inserted] = ids.try_emplace({value, dim}, ids.size());
+  if (inserted)
+    classes.grow(ids.size());
+  return it->second;
+}
+
+void TensorDimClasses::join(LinalgOp op) {
+  SmallVector<std::optional<unsigned>> loopIds(op.getNumLoops());
+  for (OpOperand &operand : op->getOpOperands()) {
+    if (!isa<RankedTensorType>(operand.get().getType()))
+      continue;
+    AffineMap map = op.getMatchingIndexingMap(&operand);
+    for (auto [dim, expr] : llvm::enumerate(map.getResults())) {
+      auto dimExpr = expr.dyn_cast<AffineDimExpr>();
+      if (!dimExpr)
+        continue;
+      unsigned id = getId(operand.get(), dim);
+      std::optional<unsigned> &loopId = loopIds[dimExpr.getPosition()];
+      if (loopId)
+        classes.join(*loopId, id);
+      else
+        loopId = id;
+    }
+  }
+  // The results have the layouts of their inits.
+  for (OpResult result : op->getResults()) {
+    Value init = op.getDpsInitOperand(result.getResultNumber())->get();
+    auto type = cast<RankedTensorType>(result.getType());
+    for (unsigned dim = 0, e = type.getRank(); dim < e; ++dim)
+      classes.join(getId(init, dim), getId(result, dim));
+  }
+}
+
+std::optional<unsigned> TensorDimClasses::getLoopClass(LinalgOp op,
+                                                       unsigned loop) {
+  for (OpOperand &operand : op->getOpOperands()) {
+    if (!isa<RankedTensorType>(operand.get().getType()))
+      continue;
+    AffineMap map = op.getMatchingIndexingMap(&operand);
+    for (auto [dim, expr] : llvm::enumerate(map.getResults())) {
+      auto dimExpr = expr.dyn_cast<AffineDimExpr>();
+      if (dimExpr && dimExpr.getPosition() == loop)
+        return classes.findLeader(getId(operand.get(), dim));
+    }
+  }
+  return std::nullopt;
+}
+
+/// Returns the inner tile that `op` prefers for each of its loops, which is 0
+/// for the loops that it does not prefer to pack, or an empty vector when
+/// `op` is not packed.
+static SmallVector<int64_t>
+getPreferredTiles(LinalgOp op, const DataLayoutAssignmentOptions &options) {
+  SmallVector<int64_t> tiles(op.getNumLoops(), 0);
+  if (isaContractionOpInterface(op)) {
+    FailureOr<ContractionDimensions> dims = inferContractionDims(op);
+    if (failed(dims))
+      return {};
+    // Only the innermost of several m, n or k loops is packed.
+    tiles[dims->m.back()] = options.mnkTileSizes[0];
+    tiles[dims->n.back()] = options.mnkTileSizes[1];
+    tiles[dims->k.back()] = options.mnkTileSizes[2];
+    return tiles;
+  }
+  if (isaConvolutionOpInterface(op)) {
+    ConvolutionDimensions dims;
+    (void)detail::isConvolutionInterfaceImpl(op, &dims);
+    for (ArrayRef<unsigned> loops :
+         {ArrayRef<unsigned>(dims.outputChannel),
+          ArrayRef<unsigned>(dims.inputChannel),
+          ArrayRef<unsigned>(dims.depth)}) {
+      if (!loops.empty())
+        tiles[loops.back()] = options.channelTileSize;
+    }
+    return tiles;
+  }
+  return {};
+}
+
+/// Returns true when the pack and unpack ops are propagated through `op`.
+static bool isPropagatedThrough(Operation *op) {
+  if (isa<FillOp>(op))
+    return true;
+  auto genericOp = dyn_cast<GenericOp>(op);
+  return genericOp && isElementwise(genericOp);
+}
+
+void mlir::linalg::packLinalgOpsForDataLayout(
+    RewriterBase &rewriter, Operation *op,
+    const DataLayoutAssignmentOptions &options) {
+  SmallVector<LinalgOp> linalgOps;
+  op->walk([&](LinalgOp linalgOp) {
+    if (linalgOp.hasTensorSemantics())
+      linalgOps.push_back(linalgOp);
+  });
+
+  TensorDimClasses dimClasses;
+  for (LinalgOp linalgOp : linalgOps)
+    dimClasses.join(linalgOp);
+
+  // Assign to every class the tile preferred by its first op, so that the
+  // layout of a result is kept by its consumers.
+  struct PackCandidate {
+    LinalgOp op;
+    SmallVector<std::optional<unsigned>> loopClasses;
+  };
+  SmallVector<PackCandidate> candidates;
+  llvm::DenseMap<unsigned, int64_t> classTiles;
+  for (LinalgOp linalgOp : linalgOps) {
+    SmallVector<int64_t> preferredTiles = getPreferredTiles(linalgOp, options);
+    if (preferredTiles.empty())
+      continue;
+    PackCandidate candidate{linalgOp, {}};
+    for (auto [loop, tile] : llvm::enumerate(preferredTiles)) {
+      std::optional<unsigned> loopClass =
+          dimClasses.getLoopClass(linalgOp, loop);
+      candidate.loopClasses.push_back(loopClass);
+      if (tile > 0 && loopClass)
+        classTiles.try_emplace(*loopClass, tile);
+    }
+    candidates.push_back(std::move(candidate));
+  }
+
+  for (PackCandidate &candidate : candidates) {
+    LinalgOp linalgOp = candidate.op;
+    SmallVector<int64_t> loopRanges = linalgOp.getStaticLoopRanges();
+    SmallVector<OpFoldResult> packedSizes;
+    bool isPacked = false;
+    for (auto [range, loopClass] :
+         llvm::zip_equal(loopRanges, candidate.loopClasses)) {
+      int64_t tile = loopClass ? classTiles.lookup(*loopClass) : 0;
+      // Only pack by the tiles that divide the loops, so that the packs do
+      // not need padding and can be propagated.
+      if (ShapedType::isDynamic(range) || tile <= 0 || range % tile != 0)
+        tile = 0;
+      isPacked |= tile > 0;
+      packedSizes.push_back(rewriter.getIndexAttr(tile));
+    }
+    if (!isPacked)
+      continue;
+
+    LLVM_DEBUG({
+      llvm::dbgs() << "packing " << linalgOp << " by ";
+      llvm::interleaveComma(packedSizes, llvm::dbgs());
+      llvm::dbgs() << "\n";
+    });
+    rewriter.setInsertionPoint(linalgOp);
+    FailureOr<PackResult> packResult = pack(rewriter, linalgOp, packedSizes);
+    if (failed(packResult))
+      continue;
+    for (tensor::PackOp packOp : packResult->packOps) {
+      rewriter.setInsertionPoint(packOp);
+      rewriter.replaceOpWithNewOp<tensor::PackOp>(
+          packOp, packOp.getSource(), packOp.getDest(),
+          packOp.getInnerDimsPos(), packOp.getMixedTiles(),
+          /*paddingValue=*/std::nullopt, packOp.getOuterDimsPerm());
+    }
+  }
+}
+
+void mlir::linalg::populateDataLayoutAssignmentPropagationPatterns(
+    RewritePatternSet &patterns) {
+  MLIRContext *context = patterns.getContext();
+  populateDataLayoutPropagationPatterns(patterns, isPropagatedThrough);
+  tensor::PackOp::getCanonicalizationPatterns(patterns, context);
+  tensor::UnPackOp::getCanonicalizationPatterns(patterns, context);
+}
+
+namespace {
+
+struct LinalgDataLayoutAssignmentPass
+    : public impl::LinalgDataLayoutAssignmentBase<
+          LinalgDataLayoutAssignmentPass> {
+  void runOnOperation() override;
+};
+
+} // namespace
+
+void LinalgDataLayoutAssignmentPass::runOnOperation() {
+  DataLayoutAssignmentOptions options;
+  if (!mnkTileSizes.empty()) {
+    if (mnkTileSizes.size() != 3) {
+      getOperation().emitError(
+          "expected 3 tile sizes for the m, n and k loops");
+      return signalPassFailure();
+    }
+    options.mnkTileSizes.assign(mnkTileSizes.begin(), mnkTileSizes.end());
+  }
+  options.channelTileSize = channelTileSize;
+
+  IRRewriter rewriter(&getContext());
+  packLinalgOpsForDataLayout(rewriter, getOperation(), options);
+
+  RewritePatternSet patterns(&getContext());
+  populateDataLayoutAssignmentPropagationPatterns(patterns);
+  if (failed(applyPatternsAndFoldGreedily(getOperation(), std::move(patterns))))
+    return signalPassFailure();
+}
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::createLinalgDataLayoutAssignmentPass() {
+  return std::make_unique<LinalgDataLayoutAssignmentPass>();
+}
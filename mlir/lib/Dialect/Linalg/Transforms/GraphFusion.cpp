@@ -0,0 +1,284 @@
+//===- GraphFusion.cpp - Tile and fuse the graph of linalg ops ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a driver that partitions the linalg ops of a graph
+// into fusion groups, and tiles and fuses each group with the producer-
+// consumer fusion of the TilingInterface, under a cost model that weighs the
+// recomputation of the fused producers against the materialization of their
+// results.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Linalg/Passes.h"
+
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SCF/Transforms/TileUsingInterface.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+
+namespace mlir {
+#define GEN_PASS_DEF_LINALGTILEANDFUSEGRAPH
+#include "mlir/Dialect/Linalg/Passes.h.inc"
+} // namespace mlir
+
+#define DEBUG_TYPE "linalg-tile-and-fuse-graph"
+
+using namespace mlir;
+using namespace mlir::linalg;
+
+/// Returns the loops that enclose `op` within `scope`, from the outermost.
+static SmallVector<scf::ForOp> getEnclosingLoops(Operation *op,
+                                                 Operation *scope) {
+  SmallVector<scf::ForOp> loops;
+  for (Operation *parent = op->getParentOp(); parent && parent != scope;
+       parent = parent->getParentOp())
+    if (auto forOp = dyn_cast<scf::ForOp>(parent))
+      loops.push_back(forOp);
+  std::reverse(loops.begin(), loops.end());
+  return loops;
+}
+
+/// Returns true if `value` is computed from `iv` within `scope`.
+static bool dependsOn(Value value, Value iv, Operation *scope) {
+  if (value == iv)
+    return true;
+  Operation *def = value.getDefiningOp();
+  if (!def || !scope->isAncestor(def))
+    return false;
+  return llvm::any_of(def->getOperands(), [&](Value operand) {
+    return dependsOn(operand, iv, scope);
+  });
+}
+
+/// Returns the number of times that the elements of the slice are computed
+/// by the `loops`, which is the product of the trip counts of the loops that
+/// the slice does not depend on, or std::nullopt when these are not static.
+static std::optional<int64_t>
+getRecomputationFactor(tensor::ExtractSliceOp sliceOp,
+                       ArrayRef<scf::ForOp> loops) {
+  int64_t factor = 1;
+  for (scf::ForOp loop : loops) {
+    auto dependsOnLoop = [&](OpFoldResult ofr) {
+      auto value = ofr.dyn_cast<Value>();
+      return value && dependsOn(value, loop.getInductionVar(), loops.front());
+    };
+    if (llvm::any_of(sliceOp.getMixedOffsets(), dependsOnLoop) ||
+        llvm::any_of(sliceOp.getMixedSizes(), dependsOnLoop))
+      continue;
+    std::optional<int64_t> lb = getConstantIntValue(loop.getLowerBound());
+    std::optional<int64_t> ub = getConstantIntValue(loop.getUpperBound());
+    std::optional<int64_t> step = getConstantIntValue(loop.getStep());
+    if (!lb || !ub || !step)
+      return std::nullopt;
+    factor *= std::max<int64_t>(llvm::divideCeil(*ub - *lb, *step), 1);
+  }
+  return factor;
+}
+
+/// Returns the number of payload ops computed by `op`, or std::nullopt when
+/// this is not static.
+static std::optional<int64_t> getComputeCost(Operation *op) {
+  auto linalgOp = dyn_cast<LinalgOp>(op);
+  if (!linalgOp)
+    return std::nullopt;
+  int64_t iterations = 1;
+  for (int64_t size : linalgOp.getStaticLoopRanges()) {
+    if (ShapedType::isDynamic(size))
+      return std::nullopt;
+    iterations *= size;
+  }
+  // The terminator is not computed, but a copy still moves its values.
+  int64_t payloadOps =
+      std::max<int64_t>(linalgOp.getBlock()->getOperations().size() - 1, 1);
+  return iterations * payloadOps;
+}
+
+namespace {
+
+/// The state of the fusion of the group of one root.
+struct FusionGroup {
+  FusionGroup(Operation *root, const GraphFusionOptions &options)
+      : root(root), scope(root->getParentOp()), options(options) {}
+
+  /// Decides whether to fuse the producer of `sliceOp`, and whether to yield
+  /// its value from the loop nest.
+  std::tuple<bool, bool> shouldFuse(tensor::ExtractSliceOp sliceOp,
+                                    OpResult producer,
+                                    bool isDestinationOperand);
+
+  Operation *root;
+  Operation *scope;
+  const GraphFusionOptions &options;
+  /// The slices that are replaced by fused producers.
+  SmallVector<tensor::ExtractSliceOp> fusedSlices;
+  /// The fused producers, in the order of their fusion.
+  llvm::SetVector<Operation *> fusedProducers;
+  /// The ops whose results are no longer used once the group is fused.
+  llvm::SmallDenseSet<Operation *> replacedOps;
+};
+
+} // namespace
+
+std::tuple<bool, bool>
+FusionGroup::shouldFuse(tensor::ExtractSliceOp sliceOp, OpResult producer,
+                        bool isDestinationOperand) {
+  SmallVector<scf::ForOp> loops = getEnclosingLoops(sliceOp, scope);
+  Operation *outermostLoop = loops.front();
+  Operation *producerOp = producer.getOwner();
+  if (!isa<TilingInterface>(producerOp))
+    return {false, false};
+
+  // Find the users of the producer other than the group, and whether the
+  // value of the producer can be yielded to them, which requires them to
+  // follow the loop nest.
+  bool hasOtherUsers = false;
+  bool usersFollowLoops = true;
+  for (Operation *user : producer.getUsers()) {
+    if (user == sliceOp || user == root || replacedOps.contains(user) ||
+        llvm::is_contained(fusedSlices, user))
+      continue;
+    hasOtherUsers = true;
+    Operation *ancestor =
+        outermostLoop->getBlock()->findAncestorOpInBlock(*user);
+    if (!ancestor || ancestor == outermostLoop ||
+        ancestor->isBeforeInBlock(outermostLoop))
+      usersFollowLoops = false;
+  }
+
+  // Without recomputation the producer is fused, and yielded for its other
+  // users. A destination is then also fused, but never yielded. Otherwise,
+  // the recomputation of the producer is weighed against writing its result
+  // and reading it back, or just reading it back when the producer is also
+  // kept for its other users.
+  std::optional<int64_t> factor = getRecomputationFactor(sliceOp, loops);
+  bool shouldYield = hasOtherUsers && usersFollowLoops && factor == 1 &&
+                     !isDestinationOperand;
+  bool isKept = hasOtherUsers && !shouldYield;
+  bool isFused = false;
+  if (factor == 1 && !isKept) {
+    isFused = true;
+  } else if (factor && !(isDestinationOperand && *factor != 1)) {
+    std::optional<int64_t> computeCost = getComputeCost(producerOp);
+    auto type = dyn_cast<RankedTensorType>(producer.getType());
+    if (computeCost && type && type.hasStaticShape()) {
+      int64_t recomputeCost = (isKept ? *factor : *factor - 1) * *computeCost;
+      int64_t materializeCost =
+          (isKept ? 1 : 2) * type.getNumElements() * options.memoryCost;
+      isFused = recomputeCost <= materializeCost;
+      LLVM_DEBUG(llvm::dbgs() << "recompute cost " << recomputeCost
+                              << " vs materialize cost " << materializeCost
+                              << " of " << *producerOp << "\n");
+    }
+  }
+  if (!isFused)
+    return {false, false};
+
+  fusedSlices.push_back(sliceOp);
+  fusedProducers.insert(producerOp);
+  if (!isKept)
+    replacedOps.insert(producerOp);
+  return {true, shouldYield};
+}
+
+void mlir::linalg::tileAndFuseLinalgGraph(RewriterBase &rewriter,
+                                          Operation *op,
+                                          const GraphFusionOptions &options) {
+  SmallVector<LinalgOp> candidates;
+  op->walk([&](LinalgOp linalgOp) {
+    if (linalgOp.hasTensorSemantics() && linalgOp->getNumResults() > 0)
+      candidates.push_back(linalgOp);
+  });
+
+  // Form the groups from the last op, so that every op is fused into its
+  // consumers before it is considered as a root.
+  llvm::SmallDenseSet<Operation *> erasedOps;
+  for (LinalgOp root : llvm::reverse(candidates)) {
+    if (erasedOps.contains(root))
+      continue;
+
+    SmallVector<int64_t> tileSizes(root.getNumLoops(), 0);
+    for (auto [index, iteratorType] :
+         llvm::enumerate(root.getIteratorTypesArray())) {
+      if (index < options.tileSizes.size() && isParallelIterator(iteratorType))
+        tileSizes[index] = options.tileSizes[index];
+    }
+    if (llvm::all_of(tileSizes, [](int64_t size) { return size == 0; }))
+      continue;
+
+    FusionGroup group(root, options);
+    scf::SCFTileAndFuseOptions fuseOptions;
+    fuseOptions.setTilingOptions(
+        scf::SCFTilingOptions().setTileSizes(tileSizes));
+    fuseOptions.setFusionControlFn(
+        [&](tensor::ExtractSliceOp sliceOp, OpResult producer,
+            bool isDestinationOperand) {
+          return group.shouldFuse(sliceOp, producer, isDestinationOperand);
+        });
+    rewriter.setInsertionPoint(root);
+    FailureOr<scf::SCFTileAndFuseResult> result =
+        scf::tileConsumerAndFuseProducerGreedilyUsingSCFForOp(
+            rewriter, cast<TilingInterface>(root.getOperation()),
+            fuseOptions);
+    if (failed(result) || result->loops.empty())
+      continue;
+
+    // Replace the uses of the root and of the yielded producers outside of
+    // the loop nest, and erase the ops that are left unused.
+    Operation *outermostLoop = result->loops.front();
+    for (auto [value, replacement] : result->replacements) {
+      rewriter.replaceUsesWithIf(value, replacement, [&](OpOperand &use) {
+        return !outermostLoop->isAncestor(use.getOwner());
+      });
+    }
+    erasedOps.insert(root);
+    rewriter.eraseOp(root);
+    for (tensor::ExtractSliceOp sliceOp : group.fusedSlices)
+      if (sliceOp->use_empty())
+        rewriter.eraseOp(sliceOp);
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (Operation *producer : group.fusedProducers) {
+        if (erasedOps.contains(producer) || !producer->use_empty())
+          continue;
+        erasedOps.insert(producer);
+        rewriter.eraseOp(producer);
+        changed = true;
+      }
+    }
+  }
+}
+
+namespace {
+
+struct LinalgTileAndFuseGraphPass
+    : public impl::LinalgTileAndFuseGraphBase<LinalgTileAndFuseGraphPass> {
+  void runOnOperation() override;
+};
+
+} // namespace
+
+void LinalgTileAndFuseGraphPass::runOnOperation() {
+  GraphFusionOptions options;
+  options.tileSizes.assign(tileSizes.begin(), tileSizes.end());
+  options.memoryCost = memoryCost;
+  IRRewriter rewriter(&getContext());
+  tileAndFuseLinalgGraph(rewriter, getOperation(), options);
+}
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::createLinalgTileAndFuseGraphPass() {
+  return std::make_unique<LinalgTileAndFuseGraphPass>();
+}
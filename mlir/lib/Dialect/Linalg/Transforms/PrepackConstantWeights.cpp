@@ -0,0 +1,140 @@
+//===- PrepackConstantWeights.cpp - Pack constant weights at load time ----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass that moves the packing of constant weights into
+// the module initializer. The packed weights are stored in mutable globals
+// that the functions read instead of repacking the weights on every call.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Linalg/Passes.h"
+
+#include "mlir/Dialect/Bufferization/IR/Bufferization.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/SymbolTable.h"
+
+namespace mlir {
+#define GEN_PASS_DEF_LINALGPREPACKCONSTANTWEIGHTS
+#include "mlir/Dialect/Linalg/Passes.h.inc"
+} // namespace mlir
+
+using namespace mlir;
+
+/// The alignment of the globals holding the packed weights, in bytes.
+constexpr int64_t kPackedWeightAlignment = 64;
+
+/// Returns true if `value` is known before the module runs: it is a constant,
+/// or an empty tensor of a static shape.
+static bool isKnownAtLoadTime(Value value) {
+  if (matchPattern(value, m_Constant()))
+    return true;
+  auto emptyOp = value.getDefiningOp<tensor::EmptyOp>();
+  return emptyOp && emptyOp.getType().hasStaticShape();
+}
+
+/// Returns the initializer function `name` of `module`, creating it if needed.
+/// Returns null if a symbol of this name is not a function that can be used
+/// as the initializer.
+static func::FuncOp getOrCreateInitFunction(ModuleOp module,
+                                            SymbolTable &symbolTable,
+                                            StringRef name) {
+  if (Operation *symbol = symbolTable.lookup(name)) {
+    auto initFn = dyn_cast<func::FuncOp>(symbol);
+    if (!initFn || initFn.isExternal() ||
+        initFn.getFunctionType() !=
+            FunctionType::get(module.getContext(), {}, {}) ||
+        !initFn.getBody().hasOneBlock()) {
+      symbol->emitError() << "expected the module initializer '" << name
+                          << "' to be a single-block function without "
+                             "arguments and results";
+      return {};
+    }
+    return initFn;
+  }
+  OpBuilder builder(module.getContext());
+  auto initFn = builder.create<func::FuncOp>(
+      module.getLoc(), name, builder.getFunctionType({}, {}));
+  builder.setInsertionPointToEnd(initFn.addEntryBlock());
+  builder.create<func::ReturnOp>(module.getLoc());
+  symbolTable.insert(initFn);
+  return initFn;
+}
+
+namespace {
+struct LinalgPrepackConstantWeightsPass
+    : public impl::LinalgPrepackConstantWeightsBase<
+          LinalgPrepackConstantWeightsPass> {
+  using Base::Base;
+
+  void runOnOperation() override {
+    ModuleOp module = getOperation();
+    SmallVector<tensor::PackOp> packOps;
+    module.walk([&](tensor::PackOp packOp) {
+      if (packOp.getDestType().hasStaticShape() &&
+          matchPattern(packOp.getSource(), m_Constant()) &&
+          llvm::all_of(packOp->getOperands(), isKnownAtLoadTime) &&
+          packOp->getParentOfType<func::FuncOp>())
+        packOps.push_back(packOp);
+    });
+    if (packOps.empty())
+      return;
+
+    SymbolTable symbolTable(module);
+    func::FuncOp initFn =
+        getOrCreateInitFunction(module, symbolTable, initFunction);
+    if (!initFn)
+      return signalPassFailure();
+
+    OpBuilder builder(&getContext());
+    for (tensor::PackOp packOp : packOps) {
+      Location loc = packOp.getLoc();
+      RankedTensorType packedType = packOp.getDestType();
+      auto bufferType = MemRefType::get(packedType.getShape(),
+                                        packedType.getElementType());
+
+      // The packed weight lives in a global of its own, declared before the
+      // initializer.
+      builder.clearInsertionPoint();
+      auto globalOp = builder.create<memref::GlobalOp>(
+          loc, "__packed_weight", builder.getStringAttr("private"), bufferType,
+          /*initial_value=*/builder.getUnitAttr(), /*constant=*/false,
+          builder.getI64IntegerAttr(kPackedWeightAlignment));
+      symbolTable.insert(globalOp, Block::iterator(initFn));
+
+      // Pack the weight into the global in the initializer.
+      builder.setInsertionPoint(initFn.getBody().front().getTerminator());
+      IRMapping mapping;
+      for (Value operand : packOp->getOperands())
+        if (!mapping.contains(operand))
+          builder.clone(*operand.getDefiningOp(), mapping);
+      Operation *packed = builder.clone(*packOp, mapping);
+      Value initBuffer = builder.create<memref::GetGlobalOp>(
+          loc, bufferType, globalOp.getSymName());
+      builder.create<memref::TensorStoreOp>(loc, packed->getResult(0),
+                                            initBuffer);
+
+      // Read the packed weight from the global instead of packing it.
+      builder.setInsertionPoint(packOp);
+      Value buffer = builder.create<memref::GetGlobalOp>(
+          loc, bufferType, globalOp.getSymName());
+      Value packedWeight = builder.create<bufferization::ToTensorOp>(
+          loc, buffer, /*restrict=*/true, /*writable=*/false);
+      packOp.getResult().replaceAllUsesWith(packedWeight);
+      packOp.erase();
+    }
+  }
+};
+} // namespace
+
+std::unique_ptr<Pass> mlir::createLinalgPrepackConstantWeightsPass() {
+  return std::make_unique<LinalgPrepackConstantWeightsPass>();
+}
@@ -208,6 +208,47 @@ FailureOr<SplitReductionResult> mlir::linalg::splitReduction(
                               reduction};
 }
 
+FailureOr<TreeReductionResult>
+mlir::linalg::splitReductionIntoTree(RewriterBase &b, LinalgOp op,
+                                     int64_t arity) {
+  if (arity <= 1)
+    return b.notifyMatchFailure(op, "tree arity needs to be greater than 1");
+  SmallVector<unsigned> dims;
+  op.getReductionDims(dims);
+  if (dims.size() != 1)
+    return b.notifyMatchFailure(op, "needs a single reduction dimension");
+  if (ShapedType::isDynamic(op.getStaticLoopRanges()[dims[0]]))
+    return b.notifyMatchFailure(op, "needs a static reduction dimension");
+
+  // Each level reduces groups of `arity` adjacent elements in parallel, until
+  // the reduction of the last `arity` elements.
+  TreeReductionResult result;
+  result.resultCombiningLinalgOp = op;
+  while (true) {
+    LinalgOp combiningOp = result.resultCombiningLinalgOp;
+    combiningOp.getReductionDims(dims);
+    if (dims.size() != 1)
+      break;
+    int64_t size = combiningOp.getStaticLoopRanges()[dims[0]];
+    if (ShapedType::isDynamic(size) || size <= arity || size % arity != 0)
+      break;
+    ControlSplitReductionFn control = [&](LinalgOp) {
+      return SplitReductionOptions{size / arity, /*index=*/0,
+                                   /*innerParallel=*/false};
+    };
+    FailureOr<SplitReductionResult> level =
+        splitReduction(b, combiningOp, control);
+    if (failed(level)) {
+      if (result.levelOps.empty())
+        return failure();
+      break;
+    }
+    result.levelOps.push_back(level->splitLinalgOp);
+    result.resultCombiningLinalgOp = level->resultCombiningLinalgOp;
+  }
+  return result;
+}
+
 /// Rewrite f(i, j, k, ...) into f(i, j, k * ratio + kk, ...)
 /// TODO: Additional pattern to rewrite f(i, j, k * ratio + kk, ...) into
 /// f(i, j, k, kk, ...) with a proper ExpandShapeOp. This is probably better
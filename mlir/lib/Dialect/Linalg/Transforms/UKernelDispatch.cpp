@@ -0,0 +1,167 @@
+//===- UKernelDispatch.cpp - Dispatch linalg tiles to micro-kernels -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the patterns and the pass that replace the linalg ops
+// computing register-level tiles, such as the packed tiles of `linalg.mmt4d`,
+// with calls to the micro-kernels of a registry. The micro-kernels are linked
+// through their C interfaces, which take the operands as memref descriptors.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Linalg/Passes.h"
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "llvm/Support/FormatVariadic.h"
+
+namespace mlir {
+#define GEN_PASS_DEF_LINALGUKERNELDISPATCH
+#include "mlir/Dialect/Linalg/Passes.h.inc"
+} // namespace mlir
+
+using namespace mlir;
+using namespace mlir::linalg;
+
+UKernelRegistry UKernelRegistry::getRunnerUtilsUKernels() {
+  UKernelRegistry registry;
+  registry.insert("mlir_ukernel_mmt4d_f32f32f32_8x8x1");
+  registry.insert("mlir_ukernel_mmt4d_f32f32f32_16x16x1");
+  registry.insert("mlir_ukernel_matmul_f32f32f32_8x8");
+  registry.insert("mlir_ukernel_matmul_f32f32f32_16x16");
+  return registry;
+}
+
+/// Returns the sizes of the tile computed by `op`, or an empty vector when
+/// `op` is not a tile computed by micro-kernels.
+static SmallVector<int64_t> getUKernelTileSizes(LinalgOp op) {
+  auto getShape = [&](int64_t i) {
+    return cast<MemRefType>(op->getOperand(i).getType()).getShape();
+  };
+  SmallVector<int64_t> tile;
+  if (isa<Mmt4DOp>(op)) {
+    // The inner tiles of the (M, K, M0, K0) lhs and the (N, K, N0, K0) rhs.
+    tile = {getShape(0)[2], getShape(1)[2], getShape(0)[3]};
+  } else if (isa<MatmulOp>(op)) {
+    // The (M, N) accumulator, updated for any reduction size.
+    tile = {getShape(2)[0], getShape(2)[1]};
+  }
+  if (llvm::any_of(tile, ShapedType::isDynamic))
+    return {};
+  return tile;
+}
+
+std::optional<std::string> mlir::linalg::getUKernelSymbol(LinalgOp op) {
+  if (!op.hasBufferSemantics() || op->getNumOperands() != 3)
+    return std::nullopt;
+  std::string types;
+  llvm::raw_string_ostream os(types);
+  for (Value operand : op->getOperands()) {
+    Type elementType = cast<MemRefType>(operand.getType()).getElementType();
+    if (!elementType.isIntOrFloat())
+      return std::nullopt;
+    os << elementType;
+  }
+  SmallVector<int64_t> tile = getUKernelTileSizes(op);
+  if (tile.empty())
+    return std::nullopt;
+  os << "_";
+  llvm::interleave(tile, os, "x");
+  return llvm::formatv("mlir_ukernel_{0}_{1}", op->getName().stripDialect(),
+                       os.str())
+      .str();
+}
+
+/// Returns the type of `type` with a dynamic shape and strided layout, so
+/// that a micro-kernel has the one declaration for the tiles of any sizes
+/// and any layout.
+static MemRefType makeShapeAndStridedLayoutDynamic(MemRefType type) {
+  SmallVector<int64_t> dynamic(type.getRank(), ShapedType::kDynamic);
+  return MemRefType::Builder(type).setShape(dynamic).setLayout(
+      StridedLayoutAttr::get(type.getContext(), ShapedType::kDynamic,
+                             dynamic));
+}
+
+namespace {
+
+/// Replaces a linalg op with a call to the micro-kernel that computes it,
+/// when the registry has such a micro-kernel.
+struct UKernelDispatchPattern : public OpInterfaceRewritePattern<LinalgOp> {
+  UKernelDispatchPattern(MLIRContext *context, const UKernelRegistry &registry)
+      : OpInterfaceRewritePattern<LinalgOp>(context), registry(registry) {}
+
+  LogicalResult matchAndRewrite(LinalgOp op,
+                                PatternRewriter &rewriter) const override {
+    std::optional<std::string> symbol = getUKernelSymbol(op);
+    if (!symbol)
+      return rewriter.notifyMatchFailure(op, "not a micro-kernel tile");
+    if (!registry.contains(*symbol))
+      return rewriter.notifyMatchFailure(op, "no micro-kernel for the tile");
+
+    Location loc = op->getLoc();
+    SmallVector<Value> operands;
+    for (Value operand : op->getOperands()) {
+      auto type = makeShapeAndStridedLayoutDynamic(
+          cast<MemRefType>(operand.getType()));
+      operands.push_back(rewriter.create<memref::CastOp>(loc, type, operand));
+    }
+
+    auto module = op->getParentOfType<ModuleOp>();
+    if (!module.lookupSymbol(*symbol)) {
+      OpBuilder::InsertionGuard guard(rewriter);
+      rewriter.setInsertionPoint(module.getBody(),
+                                 std::prev(module.getBody()->end()));
+      auto fnType =
+          rewriter.getFunctionType(ValueRange(operands).getTypes(), {});
+      auto funcOp = rewriter.create<func::FuncOp>(loc, *symbol, fnType);
+      // Link the micro-kernel through its `_mlir_ciface_` interface.
+      funcOp->setAttr(LLVM::LLVMDialect::getEmitCWrapperAttrName(),
+                      rewriter.getUnitAttr());
+      funcOp.setPrivate();
+    }
+    rewriter.replaceOpWithNewOp<func::CallOp>(op, *symbol, TypeRange(),
+                                              operands);
+    return success();
+  }
+
+private:
+  UKernelRegistry registry;
+};
+
+struct LinalgUKernelDispatchPass
+    : public impl::LinalgUKernelDispatchBase<LinalgUKernelDispatchPass> {
+  void runOnOperation() override;
+};
+
+} // namespace
+
+void mlir::linalg::populateUKernelDispatchPatterns(
+    RewritePatternSet &patterns, const UKernelRegistry &registry) {
+  patterns.add<UKernelDispatchPattern>(patterns.getContext(), registry);
+}
+
+void LinalgUKernelDispatchPass::runOnOperation() {
+  UKernelRegistry registry;
+  if (ukernels.empty()) {
+    registry = UKernelRegistry::getRunnerUtilsUKernels();
+  } else {
+    for (const std::string &symbol : ukernels)
+      registry.insert(symbol);
+  }
+  RewritePatternSet patterns(&getContext());
+  populateUKernelDispatchPatterns(patterns, registry);
+  if (failed(applyPatternsAndFoldGreedily(getOperation(), std::move(patterns))))
+    return signalPassFailure();
+}
+
+std::unique_ptr<Pass> mlir::createLinalgUKernelDispatchPass() {
+  return std::make_unique<LinalgUKernelDispatchPass>();
+}
@@ -18,6 +18,7 @@
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Dialect/Utils/StructuredOpsUtils.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
@@ -43,9 +44,11 @@ using namespace mlir::linalg;
 #define DBGS() (llvm::dbgs() << '[' << DEBUG_TYPE << "] ")
 #define LDBG(X) LLVM_DEBUG(DBGS() << X << "\n")
 
-/// Try to vectorize `convOp` as a convolution.
-static FailureOr<Operation *> vectorizeConvolution(RewriterBase &rewriter,
-                                                   LinalgOp convOp);
+/// Try to vectorize `convOp` as a convolution, masked to the
+/// `inputVectorSizes` if provided.
+static FailureOr<Operation *>
+vectorizeConvolution(RewriterBase &rewriter, LinalgOp convOp,
+                     ArrayRef<int64_t> inputVectorSizes = {});
 
 /// Return the unique instance of OpType in `block` if it is indeed unique.
 /// Return null if none or more than 1 instances exist.
@@ -1471,9 +1474,34 @@ static LogicalResult reductionPreconditions(LinalgOp op) {
   return success();
 }
 
-static LogicalResult vectorizeDynamicLinalgOpPrecondition(linalg::LinalgOp op) {
-  // TODO: Masking only supports dynamic generic ops for now.
-  if (!isa<linalg::GenericOp, linalg::FillOp, linalg::CopyOp,
+/// Preconditions for masking dynamically-shaped convolutions. Only the 1-D
+/// depthwise convolutions are supported, for which every dimension of the
+/// iteration space is vectorized, and masked to its size, by the
+/// `inputVectorSizes`.
+static LogicalResult
+vectorizeDynamicConvOpPrecondition(linalg::LinalgOp conv,
+                                   ArrayRef<int64_t> inputVectorSizes) {
+  if (!isa<linalg::DepthwiseConv1DNwcWcOp>(conv.getOperation())) {
+    LDBG("Not a 1-D depthwise conv, dynamic shapes are not supported\n");
+    return failure();
+  }
+  if (inputVectorSizes.empty()) {
+    LDBG("Dynamically-shaped conv requires input vector sizes\n");
+    return failure();
+  }
+  return success();
+}
+
+static LogicalResult
+vectorizeDynamicLinalgOpPrecondition(linalg::LinalgOp op,
+                                     ArrayRef<int64_t> inputVectorSizes) {
+  if (isa<ConvolutionOpInterface>(op.getOperation()))
+    return vectorizeDynamicConvOpPrecondition(op, inputVectorSizes);
+
+  // TODO: Masking only supports dynamic element-wise ops, generic ops,
+  // reductions, fills, copies and contractions for now.
+  if (!isElementwise(op) &&
+      !isa<linalg::GenericOp, linalg::ReduceOp, linalg::FillOp, linalg::CopyOp,
            linalg::ContractionOpInterface>(op.getOperation()))
     return failure();
 
@@ -1527,7 +1555,8 @@ vectorizeLinalgOpPrecondition(LinalgOp linalgOp,
     return failure();
 
   if (linalgOp.hasDynamicShape() &&
-      failed(vectorizeDynamicLinalgOpPrecondition(linalgOp))) {
+      failed(
+          vectorizeDynamicLinalgOpPrecondition(linalgOp, inputVectorSizes))) {
     LDBG("Dynamically-shaped op failed vectorization pre-conditions\n");
     return failure();
   }
@@ -1624,9 +1653,20 @@ vectorizeScalableVectorPrecondition(Operation *op,
   if (!isScalable)
     return success();
 
-  // Only element-wise ops supported in the presence of scalable dims.
+  // Only element-wise ops, and reductions whose trailing scalable dim is
+  // parallel, are supported in the presence of scalable dims. The reductions
+  // then combine whole scalable vectors.
   auto linalgOp = dyn_cast<LinalgOp>(op);
-  return success(linalgOp && isElementwise(linalgOp));
+  if (!linalgOp)
+    return failure();
+  if (isElementwise(linalgOp))
+    return success();
+  if (isa<ConvolutionOpInterface>(op))
+    return failure();
+  SmallVector<utils::IteratorType> iteratorTypes =
+      linalgOp.getIteratorTypesArray();
+  return success(isParallelIterator(iteratorTypes.back()) &&
+                 llvm::any_of(iteratorTypes, isReductionIterator));
 }
 
 LogicalResult mlir::linalg::vectorizeOpPrecondition(
@@ -1703,7 +1743,7 @@ LogicalResult mlir::linalg::vectorize(RewriterBase &rewriter, Operation *op,
             // TODO: isaConvolutionOpInterface that can also infer from generic
             // features. Will require stride/dilation attributes inference.
             FailureOr<Operation *> convOr =
-                vectorizeConvolution(rewriter, linalgOp);
+                vectorizeConvolution(rewriter, linalgOp, inputVectorSizes);
             if (succeeded(convOr)) {
               llvm::append_range(results, (*convOr)->getResults());
               return success();
@@ -2475,9 +2515,10 @@ bool isSupportedPoolKind(vector::CombiningKind kind) {
 struct Conv1DGenerator
     : public StructuredGenerator<LinalgOp, utils::IteratorType> {
   Conv1DGenerator(RewriterBase &rewriter, LinalgOp linalgOp, int strideW,
-                  int dilationW)
+                  int dilationW, ArrayRef<int64_t> inputVectorSizes = {})
       : StructuredGenerator<LinalgOp, utils::IteratorType>(rewriter, linalgOp),
-        strideW(strideW), dilationW(dilationW) {
+        strideW(strideW), dilationW(dilationW),
+        vectorSizes(inputVectorSizes) {
     // Determine whether `linalgOp` can be generated with this generator
     if (linalgOp.getNumDpsInputs() != 2 || linalgOp.getNumDpsInits() != 1)
       return;
@@ -2813,6 +2854,28 @@ struct Conv1DGenerator
         ->getResult(0);
   }
 
+  /// Masks the transfer `xferOp` of `shaped` to the sizes of `shaped`, when
+  /// the vector sizes of the iteration space are given and differ from its
+  /// static sizes. The masked transfer is in bounds.
+  Operation *maybeMaskXferOp(Operation *xferOp, Value shaped) {
+    if (vectorSizes.empty() ||
+        llvm::equal(vectorSizes, cast<LinalgOp>(op).getStaticLoopRanges()))
+      return xferOp;
+    auto xferIface = cast<VectorTransferOpInterface>(xferOp);
+    VectorType vecType = xferIface.getVectorType();
+    xferOp->setAttr(xferIface.getInBoundsAttrStrName(),
+                    rewriter.getBoolArrayAttr(
+                        SmallVector<bool>(vecType.getRank(), true)));
+    SmallVector<OpFoldResult> sizes =
+        isa<MemRefType>(shaped.getType())
+            ? memref::getMixedSizes(rewriter, loc, shaped)
+            : tensor::getMixedSizes(rewriter, loc, shaped);
+    Value mask = rewriter.create<vector::CreateMaskOp>(
+        loc, VectorType::get(vecType.getShape(), rewriter.getI1Type()),
+        sizes);
+    return vector::maskOperation(rewriter, xferOp, mask);
+  }
+
   /// Generate a vector implementation for:
   /// ```
   ///   Op def: (     n,     w,     c,    kw)
@@ -2822,15 +2885,27 @@ struct Conv1DGenerator
   /// kw is always unrolled.
   /// TODO: w (resp. kw) is unrolled when the strideW ( resp. dilationW) is
   /// > 1.
+  ///
+  /// With vector sizes for the iteration space, the vectors have these sizes
+  /// and the transfers are masked to the sizes of the operands, which may be
+  /// dynamic. The lanes of the output beyond its sizes only read lanes of
+  /// the input and the filter beyond their sizes, so they are never written.
   FailureOr<Operation *> depthwiseConv() {
     if (!valid)
       return rewriter.notifyMatchFailure(op, "unvectorizable depthwise conv");
 
     int64_t nSize, wSize, cSize, kwSize;
-    // kernel{kw, c}
-    bindShapeDims(rhsShapedType, kwSize, cSize);
-    // out{n, w, c}
-    bindShapeDims(resShapedType, nSize, wSize);
+    if (!vectorSizes.empty()) {
+      nSize = vectorSizes[0];
+      wSize = vectorSizes[1];
+      cSize = vectorSizes[2];
+      kwSize = vectorSizes[3];
+    } else {
+      // kernel{kw, c}
+      bindShapeDims(rhsShapedType, kwSize, cSize);
+      // out{n, w, c}
+      bindShapeDims(resShapedType, nSize, wSize);
+    }
 
     vector::TransferWriteOp write;
     Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
@@ -2855,14 +2930,17 @@ struct Conv1DGenerator
 
     // Read lhs slice of size {n, w * strideW + kw * dilationW, c} @ [0, 0,
     // 0].
-    Value lhs = rewriter.create<vector::TransferReadOp>(
+    Operation *lhsRead = rewriter.create<vector::TransferReadOp>(
         loc, lhsType, lhsShaped, ValueRange{zero, zero, zero});
+    Value lhs = maybeMaskXferOp(lhsRead, lhsShaped)->getResult(0);
     // Read rhs slice of size {kw, c} @ [0, 0].
-    Value rhs = rewriter.create<vector::TransferReadOp>(loc, rhsType, rhsShaped,
-                                                        ValueRange{zero, zero});
+    Operation *rhsRead = rewriter.create<vector::TransferReadOp>(
+        loc, rhsType, rhsShaped, ValueRange{zero, zero});
+    Value rhs = maybeMaskXferOp(rhsRead, rhsShaped)->getResult(0);
     // Read res slice of size {n, w, c} @ [0, 0, 0].
-    Value res = rewriter.create<vector::TransferReadOp>(
+    Operation *resRead = rewriter.create<vector::TransferReadOp>(
         loc, resType, resShaped, ValueRange{zero, zero, zero});
+    Value res = maybeMaskXferOp(resRead, resShaped)->getResult(0);
 
     //===------------------------------------------------------------------===//
     // Begin vector-only rewrite part
@@ -2913,7 +2991,8 @@ struct Conv1DGenerator
       for (auto &collection :
            {resVals, rhsVals, lhsVals, {res, rhs, lhs, zero}})
         for (Value v : collection)
-          rewriter.eraseOp(v.getDefiningOp());
+          if (v)
+            rewriter.eraseOp(v.getDefiningOp());
       return rewriter.notifyMatchFailure(op, "failed to create FMA");
     }
 
@@ -2930,10 +3009,9 @@ struct Conv1DGenerator
     //===------------------------------------------------------------------===//
 
     // Write back res slice of size {n, w, c} @ [0, 0, 0].
-    return rewriter
-        .create<vector::TransferWriteOp>(loc, res, resShaped,
-                                         ValueRange{zero, zero, zero})
-        .getOperation();
+    Operation *resWrite = rewriter.create<vector::TransferWriteOp>(
+        loc, res, resShaped, ValueRange{zero, zero, zero});
+    return maybeMaskXferOp(resWrite, resShaped);
   }
 
   /// Lower lhs{n, w, c} * rhs{c} -> res{n, w, c} to MulAcc
@@ -3073,6 +3151,8 @@ private:
   StringAttr poolExtOp;
   bool isPoolExt = false;
   int strideW, dilationW;
+  // The vector sizes of the iteration space, if provided.
+  SmallVector<int64_t> vectorSizes;
   Value lhsShaped, rhsShaped, resShaped;
   ShapedType lhsShapedType, rhsShapedType, resShapedType;
 
@@ -3125,8 +3205,9 @@ private:
 
 /// Helper function to vectorize a LinalgOp with convolution semantics.
 // TODO: extend the generic vectorization to support windows and drop this.
-static FailureOr<Operation *> vectorizeConvolution(RewriterBase &rewriter,
-                                                   LinalgOp op) {
+static FailureOr<Operation *>
+vectorizeConvolution(RewriterBase &rewriter, LinalgOp op,
+                     ArrayRef<int64_t> inputVectorSizes) {
   // The ConvolutionOpInterface gives us guarantees of existence for
   // strides/dilations. However, we do not need to rely on those, we can simply
   // use them if present, otherwise use the default and let the generic conv.
@@ -3135,7 +3216,7 @@ static FailureOr<Operation *> vectorizeConvolution(RewriterBase &rewriter,
   auto dilations = op->getAttrOfType<DenseIntElementsAttr>("dilations");
   auto stride = strides ? *strides.getValues<uint64_t>().begin() : 1;
   auto dilation = dilations ? *dilations.getValues<uint64_t>().begin() : 1;
-  Conv1DGenerator e(rewriter, op, stride, dilation);
+  Conv1DGenerator e(rewriter, op, stride, dilation, inputVectorSizes);
   auto res = e.generateNonChanneledConv();
   if (succeeded(res))
     return res;
@@ -0,0 +1,439 @@
+//===- WinogradConv2D.cpp - Winograd rewrite of 2-D convolutions ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the rewrite of 2-D convolutions with 3x3 filters into
+// the minimal filtering algorithm F(m x m, 3 x 3) of Winograd. The output is
+// computed by tiles of m x m elements from tiles of (m + 2) x (m + 2) elements
+// of the input, as
+//
+//   Y = AT * [(G * g * GT) . (BT * d * B)] * A
+//
+// where `.` is the element-wise product, which is a batched matmul over the
+// channels for every pair of the (m + 2) x (m + 2) positions of the tiles.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Linalg/Passes.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Tensor/Utils/Utils.h"
+#include "mlir/IR/AffineExpr.h"
+#include "mlir/IR/AffineMap.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+namespace mlir {
+#define GEN_PASS_DEF_LINALGWINOGRADCONV2D
+#include "mlir/Dialect/Linalg/Passes.h.inc"
+} // namespace mlir
+
+using namespace mlir;
+using namespace mlir::linalg;
+
+namespace {
+
+/// The transform matrices of F(m x m, 3 x 3), stored row-major. `BT` is
+/// (m + 2) x (m + 2), `G` is (m + 2) x 3 and `AT` is m x (m + 2).
+struct WinogradMatrices {
+  ArrayRef<double> BT;
+  ArrayRef<double> G;
+  ArrayRef<double> AT;
+};
+
+} // namespace
+
+// clang-format off
+static const double BT_2x2_3x3[] = {
+  1,  0, -1,  0,
+  0,  1,  1,  0,
+  0, -1,  1,  0,
+  0,  1,  0, -1,
+};
+
+static const double G_2x2_3x3[] = {
+  1,      0,    0,
+  0.5,  0.5,  0.5,
+  0.5, -0.5,  0.5,
+  0,      0,    1,
+};
+
+static const double AT_2x2_3x3[] = {
+  1,  1,  1,  0,
+  0,  1, -1, -1,
+};
+
+static const double BT_4x4_3x3[] = {
+  4,  0, -5,  0,  1,  0,
+  0, -4, -4,  1,  1,  0,
+  0,  4, -4, -1,  1,  0,
+  0, -2, -1,  2,  1,  0,
+  0,  2, -1, -2,  1,  0,
+  0,  4,  0, -5,  0,  1,
+};
+
+static const double G_4x4_3x3[] = {
+   1. / 4,        0,       0,
+  -1. / 6,  -1. / 6, -1. / 6,
+  -1. / 6,   1. / 6, -1. / 6,
+   1. / 24,  1. / 12, 1. / 6,
+   1. / 24, -1. / 12, 1. / 6,
+   0,             0,       1,
+};
+
+static const double AT_4x4_3x3[] = {
+  1,  1,  1,  1,  1,  0,
+  0,  1, -1,  2, -2,  0,
+  0,  1,  1,  4,  4,  0,
+  0,  1, -1,  8, -8,  1,
+};
+// clang-format on
+
+static std::optional<WinogradMatrices> getWinogradMatrices(int64_t m) {
+  if (m == 2)
+    return WinogradMatrices{BT_2x2_3x3, G_2x2_3x3, AT_2x2_3x3};
+  if (m == 4)
+    return WinogradMatrices{BT_4x4_3x3, G_4x4_3x3, AT_4x4_3x3};
+  return std::nullopt;
+}
+
+static bool hasAllOneValues(DenseIntElementsAttr attr) {
+  return llvm::all_of(
+      attr, [](APInt element) { return element.getSExtValue() == 1; });
+}
+
+static APFloat getAPFloat(double value, FloatType type) {
+  APFloat result(value);
+  bool losesInfo;
+  result.convert(type.getFloatSemantics(), APFloat::rmNearestTiesToEven,
+                 &losesInfo);
+  return result;
+}
+
+/// Creates a constant tensor of the given shape from the row-major `values`.
+static Value createMatrixConstant(OpBuilder &b, Location loc, FloatType type,
+                                  ArrayRef<int64_t> shape,
+                                  ArrayRef<double> values) {
+  SmallVector<APFloat> elements;
+  for (double value : values)
+    elements.push_back(getAPFloat(value, type));
+  auto tensorType = RankedTensorType::get(shape, type);
+  return b.create<arith::ConstantOp>(
+      loc, DenseElementsAttr::get(tensorType, elements));
+}
+
+/// Creates a tensor of the given shape filled with zeros.
+static Value createZeroTensor(OpBuilder &b, Location loc, FloatType type,
+                              ArrayRef<int64_t> shape) {
+  Value zero = b.create<arith::ConstantOp>(loc, b.getFloatAttr(type, 0.0));
+  Value empty = b.create<tensor::EmptyOp>(loc, shape, type);
+  return b.create<linalg::FillOp>(loc, zero, empty).getResult(0);
+}
+
+/// Creates a generic op that accumulates the product of the `inputs` into
+/// `init`, with the given maps of the `numLoops` loops, of which the last
+/// `numReductions` loops are reductions.
+static Value createContraction(OpBuilder &b, Location loc, ValueRange inputs,
+                               Value init, ArrayRef<AffineExpr> inputExprs,
+                               ArrayRef<AffineExpr> initExprs,
+                               unsigned numLoops, unsigned numReductions,
+                               ArrayRef<unsigned> inputRanks) {
+  MLIRContext *context = b.getContext();
+  SmallVector<AffineMap> maps;
+  for (unsigned rank : inputRanks) {
+    maps.push_back(AffineMap::get(numLoops, 0, inputExprs.take_front(rank),
+                                  context));
+    inputExprs = inputExprs.drop_front(rank);
+  }
+  maps.push_back(AffineMap::get(numLoops, 0, initExprs, context));
+  SmallVector<utils::IteratorType> iterators(numLoops - numReductions,
+                                             utils::IteratorType::parallel);
+  iterators.append(numReductions, utils::IteratorType::reduction);
+  auto genericOp = b.create<linalg::GenericOp>(
+      loc, init.getType(), inputs, init, maps, iterators,
+      [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
+        OpBuilder &nb = nestedBuilder;
+        Value product = args[0];
+        for (Value arg : args.drop_front().drop_back())
+          product = nb.create<arith::MulFOp>(nestedLoc, product, arg);
+        Value sum = nb.create<arith::AddFOp>(nestedLoc, product, args.back());
+        nb.create<linalg::YieldOp>(nestedLoc, sum);
+      });
+  return genericOp.getResult(0);
+}
+
+/// Returns the transformed filter U[a, b, c, f] = (G * g * GT)[a, b] of the
+/// constant `filter`, computed at compile time.
+static DenseElementsAttr foldFilterTransform(DenseElementsAttr filter,
+                                             ArrayRef<double> G,
+                                             int64_t alpha,
+                                             bool isChannelsLast,
+                                             RankedTensorType resultType) {
+  int64_t ic = resultType.getDimSize(2);
+  int64_t oc = resultType.getDimSize(3);
+  SmallVector<double> values;
+  for (APFloat value : filter.getValues<APFloat>())
+    values.push_back(value.convertToDouble());
+
+  auto getFilterValue = [&](int64_t i, int64_t j, int64_t c, int64_t f) {
+    if (isChannelsLast)
+      return values[((i * 3 + j) * ic + c) * oc + f];
+    return values[((f * 3 + i) * 3 + j) * ic + c];
+  };
+
+  auto type = cast<FloatType>(resultType.getElementType());
+  SmallVector<APFloat> elements;
+  elements.reserve(resultType.getNumElements());
+  for (int64_t a = 0; a < alpha; ++a) {
+    for (int64_t b = 0; b < alpha; ++b) {
+      for (int64_t c = 0; c < ic; ++c) {
+        for (int64_t f = 0; f < oc; ++f) {
+          double sum = 0.0;
+          for (int64_t i = 0; i < 3; ++i)
+            for (int64_t j = 0; j < 3; ++j)
+              sum += G[a * 3 + i] * G[b * 3 + j] * getFilterValue(i, j, c, f);
+          elements.push_back(getAPFloat(sum, type));
+        }
+      }
+    }
+  }
+  return DenseElementsAttr::get(resultType, elements);
+}
+
+/// Rewrites the 2-D convolution `convOp`, of which the filter is in the HWCF
+/// layout when `isChannelsLast` and in the FHWC layout otherwise.
+static FailureOr<Operation *> winogradConv2DImpl(RewriterBase &rewriter,
+                                                 LinalgOp convOp,
+                                                 DenseIntElementsAttr strides,
+                                                 DenseIntElementsAttr dilations,
+                                                 bool isChannelsLast,
+                                                 int64_t m) {
+  std::optional<WinogradMatrices> matrices = getWinogradMatrices(m);
+  if (!matrices)
+    return rewriter.notifyMatchFailure(
+        convOp, "expected an output tile size of 2 or 4");
+  if (!convOp.hasTensorSemantics())
+    return rewriter.notifyMatchFailure(convOp, "expected tensor semantics");
+
+  Value input = convOp.getDpsInputOperand(0)->get();
+  Value filter = convOp.getDpsInputOperand(1)->get();
+  Value output = convOp.getDpsInitOperand(0)->get();
+  auto inputType = cast<RankedTensorType>(input.getType());
+  auto filterType = cast<RankedTensorType>(filter.getType());
+  auto outputType = cast<RankedTensorType>(output.getType());
+  if (!inputType.hasStaticShape() || !filterType.hasStaticShape() ||
+      !outputType.hasStaticShape())
+    return rewriter.notifyMatchFailure(convOp, "expected static shapes");
+
+  auto elementType = dyn_cast<FloatType>(outputType.getElementType());
+  if (!elementType || inputType.getElementType() != elementType ||
+      filterType.getElementType() != elementType)
+    return rewriter.notifyMatchFailure(
+        convOp, "expected the same floating-point element types");
+
+  if (!hasAllOneValues(strides) || !hasAllOneValues(dilations))
+    return rewriter.notifyMatchFailure(
+        convOp, "expected all ones for strides and dilations");
+
+  ArrayRef<int64_t> filterShape = filterType.getShape();
+  int64_t fh = isChannelsLast ? filterShape[0] : filterShape[1];
+  int64_t fw = isChannelsLast ? filterShape[1] : filterShape[2];
+  if (fh != 3 || fw != 3)
+    return rewriter.notifyMatchFailure(convOp, "expected a 3x3 filter");
+
+  ArrayRef<int64_t> outputShape = outputType.getShape();
+  int64_t n = outputShape[0];
+  int64_t oh = outputShape[1];
+  int64_t ow = outputShape[2];
+  int64_t oc = outputShape[3];
+  int64_t ic = inputType.getDimSize(3);
+  int64_t alpha = m + 2;
+  int64_t th = llvm::divideCeil(oh, m);
+  int64_t tw = llvm::divideCeil(ow, m);
+
+  MLIRContext *context = rewriter.getContext();
+  Location loc = convOp.getLoc();
+  AffineExpr d0, d1, d2, d3, d4, d5, d6, d7;
+  bindDims(context, d0, d1, d2, d3, d4, d5, d6, d7);
+
+  // Transform the filter: U[a, b, c, f] = sum_ij G[a, i] * G[b, j] * g[i, j].
+  // A constant filter, such as the weights of inference, is transformed at
+  // compile time.
+  auto filterTransformType =
+      RankedTensorType::get({alpha, alpha, ic, oc}, elementType);
+  Value transformedFilter;
+  DenseElementsAttr filterAttr;
+  if (matchPattern(filter, m_Constant(&filterAttr))) {
+    transformedFilter = rewriter.create<arith::ConstantOp>(
+        loc, foldFilterTransform(filterAttr, matrices->G, alpha,
+                                 isChannelsLast, filterTransformType));
+  } else {
+    // The loops are (a, b, c, f, i, j).
+    Value G = createMatrixConstant(rewriter, loc, elementType, {alpha, 3},
+                                   matrices->G);
+    SmallVector<AffineExpr> inputExprs = {d4, d5, d2, d3};
+    if (!isChannelsLast)
+      inputExprs = {d3, d4, d5, d2};
+    inputExprs.append({d0, d4, d1, d5});
+    transformedFilter = createContraction(
+        rewriter, loc, {filter, G, G},
+        createZeroTensor(rewriter, loc, elementType, {alpha, alpha, ic, oc}),
+        inputExprs, {d0, d1, d2, d3}, /*numLoops=*/6, /*numReductions=*/2,
+        /*inputRanks=*/{4, 2, 2});
+  }
+
+  // Pad the input so that the output is covered by whole tiles, which
+  // overlap by the 2 elements of the halo of the filter.
+  int64_t paddedHeight = th * m + 2;
+  int64_t paddedWidth = tw * m + 2;
+  if (paddedHeight != inputType.getDimSize(1) ||
+      paddedWidth != inputType.getDimSize(2)) {
+    auto paddedType =
+        RankedTensorType::get({n, paddedHeight, paddedWidth, ic}, elementType);
+    Value zero = rewriter.create<arith::ConstantOp>(
+        loc, rewriter.getFloatAttr(elementType, 0.0));
+    input = tensor::createPadHighOp(paddedType, input, zero, /*nofold=*/false,
+                                    loc, rewriter);
+  }
+
+  // Transform the tiles d of the input, with the loops
+  // (a, b, n, th, tw, c, i, j):
+  //   V[a, b, n, th, tw, c] = sum_ij BT[a, i] * BT[b, j] * d[i, j]
+  Value BT = createMatrixConstant(rewriter, loc, elementType, {alpha, alpha},
+                                  matrices->BT);
+  Value transformedInput = createContraction(
+      rewriter, loc, {input, BT, BT},
+      createZeroTensor(rewriter, loc, elementType,
+                       {alpha, alpha, n, th, tw, ic}),
+      {d2, d3 * m + d6, d4 * m + d7, d5, d0, d6, d1, d7},
+      {d0, d1, d2, d3, d4, d5}, /*numLoops=*/8, /*numReductions=*/2,
+      /*inputRanks=*/{4, 2, 2});
+
+  // Multiply the transformed tiles with the transformed filter, over the
+  // channels, for every position of the tiles.
+  int64_t numTiles = n * th * tw;
+  Value collapsedInput = rewriter.create<tensor::CollapseShapeOp>(
+      loc, RankedTensorType::get({alpha * alpha, numTiles, ic}, elementType),
+      transformedInput,
+      SmallVector<ReassociationIndices>{{0, 1}, {2, 3, 4}, {5}});
+  Value collapsedFilter = rewriter.create<tensor::CollapseShapeOp>(
+      loc, RankedTensorType::get({alpha * alpha, ic, oc}, elementType),
+      transformedFilter, SmallVector<ReassociationIndices>{{0, 1}, {2}, {3}});
+  Value product =
+      rewriter
+          .create<linalg::BatchMatmulOp>(
+              loc, ValueRange{collapsedInput, collapsedFilter},
+              createZeroTensor(rewriter, loc, elementType,
+                               {alpha * alpha, numTiles, oc}))
+          .getResult(0);
+  Value expandedProduct = rewriter.create<tensor::ExpandShapeOp>(
+      loc, RankedTensorType::get({alpha, alpha, n, th, tw, oc}, elementType),
+      product, SmallVector<ReassociationIndices>{{0, 1}, {2, 3, 4}, {5}});
+
+  // Transform the products M back to the tiles of the output, with the loops
+  // (n, th, x, tw, y, f, a, b):
+  //   Y[n, th, x, tw, y, f] = sum_ab AT[x, a] * AT[y, b] * M[a, b]
+  Value AT = createMatrixConstant(rewriter, loc, elementType, {m, alpha},
+                                  matrices->AT);
+  Value tiles = createContraction(
+      rewriter, loc, {expandedProduct, AT, AT},
+      createZeroTensor(rewriter, loc, elementType, {n, th, m, tw, m, oc}),
+      {d6, d7, d0, d1, d3, d5, d2, d6, d4, d7}, {d0, d1, d2, d3, d4, d5},
+      /*numLoops=*/8, /*numReductions=*/2, /*inputRanks=*/{6, 2, 2});
+  Value result = rewriter.create<tensor::CollapseShapeOp>(
+      loc, RankedTensorType::get({n, th * m, tw * m, oc}, elementType), tiles,
+      SmallVector<ReassociationIndices>{{0}, {1, 2}, {3, 4}, {5}});
+  if (th * m != oh || tw * m != ow) {
+    SmallVector<OpFoldResult> offsets(4, rewriter.getIndexAttr(0));
+    SmallVector<OpFoldResult> sizes =
+        getAsIndexOpFoldResult(context, outputShape);
+    SmallVector<OpFoldResult> strides(4, rewriter.getIndexAttr(1));
+    result = rewriter.create<tensor::ExtractSliceOp>(loc, outputType, result,
+                                                     offsets, sizes, strides);
+  }
+
+  // Accumulate the convolution into the output.
+  AffineMap identity = rewriter.getMultiDimIdentityMap(4);
+  auto addOp = rewriter.create<linalg::GenericOp>(
+      loc, outputType, result, output,
+      ArrayRef<AffineMap>{identity, identity},
+      SmallVector<utils::IteratorType>(4, utils::IteratorType::parallel),
+      [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
+        Value sum =
+            nestedBuilder.create<arith::AddFOp>(nestedLoc, args[0], args[1]);
+        nestedBuilder.create<linalg::YieldOp>(nestedLoc, sum);
+      });
+  rewriter.replaceOp(convOp, addOp.getResults());
+  return addOp.getOperation();
+}
+
+FailureOr<Operation *>
+mlir::linalg::winogradConv2D(RewriterBase &rewriter,
+                             linalg::Conv2DNhwcHwcfOp convOp, int64_t m) {
+  return winogradConv2DImpl(rewriter, convOp, convOp.getStrides(),
+                            convOp.getDilations(), /*isChannelsLast=*/true, m);
+}
+
+FailureOr<Operation *>
+mlir::linalg::winogradConv2D(RewriterBase &rewriter,
+                             linalg::Conv2DNhwcFhwcOp convOp, int64_t m) {
+  return winogradConv2DImpl(rewriter, convOp, convOp.getStrides(),
+                            convOp.getDilations(), /*isChannelsLast=*/false,
+                            m);
+}
+
+namespace {
+
+template <typename ConvOp>
+struct WinogradConv2DPattern : public OpRewritePattern<ConvOp> {
+  WinogradConv2DPattern(MLIRContext *context, int64_t m)
+      : OpRewritePattern<ConvOp>(context), m(m) {}
+
+  LogicalResult matchAndRewrite(ConvOp convOp,
+                                PatternRewriter &rewriter) const override {
+    if (failed(winogradConv2D(rewriter, convOp, m)))
+      return failure();
+    return success();
+  }
+
+private:
+  int64_t m;
+};
+
+struct LinalgWinogradConv2DPass
+    : public impl::LinalgWinogradConv2DBase<LinalgWinogradConv2DPass> {
+  void runOnOperation() override;
+};
+
+} // namespace
+
+void mlir::linalg::populateWinogradConv2DPatterns(RewritePatternSet &patterns,
+                                                  int64_t m) {
+  MLIRContext *context = patterns.getContext();
+  patterns.add<WinogradConv2DPattern<linalg::Conv2DNhwcHwcfOp>,
+               WinogradConv2DPattern<linalg::Conv2DNhwcFhwcOp>>(context, m);
+}
+
+void LinalgWinogradConv2DPass::runOnOperation() {
+  if (!getWinogradMatrices(outputTileSize)) {
+    getOperation().emitError("expected an output tile size of 2 or 4");
+    return signalPassFailure();
+  }
+  RewritePatternSet patterns(&getContext());
+  populateWinogradConv2DPatterns(patterns, outputTileSize);
+  if (failed(applyPatternsAndFoldGreedily(getOperation(), std::move(patterns))))
+    return signalPassFailure();
+}
+
+std::unique_ptr<OperationPass<func::FuncOp>>
+mlir::createLinalgWinogradConv2DPass() {
+  return std::make_unique<LinalgWinogradConv2DPass>();
+}
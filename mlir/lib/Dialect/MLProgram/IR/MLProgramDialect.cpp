@@ -23,6 +23,30 @@ using namespace mlir::ml_program;
 #define GET_TYPEDEF_CLASSES
 #include "mlir/Dialect/MLProgram/IR/MLProgramTypes.cpp.inc"
 
+LogicalResult ExternalStorageAttr::verify(
+    function_ref<InFlightDiagnostic()> emitError, StringRef path,
+    uint64_t offset, uint64_t size, Type type) {
+  if (path.empty())
+    return emitError() << "external storage must have a path";
+  if (size == 0)
+    return emitError() << "external storage must not be empty";
+
+  // The size of the shaped types of statically sized elements is known.
+  auto shapedType = dyn_cast<ShapedType>(type);
+  if (!shapedType || !shapedType.hasStaticShape() ||
+      !shapedType.getElementType().isIntOrFloat())
+    return success();
+  unsigned bitWidth = shapedType.getElementTypeBitWidth();
+  if (bitWidth % 8 != 0)
+    return success();
+  uint64_t typeSize = shapedType.getNumElements() * (bitWidth / 8);
+  if (typeSize != size)
+    return emitError() << "external storage of " << size
+                       << " bytes does not match the " << typeSize
+                       << " bytes of " << type;
+  return success();
+}
+
 namespace {
 struct MLProgramOpAsmDialectInterface : public OpAsmDialectInterface {
   using OpAsmDialectInterface::OpAsmDialectInterface;
@@ -1398,6 +1398,95 @@ CbrtApproximation::matchAndRewrite(math::CbrtOp op,
   return success();
 }
 
+//----------------------------------------------------------------------------//
+// PowF approximation.
+//----------------------------------------------------------------------------//
+
+namespace {
+struct PowFApproximation : public OpRewritePattern<math::PowFOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(math::PowFOp op,
+                                PatternRewriter &rewriter) const final;
+};
+} // namespace
+
+// Computes pow(x, y) as exp(y * log(|x|)), with the sign of x for the odd
+// integer exponents. The exp and log ops are in turn expanded by their
+// approximations, such that the whole computation stays on vectors. The
+// relative error grows with |y * log(|x|)|.
+LogicalResult
+PowFApproximation::matchAndRewrite(math::PowFOp op,
+                                   PatternRewriter &rewriter) const {
+  if (!getElementTypeOrSelf(op.getLhs()).isF32())
+    return rewriter.notifyMatchFailure(op, "unsupported operand type");
+
+  ArrayRef<int64_t> shape = vectorShape(op.getLhs());
+
+  ImplicitLocOpBuilder builder(op->getLoc(), rewriter);
+  auto bcast = [&](Value value) -> Value {
+    return broadcast(builder, value, shape);
+  };
+
+  Value cstZero = bcast(f32Cst(builder, 0.0f));
+  Value cstHalf = bcast(f32Cst(builder, 0.5f));
+  Value cstOne = bcast(f32Cst(builder, 1.0f));
+  Value cstPosInf = bcast(f32FromBits(builder, 0x7f800000u));
+  Value cstMinusInf = bcast(f32FromBits(builder, 0xff800000u));
+  Value cstNan = bcast(f32FromBits(builder, 0x7fc00000));
+  Value cstTrue =
+      bcast(builder.create<arith::ConstantOp>(builder.getBoolAttr(true)));
+
+  Value x = op.getLhs();
+  Value y = op.getRhs();
+  Value absX = builder.create<math::AbsFOp>(x);
+  Value logX = builder.create<math::LogOp>(absX);
+  Value absPow =
+      builder.create<math::ExpOp>(builder.create<arith::MulFOp>(y, logX));
+
+  // The floats of magnitude at least 2^24, and the infinities, are even
+  // integers, and so are their halves.
+  Value yIsInt = builder.create<arith::CmpFOp>(
+      arith::CmpFPredicate::OEQ, builder.create<math::FloorOp>(y), y);
+  Value halfY = builder.create<arith::MulFOp>(y, cstHalf);
+  Value halfYIsInt = builder.create<arith::CmpFOp>(
+      arith::CmpFPredicate::OEQ, builder.create<math::FloorOp>(halfY), halfY);
+  Value yIsOddInt = builder.create<arith::AndIOp>(
+      yIsInt, builder.create<arith::XOrIOp>(halfYIsInt, cstTrue));
+
+  // The odd integer powers have the sign of the base, including for -0.
+  Value pow = builder.create<arith::SelectOp>(
+      yIsOddInt, builder.create<math::CopySignOp>(absPow, x), absPow);
+
+  // The finite negative bases have no real power for the finite non-integer
+  // exponents.
+  Value xIsFiniteNeg = builder.create<arith::AndIOp>(
+      builder.create<arith::CmpFOp>(arith::CmpFPredicate::OLT, x, cstZero),
+      builder.create<arith::CmpFOp>(arith::CmpFPredicate::OGT, x,
+                                    cstMinusInf));
+  Value yIsNotInt = builder.create<arith::XOrIOp>(yIsInt, cstTrue);
+  pow = builder.create<arith::SelectOp>(
+      builder.create<arith::AndIOp>(xIsFiniteNeg, yIsNotInt), cstNan, pow);
+
+  // pow(x, 0) and pow(1, y) are 1 even for the NaNs, and so are pow(-1, inf)
+  // and pow(-1, -inf), for which y * log(|x|) is NaN.
+  Value yIsZero =
+      builder.create<arith::CmpFOp>(arith::CmpFPredicate::OEQ, y, cstZero);
+  Value xIsOne =
+      builder.create<arith::CmpFOp>(arith::CmpFPredicate::OEQ, x, cstOne);
+  Value absXIsOneAndYIsInf = builder.create<arith::AndIOp>(
+      builder.create<arith::CmpFOp>(arith::CmpFPredicate::OEQ, absX, cstOne),
+      builder.create<arith::CmpFOp>(arith::CmpFPredicate::OEQ,
+                                    builder.create<math::AbsFOp>(y),
+                                    cstPosInf));
+  Value isOne = builder.create<arith::OrIOp>(
+      builder.create<arith::OrIOp>(yIsZero, xIsOne), absXIsOneAndYIsInf);
+  pow = builder.create<arith::SelectOp>(isOne, cstOne, pow);
+
+  rewriter.replaceOp(op, pow);
+  return success();
+}
+
 //----------------------------------------------------------------------------//
 // Rsqrt approximation.
 //----------------------------------------------------------------------------//
@@ -1481,13 +1570,14 @@ void mlir::populateMathPolynomialApproximationPatterns(
            ReuseF32Expansion<math::Log2Op>, ReuseF32Expansion<math::Log1pOp>,
            ReuseF32Expansion<math::ErfOp>, ReuseF32Expansion<math::ExpOp>,
            ReuseF32Expansion<math::ExpM1Op>, ReuseF32Expansion<math::CbrtOp>,
-           ReuseF32Expansion<math::SinOp>, ReuseF32Expansion<math::CosOp>>(
-          patterns.getContext());
+           ReuseF32Expansion<math::SinOp>, ReuseF32Expansion<math::CosOp>,
+           ReuseF32Expansion<math::PowFOp>>(patterns.getContext());
 
   patterns.add<AtanApproximation, Atan2Approximation, TanhApproximation,
                LogApproximation, Log2Approximation, Log1pApproximation,
                ErfPolynomialApproximation, ExpApproximation, ExpM1Approximation,
-               CbrtApproximation, SinAndCosApproximation<true, math::SinOp>,
+               CbrtApproximation, PowFApproximation,
+               SinAndCosApproximation<true, math::SinOp>,
                SinAndCosApproximation<false, math::CosOp>>(
       patterns.getContext());
   if (options.enableAvx2) {
@@ -15,6 +15,7 @@
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/MemRef/Transforms/Passes.h"
 #include "mlir/Dialect/MemRef/Transforms/Transforms.h"
+#include "mlir/Dialect/Utils/IndexingUtils.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "llvm/Support/FormatVariadic.h"
@@ -27,6 +28,45 @@ using namespace mlir;
 // Utility functions
 //===----------------------------------------------------------------------===//
 
+/// Returns true if the elements of `type` are packed into a 1-D memref of the
+/// wider type, i.e. if its shape is static and its layout is the identity.
+/// The other memrefs keep their shape and only use the low bits of each wider
+/// element.
+static bool isPackedStorage(MemRefType type) {
+  return type.hasStaticShape() && type.getLayout().isIdentity();
+}
+
+/// Computes the indices of the packed storage of `type` holding the element at
+/// `indices`, and returns the linear index of that element, which gives its
+/// bit offset within the wider element.
+///
+/// For example, to emulate i4 with i8, the element at [%i, %j] of
+/// memref<4x128xi4> is in the element (%i * 128 + %j) floordiv 2 of
+/// memref<256xi8>.
+static Value getPackedLoadIndices(Location loc, MemRefType type, int srcBits,
+                                  int dstBits, ValueRange indices,
+                                  SmallVectorImpl<Value> &packedIndices,
+                                  OpBuilder &builder) {
+  if (type.getRank() == 0)
+    return builder.create<arith::ConstantIndexOp>(loc, 0);
+
+  SmallVector<AffineExpr> symbols(type.getRank());
+  bindSymbolsList(builder.getContext(), MutableArrayRef{symbols});
+  SmallVector<int64_t> strides = computeStrides(type.getShape());
+  AffineExpr linearExpr = builder.getAffineConstantExpr(0);
+  for (auto [symbol, stride] : llvm::zip_equal(symbols, strides))
+    linearExpr = linearExpr + symbol * stride;
+  SmallVector<OpFoldResult> operands = getAsOpFoldResult(indices);
+
+  OpFoldResult packedIndex = affine::makeComposedFoldedAffineApply(
+      builder, loc, linearExpr.floorDiv(dstBits / srcBits), operands);
+  packedIndices.push_back(
+      getValueOrCreateConstantIndexOp(builder, loc, packedIndex));
+  OpFoldResult linearIndex = affine::makeComposedFoldedAffineApply(
+      builder, loc, linearExpr, operands);
+  return getValueOrCreateConstantIndexOp(builder, loc, linearIndex);
+}
+
 /// The emulation only works on 1D memref types.
 /// To make this work on N-D memref, we need to linearize the offset.
 ///
@@ -216,7 +256,7 @@ struct ConvertMemRefLoad final : OpConversionPattern<memref::LoadOp> {
 
     auto loc = op.getLoc();
     auto sourceType = cast<MemRefType>(adaptor.getMemref().getType());
-    unsigned sourceRank = sourceType.getRank();
+    unsigned sourceRank = op.getMemRefType().getRank();
     SmallVector<Value> indices = adaptor.getIndices();
     assert(indices.size() == sourceRank);
 
@@ -229,16 +269,23 @@ struct ConvertMemRefLoad final : OpConversionPattern<memref::LoadOp> {
           op, "only dstBits % srcBits == 0 supported");
     }
 
-    auto stridedMetadata = rewriter.create<memref::ExtractStridedMetadataOp>(
-        loc, adaptor.getMemref());
-
     Value newLoad, lastIdx;
-    if (sourceRank == 0) {
+    if (isPackedStorage(op.getMemRefType())) {
+      SmallVector<Value> packedIndices;
+      lastIdx = getPackedLoadIndices(loc, op.getMemRefType(), srcBits, dstBits,
+                                     indices, packedIndices, rewriter);
+      newLoad = rewriter.create<memref::LoadOp>(
+          loc, srcElementType, adaptor.getMemref(), packedIndices);
+    } else if (sourceRank == 0) {
+      auto stridedMetadata = rewriter.create<memref::ExtractStridedMetadataOp>(
+          loc, adaptor.getMemref());
       newLoad = rewriter.create<memref::LoadOp>(
           loc, srcElementType, adaptor.getMemref(), adaptor.getIndices());
 
       lastIdx = stridedMetadata.getOffset();
     } else {
+      auto stridedMetadata = rewriter.create<memref::ExtractStridedMetadataOp>(
+          loc, adaptor.getMemref());
       newLoad = linearizeMemrefLoad(loc, sourceType, srcBits, dstBits, indices,
                                     stridedMetadata, rewriter);
 
@@ -310,6 +357,17 @@ void memref::populateMemRefNarrowTypeEmulationConversions(
         if (!newElemTy)
           return std::nullopt;
 
-        return ty.cloneWith(std::nullopt, newElemTy);
+        if (!isPackedStorage(ty))
+          return ty.cloneWith(std::nullopt, newElemTy);
+
+        // Pack the narrow elements into a 1-D memref of the wider type, so
+        // that, e.g., memref<4x128xi4> takes 256 bytes instead of 512.
+        SmallVector<int64_t> packedShape;
+        if (ty.getRank() != 0)
+          packedShape.push_back(llvm::divideCeil(
+              ty.getNumElements() * width, loadStoreWidth));
+        return MemRefType::get(packedShape, newElemTy,
+                               MemRefLayoutAttrInterface(),
+                               ty.getMemorySpace());
       });
 }
@@ -299,6 +299,106 @@ LogicalResult LdMatrixOp::verify() {
   return success();
 }
 
+//===----------------------------------------------------------------------===//
+// NVGPU_MBarrier*Op
+//===----------------------------------------------------------------------===//
+
+/// Verifies that `barriers` is a memref of i64 in shared memory indexed by
+/// `indices`.
+static LogicalResult verifyBarrierOperand(Operation *op, Value barriers,
+                                          ValueRange indices) {
+  auto type = cast<MemRefType>(barriers.getType());
+  if (!type.getElementType().isInteger(64))
+    return op->emitOpError() << "expected barriers of type i64";
+  if (!NVGPUDialect::hasSharedMemoryAddressSpace(type))
+    return op->emitOpError()
+           << "expected barriers with a memory space attribute of "
+              "IntegerAttr("
+           << NVGPUDialect::kSharedMemoryAddressSpace
+           << ") or gpu::AddressSpaceAttr(Workgroup)";
+  if (size_t(type.getRank()) != indices.size())
+    return op->emitOpError() << "expected " << type.getRank()
+                             << " barrier indices, got " << indices.size();
+  return success();
+}
+
+LogicalResult MBarrierInitOp::verify() {
+  return verifyBarrierOperand(*this, getBarriers(), getIndices());
+}
+
+LogicalResult MBarrierArriveExpectTxOp::verify() {
+  return verifyBarrierOperand(*this, getBarriers(), getIndices());
+}
+
+LogicalResult MBarrierTryWaitParityOp::verify() {
+  return verifyBarrierOperand(*this, getBarriers(), getIndices());
+}
+
+//===----------------------------------------------------------------------===//
+// NVGPU_TmaAsyncLoadOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult TmaAsyncLoadOp::verify() {
+  auto dstMemref = cast<MemRefType>(getDst().getType());
+  if (!NVGPUDialect::hasSharedMemoryAddressSpace(dstMemref))
+    return emitOpError()
+           << "expected destination memref with a memory space attribute of "
+              "IntegerAttr("
+           << NVGPUDialect::kSharedMemoryAddressSpace
+           << ") or gpu::AddressSpaceAttr(Workgroup)";
+  if (!dstMemref.hasStaticShape() || !isLastMemrefDimUnitStride(dstMemref))
+    return emitOpError() << "expected destination memref with a static shape "
+                            "and a unit stride in the most minor dim";
+  size_t numCoordinates = getCoordinates().size();
+  if (numCoordinates < 1 || numCoordinates > kMaxTmaTensorRank)
+    return emitOpError() << "expected 1 to " << kMaxTmaTensorRank
+                         << " coordinates, got " << numCoordinates;
+  return verifyBarrierOperand(*this, getBarriers(), getBarrierIndices());
+}
+
+//===----------------------------------------------------------------------===//
+// NVGPU_WarpgroupGenerateDescriptorOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult WarpgroupGenerateDescriptorOp::verify() {
+  auto tensorMemref = cast<MemRefType>(getTensor().getType());
+  if (!NVGPUDialect::hasSharedMemoryAddressSpace(tensorMemref))
+    return emitOpError()
+           << "expected memref with a memory space attribute of "
+              "IntegerAttr("
+           << NVGPUDialect::kSharedMemoryAddressSpace
+           << ") or gpu::AddressSpaceAttr(Workgroup)";
+  // The descriptor holds the offsets in units of 16 bytes on 14 bits.
+  for (uint64_t offset : {getLeadingByteOffset(), getStrideByteOffset()})
+    if (offset % 16 != 0 || offset >= (uint64_t(1) << 18))
+      return emitOpError() << "expected byte offsets that are multiples of 16 "
+                              "smaller than 2^18, got "
+                           << offset;
+  uint64_t swizzle = getSwizzle();
+  if (swizzle != 0 && swizzle != 32 && swizzle != 64 && swizzle != 128)
+    return emitOpError() << "expected a swizzle of 0, 32, 64 or 128 bytes, got "
+                         << swizzle;
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// NVGPU_WarpgroupMmaOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult WarpgroupMmaOp::verify() {
+  Type operandType = getOperandType();
+  if (!operandType.isF16() && !operandType.isBF16())
+    return emitOpError() << "expected f16 or bf16 operands, got "
+                         << operandType;
+  // Each thread of the warpgroup holds N/2 accumulators of the 64xN matrix.
+  int64_t n = 2 * cast<VectorType>(getMatrixC().getType()).getNumElements();
+  if (n < 8 || n > 256 || n % 8 != 0)
+    return emitOpError() << "expected N to be a multiple of 8 between 8 and "
+                            "256, i.e. 4 to 128 accumulators, got "
+                         << n / 2 << " accumulators";
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // TableGen'd dialect, type, and op definitions
 //===----------------------------------------------------------------------===//
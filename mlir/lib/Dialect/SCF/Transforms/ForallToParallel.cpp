@@ -0,0 +1,82 @@
+//===- ForallToParallel.cpp - scf.forall to scf.parallel loop conversion --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Transforms the bufferized SCF.ForallOp's into SCF.ParallelOp's.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/SCF/Transforms/Passes.h"
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Arith/Utils/Utils.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SCF/Transforms/Transforms.h"
+#include "mlir/IR/PatternMatch.h"
+
+namespace mlir {
+#define GEN_PASS_DEF_SCFFORALLTOPARALLELLOOP
+#include "mlir/Dialect/SCF/Transforms/Passes.h.inc"
+} // namespace mlir
+
+using namespace mlir;
+
+FailureOr<scf::ParallelOp>
+mlir::scf::forallToParallelLoop(RewriterBase &rewriter, scf::ForallOp forallOp,
+                                bool threadPerIteration) {
+  if (!forallOp.getOutputs().empty())
+    return rewriter.notifyMatchFailure(forallOp,
+                                       "expected a bufferized forall loop");
+  if (forallOp.getMapping())
+    return rewriter.notifyMatchFailure(
+        forallOp, "expected a forall loop without mapping");
+
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPoint(forallOp);
+  Location loc = forallOp.getLoc();
+  SmallVector<Value> lbs = getValueOrCreateConstantIndexOp(
+      rewriter, loc, forallOp.getMixedLowerBound());
+  SmallVector<Value> ubs = getValueOrCreateConstantIndexOp(
+      rewriter, loc, forallOp.getMixedUpperBound());
+  SmallVector<Value> steps =
+      getValueOrCreateConstantIndexOp(rewriter, loc, forallOp.getMixedStep());
+  auto parallelOp = rewriter.create<scf::ParallelOp>(loc, lbs, ubs, steps);
+  if (threadPerIteration)
+    parallelOp->setAttr(scf::ParallelOp::getThreadPerIterationAttrName(),
+                        rewriter.getUnitAttr());
+
+  // The terminator of a bufferized forall loop has no parallel insertions.
+  rewriter.eraseOp(forallOp.getTerminator());
+  rewriter.inlineBlockBefore(forallOp.getBody(),
+                             parallelOp.getBody()->getTerminator(),
+                             parallelOp.getInductionVars());
+  rewriter.eraseOp(forallOp);
+  return parallelOp;
+}
+
+namespace {
+
+struct ForallToParallelLoop
+    : public impl::SCFForallToParallelLoopBase<ForallToParallelLoop> {
+  using Base::Base;
+
+  void runOnOperation() override {
+    SmallVector<scf::ForallOp> forallOps;
+    getOperation()->walk(
+        [&](scf::ForallOp forallOp) { forallOps.push_back(forallOp); });
+
+    // The loops that cannot be converted are left as is.
+    IRRewriter rewriter(&getContext());
+    for (scf::ForallOp forallOp : forallOps)
+      (void)scf::forallToParallelLoop(rewriter, forallOp, threadPerIteration);
+  }
+};
+} // namespace
+
+std::unique_ptr<Pass> mlir::createForallToParallelLoopPass() {
+  return std::make_unique<ForallToParallelLoop>();
+}
@@ -0,0 +1,288 @@
+//===- LoopScheduling.cpp - Schedule scf.for loops for pipelining ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass that software pipelines the innermost scf.for
+// loops with a schedule derived from latency estimates, such that the loads of
+// the next iterations overlap with the computations of the current one.
+//
+// The ops of the loop body are scheduled as soon as their operands are
+// available, from the latencies of the loads and of the floating-point
+// arithmetic. The initiation interval is bounded below by the number of ops
+// issued per iteration and by the latency of the loop-carried recurrences.
+// The stage of an op is its start time divided by the initiation interval,
+// within the maximal number of stages. The ops of the recurrences are then
+// kept in a single stage, as the pipeliner only supports loop-carried
+// dependences of distance 1, and so are the memory accesses that may depend
+// on each other.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/SCF/Transforms/Passes.h"
+
+#include "mlir/Analysis/AliasAnalysis.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SCF/Transforms/Patterns.h"
+#include "mlir/Dialect/SCF/Transforms/Transforms.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/IR/TypeUtilities.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "llvm/Support/Debug.h"
+
+namespace mlir {
+#define GEN_PASS_DEF_SCFFORLOOPPIPELINING
+#include "mlir/Dialect/SCF/Transforms/Passes.h.inc"
+} // namespace mlir
+
+#define DEBUG_TYPE "scf-for-loop-pipelining"
+
+using namespace mlir;
+using namespace mlir::scf;
+
+/// The number of ops issued per cycle.
+constexpr unsigned kIssueWidth = 4;
+/// The latency of the floating-point arithmetic, including the FMAs.
+constexpr unsigned kFloatLatency = 4;
+
+namespace {
+/// The memory accessed by an op of the loop body.
+struct MemoryAccess {
+  Operation *op;
+  /// The memory read and written by the op, or null if unknown.
+  SmallVector<Value> reads;
+  SmallVector<Value> writes;
+};
+
+struct ForLoopPipelining
+    : public impl::SCFForLoopPipeliningBase<ForLoopPipelining> {
+  using Base::Base;
+  void runOnOperation() override;
+
+private:
+  /// Returns the latency of `op` in cycles.
+  unsigned getLatency(Operation *op) const;
+
+  /// Computes the stages of the ops of the body of `forOp`. Returns an empty
+  /// schedule if the loop cannot be pipelined.
+  void computeSchedule(ForOp forOp, AliasAnalysis &aliasAnalysis,
+                       std::vector<std::pair<Operation *, unsigned>> &schedule);
+};
+} // namespace
+
+unsigned ForLoopPipelining::getLatency(Operation *op) const {
+  if (isa<arith::ConstantOp>(op))
+    return 0;
+  if (hasEffect<MemoryEffects::Read>(op))
+    return loadLatency;
+  Type type = op->getNumResults() == 1 ? op->getResult(0).getType() : Type();
+  if (type && isa<FloatType>(getElementTypeOrSelf(type)) &&
+      op->getNumOperands() > 1)
+    return kFloatLatency;
+  return 1;
+}
+
+/// Collects the memory accessed by `op`. Returns failure if `op` has effects
+/// other than reads and writes, or unknown effects.
+static LogicalResult getMemoryAccess(Operation *op, MemoryAccess &access) {
+  access.op = op;
+  if (isMemoryEffectFree(op))
+    return success();
+  auto effectInterface = dyn_cast<MemoryEffectOpInterface>(op);
+  if (!effectInterface || op->getNumRegions() != 0)
+    return failure();
+  SmallVector<MemoryEffects::EffectInstance> effects;
+  effectInterface.getEffects(effects);
+  for (const MemoryEffects::EffectInstance &effect : effects) {
+    if (isa<MemoryEffects::Read>(effect.getEffect()))
+      access.reads.push_back(effect.getValue());
+    else if (isa<MemoryEffects::Write>(effect.getEffect()))
+      access.writes.push_back(effect.getValue());
+    else
+      return failure();
+  }
+  return success();
+}
+
+/// Returns true if the memory accessed by `lhs` and `rhs` may alias.
+static bool mayAlias(ArrayRef<Value> lhs, ArrayRef<Value> rhs,
+                     AliasAnalysis &aliasAnalysis) {
+  return llvm::any_of(lhs, [&](Value a) {
+    return llvm::any_of(rhs, [&](Value b) {
+      return !a || !b || !aliasAnalysis.alias(a, b).isNo();
+    });
+  });
+}
+
+void ForLoopPipelining::computeSchedule(
+    ForOp forOp, AliasAnalysis &aliasAnalysis,
+    std::vector<std::pair<Operation *, unsigned>> &schedule) {
+  Block *body = forOp.getBody();
+  auto isInBody = [&](Value value) {
+    Operation *def = value.getDefiningOp();
+    return def && def->getBlock() == body;
+  };
+  // The pipeliner only forwards the values yielded by ops of the body.
+  if (!llvm::all_of(body->getTerminator()->getOperands(), isInBody))
+    return;
+
+  SmallVector<MemoryAccess> accesses;
+  for (Operation &op : body->without_terminator()) {
+    MemoryAccess access;
+    if (failed(getMemoryAccess(&op, access)))
+      return;
+    if (!access.reads.empty() || !access.writes.empty())
+      accesses.push_back(std::move(access));
+  }
+
+  // Schedule the ops as soon as their operands are available, and compute the
+  // latency of the paths from the iteration arguments.
+  DenseMap<Operation *, unsigned> startTimes;
+  DenseMap<Operation *, unsigned> recurrenceTimes;
+  unsigned numIssuedOps = 0;
+  for (Operation &op : body->without_terminator()) {
+    unsigned start = 0;
+    std::optional<unsigned> recurrenceStart;
+    op.walk([&](Operation *nestedOp) {
+      for (Value operand : nestedOp->getOperands()) {
+        if (auto arg = dyn_cast<BlockArgument>(operand)) {
+          if (arg.getOwner() == body && arg != forOp.getInductionVar())
+            recurrenceStart = recurrenceStart.value_or(0);
+          continue;
+        }
+        Operation *def = operand.getDefiningOp();
+        if (def->getBlock() != body)
+          continue;
+        unsigned ready = startTimes[def] + getLatency(def);
+        start = std::max(start, ready);
+        auto it = recurrenceTimes.find(def);
+        if (it != recurrenceTimes.end())
+          recurrenceStart = std::max(recurrenceStart.value_or(0),
+                                     it->second + getLatency(def));
+      }
+    });
+    startTimes[&op] = start;
+    if (recurrenceStart)
+      recurrenceTimes[&op] = *recurrenceStart;
+    if (getLatency(&op) != 0)
+      ++numIssuedOps;
+  }
+  unsigned initiationInterval = llvm::divideCeil(numIssuedOps, kIssueWidth);
+  for (Value operand : body->getTerminator()->getOperands()) {
+    Operation *def = operand.getDefiningOp();
+    auto it = recurrenceTimes.find(def);
+    if (it != recurrenceTimes.end())
+      initiationInterval =
+          std::max(initiationInterval, it->second + getLatency(def));
+  }
+  initiationInterval = std::max(initiationInterval, 1u);
+
+  DenseMap<Operation *, unsigned> stages;
+  for (Operation &op : body->without_terminator())
+    stages[&op] = std::min(startTimes[&op] / initiationInterval,
+                           numStages > 0 ? numStages - 1 : 0u);
+
+  // Raises the stages of the ops to the stages of their operands.
+  auto propagateStages = [&]() {
+    for (Operation &op : body->without_terminator()) {
+      op.walk([&](Operation *nestedOp) {
+        for (Value operand : nestedOp->getOperands())
+          if (isInBody(operand))
+            stages[&op] =
+                std::max(stages[&op], stages[operand.getDefiningOp()]);
+      });
+    }
+  };
+  // Assigns the latest of their stages to `ops`.
+  auto unifyStages = [&](ArrayRef<Operation *> ops) {
+    unsigned stage = 0;
+    for (Operation *op : ops)
+      stage = std::max(stage, stages[op]);
+    for (Operation *op : ops)
+      stages[op] = stage;
+  };
+
+  // The ops of the recurrences and the ops that define the yielded values
+  // must be in the same stage for the iteration arguments to be produced by
+  // the previous iteration. The memory accesses that may depend on each other
+  // must be in the same stage to execute in the same iteration. As the stages
+  // only increase, unifying the two sets once more after both reaches a fixed
+  // point.
+  SmallVector<Operation *> recurrenceOps;
+  for (Operation &op : body->without_terminator())
+    if (recurrenceTimes.contains(&op))
+      recurrenceOps.push_back(&op);
+  for (Value operand : body->getTerminator()->getOperands())
+    if (!llvm::is_contained(recurrenceOps, operand.getDefiningOp()))
+      recurrenceOps.push_back(operand.getDefiningOp());
+  SmallVector<Operation *> dependentAccessOps;
+  for (const MemoryAccess &access : accesses) {
+    if (llvm::any_of(accesses, [&](const MemoryAccess &other) {
+          return mayAlias(access.writes, other.reads, aliasAnalysis) ||
+                 mayAlias(access.reads, other.writes, aliasAnalysis) ||
+                 mayAlias(access.writes, other.writes, aliasAnalysis);
+        }))
+      dependentAccessOps.push_back(access.op);
+  }
+  propagateStages();
+  for (unsigned i = 0; i < 2; ++i) {
+    unifyStages(recurrenceOps);
+    propagateStages();
+    unifyStages(dependentAccessOps);
+    propagateStages();
+  }
+
+  unsigned maxStage = 0;
+  for (Operation &op : body->without_terminator())
+    maxStage = std::max(maxStage, stages[&op]);
+  if (maxStage == 0)
+    return;
+  auto isUnified = [&](ArrayRef<Operation *> ops) {
+    return llvm::all_of(
+        ops, [&](Operation *op) { return stages[op] == stages[ops.front()]; });
+  };
+  if (!isUnified(recurrenceOps) || !isUnified(dependentAccessOps))
+    return;
+
+  LLVM_DEBUG(llvm::dbgs() << "[" DEBUG_TYPE "] initiation interval "
+                          << initiationInterval << ", " << maxStage + 1
+                          << " stages\n");
+
+  // Issue the later stages first, so that the values they consume are carried
+  // from the previous iteration while the earlier stages issue their loads.
+  for (unsigned stage = maxStage + 1; stage-- > 0;)
+    for (Operation &op : body->without_terminator())
+      if (stages[&op] == stage)
+        schedule.emplace_back(&op, stage);
+}
+
+void ForLoopPipelining::runOnOperation() {
+  AliasAnalysis &aliasAnalysis = getAnalysis<AliasAnalysis>();
+  SmallVector<ForOp> forOps;
+  getOperation()->walk([&](ForOp forOp) {
+    if (!forOp.getBody()
+             ->walk([](ForOp) { return WalkResult::interrupt(); })
+             .wasInterrupted())
+      forOps.push_back(forOp);
+  });
+
+  PipeliningOption options;
+  options.getScheduleFn =
+      [&](ForOp forOp,
+          std::vector<std::pair<Operation *, unsigned>> &schedule) {
+        computeSchedule(forOp, aliasAnalysis, schedule);
+      };
+  IRRewriter rewriter(&getContext());
+  for (ForOp forOp : forOps) {
+    rewriter.setInsertionPoint(forOp);
+    (void)pipelineForLoop(rewriter, forOp, options);
+  }
+}
+
+std::unique_ptr<Pass> mlir::createForLoopPipeliningPass() {
+  return std::make_unique<ForLoopPipelining>();
+}
@@ -0,0 +1,196 @@
+//===- LoopStrengthReduction.cpp - Strength reduce index computations -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass that strength reduces the index computations of
+// scf.for loops, such as the offsets computed by the expansion of the strided
+// metadata of memrefs. An affine.apply that is linear in the induction
+// variable, with a coefficient that is invariant in the loop, is replaced by
+// a loop-carried value that is initialized before the loop and incremented by
+// the product of the coefficient and the step at the end of every iteration.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/SCF/Transforms/Passes.h"
+
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Arith/Utils/Utils.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/SCF/Utils/Utils.h"
+
+namespace mlir {
+#define GEN_PASS_DEF_SCFFORLOOPSTRENGTHREDUCTION
+#include "mlir/Dialect/SCF/Transforms/Passes.h.inc"
+} // namespace mlir
+
+using namespace mlir;
+using namespace mlir::scf;
+
+/// Returns the coefficient of the induction variable in `expr`, in which the
+/// dims and the symbols flagged in `isIv` are the induction variable. The
+/// coefficient is an expression of the other dims and symbols. Returns
+/// failure if `expr` is not linear in the induction variable.
+static FailureOr<AffineExpr> getIvCoefficient(AffineExpr expr,
+                                              ArrayRef<bool> isIvDim,
+                                              ArrayRef<bool> isIvSymbol) {
+  MLIRContext *context = expr.getContext();
+  auto zero = getAffineConstantExpr(0, context);
+  auto one = getAffineConstantExpr(1, context);
+  if (auto dim = expr.dyn_cast<AffineDimExpr>())
+    return isIvDim[dim.getPosition()] ? one : zero;
+  if (auto symbol = expr.dyn_cast<AffineSymbolExpr>())
+    return isIvSymbol[symbol.getPosition()] ? one : zero;
+  auto binary = expr.dyn_cast<AffineBinaryOpExpr>();
+  if (!binary)
+    return zero;
+  FailureOr<AffineExpr> lhs =
+      getIvCoefficient(binary.getLHS(), isIvDim, isIvSymbol);
+  FailureOr<AffineExpr> rhs =
+      getIvCoefficient(binary.getRHS(), isIvDim, isIvSymbol);
+  if (failed(lhs) || failed(rhs))
+    return failure();
+  switch (expr.getKind()) {
+  case AffineExprKind::Add:
+    return *lhs + *rhs;
+  case AffineExprKind::Mul:
+    if (*lhs != zero && *rhs != zero)
+      return failure();
+    return *lhs * binary.getRHS() + *rhs * binary.getLHS();
+  default:
+    // The divisions and the remainders are not linear.
+    if (*lhs != zero || *rhs != zero)
+      return failure();
+    return zero;
+  }
+}
+
+namespace {
+/// An index computation of the body of a loop that is linear in its
+/// induction variable.
+struct InductionExpr {
+  affine::AffineApplyOp applyOp;
+  /// The coefficient of the induction variable, as a map of the operands of
+  /// `applyOp`.
+  AffineMap coefficient;
+};
+
+struct ForLoopStrengthReduction
+    : public impl::SCFForLoopStrengthReductionBase<ForLoopStrengthReduction> {
+  void runOnOperation() override;
+};
+} // namespace
+
+/// Collects the index computations of the body of `forOp` that can be strength
+/// reduced: the affine.apply ops that are linear in the induction variable,
+/// with a coefficient that is not one, and whose other operands are defined
+/// outside of the loop.
+static SmallVector<InductionExpr> collectInductionExprs(ForOp forOp) {
+  SmallVector<InductionExpr> exprs;
+  Value iv = forOp.getInductionVar();
+  for (Operation &op : *forOp.getBody()) {
+    auto applyOp = dyn_cast<affine::AffineApplyOp>(&op);
+    if (!applyOp || !llvm::is_contained(applyOp->getOperands(), iv))
+      continue;
+    if (!llvm::all_of(applyOp->getOperands(), [&](Value operand) {
+          return operand == iv || forOp.isDefinedOutsideOfLoop(operand);
+        }))
+      continue;
+    AffineMap map = applyOp.getAffineMap();
+    SmallVector<bool> isIvDim, isIvSymbol;
+    for (Value operand : applyOp.getDimOperands())
+      isIvDim.push_back(operand == iv);
+    for (Value operand : applyOp.getSymbolOperands())
+      isIvSymbol.push_back(operand == iv);
+    FailureOr<AffineExpr> coefficient =
+        getIvCoefficient(map.getResult(0), isIvDim, isIvSymbol);
+    if (failed(coefficient))
+      continue;
+    AffineExpr simplified = simplifyAffineExpr(
+        *coefficient, map.getNumDims(), map.getNumSymbols());
+    // An increment by one costs as much as the addition of the induction
+    // variable.
+    auto constant = simplified.dyn_cast<AffineConstantExpr>();
+    if (constant && (constant.getValue() == 0 || constant.getValue() == 1))
+      continue;
+    exprs.push_back({applyOp, AffineMap::get(map.getNumDims(),
+                                             map.getNumSymbols(), simplified)});
+  }
+  return exprs;
+}
+
+/// Replaces the index computations `exprs` of the body of `forOp` with
+/// loop-carried values.
+static void strengthReduce(ForOp forOp, ArrayRef<InductionExpr> exprs) {
+  OpBuilder builder(forOp);
+  Location loc = forOp.getLoc();
+  Value iv = forOp.getInductionVar();
+  SmallVector<Value> inits, increments;
+  for (const InductionExpr &expr : exprs) {
+    // The operands of the computation before the loop, where the induction
+    // variable is the lower bound.
+    SmallVector<OpFoldResult> operands;
+    for (Value operand : expr.applyOp->getOperands())
+      operands.push_back(operand == iv ? forOp.getLowerBound() : operand);
+    inits.push_back(getValueOrCreateConstantIndexOp(
+        builder, loc,
+        affine::makeComposedFoldedAffineApply(
+            builder, loc, expr.applyOp.getAffineMap(), operands)));
+
+    // The increment is the product of the coefficient and the step, hoisted
+    // out of the loop.
+    AffineMap coefficient = expr.coefficient;
+    AffineMap incrementMap = AffineMap::get(
+        coefficient.getNumDims(), coefficient.getNumSymbols() + 1,
+        coefficient.getResult(0) *
+            getAffineSymbolExpr(coefficient.getNumSymbols(),
+                                builder.getContext()));
+    operands.push_back(forOp.getStep());
+    increments.push_back(getValueOrCreateConstantIndexOp(
+        builder, loc,
+        affine::makeComposedFoldedAffineApply(builder, loc, incrementMap,
+                                              operands)));
+  }
+
+  auto yieldIncrements = [&](OpBuilder &b, Location yieldLoc,
+                             ArrayRef<BlockArgument> newBBArgs) {
+    SmallVector<Value> yields;
+    for (auto it : llvm::zip(newBBArgs, increments))
+      yields.push_back(b.create<arith::AddIOp>(yieldLoc, std::get<0>(it),
+                                               std::get<1>(it)));
+    return yields;
+  };
+  IRRewriter rewriter(forOp->getContext());
+  rewriter.setInsertionPoint(forOp);
+  ForOp newForOp =
+      replaceLoopWithNewYields(rewriter, forOp, inits, yieldIncrements,
+                               /*replaceIterOperandsUsesInLoop=*/false);
+  unsigned firstArg = newForOp.getNumRegionIterArgs() - exprs.size();
+  for (auto it : llvm::enumerate(exprs)) {
+    affine::AffineApplyOp applyOp = it.value().applyOp;
+    rewriter.replaceOp(applyOp,
+                       newForOp.getRegionIterArgs()[firstArg + it.index()]);
+  }
+  rewriter.eraseOp(forOp);
+}
+
+void ForLoopStrengthReduction::runOnOperation() {
+  // Collect the loops first, as the rewrite replaces them.
+  SmallVector<ForOp> forOps;
+  getOperation()->walk([&](ForOp forOp) { forOps.push_back(forOp); });
+  for (ForOp forOp : forOps) {
+    if (!forOp.getInductionVar().getType().isIndex())
+      continue;
+    SmallVector<InductionExpr> exprs = collectInductionExprs(forOp);
+    if (!exprs.empty())
+      strengthReduce(forOp, exprs);
+  }
+}
+
+std::unique_ptr<Pass> mlir::createForLoopStrengthReductionPass() {
+  return std::make_unique<ForLoopStrengthReduction>();
+}
@@ -676,6 +676,10 @@ mlir::scf::tileConsumerAndFuseProducerGreedilyUsingSCFForOp(
   if (tileAndFuseResult.loops.empty())
     return tileAndFuseResult;
 
+  // The untiled values whose replacements are yielded by the outermost loop,
+  // in the order of its results.
+  SmallVector<Value> yieldedValues(consumer->getResults());
+
   // 2. Typically, the operands of the tiled operation are slices of the
   //    operands of the untiled operation. These are expressed in IR using
   //    `tensor.extract_slice` operations with source being the operands of the
@@ -698,6 +702,17 @@ mlir::scf::tileConsumerAndFuseProducerGreedilyUsingSCFForOp(
     tensor::ExtractSliceOp candidateSliceOp = candidates.front();
     candidates.pop_front();
 
+    // Check whether the producer is to be fused, and yielded.
+    auto [originalProducer, destinationIterArg] =
+        getUntiledProducerFromSliceSource(&candidateSliceOp->getOpOperand(0),
+                                          tileAndFuseResult.loops);
+    if (!originalProducer)
+      continue;
+    auto [shouldFuse, shouldYield] = options.fusionControlFn(
+        candidateSliceOp, originalProducer, destinationIterArg.has_value());
+    if (!shouldFuse)
+      continue;
+
     // The operands of the fused producer might themselved be slices of
     // values produced by operations that implement the `TilingInterface`.
     // Add these operations to the worklist.
@@ -707,12 +722,26 @@ mlir::scf::tileConsumerAndFuseProducerGreedilyUsingSCFForOp(
     if (!fusedProducer)
       continue;
 
+    if (shouldYield && !llvm::is_contained(yieldedValues, originalProducer)) {
+      yieldReplacementForFusedProducer(rewriter, candidateSliceOp,
+                                       fusedProducer.value(),
+                                       tileAndFuseResult.loops);
+      yieldedValues.push_back(originalProducer);
+    }
+
     if (Operation *tiledAndFusedOp =
             fusedProducer->tiledAndFusedProducer.getDefiningOp()) {
       tileAndFuseResult.tiledAndFusedOps.insert(tiledAndFusedOp);
       addCandidateSlices(tiledAndFusedOp, candidates);
     }
   }
+
+  // Yielding values replaces the loops, so the replacements are taken from
+  // the final outermost loop.
+  scf::ForOp outermostLoop = tileAndFuseResult.loops.front();
+  for (auto [index, yieldedValue] : llvm::enumerate(yieldedValues))
+    tileAndFuseResult.replacements[yieldedValue] =
+        outermostLoop.getResult(index);
   return tileAndFuseResult;
 }
 
@@ -11,6 +11,7 @@
 #include "mlir/Conversion/GPUToNVVM/GPUToNVVMPass.h"
 #include "mlir/Conversion/Passes.h"
 #include "mlir/Dialect/Arith/Transforms/Passes.h"
+#include "mlir/Dialect/Async/Passes.h"
 #include "mlir/Dialect/Bufferization/Transforms/Bufferize.h"
 #include "mlir/Dialect/Bufferization/Transforms/OneShotAnalysis.h"
 #include "mlir/Dialect/Bufferization/Transforms/Passes.h"
@@ -73,12 +74,30 @@ void mlir::sparse_tensor::buildSparseCompiler(
   // GPU code generation.
   const bool gpuCodegen = options.gpuTriple.hasValue();
   if (gpuCodegen) {
-    pm.addPass(createSparseGPUCodegenPass());
+    pm.addPass(createSparseGPUCodegenPass(/*numThreads=*/1024,
+                                          options.gpuRowMapping));
     pm.addNestedPass<gpu::GPUModuleOp>(createStripDebugInfoPass());
     pm.addNestedPass<gpu::GPUModuleOp>(createConvertSCFToCFPass());
     pm.addNestedPass<gpu::GPUModuleOp>(createLowerGpuOpsToNVVMOpsPass());
   }
 
+  // Lower the remaining parallel loops to a threaded runtime. Otherwise,
+  // they are sequentialized along with the other SCF loops below.
+  switch (options.parallelizationBackend) {
+  case SparseParallelizationBackend::kNone:
+    break;
+  case SparseParallelizationBackend::kOpenMP:
+    pm.addPass(createConvertSCFToOpenMPPass());
+    break;
+  case SparseParallelizationBackend::kAsync:
+    pm.addPass(createAsyncParallelForPass());
+    pm.addPass(createAsyncToAsyncRuntimePass());
+    pm.addPass(createAsyncRuntimeRefCountingPass());
+    pm.addPass(createAsyncRuntimeRefCountingOptPass());
+    pm.addPass(createConvertAsyncToLLVMPass());
+    break;
+  }
+
   // TODO(springerm): Add sparse support to the BufferDeallocation pass and add
   // it to this pipeline.
   pm.addNestedPass<func::FuncOp>(createConvertLinalgToLoopsPass());
@@ -98,6 +117,8 @@ void mlir::sparse_tensor::buildSparseCompiler(
   pm.addPass(createConvertComplexToLLVMPass());
   pm.addPass(createConvertVectorToLLVMPass(options.lowerVectorToLLVMOptions()));
   pm.addPass(createConvertFuncToLLVMPass());
+  if (options.parallelizationBackend == SparseParallelizationBackend::kOpenMP)
+    pm.addPass(createConvertOpenMPToLLVMPass());
 
   // Finalize GPU code generation.
   if (gpuCodegen) {
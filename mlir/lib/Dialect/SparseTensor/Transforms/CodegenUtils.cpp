@@ -18,6 +18,8 @@
 #include "mlir/IR/Matchers.h"
 #include "mlir/IR/Types.h"
 #include "mlir/IR/Value.h"
+#include <algorithm>
+#include <cmath>
 #include <optional>
 
 using namespace mlir;
@@ -428,6 +430,15 @@ Value mlir::sparse_tensor::allocaBuffer(OpBuilder &builder, Location loc,
   return buffer;
 }
 
+TypedValue<BaseMemRefType>
+mlir::sparse_tensor::genToMemref(OpBuilder &builder, Location loc,
+                                 Value tensor) {
+  auto tTp = llvm::cast<TensorType>(tensor.getType());
+  auto mTp = MemRefType::get(tTp.getShape(), tTp.getElementType());
+  return builder.create<bufferization::ToMemrefOp>(loc, mTp, tensor)
+      .getResult();
+}
+
 Value mlir::sparse_tensor::allocDenseTensor(OpBuilder &builder, Location loc,
                                             RankedTensorType tensorTp,
                                             ValueRange sizes) {
@@ -719,3 +730,96 @@ Value sparse_tensor::createOrFoldSliceStrideOp(OpBuilder &builder, Location loc,
     return constantIndex(builder, loc, *stride);
   return builder.create<ToSliceStrideOp>(loc, tensor, APInt(64, dim));
 }
+
+//===----------------------------------------------------------------------===//
+// Density estimates.
+//===----------------------------------------------------------------------===//
+
+/// The density and the size of a level assumed in the absence of estimates.
+static constexpr double kDefaultDensity = 0.01;
+static constexpr double kDefaultLvlSize = 1024;
+
+double sparse_tensor::getEstimatedDensity(Operation *op,
+                                          unsigned operandNumber) {
+  auto densities = op->getAttrOfType<ArrayAttr>(getDensityAttrName());
+  if (!densities || densities.size() != op->getNumOperands())
+    return kDefaultDensity;
+  auto density = densities[operandNumber].dyn_cast<FloatAttr>();
+  if (!density)
+    return kDefaultDensity;
+  return std::clamp(density.getValueAsDouble(), 0.0, 1.0);
+}
+
+/// Returns the static level sizes of `stt`, with the default estimate for
+/// the dynamic sizes and those of the non-permutations.
+static SmallVector<double> getEstimatedLvlSizes(SparseTensorType stt) {
+  const Level lvlRank = stt.getLvlRank();
+  SmallVector<double> lvlSizes(lvlRank, kDefaultLvlSize);
+  if (!stt.isPermutation())
+    return lvlSizes;
+  for (Level l = 0; l < lvlRank; l++) {
+    // FIXME: `toOrigDim` is deprecated.
+    const DynSize sz = stt.getDimShape()[toOrigDim(stt.getEncoding(), l)];
+    if (!ShapedType::isDynamic(sz))
+      lvlSizes[l] = sz;
+  }
+  return lvlSizes;
+}
+
+double sparse_tensor::getEstimatedLvlTripCount(SparseTensorType stt,
+                                               Level lvl, double density) {
+  const Level lvlRank = stt.getLvlRank();
+  assert(lvl < lvlRank);
+  const SmallVector<double> lvlSizes = getEstimatedLvlSizes(stt);
+  if (stt.isSingletonLvl(lvl))
+    return 1;
+  // The fraction of the coordinates of the levels up to `l` that lead to
+  // a nonzero, for the uniform spread, is 1 - (1 - density)^n where n is
+  // the number of elements below them.
+  auto nonEmptyFraction = [&](Level l) {
+    if (density >= 1)
+      return 1.0;
+    double numBelow = 1;
+    for (Level k = l + 1; k < lvlRank; k++)
+      numBelow *= lvlSizes[k];
+    return -std::expm1(numBelow * std::log1p(-density));
+  };
+  // The fraction of the coordinates stored at the parent level, where the
+  // dense levels store all the coordinates below their parent.
+  double parentFraction = 1;
+  for (Level l = 0; l < lvl; l++)
+    if (!stt.isDenseLvl(l))
+      parentFraction = nonEmptyFraction(l);
+  if (stt.isDenseLvl(lvl))
+    return lvlSizes[lvl];
+  if (parentFraction <= 0)
+    return 0;
+  return lvlSizes[lvl] * nonEmptyFraction(lvl) / parentFraction;
+}
+
+SmallVector<DimLevelType> sparse_tensor::suggestLvlTypes(SparseTensorType stt,
+                                                         double density) {
+  const auto enc = stt.getEncoding();
+  const Level lvlRank = stt.getLvlRank();
+  const SmallVector<double> lvlSizes = getEstimatedLvlSizes(stt);
+  SmallVector<DimLevelType> lvlTypes(enc.getLvlTypes());
+  if (!llvm::all_of(lvlTypes, [](DimLevelType dlt) {
+        return isDenseDLT(dlt) || isCompressedDLT(dlt);
+      }))
+    return {};
+  for (Level l = 0; l + 1 < lvlRank; l++) {
+    // Estimate the level as compressed, below the levels decided so far.
+    if (isDenseDLT(lvlTypes[l]))
+      lvlTypes[l] = DimLevelType::Compressed;
+    const auto candidate = stt.withEncoding(SparseTensorEncodingAttr::get(
+        enc.getContext(), lvlTypes, enc.getDimToLvl(), enc.getPosWidth(),
+        enc.getCrdWidth()));
+    const double tripCount = getEstimatedLvlTripCount(candidate, l, density);
+    // A compressed level stores a position and a coordinate per stored
+    // coordinate, where a dense level stores nothing but makes the level
+    // below it store a position per coordinate.
+    if (2 * tripCount >= lvlSizes[l])
+      lvlTypes[l] = DimLevelType::Dense;
+  }
+  return lvlTypes;
+}
@@ -19,6 +19,7 @@
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/SparseTensor/IR/Enums.h"
 #include "mlir/Dialect/SparseTensor/IR/SparseTensor.h"
+#include "mlir/Dialect/SparseTensor/IR/SparseTensorType.h"
 #include "mlir/Dialect/Utils/ReshapeOpsUtils.h"
 #include "mlir/IR/Builders.h"
 
@@ -210,6 +211,11 @@ Value genAllocaScalar(OpBuilder &builder, Location loc, Type tp);
 /// size of the buffer).
 Value allocaBuffer(OpBuilder &builder, Location loc, ValueRange values);
 
+/// Generates a `bufferization.to_memref` of the given tensor, with the
+/// identity layout.
+TypedValue<BaseMemRefType> genToMemref(OpBuilder &builder, Location loc,
+                                       Value tensor);
+
 /// Generates code to allocate a buffer of the given type, and zero
 /// initialize it.  If the buffer type has any dynamic sizes, then the
 /// `sizes` parameter should be as filled by sizesFromPtr(); that way
@@ -448,6 +454,40 @@ Value createOrFoldSliceOffsetOp(OpBuilder &builder, Location loc, Value tensor,
 /// return a constant if the offset is statically known.
 Value createOrFoldSliceStrideOp(OpBuilder &builder, Location loc, Value tensor,
                                 Dimension dim);
+
+//===----------------------------------------------------------------------===//
+// Density estimates.
+//===----------------------------------------------------------------------===//
+
+/// Returns the name of the attribute of a sparse kernel that supplies the
+/// estimated densities of its operands at compile time: an array with one
+/// float in [0, 1] per operand, whose entries for the dense operands are
+/// ignored.
+constexpr llvm::StringLiteral getDensityAttrName() {
+  return llvm::StringLiteral("sparse_tensor.density");
+}
+
+/// Returns the estimated density of the operand `operandNumber` of `op`,
+/// as supplied by its density attribute.  Returns a default estimate if
+/// `op` has no valid density attribute.
+double getEstimatedDensity(Operation *op, unsigned operandNumber);
+
+/// Returns the estimated number of coordinates stored at the level `lvl`
+/// below each position of the parent level, for a sparse tensor of type
+/// `stt` whose nonzeros are spread uniformly with the given `density`.
+/// The dynamic sizes are replaced by a default estimate.
+double getEstimatedLvlTripCount(SparseTensorType stt, Level lvl,
+                                double density);
+
+/// Returns the level types that would store a sparse tensor of type `stt`
+/// with the fewest overhead, for the given `density`: each level but the
+/// last is dense if at least half of its coordinates are estimated to be
+/// stored, and compressed otherwise, keeping the properties of the
+/// compressed levels of `stt`. Returns an empty vector if `stt` has levels
+/// other than dense and compressed ones.
+SmallVector<DimLevelType> suggestLvlTypes(SparseTensorType stt,
+                                          double density);
+
 } // namespace sparse_tensor
 } // namespace mlir
 
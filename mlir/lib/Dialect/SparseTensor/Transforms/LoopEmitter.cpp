@@ -219,6 +219,67 @@ Value LoopEmitter::genSegmentHigh(OpBuilder &builder, Location loc,
   return whileOp.getResult(0);
 }
 
+Value LoopEmitter::genGallopingSearch(OpBuilder &builder, Location loc,
+                                      TensorId tid, Level lvl, Value pLo,
+                                      Value pHi, Value crd) {
+  const auto coordinates = coordinatesBuffers[tid][lvl];
+  const Value one = C_IDX(1);
+  // Doubles the step until it overshoots `crd` (or the level bound).
+  auto gallopOp = builder.create<scf::WhileOp>(
+      loc, TypeRange{builder.getIndexType(), builder.getIndexType()},
+      ValueRange{pLo, one},
+      /*beforeBuilder=*/
+      [pHi, coordinates, crd](OpBuilder &builder, Location loc,
+                              ValueRange ivs) {
+        Value probe = ADDI(ivs[0], ivs[1]);
+        Value inBound = CMPI(ult, probe, pHi);
+        auto ifInBound =
+            builder.create<scf::IfOp>(loc, builder.getI1Type(), inBound, true);
+        {
+          OpBuilder::InsertionGuard guard(builder);
+          // Load the probed coordinate only when inbound (to avoid OOB
+          // accesses).
+          builder.setInsertionPointToStart(ifInBound.thenBlock());
+          Value probeCrd = genIndexLoad(builder, loc, coordinates, probe);
+          YIELD(CMPI(ult, probeCrd, crd));
+          builder.setInsertionPointToStart(ifInBound.elseBlock());
+          YIELD(constantI1(builder, loc, false));
+        }
+        builder.create<scf::ConditionOp>(loc, ifInBound.getResults()[0], ivs);
+      },
+      /*afterBuilder=*/
+      [](OpBuilder &builder, Location loc, ValueRange ivs) {
+        // pLo += step, step *= 2
+        Value nextLo = ADDI(ivs[0], ivs[1]);
+        Value nextStep = ADDI(ivs[1], ivs[1]);
+        YIELD((ValueRange{nextLo, nextStep}));
+      });
+  const Value lo = gallopOp.getResult(0);
+  const Value probe = ADDI(lo, gallopOp.getResult(1));
+  const Value hi = builder.create<arith::MinUIOp>(loc, probe, pHi);
+  // Bisects the window (lo, hi], whose last position is known to hold the
+  // first coordinate no less than `crd`.
+  auto bisectOp = builder.create<scf::WhileOp>(
+      loc, TypeRange{builder.getIndexType(), builder.getIndexType()},
+      ValueRange{lo, hi},
+      /*beforeBuilder=*/
+      [](OpBuilder &builder, Location loc, ValueRange ivs) {
+        Value cond = CMPI(ult, ADDI(ivs[0], C_IDX(1)), ivs[1]);
+        builder.create<scf::ConditionOp>(loc, cond, ivs);
+      },
+      /*afterBuilder=*/
+      [coordinates, crd](OpBuilder &builder, Location loc, ValueRange ivs) {
+        Value mid = builder.create<arith::ShRUIOp>(
+            loc, ADDI(ivs[0], ivs[1]), C_IDX(1));
+        Value midCrd = genIndexLoad(builder, loc, coordinates, mid);
+        Value isLess = CMPI(ult, midCrd, crd);
+        Value nextLo = SELECT(isLess, mid, ivs[0]);
+        Value nextHi = SELECT(isLess, ivs[1], mid);
+        YIELD((ValueRange{nextLo, nextHi}));
+      });
+  return bisectOp.getResult(1);
+}
+
 Value LoopEmitter::genSparseCrd(OpBuilder &builder, Location loc, TensorId tid,
                                 Level dstLvl) {
   Value crd = C_IDX(0);
@@ -1054,7 +1115,7 @@ bool LoopEmitter::shouldIteratedByForLoop(ArrayRef<TensorLvlCond> sparseConds,
 Operation *LoopEmitter::enterCoIterationOverTensorsAtLvls(
     OpBuilder &builder, Location loc, ArrayRef<TensorLevel> tidLvls,
     MutableArrayRef<Value> reduc, bool tryParallel, bool genDedup,
-    bool needsUniv) {
+    bool needsUniv, bool genGallop) {
 #ifndef NDEBUG
   // Sanity checks.
   assert(!tidLvls.empty());
@@ -1132,7 +1193,7 @@ Operation *LoopEmitter::enterCoIterationOverTensorsAtLvls(
 
   // Pushes the loop into stack.
   loopStack.emplace_back(trivialLvls, sliceDrivenInfo, l,
-                         builder.getInsertionBlock(), iv, loopTag);
+                         builder.getInsertionBlock(), iv, loopTag, genGallop);
   return l;
 }
 
@@ -1443,6 +1504,32 @@ void LoopEmitter::exitWhileLoop(OpBuilder &builder, Location loc,
     posits[tid][lvl] = whileOp->getResult(o++);
   };
 
+  // When the loop body only consumes the intersection of the levels, no
+  // level can meet the others before the maximum coordinate, and so the
+  // lagging levels can gallop straight to it instead of advancing one
+  // position per iteration.  This is restricted to unique levels that are
+  // neither collapsed nor sliced, and to loops without a universal index.
+  Value maxCrd;
+  const bool canGallop =
+      loopInfo.genGallop && loopInfo.sliceDrivenInfo.empty() &&
+      loopInfo.trivialTidLvls.size() > 1 &&
+      whileOp.getNumResults() ==
+          loopInfo.trivialTidLvls.size() + reduc.size() &&
+      llvm::all_of(loopInfo.trivialTidLvls, [this](TensorLevel tidLvl) {
+        const auto [tid, lvl] = unpackTensorLevel(tidLvl);
+        const auto lvlTp = lvlTypes[tid][lvl];
+        return !isSparseSlices[tid] && isUniqueDLT(lvlTp) &&
+               getCollapseReassociation(tid, lvl).size() == 1 &&
+               (isCompressedDLT(lvlTp) || isSingletonDLT(lvlTp) ||
+                isCompressedWithHiDLT(lvlTp));
+      });
+  if (canGallop) {
+    for (auto [tid, lvl] : unpackTensorLevelRange(loopInfo.trivialTidLvls)) {
+      const Value crd = coords[tid][lvl];
+      maxCrd = maxCrd ? SELECT(CMPI(ugt, crd, maxCrd), crd, maxCrd) : crd;
+    }
+  }
+
   for (auto [tid, dstLvl] : unpackTensorLevelRange(loopInfo.trivialTidLvls)) {
     const auto lvlTp = lvlTypes[tid][dstLvl];
     if (isCompressedDLT(lvlTp) || isSingletonDLT(lvlTp) ||
@@ -1466,7 +1553,20 @@ void LoopEmitter::exitWhileLoop(OpBuilder &builder, Location loc,
                       ? segHi[tid][reassoc.back()]
                       : ADDI(pos, one);
 
-      operands.push_back(SELECT(cmp, add, pos));
+      Value nxPos = SELECT(cmp, add, pos);
+      if (maxCrd) {
+        Value isBehind = CMPI(ult, crd, maxCrd);
+        auto ifBehind = builder.create<scf::IfOp>(loc, builder.getIndexType(),
+                                                  isBehind, true);
+        OpBuilder::InsertionGuard guard(builder);
+        builder.setInsertionPointToStart(ifBehind.thenBlock());
+        YIELD(genGallopingSearch(builder, loc, tid, dstLvl, pos,
+                                 highs[tid][dstLvl], maxCrd));
+        builder.setInsertionPointToStart(ifBehind.elseBlock());
+        YIELD(nxPos);
+        nxPos = ifBehind.getResult(0);
+      }
+      operands.push_back(nxPos);
       // Following loops continue iteration from the break point of the
       // current while loop.
       const Value newPos = whileOp->getResult(o++);
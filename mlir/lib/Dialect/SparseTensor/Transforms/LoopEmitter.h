@@ -174,10 +174,13 @@ public:
   /// tensor_tid_[0, lvl - 1] have already been generated.
   /// The function will also perform in-place update on the `reduc` vector to
   /// return the reduction variable used inside the generated loop.
+  /// Setting `genGallop` asserts that the loop body only consumes the
+  /// coordinates at which all the sparse levels intersect, which allows
+  /// the emitter to forward the lagging levels by a galloping search.
   Operation *enterCoIterationOverTensorsAtLvls(
       OpBuilder &builder, Location loc, ArrayRef<TensorLevel> tidLvls,
       MutableArrayRef<Value> reduc = {}, bool isParallel = false,
-      bool genDedup = false, bool needsUniv = false);
+      bool genDedup = false, bool needsUniv = false, bool genGallop = false);
 
   /// Generates code to exit the current loop (e.g., generates yields, forwards
   /// loop induction variables, etc).
@@ -290,9 +293,10 @@ private:
   struct LoopInfo final {
     LoopInfo(ArrayRef<TensorLevel> trivialTidLvls,
              ArrayRef<SliceLoopInfo> sliceDrivenInfo, Operation *loop,
-             Block *userBlock, Value iv, StringAttr loopTag)
+             Block *userBlock, Value iv, StringAttr loopTag,
+             bool genGallop = false)
         : trivialTidLvls(trivialTidLvls), sliceDrivenInfo(sliceDrivenInfo),
-          loop(loop), userCodeBlock(userBlock), iv(iv) {
+          loop(loop), userCodeBlock(userBlock), iv(iv), genGallop(genGallop) {
       // Attached a special tag to loop emitter generated loop.
       if (loopTag)
         loop->setAttr(LoopEmitter::getLoopEmitterLoopAttrName(), loopTag);
@@ -308,6 +312,8 @@ private:
     const Operation *loop;      // the loop operation
     Block *const userCodeBlock; // the block holding users' generated code.
     const Value iv;             // the induction variable for the loop
+    // Whether the levels may be forwarded by a galloping search.
+    const bool genGallop;
   };
 
   // SliceInfo stores information of an extracted slice for slice-driven loop.
@@ -442,6 +448,21 @@ private:
   Value genSegmentHigh(OpBuilder &builder, Location loc, TensorId tid,
                        Level lvl, Value pos, Value pHi);
 
+  /// Generates a galloping search for the first position in `(pLo, pHi)`
+  /// whose coordinate is no less than `crd`, provided that the coordinate
+  /// at `pLo` is less than `crd`.  That is, it generates the code:
+  ///
+  ///   step = 1
+  ///   while (pLo + step < pHi && coordinates_tid_lvl[pLo + step] < crd)
+  ///      pLo += step, step *= 2;
+  ///   r = min(pLo + step, pHi)
+  ///   while (pLo + 1 < r)
+  ///      m = (pLo + r) / 2
+  ///      if (coordinates_tid_lvl[m] < crd) pLo = m; else r = m;
+  ///   <return r>;
+  Value genGallopingSearch(OpBuilder &builder, Location loc, TensorId tid,
+                           Level lvl, Value pLo, Value pHi, Value crd);
+
   /// Generates instructions to compute the coordinate of tensors[tid][lvl]
   /// under the current loop context.  The final argument is the
   /// collapsed-output level, whereas this function handles converting
@@ -1387,30 +1387,128 @@ private:
   bool enableBufferInitialization;
 };
 
+/// Returns the name suffix of the runtime sort entries for the values of type
+/// `tp` that are permuted along with the keys, or an empty string if the
+/// runtime library has no such entry.
+static StringRef getRuntimeSortSuffix(Type tp) {
+  if (tp.isF64())
+    return "F64";
+  if (tp.isF32())
+    return "F32";
+  if (tp.isInteger(64))
+    return "I64";
+  if (tp.isInteger(32))
+    return "I32";
+  return "";
+}
+
+/// Returns true if `buffer` can be passed to the runtime sort entries, which
+/// expect contiguous buffers.
+static bool isRuntimeSortBuffer(Value buffer) {
+  return getMemRefType(buffer).getLayout().isIdentity();
+}
+
+/// Casts `buffer` to the buffer of dynamic size expected by the runtime sort
+/// entries, whose declarations are shared by all the calls.
+static Value castToRuntimeSortBuffer(OpBuilder &builder, Location loc,
+                                     Value buffer) {
+  MemRefType mtp = getMemRefType(buffer);
+  auto dynTp = MemRefType::get({ShapedType::kDynamic}, mtp.getElementType(),
+                               MemRefLayoutAttrInterface(),
+                               mtp.getMemorySpace());
+  if (mtp == dynTp)
+    return buffer;
+  return builder.create<memref::CastOp>(loc, dynTp, buffer);
+}
+
+/// Rewrites a sort of `n` records of `nx` index keys followed by `ny` other
+/// indices in `xy`, and of at most one buffer of values in `ys`, to a call of
+/// the parallel sort of the runtime library.
+static LogicalResult rewriteToRuntimeSortCOO(Operation *op, Value n, Value xy,
+                                             ValueRange ys, uint64_t nx,
+                                             uint64_t ny,
+                                             PatternRewriter &rewriter) {
+  if (!getMemRefType(xy).getElementType().isIndex() ||
+      !isRuntimeSortBuffer(xy) || ys.size() > 1)
+    return failure();
+  std::string name = "sortCOO";
+  if (!ys.empty()) {
+    StringRef suffix =
+        getRuntimeSortSuffix(getMemRefType(ys[0]).getElementType());
+    if (suffix.empty() || !isRuntimeSortBuffer(ys[0]))
+      return failure();
+    name += suffix;
+  }
+  Location loc = op->getLoc();
+  SmallVector<Value> operands{n, constantIndex(rewriter, loc, nx),
+                              constantIndex(rewriter, loc, ny),
+                              castToRuntimeSortBuffer(rewriter, loc, xy)};
+  if (!ys.empty())
+    operands.push_back(castToRuntimeSortBuffer(rewriter, loc, ys[0]));
+  createFuncCall(rewriter, loc, name, TypeRange(), operands,
+                 EmitCInterface::On);
+  rewriter.eraseOp(op);
+  return success();
+}
+
+/// Rewrites a sort of a single buffer of keys to a call of the runtime
+/// library: a radix sort for the keys alone, which the stable sorts of the
+/// operator also allow, and a parallel sort otherwise.
+static LogicalResult rewriteToRuntimeSort(SortOp op,
+                                          PatternRewriter &rewriter) {
+  if (op.getXs().size() != 1)
+    return failure();
+  Value x = op.getXs().front();
+  Type keyTp = getMemRefType(x).getElementType();
+  if (!op.getYs().empty() || !isRuntimeSortBuffer(x))
+    return rewriteToRuntimeSortCOO(op, op.getN(), x, op.getYs(), /*nx=*/1,
+                                   /*ny=*/0, rewriter);
+  // The keys are compared as unsigned integers, as in the generated code.
+  StringRef suffix;
+  if (keyTp.isIndex())
+    suffix = "Index";
+  else if (keyTp.isInteger(64))
+    suffix = "U64";
+  else if (keyTp.isInteger(32))
+    suffix = "U32";
+  else
+    return failure();
+  Location loc = op.getLoc();
+  createFuncCall(rewriter, loc, ("radixSort" + suffix).str(), TypeRange(),
+                 {op.getN(), castToRuntimeSortBuffer(rewriter, loc, x)},
+                 EmitCInterface::On);
+  rewriter.eraseOp(op);
+  return success();
+}
+
 /// Sparse rewriting rule for the sort operator.
 struct SortRewriter : public OpRewritePattern<SortOp> {
 public:
-  using OpRewritePattern<SortOp>::OpRewritePattern;
+  SortRewriter(MLIRContext *context, bool enableRuntimeSort)
+      : OpRewritePattern(context), enableRuntimeSort(enableRuntimeSort) {}
 
   LogicalResult matchAndRewrite(SortOp op,
                                 PatternRewriter &rewriter) const override {
+    if (enableRuntimeSort && succeeded(rewriteToRuntimeSort(op, rewriter)))
+      return success();
     SmallVector<Value> xys(op.getXs());
     xys.append(op.getYs().begin(), op.getYs().end());
     return matchAndRewriteSortOp(op, xys, op.getXs().size(), /*ny=*/0,
                                  /*isCoo=*/false, rewriter);
   }
+
+private:
+  bool enableRuntimeSort;
 };
 
 /// Sparse rewriting rule for the sort_coo operator.
 struct SortCooRewriter : public OpRewritePattern<SortCooOp> {
 public:
-  using OpRewritePattern<SortCooOp>::OpRewritePattern;
+  SortCooRewriter(MLIRContext *context, bool enableRuntimeSort)
+      : OpRewritePattern(context), enableRuntimeSort(enableRuntimeSort) {}
 
   LogicalResult matchAndRewrite(SortCooOp op,
                                 PatternRewriter &rewriter) const override {
-    SmallVector<Value> xys;
-    xys.push_back(op.getXy());
-    xys.append(op.getYs().begin(), op.getYs().end());
     uint64_t nx = 1;
     if (auto nxAttr = op.getNxAttr())
       nx = nxAttr.getInt();
@@ -1419,9 +1517,20 @@ public:
     if (auto nyAttr = op.getNyAttr())
       ny = nyAttr.getInt();
 
+    if (enableRuntimeSort &&
+        succeeded(rewriteToRuntimeSortCOO(op, op.getN(), op.getXy(),
+                                          op.getYs(), nx, ny, rewriter)))
+      return success();
+
+    SmallVector<Value> xys;
+    xys.push_back(op.getXy());
+    xys.append(op.getYs().begin(), op.getYs().end());
     return matchAndRewriteSortOp(op, xys, nx, ny,
                                  /*isCoo=*/true, rewriter);
   }
+
+private:
+  bool enableRuntimeSort;
 };
 
 } // namespace
@@ -1431,8 +1540,10 @@ public:
 //===---------------------------------------------------------------------===//
 
 void mlir::populateSparseBufferRewriting(RewritePatternSet &patterns,
-                                         bool enableBufferInitialization) {
+                                         bool enableBufferInitialization,
+                                         bool enableRuntimeSort) {
   patterns.add<PushBackRewriter>(patterns.getContext(),
                                  enableBufferInitialization);
-  patterns.add<SortRewriter, SortCooRewriter>(patterns.getContext());
+  patterns.add<SortRewriter, SortCooRewriter>(patterns.getContext(),
+                                              enableRuntimeSort);
 }
@@ -27,12 +27,16 @@
 #include "mlir/Dialect/SparseTensor/Transforms/Passes.h"
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/Matchers.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
 
 using namespace mlir;
 using namespace mlir::sparse_tensor;
 
 namespace {
 
+// The number of threads in a warp shuffle.
+constexpr unsigned kWarpSize = 32;
+
 //===----------------------------------------------------------------------===//
 // Helper methods.
 //===----------------------------------------------------------------------===//
@@ -185,6 +189,48 @@ static Value genAllocCopy(OpBuilder &builder, Location loc, Value b,
   return devMem;
 }
 
+/// Generates an alloc/copy pair for a buffer of a library call. With pinned
+/// DMA, the host buffer is registered first, and its cast is recorded in
+/// `pinned` to be unregistered once the library calls complete.
+static Value genAllocCopy(OpBuilder &builder, Location loc, Value b,
+                          SmallVectorImpl<Value> &tokens,
+                          GPUDataTransferStrategy strategy,
+                          SmallVectorImpl<Value> &pinned) {
+  if (strategy == GPUDataTransferStrategy::kPinnedDMA)
+    pinned.push_back(genHostRegisterMemref(builder, loc, b));
+  return genAllocCopy(builder, loc, b, tokens);
+}
+
+/// Generates the first wait of the library calls after the copies of
+/// `tokens`. With pinned DMA, the calls depend on the copies on the device.
+/// Otherwise, the host blocks until the copies complete.
+static Value genWaitForCopies(OpBuilder &builder, Location loc,
+                              SmallVectorImpl<Value> &tokens,
+                              GPUDataTransferStrategy strategy) {
+  Value token;
+  if (strategy == GPUDataTransferStrategy::kPinnedDMA) {
+    Type tokenType = builder.getType<gpu::AsyncTokenType>();
+    token = builder.create<gpu::WaitOp>(loc, tokenType, tokens).getAsyncToken();
+  } else {
+    genBlockingWait(builder, loc, tokens);
+    token = genFirstWait(builder, loc);
+  }
+  tokens.clear();
+  return token;
+}
+
+/// Generates the last, blocking wait of the library calls, and then
+/// unregisters the host buffers in `pinned`.
+static void genWaitForCalls(OpBuilder &builder, Location loc,
+                            SmallVectorImpl<Value> &tokens,
+                            SmallVectorImpl<Value> &pinned) {
+  genBlockingWait(builder, loc, tokens);
+  tokens.clear();
+  for (Value cast : pinned)
+    genHostUnregisterMemref(builder, loc, cast);
+  pinned.clear();
+}
+
 /// Generates a memref from tensor operation.
 static Value genTensorToMemref(PatternRewriter &rewriter, Location loc,
                                Value tensor) {
@@ -250,11 +296,161 @@ static void genParametersOut(OpBuilder &builder, Location loc, Value out,
 }
 
 /// Constructs code for new GPU kernel.
+/// Returns the scf.for in the body of the forall loop that computes a sum
+/// reduction which may be split between the lanes of a warp, or a null
+/// loop otherwise. This requires that the body consists of loads, stores,
+/// and pure computations around a single unit-stride loop, which carries a
+/// single integral or floating-point partial sum as the only side-effect.
+static scf::ForOp getWarpReducibleLoop(scf::ParallelOp forallOp) {
+  scf::ForOp redLoop;
+  for (Operation &op : forallOp.getBody()->without_terminator()) {
+    if (auto forOp = dyn_cast<scf::ForOp>(op)) {
+      if (redLoop)
+        return scf::ForOp();
+      redLoop = forOp;
+    } else if (!isMemoryEffectFree(&op) &&
+               !isa<memref::LoadOp, memref::StoreOp>(op)) {
+      return scf::ForOp();
+    }
+  }
+  if (!redLoop || redLoop.getNumIterOperands() != 1 ||
+      !matchPattern(redLoop.getStep(), m_One()))
+    return scf::ForOp();
+  Type tp = redLoop.getResult(0).getType();
+  if (!tp.isInteger(32) && !tp.isInteger(64) && !tp.isF32() && !tp.isF64())
+    return scf::ForOp();
+  // The yielded value must add to the partial sum, which is used nowhere else.
+  Value sum = redLoop.getRegionIterArgs()[0];
+  Operation *def = cast<scf::YieldOp>(redLoop.getBody()->getTerminator())
+                       .getOperand(0)
+                       .getDefiningOp();
+  if (!def || !isa<arith::AddFOp, arith::AddIOp>(def) || !sum.hasOneUse() ||
+      (def->getOperand(0) != sum && def->getOperand(1) != sum))
+    return scf::ForOp();
+  // The loop body may read memory, but not write it.
+  WalkResult result = redLoop.getBody()->walk([](Operation *op) {
+    if (isMemoryEffectFree(op) || isa<memref::LoadOp>(op) ||
+        op->hasTrait<OpTrait::HasRecursiveMemoryEffects>())
+      return WalkResult::advance();
+    return WalkResult::interrupt();
+  });
+  return result.wasInterrupted() ? scf::ForOp() : redLoop;
+}
+
+/// Returns the positions buffer of the level iterated by the forall loop,
+/// recognized by the loads at the induction variable `i` and at `i + 1`
+/// in its body, or a null value if no such buffer is found.
+static Value getRowPositions(scf::ParallelOp forallOp) {
+  Value iv = forallOp.getInductionVars()[0];
+  SmallVector<Value> lower; // buffers loaded at `i`
+  for (auto load : forallOp.getBody()->getOps<memref::LoadOp>()) {
+    if (load.getIndices().size() != 1 ||
+        !load.getMemRefType().getElementType().isIntOrIndex())
+      continue;
+    Value idx = load.getIndices()[0];
+    if (idx == iv) {
+      lower.push_back(load.getMemRef());
+      continue;
+    }
+    auto add = idx.getDefiningOp<arith::AddIOp>();
+    if (add && ((add.getLhs() == iv && matchPattern(add.getRhs(), m_One())) ||
+                (add.getRhs() == iv && matchPattern(add.getLhs(), m_One()))) &&
+        llvm::is_contained(lower, load.getMemRef()))
+      return load.getMemRef();
+  }
+  return Value();
+}
+
+/// Generates a binary search for the first row `r` in `[0, N]` of which
+/// the position `positions[r]` is at least `target`.
+static Value genRowLowerBound(OpBuilder &builder, Location loc,
+                              Value positions, Value numRows, Value target) {
+  Value zero = constantIndex(builder, loc, 0);
+  Value one = constantIndex(builder, loc, 1);
+  Type idxTp = builder.getIndexType();
+  scf::WhileOp whileOp = builder.create<scf::WhileOp>(
+      loc, TypeRange{idxTp, idxTp}, ValueRange{zero, numRows},
+      [](OpBuilder &b, Location l, ValueRange args) {
+        Value cond = b.create<arith::CmpIOp>(l, arith::CmpIPredicate::ult,
+                                             args[0], args[1]);
+        b.create<scf::ConditionOp>(l, cond, args);
+      },
+      [&](OpBuilder &b, Location l, ValueRange args) {
+        Value lo = args[0], hi = args[1];
+        Value mid = b.create<arith::ShRUIOp>(
+            l, b.create<arith::AddIOp>(l, lo, hi), one);
+        Value pos = genIndexLoad(b, l, positions, mid);
+        Value lt =
+            b.create<arith::CmpIOp>(l, arith::CmpIPredicate::ult, pos, target);
+        Value nextLo = b.create<arith::SelectOp>(
+            l, lt, b.create<arith::AddIOp>(l, mid, one), lo);
+        Value nextHi = b.create<arith::SelectOp>(l, lt, hi, mid);
+        b.create<scf::YieldOp>(l, ValueRange{nextLo, nextHi});
+      });
+  return whileOp.getResult(0);
+}
+
+/// Splits the sum reduction of the given loop in the body of a row loop
+/// between the lanes of a warp. Each lane accumulates every `kWarpSize`-th
+/// term into a partial sum, after which a butterfly of shuffles leaves the
+/// total in every lane, and only the first lane writes the results.
+static void genWarpReduction(OpBuilder &builder, Location loc,
+                             scf::ForOp redLoop, Value lane) {
+  Block *rowBody = redLoop->getBlock();
+  Value init = redLoop.getIterOperands()[0];
+  Type tp = init.getType();
+  bool isFloat = isa<FloatType>(tp);
+  builder.setInsertionPoint(redLoop);
+  Value zero = constantZero(builder, loc, tp);
+  redLoop.setLowerBound(
+      builder.create<arith::AddIOp>(loc, redLoop.getLowerBound(), lane));
+  redLoop.setStep(constantIndex(builder, loc, kWarpSize));
+  redLoop->setOperand(redLoop.getNumControlOperands(), zero);
+  builder.setInsertionPointAfter(redLoop);
+  auto genAdd = [&](Value lhs, Value rhs) -> Value {
+    if (isFloat)
+      return builder.create<arith::AddFOp>(loc, lhs, rhs);
+    return builder.create<arith::AddIOp>(loc, lhs, rhs);
+  };
+  Value partial = redLoop.getResult(0);
+  Value sum = partial;
+  for (unsigned offset = kWarpSize / 2; offset > 0; offset /= 2) {
+    Value other = builder
+                      .create<gpu::ShuffleOp>(loc, sum, offset, kWarpSize,
+                                              gpu::ShuffleMode::XOR)
+                      .getShuffleResult();
+    sum = genAdd(sum, other);
+  }
+  Value total = genAdd(init, sum);
+  partial.replaceUsesWithIf(total, [&](OpOperand &use) {
+    Operation *user = rowBody->findAncestorOpInBlock(*use.getOwner());
+    return user && total.getDefiningOp()->isBeforeInBlock(user);
+  });
+  // Guard the writes of the row by the first lane.
+  builder.setInsertionPointToStart(rowBody);
+  Value isFirst = builder.create<arith::CmpIOp>(
+      loc, arith::CmpIPredicate::eq, lane, constantIndex(builder, loc, 0));
+  for (auto store :
+       llvm::make_early_inc_range(rowBody->getOps<memref::StoreOp>())) {
+    builder.setInsertionPoint(store);
+    auto ifOp = builder.create<scf::IfOp>(loc, isFirst, /*else=*/false);
+    store->moveBefore(ifOp.thenBlock()->getTerminator());
+  }
+}
+
+/// Constructs the body of the GPU kernel from the forall loop, where the
+/// iterations of the loop are mapped onto the threads as follows.
+///   thread-per-row: for (r = row; r < N; r += inc)
+///   warp-per-row:   for (r = row / W; r < N; r += inc / W),
+///                   with the reduction loop split between the W lanes
+///   merge-path:     for (r = rStart; r < rEnd; r++)
+/// The admissibility of the mapping has been verified by the caller.
 static void genGPUCode(PatternRewriter &rewriter, gpu::GPUFuncOp gpuFunc,
                        scf::ParallelOp forallOp,
                        SmallVectorImpl<Value> &constants,
                        SmallVectorImpl<Value> &scalars,
-                       SmallVectorImpl<Value> &buffers) {
+                       SmallVectorImpl<Value> &buffers,
+                       SparseGPURowMapping rowMapping, Value positions) {
   Location loc = gpuFunc->getLoc();
   Block &block = gpuFunc.getBody().front();
   rewriter.setInsertionPointToStart(&block);
@@ -288,9 +484,51 @@ static void genGPUCode(PatternRewriter &rewriter, gpu::GPUFuncOp gpuFunc,
   //     <loop-body>
   //   }
   Value upper = irMap.lookup(forallOp.getUpperBound()[0]);
+  Value lane;
+  switch (rowMapping) {
+  case SparseGPURowMapping::kThreadPerRow:
+    break;
+  case SparseGPURowMapping::kWarpPerRow: {
+    // Since the block size is a multiple of the warp size, the lanes
+    // of each warp are consecutive threads that agree on the row.
+    Value wsz = constantIndex(rewriter, loc, kWarpSize);
+    lane = rewriter.create<arith::RemUIOp>(loc, row, wsz);
+    row = rewriter.create<arith::DivUIOp>(loc, row, wsz);
+    inc = rewriter.create<arith::DivUIOp>(loc, inc, wsz);
+    break;
+  }
+  case SparseGPURowMapping::kMergePath: {
+    // Split the nonzeros evenly between the threads, and assign to each
+    // thread the rows that start within its share, so that the thread
+    // with the last share also gets the trailing empty rows.
+    //   rStart = lowerBound(P, row * nnz / inc)
+    //   rEnd   = row + 1 == inc ? N : lowerBound(P, (row + 1) * nnz / inc)
+    Value pos = irMap.lookup(positions);
+    Value one = constantIndex(rewriter, loc, 1);
+    Value nnz = genIndexLoad(rewriter, loc, pos, upper);
+    Value next = rewriter.create<arith::AddIOp>(loc, row, one);
+    Value lo = rewriter.create<arith::DivUIOp>(
+        loc, rewriter.create<arith::MulIOp>(loc, row, nnz), inc);
+    Value hi = rewriter.create<arith::DivUIOp>(
+        loc, rewriter.create<arith::MulIOp>(loc, next, nnz), inc);
+    Value isLast = rewriter.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::eq, next, inc);
+    Value rStart = genRowLowerBound(rewriter, loc, pos, upper, lo);
+    Value rEnd = genRowLowerBound(rewriter, loc, pos, upper, hi);
+    row = rStart;
+    upper = rewriter.create<arith::SelectOp>(loc, isLast, upper, rEnd);
+    inc = one;
+    break;
+  }
+  }
   scf::ForOp forOp = rewriter.create<scf::ForOp>(loc, row, upper, inc);
   rewriter.cloneRegionBefore(forallOp.getLoopBody(), forOp.getLoopBody(),
                              forOp.getLoopBody().begin(), irMap);
+  if (lane) {
+    Value res = getWarpReducibleLoop(forallOp).getResult(0);
+    auto redLoop = irMap.lookup(res).getDefiningOp<scf::ForOp>();
+    genWarpReduction(rewriter, loc, redLoop, lane);
+  }
 
   // Done.
   rewriter.setInsertionPointAfter(forOp);
@@ -457,12 +695,14 @@ static Operation *genSpMat(OpBuilder &builder, Location loc, Type handleTp,
 
 /// Match and rewrite SpMV kernel.
 static LogicalResult rewriteSpMV(PatternRewriter &rewriter,
-                                 linalg::GenericOp op, bool enableRT) {
+                                 linalg::GenericOp op, bool enableRT,
+                                 GPUDataTransferStrategy strategy) {
   Location loc = op.getLoc();
   Value a = op.getOperand(0);
   Value x = op.getOperand(1);
   Value y = op.getOperand(2); // we have y = Ax
   SmallVector<Value> tokens;
+  SmallVector<Value> pinned;
 
   // Only admissible sparse matrix format and dense vectors.
   bool isCOO = false;
@@ -482,22 +722,22 @@ static LogicalResult rewriteSpMV(PatternRewriter &rewriter,
   Value memR = genFirstPosOrCrds(rewriter, loc, a, isCOO, enableRT);
   Value memC = genSecondCrds(rewriter, loc, a, isCOO, enableRT);
   Value memV = genToValues(rewriter, loc, a);
-  Value rowA = genAllocCopy(rewriter, loc, memR, tokens);
-  Value colA = memC ? genAllocCopy(rewriter, loc, memC, tokens) : Value();
-  Value valA = genAllocCopy(rewriter, loc, memV, tokens);
+  Value rowA = genAllocCopy(rewriter, loc, memR, tokens, strategy, pinned);
+  Value colA =
+      memC ? genAllocCopy(rewriter, loc, memC, tokens, strategy, pinned)
+           : Value();
+  Value valA = genAllocCopy(rewriter, loc, memV, tokens, strategy, pinned);
   Value memX = genTensorToMemref(rewriter, loc, x);
-  Value vecX = genAllocCopy(rewriter, loc, memX, tokens);
+  Value vecX = genAllocCopy(rewriter, loc, memX, tokens, strategy, pinned);
   Value memY = genTensorToMemref(rewriter, loc, y);
-  Value vecY = genAllocCopy(rewriter, loc, memY, tokens);
-  genBlockingWait(rewriter, loc, tokens);
-  tokens.clear();
+  Value vecY = genAllocCopy(rewriter, loc, memY, tokens, strategy, pinned);
 
   // Create sparse environment and sparse matrix/dense vector handles.
   Type indexTp = rewriter.getIndexType();
   Type dnTensorHandleTp = rewriter.getType<gpu::SparseDnTensorHandleType>();
   Type spmatHandleTp = rewriter.getType<gpu::SparseSpMatHandleType>();
   Type tokenTp = rewriter.getType<gpu::AsyncTokenType>();
-  Value token = genFirstWait(rewriter, loc);
+  Value token = genWaitForCopies(rewriter, loc, tokens, strategy);
   Operation *spGenA =
       genSpMat(rewriter, loc, spmatHandleTp, tokenTp, token, szY, szX, nseA,
                rowA, colA, valA, isCOO, enableRT);
@@ -545,8 +785,7 @@ static LogicalResult rewriteSpMV(PatternRewriter &rewriter,
   token = genCopyMemRef(rewriter, loc, memY, vecY, token);
   token = genDeallocMemRef(rewriter, loc, vecY, token);
   tokens.push_back(token);
-  genBlockingWait(rewriter, loc, tokens);
-  tokens.clear();
+  genWaitForCalls(rewriter, loc, tokens, pinned);
 
   // Done.
   rewriter.replaceOpWithNewOp<bufferization::ToTensorOp>(op, memY);
@@ -555,12 +794,14 @@ static LogicalResult rewriteSpMV(PatternRewriter &rewriter,
 
 /// Match and rewrite SpMM kernel.
 static LogicalResult rewriteSpMM(PatternRewriter &rewriter,
-                                 linalg::GenericOp op, bool enableRT) {
+                                 linalg::GenericOp op, bool enableRT,
+                                 GPUDataTransferStrategy strategy) {
   Location loc = op.getLoc();
   Value a = op.getOperand(0);
   Value b = op.getOperand(1);
   Value c = op.getOperand(2); // we have C = AB
   SmallVector<Value> tokens;
+  SmallVector<Value> pinned;
 
   // Only admissible sparse matrix format and dense matrices.
   bool isCOO = false;
@@ -581,22 +822,22 @@ static LogicalResult rewriteSpMM(PatternRewriter &rewriter,
   Value memR = genFirstPosOrCrds(rewriter, loc, a, isCOO, enableRT);
   Value memC = genSecondCrds(rewriter, loc, a, isCOO, enableRT);
   Value memV = genToValues(rewriter, loc, a);
-  Value rowA = genAllocCopy(rewriter, loc, memR, tokens);
-  Value colA = memC ? genAllocCopy(rewriter, loc, memC, tokens) : Value();
-  Value valA = genAllocCopy(rewriter, loc, memV, tokens);
+  Value rowA = genAllocCopy(rewriter, loc, memR, tokens, strategy, pinned);
+  Value colA =
+      memC ? genAllocCopy(rewriter, loc, memC, tokens, strategy, pinned)
+           : Value();
+  Value valA = genAllocCopy(rewriter, loc, memV, tokens, strategy, pinned);
   Value bufB = genTensorToMemref(rewriter, loc, b);
-  Value matB = genAllocCopy(rewriter, loc, bufB, tokens);
+  Value matB = genAllocCopy(rewriter, loc, bufB, tokens, strategy, pinned);
   Value bufC = genTensorToMemref(rewriter, loc, c);
-  Value matC = genAllocCopy(rewriter, loc, bufC, tokens);
-  genBlockingWait(rewriter, loc, tokens);
-  tokens.clear();
+  Value matC = genAllocCopy(rewriter, loc, bufC, tokens, strategy, pinned);
 
   // Create sparse environment and sparse matrix/dense matrix handles.
   Type indexTp = rewriter.getIndexType();
   Type dnTensorHandleTp = rewriter.getType<gpu::SparseDnTensorHandleType>();
   Type spMatHandleTp = rewriter.getType<gpu::SparseSpMatHandleType>();
   Type tokenTp = rewriter.getType<gpu::AsyncTokenType>();
-  Value token = genFirstWait(rewriter, loc);
+  Value token = genWaitForCopies(rewriter, loc, tokens, strategy);
   Operation *spGenA =
       genSpMat(rewriter, loc, spMatHandleTp, tokenTp, token, szm, szk, nseA,
                rowA, colA, valA, isCOO, enableRT);
@@ -639,6 +880,7 @@ static LogicalResult rewriteSpMM(PatternRewriter &rewriter,
               .getAsyncToken();
   token = rewriter.create<gpu::DestroyDnTensorOp>(loc, tokenTp, token, dnC)
               .getAsyncToken();
+  token = genDeallocMemRef(rewriter, loc, rowA, token);
   if (colA)
     token = genDeallocMemRef(rewriter, loc, colA, token);
   token = genDeallocMemRef(rewriter, loc, valA, token);
@@ -647,8 +889,7 @@ static LogicalResult rewriteSpMM(PatternRewriter &rewriter,
   token = genCopyMemRef(rewriter, loc, bufC, matC, token);
   token = genDeallocMemRef(rewriter, loc, matC, token);
   tokens.push_back(token);
-  genBlockingWait(rewriter, loc, tokens);
-  tokens.clear();
+  genWaitForCalls(rewriter, loc, tokens, pinned);
 
   // Done.
   rewriter.replaceOpWithNewOp<bufferization::ToTensorOp>(op, bufC);
@@ -657,12 +898,14 @@ static LogicalResult rewriteSpMM(PatternRewriter &rewriter,
 
 /// Match and rewrite SDDMM kernel.
 static LogicalResult rewriteSDDMM(PatternRewriter &rewriter,
-                                  linalg::GenericOp op, bool enableRT) {
+                                  linalg::GenericOp op, bool enableRT,
+                                  GPUDataTransferStrategy strategy) {
   Location loc = op.getLoc();
   Value a = op.getOperand(0);
   Value b = op.getOperand(1);
   Value c = op.getOperand(2);
   SmallVector<Value> tokens;
+  SmallVector<Value> pinned;
 
   // Only admissible sparse matrix format and dense matrices, no COO.
   bool isCOO = false;
@@ -684,24 +927,24 @@ static LogicalResult rewriteSDDMM(PatternRewriter &rewriter,
   Value szk = linalg::createOrFoldDimOp(rewriter, loc, a, 1);
   Value szn = linalg::createOrFoldDimOp(rewriter, loc, b, 1);
   Value bufA = genTensorToMemref(rewriter, loc, a);
-  Value matA = genAllocCopy(rewriter, loc, bufA, tokens);
+  Value matA = genAllocCopy(rewriter, loc, bufA, tokens, strategy, pinned);
   Value bufB = genTensorToMemref(rewriter, loc, b);
-  Value matB = genAllocCopy(rewriter, loc, bufB, tokens);
+  Value matB = genAllocCopy(rewriter, loc, bufB, tokens, strategy, pinned);
   Value memR = genFirstPosOrCrds(rewriter, loc, c, isCOO, enableRT);
   Value memC = genSecondCrds(rewriter, loc, c, isCOO, enableRT);
   Value memV = genToValues(rewriter, loc, c);
-  Value rowC = genAllocCopy(rewriter, loc, memR, tokens);
-  Value colC = memC ? genAllocCopy(rewriter, loc, memC, tokens) : Value();
-  Value valC = genAllocCopy(rewriter, loc, memV, tokens);
-  genBlockingWait(rewriter, loc, tokens);
-  tokens.clear();
+  Value rowC = genAllocCopy(rewriter, loc, memR, tokens, strategy, pinned);
+  Value colC =
+      memC ? genAllocCopy(rewriter, loc, memC, tokens, strategy, pinned)
+           : Value();
+  Value valC = genAllocCopy(rewriter, loc, memV, tokens, strategy, pinned);
 
   // Create sparse environment and sparse matrix/dense matrix handles.
   Type indexTp = rewriter.getIndexType();
   Type dnMatHandleTp = rewriter.getType<gpu::SparseDnTensorHandleType>();
   Type spMatHandleTp = rewriter.getType<gpu::SparseSpMatHandleType>();
   Type tokenTp = rewriter.getType<gpu::AsyncTokenType>();
-  Value token = genFirstWait(rewriter, loc);
+  Value token = genWaitForCopies(rewriter, loc, tokens, strategy);
   auto dmatA = rewriter.create<gpu::CreateDnTensorOp>(
       loc, dnMatHandleTp, tokenTp, token, matA, SmallVector<Value>{szm, szk});
   Value dnA = dmatA.getResult(0);
@@ -748,8 +991,7 @@ static LogicalResult rewriteSDDMM(PatternRewriter &rewriter,
   token = genCopyMemRef(rewriter, loc, memV, valC, token);
   token = genDeallocMemRef(rewriter, loc, valC, token);
   tokens.push_back(token);
-  genBlockingWait(rewriter, loc, tokens);
-  tokens.clear();
+  genWaitForCalls(rewriter, loc, tokens, pinned);
 
   // Done.
   rewriter.replaceOpWithNewOp<sparse_tensor::LoadOp>(op, c);
@@ -767,8 +1009,8 @@ static LogicalResult rewriteSDDMM(PatternRewriter &rewriter,
 struct ForallRewriter : public OpRewritePattern<scf::ParallelOp> {
   using OpRewritePattern<scf::ParallelOp>::OpRewritePattern;
 
-  ForallRewriter(MLIRContext *context, unsigned nT)
-      : OpRewritePattern(context), numThreads(nT){};
+  ForallRewriter(MLIRContext *context, unsigned nT, SparseGPURowMapping m)
+      : OpRewritePattern(context), numThreads(nT), rowMapping(m){};
 
   LogicalResult matchAndRewrite(scf::ParallelOp forallOp,
                                 PatternRewriter &rewriter) const override {
@@ -782,6 +1024,16 @@ struct ForallRewriter : public OpRewritePattern<scf::ParallelOp> {
         !matchPattern(forallOp.getLowerBound()[0], m_Zero()) ||
         !matchPattern(forallOp.getStep()[0], m_One()))
       return failure();
+    // Fall back to one thread per row when the loop is not admissible
+    // for the selected mapping.
+    SparseGPURowMapping mapping = rowMapping;
+    Value positions;
+    if (mapping == SparseGPURowMapping::kWarpPerRow &&
+        (numThreads % kWarpSize != 0 || !getWarpReducibleLoop(forallOp)))
+      mapping = SparseGPURowMapping::kThreadPerRow;
+    if (mapping == SparseGPURowMapping::kMergePath &&
+        !(positions = getRowPositions(forallOp)))
+      mapping = SparseGPURowMapping::kThreadPerRow;
     // Collect every value that is computed outside the parallel loop.
     SetVector<Value> invariants; // stable iteration!
     forallOp->walk([&](Operation *op) {
@@ -827,7 +1079,8 @@ struct ForallRewriter : public OpRewritePattern<scf::ParallelOp> {
     ModuleOp topModule = forallOp->getParentOfType<ModuleOp>();
     auto gpuModule = genGPUModule(rewriter, topModule);
     auto gpuFunc = genGPUFunc(rewriter, gpuModule, args);
-    genGPUCode(rewriter, gpuFunc, forallOp, constants, scalars, buffers);
+    genGPUCode(rewriter, gpuFunc, forallOp, constants, scalars, buffers,
+               mapping, positions);
     // Generate code that launches the kernel asynchronously, blocking on all
     // opens tokens and yielding a new token for the output.
     // TODO: Passing in tokens to launch up does not seem to be properly lowered
@@ -856,6 +1109,7 @@ private:
   }
 
   unsigned numThreads;
+  SparseGPURowMapping rowMapping;
 };
 
 //===----------------------------------------------------------------------===//
@@ -867,8 +1121,8 @@ private:
 struct LinalgOpRewriter : public OpRewritePattern<linalg::GenericOp> {
   using OpRewritePattern<linalg::GenericOp>::OpRewritePattern;
 
-  LinalgOpRewriter(MLIRContext *context, bool rt)
-      : OpRewritePattern(context), enableRT(rt) {}
+  LinalgOpRewriter(MLIRContext *context, bool rt, GPUDataTransferStrategy t)
+      : OpRewritePattern(context), enableRT(rt), gpuDataTransferStrategy(t) {}
 
   LogicalResult matchAndRewrite(linalg::GenericOp op,
                                 PatternRewriter &rewriter) const override {
@@ -894,7 +1148,7 @@ struct LinalgOpRewriter : public OpRewritePattern<linalg::GenericOp> {
         linalg::isReductionIterator(iteratorTypes[1]) &&
         // TODO: add transposed {i, j}
         maps == infer({{i, j}, {j}, {i}}) && matchSumOfMultOfArgs(op)) {
-      return rewriteSpMV(rewriter, op, enableRT);
+      return rewriteSpMV(rewriter, op, enableRT, gpuDataTransferStrategy);
     }
 
     // Recognize a SpMM kernel.
@@ -905,7 +1159,7 @@ struct LinalgOpRewriter : public OpRewritePattern<linalg::GenericOp> {
         // TODO: add transposed {i, k}, {k, j}
         // TODO: maybe add transposed {i, j} in future
         maps == infer({{i, k}, {k, j}, {i, j}}) && matchSumOfMultOfArgs(op)) {
-      return rewriteSpMM(rewriter, op, enableRT);
+      return rewriteSpMM(rewriter, op, enableRT, gpuDataTransferStrategy);
     }
 
     // Recognize a SDDMM kernel.
@@ -917,7 +1171,7 @@ struct LinalgOpRewriter : public OpRewritePattern<linalg::GenericOp> {
         // TODO: maybe add transposed {i, j} in future
         maps == infer({{i, k}, {k, j}, {i, j}}) &&
         matchSumReductionOfMulUnary(op)) {
-      return rewriteSDDMM(rewriter, op, enableRT);
+      return rewriteSDDMM(rewriter, op, enableRT, gpuDataTransferStrategy);
     }
 
     return failure();
@@ -925,6 +1179,7 @@ struct LinalgOpRewriter : public OpRewritePattern<linalg::GenericOp> {
 
 private:
   bool enableRT;
+  GPUDataTransferStrategy gpuDataTransferStrategy;
 };
 
 } // namespace
@@ -940,11 +1195,14 @@ private:
 //===----------------------------------------------------------------------===//
 
 void mlir::populateSparseGPUCodegenPatterns(RewritePatternSet &patterns,
-                                            unsigned numThreads) {
-  patterns.add<ForallRewriter>(patterns.getContext(), numThreads);
+                                            unsigned numThreads,
+                                            SparseGPURowMapping rowMapping) {
+  patterns.add<ForallRewriter>(patterns.getContext(), numThreads, rowMapping);
 }
 
-void mlir::populateSparseGPULibgenPatterns(RewritePatternSet &patterns,
-                                           bool enableRT) {
-  patterns.add<LinalgOpRewriter>(patterns.getContext(), enableRT);
+void mlir::populateSparseGPULibgenPatterns(
+    RewritePatternSet &patterns, bool enableRT,
+    GPUDataTransferStrategy gpuDataTransferStrategy) {
+  patterns.add<LinalgOpRewriter>(patterns.getContext(), enableRT,
+                                 gpuDataTransferStrategy);
 }
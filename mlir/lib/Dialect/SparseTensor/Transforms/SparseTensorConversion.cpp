@@ -697,6 +697,36 @@ public:
   }
 };
 
+/// Decomposes the `l`th result of the `dimToLvl` mapping of a permutation
+/// or blocked format (such as BSR) into its dimension `d` and level kind.
+/// The result is either `d`, or `d floordiv b` for the level holding the
+/// blocks of `d`, or `d mod b` for the level holding the coordinates within
+/// those blocks, where `b` is returned as the `blockSize`.  Returns failure
+/// for any other expression.
+static LogicalResult decomposeLvlExpr(AffineMap dimToLvl, Level l,
+                                      Dimension &dim, uint64_t &blockSize,
+                                      bool &isWithinBlock) {
+  const AffineExpr expr = dimToLvl.getResult(l);
+  blockSize = 0;
+  isWithinBlock = false;
+  if (const auto dimExpr = expr.dyn_cast<AffineDimExpr>()) {
+    dim = dimExpr.getPosition();
+    return success();
+  }
+  const auto binExpr = expr.dyn_cast<AffineBinaryOpExpr>();
+  if (!binExpr || (binExpr.getKind() != AffineExprKind::FloorDiv &&
+                   binExpr.getKind() != AffineExprKind::Mod))
+    return failure();
+  const auto dimExpr = binExpr.getLHS().dyn_cast<AffineDimExpr>();
+  const auto sizeExpr = binExpr.getRHS().dyn_cast<AffineConstantExpr>();
+  if (!dimExpr || !sizeExpr || sizeExpr.getValue() <= 0)
+    return failure();
+  dim = dimExpr.getPosition();
+  blockSize = sizeExpr.getValue();
+  isWithinBlock = binExpr.getKind() == AffineExprKind::Mod;
+  return success();
+}
+
 /// Sparse conversion rule for the new operator.
 class SparseTensorNewConverter : public OpConversionPattern<NewOp> {
 public:
@@ -710,6 +740,38 @@ public:
       return failure();
     const Dimension dimRank = stt.getDimRank();
     const Level lvlRank = stt.getLvlRank();
+    // Decompose the `dimToLvl` mapping, which may split a dimension `d` into
+    // the levels `d floordiv b` and `d mod b` of a blocked format.  Which the
+    // runtime infers from `d` occurring twice in `lvlToDim`, with the block
+    // size `b` as the level-size of the second occurrence.
+    SmallVector<Dimension> lvlDims(lvlRank);
+    SmallVector<uint64_t> lvlBlockSizes(lvlRank);
+    SmallVector<bool> lvlIsWithinBlock(lvlRank);
+    if (!stt.isIdentity()) {
+      const auto dimToLvl = stt.getDimToLvl();
+      SmallVector<uint64_t> dimBlockSizes(dimRank, 0);
+      SmallVector<unsigned> dimNumLvls(dimRank, 0);
+      for (Level l = 0; l < lvlRank; l++) {
+        Dimension d;
+        bool isWithinBlock;
+        if (failed(decomposeLvlExpr(dimToLvl, l, d, lvlBlockSizes[l],
+                                    isWithinBlock)))
+          return rewriter.notifyMatchFailure(op, "unsupported dimToLvl");
+        lvlDims[l] = d;
+        lvlIsWithinBlock[l] = isWithinBlock;
+        // The blocks of each blocked dimension must come first, followed by
+        // the coordinates within the blocks of the same size.
+        const unsigned numLvls = ++dimNumLvls[d];
+        if (numLvls == 1 && !isWithinBlock)
+          dimBlockSizes[d] = lvlBlockSizes[l];
+        else if (numLvls != 2 || !isWithinBlock ||
+                 dimBlockSizes[d] != lvlBlockSizes[l])
+          return rewriter.notifyMatchFailure(op, "unsupported dimToLvl");
+      }
+      for (Dimension d = 0; d < dimRank; d++)
+        if (dimNumLvls[d] != (dimBlockSizes[d] ? 2 : 1))
+          return rewriter.notifyMatchFailure(op, "unsupported dimToLvl");
+    }
     // Construct the dimShape.
     SmallVector<Value> dimShapeValues = getDimShape(rewriter, loc, stt);
     Value dimShapeBuffer = allocaBuffer(rewriter, loc, dimShapeValues);
@@ -729,10 +791,6 @@ public:
     // compile-time.  If dimShape is dynamic, then we'll need to generate
     // code for computing lvlSizes from the `reader`'s actual dimSizes.
     //
-    // TODO: For now we're still assuming `dimToLvl` is a permutation.
-    // But since we're computing lvlSizes here (rather than in the runtime),
-    // we can easily generalize that simply by adjusting this code.
-    //
     // FIXME: reduce redundancy vs `NewCallParams::genBuffers`.
     Value dimSizesBuffer;
     if (stt.hasDynamicDimShape()) {
@@ -747,24 +805,37 @@ public:
     Value lvlToDimBuffer;
     Value dimToLvlBuffer;
     if (!stt.isIdentity()) {
-      const auto dimToLvl = stt.getDimToLvl();
-      assert(dimToLvl.isPermutation() && "Got non-permutation");
       // We preinitialize `dimToLvlValues` since we need random-access writing.
       // And we preinitialize the others for stylistic consistency.
       SmallVector<Value> lvlSizeValues(lvlRank);
       SmallVector<Value> lvlToDimValues(lvlRank);
       SmallVector<Value> dimToLvlValues(dimRank);
       for (Level l = 0; l < lvlRank; l++) {
-        // The `d`th source variable occurs in the `l`th result position.
-        Dimension d = dimToLvl.getDimPosition(l);
+        // The `d`th source variable occurs in the `l`th result position,
+        // and maps to the first of its levels when blocked.
+        const Dimension d = lvlDims[l];
+        const uint64_t blockSize = lvlBlockSizes[l];
         Value lvl = constantIndex(rewriter, loc, l);
         Value dim = constantIndex(rewriter, loc, d);
-        dimToLvlValues[d] = lvl;
+        if (!dimToLvlValues[d])
+          dimToLvlValues[d] = lvl;
         lvlToDimValues[l] = dim;
-        lvlSizeValues[l] =
-            stt.isDynamicDim(d)
-                ? rewriter.create<memref::LoadOp>(loc, dimSizesBuffer, dim)
-                : dimShapeValues[d];
+        if (lvlIsWithinBlock[l]) {
+          lvlSizeValues[l] = constantIndex(rewriter, loc, blockSize);
+        } else if (stt.isDynamicDim(d)) {
+          Value dimSize =
+              rewriter.create<memref::LoadOp>(loc, dimSizesBuffer, dim);
+          if (blockSize)
+            dimSize = rewriter.create<arith::CeilDivUIOp>(
+                loc, dimSize, constantIndex(rewriter, loc, blockSize));
+          lvlSizeValues[l] = dimSize;
+        } else {
+          const uint64_t dimSize = stt.getDimShape()[d];
+          lvlSizeValues[l] =
+              blockSize ? constantIndex(rewriter, loc,
+                                        (dimSize + blockSize - 1) / blockSize)
+                        : dimShapeValues[d];
+        }
       }
       lvlSizesBuffer = allocaBuffer(rewriter, loc, lvlSizeValues);
       lvlToDimBuffer = allocaBuffer(rewriter, loc, lvlToDimValues);
@@ -828,9 +899,58 @@ public:
     }
     // Generate the call to construct empty tensor. The sizes are
     // explicitly defined by the arguments to the alloc operator.
-    rewriter.replaceOp(op, NewCallParams(rewriter, loc)
-                               .genBuffers(stt, dimSizes)
-                               .genNewCall(Action::kEmpty));
+    Value tensor = NewCallParams(rewriter, loc)
+                       .genBuffers(stt, dimSizes)
+                       .genNewCall(Action::kEmpty);
+    // Pass along the size hint, so that the insertions into the tensor
+    // do not need to regrow its storage.
+    if (Value sizeHint = adaptor.getSizeHint())
+      createFuncCall(rewriter, loc, "reserveSparseTensor", {},
+                     {tensor, sizeHint}, EmitCInterface::Off);
+    rewriter.replaceOp(op, tensor);
+    return success();
+  }
+};
+
+/// Returns the aligned pointer to the buffer of `tensor`, as an index.
+static Value genBarePtr(OpBuilder &builder, Location loc, Value tensor) {
+  Value mem = genToMemref(builder, loc, tensor);
+  return builder.create<memref::ExtractAlignedPointerAsIndexOp>(loc, mem);
+}
+
+/// Sparse conversion rule for the pack operator. The runtime library copies
+/// the level and value buffers into its storage, without going through a
+/// COO or sorting the coordinates.
+class SparseTensorPackConverter : public OpConversionPattern<PackOp> {
+public:
+  using OpConversionPattern::OpConversionPattern;
+  LogicalResult
+  matchAndRewrite(PackOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    const auto dstTp = getSparseTensorType(op.getResult());
+    for (Level l = 0, lvlRank = dstTp.getLvlRank(); l < lvlRank; ++l)
+      if (isCompressedWithHiDLT(dstTp.getLvlType(l)))
+        return rewriter.notifyMatchFailure(op, "unsupported level type");
+    // The verifier ensures the shape is static.
+    SmallVector<Value> dimSizes;
+    for (const DynSize sz : dstTp.getDimShape())
+      dimSizes.push_back(constantIndex(rewriter, loc, sz));
+    // Pass the pointers to the buffers in the order of the storage layout.
+    SmallVector<Value> buffers;
+    for (Value lvlTensor : adaptor.getLevels())
+      buffers.push_back(genBarePtr(rewriter, loc, lvlTensor));
+    buffers.push_back(genBarePtr(rewriter, loc, adaptor.getValues()));
+    Value buffersIdx = rewriter.create<memref::ExtractAlignedPointerAsIndexOp>(
+        loc, allocaBuffer(rewriter, loc, buffers));
+    Value buffersPtr = rewriter.create<LLVM::IntToPtrOp>(
+        loc, getOpaquePointerType(rewriter.getContext()),
+        rewriter.create<arith::IndexCastOp>(loc, rewriter.getI64Type(),
+                                            buffersIdx));
+    Value tensor = NewCallParams(rewriter, loc)
+                       .genBuffers(dstTp, dimSizes)
+                       .genNewCall(Action::kPack, buffersPtr);
+    rewriter.replaceOp(op, tensor);
     return success();
   }
 };
@@ -1463,6 +1583,7 @@ void mlir::populateSparseTensorConversionPatterns(
            SparseReshapeConverter<tensor::ExpandShapeOp>,
            SparseReshapeConverter<tensor::CollapseShapeOp>,
            SparseTensorConcatConverter, SparseTensorAllocConverter,
+           SparseTensorPackConverter,
            SparseTensorDeallocConverter, SparseTensorToPositionsConverter,
            SparseTensorToCoordinatesConverter, SparseTensorToValuesConverter,
            SparseNumberOfEntriesConverter, SparseTensorLoadConverter,
@@ -6,6 +6,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "CodegenUtils.h"
+
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Bufferization/IR/Bufferization.h"
@@ -31,6 +33,7 @@ namespace mlir {
 #define GEN_PASS_DEF_SPARSEVECTORIZATION
 #define GEN_PASS_DEF_SPARSEGPUCODEGEN
 #define GEN_PASS_DEF_STORAGESPECIFIERTOLLVM
+#define GEN_PASS_DEF_SPARSEENCODINGADVISOR
 #include "mlir/Dialect/SparseTensor/Transforms/Passes.h.inc"
 } // namespace mlir
 
@@ -68,17 +71,23 @@ struct SparsificationPass
     enableIndexReduction = options.enableIndexReduction;
     enableGPULibgen = options.enableGPULibgen;
     enableRuntimeLibrary = options.enableRuntimeLibrary;
+    enableGalloping = options.enableGalloping;
+    loopOrdering = options.loopOrderingStrategy;
+    gpuDataTransfer = options.gpuDataTransferStrategy;
   }
 
   void runOnOperation() override {
     auto *ctx = &getContext();
     // Translate strategy flags to strategy options.
     SparsificationOptions options(parallelization, enableIndexReduction,
-                                  enableGPULibgen, enableRuntimeLibrary);
+                                  enableGPULibgen, enableRuntimeLibrary,
+                                  enableGalloping, loopOrdering,
+                                  gpuDataTransfer);
     // Apply GPU libgen (if requested), sparsification, and cleanup rewriting.
     RewritePatternSet patterns(ctx);
     if (enableGPULibgen) {
-      populateSparseGPULibgenPatterns(patterns, enableRuntimeLibrary);
+      populateSparseGPULibgenPatterns(patterns, enableRuntimeLibrary,
+                                      gpuDataTransfer);
     }
     populateSparsificationPatterns(patterns, options);
     scf::ForOp::getCanonicalizationPatterns(patterns, ctx);
@@ -254,14 +263,16 @@ struct SparseBufferRewritePass
 
   SparseBufferRewritePass() = default;
   SparseBufferRewritePass(const SparseBufferRewritePass &pass) = default;
-  SparseBufferRewritePass(bool enableInit) {
+  SparseBufferRewritePass(bool enableInit, bool enableRTSort) {
     enableBufferInitialization = enableInit;
+    enableRuntimeSort = enableRTSort;
   }
 
   void runOnOperation() override {
     auto *ctx = &getContext();
     RewritePatternSet patterns(ctx);
-    populateSparseBufferRewriting(patterns, enableBufferInitialization);
+    populateSparseBufferRewriting(patterns, enableBufferInitialization,
+                                  enableRuntimeSort);
     (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
   }
 };
@@ -295,11 +306,15 @@ struct SparseGPUCodegenPass
   SparseGPUCodegenPass() = default;
   SparseGPUCodegenPass(const SparseGPUCodegenPass &pass) = default;
   SparseGPUCodegenPass(unsigned nT) { numThreads = nT; }
+  SparseGPUCodegenPass(unsigned nT, SparseGPURowMapping m) {
+    numThreads = nT;
+    rowMapping = m;
+  }
 
   void runOnOperation() override {
     auto *ctx = &getContext();
     RewritePatternSet patterns(ctx);
-    populateSparseGPUCodegenPatterns(patterns, numThreads);
+    populateSparseGPUCodegenPatterns(patterns, numThreads, rowMapping);
     (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
   }
 };
@@ -342,6 +357,39 @@ struct StorageSpecifierToLLVMPass
   }
 };
 
+struct SparseEncodingAdvisorPass
+    : public impl::SparseEncodingAdvisorBase<SparseEncodingAdvisorPass> {
+
+  SparseEncodingAdvisorPass() = default;
+  SparseEncodingAdvisorPass(const SparseEncodingAdvisorPass &pass) = default;
+
+  void runOnOperation() override {
+    getOperation()->walk([](linalg::GenericOp op) {
+      // Only advise on the kernels with a supplied output density.
+      auto densities = op->getAttrOfType<ArrayAttr>(getDensityAttrName());
+      if (!densities || op.getNumDpsInits() != 1)
+        return;
+      OpOperand *out = op.getDpsInitOperand(0);
+      const auto stt = getSparseTensorType(out->get());
+      if (!stt.hasEncoding() || stt.getEncoding().isSlice() ||
+          densities.size() != op->getNumOperands() ||
+          !densities[out->getOperandNumber()].isa<FloatAttr>())
+        return;
+      const auto lvlTypes = suggestLvlTypes(
+          stt, getEstimatedDensity(op, out->getOperandNumber()));
+      if (lvlTypes.empty() ||
+          llvm::equal(lvlTypes, stt.getEncoding().getLvlTypes()))
+        return;
+      const auto enc = stt.getEncoding();
+      op.emitRemark() << "the estimated density of the output suggests the "
+                         "encoding "
+                      << SparseTensorEncodingAttr::get(
+                             op.getContext(), lvlTypes, enc.getDimToLvl(),
+                             enc.getPosWidth(), enc.getCrdWidth());
+    });
+  }
+};
+
 } // namespace
 
 //===----------------------------------------------------------------------===//
@@ -413,8 +461,10 @@ std::unique_ptr<Pass> mlir::createSparseBufferRewritePass() {
 }
 
 std::unique_ptr<Pass>
-mlir::createSparseBufferRewritePass(bool enableBufferInitialization) {
-  return std::make_unique<SparseBufferRewritePass>(enableBufferInitialization);
+mlir::createSparseBufferRewritePass(bool enableBufferInitialization,
+                                    bool enableRuntimeSort) {
+  return std::make_unique<SparseBufferRewritePass>(enableBufferInitialization,
+                                                   enableRuntimeSort);
 }
 
 std::unique_ptr<Pass> mlir::createSparseVectorizationPass() {
@@ -437,6 +487,16 @@ std::unique_ptr<Pass> mlir::createSparseGPUCodegenPass(unsigned numThreads) {
   return std::make_unique<SparseGPUCodegenPass>(numThreads);
 }
 
+std::unique_ptr<Pass>
+mlir::createSparseGPUCodegenPass(unsigned numThreads,
+                                 SparseGPURowMapping rowMapping) {
+  return std::make_unique<SparseGPUCodegenPass>(numThreads, rowMapping);
+}
+
 std::unique_ptr<Pass> mlir::createStorageSpecifierToLLVMPass() {
   return std::make_unique<StorageSpecifierToLLVMPass>();
 }
+
+std::unique_ptr<Pass> mlir::createSparseEncodingAdvisorPass() {
+  return std::make_unique<SparseEncodingAdvisorPass>();
+}
@@ -450,6 +450,55 @@ static bool findSparseAnnotations(CodegenEnv &env, bool idxReducBased) {
   return annotated;
 }
 
+/// Returns the estimated number of iterations of the loop `ldx` for each
+/// iteration of its enclosing loops, which is the smallest estimate over the
+/// sparse levels of the inputs that it iterates, or its static trip count if
+/// it iterates no sparse level. Returns std::nullopt if there is no estimate.
+static std::optional<double> estimateTripCount(CodegenEnv &env, LoopId ldx) {
+  linalg::GenericOp op = env.op();
+  std::optional<double> tripCount;
+  if (!env.merger().isFilterLoop(ldx)) {
+    const int64_t range = op.getStaticLoopRanges()[ldx];
+    if (!ShapedType::isDynamic(range))
+      tripCount = range;
+  }
+  for (OpOperand *t : op.getDpsInputOperands()) {
+    const auto stt = getSparseTensorType(t->get());
+    if (!stt.hasEncoding())
+      continue;
+    const TensorId tid = env.makeTensorId(t->getOperandNumber());
+    const std::optional<Level> lvl = env.merger().getLvl(tid, ldx);
+    if (!lvl || stt.isDenseLvl(*lvl))
+      continue;
+    const double estimate = getEstimatedLvlTripCount(
+        stt, *lvl, getEstimatedDensity(op, t->getOperandNumber()));
+    tripCount = std::min(tripCount.value_or(estimate), estimate);
+  }
+  return tripCount;
+}
+
+/// Removes and returns the next loop to schedule from `loops`. With the
+/// cost model, this is the loop with the fewest estimated iterations, which
+/// keeps the more selective sparse levels outermost, and the later inserted
+/// loop among equal estimates. The loops without estimates come last.
+static LoopId popNextLoop(CodegenEnv &env, std::vector<LoopId> &loops) {
+  auto best = std::prev(loops.end());
+  if (env.options().loopOrderingStrategy ==
+      SparseLoopOrderingStrategy::kCostModel) {
+    std::optional<double> bestTripCount = estimateTripCount(env, *best);
+    for (auto it = loops.begin(); it != best; ++it) {
+      const std::optional<double> tripCount = estimateTripCount(env, *it);
+      if (tripCount && (!bestTripCount || *tripCount < *bestTripCount)) {
+        best = it;
+        bestTripCount = tripCount;
+      }
+    }
+  }
+  const LoopId ldx = *best;
+  loops.erase(best);
+  return ldx;
+}
+
 /// A helper to compute a topological sort. O(n^2) time complexity
 /// as we use adj matrix for the graph.
 /// The sorted result will put the first Reduction iterator to the
@@ -497,9 +546,8 @@ static bool topSortOptimal(CodegenEnv &env,
     //      for (1 to M)
     //        O(X) computation  => O(NK+NMX) time complexity
     auto &it = !filterIt.empty() ? filterIt : (!parIt.empty() ? parIt : redIt);
-    auto src = it.back();
+    const LoopId src = popNextLoop(env, it);
     env.topSortPushBack(src);
-    it.pop_back();
     // Update in-degree, and push 0-degree node into worklist.
     for (LoopId dst = 0; dst < numLoops; dst++) {
       if (adjM[src][dst] && --inDegree[dst] == 0) {
@@ -1410,13 +1458,14 @@ static Operation *genFilterLoop(CodegenEnv &env, OpBuilder &builder, LoopId ldx,
 /// one sparse level in the list.
 static Operation *genCoIteration(CodegenEnv &env, OpBuilder &builder,
                                  LoopId idx, ArrayRef<TensorLevel> tidLvls,
-                                 bool tryParallel, bool needsUniv) {
+                                 bool tryParallel, bool needsUniv,
+                                 bool genGallop) {
   Operation *loop = *env.genLoopBoundary([&](MutableArrayRef<Value> reduc) {
     // Construct the while-loop with a parameter for each
     // index.
     return env.emitter().enterCoIterationOverTensorsAtLvls(
         builder, env.op().getLoc(), tidLvls, reduc, tryParallel,
-        /*genDedup=*/true, needsUniv);
+        /*genDedup=*/true, needsUniv, genGallop);
   });
   assert(loop);
   return loop;
@@ -1425,7 +1474,8 @@ static Operation *genCoIteration(CodegenEnv &env, OpBuilder &builder,
 /// Generates a for-loop or a while-loop, depending on whether it implements
 /// singleton iteration or co-iteration over the given conjunction.
 static Operation *genLoop(CodegenEnv &env, OpBuilder &builder, LoopOrd at,
-                          bool needsUniv, ArrayRef<TensorLevel> tidLvls) {
+                          bool needsUniv, bool isConjunction,
+                          ArrayRef<TensorLevel> tidLvls) {
   const LoopId ldx = env.topSortAt(at);
   if (env.merger().isFilterLoop(ldx)) {
     assert(tidLvls.size() == 1);
@@ -1433,7 +1483,9 @@ static Operation *genLoop(CodegenEnv &env, OpBuilder &builder, LoopOrd at,
   }
 
   bool tryParallel = shouldTryParallize(env, ldx, at == 0, tidLvls);
-  return genCoIteration(env, builder, ldx, tidLvls, tryParallel, needsUniv);
+  bool genGallop = isConjunction && env.options().enableGalloping;
+  return genCoIteration(env, builder, ldx, tidLvls, tryParallel, needsUniv,
+                        genGallop);
 }
 
 /// Generates the induction structure for a while-loop.
@@ -1746,7 +1798,8 @@ static bool translateBitsToTidLvlPairs(
 /// Starts a single loop in current sequence.
 static std::pair<Operation *, bool> startLoop(CodegenEnv &env,
                                               OpBuilder &builder, LoopOrd at,
-                                              LatPointId li, bool needsUniv) {
+                                              LatPointId li, bool needsUniv,
+                                              bool isConjunction) {
   // The set of tensors + lvls to generate loops on
   SmallVector<TensorLevel> tidLvls;
   // The set of dense tensors with non-trivial affine expression that just
@@ -1757,7 +1810,8 @@ static std::pair<Operation *, bool> startLoop(CodegenEnv &env,
                                                  tidLvls, affineTidLvls);
 
   // Emit the for/while-loop control.
-  Operation *loop = genLoop(env, builder, at, needsUniv, tidLvls);
+  Operation *loop =
+      genLoop(env, builder, at, needsUniv, isConjunction, tidLvls);
   Location loc = env.op().getLoc();
   for (auto [tidLvl, exp] : affineTidLvls) {
     env.emitter().genDenseAffineAddress(builder, loc, tidLvl, exp);
@@ -1844,8 +1898,17 @@ static void genStmt(CodegenEnv &env, RewriterBase &rewriter, ExprId exp,
   const unsigned lsize = env.set(lts).size();
   for (unsigned i = 0; i < lsize; i++) {
     const LatPointId li = env.set(lts)[i];
+    // A loop whose body is guarded by its lattice point alone only works
+    // on the intersection of its conditions.
+    bool isConjunction = true;
+    for (unsigned j = 0; j < lsize; j++) {
+      const LatPointId lj = env.set(lts)[j];
+      if (li != lj && env.merger().latGT(li, lj))
+        isConjunction = false;
+    }
     // Start a loop.
-    auto [loop, isSingleCond] = startLoop(env, rewriter, at, li, needsUniv);
+    auto [loop, isSingleCond] =
+        startLoop(env, rewriter, at, li, needsUniv, isConjunction);
 
     // Visit all lattices points with Li >= Lj to generate the
     // loop-body, possibly with if statements for coiteration.
@@ -0,0 +1,157 @@
+//===- CoalesceInsertSliceChains.cpp - Reads of insert_slice chains -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements patterns rewriting the reads of the tensors updated by
+// chains of tensor.insert_slice ops, such that the chains bufferize in place.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Tensor/Transforms/Transforms.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/AffineExpr.h"
+#include "mlir/IR/AffineMap.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/ValueBoundsOpInterface.h"
+
+using namespace mlir;
+using namespace mlir::tensor;
+
+namespace {
+/// A hyperrectangular subset of a tensor, described by the offsets, sizes and
+/// strides of its dimensions.
+struct Subset {
+  SmallVector<OpFoldResult> offsets, sizes, strides;
+};
+} // namespace
+
+/// Returns whether `expr` is known to be non-negative, where `operands` are the
+/// values of its dimensions.
+static bool isKnownNonNegative(AffineExpr expr, ValueDimList operands) {
+  auto map = AffineMap::get(operands.size(), /*symbolCount=*/0, expr);
+  if (auto constExpr = dyn_cast<AffineConstantExpr>(map.getResult(0)))
+    return constExpr.getValue() >= 0;
+  FailureOr<int64_t> lb = ValueBoundsConstraintSet::computeConstantBound(
+      presburger::BoundType::LB, map, operands);
+  return succeeded(lb) && *lb >= 0;
+}
+
+/// Returns whether the subsets `a` and `b` of the same tensor are known to be
+/// disjoint, i.e. whether they are disjoint along one of the dimensions. The
+/// strides must be static, such that the subset bounds are affine.
+static bool areKnownDisjoint(const Subset &a, const Subset &b,
+                             MLIRContext *ctx) {
+  ValueDimList operands;
+  auto getExpr = [&](OpFoldResult ofr) {
+    if (std::optional<int64_t> cst = getConstantIntValue(ofr))
+      return getAffineConstantExpr(*cst, ctx);
+    operands.emplace_back(ofr.get<Value>(), std::nullopt);
+    return getAffineDimExpr(operands.size() - 1, ctx);
+  };
+
+  for (auto [offsetA, sizeA, strideA, offsetB, sizeB, strideB] :
+       llvm::zip(a.offsets, a.sizes, a.strides, b.offsets, b.sizes,
+                 b.strides)) {
+    std::optional<int64_t> cstStrideA = getConstantIntValue(strideA);
+    std::optional<int64_t> cstStrideB = getConstantIntValue(strideB);
+    if (!cstStrideA || !cstStrideB || *cstStrideA <= 0 || *cstStrideB <= 0)
+      continue;
+
+    // The subsets span [offset, offset + (size - 1) * stride + 1) in this
+    // dimension.
+    operands.clear();
+    AffineExpr beginA = getExpr(offsetA), beginB = getExpr(offsetB);
+    AffineExpr endA = beginA + (getExpr(sizeA) - 1) * *cstStrideA + 1;
+    AffineExpr endB = beginB + (getExpr(sizeB) - 1) * *cstStrideB + 1;
+    if (isKnownNonNegative(beginB - endA, operands) ||
+        isKnownNonNegative(beginA - endB, operands))
+      return true;
+  }
+  return false;
+}
+
+/// Returns whether the result of `insertOp` can be used by `readOp` instead of
+/// its destination: `insertOp` must precede `readOp` in the same block, or an
+/// ancestor of `readOp` that is not isolated from above.
+static bool isVisibleFrom(InsertSliceOp insertOp, Operation *readOp) {
+  Operation *ancestor = insertOp->getBlock()->findAncestorOpInBlock(*readOp);
+  if (!ancestor || !insertOp->isBeforeInBlock(ancestor))
+    return false;
+  for (Operation *op = readOp->getParentOp(); op != insertOp->getParentOp();
+       op = op->getParentOp()) {
+    if (op->hasTrait<OpTrait::IsIsolatedFromAbove>())
+      return false;
+  }
+  return true;
+}
+
+namespace {
+/// Rewrites a read of a subset of the destination of a tensor.insert_slice op
+/// that is disjoint from the inserted subset, and that follows the
+/// tensor.insert_slice op, to read from its result instead. E.g.:
+///
+/// %0 = tensor.insert_slice %a into %t[0] [4] [1]
+/// %1 = tensor.extract_slice %t[8] [4] [1]
+///
+/// becomes
+///
+/// %0 = tensor.insert_slice %a into %t[0] [4] [1]
+/// %1 = tensor.extract_slice %0[8] [4] [1]
+///
+/// The read of %t after the insertion prevents it from bufferizing in place,
+/// which copies the whole %t, while the read of %0 does not. The reads are
+/// forwarded along the chains of tensor.insert_slice ops, until the latest
+/// insertion that precedes them or overlaps with them.
+template <typename OpTy>
+struct ForwardDisjointReadOfInsertSliceDest : public OpRewritePattern<OpTy> {
+  using OpRewritePattern<OpTy>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(OpTy readOp,
+                                PatternRewriter &rewriter) const override {
+    // The read tensor is the first operand of the supported reads.
+    Value source = readOp->getOperand(0);
+    Subset readSubset = getReadSubset(readOp);
+    for (Operation *user : source.getUsers()) {
+      auto insertOp = dyn_cast<InsertSliceOp>(user);
+      if (!insertOp || insertOp.getDest() != source ||
+          !isVisibleFrom(insertOp, readOp))
+        continue;
+
+      Subset insertSubset{insertOp.getMixedOffsets(), insertOp.getMixedSizes(),
+                          insertOp.getMixedStrides()};
+      if (!areKnownDisjoint(readSubset, insertSubset, rewriter.getContext()))
+        continue;
+
+      rewriter.updateRootInPlace(
+          readOp, [&]() { readOp->setOperand(0, insertOp.getResult()); });
+      return success();
+    }
+    return rewriter.notifyMatchFailure(
+        readOp, "no preceding disjoint insertion into the read tensor");
+  }
+
+private:
+  static Subset getReadSubset(ExtractSliceOp op) {
+    return {op.getMixedOffsets(), op.getMixedSizes(), op.getMixedStrides()};
+  }
+  static Subset getReadSubset(ExtractOp op) {
+    // An element is a subset of unit sizes and strides.
+    SmallVector<OpFoldResult> offsets = getAsOpFoldResult(op.getIndices());
+    SmallVector<OpFoldResult> ones(offsets.size(),
+                                   Builder(op.getContext()).getIndexAttr(1));
+    return {offsets, ones, ones};
+  }
+};
+} // namespace
+
+void mlir::tensor::populateCoalesceInsertSliceChainPatterns(
+    RewritePatternSet &patterns) {
+  patterns.add<ForwardDisjointReadOfInsertSliceDest<ExtractSliceOp>,
+               ForwardDisjointReadOfInsertSliceDest<ExtractOp>>(
+      patterns.getContext());
+}
@@ -851,6 +851,14 @@ OpFoldResult ReshapeOp::fold(FoldAdaptor adaptor) {
   if (inputTy == outputTy)
     return getInput1();
 
+  // Resource backed constants are reshaped without copying their data, by
+  // referring to the same blob with the new type.
+  if (auto resource = llvm::dyn_cast_if_present<DenseResourceElementsAttr>(
+          adaptor.getInput1())) {
+    if (outputTy.hasStaticShape())
+      return DenseResourceElementsAttr::get(outputTy, resource.getRawHandle());
+  }
+
   auto operand = llvm::dyn_cast_if_present<DenseElementsAttr>(adaptor.getInput1());
   if (operand && outputTy.hasStaticShape() && operand.isSplat()) {
     return SplatElementsAttr::get(outputTy, operand.getSplatValue<Attribute>());
@@ -13,6 +13,7 @@
 #include "mlir/Dialect/Tosa/IR/TosaOps.h"
 #include "mlir/Dialect/Tosa/Transforms/Passes.h"
 #include "mlir/Dialect/Utils/IndexingUtils.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
 #include "mlir/IR/Matchers.h"
 #include "mlir/Pass/Pass.h"
 
@@ -62,6 +63,51 @@ DenseElementsAttr transposeType(ElementsAttr attr, ShapedType inputType,
                                 llvm::ArrayRef<BaseType>(outputValues));
 }
 
+// A transposition of the raw data of a resource backed ElementsAttr. The
+// elements are moved as opaque bytes into a new blob of the builtin dialect
+// resource manager, such that folding large weights neither converts them to
+// typed values nor copies them into a uniqued DenseElementsAttr. Returns null
+// if the blob is not available or its elements are not byte sized.
+DenseResourceElementsAttr
+transposeResource(DenseResourceElementsAttr attr, ShapedType inputType,
+                  ShapedType outputType, llvm::ArrayRef<int64_t> permValues) {
+  DenseResourceElementsHandle handle = attr.getRawHandle();
+  const AsmResourceBlob *blob = handle.getBlob();
+  if (!blob)
+    return {};
+  Type elementType = inputType.getElementType();
+  if (!elementType.isIntOrFloat() ||
+      elementType.getIntOrFloatBitWidth() % 8 != 0)
+    return {};
+  size_t elementSize = elementType.getIntOrFloatBitWidth() / 8;
+  ArrayRef<char> data = blob->getData();
+  if (data.size() != inputType.getNumElements() * elementSize)
+    return {};
+
+  AsmResourceBlob resultBlob =
+      HeapAsmResourceBlob::allocate(data.size(), blob->getDataAlignment());
+  MutableArrayRef<char> resultData = resultBlob.getMutableData();
+  auto inputShape = inputType.getShape();
+  auto outputStrides = computeStrides(outputType.getShape());
+  auto invertedPermValues = invertPermutationVector(permValues);
+  for (int64_t index = 0, e = inputType.getNumElements(); index < e; ++index) {
+    int64_t srcLinearIndex = index;
+    uint64_t dstLinearIndex = 0;
+    for (int64_t dim = inputShape.size() - 1; dim >= 0; --dim) {
+      dstLinearIndex += outputStrides[invertedPermValues[dim]] *
+                        (srcLinearIndex % inputShape[dim]);
+      srcLinearIndex /= inputShape[dim];
+    }
+    std::memcpy(resultData.data() + dstLinearIndex * elementSize,
+                data.data() + index * elementSize, elementSize);
+  }
+
+  auto &manager =
+      DenseResourceElementsHandle::getManagerInterface(attr.getContext());
+  return DenseResourceElementsAttr::get(
+      outputType, manager.insert(handle.getKey(), std::move(resultBlob)));
+}
+
 // A type specialized transposition of an ElementsAttr.
 // This implementation tries to operate on the underlying data in its raw
 // representation when possible to avoid allocating a large number of Attribute
@@ -124,6 +170,15 @@ struct TosaFoldConstantTranspose : public OpRewritePattern<tosa::TransposeOp> {
 
     auto inputType = cast<ShapedType>(op.getInput1().getType());
 
+    if (auto resourceAttr = dyn_cast<DenseResourceElementsAttr>(inputValues)) {
+      auto resultAttr =
+          transposeResource(resourceAttr, inputType, outputType, permValues);
+      if (!resultAttr)
+        return failure();
+      rewriter.replaceOpWithNewOp<tosa::ConstOp>(op, outputType, resultAttr);
+      return success();
+    }
+
     auto resultAttr = transpose(inputValues, inputType, outputType, permValues);
     rewriter.replaceOpWithNewOp<tosa::ConstOp>(op, outputType, resultAttr);
     return success();
@@ -13,7 +13,9 @@
 
 #include "mlir/Dialect/Tosa/Transforms/Passes.h"
 
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Dialect/Tosa/IR/TosaOps.h"
 #include "mlir/Dialect/Tosa/Utils/ShapeUtils.h"
@@ -30,6 +32,7 @@
 namespace mlir {
 namespace tosa {
 #define GEN_PASS_DEF_TOSAINFERSHAPES
+#define GEN_PASS_DEF_TOSASPECIALIZESHAPES
 #include "mlir/Dialect/Tosa/Transforms/Passes.h.inc"
 } // namespace tosa
 } // namespace mlir
@@ -41,6 +44,16 @@ namespace {
 
 void propagateShapesInRegion(Region &region);
 
+// Check whether this use case is replaceable. We define an op as being
+// replaceable if it is used by a ReturnOp, a TosaOp, or an op with a
+// type-inference related interface.
+bool isReplaceableUser(Operation *user) {
+  return isa<func::ReturnOp>(user) ||
+         user->getDialect()->getNamespace() ==
+             TosaDialect::getDialectNamespace() ||
+         isa<InferTypeOpInterface, InferShapedTypeOpInterface>(user);
+}
+
 void propagateShapesToTosaIf(
     Operation &op, DenseMap<Value, ShapedTypeComponents> &shapesStorage) {
   IfOp ifOp = dyn_cast<IfOp>(op);
@@ -202,16 +215,6 @@ void propagateShapesInRegion(Region &region) {
     return it->second;
   };
 
-  // Check whether this use case is replaceable. We define an op as
-  // being replaceable if it is used by a ReturnOp, a TosaOp, or an op with a
-  // type-inference related interface.
-  auto isReplaceableUser = [](Operation *user) -> bool {
-    return isa<func::ReturnOp>(user) ||
-           user->getDialect()->getNamespace() ==
-               TosaDialect::getDialectNamespace() ||
-           isa<InferTypeOpInterface, InferShapedTypeOpInterface>(user);
-  };
-
   for (auto &block : region) {
     for (Operation &op : block) {
       if (op.getDialect()->getNamespace() != TosaDialect::getDialectNamespace())
@@ -278,6 +281,42 @@ void propagateShapesInRegion(Region &region) {
   }
 }
 
+// Insert casts to guarantee the ReturnOps agree with the FuncOp type.
+void castReturnsToFunctionType(func::FuncOp func) {
+  IRRewriter rewriter(func.getContext());
+  func.walk([&](func::ReturnOp op) {
+    func::FuncOp parent = dyn_cast<func::FuncOp>(op->getParentOp());
+    if (!parent)
+      return;
+
+    rewriter.setInsertionPoint(op);
+    FunctionType funcTy = func.getFunctionType();
+    auto resultTys = funcTy.getResults();
+
+    bool castAdded = false;
+    SmallVector<Value> castedValues;
+    for (auto it : llvm::zip(op->getOperands(), resultTys)) {
+      auto operand = std::get<0>(it);
+      auto currentTy = operand.getType();
+      auto castTy = std::get<1>(it);
+      if (currentTy == castTy) {
+        castedValues.push_back(operand);
+        continue;
+      }
+
+      castedValues.push_back(
+          rewriter.create<tensor::CastOp>(op.getLoc(), castTy, operand)
+              .getResult());
+
+      castAdded = true;
+    }
+
+    if (castAdded) {
+      rewriter.replaceOpWithNewOp<func::ReturnOp>(op, castedValues);
+    }
+  });
+}
+
 /// Pass that performs shape propagation across TOSA operations. This includes
 /// migrating to within the regions of if/while operations.
 struct TosaInferShapes
@@ -286,43 +325,181 @@ public:
   void runOnOperation() override {
     func::FuncOp func = getOperation();
 
-    IRRewriter rewriter(func.getContext());
-
     propagateShapesInRegion(func.getBody());
 
-    // Insert UnrealizedConversionCasts to guarantee ReturnOp agress with
-    // the FuncOp type.
-    func.walk([&](func::ReturnOp op) {
-      func::FuncOp parent = dyn_cast<func::FuncOp>(op->getParentOp());
-      if (!parent)
-        return;
-
-      rewriter.setInsertionPoint(op);
-      FunctionType funcTy = func.getFunctionType();
-      auto resultTys = funcTy.getResults();
-
-      bool castAdded = false;
-      SmallVector<Value> castedValues;
-      for (auto it : llvm::zip(op->getOperands(), resultTys)) {
-        auto operand = std::get<0>(it);
-        auto currentTy = operand.getType();
-        auto castTy = std::get<1>(it);
-        if (currentTy == castTy) {
-          castedValues.push_back(operand);
-          continue;
-        }
+    castReturnsToFunctionType(func);
+  }
+};
 
-        castedValues.push_back(
-            rewriter.create<tensor::CastOp>(op.getLoc(), castTy, operand)
-                .getResult());
+// Return `type` with its dynamic dimensions replaced by `size`, or null if
+// `type` is not a tensor type with dynamic dimensions.
+RankedTensorType getSpecializedType(Type type, int64_t size) {
+  auto tensorTy = dyn_cast<RankedTensorType>(type);
+  if (!tensorTy || tensorTy.hasStaticShape())
+    return {};
+  SmallVector<int64_t> shape(tensorTy.getShape());
+  for (int64_t &dim : shape)
+    if (ShapedType::isDynamic(dim))
+      dim = size;
+  return tensorTy.clone(shape);
+}
 
-        castAdded = true;
-      }
+// Turn `func` into a specialization for the dynamic dimensions of its tensor
+// arguments having the given `size`, and propagate the static shapes across
+// its body.
+void specializeFunction(func::FuncOp func, int64_t size) {
+  Block &entry = func.front();
+  OpBuilder builder = OpBuilder::atBlockBegin(&entry);
+  for (BlockArgument arg : entry.getArguments()) {
+    RankedTensorType specializedTy = getSpecializedType(arg.getType(), size);
+    if (!specializedTy)
+      continue;
+
+    // The users that do not support refined types keep using the original
+    // type through a cast.
+    Type originalTy = arg.getType();
+    arg.setType(specializedTy);
+    SmallVector<OpOperand *> uses;
+    for (OpOperand &use : arg.getUses())
+      if (!isReplaceableUser(use.getOwner()))
+        uses.push_back(&use);
+    if (uses.empty())
+      continue;
+    Value cast = builder.create<tensor::CastOp>(arg.getLoc(), originalTy, arg);
+    for (OpOperand *use : uses)
+      use->set(cast);
+  }
 
-      if (castAdded) {
-        rewriter.replaceOpWithNewOp<func::ReturnOp>(op, castedValues);
+  propagateShapesInRegion(func.getBody());
+
+  // The results of a function with a single block take the propagated types,
+  // those of the other functions are cast to the original types.
+  if (func.getBody().hasOneBlock()) {
+    Operation *returnOp = entry.getTerminator();
+    func.setType(builder.getFunctionType(entry.getArgumentTypes(),
+                                         returnOp->getOperandTypes()));
+    return;
+  }
+  func.setType(builder.getFunctionType(entry.getArgumentTypes(),
+                                       func.getResultTypes()));
+  castReturnsToFunctionType(func);
+}
+
+// Build a call of `callee` with `args`, cast to its argument types, and return
+// its results cast to `resultTypes`.
+SmallVector<Value> buildCastedCall(OpBuilder &builder, Location loc,
+                                   func::FuncOp callee, ValueRange args,
+                                   TypeRange resultTypes) {
+  SmallVector<Value> operands;
+  for (auto [arg, argTy] : llvm::zip(args, callee.getArgumentTypes()))
+    operands.push_back(arg.getType() == argTy
+                           ? arg
+                           : builder.create<tensor::CastOp>(loc, argTy, arg));
+  auto call = builder.create<func::CallOp>(loc, callee, operands);
+
+  SmallVector<Value> results;
+  for (auto [result, resultTy] : llvm::zip(call.getResults(), resultTypes))
+    results.push_back(
+        result.getType() == resultTy
+            ? result
+            : builder.create<tensor::CastOp>(loc, resultTy, result));
+  return results;
+}
+
+// Build the dispatch to the first of `specializations` whose size matches the
+// dynamic dimensions of `args`, falling back to `generic` if none does.
+SmallVector<Value>
+buildDispatch(OpBuilder &builder, Location loc, ValueRange args,
+              TypeRange resultTypes,
+              ArrayRef<std::pair<int64_t, func::FuncOp>> specializations,
+              func::FuncOp generic) {
+  if (specializations.empty())
+    return buildCastedCall(builder, loc, generic, args, resultTypes);
+
+  int64_t size = specializations.front().first;
+  func::FuncOp specialized = specializations.front().second;
+  Value expectedSize = builder.create<arith::ConstantIndexOp>(loc, size);
+  Value condition;
+  for (Value arg : args) {
+    auto tensorTy = dyn_cast<RankedTensorType>(arg.getType());
+    if (!tensorTy)
+      continue;
+    for (auto [index, dim] : llvm::enumerate(tensorTy.getShape())) {
+      if (!ShapedType::isDynamic(dim))
+        continue;
+      Value dimSize = builder.create<tensor::DimOp>(loc, arg, index);
+      Value isEqual = builder.create<arith::CmpIOp>(
+          loc, arith::CmpIPredicate::eq, dimSize, expectedSize);
+      condition = condition
+                      ? builder.create<arith::AndIOp>(loc, condition, isEqual)
+                      : isEqual;
+    }
+  }
+
+  auto ifOp = builder.create<scf::IfOp>(
+      loc, condition,
+      [&](OpBuilder &thenBuilder, Location nestedLoc) {
+        thenBuilder.create<scf::YieldOp>(
+            nestedLoc, buildCastedCall(thenBuilder, nestedLoc, specialized,
+                                       args, resultTypes));
+      },
+      [&](OpBuilder &elseBuilder, Location nestedLoc) {
+        elseBuilder.create<scf::YieldOp>(
+            nestedLoc, buildDispatch(elseBuilder, nestedLoc, args, resultTypes,
+                                     specializations.drop_front(), generic));
+      });
+  return llvm::to_vector(ifOp.getResults());
+}
+
+/// Pass that specializes the functions for static sizes of the dynamic
+/// dimensions of their arguments, behind a dispatch on these sizes.
+struct TosaSpecializeShapes
+    : public tosa::impl::TosaSpecializeShapesBase<TosaSpecializeShapes> {
+  using Base::Base;
+
+  void runOnOperation() override {
+    if (sizes.empty())
+      return;
+
+    ModuleOp module = getOperation();
+    SymbolTable symbolTable(module);
+    SmallVector<func::FuncOp> funcs;
+    for (auto func : module.getOps<func::FuncOp>()) {
+      if (func.isPublic() && !func.isExternal() &&
+          llvm::any_of(func.getArgumentTypes(), [](Type type) {
+            auto tensorTy = dyn_cast<RankedTensorType>(type);
+            return tensorTy && !tensorTy.hasStaticShape();
+          }))
+        funcs.push_back(func);
+    }
+
+    for (func::FuncOp func : funcs) {
+      // Copy the original function as the generic fallback, and the
+      // specializations after it.
+      Block::iterator insertPt = std::next(Block::iterator(func));
+      auto cloneAs = [&](StringRef suffix) {
+        func::FuncOp clone = func.clone();
+        clone.setName((func.getName() + "_" + suffix).str());
+        clone.setPrivate();
+        symbolTable.insert(clone, insertPt);
+        return clone;
+      };
+      func::FuncOp generic = cloneAs("generic");
+      SmallVector<std::pair<int64_t, func::FuncOp>> specializations;
+      for (int64_t size : sizes) {
+        func::FuncOp specialized = cloneAs(std::to_string(size));
+        specializeFunction(specialized, size);
+        specializations.emplace_back(size, specialized);
       }
-    });
+
+      func.eraseBody();
+      Block *entry = func.addEntryBlock();
+      OpBuilder builder = OpBuilder::atBlockEnd(entry);
+      builder.create<func::ReturnOp>(
+          func.getLoc(),
+          buildDispatch(builder, func.getLoc(), entry->getArguments(),
+                        func.getResultTypes(), specializations, generic));
+    }
   }
 };
 } // namespace
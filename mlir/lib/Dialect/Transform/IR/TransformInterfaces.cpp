@@ -16,6 +16,7 @@
 #include "mlir/Interfaces/CastInterfaces.h"
 #include "mlir/Support/LogicalResult.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/Support/Debug.h"
@@ -570,6 +571,14 @@ void transform::TransformState::recordValueHandleInvalidationByOpHandleOne(
   }
 }
 
+/// Returns true if `op` or one of its ancestors is in `ops`.
+static bool isNestedInAnyOf(Operation *op, const DenseSet<Operation *> &ops) {
+  for (; op; op = op->getParentOp())
+    if (ops.contains(op))
+      return true;
+  return false;
+}
+
 void transform::TransformState::recordOpHandleInvalidation(
     OpOperand &handle, ArrayRef<Operation *> potentialAncestors,
     Value throughValue,
@@ -601,7 +610,11 @@ void transform::TransformState::recordOpHandleInvalidation(
   // on the assumption that the number of handles is significantly less than the
   // number of IR objects (operations and values). Alternatively, we could walk
   // the IR nested in each payload op associated with the given handle and look
-  // for handles associated with each operation and value.
+  // for handles associated with each operation and value. The payload IR
+  // entities that are not nested in the potential ancestors are filtered out by
+  // walking up their parents, instead of checking each of the ancestors.
+  DenseSet<Operation *> ancestorSet(potentialAncestors.begin(),
+                                    potentialAncestors.end());
   for (const auto &[region, mapping] : llvm::reverse(mappings)) {
     // Stop lookup when reaching a region that is isolated from above.
     if (region->getParentOp()->hasTrait<OpTrait::IsIsolatedFromAbove>())
@@ -610,6 +623,8 @@ void transform::TransformState::recordOpHandleInvalidation(
     // pointing to any of the payload ops associated with the given handle or
     // any op nested in them.
     for (const auto &[payloadOp, otherHandles] : mapping.reverse) {
+      if (!isNestedInAnyOf(payloadOp, ancestorSet))
+        continue;
       for (Value otherHandle : otherHandles)
         recordOpHandleInvalidationOne(handle, potentialAncestors, payloadOp,
                                       otherHandle, throughValue,
@@ -621,6 +636,13 @@ void transform::TransformState::recordOpHandleInvalidation(
     // blocks belonging to any region of any payload op associated with the
     // given handle or any op nested in them.
     for (const auto &[payloadValue, valueHandles] : mapping.reverseValues) {
+      Operation *definingOp = payloadValue.getDefiningOp();
+      if (!definingOp) {
+        definingOp =
+            llvm::cast<BlockArgument>(payloadValue).getOwner()->getParentOp();
+      }
+      if (!isNestedInAnyOf(definingOp, ancestorSet))
+        continue;
       for (Value valueHandle : valueHandles)
         recordValueHandleInvalidationByOpHandleOne(handle, potentialAncestors,
                                                    payloadValue, valueHandle,
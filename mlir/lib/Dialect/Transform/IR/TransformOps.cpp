@@ -1299,6 +1299,33 @@ transform::ParamConstantOp::apply(transform::TransformRewriter &rewriter,
   return DiagnosedSilenceableFailure::success();
 }
 
+//===----------------------------------------------------------------------===//
+// ParamTunableOp
+//===----------------------------------------------------------------------===//
+
+DiagnosedSilenceableFailure
+transform::ParamTunableOp::apply(transform::TransformRewriter &rewriter,
+                                 transform::TransformResults &results,
+                                 transform::TransformState &state) {
+  Attribute value = state.getOptions().getTunableValue(getName());
+  if (!value) {
+    value = getDefaultValue();
+  } else if (!llvm::is_contained(getOptions(), value)) {
+    return emitDefiniteFailure()
+           << "value " << value << " selected for tunable parameter '"
+           << getName() << "' is not one of its options";
+  }
+  results.setParams(cast<OpResult>(getParam()), {value});
+  return DiagnosedSilenceableFailure::success();
+}
+
+LogicalResult transform::ParamTunableOp::verify() {
+  if (!llvm::is_contained(getOptions(), getDefaultValue()))
+    return emitOpError()
+           << "expects the default value to be one of the options";
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // MergeHandlesOp
 //===----------------------------------------------------------------------===//
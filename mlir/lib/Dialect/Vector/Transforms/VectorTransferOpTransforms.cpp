@@ -22,10 +22,14 @@
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Dominance.h"
 #include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Support/MathExtras.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Debug.h"
 
+#include <map>
+
 #define DEBUG_TYPE "vector-transfer-opt"
 
 #define DBGS() (llvm::dbgs() << '[' << DEBUG_TYPE << "] ")
@@ -41,8 +45,55 @@ static Operation *findAncestorOpInRegion(Region *region, Operation *op) {
   return op;
 }
 
+/// Return the memref accessed through the subviews of `source`.
+static Value getBaseMemref(Value source) {
+  while (auto subView = source.getDefiningOp<memref::SubViewOp>())
+    source = subView.getSource();
+  return source;
+}
+
+/// Return the position of the bucket of `transfer`, made of its indices along
+/// the leading dimensions and of the index of its tile along the dimensions of
+/// the vector, or std::nullopt if some of its indices are not constants.
+static std::optional<SmallVector<int64_t>>
+getBucketPosition(VectorTransferOpInterface transfer) {
+  unsigned rankOffset = transfer.getLeadingShapedRank();
+  VectorType vectorType = transfer.getVectorType();
+  SmallVector<int64_t> position;
+  for (auto [i, index] : llvm::enumerate(transfer.indices())) {
+    auto constant = index.getDefiningOp<arith::ConstantOp>();
+    if (!constant)
+      return std::nullopt;
+    int64_t value = llvm::cast<IntegerAttr>(constant.getValue()).getInt();
+    if (i >= rankOffset)
+      value = floorDiv(value, vectorType.getDimSize(i - rankOffset));
+    position.push_back(value);
+  }
+  return position;
+}
+
 namespace {
 
+/// The ops with memory effects that use a memref, directly or through
+/// subviews. The transfers whose indices are all constants are bucketed by
+/// source, vector type and position. As `vector::isDisjointTransferSet` proves
+/// two such transfers of the same source and vector type disjoint unless they
+/// are in the same or adjacent tiles, a transfer only needs to be checked
+/// against the transfers of its source and vector type in the adjacent
+/// buckets, instead of against all of them.
+struct MemrefAccesses {
+  MemrefAccesses(Value memref);
+
+  /// Append to `result` the accesses that may overlap `transfer`.
+  void getMayOverlapAccesses(VectorTransferOpInterface transfer,
+                             SmallVectorImpl<Operation *> &result) const;
+
+  /// The accesses that are not bucketed.
+  SmallVector<Operation *> unbucketed;
+  using Buckets = std::map<SmallVector<int64_t>, SmallVector<Operation *>>;
+  llvm::MapVector<std::pair<Value, Type>, Buckets> buckets;
+};
+
 class TransferOptimization {
 public:
   TransferOptimization(RewriterBase &rewriter, Operation *op)
@@ -53,17 +104,103 @@ public:
     for (Operation *op : opToErase)
       rewriter.eraseOp(op);
     opToErase.clear();
+    // The erased ops may still be indexed.
+    memrefAccesses.clear();
   }
 
 private:
   RewriterBase &rewriter;
   bool isReachable(Operation *start, Operation *dest);
+  /// Return the accesses that may overlap `transfer`.
+  SmallVector<Operation *>
+  getMayOverlapAccesses(VectorTransferOpInterface transfer);
   DominanceInfo dominators;
   PostDominanceInfo postDominators;
   std::vector<Operation *> opToErase;
+  /// The accesses of the memrefs, indexed the first time they are queried.
+  DenseMap<Value, std::unique_ptr<MemrefAccesses>> memrefAccesses;
+  /// Whether the second block is reachable from the successors of the first
+  /// one, for the blocks queried by `isReachable`. Erasing the transfers keeps
+  /// the blocks valid.
+  DenseMap<std::pair<Block *, Block *>, bool> reachableBlocks;
 };
 
 } // namespace
+
+MemrefAccesses::MemrefAccesses(Value memref) {
+  llvm::SmallVector<Operation *, 32> users(memref.getUsers().begin(),
+                                           memref.getUsers().end());
+  llvm::SmallDenseSet<Operation *, 32> processed;
+  while (!users.empty()) {
+    Operation *user = users.pop_back_val();
+    // If the user has already been processed skip.
+    if (!processed.insert(user).second)
+      continue;
+    if (auto subView = dyn_cast<memref::SubViewOp>(user)) {
+      users.append(subView->getUsers().begin(), subView->getUsers().end());
+      continue;
+    }
+    if (isMemoryEffectFree(user))
+      continue;
+    auto transfer = dyn_cast<VectorTransferOpInterface>(user);
+    std::optional<SmallVector<int64_t>> position;
+    if (transfer)
+      position = getBucketPosition(transfer);
+    if (!position) {
+      unbucketed.push_back(user);
+      continue;
+    }
+    buckets[{transfer.source(), transfer.getVectorType()}][*position].push_back(
+        user);
+  }
+}
+
+void MemrefAccesses::getMayOverlapAccesses(
+    VectorTransferOpInterface transfer,
+    SmallVectorImpl<Operation *> &result) const {
+  result.append(unbucketed.begin(), unbucketed.end());
+  std::pair<Value, Type> key(transfer.source(), transfer.getVectorType());
+  std::optional<SmallVector<int64_t>> position = getBucketPosition(transfer);
+  for (const auto &[bucketsKey, bucketsOfKey] : buckets) {
+    if (!position || bucketsKey != key) {
+      for (const auto &bucket : bucketsOfKey)
+        result.append(bucket.second.begin(), bucket.second.end());
+      continue;
+    }
+
+    // Visit the buckets whose tiles are adjacent along all the dimensions of
+    // the vector.
+    unsigned rankOffset = transfer.getLeadingShapedRank();
+    SmallVector<int64_t> neighbor(*position);
+    for (unsigned i = rankOffset, e = neighbor.size(); i < e; ++i)
+      --neighbor[i];
+    while (true) {
+      auto it = bucketsOfKey.find(neighbor);
+      if (it != bucketsOfKey.end())
+        result.append(it->second.begin(), it->second.end());
+      unsigned i = neighbor.size();
+      for (; i > rankOffset; --i) {
+        if (++neighbor[i - 1] <= (*position)[i - 1] + 1)
+          break;
+        neighbor[i - 1] = (*position)[i - 1] - 1;
+      }
+      if (i == rankOffset)
+        break;
+    }
+  }
+}
+
+SmallVector<Operation *> TransferOptimization::getMayOverlapAccesses(
+    VectorTransferOpInterface transfer) {
+  Value memref = getBaseMemref(transfer.source());
+  std::unique_ptr<MemrefAccesses> &accesses = memrefAccesses[memref];
+  if (!accesses)
+    accesses = std::make_unique<MemrefAccesses>(memref);
+  SmallVector<Operation *> result;
+  accesses->getMayOverlapAccesses(transfer, result);
+  return result;
+}
+
 /// Return true if there is a path from start operation to dest operation,
 /// otherwise return false. The operations have to be in the same region.
 bool TransferOptimization::isReachable(Operation *start, Operation *dest) {
@@ -74,6 +211,9 @@ bool TransferOptimization::isReachable(Operation *start, Operation *dest) {
     return true;
   Block *startBlock = start->getBlock();
   Block *destBlock = dest->getBlock();
+  auto [it, inserted] = reachableBlocks.try_emplace({startBlock, destBlock});
+  if (!inserted)
+    return it->second;
   SmallVector<Block *, 32> worklist(startBlock->succ_begin(),
                                     startBlock->succ_end());
   SmallPtrSet<Block *, 32> visited;
@@ -82,7 +222,7 @@ bool TransferOptimization::isReachable(Operation *start, Operation *dest) {
     if (!visited.insert(bb).second)
       continue;
     if (dominators.dominates(bb, destBlock))
-      return true;
+      return it->second = true;
     worklist.append(bb->succ_begin(), bb->succ_end());
   }
   return false;
@@ -104,24 +244,8 @@ void TransferOptimization::deadStoreOp(vector::TransferWriteOp write) {
                     << "\n");
   llvm::SmallVector<Operation *, 8> blockingAccesses;
   Operation *firstOverwriteCandidate = nullptr;
-  Value source = write.getSource();
-  // Skip subview ops.
-  while (auto subView = source.getDefiningOp<memref::SubViewOp>())
-    source = subView.getSource();
-  llvm::SmallVector<Operation *, 32> users(source.getUsers().begin(),
-                                           source.getUsers().end());
-  llvm::SmallDenseSet<Operation *, 32> processed;
-  while (!users.empty()) {
-    Operation *user = users.pop_back_val();
-    // If the user has already been processed skip.
-    if (!processed.insert(user).second)
-      continue;
-    if (auto subView = dyn_cast<memref::SubViewOp>(user)) {
-      users.append(subView->getUsers().begin(), subView->getUsers().end());
-      continue;
-    }
-    if (isMemoryEffectFree(user))
-      continue;
+  for (Operation *user : getMayOverlapAccesses(
+           cast<VectorTransferOpInterface>(write.getOperation()))) {
     if (user == write.getOperation())
       continue;
     if (auto nextWrite = dyn_cast<vector::TransferWriteOp>(user)) {
@@ -190,23 +314,9 @@ void TransferOptimization::storeToLoadForwarding(vector::TransferReadOp read) {
                     << "\n");
   SmallVector<Operation *, 8> blockingWrites;
   vector::TransferWriteOp lastwrite = nullptr;
-  Value source = read.getSource();
-  // Skip subview ops.
-  while (auto subView = source.getDefiningOp<memref::SubViewOp>())
-    source = subView.getSource();
-  llvm::SmallVector<Operation *, 32> users(source.getUsers().begin(),
-                                           source.getUsers().end());
-  llvm::SmallDenseSet<Operation *, 32> processed;
-  while (!users.empty()) {
-    Operation *user = users.pop_back_val();
-    // If the user has already been processed skip.
-    if (!processed.insert(user).second)
-      continue;
-    if (auto subView = dyn_cast<memref::SubViewOp>(user)) {
-      users.append(subView->getUsers().begin(), subView->getUsers().end());
-      continue;
-    }
-    if (isMemoryEffectFree(user) || isa<vector::TransferReadOp>(user))
+  for (Operation *user : getMayOverlapAccesses(
+           cast<VectorTransferOpInterface>(read.getOperation()))) {
+    if (isa<vector::TransferReadOp>(user))
       continue;
     if (auto write = dyn_cast<vector::TransferWriteOp>(user)) {
       // If there is a write, but we can prove that it is disjoint we can ignore
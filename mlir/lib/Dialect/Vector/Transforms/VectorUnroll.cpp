@@ -11,9 +11,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/DLTI/DLTI.h"
 #include "mlir/Dialect/Utils/IndexingUtils.h"
 #include "mlir/Dialect/Vector/Transforms/VectorTransforms.h"
 #include "mlir/IR/ImplicitLocOpBuilder.h"
+#include "mlir/Interfaces/DataLayoutInterfaces.h"
 #include "mlir/Interfaces/VectorInterfaces.h"
 #include "mlir/Support/MathExtras.h"
 #include "llvm/ADT/MapVector.h"
@@ -724,6 +726,110 @@ private:
 
 } // namespace
 
+/// Returns the integer entry `key` of the closest data layout spec that
+/// encloses `op` and has such an entry, or zero if there is none.
+static int64_t lookupIntegerEntry(Operation *op, StringRef key) {
+  StringAttr identifier = StringAttr::get(op->getContext(), key);
+  for (Operation *parent = op; parent; parent = parent->getParentOp()) {
+    auto iface = dyn_cast<DataLayoutOpInterface>(parent);
+    if (!iface)
+      continue;
+    DataLayoutSpecInterface spec = iface.getDataLayoutSpec();
+    if (!spec)
+      continue;
+    if (DataLayoutEntryInterface entry = spec.getSpecForIdentifier(identifier))
+      if (auto value = dyn_cast<IntegerAttr>(entry.getValue()))
+        return value.getInt();
+  }
+  return 0;
+}
+
+VectorRegisterInfo mlir::vector::getVectorRegisterInfo(Operation *op) {
+  VectorRegisterInfo info;
+  info.vectorWidth =
+      lookupIntegerEntry(op, DLTIDialect::kDataLayoutVectorWidthKey);
+  info.numVectorRegisters =
+      lookupIntegerEntry(op, DLTIDialect::kDataLayoutNumVectorRegistersKey);
+  return info;
+}
+
+/// Returns the largest divisor of `size` that is at most `bound`.
+static int64_t getLargestDivisor(int64_t size, int64_t bound) {
+  for (int64_t divisor = std::min(size, bound); divisor > 1; --divisor)
+    if (size % divisor == 0)
+      return divisor;
+  return 1;
+}
+
+std::optional<SmallVector<int64_t>>
+mlir::vector::getRegisterNativeShape(Operation *op,
+                                     const VectorRegisterInfo &info) {
+  if (info.vectorWidth <= 0)
+    return std::nullopt;
+  auto unrollableOp = dyn_cast<VectorUnrollOpInterface>(op);
+  if (!unrollableOp)
+    return std::nullopt;
+  std::optional<SmallVector<int64_t>> shape = unrollableOp.getShapeForUnroll();
+  if (!shape || shape->empty())
+    return std::nullopt;
+
+  // The registers hold the elements of the accumulators of the
+  // contractions, and of the vectors of the transfers and element-wise ops.
+  Type type;
+  if (auto contractOp = dyn_cast<vector::ContractionOp>(op))
+    type = contractOp.getResultType();
+  else if (auto xferOp = dyn_cast<VectorTransferOpInterface>(op))
+    type = xferOp.getVectorType();
+  else if (OpTrait::hasElementwiseMappableTraits(op) &&
+           op->getNumResults() == 1)
+    type = op->getResult(0).getType();
+  else
+    return std::nullopt;
+  auto vectorType = dyn_cast<VectorType>(type);
+  if (vectorType && vectorType.isScalable())
+    return std::nullopt;
+  Type elementType = getElementTypeOrSelf(type);
+  int64_t elementBits = DataLayout::closest(op).getTypeSizeInBits(elementType);
+  int64_t lanes = std::max<int64_t>(1, info.vectorWidth / elementBits);
+
+  SmallVector<int64_t> nativeShape(shape->size(), 1);
+  auto contractOp = dyn_cast<vector::ContractionOp>(op);
+  if (!contractOp) {
+    nativeShape.back() = getLargestDivisor(shape->back(), lanes);
+    return nativeShape;
+  }
+
+  // Block the accumulators, and take one step of the reductions at a time.
+  AffineMap accMap = contractOp.getIndexingMapsArray()[2];
+  if (accMap.getNumResults() == 0) {
+    SmallVector<int64_t> reductionDims;
+    for (auto [dim, iteratorType] :
+         llvm::enumerate(contractOp.getIteratorTypesArray()))
+      if (iteratorType == IteratorType::reduction)
+        reductionDims.push_back(dim);
+    if (reductionDims.empty())
+      return std::nullopt;
+    int64_t dim = reductionDims.back();
+    nativeShape[dim] = getLargestDivisor((*shape)[dim], lanes);
+    return nativeShape;
+  }
+  unsigned innerDim = accMap.getDimPosition(accMap.getNumResults() - 1);
+  nativeShape[innerDim] = getLargestDivisor((*shape)[innerDim], lanes);
+  if (accMap.getNumResults() > 1) {
+    unsigned rowDim = accMap.getDimPosition(accMap.getNumResults() - 2);
+    int64_t numAccRegisters = std::max<int64_t>(1, info.numVectorRegisters / 2);
+    nativeShape[rowDim] = getLargestDivisor((*shape)[rowDim], numAccRegisters);
+  }
+  return nativeShape;
+}
+
+UnrollVectorOptions &UnrollVectorOptions::setNativeShapeFromDataLayout() {
+  nativeShape = [](Operation *op) {
+    return getRegisterNativeShape(op, getVectorRegisterInfo(op));
+  };
+  return *this;
+}
+
 void mlir::vector::populateVectorUnrollPatterns(
     RewritePatternSet &patterns, const UnrollVectorOptions &options,
     PatternBenefit benefit) {
@@ -13,17 +13,27 @@
 
 #include "mlir/ExecutionEngine/AsyncRuntime.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <condition_variable>
+#include <cstdlib>
+#include <deque>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <vector>
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include "llvm/ADT/StringMap.h"
-#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 
 using namespace mlir::runtime;
 
@@ -38,6 +48,251 @@ namespace {
 // Forward declare class defined below.
 class RefCounted;
 
+// -------------------------------------------------------------------------- //
+// Work-stealing scheduler executing the async runtime tasks.
+//
+// Every worker thread owns a task queue. Tasks scheduled from a worker thread
+// are pushed to its own queue and popped by the owner in LIFO order, which
+// keeps recently produced (cache-hot) tasks on the same core. Tasks scheduled
+// from other threads are distributed over the worker queues in a round-robin
+// fashion. Idle workers steal the oldest tasks from other queues, visiting the
+// nearest workers first: when threads are pinned, neighbouring workers run on
+// neighbouring cores, which typically share caches and the NUMA node.
+//
+// The scheduler is configured with environment variables:
+//
+//   MLIR_ASYNC_RUNTIME_NUM_THREADS  number of worker threads, defaults to the
+//                                   hardware concurrency.
+//   MLIR_ASYNC_RUNTIME_PIN_THREADS  if set to 1, pins the i-th worker thread
+//                                   to the i-th CPU available to the process
+//                                   (Linux only).
+//   MLIR_ASYNC_RUNTIME_HELP_ON_AWAIT
+//                                   if set to 1, worker threads blocked in
+//                                   `mlirAsyncRuntimeAwait*` execute pending
+//                                   tasks on the current thread instead of
+//                                   going to sleep.
+// -------------------------------------------------------------------------- //
+
+class WorkStealingScheduler {
+public:
+  using Task = std::function<void()>;
+
+  WorkStealingScheduler(unsigned numThreads, bool pinThreads);
+  ~WorkStealingScheduler();
+
+  WorkStealingScheduler(const WorkStealingScheduler &) = delete;
+  WorkStealingScheduler &operator=(const WorkStealingScheduler &) = delete;
+
+  // Schedules `task` for execution on one of the worker threads.
+  void async(Task task);
+
+  // Runs one pending task on the calling worker thread. Returns false if there
+  // was no task to run.
+  bool runPendingTask();
+
+  // Returns true if the calling thread is a worker thread of this scheduler.
+  bool isWorkerThread() const { return currentScheduler == this; }
+
+  // Waits for the completion of all scheduled tasks, including the tasks
+  // scheduled while waiting. Must not be called from a worker thread.
+  void wait();
+
+  unsigned getThreadCount() const { return workers.size(); }
+
+private:
+  struct Worker {
+    std::mutex mu;
+    std::deque<Task> tasks;
+    std::thread thread;
+  };
+
+  void workerLoop(unsigned index, bool pinThread);
+
+  // Pops a task from the queue of the worker `index`, or steals one from the
+  // other workers if its queue is empty.
+  std::optional<Task> popOrSteal(unsigned index);
+
+  // Runs the task and signals `wait` if it was the last unfinished task.
+  void run(Task &task);
+
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  // Index of the worker queue receiving the next task scheduled from outside
+  // of the worker threads.
+  std::atomic<unsigned> nextWorker{0};
+
+  // Number of tasks that are scheduled but did not complete yet, and number
+  // of tasks sitting in the worker queues.
+  std::atomic<int64_t> numUnfinishedTasks{0};
+  std::atomic<int64_t> numQueuedTasks{0};
+
+  // Idle workers sleep on `sleepCv`. Producers only take `sleepMu` to notify
+  // them when `numSleepingWorkers` is non-zero, so that scheduling a task on a
+  // busy runtime does not touch any global lock.
+  std::mutex sleepMu;
+  std::condition_variable sleepCv;
+  std::condition_variable completionCv;
+  std::atomic<int> numSleepingWorkers{0};
+  bool shutdown = false;
+
+  static thread_local WorkStealingScheduler *currentScheduler;
+  static thread_local unsigned currentWorkerIndex;
+};
+
+thread_local WorkStealingScheduler *WorkStealingScheduler::currentScheduler =
+    nullptr;
+thread_local unsigned WorkStealingScheduler::currentWorkerIndex = 0;
+
+WorkStealingScheduler::WorkStealingScheduler(unsigned numThreads,
+                                             bool pinThreads) {
+  numThreads = std::max(1u, numThreads);
+  workers.reserve(numThreads);
+  for (unsigned i = 0; i < numThreads; ++i)
+    workers.push_back(std::make_unique<Worker>());
+  for (unsigned i = 0; i < numThreads; ++i)
+    workers[i]->thread =
+        std::thread([this, i, pinThreads] { workerLoop(i, pinThreads); });
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+  wait();
+  {
+    std::unique_lock<std::mutex> lock(sleepMu);
+    shutdown = true;
+  }
+  sleepCv.notify_all();
+  for (auto &worker : workers)
+    worker->thread.join();
+}
+
+void WorkStealingScheduler::async(Task task) {
+  unsigned index = isWorkerThread()
+                       ? currentWorkerIndex
+                       : nextWorker.fetch_add(1, std::memory_order_relaxed) %
+                             workers.size();
+  numUnfinishedTasks.fetch_add(1);
+  {
+    Worker &worker = *workers[index];
+    std::unique_lock<std::mutex> lock(worker.mu);
+    worker.tasks.push_back(std::move(task));
+  }
+  numQueuedTasks.fetch_add(1);
+
+  // Sleeping workers check `numQueuedTasks` after registering themselves in
+  // `numSleepingWorkers`, so either they observe the new task or we observe
+  // them and wake one up.
+  if (numSleepingWorkers.load() > 0) {
+    { std::unique_lock<std::mutex> lock(sleepMu); }
+    sleepCv.notify_one();
+  }
+}
+
+std::optional<WorkStealingScheduler::Task>
+WorkStealingScheduler::popOrSteal(unsigned index) {
+  // Pop the most recently scheduled task from the own queue.
+  {
+    Worker &worker = *workers[index];
+    std::unique_lock<std::mutex> lock(worker.mu);
+    if (!worker.tasks.empty()) {
+      Task task = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+      numQueuedTasks.fetch_sub(1);
+      return task;
+    }
+  }
+
+  // Steal the oldest task of another worker, nearest workers first. Busy
+  // queues are skipped rather than waited for.
+  unsigned numWorkers = workers.size();
+  for (unsigned distance = 1; distance < numWorkers; ++distance) {
+    unsigned victim = (distance % 2)
+                          ? (index + (distance + 1) / 2) % numWorkers
+                          : (index + numWorkers - distance / 2) % numWorkers;
+    Worker &worker = *workers[victim];
+    std::unique_lock<std::mutex> lock(worker.mu, std::try_to_lock);
+    if (!lock.owns_lock() || worker.tasks.empty())
+      continue;
+    Task task = std::move(worker.tasks.front());
+    worker.tasks.pop_front();
+    numQueuedTasks.fetch_sub(1);
+    return task;
+  }
+
+  return std::nullopt;
+}
+
+void WorkStealingScheduler::run(Task &task) {
+  task();
+  if (numUnfinishedTasks.fetch_sub(1) == 1) {
+    { std::unique_lock<std::mutex> lock(sleepMu); }
+    completionCv.notify_all();
+  }
+}
+
+bool WorkStealingScheduler::runPendingTask() {
+  assert(isWorkerThread() && "must be called from a worker thread");
+  std::optional<Task> task = popOrSteal(currentWorkerIndex);
+  if (!task)
+    return false;
+  run(*task);
+  return true;
+}
+
+void WorkStealingScheduler::wait() {
+  assert(!isWorkerThread() && "wait must not be called from a worker thread");
+  std::unique_lock<std::mutex> lock(sleepMu);
+  completionCv.wait(lock, [this] { return numUnfinishedTasks.load() == 0; });
+}
+
+void WorkStealingScheduler::workerLoop(unsigned index, bool pinThread) {
+  currentScheduler = this;
+  currentWorkerIndex = index;
+
+#if defined(__linux__)
+  // Pin the worker to the index-th CPU of the process affinity mask.
+  cpu_set_t available;
+  if (pinThread && sched_getaffinity(0, sizeof(available), &available) == 0) {
+    int numAvailable = CPU_COUNT(&available);
+    for (int cpu = 0, seen = 0; numAvailable > 0 && cpu < CPU_SETSIZE; ++cpu) {
+      if (!CPU_ISSET(cpu, &available) ||
+          seen++ != static_cast<int>(index % numAvailable))
+        continue;
+      cpu_set_t pinned;
+      CPU_ZERO(&pinned);
+      CPU_SET(cpu, &pinned);
+      pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned);
+      break;
+    }
+  }
+#else
+  (void)pinThread;
+#endif
+
+  while (true) {
+    if (std::optional<Task> task = popOrSteal(index)) {
+      run(*task);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleepMu);
+    numSleepingWorkers.fetch_add(1);
+    sleepCv.wait(lock,
+                 [this] { return shutdown || numQueuedTasks.load() > 0; });
+    numSleepingWorkers.fetch_sub(1);
+    if (shutdown)
+      return;
+  }
+}
+
+// Returns the value of the environment variable `name` parsed as an unsigned
+// integer, or `defaultValue` if the variable is not set.
+static unsigned getEnvUnsigned(const char *name, unsigned defaultValue) {
+  const char *value = std::getenv(name);
+  if (!value || !*value)
+    return defaultValue;
+  return static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+}
+
 // -------------------------------------------------------------------------- //
 // AsyncRuntime orchestrates all async operations and Async runtime API is built
 // on top of the default runtime instance.
@@ -45,10 +300,16 @@ class RefCounted;
 
 class AsyncRuntime {
 public:
-  AsyncRuntime() : numRefCountedObjects(0) {}
+  AsyncRuntime()
+      : numRefCountedObjects(0),
+        helpOnAwait(getEnvUnsigned("MLIR_ASYNC_RUNTIME_HELP_ON_AWAIT", 0)),
+        scheduler(getEnvUnsigned(
+                      "MLIR_ASYNC_RUNTIME_NUM_THREADS",
+                      llvm::hardware_concurrency().compute_thread_count()),
+                  getEnvUnsigned("MLIR_ASYNC_RUNTIME_PIN_THREADS", 0)) {}
 
   ~AsyncRuntime() {
-    threadPool.wait(); // wait for the completion of all async tasks
+    scheduler.wait(); // wait for the completion of all async tasks
     assert(getNumRefCountedObjects() == 0 &&
            "all ref counted objects must be destroyed");
   }
@@ -57,7 +318,11 @@ public:
     return numRefCountedObjects.load(std::memory_order_relaxed);
   }
 
-  llvm::ThreadPool &getThreadPool() { return threadPool; }
+  WorkStealingScheduler &getScheduler() { return scheduler; }
+
+  // Returns true if blocking awaits on worker threads should execute pending
+  // tasks while waiting.
+  bool shouldHelpOnAwait() const { return helpOnAwait; }
 
 private:
   friend class RefCounted;
@@ -72,7 +337,8 @@ private:
   }
 
   std::atomic<int64_t> numRefCountedObjects;
-  llvm::ThreadPool threadPool;
+  bool helpOnAwait;
+  WorkStealingScheduler scheduler;
 };
 
 // -------------------------------------------------------------------------- //
@@ -167,8 +433,62 @@ static AsyncRuntime *getDefaultAsyncRuntime() {
   return getDefaultAsyncRuntimeInstance().get();
 }
 
+// -------------------------------------------------------------------------- //
+// Pooled allocation of runtime objects. Every thread caches a bounded number of
+// freed objects of each type, so that creating and destroying tokens, values
+// and groups in a steady state does not go through the global heap.
+// -------------------------------------------------------------------------- //
+
+template <typename T>
+class ObjectPool {
+public:
+  static void *allocate() {
+    std::vector<void *> &objects = getFreeList().objects;
+    if (objects.empty())
+      return ::operator new(sizeof(T));
+    void *ptr = objects.back();
+    objects.pop_back();
+    return ptr;
+  }
+
+  static void deallocate(void *ptr) {
+    std::vector<void *> &objects = getFreeList().objects;
+    if (objects.size() >= kMaxCachedObjects)
+      return ::operator delete(ptr);
+    objects.push_back(ptr);
+  }
+
+private:
+  static constexpr size_t kMaxCachedObjects = 1024;
+
+  struct FreeList {
+    ~FreeList() {
+      for (void *ptr : objects)
+        ::operator delete(ptr);
+    }
+    std::vector<void *> objects;
+  };
+
+  static FreeList &getFreeList() {
+    static thread_local FreeList freeList;
+    return freeList;
+  }
+};
+
+// Routes `new` and `delete` of the derived class through its object pool.
+template <typename Derived>
+struct PoolAllocated {
+  static void *operator new(size_t size) {
+    assert(size == sizeof(Derived) && "unexpected object size");
+    return ObjectPool<Derived>::allocate();
+  }
+  static void operator delete(void *ptr) {
+    ObjectPool<Derived>::deallocate(ptr);
+  }
+};
+
 // Async token provides a mechanism to signal asynchronous operation completion.
-struct AsyncToken : public RefCounted {
+struct AsyncToken : public RefCounted, public PoolAllocated<AsyncToken> {
   // AsyncToken created with a reference count of 2 because it will be returned
   // to the `async.execute` caller and also will be later on emplaced by the
   // asynchronously executed task. If the caller immediately will drop its
@@ -177,8 +497,14 @@ struct AsyncToken : public RefCounted {
   AsyncToken(AsyncRuntime *runtime)
       : RefCounted(runtime, /*refCount=*/2), state(State::kUnavailable) {}
 
+  bool isReady() const { return State(state.load()).isAvailableOrError(); }
+
   std::atomic<State::StateEnum> state;
 
+  // Number of awaiters registered so far. The thread emplacing the token only
+  // takes the mutex if it is non-zero.
+  std::atomic<int> numAwaiters{0};
+
   // Pending awaiters are guarded by a mutex.
   std::mutex mu;
   std::condition_variable cv;
@@ -188,17 +514,22 @@ struct AsyncToken : public RefCounted {
 // Async value provides a mechanism to access the result of asynchronous
 // operations. It owns the storage that is used to store/load the value of the
 // underlying type, and a flag to signal if the value is ready or not.
-struct AsyncValue : public RefCounted {
+struct AsyncValue : public RefCounted, public PoolAllocated<AsyncValue> {
   // AsyncValue similar to an AsyncToken created with a reference count of 2.
   AsyncValue(AsyncRuntime *runtime, int64_t size)
       : RefCounted(runtime, /*refCount=*/2), state(State::kUnavailable),
         storage(size) {}
 
+  bool isReady() const { return State(state.load()).isAvailableOrError(); }
+
   std::atomic<State::StateEnum> state;
 
   // Use vector of bytes to store async value payload.
   std::vector<std::byte> storage;
 
+  // Number of awaiters registered so far (see AsyncToken).
+  std::atomic<int> numAwaiters{0};
+
   // Pending awaiters are guarded by a mutex.
   std::mutex mu;
   std::condition_variable cv;
@@ -208,20 +539,61 @@ struct AsyncValue : public RefCounted {
 // Async group provides a mechanism to group together multiple async tokens or
 // values to await on all of them together (wait for the completion of all
 // tokens or values added to the group).
-struct AsyncGroup : public RefCounted {
+struct AsyncGroup : public RefCounted, public PoolAllocated<AsyncGroup> {
   AsyncGroup(AsyncRuntime *runtime, int64_t size)
       : RefCounted(runtime), pendingTokens(size), numErrors(0), rank(0) {}
 
+  bool isReady() const { return pendingTokens.load() == 0; }
+
   std::atomic<int> pendingTokens;
   std::atomic<int> numErrors;
   std::atomic<int> rank;
 
+  // Number of awaiters registered so far (see AsyncToken).
+  std::atomic<int> numAwaiters{0};
+
   // Pending awaiters are guarded by a mutex.
   std::mutex mu;
   std::condition_variable cv;
   std::vector<std::function<void()>> awaiters;
 };
 
+// -------------------------------------------------------------------------- //
+// Ready/error transitions of tokens, values and groups are published through
+// their atomic state. Awaiters increment `numAwaiters` and then check the
+// state, while the thread making an object ready updates the state and then
+// checks `numAwaiters` (both sequentially consistent), so at least one of them
+// observes the other: uncontended transitions and awaits on ready objects do
+// not take the mutex, and the condition variable is only used by threads that
+// actually block.
+// -------------------------------------------------------------------------- //
+
+// Runs `awaiter` once `obj` is ready: immediately on the calling thread if it
+// already is, or later on the thread making it ready.
+template <typename Obj, typename Awaiter>
+static void addAwaiter(Obj *obj, Awaiter awaiter) {
+  std::unique_lock<std::mutex> lock(obj->mu);
+  obj->numAwaiters.fetch_add(1);
+  if (obj->isReady()) {
+    lock.unlock();
+    awaiter();
+    return;
+  }
+  obj->awaiters.emplace_back(std::move(awaiter));
+}
+
+// Wakes up blocked threads and runs all registered awaiters. Must be called
+// after the state of `obj` became ready.
+template <typename Obj>
+static void notifyAwaiters(Obj *obj) {
+  if (obj->numAwaiters.load() == 0)
+    return;
+  std::unique_lock<std::mutex> lock(obj->mu);
+  obj->cv.notify_all();
+  for (auto &awaiter : obj->awaiters)
+    awaiter();
+}
+
 // Adds references to reference counted runtime object.
 extern "C" void mlirAsyncRuntimeAddRef(RefCountedObjPtr ptr, int64_t count) {
   RefCounted *refCounted = static_cast<RefCounted *>(ptr);
@@ -254,13 +626,13 @@ extern "C" AsyncGroup *mlirAsyncRuntimeCreateGroup(int64_t size) {
 
 extern "C" int64_t mlirAsyncRuntimeAddTokenToGroup(AsyncToken *token,
                                                    AsyncGroup *group) {
-  std::unique_lock<std::mutex> lockToken(token->mu);
-  std::unique_lock<std::mutex> lockGroup(group->mu);
-
   // Get the rank of the token inside the group before we drop the reference.
   int rank = group->rank.fetch_add(1);
 
-  auto onTokenReady = [group, token]() {
+  // Update group pending tokens when token will become ready. Because this
+  // may happen asynchronously we must ensure that `group` is alive until then.
+  group->addRef();
+  addAwaiter(token, [group, token]() {
     // Increment the number of errors in the group.
     if (State(token->state).isError())
       group->numErrors.fetch_add(1);
@@ -270,32 +642,10 @@ extern "C" int64_t mlirAsyncRuntimeAddTokenToGroup(AsyncToken *token,
     assert(group->pendingTokens > 0 && "wrong group size");
 
     // Run all group awaiters if it was the last token in the group.
-    if (group->pendingTokens.fetch_sub(1) == 1) {
-      group->cv.notify_all();
-      for (auto &awaiter : group->awaiters)
-        awaiter();
-    }
-  };
-
-  if (State(token->state).isAvailableOrError()) {
-    // Update group pending tokens immediately and maybe run awaiters.
-    onTokenReady();
-
-  } else {
-    // Update group pending tokens when token will become ready. Because this
-    // will happen asynchronously we must ensure that `group` is alive until
-    // then, and re-ackquire the lock.
-    group->addRef();
-
-    token->awaiters.emplace_back([group, onTokenReady]() {
-      // Make sure that `dropRef` does not destroy the mutex owned by the lock.
-      {
-        std::unique_lock<std::mutex> lockGroup(group->mu);
-        onTokenReady();
-      }
-      group->dropRef();
-    });
-  }
+    if (group->pendingTokens.fetch_sub(1) == 1)
+      notifyAwaiters(group);
+    group->dropRef();
+  });
 
   return rank;
 }
@@ -306,14 +656,8 @@ static void setTokenState(AsyncToken *token, State state) {
   assert(state.isAvailableOrError() && "must be terminal state");
   assert(State(token->state).isUnavailable() && "token must be unavailable");
 
-  // Make sure that `dropRef` does not destroy the mutex owned by the lock.
-  {
-    std::unique_lock<std::mutex> lock(token->mu);
-    token->state = state;
-    token->cv.notify_all();
-    for (auto &awaiter : token->awaiters)
-      awaiter();
-  }
+  token->state = state;
+  notifyAwaiters(token);
 
   // Async tokens created with a ref count `2` to keep token alive until the
   // async task completes. Drop this reference explicitly when token emplaced.
@@ -324,14 +668,8 @@ static void setValueState(AsyncValue *value, State state) {
   assert(state.isAvailableOrError() && "must be terminal state");
   assert(State(value->state).isUnavailable() && "value must be unavailable");
 
-  // Make sure that `dropRef` does not destroy the mutex owned by the lock.
-  {
-    std::unique_lock<std::mutex> lock(value->mu);
-    value->state = state;
-    value->cv.notify_all();
-    for (auto &awaiter : value->awaiters)
-      awaiter();
-  }
+  value->state = state;
+  notifyAwaiters(value);
 
   // Async values created with a ref count `2` to keep value alive until the
   // async task completes. Drop this reference explicitly when value emplaced.
@@ -366,24 +704,37 @@ extern "C" bool mlirAsyncRuntimeIsGroupError(AsyncGroup *group) {
   return group->numErrors.load() > 0;
 }
 
+// Blocks the caller until `obj` is ready. If enabled, worker threads keep
+// executing pending tasks while waiting instead of going to sleep.
+template <typename Obj>
+static void awaitReady(Obj *obj) {
+  if (obj->isReady())
+    return;
+
+  AsyncRuntime *runtime = getDefaultAsyncRuntime();
+  WorkStealingScheduler &scheduler = runtime->getScheduler();
+  if (runtime->shouldHelpOnAwait() && scheduler.isWorkerThread()) {
+    while (!obj->isReady())
+      if (!scheduler.runPendingTask())
+        std::this_thread::yield();
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(obj->mu);
+  obj->numAwaiters.fetch_add(1);
+  obj->cv.wait(lock, [obj] { return obj->isReady(); });
+}
+
 extern "C" void mlirAsyncRuntimeAwaitToken(AsyncToken *token) {
-  std::unique_lock<std::mutex> lock(token->mu);
-  if (!State(token->state).isAvailableOrError())
-    token->cv.wait(
-        lock, [token] { return State(token->state).isAvailableOrError(); });
+  awaitReady(token);
 }
 
 extern "C" void mlirAsyncRuntimeAwaitValue(AsyncValue *value) {
-  std::unique_lock<std::mutex> lock(value->mu);
-  if (!State(value->state).isAvailableOrError())
-    value->cv.wait(
-        lock, [value] { return State(value->state).isAvailableOrError(); });
+  awaitReady(value);
 }
 
 extern "C" void mlirAsyncRuntimeAwaitAllInGroup(AsyncGroup *group) {
-  std::unique_lock<std::mutex> lock(group->mu);
-  if (group->pendingTokens != 0)
-    group->cv.wait(lock, [group] { return group->pendingTokens == 0; });
+  awaitReady(group);
 }
 
 // Returns a pointer to the storage owned by the async value.
@@ -394,50 +745,29 @@ extern "C" ValueStorage mlirAsyncRuntimeGetValueStorage(AsyncValue *value) {
 
 extern "C" void mlirAsyncRuntimeExecute(CoroHandle handle, CoroResume resume) {
   auto *runtime = getDefaultAsyncRuntime();
-  runtime->getThreadPool().async([handle, resume]() { (*resume)(handle); });
+  runtime->getScheduler().async([handle, resume]() { (*resume)(handle); });
 }
 
 extern "C" void mlirAsyncRuntimeAwaitTokenAndExecute(AsyncToken *token,
                                                      CoroHandle handle,
                                                      CoroResume resume) {
-  auto execute = [handle, resume]() { (*resume)(handle); };
-  std::unique_lock<std::mutex> lock(token->mu);
-  if (State(token->state).isAvailableOrError()) {
-    lock.unlock();
-    execute();
-  } else {
-    token->awaiters.emplace_back([execute]() { execute(); });
-  }
+  addAwaiter(token, [handle, resume]() { (*resume)(handle); });
 }
 
 extern "C" void mlirAsyncRuntimeAwaitValueAndExecute(AsyncValue *value,
                                                      CoroHandle handle,
                                                      CoroResume resume) {
-  auto execute = [handle, resume]() { (*resume)(handle); };
-  std::unique_lock<std::mutex> lock(value->mu);
-  if (State(value->state).isAvailableOrError()) {
-    lock.unlock();
-    execute();
-  } else {
-    value->awaiters.emplace_back([execute]() { execute(); });
-  }
+  addAwaiter(value, [handle, resume]() { (*resume)(handle); });
 }
 
 extern "C" void mlirAsyncRuntimeAwaitAllInGroupAndExecute(AsyncGroup *group,
                                                           CoroHandle handle,
                                                           CoroResume resume) {
-  auto execute = [handle, resume]() { (*resume)(handle); };
-  std::unique_lock<std::mutex> lock(group->mu);
-  if (group->pendingTokens == 0) {
-    lock.unlock();
-    execute();
-  } else {
-    group->awaiters.emplace_back([execute]() { execute(); });
-  }
+  addAwaiter(group, [handle, resume]() { (*resume)(handle); });
 }
 
 extern "C" int64_t mlirAsyncRuntimGetNumWorkerThreads() {
-  return getDefaultAsyncRuntime()->getThreadPool().getThreadCount();
+  return getDefaultAsyncRuntime()->getScheduler().getThreadCount();
 }
 
 //===----------------------------------------------------------------------===//
@@ -21,17 +21,33 @@
 #else
 #include <alloca.h>
 #endif
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/time.h>
+#include <unistd.h>
 #else
 #include "malloc.h"
 #endif // _WIN32
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cinttypes>
 #include <cstdio>
 #include <cstdlib>
+#include <functional>
 #include <random>
 #include <string.h>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #ifdef MLIR_CRUNNERUTILS_DEFINE_FUNCTIONS
 
@@ -41,6 +57,116 @@ void stdSort(uint64_t n, V *p) {
   std::sort(p, p + n);
 }
 
+/// The minimal number of elements sorted by each thread of a parallel sort.
+constexpr uint64_t kMinParallelSortElements = 1 << 16;
+
+/// Runs `fn(0)`, ..., `fn(n - 1)` on `n` threads, the first one being the
+/// calling thread.
+template <typename Fn>
+void runInParallel(uint64_t n, Fn fn) {
+  std::vector<std::thread> threads;
+  threads.reserve(n - 1);
+  for (uint64_t i = 1; i < n; ++i)
+    threads.emplace_back(fn, i);
+  fn(0);
+  for (std::thread &thread : threads)
+    thread.join();
+}
+
+/// Sorts the `n` elements of `p` with a stable merge sort: the chunks of the
+/// threads are sorted in parallel, then merged pairwise in parallel rounds.
+template <typename V, typename Compare>
+void parallelSort(uint64_t n, V *p, Compare cmp) {
+  uint64_t numThreads =
+      std::min<uint64_t>(std::thread::hardware_concurrency(),
+                         n / kMinParallelSortElements);
+  if (numThreads <= 1) {
+    std::stable_sort(p, p + n, cmp);
+    return;
+  }
+  std::vector<uint64_t> bounds(numThreads + 1);
+  for (uint64_t i = 0; i <= numThreads; ++i)
+    bounds[i] = n * i / numThreads;
+  runInParallel(numThreads, [&](uint64_t i) {
+    std::stable_sort(p + bounds[i], p + bounds[i + 1], cmp);
+  });
+  for (uint64_t width = 1; width < numThreads; width *= 2) {
+    uint64_t numMerges = (numThreads + 2 * width - 1) / (2 * width);
+    runInParallel(numMerges, [&](uint64_t i) {
+      uint64_t lo = 2 * width * i;
+      uint64_t mid = std::min(lo + width, numThreads);
+      uint64_t hi = std::min(lo + 2 * width, numThreads);
+      if (mid < hi)
+        std::inplace_merge(p + bounds[lo], p + bounds[mid], p + bounds[hi],
+                           cmp);
+    });
+  }
+}
+
+/// Sorts the `n` unsigned integers of `p` with a least significant digit
+/// radix sort on bytes, which skips the bytes shared by all the keys.
+template <typename V>
+void radixSort(uint64_t n, V *p) {
+  static_assert(std::is_unsigned<V>::value, "expected unsigned keys");
+  if (n <= 1)
+    return;
+  std::vector<V> buffer(n);
+  V *src = p;
+  V *dst = buffer.data();
+  for (unsigned shift = 0; shift < sizeof(V) * 8; shift += 8) {
+    uint64_t offsets[256] = {0};
+    for (uint64_t i = 0; i < n; ++i)
+      ++offsets[(src[i] >> shift) & 0xff];
+    if (offsets[(src[0] >> shift) & 0xff] == n)
+      continue;
+    uint64_t sum = 0;
+    for (uint64_t &offset : offsets) {
+      uint64_t count = offset;
+      offset = sum;
+      sum += count;
+    }
+    for (uint64_t i = 0; i < n; ++i)
+      dst[offsets[(src[i] >> shift) & 0xff]++] = src[i];
+    std::swap(src, dst);
+  }
+  if (src != p)
+    std::copy(src, src + n, p);
+}
+
+/// Moves the `k` largest of the `n` elements of `p` to its front, in
+/// decreasing order. The order of the other elements is unspecified.
+template <typename V>
+void topK(uint64_t n, uint64_t k, V *p) {
+  k = std::min(k, n);
+  if (k == 0)
+    return;
+  std::nth_element(p, p + k - 1, p + n, std::greater<V>());
+  std::sort(p, p + k, std::greater<V>());
+}
+
+/// Sorts the `n` records of `xy`, made of `nx` keys followed by `ny` other
+/// values, in the lexicographic order of their keys, and permutes the `n`
+/// values of `y`, if any, along with them. The sort is stable.
+template <typename V>
+void sortCOO(uint64_t n, uint64_t nx, uint64_t ny, uint64_t *xy, V *y) {
+  uint64_t stride = nx + ny;
+  std::vector<uint64_t> perm(n);
+  for (uint64_t i = 0; i < n; ++i)
+    perm[i] = i;
+  parallelSort(n, perm.data(), [&](uint64_t i, uint64_t j) {
+    return std::lexicographical_compare(xy + i * stride, xy + i * stride + nx,
+                                        xy + j * stride, xy + j * stride + nx);
+  });
+  std::vector<uint64_t> records(xy, xy + n * stride);
+  for (uint64_t i = 0; i < n; ++i)
+    std::copy_n(records.data() + perm[i] * stride, stride, xy + i * stride);
+  if (!y)
+    return;
+  std::vector<V> values(y, y + n);
+  for (uint64_t i = 0; i < n; ++i)
+    y[i] = values[perm[i]];
+}
+
 } // namespace
 
 // Small runtime support "lib" for vector.print lowering.
@@ -56,27 +182,141 @@ extern "C" void printClose() { fputs(" )", stdout); }
 extern "C" void printComma() { fputs(", ", stdout); }
 extern "C" void printNewline() { fputc('\n', stdout); }
 
-extern "C" void memrefCopy(int64_t elemSize, UnrankedMemRefType<char> *srcArg,
-                           UnrankedMemRefType<char> *dstArg) {
-  DynamicMemRefType<char> src(*srcArg);
-  DynamicMemRefType<char> dst(*dstArg);
+namespace {
+/// The maximal rank of the copies handled by the blocked kernels, after the
+/// unit dimensions are dropped and the contiguous dimensions are merged.
+constexpr int64_t kMaxBlockedCopyRank = 8;
+/// The side of the square tiles in which the 2-D strided copies are done, in
+/// elements, so that both the reads and the writes of a tile reuse their
+/// cache lines.
+constexpr int64_t kCopyTileSize = 16;
+/// The minimal number of bytes copied by each thread of a parallel copy.
+constexpr int64_t kMinParallelCopyBytes = 1 << 20;
 
-  int64_t rank = src.rank;
-  MLIR_MSAN_MEMORY_IS_INITIALIZED(src.sizes, rank * sizeof(int64_t));
+/// A strided copy, with the strides in bytes.
+struct StridedCopy {
+  int64_t elemSize;
+  int64_t rank;
+  int64_t sizes[kMaxBlockedCopyRank];
+  int64_t srcStrides[kMaxBlockedCopyRank];
+  int64_t dstStrides[kMaxBlockedCopyRank];
+};
 
-  // Handle empty shapes -> nothing to copy.
-  for (int rankp = 0; rankp < rank; ++rankp)
-    if (src.sizes[rankp] == 0)
-      return;
-
-  char *srcPtr = src.data + src.offset * elemSize;
-  char *dstPtr = dst.data + dst.offset * elemSize;
+/// Copies the `rows` x `cols` elements of `elemSize` bytes, or of `N` bytes
+/// when `N` is not zero, from `src` to `dst` with the given strides in bytes.
+template <int64_t N>
+void copy2D(char *dst, const char *src, int64_t elemSize, int64_t rows,
+            int64_t cols, int64_t srcRowStride, int64_t srcColStride,
+            int64_t dstRowStride, int64_t dstColStride) {
+  const int64_t size = N ? N : elemSize;
+  if (srcColStride == size && dstColStride == size) {
+    for (int64_t r = 0; r < rows; ++r)
+      memcpy(dst + r * dstRowStride, src + r * srcRowStride, cols * size);
+    return;
+  }
+  // The elements are copied with a constant size when it is known, which
+  // compiles to plain loads and stores that do not assume an alignment.
+  for (int64_t r0 = 0; r0 < rows; r0 += kCopyTileSize) {
+    int64_t rEnd = std::min(r0 + kCopyTileSize, rows);
+    for (int64_t c0 = 0; c0 < cols; c0 += kCopyTileSize) {
+      int64_t cEnd = std::min(c0 + kCopyTileSize, cols);
+      for (int64_t r = r0; r < rEnd; ++r) {
+        const char *srcRow = src + r * srcRowStride;
+        char *dstRow = dst + r * dstRowStride;
+        for (int64_t c = c0; c < cEnd; ++c)
+          memcpy(dstRow + c * dstColStride, srcRow + c * srcColStride, size);
+      }
+    }
+  }
+}
 
-  if (rank == 0) {
-    memcpy(dstPtr, srcPtr, elemSize);
+/// Copies `copy` from `src` to `dst`, with the 2-D kernel for the element
+/// size `N` on its two innermost dimensions.
+template <int64_t N>
+void copyStrided(const StridedCopy &copy, char *dst, const char *src) {
+  int64_t rank = copy.rank;
+  if (rank == 1) {
+    copy2D<N>(dst, src, copy.elemSize, 1, copy.sizes[0], 0,
+              copy.srcStrides[0], 0, copy.dstStrides[0]);
     return;
   }
+  int64_t indices[kMaxBlockedCopyRank] = {0};
+  int64_t readIndex = 0, writeIndex = 0;
+  for (;;) {
+    copy2D<N>(dst + writeIndex, src + readIndex, copy.elemSize,
+              copy.sizes[rank - 2], copy.sizes[rank - 1],
+              copy.srcStrides[rank - 2], copy.srcStrides[rank - 1],
+              copy.dstStrides[rank - 2], copy.dstStrides[rank - 1]);
+    // Advance the indices of the outer dimensions.
+    int64_t axis = rank - 3;
+    for (; axis >= 0; --axis) {
+      readIndex += copy.srcStrides[axis];
+      writeIndex += copy.dstStrides[axis];
+      if (++indices[axis] != copy.sizes[axis])
+        break;
+      indices[axis] = 0;
+      readIndex -= copy.sizes[axis] * copy.srcStrides[axis];
+      writeIndex -= copy.sizes[axis] * copy.dstStrides[axis];
+    }
+    if (axis < 0)
+      return;
+  }
+}
+
+/// Copies `copy` from `src` to `dst` with the kernel of its element size.
+void copyStrided(const StridedCopy &copy, char *dst, const char *src) {
+  switch (copy.elemSize) {
+  case 1:
+    return copyStrided<1>(copy, dst, src);
+  case 2:
+    return copyStrided<2>(copy, dst, src);
+  case 4:
+    return copyStrided<4>(copy, dst, src);
+  case 8:
+    return copyStrided<8>(copy, dst, src);
+  case 16:
+    return copyStrided<16>(copy, dst, src);
+  default:
+    return copyStrided<0>(copy, dst, src);
+  }
+}
+
+/// Copies `copy` from `src` to `dst`, splitting its outermost dimension
+/// between threads when it is large enough.
+void copyStridedInParallel(const StridedCopy &copy, char *dst,
+                           const char *src) {
+  int64_t numBytes = copy.elemSize;
+  for (int64_t i = 0; i < copy.rank; ++i)
+    numBytes *= copy.sizes[i];
+  int64_t numThreads = std::min<int64_t>(
+      {static_cast<int64_t>(std::thread::hardware_concurrency()),
+       copy.sizes[0], numBytes / kMinParallelCopyBytes});
+  if (numThreads <= 1)
+    return copyStrided(copy, dst, src);
 
+  // Each thread copies a contiguous range of the outermost dimension.
+  auto copyRange = [&](int64_t thread) {
+    int64_t begin = copy.sizes[0] * thread / numThreads;
+    int64_t end = copy.sizes[0] * (thread + 1) / numThreads;
+    StridedCopy range = copy;
+    range.sizes[0] = end - begin;
+    copyStrided(range, dst + begin * copy.dstStrides[0],
+                src + begin * copy.srcStrides[0]);
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+  for (int64_t thread = 1; thread < numThreads; ++thread)
+    threads.emplace_back(copyRange, thread);
+  copyRange(0);
+  for (std::thread &thread : threads)
+    thread.join();
+}
+
+/// Copies the elements of `src` to `dst` one by one, in the order of their
+/// indices.
+void copyElementwise(int64_t elemSize, int64_t rank, const int64_t *sizes,
+                     char *srcPtr, const int64_t *srcStridesArg, char *dstPtr,
+                     const int64_t *dstStridesArg) {
   int64_t *indices = static_cast<int64_t *>(alloca(sizeof(int64_t) * rank));
   int64_t *srcStrides = static_cast<int64_t *>(alloca(sizeof(int64_t) * rank));
   int64_t *dstStrides = static_cast<int64_t *>(alloca(sizeof(int64_t) * rank));
@@ -84,8 +324,8 @@ extern "C" void memrefCopy(int64_t elemSize, UnrankedMemRefType<char> *srcArg,
   // Initialize index and scale strides.
   for (int rankp = 0; rankp < rank; ++rankp) {
     indices[rankp] = 0;
-    srcStrides[rankp] = src.strides[rankp] * elemSize;
-    dstStrides[rankp] = dst.strides[rankp] * elemSize;
+    srcStrides[rankp] = srcStridesArg[rankp] * elemSize;
+    dstStrides[rankp] = dstStridesArg[rankp] * elemSize;
   }
 
   int64_t readIndex = 0, writeIndex = 0;
@@ -99,7 +339,7 @@ extern "C" void memrefCopy(int64_t elemSize, UnrankedMemRefType<char> *srcArg,
       readIndex += srcStrides[axis];
       writeIndex += dstStrides[axis];
       // If this is a valid index, we have our next index, so continue copying.
-      if (src.sizes[axis] != newIndex)
+      if (sizes[axis] != newIndex)
         break;
       // We reached the end of this axis. If this is axis 0, we are done.
       if (axis == 0)
@@ -107,11 +347,69 @@ extern "C" void memrefCopy(int64_t elemSize, UnrankedMemRefType<char> *srcArg,
       // Else, reset to 0 and undo the advancement of the linear index that
       // this axis had. Then continue with the axis one outer.
       indices[axis] = 0;
-      readIndex -= src.sizes[axis] * srcStrides[axis];
-      writeIndex -= dst.sizes[axis] * dstStrides[axis];
+      readIndex -= sizes[axis] * srcStrides[axis];
+      writeIndex -= sizes[axis] * dstStrides[axis];
     }
   }
 }
+} // namespace
+
+extern "C" void memrefCopy(int64_t elemSize, UnrankedMemRefType<char> *srcArg,
+                           UnrankedMemRefType<char> *dstArg) {
+  DynamicMemRefType<char> src(*srcArg);
+  DynamicMemRefType<char> dst(*dstArg);
+
+  int64_t rank = src.rank;
+  MLIR_MSAN_MEMORY_IS_INITIALIZED(src.sizes, rank * sizeof(int64_t));
+
+  // Handle empty shapes -> nothing to copy.
+  for (int rankp = 0; rankp < rank; ++rankp)
+    if (src.sizes[rankp] == 0)
+      return;
+
+  char *srcPtr = src.data + src.offset * elemSize;
+  char *dstPtr = dst.data + dst.offset * elemSize;
+
+  if (rank == 0) {
+    memcpy(dstPtr, srcPtr, elemSize);
+    return;
+  }
+
+  // Drop the unit dimensions, and merge the dimensions that are contiguous
+  // with their inner dimension in both memrefs.
+  StridedCopy copy;
+  copy.elemSize = elemSize;
+  copy.rank = 0;
+  for (int64_t axis = 0; axis < rank; ++axis) {
+    if (src.sizes[axis] == 1)
+      continue;
+    int64_t size = src.sizes[axis];
+    int64_t srcStride = src.strides[axis] * elemSize;
+    int64_t dstStride = dst.strides[axis] * elemSize;
+    if (copy.rank > 0) {
+      int64_t last = copy.rank - 1;
+      if (copy.srcStrides[last] == srcStride * size &&
+          copy.dstStrides[last] == dstStride * size) {
+        copy.sizes[last] *= size;
+        copy.srcStrides[last] = srcStride;
+        copy.dstStrides[last] = dstStride;
+        continue;
+      }
+    }
+    if (copy.rank == kMaxBlockedCopyRank)
+      return copyElementwise(elemSize, rank, src.sizes, srcPtr, src.strides,
+                             dstPtr, dst.strides);
+    copy.sizes[copy.rank] = size;
+    copy.srcStrides[copy.rank] = srcStride;
+    copy.dstStrides[copy.rank] = dstStride;
+    ++copy.rank;
+  }
+  if (copy.rank == 0) {
+    memcpy(dstPtr, srcPtr, elemSize);
+    return;
+  }
+  copyStridedInParallel(copy, dstPtr, srcPtr);
+}
 
 /// Prints GFLOPS rating.
 extern "C" void printFlops(double flops) {
@@ -132,6 +430,77 @@ extern "C" double rtclock() {
 #endif // _WIN32
 }
 
+namespace {
+/// The counters of a profiled region. The regions are kept in a fixed table
+/// addressed by the hash of their name, so that recording does not allocate
+/// or lock.
+struct ProfileRegion {
+  std::atomic<const char *> name{nullptr};
+  std::atomic<uint64_t> numExecutions{0};
+  std::atomic<uint64_t> ticks{0};
+};
+constexpr size_t kMaxProfileRegions = 4096;
+ProfileRegion profileRegions[kMaxProfileRegions];
+} // namespace
+
+extern "C" uint64_t mlirProfileReadCounter() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||            \
+    defined(_M_IX86)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+extern "C" void mlirProfileRecordRegion(const char *name, uint64_t start) {
+  uint64_t ticks = mlirProfileReadCounter() - start;
+  uint64_t hash =
+      (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(name)) *
+       0x9E3779B97F4A7C15ull) >>
+      32;
+  for (size_t i = 0; i < kMaxProfileRegions; ++i) {
+    ProfileRegion &region = profileRegions[(hash + i) % kMaxProfileRegions];
+    const char *current = region.name.load(std::memory_order_acquire);
+    if (!current && region.name.compare_exchange_strong(
+                        current, name, std::memory_order_acq_rel))
+      current = name;
+    if (current != name)
+      continue;
+    region.numExecutions.fetch_add(1, std::memory_order_relaxed);
+    region.ticks.fetch_add(ticks, std::memory_order_relaxed);
+    return;
+  }
+}
+
+extern "C" void mlirProfilePrintReport() {
+  struct Entry {
+    const char *name;
+    uint64_t numExecutions;
+    uint64_t ticks;
+  };
+  static Entry entries[kMaxProfileRegions];
+  size_t numEntries = 0;
+  for (ProfileRegion &region : profileRegions) {
+    const char *name = region.name.exchange(nullptr);
+    if (!name)
+      continue;
+    entries[numEntries++] = {name, region.numExecutions.exchange(0),
+                             region.ticks.exchange(0)};
+  }
+  std::sort(entries, entries + numEntries, [](const Entry &a, const Entry &b) {
+    return a.ticks > b.ticks;
+  });
+  fprintf(stderr, "profile: %-40s %12s %16s %12s\n", "region", "executions",
+          "ticks", "ticks/exec");
+  for (size_t i = 0; i < numEntries; ++i)
+    fprintf(stderr,
+            "profile: %-40s %12" PRIu64 " %16" PRIu64 " %12" PRIu64 "\n",
+            entries[i].name, entries[i].numExecutions, entries[i].ticks,
+            entries[i].ticks / std::max<uint64_t>(entries[i].numExecutions, 1));
+}
+
 extern "C" void *mlirAlloc(uint64_t size) { return malloc(size); }
 
 extern "C" void *mlirAlignedAlloc(uint64_t alignment, uint64_t size) {
@@ -158,6 +527,46 @@ extern "C" void mlirAlignedFree(void *ptr) {
 #endif
 }
 
+extern "C" void *mlirMapExternalStorage(const char *path, int64_t offset,
+                                        int64_t size, int32_t isMutable) {
+#ifndef _WIN32
+  int fd = ::open(path, O_RDONLY);
+  struct stat status;
+  if (fd < 0 || ::fstat(fd, &status) != 0 || offset < 0 || size <= 0 ||
+      status.st_size < offset + size) {
+    fprintf(stderr, "Cannot map %" PRId64 " bytes at offset %" PRId64
+                    " of external storage '%s'\n",
+            size, offset, path);
+    abort();
+  }
+  // The mapping must start at a page boundary.
+  int64_t pageOffset = offset % ::sysconf(_SC_PAGESIZE);
+  int prot = isMutable ? PROT_READ | PROT_WRITE : PROT_READ;
+  void *mapped = ::mmap(nullptr, size + pageOffset, prot, MAP_PRIVATE, fd,
+                        offset - pageOffset);
+  ::close(fd);
+  if (mapped == MAP_FAILED) {
+    fprintf(stderr, "Cannot map external storage '%s'\n", path);
+    abort();
+  }
+  return static_cast<char *>(mapped) + pageOffset;
+#else
+  // Read the storage into memory, which is never freed either.
+  (void)isMutable;
+  FILE *file = fopen(path, "rb");
+  char *data = size > 0 ? static_cast<char *>(malloc(size)) : nullptr;
+  if (!file || !data || offset < 0 || _fseeki64(file, offset, SEEK_SET) ||
+      fread(data, 1, size, file) != static_cast<size_t>(size)) {
+    fprintf(stderr, "Cannot read %" PRId64 " bytes at offset %" PRId64
+                    " of external storage '%s'\n",
+            size, offset, path);
+    abort();
+  }
+  fclose(file);
+  return data;
+#endif // _WIN32
+}
+
 extern "C" void *rtsrand(uint64_t s) {
   // Standard mersenne_twister_engine seeded with s.
   return new std::mt19937(s);
@@ -187,4 +596,65 @@ IMPL_STDSORT(F64, double)
 IMPL_STDSORT(F32, float)
 #undef IMPL_STDSORT
 
+#define IMPL_PARALLELSORT(VNAME, V)                                            \
+  extern "C" void _mlir_ciface_parallelSort##VNAME(                            \
+      uint64_t n, StridedMemRefType<V, 1> *vref) {                             \
+    assert(vref);                                                              \
+    assert(vref->strides[0] == 1);                                             \
+    V *values = vref->data + vref->offset;                                     \
+    parallelSort(n, values, std::less<V>());                                   \
+  }
+IMPL_PARALLELSORT(I64, int64_t)
+IMPL_PARALLELSORT(F64, double)
+IMPL_PARALLELSORT(F32, float)
+#undef IMPL_PARALLELSORT
+
+#define IMPL_RADIXSORT(VNAME, V)                                               \
+  extern "C" void _mlir_ciface_radixSort##VNAME(                               \
+      uint64_t n, StridedMemRefType<V, 1> *vref) {                             \
+    assert(vref);                                                              \
+    assert(vref->strides[0] == 1);                                             \
+    V *values = vref->data + vref->offset;                                     \
+    radixSort(n, values);                                                      \
+  }
+IMPL_RADIXSORT(Index, uint64_t)
+IMPL_RADIXSORT(U64, uint64_t)
+IMPL_RADIXSORT(U32, uint32_t)
+#undef IMPL_RADIXSORT
+
+#define IMPL_TOPK(VNAME, V)                                                    \
+  extern "C" void _mlir_ciface_topK##VNAME(uint64_t n, uint64_t k,             \
+                                           StridedMemRefType<V, 1> *vref) {    \
+    assert(vref);                                                              \
+    assert(vref->strides[0] == 1);                                             \
+    V *values = vref->data + vref->offset;                                     \
+    topK(n, k, values);                                                        \
+  }
+IMPL_TOPK(I64, int64_t)
+IMPL_TOPK(F64, double)
+IMPL_TOPK(F32, float)
+#undef IMPL_TOPK
+
+extern "C" void _mlir_ciface_sortCOO(uint64_t n, uint64_t nx, uint64_t ny,
+                                     StridedMemRefType<uint64_t, 1> *xyref) {
+  assert(xyref);
+  assert(xyref->strides[0] == 1);
+  sortCOO<char>(n, nx, ny, xyref->data + xyref->offset, nullptr);
+}
+
+#define IMPL_SORTCOO(VNAME, V)                                                 \
+  extern "C" void _mlir_ciface_sortCOO##VNAME(                                 \
+      uint64_t n, uint64_t nx, uint64_t ny,                                    \
+      StridedMemRefType<uint64_t, 1> *xyref, StridedMemRefType<V, 1> *yref) {  \
+    assert(xyref && yref);                                                     \
+    assert(xyref->strides[0] == 1 && yref->strides[0] == 1);                   \
+    V *values = yref->data + yref->offset;                                     \
+    sortCOO(n, nx, ny, xyref->data + xyref->offset, values);                   \
+  }
+IMPL_SORTCOO(I64, int64_t)
+IMPL_SORTCOO(I32, int32_t)
+IMPL_SORTCOO(F64, double)
+IMPL_SORTCOO(F32, float)
+#undef IMPL_SORTCOO
+
 #endif // MLIR_CRUNNERUTILS_DEFINE_FUNCTIONS
@@ -14,7 +14,17 @@
 
 #include "mlir/ExecutionEngine/CRunnerUtils.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <stdio.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "cuda.h"
 #include "cuda_bf16.h"
@@ -79,6 +89,52 @@ public:
   ~ScopedContext() { CUDA_REPORT_IF_ERROR(cuCtxPopCurrent(nullptr)); }
 };
 
+// A pool of CUDA handles, streams or events, that are recycled instead of
+// being destroyed, because their creation is expensive compared to the small
+// kernels that may run on them. A stream may be recycled while it still has
+// pending work, which only orders the work of its next user after it. At most
+// `kMaxSize` handles are kept.
+template <typename T>
+class HandlePool {
+public:
+  static constexpr size_t kMaxSize = 64;
+
+  // Returns a pooled handle, or null if there is none.
+  T pop() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (handles.empty())
+      return nullptr;
+    T handle = handles.back();
+    handles.pop_back();
+    return handle;
+  }
+
+  // Adds `handle` to the pool. Returns false if the pool is full.
+  bool push(T handle) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (handles.size() >= kMaxSize)
+      return false;
+    handles.push_back(handle);
+    return true;
+  }
+
+private:
+  std::mutex mutex;
+  std::vector<T> handles;
+};
+
+// The pools are never destroyed, such that the handles may still be released
+// by static destructors.
+static HandlePool<CUstream> &getStreamPool() {
+  static auto *pool = new HandlePool<CUstream>();
+  return *pool;
+}
+
+static HandlePool<CUevent> &getEventPool() {
+  static auto *pool = new HandlePool<CUevent>();
+  return *pool;
+}
+
 // Note that (1) Nvidia confirms the safety to share handle across multiple
 // instances, and streams. (2) Clients are responsible to call the @mgpu
 // environment initialization/destruction in a thread-safe manner, e.g.,
@@ -128,6 +184,8 @@ mgpuLaunchKernel(CUfunction function, intptr_t gridX, intptr_t gridY,
 }
 
 extern "C" MLIR_CUDA_WRAPPERS_EXPORT CUstream mgpuStreamCreate() {
+  if (CUstream stream = getStreamPool().pop())
+    return stream;
   ScopedContext scopedContext;
   CUstream stream = nullptr;
   CUDA_REPORT_IF_ERROR(cuStreamCreate(&stream, CU_STREAM_NON_BLOCKING));
@@ -135,7 +193,8 @@ extern "C" MLIR_CUDA_WRAPPERS_EXPORT CUstream mgpuStreamCreate() {
 }
 
 extern "C" MLIR_CUDA_WRAPPERS_EXPORT void mgpuStreamDestroy(CUstream stream) {
-  CUDA_REPORT_IF_ERROR(cuStreamDestroy(stream));
+  if (!getStreamPool().push(stream))
+    CUDA_REPORT_IF_ERROR(cuStreamDestroy(stream));
 }
 
 extern "C" MLIR_CUDA_WRAPPERS_EXPORT void
@@ -149,14 +208,19 @@ extern "C" MLIR_CUDA_WRAPPERS_EXPORT void mgpuStreamWaitEvent(CUstream stream,
 }
 
 extern "C" MLIR_CUDA_WRAPPERS_EXPORT CUevent mgpuEventCreate() {
+  if (CUevent event = getEventPool().pop())
+    return event;
   ScopedContext scopedContext;
   CUevent event = nullptr;
   CUDA_REPORT_IF_ERROR(cuEventCreate(&event, CU_EVENT_DISABLE_TIMING));
   return event;
 }
 
+// A recycled event may be recorded again, which does not affect the streams
+// that already wait for it.
 extern "C" MLIR_CUDA_WRAPPERS_EXPORT void mgpuEventDestroy(CUevent event) {
-  CUDA_REPORT_IF_ERROR(cuEventDestroy(event));
+  if (!getEventPool().push(event))
+    CUDA_REPORT_IF_ERROR(cuEventDestroy(event));
 }
 
 extern MLIR_CUDA_WRAPPERS_EXPORT "C" void mgpuEventSynchronize(CUevent event) {
@@ -168,15 +232,104 @@ extern MLIR_CUDA_WRAPPERS_EXPORT "C" void mgpuEventRecord(CUevent event,
   CUDA_REPORT_IF_ERROR(cuEventRecord(event, stream));
 }
 
-extern "C" void *mgpuMemAlloc(uint64_t sizeBytes, CUstream /*stream*/) {
+// Returns whether the device memory is allocated from the stream-ordered
+// memory pool of the device, which the allocations and frees are ordered with
+// the other work of their stream in, instead of synchronizing the device. The
+// pool keeps the freed memory for the subsequent allocations. It is used when
+// the device supports it, unless the MLIR_GPU_MEMORY_POOL environment variable
+// is set to 0.
+static bool isMemoryPoolEnabled() {
+  static bool enabled = [] {
+    const char *value = getenv("MLIR_GPU_MEMORY_POOL");
+    if (value && !strcmp(value, "0"))
+      return false;
+    ScopedContext scopedContext;
+    CUdevice device;
+    int supported = 0;
+    CUDA_REPORT_IF_ERROR(cuCtxGetDevice(&device));
+    CUDA_REPORT_IF_ERROR(cuDeviceGetAttribute(
+        &supported, CU_DEVICE_ATTRIBUTE_MEMORY_POOLS_SUPPORTED, device));
+    if (!supported)
+      return false;
+    CUmemoryPool pool;
+    CUDA_REPORT_IF_ERROR(cuDeviceGetDefaultMemPool(&pool, device));
+    cuuint64_t threshold = UINT64_MAX;
+    CUDA_REPORT_IF_ERROR(cuMemPoolSetAttribute(
+        pool, CU_MEMPOOL_ATTR_RELEASE_THRESHOLD, &threshold));
+    return true;
+  }();
+  return enabled;
+}
+
+// Statistics of the device allocations, which are collected and printed at
+// exit if the MLIR_GPU_MEMORY_STATS environment variable is set.
+class MemoryStatistics {
+public:
+  ~MemoryStatistics() {
+    fprintf(stderr,
+            "gpu memory: %llu allocations, %llu frees, %llu bytes allocated, "
+            "%llu bytes peak\n",
+            numAllocations, numFrees, allocatedBytes, peakLiveBytes);
+  }
+
+  void recordAlloc(void *ptr, uint64_t sizeBytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    sizes[ptr] = sizeBytes;
+    ++numAllocations;
+    allocatedBytes += sizeBytes;
+    liveBytes += sizeBytes;
+    peakLiveBytes = std::max(peakLiveBytes, liveBytes);
+  }
+
+  void recordFree(void *ptr) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = sizes.find(ptr);
+    if (it == sizes.end())
+      return;
+    ++numFrees;
+    liveBytes -= it->second;
+    sizes.erase(it);
+  }
+
+private:
+  std::mutex mutex;
+  std::unordered_map<void *, uint64_t> sizes;
+  unsigned long long numAllocations = 0;
+  unsigned long long numFrees = 0;
+  unsigned long long allocatedBytes = 0;
+  unsigned long long liveBytes = 0;
+  unsigned long long peakLiveBytes = 0;
+};
+
+// Returns the statistics of the device allocations, or null if they are not
+// collected.
+static MemoryStatistics *getMemoryStatistics() {
+  static std::unique_ptr<MemoryStatistics> statistics(
+      getenv("MLIR_GPU_MEMORY_STATS") ? new MemoryStatistics() : nullptr);
+  return statistics.get();
+}
+
+extern "C" void *mgpuMemAlloc(uint64_t sizeBytes, CUstream stream) {
   ScopedContext scopedContext;
   CUdeviceptr ptr;
-  CUDA_REPORT_IF_ERROR(cuMemAlloc(&ptr, sizeBytes));
+  if (isMemoryPoolEnabled())
+    CUDA_REPORT_IF_ERROR(cuMemAllocAsync(&ptr, sizeBytes, stream));
+  else
+    CUDA_REPORT_IF_ERROR(cuMemAlloc(&ptr, sizeBytes));
+  if (MemoryStatistics *statistics = getMemoryStatistics())
+    statistics->recordAlloc(reinterpret_cast<void *>(ptr), sizeBytes);
   return reinterpret_cast<void *>(ptr);
 }
 
-extern "C" void mgpuMemFree(void *ptr, CUstream /*stream*/) {
-  CUDA_REPORT_IF_ERROR(cuMemFree(reinterpret_cast<CUdeviceptr>(ptr)));
+extern "C" void mgpuMemFree(void *ptr, CUstream stream) {
+  if (MemoryStatistics *statistics = getMemoryStatistics())
+    statistics->recordFree(ptr);
+  ScopedContext scopedContext;
+  if (isMemoryPoolEnabled())
+    CUDA_REPORT_IF_ERROR(
+        cuMemFreeAsync(reinterpret_cast<CUdeviceptr>(ptr), stream));
+  else
+    CUDA_REPORT_IF_ERROR(cuMemFree(reinterpret_cast<CUdeviceptr>(ptr)));
 }
 
 extern "C" void mgpuMemcpy(void *dst, void *src, size_t sizeBytes,
@@ -198,6 +351,150 @@ extern "C" void mgpuMemset16(void *dst, unsigned short value, size_t count,
                                         value, count, stream));
 }
 
+///
+/// Graph capture of kernel launch sequences
+///
+
+// A kernel launch of a sequence captured into a graph, with a copy of its
+// parameters.
+struct GraphLaunch {
+  CUfunction function;
+  intptr_t grid[3];
+  intptr_t block[3];
+  int32_t smem;
+  std::vector<char> paramsData;
+  std::vector<size_t> paramOffsets;
+
+  bool operator==(const GraphLaunch &other) const {
+    return function == other.function &&
+           std::equal(grid, grid + 3, other.grid) &&
+           std::equal(block, block + 3, other.block) && smem == other.smem &&
+           paramsData == other.paramsData &&
+           paramOffsets == other.paramOffsets;
+  }
+};
+
+// The executable graph of a launch sequence, and the launches it was captured
+// from.
+struct GraphCache {
+  std::mutex mutex;
+  std::vector<GraphLaunch> launches;
+  CUgraphExec exec = nullptr;
+};
+
+// The launches of one execution of a sequence, which are deferred until the
+// end of the sequence.
+struct GraphRecording {
+  GraphCache *cache;
+  CUstream stream;
+  std::vector<GraphLaunch> launches;
+};
+
+// Returns the function `name` of the module `data`. The modules are loaded
+// once and stay loaded, since the cached graphs refer to their functions.
+static CUfunction getGraphFunction(void *data, const char *name) {
+  static std::mutex mutex;
+  static auto *functions = new std::map<std::pair<void *, std::string>,
+                                        CUfunction>();
+  static auto *modules = new std::map<void *, CUmodule>();
+  std::lock_guard<std::mutex> lock(mutex);
+  CUfunction &function = (*functions)[{data, name}];
+  if (!function) {
+    CUmodule &module = (*modules)[data];
+    if (!module)
+      module = mgpuModuleLoad(data);
+    function = mgpuModuleGetFunction(module, name);
+  }
+  return function;
+}
+
+// Begins an execution of the launch sequence whose graph is cached in
+// `*cache`, which must be null initially. Returns the recording that the
+// launches of the sequence are added to.
+extern "C" MLIR_CUDA_WRAPPERS_EXPORT GraphRecording *
+mgpuGraphBegin(GraphCache **cache) {
+  static std::mutex mutex;
+  GraphCache *graphCache;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!*cache)
+      *cache = new GraphCache();
+    graphCache = *cache;
+  }
+  return new GraphRecording{graphCache, mgpuStreamCreate(), {}};
+}
+
+// Adds a launch of the function `name` of the module `data` to `recording`.
+// The `numParams` parameters point into a buffer of `paramsSize` bytes, which
+// starts with the first parameter.
+extern "C" MLIR_CUDA_WRAPPERS_EXPORT void
+mgpuGraphLaunchKernel(GraphRecording *recording, void *data, const char *name,
+                      intptr_t gridX, intptr_t gridY, intptr_t gridZ,
+                      intptr_t blockX, intptr_t blockY, intptr_t blockZ,
+                      int32_t smem, void **params, intptr_t numParams,
+                      intptr_t paramsSize) {
+  GraphLaunch launch{getGraphFunction(data, name),
+                     {gridX, gridY, gridZ},
+                     {blockX, blockY, blockZ},
+                     smem,
+                     {},
+                     {}};
+  const char *paramsBegin = numParams ? static_cast<char *>(params[0]) : "";
+  launch.paramsData.assign(paramsBegin, paramsBegin + paramsSize);
+  for (intptr_t i = 0; i < numParams; ++i)
+    launch.paramOffsets.push_back(static_cast<char *>(params[i]) -
+                                  paramsBegin);
+  recording->launches.push_back(std::move(launch));
+}
+
+// Captures `launches` into a new executable graph.
+static CUgraphExec captureGraph(std::vector<GraphLaunch> &launches,
+                                CUstream stream) {
+  ScopedContext scopedContext;
+  CUDA_REPORT_IF_ERROR(
+      cuStreamBeginCapture(stream, CU_STREAM_CAPTURE_MODE_THREAD_LOCAL));
+  std::vector<void *> params;
+  for (GraphLaunch &launch : launches) {
+    params.clear();
+    for (size_t offset : launch.paramOffsets)
+      params.push_back(launch.paramsData.data() + offset);
+    CUDA_REPORT_IF_ERROR(cuLaunchKernel(
+        launch.function, launch.grid[0], launch.grid[1], launch.grid[2],
+        launch.block[0], launch.block[1], launch.block[2], launch.smem, stream,
+        params.data(), /*extra=*/nullptr));
+  }
+  CUgraph graph = nullptr;
+  CUDA_REPORT_IF_ERROR(cuStreamEndCapture(stream, &graph));
+  CUgraphExec exec = nullptr;
+  CUDA_REPORT_IF_ERROR(cuGraphInstantiateWithFlags(&exec, graph, /*flags=*/0));
+  CUDA_REPORT_IF_ERROR(cuGraphDestroy(graph));
+  return exec;
+}
+
+// Ends the execution of a launch sequence. Replays the cached graph if the
+// sequence launches the same kernels with the same parameters as when it was
+// captured, or captures the sequence again otherwise, e.g. when the buffers it
+// is passed changed. Then synchronizes the host with the sequence.
+extern "C" MLIR_CUDA_WRAPPERS_EXPORT void
+mgpuGraphEnd(GraphRecording *recording) {
+  GraphCache *cache = recording->cache;
+  CUstream stream = recording->stream;
+  if (!recording->launches.empty()) {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    if (!cache->exec || cache->launches != recording->launches) {
+      // An executable graph that is still running is released on completion.
+      if (cache->exec)
+        CUDA_REPORT_IF_ERROR(cuGraphExecDestroy(cache->exec));
+      cache->exec = captureGraph(recording->launches, stream);
+      cache->launches = std::move(recording->launches);
+    }
+    CUDA_REPORT_IF_ERROR(cuGraphLaunch(cache->exec, stream));
+  }
+  mgpuStreamSynchronize(stream);
+  mgpuStreamDestroy(stream);
+  delete recording;
+}
+
 ///
 /// Helper functions for writing mlir example code
 ///
@@ -250,6 +547,86 @@ mgpuMemHostUnregisterMemRef(int64_t rank,
   mgpuMemHostUnregister(ptr);
 }
 
+#if CUDA_VERSION >= 12000
+
+/// Creates the tensor map through which `nvgpu.tma.async.load` copies tiles of
+/// the memref `tensor`, i.e. a pointer to a ranked memref descriptor struct of
+/// rank `tensorRank`, in device memory. `boxDims` is a 1-D memref holding the
+/// shape of the tiles, and `swizzle` the swizzling of their rows in shared
+/// memory, which is 0 (none), 32, 64 or 128 bytes. Returns the device address
+/// of the tensor map, to be freed with `mgpuTensorMapDestroy`.
+extern "C" MLIR_CUDA_WRAPPERS_EXPORT uint64_t mgpuTensorMapEncodeTiledMemRef(
+    int64_t tensorRank, StridedMemRefType<char, 1> *tensor,
+    int64_t elementSizeBytes, int64_t boxRank,
+    StridedMemRefType<int64_t, 1> *boxDims, int32_t swizzle) {
+  assert(tensorRank >= 1 && tensorRank <= 5 && boxRank == 1 &&
+         boxDims->sizes[0] == tensorRank && "Invalid tensor map rank");
+  (void)boxRank;
+  // The data type only matters for the fill of out-of-bound elements, which
+  // are zeros, the elements are copied as integers of their size.
+  CUtensorMapDataType dataType;
+  switch (elementSizeBytes) {
+  case 1:
+    dataType = CU_TENSOR_MAP_DATA_TYPE_UINT8;
+    break;
+  case 2:
+    dataType = CU_TENSOR_MAP_DATA_TYPE_UINT16;
+    break;
+  case 4:
+    dataType = CU_TENSOR_MAP_DATA_TYPE_UINT32;
+    break;
+  default:
+    dataType = CU_TENSOR_MAP_DATA_TYPE_UINT64;
+    break;
+  }
+  CUtensorMapSwizzle swizzleMode = CU_TENSOR_MAP_SWIZZLE_NONE;
+  if (swizzle == 32)
+    swizzleMode = CU_TENSOR_MAP_SWIZZLE_32B;
+  else if (swizzle == 64)
+    swizzleMode = CU_TENSOR_MAP_SWIZZLE_64B;
+  else if (swizzle == 128)
+    swizzleMode = CU_TENSOR_MAP_SWIZZLE_128B;
+
+  // The tensor map lists the dimensions from the innermost one, and the
+  // strides in bytes of all the dimensions but the innermost one.
+  int64_t *sizes = tensor->sizes;
+  int64_t *strides = &sizes[tensorRank];
+  cuuint64_t globalDim[5], globalStrides[4];
+  cuuint32_t boxDim[5], elementStrides[5];
+  for (int64_t i = 0; i < tensorRank; ++i) {
+    int64_t dim = tensorRank - 1 - i;
+    globalDim[i] = sizes[dim];
+    boxDim[i] = boxDims->data[boxDims->offset + dim * boxDims->strides[0]];
+    elementStrides[i] = 1;
+    if (i > 0)
+      globalStrides[i - 1] = strides[dim] * elementSizeBytes;
+  }
+  assert(strides[tensorRank - 1] == 1 && "Expected a unit innermost stride");
+
+  CUtensorMap tensorMap;
+  void *globalAddress = tensor->data + tensor->offset * elementSizeBytes;
+  CUDA_REPORT_IF_ERROR(cuTensorMapEncodeTiled(
+      &tensorMap, dataType, tensorRank, globalAddress, globalDim,
+      globalStrides, boxDim, elementStrides, CU_TENSOR_MAP_INTERLEAVE_NONE,
+      swizzleMode, CU_TENSOR_MAP_L2_PROMOTION_L2_128B,
+      CU_TENSOR_MAP_FLOAT_OOB_FILL_NONE));
+
+  ScopedContext scopedContext;
+  CUdeviceptr ptr = 0;
+  CUDA_REPORT_IF_ERROR(cuMemAlloc(&ptr, sizeof(tensorMap)));
+  CUDA_REPORT_IF_ERROR(cuMemcpyHtoD(ptr, &tensorMap, sizeof(tensorMap)));
+  return ptr;
+}
+
+/// Frees a tensor map created by `mgpuTensorMapEncodeTiledMemRef`.
+extern "C" MLIR_CUDA_WRAPPERS_EXPORT void
+mgpuTensorMapDestroy(uint64_t tensorMap) {
+  ScopedContext scopedContext;
+  CUDA_REPORT_IF_ERROR(cuMemFree(static_cast<CUdeviceptr>(tensorMap)));
+}
+
+#endif // CUDA_VERSION >= 12000
+
 extern "C" MLIR_CUDA_WRAPPERS_EXPORT void mgpuSetDefaultDevice(int32_t device) {
   defaultDevice = device;
 }
@@ -13,9 +13,14 @@
 #include "mlir/ExecutionEngine/ExecutionEngine.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/SymbolTable.h"
 #include "mlir/Support/FileUtilities.h"
 #include "mlir/Target/LLVMIR/Export.h"
 
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/ExecutionEngine/JITEventListener.h"
 #include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
@@ -28,9 +33,13 @@
 #include "llvm/MC/TargetRegistry.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/TargetParser/Host.h"
 #include "llvm/TargetParser/SubtargetFeature.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
 
 #define DEBUG_TYPE "execution-engine"
 
@@ -46,12 +55,16 @@ using llvm::Module;
 using llvm::SectionMemoryManager;
 using llvm::StringError;
 using llvm::Triple;
+using llvm::orc::DefinitionGenerator;
 using llvm::orc::DynamicLibrarySearchGenerator;
 using llvm::orc::ExecutionSession;
 using llvm::orc::IRCompileLayer;
+using llvm::orc::JITDylib;
+using llvm::orc::JITDylibLookupFlags;
 using llvm::orc::JITTargetMachineBuilder;
 using llvm::orc::MangleAndInterner;
 using llvm::orc::RTDyldObjectLinkingLayer;
+using llvm::orc::SymbolLookupSet;
 using llvm::orc::SymbolMap;
 using llvm::orc::ThreadSafeModule;
 using llvm::orc::TMOwningSimpleCompiler;
@@ -62,22 +75,100 @@ static Error makeStringError(const Twine &message) {
                                        llvm::inconvertibleErrorCode());
 }
 
+SimpleObjectCache::SimpleObjectCache(StringRef cacheDir, StringRef codeGenKey)
+    : cacheDir(cacheDir), codeGenKey(codeGenKey) {}
+
+std::string SimpleObjectCache::getCacheFilePath(const Module *m) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cacheFilePaths.find(m->getModuleIdentifier());
+    if (it != cacheFilePaths.end())
+      return it->second;
+  }
+
+  // Hash the textual form of the module together with the code generation
+  // configuration. The leading `; ModuleID` line is dropped so that identical
+  // modules share the same entry regardless of their identifier.
+  std::string moduleStr;
+  llvm::raw_string_ostream os(moduleStr);
+  m->print(os, /*AAW=*/nullptr);
+  os.flush();
+  StringRef moduleBody =
+      StringRef(moduleStr).drop_until([](char c) { return c == '\n'; });
+
+  llvm::SHA1 hasher;
+  hasher.update(codeGenKey);
+  hasher.update(moduleBody);
+  SmallString<256> path(cacheDir);
+  llvm::sys::path::append(path, llvm::toHex(hasher.final(), /*LowerCase=*/true) +
+                                    ".o");
+
+  std::lock_guard<std::mutex> lock(mutex);
+  return cacheFilePaths
+      .try_emplace(m->getModuleIdentifier(), std::string(path))
+      .first->second;
+}
+
 void SimpleObjectCache::notifyObjectCompiled(const Module *m,
                                              MemoryBufferRef objBuffer) {
-  cachedObjects[m->getModuleIdentifier()] = MemoryBuffer::getMemBufferCopy(
-      objBuffer.getBuffer(), objBuffer.getBufferIdentifier());
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    cachedObjects[m->getModuleIdentifier()] = MemoryBuffer::getMemBufferCopy(
+        objBuffer.getBuffer(), objBuffer.getBufferIdentifier());
+  }
+  if (cacheDir.empty())
+    return;
+
+  // Persist the object. Failing to do so is not fatal: the next execution
+  // will simply recompile the module. The output is written to a temporary
+  // file and then renamed, so that concurrent processes never observe a
+  // partially written entry.
+  std::string path = getCacheFilePath(m);
+  if (std::error_code ec = llvm::sys::fs::create_directories(cacheDir)) {
+    LLVM_DEBUG(dbgs() << "Could not create object cache directory " << cacheDir
+                      << ": " << ec.message() << "\n");
+    return;
+  }
+  Error error = llvm::writeToOutput(path, [&](llvm::raw_ostream &os) {
+    os << objBuffer.getBuffer();
+    return Error::success();
+  });
+  if (error) {
+    LLVM_DEBUG(dbgs() << "Could not write object cache entry " << path << ": "
+                      << error << "\n");
+    llvm::consumeError(std::move(error));
+    return;
+  }
+  LLVM_DEBUG(dbgs() << "Object for " << m->getModuleIdentifier()
+                    << " stored in " << path << ".\n");
 }
 
 std::unique_ptr<MemoryBuffer> SimpleObjectCache::getObject(const Module *m) {
-  auto i = cachedObjects.find(m->getModuleIdentifier());
-  if (i == cachedObjects.end()) {
-    LLVM_DEBUG(dbgs() << "No object for " << m->getModuleIdentifier()
-                      << " in cache. Compiling.\n");
-    return nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto i = cachedObjects.find(m->getModuleIdentifier());
+    if (i != cachedObjects.end()) {
+      LLVM_DEBUG(dbgs() << "Object for " << m->getModuleIdentifier()
+                        << " loaded from cache.\n");
+      return MemoryBuffer::getMemBuffer(i->second->getMemBufferRef());
+    }
   }
-  LLVM_DEBUG(dbgs() << "Object for " << m->getModuleIdentifier()
-                    << " loaded from cache.\n");
-  return MemoryBuffer::getMemBuffer(i->second->getMemBufferRef());
+
+  if (!cacheDir.empty()) {
+    std::string path = getCacheFilePath(m);
+    if (auto fileOrErr = MemoryBuffer::getFile(path)) {
+      LLVM_DEBUG(dbgs() << "Object for " << m->getModuleIdentifier()
+                        << " loaded from " << path << ".\n");
+      std::lock_guard<std::mutex> lock(mutex);
+      auto &cachedObject = cachedObjects[m->getModuleIdentifier()];
+      cachedObject = std::move(*fileOrErr);
+      return MemoryBuffer::getMemBuffer(cachedObject->getMemBufferRef());
+    }
+  }
+
+  LLVM_DEBUG(dbgs() << "No object for " << m->getModuleIdentifier()
+                    << " in cache. Compiling.\n");
+  return nullptr;
 }
 
 void SimpleObjectCache::dumpToObjectFile(StringRef outputFilename) {
@@ -90,13 +181,107 @@ void SimpleObjectCache::dumpToObjectFile(StringRef outputFilename) {
   }
 
   // Dump the object generated for a single module to the output file.
+  std::lock_guard<std::mutex> lock(mutex);
   assert(cachedObjects.size() == 1 && "Expected only one object entry.");
   auto &cachedObject = cachedObjects.begin()->second;
   file->os() << cachedObject->getBuffer();
   file->keep();
 }
 
-bool SimpleObjectCache::isEmpty() { return cachedObjects.empty(); }
+bool SimpleObjectCache::isEmpty() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return cachedObjects.empty();
+}
+
+SharedRuntimeLibraries::~SharedRuntimeLibraries() {
+  for (ExecutionEngine::LibraryDestroyFn destroy : destroyFns)
+    destroy();
+}
+
+Expected<std::shared_ptr<SharedRuntimeLibraries>>
+SharedRuntimeLibraries::load(ArrayRef<StringRef> libPaths) {
+  std::shared_ptr<SharedRuntimeLibraries> runtimeLibraries(
+      new SharedRuntimeLibraries());
+  for (StringRef libPath : libPaths) {
+    // Use absolute library path so that gdb can find the symbol table.
+    SmallString<256> absPath(libPath);
+    if (std::error_code ec = llvm::sys::fs::make_absolute(absPath))
+      return llvm::errorCodeToError(ec);
+
+    std::string errorMessage;
+    auto lib = llvm::sys::DynamicLibrary::getPermanentLibrary(absPath.c_str(),
+                                                              &errorMessage);
+    if (!lib.isValid())
+      return makeStringError(Twine("could not load ") + absPath + ": " +
+                             errorMessage);
+    void *initSym = lib.getAddressOfSymbol(ExecutionEngine::kLibraryInitFnName);
+    void *destroySym =
+        lib.getAddressOfSymbol(ExecutionEngine::kLibraryDestroyFnName);
+    if (!initSym || !destroySym) {
+      runtimeLibraries->libraries.push_back(lib);
+      continue;
+    }
+    reinterpret_cast<ExecutionEngine::LibraryInitFn>(initSym)(
+        runtimeLibraries->exportedSymbols);
+    runtimeLibraries->destroyFns.push_back(
+        reinterpret_cast<ExecutionEngine::LibraryDestroyFn>(destroySym));
+  }
+  return std::move(runtimeLibraries);
+}
+
+void *SharedRuntimeLibraries::lookup(StringRef name) {
+  // The exported symbols are immutable once the libraries are loaded.
+  auto it = exportedSymbols.find(name);
+  if (it != exportedSymbols.end())
+    return it->second;
+  if (libraries.empty())
+    return nullptr;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto [resolvedIt, inserted] = resolvedSymbols.try_emplace(name, nullptr);
+  if (inserted) {
+    std::string nameStr = name.str();
+    for (llvm::sys::DynamicLibrary &lib : libraries)
+      if ((resolvedIt->second = lib.getAddressOfSymbol(nameStr.c_str())))
+        break;
+  }
+  return resolvedIt->second;
+}
+
+namespace {
+/// A generator defining the symbols of shared runtime libraries in the JIT
+/// dylib it is attached to, as they are looked up.
+class SharedRuntimeLibrariesGenerator : public DefinitionGenerator {
+public:
+  SharedRuntimeLibrariesGenerator(
+      std::shared_ptr<SharedRuntimeLibraries> runtimeLibraries,
+      char globalPrefix)
+      : runtimeLibraries(std::move(runtimeLibraries)),
+        globalPrefix(globalPrefix) {}
+
+  Error tryToGenerate(llvm::orc::LookupState &state, llvm::orc::LookupKind kind,
+                      JITDylib &jd, JITDylibLookupFlags jdLookupFlags,
+                      const SymbolLookupSet &lookupSet) override {
+    SymbolMap newSymbols;
+    for (const auto &entry : lookupSet) {
+      StringRef name = *entry.first;
+      if (globalPrefix != '\0' &&
+          !name.consume_front(StringRef(&globalPrefix, 1)))
+        continue;
+      if (void *address = runtimeLibraries->lookup(name))
+        newSymbols[entry.first] = {llvm::orc::ExecutorAddr::fromPtr(address),
+                                   llvm::JITSymbolFlags::Exported};
+    }
+    if (newSymbols.empty())
+      return Error::success();
+    return jd.define(absoluteSymbols(std::move(newSymbols)));
+  }
+
+private:
+  std::shared_ptr<SharedRuntimeLibraries> runtimeLibraries;
+  char globalPrefix;
+};
+} // namespace
 
 void ExecutionEngine::dumpToObjectFile(StringRef filename) {
   if (cache == nullptr) {
@@ -204,6 +389,58 @@ static void packFunctionArguments(Module *module) {
   }
 }
 
+/// Returns a builder creating target machines configured like `tm`.
+static JITTargetMachineBuilder
+getTargetMachineBuilder(const llvm::TargetMachine &tm) {
+  JITTargetMachineBuilder jtmb(tm.getTargetTriple());
+  jtmb.setCPU(tm.getTargetCPU().str())
+      .setRelocationModel(tm.getRelocationModel())
+      .setCodeModel(tm.getCodeModel())
+      .setCodeGenOptLevel(tm.getOptLevel())
+      .setOptions(tm.Options);
+  jtmb.getFeatures() = llvm::SubtargetFeatures(tm.getTargetFeatureString());
+  return jtmb;
+}
+
+/// Splits the module held by `tsm` into at most `numPartitions` modules. ORC
+/// serializes the compilation of modules that share a context, so every
+/// partition is moved to a fresh LLVM context by round-tripping it through
+/// bitcode.
+static Expected<SmallVector<ThreadSafeModule>>
+splitIntoPartitions(ThreadSafeModule tsm, unsigned numPartitions) {
+  SmallVector<ThreadSafeModule> partitions;
+  Error error = Error::success();
+  tsm.withModuleDo([&](Module &module) {
+    unsigned numDefinedFunctions = llvm::count_if(
+        module.functions(),
+        [](llvm::Function &func) { return !func.isDeclaration(); });
+    numPartitions = std::max(1u, std::min(numPartitions, numDefinedFunctions));
+    std::string moduleId = module.getModuleIdentifier();
+    llvm::SplitModule(module, numPartitions, [&](std::unique_ptr<Module> part) {
+      SmallString<0> bitcode;
+      llvm::raw_svector_ostream os(bitcode);
+      llvm::WriteBitcodeToFile(*part, os);
+
+      auto partCtx = std::make_unique<LLVMContext>();
+      auto partOrError =
+          llvm::parseBitcodeFile(MemoryBufferRef(bitcode, moduleId), *partCtx);
+      if (!partOrError) {
+        error = llvm::joinErrors(std::move(error), partOrError.takeError());
+        return;
+      }
+      // Object caches are indexed by module identifier, which must therefore
+      // be unique across partitions.
+      (*partOrError)
+          ->setModuleIdentifier(moduleId + ".part" +
+                                std::to_string(partitions.size()));
+      partitions.emplace_back(std::move(*partOrError), std::move(partCtx));
+    });
+  });
+  if (error)
+    return std::move(error);
+  return std::move(partitions);
+}
+
 ExecutionEngine::ExecutionEngine(bool enableObjectDump,
                                  bool enableGDBNotificationListener,
                                  bool enablePerfNotificationListener)
@@ -223,6 +460,15 @@ ExecutionEngine::ExecutionEngine(bool enableObjectDump,
 }
 
 ExecutionEngine::~ExecutionEngine() {
+  // Print the profile counters before the libraries that hold them shut down.
+  if (printProfileReport && jit) {
+    Expected<void *> report = lookup("mlirProfilePrintReport");
+    if (report)
+      reinterpret_cast<void (*)()>(*report)();
+    else
+      llvm::consumeError(report.takeError());
+  }
+
   // Run all dynamic library destroy callbacks to prepare for the shutdown.
   for (LibraryDestroyFn destroy : destroyFns)
     destroy();
@@ -231,9 +477,16 @@ ExecutionEngine::~ExecutionEngine() {
 Expected<std::unique_ptr<ExecutionEngine>>
 ExecutionEngine::create(Operation *m, const ExecutionEngineOptions &options,
                         std::unique_ptr<llvm::TargetMachine> tm) {
+  if (options.enableObjectDump &&
+      (options.numCompileThreads || options.enableLazyCompilation))
+    return makeStringError(
+        "object dump is not supported with lazy or concurrent compilation");
+
   auto engine = std::make_unique<ExecutionEngine>(
       options.enableObjectDump, options.enableGDBNotificationListener,
       options.enablePerfNotificationListener);
+  engine->printProfileReport = options.printProfileReport;
+  engine->runtimeLibraries = options.runtimeLibraries;
 
   // Remember all entry-points if object dumping is enabled.
   if (options.enableObjectDump) {
@@ -263,6 +516,20 @@ ExecutionEngine::create(Operation *m, const ExecutionEngineOptions &options,
     tm = std::move(tmOrError.get());
   }
 
+  // Now that the target is known, back the object cache by the persistent
+  // directory if requested. The key covers everything besides the module that
+  // affects the generated code, including the LLVM version.
+  if (!options.objectCacheDir.empty()) {
+    std::string codeGenKey;
+    llvm::raw_string_ostream os(codeGenKey);
+    os << LLVM_VERSION_STRING << ';' << tm->getTargetTriple().str() << ';'
+       << tm->getTargetCPU() << ';' << tm->getTargetFeatureString() << ';'
+       << static_cast<int>(
+              options.jitCodeGenOptLevel.value_or(tm->getOptLevel()));
+    engine->cache = std::make_unique<SimpleObjectCache>(options.objectCacheDir,
+                                                        os.str());
+  }
+
   // TODO: Currently, the LLVM module created above has no triple associated
   // with it. Instead, the triple is extracted from the TargetMachine, which is
   // either based on the host defaults or command line arguments when specified
@@ -310,6 +577,22 @@ ExecutionEngine::create(Operation *m, const ExecutionEngineOptions &options,
   }
   engine->destroyFns = std::move(destroyFns);
 
+  // Serve the allocation functions by the pooled allocator if requested,
+  // taking precedence over the definitions of the shared libraries.
+  if (options.pooledAllocator) {
+    runtime::configurePooledAllocator(*options.pooledAllocator);
+    auto *alloc = reinterpret_cast<void *>(&runtime::pooledAlloc);
+    auto *alignedAlloc = reinterpret_cast<void *>(&runtime::pooledAlignedAlloc);
+    auto *freeFn = reinterpret_cast<void *>(&runtime::pooledFree);
+    exportSymbols["mlirAlloc"] = alloc;
+    exportSymbols["mlirAlignedAlloc"] = alignedAlloc;
+    exportSymbols["mlirFree"] = freeFn;
+    exportSymbols["mlirAlignedFree"] = freeFn;
+    exportSymbols["_mlir_memref_to_llvm_alloc"] = alloc;
+    exportSymbols["_mlir_memref_to_llvm_aligned_alloc"] = alignedAlloc;
+    exportSymbols["_mlir_memref_to_llvm_free"] = freeFn;
+  }
+
   // Callback to create the object layer with symbol resolution to current
   // process and dynamically linked libraries.
   auto objectLinkingLayerCreator = [&](ExecutionSession &session,
@@ -358,33 +641,73 @@ ExecutionEngine::create(Operation *m, const ExecutionEngineOptions &options,
   };
 
   // Callback to inspect the cache and recompile on demand. This follows Lang's
-  // LLJITWithObjectCache example.
+  // LLJITWithObjectCache example. Concurrent compilation needs a separate
+  // target machine per compile, which the concurrent compiler creates from
+  // the builder.
   auto compileFunctionCreator = [&](JITTargetMachineBuilder jtmb)
       -> Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
     if (options.jitCodeGenOptLevel)
       jtmb.setCodeGenOptLevel(*options.jitCodeGenOptLevel);
+    if (options.numCompileThreads)
+      return std::make_unique<llvm::orc::ConcurrentIRCompiler>(
+          std::move(jtmb), engine->cache.get());
     return std::make_unique<TMOwningSimpleCompiler>(std::move(tm),
                                                     engine->cache.get());
   };
 
-  // Create the LLJIT by calling the LLJITBuilder with 2 callbacks.
-  auto jit =
-      cantFail(llvm::orc::LLJITBuilder()
-                   .setCompileFunctionCreator(compileFunctionCreator)
-                   .setObjectLinkingLayerCreator(objectLinkingLayerCreator)
-                   .setDataLayout(dataLayout)
-                   .create());
+  // Create the LLJIT, or the LLLazyJIT when compiling lazily, by calling the
+  // builder with 2 callbacks.
+  auto configureBuilder = [&](auto &builder) {
+    builder.setCompileFunctionCreator(compileFunctionCreator)
+        .setObjectLinkingLayerCreator(objectLinkingLayerCreator)
+        .setDataLayout(dataLayout)
+        .setNumCompileThreads(options.numCompileThreads);
+    if (options.numCompileThreads)
+      builder.setJITTargetMachineBuilder(getTargetMachineBuilder(*tm));
+  };
+  auto createJIT = [&]() -> Expected<std::unique_ptr<llvm::orc::LLJIT>> {
+    if (options.enableLazyCompilation) {
+      llvm::orc::LLLazyJITBuilder builder;
+      configureBuilder(builder);
+      return builder.create();
+    }
+    llvm::orc::LLJITBuilder builder;
+    configureBuilder(builder);
+    return builder.create();
+  };
+  auto jitOrError = createJIT();
+  if (!jitOrError)
+    return jitOrError.takeError();
+  std::unique_ptr<llvm::orc::LLJIT> jit = std::move(*jitOrError);
 
-  // Add a ThreadSafemodule to the engine and return.
+  // Add the ThreadSafeModule, or its partitions when compiling concurrently,
+  // to the engine.
   ThreadSafeModule tsm(std::move(llvmModule), std::move(ctx));
   if (options.transformer)
     cantFail(tsm.withModuleDo(
         [&](llvm::Module &module) { return options.transformer(&module); }));
-  cantFail(jit->addIRModule(std::move(tsm)));
+  if (options.enableLazyCompilation) {
+    // The lazy layer already emits every function separately.
+    cantFail(static_cast<llvm::orc::LLLazyJIT &>(*jit).addLazyIRModule(
+        std::move(tsm)));
+  } else if (options.numCompileThreads) {
+    auto partitions =
+        splitIntoPartitions(std::move(tsm), options.numCompileThreads);
+    if (!partitions)
+      return partitions.takeError();
+    for (ThreadSafeModule &partition : *partitions)
+      cantFail(jit->addIRModule(std::move(partition)));
+  } else {
+    cantFail(jit->addIRModule(std::move(tsm)));
+  }
   engine->jit = std::move(jit);
 
-  // Resolve symbols that are statically linked in the current process.
+  // Resolve the symbols of the shared runtime libraries first, and then the
+  // symbols that are statically linked in the current process.
   llvm::orc::JITDylib &mainJD = engine->jit->getMainJITDylib();
+  if (engine->runtimeLibraries)
+    mainJD.addGenerator(std::make_unique<SharedRuntimeLibrariesGenerator>(
+        engine->runtimeLibraries, dataLayout.getGlobalPrefix()));
   mainJD.addGenerator(
       cantFail(DynamicLibrarySearchGenerator::GetForCurrentProcess(
           dataLayout.getGlobalPrefix())));
@@ -400,6 +723,12 @@ ExecutionEngine::create(Operation *m, const ExecutionEngineOptions &options,
   };
   engine->registerSymbols(runtimeSymbolMap);
 
+  // Initialize the module once its dependencies are resolved.
+  if (m->hasTrait<OpTrait::SymbolTable>() &&
+      SymbolTable::lookupSymbolIn(m, kModuleInitFnName))
+    if (Error error = engine->invokePacked(kModuleInitFnName))
+      return std::move(error);
+
   return std::move(engine);
 }
 
@@ -412,6 +741,15 @@ ExecutionEngine::lookupPacked(StringRef name) const {
 }
 
 Expected<void *> ExecutionEngine::lookup(StringRef name) const {
+  {
+    llvm::sys::SmartScopedReader<true> reader(symbolCacheMutex);
+    auto it = symbolCache.find(name);
+    if (it != symbolCache.end())
+      return it->second;
+  }
+
+  // The JIT lookup is thread-safe, concurrent lookups of the same symbol
+  // simply resolve to the same address.
   auto expectedSymbol = jit->lookup(name);
 
   // JIT lookup may return an Error referring to strings stored internally by
@@ -428,9 +766,12 @@ Expected<void *> ExecutionEngine::lookup(StringRef name) const {
     return makeStringError(os.str());
   }
 
-  if (void *fptr = expectedSymbol->toPtr<void *>())
-    return fptr;
-  return makeStringError("looked up function is null");
+  void *fptr = expectedSymbol->toPtr<void *>();
+  if (!fptr)
+    return makeStringError("looked up function is null");
+  llvm::sys::SmartScopedWriter<true> writer(symbolCacheMutex);
+  symbolCache.try_emplace(name, fptr);
+  return fptr;
 }
 
 Error ExecutionEngine::invokePacked(StringRef name,
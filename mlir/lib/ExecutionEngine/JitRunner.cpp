@@ -23,6 +23,7 @@
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/Parser/Parser.h"
 #include "mlir/Support/FileUtilities.h"
+#include "mlir/Target/LLVMIR/Export.h"
 #include "mlir/Tools/ParseUtilities.h"
 
 #include "llvm/ADT/STLExtras.h"
@@ -30,13 +31,17 @@
 #include "llvm/ExecutionEngine/Orc/LLJIT.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/LegacyPassNameParser.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/ToolOutputFile.h"
+#include <chrono>
 #include <cstdint>
 #include <numeric>
 #include <optional>
@@ -87,11 +92,98 @@ struct Options {
       "march",
       llvm::cl::desc("Architecture to generate code for (see --version)")};
 
+  llvm::cl::opt<std::string> mCPU{
+      "mcpu",
+      llvm::cl::desc("Target a specific cpu type, or the host cpu and its "
+                     "features for 'native' (-mcpu=help for details)"),
+      llvm::cl::value_desc("cpu-name"), llvm::cl::init("native"),
+      llvm::cl::cat(optFlags)};
+
+  llvm::cl::opt<std::string> profileUse{
+      "profile-use",
+      llvm::cl::desc("Optimize with the instrumentation profile merged by "
+                     "llvm-profdata in the given file (requires -O1 or more)"),
+      llvm::cl::value_desc("filename"), llvm::cl::cat(optFlags)};
+
+  llvm::cl::opt<std::string> sampleProfileUse{
+      "sample-profile-use",
+      llvm::cl::desc("Optimize with the sample profile in the given file "
+                     "(requires -O1 or more)"),
+      llvm::cl::value_desc("filename"), llvm::cl::cat(optFlags)};
+
   llvm::cl::OptionCategory clOptionsCategory{"linking options"};
   llvm::cl::list<std::string> clSharedLibs{
       "shared-libs", llvm::cl::desc("Libraries to link dynamically"),
       llvm::cl::MiscFlags::CommaSeparated, llvm::cl::cat(clOptionsCategory)};
 
+  llvm::cl::opt<bool> pooledAllocator{
+      "pooled-allocator",
+      llvm::cl::desc("Serve the memory allocation functions by the pooled "
+                     "allocator of the execution engine"),
+      llvm::cl::cat(clOptionsCategory)};
+
+  llvm::cl::opt<uint64_t> hugeAllocationThreshold{
+      "huge-allocation-threshold",
+      llvm::cl::desc("Number of bytes from which the pooled allocator maps "
+                     "allocations directly to huge pages"),
+      llvm::cl::init(
+          mlir::runtime::PooledAllocatorOptions().hugeAllocationThreshold),
+      llvm::cl::cat(clOptionsCategory)};
+
+  llvm::cl::opt<bool> printAllocationStats{
+      "print-allocation-stats",
+      llvm::cl::desc("Print the statistics of the allocations of each call "
+                     "site upon exit (implies -pooled-allocator)"),
+      llvm::cl::cat(clOptionsCategory)};
+
+  llvm::cl::opt<bool> printProfileReport{
+      "print-profile-report",
+      llvm::cl::desc("Print the profile counters added by "
+                     "-llvm-add-profile-counters upon exit (requires the C "
+                     "runner utils library)"),
+      llvm::cl::cat(clOptionsCategory)};
+
+  llvm::cl::OptionCategory benchmarkCategory{"benchmarking options"};
+  llvm::cl::opt<unsigned> benchmarkRepetitions{
+      "benchmark-repetitions",
+      llvm::cl::desc("Call the entry point this many more times after the "
+                     "first call, and report the mean and minimal execution "
+                     "times of these calls"),
+      llvm::cl::init(0), llvm::cl::cat(benchmarkCategory)};
+
+  llvm::cl::opt<unsigned> benchmarkWarmup{
+      "benchmark-warmup",
+      llvm::cl::desc("Call the entry point this many more times after the "
+                     "first call before the timed repetitions"),
+      llvm::cl::init(0), llvm::cl::cat(benchmarkCategory)};
+
+  llvm::cl::opt<uint64_t> benchmarkFlushCacheBytes{
+      "benchmark-flush-cache-bytes",
+      llvm::cl::desc("Write a buffer of this many bytes before each timed "
+                     "repetition, to evict the data of the previous one from "
+                     "the caches"),
+      llvm::cl::init(0), llvm::cl::cat(benchmarkCategory)};
+
+  llvm::cl::opt<uint64_t> benchmarkFlops{
+      "benchmark-flops",
+      llvm::cl::desc("The number of floating-point operations of a call of "
+                     "the entry point, to report the GFLOP/s of the median "
+                     "repetition"),
+      llvm::cl::init(0), llvm::cl::cat(benchmarkCategory)};
+
+  llvm::cl::opt<bool> benchmarkJson{
+      "benchmark-json",
+      llvm::cl::desc("Report the benchmark statistics as a JSON object"),
+      llvm::cl::init(false), llvm::cl::cat(benchmarkCategory)};
+
+  llvm::cl::OptionCategory aotCategory{"ahead-of-time compilation options"};
+  llvm::cl::opt<std::string> objectOutput{
+      "object-output",
+      llvm::cl::desc("Compile the module to a position-independent object "
+                     "file instead of running it, for example to link it in "
+                     "a shared library"),
+      llvm::cl::value_desc("filename"), llvm::cl::cat(aotCategory)};
+
   /// CLI variables for debugging.
   llvm::cl::opt<bool> dumpObjectFile{
       "dump-object-file",
@@ -176,6 +268,68 @@ static std::optional<unsigned> getCommandLineOptLevel(Options &options) {
   return optLevel;
 }
 
+// Call `fptr` with `args` the number of times requested by the benchmarking
+// options, and report the statistics of the execution times of the calls. The
+// first call, made by the caller, warms up the caches and the lazily resolved
+// symbols along with the warmup calls, and the next ones are timed.
+static void runBenchmark(Options &options, StringRef entryPoint,
+                         void (*fptr)(void **), void **args) {
+  for (unsigned i = 0; i < options.benchmarkWarmup; ++i)
+    (*fptr)(args);
+
+  std::vector<char> flushBuffer(options.benchmarkFlushCacheBytes);
+  std::vector<int64_t> times;
+  times.reserve(options.benchmarkRepetitions);
+  for (unsigned i = 0; i < options.benchmarkRepetitions; ++i) {
+    if (!flushBuffer.empty()) {
+      // Write through a volatile pointer so that the stores are not elided.
+      volatile char *data = flushBuffer.data();
+      for (size_t j = 0, e = flushBuffer.size(); j < e; j += 64)
+        data[j] = static_cast<char>(i + j);
+    }
+    auto start = std::chrono::steady_clock::now();
+    (*fptr)(args);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    times.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  }
+
+  llvm::sort(times);
+  int64_t total = std::accumulate(times.begin(), times.end(), int64_t(0));
+  int64_t mean = total / static_cast<int64_t>(times.size());
+  int64_t median = times[times.size() / 2];
+  // The nearest-rank 99th percentile.
+  int64_t p99 = times[llvm::divideCeil(times.size() * 99, 100) - 1];
+  std::optional<double> gflops;
+  if (options.benchmarkFlops > 0 && median > 0)
+    gflops = static_cast<double>(options.benchmarkFlops) / median;
+
+  if (options.benchmarkJson) {
+    llvm::json::OStream json(llvm::outs(), /*IndentSize=*/2);
+    json.object([&] {
+      json.attribute("entry_point", entryPoint);
+      json.attribute("repetitions", int64_t(times.size()));
+      json.attribute("warmup", int64_t(options.benchmarkWarmup));
+      json.attribute("mean_ns", mean);
+      json.attribute("min_ns", times.front());
+      json.attribute("median_ns", median);
+      json.attribute("p99_ns", p99);
+      json.attribute("max_ns", times.back());
+      if (gflops)
+        json.attribute("gflops", *gflops);
+    });
+    llvm::outs() << "\n";
+    return;
+  }
+
+  llvm::errs() << "benchmark: " << entryPoint << ": " << times.size()
+               << " repetitions, mean " << mean << " ns, min " << times.front()
+               << " ns, median " << median << " ns, p99 " << p99 << " ns";
+  if (gflops)
+    llvm::errs() << ", " << llvm::format("%.3f", *gflops) << " GFLOP/s";
+  llvm::errs() << "\n";
+}
+
 // JIT-compile the given module and run "entryPoint" with "args" as arguments.
 static Error
 compileAndExecute(Options &options, Operation *module, StringRef entryPoint,
@@ -195,6 +349,13 @@ compileAndExecute(Options &options, Operation *module, StringRef entryPoint,
   engineOptions.jitCodeGenOptLevel = jitCodeGenOptLevel;
   engineOptions.sharedLibPaths = sharedLibs;
   engineOptions.enableObjectDump = true;
+  engineOptions.printProfileReport = options.printProfileReport;
+  if (options.pooledAllocator || options.printAllocationStats) {
+    mlir::runtime::PooledAllocatorOptions allocatorOptions;
+    allocatorOptions.hugeAllocationThreshold = options.hugeAllocationThreshold;
+    allocatorOptions.collectStatistics = options.printAllocationStats;
+    engineOptions.pooledAllocator = allocatorOptions;
+  }
   auto expectedEngine =
       mlir::ExecutionEngine::create(module, engineOptions, std::move(tm));
   if (!expectedEngine)
@@ -214,6 +375,42 @@ compileAndExecute(Options &options, Operation *module, StringRef entryPoint,
   void (*fptr)(void **) = *expectedFPtr;
   (*fptr)(args);
 
+  if (options.benchmarkRepetitions > 0)
+    runBenchmark(options, entryPoint, fptr, args);
+
+  if (options.printAllocationStats)
+    mlir::runtime::printPooledAllocatorStatistics(llvm::errs());
+
+  return Error::success();
+}
+
+// Compile the given module to the object file requested by the options, which
+// can be linked in an application or a shared library without the JIT.
+static Error compileToObjectFile(Options &options, Operation *module,
+                                 CompileAndExecuteConfig config,
+                                 llvm::TargetMachine &tm) {
+  llvm::LLVMContext llvmContext;
+  std::unique_ptr<llvm::Module> llvmModule =
+      config.llvmModuleBuilder ? config.llvmModuleBuilder(module, llvmContext)
+                               : translateModuleToLLVMIR(module, llvmContext);
+  if (!llvmModule)
+    return makeStringError("could not convert to LLVM IR");
+  ExecutionEngine::setupTargetTripleAndDataLayout(llvmModule.get(), &tm);
+  if (config.transformer)
+    if (Error error = config.transformer(llvmModule.get()))
+      return error;
+
+  std::string errorMessage;
+  std::unique_ptr<llvm::ToolOutputFile> output =
+      openOutputFile(options.objectOutput, &errorMessage);
+  if (!output)
+    return makeStringError(errorMessage);
+  llvm::legacy::PassManager codegenPasses;
+  if (tm.addPassesToEmitFile(codegenPasses, output->os(), nullptr,
+                             llvm::CGFT_ObjectFile))
+    return makeStringError("the target cannot emit object files");
+  codegenPasses.run(*llvmModule);
+  output->keep();
   return Error::success();
 }
 
@@ -341,7 +538,13 @@ int mlir::JitRunnerMain(int argc, char **argv, const DialectRegistry &registry,
     return EXIT_FAILURE;
   }
 
-  // Configure TargetMachine builder based on the command line options
+  // Configure TargetMachine builder based on the command line options. The
+  // host builder targets the host cpu with the features it detected, which
+  // are dropped when targeting another cpu.
+  if (options.mCPU != "native") {
+    tmBuilderOrError->setCPU(options.mCPU);
+    tmBuilderOrError->getFeatures() = llvm::SubtargetFeatures();
+  }
   llvm::SubtargetFeatures features;
   if (!options.mAttrs.empty()) {
     for (StringRef attr : options.mAttrs)
@@ -353,6 +556,14 @@ int mlir::JitRunnerMain(int argc, char **argv, const DialectRegistry &registry,
     tmBuilderOrError->getTargetTriple().setArchName(options.mArch);
   }
 
+  // The objects compiled ahead of time may be linked in shared libraries.
+  if (!options.objectOutput.empty()) {
+    tmBuilderOrError->setRelocationModel(llvm::Reloc::PIC_);
+    if (optLevel)
+      tmBuilderOrError->setCodeGenOptLevel(
+          static_cast<llvm::CodeGenOpt::Level>(*optLevel));
+  }
+
   // Build TargetMachine
   auto tmOrError = tmBuilderOrError->createTargetMachine();
 
@@ -367,14 +578,40 @@ int mlir::JitRunnerMain(int argc, char **argv, const DialectRegistry &registry,
                                                               "\n");
   });
 
+  if (!options.profileUse.empty() && !options.sampleProfileUse.empty()) {
+    llvm::errs() << "-profile-use and -sample-profile-use are exclusive\n";
+    return EXIT_FAILURE;
+  }
+
   CompileAndExecuteConfig compileAndExecuteConfig;
-  if (optLevel) {
+  if (optLevel && (!options.profileUse.empty() ||
+                   !options.sampleProfileUse.empty())) {
+    ProfileUseOptions profileOptions;
+    if (!options.profileUse.empty()) {
+      profileOptions.profileFile = options.profileUse;
+    } else {
+      profileOptions.kind = ProfileUseOptions::Kind::Sample;
+      profileOptions.profileFile = options.sampleProfileUse;
+    }
+    compileAndExecuteConfig.transformer = mlir::makeOptimizingTransformer(
+        *optLevel, /*sizeLevel=*/0, /*targetMachine=*/tmOrError->get(),
+        profileOptions);
+  } else if (optLevel) {
     compileAndExecuteConfig.transformer = mlir::makeOptimizingTransformer(
         *optLevel, /*sizeLevel=*/0, /*targetMachine=*/tmOrError->get());
   }
   compileAndExecuteConfig.llvmModuleBuilder = config.llvmModuleBuilder;
   compileAndExecuteConfig.runtimeSymbolMap = config.runtimesymbolMap;
 
+  if (!options.objectOutput.empty()) {
+    Error error = compileToObjectFile(options, m.get(), compileAndExecuteConfig,
+                                      *tmOrError.get());
+    if (!error)
+      return EXIT_SUCCESS;
+    llvm::errs() << "Error: " << llvm::toString(std::move(error)) << '\n';
+    return EXIT_FAILURE;
+  }
+
   // Get the function used to compile and execute the module.
   using CompileAndExecuteFnT =
       Error (*)(Options &, Operation *, StringRef, CompileAndExecuteConfig,
@@ -0,0 +1,130 @@
+//===- MicroKernels.cpp - Micro-kernels for linalg tiles ------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the micro-kernels declared in MicroKernels.h. They
+// are written in portable C++ for static tile sizes, so that the host
+// compiler keeps the accumulator tile in vector registers and vectorizes
+// the rank-1 updates of the reduction. Hand-written kernels for a specific
+// ISA can replace any of them under the same symbol.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/ExecutionEngine/MicroKernels.h"
+
+#include <cassert>
+#include <cstdint>
+
+namespace {
+
+/// Returns the element of the rank-4 `memref` at the given coordinates.
+template <typename T>
+inline T &at(StridedMemRefType<T, 4> *memref, int64_t i0, int64_t i1,
+             int64_t i2, int64_t i3) {
+  return memref->data[memref->offset + i0 * memref->strides[0] +
+                      i1 * memref->strides[1] + i2 * memref->strides[2] +
+                      i3 * memref->strides[3]];
+}
+
+/// Returns the element of the rank-2 `memref` at the given coordinates.
+template <typename T>
+inline T &at(StridedMemRefType<T, 2> *memref, int64_t i0, int64_t i1) {
+  return memref->data[memref->offset + i0 * memref->strides[0] +
+                      i1 * memref->strides[1]];
+}
+
+/// Adds the outer product of `a` and `b` to the accumulator tile `c`.
+template <typename T, int64_t M0, int64_t N0>
+inline void rank1Update(T (&c)[M0][N0], const T (&a)[M0], const T (&b)[N0]) {
+  for (int64_t m0 = 0; m0 < M0; ++m0)
+    for (int64_t n0 = 0; n0 < N0; ++n0)
+      c[m0][n0] += a[m0] * b[n0];
+}
+
+template <typename T, int64_t M0, int64_t N0, int64_t K0>
+void mmt4d(StridedMemRefType<T, 4> *lhs, StridedMemRefType<T, 4> *rhs,
+           StridedMemRefType<T, 4> *acc) {
+  const int64_t m = acc->sizes[0];
+  const int64_t n = acc->sizes[1];
+  const int64_t k = lhs->sizes[1];
+  assert(lhs->sizes[0] == m && rhs->sizes[0] == n && rhs->sizes[1] == k &&
+         "Mismatched outer sizes");
+  assert(lhs->sizes[2] == M0 && lhs->sizes[3] == K0 && rhs->sizes[2] == N0 &&
+         rhs->sizes[3] == K0 && acc->sizes[2] == M0 && acc->sizes[3] == N0 &&
+         "Mismatched tile sizes");
+  for (int64_t i = 0; i < m; ++i) {
+    for (int64_t j = 0; j < n; ++j) {
+      T c[M0][N0];
+      for (int64_t m0 = 0; m0 < M0; ++m0)
+        for (int64_t n0 = 0; n0 < N0; ++n0)
+          c[m0][n0] = at(acc, i, j, m0, n0);
+      for (int64_t l = 0; l < k; ++l) {
+        for (int64_t k0 = 0; k0 < K0; ++k0) {
+          T a[M0], b[N0];
+          for (int64_t m0 = 0; m0 < M0; ++m0)
+            a[m0] = at(lhs, i, l, m0, k0);
+          for (int64_t n0 = 0; n0 < N0; ++n0)
+            b[n0] = at(rhs, j, l, n0, k0);
+          rank1Update(c, a, b);
+        }
+      }
+      for (int64_t m0 = 0; m0 < M0; ++m0)
+        for (int64_t n0 = 0; n0 < N0; ++n0)
+          at(acc, i, j, m0, n0) = c[m0][n0];
+    }
+  }
+}
+
+template <typename T, int64_t M0, int64_t N0>
+void matmul(StridedMemRefType<T, 2> *lhs, StridedMemRefType<T, 2> *rhs,
+            StridedMemRefType<T, 2> *acc) {
+  const int64_t k = lhs->sizes[1];
+  assert(lhs->sizes[0] == M0 && rhs->sizes[0] == k && rhs->sizes[1] == N0 &&
+         acc->sizes[0] == M0 && acc->sizes[1] == N0 &&
+         "Mismatched tile sizes");
+  T c[M0][N0];
+  for (int64_t m0 = 0; m0 < M0; ++m0)
+    for (int64_t n0 = 0; n0 < N0; ++n0)
+      c[m0][n0] = at(acc, m0, n0);
+  for (int64_t l = 0; l < k; ++l) {
+    T a[M0], b[N0];
+    for (int64_t m0 = 0; m0 < M0; ++m0)
+      a[m0] = at(lhs, m0, l);
+    for (int64_t n0 = 0; n0 < N0; ++n0)
+      b[n0] = at(rhs, l, n0);
+    rank1Update(c, a, b);
+  }
+  for (int64_t m0 = 0; m0 < M0; ++m0)
+    for (int64_t n0 = 0; n0 < N0; ++n0)
+      at(acc, m0, n0) = c[m0][n0];
+}
+
+} // namespace
+
+extern "C" {
+
+#define IMPL_MMT4D(M0, N0, K0)                                                 \
+  void _mlir_ciface_mlir_ukernel_mmt4d_f32f32f32_##M0##x##N0##x##K0(           \
+      StridedMemRefType<float, 4> *lhs, StridedMemRefType<float, 4> *rhs,      \
+      StridedMemRefType<float, 4> *acc) {                                      \
+    mmt4d<float, M0, N0, K0>(lhs, rhs, acc);                                   \
+  }
+IMPL_MMT4D(8, 8, 1)
+IMPL_MMT4D(16, 16, 1)
+#undef IMPL_MMT4D
+
+#define IMPL_MATMUL(M0, N0)                                                    \
+  void _mlir_ciface_mlir_ukernel_matmul_f32f32f32_##M0##x##N0(                 \
+      StridedMemRefType<float, 2> *lhs, StridedMemRefType<float, 2> *rhs,      \
+      StridedMemRefType<float, 2> *acc) {                                      \
+    matmul<float, M0, N0>(lhs, rhs, acc);                                      \
+  }
+IMPL_MATMUL(8, 8)
+IMPL_MATMUL(16, 16)
+#undef IMPL_MATMUL
+
+} // extern "C"
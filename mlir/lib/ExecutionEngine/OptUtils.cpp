@@ -18,7 +18,9 @@
 #include "llvm/Passes/OptimizationLevel.h"
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/VirtualFileSystem.h"
 #include "llvm/Target/TargetMachine.h"
 #include <optional>
 
@@ -50,12 +52,25 @@ static std::optional<OptimizationLevel> mapToLevel(unsigned optLevel,
   }
   return std::nullopt;
 }
+
+/// Returns the options of the pass builder that read the given profile.
+static PGOOptions getPGOOptions(const mlir::ProfileUseOptions &profileOptions) {
+  PGOOptions::PGOAction action =
+      profileOptions.kind == mlir::ProfileUseOptions::Kind::Sample
+          ? PGOOptions::SampleUse
+          : PGOOptions::IRUse;
+  return PGOOptions(profileOptions.profileFile, /*CSProfileGenFile=*/"",
+                    profileOptions.remappingFile, /*MemoryProfile=*/"",
+                    vfs::getRealFileSystem(), action);
+}
+
 // Create and return a lambda that uses LLVM pass manager builder to set up
-// optimizations based on the given level.
-std::function<Error(Module *)>
-mlir::makeOptimizingTransformer(unsigned optLevel, unsigned sizeLevel,
-                                TargetMachine *targetMachine) {
-  return [optLevel, sizeLevel, targetMachine](Module *m) -> Error {
+// optimizations based on the given level and profile.
+static std::function<Error(Module *)>
+makeTransformer(unsigned optLevel, unsigned sizeLevel,
+                TargetMachine *targetMachine,
+                std::optional<PGOOptions> pgoOptions) {
+  return [optLevel, sizeLevel, targetMachine, pgoOptions](Module *m) -> Error {
     std::optional<OptimizationLevel> ol = mapToLevel(optLevel, sizeLevel);
     if (!ol) {
       return make_error<StringError>(
@@ -64,6 +79,12 @@ mlir::makeOptimizingTransformer(unsigned optLevel, unsigned sizeLevel,
               .str(),
           inconvertibleErrorCode());
     }
+    if (pgoOptions && !sys::fs::exists(pgoOptions->ProfileFile)) {
+      return make_error<StringError>(
+          formatv("profile file '{0}' not found", pgoOptions->ProfileFile)
+              .str(),
+          inconvertibleErrorCode());
+    }
     LoopAnalysisManager lam;
     FunctionAnalysisManager fam;
     CGSCCAnalysisManager cgam;
@@ -75,7 +96,7 @@ mlir::makeOptimizingTransformer(unsigned optLevel, unsigned sizeLevel,
     tuningOptions.LoopVectorization = true;
     tuningOptions.SLPVectorization = true;
 
-    PassBuilder pb(targetMachine, tuningOptions);
+    PassBuilder pb(targetMachine, tuningOptions, pgoOptions);
 
     pb.registerModuleAnalyses(mam);
     pb.registerCGSCCAnalyses(cgam);
@@ -89,3 +110,17 @@ mlir::makeOptimizingTransformer(unsigned optLevel, unsigned sizeLevel,
     return Error::success();
   };
 }
+
+std::function<Error(Module *)>
+mlir::makeOptimizingTransformer(unsigned optLevel, unsigned sizeLevel,
+                                TargetMachine *targetMachine) {
+  return makeTransformer(optLevel, sizeLevel, targetMachine, std::nullopt);
+}
+
+std::function<Error(Module *)>
+mlir::makeOptimizingTransformer(unsigned optLevel, unsigned sizeLevel,
+                                TargetMachine *targetMachine,
+                                const ProfileUseOptions &profileOptions) {
+  return makeTransformer(optLevel, sizeLevel, targetMachine,
+                         getPGOOptions(profileOptions));
+}
@@ -0,0 +1,428 @@
+//===- PooledAllocator.cpp - Pooled allocator for JIT code ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the pooled allocator. Every allocation is preceded by a
+// header that records how its memory was obtained, such that it can be freed
+// by any thread without looking it up:
+//
+//  - the blocks of the size classes are carved from slabs that are never
+//    returned to the system. The free blocks are cached per thread, and
+//    exchanged in batches with a central free list when a cache runs empty or
+//    full;
+//  - the allocations above the huge allocation threshold are mapped directly,
+//    at the alignment of huge pages, and advised to be backed by them;
+//  - the allocations in between are forwarded to the system allocator.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/ExecutionEngine/PooledAllocator.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <intrin.h>
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif // _WIN32
+
+using namespace mlir::runtime;
+
+#ifdef _MSC_VER
+#define MLIR_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define MLIR_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+namespace {
+/// Header preceding every allocation.
+struct alignas(16) BlockHeader {
+  /// Start and size of the memory that holds the allocation.
+  void *base;
+  uint64_t baseSize;
+  /// Number of bytes requested.
+  uint64_t size;
+  /// Size class of the memory, or `kDirectKind` or `kHugeKind`.
+  uint32_t kind;
+  /// One plus the index of the statistics of the call site, or 0.
+  uint32_t site;
+};
+} // namespace
+
+static_assert(sizeof(BlockHeader) == 32, "unexpected block header size");
+
+/// The size classes have a granule of 16 bytes up to 128 bytes, and 4 classes
+/// per power of 2 above, up to 256 KiB.
+static constexpr unsigned kNumSizeClasses = 52;
+static constexpr uint64_t kMaxClassSize = 256 * 1024;
+static constexpr uint32_t kDirectKind = kNumSizeClasses;
+static constexpr uint32_t kHugeKind = kNumSizeClasses + 1;
+
+/// Minimum size of the slabs from which the blocks are carved.
+static constexpr uint64_t kSlabSize = 1024 * 1024;
+/// Number of bytes of the blocks of each class cached by a thread.
+static constexpr uint64_t kThreadCacheBytes = 256 * 1024;
+/// Size and alignment of the mappings of the huge allocations.
+static constexpr uint64_t kHugePageSize = 2 * 1024 * 1024;
+
+/// Returns the size class of the blocks of `size` bytes.
+static unsigned getSizeClass(uint64_t size) {
+  if (size <= 128)
+    return (std::max<uint64_t>(size, 1) + 15) / 16 - 1;
+  unsigned log = llvm::Log2_64(size - 1);
+  return 8 + (log - 7) * 4 + ((size - 1) >> (log - 2)) - 4;
+}
+
+/// Returns the size of the blocks of the size class `sizeClass`.
+static uint64_t getClassSize(unsigned sizeClass) {
+  if (sizeClass < 8)
+    return (sizeClass + 1) * 16;
+  unsigned log = 7 + (sizeClass - 8) / 4;
+  return (uint64_t(1) << log) +
+         ((sizeClass - 8) % 4 + 1) * (uint64_t(1) << (log - 2));
+}
+
+/// Returns the number of blocks of the size class `sizeClass` that a thread
+/// caches.
+static uint32_t getCacheCapacity(unsigned sizeClass) {
+  return std::clamp<uint64_t>(kThreadCacheBytes / getClassSize(sizeClass), 4,
+                              256);
+}
+
+static void *allocateSystem(uint64_t alignment, uint64_t size) {
+#ifdef _WIN32
+  return _aligned_malloc(size, alignment);
+#else
+  void *result = nullptr;
+  if (::posix_memalign(&result, alignment, size))
+    return nullptr;
+  return result;
+#endif // _WIN32
+}
+
+static void freeSystem(void *ptr) {
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif // _WIN32
+}
+
+/// Maps `size` bytes at the alignment of huge pages, and advises the system
+/// to back them by huge pages. Returns null on failure.
+static void *mapHuge(uint64_t size) {
+#ifdef _WIN32
+  (void)size;
+  return nullptr;
+#else
+  // Over-map by a huge page and unmap the unaligned ends.
+  uint64_t mappedSize = size + kHugePageSize;
+  void *mapped = ::mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapped == MAP_FAILED)
+    return nullptr;
+  auto start = reinterpret_cast<uintptr_t>(mapped);
+  uintptr_t alignedStart = llvm::alignTo(start, kHugePageSize);
+  if (alignedStart != start)
+    ::munmap(mapped, alignedStart - start);
+  if (uintptr_t tail = start + mappedSize - (alignedStart + size))
+    ::munmap(reinterpret_cast<void *>(alignedStart + size), tail);
+  void *result = reinterpret_cast<void *>(alignedStart);
+#ifdef MADV_HUGEPAGE
+  ::madvise(result, size, MADV_HUGEPAGE);
+#endif // MADV_HUGEPAGE
+  return result;
+#endif // _WIN32
+}
+
+static void unmapHuge(void *ptr, uint64_t size) {
+#ifdef _WIN32
+  (void)ptr;
+  (void)size;
+#else
+  ::munmap(ptr, size);
+#endif // _WIN32
+}
+
+namespace {
+/// A free block, linked to the next one of its size class.
+struct FreeBlock {
+  FreeBlock *next;
+};
+
+/// A list of the free blocks of a size class.
+struct FreeList {
+  FreeBlock *head = nullptr;
+  uint32_t size = 0;
+
+  void push(FreeBlock *block) {
+    block->next = head;
+    head = block;
+    ++size;
+  }
+
+  FreeBlock *pop() {
+    FreeBlock *block = head;
+    head = block->next;
+    --size;
+    return block;
+  }
+
+  /// Moves `count` blocks of this list to `other`.
+  void moveTo(FreeList &other, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i)
+      other.push(pop());
+  }
+};
+
+/// The free blocks shared by all threads, and the slabs that hold them.
+struct CentralPool {
+  std::mutex mutexes[kNumSizeClasses];
+  FreeList lists[kNumSizeClasses];
+
+  /// Moves up to `count` free blocks of `sizeClass` to `list`, carving a new
+  /// slab if there is none. Returns false on failure.
+  bool refill(unsigned sizeClass, FreeList &list, uint32_t count) {
+    std::lock_guard<std::mutex> lock(mutexes[sizeClass]);
+    FreeList &central = lists[sizeClass];
+    if (central.size == 0) {
+      uint64_t classSize = getClassSize(sizeClass);
+      uint64_t slabSize = std::max(kSlabSize, classSize * count);
+      auto *slab = static_cast<char *>(allocateSystem(64, slabSize));
+      if (!slab)
+        return false;
+      for (uint64_t offset = 0; offset + classSize <= slabSize;
+           offset += classSize)
+        central.push(reinterpret_cast<FreeBlock *>(slab + offset));
+    }
+    central.moveTo(list, std::min(count, central.size));
+    return true;
+  }
+
+  /// Moves `count` free blocks of `sizeClass` from `list` to the pool.
+  void release(unsigned sizeClass, FreeList &list, uint32_t count) {
+    std::lock_guard<std::mutex> lock(mutexes[sizeClass]);
+    list.moveTo(lists[sizeClass], count);
+  }
+};
+} // namespace
+
+/// Returns the central pool. It is never destroyed, such that the threads that
+/// exit after the static destructors ran may still release their blocks.
+static CentralPool &getCentralPool() {
+  static CentralPool *pool = new CentralPool();
+  return *pool;
+}
+
+namespace {
+/// The free blocks cached by a thread.
+struct ThreadCache {
+  FreeList lists[kNumSizeClasses];
+
+  ~ThreadCache() {
+    for (auto [sizeClass, list] : llvm::enumerate(lists))
+      if (list.size)
+        getCentralPool().release(sizeClass, list, list.size);
+  }
+
+  void *allocate(unsigned sizeClass) {
+    FreeList &list = lists[sizeClass];
+    if (list.size == 0 &&
+        !getCentralPool().refill(sizeClass, list,
+                                 getCacheCapacity(sizeClass) / 2))
+      return nullptr;
+    return list.pop();
+  }
+
+  void deallocate(unsigned sizeClass, void *ptr) {
+    FreeList &list = lists[sizeClass];
+    list.push(static_cast<FreeBlock *>(ptr));
+    uint32_t capacity = getCacheCapacity(sizeClass);
+    if (list.size > capacity)
+      getCentralPool().release(sizeClass, list, capacity / 2);
+  }
+};
+
+} // namespace
+
+static thread_local ThreadCache threadCache;
+
+namespace {
+/// The statistics of the call sites, indexed in the order of their first
+/// allocation.
+struct StatisticsRegistry {
+  std::mutex mutex;
+  std::unordered_map<const void *, uint32_t> siteIndices;
+  std::vector<AllocationSiteStatistics> sites;
+
+  /// Records an allocation of `size` bytes from `site`, and returns the
+  /// value of the `site` field of its header.
+  uint32_t recordAllocation(const void *site, uint64_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto [it, inserted] = siteIndices.try_emplace(site, sites.size());
+    if (inserted) {
+      sites.emplace_back();
+      sites.back().site = site;
+    }
+    AllocationSiteStatistics &stats = sites[it->second];
+    ++stats.numAllocations;
+    stats.allocatedBytes += size;
+    stats.liveBytes += size;
+    stats.peakLiveBytes = std::max(stats.peakLiveBytes, stats.liveBytes);
+    return it->second + 1;
+  }
+
+  /// Records the free of an allocation of `size` bytes, whose header has the
+  /// `site` field `site`.
+  void recordFree(uint32_t site, uint64_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    AllocationSiteStatistics &stats = sites[site - 1];
+    ++stats.numFrees;
+    stats.liveBytes -= size;
+  }
+};
+
+} // namespace
+
+static StatisticsRegistry &getStatisticsRegistry() {
+  static StatisticsRegistry *registry = new StatisticsRegistry();
+  return *registry;
+}
+
+static std::atomic<uint64_t> hugeAllocationThreshold{
+    PooledAllocatorOptions().hugeAllocationThreshold};
+static std::atomic<bool> collectStatistics{false};
+
+/// Allocates `size` bytes aligned to `alignment` for the call site `site`.
+static void *allocate(uint64_t alignment, uint64_t size, const void *site) {
+  alignment = std::max<uint64_t>(alignment, alignof(BlockHeader));
+  if (!llvm::isPowerOf2_64(alignment) ||
+      size > std::numeric_limits<uint64_t>::max() / 2 - alignment)
+    return nullptr;
+  // The memory of the allocations is at least aligned to the header, which
+  // leaves at most `alignment - alignof(BlockHeader)` bytes for the padding.
+  uint64_t blockSize =
+      sizeof(BlockHeader) + size + alignment - alignof(BlockHeader);
+
+  void *base = nullptr;
+  uint64_t baseSize = blockSize;
+  uint32_t kind;
+  if (blockSize >= hugeAllocationThreshold.load(std::memory_order_relaxed) &&
+      (base = mapHuge(llvm::alignTo(blockSize, kHugePageSize)))) {
+    baseSize = llvm::alignTo(blockSize, kHugePageSize);
+    kind = kHugeKind;
+  } else if (blockSize <= kMaxClassSize) {
+    unsigned sizeClass = getSizeClass(blockSize);
+    base = threadCache.allocate(sizeClass);
+    baseSize = getClassSize(sizeClass);
+    kind = sizeClass;
+  } else {
+    base = allocateSystem(alignof(BlockHeader), blockSize);
+    kind = kDirectKind;
+  }
+  if (!base)
+    return nullptr;
+
+  uintptr_t address = llvm::alignTo(
+      reinterpret_cast<uintptr_t>(base) + sizeof(BlockHeader), alignment);
+  auto *header = reinterpret_cast<BlockHeader *>(address) - 1;
+  header->base = base;
+  header->baseSize = baseSize;
+  header->size = size;
+  header->kind = kind;
+  header->site =
+      collectStatistics.load(std::memory_order_relaxed)
+          ? getStatisticsRegistry().recordAllocation(site, size)
+          : 0;
+  return reinterpret_cast<void *>(address);
+}
+
+void mlir::runtime::configurePooledAllocator(
+    const PooledAllocatorOptions &options) {
+  hugeAllocationThreshold.store(options.hugeAllocationThreshold,
+                                std::memory_order_relaxed);
+  collectStatistics.store(options.collectStatistics,
+                          std::memory_order_relaxed);
+}
+
+void *mlir::runtime::pooledAlloc(uint64_t size) {
+  return allocate(alignof(BlockHeader), size, MLIR_RETURN_ADDRESS());
+}
+
+void *mlir::runtime::pooledAlignedAlloc(uint64_t alignment, uint64_t size) {
+  return allocate(alignment, size, MLIR_RETURN_ADDRESS());
+}
+
+void mlir::runtime::pooledFree(void *ptr) {
+  if (!ptr)
+    return;
+  auto *header = static_cast<BlockHeader *>(ptr) - 1;
+  if (header->site)
+    getStatisticsRegistry().recordFree(header->site, header->size);
+  void *base = header->base;
+  if (header->kind < kNumSizeClasses)
+    threadCache.deallocate(header->kind, base);
+  else if (header->kind == kHugeKind)
+    unmapHuge(base, header->baseSize);
+  else
+    freeSystem(base);
+}
+
+std::vector<AllocationSiteStatistics>
+mlir::runtime::getPooledAllocatorStatistics() {
+  StatisticsRegistry &registry = getStatisticsRegistry();
+  std::vector<AllocationSiteStatistics> sites;
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    sites = registry.sites;
+  }
+  llvm::stable_sort(sites, [](const AllocationSiteStatistics &lhs,
+                              const AllocationSiteStatistics &rhs) {
+    return lhs.allocatedBytes > rhs.allocatedBytes;
+  });
+  return sites;
+}
+
+void mlir::runtime::resetPooledAllocatorStatistics() {
+  StatisticsRegistry &registry = getStatisticsRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  // The live allocations keep the index of their site, and their frees are
+  // still recorded.
+  for (AllocationSiteStatistics &stats : registry.sites) {
+    stats.numAllocations = 0;
+    stats.numFrees = 0;
+    stats.allocatedBytes = 0;
+    stats.peakLiveBytes = stats.liveBytes;
+  }
+}
+
+void mlir::runtime::printPooledAllocatorStatistics(llvm::raw_ostream &os) {
+  os << "===" << std::string(73, '-') << "===\n"
+     << std::string(26, ' ') << "Pooled allocator statistics\n"
+     << "===" << std::string(73, '-') << "===\n";
+  os << " allocations        frees  allocated bytes       live bytes  "
+        "peak live bytes  call site\n";
+  for (const AllocationSiteStatistics &stats : getPooledAllocatorStatistics())
+    os << llvm::format("%12llu %12llu %16llu %16llu %16llu  %p\n",
+                       static_cast<unsigned long long>(stats.numAllocations),
+                       static_cast<unsigned long long>(stats.numFrees),
+                       static_cast<unsigned long long>(stats.allocatedBytes),
+                       static_cast<unsigned long long>(stats.liveBytes),
+                       static_cast<unsigned long long>(stats.peakLiveBytes),
+                       stats.site);
+}
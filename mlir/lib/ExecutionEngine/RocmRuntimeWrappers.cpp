@@ -12,8 +12,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <unordered_map>
 
 #include "mlir/ExecutionEngine/CRunnerUtils.h"
 #include "llvm/ADT/ArrayRef.h"
@@ -99,14 +105,100 @@ extern "C" void mgpuEventRecord(hipEvent_t event, hipStream_t stream) {
   HIP_REPORT_IF_ERROR(hipEventRecord(event, stream));
 }
 
-extern "C" void *mgpuMemAlloc(uint64_t sizeBytes, hipStream_t /*stream*/) {
+// Returns whether the device memory is allocated from the stream-ordered
+// memory pool of the device, which the allocations and frees are ordered with
+// the other work of their stream in, instead of synchronizing the device. The
+// pool keeps the freed memory for the subsequent allocations. It is used when
+// the device supports it, unless the MLIR_GPU_MEMORY_POOL environment variable
+// is set to 0.
+static bool isMemoryPoolEnabled() {
+  static bool enabled = [] {
+    const char *value = getenv("MLIR_GPU_MEMORY_POOL");
+    if (value && !strcmp(value, "0"))
+      return false;
+    int device = 0;
+    int supported = 0;
+    HIP_REPORT_IF_ERROR(hipGetDevice(&device));
+    HIP_REPORT_IF_ERROR(hipDeviceGetAttribute(
+        &supported, hipDeviceAttributeMemoryPoolsSupported, device));
+    if (!supported)
+      return false;
+    hipMemPool_t pool;
+    HIP_REPORT_IF_ERROR(hipDeviceGetDefaultMemPool(&pool, device));
+    uint64_t threshold = UINT64_MAX;
+    HIP_REPORT_IF_ERROR(hipMemPoolSetAttribute(
+        pool, hipMemPoolAttrReleaseThreshold, &threshold));
+    return true;
+  }();
+  return enabled;
+}
+
+// Statistics of the device allocations, which are collected and printed at
+// exit if the MLIR_GPU_MEMORY_STATS environment variable is set.
+class MemoryStatistics {
+public:
+  ~MemoryStatistics() {
+    fprintf(stderr,
+            "gpu memory: %llu allocations, %llu frees, %llu bytes allocated, "
+            "%llu bytes peak\n",
+            numAllocations, numFrees, allocatedBytes, peakLiveBytes);
+  }
+
+  void recordAlloc(void *ptr, uint64_t sizeBytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    sizes[ptr] = sizeBytes;
+    ++numAllocations;
+    allocatedBytes += sizeBytes;
+    liveBytes += sizeBytes;
+    peakLiveBytes = std::max(peakLiveBytes, liveBytes);
+  }
+
+  void recordFree(void *ptr) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = sizes.find(ptr);
+    if (it == sizes.end())
+      return;
+    ++numFrees;
+    liveBytes -= it->second;
+    sizes.erase(it);
+  }
+
+private:
+  std::mutex mutex;
+  std::unordered_map<void *, uint64_t> sizes;
+  unsigned long long numAllocations = 0;
+  unsigned long long numFrees = 0;
+  unsigned long long allocatedBytes = 0;
+  unsigned long long liveBytes = 0;
+  unsigned long long peakLiveBytes = 0;
+};
+
+// Returns the statistics of the device allocations, or null if they are not
+// collected.
+static MemoryStatistics *getMemoryStatistics() {
+  static std::unique_ptr<MemoryStatistics> statistics(
+      getenv("MLIR_GPU_MEMORY_STATS") ? new MemoryStatistics() : nullptr);
+  return statistics.get();
+}
+
+extern "C" void *mgpuMemAlloc(uint64_t sizeBytes, hipStream_t stream) {
   void *ptr;
-  HIP_REPORT_IF_ERROR(hipMalloc(&ptr, sizeBytes));
+  if (isMemoryPoolEnabled())
+    HIP_REPORT_IF_ERROR(hipMallocAsync(&ptr, sizeBytes, stream));
+  else
+    HIP_REPORT_IF_ERROR(hipMalloc(&ptr, sizeBytes));
+  if (MemoryStatistics *statistics = getMemoryStatistics())
+    statistics->recordAlloc(ptr, sizeBytes);
   return ptr;
 }
 
-extern "C" void mgpuMemFree(void *ptr, hipStream_t /*stream*/) {
-  HIP_REPORT_IF_ERROR(hipFree(ptr));
+extern "C" void mgpuMemFree(void *ptr, hipStream_t stream) {
+  if (MemoryStatistics *statistics = getMemoryStatistics())
+    statistics->recordFree(ptr);
+  if (isMemoryPoolEnabled())
+    HIP_REPORT_IF_ERROR(hipFreeAsync(ptr, stream));
+  else
+    HIP_REPORT_IF_ERROR(hipFree(ptr));
 }
 
 extern "C" void mgpuMemcpy(void *dst, void *src, size_t sizeBytes,
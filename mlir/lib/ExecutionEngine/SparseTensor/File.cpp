@@ -25,11 +25,75 @@
 
 #include "mlir/ExecutionEngine/SparseTensor/File.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstring>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace mlir::sparse_tensor;
 
+//===----------------------------------------------------------------------===//
+// MappedFile
+//===----------------------------------------------------------------------===//
+
+detail::MappedFile::MappedFile(const char *filename) {
+#ifndef _WIN32
+  // Try to map the file into memory.
+  const int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    MLIR_SPARSETENSOR_FATAL("Cannot find file %s\n", filename);
+  struct stat st;
+  if (fstat(fd, &st) == 0) {
+    size = static_cast<uint64_t>(st.st_size);
+    if (size == 0) {
+      close(fd);
+      return;
+    }
+    void *ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ptr != MAP_FAILED) {
+      close(fd);
+      data = static_cast<char *>(ptr);
+      isMapped = true;
+      // The file is parsed front to back.
+      madvise(ptr, size, MADV_SEQUENTIAL);
+      return;
+    }
+  }
+  close(fd);
+#endif
+  // Otherwise, read the whole file into a buffer.
+  FILE *file = fopen(filename, "rb");
+  if (!file)
+    MLIR_SPARSETENSOR_FATAL("Cannot find file %s\n", filename);
+  fseek(file, 0, SEEK_END);
+  size = static_cast<uint64_t>(ftell(file));
+  fseek(file, 0, SEEK_SET);
+  data = static_cast<char *>(malloc(size ? size : 1));
+  if (!data || fread(data, 1, size, file) != size)
+    MLIR_SPARSETENSOR_FATAL("Cannot read file %s\n", filename);
+  fclose(file);
+}
+
+detail::MappedFile::~MappedFile() {
+#ifndef _WIN32
+  if (isMapped) {
+    munmap(data, size);
+    return;
+  }
+#endif
+  free(data);
+}
+
+//===----------------------------------------------------------------------===//
+// SparseTensorReader
+//===----------------------------------------------------------------------===//
+
 /// Opens the file for reading.
 void SparseTensorReader::openFile() {
   if (file)
@@ -45,6 +109,7 @@ void SparseTensorReader::closeFile() {
     fclose(file);
     file = nullptr;
   }
+  mappedFile.reset();
 }
 
 /// Attempts to read a line from the file.
@@ -191,3 +256,62 @@ void SparseTensorReader::readExtFROSTTHeader() {
   // The FROSTT format does not define the data type of the nonzero elements.
   valueKind_ = ValueKind::kUndefined;
 }
+
+/// Counts the lines of `[begin, end)` that aren't blank.
+static uint64_t countNonBlankLines(const char *begin, const char *end) {
+  uint64_t numLines = 0;
+  for (const char *ptr = begin; ptr != end;) {
+    ptr = detail::skipBlankLines(ptr, end);
+    if (ptr == end || detail::skipBlanks(ptr, end) == end)
+      break;
+    ++numLines;
+    ptr = detail::skipLine(ptr, end);
+  }
+  return numLines;
+}
+
+std::vector<SparseTensorReader::ElementChunk>
+SparseTensorReader::mapElementChunks() {
+  assert(file && "Attempt to mapElementChunks() before openFile()");
+  // The elements follow the header, which has already been read.
+  const long offset = ftell(file);
+  if (offset < 0)
+    MLIR_SPARSETENSOR_FATAL("Cannot read next line of %s\n", filename);
+  mappedFile = std::make_unique<detail::MappedFile>(filename);
+  const char *begin =
+      mappedFile->getData() +
+      std::min(static_cast<uint64_t>(offset), mappedFile->getSize());
+  const char *end = mappedFile->getData() + mappedFile->getSize();
+
+  // Split the elements into chunks of whole lines, one per thread, making
+  // sure that each thread has enough work to amortize its startup.
+  const uint64_t numBytes = end - begin;
+  const uint64_t numChunks = detail::getNumThreads(numBytes, kMinChunkSize);
+  std::vector<ElementChunk> chunks(numChunks);
+  const char *chunkBegin = begin;
+  for (uint64_t i = 0; i < numChunks; ++i) {
+    const char *chunkEnd = end;
+    if (i + 1 != numChunks)
+      chunkEnd = detail::skipLine(
+          std::max(chunkBegin, begin + (i + 1) * (numBytes / numChunks)), end);
+    chunks[i] = {chunkBegin, chunkEnd, 0, 0};
+    chunkBegin = chunkEnd;
+  }
+
+  // Count the elements of each chunk in parallel, and assign to each chunk
+  // the positions of its elements.
+  detail::parallelInvoke(numChunks, [&](uint64_t i) {
+    chunks[i].numElements = countNonBlankLines(chunks[i].begin, chunks[i].end);
+  });
+  const uint64_t nse = getNSE();
+  uint64_t firstElement = 0;
+  for (ElementChunk &chunk : chunks) {
+    chunk.firstElement = firstElement;
+    chunk.numElements = std::min(chunk.numElements, nse - firstElement);
+    firstElement += chunk.numElements;
+  }
+  if (firstElement != nse)
+    MLIR_SPARSETENSOR_FATAL("Cannot read next line of %s\n", filename);
+  return chunks;
+}
+
@@ -61,15 +61,31 @@ void SparseTensorNNZ::forallCoords(uint64_t stopLvl,
   forallCoords(yield, stopLvl, 0, 0);
 }
 
-void SparseTensorNNZ::add(const std::vector<uint64_t> &lvlCoords) {
+void SparseTensorNNZ::add(LvlCounts &counts,
+                          const std::vector<uint64_t> &lvlCoords) const {
   uint64_t parentPos = 0;
   for (uint64_t l = 0, lvlrank = getLvlRank(); l < lvlrank; ++l) {
     if (isCompressedDLT(lvlTypes[l]))
-      nnz[l][parentPos]++;
+      counts[l][parentPos]++;
     parentPos = parentPos * lvlSizes[l] + lvlCoords[l];
   }
 }
 
+void SparseTensorNNZ::accumulate(const std::vector<LvlCounts> &partials) {
+  const uint64_t numThreads = partials.size();
+  for (uint64_t l = 0, lvlrank = getLvlRank(); l < lvlrank; ++l) {
+    std::vector<uint64_t> &counts = nnz[l];
+    const uint64_t size = counts.size();
+    detail::parallelInvoke(numThreads, [&](uint64_t t) {
+      for (uint64_t i = t * size / numThreads,
+                    e = (t + 1) * size / numThreads;
+           i < e; ++i)
+        for (const LvlCounts &partial : partials)
+          counts[i] += partial[l][i];
+    });
+  }
+}
+
 void SparseTensorNNZ::forallCoords(SparseTensorNNZ::NNZConsumer yield,
                                    uint64_t stopLvl, uint64_t parentPos,
                                    uint64_t l) const {
@@ -57,8 +57,12 @@
 #include "mlir/ExecutionEngine/SparseTensor/PermutationRef.h"
 #include "mlir/ExecutionEngine/SparseTensor/Storage.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <mutex>
 #include <numeric>
+#include <unordered_map>
 
 using namespace mlir::sparse_tensor;
 
@@ -91,7 +95,7 @@ public:
   /// callers must not free the underlying COO object, since the iterator's
   /// dtor will do so.
   explicit SparseTensorIterator(const SparseTensorCOO<V> *coo)
-      : coo(coo), it(coo->begin()), end(coo->end()) {}
+      : coo(coo), current(nullptr, V()) {}
 
   ~SparseTensorIterator() { delete coo; }
 
@@ -101,12 +105,17 @@ public:
 
   /// Gets the next element.  If there are no remaining elements, then
   /// returns nullptr.
-  const Element<V> *getNext() { return it < end ? &*it++ : nullptr; }
+  const Element<V> *getNext() {
+    if (pos == coo->getNSE())
+      return nullptr;
+    current = coo->getElement(pos++);
+    return &current;
+  }
 
 private:
   const SparseTensorCOO<V> *const coo; // Owning pointer.
-  typename SparseTensorCOO<V>::const_iterator it;
-  const typename SparseTensorCOO<V>::const_iterator end;
+  uint64_t pos = 0;
+  Element<V> current;
 };
 
 // TODO: When using this library from MLIR, the `toMLIRSparseTensor`/
@@ -187,8 +196,7 @@ fromMLIRSparseTensor(const SparseTensorStorage<uint64_t, uint64_t, V> *tensor,
   SparseTensorCOO<V> *coo =
       tensor->toCOO(dimRank, dimSizes.data(), dimRank, identityPerm.data());
 
-  const std::vector<Element<V>> &elements = coo->getElements();
-  const uint64_t nse = elements.size();
+  const uint64_t nse = coo->getNSE();
 
   const auto &cooSizes = coo->getDimSizes();
   assert(cooSizes.size() == dimRank && "Rank mismatch");
@@ -199,13 +207,9 @@ fromMLIRSparseTensor(const SparseTensorStorage<uint64_t, uint64_t, V> *tensor,
 
   V *values = new V[nse];
   uint64_t *coordinates = new uint64_t[dimRank * nse];
-
-  for (uint64_t i = 0, base = 0; i < nse; ++i) {
-    values[i] = elements[i].value;
-    for (uint64_t d = 0; d < dimRank; ++d)
-      coordinates[base + d] = elements[i].coords[d];
-    base += dimRank;
-  }
+  std::copy(coo->getValues().begin(), coo->getValues().end(), values);
+  std::copy(coo->getCoordinates().begin(), coo->getCoordinates().end(),
+            coordinates);
 
   delete coo;
   *pRank = dimRank;
@@ -215,6 +219,123 @@ fromMLIRSparseTensor(const SparseTensorStorage<uint64_t, uint64_t, V> *tensor,
   *pCoordinates = coordinates;
 }
 
+/// A pool of released sparse tensors which were allocated empty by
+/// `Action::kEmpty`, so that kernels with sparse outputs which are invoked
+/// over and over again can reuse the storage capacity of their previous
+/// outputs rather than allocating and regrowing it from scratch.  Only
+/// tensors allocated while the pool is enabled are returned to it, and
+/// they are handed out again only for the exact same encoding and sizes.
+/// The pool is disabled until it is given a capacity, and its methods are
+/// safe to call from multiple threads.
+class SparseTensorPool final {
+public:
+  /// The types of a pooled tensor, which are not recoverable from its
+  /// type-erased `SparseTensorStorageBase`.
+  struct Types final {
+    OverheadType posTp;
+    OverheadType crdTp;
+    PrimaryType valTp;
+    bool operator==(const Types &other) const {
+      return posTp == other.posTp && crdTp == other.crdTp &&
+             valTp == other.valTp;
+    }
+  };
+
+  /// Sets the number of released tensors to hold on to, freeing the
+  /// surplus ones.  A capacity of zero disables the pool.
+  void setCapacity(uint64_t n) {
+    std::lock_guard<std::mutex> guard(mutex);
+    capacity = n;
+    while (released.size() > n) {
+      SparseTensorStorageBase *tensor = released.back().second;
+      released.pop_back();
+      tracked.erase(tensor);
+      delete tensor;
+    }
+    if (n == 0)
+      tracked.clear();
+    else
+      released.reserve(n);
+  }
+
+  /// Returns a released tensor with the given types and encoding, cleared
+  /// to the empty state, or nullptr when there is none.
+  SparseTensorStorageBase *acquire(Types tps, uint64_t dimRank,
+                                   const uint64_t *dimSizes, uint64_t lvlRank,
+                                   const uint64_t *lvlSizes,
+                                   const DimLevelType *lvlTypes,
+                                   const uint64_t *lvl2dim) {
+    if (capacity == 0)
+      return nullptr;
+    std::lock_guard<std::mutex> guard(mutex);
+    for (auto it = released.begin(); it != released.end(); ++it) {
+      const SparseTensorStorageBase &tensor = *it->second;
+      if (it->first == tps && tensor.getDimRank() == dimRank &&
+          tensor.getLvlRank() == lvlRank &&
+          std::equal(dimSizes, dimSizes + dimRank,
+                     tensor.getDimSizes().begin()) &&
+          std::equal(lvlSizes, lvlSizes + lvlRank,
+                     tensor.getLvlSizes().begin()) &&
+          std::equal(lvlTypes, lvlTypes + lvlRank,
+                     tensor.getLvlTypes().begin()) &&
+          std::equal(lvl2dim, lvl2dim + lvlRank,
+                     tensor.getLvl2Dim().begin())) {
+        SparseTensorStorageBase *found = it->second;
+        *it = released.back();
+        released.pop_back();
+        return found;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Registers a newly allocated empty tensor with the pool (when it is
+  /// enabled), so that releasing the tensor returns it to the pool.
+  SparseTensorStorageBase *track(SparseTensorStorageBase *tensor, Types tps) {
+    if (capacity == 0)
+      return tensor;
+    std::lock_guard<std::mutex> guard(mutex);
+    tracked.emplace(tensor, tps);
+    return tensor;
+  }
+
+  /// Returns the tensor to the pool, clearing its contents but keeping
+  /// its capacity.  Returns false when the tensor is not tracked or the
+  /// pool is full, in which case the caller must delete it instead.
+  bool release(SparseTensorStorageBase *tensor) {
+    if (capacity == 0)
+      return false;
+    std::lock_guard<std::mutex> guard(mutex);
+    const auto it = tracked.find(tensor);
+    if (it == tracked.end())
+      return false;
+    if (released.size() >= capacity) {
+      tracked.erase(it);
+      return false;
+    }
+    tensor->clear();
+    released.emplace_back(it->second, tensor);
+    return true;
+  }
+
+private:
+  std::mutex mutex;
+  // Read without the lock, so that a disabled pool costs nothing.
+  std::atomic<uint64_t> capacity{0};
+  // The tensors allocated under the pool which are live or released.
+  // Their entries stay put across reuse, so that steady-state reuse
+  // does not allocate.
+  std::unordered_map<SparseTensorStorageBase *, Types> tracked;
+  // The released tensors which are ready for reuse.
+  std::vector<std::pair<Types, SparseTensorStorageBase *>> released;
+};
+
+/// Gets the process-wide pool of released sparse tensors.
+static SparseTensorPool &getSparseTensorPool() {
+  static SparseTensorPool pool;
+  return pool;
+}
+
 //===----------------------------------------------------------------------===//
 //
 // Utilities for manipulating `StridedMemRefType`.
@@ -284,9 +405,17 @@ extern "C" {
 #define CASE(p, c, v, P, C, V)                                                 \
   if (posTp == (p) && crdTp == (c) && valTp == (v)) {                          \
     switch (action) {                                                          \
-    case Action::kEmpty:                                                       \
-      return SparseTensorStorage<P, C, V>::newEmpty(                           \
-          dimRank, dimSizes, lvlRank, lvlSizes, lvlTypes, lvl2dim);            \
+    case Action::kEmpty: {                                                     \
+      SparseTensorPool &pool = getSparseTensorPool();                          \
+      const SparseTensorPool::Types tps{posTp, crdTp, valTp};                  \
+      if (auto *tensor = pool.acquire(tps, dimRank, dimSizes, lvlRank,         \
+                                      lvlSizes, lvlTypes, lvl2dim))            \
+        return tensor;                                                         \
+      return pool.track(SparseTensorStorage<P, C, V>::newEmpty(                \
+                            dimRank, dimSizes, lvlRank, lvlSizes, lvlTypes,    \
+                            lvl2dim),                                          \
+                        tps);                                                  \
+    }                                                                          \
     case Action::kFromCOO: {                                                   \
       assert(ptr && "Received nullptr for SparseTensorCOO object");            \
       auto &coo = *static_cast<SparseTensorCOO<V> *>(ptr);                     \
@@ -313,6 +442,12 @@ extern "C" {
       auto *coo = tensor.toCOO(lvlRank, lvlSizes, dimRank, dim2lvl);           \
       return new SparseTensorIterator<V>(coo);                                 \
     }                                                                          \
+    case Action::kPack: {                                                      \
+      assert(ptr && "Received nullptr for the level buffers");                 \
+      return SparseTensorStorage<P, C, V>::packFromLvlBuffers(                 \
+          dimRank, dimSizes, lvlRank, lvlSizes, lvlTypes, lvl2dim,             \
+          static_cast<const void *const *>(ptr));                              \
+    }                                                                          \
     }                                                                          \
     MLIR_SPARSETENSOR_FATAL("unknown action: %d\n",                            \
                             static_cast<uint32_t>(action));                    \
@@ -665,6 +800,70 @@ MLIR_SPARSETENSOR_FOREVERY_V(IMPL_GETNEXT)
 MLIR_SPARSETENSOR_FOREVERY_V_O(IMPL_GETNEXT)
 #undef IMPL_GETNEXT
 
+// The combinations of overhead and value types that are supported when
+// materializing a `SparseTensorStorage<P,C,V>` from opaque arguments, as
+// `DO(p, c, v, P, C, V)`: all of the combinations of overhead storage for
+// double and float values, and both overheads of the same type otherwise.
+#define MLIR_SPARSETENSOR_FOREVERY_STORAGE(DO)                                 \
+  DO(kU64, kU64, kF64, uint64_t, uint64_t, double)                             \
+  DO(kU64, kU32, kF64, uint64_t, uint32_t, double)                             \
+  DO(kU64, kU16, kF64, uint64_t, uint16_t, double)                             \
+  DO(kU64, kU8, kF64, uint64_t, uint8_t, double)                               \
+  DO(kU32, kU64, kF64, uint32_t, uint64_t, double)                             \
+  DO(kU32, kU32, kF64, uint32_t, uint32_t, double)                             \
+  DO(kU32, kU16, kF64, uint32_t, uint16_t, double)                             \
+  DO(kU32, kU8, kF64, uint32_t, uint8_t, double)                               \
+  DO(kU16, kU64, kF64, uint16_t, uint64_t, double)                             \
+  DO(kU16, kU32, kF64, uint16_t, uint32_t, double)                             \
+  DO(kU16, kU16, kF64, uint16_t, uint16_t, double)                             \
+  DO(kU16, kU8, kF64, uint16_t, uint8_t, double)                               \
+  DO(kU8, kU64, kF64, uint8_t, uint64_t, double)                               \
+  DO(kU8, kU32, kF64, uint8_t, uint32_t, double)                               \
+  DO(kU8, kU16, kF64, uint8_t, uint16_t, double)                               \
+  DO(kU8, kU8, kF64, uint8_t, uint8_t, double)                                 \
+  DO(kU64, kU64, kF32, uint64_t, uint64_t, float)                              \
+  DO(kU64, kU32, kF32, uint64_t, uint32_t, float)                              \
+  DO(kU64, kU16, kF32, uint64_t, uint16_t, float)                              \
+  DO(kU64, kU8, kF32, uint64_t, uint8_t, float)                                \
+  DO(kU32, kU64, kF32, uint32_t, uint64_t, float)                              \
+  DO(kU32, kU32, kF32, uint32_t, uint32_t, float)                              \
+  DO(kU32, kU16, kF32, uint32_t, uint16_t, float)                              \
+  DO(kU32, kU8, kF32, uint32_t, uint8_t, float)                                \
+  DO(kU16, kU64, kF32, uint16_t, uint64_t, float)                              \
+  DO(kU16, kU32, kF32, uint16_t, uint32_t, float)                              \
+  DO(kU16, kU16, kF32, uint16_t, uint16_t, float)                              \
+  DO(kU16, kU8, kF32, uint16_t, uint8_t, float)                                \
+  DO(kU8, kU64, kF32, uint8_t, uint64_t, float)                                \
+  DO(kU8, kU32, kF32, uint8_t, uint32_t, float)                                \
+  DO(kU8, kU16, kF32, uint8_t, uint16_t, float)                                \
+  DO(kU8, kU8, kF32, uint8_t, uint8_t, float)                                  \
+  DO(kU64, kU64, kF16, uint64_t, uint64_t, f16)                                \
+  DO(kU64, kU64, kBF16, uint64_t, uint64_t, bf16)                              \
+  DO(kU32, kU32, kF16, uint32_t, uint32_t, f16)                                \
+  DO(kU32, kU32, kBF16, uint32_t, uint32_t, bf16)                              \
+  DO(kU16, kU16, kF16, uint16_t, uint16_t, f16)                                \
+  DO(kU16, kU16, kBF16, uint16_t, uint16_t, bf16)                              \
+  DO(kU8, kU8, kF16, uint8_t, uint8_t, f16)                                    \
+  DO(kU8, kU8, kBF16, uint8_t, uint8_t, bf16)                                  \
+  DO(kU64, kU64, kI64, uint64_t, uint64_t, int64_t)                            \
+  DO(kU64, kU64, kI32, uint64_t, uint64_t, int32_t)                            \
+  DO(kU64, kU64, kI16, uint64_t, uint64_t, int16_t)                            \
+  DO(kU64, kU64, kI8, uint64_t, uint64_t, int8_t)                              \
+  DO(kU32, kU32, kI64, uint32_t, uint32_t, int64_t)                            \
+  DO(kU32, kU32, kI32, uint32_t, uint32_t, int32_t)                            \
+  DO(kU32, kU32, kI16, uint32_t, uint32_t, int16_t)                            \
+  DO(kU32, kU32, kI8, uint32_t, uint32_t, int8_t)                              \
+  DO(kU16, kU16, kI64, uint16_t, uint16_t, int64_t)                            \
+  DO(kU16, kU16, kI32, uint16_t, uint16_t, int32_t)                            \
+  DO(kU16, kU16, kI16, uint16_t, uint16_t, int16_t)                            \
+  DO(kU16, kU16, kI8, uint16_t, uint16_t, int8_t)                              \
+  DO(kU8, kU8, kI64, uint8_t, uint8_t, int64_t)                                \
+  DO(kU8, kU8, kI32, uint8_t, uint8_t, int32_t)                                \
+  DO(kU8, kU8, kI16, uint8_t, uint8_t, int16_t)                                \
+  DO(kU8, kU8, kI8, uint8_t, uint8_t, int8_t)                                  \
+  DO(kU64, kU64, kC64, uint64_t, uint64_t, complex64)                          \
+  DO(kU64, kU64, kC32, uint64_t, uint64_t, complex32)
+
 void *_mlir_ciface_newSparseTensorFromReader(
     void *p, StridedMemRefType<index_type, 1> *lvlSizesRef,
     StridedMemRefType<DimLevelType, 1> *lvlTypesRef,
@@ -685,86 +884,22 @@ void *_mlir_ciface_newSparseTensorFromReader(
   (void)dimRank;
   const index_type *lvlSizes = MEMREF_GET_PAYLOAD(lvlSizesRef);
   const DimLevelType *lvlTypes = MEMREF_GET_PAYLOAD(lvlTypesRef);
+  // The `dim2lvl` mapping is implied by the `lvl2dim` one, which also
+  // describes blocked formats; so the former is only checked for its size.
   const index_type *lvl2dim = MEMREF_GET_PAYLOAD(lvl2dimRef);
-  const index_type *dim2lvl = MEMREF_GET_PAYLOAD(dim2lvlRef);
-  //
-  // FIXME(wrengr): Really need to define a separate x-macro for handling
-  // all this. (Or ideally some better, entirely-different approach)
-#define CASE(p, c, v, P, C, V)                                                 \
-  if (posTp == OverheadType::p && crdTp == OverheadType::c &&                  \
-      valTp == PrimaryType::v)                                                 \
-    return static_cast<void *>(reader.readSparseTensor<P, C, V>(               \
-        lvlRank, lvlSizes, lvlTypes, lvl2dim, dim2lvl));
-#define CASE_SECSAME(p, v, P, V) CASE(p, p, v, P, P, V)
   // Rewrite kIndex to kU64, to avoid introducing a bunch of new cases.
   // This is safe because of the static_assert above.
   if (posTp == OverheadType::kIndex)
     posTp = OverheadType::kU64;
   if (crdTp == OverheadType::kIndex)
     crdTp = OverheadType::kU64;
-  // Double matrices with all combinations of overhead storage.
-  CASE(kU64, kU64, kF64, uint64_t, uint64_t, double);
-  CASE(kU64, kU32, kF64, uint64_t, uint32_t, double);
-  CASE(kU64, kU16, kF64, uint64_t, uint16_t, double);
-  CASE(kU64, kU8, kF64, uint64_t, uint8_t, double);
-  CASE(kU32, kU64, kF64, uint32_t, uint64_t, double);
-  CASE(kU32, kU32, kF64, uint32_t, uint32_t, double);
-  CASE(kU32, kU16, kF64, uint32_t, uint16_t, double);
-  CASE(kU32, kU8, kF64, uint32_t, uint8_t, double);
-  CASE(kU16, kU64, kF64, uint16_t, uint64_t, double);
-  CASE(kU16, kU32, kF64, uint16_t, uint32_t, double);
-  CASE(kU16, kU16, kF64, uint16_t, uint16_t, double);
-  CASE(kU16, kU8, kF64, uint16_t, uint8_t, double);
-  CASE(kU8, kU64, kF64, uint8_t, uint64_t, double);
-  CASE(kU8, kU32, kF64, uint8_t, uint32_t, double);
-  CASE(kU8, kU16, kF64, uint8_t, uint16_t, double);
-  CASE(kU8, kU8, kF64, uint8_t, uint8_t, double);
-  // Float matrices with all combinations of overhead storage.
-  CASE(kU64, kU64, kF32, uint64_t, uint64_t, float);
-  CASE(kU64, kU32, kF32, uint64_t, uint32_t, float);
-  CASE(kU64, kU16, kF32, uint64_t, uint16_t, float);
-  CASE(kU64, kU8, kF32, uint64_t, uint8_t, float);
-  CASE(kU32, kU64, kF32, uint32_t, uint64_t, float);
-  CASE(kU32, kU32, kF32, uint32_t, uint32_t, float);
-  CASE(kU32, kU16, kF32, uint32_t, uint16_t, float);
-  CASE(kU32, kU8, kF32, uint32_t, uint8_t, float);
-  CASE(kU16, kU64, kF32, uint16_t, uint64_t, float);
-  CASE(kU16, kU32, kF32, uint16_t, uint32_t, float);
-  CASE(kU16, kU16, kF32, uint16_t, uint16_t, float);
-  CASE(kU16, kU8, kF32, uint16_t, uint8_t, float);
-  CASE(kU8, kU64, kF32, uint8_t, uint64_t, float);
-  CASE(kU8, kU32, kF32, uint8_t, uint32_t, float);
-  CASE(kU8, kU16, kF32, uint8_t, uint16_t, float);
-  CASE(kU8, kU8, kF32, uint8_t, uint8_t, float);
-  // Two-byte floats with both overheads of the same type.
-  CASE_SECSAME(kU64, kF16, uint64_t, f16);
-  CASE_SECSAME(kU64, kBF16, uint64_t, bf16);
-  CASE_SECSAME(kU32, kF16, uint32_t, f16);
-  CASE_SECSAME(kU32, kBF16, uint32_t, bf16);
-  CASE_SECSAME(kU16, kF16, uint16_t, f16);
-  CASE_SECSAME(kU16, kBF16, uint16_t, bf16);
-  CASE_SECSAME(kU8, kF16, uint8_t, f16);
-  CASE_SECSAME(kU8, kBF16, uint8_t, bf16);
-  // Integral matrices with both overheads of the same type.
-  CASE_SECSAME(kU64, kI64, uint64_t, int64_t);
-  CASE_SECSAME(kU64, kI32, uint64_t, int32_t);
-  CASE_SECSAME(kU64, kI16, uint64_t, int16_t);
-  CASE_SECSAME(kU64, kI8, uint64_t, int8_t);
-  CASE_SECSAME(kU32, kI64, uint32_t, int64_t);
-  CASE_SECSAME(kU32, kI32, uint32_t, int32_t);
-  CASE_SECSAME(kU32, kI16, uint32_t, int16_t);
-  CASE_SECSAME(kU32, kI8, uint32_t, int8_t);
-  CASE_SECSAME(kU16, kI64, uint16_t, int64_t);
-  CASE_SECSAME(kU16, kI32, uint16_t, int32_t);
-  CASE_SECSAME(kU16, kI16, uint16_t, int16_t);
-  CASE_SECSAME(kU16, kI8, uint16_t, int8_t);
-  CASE_SECSAME(kU8, kI64, uint8_t, int64_t);
-  CASE_SECSAME(kU8, kI32, uint8_t, int32_t);
-  CASE_SECSAME(kU8, kI16, uint8_t, int16_t);
-  CASE_SECSAME(kU8, kI8, uint8_t, int8_t);
-  // Complex matrices with wide overhead.
-  CASE_SECSAME(kU64, kC64, uint64_t, complex64);
-  CASE_SECSAME(kU64, kC32, uint64_t, complex32);
+#define CASE(p, c, v, P, C, V)                                                 \
+  if (posTp == OverheadType::p && crdTp == OverheadType::c &&                  \
+      valTp == PrimaryType::v)                                                 \
+    return static_cast<void *>(reader.readSparseTensor<P, C, V>(               \
+        lvlRank, lvlSizes, lvlTypes, lvl2dim));
+  MLIR_SPARSETENSOR_FOREVERY_STORAGE(CASE)
+#undef CASE
 
   // Unsupported case (add above if needed).
   // TODO: better pretty-printing of enum values!
@@ -772,8 +907,30 @@ void *_mlir_ciface_newSparseTensorFromReader(
       "unsupported combination of types: <P=%d, C=%d, V=%d>\n",
       static_cast<int>(posTp), static_cast<int>(crdTp),
       static_cast<int>(valTp));
-#undef CASE_SECSAME
+}
+
+void *_mlir_ciface_newSparseTensorFromBinaryFile(
+    char *filename, StridedMemRefType<index_type, 1> *dimShapeRef,
+    OverheadType posTp, OverheadType crdTp, PrimaryType valTp) {
+  assert(filename && "Got nullptr for filename");
+  ASSERT_NO_STRIDE(dimShapeRef);
+  const uint64_t dimRank = MEMREF_GET_USIZE(dimShapeRef);
+  const index_type *dimShape = MEMREF_GET_PAYLOAD(dimShapeRef);
+  if (posTp == OverheadType::kIndex)
+    posTp = OverheadType::kU64;
+  if (crdTp == OverheadType::kIndex)
+    crdTp = OverheadType::kU64;
+#define CASE(p, c, v, P, C, V)                                                 \
+  if (posTp == OverheadType::p && crdTp == OverheadType::c &&                  \
+      valTp == PrimaryType::v)                                                 \
+    return static_cast<void *>(                                                \
+        readBinary<P, C, V>(filename, valTp, dimRank, dimShape));
+  MLIR_SPARSETENSOR_FOREVERY_STORAGE(CASE)
 #undef CASE
+  MLIR_SPARSETENSOR_FATAL(
+      "unsupported combination of types: <P=%d, C=%d, V=%d>\n",
+      static_cast<int>(posTp), static_cast<int>(crdTp),
+      static_cast<int>(valTp));
 }
 
 void _mlir_ciface_outSparseTensorWriterMetaData(
@@ -783,11 +940,7 @@ void _mlir_ciface_outSparseTensorWriterMetaData(
   ASSERT_NO_STRIDE(dimSizesRef);
   assert(dimRank != 0);
   index_type *dimSizes = MEMREF_GET_PAYLOAD(dimSizesRef);
-  SparseTensorWriter &file = *static_cast<SparseTensorWriter *>(p);
-  file << dimRank << " " << nse << std::endl;
-  for (index_type d = 0; d < dimRank - 1; ++d)
-    file << dimSizes[d] << " ";
-  file << dimSizes[dimRank - 1] << std::endl;
+  static_cast<SparseTensorWriter *>(p)->writeMetaData(dimRank, nse, dimSizes);
 }
 
 #define IMPL_OUTNEXT(VNAME, V)                                                 \
@@ -798,11 +951,9 @@ void _mlir_ciface_outSparseTensorWriterMetaData(
     assert(p &&vref);                                                          \
     ASSERT_NO_STRIDE(dimCoordsRef);                                            \
     const index_type *dimCoords = MEMREF_GET_PAYLOAD(dimCoordsRef);            \
-    SparseTensorWriter &file = *static_cast<SparseTensorWriter *>(p);          \
-    for (index_type d = 0; d < dimRank; ++d)                                   \
-      file << (dimCoords[d] + 1) << " ";                                       \
     V *value = MEMREF_GET_PAYLOAD(vref);                                       \
-    file << *value << std::endl;                                               \
+    static_cast<SparseTensorWriter *>(p)->writeElement(                        \
+        PrimaryType::k##VNAME, dimRank, dimCoords, *value);                    \
   }
 MLIR_SPARSETENSOR_FOREVERY_V(IMPL_OUTNEXT)
 #undef IMPL_OUTNEXT
@@ -838,7 +989,39 @@ MLIR_SPARSETENSOR_FOREVERY_V(IMPL_OUTSPARSETENSOR)
 #undef IMPL_OUTSPARSETENSOR
 
 void delSparseTensor(void *tensor) {
-  delete static_cast<SparseTensorStorageBase *>(tensor);
+  auto *stsb = static_cast<SparseTensorStorageBase *>(tensor);
+  if (!getSparseTensorPool().release(stsb))
+    delete stsb;
+}
+
+void reserveSparseTensor(void *tensor, index_type nse) {
+  assert(tensor && "Got nullptr for tensor");
+  static_cast<SparseTensorStorageBase *>(tensor)->reserve(nse);
+}
+
+void setSparseTensorPoolCapacity(index_type capacity) {
+  getSparseTensorPool().setCapacity(capacity);
+}
+
+void outSparseTensorBinary(void *tensor, char *filename, OverheadType posTp,
+                           OverheadType crdTp, PrimaryType valTp) {
+  assert(tensor && "Got nullptr for tensor");
+  assert(filename && "Got nullptr for filename");
+  if (posTp == OverheadType::kIndex)
+    posTp = OverheadType::kU64;
+  if (crdTp == OverheadType::kIndex)
+    crdTp = OverheadType::kU64;
+#define CASE(p, c, v, P, C, V)                                                 \
+  if (posTp == OverheadType::p && crdTp == OverheadType::c &&                  \
+      valTp == PrimaryType::v)                                                 \
+    return writeBinary(*static_cast<SparseTensorStorage<P, C, V> *>(tensor),   \
+                       valTp, filename);
+  MLIR_SPARSETENSOR_FOREVERY_STORAGE(CASE)
+#undef CASE
+  MLIR_SPARSETENSOR_FATAL(
+      "unsupported combination of types: <P=%d, C=%d, V=%d>\n",
+      static_cast<int>(posTp), static_cast<int>(crdTp),
+      static_cast<int>(valTp));
 }
 
 #define IMPL_DELCOO(VNAME, V)                                                  \
@@ -930,22 +1113,20 @@ void delSparseTensorReader(void *p) {
 }
 
 void *createSparseTensorWriter(char *filename) {
-  SparseTensorWriter *file =
-      (filename[0] == 0) ? &std::cout : new std::ofstream(filename);
-  *file << "# extended FROSTT format\n";
-  return static_cast<void *>(file);
+  return new SparseTensorWriter(filename);
+}
+
+void *createSparseTensorBinaryWriter(char *filename, PrimaryType valTp) {
+  return new SparseTensorWriter(filename, valTp);
 }
 
 void delSparseTensorWriter(void *p) {
-  SparseTensorWriter *file = static_cast<SparseTensorWriter *>(p);
-  file->flush();
-  assert(file->good());
-  if (file != &std::cout)
-    delete file;
+  delete static_cast<SparseTensorWriter *>(p);
 }
 
 } // extern "C"
 
+#undef MLIR_SPARSETENSOR_FOREVERY_STORAGE
 #undef MEMREF_GET_PAYLOAD
 #undef ASSERT_USIZE_EQ
 #undef MEMREF_GET_USIZE
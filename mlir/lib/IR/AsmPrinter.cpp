@@ -25,6 +25,7 @@
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/IR/OpImplementation.h"
 #include "mlir/IR/Operation.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/IR/Verifier.h"
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/DenseMap.h"
@@ -44,6 +45,7 @@
 #include "llvm/Support/SaveAndRestore.h"
 #include "llvm/Support/Threading.h"
 
+#include <mutex>
 #include <optional>
 #include <tuple>
 
@@ -168,6 +170,11 @@ struct AsmPrinterOptions {
       "mlir-print-value-users", llvm::cl::init(false),
       llvm::cl::desc(
           "Print users of operation results and block arguments as a comment")};
+
+  llvm::cl::opt<bool> printInParallelOpt{
+      "mlir-print-in-parallel", llvm::cl::init(false),
+      llvm::cl::desc("Print the isolated operations nested in the top level "
+                     "operation in parallel")};
 };
 } // namespace
 
@@ -182,21 +189,25 @@ void mlir::registerAsmPrinterCLOptions() {
 
 /// Initialize the printing flags with default supplied by the cl::opts above.
 OpPrintingFlags::OpPrintingFlags()
-    : printDebugInfoFlag(false), printDebugInfoPrettyFormFlag(false),
-      printGenericOpFormFlag(false), skipRegionsFlag(false),
-      assumeVerifiedFlag(false), printLocalScope(false),
-      printValueUsersFlag(false) {
+    : elementsAttrHexElementLimit(100), printDebugInfoFlag(false),
+      printDebugInfoPrettyFormFlag(false), printGenericOpFormFlag(false),
+      skipRegionsFlag(false), assumeVerifiedFlag(false),
+      printLocalScope(false), printValueUsersFlag(false),
+      printInParallelFlag(false) {
   // Initialize based upon command line options, if they are available.
   if (!clOptions.isConstructed())
     return;
   if (clOptions->elideElementsAttrIfLarger.getNumOccurrences())
     elementsAttrElementLimit = clOptions->elideElementsAttrIfLarger;
+  if (clOptions->printElementsAttrWithHexIfLarger.getNumOccurrences())
+    elementsAttrHexElementLimit = clOptions->printElementsAttrWithHexIfLarger;
   printDebugInfoFlag = clOptions->printDebugInfoOpt;
   printDebugInfoPrettyFormFlag = clOptions->printPrettyDebugInfoOpt;
   printGenericOpFormFlag = clOptions->printGenericOpFormOpt;
   assumeVerifiedFlag = clOptions->assumeVerifiedOpt;
   printLocalScope = clOptions->printLocalScopeOpt;
   printValueUsersFlag = clOptions->printValueUsers;
+  printInParallelFlag = clOptions->printInParallelOpt;
 }
 
 /// Enable the elision of large elements attributes, by printing a '...'
@@ -209,6 +220,14 @@ OpPrintingFlags::elideLargeElementsAttrs(int64_t largeElementLimit) {
   return *this;
 }
 
+/// Print the non-splat DenseElementsAttrs as a hex string when the number of
+/// elements is greater than `largeElementLimit`, or never if it is -1.
+OpPrintingFlags &
+OpPrintingFlags::printElementsAttrWithHexIfLarger(int64_t largeElementLimit) {
+  elementsAttrHexElementLimit = largeElementLimit;
+  return *this;
+}
+
 /// Enable printing of debug information. If 'prettyForm' is set to true,
 /// debug information is printed in a more readable 'pretty' form.
 OpPrintingFlags &OpPrintingFlags::enableDebugInfo(bool enable,
@@ -250,6 +269,13 @@ OpPrintingFlags &OpPrintingFlags::printValueUsers() {
   return *this;
 }
 
+/// Print the isolated operations nested in the top level operation in
+/// parallel.
+OpPrintingFlags &OpPrintingFlags::printInParallel(bool enable) {
+  printInParallelFlag = enable;
+  return *this;
+}
+
 /// Return if the given ElementsAttr should be elided.
 bool OpPrintingFlags::shouldElideElementsAttr(ElementsAttr attr) const {
   return elementsAttrElementLimit &&
@@ -262,6 +288,18 @@ std::optional<int64_t> OpPrintingFlags::getLargeElementsAttrLimit() const {
   return elementsAttrElementLimit;
 }
 
+/// Return if the given ElementsAttr should be printed as a hex string.
+bool OpPrintingFlags::shouldPrintElementsAttrWithHex(ElementsAttr attr) const {
+  return elementsAttrHexElementLimit != -1 &&
+         elementsAttrHexElementLimit < int64_t(attr.getNumElements()) &&
+         !llvm::isa<SplatElementsAttr>(attr);
+}
+
+/// Return the size limit for printing ElementsAttr as a hex string.
+int64_t OpPrintingFlags::getElementsAttrHexLimit() const {
+  return elementsAttrHexElementLimit;
+}
+
 /// Return if debug information should be printed.
 bool OpPrintingFlags::shouldPrintDebugInfo() const {
   return printDebugInfoFlag;
@@ -293,21 +331,9 @@ bool OpPrintingFlags::shouldPrintValueUsers() const {
   return printValueUsersFlag;
 }
 
-/// Returns true if an ElementsAttr with the given number of elements should be
-/// printed with hex.
-static bool shouldPrintElementsAttrWithHex(int64_t numElements) {
-  // Check to see if a command line option was provided for the limit.
-  if (clOptions.isConstructed()) {
-    if (clOptions->printElementsAttrWithHexIfLarger.getNumOccurrences()) {
-      // -1 is used to disable hex printing.
-      if (clOptions->printElementsAttrWithHexIfLarger == -1)
-        return false;
-      return numElements > clOptions->printElementsAttrWithHexIfLarger;
-    }
-  }
-
-  // Otherwise, default to printing with hex if the number of elements is >100.
-  return numElements > 100;
+/// Return if the printer should print isolated operations in parallel.
+bool OpPrintingFlags::shouldPrintInParallel() const {
+  return printInParallelFlag;
 }
 
 //===----------------------------------------------------------------------===//
@@ -449,9 +475,38 @@ protected:
 
   /// A tracker for the number of new lines emitted during printing.
   NewLineCounter newLine;
+
+  /// If set, the dialect resources referenced during printing are recorded in
+  /// this list instead of the printer state, e.g. when printing on a separate
+  /// thread.
+  std::vector<AsmDialectResourceHandle> *referencedResources = nullptr;
 };
 } // namespace mlir
 
+//===----------------------------------------------------------------------===//
+// Parallel Printing
+//===----------------------------------------------------------------------===//
+
+/// Returns the operations that are processed in parallel when printing `op`:
+/// the isolated operations with regions that are nested in the regions of
+/// `op`, if printing in parallel is enabled and there are several of them.
+static SmallVector<Operation *>
+getParallelPrintingPartitions(Operation *op, const OpPrintingFlags &flags) {
+  SmallVector<Operation *> partitions;
+  if (!flags.shouldPrintInParallel() || flags.shouldSkipRegions() ||
+      !op->getContext()->isMultithreadingEnabled())
+    return partitions;
+  for (Region &region : op->getRegions())
+    for (Block &block : region)
+      for (Operation &nestedOp : block)
+        if (nestedOp.getNumRegions() != 0 &&
+            nestedOp.hasTrait<OpTrait::IsIsolatedFromAbove>())
+          partitions.push_back(&nestedOp);
+  if (partitions.size() < 2)
+    partitions.clear();
+  return partitions;
+}
+
 //===----------------------------------------------------------------------===//
 // AliasInitializer
 //===----------------------------------------------------------------------===//
@@ -522,6 +577,10 @@ public:
     return visitImpl(type, aliases, canBeDeferred);
   }
 
+  /// Merge the aliases visited by `other` into this initializer, as if they
+  /// were visited by this initializer at this point.
+  void mergeAliases(AliasInitializer &other);
+
 private:
   struct InProgressAliasInfo {
     InProgressAliasInfo()
@@ -599,9 +658,12 @@ private:
 /// in the output, and trims down unnecessary output.
 class DummyAliasOperationPrinter : private OpAsmPrinter {
 public:
-  explicit DummyAliasOperationPrinter(const OpPrintingFlags &printerFlags,
-                                      AliasInitializer &initializer)
-      : printerFlags(printerFlags), initializer(initializer) {}
+  explicit DummyAliasOperationPrinter(
+      const OpPrintingFlags &printerFlags, AliasInitializer &initializer,
+      const DenseMap<Operation *, AliasInitializer *> *partitionAliases =
+          nullptr)
+      : printerFlags(printerFlags), initializer(initializer),
+        partitionAliases(partitionAliases) {}
 
   /// Prints the entire operation with the custom assembly form, if available,
   /// or the generic assembly form, otherwise.
@@ -667,8 +729,16 @@ private:
         block->begin(),
         std::prev(block->end(),
                   (!hasTerminator || printBlockTerminator) ? 0 : 1));
-    for (Operation &op : range)
+    for (Operation &op : range) {
+      // The aliases of the operations visited in parallel are merged in order.
+      if (partitionAliases) {
+        if (AliasInitializer *partition = partitionAliases->lookup(&op)) {
+          initializer.mergeAliases(*partition);
+          continue;
+        }
+      }
       printCustomOrGenericOp(&op);
+    }
   }
 
   /// Print the given region.
@@ -774,6 +844,10 @@ private:
   /// The initializer to use when identifying aliases.
   AliasInitializer &initializer;
 
+  /// The initializers of the operations whose aliases were visited in
+  /// parallel, if any.
+  const DenseMap<Operation *, AliasInitializer *> *partitionAliases;
+
   /// A dummy output stream.
   mutable llvm::raw_null_ostream os;
 };
@@ -994,16 +1068,69 @@ void AliasInitializer::initializeAliases(
 void AliasInitializer::initialize(
     Operation *op, const OpPrintingFlags &printerFlags,
     llvm::MapVector<const void *, SymbolAlias> &attrTypeToAlias) {
+  // Visit the isolated operations nested in `op` in parallel, each with a
+  // separate initializer whose aliases are merged when reaching the operation.
+  SmallVector<Operation *> partitions =
+      getParallelPrintingPartitions(op, printerFlags);
+  std::vector<llvm::BumpPtrAllocator> partitionAllocators(partitions.size());
+  std::vector<std::unique_ptr<AliasInitializer>> partitionInitializers;
+  DenseMap<Operation *, AliasInitializer *> partitionAliases;
+  for (auto [partition, allocator] :
+       llvm::zip_equal(partitions, partitionAllocators)) {
+    partitionInitializers.push_back(
+        std::make_unique<AliasInitializer>(interfaces, allocator));
+    partitionAliases[partition] = partitionInitializers.back().get();
+  }
+  parallelFor(op->getContext(), 0, partitions.size(), [&](size_t index) {
+    DummyAliasOperationPrinter(printerFlags, *partitionInitializers[index])
+        .printCustomOrGenericOp(partitions[index]);
+  });
+
   // Use a dummy printer when walking the IR so that we can collect the
   // attributes/types that will actually be used during printing when
   // considering aliases.
-  DummyAliasOperationPrinter aliasPrinter(printerFlags, *this);
+  DummyAliasOperationPrinter aliasPrinter(printerFlags, *this,
+                                          &partitionAliases);
   aliasPrinter.printCustomOrGenericOp(op);
 
   // Initialize the aliases.
   initializeAliases(aliases, attrTypeToAlias);
 }
 
+void AliasInitializer::mergeAliases(AliasInitializer &other) {
+  // Insert the aliases that were not visited yet, in the order of `other`, and
+  // map the alias indices of `other` to the indices in this initializer.
+  SmallVector<size_t> indexMap;
+  SmallVector<bool> isNewAlias;
+  indexMap.reserve(other.aliases.size());
+  isNewAlias.reserve(other.aliases.size());
+  for (auto &[symbol, aliasInfo] : other.aliases) {
+    auto [it, inserted] = aliases.insert({symbol, InProgressAliasInfo()});
+    indexMap.push_back(std::distance(aliases.begin(), it));
+    isNewAlias.push_back(inserted);
+    if (!inserted)
+      continue;
+    if (aliasInfo.alias)
+      it->second.alias = aliasInfo.alias->copy(aliasAllocator);
+    it->second.aliasDepth = aliasInfo.aliasDepth;
+    it->second.isType = aliasInfo.isType;
+    it->second.canBeDeferred = aliasInfo.canBeDeferred;
+  }
+
+  // Remap the children of the new aliases, and propagate the non-deferrable
+  // flag to the aliases that were already visited.
+  for (auto [index, entry] : llvm::enumerate(other.aliases)) {
+    InProgressAliasInfo &aliasInfo = entry.second;
+    if (isNewAlias[index]) {
+      auto it = std::next(aliases.begin(), indexMap[index]);
+      for (size_t childIndex : aliasInfo.childIndices)
+        it->second.childIndices.push_back(indexMap[childIndex]);
+    } else if (!aliasInfo.canBeDeferred) {
+      markAliasNonDeferrable(indexMap[index]);
+    }
+  }
+}
+
 template <typename T, typename... PrintArgs>
 std::pair<size_t, size_t> AliasInitializer::visitImpl(
     T value, llvm::MapVector<const void *, InProgressAliasInfo> &aliases,
@@ -1217,6 +1344,37 @@ public:
   void shadowRegionArgs(Region &region, ValueRange namesToUse);
 
 private:
+  /// The naming context includes `nextValueID`, `nextArgumentID`,
+  /// `nextConflictID` and `usedNames` scoped HashTable. This information is
+  /// carried from the parent region.
+  using UsedNamesScopeTy = llvm::ScopedHashTable<StringRef, char>::ScopeTy;
+  using NamingContext =
+      std::tuple<Region *, unsigned, unsigned, unsigned, UsedNamesScopeTy *>;
+
+  /// An isolated operation whose regions are numbered on a separate thread,
+  /// along with the naming context of its parent region.
+  struct Partition {
+    Operation *op;
+    unsigned nextValueID, nextArgumentID, nextConflictID;
+    /// The names visible from the regions of the operation.
+    SmallVector<StringRef> visibleNames;
+  };
+
+  /// Number the SSA values within the regions of `nameContext`, and within
+  /// their nested regions. The isolated operations nested in the regions of
+  /// `partitionRoot`, if provided, are added to `partitions` instead of being
+  /// numbered.
+  void numberValuesInContexts(SmallVectorImpl<NamingContext> &nameContext,
+                              llvm::BumpPtrAllocator &allocator,
+                              Operation *partitionRoot,
+                              ArrayRef<StringRef> topLevelNames,
+                              std::vector<Partition> &partitions);
+
+  /// Number the SSA values within the regions of the given partitions in
+  /// parallel, and merge the results into this state.
+  void numberPartitionsInParallel(MLIRContext *context,
+                                  std::vector<Partition> &partitions);
+
   /// Number the SSA values within the given IR unit.
   void numberValuesInRegion(Region &region);
   void numberValuesInBlock(Block &block);
@@ -1260,6 +1418,15 @@ private:
   llvm::ScopedHashTable<StringRef, char> usedNames;
   llvm::BumpPtrAllocator usedNameAllocator;
 
+  /// A mutex guarding the allocator of names while printing.
+  std::mutex usedNameMutex;
+
+  /// The allocators of the names assigned when numbering partitions.
+  std::vector<llvm::BumpPtrAllocator> partitionAllocators;
+
+  /// If set, the names made unique are also recorded in this list.
+  SmallVectorImpl<StringRef> *recordedNames = nullptr;
+
   /// This is the next value ID to assign in numbering.
   unsigned nextValueID = 0;
   /// This is the next ID to assign to a region entry block argument.
@@ -1279,13 +1446,6 @@ SSANameState::SSANameState(Operation *op, const OpPrintingFlags &printerFlags)
   llvm::SaveAndRestore argumentIDSaver(nextArgumentID);
   llvm::SaveAndRestore conflictIDSaver(nextConflictID);
 
-  // The naming context includes `nextValueID`, `nextArgumentID`,
-  // `nextConflictID` and `usedNames` scoped HashTable. This information is
-  // carried from the parent region.
-  using UsedNamesScopeTy = llvm::ScopedHashTable<StringRef, char>::ScopeTy;
-  using NamingContext =
-      std::tuple<Region *, unsigned, unsigned, unsigned, UsedNamesScopeTy *>;
-
   // Allocator for UsedNamesScopeTy
   llvm::BumpPtrAllocator allocator;
 
@@ -1298,8 +1458,32 @@ SSANameState::SSANameState(Operation *op, const OpPrintingFlags &printerFlags)
     nameContext.push_back(std::make_tuple(&region, nextValueID, nextArgumentID,
                                           nextConflictID, topLevelNamesScope));
 
+  // When numbering in parallel, record the names of the top level scope that
+  // are visible from the partitions.
+  bool inParallel = !getParallelPrintingPartitions(op, printerFlags).empty();
+  SmallVector<StringRef> topLevelNames;
+  if (inParallel)
+    recordedNames = &topLevelNames;
   numberValuesInOp(*op);
+  recordedNames = nullptr;
+
+  std::vector<Partition> partitions;
+  numberValuesInContexts(nameContext, allocator, inParallel ? op : nullptr,
+                         topLevelNames, partitions);
 
+  // Manually remove all the scopes.
+  while (usedNames.getCurScope() != nullptr)
+    usedNames.getCurScope()->~UsedNamesScopeTy();
+
+  if (!partitions.empty())
+    numberPartitionsInParallel(op->getContext(), partitions);
+}
+
+void SSANameState::numberValuesInContexts(
+    SmallVectorImpl<NamingContext> &nameContext,
+    llvm::BumpPtrAllocator &allocator, Operation *partitionRoot,
+    ArrayRef<StringRef> topLevelNames, std::vector<Partition> &partitions) {
+  SmallVector<StringRef> regionNames;
   while (!nameContext.empty()) {
     Region *region;
     UsedNamesScopeTy *parentScope;
@@ -1318,18 +1502,83 @@ SSANameState::SSANameState(Operation *op, const OpPrintingFlags &printerFlags)
     auto *curNamesScope = new (allocator.Allocate<UsedNamesScopeTy>())
         UsedNamesScopeTy(usedNames);
 
+    bool isPartitionParent =
+        partitionRoot && region->getParentOp() == partitionRoot;
+    if (isPartitionParent) {
+      regionNames.assign(topLevelNames.begin(), topLevelNames.end());
+      recordedNames = &regionNames;
+    }
     numberValuesInRegion(*region);
-
-    for (Operation &op : region->getOps())
+    recordedNames = nullptr;
+
+    for (Operation &op : region->getOps()) {
+      if (isPartitionParent && op.getNumRegions() != 0 &&
+          op.hasTrait<OpTrait::IsIsolatedFromAbove>()) {
+        partitions.push_back({&op, nextValueID, nextArgumentID, nextConflictID,
+                              regionNames});
+        continue;
+      }
       for (Region &region : op.getRegions())
         nameContext.push_back(std::make_tuple(&region, nextValueID,
                                               nextArgumentID, nextConflictID,
                                               curNamesScope));
+    }
   }
+}
 
-  // Manually remove all the scopes.
-  while (usedNames.getCurScope() != nullptr)
-    usedNames.getCurScope()->~UsedNamesScopeTy();
+void SSANameState::numberPartitionsInParallel(
+    MLIRContext *context, std::vector<Partition> &partitions) {
+  std::vector<std::unique_ptr<SSANameState>> states(partitions.size());
+  parallelFor(context, 0, partitions.size(), [&](size_t index) {
+    Partition &partition = partitions[index];
+    auto state = std::make_unique<SSANameState>();
+    state->printerFlags = printerFlags;
+    state->nextValueID = partition.nextValueID;
+    state->nextArgumentID = partition.nextArgumentID;
+    state->nextConflictID = partition.nextConflictID;
+
+    // The blocks of the partition may have been named by the operation when
+    // numbering its parent region.
+    for (Region &region : partition.op->getRegions()) {
+      for (Block &block : region) {
+        auto it = blockNames.find(&block);
+        if (it != blockNames.end())
+          state->blockNames.insert(*it);
+      }
+    }
+
+    llvm::BumpPtrAllocator allocator;
+    auto *parentScope = new (allocator.Allocate<UsedNamesScopeTy>())
+        UsedNamesScopeTy(state->usedNames);
+    for (StringRef name : partition.visibleNames)
+      state->usedNames.insert(name, char());
+
+    SmallVector<NamingContext, 8> nameContext;
+    for (Region &region : partition.op->getRegions())
+      nameContext.push_back(std::make_tuple(
+          &region, partition.nextValueID, partition.nextArgumentID,
+          partition.nextConflictID, parentScope));
+    std::vector<Partition> nestedPartitions;
+    state->numberValuesInContexts(nameContext, allocator,
+                                  /*partitionRoot=*/nullptr,
+                                  /*topLevelNames=*/{}, nestedPartitions);
+    while (state->usedNames.getCurScope() != nullptr)
+      state->usedNames.getCurScope()->~UsedNamesScopeTy();
+    states[index] = std::move(state);
+  });
+
+  // Merge the numbering of the partitions, which are disjoint except for the
+  // block names seeded above.
+  for (std::unique_ptr<SSANameState> &state : states) {
+    valueIDs.insert(state->valueIDs.begin(), state->valueIDs.end());
+    valueNames.insert(state->valueNames.begin(), state->valueNames.end());
+    operationIDs.insert(state->operationIDs.begin(), state->operationIDs.end());
+    for (auto &it : state->opResultGroups)
+      opResultGroups.try_emplace(it.first, std::move(it.second));
+    for (auto &it : state->blockNames)
+      blockNames[it.first] = it.second;
+    partitionAllocators.push_back(std::move(state->usedNameAllocator));
+  }
 }
 
 void SSANameState::printValueID(Value value, bool printResultNo,
@@ -1410,7 +1659,9 @@ void SSANameState::shadowRegionArgs(Region &region, ValueRange namesToUse) {
     // Use the name without the leading %.
     auto name = StringRef(nameStream.str()).drop_front();
 
-    // Overwrite the name.
+    // Overwrite the name. The operations may be printed in parallel, which
+    // share the allocator.
+    std::lock_guard<std::mutex> lock(usedNameMutex);
     valueNames[nameToReplace] = name.copy(usedNameAllocator);
   }
 }
@@ -1601,6 +1852,8 @@ StringRef SSANameState::uniqueValueName(StringRef name) {
   }
 
   usedNames.insert(name, char());
+  if (recordedNames)
+    recordedNames->push_back(name);
   return name;
 }
 
@@ -1736,6 +1989,9 @@ public:
       (*locationMap)[op] = std::make_pair(line, col);
   }
 
+  /// Return if the locations of the printed operations are recorded.
+  bool hasLocationMap() const { return locationMap != nullptr; }
+
   /// Return the referenced dialect resources within the printer.
   DenseMap<Dialect *, SetVector<AsmDialectResourceHandle>> &
   getDialectResources() {
@@ -1988,7 +2244,10 @@ void AsmPrinter::Impl::printResourceHandle(
     const AsmDialectResourceHandle &resource) {
   auto *interface = cast<OpAsmDialectInterface>(resource.getDialect());
   os << interface->getResourceKey(resource);
-  state.getDialectResources()[resource.getDialect()].insert(resource);
+  if (referencedResources)
+    referencedResources->push_back(resource);
+  else
+    state.getDialectResources()[resource.getDialect()].insert(resource);
 }
 
 /// Returns true if the given dialect symbol data is simple enough to print in
@@ -2315,9 +2574,7 @@ void AsmPrinter::Impl::printDenseIntOrFPElementsAttr(
   auto elementType = type.getElementType();
 
   // Check to see if we should format this attribute as a hex string.
-  auto numElements = type.getNumElements();
-  if (!attr.isSplat() && allowHex &&
-      shouldPrintElementsAttrWithHex(numElements)) {
+  if (allowHex && printerFlags.shouldPrintElementsAttrWithHex(attr)) {
     ArrayRef<char> rawData = attr.getRawData();
     if (llvm::support::endian::system_endianness() ==
         llvm::support::endianness::big) {
@@ -2596,6 +2853,7 @@ void AsmPrinter::Impl::printDialectAttribute(Attribute attr) {
   {
     llvm::raw_string_ostream attrNameStr(attrName);
     Impl subPrinter(attrNameStr, state);
+    subPrinter.referencedResources = referencedResources;
     DialectAsmPrinter printer(subPrinter);
     dialect.printAttribute(attr, printer);
   }
@@ -2610,6 +2868,7 @@ void AsmPrinter::Impl::printDialectType(Type type) {
   {
     llvm::raw_string_ostream typeNameStr(typeName);
     Impl subPrinter(typeNameStr, state);
+    subPrinter.referencedResources = referencedResources;
     DialectAsmPrinter printer(subPrinter);
     dialect.printType(type, printer);
   }
@@ -2622,8 +2881,26 @@ void AsmPrinter::Impl::printEscapedString(StringRef str) {
   os << "\"";
 }
 
+/// Print the hex digits of the given data, in chunks that avoid materializing
+/// the hex string of large data.
+static void printHexDigits(raw_ostream &os, StringRef data) {
+  static constexpr char kHexDigits[] = "0123456789ABCDEF";
+  char buffer[1024];
+  constexpr size_t kChunkSize = sizeof(buffer) / 2;
+  for (size_t begin = 0, e = data.size(); begin < e; begin += kChunkSize) {
+    StringRef chunk = data.substr(begin, kChunkSize);
+    for (auto [index, c] : llvm::enumerate(chunk.bytes())) {
+      buffer[2 * index] = kHexDigits[c >> 4];
+      buffer[2 * index + 1] = kHexDigits[c & 0xF];
+    }
+    os.write(buffer, 2 * chunk.size());
+  }
+}
+
 void AsmPrinter::Impl::printHexString(StringRef str) {
-  os << "\"0x" << llvm::toHex(str) << "\"";
+  os << "\"0x";
+  printHexDigits(os, str);
+  os << "\"";
 }
 void AsmPrinter::Impl::printHexString(ArrayRef<char> data) {
   printHexString(StringRef(data.data(), data.size()));
@@ -3056,10 +3333,11 @@ private:
       printFn(key, [&](raw_ostream &os) {
         // Store the blob in a hex string containing the alignment and the data.
         llvm::support::ulittle32_t dataAlignmentLE(dataAlignment);
-        os << "\"0x"
-           << llvm::toHex(StringRef(reinterpret_cast<char *>(&dataAlignmentLE),
-                                    sizeof(dataAlignment)))
-           << llvm::toHex(StringRef(data.data(), data.size())) << "\"";
+        os << "\"0x";
+        printHexDigits(os, StringRef(reinterpret_cast<char *>(&dataAlignmentLE),
+                                     sizeof(dataAlignment)));
+        printHexDigits(os, StringRef(data.data(), data.size()));
+        os << "\"";
       });
     }
 
@@ -3068,6 +3346,10 @@ private:
     PrintFn printFn;
   };
 
+  /// Print the given operations of a block of the top-level operation, and
+  /// the partitions among them in parallel.
+  void printOperationsInParallel(iterator_range<Block::iterator> range);
+
   /// Print the metadata dictionary for the file, eliding it if it is empty.
   void printFileMetadataDictionary(Operation *op);
 
@@ -3090,10 +3372,23 @@ private:
 
   // This is the current indentation level for nested structures.
   unsigned currentIndent = 0;
+
+  /// The top-level operation whose nested partitions are printed in parallel,
+  /// and the partitions.
+  Operation *parallelRoot = nullptr;
+  SmallPtrSet<Operation *, 8> parallelPartitions;
 };
 } // namespace
 
 void OperationPrinter::printTopLevelOperation(Operation *op) {
+  // Print the isolated operations nested in `op` in parallel, unless the
+  // locations of the printed operations are recorded.
+  if (!state.hasLocationMap()) {
+    parallelRoot = op;
+    for (Operation *partition : getParallelPrintingPartitions(op, printerFlags))
+      parallelPartitions.insert(partition);
+  }
+
   // Output the aliases at the top level that can't be deferred.
   state.getAliasState().printNonDeferredAliases(*this, newLine);
 
@@ -3446,13 +3741,59 @@ void OperationPrinter::print(Block *block, bool printBlockArgs,
       block->begin(),
       std::prev(block->end(),
                 (!hasTerminator || printBlockTerminator) ? 0 : 1));
-  for (auto &op : range) {
-    printFullOpWithIndentAndLoc(&op);
-    os << newLine;
+  if (!parallelPartitions.empty() && block->getParentOp() == parallelRoot) {
+    printOperationsInParallel(range);
+  } else {
+    for (auto &op : range) {
+      printFullOpWithIndentAndLoc(&op);
+      os << newLine;
+    }
   }
   currentIndent -= indentWidth;
 }
 
+void OperationPrinter::printOperationsInParallel(
+    iterator_range<Block::iterator> range) {
+  SmallVector<Operation *> ops =
+      llvm::to_vector(llvm::make_pointer_range(range));
+  if (ops.empty())
+    return;
+
+  // The partitions are printed into separate buffers, in batches that bound
+  // the memory of the buffers, and written in order with the other operations.
+  MLIRContext *context = ops.front()->getContext();
+  size_t batchSize = 4 * context->getNumThreads();
+  std::vector<std::string> buffers;
+  std::vector<std::vector<AsmDialectResourceHandle>> resources;
+  for (size_t begin = 0, e = ops.size(); begin < e; begin += batchSize) {
+    ArrayRef<Operation *> batch =
+        ArrayRef(ops).slice(begin, std::min(batchSize, e - begin));
+    buffers.assign(batch.size(), std::string());
+    resources.assign(batch.size(), {});
+    parallelFor(context, 0, batch.size(), [&](size_t index) {
+      if (!parallelPartitions.contains(batch[index]))
+        return;
+      llvm::raw_string_ostream bufferOS(buffers[index]);
+      OperationPrinter printer(bufferOS, state);
+      printer.defaultDialectStack = defaultDialectStack;
+      printer.currentIndent = currentIndent;
+      printer.referencedResources = &resources[index];
+      printer.printFullOpWithIndentAndLoc(batch[index]);
+    });
+
+    for (auto [index, op] : llvm::enumerate(batch)) {
+      if (parallelPartitions.contains(op)) {
+        os << buffers[index];
+        for (const AsmDialectResourceHandle &resource : resources[index])
+          state.getDialectResources()[resource.getDialect()].insert(resource);
+      } else {
+        printFullOpWithIndentAndLoc(op);
+      }
+      os << newLine;
+    }
+  }
+}
+
 void OperationPrinter::printValueID(Value value, bool printResultNo,
                                     raw_ostream *streamOverride) const {
   state.getSSANameState().printValueID(value, printResultNo,
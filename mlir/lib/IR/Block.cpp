@@ -10,14 +10,37 @@
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/Operation.h"
 #include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseSet.h"
 using namespace mlir;
 
+//===----------------------------------------------------------------------===//
+// OpNameIndex
+//===----------------------------------------------------------------------===//
+
+namespace mlir {
+namespace detail {
+/// An index of the operations of a block by name.
+struct OpNameIndex {
+  struct Entry {
+    /// The operations with the name.
+    DenseSet<Operation *> ops;
+    /// The operations in block order, which is recomputed from `ops` when it
+    /// is marked as stale.
+    SmallVector<Operation *, 1> orderedOps;
+    bool isOrderStale = false;
+  };
+  DenseMap<OperationName, Entry> entries;
+};
+} // namespace detail
+} // namespace mlir
+
 //===----------------------------------------------------------------------===//
 // Block
 //===----------------------------------------------------------------------===//
 
 Block::~Block() {
   assert(!verifyOpOrder() && "Expected valid operation ordering.");
+  opNameIndex.reset();
   clear();
   for (BlockArgument arg : arguments)
     arg.destroy();
@@ -129,6 +152,122 @@ void Block::recomputeOpOrder() {
     op.orderIndex = (orderIndex += Operation::kOrderStride);
 }
 
+void Block::recomputeOpOrderAround(Operation *op) {
+  assert(op->getBlock() == this && "expected an operation of this block");
+  assert(isOpOrderValid() && "expected a valid block order");
+
+  // The window of operations to renumber is [first, last]. Its exclusive
+  // bounds are the indices of the operations around it, which must be valid,
+  // or -1 and kInvalidOrderIdx at the ends of the block.
+  Operation *first = op, *last = op;
+  uint64_t count = 1;
+  int64_t lowerBound, upperBound;
+  for (unsigned growth = 1;; growth *= 2) {
+    // Double the size of the window on both sides.
+    for (unsigned i = 0; i < growth; ++i) {
+      if (Operation *prev = first->getPrevNode()) {
+        first = prev;
+        ++count;
+      }
+      if (Operation *next = last->getNextNode()) {
+        last = next;
+        ++count;
+      }
+    }
+    while (first->getPrevNode() && !first->getPrevNode()->hasValidOrder()) {
+      first = first->getPrevNode();
+      ++count;
+    }
+    while (last->getNextNode() && !last->getNextNode()->hasValidOrder()) {
+      last = last->getNextNode();
+      ++count;
+    }
+
+    Operation *prev = first->getPrevNode(), *next = last->getNextNode();
+    lowerBound = prev ? static_cast<int64_t>(prev->orderIndex) : -1;
+    upperBound = next ? static_cast<int64_t>(next->orderIndex)
+                      : static_cast<int64_t>(Operation::kInvalidOrderIdx);
+    uint64_t numAvailable = upperBound - lowerBound - 1;
+
+    // Stop at the first window that leaves a stride between its operations,
+    // such that the next insertions in it have room too.
+    if (numAvailable >= count * Operation::kOrderStride)
+      break;
+    if (!prev && !next) {
+      if (numAvailable >= count)
+        break;
+      return recomputeOpOrder();
+    }
+  }
+
+  // Spread the indices of the window evenly between its bounds.
+  uint64_t spacing = (upperBound - lowerBound) / (count + 1);
+  int64_t orderIndex = lowerBound;
+  for (Operation *it = first;; it = it->getNextNode()) {
+    orderIndex += spacing;
+    it->orderIndex = orderIndex;
+    if (it == last)
+      break;
+  }
+}
+
+ArrayRef<Operation *> Block::getOpsWithName(OperationName name) {
+  if (!opNameIndex) {
+    opNameIndex = std::make_unique<detail::OpNameIndex>();
+    for (Operation &op : *this) {
+      detail::OpNameIndex::Entry &entry = opNameIndex->entries[op.getName()];
+      entry.ops.insert(&op);
+      entry.orderedOps.push_back(&op);
+    }
+  }
+
+  auto it = opNameIndex->entries.find(name);
+  if (it == opNameIndex->entries.end())
+    return {};
+  detail::OpNameIndex::Entry &entry = it->second;
+  if (entry.isOrderStale) {
+    entry.orderedOps.assign(entry.ops.begin(), entry.ops.end());
+    llvm::sort(entry.orderedOps, [](Operation *lhs, Operation *rhs) {
+      return lhs->isBeforeInBlock(rhs);
+    });
+    entry.isOrderStale = false;
+  }
+  return entry.orderedOps;
+}
+
+ArrayRef<Operation *> Block::getOpsWithName(StringRef name) {
+  if (empty())
+    return {};
+  return getOpsWithName(OperationName(name, front().getContext()));
+}
+
+void Block::addToOpNameIndex(Operation *op) {
+  if (!opNameIndex)
+    return;
+  detail::OpNameIndex::Entry &entry = opNameIndex->entries[op->getName()];
+  entry.ops.insert(op);
+  entry.isOrderStale = true;
+}
+
+void Block::removeFromOpNameIndex(Operation *op) {
+  if (!opNameIndex)
+    return;
+  auto it = opNameIndex->entries.find(op->getName());
+  assert(it != opNameIndex->entries.end() && "operation is not indexed");
+  detail::OpNameIndex::Entry &entry = it->second;
+  entry.ops.erase(op);
+  if (entry.ops.empty())
+    opNameIndex->entries.erase(it);
+  else
+    entry.isOrderStale = true;
+}
+
+void Block::invalidateOpNameIndexOrder(Operation *op) {
+  if (!opNameIndex)
+    return;
+  opNameIndex->entries[op->getName()].isOrderStale = true;
+}
+
 //===----------------------------------------------------------------------===//
 // Argument list management.
 //===----------------------------------------------------------------------===//
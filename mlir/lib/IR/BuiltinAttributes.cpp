@@ -18,6 +18,7 @@
 #include "mlir/IR/SymbolTable.h"
 #include "mlir/IR/Types.h"
 #include "llvm/ADT/APSInt.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/Sequence.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Endian.h"
@@ -1601,6 +1602,37 @@ bool DenseResourceElementsAttrBase<T>::classof(Attribute attr) {
                              resourceAttr.getElementType());
 }
 
+size_t mlir::releaseUnreferencedDenseResources(MLIRContext *context,
+                                               ArrayRef<Operation *> roots) {
+  // Collect the blob entries referenced from the attributes and types of the
+  // live operations.
+  DenseSet<const DialectResourceBlobManager::BlobEntry *> referenced;
+  auto collect = [&](DenseResourceElementsAttr attr) {
+    referenced.insert(attr.getRawHandle().getResource());
+  };
+  for (Operation *root : roots) {
+    root->walk([&](Operation *op) {
+      op->getDiscardableAttrDictionary().walk(collect);
+      if (op->isRegistered()) {
+        NamedAttrList inherentAttrs;
+        op->getName().populateInherentAttrs(op, inherentAttrs);
+        for (const NamedAttribute &attr : inherentAttrs)
+          attr.getValue().walk(collect);
+      } else if (Attribute properties = op->getPropertiesAsAttribute()) {
+        properties.walk(collect);
+      }
+      for (Type type : op->getResultTypes())
+        type.walk(collect);
+    });
+  }
+
+  auto &manager = DenseResourceElementsHandle::getManagerInterface(context);
+  return manager.getBlobManager().releaseBlobs(
+      [&](const DialectResourceBlobManager::BlobEntry &entry) {
+        return !referenced.contains(&entry);
+      });
+}
+
 namespace mlir {
 namespace detail {
 // Explicit instantiation for all the supported DenseResourceElementsAttr.
@@ -86,6 +86,13 @@ struct BuiltinOpAsmDialectInterface : public OpAsmDialectInterface {
     return blobManager.insert(key);
   }
   LogicalResult parseResource(AsmParsedResourceEntry &entry) const final {
+    // Defer the parsing of the blob to its first use when possible.
+    if (entry.getKind() == AsmResourceEntryKind::Blob) {
+      if (AsmParsedResourceEntry::LazyBlobFn loadFn = entry.parseAsLazyBlob()) {
+        blobManager.updateLazily(entry.getKey(), std::move(loadFn));
+        return success();
+      }
+    }
     FailureOr<AsmResourceBlob> blob = entry.parseAsBlob();
     if (failed(blob))
       return failure();
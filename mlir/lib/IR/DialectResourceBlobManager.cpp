@@ -30,6 +30,14 @@ void DialectResourceBlobManager::update(StringRef name,
   entry->setBlob(std::move(newBlob));
 }
 
+void DialectResourceBlobManager::updateLazily(
+    StringRef name, AsmParsedResourceEntry::LazyBlobFn loadFn) {
+  BlobEntry *entry = lookup(name);
+  assert(entry &&
+         "`updateLazily` expects an existing entry for the provided name");
+  entry->setLazyBlob(std::move(loadFn));
+}
+
 auto DialectResourceBlobManager::insert(StringRef name,
                                         std::optional<AsmResourceBlob> blob)
     -> BlobEntry & {
@@ -63,3 +71,31 @@ auto DialectResourceBlobManager::insert(StringRef name,
     nameStorage.resize(name.size() + 1);
   } while (true);
 }
+
+size_t DialectResourceBlobManager::releaseBlobs(
+    function_ref<bool(const BlobEntry &)> shouldRelease) {
+  llvm::sys::SmartScopedWriter<true> writer(blobMapLock);
+
+  size_t numReleasedBytes = 0;
+  for (auto &it : blobMap) {
+    BlobEntry &entry = it.second;
+    // The lazily loaded blobs that were not loaded yet hold no data, but are
+    // released for the entries to consistently have no blob afterwards.
+    if ((!entry.blob && !entry.hasUnloadedBlob()) || !shouldRelease(entry))
+      continue;
+    if (entry.blob)
+      numReleasedBytes += entry.blob->getData().size();
+    entry.releaseBlob();
+  }
+  return numReleasedBytes;
+}
+
+size_t DialectResourceBlobManager::getTotalBlobSize() {
+  llvm::sys::SmartScopedReader<true> reader(blobMapLock);
+
+  size_t totalSize = 0;
+  for (auto &it : blobMap)
+    if (const std::optional<AsmResourceBlob> &blob = it.second.blob)
+      totalSize += blob->getData().size();
+  return totalSize;
+}
@@ -49,6 +49,50 @@ void DominanceInfoBase<IsPostDom>::invalidate(Region *region) {
   }
 }
 
+/// Return the dominator tree of `region` if it was computed and is still
+/// rooted at the entry block of the region, invalidating it otherwise.
+template <typename DomTree, typename DomInfosT>
+static DomTree *getUpdatableDomTree(DomInfosT &dominanceInfos,
+                                    Region *region) {
+  auto it = dominanceInfos.find(region);
+  // The trees are built on demand, there is nothing to update until then.
+  if (it == dominanceInfos.end() || !it->second.getPointer())
+    return nullptr;
+  DomTree *domTree = it->second.getPointer();
+  if (!DomTree::IsPostDominator &&
+      (region->empty() || domTree->getRoot() != &region->front())) {
+    delete domTree;
+    dominanceInfos.erase(it);
+    return nullptr;
+  }
+  return domTree;
+}
+
+template <bool IsPostDom>
+void DominanceInfoBase<IsPostDom>::insertEdge(Block *from, Block *to) {
+  assert(from->getParent() == to->getParent() &&
+         "expected blocks of the same region");
+  if (DomTree *domTree =
+          getUpdatableDomTree<DomTree>(dominanceInfos, from->getParent()))
+    domTree->insertEdge(from, to);
+}
+
+template <bool IsPostDom>
+void DominanceInfoBase<IsPostDom>::deleteEdge(Block *from, Block *to) {
+  assert(from->getParent() == to->getParent() &&
+         "expected blocks of the same region");
+  if (DomTree *domTree =
+          getUpdatableDomTree<DomTree>(dominanceInfos, from->getParent()))
+    domTree->deleteEdge(from, to);
+}
+
+template <bool IsPostDom>
+void DominanceInfoBase<IsPostDom>::applyUpdates(
+    Region *region, ArrayRef<typename DomTree::UpdateType> updates) {
+  if (DomTree *domTree = getUpdatableDomTree<DomTree>(dominanceInfos, region))
+    domTree->applyUpdates(updates);
+}
+
 /// Return the dom tree and "hasSSADominance" bit for the given region.  The
 /// DomTree will be null for single-block regions.  This lazily constructs the
 /// DomTree on demand when needsDomTree=true.
@@ -8,6 +8,7 @@
 
 #include "mlir/IR/Location.h"
 #include "mlir/IR/BuiltinDialect.h"
+#include "mlir/IR/MLIRContext.h"
 #include "mlir/IR/Visitors.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/TypeSwitch.h"
@@ -86,26 +87,41 @@ CallSiteLoc CallSiteLoc::get(Location name, ArrayRef<Location> frames) {
 
 Location FusedLoc::get(ArrayRef<Location> locs, Attribute metadata,
                        MLIRContext *context) {
-  // Unique the set of locations to be fused.
+  // Unique the set of locations to be fused, as dictated by the policy of the
+  // context.
+  MLIRContext::FusedLocPolicy policy = context->getFusedLocPolicy();
+  bool dropToCallSite = policy == MLIRContext::FusedLocPolicy::DropToCallSite;
   llvm::SmallSetVector<Location, 4> decomposedLocs;
+  auto insertLoc = [&](Location loc) {
+    while (dropToCallSite && isa<CallSiteLoc>(loc))
+      loc = cast<CallSiteLoc>(loc).getCaller();
+    if (!isa<UnknownLoc>(loc))
+      decomposedLocs.insert(loc);
+  };
   for (auto loc : locs) {
     // If the location is a fused location we decompose it if it has no
-    // metadata or the metadata is the same as the top level metadata.
+    // metadata or the metadata is the same as the top level metadata, or if
+    // the policy flattens all the fused locations.
     if (auto fusedLoc = llvm::dyn_cast<FusedLoc>(loc)) {
-      if (fusedLoc.getMetadata() == metadata) {
+      if (fusedLoc.getMetadata() == metadata ||
+          policy != MLIRContext::FusedLocPolicy::Default) {
         // UnknownLoc's have already been removed from FusedLocs so we can
         // simply add all of the internal locations.
-        decomposedLocs.insert(fusedLoc.getLocations().begin(),
-                              fusedLoc.getLocations().end());
+        for (Location nestedLoc : fusedLoc.getLocations())
+          insertLoc(nestedLoc);
         continue;
       }
     }
     // Otherwise, only add known locations to the set.
-    if (!llvm::isa<UnknownLoc>(loc))
-      decomposedLocs.insert(loc);
+    insertLoc(loc);
   }
   locs = decomposedLocs.getArrayRef();
 
+  // Keep the first locations if there are too many of them.
+  unsigned maxLocations = context->getMaxFusedLocations();
+  if (maxLocations && locs.size() > maxLocations)
+    locs = locs.take_front(maxLocations);
+
   // Handle the simple cases of less than two locations. Ensure the metadata (if
   // provided) is not dropped.
   if (locs.empty()) {
@@ -60,6 +60,12 @@ struct MLIRContextOptions {
       llvm::cl::desc("Disable multi-threading within MLIR, overrides any "
                      "further call to MLIRContext::enableMultiThreading()")};
 
+  llvm::cl::opt<bool> useSharedThreadPool{
+      "mlir-shared-thread-pool",
+      llvm::cl::desc("Make the contexts that do not have an external thread "
+                     "pool share a thread pool, instead of each creating its "
+                     "own")};
+
   llvm::cl::opt<bool> printOpOnDiagnostic{
       "mlir-print-op-on-diagnostic",
       llvm::cl::desc("When a diagnostic is emitted on an operation, also print "
@@ -70,6 +76,26 @@ struct MLIRContextOptions {
       "mlir-print-stacktrace-on-diagnostic",
       llvm::cl::desc("When a diagnostic is emitted, also print the stack trace "
                      "as an attached note")};
+
+  llvm::cl::opt<MLIRContext::FusedLocPolicy> fusedLocPolicy{
+      "mlir-fused-loc-policy",
+      llvm::cl::desc("The policy bounding the growth of the fused locations"),
+      llvm::cl::init(MLIRContext::FusedLocPolicy::Default),
+      llvm::cl::values(
+          clEnumValN(MLIRContext::FusedLocPolicy::Default, "default",
+                     "Flatten the fused locations with the same metadata"),
+          clEnumValN(MLIRContext::FusedLocPolicy::Flatten, "flatten",
+                     "Flatten all the nested fused locations"),
+          clEnumValN(MLIRContext::FusedLocPolicy::DropToCallSite,
+                     "drop-to-callsite",
+                     "Flatten all the nested fused locations, and reduce the "
+                     "call site locations to their outermost caller"))};
+
+  llvm::cl::opt<unsigned> maxFusedLocations{
+      "mlir-max-fused-locations",
+      llvm::cl::desc("The maximum number of locations of a fused location, or "
+                     "0 for no maximum"),
+      llvm::cl::init(0)};
 };
 } // namespace
 
@@ -161,6 +187,12 @@ public:
   /// If the current stack trace should be attached when emitting diagnostics.
   bool printStackTraceOnDiagnostic = false;
 
+  /// The policy and the maximum number of locations applied to the fused
+  /// locations.
+  MLIRContext::FusedLocPolicy fusedLocPolicy =
+      MLIRContext::FusedLocPolicy::Default;
+  unsigned maxFusedLocations = 0;
+
   //===--------------------------------------------------------------------===//
   // Other
   //===--------------------------------------------------------------------===//
@@ -250,11 +282,21 @@ public:
 public:
   MLIRContextImpl(bool threadingIsEnabled)
       : threadingIsEnabled(threadingIsEnabled) {
-    if (threadingIsEnabled) {
-      ownedThreadPool = std::make_unique<llvm::ThreadPool>();
-      threadPool = ownedThreadPool.get();
+    if (threadingIsEnabled)
+      initThreadPool();
+  }
+  /// Sets up the thread pool of a context that has none: either the thread
+  /// pool shared by the contexts of the process, or one owned by the context.
+  void initThreadPool() {
+    assert(!threadPool && !ownedThreadPool && "expected no thread pool");
+    if (clOptions.isConstructed() && clOptions->useSharedThreadPool) {
+      threadPool = &MLIRContext::getSharedThreadPool();
+      return;
     }
+    ownedThreadPool = std::make_unique<llvm::ThreadPool>();
+    threadPool = ownedThreadPool.get();
   }
+
   ~MLIRContextImpl() {
     for (auto typeMapping : registeredTypes)
       typeMapping.second->~AbstractType();
@@ -274,6 +316,8 @@ MLIRContext::MLIRContext(const DialectRegistry &registry, Threading setting)
   if (clOptions.isConstructed()) {
     printOpOnDiagnostic(clOptions->printOpOnDiagnostic);
     printStackTraceOnDiagnostic(clOptions->printStackTraceOnDiagnostic);
+    setFusedLocPolicy(clOptions->fusedLocPolicy);
+    setMaxFusedLocations(clOptions->maxFusedLocations);
   }
 
   // Pre-populate the registry.
@@ -596,9 +640,7 @@ void MLIRContext::disableMultithreading(bool disable) {
     }
   } else if (!impl->threadPool) {
     // The thread pool isn't externally provided.
-    assert(!impl->ownedThreadPool);
-    impl->ownedThreadPool = std::make_unique<llvm::ThreadPool>();
-    impl->threadPool = impl->ownedThreadPool.get();
+    impl->initThreadPool();
   }
 }
 
@@ -610,6 +652,11 @@ void MLIRContext::setThreadPool(llvm::ThreadPool &pool) {
   enableMultithreading();
 }
 
+llvm::ThreadPool &MLIRContext::getSharedThreadPool() {
+  static llvm::ThreadPool sharedThreadPool;
+  return sharedThreadPool;
+}
+
 unsigned MLIRContext::getNumThreads() {
   if (isMultithreadingEnabled()) {
     assert(impl->threadPool &&
@@ -669,6 +716,28 @@ void MLIRContext::printStackTraceOnDiagnostic(bool enable) {
   impl->printStackTraceOnDiagnostic = enable;
 }
 
+MLIRContext::FusedLocPolicy MLIRContext::getFusedLocPolicy() {
+  return impl->fusedLocPolicy;
+}
+
+void MLIRContext::setFusedLocPolicy(FusedLocPolicy policy) {
+  assert(impl->multiThreadedExecutionContext == 0 &&
+         "changing MLIRContext `fused-loc-policy` configuration while in a "
+         "multi-threaded execution context");
+  impl->fusedLocPolicy = policy;
+}
+
+unsigned MLIRContext::getMaxFusedLocations() {
+  return impl->maxFusedLocations;
+}
+
+void MLIRContext::setMaxFusedLocations(unsigned maxLocations) {
+  assert(impl->multiThreadedExecutionContext == 0 &&
+         "changing MLIRContext `max-fused-locations` configuration while in a "
+         "multi-threaded execution context");
+  impl->maxFusedLocations = maxLocations;
+}
+
 /// Return information about all registered operations.
 ArrayRef<RegisteredOperationName> MLIRContext::getRegisteredOperations() {
   return impl->sortedRegisteredOperations;
@@ -903,15 +972,19 @@ void RegisteredOperationName::insert(
       name, RegisteredOperationName(impl));
   assert(emplaced.second && "operation name registration must be successful");
 
-  // Add emplaced operation name to the sorted operations container.
+  // Add emplaced operation name to the sorted operations container. The
+  // dialects are loaded in the order of their namespace and register their
+  // operations in the order of their names, such that the new operation
+  // usually sorts last and is appended without shifting the others.
   RegisteredOperationName &value = emplaced.first->getValue();
-  ctxImpl.sortedRegisteredOperations.insert(
-      llvm::upper_bound(ctxImpl.sortedRegisteredOperations, value,
-                        [](auto &lhs, auto &rhs) {
-                          return lhs.getIdentifier().compare(
-                              rhs.getIdentifier());
-                        }),
-      value);
+  auto &sortedOps = ctxImpl.sortedRegisteredOperations;
+  auto isBefore = [](RegisteredOperationName lhs, RegisteredOperationName rhs) {
+    return lhs.getStringRef() < rhs.getStringRef();
+  };
+  if (sortedOps.empty() || !isBefore(value, sortedOps.back()))
+    sortedOps.push_back(value);
+  else
+    sortedOps.insert(llvm::upper_bound(sortedOps, value, isBefore), value);
 }
 
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,32 @@
+//===- ModifiedOpsListener.cpp - Track modified operations ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/ModifiedOpsListener.h"
+
+using namespace mlir;
+
+void ModifiedOpsListener::notifyOperationInserted(Operation *op) {
+  modifiedOps.insert(op);
+}
+
+void ModifiedOpsListener::notifyBlockCreated(Block *block) {
+  if (Operation *parentOp = block->getParentOp())
+    modifiedOps.insert(parentOp);
+}
+
+void ModifiedOpsListener::notifyOperationModified(Operation *op) {
+  modifiedOps.insert(op);
+}
+
+void ModifiedOpsListener::notifyOperationRemoved(Operation *op) {
+  // The operation and the operations nested within it are about to be
+  // destroyed, but the structure of the parent operation changes.
+  op->walk([&](Operation *nested) { modifiedOps.erase(nested); });
+  if (Operation *parentOp = op->getParentOp())
+    modifiedOps.insert(parentOp);
+}
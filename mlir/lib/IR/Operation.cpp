@@ -13,6 +13,7 @@
 #include "mlir/IR/Dialect.h"
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/OpImplementation.h"
+#include "mlir/IR/OperationArena.h"
 #include "mlir/IR/OperationSupport.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/IR/TypeUtilities.h"
@@ -109,13 +110,18 @@ Operation *Operation::create(Location location, OperationName name,
   size_t prefixByteSize = llvm::alignTo(
       Operation::prefixAllocSize(numTrailingResults, numInlineResults),
       alignof(Operation));
-  char *mallocMem = reinterpret_cast<char *>(malloc(byteSize + prefixByteSize));
+  OperationArena *arena = OperationArena::getActive();
+  char *mallocMem = reinterpret_cast<char *>(
+      arena ? arena->allocate(byteSize + prefixByteSize,
+                              alignof(std::max_align_t))
+            : malloc(byteSize + prefixByteSize));
   void *rawMem = mallocMem + prefixByteSize;
 
   // Create the new Operation.
   Operation *op = ::new (rawMem) Operation(
       location, name, numResults, numSuccessors, numRegions,
       opPropertiesAllocSize, attributes, properties, needsOperandStorage);
+  op->isArenaAllocated = arena != nullptr;
 
   assert((numSuccessors == 0 || op->mightHaveTrait<OpTrait::IsTerminator>()) &&
          "unexpected successors in a non-terminator operation");
@@ -155,7 +161,8 @@ Operation::Operation(Location location, OperationName name, unsigned numResults,
                      int fullPropertiesStorageSize, DictionaryAttr attributes,
                      OpaqueProperties properties, bool hasOperandStorage)
     : location(location), numResults(numResults), numSuccs(numSuccessors),
-      numRegions(numRegions), hasOperandStorage(hasOperandStorage),
+      numRegions(numRegions), isArenaAllocated(false),
+      hasOperandStorage(hasOperandStorage),
       propertiesStorageSize((fullPropertiesStorageSize + 7) / 8), name(name) {
   assert(attributes && "unexpected null attribute dictionary");
   assert(fullPropertiesStorageSize <= propertiesCapacity &&
@@ -208,8 +215,13 @@ void Operation::destroy() {
   // accounted for here when computing the address to free.
   char *rawMem = reinterpret_cast<char *>(this) -
                  llvm::alignTo(prefixAllocSize(), alignof(Operation));
+  bool wasArenaAllocated = isArenaAllocated;
   this->~Operation();
-  free(rawMem);
+
+  // The memory of arena allocated operations is reclaimed when the arena is
+  // reset.
+  if (!wasArenaAllocated)
+    free(rawMem);
 }
 
 /// Return true if this operation is a proper ancestor of the `other`
@@ -401,7 +413,7 @@ bool Operation::isBeforeInBlock(Operation *other) {
 }
 
 /// Update the order index of this operation of this operation if necessary,
-/// potentially recomputing the order of the parent block.
+/// potentially recomputing the order of the operations around it.
 void Operation::updateOrderIfNecessary() {
   assert(block && "expected valid parent");
 
@@ -418,8 +430,9 @@ void Operation::updateOrderIfNecessary() {
   // If the operation is at the end of the block.
   if (this == blockBack) {
     Operation *prevNode = getPrevNode();
-    if (!prevNode->hasValidOrder())
-      return block->recomputeOpOrder();
+    if (!prevNode->hasValidOrder() ||
+        prevNode->orderIndex >= kInvalidOrderIdx - kOrderStride)
+      return block->recomputeOpOrderAround(this);
 
     // Add the stride to the previous operation.
     orderIndex = prevNode->orderIndex + kOrderStride;
@@ -431,10 +444,10 @@ void Operation::updateOrderIfNecessary() {
   if (this == blockFront) {
     Operation *nextNode = getNextNode();
     if (!nextNode->hasValidOrder())
-      return block->recomputeOpOrder();
+      return block->recomputeOpOrderAround(this);
     // There is no order to give this operation.
     if (nextNode->orderIndex == 0)
-      return block->recomputeOpOrder();
+      return block->recomputeOpOrderAround(this);
 
     // If we can't use the stride, just take the middle value left. This is safe
     // because we know there is at least one valid index to assign to.
@@ -449,12 +462,12 @@ void Operation::updateOrderIfNecessary() {
   // the middle of the previous and next if possible.
   Operation *prevNode = getPrevNode(), *nextNode = getNextNode();
   if (!prevNode->hasValidOrder() || !nextNode->hasValidOrder())
-    return block->recomputeOpOrder();
+    return block->recomputeOpOrderAround(this);
   unsigned prevOrder = prevNode->orderIndex, nextOrder = nextNode->orderIndex;
 
   // Check to see if there is a valid order between the two.
   if (prevOrder + 1 == nextOrder)
-    return block->recomputeOpOrder();
+    return block->recomputeOpOrderAround(this);
   orderIndex = prevOrder + ((nextOrder - prevOrder) / 2);
 }
 
@@ -503,6 +516,7 @@ Block *llvm::ilist_traits<::mlir::Operation>::getContainingBlock() {
 void llvm::ilist_traits<::mlir::Operation>::addNodeToList(Operation *op) {
   assert(!op->getBlock() && "already in an operation block!");
   op->block = getContainingBlock();
+  op->block->addToOpNameIndex(op);
 
   // Invalidate the order on the operation.
   op->orderIndex = Operation::kInvalidOrderIdx;
@@ -512,6 +526,7 @@ void llvm::ilist_traits<::mlir::Operation>::addNodeToList(Operation *op) {
 /// We keep the block pointer up to date.
 void llvm::ilist_traits<::mlir::Operation>::removeNodeFromList(Operation *op) {
   assert(op->block && "not already in an operation block!");
+  op->block->removeFromOpNameIndex(op);
   op->block = nullptr;
 }
 
@@ -526,12 +541,21 @@ void llvm::ilist_traits<::mlir::Operation>::transferNodesFromList(
 
   // If we are transferring operations within the same block, the block
   // pointer doesn't need to be updated.
-  if (curParent == otherList.getContainingBlock())
+  Block *otherParent = otherList.getContainingBlock();
+  if (curParent == otherParent) {
+    if (curParent->opNameIndex) {
+      for (; first != last; ++first)
+        curParent->invalidateOpNameIndexOrder(&*first);
+    }
     return;
+  }
 
   // Update the 'block' member of each operation.
-  for (; first != last; ++first)
+  for (; first != last; ++first) {
+    otherParent->removeFromOpNameIndex(&*first);
     first->block = curParent;
+    curParent->addToOpNameIndex(&*first);
+  }
 }
 
 /// Remove this operation (and its descendants) from its Block and delete
@@ -714,6 +738,76 @@ Operation *Operation::clone(CloneOptions options) {
   return clone(mapper, options);
 }
 
+//===----------------------------------------------------------------------===//
+// OperationArena
+//===----------------------------------------------------------------------===//
+
+/// The arena active on the current thread.
+static thread_local OperationArena *activeOperationArena = nullptr;
+
+OperationArena::Scope::Scope(OperationArena &arena)
+    : previous(activeOperationArena) {
+  activeOperationArena = &arena;
+}
+OperationArena::Scope::~Scope() { activeOperationArena = previous; }
+
+OperationArena *OperationArena::getActive() { return activeOperationArena; }
+
+void OperationArena::releaseResources(Operation *op, bool releaseOp) {
+  for (Region &region : op->getRegions()) {
+    for (Block &block : region) {
+      for (Operation &nestedOp : llvm::make_early_inc_range(block)) {
+        // Operations that aren't owned by the arena are destroyed as usual.
+        // Their nested operations and the values they use are still alive, so
+        // unlinking their uses is safe.
+        if (!nestedOp.isArenaAllocated) {
+          nestedOp.dropAllUses();
+          nestedOp.erase();
+          continue;
+        }
+        releaseResources(&nestedOp, /*releaseOp=*/true);
+      }
+
+      // The remaining operations are owned by the arena, leak them from the
+      // block so that they aren't destroyed one at a time. Only the uses of the
+      // block and its arguments need to be dropped before it is deleted.
+      block.getOperations().clearAndLeakNodesUnsafely();
+      block.dropAllUses();
+      for (BlockArgument arg : block.getArguments())
+        arg.dropAllUses();
+    }
+    region.getBlocks().clear();
+  }
+  if (!releaseOp)
+    return;
+
+  // Release the storage that lives outside of the arena, leaving the use lists
+  // of the values to be freed along with the arena.
+  if (op->hasOperandStorage)
+    op->getOperandStorage().releaseWithoutUnlinking();
+  if (op->propertiesStorageSize)
+    op->name.destroyOpProperties(op->getPropertiesStorage());
+}
+
+void OperationArena::destroyAndReset(Operation *root) {
+  assert(root->use_empty() && "expected root operation to have no uses");
+  if (root->isArenaAllocated) {
+    // The root may use values defined outside of the arena, so its own
+    // operands must be properly unlinked.
+    for (OpOperand &operand : root->getOpOperands())
+      operand.drop();
+    for (BlockOperand &successor : root->getBlockOperands())
+      successor.drop();
+    releaseResources(root, /*releaseOp=*/true);
+    if (Block *block = root->getBlock())
+      block->getOperations().remove(root);
+  } else {
+    releaseResources(root, /*releaseOp=*/false);
+    root->erase();
+  }
+  allocator.Reset();
+}
+
 //===----------------------------------------------------------------------===//
 // OpState trait class.
 //===----------------------------------------------------------------------===//
@@ -255,6 +255,13 @@ detail::OperandStorage::~OperandStorage() {
     free(operandStorage);
 }
 
+void detail::OperandStorage::releaseWithoutUnlinking() {
+  if (isStorageDynamic)
+    free(operandStorage);
+  numOperands = capacity = 0;
+  isStorageDynamic = false;
+}
+
 /// Replace the operands contained in the storage with the ones provided in
 /// 'values'.
 void detail::OperandStorage::setOperands(Operation *owner, ValueRange values) {
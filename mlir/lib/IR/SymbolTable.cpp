@@ -9,6 +9,7 @@
 #include "mlir/IR/SymbolTable.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/OpImplementation.h"
+#include "mlir/IR/Threading.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallString.h"
@@ -1025,6 +1026,83 @@ void SymbolUserMap::replaceAllUsesWith(Operation *symbol,
   }
 }
 
+//===----------------------------------------------------------------------===//
+// SymbolUseIndex
+//===----------------------------------------------------------------------===//
+
+SymbolUseIndex::SymbolUseIndex(SymbolTableCollection &symbolTable,
+                               Operation *symbolTableOp) {
+  // Collect the symbol tables to index, along with the operations directly
+  // nested within them.
+  SmallVector<Operation *> ops;
+  symbolTableOps.push_back(symbolTableOp);
+  for (unsigned i = 0; i < symbolTableOps.size(); ++i) {
+    for (Operation &op : symbolTableOps[i]->getRegion(0).getOps()) {
+      ops.push_back(&op);
+      if (op.hasTrait<OpTrait::SymbolTable>())
+        symbolTableOps.push_back(&op);
+    }
+  }
+
+  // Construct the symbol tables that aren't already in the collection up
+  // front, so that resolving the uses below only has to read the collection.
+  SmallVector<Operation *> missingSymbolTableOps;
+  for (Operation *op : symbolTableOps)
+    if (!symbolTable.symbolTables.count(op))
+      missingSymbolTableOps.push_back(op);
+  MLIRContext *context = symbolTableOp->getContext();
+  SmallVector<std::unique_ptr<SymbolTable>> newSymbolTables(
+      missingSymbolTableOps.size());
+  parallelFor(context, 0, missingSymbolTableOps.size(), [&](size_t i) {
+    newSymbolTables[i] =
+        std::make_unique<SymbolTable>(missingSymbolTableOps[i]);
+  });
+  for (auto [op, newSymbolTable] :
+       llvm::zip(missingSymbolTableOps, newSymbolTables))
+    symbolTable.symbolTables.try_emplace(op, std::move(newSymbolTable));
+
+  // Resolve the uses of each of the operations in parallel. The symbol tables
+  // of symbols referenced through nested references have all been built
+  // above, but use a locked collection to guard against any that haven't.
+  LockedSymbolTableCollection lockedSymbolTable(symbolTable);
+  std::vector<std::optional<SmallVector<Operation *, 2>>> opSymbols(ops.size());
+  parallelFor(context, 0, ops.size(), [&](size_t i) {
+    Operation *op = ops[i];
+    std::optional<SymbolTable::UseRange> uses = SymbolTable::getSymbolUses(op);
+    if (!uses)
+      return;
+
+    SetVector<Operation *, SmallVector<Operation *, 2>> referencedSymbols;
+    SmallVector<Operation *, 4> resolvedSymbols;
+    for (const SymbolTable::SymbolUse &use : *uses) {
+      resolvedSymbols.clear();
+      if (succeeded(lockedSymbolTable.lookupSymbolIn(
+              op->getParentOp(), use.getSymbolRef(), resolvedSymbols)))
+        referencedSymbols.insert(resolvedSymbols.begin(),
+                                 resolvedSymbols.end());
+    }
+    opSymbols[i] = referencedSymbols.takeVector();
+  });
+
+  // Populate the maps in order, keeping the use lists deterministic.
+  opToSymbols.reserve(ops.size());
+  for (auto [op, symbols] : llvm::zip(ops, opSymbols)) {
+    if (symbols)
+      for (Operation *symbol : *symbols)
+        symbolToUsers[symbol].push_back(op);
+    opToSymbols.try_emplace(op, std::move(symbols));
+  }
+}
+
+FailureOr<ArrayRef<Operation *>>
+SymbolUseIndex::getReferencedSymbols(Operation *op) const {
+  auto it = opToSymbols.find(op);
+  assert(it != opToSymbols.end() && "expected operation to be indexed");
+  if (!it->second)
+    return failure();
+  return ArrayRef<Operation *>(*it->second);
+}
+
 //===----------------------------------------------------------------------===//
 // Visibility parsing implementation.
 //===----------------------------------------------------------------------===//
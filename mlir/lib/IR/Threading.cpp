@@ -0,0 +1,81 @@
+//===- Threading.cpp - MLIR Threading Utilities ---------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/Threading.h"
+#include "llvm/ADT/DenseMap.h"
+#include <mutex>
+
+using namespace mlir;
+using namespace mlir::detail;
+
+/// The level of the tasks of the loops started on the current thread.
+static thread_local unsigned currentLevel =
+    static_cast<unsigned>(ParallelPriority::Default) *
+    ParallelTaskQueue::kNumDepths;
+
+/// Whether the current thread waits for the tasks of a loop.
+static thread_local bool isWaiting = false;
+
+//===----------------------------------------------------------------------===//
+// ParallelPriorityScope
+//===----------------------------------------------------------------------===//
+
+ParallelPriorityScope::ParallelPriorityScope(ParallelPriority priority)
+    : previousLevel(currentLevel) {
+  unsigned depth = currentLevel % ParallelTaskQueue::kNumDepths;
+  currentLevel =
+      static_cast<unsigned>(priority) * ParallelTaskQueue::kNumDepths + depth;
+}
+
+ParallelPriorityScope::~ParallelPriorityScope() {
+  currentLevel = previousLevel;
+}
+
+//===----------------------------------------------------------------------===//
+// ParallelTaskQueue
+//===----------------------------------------------------------------------===//
+
+ParallelTaskQueue &ParallelTaskQueue::get(llvm::ThreadPool &threadPool) {
+  // The queues are never destroyed, a pool allocated at the address of a
+  // destroyed one simply reuses its queue, which no longer tracks any task.
+  static std::mutex mutex;
+  static llvm::DenseMap<llvm::ThreadPool *, std::unique_ptr<ParallelTaskQueue>>
+      queues;
+  std::lock_guard<std::mutex> lock(mutex);
+  std::unique_ptr<ParallelTaskQueue> &queue = queues[&threadPool];
+  if (!queue)
+    queue = std::make_unique<ParallelTaskQueue>();
+  return *queue;
+}
+
+unsigned ParallelTaskQueue::getCurrentLevel() { return currentLevel; }
+
+bool ParallelTaskQueue::shouldYield(unsigned level) const {
+  if (isWaiting)
+    return false;
+  for (unsigned higherLevel = level + 1; higherLevel < kNumLevels;
+       ++higherLevel)
+    if (numQueued[higherLevel].load(std::memory_order_relaxed))
+      return true;
+  return false;
+}
+
+void ParallelTaskQueue::wait(llvm::ThreadPoolTaskGroup &group) {
+  bool wasWaiting = isWaiting;
+  isWaiting = true;
+  group.wait();
+  isWaiting = wasWaiting;
+}
+
+ParallelTaskQueue::TaskScope::TaskScope(unsigned level)
+    : previousLevel(currentLevel) {
+  unsigned depth = level % kNumDepths;
+  currentLevel = level - depth + std::min(depth + 1, kNumDepths - 1);
+}
+
+ParallelTaskQueue::TaskScope::~TaskScope() { currentLevel = previousLevel; }
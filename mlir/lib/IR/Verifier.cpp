@@ -31,6 +31,7 @@
 #include "mlir/IR/Operation.h"
 #include "mlir/IR/RegionKindInterface.h"
 #include "mlir/IR/Threading.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/PrettyStackTrace.h"
@@ -45,9 +46,11 @@ namespace {
 class OperationVerifier {
 public:
   /// If `verifyRecursively` is true, then this will also recursively verify
-  /// nested operations.
-  explicit OperationVerifier(bool verifyRecursively)
-      : verifyRecursively(verifyRecursively) {}
+  /// nested operations. If `scope` is provided, only the nested operations
+  /// within it are verified.
+  explicit OperationVerifier(bool verifyRecursively,
+                             const DenseSet<Operation *> *scope = nullptr)
+      : verifyRecursively(verifyRecursively), scope(scope) {}
 
   /// Verify the given operation.
   LogicalResult verifyOpAndDominance(Operation &op);
@@ -67,9 +70,16 @@ private:
   LogicalResult verifyDominanceOfContainedRegions(Operation &op,
                                                   DominanceInfo &domInfo);
 
+  /// Returns true if the given operation should be verified.
+  bool isInScope(Operation &op) const { return !scope || scope->contains(&op); }
+
   /// A flag indicating if this verifier should recursively verify nested
   /// operations.
   bool verifyRecursively;
+
+  /// An optional set of the operations to verify, other operations are assumed
+  /// to be valid.
+  const DenseSet<Operation *> *scope;
 };
 } // namespace
 
@@ -130,7 +140,7 @@ LogicalResult OperationVerifier::verifyBlock(
           "operation with block successors must terminate its parent block");
 
     // If we aren't verifying recursievly, there is nothing left to check.
-    if (!verifyRecursively)
+    if (!verifyRecursively || !isInScope(op))
       continue;
 
     // If this operation has regions and is IsolatedFromAbove, we defer
@@ -338,6 +348,9 @@ OperationVerifier::verifyDominanceOfContainedRegions(Operation &op,
       bool isReachable = domInfo.isReachableFromEntry(&block);
 
       for (Operation &op : block) {
+        if (!isInScope(op))
+          continue;
+
         if (isReachable) {
           // Check that operands properly dominate this use.
           for (const auto &operand : llvm::enumerate(op.getOperands())) {
@@ -375,3 +388,34 @@ LogicalResult mlir::verify(Operation *op, bool verifyRecursively) {
   OperationVerifier verifier(verifyRecursively);
   return verifier.verifyOpAndDominance(*op);
 }
+
+LogicalResult mlir::verifyIncrementally(Operation *root,
+                                        ArrayRef<Operation *> modifiedOps) {
+  // Collect the operations to verify. Any operation in the scope also has its
+  // ancestors up to `root` in the scope, which allows for stopping early when
+  // adding the ancestors of an operation.
+  DenseSet<Operation *> scope;
+  auto addWithAncestors = [&](Operation *op) {
+    for (; op != root && scope.insert(op).second; op = op->getParentOp())
+      ;
+  };
+  for (Operation *op : modifiedOps) {
+    if (op == root) {
+      scope.insert(root);
+      continue;
+    }
+    if (!root->isProperAncestor(op))
+      continue;
+    op->walk([&](Operation *nested) { scope.insert(nested); });
+    addWithAncestors(op->getParentOp());
+    for (Operation *user : op->getUsers())
+      if (root->isProperAncestor(user))
+        addWithAncestors(user);
+  }
+  if (scope.empty())
+    return success();
+
+  scope.insert(root);
+  OperationVerifier verifier(/*verifyRecursively=*/true, &scope);
+  return verifier.verifyOpAndDominance(*root);
+}
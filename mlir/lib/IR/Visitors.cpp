@@ -18,6 +18,127 @@ MutableArrayRef<Region> ForwardIterator::makeIterable(Operation &range) {
   return range.getRegions();
 }
 
+namespace {
+/// The position of an iterative walk within the regions of an operation.
+class OpWalkFrame {
+public:
+  explicit OpWalkFrame(Operation *op)
+      : op(op), regionIt(op->getRegions().begin()),
+        regionEnd(op->getRegions().end()) {}
+
+  /// Returns the operation whose regions are walked.
+  Operation *getOp() const { return op; }
+
+  /// Returns the next operation nested in the regions of the operation, or
+  /// null if all of them were visited. As in the recursive walks, the blocks
+  /// are advanced once all of their operations were visited, and the
+  /// operations are advanced before they are visited in case they are erased.
+  Operation *getNextOp() {
+    while (regionIt != regionEnd) {
+      if (!inRegion) {
+        blockIt = regionIt->begin();
+        inRegion = true;
+        inBlock = false;
+      }
+      if (blockIt == regionIt->end()) {
+        ++regionIt;
+        inRegion = false;
+        continue;
+      }
+      if (!inBlock) {
+        opIt = blockIt->begin();
+        inBlock = true;
+      }
+      if (opIt != blockIt->end())
+        return &*opIt++;
+      ++blockIt;
+      inBlock = false;
+    }
+    return nullptr;
+  }
+
+private:
+  Operation *op;
+  Region *regionIt, *regionEnd;
+  Region::iterator blockIt;
+  Block::iterator opIt;
+  bool inRegion = false, inBlock = false;
+};
+} // namespace
+
+namespace mlir {
+namespace detail {
+template <>
+void walk<ForwardIterator>(Operation *op,
+                           function_ref<void(Operation *)> callback,
+                           WalkOrder order) {
+  if (order == WalkOrder::PreOrder)
+    callback(op);
+  SmallVector<OpWalkFrame, 8> stack;
+  stack.emplace_back(op);
+  while (!stack.empty()) {
+    if (Operation *nestedOp = stack.back().getNextOp()) {
+      if (order == WalkOrder::PreOrder)
+        callback(nestedOp);
+      if (nestedOp->getNumRegions() != 0)
+        stack.emplace_back(nestedOp);
+      else if (order == WalkOrder::PostOrder)
+        callback(nestedOp);
+      continue;
+    }
+    Operation *finishedOp = stack.pop_back_val().getOp();
+    if (order == WalkOrder::PostOrder)
+      callback(finishedOp);
+  }
+}
+
+template <>
+WalkResult
+walk<ForwardIterator>(Operation *op,
+                      function_ref<WalkResult(Operation *)> callback,
+                      WalkOrder order) {
+  if (order == WalkOrder::PreOrder) {
+    WalkResult result = callback(op);
+    // If skipped, caller will continue the walk on the next operation.
+    if (result.wasSkipped())
+      return WalkResult::advance();
+    if (result.wasInterrupted())
+      return WalkResult::interrupt();
+  }
+  SmallVector<OpWalkFrame, 8> stack;
+  stack.emplace_back(op);
+  while (!stack.empty()) {
+    if (Operation *nestedOp = stack.back().getNextOp()) {
+      if (order == WalkOrder::PreOrder) {
+        WalkResult result = callback(nestedOp);
+        if (result.wasSkipped())
+          continue;
+        if (result.wasInterrupted())
+          return WalkResult::interrupt();
+      }
+      if (nestedOp->getNumRegions() != 0) {
+        stack.emplace_back(nestedOp);
+        continue;
+      }
+      if (order == WalkOrder::PostOrder &&
+          callback(nestedOp).wasInterrupted())
+        return WalkResult::interrupt();
+      continue;
+    }
+    Operation *finishedOp = stack.pop_back_val().getOp();
+    if (order != WalkOrder::PostOrder)
+      continue;
+    // The result of the walk is the result of the callback on `op`.
+    if (stack.empty())
+      return callback(finishedOp);
+    if (callback(finishedOp).wasInterrupted())
+      return WalkResult::interrupt();
+  }
+  return WalkResult::advance();
+}
+} // namespace detail
+} // namespace mlir
+
 void detail::walk(Operation *op,
                   function_ref<void(Operation *, const WalkStage &)> callback) {
   WalkStage stage(op);
@@ -42,6 +42,19 @@ static std::optional<int64_t> getConstantIntValue(OpFoldResult ofr) {
 ValueBoundsConstraintSet::ValueBoundsConstraintSet(MLIRContext *ctx)
     : builder(ctx) {}
 
+static Operation *getOwnerOfValue(Value value) {
+  if (auto bbArg = dyn_cast<BlockArgument>(value))
+    return bbArg.getOwner()->getParentOp();
+  return value.getDefiningOp();
+}
+
+void ValueBoundsConstraintSet::recordVisit(Value value) {
+  if (!visitedOps)
+    return;
+  if (Operation *owner = getOwnerOfValue(value))
+    visitedOps->insert(owner);
+}
+
 #ifndef NDEBUG
 static void assertValidValueDim(Value value, std::optional<int64_t> dim) {
   if (value.getType().isIndex()) {
@@ -76,6 +89,7 @@ AffineExpr ValueBoundsConstraintSet::getExpr(Value value,
 #ifndef NDEBUG
   assertValidValueDim(value, dim);
 #endif // NDEBUG
+  recordVisit(value);
 
   auto shapedType = dyn_cast<ShapedType>(value.getType());
   if (shapedType) {
@@ -117,6 +131,8 @@ int64_t ValueBoundsConstraintSet::insert(Value value,
   assertValidValueDim(value, dim);
 #endif // NDEBUG
 
+  recordVisit(value);
+
   ValueDim valueDim = std::make_pair(value, dim.value_or(kIndexValue));
   assert(!valueDimToPosition.contains(valueDim) && "already mapped");
   int64_t pos = isSymbol ? cstr.appendVar(VarKind::Symbol)
@@ -157,12 +173,6 @@ int64_t ValueBoundsConstraintSet::getPos(Value value,
   return it->second;
 }
 
-static Operation *getOwnerOfValue(Value value) {
-  if (auto bbArg = dyn_cast<BlockArgument>(value))
-    return bbArg.getOwner()->getParentOp();
-  return value.getDefiningOp();
-}
-
 void ValueBoundsConstraintSet::processWorklist(StopConditionFn stopCondition) {
   while (!worklist.empty()) {
     int64_t pos = worklist.front();
@@ -236,6 +246,14 @@ LogicalResult ValueBoundsConstraintSet::computeBound(
     AffineMap &resultMap, ValueDimList &mapOperands, presburger::BoundType type,
     Value value, std::optional<int64_t> dim, StopConditionFn stopCondition,
     bool closedUB) {
+  return computeBoundImpl(resultMap, mapOperands, type, value, dim,
+                          stopCondition, closedUB, /*visitedOps=*/nullptr);
+}
+
+LogicalResult ValueBoundsConstraintSet::computeBoundImpl(
+    AffineMap &resultMap, ValueDimList &mapOperands, presburger::BoundType type,
+    Value value, std::optional<int64_t> dim, StopConditionFn stopCondition,
+    bool closedUB, SmallPtrSetImpl<Operation *> *visitedOps) {
 #ifndef NDEBUG
   assertValidValueDim(value, dim);
   assert(!stopCondition(value, dim) &&
@@ -262,6 +280,7 @@ LogicalResult ValueBoundsConstraintSet::computeBound(
   // `stopCondition` is met.
   ValueDim valueDim = std::make_pair(value, dim.value_or(kIndexValue));
   ValueBoundsConstraintSet cstr(value.getContext());
+  cstr.visitedOps = visitedOps;
   int64_t pos = cstr.insert(value, dim, /*isSymbol=*/false);
   cstr.processWorklist(stopCondition);
 
@@ -436,8 +455,17 @@ FailureOr<int64_t> ValueBoundsConstraintSet::computeConstantBound(
 FailureOr<int64_t> ValueBoundsConstraintSet::computeConstantBound(
     presburger::BoundType type, AffineMap map, ValueDimList operands,
     StopConditionFn stopCondition, bool closedUB) {
+  return computeConstantBoundImpl(type, map, std::move(operands), stopCondition,
+                                  closedUB, /*visitedOps=*/nullptr);
+}
+
+FailureOr<int64_t> ValueBoundsConstraintSet::computeConstantBoundImpl(
+    presburger::BoundType type, AffineMap map, ValueDimList operands,
+    StopConditionFn stopCondition, bool closedUB,
+    SmallPtrSetImpl<Operation *> *visitedOps) {
   assert(map.getNumResults() == 1 && "expected affine map with one result");
   ValueBoundsConstraintSet cstr(map.getContext());
+  cstr.visitedOps = visitedOps;
   int64_t pos = cstr.insert(/*isSymbol=*/false);
 
   // Add map and operands to the constraint set. Dimensions are converted to
@@ -572,3 +600,152 @@ void ValueBoundsConstraintSet::BoundBuilder::operator>=(int64_t i) {
 void ValueBoundsConstraintSet::BoundBuilder::operator==(int64_t i) {
   operator==(cstr.getExpr(i));
 }
+
+//===----------------------------------------------------------------------===//
+// ValueBoundsCache
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// The kinds of the cached queries, which prefix their keys.
+enum class CachedQueryKind : uintptr_t { ConstantBound, DependentBound };
+} // namespace
+
+/// Append the given values/dimensions to a cache key.
+static void appendToKey(SmallVectorImpl<uintptr_t> &key,
+                        SmallVectorImpl<Value> &keyValues,
+                        const ValueDimList &valueDims) {
+  for (const auto &valueDim : valueDims) {
+    key.push_back(
+        reinterpret_cast<uintptr_t>(valueDim.first.getAsOpaquePointer()));
+    key.push_back(static_cast<uintptr_t>(valueDim.second.value_or(-1)));
+    keyValues.push_back(valueDim.first);
+  }
+}
+
+FailureOr<int64_t>
+ValueBoundsCache::computeConstantBound(presburger::BoundType type, Value value,
+                                       std::optional<int64_t> dim,
+                                       bool closedUB) {
+  AffineMap map =
+      AffineMap::get(/*dimCount=*/1, /*symbolCount=*/0,
+                     Builder(value.getContext()).getAffineDimExpr(0));
+  return computeConstantBound(type, map, {{value, dim}}, closedUB);
+}
+
+FailureOr<int64_t>
+ValueBoundsCache::computeConstantBound(presburger::BoundType type,
+                                       AffineMap map, ValueDimList mapOperands,
+                                       bool closedUB) {
+  SmallVector<uintptr_t> key = {
+      static_cast<uintptr_t>(CachedQueryKind::ConstantBound),
+      static_cast<uintptr_t>(type), closedUB,
+      reinterpret_cast<uintptr_t>(map.getAsOpaquePointer())};
+  SmallVector<Value> keyValues;
+  appendToKey(key, keyValues, mapOperands);
+
+  CachedBound bound = lookupOrCompute(
+      key, keyValues, [&](SmallPtrSetImpl<Operation *> &visitedOps) {
+        CachedBound bound;
+        FailureOr<int64_t> constant =
+            ValueBoundsConstraintSet::computeConstantBoundImpl(
+                type, map, mapOperands, /*stopCondition=*/nullptr, closedUB,
+                &visitedOps);
+        if (succeeded(constant)) {
+          bound.status = success();
+          bound.constant = *constant;
+        }
+        return bound;
+      });
+  if (failed(bound.status))
+    return failure();
+  return bound.constant;
+}
+
+FailureOr<bool> ValueBoundsCache::areEqual(Value value1, Value value2,
+                                           std::optional<int64_t> dim1,
+                                           std::optional<int64_t> dim2) {
+  Builder b(value1.getContext());
+  AffineMap map = AffineMap::get(/*dimCount=*/2, /*symbolCount=*/0,
+                                 b.getAffineDimExpr(0) - b.getAffineDimExpr(1));
+  FailureOr<int64_t> bound = computeConstantBound(
+      presburger::BoundType::EQ, map, {{value1, dim1}, {value2, dim2}});
+  if (failed(bound))
+    return failure();
+  return *bound == 0;
+}
+
+LogicalResult ValueBoundsCache::computeDependentBound(
+    AffineMap &resultMap, ValueDimList &mapOperands, presburger::BoundType type,
+    Value value, std::optional<int64_t> dim, ValueDimList dependencies,
+    bool closedUB) {
+  SmallVector<uintptr_t> key = {
+      static_cast<uintptr_t>(CachedQueryKind::DependentBound),
+      static_cast<uintptr_t>(type), closedUB};
+  SmallVector<Value> keyValues;
+  appendToKey(key, keyValues, {{value, dim}});
+  appendToKey(key, keyValues, dependencies);
+
+  CachedBound bound = lookupOrCompute(
+      key, keyValues, [&](SmallPtrSetImpl<Operation *> &visitedOps) {
+        CachedBound bound;
+        bound.status = ValueBoundsConstraintSet::computeBoundImpl(
+            bound.map, bound.mapOperands, type, value, dim,
+            [&](Value v, std::optional<int64_t> d) {
+              return llvm::is_contained(dependencies, std::make_pair(v, d));
+            },
+            closedUB, &visitedOps);
+        return bound;
+      });
+  resultMap = bound.map;
+  mapOperands = std::move(bound.mapOperands);
+  return bound.status;
+}
+
+ValueBoundsCache::CachedBound ValueBoundsCache::lookupOrCompute(
+    ArrayRef<uintptr_t> key, ArrayRef<Value> keyValues,
+    function_ref<CachedBound(SmallPtrSetImpl<Operation *> &)> compute) {
+  auto it = bounds.find(key);
+  if (it != bounds.end()) {
+    ++numHits;
+    return it->second;
+  }
+  ++numMisses;
+
+  // The bound also depends on the ops of the queried values, which may be
+  // constants not visited otherwise.
+  SmallPtrSet<Operation *, 16> visitedOps;
+  for (Value value : keyValues)
+    if (Operation *owner = getOwnerOfValue(value))
+      visitedOps.insert(owner);
+  CachedBound bound = compute(visitedOps);
+
+  uintptr_t *storage = allocator.Allocate<uintptr_t>(key.size());
+  llvm::copy(key, storage);
+  Key ownedKey(storage, key.size());
+  bounds.try_emplace(ownedKey, bound);
+  for (Operation *op : visitedOps)
+    keysByOp[op].push_back(ownedKey);
+  return bound;
+}
+
+void ValueBoundsCache::invalidate(Operation *op) {
+  auto it = keysByOp.find(op);
+  if (it == keysByOp.end())
+    return;
+  // The keys of the bounds invalidated through another op may be stale, and
+  // may match a bound recomputed since, which is then conservatively dropped.
+  for (Key key : it->second)
+    bounds.erase(key);
+  keysByOp.erase(it);
+}
+
+void ValueBoundsCache::notifyOperationRemoved(Operation *op) {
+  // The nested ops are erased as well, and their addresses may be reused.
+  op->walk([&](Operation *nestedOp) { invalidate(nestedOp); });
+}
+
+void ValueBoundsCache::clear() {
+  bounds.clear();
+  keysByOp.clear();
+  allocator.Reset();
+}
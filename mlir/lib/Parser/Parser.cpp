@@ -13,10 +13,28 @@
 #include "mlir/Parser/Parser.h"
 #include "mlir/AsmParser/AsmParser.h"
 #include "mlir/Bytecode/BytecodeReader.h"
+#include "mlir/Support/FileUtilities.h"
+#include "llvm/Support/Alignment.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
 
 using namespace mlir;
 
+std::unique_ptr<llvm::MemoryBuffer>
+mlir::openSourceFile(llvm::StringRef filename, std::string *errorMessage,
+                     std::optional<llvm::Align> alignment) {
+  // Stdin can't be reopened, so it is always read as text.
+  if (filename != "-") {
+    std::unique_ptr<llvm::MemoryBuffer> buffer =
+        openInputFileForMapping(filename, alignment, errorMessage);
+    if (!buffer || isBytecode(*buffer))
+      return buffer;
+  }
+  if (alignment)
+    return openInputFile(filename, *alignment, errorMessage);
+  return openInputFile(filename, errorMessage);
+}
+
 LogicalResult mlir::parseSourceFile(const llvm::SourceMgr &sourceMgr,
                                     Block *block, const ParserConfig &config,
                                     LocationAttr *sourceFileLoc) {
@@ -61,13 +79,13 @@ static LogicalResult loadSourceFileBuffer(llvm::StringRef filename,
     return emitError(mlir::UnknownLoc::get(ctx),
                      "only main buffer parsed at the moment");
   }
-  auto fileOrErr = llvm::MemoryBuffer::getFileOrSTDIN(filename);
-  if (std::error_code error = fileOrErr.getError())
+  std::unique_ptr<llvm::MemoryBuffer> buffer = openSourceFile(filename);
+  if (!buffer)
     return emitError(mlir::UnknownLoc::get(ctx),
                      "could not open input file " + filename);
 
   // Load the MLIR source file.
-  sourceMgr.AddNewSourceBuffer(std::move(*fileOrErr), SMLoc());
+  sourceMgr.AddNewSourceBuffer(std::move(buffer), SMLoc());
   return success();
 }
 
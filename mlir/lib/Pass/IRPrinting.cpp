@@ -7,10 +7,16 @@
 //===----------------------------------------------------------------------===//
 
 #include "PassDetail.h"
+#include "mlir/Bytecode/BytecodeWriter.h"
 #include "mlir/IR/SymbolTable.h"
 #include "mlir/Pass/PassManager.h"
+#include "mlir/Support/FileUtilities.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include <atomic>
 
 using namespace mlir;
 using namespace mlir::detail;
@@ -23,7 +29,15 @@ namespace {
 class IRPrinterInstrumentation : public PassInstrumentation {
 public:
   IRPrinterInstrumentation(std::unique_ptr<PassManager::IRPrinterConfig> config)
-      : config(std::move(config)) {}
+      : config(std::move(config)) {
+    if (this->config->shouldPrintAsynchronously())
+      printThreadPool =
+          std::make_unique<llvm::ThreadPool>(llvm::hardware_concurrency(1));
+  }
+  ~IRPrinterInstrumentation() override {
+    if (printThreadPool)
+      printThreadPool->wait();
+  }
 
 private:
   /// Instrumentation hooks.
@@ -31,9 +45,23 @@ private:
   void runAfterPass(Pass *pass, Operation *op) override;
   void runAfterPassFailed(Pass *pass, Operation *op) override;
 
+  /// Print the IR of `op` to `out` after `title`, or write it to a bytecode
+  /// file named after `pass` and `kind` if the config asked for bytecode. The
+  /// IR is printed from a clone on the printing thread if the config asked for
+  /// asynchronous printing.
+  void printIR(Operation *op, raw_ostream &out, const Twine &title, Pass *pass,
+               StringRef kind, OpPrintingFlags flags);
+
   /// Configuration to use.
   std::unique_ptr<PassManager::IRPrinterConfig> config;
 
+  /// The thread printing the IR, if the config asked for asynchronous printing.
+  /// A single thread keeps the dumps in order.
+  std::unique_ptr<llvm::ThreadPool> printThreadPool;
+
+  /// The number of dumps, used to name the bytecode files in pipeline order.
+  std::atomic<unsigned> numDumps = 0;
+
   /// The following is a set of fingerprints for operations that are currently
   /// being operated on in a pass. This field is only used when the
   /// configuration asked for change detection.
@@ -41,25 +69,75 @@ private:
 };
 } // namespace
 
-static void printIR(Operation *op, bool printModuleScope, raw_ostream &out,
-                    OpPrintingFlags flags) {
-  // Otherwise, check to see if we are not printing at module scope.
-  if (!printModuleScope)
-    return op->print(out << " //----- //\n",
-                     op->getBlock() ? flags.useLocalScope() : flags);
-
-  // Otherwise, we are printing at module scope.
-  out << " ('" << op->getName() << "' operation";
-  if (auto symbolName =
-          op->getAttrOfType<StringAttr>(SymbolTable::getSymbolAttrName()))
-    out << ": @" << symbolName.getValue();
-  out << ") //----- //\n";
-
-  // Find the top-level operation.
-  auto *topLevelOp = op;
-  while (auto *parentOp = topLevelOp->getParentOp())
-    topLevelOp = parentOp;
-  topLevelOp->print(out, flags);
+void IRPrinterInstrumentation::printIR(Operation *op, raw_ostream &out,
+                                       const Twine &title, Pass *pass,
+                                       StringRef kind, OpPrintingFlags flags) {
+  std::string header;
+  llvm::raw_string_ostream headerOS(header);
+  headerOS << title;
+
+  // Check to see if we are not printing at module scope.
+  Operation *printedOp = op;
+  if (!config->shouldPrintAtModuleScope()) {
+    if (op->getBlock())
+      flags.useLocalScope();
+  } else {
+    // Otherwise, we are printing at module scope.
+    headerOS << " ('" << op->getName() << "' operation";
+    if (auto symbolName =
+            op->getAttrOfType<StringAttr>(SymbolTable::getSymbolAttrName()))
+      headerOS << ": @" << symbolName.getValue();
+    headerOS << ")";
+
+    // Find the top-level operation.
+    while (auto *parentOp = printedOp->getParentOp())
+      printedOp = parentOp;
+  }
+  headerOS << " //----- //\n";
+
+  // Name the bytecode file after the position of the dump in the pipeline.
+  std::string bytecodeFile;
+  if (!config->getBytecodeDirectory().empty()) {
+    SmallString<128> path(config->getBytecodeDirectory());
+    llvm::sys::path::append(path, formatv("{0:d4}_{1}_{2}.mlirbc", numDumps++,
+                                          kind, pass->getArgument()));
+    bytecodeFile = std::string(path);
+  }
+
+  auto print = [header = headerOS.str(), bytecodeFile, flags,
+                os = &out](Operation *printedOp) {
+    raw_ostream &out = *os;
+    out << header;
+    if (bytecodeFile.empty()) {
+      printedOp->print(out, flags);
+      out << "\n\n";
+      return;
+    }
+
+    std::string error;
+    std::unique_ptr<llvm::ToolOutputFile> file =
+        openOutputFile(bytecodeFile, &error);
+    if (!file) {
+      out << "// failed to write the IR: " << error << "\n\n";
+      return;
+    }
+    if (failed(writeBytecodeToFile(printedOp, file->os()))) {
+      out << "// failed to write the IR to '" << bytecodeFile << "'\n\n";
+      return;
+    }
+    file->keep();
+    out << "// written to '" << bytecodeFile << "'\n\n";
+  };
+  if (!printThreadPool)
+    return print(printedOp);
+
+  // Cloning is much cheaper than printing, and lets the pipeline carry on
+  // transforming the IR while the clone is printed.
+  Operation *clone = printedOp->clone();
+  printThreadPool->async([print, clone] {
+    print(clone);
+    clone->erase();
+  });
 }
 
 /// Instrumentation hooks.
@@ -71,11 +149,10 @@ void IRPrinterInstrumentation::runBeforePass(Pass *pass, Operation *op) {
     beforePassFingerPrints.try_emplace(pass, op);
 
   config->printBeforeIfEnabled(pass, op, [&](raw_ostream &out) {
-    out << "// -----// IR Dump Before " << pass->getName() << " ("
-        << pass->getArgument() << ")";
-    printIR(op, config->shouldPrintAtModuleScope(), out,
-            config->getOpPrintingFlags());
-    out << "\n\n";
+    printIR(op, out,
+            "// -----// IR Dump Before " + pass->getName() + " (" +
+                pass->getArgument() + ")",
+            pass, "before", config->getOpPrintingFlags());
   });
 }
 
@@ -102,11 +179,10 @@ void IRPrinterInstrumentation::runAfterPass(Pass *pass, Operation *op) {
   }
 
   config->printAfterIfEnabled(pass, op, [&](raw_ostream &out) {
-    out << "// -----// IR Dump After " << pass->getName() << " ("
-        << pass->getArgument() << ")";
-    printIR(op, config->shouldPrintAtModuleScope(), out,
-            config->getOpPrintingFlags());
-    out << "\n\n";
+    printIR(op, out,
+            "// -----// IR Dump After " + pass->getName() + " (" +
+                pass->getArgument() + ")",
+            pass, "after", config->getOpPrintingFlags());
   });
 }
 
@@ -117,11 +193,16 @@ void IRPrinterInstrumentation::runAfterPassFailed(Pass *pass, Operation *op) {
     beforePassFingerPrints.erase(pass);
 
   config->printAfterIfEnabled(pass, op, [&](raw_ostream &out) {
-    out << formatv("// -----// IR Dump After {0} Failed ({1})", pass->getName(),
-                   pass->getArgument());
-    printIR(op, config->shouldPrintAtModuleScope(), out, OpPrintingFlags());
-    out << "\n\n";
+    printIR(op, out,
+            formatv("// -----// IR Dump After {0} Failed ({1})",
+                    pass->getName(), pass->getArgument()),
+            pass, "failed", OpPrintingFlags());
   });
+
+  // Make sure that the IR of the failure is printed before the pipeline
+  // reports it.
+  if (printThreadPool)
+    printThreadPool->wait();
 }
 
 //===----------------------------------------------------------------------===//
@@ -132,11 +213,15 @@ void IRPrinterInstrumentation::runAfterPassFailed(Pass *pass, Operation *op) {
 PassManager::IRPrinterConfig::IRPrinterConfig(bool printModuleScope,
                                               bool printAfterOnlyOnChange,
                                               bool printAfterOnlyOnFailure,
-                                              OpPrintingFlags opPrintingFlags)
+                                              OpPrintingFlags opPrintingFlags,
+                                              bool printAsynchronously,
+                                              StringRef bytecodeDirectory)
     : printModuleScope(printModuleScope),
       printAfterOnlyOnChange(printAfterOnlyOnChange),
       printAfterOnlyOnFailure(printAfterOnlyOnFailure),
-      opPrintingFlags(opPrintingFlags) {}
+      opPrintingFlags(opPrintingFlags),
+      printAsynchronously(printAsynchronously),
+      bytecodeDirectory(bytecodeDirectory.str()) {}
 PassManager::IRPrinterConfig::~IRPrinterConfig() = default;
 
 /// A hook that may be overridden by a derived config that checks if the IR
@@ -169,9 +254,10 @@ struct BasicIRPrinterConfig : public PassManager::IRPrinterConfig {
       std::function<bool(Pass *, Operation *)> shouldPrintAfterPass,
       bool printModuleScope, bool printAfterOnlyOnChange,
       bool printAfterOnlyOnFailure, OpPrintingFlags opPrintingFlags,
-      raw_ostream &out)
+      bool printAsynchronously, StringRef bytecodeDirectory, raw_ostream &out)
       : IRPrinterConfig(printModuleScope, printAfterOnlyOnChange,
-                        printAfterOnlyOnFailure, opPrintingFlags),
+                        printAfterOnlyOnFailure, opPrintingFlags,
+                        printAsynchronously, bytecodeDirectory),
         shouldPrintBeforePass(std::move(shouldPrintBeforePass)),
         shouldPrintAfterPass(std::move(shouldPrintAfterPass)), out(out) {
     assert((this->shouldPrintBeforePass || this->shouldPrintAfterPass) &&
@@ -216,9 +302,10 @@ void PassManager::enableIRPrinting(
     std::function<bool(Pass *, Operation *)> shouldPrintAfterPass,
     bool printModuleScope, bool printAfterOnlyOnChange,
     bool printAfterOnlyOnFailure, raw_ostream &out,
-    OpPrintingFlags opPrintingFlags) {
+    OpPrintingFlags opPrintingFlags, bool printAsynchronously,
+    StringRef bytecodeDirectory) {
   enableIRPrinting(std::make_unique<BasicIRPrinterConfig>(
       std::move(shouldPrintBeforePass), std::move(shouldPrintAfterPass),
       printModuleScope, printAfterOnlyOnChange, printAfterOnlyOnFailure,
-      opPrintingFlags, out));
+      opPrintingFlags, printAsynchronously, bytecodeDirectory, out));
 }
@@ -12,17 +12,23 @@
 
 #include "mlir/Pass/Pass.h"
 #include "PassDetail.h"
+#include "mlir/Bytecode/BytecodeReader.h"
+#include "mlir/Bytecode/BytecodeWriter.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/Dialect.h"
+#include "mlir/IR/ModifiedOpsListener.h"
 #include "mlir/IR/OpDefinition.h"
 #include "mlir/IR/Threading.h"
 #include "mlir/IR/Verifier.h"
 #include "mlir/Support/FileUtilities.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/CrashRecoveryContext.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Mutex.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
@@ -48,6 +54,14 @@ void PassExecutionAction::print(raw_ostream &os) const {
 /// single .o file.
 void Pass::anchor() {}
 
+ModifiedOpsListener &Pass::getModifiedOpsListener() {
+  std::shared_ptr<ModifiedOpsListener> &listener =
+      getPassState().modifiedOpsListener;
+  if (!listener)
+    listener = std::make_shared<ModifiedOpsListener>();
+  return *listener;
+}
+
 /// Attempt to initialize the options of this pass from the given string.
 LogicalResult Pass::initializeOptions(StringRef options) {
   return passOptions.parseFromString(options);
@@ -99,7 +113,8 @@ struct OpPassManagerImpl {
   OpPassManagerImpl(const OpPassManagerImpl &rhs)
       : name(rhs.name), opName(rhs.opName),
         initializationGeneration(rhs.initializationGeneration),
-        nesting(rhs.nesting) {
+        nesting(rhs.nesting), pipelineCache(rhs.pipelineCache),
+        pipelineCacheKey(rhs.pipelineCacheKey) {
     for (const std::unique_ptr<Pass> &pass : rhs.passes) {
       std::unique_ptr<Pass> newPass = pass->clone();
       newPass->threadingSibling = pass.get();
@@ -175,6 +190,11 @@ struct OpPassManagerImpl {
   /// Control the implicit nesting of passes that mismatch the name set for this
   /// OpPassManager.
   OpPassManager::Nesting nesting;
+
+  /// An optional cache for the results of this pass manager, and the textual
+  /// form of its pipeline used to key the entries of the cache.
+  PassPipelineCache *pipelineCache = nullptr;
+  std::string pipelineCacheKey;
 };
 } // namespace detail
 } // namespace mlir
@@ -505,13 +525,23 @@ LogicalResult OpToOpPassAdaptor::run(Pass *pass, Operation *op,
     //
     //  1) If the pass said that it preserved all analyses then it can't have
     //     permuted the IR.
+    //  2) If the pass recorded the operations it modified, then only the IR
+    //     that may have been invalidated by these modifications needs to be
+    //     re-verified.
     //
     // We run these checks in EXPENSIVE_CHECKS mode out of caution.
+    bool runVerifierIncrementally = false;
 #ifndef EXPENSIVE_CHECKS
     runVerifierNow = !pass->passState->preservedAnalyses.isAll();
+    runVerifierIncrementally =
+        runVerifierRecursively && pass->passState->modifiedOpsListener;
 #endif
-    if (runVerifierNow)
+    if (runVerifierNow && runVerifierIncrementally) {
+      ModifiedOpsListener &listener = *pass->passState->modifiedOpsListener;
+      passFailed = failed(verifyIncrementally(op, listener.getModifiedOps()));
+    } else if (runVerifierNow) {
       passFailed = failed(verify(op, runVerifierRecursively));
+    }
   }
 
   // Instrument after the pass has run.
@@ -526,6 +556,69 @@ LogicalResult OpToOpPassAdaptor::run(Pass *pass, Operation *op,
   return failure(passFailed);
 }
 
+/// Compute the key of the pipeline cache entry holding the result of running
+/// `pm` on `op`, or an empty string if the result of `op` can't be cached.
+static std::string getPipelineCacheKey(OpPassManager &pm, Operation *op) {
+  // Only operations that are isolated from above and don't use any values can
+  // be encoded on their own.
+  if (op->getNumOperands() != 0 || op->getNumSuccessors() != 0 ||
+      !op->hasTrait<OpTrait::IsIsolatedFromAbove>())
+    return "";
+
+  std::string bytecode;
+  llvm::raw_string_ostream os(bytecode);
+  if (failed(writeBytecodeToFile(op, os)))
+    return "";
+  os.flush();
+
+  llvm::SHA1 hasher;
+  hasher.update(pm.getImpl().pipelineCacheKey);
+  hasher.update(StringRef("\0", 1));
+  hasher.update(bytecode);
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+/// Try to replace the body of `op` with the cached result of running a
+/// pipeline on it, returning failure if there is no valid entry for `key`.
+static LogicalResult loadCachedPipelineResult(PassPipelineCache &cache,
+                                              StringRef key, Operation *op) {
+  std::unique_ptr<llvm::MemoryBuffer> entry = cache.lookup(key);
+  if (!entry)
+    return failure();
+
+  Block block;
+  ParserConfig config(op->getContext(), /*verifyAfterParse=*/false);
+  if (failed(readBytecodeFile(entry->getMemBufferRef(), &block, config)))
+    return failure();
+
+  // Check that the entry holds an operation of the same shape, which clients
+  // of `op` can't observe the replacement of.
+  Operation *result = block.empty() ? nullptr : &block.front();
+  if (!result || !llvm::hasSingleElement(block) ||
+      result->getName() != op->getName() ||
+      result->getNumRegions() != op->getNumRegions() ||
+      !llvm::equal(result->getResultTypes(), op->getResultTypes()))
+    return failure();
+
+  op->setLoc(result->getLoc());
+  op->setDiscardableAttrs(result->getDiscardableAttrDictionary());
+  if (op->getPropertiesStorage())
+    op->copyProperties(result->getPropertiesStorage());
+  for (auto [region, cachedRegion] :
+       llvm::zip(op->getRegions(), result->getRegions()))
+    region.takeBody(cachedRegion);
+  return success();
+}
+
+/// Store the result of running a pipeline on `op` within the cache.
+static void storePipelineResult(PassPipelineCache &cache, StringRef key,
+                                Operation *op) {
+  std::string bytecode;
+  llvm::raw_string_ostream os(bytecode);
+  if (succeeded(writeBytecodeToFile(op, os)))
+    cache.insert(key, os.str());
+}
+
 /// Run the given operation and analysis manager on a provided op pass manager.
 LogicalResult OpToOpPassAdaptor::runPipeline(
     OpPassManager &pm, Operation *op, AnalysisManager am, bool verifyPasses,
@@ -547,9 +640,20 @@ LogicalResult OpToOpPassAdaptor::runPipeline(
                                     *parentInfo);
   }
 
-  for (Pass &pass : pm.getPasses())
-    if (failed(run(&pass, op, am, verifyPasses, parentInitGeneration)))
-      return failure();
+  // If the pipeline has a cache, check if it already holds the result of
+  // running on the operation.
+  PassPipelineCache *cache = pm.getImpl().pipelineCache;
+  std::string cacheKey;
+  if (cache)
+    cacheKey = getPipelineCacheKey(pm, op);
+  if (cacheKey.empty() ||
+      failed(loadCachedPipelineResult(*cache, cacheKey, op))) {
+    for (Pass &pass : pm.getPasses())
+      if (failed(run(&pass, op, am, verifyPasses, parentInitGeneration)))
+        return failure();
+    if (!cacheKey.empty())
+      storePipelineResult(*cache, cacheKey, op);
+  }
 
   if (instrumentor) {
     instrumentor->runAfterPipeline(pm.getOpName(*op->getContext()),
@@ -777,8 +881,29 @@ void OpToOpPassAdaptor::runOnOperationAsyncImpl(bool verifyPasses) {
     return pipelineResult;
   };
 
+  // If there are more operations than executors, start the processing of the
+  // operations largest-first. Otherwise, a large operation that appears late
+  // in the IR may end up running alone after all of the others have finished,
+  // and dominate the wall time. The number of nested operations is used as a
+  // cheap estimate of the cost of running the pipeline on an operation.
+  SmallVector<unsigned> schedule;
+  if (opInfos.size() > asyncExecutors.size()) {
+    SmallVector<size_t> costs;
+    costs.reserve(opInfos.size());
+    for (OpPMInfo &opInfo : opInfos) {
+      size_t cost = 0;
+      opInfo.op->walk([&](Operation *) { ++cost; });
+      costs.push_back(cost);
+    }
+    schedule = llvm::to_vector(llvm::seq<unsigned>(0, opInfos.size()));
+    llvm::stable_sort(schedule, [&](unsigned lhs, unsigned rhs) {
+      return costs[lhs] > costs[rhs];
+    });
+  }
+
   // Signal a failure if any of the executors failed.
-  if (failed(failableParallelForEach(context, opInfos, processFn)))
+  if (failed(failableParallelForEach(context, opInfos.begin(), opInfos.end(),
+                                     schedule, processFn)))
     signalPassFailure();
 }
 
@@ -800,8 +925,13 @@ PassManager::~PassManager() = default;
 
 void PassManager::enableVerifier(bool enabled) { verifyPasses = enabled; }
 
+void PassManager::enablePipelineCache(
+    std::shared_ptr<PassPipelineCache> cache) {
+  pipelineCache = std::move(cache);
+}
+
 /// Run the passes within this manager on the provided operation.
-LogicalResult PassManager::run(Operation *op) {
+LogicalResult PassManager::initializeForRun(Operation *op) {
   MLIRContext *context = getContext();
   std::optional<OperationName> anchorOp = getOpName(*context);
   if (anchorOp && anchorOp != op->getName())
@@ -820,6 +950,28 @@ LogicalResult PassManager::run(Operation *op) {
   if (failed(getImpl().finalizePassList(context)))
     return failure();
 
+  // Propagate the pipeline cache to the nested pass managers, including the
+  // ones already cloned for parallel execution.
+  auto setPipelineCache = [&](OpPassManager &pm) {
+    OpPassManagerImpl &pmImpl = pm.getImpl();
+    pmImpl.pipelineCache = pipelineCache.get();
+    pmImpl.pipelineCacheKey.clear();
+    if (pipelineCache) {
+      llvm::raw_string_ostream os(pmImpl.pipelineCacheKey);
+      pm.printAsTextualPipeline(os);
+    }
+  };
+  for (Pass &pass : getPasses()) {
+    auto *adaptor = dyn_cast<OpToOpPassAdaptor>(&pass);
+    if (!adaptor)
+      continue;
+    for (OpPassManager &pm : adaptor->getPassManagers())
+      setPipelineCache(pm);
+    for (auto &executor : adaptor->getParallelPassManagers())
+      for (OpPassManager &pm : executor)
+        setPipelineCache(pm);
+  }
+
   // Initialize all of the passes within the pass manager with a new generation.
   llvm::hash_code newInitKey = context->getRegistryHash();
   if (newInitKey != initializationKey) {
@@ -827,6 +979,12 @@ LogicalResult PassManager::run(Operation *op) {
       return failure();
     initializationKey = newInitKey;
   }
+  return success();
+}
+
+LogicalResult PassManager::run(Operation *op) {
+  if (failed(initializeForRun(op)))
+    return failure();
 
   // Construct a top level analysis manager for the pipeline.
   ModuleAnalysisManager am(op, instrumentor.get());
@@ -848,6 +1006,90 @@ LogicalResult PassManager::run(Operation *op) {
   return result;
 }
 
+LogicalResult
+PassManager::runStreaming(Operation *op,
+                          function_ref<LogicalResult(Operation *)> prepare,
+                          function_ref<LogicalResult(Operation *)> release) {
+  if (failed(initializeForRun(op)))
+    return failure();
+
+  // Streaming only supports pipelines that are entirely nested, as the passes
+  // are run on a single nested operation at a time.
+  for (Pass &pass : getPasses()) {
+    if (!isa<OpToOpPassAdaptor>(&pass))
+      return emitError(op->getLoc())
+             << "streaming execution requires a pipeline of nested pass "
+                "managers, but found '"
+             << pass.getName() << "' anchored on '" << getOpAnchorName()
+             << "'";
+  }
+
+  // Construct a top level analysis manager for the pipeline.
+  ModuleAnalysisManager am(op, instrumentor.get());
+
+  // Notify the context that we start running a pipeline for book keeping.
+  MLIRContext *context = getContext();
+  context->enterMultiThreadedExecution();
+  LogicalResult result = runStreamingPasses(op, am, prepare, release);
+  context->exitMultiThreadedExecution();
+
+  // Dump all of the pass statistics if necessary.
+  if (passStatisticsMode)
+    dumpStatistics();
+  return result;
+}
+
+LogicalResult PassManager::runStreamingPasses(
+    Operation *op, AnalysisManager am,
+    function_ref<LogicalResult(Operation *)> prepare,
+    function_ref<LogicalResult(Operation *)> release) {
+  MLIRContext &context = *getContext();
+  PassInstrumentor *pi = am.getPassInstrumentor();
+  unsigned initGeneration = impl->initializationGeneration;
+  for (Region &region : op->getRegions()) {
+    for (Block &block : region) {
+      for (Operation &nestedOp : llvm::make_early_inc_range(block)) {
+        if (prepare && failed(prepare(&nestedOp)))
+          return failure();
+
+        // Run each of the nested pipelines that can be scheduled on the
+        // operation, in the order they appear within the pipeline.
+        AnalysisManager nestedAm = am.nest(&nestedOp);
+        for (Pass &pass : getPasses()) {
+          auto &adaptor = cast<OpToOpPassAdaptor>(pass);
+          OpPassManager *mgr = findPassManagerFor(
+              adaptor.getPassManagers(), nestedOp.getName(), context);
+          if (!mgr)
+            continue;
+
+          if (pi)
+            pi->runBeforePass(&adaptor, op);
+          PassInstrumentation::PipelineParentInfo parentInfo = {
+              llvm::get_threadid(), &adaptor};
+          LogicalResult result = OpToOpPassAdaptor::runPipeline(
+              *mgr, &nestedOp, nestedAm, verifyPasses, initGeneration, pi,
+              &parentInfo);
+          if (pi) {
+            if (failed(result))
+              pi->runAfterPassFailed(&adaptor, op);
+            else
+              pi->runAfterPass(&adaptor, op);
+          }
+          if (failed(result))
+            return failure();
+        }
+
+        // Drop the analyses computed on the operation before releasing it, as
+        // they may hold references into it.
+        am.clear();
+        if (release && failed(release(&nestedOp)))
+          return failure();
+      }
+    }
+  }
+  return success();
+}
+
 /// Add the provided instrumentation to the pass manager.
 void PassManager::addInstrumentation(std::unique_ptr<PassInstrumentation> pi) {
   if (!instrumentor)
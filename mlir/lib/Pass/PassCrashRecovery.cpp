@@ -9,6 +9,7 @@
 #include "PassDetail.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/Dialect.h"
+#include "mlir/IR/FunctionInterfaces.h"
 #include "mlir/IR/SymbolTable.h"
 #include "mlir/IR/Verifier.h"
 #include "mlir/Parser/Parser.h"
@@ -23,6 +24,8 @@
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
+#include <atomic>
+#include <mutex>
 
 using namespace mlir;
 using namespace mlir::detail;
@@ -37,7 +40,9 @@ namespace detail {
 /// Each recovery context is registered globally to allow for generating
 /// reproducers when a signal is raised, such as a segfault.
 struct RecoveryReproducerContext {
-  RecoveryReproducerContext(std::string passPipelineStr, Operation *op,
+  /// Create a context for a reproducer of `passPipelineStr` on `snapshot`, a
+  /// detached operation owned by the context.
+  RecoveryReproducerContext(std::string passPipelineStr, Operation *snapshot,
                             PassManager::ReproducerStreamFactory &streamFactory,
                             bool verifyPasses);
   ~RecoveryReproducerContext();
@@ -91,11 +96,11 @@ llvm::ManagedStatic<llvm::SmallSetVector<RecoveryReproducerContext *, 1>>
     RecoveryReproducerContext::reproducerSet;
 
 RecoveryReproducerContext::RecoveryReproducerContext(
-    std::string passPipelineStr, Operation *op,
+    std::string passPipelineStr, Operation *snapshot,
     PassManager::ReproducerStreamFactory &streamFactory, bool verifyPasses)
     : pipelineElements(std::move(passPipelineStr)),
-      preCrashOperation(op->clone()), streamFactory(streamFactory),
-      disableThreads(!op->getContext()->isMultithreadingEnabled()),
+      preCrashOperation(snapshot), streamFactory(streamFactory),
+      disableThreads(!snapshot->getContext()->isMultithreadingEnabled()),
       verifyPasses(verifyPasses) {
   enable();
 }
@@ -186,12 +191,41 @@ struct PassCrashReproducerGenerator::Impl {
   /// failing pass.
   bool localReproducer = false;
 
-  /// A record of all of the currently active reproducer contexts.
-  SmallVector<std::unique_ptr<RecoveryReproducerContext>> activeContexts;
+  /// The reproducer contexts and the passes running on a thread.
+  struct ThreadState {
+    /// A record of all of the currently active reproducer contexts. When
+    /// `localReproducer` is true, each running pass gets its own context.
+    SmallVector<std::unique_ptr<RecoveryReproducerContext>> activeContexts;
 
-  /// The set of all currently running passes. Note: This is not populated when
-  /// `localReproducer` is true, as each pass will get its own recovery context.
-  SetVector<std::pair<Pass *, Operation *>> runningPasses;
+    /// The set of all currently running passes.
+    SetVector<std::pair<Pass *, Operation *>> runningPasses;
+  };
+
+  /// Returns the state of the current thread. The threads share a single state
+  /// when `localReproducer` is false, as there is a single reproducer context
+  /// for the whole pipeline.
+  ThreadState &getThreadState() {
+    return threadStates[localReproducer ? llvm::get_threadid() : 0];
+  }
+
+  /// Returns true if there are no active reproducer contexts.
+  bool hasNoActiveContexts() const {
+    return llvm::all_of(threadStates, [](const auto &it) {
+      return it.second.activeContexts.empty();
+    });
+  }
+
+  /// The states of the threads running passes, keyed by thread id.
+  DenseMap<uint64_t, ThreadState> threadStates;
+
+  /// A mutex protecting the thread states, as the passes of a local reproducer
+  /// may run on multiple threads.
+  std::mutex mutex;
+
+  /// Flag indicating if a reproducer was generated for the current run of the
+  /// pass manager. Only one reproducer is generated per run, even if several
+  /// threads fail.
+  bool reproducerGenerated = false;
 
   /// Various pass manager flags that get emitted when generating a reproducer.
   bool pmFlagVerifyPasses = false;
@@ -205,13 +239,9 @@ PassCrashReproducerGenerator::~PassCrashReproducerGenerator() = default;
 void PassCrashReproducerGenerator::initialize(
     iterator_range<PassManager::pass_iterator> passes, Operation *op,
     bool pmFlagVerifyPasses) {
-  assert((!impl->localReproducer ||
-          !op->getContext()->isMultithreadingEnabled()) &&
-         "expected multi-threading to be disabled when generating a local "
-         "reproducer");
-
   llvm::CrashRecoveryContext::Enable();
   impl->pmFlagVerifyPasses = pmFlagVerifyPasses;
+  impl->reproducerGenerated = false;
 
   // If we aren't generating a local reproducer, prepare a reproducer for the
   // given top-level operation.
@@ -230,13 +260,17 @@ formatPassOpReproducerMessage(Diagnostic &os,
 
 void PassCrashReproducerGenerator::finalize(Operation *rootOp,
                                             LogicalResult executionResult) {
+  std::lock_guard<std::mutex> lock(impl->mutex);
+
   // Don't generate a reproducer if we have no active contexts.
-  if (impl->activeContexts.empty())
-    return;
+  if (impl->hasNoActiveContexts())
+    return impl->threadStates.clear();
 
-  // If the pass manager execution succeeded, we don't generate any reproducers.
-  if (succeeded(executionResult))
-    return impl->activeContexts.clear();
+  // If the pass manager execution succeeded, or if a reproducer was already
+  // generated for another failure, we don't generate any reproducers.
+  if (succeeded(executionResult) || impl->reproducerGenerated)
+    return impl->threadStates.clear();
+  impl->reproducerGenerated = true;
 
   InFlightDiagnostic diag = emitError(rootOp->getLoc())
                             << "Failures have been detected while "
@@ -245,63 +279,133 @@ void PassCrashReproducerGenerator::finalize(Operation *rootOp,
   // If we are generating a global reproducer, we include all of the running
   // passes in the error message for the only active context.
   if (!impl->localReproducer) {
-    assert(impl->activeContexts.size() == 1 && "expected one active context");
+    Impl::ThreadState &state = impl->getThreadState();
+    assert(state.activeContexts.size() == 1 && "expected one active context");
 
     // Generate the reproducer.
     std::string description;
-    impl->activeContexts.front()->generate(description);
+    state.activeContexts.front()->generate(description);
 
     // Emit an error to the user.
     Diagnostic &note = diag.attachNote() << "Pipeline failed while executing [";
-    llvm::interleaveComma(impl->runningPasses, note,
+    llvm::interleaveComma(state.runningPasses, note,
                           [&](const std::pair<Pass *, Operation *> &value) {
                             formatPassOpReproducerMessage(note, value);
                           });
     note << "]: " << description;
-    impl->runningPasses.clear();
-    impl->activeContexts.clear();
+    impl->threadStates.clear();
     return;
   }
 
   // If we were generating a local reproducer, we generate a reproducer for the
   // most recently executing pass using the matching entry from  `runningPasses`
-  // to generate a localized diagnostic message.
-  assert(impl->activeContexts.size() == impl->runningPasses.size() &&
+  // to generate a localized diagnostic message. The failure is reported from
+  // the thread that ran the failing pass, unless the pass crashed, in which
+  // case the reproducer is generated for the thread left with active contexts.
+  Impl::ThreadState *state = &impl->getThreadState();
+  if (state->activeContexts.empty()) {
+    for (auto &it : impl->threadStates) {
+      if (!it.second.activeContexts.empty()) {
+        state = &it.second;
+        break;
+      }
+    }
+  }
+  assert(state->activeContexts.size() == state->runningPasses.size() &&
          "expected running passes to match active contexts");
 
   // Generate the reproducer.
-  RecoveryReproducerContext &reproducerContext = *impl->activeContexts.back();
+  RecoveryReproducerContext &reproducerContext = *state->activeContexts.back();
   std::string description;
   reproducerContext.generate(description);
 
   // Emit an error to the user.
   Diagnostic &note = diag.attachNote() << "Pipeline failed while executing ";
-  formatPassOpReproducerMessage(note, impl->runningPasses.back());
+  formatPassOpReproducerMessage(note, state->runningPasses.back());
   note << ": " << description;
 
-  impl->activeContexts.clear();
-  impl->runningPasses.clear();
+  impl->threadStates.clear();
+}
+
+/// Returns a copy of the symbol `symbol` to be referenced from a local
+/// reproducer. The functions are turned into private declarations.
+static Operation *cloneReferencedSymbol(Operation *symbol) {
+  auto function = dyn_cast<FunctionOpInterface>(symbol);
+  if (!function || function.isExternal())
+    return symbol->clone();
+  Operation *declaration = symbol->cloneWithoutRegions();
+  SymbolTable::setSymbolVisibility(declaration,
+                                   SymbolTable::Visibility::Private);
+  return declaration;
+}
+
+/// Returns a detached snapshot of `op` for a local reproducer. Instead of the
+/// whole top-level operation, the snapshot only contains `op` nested in copies
+/// of its parents. The blocks of the parents only keep the operations on the
+/// path to `op`, their terminators if these have no operands, and copies of
+/// the symbols referenced from within `op`, which only has to be isolated from
+/// above to be scheduled. This keeps the cost of the snapshot proportional to
+/// the size of `op` rather than to the size of the top-level operation.
+static Operation *cloneForLocalReproducer(Operation *op) {
+  Operation *parentOp = op->getParentOp();
+  if (!parentOp)
+    return op->clone();
+
+  // Collect the symbols referenced from within `op` and defined outside of it.
+  llvm::SmallPtrSet<Operation *, 8> referencedSymbols;
+  for (Region &region : op->getRegions()) {
+    std::optional<SymbolTable::UseRange> uses =
+        SymbolTable::getSymbolUses(&region);
+    if (!uses)
+      continue;
+    for (const SymbolTable::SymbolUse &use : *uses) {
+      Operation *symbol = SymbolTable::lookupNearestSymbolFrom(
+          parentOp, use.getSymbolRef().getRootReference());
+      if (symbol && !op->isAncestor(symbol))
+        referencedSymbols.insert(symbol);
+    }
+  }
+
+  Operation *snapshot = op->clone();
+  for (Operation *child = op; parentOp;
+       child = parentOp, parentOp = parentOp->getParentOp()) {
+    Operation *parentSnapshot = parentOp->cloneWithoutRegions();
+    Block *block = child->getBlock();
+    Block *blockSnapshot = new Block();
+    parentSnapshot->getRegion(child->getParentRegion()->getRegionNumber())
+        .push_back(blockSnapshot);
+    for (BlockArgument arg : block->getArguments())
+      blockSnapshot->addArgument(arg.getType(), arg.getLoc());
+    for (Operation &sibling : *block) {
+      if (&sibling == child)
+        blockSnapshot->push_back(snapshot);
+      else if (referencedSymbols.contains(&sibling))
+        blockSnapshot->push_back(cloneReferencedSymbol(&sibling));
+      else if (sibling.hasTrait<OpTrait::IsTerminator>() &&
+               sibling.getNumOperands() == 0 &&
+               sibling.getNumSuccessors() == 0)
+        blockSnapshot->push_back(sibling.clone());
+    }
+    snapshot = parentSnapshot;
+  }
+  return snapshot;
 }
 
 void PassCrashReproducerGenerator::prepareReproducerFor(Pass *pass,
                                                         Operation *op) {
   // If not tracking local reproducers, we simply remember that this pass is
   // running.
-  impl->runningPasses.insert(std::make_pair(pass, op));
-  if (!impl->localReproducer)
+  if (!impl->localReproducer) {
+    std::lock_guard<std::mutex> lock(impl->mutex);
+    impl->getThreadState().runningPasses.insert(std::make_pair(pass, op));
     return;
-
-  // Disable the current pass recovery context, if there is one. This may happen
-  // in the case of dynamic pass pipelines.
-  if (!impl->activeContexts.empty())
-    impl->activeContexts.back()->disable();
+  }
 
   // Collect all of the parent scopes of this operation.
   SmallVector<OperationName> scopes;
-  while (Operation *parentOp = op->getParentOp()) {
-    scopes.push_back(op->getName());
-    op = parentOp;
-  }
+  for (Operation *scopeOp = op; Operation *parentOp = scopeOp->getParentOp();
+       scopeOp = parentOp)
+    scopes.push_back(scopeOp->getName());
 
   // Emit a pass pipeline string for the current pass running on the current
   // operation type.
@@ -313,8 +417,20 @@ void PassCrashReproducerGenerator::prepareReproducerFor(Pass *pass,
   for (unsigned i = 0, e = scopes.size(); i < e; ++i)
     passOS << ")";
 
-  impl->activeContexts.push_back(std::make_unique<RecoveryReproducerContext>(
-      passOS.str(), op, impl->streamFactory, impl->pmFlagVerifyPasses));
+  // Snapshot the IR outside of the lock, as the other threads only need it to
+  // access their own state.
+  auto context = std::make_unique<RecoveryReproducerContext>(
+      passOS.str(), cloneForLocalReproducer(op), impl->streamFactory,
+      impl->pmFlagVerifyPasses);
+
+  // Disable the current pass recovery context, if there is one. This may happen
+  // in the case of dynamic pass pipelines.
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  Impl::ThreadState &state = impl->getThreadState();
+  if (!state.activeContexts.empty())
+    state.activeContexts.back()->disable();
+  state.runningPasses.insert(std::make_pair(pass, op));
+  state.activeContexts.push_back(std::move(context));
 }
 void PassCrashReproducerGenerator::prepareReproducerFor(
     iterator_range<PassManager::pass_iterator> passes, Operation *op) {
@@ -323,22 +439,28 @@ void PassCrashReproducerGenerator::prepareReproducerFor(
   llvm::interleaveComma(
       passes, passOS, [&](Pass &pass) { pass.printAsTextualPipeline(passOS); });
 
-  impl->activeContexts.push_back(std::make_unique<RecoveryReproducerContext>(
-      passOS.str(), op, impl->streamFactory, impl->pmFlagVerifyPasses));
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  impl->getThreadState().activeContexts.push_back(
+      std::make_unique<RecoveryReproducerContext>(passOS.str(), op->clone(),
+                                                  impl->streamFactory,
+                                                  impl->pmFlagVerifyPasses));
 }
 
 void PassCrashReproducerGenerator::removeLastReproducerFor(Pass *pass,
                                                            Operation *op) {
-  // We only pop the active context if we are tracking local reproducers.
-  impl->runningPasses.remove(std::make_pair(pass, op));
-  if (impl->localReproducer) {
-    impl->activeContexts.pop_back();
-
-    // Re-enable the previous pass recovery context, if there was one. This may
-    // happen in the case of dynamic pass pipelines.
-    if (!impl->activeContexts.empty())
-      impl->activeContexts.back()->enable();
-  }
+  // We only pop the active context if we are tracking local reproducers. The
+  // contexts may have been cleared already if another thread failed.
+  std::lock_guard<std::mutex> lock(impl->mutex);
+  Impl::ThreadState &state = impl->getThreadState();
+  if (!state.runningPasses.remove(std::make_pair(pass, op)) ||
+      !impl->localReproducer)
+    return;
+  state.activeContexts.pop_back();
+
+  // Re-enable the previous pass recovery context, if there was one. This may
+  // happen in the case of dynamic pass pipelines.
+  if (!state.activeContexts.empty())
+    state.activeContexts.back()->enable();
 }
 
 //===----------------------------------------------------------------------===//
@@ -363,17 +485,16 @@ struct CrashReproducerInstrumentation : public PassInstrumentation {
 
   void runAfterPassFailed(Pass *pass, Operation *op) override {
     // Only generate one reproducer per crash reproducer instrumentation.
-    if (alreadyFailed)
+    if (alreadyFailed.exchange(true))
       return;
 
-    alreadyFailed = true;
     generator.finalize(op, /*executionResult=*/failure());
   }
 
 private:
   /// The generator used to create crash reproducers.
   PassCrashReproducerGenerator &generator;
-  bool alreadyFailed = false;
+  std::atomic<bool> alreadyFailed = false;
 };
 } // namespace
 
@@ -440,10 +561,6 @@ void PassManager::enableCrashReproducerGeneration(
     ReproducerStreamFactory factory, bool genLocalReproducer) {
   assert(!crashReproGenerator &&
          "crash reproducer has already been initialized");
-  if (genLocalReproducer && getContext()->isMultithreadingEnabled())
-    llvm::report_fatal_error(
-        "Local crash reproduction can't be setup on a "
-        "pass-manager without disabling multi-threading first.");
 
   crashReproGenerator = std::make_unique<PassCrashReproducerGenerator>(
       factory, genLocalReproducer);
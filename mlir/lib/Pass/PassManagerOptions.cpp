@@ -30,6 +30,15 @@ struct PassManagerOptions {
                      "a reproducer with the smallest pipeline."),
       llvm::cl::init(false)};
 
+  //===--------------------------------------------------------------------===//
+  // Pipeline Cache
+  //===--------------------------------------------------------------------===//
+  llvm::cl::opt<std::string> pipelineCacheDir{
+      "mlir-pass-pipeline-cache-dir",
+      llvm::cl::desc("Cache the results of nested pass pipelines within the "
+                     "given directory, and reuse them on identical operations"),
+      llvm::cl::value_desc("directory")};
+
   //===--------------------------------------------------------------------===//
   // IR Printing
   //===--------------------------------------------------------------------===//
@@ -58,6 +67,17 @@ struct PassManagerOptions {
       llvm::cl::desc("When printing IR for print-ir-[before|after]{-all} "
                      "always print the top-level operation"),
       llvm::cl::init(false)};
+  llvm::cl::opt<bool> printAsync{
+      "mlir-print-ir-async",
+      llvm::cl::desc("When printing IR for print-ir-[before|after]{-all} "
+                     "print on a background thread from a clone of the IR"),
+      llvm::cl::init(false)};
+  llvm::cl::opt<std::string> printBytecodeDir{
+      "mlir-print-ir-bytecode-dir",
+      llvm::cl::desc("When printing IR for print-ir-[before|after]{-all} "
+                     "write each dump as bytecode to a file of the given "
+                     "directory"),
+      llvm::cl::value_desc("directory")};
 
   /// Add an IR printing instrumentation if enabled by any 'print-ir' flags.
   void addPrinterInstrumentation(PassManager &pm);
@@ -78,6 +98,13 @@ struct PassManagerOptions {
               "display the results in a merged list sorted by pass name"),
           clEnumValN(PassDisplayMode::Pipeline, "pipeline",
                      "display the results with a nested pipeline view"))};
+
+  //===--------------------------------------------------------------------===//
+  // Pass Memory Report
+  //===--------------------------------------------------------------------===//
+  llvm::cl::opt<bool> memoryReport{
+      "mlir-memory-report",
+      llvm::cl::desc("Display the memory changes of each pass")};
 };
 } // namespace
 
@@ -122,7 +149,8 @@ void PassManagerOptions::addPrinterInstrumentation(PassManager &pm) {
   // Otherwise, add the IR printing instrumentation.
   pm.enableIRPrinting(shouldPrintBeforePass, shouldPrintAfterPass,
                       printModuleScope, printAfterChange, printAfterFailure,
-                      llvm::errs());
+                      llvm::errs(), OpPrintingFlags(), printAsync,
+                      printBytecodeDir);
 }
 
 void mlir::registerPassManagerCLOptions() {
@@ -139,10 +167,19 @@ LogicalResult mlir::applyPassManagerCLOptions(PassManager &pm) {
     pm.enableCrashReproducerGeneration(options->reproducerFile,
                                        options->localReproducer);
 
+  // Cache the results of the nested pipelines.
+  if (!options->pipelineCacheDir.empty())
+    pm.enablePipelineCache(
+        createDirectoryPassPipelineCache(options->pipelineCacheDir));
+
   // Enable statistics dumping.
   if (options->passStatistics)
     pm.enableStatistics(options->passStatisticsDisplayMode);
 
+  // Enable the memory report.
+  if (options->memoryReport)
+    pm.enableMemoryReport();
+
   if (options->printModuleScope && pm.getContext()->isMultithreadingEnabled()) {
     emitError(UnknownLoc::get(pm.getContext()))
         << "IR print for module scope can't be setup on a pass-manager "
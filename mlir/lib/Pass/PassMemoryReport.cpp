@@ -0,0 +1,170 @@
+//===- PassMemoryReport.cpp -----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "PassDetail.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
+#include "mlir/IR/Location.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Support/StorageUniquer.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/Threading.h"
+#include <mutex>
+
+using namespace mlir;
+using namespace mlir::detail;
+
+//===----------------------------------------------------------------------===//
+// PassMemoryReport
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// The memory used by the process and the context at a point of the pipeline.
+struct MemorySnapshot {
+  /// The bytes allocated by malloc.
+  int64_t mallocBytes;
+  /// The bytes allocated for the uniqued attributes and types, and for the
+  /// builtin locations among the attributes.
+  int64_t attributeBytes;
+  int64_t locationBytes;
+  int64_t typeBytes;
+  /// The bytes of the data of the builtin dialect resource blobs.
+  int64_t blobBytes;
+  /// The number of operations nested in the operation the pass runs on.
+  int64_t numOps;
+
+  static MemorySnapshot get(Operation *op) {
+    MLIRContext *context = op->getContext();
+    auto &blobManager =
+        DenseResourceElementsHandle::getManagerInterface(context)
+            .getBlobManager();
+    int64_t numOps = 0;
+    op->walk([&](Operation *) { ++numOps; });
+    StorageUniquer &attrUniquer = context->getAttributeUniquer();
+    size_t locationBytes = 0;
+    for (TypeID id : {TypeID::get<CallSiteLoc>(), TypeID::get<FileLineColLoc>(),
+                      TypeID::get<FusedLoc>(), TypeID::get<NameLoc>(),
+                      TypeID::get<OpaqueLoc>()})
+      locationBytes += attrUniquer.getBytesAllocated(id);
+    return {static_cast<int64_t>(llvm::sys::Process::GetMallocUsage()),
+            static_cast<int64_t>(attrUniquer.getBytesAllocated()),
+            static_cast<int64_t>(locationBytes),
+            static_cast<int64_t>(context->getTypeUniquer().getBytesAllocated()),
+            static_cast<int64_t>(blobManager.getTotalBlobSize()), numOps};
+  }
+
+  MemorySnapshot &operator+=(const MemorySnapshot &other) {
+    mallocBytes += other.mallocBytes;
+    attributeBytes += other.attributeBytes;
+    locationBytes += other.locationBytes;
+    typeBytes += other.typeBytes;
+    blobBytes += other.blobBytes;
+    numOps += other.numOps;
+    return *this;
+  }
+  MemorySnapshot operator-(const MemorySnapshot &other) const {
+    return {mallocBytes - other.mallocBytes,
+            attributeBytes - other.attributeBytes,
+            locationBytes - other.locationBytes, typeBytes - other.typeBytes,
+            blobBytes - other.blobBytes, numOps - other.numOps};
+  }
+};
+
+struct PassMemoryReport : public PassInstrumentation {
+  PassMemoryReport(raw_ostream &os) : os(os) {}
+  ~PassMemoryReport() override { print(); }
+
+  void runBeforePass(Pass *pass, Operation *op) override {
+    // The adaptors report the memory of their nested passes.
+    if (isa<OpToOpPassAdaptor>(pass))
+      return;
+    MemorySnapshot snapshot = MemorySnapshot::get(op);
+    std::lock_guard<std::mutex> lock(mutex);
+    activeSnapshots[{llvm::get_threadid(), pass}].push_back(snapshot);
+  }
+
+  void runAfterPass(Pass *pass, Operation *op) override {
+    if (isa<OpToOpPassAdaptor>(pass))
+      return;
+    MemorySnapshot snapshot = MemorySnapshot::get(op);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &snapshots = activeSnapshots[{llvm::get_threadid(), pass}];
+    MemorySnapshot delta = snapshot - snapshots.pop_back_val();
+
+    // The clones of a pass running on other threads share its entry.
+    const Pass *key = pass->getThreadingSiblingOrThis();
+    auto it = passIndices.try_emplace(key, entries.size()).first;
+    if (it->second == entries.size()) {
+      entries.push_back({pass->getName().str(), delta, 1});
+      return;
+    }
+    Entry &entry = entries[it->second];
+    entry.delta += delta;
+    ++entry.numRuns;
+  }
+
+  void runAfterPassFailed(Pass *pass, Operation *op) override {
+    runAfterPass(pass, op);
+  }
+
+  /// Prints the memory report of the passes that ran, in the order they first
+  /// ran in.
+  void print() {
+    if (entries.empty())
+      return;
+    auto toKB = [](int64_t bytes) { return static_cast<double>(bytes) / 1024; };
+    os << "===" << std::string(73, '-') << "===\n"
+       << "                              Pass Memory Report\n"
+       << "===" << std::string(73, '-') << "===\n"
+       << "  Malloc(KB)  Attrs(KB)   Locs(KB)  Types(KB)  Blobs(KB)"
+       << "      Ops  Runs  Name\n";
+    for (const Entry &entry : entries) {
+      os << llvm::format("  %10.1f %10.1f %10.1f %10.1f %10.1f %8lld %5u  ",
+                         toKB(entry.delta.mallocBytes),
+                         toKB(entry.delta.attributeBytes),
+                         toKB(entry.delta.locationBytes),
+                         toKB(entry.delta.typeBytes),
+                         toKB(entry.delta.blobBytes),
+                         static_cast<long long>(entry.delta.numOps),
+                         entry.numRuns)
+         << entry.name << "\n";
+    }
+    os.flush();
+  }
+
+  /// The memory changes of a pass, summed over its runs.
+  struct Entry {
+    std::string name;
+    MemorySnapshot delta;
+    unsigned numRuns;
+  };
+  SmallVector<Entry> entries;
+  DenseMap<const Pass *, unsigned> passIndices;
+
+  /// The snapshots taken before the passes currently running on each thread.
+  DenseMap<std::pair<uint64_t, Pass *>, SmallVector<MemorySnapshot, 1>>
+      activeSnapshots;
+
+  /// A mutex protecting the state of the report, as the passes may run on
+  /// multiple threads.
+  std::mutex mutex;
+
+  /// The stream the report is printed to.
+  raw_ostream &os;
+};
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// PassManager
+//===----------------------------------------------------------------------===//
+
+/// Add an instrumentation to report the memory changes of each pass.
+void PassManager::enableMemoryReport(raw_ostream &os) {
+  addInstrumentation(std::make_unique<PassMemoryReport>(os));
+}
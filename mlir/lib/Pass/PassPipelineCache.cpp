@@ -0,0 +1,119 @@
+//===- PassPipelineCache.cpp - Pass pipeline result caches ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the builtin caches for the results of pass pipelines.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Pass/PassManager.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include <mutex>
+
+#define DEBUG_TYPE "pass-pipeline-cache"
+
+using namespace mlir;
+
+PassPipelineCache::~PassPipelineCache() = default;
+
+//===----------------------------------------------------------------------===//
+// InMemoryPassPipelineCache
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// A pipeline cache that holds its entries in memory. Entries are never
+/// removed, so the buffers returned by `lookup` may reference them directly.
+class InMemoryPassPipelineCache : public PassPipelineCache {
+public:
+  std::unique_ptr<llvm::MemoryBuffer> lookup(StringRef key) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it == entries.end())
+      return nullptr;
+    return llvm::MemoryBuffer::getMemBuffer(it->second->getMemBufferRef());
+  }
+
+  void insert(StringRef key, StringRef result) override {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<llvm::MemoryBuffer> &entry = entries[key];
+    if (!entry)
+      entry = llvm::MemoryBuffer::getMemBufferCopy(result, key);
+  }
+
+private:
+  llvm::StringMap<std::unique_ptr<llvm::MemoryBuffer>> entries;
+  std::mutex mutex;
+};
+} // namespace
+
+std::unique_ptr<PassPipelineCache> mlir::createInMemoryPassPipelineCache() {
+  return std::make_unique<InMemoryPassPipelineCache>();
+}
+
+//===----------------------------------------------------------------------===//
+// DirectoryPassPipelineCache
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// A pipeline cache that holds each of its entries in a file of the cache
+/// directory, named after the key of the entry.
+class DirectoryPassPipelineCache : public PassPipelineCache {
+public:
+  DirectoryPassPipelineCache(StringRef directory) : directory(directory) {}
+
+  std::unique_ptr<llvm::MemoryBuffer> lookup(StringRef key) override {
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> entry =
+        llvm::MemoryBuffer::getFile(getEntryPath(key), /*IsText=*/false,
+                                    /*RequiresNullTerminator=*/false);
+    if (!entry)
+      return nullptr;
+    return std::move(*entry);
+  }
+
+  void insert(StringRef key, StringRef result) override {
+    // Failing to persist an entry is not fatal: the pipeline will simply be
+    // rerun the next time. The entry is written to a temporary file and then
+    // renamed, so that concurrent processes never observe a partially written
+    // entry.
+    if (std::error_code ec = llvm::sys::fs::create_directories(directory)) {
+      LLVM_DEBUG(llvm::dbgs() << "Could not create pipeline cache directory "
+                              << directory << ": " << ec.message() << "\n");
+      return;
+    }
+    std::string path = getEntryPath(key);
+    llvm::Error error = llvm::writeToOutput(path, [&](raw_ostream &os) {
+      os << result;
+      return llvm::Error::success();
+    });
+    if (error) {
+      LLVM_DEBUG(llvm::dbgs() << "Could not write pipeline cache entry "
+                              << path << ": " << error << "\n");
+      llvm::consumeError(std::move(error));
+    }
+  }
+
+private:
+  /// Return the path of the file holding the entry for the given key.
+  std::string getEntryPath(StringRef key) const {
+    SmallString<256> path(directory);
+    llvm::sys::path::append(path, key + ".mlirbc");
+    return std::string(path);
+  }
+
+  /// The directory holding the entries of the cache.
+  std::string directory;
+};
+} // namespace
+
+std::unique_ptr<PassPipelineCache>
+mlir::createDirectoryPassPipelineCache(StringRef directory) {
+  return std::make_unique<DirectoryPassPipelineCache>(directory);
+}
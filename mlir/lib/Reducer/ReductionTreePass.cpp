@@ -16,6 +16,7 @@
 
 #include "mlir/IR/DialectInterface.h"
 #include "mlir/IR/OpDefinition.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Reducer/Passes.h"
 #include "mlir/Reducer/ReductionNode.h"
 #include "mlir/Reducer/ReductionPatternInterface.h"
@@ -110,11 +111,29 @@ static LogicalResult findOptimal(ModuleOp module, Region &region,
 
   while (iter != IteratorType::end()) {
     ReductionNode &currentNode = *iter;
-    Region &curRegion = currentNode.getRegion();
 
-    applyPatterns(curRegion, patterns, currentNode.getRanges(),
-                  eraseOpNotInRange);
-    currentNode.update(test.isInteresting(currentNode.getModule()));
+    // The variants generated together are visited one after the other, and
+    // don't depend on each other. Reduce and test them all in parallel when the
+    // first one is visited. The root is reduced as well, although it has been
+    // tested already.
+    SmallVector<ReductionNode *> variantsToReduce;
+    if (&currentNode == root) {
+      variantsToReduce.push_back(root);
+    } else if (currentNode.isInteresting() ==
+               Tester::Interestingness::Untested) {
+      for (ReductionNode *variant : currentNode.getParent()->getVariants())
+        if (variant->isInteresting() == Tester::Interestingness::Untested)
+          variantsToReduce.push_back(variant);
+    }
+    if (!variantsToReduce.empty()) {
+      parallelForEach(module.getContext(), variantsToReduce,
+                      [&](ReductionNode *variant) {
+                        applyPatterns(variant->getRegion(), patterns,
+                                      variant->getRanges(), eraseOpNotInRange);
+                        variant->update(
+                            test.isInteresting(variant->getModule()));
+                      });
+    }
 
     if (currentNode.isInteresting() == Tester::Interestingness::True &&
         currentNode.getSize() < smallestNode->getSize())
@@ -201,7 +220,7 @@ public:
   void runOnOperation() override;
 
 private:
-  LogicalResult reduceOp(ModuleOp module, Region &region);
+  LogicalResult reduceOp(ModuleOp module, Region &region, const Tester &test);
 
   FrozenRewritePatternSet reducerPatterns;
 };
@@ -227,6 +246,9 @@ void ReductionTreePass::runOnOperation() {
     return signalPassFailure();
   }
 
+  // The tester is shared by the regions to reuse the results of the variants
+  // that are identical across them.
+  Tester test(testerName, testerArgs);
   SmallVector<Operation *, 8> workList;
   workList.push_back(getOperation());
 
@@ -235,7 +257,7 @@ void ReductionTreePass::runOnOperation() {
 
     for (Region &region : op->getRegions())
       if (!region.empty())
-        if (failed(reduceOp(module, region)))
+        if (failed(reduceOp(module, region, test)))
           return signalPassFailure();
 
     for (Region &region : op->getRegions())
@@ -245,8 +267,8 @@ void ReductionTreePass::runOnOperation() {
   } while (!workList.empty());
 }
 
-LogicalResult ReductionTreePass::reduceOp(ModuleOp module, Region &region) {
-  Tester test(testerName, testerArgs);
+LogicalResult ReductionTreePass::reduceOp(ModuleOp module, Region &region,
+                                          const Tester &test) {
   switch (traversalModeId) {
   case TraversalMode::SinglePath:
     return findOptimal<ReductionNode::iterator<TraversalMode::SinglePath>>(
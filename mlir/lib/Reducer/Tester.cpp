@@ -31,6 +31,19 @@ Tester::isInteresting(ModuleOp module) const {
   if (failed(verify(module)))
     return std::make_pair(Interestingness::False, /*size=*/0);
 
+  // The reduction often produces identical variants, e.g. when the patterns
+  // do not apply, which don't need to be tested again.
+  std::string ir;
+  llvm::raw_string_ostream irStream(ir);
+  module.print(irStream);
+  irStream.flush();
+  {
+    std::lock_guard<std::mutex> lock(resultCacheMutex);
+    auto it = resultCache.find(ir);
+    if (it != resultCache.end())
+      return std::make_pair(it->second, ir.size());
+  }
+
   SmallString<128> filepath;
   int fd;
 
@@ -43,15 +56,17 @@ Tester::isInteresting(ModuleOp module) const {
                              ec.message());
 
   llvm::ToolOutputFile out(filepath, fd);
-  module.print(out.os());
+  out.os() << ir;
   out.os().close();
 
   if (out.os().has_error())
     llvm::report_fatal_error(llvm::Twine("Error emitting the IR to file '") +
                              filepath);
 
-  size_t size = out.os().tell();
-  return std::make_pair(isInteresting(filepath), size);
+  Interestingness result = isInteresting(filepath);
+  std::lock_guard<std::mutex> lock(resultCacheMutex);
+  resultCache.try_emplace(ir, result);
+  return std::make_pair(result, ir.size());
 }
 
 /// Runs the interestingness testing script on a MLIR test case file. Returns
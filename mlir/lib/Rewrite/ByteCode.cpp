@@ -1051,6 +1051,14 @@ PDLByteCode::PDLByteCode(
                       maxLoopLevel, constraintFns, rewriteFns, configMap);
   generator.generate(module);
 
+  // Collect the operations that the patterns are rooted on.
+  for (const PDLByteCodePattern &pattern : patterns) {
+    if (std::optional<OperationName> rootKind = pattern.getRootKind())
+      rootKinds.insert(*rootKind);
+    else
+      hasAnyOpPattern = true;
+  }
+
   // Initialize the external functions.
   for (auto &it : constraintFns)
     constraintFunctions.push_back(std::move(it.second));
@@ -2266,6 +2274,10 @@ ByteCodeExecutor::execute(PatternRewriter &rewriter,
 void PDLByteCode::match(Operation *op, PatternRewriter &rewriter,
                         SmallVectorImpl<MatchResult> &matches,
                         PDLByteCodeMutableState &state) const {
+  // Avoid entering the interpreter for operations that no pattern can match.
+  if (!hasAnyOpPattern && !rootKinds.contains(op->getName()))
+    return;
+
   // The first memory slot is always the root operation.
   state.memory[0] = op;
 
@@ -15,6 +15,7 @@
 #define MLIR_REWRITE_BYTECODE_H_
 
 #include "mlir/IR/PatternMatch.h"
+#include "llvm/ADT/DenseSet.h"
 
 namespace mlir {
 namespace pdl_interp {
@@ -205,6 +206,13 @@ private:
   /// The set of patterns contained within the bytecode.
   SmallVector<PDLByteCodePattern, 32> patterns;
 
+  /// The root operation names of the patterns. The matcher is only executed on
+  /// operations with one of these names, unless `hasAnyOpPattern` is set.
+  DenseSet<OperationName> rootKinds;
+
+  /// Whether any of the patterns may match any operation type.
+  bool hasAnyOpPattern = false;
+
   /// A set of user defined functions invoked via PDL.
   std::vector<PDLConstraintFunction> constraintFunctions;
   std::vector<PDLRewriteFunction> rewriteFunctions;
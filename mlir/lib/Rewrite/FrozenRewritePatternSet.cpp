@@ -121,6 +121,35 @@ FrozenRewritePatternSet::FrozenRewritePatternSet(
     impl->nativeAnyOpPatterns.push_back(std::move(pat));
   }
 
+  // Resolve the candidate patterns of each operation for the static benefits,
+  // which is the cost model used by most applicators. Op specific patterns
+  // take precedence over "match any" patterns of the same benefit.
+  auto hasHigherBenefit = [](const RewritePattern *lhs,
+                             const RewritePattern *rhs) {
+    return lhs->getBenefit() > rhs->getBenefit();
+  };
+  for (const std::unique_ptr<RewritePattern> &pat : impl->nativeAnyOpPatterns)
+    if (!pat->getBenefit().isImpossibleToMatch())
+      impl->sortedAnyOpPatterns.push_back(pat.get());
+  std::stable_sort(impl->sortedAnyOpPatterns.begin(),
+                   impl->sortedAnyOpPatterns.end(), hasHigherBenefit);
+  SmallVector<const RewritePattern *> opPatterns;
+  for (const auto &it : impl->nativeOpSpecificPatternMap) {
+    opPatterns.clear();
+    for (const RewritePattern *pat : it.second)
+      if (!pat->getBenefit().isImpossibleToMatch())
+        opPatterns.push_back(pat);
+    std::stable_sort(opPatterns.begin(), opPatterns.end(), hasHigherBenefit);
+
+    SortedNativePatternListT &candidates =
+        impl->sortedNativePatternMap[it.first];
+    candidates.reserve(opPatterns.size() + impl->sortedAnyOpPatterns.size());
+    std::merge(opPatterns.begin(), opPatterns.end(),
+               impl->sortedAnyOpPatterns.begin(),
+               impl->sortedAnyOpPatterns.end(), std::back_inserter(candidates),
+               hasHigherBenefit);
+  }
+
   // Generate the bytecode for the PDL patterns if any were provided.
   PDLPatternModule &pdlPatterns = patterns.getPDLPatterns();
   ModuleOp pdlModule = pdlPatterns.getModule();
@@ -14,12 +14,92 @@
 #include "mlir/Rewrite/PatternApplicator.h"
 #include "ByteCode.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Format.h"
 
 #define DEBUG_TYPE "pattern-application"
 
 using namespace mlir;
 using namespace mlir::detail;
 
+//===----------------------------------------------------------------------===//
+// PatternProfile
+//===----------------------------------------------------------------------===//
+
+void PatternProfile::recordPatternApplication(const Pattern &pattern,
+                                              bool succeeded, Duration time) {
+  StringRef name = pattern.getDebugName();
+  if (!name.empty())
+    return record(patterns, name, succeeded, time);
+
+  // Fallback to the root of the pattern for unnamed patterns.
+  std::string unnamed = "<unnamed pattern on ";
+  if (std::optional<OperationName> rootKind = pattern.getRootKind())
+    unnamed += "'" + rootKind->getStringRef().str() + "'>";
+  else
+    unnamed += "any operation>";
+  record(patterns, unnamed, succeeded, time);
+}
+
+void PatternProfile::recordFold(OperationName name, bool succeeded,
+                                Duration time) {
+  record(folds, name.getStringRef(), succeeded, time);
+}
+
+void PatternProfile::record(llvm::StringMap<Entry> &entries, StringRef name,
+                            bool succeeded, Duration time) {
+  std::lock_guard<std::mutex> lock(mutex);
+  Entry &entry = entries[name];
+  ++entry.numAttempts;
+  if (succeeded)
+    ++entry.numSuccesses;
+  entry.time += time;
+}
+
+void PatternProfile::print(raw_ostream &os) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto printEntries = [&](StringRef title,
+                          const llvm::StringMap<Entry> &entries) {
+    if (entries.empty())
+      return;
+    SmallVector<const llvm::StringMapEntry<Entry> *> sortedEntries;
+    for (const llvm::StringMapEntry<Entry> &entry : entries)
+      sortedEntries.push_back(&entry);
+    llvm::sort(sortedEntries, [](const auto *lhs, const auto *rhs) {
+      if (lhs->second.time != rhs->second.time)
+        return lhs->second.time > rhs->second.time;
+      return lhs->getKey() < rhs->getKey();
+    });
+
+    os << "===" << std::string(73, '-') << "===\n";
+    os.indent((80 - title.size()) / 2) << title << "\n";
+    os << "===" << std::string(73, '-') << "===\n";
+    os << llvm::format("  %10s  %10s  %10s  %s\n", "Time (s)", "Attempts",
+                       "Successes", "Name");
+    for (const llvm::StringMapEntry<Entry> *entry : sortedEntries) {
+      const Entry &info = entry->second;
+      os << llvm::format(
+                "  %10.4f  %10llu  %10llu  ",
+                std::chrono::duration<double>(info.time).count(),
+                static_cast<unsigned long long>(info.numAttempts),
+                static_cast<unsigned long long>(info.numSuccesses))
+         << entry->getKey() << "\n";
+    }
+    os << "\n";
+  };
+  printEntries("Pattern Application Profile", patterns);
+  printEntries("Fold Profile", folds);
+}
+
+void PatternProfile::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  patterns.clear();
+  folds.clear();
+}
+
+//===----------------------------------------------------------------------===//
+// PatternApplicator
+//===----------------------------------------------------------------------===//
+
 PatternApplicator::PatternApplicator(
     const FrozenRewritePatternSet &frozenPatternList)
     : frozenPatternList(frozenPatternList) {
@@ -49,7 +129,24 @@ static void logSucessfulPatternApplication(Operation *op) {
 }
 #endif
 
+void PatternApplicator::applyDefaultCostModel() {
+  // The bytecode patterns are few, so simply reset them to their benefit.
+  if (const PDLByteCode *bytecode = frozenPatternList.getPDLByteCode()) {
+    for (const auto &it : llvm::enumerate(bytecode->getPatterns()))
+      mutableByteCodeState->updatePatternBenefit(it.index(),
+                                                 it.value().getBenefit());
+  }
+
+  // The native patterns have already been sorted by static benefit for each
+  // operation when the pattern list was frozen.
+  patterns.clear();
+  anyOpPatterns.clear();
+  useSortedNativePatterns = true;
+}
+
 void PatternApplicator::applyCostModel(CostModel model) {
+  useSortedNativePatterns = false;
+
   // Apply the cost model to the bytecode patterns first, and then the native
   // patterns.
   if (const PDLByteCode *bytecode = frozenPatternList.getPDLByteCode()) {
@@ -137,10 +234,16 @@ LogicalResult PatternApplicator::matchAndRewrite(
     bytecode->match(op, rewriter, pdlMatches, *mutableByteCodeState);
 
   // Check to see if there are patterns matching this specific operation type.
-  MutableArrayRef<const RewritePattern *> opPatterns;
-  auto patternIt = patterns.find(op->getName());
-  if (patternIt != patterns.end())
-    opPatterns = patternIt->second;
+  // The sorted lists of the frozen pattern list already include the patterns
+  // that match any operation type.
+  ArrayRef<const RewritePattern *> opPatterns;
+  if (useSortedNativePatterns) {
+    opPatterns = frozenPatternList.getSortedNativePatterns(op->getName());
+  } else {
+    auto patternIt = patterns.find(op->getName());
+    if (patternIt != patterns.end())
+      opPatterns = patternIt->second;
+  }
 
   // Process the patterns for that match the specific operation type, and any
   // operation type in an interleaved fashion.
@@ -188,6 +291,17 @@ LogicalResult PatternApplicator::matchAndRewrite(
     bool matched = false;
     op->getContext()->executeAction<ApplyPatternAction>(
         [&]() {
+          std::chrono::steady_clock::time_point startTime;
+          if (profile)
+            startTime = std::chrono::steady_clock::now();
+          auto recordProfile = [&](bool succeeded) {
+            if (profile)
+              profile->recordPatternApplication(
+                  *bestPattern, succeeded,
+                  std::chrono::duration_cast<PatternProfile::Duration>(
+                      std::chrono::steady_clock::now() - startTime));
+          };
+
           rewriter.setInsertionPoint(op);
 #ifndef NDEBUG
           // Operation `op` may be invalidated after applying the rewrite
@@ -214,6 +328,7 @@ LogicalResult PatternApplicator::matchAndRewrite(
           if (succeeded(result) && onSuccess && failed(onSuccess(*bestPattern)))
             result = failure();
           if (succeeded(result)) {
+            recordProfile(/*succeeded=*/true);
             LLVM_DEBUG(logSucessfulPatternApplication(dumpRootOp));
             matched = true;
             return;
@@ -222,6 +337,7 @@ LogicalResult PatternApplicator::matchAndRewrite(
           // Perform any necessary cleanups.
           if (onFailure)
             onFailure(*bestPattern);
+          recordProfile(/*succeeded=*/false);
         },
         {op}, *bestPattern);
     if (matched)
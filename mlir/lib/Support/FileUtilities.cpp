@@ -21,10 +21,10 @@ using namespace mlir;
 
 static std::unique_ptr<llvm::MemoryBuffer>
 openInputFileImpl(StringRef inputFilename, std::string *errorMessage,
-                  std::optional<llvm::Align> alignment) {
+                  std::optional<llvm::Align> alignment,
+                  bool requiresNullTerminator = true) {
   auto fileOrErr = llvm::MemoryBuffer::getFileOrSTDIN(
-      inputFilename, /*IsText=*/false, /*RequiresNullTerminator=*/true,
-      alignment);
+      inputFilename, /*IsText=*/false, requiresNullTerminator, alignment);
   if (std::error_code error = fileOrErr.getError()) {
     if (errorMessage)
       *errorMessage = "cannot open input file '" + inputFilename.str() +
@@ -44,6 +44,13 @@ mlir::openInputFile(llvm::StringRef inputFilename, llvm::Align alignment,
                     std::string *errorMessage) {
   return openInputFileImpl(inputFilename, errorMessage, alignment);
 }
+std::unique_ptr<llvm::MemoryBuffer>
+mlir::openInputFileForMapping(StringRef inputFilename,
+                              std::optional<llvm::Align> alignment,
+                              std::string *errorMessage) {
+  return openInputFileImpl(inputFilename, errorMessage, alignment,
+                           /*requiresNullTerminator=*/false);
+}
 
 std::unique_ptr<llvm::ToolOutputFile>
 mlir::openOutputFile(StringRef outputFilename, std::string *errorMessage) {
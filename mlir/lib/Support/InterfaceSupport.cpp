@@ -12,6 +12,7 @@
 
 #include "mlir/Support/InterfaceSupport.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 
 #define DEBUG_TYPE "interfaces"
@@ -30,4 +31,21 @@ void detail::InterfaceMap::insert(TypeID interfaceId, void *conceptImpl) {
     return;
   }
   interfaces.insert(it, {interfaceId, conceptImpl});
+  rebuildLookupTable();
+}
+
+void detail::InterfaceMap::rebuildLookupTable() {
+  // Keep the table at most half full, to bound the length of the probes.
+  unsigned numBuckets =
+      llvm::PowerOf2Ceil(std::max<size_t>(4, 2 * interfaces.size()));
+  lookupKeys.assign(numBuckets, nullptr);
+  lookupConcepts.assign(numBuckets, nullptr);
+  for (const auto &it : interfaces) {
+    const void *key = it.first.getAsOpaquePointer();
+    unsigned bucket = getBucket(key, numBuckets);
+    while (lookupKeys[bucket])
+      bucket = (bucket + 1) & (numBuckets - 1);
+    lookupKeys[bucket] = key;
+    lookupConcepts[bucket] = it.second;
+  }
 }
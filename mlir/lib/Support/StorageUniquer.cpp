@@ -11,7 +11,7 @@
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/ThreadLocalCache.h"
 #include "mlir/Support/TypeID.h"
-#include "llvm/Support/RWMutex.h"
+#include "llvm/Support/Mutex.h"
 
 using namespace mlir;
 using namespace mlir::detail;
@@ -37,65 +37,141 @@ public:
   };
 
 private:
-  /// A utility wrapper object representing a hashed storage object. This class
-  /// contains a storage object and an existing computed hash value.
-  struct HashedStorage {
-    HashedStorage(unsigned hashValue = 0, BaseStorage *storage = nullptr)
-        : hashValue(hashValue), storage(storage) {}
-    unsigned hashValue;
-    BaseStorage *storage;
-  };
-
-  /// Storage info for derived TypeStorage objects.
-  struct StorageKeyInfo {
-    static inline HashedStorage getEmptyKey() {
-      return HashedStorage(0, DenseMapInfo<BaseStorage *>::getEmptyKey());
-    }
-    static inline HashedStorage getTombstoneKey() {
-      return HashedStorage(0, DenseMapInfo<BaseStorage *>::getTombstoneKey());
+  /// This class represents a single shard of the uniquer. The uniquer uses a
+  /// set of shards to allow for multiple threads to create instances with less
+  /// lock contention.
+  ///
+  /// Storage instances are never removed from a shard, which allows for
+  /// lookups to be lock-free: the instances are held within an open addressing
+  /// table whose slots are only ever filled once. Insertions are serialized by
+  /// the shard mutex, and grow the table by publishing a rehashed copy. The
+  /// replaced tables are kept alive until the shard is destroyed, given that
+  /// concurrent lookups may still be probing them.
+  class Shard {
+  public:
+    /// Lookup an existing instance matching the given key, returns nullptr if
+    /// there is none. This is safe to call concurrently with `insert`.
+    BaseStorage *lookup(const LookupKey &key) const {
+      const Table *curTable = table.load(std::memory_order_acquire);
+      if (!curTable)
+        return nullptr;
+      for (size_t idx = curTable->getBucket(key.hashValue), probe = 1;;
+           idx = (idx + probe++) & curTable->mask) {
+        const Slot &slot = curTable->slots[idx];
+        BaseStorage *storage = slot.storage.load(std::memory_order_acquire);
+        if (!storage)
+          return nullptr;
+        if (slot.hashValue.load(std::memory_order_relaxed) == key.hashValue &&
+            key.isEqual(storage))
+          return storage;
+      }
     }
 
-    static inline unsigned getHashValue(const HashedStorage &key) {
-      return key.hashValue;
+    /// Insert a new instance with the provided hash value, which must not
+    /// already be present. This is not safe to call concurrently with another
+    /// `insert`.
+    void insert(unsigned hashValue, BaseStorage *storage) {
+      // Keep the load factor under 3/4 so that probing stays short.
+      Table *curTable = table.load(std::memory_order_relaxed);
+      if (!curTable || (numInstances + 1) * 4 > (curTable->mask + 1) * 3)
+        curTable = grow(curTable);
+      insertInto(*curTable, hashValue, storage);
+      ++numInstances;
     }
-    static inline unsigned getHashValue(const LookupKey &key) {
-      return key.hashValue;
+
+    /// Invoke the given callback on every instance within the shard.
+    void forEach(function_ref<void(BaseStorage *)> fn) const {
+      const Table *curTable = table.load(std::memory_order_relaxed);
+      if (!curTable)
+        return;
+      for (size_t i = 0, e = curTable->mask + 1; i != e; ++i)
+        if (BaseStorage *storage =
+                curTable->slots[i].storage.load(std::memory_order_relaxed))
+          fn(storage);
     }
 
-    static inline bool isEqual(const HashedStorage &lhs,
-                               const HashedStorage &rhs) {
-      return lhs.storage == rhs.storage;
+#if LLVM_ENABLE_THREADS != 0
+    /// A mutex used to serialize insertions and mutations.
+    llvm::sys::SmartMutex<true> mutex;
+#endif
+
+  private:
+    /// A single entry of the table. The hash value is written before the
+    /// storage is published, so that readers observing a non-null storage
+    /// also observe its hash.
+    struct Slot {
+      std::atomic<unsigned> hashValue{0};
+      std::atomic<BaseStorage *> storage{nullptr};
+    };
+
+    /// A power-of-two sized table of slots.
+    struct Table {
+      Table(unsigned log2Capacity)
+          : slots(new Slot[size_t(1) << log2Capacity]),
+            mask((size_t(1) << log2Capacity) - 1), log2Capacity(log2Capacity) {
+      }
+
+      /// Return the initial bucket for the given hash value. The hash is
+      /// scrambled (using Fibonacci hashing), because the low bits of the
+      /// hashes within a shard are correlated with the shard number.
+      size_t getBucket(unsigned hashValue) const {
+        return (hashValue * 2654435769u) >> (32 - log2Capacity);
+      }
+
+      std::unique_ptr<Slot[]> slots;
+      size_t mask;
+      unsigned log2Capacity;
+    };
+
+    /// Insert the given instance into an empty slot of `dest`.
+    static void insertInto(Table &dest, unsigned hashValue,
+                           BaseStorage *storage) {
+      size_t idx = dest.getBucket(hashValue);
+      for (size_t probe = 1;
+           dest.slots[idx].storage.load(std::memory_order_relaxed);
+           idx = (idx + probe++) & dest.mask)
+        continue;
+      dest.slots[idx].hashValue.store(hashValue, std::memory_order_relaxed);
+      dest.slots[idx].storage.store(storage, std::memory_order_release);
     }
-    static inline bool isEqual(const LookupKey &lhs, const HashedStorage &rhs) {
-      if (isEqual(rhs, getEmptyKey()) || isEqual(rhs, getTombstoneKey()))
-        return false;
-      // Invoke the equality function on the lookup key.
-      return lhs.isEqual(rhs.storage);
+
+    /// Publish a new table twice as large as `curTable`, containing all of the
+    /// instances of `curTable`.
+    Table *grow(Table *curTable) {
+      auto newTable = std::make_unique<Table>(
+          curTable ? curTable->log2Capacity + 1 : /*16 slots*/ 4);
+      if (curTable) {
+        for (size_t i = 0, e = curTable->mask + 1; i != e; ++i) {
+          const Slot &slot = curTable->slots[i];
+          BaseStorage *storage = slot.storage.load(std::memory_order_relaxed);
+          if (storage)
+            insertInto(*newTable,
+                       slot.hashValue.load(std::memory_order_relaxed), storage);
+        }
+      }
+      table.store(newTable.get(), std::memory_order_release);
+      tables.push_back(std::move(newTable));
+      return tables.back().get();
     }
-  };
-  using StorageTypeSet = DenseSet<HashedStorage, StorageKeyInfo>;
 
-  /// This class represents a single shard of the uniquer. The uniquer uses a
-  /// set of shards to allow for multiple threads to create instances with less
-  /// lock contention.
-  struct Shard {
-    /// The set containing the allocated storage instances.
-    StorageTypeSet instances;
+    /// The current table, which is the last element of `tables`.
+    std::atomic<Table *> table{nullptr};
 
-#if LLVM_ENABLE_THREADS != 0
-    /// A mutex to keep uniquing thread-safe.
-    llvm::sys::SmartRWMutex<true> mutex;
-#endif
+    /// All of the tables allocated for this shard.
+    std::vector<std::unique_ptr<Table>> tables;
+
+    /// The number of instances within the current table.
+    size_t numInstances = 0;
   };
 
   /// Get or create an instance of a param derived type in an thread-unsafe
   /// fashion.
   BaseStorage *getOrCreateUnsafe(Shard &shard, LookupKey &key,
                                  function_ref<BaseStorage *()> ctorFn) {
-    auto existing = shard.instances.insert_as({key.hashValue}, key);
-    BaseStorage *&storage = existing.first->storage;
-    if (existing.second)
-      storage = ctorFn();
+    if (BaseStorage *storage = shard.lookup(key))
+      return storage;
+    BaseStorage *storage = ctorFn();
+    shard.insert(key.hashValue, storage);
     return storage;
   }
 
@@ -103,17 +179,29 @@ private:
   void destroyShardInstances(Shard &shard) {
     if (!destructorFn)
       return;
-    for (HashedStorage &instance : shard.instances)
-      destructorFn(instance.storage);
+    shard.forEach(destructorFn);
   }
 
+  /// The number of bytes allocated for the instances of this uniquer.
+  std::atomic<size_t> bytesAllocated{0};
+
 public:
+  /// Record bytes allocated for the instances of this uniquer.
+  void addBytesAllocated(size_t numBytes) {
+    bytesAllocated.fetch_add(numBytes, std::memory_order_relaxed);
+  }
+
+  /// Return the number of bytes allocated for the instances of this uniquer.
+  size_t getBytesAllocated() const {
+    return bytesAllocated.load(std::memory_order_relaxed);
+  }
+
 #if LLVM_ENABLE_THREADS != 0
   /// Initialize the storage uniquer with a given number of storage shards to
   /// use. The provided shard number is required to be a valid power of 2. The
   /// destructor function is used to destroy any allocated storage instances.
   ParametricStorageUniquer(function_ref<void(BaseStorage *)> destructorFn,
-                           size_t numShards = 8)
+                           size_t numShards = 32)
       : shards(new std::atomic<Shard *>[numShards]), numShards(numShards),
         destructorFn(destructorFn) {
     assert(llvm::isPowerOf2_64(numShards) &&
@@ -139,24 +227,15 @@ public:
     if (!threadingIsEnabled)
       return getOrCreateUnsafe(shard, lookupKey, ctorFn);
 
-    // Check for a instance of this object in the local cache.
-    auto localIt = localCache->insert_as({hashValue}, lookupKey);
-    BaseStorage *&localInst = localIt.first->storage;
-    if (localInst)
-      return localInst;
-
-    // Check for an existing instance in read-only mode.
-    {
-      llvm::sys::SmartScopedReader<true> typeLock(shard.mutex);
-      auto it = shard.instances.find_as(lookupKey);
-      if (it != shard.instances.end())
-        return localInst = it->storage;
-    }
+    // Check for an existing instance, which doesn't require any locking.
+    if (BaseStorage *storage = shard.lookup(lookupKey))
+      return storage;
 
-    // Acquire a writer-lock so that we can safely create the new storage
-    // instance.
-    llvm::sys::SmartScopedWriter<true> typeLock(shard.mutex);
-    return localInst = getOrCreateUnsafe(shard, lookupKey, ctorFn);
+    // Acquire the shard lock so that we can safely create the new storage
+    // instance. The instance may have been created in the meantime, which is
+    // checked again under the lock.
+    llvm::sys::SmartScopedLock<true> typeLock(shard.mutex);
+    return getOrCreateUnsafe(shard, lookupKey, ctorFn);
   }
 
   /// Run a mutation function on the provided storage object in a thread-safe
@@ -170,7 +249,7 @@ public:
     // be the same shard as the original allocation, but does need to be
     // deterministic.
     Shard &shard = getShard(llvm::hash_value(storage));
-    llvm::sys::SmartScopedWriter<true> lock(shard.mutex);
+    llvm::sys::SmartScopedLock<true> lock(shard.mutex);
     return mutationFn();
   }
 
@@ -195,10 +274,6 @@ private:
     return *shard;
   }
 
-  /// A thread local cache for storage objects. This helps to reduce the lock
-  /// contention when an object already existing in the cache.
-  ThreadLocalCache<StorageTypeSet> localCache;
-
   /// A set of uniquer shards to allow for further bucketing accesses for
   /// instances of this storage type. Each shard is lazily initialized to reduce
   /// the overhead when only a small amount of shards are in use.
@@ -268,8 +343,16 @@ struct StorageUniquerImpl {
            "creating unregistered storage instance");
     ParametricStorageUniquer &storageUniquer = *parametricUniquers[id];
     return storageUniquer.getOrCreate(
-        threadingIsEnabled, hashValue, isEqual,
-        [&] { return ctorFn(getThreadSafeAllocator()); });
+        threadingIsEnabled, hashValue, isEqual, [&] {
+          // The allocator is only used by this thread, so the bytes it
+          // allocates in the meantime are those of the new instance.
+          StorageAllocator &allocator = getThreadSafeAllocator();
+          size_t numBytes = allocator.getBytesAllocated();
+          BaseStorage *storage = ctorFn(allocator);
+          storageUniquer.addBytesAllocated(allocator.getBytesAllocated() -
+                                           numBytes);
+          return storage;
+        });
   }
 
   /// Run a mutation function on the provided storage object in a thread-safe
@@ -281,10 +364,23 @@ struct StorageUniquerImpl {
            "mutating unregistered storage instance");
     ParametricStorageUniquer &storageUniquer = *parametricUniquers[id];
     return storageUniquer.mutate(threadingIsEnabled, storage, [&] {
-      return mutationFn(getThreadSafeAllocator());
+      StorageAllocator &allocator = getThreadSafeAllocator();
+      size_t numBytes = allocator.getBytesAllocated();
+      LogicalResult result = mutationFn(allocator);
+      storageUniquer.addBytesAllocated(allocator.getBytesAllocated() -
+                                       numBytes);
+      return result;
     });
   }
 
+  /// Return the number of bytes allocated for the instances of the given
+  /// parametric storage class.
+  size_t getBytesAllocated(TypeID id) {
+    auto it = parametricUniquers.find(id);
+    return it == parametricUniquers.end() ? 0
+                                          : it->second->getBytesAllocated();
+  }
+
   /// Return an allocator that can be used to safely allocate instances on the
   /// current thread.
   StorageAllocator &getThreadSafeAllocator() {
@@ -366,6 +462,21 @@ void StorageUniquer::disableMultithreading(bool disable) {
   impl->threadingIsEnabled = !disable;
 }
 
+size_t StorageUniquer::getBytesAllocated(TypeID id) {
+  return impl->getBytesAllocated(id);
+}
+
+size_t StorageUniquer::getBytesAllocated() {
+  size_t numBytes = impl->allocator.getBytesAllocated();
+#if LLVM_ENABLE_THREADS != 0
+  llvm::sys::SmartScopedLock<true> lock(impl->threadAllocatorMutex);
+  for (const std::unique_ptr<StorageAllocator> &allocator :
+       impl->threadAllocators)
+    numBytes += allocator->getBytesAllocated();
+#endif
+  return numBytes;
+}
+
 /// Implementation for getting/creating an instance of a derived type with
 /// parametric storage.
 auto StorageUniquer::getParametricStorageTypeImpl(
@@ -20,6 +20,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/RWMutex.h"
 #include "llvm/Support/Threading.h"
@@ -183,9 +184,12 @@ public:
 
   /// Stop the timer.
   void stop() {
-    auto newTime = std::chrono::steady_clock::now() - startTime;
+    auto stopTime = std::chrono::steady_clock::now();
+    auto newTime = stopTime - startTime;
     wallTime += newTime;
     userTime += newTime;
+    if (recordSpans)
+      spans.push_back({startTime, stopTime, llvm::get_threadid()});
   }
 
   /// Create a child timer nested within this one. Multiple calls to this
@@ -205,8 +209,10 @@ public:
   /// Tail-called from `nest()`.
   TimerImpl *nestTail(std::unique_ptr<TimerImpl> &child,
                       function_ref<std::string()> nameBuilder) {
-    if (!child)
+    if (!child) {
       child = std::make_unique<TimerImpl>(nameBuilder());
+      child->recordSpans = recordSpans;
+    }
     return child.get();
   }
 
@@ -287,6 +293,7 @@ public:
     } else {
       into->wallTime = std::max(into->wallTime, other->wallTime);
       into->userTime += other->userTime;
+      into->spans.append(other->spans.begin(), other->spans.end());
       into->mergeChildren(std::move(other->children));
       into->mergeChildren(std::move(other->asyncChildren));
       other.reset();
@@ -358,8 +365,63 @@ public:
     }
   }
 
+  /// Print the recorded executions of the timer and its children as Chrome
+  /// trace events, relative to the given origin.
+  void printAsTrace(llvm::json::OStream &json,
+                    std::chrono::steady_clock::time_point origin) {
+    auto toMicroseconds = [](std::chrono::steady_clock::duration duration) {
+      return std::chrono::duration<double, std::micro>(duration).count();
+    };
+    if (!hidden) {
+      for (const Span &span : spans) {
+        json.object([&] {
+          json.attribute("name", name);
+          json.attribute("cat", "timing");
+          json.attribute("ph", "X");
+          json.attribute("pid", 0);
+          json.attribute("tid", static_cast<int64_t>(span.threadId));
+          json.attribute("ts", toMicroseconds(span.start - origin));
+          json.attribute("dur", toMicroseconds(span.stop - span.start));
+        });
+      }
+    }
+    for (auto &child : children)
+      child.second->printAsTrace(json, origin);
+  }
+
+  /// Print the timing result in trace mode.
+  void printAsTrace(raw_ostream &os) {
+    // Use the earliest recorded execution as the origin of the trace.
+    std::optional<std::chrono::steady_clock::time_point> origin;
+    std::function<void(TimerImpl *)> findOrigin = [&](TimerImpl *timer) {
+      for (const Span &span : timer->spans)
+        if (!origin || span.start < *origin)
+          origin = span.start;
+      for (auto &child : timer->children)
+        findOrigin(child.second.get());
+    };
+    findOrigin(this);
+
+    llvm::json::OStream json(os, /*IndentSize=*/2);
+    json.object([&] {
+      json.attributeArray("traceEvents", [&] {
+        if (origin)
+          printAsTrace(json, *origin);
+      });
+      json.attribute("displayTimeUnit", "ms");
+    });
+    os << "\n";
+  }
+
   /// Print the current timing information.
   void print(raw_ostream &os, DisplayMode displayMode) {
+    // Traces are printed on their own, without the report banner.
+    if (displayMode == DisplayMode::Trace) {
+      printAsTrace(os);
+      os.flush();
+      return;
+    }
+
     // Print the banner.
     auto total = getTimeRecord();
     printTimeHeader(os, total);
@@ -372,6 +434,8 @@ public:
     case DisplayMode::Tree:
       printAsTree(os, total);
       break;
+    case DisplayMode::Trace:
+      llvm_unreachable("traces are printed separately");
     }
 
     // Print the top-level time not accounted for by child timers, and the
@@ -405,6 +469,19 @@ public:
   /// Whether to omit this timer from reports and directly show its children.
   bool hidden = false;
 
+  /// A single execution of the timer, between a start and a stop.
+  struct Span {
+    std::chrono::steady_clock::time_point start, stop;
+    uint64_t threadId;
+  };
+
+  /// Whether to record each execution of this timer, and of its children, for
+  /// trace output.
+  bool recordSpans = false;
+
+  /// The recorded executions of this timer.
+  std::vector<Span> spans;
+
   /// Child timers on the same thread the timer itself. We keep at most one
   /// timer per unique identifier.
   ChildrenMap children;
@@ -461,6 +538,7 @@ bool DefaultTimingManager::isEnabled() const { return impl->enabled; }
 /// Change the display mode.
 void DefaultTimingManager::setDisplayMode(DisplayMode displayMode) {
   impl->displayMode = displayMode;
+  impl->rootTimer->recordSpans = displayMode == DisplayMode::Trace;
 }
 
 /// Return the current display mode;
@@ -490,6 +568,7 @@ void DefaultTimingManager::print() {
 void DefaultTimingManager::clear() {
   impl->rootTimer = std::make_unique<TimerImpl>("root");
   impl->rootTimer->hidden = true;
+  impl->rootTimer->recordSpans = impl->displayMode == DisplayMode::Trace;
 }
 
 /// Debug print the timer data structures to an output stream.
@@ -548,7 +627,9 @@ struct DefaultTimingManagerOptions {
           clEnumValN(DisplayMode::List, "list",
                      "display the results in a list sorted by total time"),
           clEnumValN(DisplayMode::Tree, "tree",
-                     "display the results ina with a nested tree view"))};
+                     "display the results ina with a nested tree view"),
+          clEnumValN(DisplayMode::Trace, "trace",
+                     "display each timed execution as a Chrome trace event"))};
 };
 } // namespace
 
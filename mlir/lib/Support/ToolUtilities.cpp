@@ -14,35 +14,25 @@
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/LogicalResult.h"
 #include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace mlir;
 
-LogicalResult
-mlir::splitAndProcessBuffer(std::unique_ptr<llvm::MemoryBuffer> originalBuffer,
-                            ChunkBufferHandler processChunkBuffer,
-                            raw_ostream &os, bool enableSplitting,
-                            bool insertMarkerInOutput) {
-  // If splitting is disabled, we process the full input buffer.
-  if (!enableSplitting)
-    return processChunkBuffer(std::move(originalBuffer), os);
-
+/// Splits the main buffer of `fileSourceMgr` on the split markers, and warns
+/// about the near misses with them.
+static SmallVector<StringRef, 8> splitOnMarker(llvm::SourceMgr &fileSourceMgr) {
   const char splitMarkerConst[] = "// -----";
   StringRef splitMarker(splitMarkerConst);
   const int splitMarkerLen = splitMarker.size();
 
-  auto *origMemBuffer = originalBuffer.get();
+  const llvm::MemoryBuffer *origMemBuffer =
+      fileSourceMgr.getMemoryBuffer(fileSourceMgr.getMainFileID());
   SmallVector<StringRef, 8> rawSourceBuffers;
   const int checkLen = 2;
   // Split dropping the last checkLen chars to enable flagging near misses.
   origMemBuffer->getBuffer().split(rawSourceBuffers,
                                    splitMarker.drop_back(checkLen));
-  if (rawSourceBuffers.empty())
-    return success();
-
-  // Add the original buffer to the source manager.
-  llvm::SourceMgr fileSourceMgr;
-  fileSourceMgr.AddNewSourceBuffer(std::move(originalBuffer), SMLoc());
 
   // Flag near misses by iterating over all the sub-buffers found when splitting
   // with the prefix of the splitMarker. Use a sliding window where we only add
@@ -75,17 +65,42 @@ mlir::splitAndProcessBuffer(std::unique_ptr<llvm::MemoryBuffer> originalBuffer,
   }
   if (!prev.empty())
     sourceBuffers.push_back(prev);
+  return sourceBuffers;
+}
+
+/// Returns a copy of the chunk `subBuffer` of the main buffer of
+/// `fileSourceMgr`, named after the line it starts at.
+static std::unique_ptr<llvm::MemoryBuffer>
+createChunkBuffer(StringRef subBuffer, llvm::SourceMgr &fileSourceMgr) {
+  auto splitLoc = SMLoc::getFromPointer(subBuffer.data());
+  unsigned splitLine = fileSourceMgr.getLineAndColumn(splitLoc).first;
+  StringRef identifier =
+      fileSourceMgr.getMemoryBuffer(fileSourceMgr.getMainFileID())
+          ->getBufferIdentifier();
+  return llvm::MemoryBuffer::getMemBufferCopy(
+      subBuffer, Twine("within split at ") + identifier + ":" +
+                     Twine(splitLine) + " offset ");
+}
+
+LogicalResult
+mlir::splitAndProcessBuffer(std::unique_ptr<llvm::MemoryBuffer> originalBuffer,
+                            ChunkBufferHandler processChunkBuffer,
+                            raw_ostream &os, bool enableSplitting,
+                            bool insertMarkerInOutput) {
+  // If splitting is disabled, we process the full input buffer.
+  if (!enableSplitting)
+    return processChunkBuffer(std::move(originalBuffer), os);
+
+  // Add the original buffer to the source manager.
+  llvm::SourceMgr fileSourceMgr;
+  fileSourceMgr.AddNewSourceBuffer(std::move(originalBuffer), SMLoc());
+  SmallVector<StringRef, 8> sourceBuffers = splitOnMarker(fileSourceMgr);
 
   // Process each chunk in turn.
   bool hadFailure = false;
   auto interleaveFn = [&](StringRef subBuffer) {
-    auto splitLoc = SMLoc::getFromPointer(subBuffer.data());
-    unsigned splitLine = fileSourceMgr.getLineAndColumn(splitLoc).first;
-    auto subMemBuffer = llvm::MemoryBuffer::getMemBufferCopy(
-        subBuffer, Twine("within split at ") +
-                       origMemBuffer->getBufferIdentifier() + ":" +
-                       Twine(splitLine) + " offset ");
-    if (failed(processChunkBuffer(std::move(subMemBuffer), os)))
+    if (failed(processChunkBuffer(createChunkBuffer(subBuffer, fileSourceMgr),
+                                  os)))
       hadFailure = true;
   };
   llvm::interleave(sourceBuffers, os, interleaveFn,
@@ -94,3 +109,47 @@ mlir::splitAndProcessBuffer(std::unique_ptr<llvm::MemoryBuffer> originalBuffer,
   // If any fails, then return a failure of the tool.
   return failure(hadFailure);
 }
+
+LogicalResult mlir::splitAndProcessBufferInParallel(
+    std::unique_ptr<llvm::MemoryBuffer> originalBuffer,
+    ParallelChunkBufferHandler processChunkBuffer, raw_ostream &os,
+    llvm::ThreadPool &threadPool, bool insertMarkerInOutput) {
+  llvm::SourceMgr fileSourceMgr;
+  fileSourceMgr.AddNewSourceBuffer(std::move(originalBuffer), SMLoc());
+  SmallVector<StringRef, 8> sourceBuffers = splitOnMarker(fileSourceMgr);
+
+  // The chunk buffers are created upfront, as the source manager caches the
+  // line offsets of its buffers lazily.
+  struct ChunkResult {
+    std::unique_ptr<llvm::MemoryBuffer> buffer;
+    std::string output;
+    std::string diagnostics;
+    bool failed = false;
+  };
+  std::vector<ChunkResult> results(sourceBuffers.size());
+  for (auto it : llvm::enumerate(sourceBuffers))
+    results[it.index()].buffer = createChunkBuffer(it.value(), fileSourceMgr);
+
+  llvm::ThreadPoolTaskGroup tasks(threadPool);
+  for (ChunkResult &result : results) {
+    tasks.async([&result, processChunkBuffer] {
+      llvm::raw_string_ostream outputOS(result.output);
+      llvm::raw_string_ostream diagOS(result.diagnostics);
+      result.failed = failed(
+          processChunkBuffer(std::move(result.buffer), outputOS, diagOS));
+    });
+  }
+  tasks.wait();
+
+  // Write the outputs and the diagnostics in the order of the chunks.
+  bool hadFailure = false;
+  llvm::interleave(
+      results, os,
+      [&](const ChunkResult &result) {
+        os << result.output;
+        llvm::errs() << result.diagnostics;
+        hadFailure |= result.failed;
+      },
+      insertMarkerInOutput ? "\n// -----\n" : "");
+  return failure(hadFailure);
+}
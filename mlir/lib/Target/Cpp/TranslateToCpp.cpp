@@ -31,6 +31,11 @@ using namespace mlir;
 using namespace mlir::emitc;
 using llvm::formatv;
 
+/// The argument attributes of the LLVM dialect, which carry the aliasing and
+/// the alignment of the pointer arguments of the functions.
+static constexpr StringLiteral kNoAliasAttrName = "llvm.noalias";
+static constexpr StringLiteral kAlignAttrName = "llvm.align";
+
 /// Convenience functions to produce interleaved output with functions returning
 /// a LogicalResult. This is different than those in STLExtras as functions used
 /// on each element doesn't return a string.
@@ -517,6 +522,43 @@ static LogicalResult printOperation(CppEmitter &emitter, scf::ForOp forOp) {
   return success();
 }
 
+static LogicalResult printOperation(CppEmitter &emitter,
+                                    scf::ParallelOp parallelOp) {
+  raw_indented_ostream &os = emitter.ostream();
+
+  // The reductions would be carried across the iterations.
+  if (parallelOp.getNumResults() != 0)
+    return parallelOp.emitOpError("with reductions is not supported");
+
+  // Emit a loop nest whose innermost loop is vectorized, as its iterations are
+  // independent.
+  for (auto [index, iv] : llvm::enumerate(parallelOp.getInductionVars())) {
+    if (index + 1 == parallelOp.getNumLoops())
+      os << "#pragma omp simd\n";
+    os << "for (";
+    if (failed(emitter.emitType(parallelOp.getLoc(), iv.getType())))
+      return failure();
+    os << " " << emitter.getOrCreateName(iv) << " = "
+       << emitter.getOrCreateName(parallelOp.getLowerBound()[index]) << "; "
+       << emitter.getOrCreateName(iv) << " < "
+       << emitter.getOrCreateName(parallelOp.getUpperBound()[index]) << "; "
+       << emitter.getOrCreateName(iv)
+       << " += " << emitter.getOrCreateName(parallelOp.getStep()[index])
+       << ") {\n";
+    os.indent();
+  }
+
+  for (Operation &op : parallelOp.getBody()->without_terminator()) {
+    if (failed(emitter.emitOperation(op, /*trailingSemicolon=*/true)))
+      return failure();
+  }
+
+  for (unsigned i = 1; i < parallelOp.getNumLoops(); ++i)
+    os.unindent() << "}\n";
+  os.unindent() << "}";
+  return success();
+}
+
 static LogicalResult printOperation(CppEmitter &emitter, scf::IfOp ifOp) {
   raw_indented_ostream &os = emitter.ostream();
 
@@ -640,12 +682,31 @@ static LogicalResult printOperation(CppEmitter &emitter,
           [&](BlockArgument arg) -> LogicalResult {
             if (failed(emitter.emitType(functionOp.getLoc(), arg.getType())))
               return failure();
+            // The pointers that do not alias the other arguments let the
+            // compiler vectorize their accesses.
+            if (isa<emitc::PointerType>(arg.getType()) &&
+                functionOp.getArgAttr(arg.getArgNumber(), kNoAliasAttrName))
+              os << " __restrict";
             os << " " << emitter.getOrCreateName(arg);
             return success();
           })))
     return failure();
   os << ") {\n";
   os.indent();
+
+  // Assume the alignment of the pointer arguments.
+  for (BlockArgument arg : functionOp.getArguments()) {
+    auto alignment = functionOp.getArgAttrOfType<IntegerAttr>(
+        arg.getArgNumber(), kAlignAttrName);
+    if (!alignment || !isa<emitc::PointerType>(arg.getType()))
+      continue;
+    StringRef name = emitter.getOrCreateName(arg);
+    os << name << " = (";
+    if (failed(emitter.emitType(functionOp.getLoc(), arg.getType())))
+      return failure();
+    os << ") __builtin_assume_aligned(" << name << ", " << alignment.getInt()
+       << ");\n";
+  }
   if (emitter.shouldDeclareVariablesAtTop()) {
     // Declare all variables that hold op results including those from nested
     // regions.
@@ -696,7 +757,7 @@ static LogicalResult printOperation(CppEmitter &emitter,
       // When generating code for an scf.for op, printing a trailing semicolon
       // is handled within the printOperation function.
       bool trailingSemicolon =
-          !isa<scf::IfOp, scf::ForOp, cf::CondBranchOp>(op);
+          !isa<scf::IfOp, scf::ForOp, scf::ParallelOp, cf::CondBranchOp>(op);
 
       if (failed(emitter.emitOperation(
               op, /*trailingSemicolon=*/trailingSemicolon)))
@@ -808,8 +869,7 @@ LogicalResult CppEmitter::emitAttribute(Location loc, Attribute attr) {
     }
   }
   if (auto dense = dyn_cast<DenseIntElementsAttr>(attr)) {
-    if (auto iType = dyn_cast<IntegerType>(
-            cast<TensorType>(dense.getType()).getElementType())) {
+    if (auto iType = dyn_cast<IntegerType>(dense.getType().getElementType())) {
       os << '{';
       interleaveComma(dense, os, [&](const APInt &val) {
         printInt(val, shouldMapToUnsigned(iType.getSignedness()));
@@ -817,8 +877,7 @@ LogicalResult CppEmitter::emitAttribute(Location loc, Attribute attr) {
       os << '}';
       return success();
     }
-    if (auto iType = dyn_cast<IndexType>(
-            cast<TensorType>(dense.getType()).getElementType())) {
+    if (auto iType = dyn_cast<IndexType>(dense.getType().getElementType())) {
       os << '{';
       interleaveComma(dense, os,
                       [&](const APInt &val) { printInt(val, false); });
@@ -964,7 +1023,7 @@ LogicalResult CppEmitter::emitOperation(Operation &op, bool trailingSemicolon) {
           .Case<func::CallOp, func::ConstantOp, func::FuncOp, func::ReturnOp>(
               [&](auto op) { return printOperation(*this, op); })
           // SCF ops.
-          .Case<scf::ForOp, scf::IfOp, scf::YieldOp>(
+          .Case<scf::ForOp, scf::IfOp, scf::ParallelOp, scf::YieldOp>(
               [&](auto op) { return printOperation(*this, op); })
           // Arithmetic ops.
           .Case<arith::ConstantOp>(
@@ -1024,6 +1083,21 @@ LogicalResult CppEmitter::emitType(Location loc, Type type) {
     os << ">";
     return success();
   }
+  if (auto vType = dyn_cast<VectorType>(type)) {
+    // Emit the fixed-width vectors with the vector extension of GCC and Clang,
+    // whose arithmetic operators apply elementwise. The size of the vectors of
+    // `size_t` depends on the target.
+    Type elementType = vType.getElementType();
+    if (vType.getRank() != 1 || vType.isScalable() ||
+        !elementType.isIntOrFloat() || elementType.isInteger(1))
+      return emitError(loc, "cannot emit vector type ") << type;
+    if (failed(emitType(loc, elementType)))
+      return failure();
+    os << " __attribute__((vector_size("
+       << vType.getNumElements() * elementType.getIntOrFloatBitWidth() / 8
+       << ")))";
+    return success();
+  }
   if (auto tType = dyn_cast<TupleType>(type))
     return emitTupleType(loc, tType.getTypes());
   if (auto oType = dyn_cast<emitc::OpaqueType>(type)) {
@@ -31,6 +31,22 @@ void registerFromLLVMIRTranslation() {
                      "(discouraged: testing only!)"),
       llvm::cl::init(false));
 
+  static llvm::cl::opt<bool> dropDebugInfo(
+      "drop-debug-info",
+      llvm::cl::desc("Drop the debug information during LLVM IR import"),
+      llvm::cl::init(false));
+
+  static llvm::cl::opt<bool> dropLoopAnnotations(
+      "drop-loop-annotations",
+      llvm::cl::desc("Drop the loop annotations during LLVM IR import"),
+      llvm::cl::init(false));
+
+  static llvm::cl::opt<bool> parallelImport(
+      "parallel-import",
+      llvm::cl::desc("Import the function bodies of the LLVM IR module "
+                     "concurrently"),
+      llvm::cl::init(false));
+
   TranslateToMLIRRegistration registration(
       "import-llvm", "Translate LLVMIR to MLIR",
       [](llvm::SourceMgr &sourceMgr,
@@ -51,7 +67,8 @@ void registerFromLLVMIRTranslation() {
           return nullptr;
 
         return translateLLVMIRToModule(std::move(llvmModule), context,
-                                       emitExpensiveWarnings);
+                                       emitExpensiveWarnings, !dropDebugInfo,
+                                       !dropLoopAnnotations, parallelImport);
       },
       [](DialectRegistry &registry) {
         // Register the DLTI dialect used to express the data layout
@@ -18,16 +18,26 @@
 #include "mlir/Tools/mlir-translate/Translation.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Support/CommandLine.h"
 
 using namespace mlir;
 
 namespace mlir {
 void registerToLLVMIRTranslation() {
+  static llvm::cl::opt<unsigned> numShards(
+      "mlir-to-llvmir-shards",
+      llvm::cl::desc("Translate the functions in parallel over the given "
+                     "number of LLVM modules, linked together afterwards"),
+      llvm::cl::init(1));
+
   TranslateFromMLIRRegistration registration(
       "mlir-to-llvmir", "Translate MLIR to LLVMIR",
       [](Operation *op, raw_ostream &output) {
         llvm::LLVMContext llvmContext;
-        auto llvmModule = translateModuleToLLVMIR(op, llvmContext);
+        auto llvmModule =
+            numShards > 1
+                ? translateModuleToLLVMIRInParallel(op, llvmContext, numShards)
+                : translateModuleToLLVMIR(op, llvmContext);
         if (!llvmModule)
           return failure();
 
@@ -45,6 +45,11 @@ public:
   FailureOr<SmallVector<SymbolRefAttr>>
   lookupAccessGroupAttrs(const llvm::MDNode *node) const;
 
+  /// Copies the mapping of the access groups translated by `other`.
+  void copyAccessGroupMapping(const LoopAnnotationImporter &other) {
+    accessGroupMapping = other.accessGroupMapping;
+  }
+
   /// The ModuleImport owning this instance.
   ModuleImport &moduleImport;
 
@@ -23,6 +23,7 @@
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/Matchers.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Interfaces/DataLayoutInterfaces.h"
 #include "mlir/Tools/mlir-translate/Translation.h"
 
@@ -39,6 +40,8 @@
 #include "llvm/IR/Operator.h"
 #include "llvm/Support/ModRef.h"
 
+#include <atomic>
+
 using namespace mlir;
 using namespace mlir::LLVM;
 using namespace mlir::LLVM::detail;
@@ -154,7 +157,8 @@ getTopologicallySortedBlocks(llvm::Function *func) {
 
 ModuleImport::ModuleImport(ModuleOp mlirModule,
                            std::unique_ptr<llvm::Module> llvmModule,
-                           bool emitExpensiveWarnings)
+                           bool emitExpensiveWarnings, bool importDebugInfo,
+                           bool importLoopAnnotations)
     : builder(mlirModule->getContext()), context(mlirModule->getContext()),
       mlirModule(mlirModule), llvmModule(std::move(llvmModule)),
       iface(mlirModule->getContext()),
@@ -162,10 +166,33 @@ ModuleImport::ModuleImport(ModuleOp mlirModule,
       debugImporter(std::make_unique<DebugImporter>(mlirModule)),
       loopAnnotationImporter(
           std::make_unique<LoopAnnotationImporter>(*this, builder)),
-      emitExpensiveWarnings(emitExpensiveWarnings) {
+      emitExpensiveWarnings(emitExpensiveWarnings),
+      importDebugInfo(importDebugInfo),
+      importLoopAnnotations(importLoopAnnotations) {
   builder.setInsertionPointToStart(mlirModule.getBody());
 }
 
+ModuleImport::ModuleImport(const ModuleImport &parent,
+                           std::mutex &constantMutex)
+    : builder(parent.context), globalMetadataOp(parent.globalMetadataOp),
+      globalComdatOp(parent.globalComdatOp), context(parent.context),
+      mlirModule(parent.mlirModule), iface(parent.context),
+      aliasScopeMapping(parent.aliasScopeMapping),
+      tbaaMapping(parent.tbaaMapping), comdatMapping(parent.comdatMapping),
+      typeTranslator(*parent.context),
+      debugImporter(std::make_unique<DebugImporter>(parent.mlirModule)),
+      loopAnnotationImporter(
+          std::make_unique<LoopAnnotationImporter>(*this, builder)),
+      emitExpensiveWarnings(parent.emitExpensiveWarnings),
+      importDebugInfo(parent.importDebugInfo),
+      importLoopAnnotations(parent.importLoopAnnotations),
+      constantMutex(&constantMutex) {
+  // The dispatch tables were checked when initializing the parent.
+  (void)initializeImportInterface();
+  loopAnnotationImporter->copyAccessGroupMapping(
+      *parent.loopAnnotationImporter);
+}
+
 MetadataOp ModuleImport::getGlobalMetadataOp() {
   if (globalMetadataOp)
     return globalMetadataOp;
@@ -540,10 +567,11 @@ LogicalResult ModuleImport::convertMetadata() {
   for (const llvm::Function &func : llvmModule->functions()) {
     for (const llvm::Instruction &inst : llvm::instructions(func)) {
       // Convert access group metadata nodes.
-      if (llvm::MDNode *node =
-              inst.getMetadata(llvm::LLVMContext::MD_access_group))
-        if (failed(processAccessGroupMetadata(node)))
-          return failure();
+      if (importLoopAnnotations)
+        if (llvm::MDNode *node =
+                inst.getMetadata(llvm::LLVMContext::MD_access_group))
+          if (failed(processAccessGroupMetadata(node)))
+            return failure();
 
       // Convert alias analysis metadata nodes.
       llvm::AAMDNodes aliasAnalysisNodes = inst.getAAMetadata();
@@ -629,6 +657,37 @@ LogicalResult ModuleImport::convertFunctions() {
   return success();
 }
 
+LogicalResult ModuleImport::convertFunctionsInParallel() {
+  // Create the functions in the order of the LLVM module first, since the
+  // module body cannot be modified concurrently.
+  SmallVector<std::pair<llvm::Function *, LLVMFuncOp>> definitions;
+  for (llvm::Function &func : llvmModule->functions()) {
+    LLVMFuncOp funcOp = createFunctionOp(&func);
+    if (funcOp && !func.isDeclaration())
+      definitions.emplace_back(&func, funcOp);
+  }
+  if (definitions.empty())
+    return success();
+
+  // Import the bodies with one importer per thread, each with its own value
+  // mappings and builder, that take the next function to import until all of
+  // them are imported.
+  std::mutex constantMutex;
+  std::atomic<size_t> nextDefinition = 0;
+  size_t numWorkers =
+      std::min<size_t>(context->getNumThreads(), definitions.size());
+  return failableParallelForEachN(context, 0, numWorkers, [&](size_t) {
+    ModuleImport worker(*this, constantMutex);
+    for (size_t i = nextDefinition++; i < definitions.size();
+         i = nextDefinition++) {
+      auto [func, funcOp] = definitions[i];
+      if (failed(worker.processFunctionBody(func, funcOp)))
+        return failure();
+    }
+    return success();
+  });
+}
+
 void ModuleImport::setNonDebugMetadataAttrs(llvm::Instruction *inst,
                                             Operation *op) {
   SmallVector<std::pair<unsigned, llvm::MDNode *>> allMetadata;
@@ -636,11 +695,14 @@ void ModuleImport::setNonDebugMetadataAttrs(llvm::Instruction *inst,
   for (auto &[kind, node] : allMetadata) {
     if (!iface.isConvertibleMetadata(kind))
       continue;
+    if (!importLoopAnnotations && (kind == llvm::LLVMContext::MD_loop ||
+                                   kind == llvm::LLVMContext::MD_access_group))
+      continue;
     if (failed(iface.setMetadataAttrs(builder, kind, node, op, *this))) {
       if (emitExpensiveWarnings) {
-        Location loc = debugImporter->translateLoc(inst->getDebugLoc());
+        Location loc = translateLoc(inst->getDebugLoc());
         emitWarning(loc) << "unhandled metadata: "
-                         << diagMD(node, llvmModule.get()) << " on "
+                         << diagMD(node, inst->getModule()) << " on "
                          << diag(*inst);
       }
     }
@@ -1152,6 +1214,12 @@ FailureOr<Value> ModuleImport::convertConstantExpr(llvm::Constant *constant) {
   assert(constantInsertionBlock &&
          "expected the constant insertion block to be non-null");
 
+  // Converting a constant may create other constants in the LLVM context,
+  // which is not thread-safe.
+  std::unique_lock<std::mutex> lock;
+  if (constantMutex)
+    lock = std::unique_lock<std::mutex>(*constantMutex);
+
   // Insert the constant after the last one or at the start of the entry block.
   OpBuilder::InsertionGuard guard(builder);
   if (!constantInsertionOp)
@@ -1269,6 +1337,8 @@ ModuleImport::matchAliasScopeAttrs(llvm::Value *value) {
 }
 
 Location ModuleImport::translateLoc(llvm::DILocation *loc) {
+  if (!importDebugInfo)
+    return mlirModule.getLoc();
   return debugImporter->translateLoc(loc);
 }
 
@@ -1706,13 +1776,18 @@ void ModuleImport::convertParameterAttributes(llvm::Function *func,
 }
 
 LogicalResult ModuleImport::processFunction(llvm::Function *func) {
-  clearBlockAndValueMapping();
+  LLVMFuncOp funcOp = createFunctionOp(func);
+  if (!funcOp || func->isDeclaration())
+    return success();
+  return processFunctionBody(func, funcOp);
+}
 
+LLVMFuncOp ModuleImport::createFunctionOp(llvm::Function *func) {
   auto functionType =
       dyn_cast<LLVMFunctionType>(convertType(func->getFunctionType()));
   if (func->isIntrinsic() &&
       iface.isConvertibleIntrinsic(func->getIntrinsicID()))
-    return success();
+    return nullptr;
 
   bool dsoLocal = func->hasLocalLinkage();
   CConv cconv = convertCConvFromLLVM(func->getCallingConv());
@@ -1726,7 +1801,8 @@ LogicalResult ModuleImport::processFunction(llvm::Function *func) {
       convertLinkageFromLLVM(func->getLinkage()), dsoLocal, cconv);
 
   // Set the function debug information if available.
-  debugImporter->translate(func, funcOp);
+  if (importDebugInfo)
+    debugImporter->translate(func, funcOp);
 
   convertParameterAttributes(func, funcOp, builder);
 
@@ -1767,9 +1843,18 @@ LogicalResult ModuleImport::processFunction(llvm::Function *func) {
           << " on " << diag(*func);
     }
   }
+  return funcOp;
+}
 
-  if (func->isDeclaration())
-    return success();
+LogicalResult ModuleImport::processFunctionBody(llvm::Function *func,
+                                                LLVMFuncOp funcOp) {
+  clearBlockAndValueMapping();
+  OpBuilder::InsertionGuard guard(builder);
+
+  // Size the mappings for the values of the function upfront, rather than
+  // growing them while importing large functions.
+  blockMapping.reserve(func->size());
+  valueMapping.reserve(func->arg_size() + func->getInstructionCount());
 
   // Eagerly create all blocks.
   for (llvm::BasicBlock &bb : *func) {
@@ -1802,6 +1887,8 @@ LogicalResult ModuleImport::processBasicBlock(llvm::BasicBlock *bb,
                                               Block *block) {
   builder.setInsertionPointToStart(block);
   for (llvm::Instruction &inst : *bb) {
+    if (!importDebugInfo && isa<llvm::DbgInfoIntrinsic>(inst))
+      continue;
     if (failed(processInstruction(&inst)))
       return failure();
 
@@ -1812,7 +1899,7 @@ LogicalResult ModuleImport::processBasicBlock(llvm::BasicBlock *bb,
       setNonDebugMetadataAttrs(&inst, op);
     } else if (inst.getOpcode() != llvm::Instruction::PHI) {
       if (emitExpensiveWarnings) {
-        Location loc = debugImporter->translateLoc(inst.getDebugLoc());
+        Location loc = translateLoc(inst.getDebugLoc());
         emitWarning(loc) << "dropped instruction: " << diag(inst);
       }
     }
@@ -1834,7 +1921,9 @@ ModuleImport::translateLoopAnnotationAttr(const llvm::MDNode *node,
 OwningOpRef<ModuleOp>
 mlir::translateLLVMIRToModule(std::unique_ptr<llvm::Module> llvmModule,
                               MLIRContext *context,
-                              bool emitExpensiveWarnings) {
+                              bool emitExpensiveWarnings, bool importDebugInfo,
+                              bool importLoopAnnotations,
+                              bool importFunctionsInParallel) {
   // Preload all registered dialects to allow the import to iterate the
   // registered LLVMImportDialectInterface implementations and query the
   // supported LLVM IR constructs before starting the translation. Assumes the
@@ -1850,7 +1939,8 @@ mlir::translateLLVMIRToModule(std::unique_ptr<llvm::Module> llvmModule,
       /*column=*/0)));
 
   ModuleImport moduleImport(module.get(), std::move(llvmModule),
-                            emitExpensiveWarnings);
+                            emitExpensiveWarnings, importDebugInfo,
+                            importLoopAnnotations);
   if (failed(moduleImport.initializeImportInterface()))
     return {};
   if (failed(moduleImport.convertDataLayout()))
@@ -1861,7 +1951,9 @@ mlir::translateLLVMIRToModule(std::unique_ptr<llvm::Module> llvmModule,
     return {};
   if (failed(moduleImport.convertGlobals()))
     return {};
-  if (failed(moduleImport.convertFunctions()))
+  if (failed(importFunctionsInParallel
+                 ? moduleImport.convertFunctionsInParallel()
+                 : moduleImport.convertFunctions()))
     return {};
 
   return module;
@@ -26,6 +26,8 @@
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/RegionGraphTraits.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/LogicalResult.h"
 #include "mlir/Target/LLVMIR/LLVMTranslationInterface.h"
@@ -34,6 +36,8 @@
 #include "llvm/ADT/PostOrderIterator.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/Frontend/OpenMP/OMPIRBuilder.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/CFG.h"
@@ -46,6 +50,7 @@
 #include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
+#include "llvm/Linker/Linker.h"
 #include "llvm/Transforms/Utils/BasicBlockUtils.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 #include "llvm/Transforms/Utils/ModuleUtils.h"
@@ -1450,3 +1455,205 @@ mlir::translateModuleToLLVMIR(Operation *module, llvm::LLVMContext &llvmContext,
 
   return std::move(translator.llvmModule);
 }
+
+//===----------------------------------------------------------------------===//
+// Parallel translation
+//===----------------------------------------------------------------------===//
+
+/// Returns the linkage of `symbol` if it is a function or a global.
+static std::optional<Linkage> getSymbolLinkage(Operation *symbol) {
+  if (auto func = dyn_cast_or_null<LLVMFuncOp>(symbol))
+    return func.getLinkage();
+  if (auto global = dyn_cast_or_null<GlobalOp>(symbol))
+    return global.getLinkage();
+  return std::nullopt;
+}
+
+/// Returns true if the definition of `func` can be translated in a separate
+/// LLVM module, in which the symbols it references are declared.
+static bool canTranslateSeparately(LLVMFuncOp func, SymbolTable &symbolTable) {
+  if (func.isExternal() || func.getLinkage() != Linkage::External ||
+      func.getComdat())
+    return false;
+
+  // The OpenMP and OpenACC translations maintain module-level state.
+  WalkResult walkResult = func.walk([](Operation *op) {
+    StringRef dialect = op->getName().getDialectNamespace();
+    return dialect == "omp" || dialect == "acc" ? WalkResult::interrupt()
+                                                : WalkResult::advance();
+  });
+  if (walkResult.wasInterrupted())
+    return false;
+
+  // The referenced symbols must be visible from other modules, or be metadata
+  // that can be duplicated.
+  std::optional<SymbolTable::UseRange> uses = SymbolTable::getSymbolUses(func);
+  if (!uses)
+    return false;
+  for (const SymbolTable::SymbolUse &use : *uses) {
+    Operation *symbol =
+        symbolTable.lookup(use.getSymbolRef().getRootReference());
+    if (isa_and_nonnull<MetadataOp>(symbol))
+      continue;
+    std::optional<Linkage> linkage = getSymbolLinkage(symbol);
+    if (!linkage || *linkage == Linkage::Private ||
+        *linkage == Linkage::Internal || *linkage == Linkage::Appending)
+      return false;
+  }
+  return true;
+}
+
+/// Inserts an external declaration of `symbol`, a function or a global.
+static void declareSymbol(Operation *symbol, OpBuilder &builder) {
+  Operation *decl = builder.insert(symbol->cloneWithoutRegions());
+  auto getDeclLinkage = [&](Linkage linkage) {
+    return LinkageAttr::get(decl->getContext(), linkage == Linkage::ExternWeak
+                                                    ? Linkage::ExternWeak
+                                                    : Linkage::External);
+  };
+  if (auto func = dyn_cast<LLVMFuncOp>(decl)) {
+    func.setLinkageAttr(getDeclLinkage(func.getLinkage()));
+    func.removeComdatAttr();
+    func.removePersonalityAttr();
+    return;
+  }
+  auto global = cast<GlobalOp>(decl);
+  global.setLinkageAttr(getDeclLinkage(global.getLinkage()));
+  global.removeValueAttr();
+  global.removeComdatAttr();
+}
+
+std::unique_ptr<llvm::Module> mlir::translateModuleToLLVMIRInParallel(
+    Operation *module, llvm::LLVMContext &llvmContext, unsigned numShards,
+    StringRef name) {
+  if (!satisfiesLLVMModule(module)) {
+    module->emitOpError("can not be translated to an LLVMIR module");
+    return nullptr;
+  }
+
+  // Distribute the function definitions that can be translated separately
+  // over the shards, balancing their number of operations. The first shard
+  // holds the other operations.
+  SymbolTable symbolTable(module);
+  Block &body = getModuleBody(module);
+  SmallVector<size_t> shardSizes(std::max(numShards, 1u), 0);
+  DenseMap<Operation *, unsigned> shardOfFunction;
+  for (Operation &op : body) {
+    size_t size = 0;
+    op.walk([&](Operation *) { ++size; });
+    auto func = dyn_cast<LLVMFuncOp>(op);
+    if (!func || !canTranslateSeparately(func, symbolTable)) {
+      shardSizes[0] += size;
+      continue;
+    }
+    unsigned shard = std::distance(
+        shardSizes.begin(),
+        std::min_element(shardSizes.begin(), shardSizes.end()));
+    shardSizes[shard] += size;
+    if (shard != 0)
+      shardOfFunction[&op] = shard;
+  }
+  if (shardOfFunction.empty())
+    return translateModuleToLLVMIR(module, llvmContext, name);
+
+  // Create the modules of the shards. The other shards only keep the
+  // attributes that define the data layout and the target of the module.
+  SmallVector<OwningOpRef<Operation *>> shardModules;
+  SmallVector<OpBuilder> builders;
+  for (unsigned shard = 0; shard < shardSizes.size(); ++shard) {
+    Operation *shardModule = module->cloneWithoutRegions();
+    if (shard != 0) {
+      SmallVector<NamedAttribute> attrs;
+      for (NamedAttribute attr : shardModule->getAttrs()) {
+        if (!attr.getName().strref().contains('.') ||
+            attr.getName() == LLVMDialect::getDataLayoutAttrName() ||
+            attr.getName() == LLVMDialect::getTargetTripleAttrName() ||
+            attr.getName() == DLTIDialect::kDataLayoutAttrName)
+          attrs.push_back(attr);
+      }
+      shardModule->setAttrs(attrs);
+    }
+    builders.push_back(
+        OpBuilder::atBlockEnd(&shardModule->getRegion(0).emplaceBlock()));
+    shardModules.emplace_back(shardModule);
+  }
+
+  // Declare the symbols referenced by the functions of the other shards.
+  SmallVector<llvm::SetVector<Operation *>> referencedSymbols(
+      shardSizes.size());
+  for (auto [op, shard] : shardOfFunction) {
+    for (const SymbolTable::SymbolUse &use : *SymbolTable::getSymbolUses(op)) {
+      Operation *symbol =
+          symbolTable.lookup(use.getSymbolRef().getRootReference());
+      if (shardOfFunction.lookup(symbol) != shard)
+        referencedSymbols[shard].insert(symbol);
+    }
+  }
+  for (Operation &op : body) {
+    for (unsigned shard = 1; shard < shardSizes.size(); ++shard) {
+      if (!referencedSymbols[shard].contains(&op))
+        continue;
+      if (isa<MetadataOp>(op))
+        builders[shard].clone(op);
+      else
+        declareSymbol(&op, builders[shard]);
+    }
+  }
+
+  // Move the definitions to their shard, and declare them in the first one.
+  for (Operation &op : body) {
+    unsigned shard = shardOfFunction.lookup(&op);
+    if (op.hasTrait<OpTrait::IsTerminator>()) {
+      for (OpBuilder &builder : builders)
+        builder.clone(op);
+      continue;
+    }
+    builders[shard].clone(op);
+    if (shard != 0)
+      declareSymbol(&op, builders[0]);
+  }
+
+  // Translate the shards in parallel, the first one into `llvmContext` and
+  // the others into separate contexts.
+  SmallVector<std::unique_ptr<llvm::LLVMContext>> shardContexts;
+  for (unsigned shard = 1; shard < shardSizes.size(); ++shard)
+    shardContexts.push_back(std::make_unique<llvm::LLVMContext>());
+  SmallVector<std::unique_ptr<llvm::Module>> llvmModules(shardSizes.size());
+  LogicalResult result = failableParallelForEachN(
+      module->getContext(), 0, shardSizes.size(), [&](size_t shard) {
+        llvm::LLVMContext &shardContext =
+            shard == 0 ? llvmContext : *shardContexts[shard - 1];
+        llvmModules[shard] = translateModuleToLLVMIR(shardModules[shard].get(),
+                                                     shardContext, name);
+        return success(llvmModules[shard] != nullptr);
+      });
+  if (failed(result))
+    return nullptr;
+
+  // Link the other shards into the first one, through bitcode as they live in
+  // different contexts.
+  std::unique_ptr<llvm::Module> llvmModule = std::move(llvmModules[0]);
+  llvm::Linker linker(*llvmModule);
+  for (std::unique_ptr<llvm::Module> &shardModule :
+       llvm::drop_begin(llvmModules)) {
+    SmallVector<char> bitcode;
+    llvm::raw_svector_ostream os(bitcode);
+    llvm::WriteBitcodeToFile(*shardModule, os);
+    shardModule.reset();
+    llvm::Expected<std::unique_ptr<llvm::Module>> linkedModule =
+        llvm::parseBitcodeFile(
+            llvm::MemoryBufferRef(StringRef(bitcode.data(), bitcode.size()),
+                                  name),
+            llvmContext);
+    if (!linkedModule) {
+      module->emitError("failed to read the translated module: ")
+          << llvm::toString(linkedModule.takeError());
+      return nullptr;
+    }
+    if (linker.linkInModule(std::move(*linkedModule))) {
+      module->emitError("failed to link the translated modules");
+      return nullptr;
+    }
+  }
+  return llvmModule;
+}
@@ -10,6 +10,9 @@
 
 #include "Deserializer.h"
 
+#include "mlir/Dialect/SPIRV/IR/SPIRVDialect.h"
+#include "mlir/IR/Threading.h"
+
 using namespace mlir;
 
 OwningOpRef<spirv::ModuleOp> spirv::deserialize(ArrayRef<uint32_t> binary,
@@ -21,3 +24,19 @@ OwningOpRef<spirv::ModuleOp> spirv::deserialize(ArrayRef<uint32_t> binary,
 
   return deserializer.collect();
 }
+
+LogicalResult
+spirv::deserialize(ArrayRef<ArrayRef<uint32_t>> binaries, MLIRContext *context,
+                   SmallVectorImpl<OwningOpRef<spirv::ModuleOp>> &modules) {
+  // The dialect cannot be loaded by the threads creating its ops.
+  context->getOrLoadDialect<spirv::SPIRVDialect>();
+
+  modules.clear();
+  modules.resize(binaries.size());
+  return failableParallelForEachN(context, 0, binaries.size(),
+                                  [&](size_t index) {
+                                    modules[index] =
+                                        deserialize(binaries[index], context);
+                                    return success(modules[index] != nullptr);
+                                  });
+}
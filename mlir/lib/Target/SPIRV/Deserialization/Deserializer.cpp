@@ -148,7 +148,13 @@ LogicalResult spirv::Deserializer::processHeader() {
            << majorVersion;
   }
 
-  // TODO: generator number, bound, schema
+  // All the <id>s of the module are below the bound, and each is defined by an
+  // instruction of at least one word. Reserve the value map for as many values
+  // to avoid rehashing it as the module is deserialized.
+  uint32_t bound = binary[3];
+  valueMap.reserve(std::min<size_t>(bound, binary.size()));
+
+  // TODO: generator number, schema
   curOffset = spirv::kHeaderWordCount;
   return success();
 }
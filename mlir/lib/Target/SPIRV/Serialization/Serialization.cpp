@@ -16,6 +16,7 @@
 #include "mlir/Target/SPIRV/Serialization.h"
 
 #include "mlir/Dialect/SPIRV/IR/SPIRVAttributes.h"
+#include "mlir/IR/Threading.h"
 #include "llvm/Support/Debug.h"
 
 #define DEBUG_TYPE "spirv-serialization"
@@ -38,4 +39,20 @@ LogicalResult spirv::serialize(spirv::ModuleOp module,
   serializer.collect(binary);
   return success();
 }
+
+LogicalResult
+spirv::serialize(ArrayRef<spirv::ModuleOp> modules,
+                 SmallVectorImpl<SmallVector<uint32_t, 0>> &binaries,
+                 const SerializationOptions &options) {
+  binaries.clear();
+  binaries.resize(modules.size());
+  if (modules.empty())
+    return success();
+
+  // The serializers of the modules share no state.
+  return failableParallelForEachN(
+      modules.front().getContext(), 0, modules.size(), [&](size_t index) {
+        return serialize(modules[index], binaries[index], options);
+      });
+}
 } // namespace mlir
@@ -114,8 +114,9 @@ void Serializer::collect(SmallVectorImpl<uint32_t> &binary) {
   auto moduleSize = spirv::kHeaderWordCount + capabilities.size() +
                     extensions.size() + extendedSets.size() +
                     memoryModel.size() + entryPoints.size() +
-                    executionModes.size() + decorations.size() +
-                    typesGlobalValues.size() + functions.size();
+                    executionModes.size() + debug.size() + names.size() +
+                    decorations.size() + typesGlobalValues.size() +
+                    functions.size();
 
   binary.clear();
   binary.reserve(moduleSize);
@@ -900,10 +900,24 @@ MLIRDocument::convertToBytecode() {
 namespace {
 /// This class represents a single chunk of an MLIR text file.
 struct MLIRTextFileChunk {
-  MLIRTextFileChunk(MLIRContext &context, uint64_t lineOffset,
-                    const lsp::URIForFile &uri, StringRef contents,
-                    std::vector<lsp::Diagnostic> &diagnostics)
-      : lineOffset(lineOffset), document(context, uri, contents, diagnostics) {}
+  MLIRTextFileChunk(MLIRContext &context, const lsp::URIForFile &uri,
+                    StringRef contents)
+      : contents(contents), document(context, uri, contents, diagnostics) {}
+
+  /// Append the diagnostics emitted when parsing this chunk to
+  /// `fileDiagnostics`, anchored at the beginning of the file.
+  void getDiagnostics(const lsp::URIForFile &uri,
+                      std::vector<lsp::Diagnostic> &fileDiagnostics) {
+    for (lsp::Diagnostic diag : diagnostics) {
+      adjustLocForChunkOffset(diag.range);
+      if (diag.relatedInformation) {
+        for (auto &it : *diag.relatedInformation)
+          if (it.location.uri == uri)
+            adjustLocForChunkOffset(it.location.range);
+      }
+      fileDiagnostics.push_back(std::move(diag));
+    }
+  }
 
   /// Adjust the line number of the given range to anchor at the beginning of
   /// the file, instead of the beginning of this chunk.
@@ -916,7 +930,12 @@ struct MLIRTextFileChunk {
   void adjustLocForChunkOffset(lsp::Position &pos) { pos.line += lineOffset; }
 
   /// The line offset of this chunk from the beginning of the file.
-  uint64_t lineOffset;
+  uint64_t lineOffset = 0;
+  /// The contents of this chunk, which reference the contents of the file.
+  StringRef contents;
+  /// The diagnostics emitted when parsing this chunk, anchored at the
+  /// beginning of the chunk.
+  std::vector<lsp::Diagnostic> diagnostics;
   /// The document referred to by this chunk.
   MLIRDocument document;
 };
@@ -937,6 +956,18 @@ public:
   /// Return the current version of this text file.
   int64_t getVersion() const { return version; }
 
+  /// Update the contents of this text file. Only the chunks whose contents
+  /// changed are parsed again, the others keep their parsed state and
+  /// diagnostics.
+  void update(const lsp::URIForFile &uri, StringRef newContents,
+              int64_t newVersion, std::vector<lsp::Diagnostic> &diagnostics);
+
+  /// Update the contents of this text file with the given changes. Returns
+  /// failure if the changes could not be applied.
+  LogicalResult update(const lsp::URIForFile &uri, int64_t newVersion,
+                       ArrayRef<lsp::TextDocumentContentChangeEvent> changes,
+                       std::vector<lsp::Diagnostic> &diagnostics);
+
   //===--------------------------------------------------------------------===//
   // LSP Queries
   //===--------------------------------------------------------------------===//
@@ -982,43 +1013,86 @@ private:
 MLIRTextFile::MLIRTextFile(const lsp::URIForFile &uri, StringRef fileContents,
                            int64_t version, DialectRegistry &registry,
                            std::vector<lsp::Diagnostic> &diagnostics)
-    : context(registry, MLIRContext::Threading::DISABLED),
-      contents(fileContents.str()), version(version) {
+    : context(registry, MLIRContext::Threading::DISABLED) {
   context.allowUnregisteredDialects();
+  update(uri, fileContents, version, diagnostics);
+}
 
-  // Split the file into separate MLIR documents.
+/// Split the contents of a file into separate MLIR documents.
+static void splitIntoChunks(StringRef contents,
+                            SmallVectorImpl<StringRef> &subContents) {
   // TODO: Find a way to share the split file marker with other tools. We don't
   // want to use `splitAndProcessBuffer` here, but we do want to make sure this
   // marker doesn't go out of sync.
+  contents.split(subContents, "// -----");
+}
+
+void MLIRTextFile::update(const lsp::URIForFile &uri, StringRef newContents,
+                          int64_t newVersion,
+                          std::vector<lsp::Diagnostic> &diagnostics) {
   SmallVector<StringRef, 8> subContents;
-  StringRef(contents).split(subContents, "// -----");
-  chunks.emplace_back(std::make_unique<MLIRTextFileChunk>(
-      context, /*lineOffset=*/0, uri, subContents.front(), diagnostics));
-
-  uint64_t lineOffset = subContents.front().count('\n');
-  for (StringRef docContents : llvm::drop_begin(subContents)) {
-    unsigned currentNumDiags = diagnostics.size();
-    auto chunk = std::make_unique<MLIRTextFileChunk>(context, lineOffset, uri,
-                                                     docContents, diagnostics);
+  splitIntoChunks(newContents, subContents);
+
+  // An edit typically changes a single chunk, or inserts or removes chunks at
+  // one place. Keep the unchanged chunks before and after the edit, whose
+  // parsed state is anchored at the beginning of the chunk.
+  std::vector<std::unique_ptr<MLIRTextFileChunk>> oldChunks;
+  std::swap(oldChunks, chunks);
+  size_t maxNumReused = std::min(oldChunks.size(), subContents.size());
+  size_t numPrefix = 0;
+  while (numPrefix < maxNumReused &&
+         oldChunks[numPrefix]->contents == subContents[numPrefix])
+    ++numPrefix;
+  size_t numSuffix = 0;
+  while (numPrefix + numSuffix < maxNumReused &&
+         oldChunks[oldChunks.size() - numSuffix - 1]->contents ==
+             subContents[subContents.size() - numSuffix - 1])
+    ++numSuffix;
+
+  // The chunks reference the contents of the file, which is only replaced
+  // once the old chunks have been compared to the new ones.
+  contents = newContents.str();
+  version = newVersion;
+  subContents.clear();
+  splitIntoChunks(contents, subContents);
+
+  uint64_t lineOffset = 0;
+  for (auto [i, docContents] : llvm::enumerate(subContents)) {
+    std::unique_ptr<MLIRTextFileChunk> chunk;
+    if (i < numPrefix)
+      chunk = std::move(oldChunks[i]);
+    else if (i >= subContents.size() - numSuffix)
+      chunk = std::move(oldChunks[i + oldChunks.size() - subContents.size()]);
+    else
+      chunk = std::make_unique<MLIRTextFileChunk>(context, uri, docContents);
+    chunk->contents = docContents;
+    chunk->lineOffset = lineOffset;
     lineOffset += docContents.count('\n');
 
     // Adjust locations used in diagnostics to account for the offset from the
     // beginning of the file.
-    for (lsp::Diagnostic &diag :
-         llvm::drop_begin(diagnostics, currentNumDiags)) {
-      chunk->adjustLocForChunkOffset(diag.range);
-
-      if (!diag.relatedInformation)
-        continue;
-      for (auto &it : *diag.relatedInformation)
-        if (it.location.uri == uri)
-          chunk->adjustLocForChunkOffset(it.location.range);
-    }
+    chunk->getDiagnostics(uri, diagnostics);
     chunks.emplace_back(std::move(chunk));
   }
   totalNumLines = lineOffset;
 }
 
+LogicalResult
+MLIRTextFile::update(const lsp::URIForFile &uri, int64_t newVersion,
+                     ArrayRef<lsp::TextDocumentContentChangeEvent> changes,
+                     std::vector<lsp::Diagnostic> &diagnostics) {
+  // The changes are applied to a copy of the contents, which are referenced by
+  // the chunks until they are compared to the new ones.
+  std::string newContents = contents;
+  if (failed(
+          lsp::TextDocumentContentChangeEvent::applyTo(changes, newContents))) {
+    lsp::Logger::error("Failed to update contents of {0}", uri.file());
+    return failure();
+  }
+  update(uri, newContents, newVersion, diagnostics);
+  return success();
+}
+
 void MLIRTextFile::getLocationsOf(const lsp::URIForFile &uri,
                                   lsp::Position defPos,
                                   std::vector<lsp::Location> &locations) {
@@ -1221,8 +1295,26 @@ lsp::MLIRServer::~MLIRServer() = default;
 void lsp::MLIRServer::addOrUpdateDocument(
     const URIForFile &uri, StringRef contents, int64_t version,
     std::vector<Diagnostic> &diagnostics) {
-  impl->files[uri.file()] = std::make_unique<MLIRTextFile>(
-      uri, contents, version, impl->registry, diagnostics);
+  std::unique_ptr<MLIRTextFile> &file = impl->files[uri.file()];
+  if (file)
+    file->update(uri, contents, version, diagnostics);
+  else
+    file = std::make_unique<MLIRTextFile>(uri, contents, version,
+                                          impl->registry, diagnostics);
+}
+
+void lsp::MLIRServer::updateDocument(
+    const URIForFile &uri, ArrayRef<TextDocumentContentChangeEvent> changes,
+    int64_t version, std::vector<Diagnostic> &diagnostics) {
+  // Check that we actually have a document for this uri.
+  auto it = impl->files.find(uri.file());
+  if (it == impl->files.end())
+    return;
+
+  // Try to update the document. If we fail, erase the file from the server. A
+  // failed updated generally means we've fallen out of sync somewhere.
+  if (failed(it->second->update(uri, version, changes, diagnostics)))
+    impl->files.erase(it);
 }
 
 std::optional<int64_t> lsp::MLIRServer::removeDocument(const URIForFile &uri) {
@@ -28,6 +28,7 @@ struct Location;
 struct MLIRConvertBytecodeResult;
 struct Position;
 struct Range;
+struct TextDocumentContentChangeEvent;
 class URIForFile;
 
 /// This class implements all of the MLIR related functionality necessary for a
@@ -46,6 +47,13 @@ public:
                            int64_t version,
                            std::vector<Diagnostic> &diagnostics);
 
+  /// Update the document, with the provided `version`, at the given URI. Only
+  /// the parts of the document affected by the changes are parsed again. Any
+  /// diagnostics emitted for this document should be added to `diagnostics`.
+  void updateDocument(const URIForFile &uri,
+                      ArrayRef<TextDocumentContentChangeEvent> changes,
+                      int64_t version, std::vector<Diagnostic> &diagnostics);
+
   /// Remove the document with the given uri. Returns the version of the removed
   /// document, or std::nullopt if the uri did not have a corresponding document
   /// within the server.
@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "mlir/Tools/mlir-opt/MlirOptMain.h"
+#include "mlir/Bytecode/BytecodeReader.h"
 #include "mlir/Bytecode/BytecodeWriter.h"
 #include "mlir/Debug/CLOptionsSetup.h"
 #include "mlir/Debug/Counter.h"
@@ -36,6 +37,7 @@
 #include "mlir/Tools/ParseUtilities.h"
 #include "mlir/Tools/Plugins/DialectPlugin.h"
 #include "mlir/Tools/Plugins/PassPlugin.h"
+#include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileUtilities.h"
@@ -128,6 +130,19 @@ struct MlirOptMainConfigCLOptions : public MlirOptMainConfig {
                  "chunk independently"),
         cl::location(splitInputFileFlag), cl::init(false));
 
+    static cl::opt<bool, /*ExternalStorage=*/true> splitInputFileInParallel(
+        "split-input-file-in-parallel",
+        cl::desc("Process the chunks of a split input file concurrently, "
+                 "emitting their output and diagnostics in order"),
+        cl::location(splitInputFileInParallelFlag), cl::init(false));
+
+    static cl::opt<bool, /*ExternalStorage=*/true> streamLazyOps(
+        "stream-lazy-ops",
+        cl::desc("Run the nested pass pipelines on one operation at a time, "
+                 "lazily loading each one from the bytecode input just "
+                 "before it is processed"),
+        cl::location(streamLazyOpsFlag), cl::init(false));
+
     static cl::opt<bool, /*ExternalStorage=*/true> verifyDiagnostics(
         "verify-diagnostics",
         cl::desc("Check that emitted diagnostics match "
@@ -316,6 +331,44 @@ static LogicalResult doVerifyRoundTrip(Operation *op,
   return doVerifyRoundTrip(op, config, /*useBytecode=*/true);
 }
 
+/// Parse the bytecode file specified by the indicated SourceMgr with lazy
+/// loading enabled: only the top-level operation is materialized, and the
+/// operations nested within it are left for `reader` to materialize on demand.
+/// If 'insertImplicitModule' is true a top-level 'builtin.module' op will be
+/// inserted that contains the parsed IR, unless one exists already.
+static OwningOpRef<Operation *>
+parseLazySourceFileForTool(const std::shared_ptr<llvm::SourceMgr> &sourceMgr,
+                           const ParserConfig &config,
+                           bool insertImplicitModule,
+                           std::unique_ptr<BytecodeReader> &reader) {
+  MLIRContext *context = config.getContext();
+  const MemoryBuffer *buffer =
+      sourceMgr->getMemoryBuffer(sourceMgr->getMainFileID());
+  Location sourceFileLoc =
+      FileLineColLoc::get(context, buffer->getBufferIdentifier(),
+                          /*line=*/0, /*column=*/0);
+  if (!isBytecode(*buffer)) {
+    emitError(sourceFileLoc)
+        << "streaming lazily loaded operations requires a bytecode input";
+    return nullptr;
+  }
+
+  reader = std::make_unique<BytecodeReader>(buffer->getMemBufferRef(), config,
+                                            /*lazyLoad=*/true, sourceMgr);
+  Block block;
+  // Eagerly materialize the top-level operation, which has no parent yet, and
+  // keep everything nested within it lazy.
+  if (failed(reader->readTopLevel(
+          &block, [](Operation *op) { return !op->getParentOp(); })))
+    return nullptr;
+  if (insertImplicitModule) {
+    return detail::constructContainerOpForParserIfNecessary<ModuleOp>(
+        &block, context, sourceFileLoc);
+  }
+  return detail::constructContainerOpForParserIfNecessary<Operation *>(
+      &block, context, sourceFileLoc);
+}
+
 /// Perform the actions on the input file indicated by the command line flags
 /// within the specified context.
 ///
@@ -348,8 +401,26 @@ performActions(raw_ostream &os,
 
   // Parse the input file and reset the context threading state.
   TimingScope parserTiming = timing.nest("Parser");
-  OwningOpRef<Operation *> op = parseSourceFileForTool(
-      sourceMgr, parseConfig, !config.shouldUseExplicitModule());
+  OwningOpRef<Operation *> op;
+  std::unique_ptr<BytecodeReader> lazyReader;
+  // The lazy reader must be finalized before the IR it refers to is destroyed.
+  // On failure, drop any operation that hasn't been materialized yet.
+  auto finalizeLazyReader = llvm::make_scope_exit([&] {
+    if (lazyReader)
+      (void)lazyReader->finalize([](Operation *) { return false; });
+  });
+  if (config.shouldStreamLazyOps()) {
+    if (config.shouldVerifyRoundtrip())
+      return emitError(UnknownLoc::get(context))
+             << "round-trip verification can't be combined with streaming "
+                "lazily loaded operations";
+    op = parseLazySourceFileForTool(sourceMgr, parseConfig,
+                                    !config.shouldUseExplicitModule(),
+                                    lazyReader);
+  } else {
+    op = parseSourceFileForTool(sourceMgr, parseConfig,
+                                !config.shouldUseExplicitModule());
+  }
   parserTiming.stop();
   if (!op)
     return failure();
@@ -372,14 +443,33 @@ performActions(raw_ostream &os,
   if (failed(config.setupPassPipeline(pm)))
     return failure();
 
-  // Run the pipeline.
-  if (failed(pm.run(*op)))
+  // Run the pipeline. When streaming, each nested operation is materialized
+  // just before its nested pipelines run on it.
+  if (lazyReader) {
+    auto materialize = [&](Operation *nestedOp) -> LogicalResult {
+      if (!lazyReader->isMaterializable(nestedOp))
+        return success();
+      return lazyReader->materialize(nestedOp,
+                                     [](Operation *) { return true; });
+    };
+    if (failed(pm.runStreaming(*op, materialize)))
+      return failure();
+
+    // Materialize anything the pipeline didn't visit before printing.
+    std::unique_ptr<BytecodeReader> reader = std::move(lazyReader);
+    if (failed(reader->finalize()))
+      return failure();
+  } else if (failed(pm.run(*op))) {
     return failure();
+  }
 
   // Print the output.
   TimingScope outputTiming = timing.nest("Output");
   if (config.shouldEmitBytecode()) {
     BytecodeWriterConfig writerConfig(fallbackResourceMap);
+    // The output file is only kept on success, so there is no need to buffer
+    // the whole encoding before writing it out.
+    writerConfig.setStreamOutput();
     if (auto v = config.bytecodeVersionToEmit())
       writerConfig.setDesiredBytecodeVersion(*v);
     return writeBytecodeToFile(op.get(), os, writerConfig);
@@ -396,8 +486,8 @@ performActions(raw_ostream &os,
 }
 
 /// Parses the memory buffer.  If successfully, run a series of passes against
-/// it and print the result.
-static LogicalResult processBuffer(raw_ostream &os,
+/// it and print the result. The diagnostics are printed to `diagOS`.
+static LogicalResult processBuffer(raw_ostream &os, raw_ostream &diagOS,
                                    std::unique_ptr<MemoryBuffer> ownedBuffer,
                                    const MlirOptMainConfig &config,
                                    DialectRegistry &registry,
@@ -427,11 +517,12 @@ static LogicalResult processBuffer(raw_ostream &os,
   // If we are in verify diagnostics mode then we have a lot of work to do,
   // otherwise just perform the actions without worrying about it.
   if (!config.shouldVerifyDiagnostics()) {
-    SourceMgrDiagnosticHandler sourceMgrHandler(*sourceMgr, &context);
+    SourceMgrDiagnosticHandler sourceMgrHandler(*sourceMgr, &context, diagOS);
     return performActions(os, sourceMgr, &context, config);
   }
 
-  SourceMgrDiagnosticVerifierHandler sourceMgrHandler(*sourceMgr, &context);
+  SourceMgrDiagnosticVerifierHandler sourceMgrHandler(*sourceMgr, &context,
+                                                      diagOS);
 
   // Do any processing requested by command line flags.  We don't care whether
   // these actions succeed or fail, we only care what diagnostics they produce
@@ -467,10 +558,24 @@ LogicalResult mlir::MlirOptMain(llvm::raw_ostream &outputStream,
   if (threadPoolCtx.isMultithreadingEnabled())
     threadPool = &threadPoolCtx.getThreadPool();
 
+  // The chunks may also be processed concurrently on the same thread-pool,
+  // each buffering its diagnostics to emit them in order.
+  if (config.shouldSplitInputFile() &&
+      config.shouldSplitInputFileInParallel() && threadPool) {
+    auto chunkFn = [&](std::unique_ptr<MemoryBuffer> chunkBuffer,
+                       raw_ostream &os, raw_ostream &diagOS) {
+      return processBuffer(os, diagOS, std::move(chunkBuffer), config,
+                           registry, threadPool);
+    };
+    return splitAndProcessBufferInParallel(std::move(buffer), chunkFn,
+                                           outputStream, *threadPool,
+                                           /*insertMarkerInOutput=*/true);
+  }
+
   auto chunkFn = [&](std::unique_ptr<MemoryBuffer> chunkBuffer,
                      raw_ostream &os) {
-    return processBuffer(os, std::move(chunkBuffer), config, registry,
-                         threadPool);
+    return processBuffer(os, llvm::errs(), std::move(chunkBuffer), config,
+                         registry, threadPool);
   };
   return splitAndProcessBuffer(std::move(buffer), chunkFn, outputStream,
                                config.shouldSplitInputFile(),
@@ -517,7 +622,7 @@ LogicalResult mlir::MlirOptMain(int argc, char **argv, llvm::StringRef toolName,
 
   // Set up the input file.
   std::string errorMessage;
-  auto file = openInputFile(inputFilename, &errorMessage);
+  auto file = openSourceFile(inputFilename, &errorMessage);
   if (!file) {
     llvm::errs() << errorMessage << "\n";
     return failure();
@@ -98,11 +98,9 @@ LogicalResult mlir::mlirTranslateMain(int argc, char **argv,
   TimingScope timing = tm.getRootScope();
 
   std::string errorMessage;
-  std::unique_ptr<llvm::MemoryBuffer> input;
-  if (auto inputAlignment = translationsRequested[0]->getInputAlignment())
-    input = openInputFile(inputFilename, *inputAlignment, &errorMessage);
-  else
-    input = openInputFile(inputFilename, &errorMessage);
+  std::unique_ptr<llvm::MemoryBuffer> input =
+      openSourceFile(inputFilename, &errorMessage,
+                     translationsRequested[0]->getInputAlignment());
   if (!input) {
     llvm::errs() << errorMessage << "\n";
     return failure();
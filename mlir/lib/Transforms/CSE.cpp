@@ -15,6 +15,7 @@
 
 #include "mlir/IR/Dominance.h"
 #include "mlir/IR/PatternMatch.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/Passes.h"
@@ -33,29 +34,94 @@ namespace mlir {
 using namespace mlir;
 
 namespace {
-struct SimpleOperationInfo : public llvm::DenseMapInfo<Operation *> {
-  static unsigned getHashValue(const Operation *opC) {
+/// An operation along with its hash, which may have been precomputed.
+struct HashedOperation {
+  Operation *op;
+  unsigned hash;
+};
+
+struct SimpleOperationInfo {
+  static HashedOperation getEmptyKey() {
+    return {llvm::DenseMapInfo<Operation *>::getEmptyKey(), 0};
+  }
+  static HashedOperation getTombstoneKey() {
+    return {llvm::DenseMapInfo<Operation *>::getTombstoneKey(), 0};
+  }
+  static unsigned computeHash(Operation *op) {
     return OperationEquivalence::computeHash(
-        const_cast<Operation *>(opC),
+        op,
         /*hashOperands=*/OperationEquivalence::directHashValue,
         /*hashResults=*/OperationEquivalence::ignoreHashValue,
         OperationEquivalence::IgnoreLocations);
   }
-  static bool isEqual(const Operation *lhsC, const Operation *rhsC) {
-    auto *lhs = const_cast<Operation *>(lhsC);
-    auto *rhs = const_cast<Operation *>(rhsC);
-    if (lhs == rhs)
+  static unsigned getHashValue(const HashedOperation &key) { return key.hash; }
+  static bool isEqual(const HashedOperation &lhs, const HashedOperation &rhs) {
+    if (lhs.op == rhs.op)
       return true;
-    if (lhs == getTombstoneKey() || lhs == getEmptyKey() ||
-        rhs == getTombstoneKey() || rhs == getEmptyKey())
+    if (lhs.hash != rhs.hash)
+      return false;
+    if (lhs.op == getTombstoneKey().op || lhs.op == getEmptyKey().op ||
+        rhs.op == getTombstoneKey().op || rhs.op == getEmptyKey().op)
       return false;
     return OperationEquivalence::isEquivalentTo(
-        const_cast<Operation *>(lhsC), const_cast<Operation *>(rhsC),
-        OperationEquivalence::IgnoreLocations);
+        lhs.op, rhs.op, OperationEquivalence::IgnoreLocations);
   }
 };
+
+/// The properties of an operation that decide how it can be simplified. They
+/// don't change while the operations preceding it are simplified, except for
+/// the hash when its operands are replaced, so they can be computed for all the
+/// operations concurrently before simplifying them.
+struct CSEOpInfo {
+  enum class Kind {
+    /// The operation can't be eliminated.
+    NotEligible,
+    /// The operation is trivially dead.
+    TriviallyDead,
+    /// The operation only reads memory, and may be eliminated if no operation
+    /// writes in between it and an equivalent operation.
+    ReadOnly,
+    /// The operation has no memory effects.
+    MemoryEffectFree
+  };
+  Kind kind = Kind::NotEligible;
+  /// The hash of the operation, if it can be eliminated.
+  unsigned hash = 0;
+};
 } // namespace
 
+/// Computes the properties of `op` that decide how it can be simplified.
+static CSEOpInfo computeOpInfo(Operation *op) {
+  // Don't simplify terminator operations.
+  if (op->hasTrait<OpTrait::IsTerminator>())
+    return {};
+
+  // If the operation is already trivially dead, it is erased.
+  if (isOpTriviallyDead(op))
+    return {CSEOpInfo::Kind::TriviallyDead};
+
+  // Don't simplify operations with regions that have multiple blocks.
+  // TODO: We need additional tests to verify that we handle such IR correctly.
+  if (!llvm::all_of(op->getRegions(), [](Region &r) {
+        return r.getBlocks().empty() || llvm::hasSingleElement(r.getBlocks());
+      }))
+    return {};
+
+  // Some simple use case of operation with memory side-effect are dealt with
+  // too.
+  if (!isMemoryEffectFree(op)) {
+    auto memEffects = dyn_cast<MemoryEffectOpInterface>(op);
+    // TODO: Only basic use case for operations with MemoryEffects::Read can be
+    // eleminated now. More work needs to be done for more complicated patterns
+    // and other side-effects.
+    if (!memEffects || !memEffects.onlyHasEffect<MemoryEffects::Read>())
+      return {};
+    return {CSEOpInfo::Kind::ReadOnly, SimpleOperationInfo::computeHash(op)};
+  }
+  return {CSEOpInfo::Kind::MemoryEffectFree,
+          SimpleOperationInfo::computeHash(op)};
+}
+
 namespace {
 /// Simple common sub-expression elimination.
 class CSEDriver {
@@ -63,8 +129,12 @@ public:
   CSEDriver(RewriterBase &rewriter, DominanceInfo *domInfo)
       : rewriter(rewriter), domInfo(domInfo) {}
 
-  /// Simplify all operations within the given op.
-  void simplify(Operation *op, bool *changed = nullptr);
+  /// Simplify all operations within the given op. If `precomputeInParallel` is
+  /// set and multi-threading is enabled, the properties of the operations are
+  /// computed concurrently first, which leaves only the lookups of the
+  /// operations in dominance order to the serial walk.
+  void simplify(Operation *op, bool *changed = nullptr,
+                bool precomputeInParallel = false);
 
   int64_t getNumCSE() const { return numCSE; }
   int64_t getNumDCE() const { return numDCE; }
@@ -73,8 +143,8 @@ private:
   /// Shared implementation of operation elimination and scoped map definitions.
   using AllocatorTy = llvm::RecyclingAllocator<
       llvm::BumpPtrAllocator,
-      llvm::ScopedHashTableVal<Operation *, Operation *>>;
-  using ScopedMapTy = llvm::ScopedHashTable<Operation *, Operation *,
+      llvm::ScopedHashTableVal<HashedOperation, Operation *>>;
+  using ScopedMapTy = llvm::ScopedHashTable<HashedOperation, Operation *,
                                             SimpleOperationInfo, AllocatorTy>;
 
   /// Cache holding MemoryEffects information between two operations. The first
@@ -103,7 +173,7 @@ private:
   /// Attempt to eliminate a redundant operation. Returns success if the
   /// operation was marked for removal, failure otherwise.
   LogicalResult simplifyOperation(ScopedMapTy &knownValues, Operation *op,
-                                  bool hasSSADominance);
+                                  const CSEOpInfo &info, bool hasSSADominance);
   void simplifyBlock(ScopedMapTy &knownValues, Block *bb, bool hasSSADominance);
   void simplifyRegion(ScopedMapTy &knownValues, Region &region);
 
@@ -114,6 +184,10 @@ private:
   /// between the two operations.
   bool hasOtherSideEffectingOpInBetween(Operation *fromOp, Operation *toOp);
 
+  /// Computes the properties of all the operations nested in `op`
+  /// concurrently.
+  void precomputeOpInfos(Operation *op);
+
   /// A rewriter for modifying the IR.
   RewriterBase &rewriter;
 
@@ -122,6 +196,16 @@ private:
   DominanceInfo *domInfo = nullptr;
   MemEffectsCache memEffectsCache;
 
+  /// The precomputed properties of the operations, laid out block by block,
+  /// and the offset of the first operation of each block. These are empty
+  /// unless the properties are precomputed.
+  std::vector<CSEOpInfo> precomputedInfos;
+  DenseMap<Block *, size_t> precomputedBlockOffsets;
+
+  /// The operations whose operands were replaced, and whose precomputed hash
+  /// is stale.
+  DenseSet<Operation *> opsWithReplacedOperands;
+
   // Various statistics.
   int64_t numCSE = 0;
   int64_t numDCE = 0;
@@ -134,6 +218,9 @@ void CSEDriver::replaceUsesAndDelete(ScopedMapTy &knownValues, Operation *op,
   // If we find one then replace all uses of the current operation with the
   // existing one and mark it for deletion. We can only replace an operand in
   // an operation if it has not been visited yet.
+  if (!precomputedInfos.empty())
+    for (Operation *user : op->getUsers())
+      opsWithReplacedOperands.insert(user);
   if (hasSSADominance) {
     // If the region has SSA dominance, then we are guaranteed to have not
     // visited any use of the current operation.
@@ -148,7 +235,9 @@ void CSEDriver::replaceUsesAndDelete(ScopedMapTy &knownValues, Operation *op,
     // When the region does not have SSA dominance, we need to check if we
     // have visited a use before replacing any use.
     auto wasVisited = [&](OpOperand &operand) {
-      return !knownValues.count(operand.getOwner());
+      Operation *owner = operand.getOwner();
+      return !knownValues.count(
+          {owner, SimpleOperationInfo::computeHash(owner)});
     };
     if (auto *rewriteListener =
             dyn_cast_if_present<RewriterBase::Listener>(rewriter.getListener()))
@@ -218,38 +307,27 @@ bool CSEDriver::hasOtherSideEffectingOpInBetween(Operation *fromOp,
 
 /// Attempt to eliminate a redundant operation.
 LogicalResult CSEDriver::simplifyOperation(ScopedMapTy &knownValues,
-                                           Operation *op,
+                                           Operation *op, const CSEOpInfo &info,
                                            bool hasSSADominance) {
-  // Don't simplify terminator operations.
-  if (op->hasTrait<OpTrait::IsTerminator>())
+  if (info.kind == CSEOpInfo::Kind::NotEligible)
     return failure();
 
   // If the operation is already trivially dead just add it to the erase list.
-  if (isOpTriviallyDead(op)) {
+  if (info.kind == CSEOpInfo::Kind::TriviallyDead) {
     opsToErase.push_back(op);
     ++numDCE;
     return success();
   }
 
-  // Don't simplify operations with regions that have multiple blocks.
-  // TODO: We need additional tests to verify that we handle such IR correctly.
-  if (!llvm::all_of(op->getRegions(), [](Region &r) {
-        return r.getBlocks().empty() || llvm::hasSingleElement(r.getBlocks());
-      }))
-    return failure();
+  HashedOperation key{op, opsWithReplacedOperands.contains(op)
+                              ? SimpleOperationInfo::computeHash(op)
+                              : info.hash};
 
   // Some simple use case of operation with memory side-effect are dealt with
   // here. Operations with no side-effect are done after.
-  if (!isMemoryEffectFree(op)) {
-    auto memEffects = dyn_cast<MemoryEffectOpInterface>(op);
-    // TODO: Only basic use case for operations with MemoryEffects::Read can be
-    // eleminated now. More work needs to be done for more complicated patterns
-    // and other side-effects.
-    if (!memEffects || !memEffects.onlyHasEffect<MemoryEffects::Read>())
-      return failure();
-
+  if (info.kind == CSEOpInfo::Kind::ReadOnly) {
     // Look for an existing definition for the operation.
-    if (auto *existing = knownValues.lookup(op)) {
+    if (auto *existing = knownValues.lookup(key)) {
       if (existing->getBlock() == op->getBlock() &&
           !hasOtherSideEffectingOpInBetween(existing, op)) {
         // The operation that can be deleted has been reach with no
@@ -259,24 +337,29 @@ LogicalResult CSEDriver::simplifyOperation(ScopedMapTy &knownValues,
         return success();
       }
     }
-    knownValues.insert(op, op);
+    knownValues.insert(key, op);
     return failure();
   }
 
   // Look for an existing definition for the operation.
-  if (auto *existing = knownValues.lookup(op)) {
+  if (auto *existing = knownValues.lookup(key)) {
     replaceUsesAndDelete(knownValues, op, existing, hasSSADominance);
     ++numCSE;
     return success();
   }
 
   // Otherwise, we add this operation to the known values map.
-  knownValues.insert(op, op);
+  knownValues.insert(key, op);
   return failure();
 }
 
 void CSEDriver::simplifyBlock(ScopedMapTy &knownValues, Block *bb,
                               bool hasSSADominance) {
+  const CSEOpInfo *precomputedInfo = nullptr;
+  auto offsetIt = precomputedBlockOffsets.find(bb);
+  if (offsetIt != precomputedBlockOffsets.end())
+    precomputedInfo = &precomputedInfos[offsetIt->second];
+
   for (auto &op : *bb) {
     // Most operations don't have regions, so fast path that case.
     if (op.getNumRegions() != 0) {
@@ -294,8 +377,13 @@ void CSEDriver::simplifyBlock(ScopedMapTy &knownValues, Block *bb,
       }
     }
 
+    // The properties are computed after simplifying the nested regions, which
+    // doesn't change them.
+    CSEOpInfo info =
+        precomputedInfo ? *precomputedInfo++ : computeOpInfo(&op);
+
     // If the operation is simplified, we don't process any held regions.
-    if (succeeded(simplifyOperation(knownValues, &op, hasSSADominance)))
+    if (succeeded(simplifyOperation(knownValues, &op, info, hasSSADominance)))
       continue;
   }
   // Clear the MemoryEffects cache since its usage is by block only.
@@ -357,7 +445,27 @@ void CSEDriver::simplifyRegion(ScopedMapTy &knownValues, Region &region) {
   }
 }
 
-void CSEDriver::simplify(Operation *op, bool *changed) {
+void CSEDriver::precomputeOpInfos(Operation *op) {
+  // Lay the operations out block by block, so that each block finds the
+  // properties of its operations from the offset of its first one.
+  std::vector<Operation *> ops;
+  op->walk([&](Block *block) {
+    precomputedBlockOffsets[block] = ops.size();
+    for (Operation &nestedOp : *block)
+      ops.push_back(&nestedOp);
+  });
+
+  precomputedInfos.resize(ops.size());
+  parallelFor(op->getContext(), 0, ops.size(), [&](size_t i) {
+    precomputedInfos[i] = computeOpInfo(ops[i]);
+  });
+}
+
+void CSEDriver::simplify(Operation *op, bool *changed,
+                         bool precomputeInParallel) {
+  if (precomputeInParallel && op->getContext()->isMultithreadingEnabled())
+    precomputeOpInfos(op);
+
   /// Simplify all regions.
   ScopedMapTy knownValues;
   for (auto &region : op->getRegions())
@@ -383,6 +491,7 @@ void mlir::eliminateCommonSubExpressions(RewriterBase &rewriter,
 namespace {
 /// CSE pass.
 struct CSE : public impl::CSEBase<CSE> {
+  using CSEBase::CSEBase;
   void runOnOperation() override;
 };
 } // namespace
@@ -392,7 +501,7 @@ void CSE::runOnOperation() {
   IRRewriter rewriter(&getContext());
   CSEDriver driver(rewriter, &getAnalysis<DominanceInfo>());
   bool changed = false;
-  driver.simplify(getOperation(), &changed);
+  driver.simplify(getOperation(), &changed, parallelHashing);
 
   // Set statistics.
   numCSE = driver.getNumCSE();
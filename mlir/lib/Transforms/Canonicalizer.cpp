@@ -13,7 +13,9 @@
 
 #include "mlir/Transforms/Passes.h"
 
+#include "mlir/IR/ModifiedOpsListener.h"
 #include "mlir/Pass/Pass.h"
+#include "mlir/Rewrite/PatternApplicator.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 namespace mlir {
@@ -24,6 +26,12 @@ namespace mlir {
 using namespace mlir;
 
 namespace {
+/// A pattern profile that is printed to stderr once all of the canonicalizer
+/// instances sharing it, e.g. the clones used for multi-threading, are gone.
+struct PrintedPatternProfile : public PatternProfile {
+  ~PrintedPatternProfile() { print(llvm::errs()); }
+};
+
 /// Canonicalize operations in nested regions.
 struct Canonicalizer : public impl::CanonicalizerBase<Canonicalizer> {
   Canonicalizer() = default;
@@ -34,6 +42,8 @@ struct Canonicalizer : public impl::CanonicalizerBase<Canonicalizer> {
     this->enableRegionSimplification = config.enableRegionSimplification;
     this->maxIterations = config.maxIterations;
     this->maxNumRewrites = config.maxNumRewrites;
+    this->parallelIsolatedRegions = config.processIsolatedRegionsInParallel;
+    this->revisitChangedOps = config.revisitChangedOpsOnly;
     this->disabledPatterns = disabledPatterns;
     this->enabledPatterns = enabledPatterns;
   }
@@ -49,6 +59,8 @@ struct Canonicalizer : public impl::CanonicalizerBase<Canonicalizer> {
 
     patterns = FrozenRewritePatternSet(std::move(owningPatterns),
                                        disabledPatterns, enabledPatterns);
+    if (profilePatterns && !profile)
+      profile = std::make_shared<PrintedPatternProfile>();
     return success();
   }
   void runOnOperation() override {
@@ -57,6 +69,16 @@ struct Canonicalizer : public impl::CanonicalizerBase<Canonicalizer> {
     config.enableRegionSimplification = enableRegionSimplification;
     config.maxIterations = maxIterations;
     config.maxNumRewrites = maxNumRewrites;
+    // Canonicalization patterns are already applied concurrently when the pass
+    // is nested under parallel pipelines, so they are thread-safe.
+    config.processIsolatedRegionsInParallel = parallelIsolatedRegions;
+    config.revisitChangedOpsOnly = revisitChangedOps;
+    config.profile = profile.get();
+    // All of the modifications go through the driver, so only the modified
+    // operations need to be re-verified. The listener isn't thread-safe, so
+    // the IR is fully re-verified when processing regions in parallel.
+    if (!parallelIsolatedRegions)
+      config.listener = &getModifiedOpsListener();
     LogicalResult converged =
         applyPatternsAndFoldGreedily(getOperation(), patterns, config);
     // Canonicalization is best-effort. Non-convergence is not a pass failure.
@@ -65,6 +87,9 @@ struct Canonicalizer : public impl::CanonicalizerBase<Canonicalizer> {
   }
 
   FrozenRewritePatternSet patterns;
+
+  /// The profile of the patterns, shared with the clones of this pass.
+  std::shared_ptr<PrintedPatternProfile> profile;
 };
 } // namespace
 
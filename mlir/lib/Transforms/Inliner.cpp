@@ -265,7 +265,11 @@ namespace {
 class CallGraphSCC {
 public:
   CallGraphSCC(llvm::scc_iterator<const CallGraph *> &parentIterator)
-      : parentIterator(parentIterator) {}
+      : parentIterator(&parentIterator) {}
+  /// Construct an SCC with the given nodes, that isn't tied to an active
+  /// callgraph traversal.
+  explicit CallGraphSCC(const std::vector<CallGraphNode *> &nodes)
+      : nodes(nodes) {}
   /// Return a range over the nodes within this SCC.
   std::vector<CallGraphNode *>::iterator begin() { return nodes.begin(); }
   std::vector<CallGraphNode *>::iterator end() { return nodes.end(); }
@@ -278,13 +282,14 @@ public:
     auto it = llvm::find(nodes, node);
     if (it != nodes.end()) {
       nodes.erase(it);
-      parentIterator.ReplaceNode(node, nullptr);
+      if (parentIterator)
+        parentIterator->ReplaceNode(node, nullptr);
     }
   }
 
 private:
   std::vector<CallGraphNode *> nodes;
-  llvm::scc_iterator<const CallGraph *> &parentIterator;
+  llvm::scc_iterator<const CallGraph *> *parentIterator = nullptr;
 };
 } // namespace
 
@@ -306,6 +311,38 @@ static LogicalResult runTransformOnCGSCCs(
   return success();
 }
 
+/// Collect the SCCs of the callgraph grouped into wavefronts. Each SCC is
+/// placed in the wavefront following the deepest of the SCCs that it
+/// references, meaning that the SCCs of a wavefront are independent of each
+/// other and only reference the SCCs of the previous wavefronts. Within a
+/// wavefront, the SCCs are kept in post-order.
+static std::vector<std::vector<CallGraphSCC>>
+collectCGSCCWavefronts(const CallGraph &cg) {
+  std::vector<std::vector<CallGraphSCC>> wavefronts;
+  DenseMap<CallGraphNode *, unsigned> nodeToWavefront;
+  for (llvm::scc_iterator<const CallGraph *> cgi = llvm::scc_begin(&cg);
+       !cgi.isAtEnd(); ++cgi) {
+    // The SCCs are visited in post-order, so any referenced SCC, other than
+    // this one, has already been assigned a wavefront.
+    const std::vector<CallGraphNode *> &nodes = *cgi;
+    unsigned wavefront = 0;
+    for (CallGraphNode *node : nodes) {
+      for (const CallGraphNode::Edge &edge : *node) {
+        auto it = nodeToWavefront.find(edge.getTarget());
+        if (it != nodeToWavefront.end())
+          wavefront = std::max(wavefront, it->second + 1);
+      }
+    }
+    for (CallGraphNode *node : nodes)
+      nodeToWavefront[node] = wavefront;
+
+    if (wavefront >= wavefronts.size())
+      wavefronts.resize(wavefront + 1);
+    wavefronts[wavefront].emplace_back(nodes);
+  }
+  return wavefronts;
+}
+
 namespace {
 /// This struct represents a resolved call to a given callgraph node. Given that
 /// the call does not actually contain a direct reference to the
@@ -597,18 +634,20 @@ public:
   void runOnOperation() override;
 
 private:
-  /// Attempt to inline calls within the given scc, and run simplifications,
+  /// Attempt to inline calls within the given sccs, and run simplifications,
   /// until a fixed point is reached. This allows for the inlining of newly
-  /// devirtualized calls. Returns failure if there was a fatal error during
-  /// inlining.
-  LogicalResult inlineSCC(Inliner &inliner, CGUseList &useList,
-                          CallGraphSCC &currentSCC, MLIRContext *context);
-
-  /// Optimize the nodes within the given SCC with one of the held optimization
-  /// pass pipelines. Returns failure if an error occurred during the
-  /// optimization of the SCC, success otherwise.
-  LogicalResult optimizeSCC(CallGraph &cg, CGUseList &useList,
-                            CallGraphSCC &currentSCC, MLIRContext *context);
+  /// devirtualized calls. The sccs must be independent of each other, as the
+  /// nodes of all of them are simplified together. Returns failure if there
+  /// was a fatal error during inlining.
+  LogicalResult inlineSCCs(Inliner &inliner, CGUseList &useList,
+                           ArrayRef<CallGraphSCC *> sccs, MLIRContext *context);
+
+  /// Optimize the nodes within the given SCCs with one of the held
+  /// optimization pass pipelines. Returns failure if an error occurred during
+  /// the optimization of the SCCs, success otherwise.
+  LogicalResult optimizeSCCs(CallGraph &cg, CGUseList &useList,
+                             ArrayRef<CallGraphSCC *> sccs,
+                             MLIRContext *context);
 
   /// Optimize the nodes within the given SCC in parallel. Returns failure if an
   /// error occurred during the optimization of the SCC, success otherwise.
@@ -670,12 +709,28 @@ void InlinerPass::runOnOperation() {
     return signalPassFailure();
   }
 
-  // Run the inline transform in post-order over the SCCs in the callgraph.
   SymbolTableCollection symbolTable;
   Inliner inliner(context, cg, symbolTable);
   CGUseList useList(getOperation(), cg, symbolTable);
+
+  // If requested, run the inline transform over wavefronts of independent
+  // SCCs, from the leafs to the roots of the callgraph.
+  if (parallelSCCs) {
+    for (std::vector<CallGraphSCC> &wavefront : collectCGSCCWavefronts(cg)) {
+      SmallVector<CallGraphSCC *> sccs =
+          llvm::to_vector(llvm::make_pointer_range(wavefront));
+      if (failed(inlineSCCs(inliner, useList, sccs, context)))
+        return signalPassFailure();
+    }
+    inliner.eraseDeadCallables();
+    return;
+  }
+
+  // Otherwise, run the inline transform in post-order over the SCCs in the
+  // callgraph.
   LogicalResult result = runTransformOnCGSCCs(cg, [&](CallGraphSCC &scc) {
-    return inlineSCC(inliner, useList, scc, context);
+    CallGraphSCC *currentSCC = &scc;
+    return inlineSCCs(inliner, useList, currentSCC, context);
   });
   if (failed(result))
     return signalPassFailure();
@@ -684,48 +739,57 @@ void InlinerPass::runOnOperation() {
   inliner.eraseDeadCallables();
 }
 
-LogicalResult InlinerPass::inlineSCC(Inliner &inliner, CGUseList &useList,
-                                     CallGraphSCC &currentSCC,
-                                     MLIRContext *context) {
+LogicalResult InlinerPass::inlineSCCs(Inliner &inliner, CGUseList &useList,
+                                      ArrayRef<CallGraphSCC *> sccs,
+                                      MLIRContext *context) {
   // Continuously simplify and inline until we either reach a fixed point, or
   // hit the maximum iteration count. Simplifying early helps to refine the cost
-  // model, and in future iterations may devirtualize new calls.
+  // model, and in future iterations may devirtualize new calls. SCCs that
+  // reach a fixed point are dropped from subsequent iterations.
+  SmallVector<CallGraphSCC *> activeSCCs(sccs.begin(), sccs.end());
   unsigned iterationCount = 0;
   do {
-    if (failed(optimizeSCC(inliner.cg, useList, currentSCC, context)))
+    if (failed(optimizeSCCs(inliner.cg, useList, activeSCCs, context)))
       return failure();
-    if (failed(inlineCallsInSCC(inliner, useList, currentSCC)))
-      break;
-  } while (++iterationCount < maxInliningIterations);
+
+    SmallVector<CallGraphSCC *> changedSCCs;
+    for (CallGraphSCC *scc : activeSCCs)
+      if (succeeded(inlineCallsInSCC(inliner, useList, *scc)))
+        changedSCCs.push_back(scc);
+    activeSCCs = std::move(changedSCCs);
+  } while (!activeSCCs.empty() && ++iterationCount < maxInliningIterations);
   return success();
 }
 
-LogicalResult InlinerPass::optimizeSCC(CallGraph &cg, CGUseList &useList,
-                                       CallGraphSCC &currentSCC,
-                                       MLIRContext *context) {
+LogicalResult InlinerPass::optimizeSCCs(CallGraph &cg, CGUseList &useList,
+                                        ArrayRef<CallGraphSCC *> sccs,
+                                        MLIRContext *context) {
   // Collect the sets of nodes to simplify.
   SmallVector<CallGraphNode *, 4> nodesToVisit;
-  for (auto *node : currentSCC) {
-    if (node->isExternal())
-      continue;
+  for (CallGraphSCC *scc : sccs) {
+    for (auto *node : *scc) {
+      if (node->isExternal())
+        continue;
 
-    // Don't simplify nodes with children. Nodes with children require special
-    // handling as we may remove the node during simplification. In the future,
-    // we should be able to handle this case with proper node deletion tracking.
-    if (node->hasChildren())
-      continue;
+      // Don't simplify nodes with children. Nodes with children require
+      // special handling as we may remove the node during simplification. In
+      // the future, we should be able to handle this case with proper node
+      // deletion tracking.
+      if (node->hasChildren())
+        continue;
 
-    // We also won't apply simplifications to nodes that can't have passes
-    // scheduled on them.
-    auto *region = node->getCallableRegion();
-    if (!region->getParentOp()->hasTrait<OpTrait::IsIsolatedFromAbove>())
-      continue;
-    nodesToVisit.push_back(node);
+      // We also won't apply simplifications to nodes that can't have passes
+      // scheduled on them.
+      auto *region = node->getCallableRegion();
+      if (!region->getParentOp()->hasTrait<OpTrait::IsIsolatedFromAbove>())
+        continue;
+      nodesToVisit.push_back(node);
+    }
   }
   if (nodesToVisit.empty())
     return success();
 
-  // Optimize each of the nodes within the SCC in parallel.
+  // Optimize each of the nodes within the SCCs in parallel.
   if (failed(optimizeSCCAsync(nodesToVisit, context)))
     return failure();
 
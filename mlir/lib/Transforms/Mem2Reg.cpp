@@ -87,6 +87,14 @@ using namespace mlir;
 /// - The final fourth step uses the reaching definition to remove blocking uses
 /// in topological order.
 ///
+/// Promotion does not modify the CFG: merge points receive their new block
+/// argument in place. The dominator tree of a region, on which the merge points
+/// and the reaching definitions are computed, can therefore be shared by the
+/// promotion of all the slots of the region. This avoids recomputing it for
+/// each of the thousands of slots of large functions, the way LLVM's
+/// PromoteMemToReg computes the dominator tree once for all the allocas of a
+/// function.
+///
 /// For further reading, chapter three of SSA-based Compiler Design [1]
 /// showcases SSA construction, where mem2reg is an adaptation of the same
 /// process.
@@ -463,30 +471,11 @@ void MemorySlotPromoter::computeReachingDefInRegion(Region *region,
 
     if (info.mergePoints.contains(block)) {
       // If the block is a merge point, we need to add a block argument to hold
-      // the selected reaching definition. This has to be a bit complicated
-      // because of RewriterBase limitations: we need to create a new block with
-      // the extra block argument, move the content of the block to the new
-      // block, and replace the block with the new block in the merge point set.
-      SmallVector<Type> argTypes;
-      SmallVector<Location> argLocs;
-      for (BlockArgument arg : block->getArguments()) {
-        argTypes.push_back(arg.getType());
-        argLocs.push_back(arg.getLoc());
-      }
-      argTypes.push_back(slot.elemType);
-      argLocs.push_back(slot.ptr.getLoc());
-      Block *newBlock = rewriter.createBlock(block, argTypes, argLocs);
-
-      info.mergePoints.erase(block);
-      info.mergePoints.insert(newBlock);
-
-      rewriter.replaceAllUsesWith(block, newBlock);
-      rewriter.mergeBlocks(block, newBlock,
-                           newBlock->getArguments().drop_back());
-
-      block = newBlock;
-
-      BlockArgument blockArgument = block->getArguments().back();
+      // the selected reaching definition. The argument is added in place rather
+      // than by replacing the block, such that the dominance information shared
+      // with the promotion of the other slots remains valid.
+      BlockArgument blockArgument =
+          block->addArgument(slot.elemType, slot.ptr.getLoc());
       rewriter.setInsertionPointToStart(block);
       allocator.handleBlockArgument(slot, blockArgument, rewriter);
       job.reachingDef = blockArgument;
@@ -586,7 +575,8 @@ void MemorySlotPromoter::promoteSlot() {
 
 LogicalResult mlir::tryToPromoteMemorySlots(
     ArrayRef<PromotableAllocationOpInterface> allocators,
-    RewriterBase &rewriter, Mem2RegStatistics statistics) {
+    RewriterBase &rewriter, DominanceInfo &dominance,
+    Mem2RegStatistics statistics) {
   bool promotedAny = false;
 
   for (PromotableAllocationOpInterface allocator : allocators) {
@@ -594,7 +584,6 @@ LogicalResult mlir::tryToPromoteMemorySlots(
       if (slot.ptr.use_empty())
         continue;
 
-      DominanceInfo dominance;
       MemorySlotPromotionAnalyzer analyzer(slot, dominance);
       std::optional<MemorySlotPromotionInfo> info = analyzer.computeInfo();
       if (info) {
@@ -613,7 +602,10 @@ LogicalResult
 Mem2RegPattern::matchAndRewrite(PromotableAllocationOpInterface allocator,
                                 PatternRewriter &rewriter) const {
   hasBoundedRewriteRecursion();
-  return tryToPromoteMemorySlots({allocator}, rewriter, statistics);
+  // The pattern driver may modify the CFG between two applications, so the
+  // dominance information cannot outlive this one.
+  DominanceInfo dominance;
+  return tryToPromoteMemorySlots({allocator}, rewriter, dominance, statistics);
 }
 
 namespace {
@@ -626,6 +618,24 @@ struct Mem2Reg : impl::Mem2RegBase<Mem2Reg> {
 
     Mem2RegStatistics statictics{&promotedAmount, &newBlockArgumentAmount};
 
+    // First promote all the slots of the scope in bulk, sharing the dominance
+    // information between them. Promoting a slot may make other slots
+    // promotable, so this is repeated until no slot is promoted.
+    DominanceInfo dominance;
+    IRRewriter rewriter(&getContext());
+    while (true) {
+      SmallVector<PromotableAllocationOpInterface> allocators;
+      scopeOp->walk([&](PromotableAllocationOpInterface allocator) {
+        allocators.push_back(allocator);
+      });
+      if (failed(tryToPromoteMemorySlots(allocators, rewriter, dominance,
+                                         statictics)))
+        break;
+    }
+
+    // The greedy driver then folds the operations the promotion exposed,
+    // simplifies the regions if requested, and promotes the slots the folding
+    // made promotable.
     GreedyRewriteConfig config;
     config.enableRegionSimplification = enableRegionSimplification;
 
@@ -0,0 +1,183 @@
+//===- MergeFunctions.cpp - Pass to merge identical callables -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass that merges structurally identical callable
+// symbols, redirecting the uses of the merged symbols.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Transforms/Passes.h"
+
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/IR/Threading.h"
+#include "mlir/Interfaces/CallInterfaces.h"
+
+namespace mlir {
+#define GEN_PASS_DEF_MERGEFUNCTIONS
+#include "mlir/Transforms/Passes.h.inc"
+} // namespace mlir
+
+using namespace mlir;
+
+/// Return the attributes of the given symbol operation, excluding its name and
+/// visibility.
+static DictionaryAttr getNonSymbolAttrDictionary(Operation *op) {
+  NamedAttrList attrs(op->getAttrDictionary());
+  attrs.erase(SymbolTable::getSymbolAttrName());
+  attrs.erase(SymbolTable::getVisibilityAttrName());
+  return attrs.getDictionary(op->getContext());
+}
+
+/// Compute a hash for the given callable, that is consistent with
+/// `isEquivalentCallable`.
+static llvm::hash_code computeCallableHash(Operation *callable) {
+  llvm::hash_code hash = llvm::hash_combine(
+      callable->getName(), getNonSymbolAttrDictionary(callable));
+  callable->walk([&](Operation *op) {
+    if (op == callable)
+      return;
+    hash = llvm::hash_combine(
+        hash, OperationEquivalence::computeHash(
+                  op, OperationEquivalence::ignoreHashValue,
+                  OperationEquivalence::ignoreHashValue,
+                  OperationEquivalence::IgnoreLocations));
+  });
+  return hash;
+}
+
+/// Return true if the two given callables are structurally identical, ignoring
+/// their names, visibilities and locations.
+static bool isEquivalentCallable(Operation *lhs, Operation *rhs) {
+  if (lhs->getName() != rhs->getName() ||
+      getNonSymbolAttrDictionary(lhs) != getNonSymbolAttrDictionary(rhs))
+    return false;
+  return llvm::all_of_zip(
+      lhs->getRegions(), rhs->getRegions(), [](Region &lhs, Region &rhs) {
+        return OperationEquivalence::isRegionEquivalentTo(
+            &lhs, &rhs, OperationEquivalence::IgnoreLocations);
+      });
+}
+
+namespace {
+struct MergeFunctions : public impl::MergeFunctionsBase<MergeFunctions> {
+  void runOnOperation() override;
+
+  /// Merge the identical callables directly nested within the given symbol
+  /// table. Returns the number of callables that were merged.
+  unsigned mergeIdenticalCallables(Operation *symbolTableOp);
+};
+} // namespace
+
+void MergeFunctions::runOnOperation() {
+  Operation *symbolTableOp = getOperation();
+  if (!symbolTableOp->hasTrait<OpTrait::SymbolTable>()) {
+    symbolTableOp->emitOpError()
+        << " was scheduled to run under MergeFunctions, but does not define a "
+           "symbol table";
+    return signalPassFailure();
+  }
+
+  // Redirecting the uses of merged callables may make their users identical,
+  // so iterate until a fixed point is reached.
+  bool changed = false;
+  while (unsigned numMergedCallables = mergeIdenticalCallables(symbolTableOp)) {
+    numMerged += numMergedCallables;
+    changed = true;
+  }
+  if (!changed)
+    markAllAnalysesPreserved();
+}
+
+unsigned MergeFunctions::mergeIdenticalCallables(Operation *symbolTableOp) {
+  // Collect the callables that may be merged.
+  SmallVector<Operation *> callables;
+  for (Operation &op : symbolTableOp->getRegion(0).getOps()) {
+    auto symbol = dyn_cast<SymbolOpInterface>(&op);
+    if (!symbol || symbol.isDeclaration() || !isa<CallableOpInterface>(op) ||
+        !op.hasTrait<OpTrait::IsIsolatedFromAbove>())
+      continue;
+    callables.push_back(&op);
+  }
+  if (callables.size() < 2)
+    return 0;
+
+  // Hash each of the callables in parallel, and group the callables with the
+  // same hash while keeping them in their original order.
+  MLIRContext *context = symbolTableOp->getContext();
+  SmallVector<std::pair<size_t, size_t>> hashes(callables.size());
+  parallelFor(context, 0, callables.size(), [&](size_t i) {
+    hashes[i] = {computeCallableHash(callables[i]), i};
+  });
+  llvm::sort(hashes);
+
+  SmallVector<ArrayRef<std::pair<size_t, size_t>>> hashGroups;
+  for (size_t i = 0, e = hashes.size(); i != e;) {
+    size_t groupEnd = i + 1;
+    while (groupEnd != e && hashes[groupEnd].first == hashes[i].first)
+      ++groupEnd;
+    if (groupEnd - i > 1)
+      hashGroups.push_back(ArrayRef(hashes).slice(i, groupEnd - i));
+    i = groupEnd;
+  }
+  if (hashGroups.empty())
+    return 0;
+
+  // Partition each group of callables into sets of identical callables, in
+  // parallel.
+  std::vector<SmallVector<SmallVector<Operation *, 2>, 1>> equivalenceClasses(
+      hashGroups.size());
+  parallelFor(context, 0, hashGroups.size(), [&](size_t i) {
+    auto &classes = equivalenceClasses[i];
+    for (const auto &it : hashGroups[i]) {
+      Operation *callable = callables[it.second];
+      auto *classIt = llvm::find_if(classes, [&](ArrayRef<Operation *> cls) {
+        return isEquivalentCallable(cls.front(), callable);
+      });
+      if (classIt == classes.end())
+        classes.emplace_back().push_back(callable);
+      else
+        classIt->push_back(callable);
+    }
+  });
+
+  // Select the callable to keep within each set, preferring public symbols,
+  // and redirect the uses of the others to it.
+  SymbolTableCollection symbolTable;
+  std::optional<SymbolUserMap> userMap;
+  SmallVector<Operation *> mergedCallables;
+  for (auto &classes : equivalenceClasses) {
+    for (SmallVector<Operation *, 2> &cls : classes) {
+      if (cls.size() < 2)
+        continue;
+      auto *keptIt = llvm::find_if(cls, [](Operation *callable) {
+        return cast<SymbolOpInterface>(callable).isPublic();
+      });
+      Operation *kept = keptIt == cls.end() ? cls.front() : *keptIt;
+      StringAttr keptName = cast<SymbolOpInterface>(kept).getNameAttr();
+      for (Operation *callable : cls) {
+        // Only private symbols are known to have all of their uses visible.
+        if (callable == kept || !cast<SymbolOpInterface>(callable).isPrivate())
+          continue;
+        if (!userMap)
+          userMap.emplace(symbolTable, symbolTableOp);
+        userMap->replaceAllUsesWith(callable, keptName);
+        mergedCallables.push_back(callable);
+      }
+    }
+  }
+
+  // Erase the merged callables after all of the uses have been redirected, as
+  // they may be users of each other.
+  for (Operation *callable : mergedCallables)
+    callable->erase();
+  return mergedCallables.size();
+}
+
+std::unique_ptr<Pass> mlir::createMergeFunctionsPass() {
+  return std::make_unique<MergeFunctions>();
+}
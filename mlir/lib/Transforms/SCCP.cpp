@@ -122,6 +122,21 @@ struct SCCP : public impl::SCCPBase<SCCP> {
 void SCCP::runOnOperation() {
   Operation *op = getOperation();
 
+  if (parallel) {
+    auto loadAnalyses = [](DataFlowSolver &solver) {
+      solver.load<DeadCodeAnalysis>();
+      solver.load<SparseConstantPropagation>();
+    };
+    auto rewritePartition = [](Operation *partition, DataFlowSolver &solver) {
+      rewrite(solver, partition->getContext(), partition->getRegions());
+      return success();
+    };
+    if (failed(
+            solveIsolatedRegionsInParallel(op, loadAnalyses, rewritePartition)))
+      signalPassFailure();
+    return;
+  }
+
   DataFlowSolver solver;
   solver.load<DeadCodeAnalysis>();
   solver.load<SparseConstantPropagation>();
@@ -30,7 +30,7 @@ struct SymbolDCE : public impl::SymbolDCEBase<SymbolDCE> {
   /// `symbolTableIsHidden` is true if this symbol table is known to be
   /// unaccessible from operations in its parent regions.
   LogicalResult computeLiveness(Operation *symbolTableOp,
-                                SymbolTableCollection &symbolTable,
+                                const SymbolUseIndex &symbolUses,
                                 bool symbolTableIsHidden,
                                 DenseSet<Operation *> &liveSymbols);
 };
@@ -54,12 +54,16 @@ void SymbolDCE::runOnOperation() {
   if (symbolTableOp->getParentOp() && symbol)
     symbolTableIsHidden = symbol.isPrivate();
 
-  // Compute the set of live symbols within the symbol table.
+  // Compute the set of live symbols within the symbol table, using an index of
+  // the symbol uses that is built up front.
   DenseSet<Operation *> liveSymbols;
-  SymbolTableCollection symbolTable;
-  if (failed(computeLiveness(symbolTableOp, symbolTable, symbolTableIsHidden,
-                             liveSymbols)))
-    return signalPassFailure();
+  {
+    SymbolTableCollection symbolTable;
+    SymbolUseIndex symbolUses(symbolTable, symbolTableOp);
+    if (failed(computeLiveness(symbolTableOp, symbolUses, symbolTableIsHidden,
+                               liveSymbols)))
+      return signalPassFailure();
+  }
 
   // After computing the liveness, delete all of the symbols that were found to
   // be dead.
@@ -81,7 +85,7 @@ void SymbolDCE::runOnOperation() {
 /// `symbolTableIsHidden` is true if this symbol table is known to be
 /// unaccessible from operations in its parent regions.
 LogicalResult SymbolDCE::computeLiveness(Operation *symbolTableOp,
-                                         SymbolTableCollection &symbolTable,
+                                         const SymbolUseIndex &symbolUses,
                                          bool symbolTableIsHidden,
                                          DenseSet<Operation *> &liveSymbols) {
   // A worklist of live operations to propagate uses from.
@@ -115,32 +119,23 @@ LogicalResult SymbolDCE::computeLiveness(Operation *symbolTableOp,
       // symbol, or if it is a private symbol.
       SymbolOpInterface symbol = dyn_cast<SymbolOpInterface>(op);
       bool symIsHidden = symbolTableIsHidden || !symbol || symbol.isPrivate();
-      if (failed(computeLiveness(op, symbolTable, symIsHidden, liveSymbols)))
+      if (failed(computeLiveness(op, symbolUses, symIsHidden, liveSymbols)))
         return failure();
     }
 
-    // Collect the uses held by this operation.
-    std::optional<SymbolTable::UseRange> uses = SymbolTable::getSymbolUses(op);
-    if (!uses) {
+    // Collect the symbols referenced by this operation.
+    FailureOr<ArrayRef<Operation *>> referencedSymbols =
+        symbolUses.getReferencedSymbols(op);
+    if (failed(referencedSymbols)) {
       return op->emitError()
              << "operation contains potentially unknown symbol table, "
                 "meaning that we can't reliable compute symbol uses";
     }
 
-    SmallVector<Operation *, 4> resolvedSymbols;
-    for (const SymbolTable::SymbolUse &use : *uses) {
-      // Lookup the symbols referenced by this use.
-      resolvedSymbols.clear();
-      if (failed(symbolTable.lookupSymbolIn(
-              op->getParentOp(), use.getSymbolRef(), resolvedSymbols)))
-        // Ignore references to unknown symbols.
-        continue;
-
-      // Mark each of the resolved symbols as live.
-      for (Operation *resolvedSymbol : resolvedSymbols)
-        if (liveSymbols.insert(resolvedSymbol).second)
-          worklist.push_back(resolvedSymbol);
-    }
+    // Mark each of the referenced symbols as live.
+    for (Operation *referencedSymbol : *referencedSymbols)
+      if (liveSymbols.insert(referencedSymbol).second)
+        worklist.push_back(referencedSymbol);
   }
 
   return success();
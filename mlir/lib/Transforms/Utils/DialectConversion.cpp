@@ -13,10 +13,12 @@
 #include "mlir/IR/FunctionInterfaces.h"
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/Iterators.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Rewrite/PatternApplicator.h"
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Support/Allocator.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/SaveAndRestore.h"
@@ -190,18 +192,28 @@ struct RewriterState {
 
 /// The state of an operation that was updated by a pattern in-place. This
 /// contains all of the necessary information to reconstruct an operation that
-/// was updated in place.
+/// was updated in place, unless the state was created without a snapshot of
+/// the operation when rollback is disabled.
 class OperationTransactionState {
 public:
   OperationTransactionState() = default;
-  OperationTransactionState(Operation *op)
-      : op(op), loc(op->getLoc()), attrs(op->getAttrDictionary()),
-        operands(op->operand_begin(), op->operand_end()),
-        successors(op->successor_begin(), op->successor_end()) {}
+  OperationTransactionState(Operation *op, bool takeSnapshot = true)
+      : op(op), hasSnapshot(takeSnapshot) {
+    if (!takeSnapshot)
+      return;
+    loc = op->getLoc();
+    attrs = op->getAttrDictionary();
+    operands.assign(op->operand_begin(), op->operand_end());
+    successors.assign(op->successor_begin(), op->successor_end());
+  }
+
+  /// Return true if the original operation can be reset.
+  bool canResetOperation() const { return hasSnapshot; }
 
   /// Discard the transaction state and reset the state of the original
   /// operation.
   void resetOperation() const {
+    assert(hasSnapshot && "cannot reset an operation without a snapshot");
     op->setLoc(loc);
     op->setAttrs(attrs);
     op->setOperands(operands);
@@ -214,6 +226,7 @@ public:
 
 private:
   Operation *op;
+  bool hasSnapshot = false;
   LocationAttr loc;
   DictionaryAttr attrs;
   SmallVector<Value, 8> operands;
@@ -816,6 +829,10 @@ struct ConversionPatternRewriterImpl {
       : argConverter(rewriter, unresolvedMaterializations),
         notifyCallback(nullptr) {}
 
+  /// Record that an in-place modification of `op` had to be rolled back, which
+  /// isn't possible when rollback is disabled.
+  void notifyUnrecoverableRollback(Operation *op);
+
   /// Cleanup and destroy any generated rewrite operations. This method is
   /// invoked when the conversion process fails.
   void discardRewrites();
@@ -967,6 +984,13 @@ struct ConversionPatternRewriterImpl {
   /// This allows the user to collect the match failure message.
   function_ref<void(Diagnostic &)> notifyCallback;
 
+  /// Whether in-place modifications keep the state needed to roll them back.
+  bool allowPatternRollback = true;
+
+  /// The name of the first operation whose in-place modification had to be
+  /// rolled back while rollback was disabled, if any.
+  std::optional<OperationName> unrecoverableRollbackOpName;
+
 #ifndef NDEBUG
   /// A set of operations that have pending updates. This tracking isn't
   /// strictly necessary, and is thus only active during debug builds for extra
@@ -1000,10 +1024,18 @@ static void detachNestedAndErase(Operation *op) {
   op->erase();
 }
 
+void ConversionPatternRewriterImpl::notifyUnrecoverableRollback(
+    Operation *op) {
+  if (!unrecoverableRollbackOpName)
+    unrecoverableRollbackOpName = op->getName();
+}
+
 void ConversionPatternRewriterImpl::discardRewrites() {
-  // Reset any operations that were updated in place.
+  // Reset any operations that were updated in place, if possible. When
+  // rollback is disabled, the IR is left in a state that must be discarded.
   for (auto &state : rootUpdates)
-    state.resetOperation();
+    if (state.canResetOperation())
+      state.resetOperation();
 
   undoBlockActions();
 
@@ -1084,8 +1116,12 @@ RewriterState ConversionPatternRewriterImpl::getCurrentState() {
 
 void ConversionPatternRewriterImpl::resetState(RewriterState state) {
   // Reset any operations that were updated in place.
-  for (unsigned i = state.numRootUpdates, e = rootUpdates.size(); i != e; ++i)
-    rootUpdates[i].resetOperation();
+  for (unsigned i = state.numRootUpdates, e = rootUpdates.size(); i != e; ++i) {
+    if (rootUpdates[i].canResetOperation())
+      rootUpdates[i].resetOperation();
+    else
+      notifyUnrecoverableRollback(rootUpdates[i].getOperation());
+  }
   rootUpdates.resize(state.numRootUpdates);
 
   // Reset any replaced arguments.
@@ -1604,7 +1640,7 @@ void ConversionPatternRewriter::startRootUpdate(Operation *op) {
 #ifndef NDEBUG
   impl->pendingRootUpdates.insert(op);
 #endif
-  impl->rootUpdates.emplace_back(op);
+  impl->rootUpdates.emplace_back(op, impl->allowPatternRollback);
 }
 
 void ConversionPatternRewriter::finalizeRootUpdate(Operation *op) {
@@ -1627,7 +1663,10 @@ void ConversionPatternRewriter::cancelRootUpdate(Operation *op) {
   auto &rootUpdates = impl->rootUpdates;
   auto it = llvm::find_if(llvm::reverse(rootUpdates), stateHasOp);
   assert(it != rootUpdates.rend() && "no root update started on op");
-  (*it).resetOperation();
+  if (it->canResetOperation())
+    it->resetOperation();
+  else
+    impl->notifyUnrecoverableRollback(op);
   int updateIdx = std::prev(rootUpdates.rend()) - it;
   rootUpdates.erase(rootUpdates.begin() + updateIdx);
 }
@@ -1672,6 +1711,38 @@ namespace {
 /// A set of rewrite patterns that can be used to legalize a given operation.
 using LegalizationPatterns = SmallVector<const Pattern *, 1>;
 
+/// The key of the legality cache of an OperationLegalizer: the name of an
+/// operation, followed by the types of its operands and results.
+struct LegalityCacheKey {
+  OperationName name;
+  unsigned numOperands;
+  ArrayRef<Type> types;
+};
+} // namespace
+
+namespace llvm {
+template <>
+struct DenseMapInfo<LegalityCacheKey> {
+  static LegalityCacheKey getEmptyKey() {
+    return {DenseMapInfo<OperationName>::getEmptyKey(), 0, {}};
+  }
+  static LegalityCacheKey getTombstoneKey() {
+    return {DenseMapInfo<OperationName>::getTombstoneKey(), 0, {}};
+  }
+  static unsigned getHashValue(const LegalityCacheKey &key) {
+    return llvm::hash_combine(
+        key.name.getAsOpaquePointer(), key.numOperands,
+        llvm::hash_combine_range(key.types.begin(), key.types.end()));
+  }
+  static bool isEqual(const LegalityCacheKey &lhs,
+                      const LegalityCacheKey &rhs) {
+    return lhs.name == rhs.name && lhs.numOperands == rhs.numOperands &&
+           lhs.types == rhs.types;
+  }
+};
+} // namespace llvm
+
+namespace {
 /// This class defines a recursive operation legalizer.
 class OperationLegalizer {
 public:
@@ -1683,6 +1754,11 @@ public:
   /// Returns true if the given operation is known to be illegal on the target.
   bool isIllegal(Operation *op) const;
 
+  /// Returns the legality information of the given operation if it is legal
+  /// on the target, see `ConversionTarget::isLegal`. The result is cached for
+  /// operations whose legality is type based.
+  std::optional<ConversionTarget::LegalOpDetails> isLegal(Operation *op);
+
   /// Attempt to legalize the given operation. Returns success if the operation
   /// was legalized, failure otherwise.
   LogicalResult legalize(Operation *op, ConversionPatternRewriter &rewriter);
@@ -1770,6 +1846,16 @@ private:
 
   /// The pattern applicator to use for conversions.
   PatternApplicator applicator;
+
+  /// The cached legality of the operations whose legality is type based. The
+  /// key only refers to the types of an operation, so an operation updated in
+  /// place without changing its types keeps its legality, and an operation
+  /// updated with new types maps to a different key.
+  DenseMap<LegalityCacheKey, std::optional<ConversionTarget::LegalOpDetails>>
+      legalityCache;
+
+  /// The storage of the types referenced by the keys of `legalityCache`.
+  llvm::BumpPtrAllocator legalityCacheTypeStorage;
 };
 } // namespace
 
@@ -1789,6 +1875,28 @@ bool OperationLegalizer::isIllegal(Operation *op) const {
   return target.isIllegal(op);
 }
 
+std::optional<ConversionTarget::LegalOpDetails>
+OperationLegalizer::isLegal(Operation *op) {
+  OperationName name = op->getName();
+  if (!target.isOpLegalityTypeBased(name))
+    return target.isLegal(op);
+
+  SmallVector<Type, 8> types(op->getOperandTypes());
+  llvm::append_range(types, op->getResultTypes());
+  LegalityCacheKey key{name, op->getNumOperands(), types};
+  auto it = legalityCache.find(key);
+  if (it != legalityCache.end())
+    return it->second;
+
+  // Copy the types into storage owned by the legalizer before caching.
+  std::optional<ConversionTarget::LegalOpDetails> legality = target.isLegal(op);
+  Type *storedTypes = legalityCacheTypeStorage.Allocate<Type>(types.size());
+  std::uninitialized_copy(types.begin(), types.end(), storedTypes);
+  key.types = ArrayRef<Type>(storedTypes, types.size());
+  legalityCache.try_emplace(key, legality);
+  return legality;
+}
+
 LogicalResult
 OperationLegalizer::legalize(Operation *op,
                              ConversionPatternRewriter &rewriter) {
@@ -1813,7 +1921,7 @@ OperationLegalizer::legalize(Operation *op,
   });
 
   // Check if this operation is legal on the target.
-  if (auto legalityInfo = target.isLegal(op)) {
+  if (auto legalityInfo = isLegal(op)) {
     LLVM_DEBUG({
       logSuccess(
           logger, "operation marked legal by the target{0}",
@@ -2305,13 +2413,18 @@ struct OperationConverter {
   explicit OperationConverter(ConversionTarget &target,
                               const FrozenRewritePatternSet &patterns,
                               OpConversionMode mode,
-                              DenseSet<Operation *> *trackedOps = nullptr)
-      : opLegalizer(target, patterns), mode(mode), trackedOps(trackedOps) {}
-
-  /// Converts the given operations to the conversion target.
-  LogicalResult
-  convertOperations(ArrayRef<Operation *> ops,
-                    function_ref<void(Diagnostic &)> notifyCallback = nullptr);
+                              DenseSet<Operation *> *trackedOps = nullptr,
+                              const ConversionConfig &config = {})
+      : opLegalizer(target, patterns), mode(mode), trackedOps(trackedOps),
+        config(config) {}
+
+  /// Converts the given operations to the conversion target. The operations
+  /// nested in the ops of `opsWithConvertedBodies`, if provided, are not
+  /// converted, as they were already.
+  LogicalResult convertOperations(
+      ArrayRef<Operation *> ops,
+      function_ref<void(Diagnostic &)> notifyCallback = nullptr,
+      const DenseSet<Operation *> *opsWithConvertedBodies = nullptr);
 
 private:
   /// Converts an operation with the given rewriter.
@@ -2356,6 +2469,9 @@ private:
   /// When mode == OpConversionMode::Partial, this is populated with ops found
   /// *not* to be legalizable to the target.
   DenseSet<Operation *> *trackedOps;
+
+  /// The configuration of the conversion.
+  ConversionConfig config;
 };
 } // namespace
 
@@ -2389,8 +2505,8 @@ LogicalResult OperationConverter::convert(ConversionPatternRewriter &rewriter,
 }
 
 LogicalResult OperationConverter::convertOperations(
-    ArrayRef<Operation *> ops,
-    function_ref<void(Diagnostic &)> notifyCallback) {
+    ArrayRef<Operation *> ops, function_ref<void(Diagnostic &)> notifyCallback,
+    const DenseSet<Operation *> *opsWithConvertedBodies) {
   if (ops.empty())
     return success();
   ConversionTarget &target = opLegalizer.getTarget();
@@ -2402,8 +2518,11 @@ LogicalResult OperationConverter::convertOperations(
         [&](Operation *op) {
           toConvert.push_back(op);
           // Don't check this operation's children for conversion if the
-          // operation is recursively legal.
-          auto legalityInfo = target.isLegal(op);
+          // operation is recursively legal, or if they were converted
+          // already.
+          if (opsWithConvertedBodies && opsWithConvertedBodies->contains(op))
+            return WalkResult::skip();
+          auto legalityInfo = opLegalizer.isLegal(op);
           if (legalityInfo && legalityInfo->isRecursivelyLegal)
             return WalkResult::skip();
           return WalkResult::advance();
@@ -2414,10 +2533,22 @@ LogicalResult OperationConverter::convertOperations(
   ConversionPatternRewriter rewriter(ops.front()->getContext());
   ConversionPatternRewriterImpl &rewriterImpl = rewriter.getImpl();
   rewriterImpl.notifyCallback = notifyCallback;
+  // Analysis conversions always roll back all of the modifications.
+  rewriterImpl.allowPatternRollback =
+      config.allowPatternRollback || mode == OpConversionMode::Analysis;
 
-  for (auto *op : toConvert)
+  for (auto *op : toConvert) {
     if (failed(convert(rewriter, op)))
       return rewriterImpl.discardRewrites(), failure();
+    if (rewriterImpl.unrecoverableRollbackOpName) {
+      op->emitError() << "failed to legalize operation '" << op->getName()
+                      << "': an in-place modification of '"
+                      << *rewriterImpl.unrecoverableRollbackOpName
+                      << "' had to be rolled back, but pattern rollback is "
+                         "disabled";
+      return rewriterImpl.discardRewrites(), failure();
+    }
+  }
 
   // Now that all of the operations have been converted, finalize the conversion
   // process to ensure any lingering conversion artifacts are cleaned up and
@@ -2907,27 +3038,37 @@ void TypeConverter::SignatureConversion::remapInput(unsigned origInputNo,
 
 LogicalResult TypeConverter::convertType(Type t,
                                          SmallVectorImpl<Type> &results) {
-  auto existingIt = cachedDirectConversions.find(t);
-  if (existingIt != cachedDirectConversions.end()) {
-    if (existingIt->second)
-      results.push_back(existingIt->second);
-    return success(existingIt->second != nullptr);
-  }
-  auto multiIt = cachedMultiConversions.find(t);
-  if (multiIt != cachedMultiConversions.end()) {
-    results.append(multiIt->second.begin(), multiIt->second.end());
-    return success();
+  {
+    llvm::sys::SmartScopedReader<true> cacheReadLock(cacheMutex);
+    auto existingIt = cachedDirectConversions.find(t);
+    if (existingIt != cachedDirectConversions.end()) {
+      numCacheHits.fetch_add(1, std::memory_order_relaxed);
+      if (existingIt->second)
+        results.push_back(existingIt->second);
+      return success(existingIt->second != nullptr);
+    }
+    auto multiIt = cachedMultiConversions.find(t);
+    if (multiIt != cachedMultiConversions.end()) {
+      numCacheHits.fetch_add(1, std::memory_order_relaxed);
+      results.append(multiIt->second.begin(), multiIt->second.end());
+      return success();
+    }
   }
+  numCacheMisses.fetch_add(1, std::memory_order_relaxed);
 
   // Walk the added converters in reverse order to apply the most recently
-  // registered first.
+  // registered first. The callbacks are invoked without holding the lock, as
+  // they may recursively convert nested types. Concurrent conversions of the
+  // same type produce the same result, so the first one is cached.
   size_t currentCount = results.size();
-  conversionCallStack.push_back(t);
+  SmallVector<Type, 2> &callStack = conversionCallStack.get();
+  callStack.push_back(t);
   auto popConversionCallStack =
-      llvm::make_scope_exit([this]() { conversionCallStack.pop_back(); });
+      llvm::make_scope_exit([&callStack]() { callStack.pop_back(); });
   for (ConversionCallbackFn &converter : llvm::reverse(conversions)) {
     if (std::optional<LogicalResult> result =
-            converter(t, results, conversionCallStack)) {
+            converter(t, results, callStack)) {
+      llvm::sys::SmartScopedWriter<true> cacheWriteLock(cacheMutex);
       if (!succeeded(*result)) {
         cachedDirectConversions.try_emplace(t, nullptr);
         return failure();
@@ -3361,6 +3502,137 @@ void mlir::registerConversionPDLFunctions(RewritePatternSet &patterns) {
 // Op Conversion Entry Points
 //===----------------------------------------------------------------------===//
 
+//===----------------------------------------------------------------------===//
+// Parallel Conversion
+
+/// Folds the pairs of unrealized conversion casts nested in `op` that cast
+/// values back to their original types. These are materialized where the
+/// operations converted before their parent use the block arguments converted
+/// with it.
+static void foldUnrealizedCastPairs(Operation *op) {
+  SmallVector<UnrealizedConversionCastOp> castOps;
+  op->walk([&](UnrealizedConversionCastOp castOp) {
+    castOps.push_back(castOp);
+  });
+  bool changed = false;
+  for (UnrealizedConversionCastOp castOp : castOps) {
+    auto inputOp = castOp.getInputs().empty()
+                       ? nullptr
+                       : castOp.getInputs()
+                             .front()
+                             .getDefiningOp<UnrealizedConversionCastOp>();
+    if (!inputOp || inputOp.getOutputs() != castOp.getInputs() ||
+        inputOp.getInputs().getTypes() != castOp.getResultTypes())
+      continue;
+    castOp.replaceAllUsesWith(inputOp.getInputs());
+    changed = true;
+  }
+  if (!changed)
+    return;
+  for (UnrealizedConversionCastOp castOp : llvm::reverse(castOps))
+    if (castOp.use_empty())
+      castOp.erase();
+}
+
+/// Converts the given operations, converting the bodies of the isolated ops
+/// nested in them concurrently first, see
+/// `ConversionConfig::convertIsolatedOpsInParallel`.
+static LogicalResult
+convertOperationsInParallel(ArrayRef<Operation *> ops, ConversionTarget &target,
+                            const FrozenRewritePatternSet &patterns,
+                            OpConversionMode mode,
+                            DenseSet<Operation *> *trackedOps,
+                            const ConversionConfig &config) {
+  // Collect the isolated ops nested directly in the converted ops, unless they
+  // are recursively legal. The converted ops must not be replaced, for their
+  // bodies to be walked after the conversion, and are thus required to be
+  // legal.
+  auto collectIsolatedOps = [&](SmallVectorImpl<Operation *> &isolatedOps) {
+    for (Operation *op : ops) {
+      if (!target.isLegal(op))
+        return false;
+      for (Region &region : op->getRegions()) {
+        for (Operation &nestedOp : region.getOps()) {
+          if (nestedOp.getNumRegions() == 0 ||
+              !nestedOp.hasTrait<OpTrait::IsIsolatedFromAbove>())
+            continue;
+          auto legalityInfo = target.isLegal(&nestedOp);
+          if (!legalityInfo || !legalityInfo->isRecursivelyLegal)
+            isolatedOps.push_back(&nestedOp);
+        }
+      }
+    }
+    return true;
+  };
+  SmallVector<Operation *> isolatedOps;
+  MLIRContext *context = ops.front()->getContext();
+  if (!context->isMultithreadingEnabled() ||
+      !collectIsolatedOps(isolatedOps) || isolatedOps.size() < 2) {
+    OperationConverter opConverter(target, patterns, mode, trackedOps, config);
+    return opConverter.convertOperations(ops);
+  }
+
+  // Convert the bodies of the isolated ops concurrently. Each thread reuses a
+  // converter, as setting up the legalizer is not free.
+  struct BodyConverter {
+    BodyConverter(ConversionTarget &target,
+                  const FrozenRewritePatternSet &patterns,
+                  OpConversionMode mode, bool trackOps,
+                  const ConversionConfig &config)
+        : converter(target, patterns, mode, trackOps ? &trackedOps : nullptr,
+                    config) {}
+    DenseSet<Operation *> trackedOps;
+    OperationConverter converter;
+  };
+  std::mutex convertersMutex;
+  SmallVector<std::unique_ptr<BodyConverter>> freeConverters;
+  LogicalResult bodiesResult = failableParallelForEach(
+      context, isolatedOps, [&](Operation *isolatedOp) {
+        std::unique_ptr<BodyConverter> bodyConverter;
+        {
+          std::lock_guard<std::mutex> lock(convertersMutex);
+          if (!freeConverters.empty())
+            bodyConverter = freeConverters.pop_back_val();
+        }
+        if (!bodyConverter)
+          bodyConverter = std::make_unique<BodyConverter>(
+              target, patterns, mode, trackedOps != nullptr, config);
+
+        SmallVector<Operation *> bodyOps;
+        for (Region &region : isolatedOp->getRegions())
+          for (Operation &op : region.getOps())
+            bodyOps.push_back(&op);
+        LogicalResult result =
+            bodyConverter->converter.convertOperations(bodyOps);
+
+        std::lock_guard<std::mutex> lock(convertersMutex);
+        freeConverters.push_back(std::move(bodyConverter));
+        return result;
+      });
+  if (trackedOps)
+    for (std::unique_ptr<BodyConverter> &bodyConverter : freeConverters)
+      trackedOps->insert(bodyConverter->trackedOps.begin(),
+                         bodyConverter->trackedOps.end());
+  if (failed(bodiesResult))
+    return failure();
+
+  // Convert the isolated ops themselves and the other ops serially, which is
+  // where the symbols and the signatures are rewritten.
+  DenseSet<Operation *> opsWithConvertedBodies(isolatedOps.begin(),
+                                               isolatedOps.end());
+  OperationConverter opConverter(target, patterns, mode, trackedOps, config);
+  if (failed(opConverter.convertOperations(ops, /*notifyCallback=*/nullptr,
+                                           &opsWithConvertedBodies)))
+    return failure();
+
+  // Clean up the casts materialized between the bodies and their converted
+  // block arguments.
+  isolatedOps.clear();
+  (void)collectIsolatedOps(isolatedOps);
+  parallelForEach(context, isolatedOps, foldUnrealizedCastPairs);
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // Partial Conversion
 
@@ -3380,6 +3652,28 @@ mlir::applyPartialConversion(Operation *op, ConversionTarget &target,
   return applyPartialConversion(llvm::ArrayRef(op), target, patterns,
                                 unconvertedOps);
 }
+LogicalResult
+mlir::applyPartialConversion(ArrayRef<Operation *> ops,
+                             ConversionTarget &target,
+                             const FrozenRewritePatternSet &patterns,
+                             const ConversionConfig &config,
+                             DenseSet<Operation *> *unconvertedOps) {
+  if (config.convertIsolatedOpsInParallel && !ops.empty())
+    return convertOperationsInParallel(ops, target, patterns,
+                                       OpConversionMode::Partial,
+                                       unconvertedOps, config);
+  OperationConverter opConverter(target, patterns, OpConversionMode::Partial,
+                                 unconvertedOps, config);
+  return opConverter.convertOperations(ops);
+}
+LogicalResult
+mlir::applyPartialConversion(Operation *op, ConversionTarget &target,
+                             const FrozenRewritePatternSet &patterns,
+                             const ConversionConfig &config,
+                             DenseSet<Operation *> *unconvertedOps) {
+  return applyPartialConversion(llvm::ArrayRef(op), target, patterns, config,
+                                unconvertedOps);
+}
 
 //===----------------------------------------------------------------------===//
 // Full Conversion
@@ -3395,6 +3689,24 @@ mlir::applyFullConversion(Operation *op, ConversionTarget &target,
                           const FrozenRewritePatternSet &patterns) {
   return applyFullConversion(llvm::ArrayRef(op), target, patterns);
 }
+LogicalResult
+mlir::applyFullConversion(ArrayRef<Operation *> ops, ConversionTarget &target,
+                          const FrozenRewritePatternSet &patterns,
+                          const ConversionConfig &config) {
+  if (config.convertIsolatedOpsInParallel && !ops.empty())
+    return convertOperationsInParallel(ops, target, patterns,
+                                       OpConversionMode::Full,
+                                       /*trackedOps=*/nullptr, config);
+  OperationConverter opConverter(target, patterns, OpConversionMode::Full,
+                                 /*trackedOps=*/nullptr, config);
+  return opConverter.convertOperations(ops);
+}
+LogicalResult
+mlir::applyFullConversion(Operation *op, ConversionTarget &target,
+                          const FrozenRewritePatternSet &patterns,
+                          const ConversionConfig &config) {
+  return applyFullConversion(llvm::ArrayRef(op), target, patterns, config);
+}
 
 //===----------------------------------------------------------------------===//
 // Analysis Conversion
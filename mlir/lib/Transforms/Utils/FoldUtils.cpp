@@ -155,7 +155,7 @@ bool OperationFolder::insertKnownConstant(Operation *op, Attribute constValue) {
     op->moveBefore(&insertBlock->front());
 
   folderConstOp = op;
-  referencedDialects[op].push_back(op->getDialect());
+  ownedConstants[op] = {insertRegion, constValue, {op->getDialect()}};
   return true;
 }
 
@@ -163,31 +163,25 @@ bool OperationFolder::insertKnownConstant(Operation *op, Attribute constValue) {
 /// OperationFolder's internal bookkeeping.
 void OperationFolder::notifyRemoval(Operation *op) {
   // Check to see if this operation is uniqued within the folder.
-  auto it = referencedDialects.find(op);
-  if (it == referencedDialects.end())
+  auto it = ownedConstants.find(op);
+  if (it == ownedConstants.end())
     return;
 
-  // Get the constant value for this operation, this is the value that was used
-  // to unique the operation internally.
-  Attribute constValue;
-  matchPattern(op, m_Constant(&constValue));
-  assert(constValue);
-
-  // Get the constant map that this operation was uniqued in.
-  auto &uniquedConstants =
-      foldScopes[getInsertionRegion(interfaces, op->getBlock())];
-
-  // Erase all of the references to this operation.
+  // Erase all of the references to this operation from the constant map that
+  // it was uniqued in.
+  const ConstantInfo &info = it->second;
+  auto scopeIt = foldScopes.find(info.insertRegion);
+  assert(scopeIt != foldScopes.end() && "expected a constant map");
   auto type = op->getResult(0).getType();
-  for (auto *dialect : it->second)
-    uniquedConstants.erase(std::make_tuple(dialect, constValue, type));
-  referencedDialects.erase(it);
+  for (auto *dialect : info.dialects)
+    scopeIt->second.erase(std::make_tuple(dialect, info.value, type));
+  ownedConstants.erase(it);
 }
 
 /// Clear out any constants cached inside of the folder.
 void OperationFolder::clear() {
   foldScopes.clear();
-  referencedDialects.clear();
+  ownedConstants.clear();
 }
 
 /// Get or create a constant using the given builder. On success this returns
@@ -202,13 +196,13 @@ Value OperationFolder::getOrCreateConstant(Block *block, Dialect *dialect,
 
   // Get the constant map for the insertion region of this operation.
   auto &uniquedConstants = foldScopes[insertRegion];
-  Operation *constOp =
-      tryGetOrCreateConstant(uniquedConstants, dialect, value, type, loc);
+  Operation *constOp = tryGetOrCreateConstant(insertRegion, uniquedConstants,
+                                              dialect, value, type, loc);
   return constOp ? constOp->getResult(0) : Value();
 }
 
 bool OperationFolder::isFolderOwnedConstant(Operation *op) const {
-  return referencedDialects.count(op);
+  return ownedConstants.count(op);
 }
 
 /// Tries to perform folding on the given `op`. If successful, populates
@@ -284,8 +278,9 @@ OperationFolder::processFoldResults(Operation *op,
     // Check to see if there is a canonicalized version of this constant.
     auto res = op->getResult(i);
     Attribute attrRepl = foldResults[i].get<Attribute>();
-    if (auto *constOp = tryGetOrCreateConstant(
-            uniquedConstants, dialect, attrRepl, res.getType(), op->getLoc())) {
+    if (auto *constOp =
+            tryGetOrCreateConstant(insertRegion, uniquedConstants, dialect,
+                                   attrRepl, res.getType(), op->getLoc())) {
       // Ensure that this constant dominates the operation we are replacing it
       // with. This may not automatically happen if the operation being folded
       // was inserted before the constant within the insertion block.
@@ -314,7 +309,8 @@ OperationFolder::processFoldResults(Operation *op,
 /// Try to get or create a new constant entry. On success this returns the
 /// constant operation value, nullptr otherwise.
 Operation *
-OperationFolder::tryGetOrCreateConstant(ConstantMap &uniquedConstants,
+OperationFolder::tryGetOrCreateConstant(Region *insertRegion,
+                                        ConstantMap &uniquedConstants,
                                         Dialect *dialect, Attribute value,
                                         Type type, Location loc) {
   // Check if an existing mapping already exists.
@@ -330,7 +326,7 @@ OperationFolder::tryGetOrCreateConstant(ConstantMap &uniquedConstants,
   // Check to see if the generated constant is in the expected dialect.
   auto *newDialect = constOp->getDialect();
   if (newDialect == dialect) {
-    referencedDialects[constOp].push_back(dialect);
+    ownedConstants[constOp] = {insertRegion, value, {dialect}};
     return constOp;
   }
 
@@ -343,12 +339,12 @@ OperationFolder::tryGetOrCreateConstant(ConstantMap &uniquedConstants,
   if (auto *existingOp = uniquedConstants.lookup(newKey)) {
     notifyRemoval(constOp);
     rewriter.eraseOp(constOp);
-    referencedDialects[existingOp].push_back(dialect);
+    ownedConstants[existingOp].dialects.push_back(dialect);
     return constOp = existingOp;
   }
 
   // Otherwise, update the new dialect to the materialized operation.
-  referencedDialects[constOp].assign({dialect, newDialect});
+  ownedConstants[constOp] = {insertRegion, value, {dialect, newDialect}};
   auto newIt = uniquedConstants.insert({newKey, constOp});
   return newIt.first->second;
 }
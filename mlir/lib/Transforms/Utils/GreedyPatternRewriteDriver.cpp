@@ -15,6 +15,7 @@
 #include "mlir/Config/mlir-config.h"
 #include "mlir/IR/Action.h"
 #include "mlir/IR/Matchers.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Interfaces/SideEffectInterfaces.h"
 #include "mlir/Rewrite/PatternApplicator.h"
 #include "mlir/Transforms/FoldUtils.h"
@@ -313,6 +314,13 @@ protected:
   Worklist worklist;
 #endif // MLIR_GREEDY_REWRITE_RANDOMIZER_SEED
 
+  /// The ops enqueued since the start of the current iteration, which are the
+  /// only ones revisited by the next iteration when
+  /// `config.revisitChangedOpsOnly` is set. Ops are recorded only while
+  /// `recordChangedOps` is set.
+  Worklist changedOps;
+  bool recordChangedOps = false;
+
   /// Non-pattern based folder for operations.
   OperationFolder folder;
 
@@ -366,6 +374,7 @@ GreedyPatternRewriteDriver::GreedyPatternRewriteDriver(
 {
   // Apply a simple cost model based solely on pattern benefit.
   matcher.applyDefaultCostModel();
+  matcher.setProfile(config.profile);
 
   // Set up listener.
 #if MLIR_ENABLE_EXPENSIVE_PATTERN_API_CHECKS
@@ -430,7 +439,19 @@ bool GreedyPatternRewriteDriver::processWorklist() {
     }
 
     // Try to fold this op.
-    if (succeeded(folder.tryToFold(op))) {
+    LogicalResult foldResult = failure();
+    if (config.profile) {
+      OperationName opName = op->getName();
+      auto startTime = std::chrono::steady_clock::now();
+      foldResult = folder.tryToFold(op);
+      config.profile->recordFold(
+          opName, succeeded(foldResult),
+          std::chrono::duration_cast<PatternProfile::Duration>(
+              std::chrono::steady_clock::now() - startTime));
+    } else {
+      foldResult = folder.tryToFold(op);
+    }
+    if (succeeded(foldResult)) {
       LLVM_DEBUG(logResultWithLine("success", "operation was folded"));
       changed = true;
       continue;
@@ -512,9 +533,12 @@ void GreedyPatternRewriteDriver::addToWorklist(Operation *op) {
 }
 
 void GreedyPatternRewriteDriver::addSingleOpToWorklist(Operation *op) {
-  if (config.strictMode == GreedyRewriteStrictness::AnyOp ||
-      strictModeFilteredOps.contains(op))
-    worklist.push(op);
+  if (config.strictMode != GreedyRewriteStrictness::AnyOp &&
+      !strictModeFilteredOps.contains(op))
+    return;
+  worklist.push(op);
+  if (recordChangedOps)
+    changedOps.push(op);
 }
 
 void GreedyPatternRewriteDriver::notifyBlockCreated(Block *block) {
@@ -569,6 +593,7 @@ void GreedyPatternRewriteDriver::notifyOperationRemoved(Operation *op) {
   addOperandsToWorklist(op->getOperands());
   op->walk([this](Operation *operation) {
     worklist.remove(operation);
+    changedOps.remove(operation);
     folder.notifyRemoval(operation);
   });
 
@@ -612,7 +637,8 @@ public:
   explicit RegionPatternRewriteDriver(MLIRContext *ctx,
                                       const FrozenRewritePatternSet &patterns,
                                       const GreedyRewriteConfig &config,
-                                      Region &regions);
+                                      Region &regions,
+                                      bool skipIsolatedOps = false);
 
   /// Simplify ops inside `region` and simplify the region itself. Return
   /// success if the transformation converged.
@@ -621,13 +647,19 @@ public:
 private:
   /// The region that is simplified.
   Region &region;
+
+  /// If set, the ops nested within ops that are isolated from above are not
+  /// added to the initial worklist, e.g. because they were already simplified
+  /// by drivers running in parallel.
+  bool skipIsolatedOps;
 };
 } // namespace
 
 RegionPatternRewriteDriver::RegionPatternRewriteDriver(
     MLIRContext *ctx, const FrozenRewritePatternSet &patterns,
-    const GreedyRewriteConfig &config, Region &region)
-    : GreedyPatternRewriteDriver(ctx, patterns, config), region(region) {
+    const GreedyRewriteConfig &config, Region &region, bool skipIsolatedOps)
+    : GreedyPatternRewriteDriver(ctx, patterns, config), region(region),
+      skipIsolatedOps(skipIsolatedOps) {
   // Populate strict mode ops.
   if (config.strictMode != GreedyRewriteStrictness::AnyOp) {
     region.walk([&](Operation *op) { strictModeFilteredOps.insert(op); });
@@ -652,6 +684,20 @@ private:
 };
 } // namespace
 
+/// Walk the ops nested within `region` in postorder, without descending into
+/// ops that are isolated from above.
+static void walkSkippingIsolatedOps(Region &region,
+                                    function_ref<void(Operation *)> callback) {
+  for (Block &block : region) {
+    for (Operation &op : llvm::make_early_inc_range(block)) {
+      if (!op.hasTrait<OpTrait::IsIsolatedFromAbove>())
+        for (Region &nestedRegion : op.getRegions())
+          walkSkippingIsolatedOps(nestedRegion, callback);
+      callback(&op);
+    }
+  }
+}
+
 LogicalResult RegionPatternRewriteDriver::simplify(bool *changed) && {
   auto insertKnownConstant = [&](Operation *op) {
     // Check for existing constants when populating the worklist. This avoids
@@ -664,6 +710,7 @@ LogicalResult RegionPatternRewriteDriver::simplify(bool *changed) && {
   };
 
   bool continueRewrites = false;
+  bool rescanRegion = true;
   int64_t iteration = 0;
   MLIRContext *ctx = getContext();
   do {
@@ -674,17 +721,29 @@ LogicalResult RegionPatternRewriteDriver::simplify(bool *changed) && {
 
     worklist.clear();
 
-    if (!config.useTopDownTraversal) {
+    if (!rescanRegion) {
+      // Only revisit the ops changed by the previous iteration. Popping them
+      // in reverse and pushing them onto the LIFO worklist processes them in
+      // the order they were changed in.
+      while (!changedOps.empty())
+        worklist.push(changedOps.pop());
+    } else if (!config.useTopDownTraversal) {
       // Add operations to the worklist in postorder.
-      region.walk([&](Operation *op) {
+      auto addToWorklistInPostOrder = [&](Operation *op) {
         if (!insertKnownConstant(op))
           addToWorklist(op);
-      });
+      };
+      if (skipIsolatedOps)
+        walkSkippingIsolatedOps(region, addToWorklistInPostOrder);
+      else
+        region.walk(addToWorklistInPostOrder);
     } else {
       // Add all nested operations to the worklist in preorder.
       region.walk<WalkOrder::PreOrder>([&](Operation *op) {
         if (!insertKnownConstant(op)) {
           addToWorklist(op);
+          if (skipIsolatedOps && op->hasTrait<OpTrait::IsIsolatedFromAbove>())
+            return WalkResult::skip();
           return WalkResult::advance();
         }
         return WalkResult::skip();
@@ -694,16 +753,23 @@ LogicalResult RegionPatternRewriteDriver::simplify(bool *changed) && {
       worklist.reverse();
     }
 
+    changedOps.clear();
+    recordChangedOps = config.revisitChangedOpsOnly;
+
     ctx->executeAction<GreedyPatternRewriteIteration>(
         [&] {
           continueRewrites = processWorklist();
 
           // After applying patterns, make sure that the CFG of each of the
           // regions is kept up to date.
+          bool regionsSimplified = false;
           if (config.enableRegionSimplification)
-            continueRewrites |= succeeded(simplifyRegions(*this, region));
+            regionsSimplified = succeeded(simplifyRegions(*this, region));
+          continueRewrites |= regionsSimplified;
+          rescanRegion = !config.revisitChangedOpsOnly || regionsSimplified;
         },
         {&region}, iteration);
+    recordChangedOps = false;
   } while (continueRewrites);
 
   if (changed)
@@ -727,10 +793,48 @@ mlir::applyPatternsAndFoldGreedily(Region &region,
   if (!config.scope)
     config.scope = &region;
 
+  // Simplify the regions of the nested isolated ops in parallel first, if
+  // requested. They can't be affected by anything outside of them.
+  MLIRContext *ctx = region.getContext();
+  bool skipIsolatedOps = false;
+  std::atomic<bool> nestedChanged(false), nestedConverged(true);
+  if (config.processIsolatedRegionsInParallel &&
+      ctx->isMultithreadingEnabled()) {
+    SmallVector<Operation *> isolatedOps;
+    region.walk<WalkOrder::PreOrder>([&](Operation *op) {
+      if (!op->hasTrait<OpTrait::IsIsolatedFromAbove>())
+        return WalkResult::advance();
+      isolatedOps.push_back(op);
+      return WalkResult::skip();
+    });
+
+    // There is nothing to gain from splitting the work for a single op.
+    if (isolatedOps.size() > 1) {
+      skipIsolatedOps = true;
+      GreedyRewriteConfig nestedConfig = config;
+      nestedConfig.scope = nullptr;
+      parallelForEach(ctx, isolatedOps, [&](Operation *op) {
+        for (Region &nestedRegion : op->getRegions()) {
+          bool regionChanged = false;
+          if (failed(applyPatternsAndFoldGreedily(nestedRegion, patterns,
+                                                  nestedConfig,
+                                                  &regionChanged)))
+            nestedConverged = false;
+          if (regionChanged)
+            nestedChanged = true;
+        }
+      });
+    }
+  }
+
   // Start the pattern driver.
-  RegionPatternRewriteDriver driver(region.getContext(), patterns, config,
-                                    region);
+  RegionPatternRewriteDriver driver(ctx, patterns, config, region,
+                                    skipIsolatedOps);
   LogicalResult converged = std::move(driver).simplify(changed);
+  if (changed)
+    *changed |= nestedChanged;
+  if (!nestedConverged)
+    converged = failure();
   LLVM_DEBUG(if (failed(converged)) {
     llvm::dbgs() << "The pattern rewrite did not converge after scanning "
                  << config.maxIterations << " times\n";
@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "mlir/Transforms/LoopInvariantCodeMotionUtils.h"
+#include "mlir/Analysis/AliasAnalysis.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/IR/Operation.h"
 #include "mlir/Interfaces/LoopLikeInterface.h"
 #include "mlir/Interfaces/SideEffectInterfaces.h"
@@ -105,3 +107,100 @@ size_t mlir::moveLoopInvariantCode(LoopLikeOpInterface loopLike) {
       },
       [&](Operation *op, Region *) { loopLike.moveOutOfLoop(op); });
 }
+
+/// Returns the value of `ofr` if it is a constant integer.
+static std::optional<int64_t>
+getConstantInt(std::optional<OpFoldResult> ofr) {
+  if (!ofr)
+    return std::nullopt;
+  APInt value;
+  if (auto attr = dyn_cast<Attribute>(*ofr)) {
+    auto intAttr = dyn_cast<IntegerAttr>(attr);
+    if (!intAttr)
+      return std::nullopt;
+    value = intAttr.getValue();
+  } else if (!matchPattern(cast<Value>(*ofr), m_ConstantInt(&value))) {
+    return std::nullopt;
+  }
+  return value.getSExtValue();
+}
+
+/// Returns true if `loopLike` is known to execute at least one iteration.
+static bool hasAtLeastOneIteration(LoopLikeOpInterface loopLike) {
+  std::optional<int64_t> lb = getConstantInt(loopLike.getSingleLowerBound());
+  std::optional<int64_t> ub = getConstantInt(loopLike.getSingleUpperBound());
+  std::optional<int64_t> step = getConstantInt(loopLike.getSingleStep());
+  return lb && ub && step && *step > 0 && *lb < *ub;
+}
+
+/// Collects the memory read by `op` into `reads`. Returns failure if `op` has
+/// effects other than reads of values, or nested regions.
+static LogicalResult getReadValues(Operation *op,
+                                   SmallVectorImpl<Value> &reads) {
+  auto effectInterface = dyn_cast<MemoryEffectOpInterface>(op);
+  if (!effectInterface || op->getNumRegions() != 0)
+    return failure();
+  SmallVector<MemoryEffects::EffectInstance> effects;
+  effectInterface.getEffects(effects);
+  for (const MemoryEffects::EffectInstance &effect : effects) {
+    if (!isa<MemoryEffects::Read>(effect.getEffect()) || !effect.getValue())
+      return failure();
+    reads.push_back(effect.getValue());
+  }
+  return success(!reads.empty());
+}
+
+/// Collects the memory written, allocated or freed by the ops nested in
+/// `region` into `writes`. A null value stands for an unknown write to any
+/// memory.
+static void collectWrittenValues(Region &region,
+                                 SmallVectorImpl<Value> &writes) {
+  region.walk([&](Operation *op) {
+    auto effectInterface = dyn_cast<MemoryEffectOpInterface>(op);
+    if (!effectInterface) {
+      // The effects of the nested ops are collected by the walk.
+      if (!op->hasTrait<OpTrait::HasRecursiveMemoryEffects>())
+        writes.push_back(Value());
+      return;
+    }
+    SmallVector<MemoryEffects::EffectInstance> effects;
+    effectInterface.getEffects(effects);
+    for (const MemoryEffects::EffectInstance &effect : effects)
+      if (!isa<MemoryEffects::Read>(effect.getEffect()))
+        writes.push_back(effect.getValue());
+  });
+}
+
+size_t mlir::moveLoopInvariantCode(LoopLikeOpInterface loopLike,
+                                   AliasAnalysis &aliasAnalysis) {
+  // The writes of the loop are computed lazily, on the first read that may be
+  // hoisted. Only reads and side-effect free ops are hoisted, so they don't
+  // change while ops are moved.
+  bool canHoistReads = hasAtLeastOneIteration(loopLike);
+  std::optional<SmallVector<Value>> writes;
+  auto isInvariantRead = [&](Operation *op) {
+    SmallVector<Value> reads;
+    if (!canHoistReads || failed(getReadValues(op, reads)))
+      return false;
+    if (!writes) {
+      writes.emplace();
+      collectWrittenValues(loopLike.getLoopBody(), *writes);
+    }
+    return llvm::none_of(reads, [&](Value read) {
+      return llvm::any_of(*writes, [&](Value write) {
+        return !write || !aliasAnalysis.alias(read, write).isNo();
+      });
+    });
+  };
+
+  return moveLoopInvariantCode(
+      &loopLike.getLoopBody(),
+      [&](Value value, Region *) {
+        return loopLike.isDefinedOutsideOfLoop(value);
+      },
+      [&](Operation *op, Region *) {
+        return (isMemoryEffectFree(op) && isSpeculatable(op)) ||
+               isInvariantRead(op);
+      },
+      [&](Operation *op, Region *) { loopLike.moveOutOfLoop(op); });
+}
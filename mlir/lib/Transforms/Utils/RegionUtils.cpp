@@ -238,6 +238,8 @@ namespace {
 ///
 /// This data structure essentially tracks the dataflow lattice.
 /// The set of values/ops proved live increases monotonically to a fixed-point.
+/// The values/ops newly proved live are also recorded in a worklist, from
+/// which their liveness is propagated to the values they use.
 class LiveMap {
 public:
   /// Value methods.
@@ -257,21 +259,31 @@ public:
     setProvedLive(cast<BlockArgument>(value));
   }
   void setProvedLive(BlockArgument arg) {
-    changed |= liveValues.insert(arg).second;
+    if (liveValues.insert(arg).second)
+      argWorklist.push_back(arg);
   }
 
   /// Operation methods.
   bool wasProvenLive(Operation *op) { return liveOps.count(op); }
-  void setProvedLive(Operation *op) { changed |= liveOps.insert(op).second; }
+  void setProvedLive(Operation *op) {
+    if (liveOps.insert(op).second)
+      opWorklist.push_back(op);
+  }
 
-  /// Methods for tracking if we have reached a fixed-point.
-  void resetChanged() { changed = false; }
-  bool hasChanged() { return changed; }
+  /// Worklist methods. These pop the ops and block arguments proved live whose
+  /// liveness hasn't been propagated yet, or return null if there are none.
+  Operation *popNewlyLiveOp() {
+    return opWorklist.empty() ? nullptr : opWorklist.pop_back_val();
+  }
+  BlockArgument popNewlyLiveArgument() {
+    return argWorklist.empty() ? BlockArgument() : argWorklist.pop_back_val();
+  }
 
 private:
-  bool changed = false;
   DenseSet<Value> liveValues;
   DenseSet<Operation *> liveOps;
+  SmallVector<Operation *> opWorklist;
+  SmallVector<BlockArgument> argWorklist;
 };
 } // namespace
 
@@ -298,17 +310,19 @@ static bool isUseSpeciallyKnownDead(OpOperand &use, LiveMap &liveMap) {
   return false;
 }
 
-static void processValue(Value value, LiveMap &liveMap) {
-  bool provedLive = llvm::any_of(value.getUses(), [&](OpOperand &use) {
-    if (isUseSpeciallyKnownDead(use, liveMap))
-      return false;
-    return liveMap.wasProvenLive(use.getOwner());
-  });
-  if (provedLive)
-    liveMap.setProvedLive(value);
+/// Mark `value`, which is used by a live op, as live.
+static void setUsedValueLive(Value value, LiveMap &liveMap) {
+  // We currently do not remove entry block arguments, so there is no need to
+  // track their liveness.
+  // TODO: We could track these and enable removing dead operands/arguments
+  // from region control flow operations.
+  if (auto arg = dyn_cast<BlockArgument>(value))
+    if (arg.getOwner()->isEntryBlock())
+      return;
+  liveMap.setProvedLive(value);
 }
 
-static void propagateLiveness(Region &region, LiveMap &liveMap);
+static void markIntrinsicallyLive(Region &region, LiveMap &liveMap);
 
 static void propagateTerminatorLiveness(Operation *op, LiveMap &liveMap) {
   // Terminators are always live.
@@ -334,49 +348,68 @@ static void propagateTerminatorLiveness(Operation *op, LiveMap &liveMap) {
   }
 }
 
-static void propagateLiveness(Operation *op, LiveMap &liveMap) {
+/// Mark the ops that are live regardless of their uses, i.e. the terminators
+/// and the ops that would not be trivially dead, as live.
+static void markIntrinsicallyLive(Operation *op, LiveMap &liveMap) {
   // Recurse on any regions the op has.
   for (Region &region : op->getRegions())
-    propagateLiveness(region, liveMap);
+    markIntrinsicallyLive(region, liveMap);
 
   // Process terminator operations.
   if (op->hasTrait<OpTrait::IsTerminator>())
     return propagateTerminatorLiveness(op, liveMap);
 
-  // Don't reprocess live operations.
-  if (liveMap.wasProvenLive(op))
-    return;
-
-  // Process the op itself.
   if (!wouldOpBeTriviallyDead(op))
-    return liveMap.setProvedLive(op);
-
-  // If the op isn't intrinsically alive, check it's results.
-  for (Value value : op->getResults())
-    processValue(value, liveMap);
+    liveMap.setProvedLive(op);
 }
 
-static void propagateLiveness(Region &region, LiveMap &liveMap) {
+static void markIntrinsicallyLive(Region &region, LiveMap &liveMap) {
   if (region.empty())
     return;
 
-  for (Block *block : llvm::post_order(&region.front())) {
-    // We process block arguments after the ops in the block, to promote
-    // faster convergence to a fixed point (we try to visit uses before defs).
+  // Only the reachable blocks are processed, the ops of the unreachable ones
+  // are never live.
+  for (Block *block : llvm::post_order(&region.front()))
     for (Operation &op : llvm::reverse(block->getOperations()))
-      propagateLiveness(&op, liveMap);
+      markIntrinsicallyLive(&op, liveMap);
+}
 
-    // We currently do not remove entry block arguments, so there is no need to
-    // track their liveness.
-    // TODO: We could track these and enable removing dead operands/arguments
-    // from region control flow operations.
-    if (block->isEntryBlock())
+/// Compute the live ops and block arguments of `regions`. The liveness of the
+/// ops and block arguments proved live is propagated to the values they use
+/// through a worklist, so that each of them is processed once.
+static void propagateLiveness(MutableArrayRef<Region> regions,
+                              LiveMap &liveMap) {
+  for (Region &region : regions)
+    markIntrinsicallyLive(region, liveMap);
+
+  while (true) {
+    // The values used by a live op are live, except for the successor
+    // operands forwarded to block arguments that aren't live (yet).
+    if (Operation *op = liveMap.popNewlyLiveOp()) {
+      for (OpOperand &use : op->getOpOperands())
+        if (!isUseSpeciallyKnownDead(use, liveMap))
+          setUsedValueLive(use.get(), liveMap);
       continue;
+    }
 
-    for (Value value : block->getArguments()) {
-      if (!liveMap.wasProvenLive(value))
-        processValue(value, liveMap);
+    // The successor operands forwarded to a live block argument by the live
+    // terminators of its predecessors are live.
+    if (BlockArgument arg = liveMap.popNewlyLiveArgument()) {
+      Block *block = arg.getOwner();
+      for (auto it = block->pred_begin(), e = block->pred_end(); it != e;
+           ++it) {
+        Operation *terminator = (*it)->getTerminator();
+        auto branch = dyn_cast<BranchOpInterface>(terminator);
+        if (!branch || !liveMap.wasProvenLive(terminator))
+          continue;
+        SuccessorOperands succOperands =
+            branch.getSuccessorOperands(it.getSuccessorIndex());
+        if (arg.getArgNumber() >= succOperands.getProducedOperandCount())
+          setUsedValueLive(succOperands[arg.getArgNumber()], liveMap);
+      }
+      continue;
     }
+    break;
   }
 }
 
@@ -456,23 +489,17 @@ static LogicalResult deleteDeadness(RewriterBase &rewriter,
 // proved otherwise, allowing it to delete recursively dead cycles.
 //
 // This is a simple fixed-point dataflow analysis algorithm on a lattice
-// {Dead,Alive}. Because liveness flows backward, we generally try to
-// iterate everything backward to speed up convergence to the fixed-point. This
-// allows for being able to delete recursively dead cycles of the use-def graph,
-// including block arguments.
+// {Dead,Alive}. Liveness flows backward, from the ops that are intrinsically
+// live to the values they use, through a worklist. This allows for being able
+// to delete recursively dead cycles of the use-def graph, including block
+// arguments.
 //
 // This function returns success if any operations or arguments were deleted,
 // failure otherwise.
 LogicalResult mlir::runRegionDCE(RewriterBase &rewriter,
                                  MutableArrayRef<Region> regions) {
   LiveMap liveMap;
-  do {
-    liveMap.resetChanged();
-
-    for (Region &region : regions)
-      propagateLiveness(region, liveMap);
-  } while (liveMap.hasChanged());
-
+  propagateLiveness(regions, liveMap);
   return deleteDeadness(rewriter, regions, liveMap);
 }
 
@@ -563,7 +590,13 @@ public:
   LogicalResult addToCluster(BlockEquivalenceData &blockData);
 
   /// Try to merge all of the blocks within this cluster into the leader block.
-  LogicalResult merge(RewriterBase &rewriter);
+  /// The blocks that may have become mergeable with other blocks are added to
+  /// `changedBlocks`, and the merged blocks are removed from it.
+  LogicalResult merge(RewriterBase &rewriter,
+                      SmallPtrSetImpl<Block *> &changedBlocks);
+
+  /// Return the hash of the blocks of this cluster.
+  llvm::hash_code getHash() const { return leaderData.hash; }
 
 private:
   /// The equivalence data for the leader of the cluster.
@@ -675,7 +708,9 @@ static bool ableToUpdatePredOperands(Block *block) {
   return true;
 }
 
-LogicalResult BlockMergeCluster::merge(RewriterBase &rewriter) {
+LogicalResult
+BlockMergeCluster::merge(RewriterBase &rewriter,
+                         SmallPtrSetImpl<Block *> &changedBlocks) {
   // Don't consider clusters that don't have blocks to merge.
   if (blocksToMerge.empty())
     return failure();
@@ -738,11 +773,26 @@ LogicalResult BlockMergeCluster::merge(RewriterBase &rewriter) {
       updatePredecessors(blocksToMerge[i], /*clusterIndex=*/i + 1);
   }
 
-  // Replace all uses of the merged blocks with the leader and erase them.
+  // Replace all uses of the merged blocks with the leader and erase them. The
+  // blocks defining the values used by the merged blocks may have lost their
+  // uses outside of themselves.
   for (Block *block : blocksToMerge) {
+    for (Operation &op : *block)
+      for (Value operand : op.getOperands())
+        if (operand.getParentBlock() != block)
+          changedBlocks.insert(operand.getParentBlock());
     block->replaceAllUsesWith(leaderBlock);
+    changedBlocks.erase(block);
     rewriter.eraseBlock(block);
   }
+
+  // The leader and the terminators of its predecessors changed, and the
+  // successors of the merged blocks lost predecessors.
+  changedBlocks.insert(leaderBlock);
+  for (Block *pred : leaderBlock->getPredecessors())
+    changedBlocks.insert(pred);
+  for (Block *succ : leaderBlock->getSuccessors())
+    changedBlocks.insert(succ);
   return success();
 }
 
@@ -754,41 +804,72 @@ static LogicalResult mergeIdenticalBlocks(RewriterBase &rewriter,
   if (region.empty() || llvm::hasSingleElement(region))
     return failure();
 
-  // Identify sets of blocks, other than the entry block, that branch to the
-  // same successors. We will use these groups to create clusters of equivalent
-  // blocks.
-  DenseMap<SuccessorRange, SmallVector<Block *, 1>> matchingSuccessors;
+  // The blocks that may be mergeable with other blocks: initially all of them,
+  // then only the ones affected by the previous merges.
+  SmallPtrSet<Block *, 16> changedBlocks;
   for (Block &block : llvm::drop_begin(region, 1))
-    matchingSuccessors[block.getSuccessors()].push_back(&block);
+    changedBlocks.insert(&block);
 
   bool mergedAnyBlocks = false;
-  for (ArrayRef<Block *> blocks : llvm::make_second_range(matchingSuccessors)) {
-    if (blocks.size() == 1)
-      continue;
+  while (!changedBlocks.empty()) {
+    // Identify sets of blocks, other than the entry block, that branch to the
+    // same successors. We will use these groups to create clusters of
+    // equivalent blocks.
+    DenseMap<SuccessorRange, SmallVector<Block *, 1>> matchingSuccessors;
+    for (Block &block : llvm::drop_begin(region, 1))
+      matchingSuccessors[block.getSuccessors()].push_back(&block);
+
+    SmallPtrSet<Block *, 16> nextChangedBlocks;
+    for (ArrayRef<Block *> blocks :
+         llvm::make_second_range(matchingSuccessors)) {
+      // Groups without changed blocks were already considered.
+      if (blocks.size() == 1 || llvm::none_of(blocks, [&](Block *block) {
+            return changedBlocks.contains(block);
+          }))
+        continue;
 
-    SmallVector<BlockMergeCluster, 1> clusters;
-    for (Block *block : blocks) {
-      BlockEquivalenceData data(block);
+      SmallVector<BlockEquivalenceData, 1> blockData;
+      for (Block *block : blocks) {
+        // Don't allow merging if this block has any regions.
+        // TODO: Add support for regions if necessary.
+        bool hasNonEmptyRegion = llvm::any_of(*block, [](Operation &op) {
+          return llvm::any_of(op.getRegions(),
+                              [](Region &region) { return !region.empty(); });
+        });
+        if (!hasNonEmptyRegion)
+          blockData.emplace_back(block);
+      }
 
-      // Don't allow merging if this block has any regions.
-      // TODO: Add support for regions if necessary.
-      bool hasNonEmptyRegion = llvm::any_of(*block, [](Operation &op) {
-        return llvm::any_of(op.getRegions(),
-                            [](Region &region) { return !region.empty(); });
+      // Sort the blocks by hash, such that each block is only compared with
+      // the leaders of the clusters of blocks of the same hash. The sort is
+      // stable to keep the first block of each cluster as its leader.
+      SmallVector<unsigned> order =
+          llvm::to_vector(llvm::seq<unsigned>(0, blockData.size()));
+      llvm::stable_sort(order, [&](unsigned lhs, unsigned rhs) {
+        return blockData[lhs].hash < blockData[rhs].hash;
       });
-      if (hasNonEmptyRegion)
-        continue;
 
-      // Try to add this block to an existing cluster.
-      bool addedToCluster = false;
+      SmallVector<BlockMergeCluster, 1> clusters;
+      size_t firstClusterWithHash = 0;
+      for (unsigned index : order) {
+        BlockEquivalenceData &data = blockData[index];
+        if (!clusters.empty() &&
+            clusters[firstClusterWithHash].getHash() != data.hash)
+          firstClusterWithHash = clusters.size();
+
+        // Try to add this block to an existing cluster.
+        bool addedToCluster = false;
+        for (auto &cluster : llvm::drop_begin(clusters, firstClusterWithHash))
+          if ((addedToCluster = succeeded(cluster.addToCluster(data))))
+            break;
+        if (!addedToCluster)
+          clusters.emplace_back(std::move(data));
+      }
       for (auto &cluster : clusters)
-        if ((addedToCluster = succeeded(cluster.addToCluster(data))))
-          break;
-      if (!addedToCluster)
-        clusters.emplace_back(std::move(data));
+        mergedAnyBlocks |=
+            succeeded(cluster.merge(rewriter, nextChangedBlocks));
     }
-    for (auto &cluster : clusters)
-      mergedAnyBlocks |= succeeded(cluster.merge(rewriter));
+    changedBlocks = std::move(nextChangedBlocks);
   }
 
   return success(mergedAnyBlocks);
@@ -798,22 +879,22 @@ static LogicalResult mergeIdenticalBlocks(RewriterBase &rewriter,
 /// new block arguments as necessary.
 static LogicalResult mergeIdenticalBlocks(RewriterBase &rewriter,
                                           MutableArrayRef<Region> regions) {
-  llvm::SmallSetVector<Region *, 1> worklist;
+  // Each region is merged to a fixed point at once, and block merging doesn't
+  // modify the nested regions, so each region is only visited once.
+  SmallVector<Region *, 1> worklist;
   for (auto &region : regions)
-    worklist.insert(&region);
+    worklist.push_back(&region);
   bool anyChanged = false;
   while (!worklist.empty()) {
     Region *region = worklist.pop_back_val();
-    if (succeeded(mergeIdenticalBlocks(rewriter, *region))) {
-      worklist.insert(region);
+    if (succeeded(mergeIdenticalBlocks(rewriter, *region)))
       anyChanged = true;
-    }
 
     // Add any nested regions to the worklist.
     for (Block &block : *region)
       for (auto &op : block)
         for (auto &nestedRegion : op.getRegions())
-          worklist.insert(&nestedRegion);
+          worklist.push_back(&nestedRegion);
   }
 
   return success(anyChanged);
@@ -43,6 +43,7 @@ __all__ = [
     "DenseElementsAttr",
     "DenseFPElementsAttr",
     "DenseIntElementsAttr",
+    "DenseResourceElementsAttr",
     "Dialect",
     "DialectDescriptor",
     "Dialects",
@@ -92,6 +93,7 @@ __all__ = [
     "ShapedTypeComponents",
     "StringAttr",
     "SymbolTable",
+    "ThreadPool",
     "TupleType",
     "Type",
     "TypeAttr",
@@ -478,6 +480,7 @@ class Context:
     def enable_multithreading(self, enable: bool) -> None: ...
     def get_dialect_descriptor(self, dialect_name: str) -> DialectDescriptor: ...
     def is_registered_operation(self, operation_name: str) -> bool: ...
+    def set_thread_pool(self, pool: ThreadPool) -> None: ...
     def __enter__(self) -> Context: ...
     def __exit__(self, arg0: object, arg1: object, arg2: object) -> None: ...
     @property
@@ -486,6 +489,8 @@ class Context:
     def d(self) -> Dialects: ...
     @property
     def dialects(self) -> Dialects: ...
+    @property
+    def num_threads(self) -> int: ...
     def append_dialect_registry(self, registry: "DialectRegistry") -> None: ...
     def load_all_available_dialects(self) -> None: ...
 
@@ -529,6 +534,22 @@ class DenseIntElementsAttr(DenseElementsAttr):
     @property
     def type(self) -> Type: ...
 
+class DenseResourceElementsAttr(Attribute):
+    def __init__(self, cast_from_attr: Attribute) -> None: ...
+    @staticmethod
+    def get_from_buffer(
+        array: Any,
+        name: str,
+        type: Type,
+        alignment: Optional[int] = None,
+        is_mutable: bool = False,
+        context: Optional[Context] = None,
+    ) -> DenseResourceElementsAttr: ...
+    @staticmethod
+    def isinstance(arg: Any) -> bool: ...
+    @property
+    def type(self) -> Type: ...
+
 class Dialect:
     def __init__(self, descriptor: DialectDescriptor) -> None: ...
     @property
@@ -1072,6 +1093,11 @@ class SymbolTable:
     def __delitem__(self, arg0: str) -> None: ...
     def __getitem__(self, arg0: str) -> OpView: ...
 
+class ThreadPool:
+    def __init__(self, num_threads: int = 0) -> None: ...
+    @property
+    def max_concurrency(self) -> int: ...
+
 # TODO: Auto-generated. Audit and fix.
 class TupleType(Type):
     def __init__(self, cast_from_type: Type) -> None: ...
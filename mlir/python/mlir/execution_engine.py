@@ -34,6 +34,16 @@ class ExecutionEngine(_execution_engine.ExecutionEngine):
             packed_args[argNum] = ctypes.cast(ctypes_args[argNum], ctypes.c_void_p)
         func(packed_args)
 
+    def prepare(self, name, arg_ranks):
+        """Prepare the calls of a function emitted with the
+        `llvm.emit_c_interface` attribute. `arg_ranks` lists the kinds of its
+        arguments: the rank of a ranked memref, or None for an argument passed
+        by pointer (e.g. a scalar or a scalar result). The returned callable
+        takes buffers such as numpy arrays, without ctypes packing.
+        Raise a RuntimeError if the function isn't found.
+        """
+        return self.raw_prepare("_mlir_ciface_" + name, arg_ranks)
+
     def register_runtime(self, name, ctypes_callback):
         """Register a runtime function available to the jitted code
         under the provided `name`. The `ctypes_callback` must be a
@@ -256,3 +256,18 @@ func.func @constants(%arg: memref<2xf32>) attributes {test.ptr = "func"} {
 
   return
 }
+
+// -----
+
+// CHECK-LABEL: Testing : "noalias_arguments"
+// CHECK-DAG: func.region0#0 <-> func.region0#1: NoAlias
+// CHECK-DAG: func.region0#0 <-> func.region0#2: NoAlias
+// CHECK-DAG: func.region0#1 <-> func.region0#2: MayAlias
+
+// CHECK-DAG: view#0 <-> func.region0#0: MustAlias
+// CHECK-DAG: view#0 <-> func.region0#1: NoAlias
+// CHECK-DAG: view#0 <-> func.region0#2: NoAlias
+func.func @noalias_arguments(%arg: memref<8x64xf32> {llvm.noalias}, %arg1: memref<8x64xf32>, %arg2: memref<8x64xf32>) attributes {test.ptr = "func"} {
+  %0 = memref.subview %arg[0, 0] [4, 4] [1, 1] {test.ptr = "view"} : memref<8x64xf32> to memref<4x4xf32, strided<[64, 1]>>
+  return
+}
@@ -0,0 +1,25 @@
+// RUN: mlir-opt %s -emit-bytecode | mlir-opt -stream-lazy-ops --pass-pipeline="builtin.module(func.func(canonicalize))" | FileCheck %s
+// RUN: mlir-opt %s -emit-bytecode | not mlir-opt -stream-lazy-ops --pass-pipeline="builtin.module(symbol-dce)" 2>&1 | FileCheck %s --check-prefix=NESTED
+// RUN: not mlir-opt %s -stream-lazy-ops 2>&1 | FileCheck %s --check-prefix=TEXTUAL
+
+// CHECK-LABEL: func.func @foo
+// CHECK-NEXT:    %[[C:.*]] = arith.constant 3 : i32
+// CHECK-NEXT:    return %[[C]]
+func.func @foo() -> i32 {
+  %0 = arith.constant 1 : i32
+  %1 = arith.constant 2 : i32
+  %2 = arith.addi %0, %1 : i32
+  return %2 : i32
+}
+
+// CHECK-LABEL: func.func @bar
+// CHECK-NEXT:    %[[C:.*]] = arith.constant 8 : i32
+// CHECK-NEXT:    return %[[C]]
+func.func @bar() -> i32 {
+  %0 = arith.constant 4 : i32
+  %1 = arith.addi %0, %0 : i32
+  return %1 : i32
+}
+
+// NESTED: streaming execution requires a pipeline of nested pass managers
+// TEXTUAL: streaming lazily loaded operations requires a bytecode input
@@ -2210,6 +2210,94 @@ int testDialectRegistry(void) {
   return 0;
 }
 
+/// Prints the name of the operations in a walk and skips or interrupts the
+/// walk at the operations named by `userData`.
+static MlirWalkResult printOpNameAndSkip(MlirOperation op, void *userData) {
+  MlirIdentifier name = mlirOperationGetName(op);
+  MlirStringRef nameStr = mlirIdentifierStr(name);
+  fprintf(stderr, "%.*s ", (int)nameStr.length, nameStr.data);
+  const char *const *names = (const char *const *)userData;
+  if (mlirStringRefEqual(nameStr, mlirStringRefCreateFromCString(names[0])))
+    return MlirWalkResultSkip;
+  if (mlirStringRefEqual(nameStr, mlirStringRefCreateFromCString(names[1])))
+    return MlirWalkResultInterrupt;
+  return MlirWalkResultAdvance;
+}
+
+int testBulkOperations(MlirContext ctx) {
+  fprintf(stderr, "@testBulkOperations\n");
+  // CHECK-LABEL: @testBulkOperations
+
+  mlirContextSetAllowUnregisteredDialects(ctx, true);
+  MlirLocation loc = mlirLocationUnknownGet(ctx);
+  MlirType indexType = mlirIndexTypeGet(ctx);
+
+  // Create two operations with two results each at once.
+  MlirType resultTypes[] = {indexType, indexType};
+  MlirOperationState states[] = {
+      mlirOperationStateGet(mlirStringRefCreateFromCString("dummy.first"), loc),
+      mlirOperationStateGet(mlirStringRefCreateFromCString("dummy.second"),
+                            loc)};
+  mlirOperationStateAddResults(&states[0], 2, resultTypes);
+  mlirOperationStateAddResults(&states[1], 2, resultTypes);
+  MlirOperation ops[2];
+  if (mlirLogicalResultIsFailure(mlirOperationCreateN(2, states, ops))) {
+    fprintf(stderr, "ERROR: Expected the operations to be created\n");
+    return 1;
+  }
+
+  // Use the results of both as operands of a third operation.
+  MlirValue operands[4];
+  mlirOperationGetResults(ops[0], operands);
+  mlirOperationGetResults(ops[1], operands + 2);
+  MlirOperationState userState =
+      mlirOperationStateGet(mlirStringRefCreateFromCString("dummy.user"), loc);
+  mlirOperationStateAddOperands(&userState, 4, operands);
+  MlirOperation user = mlirOperationCreate(&userState);
+
+  MlirValue userOperands[4];
+  mlirOperationGetOperands(user, userOperands);
+  for (int i = 0; i < 4; ++i) {
+    if (!mlirValueEqual(userOperands[i], operands[i])) {
+      fprintf(stderr, "ERROR: Unexpected operand %d\n", i);
+      return 2;
+    }
+  }
+  mlirOperationDestroy(user);
+  mlirOperationDestroy(ops[1]);
+  mlirOperationDestroy(ops[0]);
+
+  const char *moduleString = "\"dummy.outer\"() ({\n"
+                             "  \"dummy.skipped\"() ({\n"
+                             "    \"dummy.nested\"() : () -> ()\n"
+                             "  }) : () -> ()\n"
+                             "  \"dummy.inner\"() ({\n"
+                             "    \"dummy.nested\"() : () -> ()\n"
+                             "  }) : () -> ()\n"
+                             "  \"dummy.interrupt\"() : () -> ()\n"
+                             "  \"dummy.last\"() : () -> ()\n"
+                             "}) : () -> ()";
+  MlirOperation outer = mlirOperationCreateParse(
+      ctx, mlirStringRefCreateFromCString(moduleString),
+      mlirStringRefCreateFromCString("walk"));
+  const char *names[] = {"dummy.skipped", "dummy.interrupt"};
+
+  // CHECK: dummy.outer dummy.skipped dummy.inner dummy.nested dummy.interrupt
+  // CHECK-SAME: interrupted: 1
+  bool interrupted = mlirOperationWalk(outer, printOpNameAndSkip, names,
+                                       MlirWalkPreOrder);
+  fprintf(stderr, "interrupted: %d\n", interrupted);
+
+  // CHECK: dummy.nested dummy.skipped dummy.nested dummy.inner dummy.interrupt
+  // CHECK-SAME: interrupted: 1
+  interrupted = mlirRegionWalk(mlirOperationGetRegion(outer, 0),
+                               printOpNameAndSkip, names, MlirWalkPostOrder);
+  fprintf(stderr, "interrupted: %d\n", interrupted);
+
+  mlirOperationDestroy(outer);
+  return 0;
+}
+
 void testDiagnostics(void) {
   MlirContext ctx = mlirContextCreate();
   MlirDiagnosticHandlerID id = mlirContextAttachDiagnosticHandler(
@@ -2307,6 +2395,8 @@ int main(void) {
     return 14;
   if (testDialectRegistry())
     return 15;
+  if (testBulkOperations(ctx))
+    return 16;
 
   mlirContextDestroy(ctx);
 
@@ -0,0 +1,14 @@
+// RUN: mlir-opt %s -convert-func-to-llvm="c-interface-header=-" -o /dev/null \
+// RUN:   -verify-diagnostics -split-input-file
+
+// expected-error @+1 {{cannot declare the C interface of a function with a 'vector<4xf32>'}}
+func.func @vector(%arg0: vector<4xf32>) attributes {llvm.emit_c_interface} {
+  return
+}
+
+// -----
+
+// expected-error @+1 {{cannot declare the C interface of a function with a 'memref<4xcomplex<f32>>'}}
+func.func @complex(%arg0: memref<4xcomplex<f32>>) attributes {llvm.emit_c_interface} {
+  return
+}
@@ -0,0 +1,82 @@
+// RUN: mlir-opt %s -convert-func-to-llvm="c-interface-header=-" -o /dev/null \
+// RUN: | FileCheck %s
+// RUN: mlir-opt %s -convert-func-to-llvm="c-interface-header=- index-bitwidth=32" \
+// RUN:   -o /dev/null | FileCheck %s --check-prefix=INDEX32
+
+// CHECK:      #pragma once
+// CHECK:      #include <stdbool.h>
+// CHECK-NEXT: #include <stdint.h>
+// CHECK:      #ifdef __cplusplus
+// CHECK-NEXT: extern "C" {
+// CHECK-NEXT: #endif
+
+// CHECK:      #ifndef MLIR_C_INTERFACE_MLIR_MEMREF_2D_F32
+// CHECK-NEXT: #define MLIR_C_INTERFACE_MLIR_MEMREF_2D_F32
+// CHECK-NEXT: typedef struct {
+// CHECK-NEXT:   float *allocated;
+// CHECK-NEXT:   float *aligned;
+// CHECK-NEXT:   int64_t offset;
+// CHECK-NEXT:   int64_t sizes[2];
+// CHECK-NEXT:   int64_t strides[2];
+// CHECK-NEXT: } mlir_memref_2d_f32;
+// CHECK-NEXT: #endif
+
+// CHECK:      typedef struct {
+// CHECK-NEXT:   int64_t rank;
+// CHECK-NEXT:   void *descriptor;
+// CHECK-NEXT: } mlir_unranked_memref;
+
+// CHECK:      typedef struct {
+// CHECK-NEXT:   int32_t *allocated;
+// CHECK-NEXT:   int32_t *aligned;
+// CHECK-NEXT:   int64_t offset;
+// CHECK-NEXT: } mlir_memref_0d_i32;
+
+// CHECK:      typedef struct {
+// CHECK-NEXT:   mlir_memref_0d_i32 result0;
+// CHECK-NEXT:   double result1;
+// CHECK-NEXT: } multiple_results_results;
+
+// CHECK:      float _mlir_ciface_scalars(int32_t arg0, int64_t arg1, bool arg2, uint8_t arg3);
+// CHECK-NEXT: void _mlir_ciface_memrefs(mlir_memref_2d_f32 *result, mlir_memref_2d_f32 *arg0, mlir_memref_2d_f32 *arg1);
+// CHECK-NEXT: void _mlir_ciface_unranked(mlir_unranked_memref *arg0);
+// CHECK-NEXT: void _mlir_ciface_multiple_results(multiple_results_results *result, mlir_memref_0d_i32 *arg0, double arg1);
+// CHECK-NEXT: void _mlir_ciface_external(mlir_memref_0d_i32 *arg0);
+// CHECK-NEXT: void _mlir_ciface_no_arguments(void);
+// CHECK-NOT:  without_interface
+// CHECK:      #ifdef __cplusplus
+// CHECK-NEXT: }
+// CHECK-NEXT: #endif
+
+// INDEX32:      int32_t offset;
+// INDEX32:      float _mlir_ciface_scalars(int32_t arg0, int32_t arg1, bool arg2, uint8_t arg3);
+
+func.func @scalars(%arg0: i32, %arg1: index, %arg2: i1, %arg3: ui8) -> f32
+    attributes {llvm.emit_c_interface} {
+  %0 = arith.constant 0.0 : f32
+  return %0 : f32
+}
+
+func.func @memrefs(%arg0: memref<?x4xf32>, %arg1: memref<8x?xf32>)
+    -> memref<?x4xf32> attributes {llvm.emit_c_interface} {
+  return %arg0 : memref<?x4xf32>
+}
+
+func.func @unranked(%arg0: memref<*xf32>) attributes {llvm.emit_c_interface} {
+  return
+}
+
+func.func @multiple_results(%arg0: memref<i32>, %arg1: f64)
+    -> (memref<i32>, f64) attributes {llvm.emit_c_interface} {
+  return %arg0, %arg1 : memref<i32>, f64
+}
+
+func.func private @external(memref<i32>) attributes {llvm.emit_c_interface}
+
+func.func @no_arguments() attributes {llvm.emit_c_interface} {
+  return
+}
+
+func.func @without_interface(%arg0: memref<i32>) {
+  return
+}
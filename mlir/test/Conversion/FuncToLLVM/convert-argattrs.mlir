@@ -8,8 +8,15 @@ func.func @check_attributes(%int: i64 {dialect.a = true, dialect.b = 4 : i64 })
 
 // CHECK-LABEL: func @check_memref
 // When expanding the memref to multiple arguments, argument attributes should be dropped entirely.
-// CHECK-NOT: {llvm.noalias}
-func.func @check_memref(%static: memref<10x20xf32> {llvm.noalias}) {
+// CHECK-NOT: {dialect.a = true}
+func.func @check_memref(%static: memref<10x20xf32> {dialect.a = true}) {
+  return
+}
+
+// CHECK-LABEL: func @check_noalias_memref
+// The noalias attribute is only kept on the aligned pointer.
+// CHECK-SAME: (%{{.*}}: !llvm.ptr, %{{.*}}: !llvm.ptr {llvm.noalias}, %{{.*}}: i64, %{{.*}}: i64, %{{.*}}: i64, %{{.*}}: i64, %{{.*}}: i64)
+func.func @check_noalias_memref(%static: memref<10x20xf32> {llvm.noalias, dialect.a = true}) {
   return
 }
 
@@ -0,0 +1,28 @@
+// RUN: mlir-opt -convert-func-to-llvm='parallel-conversion=1' %s | FileCheck %s
+// RUN: mlir-opt -convert-func-to-llvm='parallel-conversion=1' -mlir-disable-threading %s | FileCheck %s
+
+// CHECK-LABEL: llvm.func @callee
+// CHECK-SAME: (%[[ARG0:.*]]: i64, %[[ARG1:.*]]: f32) -> i64
+func.func @callee(%arg0: index, %arg1: f32) -> index {
+  // CHECK-NOT: builtin.unrealized_conversion_cast
+  // CHECK: %[[SUM:.*]] = llvm.add %[[ARG0]], %[[ARG0]] : i64
+  %0 = arith.addi %arg0, %arg0 : index
+  // CHECK: llvm.return %[[SUM]] : i64
+  return %0 : index
+}
+
+// CHECK-LABEL: llvm.func @caller
+// CHECK-SAME: (%[[ARG0:.*]]: i64, %[[ARG1:.*]]: i1) -> i64
+func.func @caller(%arg0: index, %arg1: i1) -> index {
+  %cst = arith.constant 1.0 : f32
+  // CHECK: llvm.cond_br %[[ARG1]], ^[[BB1:.*]], ^[[BB2:.*]]
+  cf.cond_br %arg1, ^bb1, ^bb2
+^bb1:
+  // CHECK: %[[RES:.*]] = llvm.call @callee(%[[ARG0]], %{{.*}}) : (i64, f32) -> i64
+  %0 = call @callee(%arg0, %cst) : (index, f32) -> index
+  // CHECK: llvm.return %[[RES]] : i64
+  return %0 : index
+^bb2:
+  // CHECK: llvm.return %[[ARG0]] : i64
+  return %arg0 : index
+}
@@ -0,0 +1,61 @@
+// RUN: mlir-opt %s --gpu-to-llvm="gpu-binary-annotation=nvvm.cubin capture-graphs=1" | FileCheck %s
+
+module attributes {gpu.container_module} {
+
+  // CHECK: llvm.mlir.global internal @[[CACHE1:gpu_graph_cache_0]](0 : i64)
+  // CHECK: llvm.mlir.global internal @[[CACHE0:gpu_graph_cache]](0 : i64)
+
+  gpu.module @kernel_module attributes {nvvm.cubin = "CUBIN"} {
+    llvm.func @kernel(%arg0: i32) attributes {gpu.kernel} {
+      llvm.return
+    }
+  }
+
+  // CHECK-LABEL: llvm.func @sequence
+  func.func @sequence(%sz : index, %value : i32) {
+    // CHECK: %[[ADDRESS:.*]] = llvm.mlir.addressof @[[CACHE0]]
+    // CHECK: %[[RECORDING:.*]] = llvm.call @mgpuGraphBegin(%[[ADDRESS]])
+    // CHECK-NOT: llvm.call @mgpuModuleLoad
+    // CHECK: %[[SIZE:.*]] = llvm.ptrtoint
+    // CHECK: llvm.call @mgpuGraphLaunchKernel(%[[RECORDING]], {{.*}}, %[[SIZE]])
+    // CHECK-NOT: llvm.call @mgpuModuleLoad
+    // CHECK: llvm.call @mgpuGraphLaunchKernel(%[[RECORDING]],
+    // CHECK-NOT: llvm.call @mgpuModuleUnload
+    // CHECK: llvm.call @mgpuGraphEnd(%[[RECORDING]])
+    // CHECK-NOT: llvm.call @mgpuStream
+    %t0 = gpu.wait async
+    %t1 = gpu.launch_func async [%t0] @kernel_module::@kernel
+        blocks in (%sz, %sz, %sz) threads in (%sz, %sz, %sz)
+        args(%value : i32)
+    %t2 = gpu.launch_func async [%t1] @kernel_module::@kernel
+        blocks in (%sz, %sz, %sz) threads in (%sz, %sz, %sz)
+        args(%value : i32)
+    gpu.wait [%t2]
+    // CHECK: llvm.mlir.addressof @[[CACHE1]]
+    // CHECK: llvm.call @mgpuGraphBegin
+    %t3 = gpu.wait async
+    %t4 = gpu.launch_func async [%t3] @kernel_module::@kernel
+        blocks in (%sz, %sz, %sz) threads in (%sz, %sz, %sz)
+        args(%value : i32)
+    gpu.wait [%t4]
+    return
+  }
+
+  // Sequences with other ops than kernel launches use streams.
+  // CHECK-LABEL: llvm.func @not_captured
+  func.func @not_captured(%sz : index, %value : i32, %dst : memref<4xi32>,
+                          %src : memref<4xi32>) {
+    // CHECK-NOT: llvm.call @mgpuGraph
+    // CHECK: llvm.call @mgpuStreamCreate
+    // CHECK: llvm.call @mgpuLaunchKernel
+    // CHECK: llvm.call @mgpuMemcpy
+    // CHECK: llvm.call @mgpuStreamSynchronize
+    %t0 = gpu.wait async
+    %t1 = gpu.launch_func async [%t0] @kernel_module::@kernel
+        blocks in (%sz, %sz, %sz) threads in (%sz, %sz, %sz)
+        args(%value : i32)
+    %t2 = gpu.memcpy async [%t1] %dst, %src : memref<4xi32>, memref<4xi32>
+    gpu.wait [%t2]
+    return
+  }
+}
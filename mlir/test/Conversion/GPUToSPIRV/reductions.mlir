@@ -637,3 +637,56 @@ gpu.module @kernels {
 }
 
 }
+
+// -----
+
+// Without the group arithmetic capabilities, the uniform subgroup reductions
+// are converted into butterflies of subgroup shuffles.
+
+module attributes {
+  gpu.container_module,
+  spirv.target_env = #spirv.target_env<#spirv.vce<v1.3, [Kernel, Addresses, GroupNonUniformShuffle], []>, #spirv.resource_limits<subgroup_size = 4>>
+} {
+
+gpu.module @kernels {
+  // CHECK-LABEL:  spirv.func @test
+  //  CHECK-SAME: (%[[ARG:.*]]: f32)
+  gpu.func @test(%arg : f32) kernel
+    attributes {spirv.entry_point_abi = #spirv.entry_point_abi<workgroup_size = [16, 1, 1]>} {
+    //      CHECK: %[[ONE:.*]] = spirv.Constant 1 : i32
+    // CHECK-NEXT: %[[SHUFFLE0:.*]] = spirv.GroupNonUniformShuffleXor <Subgroup> %[[ARG]], %[[ONE]] : f32, i32
+    // CHECK-NEXT: %[[SUM0:.*]] = spirv.FAdd %[[ARG]], %[[SHUFFLE0]] : f32
+    // CHECK-NEXT: %[[TWO:.*]] = spirv.Constant 2 : i32
+    // CHECK-NEXT: %[[SHUFFLE1:.*]] = spirv.GroupNonUniformShuffleXor <Subgroup> %[[SUM0]], %[[TWO]] : f32, i32
+    // CHECK-NEXT: spirv.FAdd %[[SUM0]], %[[SHUFFLE1]] : f32
+    //  CHECK-NOT: spirv.GroupNonUniformShuffleXor
+    %reduced = gpu.subgroup_reduce add %arg uniform : (f32) -> (f32)
+    gpu.return
+  }
+}
+
+}
+
+// -----
+
+// The bitwise reductions have no SPIR-V group ops.
+
+module attributes {
+  gpu.container_module,
+  spirv.target_env = #spirv.target_env<#spirv.vce<v1.3, [Kernel, Addresses, Groups, GroupNonUniformArithmetic, GroupNonUniformShuffle], []>, #spirv.resource_limits<subgroup_size = 2>>
+} {
+
+gpu.module @kernels {
+  // CHECK-LABEL:  spirv.func @test
+  //  CHECK-SAME: (%[[ARG:.*]]: i32)
+  gpu.func @test(%arg : i32) kernel
+    attributes {spirv.entry_point_abi = #spirv.entry_point_abi<workgroup_size = [16, 1, 1]>} {
+    //      CHECK: %[[ONE:.*]] = spirv.Constant 1 : i32
+    // CHECK-NEXT: %[[SHUFFLE:.*]] = spirv.GroupNonUniformShuffleXor <Subgroup> %[[ARG]], %[[ONE]] : i32, i32
+    // CHECK-NEXT: spirv.BitwiseXor %[[ARG]], %[[SHUFFLE]] : i32
+    %reduced = gpu.subgroup_reduce xor %arg uniform : (i32) -> (i32)
+    gpu.return
+  }
+}
+
+}
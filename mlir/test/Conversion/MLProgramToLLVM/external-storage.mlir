@@ -0,0 +1,75 @@
+// RUN: mlir-opt -convert-ml-program-to-llvm -split-input-file -allow-unregistered-dialect -verify-diagnostics %s | FileCheck %s
+
+// CHECK-DAG: llvm.mlir.global internal constant @weights_external_storage_path("weights.bin\00")
+// CHECK-DAG: llvm.func @mlirMapExternalStorage(!llvm.ptr, i64, i64, i32) -> !llvm.ptr
+
+// CHECK-LABEL: llvm.mlir.global internal @weights() {{.*}} : !llvm.ptr {
+// CHECK:         %[[NULL:.*]] = llvm.mlir.null : !llvm.ptr
+// CHECK:         llvm.return %[[NULL]] : !llvm.ptr
+ml_program.global private @weights(#ml_program.external_storage<"weights.bin", offset = 64, size = 16> : memref<4xf32>) : memref<4xf32>
+
+// CHECK-LABEL: @load_const
+// CHECK:         %[[ADDR:.*]] = llvm.mlir.addressof @weights : !llvm.ptr
+// CHECK:         %[[PTR:.*]] = llvm.load %[[ADDR]] : !llvm.ptr -> !llvm.ptr
+// CHECK:         llvm.insertvalue %[[PTR]], %{{.*}}[0]
+// CHECK:         llvm.insertvalue %[[PTR]], %{{.*}}[1]
+// CHECK-NOT:     ml_program.global_load_const
+func.func @load_const() -> memref<4xf32> {
+  %0 = ml_program.global_load_const @weights : memref<4xf32>
+  return %0 : memref<4xf32>
+}
+
+// The module initializer maps the storage.
+// CHECK-LABEL: llvm.func @__mlir_module_init()
+// CHECK:         %[[PATH:.*]] = llvm.getelementptr %{{.*}}[0, 0] : (!llvm.ptr) -> !llvm.ptr, !llvm.array<12 x i8>
+// CHECK:         %[[OFFSET:.*]] = llvm.mlir.constant(64 : i64) : i64
+// CHECK:         %[[SIZE:.*]] = llvm.mlir.constant(16 : i64) : i64
+// CHECK:         %[[MUTABLE:.*]] = llvm.mlir.constant(0 : i32) : i32
+// CHECK:         %[[STORAGE:.*]] = llvm.call @mlirMapExternalStorage(%[[PATH]], %[[OFFSET]], %[[SIZE]], %[[MUTABLE]])
+// CHECK:         %[[GLOBAL:.*]] = llvm.mlir.addressof @weights : !llvm.ptr
+// CHECK:         llvm.store %[[STORAGE]], %[[GLOBAL]] : !llvm.ptr, !llvm.ptr
+// CHECK:         llvm.return
+
+// -----
+
+// An existing module initializer maps the storage first.
+// CHECK-LABEL: llvm.mlir.global external @state()
+ml_program.global public mutable @state(#ml_program.external_storage<"state.bin", offset = 0, size = 8> : memref<2xi32>) : memref<2xi32>
+
+// The other globals are left alone.
+// CHECK: ml_program.global private @other
+ml_program.global private @other(dense<4> : tensor<4xi32>) : tensor<4xi32>
+
+// CHECK-LABEL: func.func @__mlir_module_init()
+// CHECK:         %[[MUTABLE:.*]] = llvm.mlir.constant(1 : i32) : i32
+// CHECK:         llvm.call @mlirMapExternalStorage
+// CHECK:         llvm.store
+// CHECK:         "test.init"() : () -> ()
+func.func @__mlir_module_init() {
+  "test.init"() : () -> ()
+  return
+}
+
+// CHECK-LABEL: @load
+// CHECK:         llvm.mlir.addressof @state : !llvm.ptr
+// CHECK:         ml_program.global_load_const @other
+func.func @load() -> (memref<2xi32>, tensor<4xi32>) {
+  %0 = ml_program.global_load @state : memref<2xi32>
+  %1 = ml_program.global_load_const @other : tensor<4xi32>
+  return %0, %1 : memref<2xi32>, tensor<4xi32>
+}
+
+// -----
+
+// expected-error @+1 {{with external storage must have a statically shaped memref type with the identity layout}}
+ml_program.global private @tensor(#ml_program.external_storage<"weights.bin", offset = 0, size = 16> : tensor<4xf32>) : tensor<4xf32>
+
+// -----
+
+ml_program.global private mutable @stored(#ml_program.external_storage<"weights.bin", offset = 0, size = 16> : memref<4xf32>) : memref<4xf32>
+
+func.func @store(%arg0: memref<4xf32>) {
+  // expected-error @+1 {{cannot use the global with external storage stored}}
+  ml_program.global_store @stored = %arg0 : memref<4xf32>
+  return
+}
@@ -463,3 +463,64 @@ func.func @mma_sp_sync_i8_16864(%arg0: vector<4x4xi8>,
     (vector<4x4xi8>, vector<4x4xi8>, vector<2x2xi32>) -> vector<2x2xi32>
   return %d : vector<2x2xi32>
 }
+
+// -----
+
+// CHECK-LABEL: @mbarrier
+func.func @mbarrier(%barriers: memref<2xi64, 3>, %count: index, %bytes: index, %phase: i1) {
+  %c1 = arith.constant 1 : index
+  // CHECK: %[[PTR:.+]] = llvm.getelementptr %{{.*}}[%{{.*}}] : (!llvm.ptr<3>, i64) -> !llvm.ptr<3>
+  // CHECK: %[[COUNT:.+]] = llvm.trunc %{{.*}} : i64 to i32
+  // CHECK: nvvm.mbarrier.init.shared %[[PTR]], %[[COUNT]] : !llvm.ptr<3>, i32
+  nvgpu.mbarrier.init %barriers[%c1], %count : memref<2xi64, 3>
+  // CHECK: %[[TX:.+]] = llvm.trunc %{{.*}} : i64 to i32
+  // CHECK: %[[ADDR:.+]] = llvm.ptrtoint %{{.*}} : !llvm.ptr<3> to i32
+  // CHECK: llvm.inline_asm has_side_effects asm_dialect = att "mbarrier.arrive.expect_tx.shared::cta.b64 _, [$0], $1;", "r,r" %[[ADDR]], %[[TX]] : (i32, i32) -> ()
+  nvgpu.mbarrier.arrive.expect_tx %barriers[%c1], %bytes : memref<2xi64, 3>
+  // CHECK: %[[PHASE:.+]] = llvm.zext %{{.*}} : i1 to i32
+  // CHECK: llvm.inline_asm has_side_effects asm_dialect = att "{\0A.reg .pred p;\0ALAB_WAIT:\0Ambarrier.try_wait.parity.shared::cta.b64 p, [$0], $1;\0A@!p bra.uni LAB_WAIT;\0A}\0A", "r,r" %{{.*}}, %[[PHASE]] : (i32, i32) -> ()
+  nvgpu.mbarrier.try_wait.parity %barriers[%c1], %phase : memref<2xi64, 3>
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @tma_async_load
+// CHECK-SAME: %{{.*}}: memref<64x32xf16, 3>, %[[MAP:.+]]: i64
+func.func @tma_async_load(%tile: memref<64x32xf16, 3>, %tensorMap: i64, %barriers: memref<1xi64, 3>, %x: index, %y: index) {
+  %c0 = arith.constant 0 : index
+  // CHECK: %[[DST:.+]] = llvm.ptrtoint %{{.*}} : !llvm.ptr<3> to i32
+  // CHECK: %[[Y:.+]] = llvm.trunc %{{.*}} : i64 to i32
+  // CHECK: %[[X:.+]] = llvm.trunc %{{.*}} : i64 to i32
+  // CHECK: %[[BAR:.+]] = llvm.ptrtoint %{{.*}} : !llvm.ptr<3> to i32
+  // CHECK: llvm.inline_asm has_side_effects asm_dialect = att "cp.async.bulk.tensor.2d.shared::cluster.global.mbarrier::complete_tx::bytes [$0], [$1, {$2, $3}], [$4];", "r,l,r,r,r" %[[DST]], %[[MAP]], %[[Y]], %[[X]], %[[BAR]] : (i32, i64, i32, i32, i32) -> ()
+  nvgpu.tma.async.load %tensorMap[%x, %y], %barriers[%c0] to %tile : memref<1xi64, 3>, memref<64x32xf16, 3>
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @warpgroup_mma
+func.func @warpgroup_mma(%tileA: memref<64x16xf16, 3>, %tileB: memref<16x16xf16, 3>, %acc: vector<8xf32>) -> vector<8xf32> {
+  // CHECK: %[[ADDR:.+]] = llvm.ptrtoint %{{.*}} : !llvm.ptr<3> to i64
+  // CHECK: %[[MASK:.+]] = llvm.mlir.constant(262143 : i64) : i64
+  // CHECK: %[[MASKED:.+]] = llvm.and %[[ADDR]], %[[MASK]] : i64
+  // CHECK: %[[C4:.+]] = llvm.mlir.constant(4 : i64) : i64
+  // CHECK: %[[START:.+]] = llvm.lshr %[[MASKED]], %[[C4]] : i64
+  // CHECK: %[[BITS:.+]] = llvm.mlir.constant(4611686293305819136 : i64) : i64
+  // CHECK: %[[DESCA:.+]] = llvm.or %[[START]], %[[BITS]] : i64
+  %descA = nvgpu.warpgroup.generate.descriptor %tileA {leadingByteOffset = 128 : i64, strideByteOffset = 1024 : i64, swizzle = 128 : i64} : memref<64x16xf16, 3>
+  // CHECK: %[[BITSB:.+]] = llvm.mlir.constant(34359738368 : i64) : i64
+  // CHECK: %[[DESCB:.+]] = llvm.or %{{.*}}, %[[BITSB]] : i64
+  %descB = nvgpu.warpgroup.generate.descriptor %tileB {leadingByteOffset = 0 : i64, strideByteOffset = 128 : i64} : memref<16x16xf16, 3>
+  // CHECK-COUNT-8: llvm.extractelement %{{.*}}[%{{.*}} : i32] : vector<8xf32>
+  // CHECK: %[[ONE:.+]] = llvm.mlir.constant(1 : i32) : i32
+  // CHECK: %[[RES:.+]] = llvm.inline_asm has_side_effects asm_dialect = att
+  // CHECK-SAME: "{\0A.reg .pred p;\0Asetp.ne.b32 p, $18, 0;\0Awgmma.fence.sync.aligned;\0Awgmma.mma_async.sync.aligned.m64n16k16.f32.f16.f16 {$0, $1, $2, $3, $4, $5, $6, $7}, $16, $17, p, 1, 1, 0, 1;\0Awgmma.commit_group.sync.aligned;\0Awgmma.wait_group.sync.aligned 0;\0A}\0A"
+  // CHECK-SAME: "=f,=f,=f,=f,=f,=f,=f,=f,0,1,2,3,4,5,6,7,l,l,r"
+  // CHECK-SAME: %[[DESCA]], %[[DESCB]], %[[ONE]]
+  // CHECK-SAME: -> !llvm.struct<(f32, f32, f32, f32, f32, f32, f32, f32)>
+  // CHECK-COUNT-8: llvm.insertelement
+  %d = nvgpu.warpgroup.mma %descA, %descB, %acc {operandType = f16, transposeB} : vector<8xf32>
+  return %d : vector<8xf32>
+}
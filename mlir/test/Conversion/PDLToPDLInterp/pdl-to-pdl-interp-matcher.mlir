@@ -410,6 +410,43 @@ module @predicate_ordering {
 }
 
 
+// -----
+
+// CHECK-LABEL: module @predicate_ordering_per_node
+module @predicate_ordering_per_node {
+  // Check that the predicates are ordered by their occurrences among the
+  // patterns reaching each node: "l" is checked before "g" for the "foo.op"
+  // patterns, even though "g" is checked by more patterns, and thus once.
+
+  // CHECK: func @matcher(%[[ROOT:.*]]: !pdl.operation)
+  // CHECK: pdl_interp.switch_operation_name of %[[ROOT]] to ["foo.op", "bar.op", "baz.op"]
+  // CHECK-COUNT-1: pdl_interp.get_attribute "l" of %[[ROOT]]
+  // CHECK-NOT: pdl_interp.get_attribute "l"
+  // CHECK: module @rewriters
+
+  pdl.pattern : benefit(1) {
+    %attr = attribute
+    %attr1 = attribute
+    %root = operation "foo.op" {"l" = %attr, "g" = %attr1}
+    rewrite %root with "rewriter"
+  }
+  pdl.pattern : benefit(1) {
+    %attr = attribute
+    %root = operation "foo.op" {"l" = %attr}
+    rewrite %root with "rewriter"
+  }
+  pdl.pattern : benefit(1) {
+    %attr = attribute
+    %root = operation "bar.op" {"g" = %attr}
+    rewrite %root with "rewriter"
+  }
+  pdl.pattern : benefit(1) {
+    %attr = attribute
+    %root = operation "baz.op" {"g" = %attr}
+    rewrite %root with "rewriter"
+  }
+}
+
 // -----
 
 // CHECK-LABEL: module @multi_root
@@ -0,0 +1,27 @@
+// RUN: mlir-opt %s -affine-parallelize="parallel-reductions=1" -lower-affine \
+// RUN:   -convert-scf-to-openmp='use-opaque-pointers=1' | FileCheck %s
+
+// The reductions detected on affine loops are lowered to OpenMP reductions.
+
+// CHECK: omp.reduction.declare @[[$RED:.*]] : f32
+// CHECK: combiner
+// CHECK: arith.maxf
+
+// CHECK-LABEL: func @row_max
+// CHECK: omp.parallel
+// CHECK: omp.wsloop for (%{{.*}}) :
+// CHECK: omp.parallel
+// CHECK: omp.wsloop reduction(@[[$RED]] -> %{{.*}}
+// CHECK: omp.reduction
+func.func @row_max(%A: memref<256x512xf32>, %B: memref<256xf32>) {
+  %init = arith.constant 0xFF800000 : f32
+  affine.for %i = 0 to 256 {
+    %max = affine.for %j = 0 to 512 iter_args(%acc = %init) -> (f32) {
+      %v = affine.load %A[%i, %j] : memref<256x512xf32>
+      %m = arith.maxf %acc, %v : f32
+      affine.yield %m : f32
+    }
+    affine.store %max, %B[%i] : memref<256xf32>
+  }
+  return
+}
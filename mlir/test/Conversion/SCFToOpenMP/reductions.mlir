@@ -229,3 +229,72 @@ func.func @reduction4(%arg0 : index, %arg1 : index, %arg2 : index,
   // CHECK: return %[[RES1]], %[[RES2]]
   return %res#0, %res#1 : f32, i64
 }
+
+// -----
+
+// CHECK: omp.reduction.declare @[[$REDF:.*]] : f32
+
+// CHECK: init
+// CHECK: %[[INIT:.*]] = llvm.mlir.constant(-3.4
+// CHECK: omp.yield(%[[INIT]] : f32)
+
+// CHECK: combiner
+// CHECK: ^{{.*}}(%[[ARG0:.*]]: f32, %[[ARG1:.*]]: f32)
+// CHECK: %[[RES:.*]] = arith.maxf %[[ARG0]], %[[ARG1]]
+// CHECK: omp.yield(%[[RES]] : f32)
+
+// CHECK-NOT: atomic
+
+// CHECK-LABEL: @reduction_maxf
+func.func @reduction_maxf(%arg0 : index, %arg1 : index, %arg2 : index) {
+  %init = arith.constant 0.0 : f32
+  // CHECK: omp.wsloop
+  // CHECK-SAME: reduction(@[[$REDF]] -> %{{.*}}
+  scf.parallel (%i0) = (%arg0) to (%arg1) step (%arg2)
+                       init (%init) -> (f32) {
+    %one = arith.constant 1.0 : f32
+    // CHECK: omp.reduction
+    scf.reduce(%one) : f32 {
+    ^bb0(%lhs : f32, %rhs: f32):
+      %res = arith.maxf %lhs, %rhs : f32
+      scf.reduce.return %res : f32
+    }
+  }
+  return
+}
+
+// -----
+
+// CHECK: omp.reduction.declare @[[$REDI:.*]] : i32
+
+// CHECK: init
+// CHECK: %[[INIT:.*]] = llvm.mlir.constant(-1 : i32)
+// CHECK: omp.yield(%[[INIT]] : i32)
+
+// CHECK: combiner
+// CHECK: ^{{.*}}(%[[ARG0:.*]]: i32, %[[ARG1:.*]]: i32)
+// CHECK: %[[RES:.*]] = arith.minui %[[ARG0]], %[[ARG1]]
+// CHECK: omp.yield(%[[RES]] : i32)
+
+// CHECK: atomic
+// CHECK: ^{{.*}}(%[[ARG0:.*]]: !llvm.ptr, %[[ARG1:.*]]: !llvm.ptr):
+// CHECK: %[[RHS:.*]] = llvm.load %[[ARG1]] : !llvm.ptr -> i32
+// CHECK: llvm.atomicrmw umin %[[ARG0]], %[[RHS]] monotonic
+
+// CHECK-LABEL: @reduction_minui
+func.func @reduction_minui(%arg0 : index, %arg1 : index, %arg2 : index) {
+  %init = arith.constant 0 : i32
+  // CHECK: omp.wsloop
+  // CHECK-SAME: reduction(@[[$REDI]] -> %{{.*}}
+  scf.parallel (%i0) = (%arg0) to (%arg1) step (%arg2)
+                       init (%init) -> (i32) {
+    %one = arith.constant 1 : i32
+    // CHECK: omp.reduction
+    scf.reduce(%one) : i32 {
+    ^bb0(%lhs : i32, %rhs: i32):
+      %res = arith.minui %lhs, %rhs : i32
+      scf.reduce.return %res : i32
+    }
+  }
+  return
+}
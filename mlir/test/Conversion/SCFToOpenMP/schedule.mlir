@@ -0,0 +1,25 @@
+// RUN: mlir-opt -convert-scf-to-openmp="schedule=dynamic chunk-size=16 simd" %s | FileCheck %s
+// RUN: mlir-opt -convert-scf-to-openmp="schedule=guided" %s | FileCheck %s --check-prefix=GUIDED
+
+// The simd modifier is only added to the innermost loops.
+
+// CHECK-LABEL: @nested_loops
+// CHECK:         omp.parallel {
+// CHECK:           %[[CHUNK:.*]] = llvm.mlir.constant(16 : i64) : i64
+// CHECK:           omp.wsloop schedule(dynamic = %[[CHUNK]] : i64) for
+// CHECK:             omp.parallel {
+// CHECK:               %[[CHUNK1:.*]] = llvm.mlir.constant(16 : i64) : i64
+// CHECK:               omp.wsloop schedule(dynamic = %[[CHUNK1]] : i64, simd) for
+
+// GUIDED-LABEL: @nested_loops
+// GUIDED:         omp.wsloop schedule(guided) for
+// GUIDED:         omp.wsloop schedule(guided) for
+func.func @nested_loops(%arg0: index, %arg1: index, %arg2: index,
+                        %arg3: index, %arg4: index, %arg5: index) {
+  scf.parallel (%i) = (%arg0) to (%arg2) step (%arg4) {
+    scf.parallel (%j) = (%arg1) to (%arg3) step (%arg5) {
+      "test.payload"(%i, %j) : (index, index) -> ()
+    }
+  }
+  return
+}
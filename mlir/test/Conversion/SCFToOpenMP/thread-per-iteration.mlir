@@ -0,0 +1,42 @@
+// RUN: mlir-opt -convert-scf-to-openmp %s | FileCheck %s
+
+// The loops marked to run each iteration on its own thread use as many
+// threads as iterations.
+
+// CHECK-LABEL: @static_bounds
+// CHECK:         %[[NUM:.*]] = arith.constant 32 : i32
+// CHECK:         omp.parallel num_threads(%[[NUM]] : i32) {
+// CHECK:           omp.wsloop for
+func.func @static_bounds() {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %c4 = arith.constant 4 : index
+  %c16 = arith.constant 16 : index
+  scf.parallel (%i, %j) = (%c0, %c0) to (%c4, %c16) step (%c1, %c2) {
+    "test.payload"(%i, %j) : (index, index) -> ()
+  } {scf.thread_per_iteration}
+  return
+}
+
+// CHECK-LABEL: @dynamic_bounds
+// CHECK-SAME:    %[[LB:.*]]: index, %[[UB:.*]]: index, %[[STEP:.*]]: index
+// CHECK:         %[[RANGE:.*]] = arith.subi %[[UB]], %[[LB]] : index
+// CHECK:         %[[TRIP:.*]] = arith.ceildivsi %[[RANGE]], %[[STEP]] : index
+// CHECK:         %[[NUM:.*]] = arith.index_cast %[[TRIP]] : index to i32
+// CHECK:         omp.parallel num_threads(%[[NUM]] : i32) {
+func.func @dynamic_bounds(%lb: index, %ub: index, %step: index) {
+  scf.parallel (%i) = (%lb) to (%ub) step (%step) {
+    "test.payload"(%i) : (index) -> ()
+  } {scf.thread_per_iteration}
+  return
+}
+
+// CHECK-LABEL: @unmarked
+// CHECK:         omp.parallel {
+func.func @unmarked(%lb: index, %ub: index, %step: index) {
+  scf.parallel (%i) = (%lb) to (%ub) step (%step) {
+    "test.payload"(%i) : (index) -> ()
+  }
+  return
+}
@@ -0,0 +1,80 @@
+// RUN: mlir-opt %s -pass-pipeline="builtin.module(func.func(convert-vector-to-gpu{use-amdgpu}))" --split-input-file | FileCheck %s
+
+#map1 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map3 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// CHECK-LABEL: func @matmul
+//   CHECK-DAG:   %[[TID:.+]] = gpu.thread_id x
+//       CHECK:   %[[A:.+]] = vector.load %{{.*}}[%{{.*}}, %{{.*}}] : memref<16x16xf16>, vector<4xf16>
+//   CHECK-NOT:   vector.transfer_read
+//       CHECK:   %[[B0:.+]] = memref.load %{{.*}}[%{{.*}}, %{{.*}}] : memref<16x16xf16>
+//       CHECK:   vector.insert %[[B0]], %{{.*}} [0] : f16 into vector<4xf16>
+//       CHECK:   %[[C0:.+]] = memref.load %{{.*}}[%{{.*}}, %{{.*}}] : memref<16x16xf32>
+//       CHECK:   vector.insert %[[C0]], %{{.*}} [0] : f32 into vector<4xf32>
+//       CHECK:   %[[D:.+]] = amdgpu.mfma %[[A]] * %{{.*}} + %{{.*}} {{.*}}k = 16 : i32, m = 16 : i32, n = 16 : i32{{.*}} : vector<4xf16>, vector<4xf16>, vector<4xf32>
+//       CHECK:   %[[D0:.+]] = vector.extract %[[D]][0] : vector<4xf32>
+//       CHECK:   memref.store %[[D0]], %{{.*}}[%{{.*}}, %{{.*}}] : memref<16x16xf32>
+//   CHECK-NOT:   vector.contract
+//   CHECK-NOT:   vector.transfer_write
+func.func @matmul(%arg0: memref<16x16xf16>, %arg1: memref<16x16xf16>, %arg2: memref<16x16xf32>) {
+  %c0 = arith.constant 0 : index
+  %cst = arith.constant 0.000000e+00 : f16
+  %cst_f32 = arith.constant 0.000000e+00 : f32
+  %A = vector.transfer_read %arg0[%c0, %c0], %cst {in_bounds = [true, true]} : memref<16x16xf16>, vector<16x16xf16>
+  %B = vector.transfer_read %arg1[%c0, %c0], %cst {in_bounds = [true, true]} : memref<16x16xf16>, vector<16x16xf16>
+  %C = vector.transfer_read %arg2[%c0, %c0], %cst_f32 {in_bounds = [true, true]} : memref<16x16xf32>, vector<16x16xf32>
+  %D = vector.contract {indexing_maps = [#map1, #map2, #map3], iterator_types = ["parallel", "parallel", "reduction"], kind = #vector.kind<add>} %A, %B, %C : vector<16x16xf16>, vector<16x16xf16> into vector<16x16xf32>
+  vector.transfer_write %D, %arg2[%c0, %c0] {in_bounds = [true, true]} : vector<16x16xf32>, memref<16x16xf32>
+  return
+}
+
+// -----
+
+#map0 = affine_map<(d0, d1) -> (d1, d0)>
+#map1 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map3 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// The fragments of a transposed B are contiguous, and the splat accumulator
+// becomes a splat fragment.
+
+// CHECK-LABEL: func @matmul_transposed_b_cst
+//   CHECK-DAG:   %[[C:.+]] = arith.constant dense<0.000000e+00> : vector<4xf32>
+//       CHECK:   %[[A:.+]] = vector.load %{{.*}}[%{{.*}}, %{{.*}}] : memref<16x16xf16>, vector<4xf16>
+//       CHECK:   %[[B:.+]] = vector.load %{{.*}}[%{{.*}}, %{{.*}}] : memref<16x16xf16>, vector<4xf16>
+//       CHECK:   %[[D:.+]] = amdgpu.mfma %[[A]] * %[[B]] + %[[C]]
+//  CHECK-COUNT-4:   memref.store %{{.*}} : memref<16x16xf32>
+//   CHECK-NOT:   vector.contract
+func.func @matmul_transposed_b_cst(%arg0: memref<16x16xf16>, %arg1: memref<16x16xf16>, %arg2: memref<16x16xf32>) {
+  %c0 = arith.constant 0 : index
+  %cst = arith.constant 0.000000e+00 : f16
+  %C = arith.constant dense<0.000000e+00> : vector<16x16xf32>
+  %A = vector.transfer_read %arg0[%c0, %c0], %cst {in_bounds = [true, true]} : memref<16x16xf16>, vector<16x16xf16>
+  %B = vector.transfer_read %arg1[%c0, %c0], %cst {permutation_map = #map0, in_bounds = [true, true]} : memref<16x16xf16>, vector<16x16xf16>
+  %D = vector.contract {indexing_maps = [#map1, #map2, #map3], iterator_types = ["parallel", "parallel", "reduction"], kind = #vector.kind<add>} %A, %B, %C : vector<16x16xf16>, vector<16x16xf16> into vector<16x16xf32>
+  vector.transfer_write %D, %arg2[%c0, %c0] {in_bounds = [true, true]} : vector<16x16xf32>, memref<16x16xf32>
+  return
+}
+
+// -----
+
+#map1 = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map3 = affine_map<(d0, d1, d2) -> (d0, d1)>
+
+// Masked reads are left untouched.
+
+// CHECK-LABEL: func @matmul_masked
+//   CHECK-NOT:   amdgpu.mfma
+//       CHECK:   vector.contract
+func.func @matmul_masked(%arg0: memref<16x16xf16>, %arg1: memref<16x16xf16>, %arg2: memref<16x16xf32>, %mask: vector<16x16xi1>) {
+  %c0 = arith.constant 0 : index
+  %cst = arith.constant 0.000000e+00 : f16
+  %C = arith.constant dense<0.000000e+00> : vector<16x16xf32>
+  %A = vector.transfer_read %arg0[%c0, %c0], %cst, %mask {in_bounds = [true, true]} : memref<16x16xf16>, vector<16x16xf16>
+  %B = vector.transfer_read %arg1[%c0, %c0], %cst {in_bounds = [true, true]} : memref<16x16xf16>, vector<16x16xf16>
+  %D = vector.contract {indexing_maps = [#map1, #map2, #map3], iterator_types = ["parallel", "parallel", "reduction"], kind = #vector.kind<add>} %A, %B, %C : vector<16x16xf16>, vector<16x16xf16> into vector<16x16xf32>
+  vector.transfer_write %D, %arg2[%c0, %c0] {in_bounds = [true, true]} : vector<16x16xf32>, memref<16x16xf32>
+  return
+}
@@ -22,6 +22,20 @@ func.func @reduce_add_f32(%arg0: vector<16xf32>) -> f32 {
 
 // -----
 
+// The reductions nested in a fast-math policy that allows reassociation are
+// reassociated.
+
+// CHECK-LABEL: @reduce_add_f32_fastmath_policy(
+//      CHECK: "llvm.intr.vector.reduce.fadd"
+// CHECK-SAME: <{reassoc = true}> : (f32, vector<16xf32>) -> f32
+func.func @reduce_add_f32_fastmath_policy(%arg0: vector<16xf32>) -> f32
+    attributes {arith.fastmath = #arith.fastmath<reassoc,contract>} {
+  %0 = vector.reduction <add>, %arg0 : vector<16xf32> into f32
+  return %0 : f32
+}
+
+// -----
+
 // CHECK-LABEL: @reduce_mul_f32(
 // CHECK-SAME: %[[A:.*]]: vector<16xf32>)
 //      CHECK: %[[C:.*]] = llvm.mlir.constant(1.000000e+00 : f32) : f32
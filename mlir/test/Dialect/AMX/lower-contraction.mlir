@@ -0,0 +1,89 @@
+// RUN: mlir-opt %s -split-input-file -convert-vector-to-llvm="enable-amx" | \
+// RUN:   FileCheck %s
+
+#map_a = affine_map<(m, n, k) -> (m, k)>
+#map_b = affine_map<(m, n, k) -> (k, n)>
+#map_c = affine_map<(m, n, k) -> (m, n)>
+
+// The bf16 matmul is computed by a tile multiplication. The right-hand side
+// is packed in the VNNI layout through a buffer, while the left-hand side and
+// the result are loaded from and stored to their memrefs.
+
+// CHECK-LABEL: func @matmul_bf16(
+//       CHECK:   memref.alloca
+//       CHECK:   amx.tileloadd64
+//       CHECK:   amx.tileloadd64
+//       CHECK:   amx.tileloadd64
+//       CHECK:   amx.tdpbf16ps
+//       CHECK:   amx.tilestored64
+func.func @matmul_bf16(%a: memref<16x32xbf16>, %b: memref<32x16xbf16>,
+                       %c: memref<16x16xf32>) {
+  %c0 = arith.constant 0 : index
+  %pad = arith.constant 0.0 : bf16
+  %fpad = arith.constant 0.0 : f32
+  %0 = vector.transfer_read %a[%c0, %c0], %pad {in_bounds = [true, true]}
+    : memref<16x32xbf16>, vector<16x32xbf16>
+  %1 = vector.transfer_read %b[%c0, %c0], %pad {in_bounds = [true, true]}
+    : memref<32x16xbf16>, vector<32x16xbf16>
+  %2 = vector.transfer_read %c[%c0, %c0], %fpad {in_bounds = [true, true]}
+    : memref<16x16xf32>, vector<16x16xf32>
+  %3 = vector.contract {indexing_maps = [#map_a, #map_b, #map_c],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>}
+    %0, %1, %2 : vector<16x32xbf16>, vector<32x16xbf16> into vector<16x16xf32>
+  vector.transfer_write %3, %c[%c0, %c0] {in_bounds = [true, true]}
+    : vector<16x16xf32>, memref<16x16xf32>
+  return
+}
+
+// -----
+
+#map_a = affine_map<(m, n, k) -> (m, k)>
+#map_b = affine_map<(m, n, k) -> (k, n)>
+#map_c = affine_map<(m, n, k) -> (m, n)>
+
+// The extensions of the i8 operands select the signedness of the tile
+// multiplication, and a zero accumulator is a zero tile.
+
+// CHECK-LABEL: func @matmul_i8(
+//       CHECK:   amx.tilezero
+//       CHECK:   amx.tdpbusd
+func.func @matmul_i8(%a: vector<16x64xi8>, %b: vector<64x16xi8>)
+    -> vector<16x16xi32> {
+  %zero = arith.constant dense<0> : vector<16x16xi32>
+  %0 = arith.extui %a : vector<16x64xi8> to vector<16x64xi32>
+  %1 = arith.extsi %b : vector<64x16xi8> to vector<64x16xi32>
+  %2 = vector.contract {indexing_maps = [#map_a, #map_b, #map_c],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>}
+    %0, %1, %zero : vector<16x64xi32>, vector<64x16xi32> into vector<16x16xi32>
+  return %2 : vector<16x16xi32>
+}
+
+// -----
+
+#map_a = affine_map<(m, n, k) -> (m, k)>
+#map_b = affine_map<(m, n, k) -> (k, n)>
+#map_c = affine_map<(m, n, k) -> (m, n)>
+
+// Contractions that do not fit in tiles, or whose i8 operands are not
+// extended, are lowered as usual.
+
+// CHECK-LABEL: func @not_lowered(
+//   CHECK-NOT:   amx.tdpbf16ps
+//   CHECK-NOT:   amx.tdpbssd
+//       CHECK:   return
+func.func @not_lowered(%a: vector<32x2xbf16>, %b: vector<2x16xbf16>,
+                       %c: vector<32x16xf32>, %d: vector<4x4xi8>,
+                       %e: vector<4x4xi8>, %f: vector<4x4xi8>)
+    -> (vector<32x16xf32>, vector<4x4xi8>) {
+  %0 = vector.contract {indexing_maps = [#map_a, #map_b, #map_c],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>}
+    %a, %b, %c : vector<32x2xbf16>, vector<2x16xbf16> into vector<32x16xf32>
+  %1 = vector.contract {indexing_maps = [#map_a, #map_b, #map_c],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>}
+    %d, %e, %f : vector<4x4xi8>, vector<4x4xi8> into vector<4x4xi8>
+  return %0, %1 : vector<32x16xf32>, vector<4x4xi8>
+}
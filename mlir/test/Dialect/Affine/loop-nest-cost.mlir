@@ -0,0 +1,45 @@
+// RUN: mlir-opt %s -split-input-file -test-affine-loop-nest-cost \
+// RUN:   -o /dev/null 2>&1 | FileCheck %s
+// RUN: mlir-opt %s -split-input-file -o /dev/null \
+// RUN:   -test-affine-loop-nest-cost="cache-size=1 memory-bandwidth=1" 2>&1 | \
+// RUN:   FileCheck %s --check-prefix=SMALL-CACHE
+
+// With the default 512 KiB cache, the 48 KiB accessed by the nest are
+// transferred once, and the issue of the 6 operations of each of the 64^3
+// iterations dominates. With a 1 KiB cache, only the rows and the columns
+// accessed by the innermost loop are reused, and the transfer of the memory
+// traffic at 1 byte per cycle dominates.
+
+func.func @matmul(%A: memref<64x64xf32>, %B: memref<64x64xf32>,
+                  %C: memref<64x64xf32>) {
+  // CHECK: remark: 1572864 ops, 49152 bytes, 393216 cycles
+  // SMALL-CACHE: remark: 1572864 ops, 2113536 bytes, 2113536 cycles
+  affine.for %i = 0 to 64 {
+    affine.for %j = 0 to 64 {
+      affine.for %k = 0 to 64 {
+        %a = affine.load %A[%i, %k] : memref<64x64xf32>
+        %b = affine.load %B[%k, %j] : memref<64x64xf32>
+        %c = affine.load %C[%i, %j] : memref<64x64xf32>
+        %p = arith.mulf %a, %b : f32
+        %s = arith.addf %c, %p : f32
+        affine.store %s, %C[%i, %j] : memref<64x64xf32>
+      }
+    }
+  }
+  return
+}
+
+// -----
+
+// The trip count of the inner loop is not constant.
+
+func.func @unknown_trip_count(%A: memref<?xf32>, %n: index) {
+  // CHECK: remark: unknown cost
+  affine.for %i = 0 to 64 {
+    affine.for %j = 0 to %n {
+      %v = affine.load %A[%j] : memref<?xf32>
+      affine.store %v, %A[%j] : memref<?xf32>
+    }
+  }
+  return
+}
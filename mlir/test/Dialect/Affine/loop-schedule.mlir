@@ -0,0 +1,104 @@
+// RUN: mlir-opt %s -split-input-file \
+// RUN:   -affine-loop-schedule="tile-size=0 parallelize=false" | \
+// RUN:   FileCheck %s --check-prefix=PERM
+// RUN: mlir-opt %s -split-input-file -affine-loop-schedule | FileCheck %s
+
+// The dependence is carried by %i, so %j, along which it has a zero distance,
+// is scheduled outermost and is parallel. Within the tiles, the loop along
+// which the accesses are contiguous is innermost.
+
+// PERM-LABEL: func @interchange
+//       PERM:   affine.for %[[J:.*]] = 0 to 64 {
+//  PERM-NEXT:     affine.for %[[I:.*]] = 1 to 64 {
+//  PERM-NEXT:       affine.load %{{.*}}[%[[I]] - 1, %[[J]]]
+
+// CHECK-LABEL: func @interchange
+//       CHECK:   affine.parallel (%[[JT:.*]]) = (0) to (64) step (32) {
+//  CHECK-NEXT:     affine.for %[[IT:.*]] = 1 to 64 step 32 {
+//  CHECK-NEXT:       affine.for %[[I:.*]] = {{.*}}(%[[IT]])
+//  CHECK-NEXT:         affine.for %[[J:.*]] = {{.*}}(%[[JT]])
+//  CHECK-NEXT:           affine.load %{{.*}}[%[[I]] - 1, %[[J]]]
+func.func @interchange(%A: memref<64x64xf32>) {
+  affine.for %i = 1 to 64 {
+    affine.for %j = 0 to 64 {
+      %v = affine.load %A[%i - 1, %j] : memref<64x64xf32>
+      affine.store %v, %A[%i, %j] : memref<64x64xf32>
+    }
+  }
+  return
+}
+
+// -----
+
+// The reduction is carried by %k, which stays innermost across the tiles and
+// is interchanged with %j within them.
+
+// PERM-LABEL: func @matmul
+//       PERM:   affine.for %[[I:.*]] = 0 to 64 {
+//  PERM-NEXT:     affine.for %[[J:.*]] = 0 to 64 {
+//  PERM-NEXT:       affine.for %[[K:.*]] = 0 to 64 {
+
+// CHECK-LABEL: func @matmul
+//       CHECK:   affine.parallel (%[[IT:.*]]) = (0) to (64) step (32) {
+//  CHECK-NEXT:     affine.for %[[JT:.*]] = 0 to 64 step 32 {
+//  CHECK-NEXT:       affine.for %[[KT:.*]] = 0 to 64 step 32 {
+//  CHECK-NEXT:         affine.for %[[I:.*]] = {{.*}}(%[[IT]])
+//  CHECK-NEXT:           affine.for %[[K:.*]] = {{.*}}(%[[KT]])
+//  CHECK-NEXT:             affine.for %[[J:.*]] = {{.*}}(%[[JT]])
+//  CHECK-NEXT:               affine.load %{{.*}}[%[[I]], %[[K]]]
+func.func @matmul(%A: memref<64x64xf32>, %B: memref<64x64xf32>,
+                  %C: memref<64x64xf32>) {
+  affine.for %i = 0 to 64 {
+    affine.for %j = 0 to 64 {
+      affine.for %k = 0 to 64 {
+        %a = affine.load %A[%i, %k] : memref<64x64xf32>
+        %b = affine.load %B[%k, %j] : memref<64x64xf32>
+        %c = affine.load %C[%i, %j] : memref<64x64xf32>
+        %p = arith.mulf %a, %b : f32
+        %s = arith.addf %c, %p : f32
+        affine.store %s, %C[%i, %j] : memref<64x64xf32>
+      }
+    }
+  }
+  return
+}
+
+// -----
+
+// The dependence has a negative distance along %j, which cannot be permuted
+// with %i: the loops form bands of one loop, which are not tiled.
+
+// CHECK-LABEL: func @no_permutable_band
+//       CHECK:   affine.for %[[I:.*]] = 1 to 64 {
+//  CHECK-NEXT:     affine.parallel (%[[J:.*]]) = (0) to (63) {
+//  CHECK-NEXT:       affine.load %{{.*}}[%[[I]] - 1, %[[J]] + 1]
+func.func @no_permutable_band(%A: memref<64x64xf32>) {
+  affine.for %i = 1 to 64 {
+    affine.for %j = 0 to 63 {
+      %v = affine.load %A[%i - 1, %j + 1] : memref<64x64xf32>
+      affine.store %v, %A[%i, %j] : memref<64x64xf32>
+    }
+  }
+  return
+}
+
+// -----
+
+// The nests with unknown side effects are left untouched.
+
+// CHECK-LABEL: func @unknown_effects
+//       CHECK:   affine.for %{{.*}} = 1 to 64 {
+//  CHECK-NEXT:     affine.for %{{.*}} = 0 to 64 {
+//   CHECK-NOT:   affine.parallel
+func.func private @effect()
+
+func.func @unknown_effects(%A: memref<64x64xf32>) {
+  affine.for %i = 1 to 64 {
+    affine.for %j = 0 to 64 {
+      %v = affine.load %A[%i - 1, %j] : memref<64x64xf32>
+      affine.store %v, %A[%i, %j] : memref<64x64xf32>
+      func.call @effect() : () -> ()
+    }
+  }
+  return
+}
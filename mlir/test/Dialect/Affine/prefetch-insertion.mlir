@@ -0,0 +1,80 @@
+// RUN: mlir-opt %s -split-input-file \
+// RUN:   -affine-insert-prefetch="lookahead-bytes=64 locality-hint=2" | \
+// RUN:   FileCheck %s
+
+// An iteration transfers 48 bytes, so the prefetches are 2 iterations ahead,
+// and the reads of the same elements are prefetched once.
+
+// CHECK-LABEL: func @scf_for(
+//  CHECK-SAME:     %[[A:[a-zA-Z0-9]+]]: memref<?xf32>,
+//  CHECK-SAME:     %[[B:[a-zA-Z0-9]+]]: memref<?xf32>
+//       CHECK:   scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %{{.*}} {
+//       CHECK:     %[[C8:.*]] = arith.constant 8 : index
+//       CHECK:     %[[AHEAD:.*]] = arith.addi %[[I]], %[[C8]] : index
+//       CHECK:     memref.prefetch %[[A]][%[[AHEAD]]], read, locality<2>, data
+//       CHECK:     vector.transfer_read %[[A]][%[[I]]]
+//   CHECK-NOT:     memref.prefetch
+//       CHECK:     vector.transfer_write
+func.func @scf_for(%A: memref<?xf32>, %B: memref<?xf32>, %n: index) {
+  %c0 = arith.constant 0 : index
+  %c4 = arith.constant 4 : index
+  %pad = arith.constant 0.0 : f32
+  scf.for %i = %c0 to %n step %c4 {
+    %v = vector.transfer_read %A[%i], %pad : memref<?xf32>, vector<4xf32>
+    %w = vector.transfer_read %A[%i], %pad : memref<?xf32>, vector<4xf32>
+    %x = arith.addf %v, %w : vector<4xf32>
+    vector.transfer_write %x, %B[%c0] : vector<4xf32>, memref<?xf32>
+  }
+  return
+}
+
+// -----
+
+// The index computations of the reads are evaluated ahead, and the reads that
+// do not vary with the loop are not prefetched. An iteration reads 32 bytes,
+// so the prefetches are 2 iterations ahead.
+
+// CHECK-DAG: #[[$AHEAD:.*]] = affine_map<(d0) -> (d0 + 16)>
+// CHECK-DAG: #[[$NEXT:.*]] = affine_map<(d0) -> (d0 + 1)>
+// CHECK-LABEL: func @affine_for(
+//  CHECK-SAME:     %[[A:[a-zA-Z0-9]+]]: memref<?x256xf32>
+//       CHECK:   affine.for %[[I:.*]] = 0 to 256 step 8 {
+//       CHECK:     %[[AHEAD:.*]] = affine.apply #[[$AHEAD]](%[[I]])
+//       CHECK:     %[[J:.*]] = affine.apply #[[$NEXT]](%[[I]])
+//       CHECK:     %[[J_AHEAD:.*]] = affine.apply #[[$NEXT]](%[[AHEAD]])
+//       CHECK:     memref.prefetch %[[A]][%{{.*}}, %[[J_AHEAD]]], read, locality<2>, data
+//       CHECK:     vector.transfer_read %[[A]][%{{.*}}, %[[J]]]
+//   CHECK-NOT:     memref.prefetch
+//       CHECK:     vector.transfer_read
+func.func @affine_for(%A: memref<?x256xf32>, %B: memref<8xf32>) {
+  %c0 = arith.constant 0 : index
+  %pad = arith.constant 0.0 : f32
+  affine.for %i = 0 to 256 step 8 {
+    %j = affine.apply affine_map<(d0) -> (d0 + 1)>(%i)
+    %v = vector.transfer_read %A[%c0, %j], %pad : memref<?x256xf32>, vector<4xf32>
+    %w = vector.transfer_read %B[%c0], %pad : memref<8xf32>, vector<4xf32>
+    "test.use"(%v, %w) : (vector<4xf32>, vector<4xf32>) -> ()
+  }
+  return
+}
+
+// -----
+
+// Only the innermost loops are prefetched.
+
+// CHECK-LABEL: func @nested(
+//       CHECK:   affine.for
+//   CHECK-NOT:     memref.prefetch
+//       CHECK:     affine.for
+//       CHECK:       memref.prefetch
+func.func @nested(%A: memref<64x64xf32>) {
+  %pad = arith.constant 0.0 : f32
+  affine.for %i = 0 to 64 {
+    %v = vector.transfer_read %A[%i, %i], %pad : memref<64x64xf32>, vector<4xf32>
+    affine.for %j = 0 to 64 step 4 {
+      %w = vector.transfer_read %A[%i, %j], %pad : memref<64x64xf32>, vector<4xf32>
+      "test.use"(%v, %w) : (vector<4xf32>, vector<4xf32>) -> ()
+    }
+  }
+  return
+}
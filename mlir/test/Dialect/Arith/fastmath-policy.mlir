@@ -0,0 +1,57 @@
+// RUN: mlir-opt %s -split-input-file -arith-fastmath-policy | FileCheck %s
+// RUN: mlir-opt %s -split-input-file \
+// RUN:   -pass-pipeline='builtin.module(func.func(arith-fastmath-policy{flags=contract}))' \
+// RUN:   | FileCheck %s --check-prefix=CONTRACT
+
+// CHECK-LABEL: func @function_policy
+//       CHECK:   arith.mulf %{{.*}}, %{{.*}} fastmath<reassoc,contract> : f32
+//       CHECK:   arith.addf %{{.*}}, %{{.*}} fastmath<reassoc,nnan,contract> : f32
+//       CHECK:   math.sqrt %{{.*}} fastmath<reassoc,contract> : f32
+//       CHECK:   arith.addi %{{.*}}, %{{.*}} : i32
+func.func @function_policy(%a: f32, %b: f32, %i: i32) -> (f32, i32)
+    attributes {arith.fastmath = #arith.fastmath<reassoc,contract>} {
+  %0 = arith.mulf %a, %b : f32
+  %1 = arith.addf %0, %a fastmath<nnan> : f32
+  %2 = math.sqrt %1 : f32
+  %3 = arith.addi %i, %i : i32
+  return %2, %3 : f32, i32
+}
+
+// -----
+
+// The nested policies take precedence over the enclosing ones.
+
+// CHECK-LABEL: func @nested_policy
+//       CHECK:   scf.for
+//       CHECK:     arith.addf %{{.*}}, %{{.*}} : f32
+//       CHECK:   } {arith.fastmath = #arith.fastmath<none>}
+//       CHECK:   arith.mulf %{{.*}}, %{{.*}} fastmath<contract> : f32
+
+// CONTRACT-LABEL: func @nested_policy
+//       CONTRACT:   arith.addf %{{.*}}, %{{.*}} : f32
+//       CONTRACT:   arith.mulf %{{.*}}, %{{.*}} fastmath<contract> : f32
+func.func @nested_policy(%a: f32, %lb: index, %ub: index, %step: index) -> f32
+    attributes {arith.fastmath = #arith.fastmath<contract>} {
+  %sum = scf.for %iv = %lb to %ub step %step iter_args(%acc = %a) -> (f32) {
+    %0 = arith.addf %acc, %a : f32
+    scf.yield %0 : f32
+  } {arith.fastmath = #arith.fastmath<none>}
+  %1 = arith.mulf %sum, %a : f32
+  return %1 : f32
+}
+
+// -----
+
+// The flags of the option are the policy of the anchor op and are recorded on
+// it.
+
+// CHECK-LABEL: func @no_policy
+//       CHECK:   arith.mulf %{{.*}}, %{{.*}} : f32
+
+// CONTRACT-LABEL: func @no_policy
+//  CONTRACT-SAME:   attributes {arith.fastmath = #arith.fastmath<contract>}
+//       CONTRACT:   arith.mulf %{{.*}}, %{{.*}} fastmath<contract> : f32
+func.func @no_policy(%a: f32) -> f32 {
+  %0 = arith.mulf %a, %a : f32
+  return %0 : f32
+}
@@ -0,0 +1,32 @@
+// RUN: mlir-opt -int-range-optimizations="narrow-index-math=true" --split-input-file %s | FileCheck %s
+
+// CHECK-LABEL: func @narrow_index_math
+//   CHECK-DAG:   %[[C4:.*]] = arith.constant 4 : i32
+//   CHECK-DAG:   %[[C1:.*]] = arith.constant 1 : i32
+//       CHECK:   %[[X:.*]] = arith.index_cast %{{.*}} : index to i32
+//       CHECK:   %[[M:.*]] = arith.muli %[[X]], %[[C4]] : i32
+//       CHECK:   %[[S:.*]] = arith.addi %[[M]], %[[C1]] : i32
+//       CHECK:   %[[R:.*]] = arith.index_cast %[[S]] : i32 to index
+//       CHECK:   return %[[R]]
+func.func @narrow_index_math() -> index {
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %0 = test.with_bounds { umin = 0 : index, umax = 1024 : index, smin = 0 : index, smax = 1024 : index }
+  %1 = arith.muli %0, %c4 : index
+  %2 = arith.addi %1, %c1 : index
+  return %2 : index
+}
+
+// -----
+
+// The sum may not fit in i32.
+
+// CHECK-LABEL: func @no_narrowing
+//   CHECK-NOT:   arith.index_cast
+//       CHECK:   arith.addi %{{.*}}, %{{.*}} : index
+func.func @no_narrowing() -> index {
+  %c1 = arith.constant 1 : index
+  %0 = test.with_bounds { umin = 0 : index, umax = 0x7fffffff : index, smin = 0 : index, smax = 0x7fffffff : index }
+  %1 = arith.addi %0, %c1 : index
+  return %1 : index
+}
@@ -71,3 +71,27 @@ func.func @test() -> i1 {
   %1 = arith.cmpi sle, %0, %cst1 : index
   return %1: i1
 }
+
+// -----
+
+// CHECK-LABEL: func @redundant_assert
+//   CHECK-NOT:   cf.assert
+func.func @redundant_assert() {
+  %cst1 = arith.constant -1 : index
+  %0 = test.with_bounds { umin = 0 : index, umax = 0x7fffffffffffffff : index, smin = 0 : index, smax = 0x7fffffffffffffff : index }
+  %1 = arith.cmpi sgt, %0, %cst1 : index
+  cf.assert %1, "expected a non-negative value"
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @needed_assert
+//       CHECK:   cf.assert
+func.func @needed_assert() {
+  %cst5 = arith.constant 5 : index
+  %0 = test.with_bounds { umin = 0 : index, umax = 10 : index, smin = 0 : index, smax = 10 : index }
+  %1 = arith.cmpi slt, %0, %cst5 : index
+  cf.assert %1, "expected a value less than 5"
+  return
+}
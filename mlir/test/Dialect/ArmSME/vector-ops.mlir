@@ -102,3 +102,59 @@ func.func @transfer_write_2d_zero__vec_unknown_defining_op(%arg0 : memref<?x?xi8
   vector.transfer_write %arg1, %arg0[%c0, %c0] {in_bounds = [true, true]} : vector<[16]x[16]xi8>, memref<?x?xi8>
   return
 }
+
+// -----
+
+#lhs_map = affine_map<(m, n, k) -> (k, m)>
+#rhs_map = affine_map<(m, n, k) -> (k, n)>
+#acc_map = affine_map<(m, n, k) -> (m, n)>
+
+// CHECK-LABEL: @vector_contract_outerproduct_f32
+// CHECK: %[[C17:.*]] = arith.constant 17 : i32
+// CHECK-NEXT: "arm_sme.intr.zero"(%[[C17]]) : (i32) -> ()
+// CHECK: scf.for
+// CHECK: llvm.load
+// CHECK: llvm.load
+// CHECK: "arm_sme.intr.mopa"({{.*}}) : (i32, vector<[4]xi1>, vector<[4]xi1>, vector<[4]xf32>, vector<[4]xf32>) -> ()
+// CHECK: scf.for
+// CHECK: "arm_sme.intr.read.horiz"({{.*}}) : (vector<[4]xf32>, vector<[4]xi1>, i32, i32) -> vector<[4]xf32>
+// CHECK: llvm.store
+// CHECK-NOT: vector.contract
+func.func @vector_contract_outerproduct_f32(%lhs : memref<?x?xf32>, %rhs : memref<?x?xf32>, %res : memref<?x?xf32>) {
+  %c0 = arith.constant 0 : index
+  %pad = arith.constant 0.0 : f32
+  %acc = arith.constant dense<0.0> : vector<[4]x[4]xf32>
+  %a = vector.transfer_read %lhs[%c0, %c0], %pad {in_bounds = [true, true]} : memref<?x?xf32>, vector<8x[4]xf32>
+  %b = vector.transfer_read %rhs[%c0, %c0], %pad {in_bounds = [true, true]} : memref<?x?xf32>, vector<8x[4]xf32>
+  %0 = vector.contract {indexing_maps = [#lhs_map, #rhs_map, #acc_map], iterator_types = ["parallel", "parallel", "reduction"], kind = #vector.kind<add>} %a, %b, %acc : vector<8x[4]xf32>, vector<8x[4]xf32> into vector<[4]x[4]xf32>
+  vector.transfer_write %0, %res[%c0, %c0] {in_bounds = [true, true]} : vector<[4]x[4]xf32>, memref<?x?xf32>
+  return
+}
+
+// -----
+
+#lhs_map = affine_map<(m, n, k) -> (k, m)>
+#rhs_map = affine_map<(m, n, k) -> (k, n)>
+#acc_map = affine_map<(m, n, k) -> (m, n)>
+
+// The accumulator read from memory is moved to the slices of the ZA0.D tile.
+
+// CHECK-LABEL: @vector_contract_outerproduct_f64_acc
+// CHECK-NOT: "arm_sme.intr.zero"
+// CHECK: scf.for
+// CHECK: llvm.load
+// CHECK: "arm_sme.intr.write.horiz"({{.*}}) : (i32, i32, vector<[2]xi1>, vector<[2]xf64>) -> ()
+// CHECK: scf.for
+// CHECK: "arm_sme.intr.mopa"({{.*}}) : (i32, vector<[2]xi1>, vector<[2]xi1>, vector<[2]xf64>, vector<[2]xf64>) -> ()
+// CHECK: scf.for
+// CHECK: "arm_sme.intr.read.horiz"
+func.func @vector_contract_outerproduct_f64_acc(%lhs : memref<?x?xf64>, %rhs : memref<?x?xf64>, %res : memref<?x?xf64>) {
+  %c0 = arith.constant 0 : index
+  %pad = arith.constant 0.0 : f64
+  %a = vector.transfer_read %lhs[%c0, %c0], %pad {in_bounds = [true, true]} : memref<?x?xf64>, vector<4x[2]xf64>
+  %b = vector.transfer_read %rhs[%c0, %c0], %pad {in_bounds = [true, true]} : memref<?x?xf64>, vector<4x[2]xf64>
+  %acc = vector.transfer_read %res[%c0, %c0], %pad {in_bounds = [true, true]} : memref<?x?xf64>, vector<[2]x[2]xf64>
+  %0 = vector.contract {indexing_maps = [#lhs_map, #rhs_map, #acc_map], iterator_types = ["parallel", "parallel", "reduction"], kind = #vector.kind<add>} %a, %b, %acc : vector<4x[2]xf64>, vector<4x[2]xf64> into vector<[2]x[2]xf64>
+  vector.transfer_write %0, %res[%c0, %c0] {in_bounds = [true, true]} : vector<[2]x[2]xf64>, memref<?x?xf64>
+  return
+}
@@ -0,0 +1,69 @@
+// RUN: mlir-opt %s -split-input-file                                          \
+// RUN:    -async-parallel-for="min-task-size=1 inline-threshold=4096"          \
+// RUN:    -canonicalize -inline -symbol-dce                                    \
+// RUN: | FileCheck %s --check-prefix=INLINE
+
+// RUN: mlir-opt %s -split-input-file                                          \
+// RUN:    -async-parallel-for="min-task-size=1000 cost-model=true"             \
+// RUN:    -canonicalize -inline -symbol-dce                                    \
+// RUN: | FileCheck %s --check-prefix=COST
+
+// The loops with fewer iterations than the inline threshold are executed in
+// the caller thread.
+
+// INLINE-LABEL: @small_loop
+// INLINE-NOT:   async.
+// INLINE:       scf.for
+// INLINE:         memref.store
+// INLINE-NOT:   async.
+func.func @small_loop(%arg0: memref<?xf32>) {
+  %lb = arith.constant 0 : index
+  %ub = arith.constant 2000 : index
+  %st = arith.constant 1 : index
+  scf.parallel (%i) = (%lb) to (%ub) step (%st) {
+    %one = arith.constant 1.0 : f32
+    memref.store %one, %arg0[%i] : memref<?xf32>
+  }
+  return
+}
+
+// -----
+
+// Each iteration executes about a hundred ops, so the minimum task size of
+// 1000 ops takes a few iterations, and the loop is split into multiple blocks.
+
+// COST-LABEL: @expensive_iterations
+// COST:         async.create_group
+// COST:         async.execute
+func.func @expensive_iterations(%arg0: memref<?x?xf32>) {
+  %lb = arith.constant 0 : index
+  %ub = arith.constant 1000 : index
+  %st = arith.constant 1 : index
+  %c100 = arith.constant 100 : index
+  scf.parallel (%i) = (%lb) to (%ub) step (%st) {
+    scf.for %j = %lb to %c100 step %st {
+      %one = arith.constant 1.0 : f32
+      memref.store %one, %arg0[%i, %j] : memref<?x?xf32>
+    }
+  }
+  return
+}
+
+// -----
+
+// The loops marked to run each iteration on its own thread are not executed
+// in the caller thread, whatever their number of iterations.
+
+// INLINE-LABEL: @thread_per_iteration
+// INLINE:         async.create_group
+// INLINE:         async.execute
+func.func @thread_per_iteration(%arg0: memref<?xf32>) {
+  %lb = arith.constant 0 : index
+  %ub = arith.constant 8 : index
+  %st = arith.constant 1 : index
+  scf.parallel (%i) = (%lb) to (%ub) step (%st) {
+    %one = arith.constant 1.0 : f32
+    memref.store %one, %arg0[%i] : memref<?xf32>
+  } {scf.thread_per_iteration}
+  return
+}
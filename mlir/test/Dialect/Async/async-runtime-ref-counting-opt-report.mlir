@@ -0,0 +1,20 @@
+// RUN: mlir-opt %s -async-runtime-ref-counting-opt=report-remaining \
+// RUN:   -verify-diagnostics -o /dev/null
+
+func.func private @consume_token(%arg0: !async.token)
+
+// expected-remark @below {{0 reference counting operations remaining}}
+func.func @all_erased(%arg0: !async.token) {
+  async.runtime.add_ref %arg0 {count = 1 : i64} : !async.token
+  async.runtime.drop_ref %arg0 {count = 1 : i64} : !async.token
+  return
+}
+
+// expected-remark @below {{2 reference counting operations remaining}}
+func.func @some_remaining(%arg0: !async.token) {
+  async.runtime.add_ref %arg0 {count = 1 : i64} : !async.token
+  call @consume_token(%arg0): (!async.token) -> ()
+  async.runtime.await %arg0 : !async.token
+  async.runtime.drop_ref %arg0 {count = 1 : i64} : !async.token
+  return
+}
@@ -67,3 +67,44 @@ func.func @not_cancellable_operations_0(%arg0: !async.token) {
   // CHECK: return
   return
 }
+
+// CHECK-LABEL: @coalesce_add_refs
+func.func @coalesce_add_refs(%arg0: !async.token) {
+  // CHECK-NEXT: async.runtime.add_ref %{{.*}} {count = 3 : i64}
+  // CHECK-NEXT: call @consume_token
+  async.runtime.add_ref %arg0 {count = 1 : i64} : !async.token
+  async.runtime.add_ref %arg0 {count = 2 : i64} : !async.token
+  call @consume_token(%arg0): (!async.token) -> ()
+  return
+}
+
+// CHECK-LABEL: @coalesce_add_and_drop_ref
+func.func @coalesce_add_and_drop_ref(%arg0: !async.token) {
+  // CHECK-NEXT: async.runtime.add_ref %{{.*}} {count = 1 : i64}
+  // CHECK-NEXT: call @consume_token
+  async.runtime.add_ref %arg0 {count = 2 : i64} : !async.token
+  async.runtime.drop_ref %arg0 {count = 1 : i64} : !async.token
+  call @consume_token(%arg0): (!async.token) -> ()
+  return
+}
+
+// CHECK-LABEL: @coalesce_drop_refs
+func.func @coalesce_drop_refs(%arg0: !async.token) {
+  // CHECK-NEXT: async.runtime.await
+  // CHECK-NEXT: async.runtime.drop_ref %{{.*}} {count = 2 : i64}
+  // CHECK-NEXT: return
+  async.runtime.await %arg0 : !async.token
+  async.runtime.drop_ref %arg0 {count = 1 : i64} : !async.token
+  async.runtime.drop_ref %arg0 {count = 1 : i64} : !async.token
+  return
+}
+
+// CHECK-LABEL: @not_coalesced_drop_and_add_ref
+func.func @not_coalesced_drop_and_add_ref(%arg0: !async.token) {
+  // CHECK-NEXT: async.runtime.drop_ref %{{.*}} {count = 1 : i64}
+  // CHECK-NEXT: async.runtime.add_ref %{{.*}} {count = 1 : i64}
+  async.runtime.drop_ref %arg0 {count = 1 : i64} : !async.token
+  async.runtime.add_ref %arg0 {count = 1 : i64} : !async.token
+  call @consume_token(%arg0): (!async.token) -> ()
+  return
+}
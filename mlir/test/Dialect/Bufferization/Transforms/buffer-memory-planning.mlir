@@ -0,0 +1,110 @@
+// RUN: mlir-opt -buffer-memory-planning -split-input-file %s | FileCheck %s
+// RUN: mlir-opt -buffer-memory-planning=use-workspace-argument \
+// RUN:   -split-input-file %s | FileCheck %s --check-prefix=WORKSPACE
+
+// The buffers whose lifetimes do not overlap share the same memory.
+
+// CHECK-LABEL: func @disjoint_lifetimes(
+//  CHECK-SAME:     %{{.*}}: memref<16xf32>)
+//       CHECK:   %[[ARENA:.*]] = memref.alloc() {alignment = 64 : i64} : memref<64xi8>
+//       CHECK:   %[[C0:.*]] = arith.constant 0 : index
+//       CHECK:   %[[V0:.*]] = memref.view %[[ARENA]][%[[C0]]][] : memref<64xi8> to memref<16xf32>
+//       CHECK:   memref.copy %{{.*}}, %[[V0]]
+//       CHECK:   %[[C0_0:.*]] = arith.constant 0 : index
+//       CHECK:   %[[V1:.*]] = memref.view %[[ARENA]][%[[C0_0]]][] : memref<64xi8> to memref<8xf32>
+//       CHECK:   "test.use"(%[[V1]])
+//   CHECK-NOT:   memref.dealloc %[[V0]]
+//   CHECK-NOT:   memref.dealloc %[[V1]]
+//       CHECK:   memref.dealloc %[[ARENA]] : memref<64xi8>
+//  CHECK-NEXT:   return
+
+// WORKSPACE-LABEL: func @disjoint_lifetimes(
+//  WORKSPACE-SAME:     %{{.*}}: memref<16xf32>, %[[ARENA:.*]]: memref<64xi8>)
+//   WORKSPACE-NOT:   memref.alloc
+//       WORKSPACE:   memref.view %[[ARENA]]
+//       WORKSPACE:   memref.view %[[ARENA]]
+//   WORKSPACE-NOT:   memref.dealloc
+//       WORKSPACE:   return
+func.func @disjoint_lifetimes(%arg0: memref<16xf32>) {
+  %0 = memref.alloc() : memref<16xf32>
+  memref.copy %arg0, %0 : memref<16xf32> to memref<16xf32>
+  memref.dealloc %0 : memref<16xf32>
+  %1 = memref.alloc() : memref<8xf32>
+  "test.use"(%1) : (memref<8xf32>) -> ()
+  memref.dealloc %1 : memref<8xf32>
+  return
+}
+
+// -----
+
+// The buffers that are live at the same time, including through the views of
+// a loop, get disjoint aligned ranges.
+
+// CHECK-LABEL: func @overlapping_lifetimes(
+//       CHECK:   %[[ARENA:.*]] = memref.alloc() {alignment = 64 : i64} : memref<80xi8>
+//       CHECK:   %[[C0:.*]] = arith.constant 0 : index
+//       CHECK:   memref.view %[[ARENA]][%[[C0]]][] : memref<80xi8> to memref<16xf32>
+//       CHECK:   %[[C64:.*]] = arith.constant 64 : index
+//       CHECK:   memref.view %[[ARENA]][%[[C64]]][] : memref<80xi8> to memref<4xf32>
+//       CHECK:   scf.for
+//       CHECK:   memref.dealloc %[[ARENA]] : memref<80xi8>
+func.func @overlapping_lifetimes(%lb: index, %ub: index, %step: index) {
+  %0 = memref.alloc() : memref<16xf32>
+  %1 = memref.alloc() : memref<4xf32>
+  scf.for %i = %lb to %ub step %step {
+    %2 = memref.subview %0[%i] [4] [1]
+      : memref<16xf32> to memref<4xf32, strided<[1], offset: ?>>
+    memref.copy %1, %2
+      : memref<4xf32> to memref<4xf32, strided<[1], offset: ?>>
+  }
+  memref.dealloc %1 : memref<4xf32>
+  memref.dealloc %0 : memref<16xf32>
+  return
+}
+
+// -----
+
+// The returned and dynamic-shape buffers are not placed in the arena, and the
+// single remaining buffer is left as is.
+
+// CHECK-LABEL: func @not_planned(
+//   CHECK-NOT:   memref.view
+//       CHECK:   memref.alloc() : memref<4xf32>
+//       CHECK:   memref.alloc(%{{.*}}) : memref<?xf32>
+//       CHECK:   memref.alloc() : memref<8xf32>
+func.func @not_planned(%n: index) -> memref<4xf32> {
+  %0 = memref.alloc() : memref<4xf32>
+  %1 = memref.alloc(%n) : memref<?xf32>
+  "test.use"(%1) : (memref<?xf32>) -> ()
+  memref.dealloc %1 : memref<?xf32>
+  %2 = memref.alloc() : memref<8xf32>
+  "test.use"(%2) : (memref<8xf32>) -> ()
+  memref.dealloc %2 : memref<8xf32>
+  return %0 : memref<4xf32>
+}
+
+// -----
+
+// The functions called within the module keep their signature, and allocate
+// their arena.
+
+// WORKSPACE-LABEL: func @callee(
+//  WORKSPACE-SAME:     %{{.*}}: memref<8xf32>)
+//       WORKSPACE:   memref.alloc() {alignment = 64 : i64} : memref<32xi8>
+// WORKSPACE-LABEL: func @caller(
+//  WORKSPACE-SAME:     %{{.*}}: memref<8xf32>)
+//       WORKSPACE:   call @callee(%{{.*}}) : (memref<8xf32>) -> ()
+func.func @callee(%arg0: memref<8xf32>) {
+  %0 = memref.alloc() : memref<8xf32>
+  memref.copy %arg0, %0 : memref<8xf32> to memref<8xf32>
+  memref.dealloc %0 : memref<8xf32>
+  %1 = memref.alloc() : memref<2xf32>
+  "test.use"(%1) : (memref<2xf32>) -> ()
+  memref.dealloc %1 : memref<2xf32>
+  return
+}
+
+func.func @caller(%arg0: memref<8xf32>) {
+  call @callee(%arg0) : (memref<8xf32>) -> ()
+  return
+}
@@ -0,0 +1,115 @@
+// RUN: mlir-opt -buffer-reuse -split-input-file %s | FileCheck %s
+
+// The buffers of a chain of temporaries of the same type are recycled.
+
+// CHECK-LABEL: func @static_chain(
+//  CHECK-SAME:     %[[ARG:.*]]: memref<16xf32>
+//       CHECK:   %[[A:.*]] = memref.alloc() : memref<16xf32>
+//       CHECK:   "test.compute"(%[[ARG]], %[[A]])
+//       CHECK:   %[[B:.*]] = memref.alloc() : memref<16xf32>
+//       CHECK:   "test.compute"(%[[A]], %[[B]])
+//   CHECK-NOT:   memref.alloc
+//       CHECK:   "test.compute"(%[[B]], %[[A]])
+//   CHECK-NOT:   memref.dealloc %[[A]]
+//       CHECK:   memref.dealloc %[[B]]
+//       CHECK:   "test.compute"(%[[A]], %[[ARG]])
+//       CHECK:   memref.dealloc %[[A]]
+//   CHECK-NOT:   memref.dealloc
+//       CHECK:   return
+func.func @static_chain(%arg0: memref<16xf32>) {
+  %0 = memref.alloc() : memref<16xf32>
+  "test.compute"(%arg0, %0) : (memref<16xf32>, memref<16xf32>) -> ()
+  %1 = memref.alloc() : memref<16xf32>
+  "test.compute"(%0, %1) : (memref<16xf32>, memref<16xf32>) -> ()
+  memref.dealloc %0 : memref<16xf32>
+  %2 = memref.alloc() : memref<16xf32>
+  "test.compute"(%1, %2) : (memref<16xf32>, memref<16xf32>) -> ()
+  memref.dealloc %1 : memref<16xf32>
+  "test.compute"(%2, %arg0) : (memref<16xf32>, memref<16xf32>) -> ()
+  memref.dealloc %2 : memref<16xf32>
+  return
+}
+
+// -----
+
+// The dynamic sizes are compared at runtime, and the freed buffer is only
+// reused when they are equal.
+
+// CHECK-LABEL: func @dynamic_sizes(
+//  CHECK-SAME:     %[[N:[a-zA-Z0-9]+]]: index, %[[M:[a-zA-Z0-9]+]]: index
+//       CHECK:   %[[A:.*]] = memref.alloc(%[[N]]) : memref<?x4xf32>
+//       CHECK:   "test.use"(%[[A]])
+//       CHECK:   %[[C0:.*]] = arith.constant 0 : index
+//       CHECK:   %[[DIM:.*]] = memref.dim %[[A]], %[[C0]] : memref<?x4xf32>
+//       CHECK:   %[[SAME:.*]] = arith.cmpi eq, %[[DIM]], %[[M]] : index
+//       CHECK:   %[[B:.*]] = scf.if %[[SAME]] -> (memref<?x4xf32>) {
+//       CHECK:     scf.yield %[[A]] : memref<?x4xf32>
+//       CHECK:   } else {
+//       CHECK:     memref.dealloc %[[A]] : memref<?x4xf32>
+//       CHECK:     %[[NEW:.*]] = memref.alloc(%[[M]]) : memref<?x4xf32>
+//       CHECK:     scf.yield %[[NEW]] : memref<?x4xf32>
+//       CHECK:   }
+//       CHECK:   "test.use"(%[[B]])
+//       CHECK:   memref.dealloc %[[B]] : memref<?x4xf32>
+func.func @dynamic_sizes(%n: index, %m: index) {
+  %0 = memref.alloc(%n) : memref<?x4xf32>
+  "test.use"(%0) : (memref<?x4xf32>) -> ()
+  memref.dealloc %0 : memref<?x4xf32>
+  %1 = memref.alloc(%m) : memref<?x4xf32>
+  "test.use"(%1) : (memref<?x4xf32>) -> ()
+  memref.dealloc %1 : memref<?x4xf32>
+  return
+}
+
+// -----
+
+// A static buffer is reused for a dynamic allocation of the same rank, and
+// cast to its type.
+
+// CHECK-LABEL: func @static_to_dynamic(
+//       CHECK:   %[[A:.*]] = memref.alloc() : memref<8xf32>
+//       CHECK:   %[[C8:.*]] = arith.constant 8 : index
+//       CHECK:   arith.cmpi eq, %[[C8]], %{{.*}} : index
+//       CHECK:   scf.if
+//       CHECK:     %[[CAST:.*]] = memref.cast %[[A]] : memref<8xf32> to memref<?xf32>
+//       CHECK:     scf.yield %[[CAST]] : memref<?xf32>
+func.func @static_to_dynamic(%n: index) {
+  %0 = memref.alloc() : memref<8xf32>
+  "test.use"(%0) : (memref<8xf32>) -> ()
+  memref.dealloc %0 : memref<8xf32>
+  %1 = memref.alloc(%n) : memref<?xf32>
+  "test.use"(%1) : (memref<?xf32>) -> ()
+  memref.dealloc %1 : memref<?xf32>
+  return
+}
+
+// -----
+
+// The buffers of other types or insufficient alignment, and the buffers whose
+// aliases are still live, are not reused.
+
+// CHECK-LABEL: func @not_reused(
+//       CHECK:   memref.alloc() : memref<8xf32>
+//       CHECK:   memref.alloc() : memref<8xi32>
+//       CHECK:   memref.alloc() {alignment = 64 : i64} : memref<8xf32>
+//       CHECK:   memref.alloc() : memref<4xf32>
+//       CHECK:   memref.alloc() : memref<4xf32>
+//   CHECK-NOT:   scf.if
+func.func @not_reused(%arg0: memref<4xf32>, %cond: i1) -> memref<4xf32> {
+  %0 = memref.alloc() : memref<8xf32>
+  "test.use"(%0) : (memref<8xf32>) -> ()
+  memref.dealloc %0 : memref<8xf32>
+  %1 = memref.alloc() : memref<8xi32>
+  "test.use"(%1) : (memref<8xi32>) -> ()
+  %2 = memref.alloc() {alignment = 64 : i64} : memref<8xf32>
+  "test.use"(%2) : (memref<8xf32>) -> ()
+  %3 = memref.alloc() : memref<4xf32>
+  %4 = arith.select %cond, %3, %arg0 : memref<4xf32>
+  memref.dealloc %3 : memref<4xf32>
+  %5 = memref.alloc() : memref<4xf32>
+  "test.use"(%5) : (memref<4xf32>) -> ()
+  memref.dealloc %1 : memref<8xi32>
+  memref.dealloc %2 : memref<8xf32>
+  memref.dealloc %5 : memref<4xf32>
+  return %4 : memref<4xf32>
+}
@@ -1,6 +1,10 @@
 // RUN: mlir-opt %s -one-shot-bufferize="test-analysis-only" \
 // RUN:     -allow-unregistered-dialect -split-input-file | FileCheck %s
 
+// RUN: mlir-opt %s \
+// RUN:     -one-shot-bufferize="test-analysis-only incremental-conflict-analysis" \
+// RUN:     -allow-unregistered-dialect -split-input-file | FileCheck %s
+
 // RUN: mlir-opt %s -one-shot-bufferize="test-analysis-only dump-alias-sets" \
 // RUN:     -allow-unregistered-dialect -split-input-file | \
 // RUN: FileCheck %s --check-prefix=CHECK-ALIAS-SETS
@@ -53,6 +53,12 @@
 
 // -----
 
+// expected-error@below {{'dlti.l1_cache_size_in_bytes' data layout entry is expected to be a positive integer}}
+"test.op_with_data_layout"() ({
+}) { dlti.dl_spec = #dlti.dl_spec<#dlti.dl_entry<"dlti.l1_cache_size_in_bytes", 0 : i64>> } : () -> ()
+
+// -----
+
 // Mismatching entries don't combine.
 "test.op_with_data_layout"() ({
   // expected-error@below {{data layout does not combine with layouts of enclosing ops}}
@@ -0,0 +1,85 @@
+// RUN: mlir-opt %s -split-input-file -func-refine-memref-arguments | FileCheck %s
+// RUN: mlir-opt %s -split-input-file \
+// RUN:   -func-refine-memref-arguments="use-bare-ptr-call-conv=false" | \
+// RUN:   FileCheck %s --check-prefix=NOBARE
+
+// The static type passed by all the callers is propagated into the callee,
+// through the chain of calls, and the unused memref is dropped. The callees
+// then only take static memrefs, and use bare pointers.
+
+// CHECK-LABEL: func.func private @inner(
+//  CHECK-SAME:   %[[ARG:.*]]: memref<16x4xf32>) -> f32 attributes {llvm.bareptr}
+//       CHECK:   %[[CAST:.*]] = memref.cast %[[ARG]] : memref<16x4xf32> to memref<?x?xf32>
+//       CHECK:   memref.load %[[CAST]]
+// NOBARE-LABEL: func.func private @inner(
+//   NOBARE-NOT:   llvm.bareptr
+func.func private @inner(%m: memref<?x?xf32>, %unused: memref<?xf32>) -> f32 {
+  %c0 = arith.constant 0 : index
+  %v = memref.load %m[%c0, %c0] : memref<?x?xf32>
+  return %v : f32
+}
+
+// CHECK-LABEL: func.func private @outer(
+//  CHECK-SAME:   %[[ARG:.*]]: memref<16x4xf32>) -> f32 attributes {llvm.bareptr}
+//       CHECK:   call @inner(%[[ARG]]) : (memref<16x4xf32>) -> f32
+func.func private @outer(%m: memref<?x?xf32>, %n: memref<?xf32>) -> f32 {
+  %v = call @inner(%m, %n) : (memref<?x?xf32>, memref<?xf32>) -> f32
+  return %v : f32
+}
+
+// CHECK-LABEL: func @entry(
+//  CHECK-SAME:   %[[M:.*]]: memref<16x4xf32>, %[[N:.*]]: memref<?xf32>
+//       CHECK:   call @outer(%[[M]]) : (memref<16x4xf32>) -> f32
+//   CHECK-NOT:   llvm.bareptr
+func.func @entry(%m: memref<16x4xf32>, %n: memref<?xf32>) -> f32 {
+  %cast = memref.cast %m : memref<16x4xf32> to memref<?x?xf32>
+  %v = call @outer(%cast, %n) : (memref<?x?xf32>, memref<?xf32>) -> f32
+  return %v : f32
+}
+
+// -----
+
+// The callers pass different types, so the argument keeps its dynamic type
+// and the callee keeps the descriptors.
+
+// CHECK-LABEL: func.func private @different_types(
+//  CHECK-SAME:   %{{.*}}: memref<?xf32>) {
+func.func private @different_types(%m: memref<?xf32>) {
+  %c0 = arith.constant 0 : index
+  %cst = arith.constant 0.0 : f32
+  memref.store %cst, %m[%c0] : memref<?xf32>
+  return
+}
+
+func.func @callers(%a: memref<4xf32>, %b: memref<8xf32>) {
+  %0 = memref.cast %a : memref<4xf32> to memref<?xf32>
+  %1 = memref.cast %b : memref<8xf32> to memref<?xf32>
+  call @different_types(%0) : (memref<?xf32>) -> ()
+  call @different_types(%1) : (memref<?xf32>) -> ()
+  return
+}
+
+// -----
+
+// The public functions and the functions whose address is taken keep their
+// signature.
+
+// CHECK-LABEL: func.func @public(
+//  CHECK-SAME:   %{{.*}}: memref<?xf32>, %{{.*}}: memref<?xf32>) {
+func.func @public(%m: memref<?xf32>, %unused: memref<?xf32>) {
+  return
+}
+
+// CHECK-LABEL: func.func private @address_taken(
+//  CHECK-SAME:   %{{.*}}: memref<?xf32>) {
+func.func private @address_taken(%m: memref<?xf32>) {
+  return
+}
+
+func.func @caller(%a: memref<4xf32>) -> ((memref<?xf32>) -> ()) {
+  %0 = memref.cast %a : memref<4xf32> to memref<?xf32>
+  call @public(%0, %0) : (memref<?xf32>, memref<?xf32>) -> ()
+  call @address_taken(%0) : (memref<?xf32>) -> ()
+  %f = func.constant @address_taken : (memref<?xf32>) -> ()
+  return %f : (memref<?xf32>) -> ()
+}
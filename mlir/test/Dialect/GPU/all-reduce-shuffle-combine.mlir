@@ -0,0 +1,64 @@
+// RUN: mlir-opt -allow-unregistered-dialect -test-gpu-rewrite="all-reduce-shuffle-combine" \
+// RUN:   -split-input-file %s | FileCheck %s
+
+// The partial results of the subgroups are combined with shuffles in every
+// subgroup, after a single barrier.
+//
+// CHECK-LABEL: gpu.func @kernel(
+// CHECK-SAME:    workgroup(%[[BUF:.*]] : memref<32xf32, #gpu.address_space<workgroup>>)
+// CHECK:         gpu.shuffle xor
+// CHECK:         memref.store %{{.*}}, %[[BUF]]
+// CHECK:         gpu.barrier
+// CHECK-NOT:     gpu.barrier
+// CHECK:         memref.load %[[BUF]]
+// CHECK:         gpu.shuffle xor
+// CHECK:         %[[WIDTH:.*]] = arith.select
+// CHECK:         %[[RES:.*]], %{{.*}} = gpu.shuffle idx %{{.*}}, %{{.*}}, %[[WIDTH]] : f32
+// CHECK-NOT:     gpu.barrier
+// CHECK:         "test.consume"(%[[RES]]) : (f32) -> ()
+gpu.module @kernels {
+  gpu.func @kernel(%arg0 : f32) kernel {
+    %sum = gpu.all_reduce add %arg0 uniform {} : (f32) -> (f32)
+    "test.consume"(%sum) : (f32) -> ()
+    gpu.return
+  }
+}
+
+// -----
+
+// The vectors of two f16 values are shuffled as a single i32.
+//
+// CHECK-LABEL: gpu.func @kernel_half2(
+// CHECK-SAME:    workgroup(%{{.*}} : memref<32xvector<2xf16>, #gpu.address_space<workgroup>>)
+// CHECK:         %[[CAST:.*]] = vector.bitcast %{{.*}} : vector<2xf16> to vector<1xi32>
+// CHECK:         %[[PACKED:.*]] = vector.extract %[[CAST]][0] : vector<1xi32>
+// CHECK:         %[[SHFL:.*]], %{{.*}} = gpu.shuffle xor %[[PACKED]], %{{.*}}, %{{.*}} : i32
+// CHECK:         %[[BCAST:.*]] = vector.broadcast %[[SHFL]] : i32 to vector<1xi32>
+// CHECK:         %[[UNPACKED:.*]] = vector.bitcast %[[BCAST]] : vector<1xi32> to vector<2xf16>
+// CHECK:         arith.addf %{{.*}}, %[[UNPACKED]] : vector<2xf16>
+gpu.module @kernels {
+  gpu.func @kernel_half2(%arg0 : vector<2xf16>) kernel {
+    %sum = gpu.all_reduce add %arg0 uniform {} : (vector<2xf16>) -> (vector<2xf16>)
+    "test.consume"(%sum) : (vector<2xf16>) -> ()
+    gpu.return
+  }
+}
+
+// -----
+
+// The f16 values are extended to i32 for the shuffles.
+//
+// CHECK-LABEL: gpu.func @kernel_half(
+// CHECK:         %[[INT:.*]] = arith.bitcast %{{.*}} : f16 to i16
+// CHECK:         %[[EXT:.*]] = arith.extui %[[INT]] : i16 to i32
+// CHECK:         %[[SHFL:.*]], %{{.*}} = gpu.shuffle xor %[[EXT]], %{{.*}}, %{{.*}} : i32
+// CHECK:         %[[TRUNC:.*]] = arith.trunci %[[SHFL]] : i32 to i16
+// CHECK:         %[[VAL:.*]] = arith.bitcast %[[TRUNC]] : i16 to f16
+// CHECK:         arith.cmpf ugt, %{{.*}}, %[[VAL]] : f16
+gpu.module @kernels {
+  gpu.func @kernel_half(%arg0 : f16) kernel {
+    %max = gpu.all_reduce max %arg0 uniform {} : (f16) -> (f16)
+    "test.consume"(%max) : (f16) -> ()
+    gpu.return
+  }
+}
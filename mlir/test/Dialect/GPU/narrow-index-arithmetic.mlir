@@ -0,0 +1,100 @@
+// RUN: mlir-opt %s -gpu-narrow-index-arithmetic -split-input-file | FileCheck %s
+// RUN: mlir-opt %s -gpu-narrow-index-arithmetic="max-memref-dim-size=65536" -split-input-file | FileCheck %s --check-prefix=DIM
+
+gpu.module @kernels {
+  // CHECK-LABEL: gpu.func @known_sizes
+  //   CHECK-DAG:   %[[TID:.*]] = gpu.thread_id x
+  //   CHECK-DAG:   %[[BID:.*]] = gpu.block_id x
+  //   CHECK-DAG:   %[[BDIM:.*]] = gpu.block_dim x
+  //   CHECK-DAG:   %[[BID32:.*]] = arith.index_cast %[[BID]] : index to i32
+  //   CHECK-DAG:   %[[BDIM32:.*]] = arith.index_cast %[[BDIM]] : index to i32
+  //   CHECK-DAG:   %[[TID32:.*]] = arith.index_cast %[[TID]] : index to i32
+  //   CHECK-DAG:   %[[MUL:.*]] = arith.muli %[[BID32]], %[[BDIM32]] : i32
+  //       CHECK:   %[[ADD:.*]] = arith.addi %[[MUL]], %[[TID32]] : i32
+  //       CHECK:   %[[IDX:.*]] = arith.index_cast %[[ADD]] : i32 to index
+  //       CHECK:   memref.store %{{.*}}, %{{.*}}[%[[IDX]]]
+  gpu.func @known_sizes(%buf: memref<?xf32>, %f: f32) kernel
+      attributes {gpu.known_block_size = array<i32: 128, 1, 1>,
+                  gpu.known_grid_size = array<i32: 1024, 1, 1>} {
+    %tid = gpu.thread_id x
+    %bid = gpu.block_id x
+    %bdim = gpu.block_dim x
+    %0 = arith.muli %bid, %bdim : index
+    %1 = arith.addi %0, %tid : index
+    memref.store %f, %buf[%1] : memref<?xf32>
+    gpu.return
+  }
+
+  // Without known sizes, the global id may not fit in i32.
+
+  // CHECK-LABEL: gpu.func @unknown_sizes
+  //   CHECK-NOT:   arith.index_cast
+  //       CHECK:   arith.muli %{{.*}}, %{{.*}} : index
+  //       CHECK:   arith.addi %{{.*}}, %{{.*}} : index
+  gpu.func @unknown_sizes(%buf: memref<?xf32>, %f: f32) kernel {
+    %tid = gpu.thread_id x
+    %bid = gpu.block_id x
+    %bdim = gpu.block_dim x
+    %0 = arith.muli %bid, %bdim : index
+    %1 = arith.addi %0, %tid : index
+    memref.store %f, %buf[%1] : memref<?xf32>
+    gpu.return
+  }
+}
+
+// -----
+
+// The ranges of the ids follow from the constant launch sizes, and the
+// arithmetic outside of the launch is left untouched.
+
+// CHECK-LABEL: func @launch
+//       CHECK:   %[[OUT:.*]] = arith.muli %{{.*}}, %{{.*}} : index
+//       CHECK:   gpu.launch
+//       CHECK:     arith.muli %{{.*}}, %{{.*}} : i32
+//       CHECK:     arith.addi %{{.*}}, %{{.*}} : i32
+//       CHECK:     gpu.terminator
+//       CHECK:   return %[[OUT]]
+func.func @launch(%buf: memref<?xf32>, %f: f32) -> index {
+  %c1 = arith.constant 1 : index
+  %c64 = arith.constant 64 : index
+  %c256 = arith.constant 256 : index
+  %outside = arith.muli %c64, %c256 : index
+  gpu.launch blocks(%bx, %by, %bz) in (%gx = %c256, %gy = %c1, %gz = %c1)
+             threads(%tx, %ty, %tz) in (%sx = %c64, %sy = %c1, %sz = %c1) {
+    %0 = arith.muli %bx, %sx : index
+    %1 = arith.addi %0, %tx : index
+    memref.store %f, %buf[%1] : memref<?xf32>
+    gpu.terminator
+  }
+  return %outside : index
+}
+
+// -----
+
+// The induction variable of a loop over a dynamic size is only bounded when
+// the sizes of the memrefs are.
+
+gpu.module @kernels {
+  // CHECK-LABEL: gpu.func @dynamic_loop
+  //   CHECK-NOT:   arith.index_cast
+  //       CHECK:   arith.addi %{{.*}}, %{{.*}} : index
+
+  // DIM-LABEL: gpu.func @dynamic_loop
+  //       DIM:   scf.for %[[IV:.*]] =
+  //   DIM-DAG:     %[[IV32:.*]] = arith.index_cast %[[IV]] : index to i32
+  //   DIM-DAG:     %[[TID32:.*]] = arith.index_cast %{{.*}} : index to i32
+  //       DIM:     %[[ADD:.*]] = arith.addi %[[IV32]], %[[TID32]] : i32
+  //       DIM:     arith.index_cast %[[ADD]] : i32 to index
+  gpu.func @dynamic_loop(%buf: memref<?xf32>, %f: f32) kernel
+      attributes {gpu.known_block_size = array<i32: 128, 1, 1>} {
+    %c0 = arith.constant 0 : index
+    %c128 = arith.constant 128 : index
+    %tid = gpu.thread_id x
+    %n = memref.dim %buf, %c0 : memref<?xf32>
+    scf.for %i = %c0 to %n step %c128 {
+      %0 = arith.addi %i, %tid : index
+      memref.store %f, %buf[%0] : memref<?xf32>
+    }
+    gpu.return
+  }
+}
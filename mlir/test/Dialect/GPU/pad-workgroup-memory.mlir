@@ -0,0 +1,112 @@
+// RUN: mlir-opt %s -gpu-pad-workgroup-memory -split-input-file | FileCheck %s
+
+gpu.module @kernels {
+  // CHECK-LABEL: gpu.func @column_load
+  // CHECK-SAME: workgroup(%[[TILE:.*]] : memref<32x33xf32, #gpu.address_space<workgroup>>)
+  gpu.func @column_load(%out: memref<32x32xf32>)
+      workgroup(%tile: memref<32x32xf32, #gpu.address_space<workgroup>>) kernel {
+    // CHECK: %[[VIEW:.*]] = memref.subview %[[TILE]][0, 0] [32, 32] [1, 1]
+    // CHECK-SAME: to memref<32x32xf32, strided<[33, 1]>, #gpu.address_space<workgroup>>
+    // CHECK: memref.store %{{.*}}, %[[VIEW]][%{{.*}}, %{{.*}}]
+    // CHECK: memref.load %[[VIEW]][%{{.*}}, %{{.*}}]
+    %tx = gpu.thread_id x
+    %ty = gpu.thread_id y
+    %v = memref.load %out[%ty, %tx] : memref<32x32xf32>
+    memref.store %v, %tile[%ty, %tx] : memref<32x32xf32, #gpu.address_space<workgroup>>
+    gpu.barrier
+    %t = memref.load %tile[%tx, %ty] : memref<32x32xf32, #gpu.address_space<workgroup>>
+    memref.store %t, %out[%ty, %tx] : memref<32x32xf32>
+    gpu.return
+  }
+
+  // CHECK-LABEL: gpu.func @row_load
+  // CHECK-SAME: workgroup(%[[TILE:.*]] : memref<32x32xf32, #gpu.address_space<workgroup>>)
+  // CHECK-NOT: memref.subview
+  gpu.func @row_load(%out: memref<32x32xf32>)
+      workgroup(%tile: memref<32x32xf32, #gpu.address_space<workgroup>>) kernel {
+    %tx = gpu.thread_id x
+    %ty = gpu.thread_id y
+    %t = memref.load %tile[%ty, %tx] : memref<32x32xf32, #gpu.address_space<workgroup>>
+    memref.store %t, %out[%ty, %tx] : memref<32x32xf32>
+    gpu.return
+  }
+
+  // The column accesses to a row size that is an odd multiple of the bank
+  // width do not conflict.
+  // CHECK-LABEL: gpu.func @odd_row_size
+  // CHECK-SAME: workgroup(%{{.*}} : memref<32x33xf32, #gpu.address_space<workgroup>>)
+  // CHECK-NOT: memref.subview
+  gpu.func @odd_row_size(%out: memref<32x33xf32>)
+      workgroup(%tile: memref<32x33xf32, #gpu.address_space<workgroup>>) kernel {
+    %tx = gpu.thread_id x
+    %ty = gpu.thread_id y
+    %t = memref.load %tile[%tx, %ty] : memref<32x33xf32, #gpu.address_space<workgroup>>
+    memref.store %t, %out[%ty, %tx] : memref<32x33xf32>
+    gpu.return
+  }
+
+  func.func private @use(memref<32x32xf32, #gpu.address_space<workgroup>>)
+
+  // CHECK-LABEL: gpu.func @unknown_user
+  // CHECK-SAME: workgroup(%{{.*}} : memref<32x32xf32, #gpu.address_space<workgroup>>)
+  gpu.func @unknown_user(%out: memref<32x32xf32>)
+      workgroup(%tile: memref<32x32xf32, #gpu.address_space<workgroup>>) kernel {
+    %tx = gpu.thread_id x
+    %ty = gpu.thread_id y
+    %t = memref.load %tile[%tx, %ty] : memref<32x32xf32, #gpu.address_space<workgroup>>
+    memref.store %t, %out[%ty, %tx] : memref<32x32xf32>
+    func.call @use(%tile) : (memref<32x32xf32, #gpu.address_space<workgroup>>) -> ()
+    gpu.return
+  }
+}
+
+// -----
+
+// The rows are padded by the width of the vector accesses, and the subviews
+// of the buffer get the layout of the padded rows.
+
+// CHECK-LABEL: func @promoted_subview
+func.func @promoted_subview(%in: memref<128x128xf32>, %i: index, %j: index) -> vector<4xf32> {
+  // CHECK: %[[ALLOC:.*]] = memref.alloc() : memref<64x68xf32, #gpu.address_space<workgroup>>
+  // CHECK: %[[VIEW:.*]] = memref.subview %[[ALLOC]][0, 0] [64, 64] [1, 1]
+  // CHECK-SAME: to memref<64x64xf32, strided<[68, 1]>, #gpu.address_space<workgroup>>
+  // CHECK: %[[SUB:.*]] = memref.subview %[[VIEW]][0, 0] [%{{.*}}, %{{.*}}] [1, 1]
+  // CHECK-SAME: to memref<?x?xf32, strided<[68, 1]>, #gpu.address_space<workgroup>>
+  // CHECK: memref.copy %{{.*}}, %[[SUB]]
+  // CHECK: vector.load %[[SUB]][%{{.*}}, %{{.*}}] : memref<?x?xf32, strided<[68, 1]>, #gpu.address_space<workgroup>>, vector<4xf32>
+  %alloc = memref.alloc() : memref<64x64xf32, #gpu.address_space<workgroup>>
+  %sub = memref.subview %alloc[0, 0] [%i, %j] [1, 1]
+    : memref<64x64xf32, #gpu.address_space<workgroup>> to
+      memref<?x?xf32, strided<[64, 1]>, #gpu.address_space<workgroup>>
+  %src = memref.subview %in[0, 0] [%i, %j] [1, 1]
+    : memref<128x128xf32> to memref<?x?xf32, strided<[128, 1]>>
+  memref.copy %src, %sub
+    : memref<?x?xf32, strided<[128, 1]>> to
+      memref<?x?xf32, strided<[64, 1]>, #gpu.address_space<workgroup>>
+  gpu.barrier
+  %tx = gpu.thread_id x
+  %c0 = arith.constant 0 : index
+  %v = vector.load %sub[%tx, %c0]
+    : memref<?x?xf32, strided<[64, 1]>, #gpu.address_space<workgroup>>, vector<4xf32>
+  return %v : vector<4xf32>
+}
+
+// -----
+
+// CHECK-LABEL: func @launch
+func.func @launch(%out: memref<32x32xf16>) {
+  %c1 = arith.constant 1 : index
+  %c32 = arith.constant 32 : index
+  // CHECK: gpu.launch
+  // CHECK-SAME: workgroup(%[[TILE:.*]] : memref<32x34xf16, #gpu.address_space<workgroup>>)
+  // CHECK: %[[VIEW:.*]] = memref.subview %[[TILE]][0, 0] [32, 32] [1, 1]
+  // CHECK: memref.load %[[VIEW]]
+  gpu.launch blocks(%bx, %by, %bz) in (%gx = %c1, %gy = %c1, %gz = %c1)
+             threads(%tx, %ty, %tz) in (%sx = %c32, %sy = %c32, %sz = %c1)
+             workgroup(%tile : memref<32x32xf16, #gpu.address_space<workgroup>>) {
+    %t = memref.load %tile[%tx, %ty] : memref<32x32xf16, #gpu.address_space<workgroup>>
+    memref.store %t, %out[%ty, %tx] : memref<32x32xf16>
+    gpu.terminator
+  }
+  return
+}
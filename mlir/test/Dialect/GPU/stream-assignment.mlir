@@ -0,0 +1,89 @@
+// RUN: mlir-opt %s -gpu-stream-assignment=num-streams=2 -split-input-file | FileCheck %s
+// RUN: mlir-opt %s -gpu-stream-assignment=num-streams=1 -split-input-file | FileCheck %s --check-prefix=SINGLE
+
+module attributes {gpu.container_module} {
+
+  gpu.module @kernels {
+    gpu.func @kernel(%arg0 : memref<?xf32>) kernel { gpu.return }
+  }
+
+  // CHECK-LABEL: func @independent
+  // SINGLE-LABEL: func @independent
+  func.func @independent(%sz : index) {
+    // CHECK: %[[t0:.*]] = gpu.wait async
+    // CHECK: %[[m0:.*]], %[[t1:.*]] = gpu.alloc async [%[[t0]]]
+    // CHECK: %[[s1:.*]] = gpu.wait async{{$}}
+    // CHECK: %[[m1:.*]], %[[t2:.*]] = gpu.alloc async [%[[s1]]]
+    // CHECK: %[[t3:.*]] = gpu.launch_func async [%[[t1]]] {{.*}} args(%[[m0]] : memref<?xf32>)
+    // CHECK: %[[t4:.*]] = gpu.launch_func async [%[[t2]]] {{.*}} args(%[[m1]] : memref<?xf32>)
+    // CHECK: gpu.wait [%[[t3]], %[[t4]]]
+
+    // SINGLE: %[[t0:.*]] = gpu.wait async
+    // SINGLE: %[[m0:.*]], %[[t1:.*]] = gpu.alloc async [%[[t0]]]
+    // SINGLE-NOT: gpu.wait
+    // SINGLE: %[[m1:.*]], %[[t2:.*]] = gpu.alloc async [%[[t1]]]
+    // SINGLE: %[[t3:.*]] = gpu.launch_func async [%[[t2]]]
+    // SINGLE: %[[t4:.*]] = gpu.launch_func async [%[[t3]]]
+    // SINGLE: gpu.wait [%[[t4]]]
+    %t0 = gpu.wait async
+    %m0, %t1 = gpu.alloc async [%t0] (%sz) : memref<?xf32>
+    %m1, %t2 = gpu.alloc async [%t1] (%sz) : memref<?xf32>
+    %t3 = gpu.launch_func async [%t2] @kernels::@kernel
+        blocks in (%sz, %sz, %sz) threads in (%sz, %sz, %sz)
+        args(%m0 : memref<?xf32>)
+    %t4 = gpu.launch_func async [%t3] @kernels::@kernel
+        blocks in (%sz, %sz, %sz) threads in (%sz, %sz, %sz)
+        args(%m1 : memref<?xf32>)
+    gpu.wait [%t4]
+    return
+  }
+}
+
+// -----
+
+module attributes {gpu.container_module} {
+
+  gpu.module @kernels {
+    gpu.func @kernel(%arg0 : memref<?xf32>, %arg1 : memref<?xf32>) kernel {
+      gpu.return
+    }
+  }
+
+  // CHECK-LABEL: func @join
+  func.func @join(%sz : index) {
+    // CHECK: %[[t0:.*]] = gpu.wait async
+    // CHECK: %[[m0:.*]], %[[t1:.*]] = gpu.alloc async [%[[t0]]]
+    // CHECK: %[[s1:.*]] = gpu.wait async{{$}}
+    // CHECK: %[[m1:.*]], %[[t2:.*]] = gpu.alloc async [%[[s1]]]
+    // CHECK: %[[j:.*]] = gpu.wait async [%[[t2]], %[[t1]]]
+    // CHECK: %[[t3:.*]] = gpu.launch_func async [%[[j]]]
+    // CHECK: gpu.wait [%[[t1]], %[[t3]], %[[t2]]]
+    %t0 = gpu.wait async
+    %m0, %t1 = gpu.alloc async [%t0] (%sz) : memref<?xf32>
+    %m1, %t2 = gpu.alloc async [%t1] (%sz) : memref<?xf32>
+    %t3 = gpu.launch_func async [%t2] @kernels::@kernel
+        blocks in (%sz, %sz, %sz) threads in (%sz, %sz, %sz)
+        args(%m0 : memref<?xf32>, %m1 : memref<?xf32>)
+    gpu.wait [%t3]
+    return
+  }
+}
+
+// -----
+
+// Copies that only read the same buffer do not depend on each other.
+// CHECK-LABEL: func @shared_source
+func.func @shared_source(%src : memref<16xf32>) {
+  %dst0 = memref.alloc() : memref<16xf32>
+  %dst1 = memref.alloc() : memref<16xf32>
+  // CHECK: %[[t0:.*]] = gpu.wait async
+  // CHECK: %[[t1:.*]] = gpu.memcpy async [%[[t0]]]
+  // CHECK: %[[s1:.*]] = gpu.wait async{{$}}
+  // CHECK: %[[t2:.*]] = gpu.memcpy async [%[[s1]]]
+  // CHECK: gpu.wait [%[[t1]], %[[t2]]]
+  %t0 = gpu.wait async
+  %t1 = gpu.memcpy async [%t0] %dst0, %src : memref<16xf32>, memref<16xf32>
+  %t2 = gpu.memcpy async [%t1] %dst1, %src : memref<16xf32>, memref<16xf32>
+  gpu.wait [%t2]
+  return
+}
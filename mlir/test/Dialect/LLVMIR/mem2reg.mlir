@@ -683,3 +683,32 @@ llvm.func @no_inner_alloca_promotion(%arg: i64) -> i64 {
   // CHECK: llvm.return %[[RES]] : i64
   llvm.return %2 : i64
 }
+
+// -----
+
+// CHECK-LABEL: llvm.func @shared_merge_point
+// CHECK-SAME: (%[[COND:.*]]: i1, %[[X:.*]]: i32, %[[Y:.*]]: i32)
+llvm.func @shared_merge_point(%cond: i1, %x: i32, %y: i32) -> i32 {
+  // CHECK-NOT: = llvm.alloca
+  %0 = llvm.mlir.constant(1 : i32) : i32
+  %1 = llvm.alloca %0 x i32 {alignment = 4 : i64} : (i32) -> !llvm.ptr
+  %2 = llvm.alloca %0 x i32 {alignment = 4 : i64} : (i32) -> !llvm.ptr
+  llvm.store %x, %1 {alignment = 4 : i64} : i32, !llvm.ptr
+  llvm.store %y, %2 {alignment = 4 : i64} : i32, !llvm.ptr
+  // CHECK: llvm.cond_br %[[COND]], ^[[BB1:.*]], ^[[BB2:.*]](%[[X]], %[[Y]] : i32, i32)
+  llvm.cond_br %cond, ^bb1, ^bb2
+// CHECK: ^[[BB1]]:
+^bb1:
+  llvm.store %y, %1 {alignment = 4 : i64} : i32, !llvm.ptr
+  llvm.store %x, %2 {alignment = 4 : i64} : i32, !llvm.ptr
+  // CHECK: llvm.br ^[[BB2]](%[[Y]], %[[X]] : i32, i32)
+  llvm.br ^bb2
+// CHECK: ^[[BB2]](%[[A:.*]]: i32, %[[B:.*]]: i32):
+^bb2:
+  %3 = llvm.load %1 {alignment = 4 : i64} : !llvm.ptr -> i32
+  %4 = llvm.load %2 {alignment = 4 : i64} : !llvm.ptr -> i32
+  // CHECK: %[[SUM:.*]] = llvm.sub %[[A]], %[[B]]
+  %5 = llvm.sub %3, %4 : i32
+  // CHECK: llvm.return %[[SUM]] : i32
+  llvm.return %5 : i32
+}
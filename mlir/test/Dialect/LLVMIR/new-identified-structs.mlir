@@ -0,0 +1,16 @@
+// RUN: mlir-opt %s -mlir-disable-threading -pass-pipeline='builtin.module(func.func(test-llvm-new-identified-structs{num-structs=2}))' | FileCheck %s
+
+// The new identified structs are renamed after the existing structs, and
+// after the structs created for the previous functions.
+
+// CHECK-LABEL: func @existing
+// CHECK-SAME:    test.structs = [!llvm.struct<"struct.1", (i32, f32)>, !llvm.struct<"struct.2", (i32, f32)>]
+func.func @existing(%arg0: !llvm.struct<"struct", (i64)>) {
+  return
+}
+
+// CHECK-LABEL: func @next
+// CHECK-SAME:    test.structs = [!llvm.struct<"struct.3", (i32, f32)>, !llvm.struct<"struct.4", (i32, f32)>]
+func.func @next() {
+  return
+}
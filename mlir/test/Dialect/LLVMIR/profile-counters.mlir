@@ -0,0 +1,60 @@
+// RUN: mlir-opt %s -llvm-add-profile-counters | FileCheck %s
+// RUN: mlir-opt %s -llvm-add-profile-counters="instrument-loops=1" \
+// RUN:   | FileCheck %s --check-prefix=LOOPS
+
+// CHECK-DAG: llvm.mlir.global internal constant @{{.*}}("callee\00")
+// CHECK-DAG: llvm.mlir.global internal constant @{{.*}}("loops\00")
+// CHECK-NOT: :loop0
+
+// CHECK-LABEL: llvm.func @callee
+//       CHECK:   %[[NAME:.*]] = llvm.getelementptr
+//  CHECK-NEXT:   %[[START:.*]] = llvm.call @mlirProfileReadCounter() : () -> i64
+//       CHECK:   llvm.cond_br
+//       CHECK:   llvm.call @mlirProfileRecordRegion(%[[NAME]], %[[START]]) : (!llvm.ptr, i64) -> ()
+//  CHECK-NEXT:   llvm.return
+//       CHECK:   llvm.call @mlirProfileRecordRegion(%[[NAME]], %[[START]]) : (!llvm.ptr, i64) -> ()
+//  CHECK-NEXT:   llvm.return
+llvm.func @callee(%arg0: i1) {
+  llvm.cond_br %arg0, ^bb1, ^bb2
+^bb1:
+  llvm.return
+^bb2:
+  llvm.return
+}
+
+// LOOPS-DAG: llvm.mlir.global internal constant @{{.*}}("loops:loop0\00")
+// LOOPS-DAG: llvm.mlir.global internal constant @{{.*}}("loops:loop1\00")
+// LOOPS-NOT: :loop2
+
+// LOOPS-LABEL: func @loops
+//       LOOPS:   %[[NAME:.*]] = llvm.getelementptr
+//  LOOPS-NEXT:   %[[START:.*]] = llvm.call @mlirProfileReadCounter()
+//       LOOPS:   %[[LOOP0:.*]] = llvm.getelementptr
+//  LOOPS-NEXT:   %[[LOOP0_START:.*]] = llvm.call @mlirProfileReadCounter()
+//  LOOPS-NEXT:   scf.for
+//   LOOPS-NOT:   llvm.call @mlirProfile
+//       LOOPS:   llvm.call @mlirProfileRecordRegion(%[[LOOP0]], %[[LOOP0_START]])
+//       LOOPS:   %[[LOOP1:.*]] = llvm.getelementptr
+//  LOOPS-NEXT:   %[[LOOP1_START:.*]] = llvm.call @mlirProfileReadCounter()
+//  LOOPS-NEXT:   scf.for
+//       LOOPS:   llvm.call @mlirProfileRecordRegion(%[[LOOP1]], %[[LOOP1_START]])
+//  LOOPS-NEXT:   llvm.call @mlirProfileRecordRegion(%[[LOOP1]], %[[LOOP1_START]])
+//  LOOPS-NEXT:   llvm.call @mlirProfileRecordRegion(%[[NAME]], %[[START]])
+//  LOOPS-NEXT:   return
+func.func @loops(%lb: index, %ub: index, %step: index) {
+  scf.for %i = %lb to %ub step %step {
+    scf.for %j = %lb to %ub step %step {
+      func.call @external() : () -> ()
+    }
+  }
+  scf.for %i = %lb to %ub step %step {
+    func.call @external() : () -> ()
+  }
+  return
+}
+
+// The declarations are not instrumented.
+//     CHECK-LABEL: func.func private @external()
+//      CHECK-NEXT: llvm.func @mlirProfileReadCounter() -> i64
+//      CHECK-NEXT: llvm.func @mlirProfileRecordRegion(!llvm.ptr, i64)
+func.func private @external()
@@ -0,0 +1,98 @@
+// RUN: mlir-opt %s -split-input-file -linalg-cache-tiling | FileCheck %s
+
+// The matmul is tiled for L2, for L1, and for an 8x8 block of accumulators
+// in the vector registers, which is updated for one step of the reduction
+// at a time.
+
+module attributes { dlti.dl_spec = #dlti.dl_spec<
+    #dlti.dl_entry<"dlti.l1_cache_size_in_bytes", 32768 : i64>,
+    #dlti.dl_entry<"dlti.l2_cache_size_in_bytes", 1048576 : i64>,
+    #dlti.dl_entry<"dlti.vector_width_in_bits", 256 : i64>,
+    #dlti.dl_entry<"dlti.num_vector_registers", 16 : i64>> } {
+
+// CHECK-LABEL: func @matmul(
+//       CHECK:   scf.for %{{.*}} step %c256{{(_[0-9]+)?}} iter_args
+//       CHECK:     scf.for %{{.*}} step %c256{{(_[0-9]+)?}} iter_args
+//       CHECK:       scf.for %{{.*}} step %c128{{(_[0-9]+)?}} iter_args
+//       CHECK:         scf.for %{{.*}} step %c32{{(_[0-9]+)?}} iter_args
+//       CHECK:           scf.for %{{.*}} step %c32{{(_[0-9]+)?}} iter_args
+//       CHECK:             scf.for %{{.*}} step %c32{{(_[0-9]+)?}} iter_args
+//       CHECK:               scf.for %{{.*}} step %c8{{(_[0-9]+)?}} iter_args
+//       CHECK:                 scf.for %{{.*}} step %c8{{(_[0-9]+)?}} iter_args
+//       CHECK:                   scf.for %{{.*}} step %c1{{(_[0-9]+)?}} iter_args
+//       CHECK:                     linalg.matmul
+//  CHECK-SAME:                       ins(%{{.*}}, %{{.*}} : tensor<8x1xf32>, tensor<1x8xf32>)
+//  CHECK-SAME:                       outs(%{{.*}} : tensor<8x8xf32>)
+func.func @matmul(%A: tensor<1024x1024xf32>, %B: tensor<1024x1024xf32>,
+                  %C: tensor<1024x1024xf32>) -> tensor<1024x1024xf32> {
+  %0 = linalg.matmul ins(%A, %B : tensor<1024x1024xf32>, tensor<1024x1024xf32>)
+                     outs(%C : tensor<1024x1024xf32>) -> tensor<1024x1024xf32>
+  return %0 : tensor<1024x1024xf32>
+}
+
+}
+
+// -----
+
+// The element-wise op on buffers only needs to tile one of its loops to fit
+// in L1, and is then tiled for the vector registers.
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+module attributes { dlti.dl_spec = #dlti.dl_spec<
+    #dlti.dl_entry<"dlti.l1_cache_size_in_bytes", 32768 : i64>,
+    #dlti.dl_entry<"dlti.vector_width_in_bits", 256 : i64>,
+    #dlti.dl_entry<"dlti.num_vector_registers", 16 : i64>> } {
+
+// CHECK-LABEL: func @add(
+//       CHECK:   scf.for %{{.*}} step %c32{{(_[0-9]+)?}} {
+//       CHECK:     scf.for %{{.*}} step %c8{{(_[0-9]+)?}} {
+//       CHECK:       scf.for %{{.*}} step %c8{{(_[0-9]+)?}} {
+//       CHECK:         linalg.generic
+//   CHECK-NOT:   scf.for
+func.func @add(%A: memref<64x48xf32>, %B: memref<64x48xf32>) {
+  linalg.generic {indexing_maps = [#map, #map],
+                  iterator_types = ["parallel", "parallel"]}
+      ins(%A : memref<64x48xf32>) outs(%B : memref<64x48xf32>) {
+    ^bb0(%a: f32, %b: f32):
+      %0 = arith.addf %a, %b : f32
+      linalg.yield %0 : f32
+  }
+  return
+}
+
+}
+
+// -----
+
+// Without a description of the memory hierarchy, nothing is tiled.
+
+// CHECK-LABEL: func @no_hierarchy(
+//   CHECK-NOT:   scf.for
+//       CHECK:   linalg.matmul
+func.func @no_hierarchy(%A: tensor<1024x1024xf32>, %B: tensor<1024x1024xf32>,
+                        %C: tensor<1024x1024xf32>) -> tensor<1024x1024xf32> {
+  %0 = linalg.matmul ins(%A, %B : tensor<1024x1024xf32>, tensor<1024x1024xf32>)
+                     outs(%C : tensor<1024x1024xf32>) -> tensor<1024x1024xf32>
+  return %0 : tensor<1024x1024xf32>
+}
+
+// -----
+
+// The indexing maps of convolutions are not projected permutations, so the
+// footprint of their tiles is not modeled.
+
+module attributes { dlti.dl_spec = #dlti.dl_spec<
+    #dlti.dl_entry<"dlti.l1_cache_size_in_bytes", 32768 : i64>> } {
+
+// CHECK-LABEL: func @conv(
+//   CHECK-NOT:   scf.for
+//       CHECK:   linalg.conv_1d
+func.func @conv(%I: tensor<4096xf32>, %F: tensor<3xf32>,
+                %O: tensor<4094xf32>) -> tensor<4094xf32> {
+  %0 = linalg.conv_1d ins(%I, %F : tensor<4096xf32>, tensor<3xf32>)
+                      outs(%O : tensor<4094xf32>) -> tensor<4094xf32>
+  return %0 : tensor<4094xf32>
+}
+
+}
@@ -0,0 +1,87 @@
+// RUN: mlir-opt %s -split-input-file -linalg-data-layout-assignment | FileCheck %s
+
+// The result of the first matmul is consumed by the second matmul through an
+// element-wise op. The reduction of the second matmul is assigned the tile of
+// the columns of the first one, so that the chain is computed in the packed
+// layouts, and only its arguments and its result are packed and unpacked.
+
+#map = affine_map<(d0, d1) -> (d0, d1)>
+
+// CHECK-LABEL: func @matmul_relu_matmul(
+//  CHECK-SAME:   %[[A:.*]]: tensor<32x64xf32>, %[[B:.*]]: tensor<64x32xf32>, %[[D:.*]]: tensor<32x16xf32>
+//   CHECK-DAG:   tensor.pack %[[A]] inner_dims_pos = [0, 1] inner_tiles = [8, 1] into %{{.*}} : tensor<32x64xf32> -> tensor<4x64x8x1xf32>
+//   CHECK-DAG:   tensor.pack %[[B]] inner_dims_pos = [1, 0] inner_tiles = [8, 1] into %{{.*}} : tensor<64x32xf32> -> tensor<64x4x8x1xf32>
+//   CHECK-NOT:   tensor.unpack
+//       CHECK:   linalg.generic
+//       CHECK:     arith.mulf
+//   CHECK-NOT:   tensor.unpack
+//       CHECK:   linalg.generic
+//       CHECK:     arith.maxf
+//   CHECK-NOT:   tensor.unpack
+//       CHECK:   tensor.pack %[[D]] inner_dims_pos = [1, 0] inner_tiles = [8, 8] into %{{.*}} : tensor<32x16xf32> -> tensor<4x2x8x8xf32>
+//   CHECK-NOT:   tensor.unpack
+//   CHECK-NOT:   tensor.pack
+//       CHECK:   %[[R:.*]] = linalg.generic
+//       CHECK:     arith.mulf
+//       CHECK:   %[[U:.*]] = tensor.unpack %[[R]] inner_dims_pos = [0, 1] inner_tiles = [8, 8] into %{{.*}} : tensor<4x2x8x8xf32> -> tensor<32x16xf32>
+//   CHECK-NOT:   tensor.unpack
+//       CHECK:   return %[[U]]
+func.func @matmul_relu_matmul(%A: tensor<32x64xf32>, %B: tensor<64x32xf32>,
+                              %D: tensor<32x16xf32>) -> tensor<32x16xf32> {
+  %zero = arith.constant 0.0 : f32
+  %empty = tensor.empty() : tensor<32x32xf32>
+  %fill = linalg.fill ins(%zero : f32) outs(%empty : tensor<32x32xf32>) -> tensor<32x32xf32>
+  %C = linalg.matmul ins(%A, %B : tensor<32x64xf32>, tensor<64x32xf32>)
+                     outs(%fill : tensor<32x32xf32>) -> tensor<32x32xf32>
+  %relu = linalg.generic {indexing_maps = [#map, #map],
+                          iterator_types = ["parallel", "parallel"]}
+      ins(%C : tensor<32x32xf32>) outs(%empty : tensor<32x32xf32>) {
+    ^bb0(%in: f32, %out: f32):
+      %0 = arith.maxf %in, %zero : f32
+      linalg.yield %0 : f32
+  } -> tensor<32x32xf32>
+  %empty2 = tensor.empty() : tensor<32x16xf32>
+  %fill2 = linalg.fill ins(%zero : f32) outs(%empty2 : tensor<32x16xf32>) -> tensor<32x16xf32>
+  %E = linalg.matmul ins(%relu, %D : tensor<32x32xf32>, tensor<32x16xf32>)
+                     outs(%fill2 : tensor<32x16xf32>) -> tensor<32x16xf32>
+  return %E : tensor<32x16xf32>
+}
+
+// -----
+
+// The channels of a convolution are packed into the NCHWc layout.
+
+// CHECK-LABEL: func @conv_2d_nchw_fchw(
+//  CHECK-SAME:   %[[I:.*]]: tensor<1x16x18x18xf32>, %[[F:.*]]: tensor<32x16x3x3xf32>, %[[O:.*]]: tensor<1x32x16x16xf32>
+//   CHECK-DAG:   tensor.pack %[[I]] inner_dims_pos = [1] inner_tiles = [8] into %{{.*}} : tensor<1x16x18x18xf32> -> tensor<1x2x18x18x8xf32>
+//   CHECK-DAG:   tensor.pack %[[F]] inner_dims_pos = [0, 1] inner_tiles = [8, 8] into %{{.*}} : tensor<32x16x3x3xf32> -> tensor<4x2x3x3x8x8xf32>
+//   CHECK-DAG:   tensor.pack %[[O]] inner_dims_pos = [1] inner_tiles = [8] into %{{.*}} : tensor<1x32x16x16xf32> -> tensor<1x4x16x16x8xf32>
+//       CHECK:   %[[R:.*]] = linalg.generic
+//       CHECK:   tensor.unpack %[[R]] inner_dims_pos = [1] inner_tiles = [8]
+func.func @conv_2d_nchw_fchw(%input: tensor<1x16x18x18xf32>,
+                             %filter: tensor<32x16x3x3xf32>,
+                             %init: tensor<1x32x16x16xf32>) -> tensor<1x32x16x16xf32> {
+  %0 = linalg.conv_2d_nchw_fchw
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%input, %filter : tensor<1x16x18x18xf32>, tensor<32x16x3x3xf32>)
+    outs(%init : tensor<1x32x16x16xf32>) -> tensor<1x32x16x16xf32>
+  return %0 : tensor<1x32x16x16xf32>
+}
+
+// -----
+
+// The loops whose sizes are not divisible by their tiles are not packed, so
+// that every pack needs no padding.
+
+// CHECK-LABEL: func @matmul_not_divisible(
+//   CHECK-DAG:   tensor.pack %{{.*}} inner_dims_pos = [1] inner_tiles = [1] into %{{.*}} : tensor<30x64xf32> -> tensor<30x64x1xf32>
+//   CHECK-DAG:   tensor.pack %{{.*}} inner_dims_pos = [1, 0] inner_tiles = [8, 1] into %{{.*}} : tensor<64x32xf32> -> tensor<64x4x8x1xf32>
+//   CHECK-NOT:   padding_value
+//       CHECK:   linalg.generic
+//       CHECK:   tensor.unpack %{{.*}} inner_dims_pos = [1] inner_tiles = [8]
+func.func @matmul_not_divisible(%A: tensor<30x64xf32>, %B: tensor<64x32xf32>,
+                                %C: tensor<30x32xf32>) -> tensor<30x32xf32> {
+  %0 = linalg.matmul ins(%A, %B : tensor<30x64xf32>, tensor<64x32xf32>)
+                     outs(%C : tensor<30x32xf32>) -> tensor<30x32xf32>
+  return %0 : tensor<30x32xf32>
+}
@@ -0,0 +1,67 @@
+// RUN: mlir-opt %s -split-input-file -linalg-prepack-constant-weights | FileCheck %s
+// RUN: mlir-opt %s -split-input-file \
+// RUN:   -linalg-prepack-constant-weights="init-function=init" | \
+// RUN:   FileCheck %s --check-prefix=CHECK-NAMED
+
+// The constant weight is packed once into a global, in the module initializer,
+// and the function reads the packed weight from the global.
+
+// CHECK-LABEL: func @matmul(
+//  CHECK-SAME:   %[[LHS:.*]]: tensor<2x4x8x1xf32>
+//       CHECK:   %[[BUF:.*]] = memref.get_global @__packed_weight : memref<2x4x8x1xf32>
+//       CHECK:   %[[RHS:.*]] = bufferization.to_tensor %[[BUF]] restrict : memref<2x4x8x1xf32>
+//   CHECK-NOT:   tensor.pack
+//       CHECK:   linalg.mmt4d ins(%[[LHS]], %[[RHS]] : tensor<2x4x8x1xf32>, tensor<2x4x8x1xf32>)
+//       CHECK: memref.global "private" @__packed_weight : memref<2x4x8x1xf32> = uninitialized {alignment = 64 : i64}
+// CHECK-LABEL: func.func @__mlir_module_init()
+//       CHECK:   %[[CST:.*]] = arith.constant dense<1.000000e+00> : tensor<4x16xf32>
+//       CHECK:   %[[EMPTY:.*]] = tensor.empty() : tensor<2x4x8x1xf32>
+//       CHECK:   %[[PACK:.*]] = tensor.pack %[[CST]] outer_dims_perm = [1, 0] inner_dims_pos = [1, 0] inner_tiles = [8, 1] into %[[EMPTY]]
+//       CHECK:   %[[INIT:.*]] = memref.get_global @__packed_weight : memref<2x4x8x1xf32>
+//       CHECK:   memref.tensor_store %[[PACK]], %[[INIT]] : memref<2x4x8x1xf32>
+//       CHECK:   return
+
+// CHECK-NAMED: func.func @init()
+func.func @matmul(%lhs: tensor<2x4x8x1xf32>, %acc: tensor<2x2x8x8xf32>) -> tensor<2x2x8x8xf32> {
+  %cst = arith.constant dense<1.0> : tensor<4x16xf32>
+  %empty = tensor.empty() : tensor<2x4x8x1xf32>
+  %rhs = tensor.pack %cst outer_dims_perm = [1, 0] inner_dims_pos = [1, 0] inner_tiles = [8, 1] into %empty : tensor<4x16xf32> -> tensor<2x4x8x1xf32>
+  %0 = linalg.mmt4d ins(%lhs, %rhs : tensor<2x4x8x1xf32>, tensor<2x4x8x1xf32>) outs(%acc : tensor<2x2x8x8xf32>) -> tensor<2x2x8x8xf32>
+  return %0 : tensor<2x2x8x8xf32>
+}
+
+// -----
+
+// The packs are appended to an existing initializer, and the packs of values
+// that are not constant are left in place.
+
+// CHECK-LABEL: func @pack_weights(
+//       CHECK:   memref.get_global @__packed_weight :
+//       CHECK:   memref.get_global @__packed_weight_0 :
+//       CHECK:   tensor.pack %{{.*}} inner_dims_pos = [0, 1] inner_tiles = [8, 8]
+//       CHECK: memref.global "private" @__packed_weight : memref<2x2x8x8xf32>
+//       CHECK: memref.global "private" @__packed_weight_0 : memref<1x2x8x8xf32>
+// CHECK-LABEL: func.func @__mlir_module_init()
+//       CHECK:   "test.init"() : () -> ()
+//       CHECK:   tensor.pack
+//       CHECK:   memref.tensor_store
+//       CHECK:   arith.constant 0.000000e+00 : f32
+//       CHECK:   tensor.pack {{.*}} padding_value(
+//       CHECK:   memref.tensor_store
+//       CHECK:   return
+func.func @pack_weights(%arg0: tensor<16x16xf32>) -> (tensor<2x2x8x8xf32>, tensor<1x2x8x8xf32>, tensor<2x2x8x8xf32>) {
+  %cst = arith.constant dense<2.0> : tensor<16x16xf32>
+  %small = arith.constant dense<3.0> : tensor<5x16xf32>
+  %pad = arith.constant 0.0 : f32
+  %empty = tensor.empty() : tensor<2x2x8x8xf32>
+  %empty_small = tensor.empty() : tensor<1x2x8x8xf32>
+  %0 = tensor.pack %cst inner_dims_pos = [0, 1] inner_tiles = [8, 8] into %empty : tensor<16x16xf32> -> tensor<2x2x8x8xf32>
+  %1 = tensor.pack %small padding_value(%pad : f32) inner_dims_pos = [0, 1] inner_tiles = [8, 8] into %empty_small : tensor<5x16xf32> -> tensor<1x2x8x8xf32>
+  %2 = tensor.pack %arg0 inner_dims_pos = [0, 1] inner_tiles = [8, 8] into %empty : tensor<16x16xf32> -> tensor<2x2x8x8xf32>
+  return %0, %1, %2 : tensor<2x2x8x8xf32>, tensor<1x2x8x8xf32>, tensor<2x2x8x8xf32>
+}
+
+func.func @__mlir_module_init() {
+  "test.init"() : () -> ()
+  return
+}
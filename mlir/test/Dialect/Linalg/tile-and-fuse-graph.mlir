@@ -0,0 +1,153 @@
+// RUN: mlir-opt %s -split-input-file \
+// RUN:   -linalg-tile-and-fuse-graph="tile-sizes=4" | FileCheck %s
+// RUN: mlir-opt %s -split-input-file \
+// RUN:   -linalg-tile-and-fuse-graph="tile-sizes=4 memory-cost=1" | \
+// RUN:   FileCheck %s --check-prefix=CHECK-MAT
+// RUN: mlir-opt %s -split-input-file \
+// RUN:   -linalg-tile-and-fuse-graph="tile-sizes=4,16" | \
+// RUN:   FileCheck %s --check-prefix=CHECK-2D
+
+#id = affine_map<(d0, d1) -> (d0, d1)>
+#row = affine_map<(d0, d1) -> (d0)>
+
+// The softmax is fused into one loop over the tiles of rows. The exponential
+// is used by both the sum and the division, so it is recomputed for the sum
+// rather than materialized. When memory is cheap it is materialized instead,
+// by a loop nest of its own into which the maximum is fused.
+
+// CHECK-LABEL: func @softmax(
+//       CHECK:   %[[R:.*]] = scf.for %{{.*}} step %c4
+//   CHECK-NOT:   scf.for
+//       CHECK:     linalg.fill
+//       CHECK:     arith.maxf
+//       CHECK:     math.exp
+//       CHECK:     arith.addf
+//       CHECK:     arith.divf
+//       CHECK:     scf.yield
+//  CHECK-NEXT:   }
+//  CHECK-NEXT:   return %[[R]]
+//
+// CHECK-MAT-LABEL: func @softmax(
+//       CHECK-MAT:   %[[E:.*]] = scf.for %{{.*}} step %c4
+//       CHECK-MAT:     arith.maxf
+//       CHECK-MAT:     math.exp
+//   CHECK-MAT-NOT:     arith.divf
+//       CHECK-MAT:     scf.yield
+//       CHECK-MAT:   %[[R:.*]] = scf.for %{{.*}} step %c4
+//       CHECK-MAT:     tensor.extract_slice %[[E]]
+//   CHECK-MAT-NOT:     math.exp
+//       CHECK-MAT:     arith.addf
+//       CHECK-MAT:     arith.divf
+//       CHECK-MAT:     scf.yield
+//       CHECK-MAT:   return %[[R]]
+func.func @softmax(%x: tensor<16x64xf32>) -> tensor<16x64xf32> {
+  %ninf = arith.constant 0xFF800000 : f32
+  %zero = arith.constant 0.0 : f32
+  %empty_row = tensor.empty() : tensor<16xf32>
+  %empty = tensor.empty() : tensor<16x64xf32>
+  %init_max = linalg.fill ins(%ninf : f32) outs(%empty_row : tensor<16xf32>) -> tensor<16xf32>
+  %max = linalg.generic {indexing_maps = [#id, #row],
+                         iterator_types = ["parallel", "reduction"]}
+      ins(%x : tensor<16x64xf32>) outs(%init_max : tensor<16xf32>) {
+    ^bb0(%a: f32, %m: f32):
+      %0 = arith.maxf %a, %m : f32
+      linalg.yield %0 : f32
+  } -> tensor<16xf32>
+  %exp = linalg.generic {indexing_maps = [#id, #row, #id],
+                         iterator_types = ["parallel", "parallel"]}
+      ins(%x, %max : tensor<16x64xf32>, tensor<16xf32>)
+      outs(%empty : tensor<16x64xf32>) {
+    ^bb0(%a: f32, %m: f32, %e: f32):
+      %0 = arith.subf %a, %m : f32
+      %1 = math.exp %0 : f32
+      linalg.yield %1 : f32
+  } -> tensor<16x64xf32>
+  %init_sum = linalg.fill ins(%zero : f32) outs(%empty_row : tensor<16xf32>) -> tensor<16xf32>
+  %sum = linalg.generic {indexing_maps = [#id, #row],
+                         iterator_types = ["parallel", "reduction"]}
+      ins(%exp : tensor<16x64xf32>) outs(%init_sum : tensor<16xf32>) {
+    ^bb0(%e: f32, %s: f32):
+      %0 = arith.addf %e, %s : f32
+      linalg.yield %0 : f32
+  } -> tensor<16xf32>
+  %div = linalg.generic {indexing_maps = [#id, #row, #id],
+                         iterator_types = ["parallel", "parallel"]}
+      ins(%exp, %sum : tensor<16x64xf32>, tensor<16xf32>)
+      outs(%empty : tensor<16x64xf32>) {
+    ^bb0(%e: f32, %s: f32, %d: f32):
+      %0 = arith.divf %e, %s : f32
+      linalg.yield %0 : f32
+  } -> tensor<16x64xf32>
+  return %div : tensor<16x64xf32>
+}
+
+// -----
+
+#id = affine_map<(d0, d1) -> (d0, d1)>
+
+// A producer that is also returned is fused without recomputation, and its
+// value is yielded from the loop nest.
+
+// CHECK-LABEL: func @yield_producer(
+//       CHECK:   %[[R:.*]]:2 = scf.for %{{.*}} step %c4
+//       CHECK:     arith.negf
+//       CHECK:     arith.mulf
+//       CHECK:     scf.yield
+//   CHECK-NOT:   linalg.generic
+//       CHECK:   return %[[R]]#1, %[[R]]#0
+func.func @yield_producer(%x: tensor<16x64xf32>)
+    -> (tensor<16x64xf32>, tensor<16x64xf32>) {
+  %empty = tensor.empty() : tensor<16x64xf32>
+  %neg = linalg.generic {indexing_maps = [#id, #id],
+                         iterator_types = ["parallel", "parallel"]}
+      ins(%x : tensor<16x64xf32>) outs(%empty : tensor<16x64xf32>) {
+    ^bb0(%a: f32, %n: f32):
+      %0 = arith.negf %a : f32
+      linalg.yield %0 : f32
+  } -> tensor<16x64xf32>
+  %sq = linalg.generic {indexing_maps = [#id, #id],
+                        iterator_types = ["parallel", "parallel"]}
+      ins(%neg : tensor<16x64xf32>) outs(%empty : tensor<16x64xf32>) {
+    ^bb0(%a: f32, %s: f32):
+      %0 = arith.mulf %a, %a : f32
+      linalg.yield %0 : f32
+  } -> tensor<16x64xf32>
+  return %neg, %sq : tensor<16x64xf32>, tensor<16x64xf32>
+}
+
+// -----
+
+#id = affine_map<(d0, d1) -> (d0, d1)>
+#row = affine_map<(d0, d1) -> (d0)>
+
+// A row reduction that would be recomputed for every tile of the columns of
+// its consumer is materialized, and is tiled by a loop nest of its own.
+
+// CHECK-2D-LABEL: func @recompute_reduction(
+//       CHECK-2D:   %[[S:.*]] = scf.for %{{.*}} step %c4
+//       CHECK-2D:     arith.addf
+//       CHECK-2D:   scf.for %{{.*}} step %c4
+//       CHECK-2D:     scf.for %{{.*}} step %c16
+//       CHECK-2D:       tensor.extract_slice %[[S]]
+//   CHECK-2D-NOT:       arith.addf
+//       CHECK-2D:       arith.divf
+func.func @recompute_reduction(%x: tensor<16x64xf32>,
+                               %init: tensor<16xf32>) -> tensor<16x64xf32> {
+  %empty = tensor.empty() : tensor<16x64xf32>
+  %sum = linalg.generic {indexing_maps = [#id, #row],
+                         iterator_types = ["parallel", "reduction"]}
+      ins(%x : tensor<16x64xf32>) outs(%init : tensor<16xf32>) {
+    ^bb0(%a: f32, %s: f32):
+      %0 = arith.addf %a, %s : f32
+      linalg.yield %0 : f32
+  } -> tensor<16xf32>
+  %div = linalg.generic {indexing_maps = [#id, #row, #id],
+                         iterator_types = ["parallel", "parallel"]}
+      ins(%x, %sum : tensor<16x64xf32>, tensor<16xf32>)
+      outs(%empty : tensor<16x64xf32>) {
+    ^bb0(%a: f32, %s: f32, %d: f32):
+      %0 = arith.divf %a, %s : f32
+      linalg.yield %0 : f32
+  } -> tensor<16x64xf32>
+  return %div : tensor<16x64xf32>
+}
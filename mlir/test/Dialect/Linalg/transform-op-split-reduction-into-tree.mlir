@@ -0,0 +1,94 @@
+// RUN: mlir-opt --test-transform-dialect-interpreter --split-input-file --verify-diagnostics %s | FileCheck %s
+
+func.func @tree_reduction(%in: tensor<8xf32>, %out: tensor<f32>) -> tensor<f32> {
+  %r = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>,
+                                        affine_map<(d0) -> ()>],
+                       iterator_types = ["reduction"]}
+    ins(%in : tensor<8xf32>) outs(%out : tensor<f32>) {
+  ^bb0(%arg0: f32, %arg1: f32):
+    %0 = arith.addf %arg0, %arg1 : f32
+    linalg.yield %0 : f32
+  } -> tensor<f32>
+  return %r : tensor<f32>
+}
+
+transform.sequence failures(propagate) {
+^bb0(%arg1: !transform.any_op):
+  %0 = transform.structured.match ops{["linalg.generic"]} in %arg1 : (!transform.any_op) -> !transform.any_op
+  %1:2 = transform.structured.split_reduction_into_tree %0 : (!transform.any_op) -> (!transform.any_op, !transform.any_op)
+}
+
+// CHECK-LABEL: func @tree_reduction
+//  CHECK-SAME:   %[[IN:.+]]: tensor<8xf32>, %[[OUT:.+]]: tensor<f32>
+//       CHECK:   %[[E0:.+]] = tensor.expand_shape %[[IN]] {{\[}}[0, 1]] : tensor<8xf32> into tensor<4x2xf32>
+//       CHECK:   %[[L0:.+]] = linalg.generic
+//  CHECK-SAME:     iterator_types = ["parallel", "reduction"]
+//  CHECK-SAME:     ins(%[[E0]] : tensor<4x2xf32>)
+//       CHECK:   } -> tensor<4xf32>
+//       CHECK:   %[[E1:.+]] = tensor.expand_shape %[[L0]] {{\[}}[0, 1]] : tensor<4xf32> into tensor<2x2xf32>
+//       CHECK:   %[[L1:.+]] = linalg.generic
+//  CHECK-SAME:     iterator_types = ["parallel", "reduction"]
+//  CHECK-SAME:     ins(%[[E1]] : tensor<2x2xf32>)
+//       CHECK:   } -> tensor<2xf32>
+//       CHECK:   %[[R:.+]] = linalg.generic
+//  CHECK-SAME:     iterator_types = ["reduction"]
+//  CHECK-SAME:     ins(%[[L1]] : tensor<2xf32>) outs(%[[OUT]] : tensor<f32>)
+//       CHECK:   return %[[R]]
+
+// -----
+
+// The partial results of the threads of the forall are combined by a tree
+// instead of a sequential reduction.
+
+func.func @forall_tree_reduction(%in: tensor<64xf32>, %out: tensor<f32>) -> tensor<f32> {
+  %r = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>,
+                                        affine_map<(d0) -> ()>],
+                       iterator_types = ["reduction"]}
+    ins(%in : tensor<64xf32>) outs(%out : tensor<f32>) {
+  ^bb0(%arg0: f32, %arg1: f32):
+    %0 = arith.addf %arg0, %arg1 : f32
+    linalg.yield %0 : f32
+  } -> tensor<f32>
+  return %r : tensor<f32>
+}
+
+transform.sequence failures(propagate) {
+^bb0(%arg1: !transform.any_op):
+  %0 = transform.structured.match ops{["linalg.generic"]} in %arg1 : (!transform.any_op) -> !transform.any_op
+  %loop, %fill, %split, %combining = transform.structured.tile_reduction_using_forall %0
+    by num_threads = [8], tile_sizes = [] : (!transform.any_op) -> (!transform.any_op, !transform.any_op, !transform.any_op, !transform.any_op)
+  %tree, %last = transform.structured.split_reduction_into_tree %combining { arity = 4 } : (!transform.any_op) -> (!transform.any_op, !transform.any_op)
+}
+
+// CHECK-LABEL: func @forall_tree_reduction
+//       CHECK:   %[[L:.+]] = scf.forall {{.*}} -> (tensor<8xf32>)
+//       CHECK:   %[[E0:.+]] = tensor.expand_shape %[[L]] {{\[}}[0, 1]] : tensor<8xf32> into tensor<2x4xf32>
+//       CHECK:   %[[L0:.+]] = linalg.generic
+//  CHECK-SAME:     iterator_types = ["parallel", "reduction"]
+//  CHECK-SAME:     ins(%[[E0]] : tensor<2x4xf32>)
+//       CHECK:   } -> tensor<2xf32>
+//       CHECK:   %[[R:.+]] = linalg.generic
+//  CHECK-SAME:     iterator_types = ["reduction"]
+//  CHECK-SAME:     ins(%[[L0]] : tensor<2xf32>)
+//       CHECK:   return %[[R]]
+
+// -----
+
+func.func @invalid_arity(%in: tensor<?xf32>, %out: tensor<f32>) -> tensor<f32> {
+  %r = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>,
+                                        affine_map<(d0) -> ()>],
+                       iterator_types = ["reduction"]}
+    ins(%in : tensor<?xf32>) outs(%out : tensor<f32>) {
+  ^bb0(%arg0: f32, %arg1: f32):
+    %0 = arith.addf %arg0, %arg1 : f32
+    linalg.yield %0 : f32
+  } -> tensor<f32>
+  return %r : tensor<f32>
+}
+
+transform.sequence failures(propagate) {
+^bb0(%arg1: !transform.any_op):
+  %0 = transform.structured.match ops{["linalg.generic"]} in %arg1 : (!transform.any_op) -> !transform.any_op
+  // expected-error @below {{expects an arity greater than 1}}
+  %1:2 = transform.structured.split_reduction_into_tree %0 { arity = 1 } : (!transform.any_op) -> (!transform.any_op, !transform.any_op)
+}
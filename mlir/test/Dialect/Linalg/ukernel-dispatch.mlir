@@ -0,0 +1,91 @@
+// RUN: mlir-opt %s -split-input-file -linalg-ukernel-dispatch | FileCheck %s
+// RUN: mlir-opt %s -split-input-file \
+// RUN:   -linalg-ukernel-dispatch="ukernels=mlir_ukernel_mmt4d_f32f32f32_4x4x1" | \
+// RUN:   FileCheck %s --check-prefix=CHECK-USER
+
+// The packed tiles of the mmt4d with the inner tiles 8x8x1 are computed by
+// the micro-kernel of the runner utils, which is declared once with its C
+// interface.
+
+// CHECK-LABEL: func @mmt4d_8x8x1(
+//  CHECK-SAME:   %[[A:.*]]: memref<4x16x8x1xf32>, %[[B:.*]]: memref<2x16x8x1xf32>, %[[C:.*]]: memref<4x2x8x8xf32>
+//       CHECK:   %[[CA:.*]] = memref.cast %[[A]] : memref<4x16x8x1xf32> to memref<?x?x?x?xf32, strided<[?, ?, ?, ?], offset: ?>>
+//       CHECK:   %[[CB:.*]] = memref.cast %[[B]] : memref<2x16x8x1xf32> to memref<?x?x?x?xf32, strided<[?, ?, ?, ?], offset: ?>>
+//       CHECK:   %[[CC:.*]] = memref.cast %[[C]] : memref<4x2x8x8xf32> to memref<?x?x?x?xf32, strided<[?, ?, ?, ?], offset: ?>>
+//       CHECK:   call @mlir_ukernel_mmt4d_f32f32f32_8x8x1(%[[CA]], %[[CB]], %[[CC]])
+//       CHECK:   call @mlir_ukernel_mmt4d_f32f32f32_8x8x1(
+//   CHECK-NOT:   linalg.mmt4d
+//       CHECK: func.func private @mlir_ukernel_mmt4d_f32f32f32_8x8x1(memref<?x?x?x?xf32, strided<[?, ?, ?, ?], offset: ?>>, memref<?x?x?x?xf32, strided<[?, ?, ?, ?], offset: ?>>, memref<?x?x?x?xf32, strided<[?, ?, ?, ?], offset: ?>>) attributes {llvm.emit_c_interface}
+//   CHECK-NOT: func.func private @mlir_ukernel_mmt4d_f32f32f32_8x8x1(
+//
+// CHECK-USER-LABEL: func @mmt4d_8x8x1(
+//       CHECK-USER:   linalg.mmt4d
+func.func @mmt4d_8x8x1(%A: memref<4x16x8x1xf32>, %B: memref<2x16x8x1xf32>,
+                       %C: memref<4x2x8x8xf32>, %D: memref<?x?x8x1xf32>,
+                       %E: memref<?x?x8x1xf32>, %F: memref<?x?x8x8xf32>) {
+  linalg.mmt4d ins(%A, %B : memref<4x16x8x1xf32>, memref<2x16x8x1xf32>)
+               outs(%C : memref<4x2x8x8xf32>)
+  linalg.mmt4d ins(%D, %E : memref<?x?x8x1xf32>, memref<?x?x8x1xf32>)
+               outs(%F : memref<?x?x8x8xf32>)
+  return
+}
+
+// -----
+
+// A tile without a micro-kernel is left for vectorization, unless the tile
+// is one of the given micro-kernels.
+
+// CHECK-LABEL: func @mmt4d_4x4x1(
+//       CHECK:   linalg.mmt4d
+//   CHECK-NOT: func.func private
+//
+// CHECK-USER-LABEL: func @mmt4d_4x4x1(
+//       CHECK-USER:   call @mlir_ukernel_mmt4d_f32f32f32_4x4x1(
+//       CHECK-USER: func.func private @mlir_ukernel_mmt4d_f32f32f32_4x4x1(
+func.func @mmt4d_4x4x1(%A: memref<4x16x4x1xf32>, %B: memref<2x16x4x1xf32>,
+                       %C: memref<4x2x4x4xf32>) {
+  linalg.mmt4d ins(%A, %B : memref<4x16x4x1xf32>, memref<2x16x4x1xf32>)
+               outs(%C : memref<4x2x4x4xf32>)
+  return
+}
+
+// -----
+
+// The matmul on a strided 8x8 accumulator is computed by its micro-kernel
+// for any reduction size.
+
+// CHECK-LABEL: func @matmul_8x8(
+//       CHECK:   call @mlir_ukernel_matmul_f32f32f32_8x8(
+//   CHECK-NOT:   linalg.matmul
+//       CHECK: func.func private @mlir_ukernel_matmul_f32f32f32_8x8(memref<?x?xf32, strided<[?, ?], offset: ?>>, memref<?x?xf32, strided<[?, ?], offset: ?>>, memref<?x?xf32, strided<[?, ?], offset: ?>>)
+func.func @matmul_8x8(%A: memref<8x?xf32>, %B: memref<?x8xf32>,
+                      %C: memref<8x8xf32, strided<[64, 1], offset: ?>>) {
+  linalg.matmul ins(%A, %B : memref<8x?xf32>, memref<?x8xf32>)
+                outs(%C : memref<8x8xf32, strided<[64, 1], offset: ?>>)
+  return
+}
+
+// -----
+
+// Tiles of tensors, dynamic tiles, and tiles of other element types are not
+// dispatched.
+
+// CHECK-LABEL: func @not_dispatched(
+//   CHECK-NOT:   call
+//       CHECK:   linalg.matmul
+//       CHECK:   linalg.matmul
+//       CHECK:   linalg.matmul
+//   CHECK-NOT: func.func private
+func.func @not_dispatched(%A: tensor<8x4xf32>, %B: tensor<4x8xf32>,
+                          %C: tensor<8x8xf32>, %D: memref<?x4xf32>,
+                          %E: memref<4x8xf32>, %F: memref<?x8xf32>,
+                          %G: memref<8x4xf16>, %H: memref<4x8xf16>,
+                          %I: memref<8x8xf16>) -> tensor<8x8xf32> {
+  %0 = linalg.matmul ins(%A, %B : tensor<8x4xf32>, tensor<4x8xf32>)
+                     outs(%C : tensor<8x8xf32>) -> tensor<8x8xf32>
+  linalg.matmul ins(%D, %E : memref<?x4xf32>, memref<4x8xf32>)
+                outs(%F : memref<?x8xf32>)
+  linalg.matmul ins(%G, %H : memref<8x4xf16>, memref<4x8xf16>)
+                outs(%I : memref<8x8xf16>)
+  return %0 : tensor<8x8xf32>
+}
@@ -485,3 +485,68 @@ transform.sequence failures(propagate) {
   transform.structured.masked_vectorize %0 vector_sizes [8, 16, 4] : !transform.any_op
 }
 
+
+// -----
+
+func.func @vectorize_dynamic_reduce(%arg0: tensor<?x?xf32>,
+                                    %arg1: tensor<?xf32>) -> tensor<?xf32> {
+  %0 = linalg.reduce ins(%arg0 : tensor<?x?xf32>) outs(%arg1 : tensor<?xf32>) dimensions = [1]
+    (%in: f32, %init: f32) {
+      %1 = arith.addf %in, %init : f32
+      linalg.yield %1 : f32
+    }
+  return %0 : tensor<?xf32>
+}
+
+// CHECK-LABEL:   @vectorize_dynamic_reduce(
+// CHECK-SAME:                              %[[VAL_0:.*]]: tensor<?x?xf32>, %[[VAL_1:.*]]: tensor<?xf32>) -> tensor<?xf32> {
+// CHECK:           %[[VAL_3:.*]] = tensor.dim %[[VAL_0]], %{{.*}} : tensor<?x?xf32>
+// CHECK:           %[[VAL_5:.*]] = tensor.dim %[[VAL_0]], %{{.*}} : tensor<?x?xf32>
+// CHECK:           %[[VAL_8:.*]] = vector.create_mask %[[VAL_3]], %[[VAL_5]] : vector<4x8xi1>
+// CHECK:           %[[VAL_9:.*]] = vector.mask %[[VAL_8]] { vector.transfer_read %[[VAL_0]]{{.*}} {in_bounds = [true, true]} : tensor<?x?xf32>, vector<4x8xf32> } : vector<4x8xi1> -> vector<4x8xf32>
+// CHECK:           %[[VAL_11:.*]] = vector.create_mask %[[VAL_3]] : vector<4xi1>
+// CHECK:           %[[VAL_12:.*]] = vector.mask %[[VAL_11]] { vector.transfer_read %[[VAL_1]]{{.*}} {in_bounds = [true]} : tensor<?xf32>, vector<4xf32> } : vector<4xi1> -> vector<4xf32>
+// CHECK:           %[[VAL_13:.*]] = vector.mask %[[VAL_8]] { vector.multi_reduction <add>, %[[VAL_9]], %[[VAL_12]] [1] : vector<4x8xf32> to vector<4xf32> } : vector<4x8xi1> -> vector<4xf32>
+// CHECK:           %{{.*}} = vector.mask %[[VAL_11]] { vector.transfer_write %[[VAL_13]], %[[VAL_1]]{{.*}} {in_bounds = [true]} : vector<4xf32>, tensor<?xf32> } : vector<4xi1> -> tensor<?xf32>
+
+transform.sequence failures(propagate) {
+^bb1(%arg1: !transform.any_op):
+  %0 = transform.structured.match ops{["linalg.reduce"]} in %arg1 : (!transform.any_op) -> !transform.any_op
+  transform.structured.masked_vectorize %0 vector_sizes [4, 8] : !transform.any_op
+}
+
+// -----
+
+func.func @vectorize_dynamic_depthwise_conv(%input: memref<?x?x?xf32>,
+                                            %filter: memref<2x?xf32>,
+                                            %output: memref<?x?x?xf32>) {
+  linalg.depthwise_conv_1d_nwc_wc
+    {dilations = dense<1> : tensor<1xi64>, strides = dense<1> : tensor<1xi64>}
+    ins(%input, %filter : memref<?x?x?xf32>, memref<2x?xf32>)
+    outs(%output : memref<?x?x?xf32>)
+  return
+}
+
+// The vectors have the given sizes (n, w, c, kw), of which the input has
+// the window w + kw - 1, and every transfer is masked to its operand.
+
+// CHECK-LABEL:   func.func @vectorize_dynamic_depthwise_conv(
+// CHECK-SAME:      %[[INPUT:.*]]: memref<?x?x?xf32>, %[[FILTER:.*]]: memref<2x?xf32>, %[[OUTPUT:.*]]: memref<?x?x?xf32>) {
+// CHECK:           %[[IN_MASK:.*]] = vector.create_mask %{{.*}}, %{{.*}}, %{{.*}} : vector<1x9x4xi1>
+// CHECK:           %[[IN:.*]] = vector.mask %[[IN_MASK]] { vector.transfer_read %[[INPUT]]{{.*}} {in_bounds = [true, true, true]} : memref<?x?x?xf32>, vector<1x9x4xf32> } : vector<1x9x4xi1> -> vector<1x9x4xf32>
+// CHECK:           %[[F_MASK:.*]] = vector.create_mask %{{.*}}, %{{.*}} : vector<2x4xi1>
+// CHECK:           %[[F:.*]] = vector.mask %[[F_MASK]] { vector.transfer_read %[[FILTER]]{{.*}} {in_bounds = [true, true]} : memref<2x?xf32>, vector<2x4xf32> } : vector<2x4xi1> -> vector<2x4xf32>
+// CHECK:           %[[OUT_MASK:.*]] = vector.create_mask %{{.*}}, %{{.*}}, %{{.*}} : vector<1x8x4xi1>
+// CHECK:           %[[OUT:.*]] = vector.mask %[[OUT_MASK]] { vector.transfer_read %[[OUTPUT]]{{.*}} {in_bounds = [true, true, true]} : memref<?x?x?xf32>, vector<1x8x4xf32> } : vector<1x8x4xi1> -> vector<1x8x4xf32>
+// CHECK:           vector.extract_strided_slice %[[IN]] {offsets = [0, 0, 0], sizes = [1, 8, 4], strides = [1, 1, 1]}
+// CHECK:           vector.extract_strided_slice %[[IN]] {offsets = [0, 1, 0], sizes = [1, 8, 4], strides = [1, 1, 1]}
+// CHECK:           vector.fma
+// CHECK:           %[[RES:.*]] = vector.fma
+// CHECK:           %[[OUT_MASK_2:.*]] = vector.create_mask %{{.*}}, %{{.*}}, %{{.*}} : vector<1x8x4xi1>
+// CHECK:           vector.mask %[[OUT_MASK_2]] { vector.transfer_write %{{.*}}, %[[OUTPUT]]{{.*}} {in_bounds = [true, true, true]} : vector<1x8x4xf32>, memref<?x?x?xf32> } : vector<1x8x4xi1>
+
+transform.sequence failures(propagate) {
+^bb1(%arg1: !transform.any_op):
+  %0 = transform.structured.match ops{["linalg.depthwise_conv_1d_nwc_wc"]} in %arg1 : (!transform.any_op) -> !transform.any_op
+  transform.structured.masked_vectorize %0 vector_sizes [1, 8, 4, 2] : !transform.any_op
+}
@@ -134,3 +134,31 @@ transform.sequence failures(propagate) {
   transform.structured.masked_vectorize %0 vector_sizes [8, [16]] : !transform.any_op
 }
 
+
+// -----
+
+func.func @vectorize_dynamic_column_reduction(%arg0: tensor<?x?xf32>,
+                                              %arg1: tensor<?xf32>) -> tensor<?xf32> {
+  %0 = linalg.generic { indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                                         affine_map<(d0, d1) -> (d1)>],
+                        iterator_types = ["reduction", "parallel"] }
+    ins(%arg0 : tensor<?x?xf32>) outs(%arg1 : tensor<?xf32>) {
+    ^bb(%in: f32, %out: f32) :
+      %0 = arith.addf %in, %out : f32
+      linalg.yield %0 : f32
+    } -> tensor<?xf32>
+  return %0 : tensor<?xf32>
+}
+
+// The trailing scalable dim is parallel, so the reduction combines whole
+// scalable vectors.
+
+// CHECK-LABEL: func.func @vectorize_dynamic_column_reduction
+//   CHECK: %[[MASK:.*]] = vector.create_mask %{{.*}}, %{{.*}} : vector<4x[8]xi1>
+//   CHECK: vector.mask %[[MASK]] { vector.multi_reduction <add>, %{{.*}}, %{{.*}} [0] : vector<4x[8]xf32> to vector<[8]xf32> } : vector<4x[8]xi1> -> vector<[8]xf32>
+
+transform.sequence failures(propagate) {
+^bb1(%arg1: !transform.any_op):
+  %0 = transform.structured.match ops{["linalg.generic"]} in %arg1 : (!transform.any_op) -> !transform.any_op
+  transform.structured.masked_vectorize %0 vector_sizes [4, [8]] : !transform.any_op
+}
@@ -0,0 +1,151 @@
+// RUN: mlir-opt %s -split-input-file -linalg-winograd-conv2d | FileCheck %s
+// RUN: mlir-opt %s -split-input-file \
+// RUN:   -linalg-winograd-conv2d="output-tile-size=2" | \
+// RUN:   FileCheck %s --check-prefix=CHECK-F2
+
+// The 4x4 output is one tile of F(4x4, 3x3), computed from the 6x6 positions
+// of the transformed filter and input by a batched matmul over the channels.
+
+// CHECK-DAG: #[[FILTER:.*]] = affine_map<(d0, d1, d2, d3, d4, d5) -> (d4, d5, d2, d3)>
+// CHECK-DAG: #[[G0:.*]] = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d4)>
+// CHECK-DAG: #[[G1:.*]] = affine_map<(d0, d1, d2, d3, d4, d5) -> (d1, d5)>
+// CHECK-DAG: #[[INPUT:.*]] = affine_map<(d0, d1, d2, d3, d4, d5, d6, d7) -> (d2, d3 * 4 + d6, d4 * 4 + d7, d5)>
+// CHECK-DAG: #[[AT0:.*]] = affine_map<(d0, d1, d2, d3, d4, d5, d6, d7) -> (d2, d6)>
+// CHECK-DAG: #[[AT1:.*]] = affine_map<(d0, d1, d2, d3, d4, d5, d6, d7) -> (d4, d7)>
+
+// CHECK-LABEL: func @conv_2d_nhwc_hwcf(
+//  CHECK-SAME:   %[[I:.*]]: tensor<1x6x6x2xf32>, %[[F:.*]]: tensor<3x3x2x8xf32>, %[[O:.*]]: tensor<1x4x4x8xf32>
+//       CHECK:   %[[U:.*]] = linalg.generic
+//  CHECK-SAME:     indexing_maps = [#[[FILTER]], #[[G0]], #[[G1]], {{.*}}]
+//  CHECK-SAME:     ins(%[[F]], %{{.*}}, %{{.*}} : tensor<3x3x2x8xf32>, tensor<6x3xf32>, tensor<6x3xf32>)
+//  CHECK-SAME:     -> tensor<6x6x2x8xf32>
+//   CHECK-NOT:   tensor.pad
+//       CHECK:   %[[V:.*]] = linalg.generic
+//  CHECK-SAME:     indexing_maps = [#[[INPUT]], {{.*}}]
+//  CHECK-SAME:     ins(%[[I]], %{{.*}}, %{{.*}} : tensor<1x6x6x2xf32>, tensor<6x6xf32>, tensor<6x6xf32>)
+//  CHECK-SAME:     -> tensor<6x6x1x1x1x2xf32>
+//       CHECK:   %[[CV:.*]] = tensor.collapse_shape %[[V]] {{\[}}[0, 1], [2, 3, 4], [5]] : tensor<6x6x1x1x1x2xf32> into tensor<36x1x2xf32>
+//       CHECK:   %[[CU:.*]] = tensor.collapse_shape %[[U]] {{\[}}[0, 1], [2], [3]] : tensor<6x6x2x8xf32> into tensor<36x2x8xf32>
+//       CHECK:   %[[M:.*]] = linalg.batch_matmul ins(%[[CV]], %[[CU]] : tensor<36x1x2xf32>, tensor<36x2x8xf32>)
+//       CHECK:   %[[EM:.*]] = tensor.expand_shape %[[M]]
+//       CHECK:   %[[Y:.*]] = linalg.generic
+//  CHECK-SAME:     indexing_maps = [{{.*}}, #[[AT0]], #[[AT1]], {{.*}}]
+//  CHECK-SAME:     ins(%[[EM]], %{{.*}}, %{{.*}} : tensor<6x6x1x1x1x8xf32>, tensor<4x6xf32>, tensor<4x6xf32>)
+//  CHECK-SAME:     -> tensor<1x1x4x1x4x8xf32>
+//       CHECK:   %[[CY:.*]] = tensor.collapse_shape %[[Y]] {{\[}}[0], [1, 2], [3, 4], [5]] : tensor<1x1x4x1x4x8xf32> into tensor<1x4x4x8xf32>
+//   CHECK-NOT:   tensor.extract_slice
+//       CHECK:   %[[R:.*]] = linalg.generic
+//  CHECK-SAME:     ins(%[[CY]] : tensor<1x4x4x8xf32>) outs(%[[O]] : tensor<1x4x4x8xf32>)
+//       CHECK:     arith.addf
+//       CHECK:   return %[[R]]
+//
+// CHECK-F2-LABEL: func @conv_2d_nhwc_hwcf(
+//       CHECK-F2:   linalg.generic
+//  CHECK-F2-SAME:     -> tensor<4x4x2x8xf32>
+//       CHECK-F2:   linalg.generic
+//  CHECK-F2-SAME:     -> tensor<4x4x1x2x2x2xf32>
+//       CHECK-F2:   linalg.batch_matmul
+//  CHECK-F2-SAME:     -> tensor<16x4x8xf32>
+//       CHECK-F2:   linalg.generic
+//  CHECK-F2-SAME:     -> tensor<1x2x2x2x2x8xf32>
+func.func @conv_2d_nhwc_hwcf(%input: tensor<1x6x6x2xf32>,
+                             %filter: tensor<3x3x2x8xf32>,
+                             %init: tensor<1x4x4x8xf32>) -> tensor<1x4x4x8xf32> {
+  %0 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%input, %filter : tensor<1x6x6x2xf32>, tensor<3x3x2x8xf32>)
+    outs(%init : tensor<1x4x4x8xf32>) -> tensor<1x4x4x8xf32>
+  return %0 : tensor<1x4x4x8xf32>
+}
+
+// -----
+
+// The input is padded to whole tiles of the output, of which the 7x5 output
+// is sliced. The filter in the FHWC layout is indexed by its own map.
+
+// CHECK-DAG: #[[FILTER:.*]] = affine_map<(d0, d1, d2, d3, d4, d5) -> (d3, d4, d5, d2)>
+
+// CHECK-LABEL: func @conv_2d_nhwc_fhwc_padded(
+//       CHECK:   linalg.generic
+//  CHECK-SAME:     indexing_maps = [#[[FILTER]], {{.*}}]
+//  CHECK-SAME:     -> tensor<6x6x3x2xf32>
+//       CHECK:   tensor.pad %{{.*}} low[0, 0, 0, 0] high[0, 1, 3, 0]
+//       CHECK:     tensor<2x9x7x3xf32> to tensor<2x10x10x3xf32>
+//       CHECK:   linalg.generic
+//  CHECK-SAME:     -> tensor<6x6x2x2x2x3xf32>
+//       CHECK:   linalg.batch_matmul
+//  CHECK-SAME:     -> tensor<36x8x2xf32>
+//       CHECK:   tensor.collapse_shape
+//  CHECK-SAME:     into tensor<2x8x8x2xf32>
+//       CHECK:   tensor.extract_slice %{{.*}}[0, 0, 0, 0] [2, 7, 5, 2] [1, 1, 1, 1]
+func.func @conv_2d_nhwc_fhwc_padded(%input: tensor<2x9x7x3xf32>,
+                                    %filter: tensor<2x3x3x3xf32>,
+                                    %init: tensor<2x7x5x2xf32>) -> tensor<2x7x5x2xf32> {
+  %0 = linalg.conv_2d_nhwc_fhwc
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%input, %filter : tensor<2x9x7x3xf32>, tensor<2x3x3x3xf32>)
+    outs(%init : tensor<2x7x5x2xf32>) -> tensor<2x7x5x2xf32>
+  return %0 : tensor<2x7x5x2xf32>
+}
+
+// -----
+
+// A constant filter is transformed at compile time. A filter of ones is
+// transformed to the outer product of the row sums of G, which are
+// [1, 1.5, 0.5, 1] for F(2x2, 3x3).
+
+// CHECK-F2-LABEL: func @constant_filter(
+//       CHECK-F2:   %[[U:.*]] = arith.constant dense<{{\[}}{{\[}}{{\[}}[1.000000e+00]], {{\[}}[1.500000e+00]], {{\[}}[5.000000e-01]], {{\[}}[1.000000e+00]]]
+//   CHECK-F2-NOT:   linalg.generic {{.*}} ins(%{{.*}} : tensor<3x3x1x1xf32>
+//       CHECK-F2:   tensor.collapse_shape %[[U]]
+//       CHECK-F2:   linalg.batch_matmul
+func.func @constant_filter(%input: tensor<1x4x4x1xf32>,
+                           %init: tensor<1x2x2x1xf32>) -> tensor<1x2x2x1xf32> {
+  %filter = arith.constant dense<1.0> : tensor<3x3x1x1xf32>
+  %0 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%input, %filter : tensor<1x4x4x1xf32>, tensor<3x3x1x1xf32>)
+    outs(%init : tensor<1x2x2x1xf32>) -> tensor<1x2x2x1xf32>
+  return %0 : tensor<1x2x2x1xf32>
+}
+
+// -----
+
+// Strided and dilated convolutions, other filter sizes and integer
+// convolutions are not rewritten.
+
+// CHECK-LABEL: func @not_rewritten(
+//   CHECK-NOT:   linalg.batch_matmul
+//       CHECK:   linalg.conv_2d_nhwc_hwcf
+//       CHECK:   linalg.conv_2d_nhwc_hwcf
+//       CHECK:   linalg.conv_2d_nhwc_hwcf
+//       CHECK:   linalg.conv_2d_nhwc_hwcf
+func.func @not_rewritten(%input: tensor<1x9x9x2xf32>,
+                         %filter: tensor<3x3x2x4xf32>,
+                         %filter5: tensor<5x5x2x4xf32>,
+                         %iinput: tensor<1x6x6x2xi32>,
+                         %ifilter: tensor<3x3x2x4xi32>)
+    -> (tensor<1x4x4x4xf32>, tensor<1x5x5x4xf32>, tensor<1x5x5x4xf32>,
+        tensor<1x4x4x4xi32>) {
+  %init = tensor.empty() : tensor<1x4x4x4xf32>
+  %init5 = tensor.empty() : tensor<1x5x5x4xf32>
+  %iinit = tensor.empty() : tensor<1x4x4x4xi32>
+  %0 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<2> : tensor<2xi64>}
+     ins(%input, %filter : tensor<1x9x9x2xf32>, tensor<3x3x2x4xf32>)
+    outs(%init : tensor<1x4x4x4xf32>) -> tensor<1x4x4x4xf32>
+  %1 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<2> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%input, %filter : tensor<1x9x9x2xf32>, tensor<3x3x2x4xf32>)
+    outs(%init5 : tensor<1x5x5x4xf32>) -> tensor<1x5x5x4xf32>
+  %2 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%input, %filter5 : tensor<1x9x9x2xf32>, tensor<5x5x2x4xf32>)
+    outs(%init5 : tensor<1x5x5x4xf32>) -> tensor<1x5x5x4xf32>
+  %3 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%iinput, %ifilter : tensor<1x6x6x2xi32>, tensor<3x3x2x4xi32>)
+    outs(%iinit : tensor<1x4x4x4xi32>) -> tensor<1x4x4x4xi32>
+  return %0, %1, %2, %3 : tensor<1x4x4x4xf32>, tensor<1x5x5x4xf32>,
+                          tensor<1x5x5x4xf32>, tensor<1x4x4x4xi32>
+}
@@ -5,3 +5,8 @@
   value = #ml_program.extern : i32
 } : () -> ()
 
+
+// CHECK: #ml_program.external_storage<"weights.bin", offset = 128, size = 64> : tensor<16xf32>
+"unregistered.attributes"() {
+  value = #ml_program.external_storage<"weights.bin", offset = 128, size = 64> : tensor<16xf32>
+} : () -> ()
@@ -110,3 +110,11 @@ ml_program.subgraph @global_load_store_tokens() -> (tensor<?xi32>, !ml_program.t
 
   ml_program.output %0, %token3 : tensor<?xi32>, !ml_program.token
 }
+
+// -----
+// expected-error @+1 {{external storage of 32 bytes does not match the 64 bytes of 'memref<16xf32>'}}
+ml_program.global private @external_size_match(#ml_program.external_storage<"weights.bin", offset = 0, size = 32>) : memref<16xf32>
+
+// -----
+// expected-error @+1 {{external storage must have a path}}
+ml_program.global private @external_path(#ml_program.external_storage<"", offset = 0, size = 64>) : memref<16xf32>
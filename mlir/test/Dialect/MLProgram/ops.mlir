@@ -29,6 +29,9 @@ ml_program.global private mutable @global_mutable_undef : tensor<?xi32>
 // CHECK: ml_program.global private mutable @global_extern(#extern) : tensor<?xi32>
 ml_program.global private mutable @global_extern(#ml_program.extern : tensor<4xi32>) : tensor<?xi32>
 
+// CHECK: ml_program.global private @global_external_storage(#ml_program.external_storage<"weights.bin", offset = 0, size = 16> : tensor<4xi32>) : tensor<4xi32>
+ml_program.global private @global_external_storage(#ml_program.external_storage<"weights.bin", offset = 0, size = 16> : tensor<4xi32>) : tensor<4xi32>
+
 // CHECK-LABEL: @global_load_const
 ml_program.func @global_load_const() -> tensor<4xi32> {
   %0 = ml_program.global_load_const @global_same_type : tensor<4xi32>
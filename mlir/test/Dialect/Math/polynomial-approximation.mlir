@@ -802,7 +802,24 @@ func.func @math_f16(%arg0 : vector<4xf16>) -> vector<4xf16> {
   // CHECK-NOT: math.cos
   %11 = "math.cos"(%10) : (vector<4xf16>) -> vector<4xf16>
 
-  return %11 : vector<4xf16>
+  // CHECK-NOT: math.powf
+  %12 = "math.powf"(%11, %arg0) : (vector<4xf16>, vector<4xf16>) -> vector<4xf16>
+
+  return %12 : vector<4xf16>
+}
+
+// The logarithm and the exponential of the power are in turn approximated.
+// CHECK-LABEL: @powf_vector
+// CHECK-SAME:  %[[X:.*]]: vector<8xf32>, %[[Y:.*]]: vector<8xf32>
+// CHECK-NOT:   math.log
+// CHECK-NOT:   math.exp
+// CHECK:       %[[FLOOR:.*]] = math.floor %[[Y]] : vector<8xf32>
+// CHECK:       arith.cmpf oeq, %[[FLOOR]], %[[Y]] : vector<8xf32>
+// CHECK:       math.copysign %{{.*}}, %[[X]] : vector<8xf32>
+// CHECK-NOT:   math.powf
+func.func @powf_vector(%arg0: vector<8xf32>, %arg1: vector<8xf32>) -> vector<8xf32> {
+  %0 = math.powf %arg0, %arg1 : vector<8xf32>
+  return %0 : vector<8xf32>
 }
 
 
@@ -185,3 +185,59 @@ func.func @mma_sp_sync_f16_16816(%arg0: vector<2x2xf16>,
        (vector<2x2xf16>, vector<2x2xf16>, vector<2x2xf16>) -> vector<2x2xf16>
   return %d : vector<2x2xf16>
 }
+
+// -----
+
+func.func @mbarrier_global(%barriers: memref<1xi64>, %i: index) {
+  // expected-error @+1 {{'nvgpu.mbarrier.init' op expected barriers with a memory space attribute of IntegerAttr(3) or gpu::AddressSpaceAttr(Workgroup)}}
+  nvgpu.mbarrier.init %barriers[%i], %i : memref<1xi64>
+  return
+}
+
+// -----
+
+func.func @mbarrier_type(%barriers: memref<1xi32, 3>, %i: index) {
+  // expected-error @+1 {{'nvgpu.mbarrier.init' op expected barriers of type i64}}
+  nvgpu.mbarrier.init %barriers[%i], %i : memref<1xi32, 3>
+  return
+}
+
+// -----
+
+func.func @tma_async_load_rank(%tile: memref<2x2x2x2x2x2xf16, 3>, %tensorMap: i64, %barriers: memref<1xi64, 3>, %i: index) {
+  // expected-error @+1 {{'nvgpu.tma.async.load' op expected 1 to 5 coordinates, got 6}}
+  nvgpu.tma.async.load %tensorMap[%i, %i, %i, %i, %i, %i], %barriers[%i] to %tile : memref<1xi64, 3>, memref<2x2x2x2x2x2xf16, 3>
+  return
+}
+
+// -----
+
+func.func @warpgroup_descriptor_offset(%tile: memref<64x64xf16, 3>) -> i64 {
+  // expected-error @+1 {{'nvgpu.warpgroup.generate.descriptor' op expected byte offsets that are multiples of 16 smaller than 2^18, got 100}}
+  %desc = nvgpu.warpgroup.generate.descriptor %tile {leadingByteOffset = 100 : i64, strideByteOffset = 1024 : i64} : memref<64x64xf16, 3>
+  return %desc : i64
+}
+
+// -----
+
+func.func @warpgroup_descriptor_swizzle(%tile: memref<64x64xf16, 3>) -> i64 {
+  // expected-error @+1 {{'nvgpu.warpgroup.generate.descriptor' op expected a swizzle of 0, 32, 64 or 128 bytes, got 16}}
+  %desc = nvgpu.warpgroup.generate.descriptor %tile {leadingByteOffset = 128 : i64, strideByteOffset = 1024 : i64, swizzle = 16 : i64} : memref<64x64xf16, 3>
+  return %desc : i64
+}
+
+// -----
+
+func.func @warpgroup_mma_type(%desc: i64, %acc: vector<64xf32>) -> vector<64xf32> {
+  // expected-error @+1 {{'nvgpu.warpgroup.mma' op expected f16 or bf16 operands, got f32}}
+  %d = nvgpu.warpgroup.mma %desc, %desc, %acc {operandType = f32} : vector<64xf32>
+  return %d : vector<64xf32>
+}
+
+// -----
+
+func.func @warpgroup_mma_shape(%desc: i64, %acc: vector<6xf32>) -> vector<6xf32> {
+  // expected-error @+1 {{'nvgpu.warpgroup.mma' op expected N to be a multiple of 8 between 8 and 256, i.e. 4 to 128 accumulators, got 6 accumulators}}
+  %d = nvgpu.warpgroup.mma %desc, %desc, %acc {operandType = f16} : vector<6xf32>
+  return %d : vector<6xf32>
+}
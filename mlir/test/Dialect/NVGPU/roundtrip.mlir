@@ -69,3 +69,32 @@ func.func @async_cp(%dst : memref<2x7x5xf32, 3>, %src : memref<4x5xf32>){
   nvgpu.device_async_wait %token {numGroups = 1 : i32}
   return
 }
+
+// CHECK-LABEL: func @mbarrier(
+func.func @mbarrier(%barriers: memref<2xi64, 3>, %i: index, %count: index, %phase: i1) {
+  // CHECK: nvgpu.mbarrier.init %{{.*}}[%{{.*}}], %{{.*}} : memref<2xi64, 3>
+  nvgpu.mbarrier.init %barriers[%i], %count : memref<2xi64, 3>
+  // CHECK: nvgpu.mbarrier.arrive.expect_tx %{{.*}}[%{{.*}}], %{{.*}} : memref<2xi64, 3>
+  nvgpu.mbarrier.arrive.expect_tx %barriers[%i], %count : memref<2xi64, 3>
+  // CHECK: nvgpu.mbarrier.try_wait.parity %{{.*}}[%{{.*}}], %{{.*}} : memref<2xi64, 3>
+  nvgpu.mbarrier.try_wait.parity %barriers[%i], %phase : memref<2xi64, 3>
+  return
+}
+
+// CHECK-LABEL: func @warpgroup_mma(
+func.func @warpgroup_mma(%tile: memref<64x64xf16, 3>, %tensorMap: i64,
+                         %barriers: memref<1xi64, 3>, %x: index,
+                         %acc: vector<64xf32>) -> vector<64xf32> {
+  // CHECK: nvgpu.tma.async.load %{{.*}}[%{{.*}}, %{{.*}}], %{{.*}}[%{{.*}}] to %{{.*}} : memref<1xi64, 3>, memref<64x64xf16, 3>
+  nvgpu.tma.async.load %tensorMap[%x, %x], %barriers[%x] to %tile
+    : memref<1xi64, 3>, memref<64x64xf16, 3>
+  //      CHECK: nvgpu.warpgroup.generate.descriptor %{{.*}}
+  // CHECK-SAME: {leadingByteOffset = 128 : i64, strideByteOffset = 1024 : i64, swizzle = 128 : i64} : memref<64x64xf16, 3>
+  %desc = nvgpu.warpgroup.generate.descriptor %tile
+    {leadingByteOffset = 128 : i64, strideByteOffset = 1024 : i64,
+     swizzle = 128 : i64} : memref<64x64xf16, 3>
+  // CHECK: nvgpu.warpgroup.mma %{{.*}}, %{{.*}}, %{{.*}} {operandType = bf16, transposeB} : vector<64xf32>
+  %d = nvgpu.warpgroup.mma %desc, %desc, %acc {operandType = bf16, transposeB}
+    : vector<64xf32>
+  return %d : vector<64xf32>
+}
@@ -0,0 +1,93 @@
+// RUN: mlir-opt %s -scf-for-loop-pipelining -split-input-file | FileCheck %s
+
+// The load of the next iteration is issued while the reduction of the current
+// one executes.
+
+// CHECK-LABEL: func @reduction(
+//  CHECK-SAME:     %[[A:.*]]: memref<?xf32>) -> f32 {
+//   CHECK-DAG:   %[[C0:.*]] = arith.constant 0 : index
+//   CHECK-DAG:   %[[C1:.*]] = arith.constant 1 : index
+//   CHECK-DAG:   %[[C15:.*]] = arith.constant 15 : index
+//       CHECK:   %[[L0:.*]] = memref.load %[[A]][%[[C0]]] : memref<?xf32>
+//  CHECK-NEXT:   %[[R:.*]]:2 = scf.for %[[IV:.*]] = %[[C0]] to %[[C15]]
+//  CHECK-SAME:       step %[[C1]] iter_args(%[[ACC:.*]] = %{{.*}},
+//  CHECK-SAME:       %[[LARG:.*]] = %[[L0]]) -> (f32, f32) {
+//  CHECK-NEXT:     %[[ADD:.*]] = arith.addf %[[ACC]], %[[LARG]] : f32
+//  CHECK-NEXT:     %[[IV1:.*]] = arith.addi %[[IV]], %[[C1]] : index
+//  CHECK-NEXT:     %[[L:.*]] = memref.load %[[A]][%[[IV1]]] : memref<?xf32>
+//  CHECK-NEXT:     scf.yield %[[ADD]], %[[L]] : f32, f32
+//  CHECK-NEXT:   }
+//  CHECK-NEXT:   %[[SUM:.*]] = arith.addf %[[R]]#0, %[[R]]#1 : f32
+//  CHECK-NEXT:   return %[[SUM]]
+func.func @reduction(%A: memref<?xf32>) -> f32 {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c16 = arith.constant 16 : index
+  %zero = arith.constant 0.0 : f32
+  %sum = scf.for %i = %c0 to %c16 step %c1 iter_args(%acc = %zero) -> (f32) {
+    %a = memref.load %A[%i] : memref<?xf32>
+    %s = arith.addf %acc, %a : f32
+    scf.yield %s : f32
+  }
+  return %sum : f32
+}
+
+// -----
+
+// The loads do not alias the stores, and are issued one iteration ahead.
+
+// CHECK-LABEL: func @copy(
+//  CHECK-SAME:     %[[B:.*]]: memref<?xf32>) {
+//   CHECK-DAG:   %[[C0:.*]] = arith.constant 0 : index
+//   CHECK-DAG:   %[[C1:.*]] = arith.constant 1 : index
+//   CHECK-DAG:   %[[C15:.*]] = arith.constant 15 : index
+//       CHECK:   %[[A:.*]] = memref.alloc() : memref<16xf32>
+//       CHECK:   %[[L0:.*]] = memref.load %[[A]][%[[C0]]] : memref<16xf32>
+//  CHECK-NEXT:   %[[R:.*]] = scf.for %[[IV:.*]] = %[[C0]] to %[[C15]]
+//  CHECK-SAME:       step %[[C1]] iter_args(%[[LARG:.*]] = %[[L0]]) -> (f32) {
+//  CHECK-NEXT:     %[[ADD:.*]] = arith.addf %[[LARG]], %{{.*}} : f32
+//  CHECK-NEXT:     memref.store %[[ADD]], %[[B]][%[[IV]]] : memref<?xf32>
+//  CHECK-NEXT:     %[[IV1:.*]] = arith.addi %[[IV]], %[[C1]] : index
+//  CHECK-NEXT:     %[[L:.*]] = memref.load %[[A]][%[[IV1]]] : memref<16xf32>
+//  CHECK-NEXT:     scf.yield %[[L]] : f32
+//  CHECK-NEXT:   }
+//  CHECK-NEXT:   %[[ADD1:.*]] = arith.addf %[[R]], %{{.*}} : f32
+//  CHECK-NEXT:   memref.store %[[ADD1]], %[[B]][%[[C15]]] : memref<?xf32>
+func.func @copy(%B: memref<?xf32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c16 = arith.constant 16 : index
+  %cf = arith.constant 1.0 : f32
+  %A = memref.alloc() : memref<16xf32>
+  scf.for %i = %c0 to %c16 step %c1 {
+    %a = memref.load %A[%i] : memref<16xf32>
+    %b = arith.addf %a, %cf : f32
+    memref.store %b, %B[%i] : memref<?xf32>
+  }
+  memref.dealloc %A : memref<16xf32>
+  return
+}
+
+// -----
+
+// The load may read the element stored by the previous iteration, so the loop
+// is not pipelined.
+
+// CHECK-LABEL: func @may_alias(
+//       CHECK:   scf.for
+//  CHECK-NEXT:     memref.load
+//  CHECK-NEXT:     arith.addf
+//  CHECK-NEXT:     memref.store
+//  CHECK-NEXT:   }
+func.func @may_alias(%A: memref<?xf32>, %B: memref<?xf32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c16 = arith.constant 16 : index
+  %cf = arith.constant 1.0 : f32
+  scf.for %i = %c0 to %c16 step %c1 {
+    %a = memref.load %A[%i] : memref<?xf32>
+    %b = arith.addf %a, %cf : f32
+    memref.store %b, %B[%i] : memref<?xf32>
+  }
+  return
+}
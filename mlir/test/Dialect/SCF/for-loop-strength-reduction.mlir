@@ -0,0 +1,105 @@
+// RUN: mlir-opt %s -pass-pipeline='builtin.module(func.func(scf-for-loop-strength-reduction))' -split-input-file | FileCheck %s
+
+// The offset of the access, linear in the induction variable with a dynamic
+// stride, is incremented by the product of the stride and the step.
+
+// CHECK-LABEL: func @dynamic_stride(
+//  CHECK-SAME:   %[[M:.*]]: memref<?xf32>, %[[BASE:.*]]: index, %[[STRIDE:.*]]: index, %[[LB:.*]]: index, %[[UB:.*]]: index, %[[STEP:.*]]: index
+//   CHECK-DAG:   %[[INIT:.*]] = affine.apply #{{.*}}()[%[[BASE]], %[[LB]], %[[STRIDE]]]
+//   CHECK-DAG:   %[[INC:.*]] = affine.apply #{{.*}}()[%[[STRIDE]], %[[STEP]]]
+//       CHECK:   scf.for %{{.*}} = %[[LB]] to %[[UB]] step %[[STEP]] iter_args(%[[OFF:.*]] = %[[INIT]]) -> (index) {
+//   CHECK-NOT:     affine.apply
+//       CHECK:     memref.load %[[M]][%[[OFF]]]
+//       CHECK:     %[[NEXT:.*]] = arith.addi %[[OFF]], %[[INC]] : index
+//       CHECK:     scf.yield %[[NEXT]] : index
+func.func @dynamic_stride(%m: memref<?xf32>, %base: index, %stride: index,
+                          %lb: index, %ub: index, %step: index) {
+  %cst = arith.constant 1.0 : f32
+  scf.for %i = %lb to %ub step %step {
+    %off = affine.apply affine_map<()[s0, s1, s2] -> (s0 + s1 * s2)>()[%base, %i, %stride]
+    %v = memref.load %m[%off] : memref<?xf32>
+    %a = arith.addf %v, %cst : f32
+    memref.store %a, %m[%off] : memref<?xf32>
+  }
+  return
+}
+
+// -----
+
+// The computations with constant coefficients are reduced to additions of
+// constants, and the values yielded by the loop are preserved.
+
+// CHECK-LABEL: func @constant_stride(
+//   CHECK-DAG:   %[[C3:.*]] = arith.constant 3 : index
+//   CHECK-DAG:   %[[C8:.*]] = arith.constant 8 : index
+//       CHECK:   %[[R:.*]]:2 = scf.for %{{.*}} = %{{.*}} to %{{.*}} step %{{.*}} iter_args(%[[ACC:.*]] = %{{.*}}, %[[OFF:.*]] = %[[C3]]) -> (f32, index) {
+//       CHECK:     memref.load %{{.*}}[%[[OFF]]]
+//       CHECK:     %[[NEXT:.*]] = arith.addi %[[OFF]], %[[C8]] : index
+//       CHECK:     scf.yield %{{.*}}, %[[NEXT]] : f32, index
+//       CHECK:   return %[[R]]#0
+func.func @constant_stride(%m: memref<?xf32>) -> f32 {
+  %c0 = arith.constant 0 : index
+  %c2 = arith.constant 2 : index
+  %c64 = arith.constant 64 : index
+  %zero = arith.constant 0.0 : f32
+  %r = scf.for %i = %c0 to %c64 step %c2 iter_args(%acc = %zero) -> (f32) {
+    %off = affine.apply affine_map<(d0) -> (d0 * 4 + 3)>(%i)
+    %v = memref.load %m[%off] : memref<?xf32>
+    %a = arith.addf %acc, %v : f32
+    scf.yield %a : f32
+  }
+  return %r : f32
+}
+
+// -----
+
+// The offsets of the nested loops are reduced in the inner loop, and their
+// values before the inner loop in the outer loop.
+
+// CHECK-LABEL: func @nested(
+//       CHECK:   scf.for %{{.*}} iter_args(%[[OUTER:.*]] = %{{.*}}) -> (index) {
+//       CHECK:     scf.for %{{.*}} iter_args(%[[INNER:.*]] = %[[OUTER]]) -> (index) {
+//       CHECK:       memref.load %{{.*}}[%[[INNER]]]
+//       CHECK:       arith.addi %[[INNER]]
+//       CHECK:     }
+//       CHECK:     arith.addi %[[OUTER]]
+func.func @nested(%m: memref<?xf32>, %n: index, %stride: index) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %cst = arith.constant 1.0 : f32
+  scf.for %i = %c0 to %n step %c1 {
+    scf.for %j = %c0 to %n step %c1 {
+      %off = affine.apply affine_map<()[s0, s1, s2] -> (s0 * s1 + s2 * 2)>()[%i, %stride, %j]
+      %v = memref.load %m[%off] : memref<?xf32>
+      %a = arith.addf %v, %cst : f32
+      memref.store %a, %m[%off] : memref<?xf32>
+    }
+  }
+  return
+}
+
+// -----
+
+// The computations that are not linear in the induction variable, or whose
+// coefficient is one, are left untouched.
+
+// CHECK-LABEL: func @not_reduced(
+//       CHECK:   scf.for
+//   CHECK-NOT:     iter_args
+//       CHECK:     affine.apply
+//       CHECK:     affine.apply
+//       CHECK:     affine.apply
+func.func @not_reduced(%m: memref<?xf32>, %base: index, %n: index) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %cst = arith.constant 1.0 : f32
+  scf.for %i = %c0 to %n step %c1 {
+    %0 = affine.apply affine_map<(d0) -> (d0 mod 4)>(%i)
+    %1 = affine.apply affine_map<(d0)[s0] -> (d0 + s0)>(%i)[%base]
+    %2 = affine.apply affine_map<(d0) -> (d0 floordiv 2)>(%i)
+    memref.store %cst, %m[%0] : memref<?xf32>
+    memref.store %cst, %m[%1] : memref<?xf32>
+    memref.store %cst, %m[%2] : memref<?xf32>
+  }
+  return
+}
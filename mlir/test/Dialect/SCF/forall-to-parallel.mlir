@@ -0,0 +1,69 @@
+// RUN: mlir-opt %s -pass-pipeline='builtin.module(func.func(scf-forall-to-parallel))' -split-input-file | FileCheck %s
+// RUN: mlir-opt %s -pass-pipeline='builtin.module(func.func(scf-forall-to-parallel{thread-per-iteration=false}))' -split-input-file | FileCheck %s --check-prefix=NOTHREADS
+
+// CHECK-LABEL: func @num_threads
+//   CHECK-DAG:   %[[C0:.*]] = arith.constant 0 : index
+//   CHECK-DAG:   %[[C1:.*]] = arith.constant 1 : index
+//   CHECK-DAG:   %[[C8:.*]] = arith.constant 8 : index
+//       CHECK:   scf.parallel (%[[I:.*]]) = (%[[C0]]) to (%[[C8]]) step (%[[C1]]) {
+//       CHECK:     "test.payload"(%[[I]]) : (index) -> ()
+//   CHECK-NOT:     scf.forall.in_parallel
+//       CHECK:     scf.yield
+//       CHECK:   } {scf.thread_per_iteration}
+
+// NOTHREADS-LABEL: func @num_threads
+//       NOTHREADS:   scf.parallel
+//   NOTHREADS-NOT:   scf.thread_per_iteration
+func.func @num_threads() {
+  scf.forall (%i) in (8) {
+    "test.payload"(%i) : (index) -> ()
+  }
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @dynamic_bounds
+//  CHECK-SAME:   %[[LB:.*]]: index, %[[UB:.*]]: index, %[[STEP:.*]]: index
+//   CHECK-DAG:   %[[C0:.*]] = arith.constant 0 : index
+//   CHECK-DAG:   %[[C1:.*]] = arith.constant 1 : index
+//   CHECK-DAG:   %[[C4:.*]] = arith.constant 4 : index
+//       CHECK:   scf.parallel (%[[I:.*]], %[[J:.*]]) = (%[[LB]], %[[C0]]) to (%[[UB]], %[[C4]]) step (%[[STEP]], %[[C1]]) {
+//       CHECK:     "test.payload"(%[[I]], %[[J]]) : (index, index) -> ()
+//       CHECK:   } {scf.thread_per_iteration}
+func.func @dynamic_bounds(%lb: index, %ub: index, %step: index) {
+  scf.forall (%i, %j) = (%lb, 0) to (%ub, 4) step (%step, 1) {
+    "test.payload"(%i, %j) : (index, index) -> ()
+  }
+  return
+}
+
+// -----
+
+// The loops with a mapping or with shared outputs are not converted.
+
+// CHECK-LABEL: func @mapping
+//       CHECK:   scf.forall
+//   CHECK-NOT:   scf.parallel
+func.func @mapping() {
+  scf.forall (%i) in (8) {
+    "test.payload"(%i) : (index) -> ()
+  } {mapping = [#gpu.thread<x>]}
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @shared_outputs
+//       CHECK:   scf.forall
+//   CHECK-NOT:   scf.parallel
+func.func @shared_outputs(%t: tensor<8xf32>) -> tensor<8xf32> {
+  %0 = scf.forall (%i) in (8) shared_outs(%o = %t) -> (tensor<8xf32>) {
+    %s = "test.payload"(%i) : (index) -> (tensor<1xf32>)
+    scf.forall.in_parallel {
+      tensor.parallel_insert_slice %s into %o[%i] [1] [1]
+          : tensor<1xf32> into tensor<8xf32>
+    }
+  }
+  return %0 : tensor<8xf32>
+}
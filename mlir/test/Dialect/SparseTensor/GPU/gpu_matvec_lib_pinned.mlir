@@ -0,0 +1,31 @@
+// RUN: mlir-opt %s --linalg-generalize-named-ops \
+// RUN:   --sparsification="enable-gpu-libgen gpu-data-transfer-strategy=pinned-dma" \
+// RUN:   | FileCheck %s
+
+#CSR = #sparse_tensor.encoding<{ lvlTypes = [ "dense", "compressed" ] }>
+
+// The host buffers are pinned before their copies, and the library calls
+// wait for the copies on the device rather than on the host.
+//
+// CHECK-LABEL:   func.func @matvec(
+// CHECK:           %[[P:.*]] = memref.cast %{{.*}} : memref<?xindex{{.*}}> to memref<*xindex>
+// CHECK:           gpu.host_register %[[P]] : memref<*xindex>
+// CHECK:           %[[T0:.*]] = gpu.memcpy async
+// CHECK-COUNT-4:   gpu.host_register
+// CHECK:           %[[T4:.*]] = gpu.memcpy async
+// CHECK-NOT:       gpu.wait [
+// CHECK:           %[[W:.*]] = gpu.wait async {{\[}}%[[T0]], %{{.*}}, %{{.*}}, %{{.*}}, %[[T4]]]
+// CHECK:           gpu.create_csr async {{\[}}%[[W]]]
+// CHECK:           gpu.spmv async
+// CHECK:           gpu.wait {{\[}}%{{.*}}]
+// CHECK:           gpu.host_unregister %[[P]] : memref<*xindex>
+// CHECK-COUNT-4:   gpu.host_unregister
+// CHECK:           bufferization.to_tensor
+func.func @matvec(%A: tensor<?x?xf64, #CSR>,
+                  %x: tensor<?xf64>,
+                  %y_in: tensor<?xf64>) -> tensor<?xf64> {
+  %y_out = linalg.matvec
+    ins(%A, %x: tensor<?x?xf64, #CSR>, tensor<?xf64>)
+    outs(%y_in: tensor<?xf64>) -> tensor<?xf64>
+  return %y_out : tensor<?xf64>
+}
@@ -0,0 +1,76 @@
+// RUN: mlir-opt %s --linalg-generalize-named-ops \
+// RUN:             --pre-sparsification-rewrite \
+// RUN:             --sparsification="parallelization-strategy=dense-outer-loop" \
+// RUN:             --sparse-gpu-codegen="row-mapping=warp-per-row" | \
+// RUN:   FileCheck %s --check-prefix=CHECK-WARP
+// RUN: mlir-opt %s --linalg-generalize-named-ops \
+// RUN:             --pre-sparsification-rewrite \
+// RUN:             --sparsification="parallelization-strategy=dense-outer-loop" \
+// RUN:             --sparse-gpu-codegen="row-mapping=merge-path" | \
+// RUN:   FileCheck %s --check-prefix=CHECK-MERGE
+// RUN: mlir-opt %s --linalg-generalize-named-ops \
+// RUN:             --pre-sparsification-rewrite \
+// RUN:             --sparsification="parallelization-strategy=dense-outer-loop" \
+// RUN:             --sparse-gpu-codegen="num_threads=48 row-mapping=warp-per-row" | \
+// RUN:   FileCheck %s --check-prefix=CHECK-FALLBACK
+
+#CSR = #sparse_tensor.encoding<{ lvlTypes = [ "dense", "compressed" ] }>
+
+//
+// Compute matrix vector y = Ax with a warp per row, where the lanes split
+// the row, sum their partial results with a butterfly of shuffles, and
+// the first lane stores the total.
+//
+// CHECK-WARP-LABEL: gpu.func @kernel0(
+// CHECK-WARP:         %[[W:.*]] = arith.constant 32 : index
+// CHECK-WARP:         %[[LANE:.*]] = arith.remui %{{.*}}, %[[W]] : index
+// CHECK-WARP:         %[[WARP:.*]] = arith.divui %{{.*}}, %[[W]] : index
+// CHECK-WARP:         %[[INC:.*]] = arith.divui %{{.*}}, %[[W]] : index
+// CHECK-WARP:         scf.for %[[R:.*]] = %[[WARP]] to %{{.*}} step %[[INC]] {
+// CHECK-WARP:           %[[FIRST:.*]] = arith.cmpi eq, %[[LANE]], %{{.*}} : index
+// CHECK-WARP:           %[[Y:.*]] = memref.load %{{.*}}{{\[}}%[[R]]] : memref<?xf64>
+// CHECK-WARP:           %[[ZERO:.*]] = arith.constant 0.000000e+00 : f64
+// CHECK-WARP:           %[[LO:.*]] = arith.addi %{{.*}}, %[[LANE]] : index
+// CHECK-WARP:           %[[S:.*]] = scf.for %{{.*}} = %[[LO]] to %{{.*}} step %{{.*}} iter_args(%{{.*}} = %[[ZERO]]) -> (f64) {
+// CHECK-WARP:           }
+// CHECK-WARP:           gpu.shuffle xor %[[S]]
+// CHECK-WARP-COUNT-4:   gpu.shuffle xor
+// CHECK-WARP:           %[[T:.*]] = arith.addf %[[Y]], %{{.*}} : f64
+// CHECK-WARP:           scf.if %[[FIRST]] {
+// CHECK-WARP:             memref.store %[[T]], %{{.*}}{{\[}}%[[R]]] : memref<?xf64>
+// CHECK-WARP:           }
+// CHECK-WARP:         }
+// CHECK-WARP:         gpu.return
+//
+// Compute matrix vector y = Ax with each thread assigned the run of rows
+// that start within its even share of the nonzeros, as found by a binary
+// search over the row positions.
+//
+// CHECK-MERGE-LABEL: gpu.func @kernel0(
+// CHECK-MERGE:         %[[NNZ:.*]] = memref.load %[[POS:.*]]{{\[}}%{{.*}}] : memref<?xindex>
+// CHECK-MERGE:         %[[START:.*]]:2 = scf.while
+// CHECK-MERGE:           arith.cmpi ult
+// CHECK-MERGE:           scf.condition
+// CHECK-MERGE:         } do {
+// CHECK-MERGE:           arith.shrui
+// CHECK-MERGE:           memref.load %[[POS]]
+// CHECK-MERGE:         }
+// CHECK-MERGE:         %[[END:.*]]:2 = scf.while
+// CHECK-MERGE:         %[[UPPER:.*]] = arith.select %{{.*}}, %{{.*}}, %[[END]]#0 : index
+// CHECK-MERGE:         scf.for %{{.*}} = %[[START]]#0 to %[[UPPER]] step %{{.*}} {
+// CHECK-MERGE-NOT:       gpu.shuffle
+// CHECK-MERGE:         gpu.return
+//
+// A block size that is not a multiple of the warp size falls back to
+// a thread per row.
+//
+// CHECK-FALLBACK-LABEL: gpu.func @kernel0(
+// CHECK-FALLBACK-NOT:     gpu.shuffle
+// CHECK-FALLBACK:         gpu.return
+//
+func.func @matvec(%A: tensor<?x?xf64, #CSR>, %x: tensor<?xf64>, %y_in: tensor<?xf64>) -> tensor<?xf64> {
+  %y_out = linalg.matvec
+      ins(%A, %x: tensor<?x?xf64, #CSR>, tensor<?xf64>)
+      outs(%y_in: tensor<?xf64>) -> tensor<?xf64>
+  return %y_out : tensor<?xf64>
+}
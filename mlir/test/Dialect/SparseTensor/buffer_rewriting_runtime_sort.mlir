@@ -0,0 +1,81 @@
+// RUN: mlir-opt %s --sparse-buffer-rewrite="enable-runtime-sort=true" | FileCheck %s
+
+// CHECK-DAG: func.func private @radixSortU64(index, memref<?xi64>) attributes {llvm.emit_c_interface}
+// CHECK-DAG: func.func private @radixSortIndex(index, memref<?xindex>) attributes {llvm.emit_c_interface}
+// CHECK-DAG: func.func private @sortCOOF32(index, index, index, memref<?xindex>, memref<?xf32>) attributes {llvm.emit_c_interface}
+// CHECK-DAG: func.func private @sortCOOF64(index, index, index, memref<?xindex>, memref<?xf64>) attributes {llvm.emit_c_interface}
+// CHECK-DAG: func.func private @sortCOO(index, index, index, memref<?xindex>) attributes {llvm.emit_c_interface}
+
+// CHECK-LABEL: func.func @sparse_sort_1d0v_i64(
+//  CHECK-SAME: %[[N:.*]]: index,
+//  CHECK-SAME: %[[X:.*]]: memref<10xi64>)
+//       CHECK: %[[DX:.*]] = memref.cast %[[X]] : memref<10xi64> to memref<?xi64>
+//       CHECK: call @radixSortU64(%[[N]], %[[DX]]) : (index, memref<?xi64>) -> ()
+func.func @sparse_sort_1d0v_i64(%arg0: index, %arg1: memref<10xi64>) -> memref<10xi64> {
+  sparse_tensor.sort hybrid_quick_sort %arg0, %arg1 : memref<10xi64>
+  return %arg1 : memref<10xi64>
+}
+
+// CHECK-LABEL: func.func @sparse_sort_1d0v_index(
+//  CHECK-SAME: %[[N:.*]]: index,
+//  CHECK-SAME: %[[X:.*]]: memref<?xindex>)
+//       CHECK: call @radixSortIndex(%[[N]], %[[X]]) : (index, memref<?xindex>) -> ()
+func.func @sparse_sort_1d0v_index(%arg0: index, %arg1: memref<?xindex>) -> memref<?xindex> {
+  sparse_tensor.sort insertion_sort_stable %arg0, %arg1 : memref<?xindex>
+  return %arg1 : memref<?xindex>
+}
+
+// CHECK-LABEL: func.func @sparse_sort_1d1v(
+//  CHECK-SAME: %[[N:.*]]: index,
+//  CHECK-SAME: %[[X:.*]]: memref<?xindex>,
+//  CHECK-SAME: %[[Y:.*]]: memref<?xf32>)
+//   CHECK-DAG: %[[C0:.*]] = arith.constant 0 : index
+//   CHECK-DAG: %[[C1:.*]] = arith.constant 1 : index
+//       CHECK: call @sortCOOF32(%[[N]], %[[C1]], %[[C0]], %[[X]], %[[Y]])
+func.func @sparse_sort_1d1v(%arg0: index, %arg1: memref<?xindex>, %arg2: memref<?xf32>) -> (memref<?xindex>, memref<?xf32>) {
+  sparse_tensor.sort quick_sort %arg0, %arg1 jointly %arg2 : memref<?xindex> jointly memref<?xf32>
+  return %arg1, %arg2 : memref<?xindex>, memref<?xf32>
+}
+
+// The runtime library has no sort of multiple buffers of keys.
+// CHECK-LABEL: func.func @sparse_sort_2d0v(
+//   CHECK-NOT: radixSort
+//   CHECK-NOT: sortCOO
+//       CHECK: call @_sparse_qsort_2_index
+func.func @sparse_sort_2d0v(%arg0: index, %arg1: memref<?xindex>, %arg2: memref<?xindex>) -> (memref<?xindex>, memref<?xindex>) {
+  sparse_tensor.sort quick_sort %arg0, %arg1, %arg2 : memref<?xindex>, memref<?xindex>
+  return %arg1, %arg2 : memref<?xindex>, memref<?xindex>
+}
+
+// CHECK-LABEL: func.func @sparse_sort_coo(
+//  CHECK-SAME: %[[N:.*]]: index,
+//  CHECK-SAME: %[[XY:.*]]: memref<100xindex>,
+//  CHECK-SAME: %[[Y:.*]]: memref<?xf64>)
+//   CHECK-DAG: %[[C1:.*]] = arith.constant 1 : index
+//   CHECK-DAG: %[[C2:.*]] = arith.constant 2 : index
+//       CHECK: %[[DXY:.*]] = memref.cast %[[XY]] : memref<100xindex> to memref<?xindex>
+//       CHECK: call @sortCOOF64(%[[N]], %[[C2]], %[[C1]], %[[DXY]], %[[Y]])
+func.func @sparse_sort_coo(%arg0: index, %arg1: memref<100xindex>, %arg2: memref<?xf64>) -> (memref<100xindex>, memref<?xf64>) {
+  sparse_tensor.sort_coo hybrid_quick_sort %arg0, %arg1 jointly %arg2 {nx = 2 : index, ny = 1 : index} : memref<100xindex> jointly memref<?xf64>
+  return %arg1, %arg2 : memref<100xindex>, memref<?xf64>
+}
+
+// CHECK-LABEL: func.func @sparse_sort_coo_novalues(
+//  CHECK-SAME: %[[N:.*]]: index,
+//  CHECK-SAME: %[[XY:.*]]: memref<?xindex>)
+//   CHECK-DAG: %[[C0:.*]] = arith.constant 0 : index
+//   CHECK-DAG: %[[C2:.*]] = arith.constant 2 : index
+//       CHECK: call @sortCOO(%[[N]], %[[C2]], %[[C0]], %[[XY]])
+func.func @sparse_sort_coo_novalues(%arg0: index, %arg1: memref<?xindex>) -> memref<?xindex> {
+  sparse_tensor.sort_coo heap_sort %arg0, %arg1 {nx = 2 : index} : memref<?xindex>
+  return %arg1 : memref<?xindex>
+}
+
+// The runtime library has no sort of records with keys of type i32.
+// CHECK-LABEL: func.func @sparse_sort_coo_i32(
+//   CHECK-NOT: sortCOO
+//       CHECK: call @_sparse_hybrid_qsort_2_i32_coo_1
+func.func @sparse_sort_coo_i32(%arg0: index, %arg1: memref<?xi32>) -> memref<?xi32> {
+  sparse_tensor.sort_coo hybrid_quick_sort %arg0, %arg1 {nx = 2 : index, ny = 1 : index} : memref<?xi32>
+  return %arg1 : memref<?xi32>
+}
@@ -30,6 +30,11 @@
   dimToLvl = affine_map<(i,j,k) -> (k,i,j)>
 }>
 
+#BSR = #sparse_tensor.encoding<{
+  lvlTypes = ["compressed", "compressed", "dense", "dense"],
+  dimToLvl = affine_map<(i,j) -> (i floordiv 2, j floordiv 3, i mod 2, j mod 3)>
+}>
+
 // CHECK-LABEL: func @sparse_nop(
 //  CHECK-SAME: %[[A:.*]]: !llvm.ptr<i8>) -> !llvm.ptr<i8>
 //       CHECK: return %[[A]] : !llvm.ptr<i8>
@@ -132,6 +137,58 @@ func.func @sparse_new3d(%arg0: !llvm.ptr<i8>) -> tensor<?x?x?xf32, #SparseTensor
   return %0 : tensor<?x?x?xf32, #SparseTensor>
 }
 
+// CHECK-LABEL: func @sparse_new_bsr(
+//  CHECK-SAME: %[[A:.*]]: !llvm.ptr<i8>) -> !llvm.ptr<i8>
+//   CHECK-DAG: %[[C0:.*]] = arith.constant 0 : index
+//   CHECK-DAG: %[[C1:.*]] = arith.constant 1 : index
+//   CHECK-DAG: %[[C2:.*]] = arith.constant 2 : index
+//   CHECK-DAG: %[[C3:.*]] = arith.constant 3 : index
+//   CHECK-DAG: %[[C5:.*]] = arith.constant 5 : index
+//   CHECK-DAG: %[[C20:.*]] = arith.constant 20 : index
+//       CHECK: %[[Reader:.*]] = call @createCheckedSparseTensorReader(%[[A]], %{{.*}}, %{{.*}})
+//   CHECK-DAG: memref.store %[[C5]], %[[LvlSizes0:.*]][%[[C0]]] : memref<4xindex>
+//   CHECK-DAG: memref.store %[[C20]], %[[LvlSizes0]][%[[C1]]] : memref<4xindex>
+//   CHECK-DAG: memref.store %[[C2]], %[[LvlSizes0]][%[[C2]]] : memref<4xindex>
+//   CHECK-DAG: memref.store %[[C3]], %[[LvlSizes0]][%[[C3]]] : memref<4xindex>
+//   CHECK-DAG: memref.store %[[C0]], %[[Lvl2Dim0:.*]][%[[C0]]] : memref<4xindex>
+//   CHECK-DAG: memref.store %[[C1]], %[[Lvl2Dim0]][%[[C1]]] : memref<4xindex>
+//   CHECK-DAG: memref.store %[[C0]], %[[Lvl2Dim0]][%[[C2]]] : memref<4xindex>
+//   CHECK-DAG: memref.store %[[C1]], %[[Lvl2Dim0]][%[[C3]]] : memref<4xindex>
+//   CHECK-DAG: memref.store %[[C0]], %[[Dim2Lvl0:.*]][%[[C0]]] : memref<2xindex>
+//   CHECK-DAG: memref.store %[[C1]], %[[Dim2Lvl0]][%[[C1]]] : memref<2xindex>
+//   CHECK-DAG: %[[LvlSizes:.*]] = memref.cast %[[LvlSizes0]] : memref<4xindex> to memref<?xindex>
+//   CHECK-DAG: %[[Lvl2Dim:.*]] = memref.cast %[[Lvl2Dim0]] : memref<4xindex> to memref<?xindex>
+//   CHECK-DAG: %[[Dim2Lvl:.*]] = memref.cast %[[Dim2Lvl0]] : memref<2xindex> to memref<?xindex>
+//       CHECK: %[[T:.*]] = call @newSparseTensorFromReader(%[[Reader]], %[[LvlSizes]], %{{.*}}, %[[Lvl2Dim]], %[[Dim2Lvl]], %{{.*}}, %{{.*}}, %{{.*}})
+//       CHECK: call @delSparseTensorReader(%[[Reader]])
+//       CHECK: return %[[T]] : !llvm.ptr<i8>
+func.func @sparse_new_bsr(%arg0: !llvm.ptr<i8>) -> tensor<10x60xf64, #BSR> {
+  %0 = sparse_tensor.new %arg0 : !llvm.ptr<i8> to tensor<10x60xf64, #BSR>
+  return %0 : tensor<10x60xf64, #BSR>
+}
+
+// CHECK-LABEL: func @sparse_new_bsr_dynamic(
+//  CHECK-SAME: %[[A:.*]]: !llvm.ptr<i8>) -> !llvm.ptr<i8>
+//   CHECK-DAG: %[[C0:.*]] = arith.constant 0 : index
+//   CHECK-DAG: %[[C1:.*]] = arith.constant 1 : index
+//   CHECK-DAG: %[[C2:.*]] = arith.constant 2 : index
+//   CHECK-DAG: %[[C3:.*]] = arith.constant 3 : index
+//       CHECK: %[[Reader:.*]] = call @createCheckedSparseTensorReader(%[[A]], %{{.*}}, %{{.*}})
+//       CHECK: %[[DimSizes:.*]] = call @getSparseTensorReaderDimSizes(%[[Reader]])
+//   CHECK-DAG: %[[I:.*]] = memref.load %[[DimSizes]][%[[C0]]] : memref<?xindex>
+//   CHECK-DAG: %[[J:.*]] = memref.load %[[DimSizes]][%[[C1]]] : memref<?xindex>
+//   CHECK-DAG: %[[IB:.*]] = arith.ceildivui %[[I]], %[[C2]] : index
+//   CHECK-DAG: %[[JB:.*]] = arith.ceildivui %[[J]], %[[C3]] : index
+//   CHECK-DAG: memref.store %[[IB]], %[[LvlSizes0:.*]][%[[C0]]] : memref<4xindex>
+//   CHECK-DAG: memref.store %[[JB]], %[[LvlSizes0]][%[[C1]]] : memref<4xindex>
+//   CHECK-DAG: memref.store %[[C2]], %[[LvlSizes0]][%[[C2]]] : memref<4xindex>
+//   CHECK-DAG: memref.store %[[C3]], %[[LvlSizes0]][%[[C3]]] : memref<4xindex>
+//       CHECK: call @newSparseTensorFromReader
+func.func @sparse_new_bsr_dynamic(%arg0: !llvm.ptr<i8>) -> tensor<?x?xf64, #BSR> {
+  %0 = sparse_tensor.new %arg0 : !llvm.ptr<i8> to tensor<?x?xf64, #BSR>
+  return %0 : tensor<?x?xf64, #BSR>
+}
+
 // CHECK-LABEL: func @sparse_init(
 //  CHECK-SAME: %[[I:.*]]: index,
 //  CHECK-SAME: %[[J:.*]]: index) -> !llvm.ptr<i8>
@@ -157,6 +214,17 @@ func.func @sparse_init(%arg0: index, %arg1: index) -> tensor<?x?xf64, #CSR> {
   return %1 : tensor<?x?xf64, #CSR>
 }
 
+// CHECK-LABEL: func @sparse_init_hint(
+//  CHECK-SAME: %[[I:.*]]: index, %[[J:.*]]: index, %[[H:.*]]: index)
+//       CHECK: %[[T:.*]] = call @newSparseTensor(
+//       CHECK: call @reserveSparseTensor(%[[T]], %[[H]]) : (!llvm.ptr<i8>, index) -> ()
+//       CHECK: return %[[T]] : !llvm.ptr<i8>
+func.func @sparse_init_hint(%arg0: index, %arg1: index, %arg2: index) -> tensor<?x?xf64, #CSR> {
+  %0 = bufferization.alloc_tensor(%arg0, %arg1) size_hint=%arg2 : tensor<?x?xf64, #CSR>
+  %1 = sparse_tensor.load %0 : tensor<?x?xf64, #CSR>
+  return %1 : tensor<?x?xf64, #CSR>
+}
+
 // CHECK-LABEL: func @sparse_release(
 //  CHECK-SAME: %[[A:.*]]: !llvm.ptr<i8>)
 //       CHECK: call @delSparseTensor(%[[A]]) : (!llvm.ptr<i8>) -> ()
@@ -441,3 +509,28 @@ func.func @sparse_and_dense_init(%arg0: index, %arg1: index)
   %2 = bufferization.alloc_tensor(%arg0, %arg1) : tensor<?x?xf64>
   return %1, %2 : tensor<?x?xf64, #CSR>, tensor<?x?xf64>
 }
+
+// CHECK-LABEL: func @sparse_pack(
+//  CHECK-SAME: %[[V:.*]]: tensor<6xf64>, %[[P:.*]]: tensor<3xindex>, %[[C:.*]]: tensor<6xindex>)
+//   CHECK-DAG: %[[Pack:.*]] = arith.constant 7 : i32
+//   CHECK-DAG: %[[PM:.*]] = bufferization.to_memref %[[P]] : memref<3xindex>
+//   CHECK-DAG: %[[PI:.*]] = memref.extract_aligned_pointer_as_index %[[PM]] : memref<3xindex> -> index
+//   CHECK-DAG: %[[CM:.*]] = bufferization.to_memref %[[C]] : memref<6xindex>
+//   CHECK-DAG: %[[CI:.*]] = memref.extract_aligned_pointer_as_index %[[CM]] : memref<6xindex> -> index
+//   CHECK-DAG: %[[VM:.*]] = bufferization.to_memref %[[V]] : memref<6xf64>
+//   CHECK-DAG: %[[VI:.*]] = memref.extract_aligned_pointer_as_index %[[VM]] : memref<6xf64> -> index
+//       CHECK: memref.alloca() : memref<3xindex>
+//       CHECK: memref.store %[[PI]], %{{.*}}[%{{.*}}]
+//       CHECK: memref.store %[[CI]], %{{.*}}[%{{.*}}]
+//       CHECK: memref.store %[[VI]], %{{.*}}[%{{.*}}]
+//       CHECK: %[[BI:.*]] = memref.extract_aligned_pointer_as_index %{{.*}} : memref<{{.*}}xindex> -> index
+//       CHECK: %[[BI64:.*]] = arith.index_cast %[[BI]] : index to i64
+//       CHECK: %[[BP:.*]] = llvm.inttoptr %[[BI64]] : i64 to !llvm.ptr<i8>
+//       CHECK: %[[T:.*]] = call @newSparseTensor(%{{.*}}, %{{.*}}, %{{.*}}, %{{.*}}, %{{.*}}, %{{.*}}, %{{.*}}, %{{.*}}, %[[Pack]], %[[BP]])
+//       CHECK: return %[[T]] : !llvm.ptr<i8>
+func.func @sparse_pack(%values: tensor<6xf64>, %pos: tensor<3xindex>, %crd: tensor<6xindex>)
+           -> tensor<2x10xf64, #CSR> {
+  %0 = sparse_tensor.pack %values, %pos, %crd
+     : tensor<6xf64>, tensor<3xindex>, tensor<6xindex> to tensor<2x10xf64, #CSR>
+  return %0 : tensor<2x10xf64, #CSR>
+}
@@ -0,0 +1,93 @@
+// RUN: mlir-opt %s --sparse-encoding-advisor --split-input-file --verify-diagnostics
+
+#CSR = #sparse_tensor.encoding<{ lvlTypes = [ "dense", "compressed" ] }>
+
+#trait = {
+  indexing_maps = [
+    affine_map<(i,j) -> (i,j)>,  // A
+    affine_map<(i,j) -> (i,j)>   // X (out)
+  ],
+  iterator_types = ["parallel", "parallel"]
+}
+
+// Most rows of the output are empty, which DCSR does not store.
+func.func @hypersparse(%arga: tensor<1000x1000xf64, #CSR>,
+                       %argx: tensor<1000x1000xf64, #CSR>) -> tensor<1000x1000xf64, #CSR> {
+  // expected-remark@+1 {{the estimated density of the output suggests the encoding #sparse_tensor.encoding<{ lvlTypes = [ "compressed", "compressed" ] }>}}
+  %0 = linalg.generic #trait
+    ins(%arga: tensor<1000x1000xf64, #CSR>)
+    outs(%argx: tensor<1000x1000xf64, #CSR>)
+    attrs = {sparse_tensor.density = [1.0e-5, 1.0e-5]} {
+      ^bb(%a: f64, %x: f64):
+        %1 = arith.mulf %a, %a : f64
+        linalg.yield %1 : f64
+  } -> tensor<1000x1000xf64, #CSR>
+  return %0 : tensor<1000x1000xf64, #CSR>
+}
+
+// -----
+
+#CSR = #sparse_tensor.encoding<{ lvlTypes = [ "dense", "compressed" ] }>
+
+#trait = {
+  indexing_maps = [
+    affine_map<(i,j) -> (i,j)>,  // A
+    affine_map<(i,j) -> (i,j)>   // X (out)
+  ],
+  iterator_types = ["parallel", "parallel"]
+}
+
+// Most rows of the output are nonempty, so CSR is kept, and so is the
+// encoding of the kernels without densities.
+func.func @sparse(%arga: tensor<1000x1000xf64, #CSR>,
+                  %argx: tensor<1000x1000xf64, #CSR>) -> tensor<1000x1000xf64, #CSR> {
+  %0 = linalg.generic #trait
+    ins(%arga: tensor<1000x1000xf64, #CSR>)
+    outs(%argx: tensor<1000x1000xf64, #CSR>)
+    attrs = {sparse_tensor.density = [1.0e-2, 1.0e-2]} {
+      ^bb(%a: f64, %x: f64):
+        %1 = arith.mulf %a, %a : f64
+        linalg.yield %1 : f64
+  } -> tensor<1000x1000xf64, #CSR>
+  %2 = linalg.generic #trait
+    ins(%0: tensor<1000x1000xf64, #CSR>)
+    outs(%argx: tensor<1000x1000xf64, #CSR>) {
+      ^bb(%a: f64, %x: f64):
+        %3 = arith.mulf %a, %a : f64
+        linalg.yield %3 : f64
+  } -> tensor<1000x1000xf64, #CSR>
+  return %2 : tensor<1000x1000xf64, #CSR>
+}
+
+// -----
+
+#DCSC = #sparse_tensor.encoding<{
+  lvlTypes = [ "compressed", "compressed" ],
+  dimToLvl = affine_map<(i,j) -> (j,i)>,
+  posWidth = 32,
+  crdWidth = 32
+}>
+
+#trait = {
+  indexing_maps = [
+    affine_map<(i,j) -> (i,j)>,  // A
+    affine_map<(i,j) -> (i,j)>   // X (out)
+  ],
+  iterator_types = ["parallel", "parallel"]
+}
+
+// Most columns of the output are nonempty, so CSC is suggested, with the
+// same mapping and bitwidths.
+func.func @sparse_columns(%arga: tensor<100x?xf64, #DCSC>,
+                          %argx: tensor<100x?xf64, #DCSC>) -> tensor<100x?xf64, #DCSC> {
+  // expected-remark@+1 {{the estimated density of the output suggests the encoding #sparse_tensor.encoding<{ lvlTypes = [ "dense", "compressed" ], dimToLvl = affine_map<(d0, d1) -> (d1, d0)>, posWidth = 32, crdWidth = 32 }>}}
+  %0 = linalg.generic #trait
+    ins(%arga: tensor<100x?xf64, #DCSC>)
+    outs(%argx: tensor<100x?xf64, #DCSC>)
+    attrs = {sparse_tensor.density = [1.0e-1, 1.0e-1]} {
+      ^bb(%a: f64, %x: f64):
+        %1 = arith.mulf %a, %a : f64
+        linalg.yield %1 : f64
+  } -> tensor<100x?xf64, #DCSC>
+  return %0 : tensor<100x?xf64, #DCSC>
+}
@@ -0,0 +1,68 @@
+// RUN: mlir-opt %s --sparsification="enable-galloping=true" | FileCheck %s
+// RUN: mlir-opt %s --sparsification | FileCheck %s --check-prefix=CHECK-OFF
+
+#SV = #sparse_tensor.encoding<{ lvlTypes = [ "compressed" ] }>
+
+#trait2 = {
+  indexing_maps = [
+    affine_map<(i) -> (i)>,  // a
+    affine_map<(i) -> (i)>,  // b
+    affine_map<(i) -> (i)>   // x (out)
+  ],
+  iterator_types = ["parallel"],
+  doc = "x(i) = a(i) OP b(i)"
+}
+
+// The intersection forwards each lagging level with a galloping search
+// (doubling the step, and then bisecting) to the maximum coordinate.
+//
+// CHECK-LABEL:   func @mul_ss(
+// CHECK:           scf.while
+// CHECK:             scf.condition
+// CHECK:           } do {
+// CHECK:             %[[GT:.*]] = arith.cmpi ugt
+// CHECK:             %[[MAX:.*]] = arith.select %[[GT]]
+// CHECK:             %[[BEHIND:.*]] = arith.cmpi ult, %{{.*}}, %[[MAX]] : index
+// CHECK:             scf.if %[[BEHIND]] -> (index) {
+// CHECK:               scf.while
+// CHECK:               arith.minui
+// CHECK:               scf.while
+// CHECK:                 arith.shrui
+// CHECK:             } else {
+// CHECK:             scf.yield
+// CHECK:           }
+//
+// CHECK-OFF-LABEL: func @mul_ss(
+// CHECK-OFF-NOT:     arith.shrui
+// CHECK-OFF:         return
+func.func @mul_ss(%arga: tensor<32xf32, #SV>,
+                  %argb: tensor<32xf32, #SV>,
+                  %argx: tensor<32xf32>) -> tensor<32xf32> {
+  %0 = linalg.generic #trait2
+     ins(%arga, %argb: tensor<32xf32, #SV>, tensor<32xf32, #SV>)
+    outs(%argx: tensor<32xf32>) {
+      ^bb(%a: f32, %b: f32, %x: f32):
+        %0 = arith.mulf %a, %b : f32
+        linalg.yield %0 : f32
+  } -> tensor<32xf32>
+  return %0 : tensor<32xf32>
+}
+
+// The union must visit every coordinate of either level, and so it keeps
+// advancing one position at a time.
+//
+// CHECK-LABEL:   func @add_ss(
+// CHECK-NOT:       arith.shrui
+// CHECK:           return
+func.func @add_ss(%arga: tensor<32xf32, #SV>,
+                  %argb: tensor<32xf32, #SV>,
+                  %argx: tensor<32xf32>) -> tensor<32xf32> {
+  %0 = linalg.generic #trait2
+     ins(%arga, %argb: tensor<32xf32, #SV>, tensor<32xf32, #SV>)
+    outs(%argx: tensor<32xf32>) {
+      ^bb(%a: f32, %b: f32, %x: f32):
+        %0 = arith.addf %a, %b : f32
+        linalg.yield %0 : f32
+  } -> tensor<32xf32>
+  return %0 : tensor<32xf32>
+}
@@ -0,0 +1,49 @@
+// RUN: mlir-opt %s --sparsification | FileCheck %s
+// RUN: mlir-opt %s --sparsification="loop-ordering-strategy=cost-model" | \
+// RUN:   FileCheck %s --check-prefix=CHECK-COST
+
+#SV = #sparse_tensor.encoding<{ lvlTypes = [ "compressed" ] }>
+
+#trait = {
+  indexing_maps = [
+    affine_map<(i,j) -> (i)>,  // a
+    affine_map<(i,j) -> (j)>,  // b
+    affine_map<(i,j) -> ()>    // x (out)
+  ],
+  iterator_types = ["reduction", "reduction"],
+  doc = "x += a(i) * b(j)"
+}
+
+// Both loop orders are admissible. The default order iterates over `b` in
+// the outer loop, while the cost model picks the sparser `a`, which has one
+// estimated nonzero against 500 for `b`, for the outer loop.
+//
+// CHECK-LABEL:   func.func @sum_outer(
+// CHECK-DAG:       %[[AV:.*]] = sparse_tensor.values %arg0
+// CHECK-DAG:       %[[BV:.*]] = sparse_tensor.values %arg1
+// CHECK:           scf.for %[[J:.*]] = %{{.*}} to %{{.*}} step %{{.*}}
+// CHECK:             memref.load %[[BV]][%[[J]]] : memref<?xf64>
+// CHECK:             scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %{{.*}}
+// CHECK:               memref.load %[[AV]][%[[I]]] : memref<?xf64>
+//
+// CHECK-COST-LABEL:   func.func @sum_outer(
+// CHECK-COST-DAG:       %[[AV:.*]] = sparse_tensor.values %arg0
+// CHECK-COST-DAG:       %[[BV:.*]] = sparse_tensor.values %arg1
+// CHECK-COST:           scf.for %[[I:.*]] = %{{.*}} to %{{.*}} step %{{.*}}
+// CHECK-COST:             memref.load %[[AV]][%[[I]]] : memref<?xf64>
+// CHECK-COST:             scf.for %[[J:.*]] = %{{.*}} to %{{.*}} step %{{.*}}
+// CHECK-COST:               memref.load %[[BV]][%[[J]]] : memref<?xf64>
+func.func @sum_outer(%arga: tensor<1000xf64, #SV>,
+                     %argb: tensor<1000xf64, #SV>,
+                     %argx: tensor<f64>) -> tensor<f64> {
+  %0 = linalg.generic #trait
+     ins(%arga, %argb: tensor<1000xf64, #SV>, tensor<1000xf64, #SV>)
+    outs(%argx: tensor<f64>)
+    attrs = {sparse_tensor.density = [1.0e-3, 5.0e-1, 1.0]} {
+      ^bb(%a: f64, %b: f64, %x: f64):
+        %1 = arith.mulf %a, %b : f64
+        %2 = arith.addf %x, %1 : f64
+        linalg.yield %2 : f64
+  } -> tensor<f64>
+  return %0 : tensor<f64>
+}
@@ -0,0 +1,46 @@
+// RUN: mlir-opt %s --sparse-compiler="parallelization-strategy=any-storage-any-loop parallelization-backend=openmp" | \
+// RUN:   FileCheck %s --check-prefix=CHECK-OMP
+// RUN: mlir-opt %s --sparse-compiler="parallelization-strategy=dense-outer-loop parallelization-backend=async" | \
+// RUN:   FileCheck %s --check-prefix=CHECK-ASYNC
+
+#CSR = #sparse_tensor.encoding<{
+  lvlTypes = [ "dense", "compressed" ]
+}>
+
+#trait_matvec = {
+  indexing_maps = [
+    affine_map<(i,j) -> (i,j)>,  // A
+    affine_map<(i,j) -> (j)>,    // b
+    affine_map<(i,j) -> (i)>     // x (out)
+  ],
+  iterator_types = ["parallel", "reduction"],
+  doc = "x(i) += A(i,j) * b(j)"
+}
+
+// The outer loop is workshared, and the reduction of the inner loop over
+// the compressed level is privatized by OpenMP.
+//
+// CHECK-OMP:       omp.reduction.declare
+// CHECK-OMP-LABEL: llvm.func @matvec(
+// CHECK-OMP:         omp.parallel
+// CHECK-OMP:           omp.wsloop
+// CHECK-OMP:             omp.wsloop
+// CHECK-OMP-SAME:          reduction(
+//
+// The outer loop is split into async compute tasks.
+//
+// CHECK-ASYNC-DAG: llvm.func @parallel_compute_fn
+// CHECK-ASYNC-DAG: llvm.call @mlirAsyncRuntimeAwaitAllInGroup
+func.func @matvec(%arga: tensor<16x32xf32, #CSR>,
+                  %argb: tensor<32xf32>,
+                  %argx: tensor<16xf32>) -> tensor<16xf32> {
+  %0 = linalg.generic #trait_matvec
+      ins(%arga, %argb : tensor<16x32xf32, #CSR>, tensor<32xf32>)
+     outs(%argx: tensor<16xf32>) {
+    ^bb(%A: f32, %b: f32, %x: f32):
+      %0 = arith.mulf %A, %b : f32
+      %1 = arith.addf %0, %x : f32
+      linalg.yield %1 : f32
+  } -> tensor<16xf32>
+  return %0 : tensor<16xf32>
+}
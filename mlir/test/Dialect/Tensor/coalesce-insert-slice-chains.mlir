@@ -0,0 +1,129 @@
+// RUN: mlir-opt -split-input-file -test-tensor-transform-patterns=test-coalesce-insert-slice-chains %s | FileCheck %s
+// RUN: mlir-opt -split-input-file -test-tensor-transform-patterns=test-coalesce-insert-slice-chains -one-shot-bufferize="bufferize-function-boundaries" %s | FileCheck %s --check-prefix=BUFFERIZED
+
+// The read of %t after its update would prevent the insertion from
+// bufferizing in place, which would copy %t.
+
+// CHECK-LABEL: func @interleaved_read(
+//  CHECK-SAME:     %[[T:.*]]: tensor<16xf32>, %[[A:.*]]: tensor<4xf32>
+//       CHECK:   %[[INSERT:.*]] = tensor.insert_slice %[[A]] into %[[T]][0] [4] [1]
+//       CHECK:   %[[ELEM:.*]] = tensor.extract %[[INSERT]][%{{.*}}]
+//       CHECK:   tensor.insert %[[ELEM]] into %[[INSERT]]
+
+// BUFFERIZED-LABEL: func @interleaved_read(
+//   BUFFERIZED-NOT:   memref.alloc
+//       BUFFERIZED:   return
+func.func @interleaved_read(%t: tensor<16xf32>, %a: tensor<4xf32>)
+    -> tensor<16xf32> {
+  %c4 = arith.constant 4 : index
+  %c8 = arith.constant 8 : index
+  %0 = tensor.insert_slice %a into %t[0] [4] [1]
+      : tensor<4xf32> into tensor<16xf32>
+  %1 = tensor.extract %t[%c8] : tensor<16xf32>
+  %2 = tensor.insert %1 into %0[%c4] : tensor<16xf32>
+  return %2 : tensor<16xf32>
+}
+
+// -----
+
+// The reads are forwarded along the chains of insertions.
+
+// CHECK-LABEL: func @chain(
+//  CHECK-SAME:     %[[T:.*]]: tensor<16x16xf32>, %[[A:.*]]: tensor<4x4xf32>
+//       CHECK:   %[[INSERT0:.*]] = tensor.insert_slice %[[A]] into %[[T]][0, 0] [4, 4] [1, 1]
+//       CHECK:   %[[INSERT1:.*]] = tensor.insert_slice %[[A]] into %[[INSERT0]][0, 4] [4, 4] [1, 1]
+//       CHECK:   %[[SLICE:.*]] = tensor.extract_slice %[[INSERT1]][8, 0] [4, 4] [1, 1]
+//       CHECK:   return %[[INSERT1]], %[[SLICE]]
+func.func @chain(%t: tensor<16x16xf32>, %a: tensor<4x4xf32>)
+    -> (tensor<16x16xf32>, tensor<4x4xf32>) {
+  %0 = tensor.insert_slice %a into %t[0, 0] [4, 4] [1, 1]
+      : tensor<4x4xf32> into tensor<16x16xf32>
+  %1 = tensor.insert_slice %a into %0[0, 4] [4, 4] [1, 1]
+      : tensor<4x4xf32> into tensor<16x16xf32>
+  %2 = tensor.extract_slice %t[8, 0] [4, 4] [1, 1]
+      : tensor<16x16xf32> to tensor<4x4xf32>
+  return %1, %2 : tensor<16x16xf32>, tensor<4x4xf32>
+}
+
+// -----
+
+// The reads stop at the insertions they overlap with.
+
+// CHECK-LABEL: func @overlapping(
+//  CHECK-SAME:     %[[T:.*]]: tensor<16xf32>, %[[A:.*]]: tensor<4xf32>
+//       CHECK:   %[[INSERT0:.*]] = tensor.insert_slice %[[A]] into %[[T]][0] [4] [1]
+//       CHECK:   %[[INSERT1:.*]] = tensor.insert_slice %[[A]] into %[[INSERT0]][6] [4] [1]
+//       CHECK:   %[[SLICE:.*]] = tensor.extract_slice %[[INSERT0]][8] [4] [1]
+func.func @overlapping(%t: tensor<16xf32>, %a: tensor<4xf32>)
+    -> (tensor<16xf32>, tensor<4xf32>) {
+  %0 = tensor.insert_slice %a into %t[0] [4] [1]
+      : tensor<4xf32> into tensor<16xf32>
+  %1 = tensor.insert_slice %a into %0[6] [4] [1]
+      : tensor<4xf32> into tensor<16xf32>
+  %2 = tensor.extract_slice %t[8] [4] [1] : tensor<16xf32> to tensor<4xf32>
+  return %1, %2 : tensor<16xf32>, tensor<4xf32>
+}
+
+// -----
+
+// The reads that precede the insertions are not rewritten.
+
+// CHECK-LABEL: func @read_before_insert(
+//  CHECK-SAME:     %[[T:.*]]: tensor<16xf32>
+//       CHECK:   tensor.extract_slice %[[T]][8] [4] [1]
+func.func @read_before_insert(%t: tensor<16xf32>, %a: tensor<4xf32>)
+    -> (tensor<16xf32>, tensor<4xf32>) {
+  %0 = tensor.extract_slice %t[8] [4] [1] : tensor<16xf32> to tensor<4xf32>
+  %1 = tensor.insert_slice %a into %t[0] [4] [1]
+      : tensor<4xf32> into tensor<16xf32>
+  return %1, %0 : tensor<16xf32>, tensor<4xf32>
+}
+
+// -----
+
+// The disjointness of dynamic subsets is proven from the value bounds of
+// their offsets and sizes.
+
+// CHECK-LABEL: func @dynamic_offsets(
+//  CHECK-SAME:     %[[T:.*]]: tensor<?xf32>, %[[A:.*]]: tensor<4xf32>
+//       CHECK:   %[[INSERT:.*]] = tensor.insert_slice %[[A]] into %[[T]]
+//       CHECK:   %[[DISJOINT:.*]] = tensor.extract_slice %[[INSERT]]
+//       CHECK:   %[[OVERLAPPING:.*]] = tensor.extract_slice %[[T]]
+//       CHECK:   return %[[INSERT]], %[[DISJOINT]], %[[OVERLAPPING]]
+func.func @dynamic_offsets(%t: tensor<?xf32>, %a: tensor<4xf32>, %i: index)
+    -> (tensor<?xf32>, tensor<4xf32>, tensor<4xf32>) {
+  %c2 = arith.constant 2 : index
+  %c4 = arith.constant 4 : index
+  %0 = tensor.insert_slice %a into %t[%i] [4] [1]
+      : tensor<4xf32> into tensor<?xf32>
+  %j = arith.addi %i, %c4 : index
+  %1 = tensor.extract_slice %t[%j] [4] [1] : tensor<?xf32> to tensor<4xf32>
+  %k = arith.addi %i, %c2 : index
+  %2 = tensor.extract_slice %t[%k] [4] [1] : tensor<?xf32> to tensor<4xf32>
+  return %0, %1, %2 : tensor<?xf32>, tensor<4xf32>, tensor<4xf32>
+}
+
+// -----
+
+// The reads nested in the regions that follow the insertions are rewritten.
+
+// CHECK-LABEL: func @nested_read(
+//  CHECK-SAME:     %[[T:.*]]: tensor<16xf32>, %[[A:.*]]: tensor<4xf32>
+//       CHECK:   %[[INSERT:.*]] = tensor.insert_slice %[[A]] into %[[T]][0] [4] [1]
+//       CHECK:   scf.for
+//       CHECK:     tensor.extract %[[INSERT]]
+func.func @nested_read(%t: tensor<16xf32>, %a: tensor<4xf32>,
+                       %init: f32) -> (tensor<16xf32>, f32) {
+  %c0 = arith.constant 0 : index
+  %c4 = arith.constant 4 : index
+  %c16 = arith.constant 16 : index
+  %c1 = arith.constant 1 : index
+  %0 = tensor.insert_slice %a into %t[0] [4] [1]
+      : tensor<4xf32> into tensor<16xf32>
+  %1 = scf.for %i = %c4 to %c16 step %c1 iter_args(%acc = %init) -> (f32) {
+    %2 = tensor.extract %t[%i] : tensor<16xf32>
+    %3 = arith.addf %acc, %2 : f32
+    scf.yield %3 : f32
+  }
+  return %0, %1 : tensor<16xf32>, f32
+}
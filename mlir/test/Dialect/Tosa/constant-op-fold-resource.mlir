@@ -0,0 +1,35 @@
+// RUN: mlir-opt --tosa-layerwise-constant-fold %s | FileCheck %s
+
+// The resource backed constants are folded into new resources rather than
+// into dense elements attributes.
+
+// CHECK-LABEL: @transpose_fold_resource
+func.func @transpose_fold_resource() -> tensor<3x2xi8> {
+  %input = "tosa.const"() {value = dense_resource<weights> : tensor<2x3xi8>} : () -> tensor<2x3xi8>
+  %perms = "tosa.const"() {value = dense<[1, 0]> : tensor<2xi32>} : () -> tensor<2xi32>
+  // CHECK: %[[CST:.+]] = "tosa.const"() <{value = dense_resource<weights_1> : tensor<3x2xi8>}>
+  %0 = "tosa.transpose"(%input, %perms) : (tensor<2x3xi8>, tensor<2xi32>) -> tensor<3x2xi8>
+  // CHECK: return %[[CST]]
+  return %0 : tensor<3x2xi8>
+}
+
+// CHECK-LABEL: @reshape_fold_resource
+func.func @reshape_fold_resource() -> tensor<6xf32> {
+  %input = "tosa.const"() {value = dense_resource<bias> : tensor<2x3xf32>} : () -> tensor<2x3xf32>
+  // CHECK: %[[CST:.+]] = "tosa.const"() <{value = dense_resource<bias> : tensor<6xf32>}>
+  %0 = "tosa.reshape"(%input) {new_shape = array<i64: 6>} : (tensor<2x3xf32>) -> tensor<6xf32>
+  // CHECK: return %[[CST]]
+  return %0 : tensor<6xf32>
+}
+
+// CHECK: dialect_resources
+// CHECK-DAG: bias: "0x04000000000000000000803F0000004000004040000080400000A040"
+// CHECK-DAG: weights_1: "0x01000000010402050306"
+{-#
+  dialect_resources: {
+    builtin: {
+      weights: "0x01000000010203040506",
+      bias: "0x04000000000000000000803F0000004000004040000080400000A040"
+    }
+  }
+#-}
@@ -0,0 +1,51 @@
+// RUN: mlir-opt --split-input-file --tosa-specialize-shapes="sizes=1,8" %s | FileCheck %s
+
+// CHECK-LABEL: func.func @add(
+// CHECK-SAME:      %[[A:.*]]: tensor<?x4xf32>, %[[B:.*]]: tensor<?x4xf32>) -> tensor<?x4xf32>
+//      CHECK:   %[[C1:.*]] = arith.constant 1 : index
+//      CHECK:   %[[A_DIM:.*]] = tensor.dim %[[A]]
+//      CHECK:   %[[A_EQ:.*]] = arith.cmpi eq, %[[A_DIM]], %[[C1]]
+//      CHECK:   %[[B_DIM:.*]] = tensor.dim %[[B]]
+//      CHECK:   %[[B_EQ:.*]] = arith.cmpi eq, %[[B_DIM]], %[[C1]]
+//      CHECK:   %[[COND:.*]] = arith.andi %[[A_EQ]], %[[B_EQ]]
+//      CHECK:   %[[RESULT:.*]] = scf.if %[[COND]] -> (tensor<?x4xf32>) {
+//      CHECK:     %[[A_1:.*]] = tensor.cast %[[A]] : tensor<?x4xf32> to tensor<1x4xf32>
+//      CHECK:     %[[B_1:.*]] = tensor.cast %[[B]] : tensor<?x4xf32> to tensor<1x4xf32>
+//      CHECK:     %[[CALL_1:.*]] = {{.*}}call @add_1(%[[A_1]], %[[B_1]]) : (tensor<1x4xf32>, tensor<1x4xf32>) -> tensor<1x4xf32>
+//      CHECK:     %[[CAST_1:.*]] = tensor.cast %[[CALL_1]] : tensor<1x4xf32> to tensor<?x4xf32>
+//      CHECK:     scf.yield %[[CAST_1]]
+//      CHECK:   } else {
+//      CHECK:     scf.if
+//      CHECK:       call @add_8
+//      CHECK:     } else {
+//      CHECK:       %[[CALL:.*]] = {{.*}}call @add_generic(%[[A]], %[[B]]) : (tensor<?x4xf32>, tensor<?x4xf32>) -> tensor<?x4xf32>
+//      CHECK:       scf.yield %[[CALL]]
+//      CHECK:   return %[[RESULT]]
+
+// CHECK-LABEL: func.func private @add_generic(
+// CHECK-SAME:      tensor<?x4xf32>, %{{.*}}: tensor<?x4xf32>) -> tensor<?x4xf32>
+//      CHECK:   "tosa.add"{{.*}} -> tensor<?x4xf32>
+
+// CHECK-LABEL: func.func private @add_1(
+// CHECK-SAME:      tensor<1x4xf32>, %{{.*}}: tensor<1x4xf32>) -> tensor<1x4xf32>
+//      CHECK:   "tosa.add"{{.*}} -> tensor<1x4xf32>
+
+// CHECK-LABEL: func.func private @add_8(
+// CHECK-SAME:      tensor<8x4xf32>, %{{.*}}: tensor<8x4xf32>) -> tensor<8x4xf32>
+//      CHECK:   "tosa.add"{{.*}} -> tensor<8x4xf32>
+func.func @add(%arg0: tensor<?x4xf32>, %arg1: tensor<?x4xf32>) -> tensor<?x4xf32> {
+  %0 = "tosa.add"(%arg0, %arg1) : (tensor<?x4xf32>, tensor<?x4xf32>) -> tensor<?x4xf32>
+  return %0 : tensor<?x4xf32>
+}
+
+// -----
+
+// The functions with static arguments are not specialized.
+
+// CHECK-LABEL: func.func @static(
+//   CHECK-NOT:   scf.if
+//   CHECK-NOT: func.func private @static_1
+func.func @static(%arg0: tensor<2x4xf32>) -> tensor<2x4xf32> {
+  %0 = "tosa.abs"(%arg0) : (tensor<2x4xf32>) -> tensor<2x4xf32>
+  return %0 : tensor<2x4xf32>
+}
@@ -686,3 +686,12 @@ transform.sequence failures(propagate) {
     transform.named_sequence @foo()
   } : !transform.any_op
 }
+
+// -----
+
+transform.sequence failures(propagate) {
+^bb0(%arg0: !transform.any_op):
+  // expected-error @below {{expects the default value to be one of the options}}
+  %0 = transform.param.tunable "tile_size" = 8 : i64
+      from [16 : i64, 32 : i64] -> !transform.param<i64>
+}
@@ -105,3 +105,10 @@ transform.sequence failures(propagate) {
   %0 = transform.structured.match ops{["linalg.matmul"]} in %arg1 : (!transform.any_op) -> !transform.any_op
   transform.structured.tile %0 [4, 4, [4]] : (!transform.any_op) -> (!transform.any_op, !transform.any_op, !transform.any_op, !transform.any_op)
 }
+
+// CHECK: transform.sequence
+// CHECK: transform.param.tunable "tile_size" = 32 : i64 from [16 : i64, 32 : i64] -> !transform.param<i64>
+transform.sequence failures(propagate) {
+^bb0(%arg0: !transform.any_op):
+  %0 = transform.param.tunable "tile_size" = 32 : i64 from [16 : i64, 32 : i64] -> !transform.param<i64>
+}
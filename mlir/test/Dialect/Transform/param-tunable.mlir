@@ -0,0 +1,18 @@
+// RUN: mlir-opt %s --test-transform-dialect-interpreter 2>&1 \
+// RUN:   | FileCheck %s --check-prefix=DEFAULT
+// RUN: mlir-opt %s \
+// RUN:   --test-transform-dialect-interpreter="tunable-values=tile_size=64" \
+// RUN:   2>&1 | FileCheck %s --check-prefix=SELECTED
+// RUN: mlir-opt %s \
+// RUN:   --test-transform-dialect-interpreter="tunable-values=tile_size=48" \
+// RUN:   2>&1 | FileCheck %s --check-prefix=INVALID
+
+// DEFAULT: remark: tile size 32 : i64
+// SELECTED: remark: tile size 64 : i64
+// INVALID: error: value 48 : i64 selected for tunable parameter 'tile_size' is not one of its options
+transform.sequence failures(propagate) {
+^bb0(%arg0: !transform.any_op):
+  %size = transform.param.tunable "tile_size" = 32 : i64
+      from [16 : i64, 32 : i64, 64 : i64] -> !transform.param<i64>
+  transform.test_print_param %size, "tile size" : !transform.param<i64>
+}
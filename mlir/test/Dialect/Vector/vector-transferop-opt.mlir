@@ -215,4 +215,52 @@ func.func @forward_dead_store_negative(%arg0: i1, %arg1 : memref<4x4xf32>,
   vector.transfer_write %v2, %arg1[%c1, %c0] {in_bounds = [true, true]} :
     vector<1x4xf32>, memref<4x4xf32>
   return %0 : vector<1x4xf32>
-}
\ No newline at end of file
+}
+// The transfers with constant indices only block the ones they may overlap.
+// CHECK-LABEL: func @unrolled_forward_dead_store
+//  CHECK-SAME:   (%{{.*}}: memref<4x16xf32>, %[[V0:.*]]: vector<1x4xf32>, %[[V1:.*]]: vector<1x4xf32>, %[[V2:.*]]: vector<1x4xf32>, %[[V3:.*]]: vector<1x4xf32>)
+//       CHECK:   vector.transfer_write %[[V0]]
+//       CHECK:   vector.transfer_write %[[V1]]
+//       CHECK:   %[[R0:.*]] = vector.transfer_read
+//       CHECK:   vector.transfer_write %[[V0]]
+//       CHECK:   vector.transfer_write %[[V1]]
+//       CHECK:   vector.transfer_write %[[V1]]
+//   CHECK-NOT:   vector.transfer_write %[[V2]]
+//       CHECK:   %[[R2:.*]] = vector.transfer_read
+//       CHECK:   vector.transfer_write %[[V3]]
+//       CHECK:   return %[[R0]], %[[V0]], %[[R2]]
+func.func @unrolled_forward_dead_store(%arg0 : memref<4x16xf32>,
+  %v0 : vector<1x4xf32>, %v1 : vector<1x4xf32>, %v2 : vector<1x4xf32>,
+  %v3 : vector<1x4xf32>) -> (vector<1x4xf32>, vector<1x4xf32>, vector<1x4xf32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %c3 = arith.constant 3 : index
+  %c4 = arith.constant 4 : index
+  %c8 = arith.constant 8 : index
+  %cf0 = arith.constant 0.0 : f32
+  vector.transfer_write %v0, %arg0[%c0, %c4] {in_bounds = [true, true]} :
+    vector<1x4xf32>, memref<4x16xf32>
+  // blocking write, in the adjacent tile.
+  vector.transfer_write %v1, %arg0[%c0, %c2] {in_bounds = [true, true]} :
+    vector<1x4xf32>, memref<4x16xf32>
+  %0 = vector.transfer_read %arg0[%c0, %c4], %cf0 {in_bounds = [true, true]} :
+    memref<4x16xf32>, vector<1x4xf32>
+  vector.transfer_write %v0, %arg0[%c1, %c0] {in_bounds = [true, true]} :
+    vector<1x4xf32>, memref<4x16xf32>
+  // disjoint writes.
+  vector.transfer_write %v1, %arg0[%c1, %c4] {in_bounds = [true, true]} :
+    vector<1x4xf32>, memref<4x16xf32>
+  vector.transfer_write %v1, %arg0[%c2, %c0] {in_bounds = [true, true]} :
+    vector<1x4xf32>, memref<4x16xf32>
+  %1 = vector.transfer_read %arg0[%c1, %c0], %cf0 {in_bounds = [true, true]} :
+    memref<4x16xf32>, vector<1x4xf32>
+  vector.transfer_write %v2, %arg0[%c3, %c0] {in_bounds = [true, true]} :
+    vector<1x4xf32>, memref<4x16xf32>
+  // disjoint read.
+  %2 = vector.transfer_read %arg0[%c3, %c8], %cf0 {in_bounds = [true, true]} :
+    memref<4x16xf32>, vector<1x4xf32>
+  vector.transfer_write %v3, %arg0[%c3, %c0] {in_bounds = [true, true]} :
+    vector<1x4xf32>, memref<4x16xf32>
+  return %0, %1, %2 : vector<1x4xf32>, vector<1x4xf32>, vector<1x4xf32>
+}
@@ -0,0 +1,60 @@
+// RUN: mlir-opt %s -split-input-file \
+// RUN:   -test-vector-unrolling-patterns=native-shape-from-data-layout | \
+// RUN:   FileCheck %s
+
+// The vectors are unrolled to the 128-bit registers described by the data
+// layout, and the contraction to a block of 8 rows of accumulators, half of
+// the 16 registers, updated for one step of the reduction at a time.
+
+module attributes { dlti.dl_spec = #dlti.dl_spec<
+    #dlti.dl_entry<"dlti.vector_width_in_bits", 128 : i64>,
+    #dlti.dl_entry<"dlti.num_vector_registers", 16 : i64>> } {
+
+// CHECK-LABEL: func @elementwise(
+// CHECK-COUNT-8:   arith.addf %{{.*}}, %{{.*}} : vector<1x4xf32>
+//     CHECK-NOT:   arith.addf
+func.func @elementwise(%a: vector<4x8xf32>, %b: vector<4x8xf32>)
+    -> vector<4x8xf32> {
+  %0 = arith.addf %a, %b : vector<4x8xf32>
+  return %0 : vector<4x8xf32>
+}
+
+// CHECK-LABEL: func @transfer_read(
+// CHECK-COUNT-4:   vector.transfer_read {{.*}} : memref<?x?xf16>, vector<1x8xf16>
+//     CHECK-NOT:   vector.transfer_read
+func.func @transfer_read(%m: memref<?x?xf16>) -> vector<2x16xf16> {
+  %c0 = arith.constant 0 : index
+  %pad = arith.constant 0.0 : f16
+  %0 = vector.transfer_read %m[%c0, %c0], %pad
+    : memref<?x?xf16>, vector<2x16xf16>
+  return %0 : vector<2x16xf16>
+}
+
+// CHECK-LABEL: func @contract(
+// CHECK-COUNT-8:   vector.contract {{.*}} : vector<8x1xf32>, vector<1x4xf32> into vector<8x4xf32>
+//     CHECK-NOT:   vector.contract
+func.func @contract(%lhs: vector<8x4xf32>, %rhs: vector<4x8xf32>,
+                    %acc: vector<8x8xf32>) -> vector<8x8xf32> {
+  %0 = vector.contract {indexing_maps = [affine_map<(m, n, k) -> (m, k)>,
+                                         affine_map<(m, n, k) -> (k, n)>,
+                                         affine_map<(m, n, k) -> (m, n)>],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>}
+    %lhs, %rhs, %acc : vector<8x4xf32>, vector<4x8xf32> into vector<8x8xf32>
+  return %0 : vector<8x8xf32>
+}
+
+}
+
+// -----
+
+// Nothing is unrolled without a description of the vector registers.
+
+// CHECK-LABEL: func @no_data_layout(
+//   CHECK-NOT:   vector.extract_strided_slice
+//       CHECK:   arith.addf %{{.*}}, %{{.*}} : vector<4x8xf32>
+func.func @no_data_layout(%a: vector<4x8xf32>, %b: vector<4x8xf32>)
+    -> vector<4x8xf32> {
+  %0 = arith.addf %a, %b : vector<4x8xf32>
+  return %0 : vector<4x8xf32>
+}
@@ -13,6 +13,9 @@
 // CHECK: dense<[1.000000e+01, 5.000000e+00]> : tensor<2xf64>
 "foo.op"() {dense.attr = dense<"0x00000000000024400000000000001440"> : tensor<2xf64>} : () -> ()
 
+// CHECK: dense<[1.000000e+01, 5.000000e+00]> : tensor<2xf32>
+"foo.op"() {dense.attr = dense<"0x000020410000a040"> : tensor<2xf32>} : () -> ()
+
 // CHECK: dense<(1.000000e+01,5.000000e+00)> : tensor<2xcomplex<f32>>
 "foo.op"() {dense.attr = dense<"0x000020410000A040000020410000A040"> : tensor<2xcomplex<f32>>} : () -> ()
 
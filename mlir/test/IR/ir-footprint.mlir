@@ -0,0 +1,12 @@
+// RUN: mlir-opt %s -test-ir-footprint -o /dev/null | FileCheck %s
+
+// CHECK: operations: 5
+// CHECK-NEXT: operations without regions: 3
+// CHECK-NEXT: operations with at most two operands: 5
+// CHECK-NEXT: bytes: {{[0-9]+}}
+// CHECK-NEXT: bytes per operation: {{[0-9]+}}
+func.func @add(%a: i32, %b: i32) -> i32 {
+  %0 = arith.addi %a, %b : i32
+  %1 = arith.muli %0, %b : i32
+  return %1 : i32
+}
@@ -1125,6 +1125,34 @@ func.func @special_float_values_in_tensors() {
   "foo"(){bar = sparse<[[1,1,0],[0,1,1]], [0xFFFFFFFF, 0x7F800001]> : tensor<2x2x2xf32>} : () -> ()
 }
 
+// The bounds of the integer elements depend on the signedness of the type.
+// CHECK-LABEL: @dense_elements_bounds
+func.func @dense_elements_bounds() {
+  // CHECK: dense<[-128, -1, 127]> : tensor<3xi8>
+  "foo"(){bar = dense<[-128, 255, 127]> : tensor<3xi8>} : () -> ()
+  // CHECK: dense<[0, 255]> : tensor<2xui8>
+  "foo"(){bar = dense<[0, 255]> : tensor<2xui8>} : () -> ()
+  // CHECK: dense<[-32768, 32767]> : tensor<2xsi16>
+  "foo"(){bar = dense<[-32768, 32767]> : tensor<2xsi16>} : () -> ()
+  // CHECK: dense<[-9223372036854775808, 9223372036854775807]> : tensor<2xindex>
+  "foo"(){bar = dense<[-9223372036854775808, 9223372036854775807]> : tensor<2xindex>} : () -> ()
+  // CHECK: dense<[-1, 4294967295]> : tensor<2xi64>
+  "foo"(){bar = dense<[- 1, 0xFFFFFFFF]> : tensor<2xi64>} : () -> ()
+  // CHECK: dense<7> : tensor<4xi32>
+  "foo"(){bar = dense<7> : tensor<4xi32>} : () -> ()
+  // CHECK: dense<{{\[}}[1, 2], [3, 4]]> : tensor<2x2xi32>
+  "foo"(){bar = dense<[[1, 2],
+                       [3, // Comments are left to the lexer.
+                        4]]> : tensor<2x2xi32>} : () -> ()
+  // CHECK: dense<[1.000000e-01, -2.500000e+00, 3.000000e+08]> : tensor<3xf32>
+  "foo"(){bar = dense<[0.1, -2.5, 3.0e8]> : tensor<3xf32>} : () -> ()
+  // CHECK: dense<[1.000000e-01, -2.500000e+00]> : tensor<2xf64>
+  "foo"(){bar = dense<[1.0E-1, -2.5]> : tensor<2xf64>} : () -> ()
+  // CHECK: dense<[1.000000e+00, 2.000000e+00]> : tensor<2xf16>
+  "foo"(){bar = dense<[1.0, 2.0]> : tensor<2xf16>} : () -> ()
+  return
+}
+
 // Test parsing of an op with multiple region arguments, and without a
 // delimiter.
 
@@ -0,0 +1,47 @@
+// RUN: mlir-opt %s -allow-unregistered-dialect -mlir-print-in-parallel | FileCheck %s
+// RUN: mlir-opt %s -allow-unregistered-dialect -mlir-print-in-parallel -mlir-print-debuginfo -o %t.parallel
+// RUN: mlir-opt %s -allow-unregistered-dialect -mlir-print-debuginfo -o %t.sequential
+// RUN: diff %t.sequential %t.parallel
+
+// The functions are printed in parallel, with the same aliases, names and
+// resources as when they are printed sequentially.
+
+// CHECK: #[[MAP:.*]] = affine_map<(d0) -> (d0 + 1)>
+// CHECK-LABEL: func @first
+// CHECK:         %[[C0:.*]] = arith.constant {map = #[[MAP]]} 0 : index
+// CHECK:         return %[[C0]]
+func.func @first() -> index {
+  %c0 = arith.constant {map = affine_map<(d0) -> (d0 + 1)>} 0 : index
+  return %c0 : index
+}
+
+// CHECK: %[[C1:.*]] = arith.constant 1 : index
+%c1 = arith.constant 1 : index
+
+// CHECK-LABEL: func @second
+// CHECK-SAME:    (%[[ARG:.*]]: index)
+// CHECK:         %[[C1_0:.*]] = arith.constant {map = #[[MAP]]} 1 : index
+// CHECK:         cf.br ^bb1(%[[ARG]] : index)
+// CHECK:       ^bb1(%{{.*}}: index):
+func.func @second(%arg0: index) -> index {
+  %c1 = arith.constant {map = affine_map<(d0) -> (d0 + 1)>} 1 : index
+  cf.br ^bb1(%arg0 : index)
+^bb1(%0: index):
+  return %0 : index
+}
+
+// CHECK-LABEL: func @third
+// CHECK:         "test.user_op"() {attr = dense_resource<blob1> : tensor<3xi64>}
+func.func @third() {
+  "test.user_op"() {attr = dense_resource<blob1> : tensor<3xi64>} : () -> ()
+  return
+}
+
+// CHECK: blob1: "0x08000000010000000000000002000000000000000300000000000000"
+{-#
+  dialect_resources: {
+    builtin: {
+      blob1: "0x08000000010000000000000002000000000000000300000000000000"
+    }
+  }
+#-}
@@ -56,6 +56,15 @@
   lvlTypes = [ "dense", "dense", "compressed" ]
 }>
 
+#CSR = #sparse_tensor.encoding<{
+  lvlTypes = [ "dense", "compressed" ]
+}>
+
+#CSC = #sparse_tensor.encoding<{
+  lvlTypes = [ "dense", "compressed" ],
+  dimToLvl = affine_map<(i,j) -> (j,i)>
+}>
+
 module {
   //
   // Utility for output.
@@ -202,12 +211,68 @@ module {
     return
   }
 
+  //
+  // The third test suite (for the transpose of matrices).
+  //
+  func.func @testTranspose() {
+    %c0 = arith.constant 0 : index
+    %d0 = arith.constant -1.0 : f64
+    %src = arith.constant dense<[
+       [ 1.0, 0.0, 2.0, 0.0, 0.0 ],
+       [ 0.0, 0.0, 0.0, 0.0, 3.0 ],
+       [ 4.0, 5.0, 0.0, 0.0, 6.0 ]
+    ]> : tensor<3x5xf64>
+
+    //
+    // Convert between CSR and CSC, and between the static and dynamic
+    // shapes of the same format.
+    //
+    %s = sparse_tensor.convert %src : tensor<3x5xf64> to tensor<3x5xf64, #CSR>
+    %t = sparse_tensor.convert %s : tensor<3x5xf64, #CSR> to tensor<3x5xf64, #CSC>
+    %u = sparse_tensor.convert %t : tensor<3x5xf64, #CSC> to tensor<?x?xf64, #CSC>
+    %v = sparse_tensor.convert %u : tensor<?x?xf64, #CSC> to tensor<3x5xf64, #CSR>
+    %dt = sparse_tensor.convert %t : tensor<3x5xf64, #CSC> to tensor<3x5xf64>
+    %dv = sparse_tensor.convert %v : tensor<3x5xf64, #CSR> to tensor<3x5xf64>
+
+    //
+    // Check the storage of the transpose, and round-trip equality.
+    //
+    // CHECK: ( 0, 2, 3, 4, 4, 6 )
+    // CHECK-NEXT: ( 0, 2, 2, 0, 1, 2 )
+    // CHECK-NEXT: ( 1, 4, 5, 2, 3, 6 )
+    // CHECK-COUNT-2: ( ( 1, 0, 2, 0, 0 ), ( 0, 0, 0, 0, 3 ), ( 4, 5, 0, 0, 6 ) )
+    %pos = sparse_tensor.positions %t { level = 1 : index } : tensor<3x5xf64, #CSC> to memref<?xindex>
+    %crd = sparse_tensor.coordinates %t { level = 1 : index } : tensor<3x5xf64, #CSC> to memref<?xindex>
+    %val = sparse_tensor.values %t : tensor<3x5xf64, #CSC> to memref<?xf64>
+    %vpos = vector.transfer_read %pos[%c0], %c0 : memref<?xindex>, vector<6xindex>
+    %vcrd = vector.transfer_read %crd[%c0], %c0 : memref<?xindex>, vector<6xindex>
+    %vval = vector.transfer_read %val[%c0], %d0 : memref<?xf64>, vector<6xf64>
+    vector.print %vpos : vector<6xindex>
+    vector.print %vcrd : vector<6xindex>
+    vector.print %vval : vector<6xf64>
+    %0 = vector.transfer_read %dt[%c0, %c0], %d0 : tensor<3x5xf64>, vector<3x5xf64>
+    %1 = vector.transfer_read %dv[%c0, %c0], %d0 : tensor<3x5xf64>, vector<3x5xf64>
+    vector.print %0 : vector<3x5xf64>
+    vector.print %1 : vector<3x5xf64>
+
+    //
+    // Release sparse tensors.
+    //
+    bufferization.dealloc_tensor %s : tensor<3x5xf64, #CSR>
+    bufferization.dealloc_tensor %t : tensor<3x5xf64, #CSC>
+    bufferization.dealloc_tensor %u : tensor<?x?xf64, #CSC>
+    bufferization.dealloc_tensor %v : tensor<3x5xf64, #CSR>
+
+    return
+  }
+
   //
   // Main driver.
   //
   func.func @entry() {
     call @testNonSingleton() : () -> ()
     call @testSingleton() : () -> ()
+    call @testTranspose() : () -> ()
     return
   }
 }
@@ -1,7 +1,7 @@
 // DEFINE: %{option} = enable-runtime-library=true
 // DEFINE: %{compile} = mlir-opt %s --sparse-compiler=%{option}
 // DEFINE: %{run} = TENSOR0="%mlir_src_dir/test/Integration/data/wide.mtx" TENSOR1="" \
-// DEFINE:   mlir-cpu-runner \
+// DEFINE:   TENSOR2="%t.bin" mlir-cpu-runner \
 // DEFINE:  -e entry -entry-point-result=void  \
 // DEFINE:  -shared-libs=%mlir_c_runner_utils | \
 // DEFINE: FileCheck %s
@@ -20,7 +20,7 @@
 // vectorization.
 // REDEFINE: %{option} = "enable-runtime-library=false vl=4 enable-arm-sve=%ENABLE_VLA"
 // REDEFINE: %{run} = TENSOR0="%mlir_src_dir/test/Integration/data/wide.mtx" TENSOR1="" \
-// REDEFINE:   %lli_host_or_aarch64_cmd \
+// REDEFINE:   TENSOR2="%t.bin" %lli_host_or_aarch64_cmd \
 // REDEFINE:   --entry-function=entry_lli \
 // REDEFINE:   --extra-module=%S/Inputs/main_for_lli.ll \
 // REDEFINE:   %VLA_ARCH_ATTR_OPTIONS \
@@ -31,6 +31,7 @@
 !Filename = !llvm.ptr<i8>
 !TensorReader = !llvm.ptr<i8>
 !TensorWriter = !llvm.ptr<i8>
+!Tensor = !llvm.ptr<i8>
 
 module {
 
@@ -55,6 +56,16 @@ module {
     memref<?xindex>) -> () attributes { llvm.emit_c_interface }
   func.func private @outSparseTensorWriterNextF32(!TensorWriter, index,
     memref<?xindex>, memref<f32>) -> () attributes { llvm.emit_c_interface }
+  func.func private @createSparseTensorBinaryWriter(!Filename, i32)
+    -> (!TensorWriter)
+
+  func.func private @newSparseTensorFromBinaryFile(!Filename, memref<?xindex>,
+    i32, i32, i32) -> (!Tensor) attributes { llvm.emit_c_interface }
+  func.func private @sparseCoordinates0(!Tensor, index) -> (memref<?xindex>)
+    attributes { llvm.emit_c_interface }
+  func.func private @sparseValuesF32(!Tensor) -> (memref<?xf32>)
+    attributes { llvm.emit_c_interface }
+  func.func private @delSparseTensor(!Tensor) -> ()
 
   func.func @dumpi(%arg0: memref<?xindex>) {
     %c0 = arith.constant 0 : index
@@ -140,16 +151,14 @@ module {
     return
   }
 
-  // Reads a COO tensor from a file with fileName0 and writes its content to
-  // another file with fileName1.
-  func.func @createTensorFileFrom(%fileName0: !Filename, %fileName1: !Filename) {
+  // Reads a COO tensor from a file with fileName0 and writes its content
+  // through the given writer, which it releases.
+  func.func @copyTensorFile(%fileName0: !Filename, %tensor1: !TensorWriter) {
     %c0 = arith.constant 0 : index
     %c1 = arith.constant 1 : index
 
     %tensor0 = call @createSparseTensorReader(%fileName0)
       : (!Filename) -> (!TensorReader)
-    %tensor1 = call @createSparseTensorWriter(%fileName1)
-      : (!Filename) -> (!TensorWriter)
 
     %rank = call @getSparseTensorReaderRank(%tensor0) : (!TensorReader) -> index
     %nse = call @getSparseTensorReaderNSE(%tensor0) : (!TensorReader) -> index
@@ -179,11 +188,39 @@ module {
     return
   }
 
+  // Reads the sparse tensor, written with the binary writer, from the given
+  // file name and prints its coordinates and values.
+  func.func @readBinaryFileAndDump(%fileName: !Filename) {
+    %c0 = arith.constant 0 : index
+    %c1 = arith.constant 1 : index
+    %c2 = arith.constant 2 : index
+    %kIndex = arith.constant 0 : i32
+    %kF32 = arith.constant 2 : i32
+    %dimShape = memref.alloca(%c2) : memref<?xindex>
+    memref.store %c0, %dimShape[%c0] : memref<?xindex>
+    memref.store %c0, %dimShape[%c1] : memref<?xindex>
+    %tensor = call @newSparseTensorFromBinaryFile(%fileName, %dimShape,
+      %kIndex, %kIndex, %kF32)
+      : (!Filename, memref<?xindex>, i32, i32, i32) -> (!Tensor)
+    %crd0 = call @sparseCoordinates0(%tensor, %c0)
+      : (!Tensor, index) -> (memref<?xindex>)
+    %crd1 = call @sparseCoordinates0(%tensor, %c1)
+      : (!Tensor, index) -> (memref<?xindex>)
+    %values = call @sparseValuesF32(%tensor) : (!Tensor) -> (memref<?xf32>)
+    call @dumpi(%crd0) : (memref<?xindex>) -> ()
+    call @dumpi(%crd1) : (memref<?xindex>) -> ()
+    call @dumpf(%values) : (memref<?xf32>) -> ()
+    call @delSparseTensor(%tensor) : (!Tensor) -> ()
+    return
+  }
+
   func.func @entry() {
     %c0 = arith.constant 0 : index
     %c1 = arith.constant 1 : index
     %fileName0 = call @getTensorFilename(%c0) : (index) -> (!Filename)
+    %c2 = arith.constant 2 : index
     %fileName1 = call @getTensorFilename(%c1) : (index) -> (!Filename)
+    %fileName2 = call @getTensorFilename(%c2) : (index) -> (!Filename)
 
     // Write the sparse tensor data from file through the SparseTensorReader and
     // print the data.
@@ -218,8 +255,22 @@ module {
     // CHECK: 4 250 -15
     // CHECK: 4 254 16
     // CHECK: 4 256 -17
-    call @createTensorFileFrom(%fileName0, %fileName1)
-      : (!Filename, !Filename) -> ()
+    %writer1 = call @createSparseTensorWriter(%fileName1)
+      : (!Filename) -> (!TensorWriter)
+    call @copyTensorFile(%fileName0, %writer1)
+      : (!Filename, !TensorWriter) -> ()
+
+    // Write the sparse tensor data to a file in the binary container format
+    // and load it back as a storage scheme in COO.
+    // CHECK: ( 0, 0, 0, 0, 1, 1, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3 )
+    // CHECK: ( 0, 126, 127, 254, 1, 253, 2, 0, 1, 3, 98, 126, 127, 128, 249, 253, 255 )
+    // CHECK: ( -1, 2, -3, 4, -5, 6, -7, 8, -9, 10, -11, 12, -13, 14, -15, 16, -17 )
+    %kF32 = arith.constant 2 : i32
+    %writer2 = call @createSparseTensorBinaryWriter(%fileName2, %kF32)
+      : (!Filename, i32) -> (!TensorWriter)
+    call @copyTensorFile(%fileName0, %writer2)
+      : (!Filename, !TensorWriter) -> ()
+    call @readBinaryFileAndDump(%fileName2) : (!Filename) -> ()
 
     return
   }
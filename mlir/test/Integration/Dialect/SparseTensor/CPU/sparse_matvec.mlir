@@ -23,6 +23,17 @@
 // REDEFINE: %{option} = "enable-runtime-library=false vl=2 reassociate-fp-reductions=true enable-index-optimizations=true"
 // RUN: %{compile} | %{run}
 
+// Do the same run, but now with direct IR generation and parallel loops
+// executed on the async runtime.
+// REDEFINE: %{option} = "enable-runtime-library=false parallelization-strategy=dense-outer-loop parallelization-backend=async"
+// REDEFINE: %{run} = TENSOR0="%mlir_src_dir/test/Integration/data/wide.mtx" \
+// REDEFINE: mlir-cpu-runner \
+// REDEFINE:  -e entry -entry-point-result=void  \
+// REDEFINE:  -shared-libs=%mlir_c_runner_utils \
+// REDEFINE:  -shared-libs=%mlir_async_runtime | \
+// REDEFINE: FileCheck %s
+// RUN: %{compile} | %{run}
+
 // Do the same run, but now with direct IR generation and, if available, VLA
 // vectorization.
 // REDEFINE: %{option} = "enable-runtime-library=false vl=4 enable-arm-sve=%ENABLE_VLA"
@@ -0,0 +1,105 @@
+// DEFINE: %{option} = enable-runtime-library=true
+// DEFINE: %{compile} = mlir-opt %s --sparse-compiler=%{option}
+// DEFINE: %{run} = mlir-cpu-runner \
+// DEFINE:  -e entry -entry-point-result=void  \
+// DEFINE:  -shared-libs=%mlir_c_runner_utils | \
+// DEFINE: FileCheck %s
+//
+// RUN: %{compile} | %{run}
+
+#SortedCOO = #sparse_tensor.encoding<{
+  lvlTypes = [ "compressed-nu", "singleton" ]
+}>
+
+#CSR = #sparse_tensor.encoding<{
+  lvlTypes = [ "dense", "compressed" ],
+  posWidth = 32,
+  crdWidth = 32
+}>
+
+#DCSR = #sparse_tensor.encoding<{
+  lvlTypes = [ "compressed", "compressed" ]
+}>
+
+module {
+  //
+  // Packs the buffers with the runtime library, which copies them into its
+  // storage as they are.
+  //
+  func.func @entry() {
+    %data = arith.constant dense<[ 1.0, 2.0, 3.0 ]> : tensor<3xf64>
+    %pos = arith.constant dense<[ 0, 3 ]> : tensor<2xindex>
+    %index = arith.constant dense<[[ 1, 2 ], [ 5, 6 ], [ 7, 8 ]]> : tensor<3x2xindex>
+    %coo = sparse_tensor.pack %data, %pos, %index
+      : tensor<3xf64>, tensor<2xindex>, tensor<3x2xindex> to tensor<10x10xf64, #SortedCOO>
+
+    // The values buffer may be larger than the number of entries.
+    %csr_data = arith.constant dense<[ 1.0, 2.0, 3.0, 4.0 ]> : tensor<4xf64>
+    %csr_pos32 = arith.constant dense<[ 0, 1, 3 ]> : tensor<3xi32>
+    %csr_index32 = arith.constant dense<[ 1, 0, 1 ]> : tensor<3xi32>
+    %csr = sparse_tensor.pack %csr_data, %csr_pos32, %csr_index32
+      : tensor<4xf64>, tensor<3xi32>, tensor<3xi32> to tensor<2x2xf64, #CSR>
+
+    %dcsr_data = arith.constant dense<[ 4.0, 5.0, 6.0 ]> : tensor<3xf64>
+    %dcsr_pos0 = arith.constant dense<[ 0, 2 ]> : tensor<2xindex>
+    %dcsr_index0 = arith.constant dense<[ 1, 3 ]> : tensor<2xindex>
+    %dcsr_pos1 = arith.constant dense<[ 0, 1, 3 ]> : tensor<3xindex>
+    %dcsr_index1 = arith.constant dense<[ 2, 0, 3 ]> : tensor<3xindex>
+    %dcsr = sparse_tensor.pack %dcsr_data, %dcsr_pos0, %dcsr_index0, %dcsr_pos1, %dcsr_index1
+      : tensor<3xf64>, tensor<2xindex>, tensor<2xindex>, tensor<3xindex>, tensor<3xindex>
+      to tensor<4x4xf64, #DCSR>
+
+    // CHECK:      1
+    // CHECK-NEXT: 2
+    // CHECK-NEXT: 1
+    // CHECK-NEXT: 5
+    // CHECK-NEXT: 6
+    // CHECK-NEXT: 2
+    // CHECK-NEXT: 7
+    // CHECK-NEXT: 8
+    // CHECK-NEXT: 3
+    sparse_tensor.foreach in %coo : tensor<10x10xf64, #SortedCOO> do {
+      ^bb0(%1: index, %2: index, %v: f64) :
+        vector.print %1: index
+        vector.print %2: index
+        vector.print %v: f64
+     }
+
+    // CHECK-NEXT: 0
+    // CHECK-NEXT: 1
+    // CHECK-NEXT: 1
+    // CHECK-NEXT: 1
+    // CHECK-NEXT: 0
+    // CHECK-NEXT: 2
+    // CHECK-NEXT: 1
+    // CHECK-NEXT: 1
+    // CHECK-NEXT: 3
+    sparse_tensor.foreach in %csr : tensor<2x2xf64, #CSR> do {
+      ^bb0(%1: index, %2: index, %v: f64) :
+        vector.print %1: index
+        vector.print %2: index
+        vector.print %v: f64
+     }
+
+    // CHECK-NEXT: 1
+    // CHECK-NEXT: 2
+    // CHECK-NEXT: 4
+    // CHECK-NEXT: 3
+    // CHECK-NEXT: 0
+    // CHECK-NEXT: 5
+    // CHECK-NEXT: 3
+    // CHECK-NEXT: 3
+    // CHECK-NEXT: 6
+    sparse_tensor.foreach in %dcsr : tensor<4x4xf64, #DCSR> do {
+      ^bb0(%1: index, %2: index, %v: f64) :
+        vector.print %1: index
+        vector.print %2: index
+        vector.print %v: f64
+     }
+
+    bufferization.dealloc_tensor %coo : tensor<10x10xf64, #SortedCOO>
+    bufferization.dealloc_tensor %csr : tensor<2x2xf64, #CSR>
+    bufferization.dealloc_tensor %dcsr : tensor<4x4xf64, #DCSR>
+    return
+  }
+}
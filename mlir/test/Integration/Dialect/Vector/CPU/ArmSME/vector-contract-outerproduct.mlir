@@ -0,0 +1,135 @@
+// RUN: mlir-opt %s -enable-arm-streaming="mode=locally enable-za" \
+// RUN:   -convert-vector-to-llvm="enable-arm-sme" -test-lower-to-llvm | \
+// RUN: mlir-translate -mlir-to-llvmir | \
+// RUN: %lli_aarch64_cmd --march=aarch64 --mattr="+sve,+sme" \
+// RUN:   --entry-function=entry \
+// RUN:   --dlopen=%mlir_native_utils_lib_dir/libmlir_c_runner_utils%shlibext | \
+// RUN: FileCheck %s
+
+// NOTE: To run this test, your CPU must support SME.
+
+#lhs_map = affine_map<(m, n, k) -> (k, m)>
+#rhs_map = affine_map<(m, n, k) -> (k, n)>
+#acc_map = affine_map<(m, n, k) -> (m, n)>
+
+// Accumulates the 16 outer products of the rows of 'lhs' and 'rhs' into 'res',
+// which is lowered to 16 'fmopa' into the ZA0.S tile.
+func.func @outerproduct_f32(%lhs : memref<?x?xf32>, %rhs : memref<?x?xf32>,
+                            %res : memref<?x?xf32>) {
+  %c0 = arith.constant 0 : index
+  %pad = arith.constant 0.0 : f32
+  %a = vector.transfer_read %lhs[%c0, %c0], %pad {in_bounds = [true, true]}
+    : memref<?x?xf32>, vector<16x[4]xf32>
+  %b = vector.transfer_read %rhs[%c0, %c0], %pad {in_bounds = [true, true]}
+    : memref<?x?xf32>, vector<16x[4]xf32>
+  %acc = vector.transfer_read %res[%c0, %c0], %pad {in_bounds = [true, true]}
+    : memref<?x?xf32>, vector<[4]x[4]xf32>
+  %0 = vector.contract {indexing_maps = [#lhs_map, #rhs_map, #acc_map],
+                        iterator_types = ["parallel", "parallel", "reduction"],
+                        kind = #vector.kind<add>}
+    %a, %b, %acc : vector<16x[4]xf32>, vector<16x[4]xf32> into vector<[4]x[4]xf32>
+  vector.transfer_write %0, %res[%c0, %c0] {in_bounds = [true, true]}
+    : vector<[4]x[4]xf32>, memref<?x?xf32>
+  return
+}
+
+// Fills the 'rows' x 'cols' memref 'mem' with 'value'.
+func.func @fill(%mem : memref<?x?xf32>, %rows : index, %cols : index,
+                %value : f32) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  scf.for %i = %c0 to %rows step %c1 {
+    scf.for %j = %c0 to %cols step %c1 {
+      memref.store %value, %mem[%i, %j] : memref<?x?xf32>
+    }
+  }
+  return
+}
+
+// Prints the minimum and the maximum of the elements of the 'size' x 'size'
+// memref 'mem'.
+func.func @print_min_max(%mem : memref<?x?xf32>, %size : index) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %inf = arith.constant 0x7F800000 : f32
+  %ninf = arith.constant 0xFF800000 : f32
+  %min, %max = scf.for %i = %c0 to %size step %c1
+      iter_args(%min_i = %inf, %max_i = %ninf) -> (f32, f32) {
+    %min_j, %max_j = scf.for %j = %c0 to %size step %c1
+        iter_args(%min_ij = %min_i, %max_ij = %max_i) -> (f32, f32) {
+      %t = memref.load %mem[%i, %j] : memref<?x?xf32>
+      %min_next = arith.minf %min_ij, %t : f32
+      %max_next = arith.maxf %max_ij, %t : f32
+      scf.yield %min_next, %max_next : f32, f32
+    }
+    scf.yield %min_j, %max_j : f32, f32
+  }
+  vector.print %min : f32
+  vector.print %max : f32
+  return
+}
+
+func.func @entry() -> i32 {
+  %c0 = arith.constant 0 : index
+  %c4 = arith.constant 4 : index
+  %c16 = arith.constant 16 : index
+  %zero = arith.constant 0.0 : f32
+  %one = arith.constant 1.0 : f32
+  %two = arith.constant 2.0 : f32
+
+  // "svl_s" is the number of 32-bit elements in a vector of SVL bits.
+  %vscale = vector.vscale
+  %svl_s = arith.muli %c4, %vscale : index
+
+  %lhs = memref.alloca(%c16, %svl_s) : memref<?x?xf32>
+  %rhs = memref.alloca(%c16, %svl_s) : memref<?x?xf32>
+  %res = memref.alloca(%svl_s, %svl_s) : memref<?x?xf32>
+  call @fill(%lhs, %c16, %svl_s, %one)
+    : (memref<?x?xf32>, index, index, f32) -> ()
+  call @fill(%rhs, %c16, %svl_s, %two)
+    : (memref<?x?xf32>, index, index, f32) -> ()
+  call @fill(%res, %svl_s, %svl_s, %zero)
+    : (memref<?x?xf32>, index, index, f32) -> ()
+
+  // Every element is the sum of 16 products of 1 by 2.
+  call @outerproduct_f32(%lhs, %rhs, %res)
+    : (memref<?x?xf32>, memref<?x?xf32>, memref<?x?xf32>) -> ()
+  // CHECK: 32
+  // CHECK-NEXT: 32
+  call @print_min_max(%res, %svl_s) : (memref<?x?xf32>, index) -> ()
+
+  // The result is accumulated into the elements of 'res'.
+  call @outerproduct_f32(%lhs, %rhs, %res)
+    : (memref<?x?xf32>, memref<?x?xf32>, memref<?x?xf32>) -> ()
+  // CHECK-NEXT: 64
+  // CHECK-NEXT: 64
+  call @print_min_max(%res, %svl_s) : (memref<?x?xf32>, index) -> ()
+
+  // Measure the throughput of the outer products in GFLOP/s, which depends on
+  // the machine and is printed for reference only.
+  %c1 = arith.constant 1 : index
+  %reps = arith.constant 10000 : index
+  %t0 = call @rtclock() : () -> f64
+  scf.for %i = %c0 to %reps step %c1 {
+    func.call @outerproduct_f32(%lhs, %rhs, %res)
+      : (memref<?x?xf32>, memref<?x?xf32>, memref<?x?xf32>) -> ()
+  }
+  %t1 = call @rtclock() : () -> f64
+  %seconds = arith.subf %t1, %t0 : f64
+  %c2 = arith.constant 2 : index
+  %flops_per_rep_0 = arith.muli %c2, %c16 : index
+  %flops_per_rep_1 = arith.muli %flops_per_rep_0, %svl_s : index
+  %flops_per_rep = arith.muli %flops_per_rep_1, %svl_s : index
+  %flops_index = arith.muli %flops_per_rep, %reps : index
+  %flops_i64 = arith.index_cast %flops_index : index to i64
+  %flops = arith.uitofp %flops_i64 : i64 to f64
+  %giga = arith.constant 1.0e9 : f64
+  %gflops_0 = arith.divf %flops, %seconds : f64
+  %gflops = arith.divf %gflops_0, %giga : f64
+  vector.print %gflops : f64
+
+  %c0_i32 = arith.constant 0 : i32
+  return %c0_i32 : i32
+}
+
+func.func private @rtclock() -> f64
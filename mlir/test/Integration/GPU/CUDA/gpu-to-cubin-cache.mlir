@@ -0,0 +1,29 @@
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: mlir-opt %s -gpu-kernel-outlining \
+// RUN: | mlir-opt -pass-pipeline='builtin.module(gpu.module(strip-debuginfo,convert-gpu-to-nvvm,gpu-to-cubin{cache-dir=%t/cache}))' \
+// RUN:   -o %t/first.mlir
+// RUN: ls %t/cache | count 2
+// RUN: mlir-opt %s -gpu-kernel-outlining \
+// RUN: | mlir-opt -pass-pipeline='builtin.module(gpu.module(strip-debuginfo,convert-gpu-to-nvvm,gpu-to-cubin{cache-dir=%t/cache}))' \
+// RUN:   -o %t/second.mlir
+// RUN: ls %t/cache | count 2
+// RUN: diff %t/first.mlir %t/second.mlir
+
+// Each kernel module has its own cache entry, which the second compilation
+// reuses.
+func.func @kernels(%arg0 : f32, %arg1 : memref<?xf32>) {
+  %c1 = arith.constant 1 : index
+  gpu.launch blocks(%bx, %by, %bz) in (%grid_x = %c1, %grid_y = %c1, %grid_z = %c1)
+             threads(%tx, %ty, %tz) in (%block_x = %c1, %block_y = %c1, %block_z = %c1) {
+    memref.store %arg0, %arg1[%tx] : memref<?xf32>
+    gpu.terminator
+  }
+  gpu.launch blocks(%bx, %by, %bz) in (%grid_x = %c1, %grid_y = %c1, %grid_z = %c1)
+             threads(%tx, %ty, %tz) in (%block_x = %c1, %block_y = %c1, %block_z = %c1) {
+    %value = memref.load %arg1[%tx] : memref<?xf32>
+    %sum = arith.addf %value, %arg0 : f32
+    memref.store %sum, %arg1[%tx] : memref<?xf32>
+    gpu.terminator
+  }
+  return
+}
@@ -0,0 +1,48 @@
+// RUN: mlir-opt %s -convert-scf-to-cf -gpu-to-llvm \
+// RUN: | env MLIR_GPU_MEMORY_STATS=1 mlir-cpu-runner \
+// RUN:   --shared-libs=%mlir_cuda_runtime \
+// RUN:   --shared-libs=%mlir_runner_utils \
+// RUN:   --entry-point-result=void -O0 2>&1 \
+// RUN: | FileCheck %s
+// RUN: mlir-opt %s -convert-scf-to-cf -gpu-to-llvm \
+// RUN: | env MLIR_GPU_MEMORY_POOL=0 MLIR_GPU_MEMORY_STATS=1 mlir-cpu-runner \
+// RUN:   --shared-libs=%mlir_cuda_runtime \
+// RUN:   --shared-libs=%mlir_runner_utils \
+// RUN:   --entry-point-result=void -O0 2>&1 \
+// RUN: | FileCheck %s
+
+func.func @main() {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %count = arith.constant 4 : index
+  %h0 = memref.alloc(%count) : memref<?xi32>
+  %h1 = memref.alloc(%count) : memref<?xi32>
+  %v0 = arith.constant 42 : i32
+  scf.for %i = %c0 to %count step %c1 {
+    memref.store %v0, %h0[%i] : memref<?xi32>
+  }
+  %h0_unranked = memref.cast %h0 : memref<?xi32> to memref<*xi32>
+  %h1_unranked = memref.cast %h1 : memref<?xi32> to memref<*xi32>
+  gpu.host_register %h0_unranked : memref<*xi32>
+  gpu.host_register %h1_unranked : memref<*xi32>
+
+  // Copy h0 to h1 through two device buffers, the second of which may reuse
+  // the memory of the first.
+  %t0 = gpu.wait async
+  %b0, %t1 = gpu.alloc async [%t0] (%count) : memref<?xi32>
+  %t2 = gpu.memcpy async [%t1] %b0, %h0 : memref<?xi32>, memref<?xi32>
+  %b1, %t3 = gpu.alloc async [%t2] (%count) : memref<?xi32>
+  %t4 = gpu.memcpy async [%t3] %b1, %b0 : memref<?xi32>, memref<?xi32>
+  %t5 = gpu.dealloc async [%t4] %b0 : memref<?xi32>
+  %t6 = gpu.memcpy async [%t5] %h1, %b1 : memref<?xi32>, memref<?xi32>
+  %t7 = gpu.dealloc async [%t6] %b1 : memref<?xi32>
+  gpu.wait [%t7]
+
+  // CHECK: [42, 42, 42, 42]
+  call @printMemrefI32(%h1_unranked) : (memref<*xi32>) -> ()
+  return
+}
+
+// CHECK: gpu memory: 2 allocations, 2 frees, 32 bytes allocated, 32 bytes peak
+
+func.func private @printMemrefI32(memref<*xi32>)
@@ -0,0 +1,56 @@
+// RUN: mlir-opt %s -gpu-pad-workgroup-memory -gpu-kernel-outlining \
+// RUN:   -expand-strided-metadata -lower-affine \
+// RUN: | mlir-opt -pass-pipeline='builtin.module(gpu.module(strip-debuginfo,convert-gpu-to-nvvm,gpu-to-cubin))' \
+// RUN: | mlir-opt -convert-scf-to-cf -gpu-to-llvm \
+// RUN: | mlir-cpu-runner \
+// RUN:   --shared-libs=%mlir_cuda_runtime \
+// RUN:   --shared-libs=%mlir_runner_utils \
+// RUN:   --entry-point-result=void \
+// RUN: | FileCheck %s
+
+// Transposes a 32x32 matrix through a tile in workgroup memory, which the
+// threads read by column from padded rows.
+func.func @main() {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c32 = arith.constant 32 : index
+  %in = memref.alloc() : memref<32x32xf32>
+  %out = memref.alloc() : memref<32x32xf32>
+  scf.for %i = %c0 to %c32 step %c1 {
+    scf.for %j = %c0 to %c32 step %c1 {
+      %index = arith.muli %i, %c32 : index
+      %linear = arith.addi %index, %j : index
+      %int = arith.index_cast %linear : index to i32
+      %value = arith.sitofp %int : i32 to f32
+      memref.store %value, %in[%i, %j] : memref<32x32xf32>
+    }
+  }
+  %in_unranked = memref.cast %in : memref<32x32xf32> to memref<*xf32>
+  %out_unranked = memref.cast %out : memref<32x32xf32> to memref<*xf32>
+  gpu.host_register %in_unranked : memref<*xf32>
+  gpu.host_register %out_unranked : memref<*xf32>
+
+  gpu.launch blocks(%bx, %by, %bz) in (%gx = %c1, %gy = %c1, %gz = %c1)
+             threads(%tx, %ty, %tz) in (%sx = %c32, %sy = %c32, %sz = %c1)
+             workgroup(%tile : memref<32x32xf32, #gpu.address_space<workgroup>>) {
+    %v = memref.load %in[%ty, %tx] : memref<32x32xf32>
+    memref.store %v, %tile[%ty, %tx] : memref<32x32xf32, #gpu.address_space<workgroup>>
+    gpu.barrier
+    %t = memref.load %tile[%tx, %ty] : memref<32x32xf32, #gpu.address_space<workgroup>>
+    memref.store %t, %out[%ty, %tx] : memref<32x32xf32>
+    gpu.terminator
+  }
+
+  //      CHECK: rank = 2 offset = 0 sizes = [2, 8] strides = [32, 1] data =
+  // CHECK-NEXT: [
+  // CHECK-SAME: [0,   32,   64,   96,   128,   160,   192,   224],
+  // CHECK-NEXT: [1,   33,   65,   97,   129,   161,   193,   225]
+  %rows = memref.subview %out[0, 0] [2, 8] [1, 1]
+    : memref<32x32xf32> to memref<2x8xf32, strided<[32, 1]>>
+  %rows_unranked = memref.cast %rows
+    : memref<2x8xf32, strided<[32, 1]>> to memref<*xf32>
+  call @printMemrefF32(%rows_unranked) : (memref<*xf32>) -> ()
+  return
+}
+
+func.func private @printMemrefF32(memref<*xf32>)
@@ -0,0 +1,8 @@
+// RUN: mlir-opt %s --profile-actions-to=- -test-stats-pass -test-module-pass -o /dev/null | FileCheck %s
+
+// CHECK: [
+// CHECK-NEXT: {"name":"pass-execution","cat":"action","ph":"B","pid":0,"tid":{{[0-9]+}},"ts":{{[0-9.e+]+}},"args":{"desc":"`pass-execution` running `{{.*}}TestStatisticPass` on Operation `builtin.module`","op":"builtin.module"}},
+// CHECK-NEXT: {"name":"pass-execution","cat":"action","ph":"E","pid":0,"tid":{{[0-9]+}},"ts":{{[0-9.e+]+}}},
+// CHECK-NEXT: {"name":"pass-execution","cat":"action","ph":"B","pid":0,"tid":{{[0-9]+}},"ts":{{[0-9.e+]+}},"args":{"desc":"`pass-execution` running `{{.*}}TestModulePass` on Operation `builtin.module`","op":"builtin.module"}},
+// CHECK-NEXT: {"name":"pass-execution","cat":"action","ph":"E","pid":0,"tid":{{[0-9]+}},"ts":{{[0-9.e+]+}}}
+// CHECK-NEXT: ]
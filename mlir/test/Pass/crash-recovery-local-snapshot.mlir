@@ -0,0 +1,40 @@
+// Check that local reproducers only snapshot the operation the failing pass
+// runs on, with declarations of the symbols it references, with and without
+// multi-threading.
+// RUN: mlir-opt %s -pass-pipeline='builtin.module(func.func(test-dynamic-pipeline{op-name=caller dynamic-pipeline=test-pass-failure}))' -mlir-pass-pipeline-crash-reproducer=%t -verify-diagnostics -mlir-pass-pipeline-local-reproducer -mlir-disable-threading
+// RUN: cat %t | FileCheck %s
+// RUN: mlir-opt %s -pass-pipeline='builtin.module(func.func(test-dynamic-pipeline{op-name=caller dynamic-pipeline=test-pass-failure}))' -mlir-pass-pipeline-crash-reproducer=%t -verify-diagnostics -mlir-pass-pipeline-local-reproducer
+// RUN: cat %t | FileCheck %s
+
+module attributes {test.attr} {
+  memref.global "private" constant @global : memref<2xi32> = dense<[1, 2]>
+
+  func.func @callee(%arg0: i32) -> i32 {
+    %0 = arith.addi %arg0, %arg0 : i32
+    return %0 : i32
+  }
+
+  func.func private @external(i32)
+
+  // expected-error@below {{Failures have been detected while processing an MLIR pass pipeline}}
+  // expected-note@below {{Pipeline failed while executing}}
+  func.func @caller(%arg0: i32) -> memref<2xi32> {
+    %0 = call @callee(%arg0) : (i32) -> i32
+    call @external(%0) : (i32) -> ()
+    %1 = memref.get_global @global : memref<2xi32>
+    return %1 : memref<2xi32>
+  }
+
+  func.func @unused() {
+    return
+  }
+}
+
+// CHECK: module attributes {test.attr} {
+// CHECK-NEXT: memref.global "private" constant @global : memref<2xi32> = dense<[1, 2]>
+// CHECK-NEXT: func.func private @callee(i32) -> i32
+// CHECK-NEXT: func.func private @external(i32)
+// CHECK-NEXT: func.func @caller
+// CHECK-NOT: arith.addi
+// CHECK-NOT: @unused
+// CHECK: pipeline: "builtin.module(func.func(test-pass-failure))"
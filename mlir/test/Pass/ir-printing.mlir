@@ -5,6 +5,12 @@
 // RUN: mlir-opt %s -mlir-disable-threading=true -pass-pipeline='builtin.module(func.func(cse,canonicalize))' -mlir-print-ir-before=cse -mlir-print-ir-module-scope -o /dev/null 2>&1 | FileCheck -check-prefix=BEFORE_MODULE %s
 // RUN: mlir-opt %s -mlir-disable-threading=true -pass-pipeline='builtin.module(func.func(cse,cse))' -mlir-print-ir-after-all -mlir-print-ir-after-change -o /dev/null 2>&1 | FileCheck -check-prefix=AFTER_ALL_CHANGE %s
 // RUN: not mlir-opt %s -mlir-disable-threading=true -pass-pipeline='builtin.module(func.func(cse,test-pass-failure))' -mlir-print-ir-after-failure -o /dev/null 2>&1 | FileCheck -check-prefix=AFTER_FAILURE %s
+// RUN: mlir-opt %s -mlir-disable-threading=true -pass-pipeline='builtin.module(func.func(cse,canonicalize))' -mlir-print-ir-after-all -mlir-print-ir-async -o /dev/null 2>&1 | FileCheck -check-prefix=AFTER_ALL %s
+// RUN: mlir-opt %s -mlir-disable-threading=true -pass-pipeline='builtin.module(func.func(cse,canonicalize))' -mlir-print-ir-before=cse -mlir-print-ir-module-scope -mlir-print-ir-async -o /dev/null 2>&1 | FileCheck -check-prefix=BEFORE_MODULE %s
+// RUN: rm -rf %t && mkdir -p %t
+// RUN: mlir-opt %s -mlir-disable-threading=true -pass-pipeline='builtin.module(func.func(cse,canonicalize))' -mlir-print-ir-after=cse -mlir-print-ir-bytecode-dir=%t -mlir-print-ir-async -o /dev/null 2>&1 | FileCheck -check-prefix=AFTER_BYTECODE %s
+// RUN: mlir-opt %t/0000_after_cse.mlirbc | FileCheck -check-prefix=AFTER_BYTECODE_FOO %s
+// RUN: mlir-opt %t/0001_after_cse.mlirbc | FileCheck -check-prefix=AFTER_BYTECODE_BAR %s
 
 func.func @foo() {
   %0 = arith.constant 0 : i32
@@ -65,3 +71,13 @@ func.func @bar() {
 // AFTER_FAILURE-NOT: // -----// IR Dump After{{.*}}CSE
 // AFTER_FAILURE: // -----// IR Dump After{{.*}}TestFailurePass Failed (test-pass-failure) //----- //
 // AFTER_FAILURE: func @foo()
+
+// AFTER_BYTECODE: // -----// IR Dump After{{.*}}CSE (cse) //----- //
+// AFTER_BYTECODE-NEXT: // written to '{{.*}}0000_after_cse.mlirbc'
+// AFTER_BYTECODE: // -----// IR Dump After{{.*}}CSE (cse) //----- //
+// AFTER_BYTECODE-NEXT: // written to '{{.*}}0001_after_cse.mlirbc'
+// AFTER_BYTECODE-NOT: // -----// IR Dump After{{.*}}Canonicalizer
+
+// AFTER_BYTECODE_FOO: func @foo()
+// AFTER_BYTECODE_FOO-NOT: arith.constant
+// AFTER_BYTECODE_BAR: func @bar()
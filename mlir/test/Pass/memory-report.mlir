@@ -0,0 +1,20 @@
+// RUN: mlir-opt %s -mlir-disable-threading=true -pass-pipeline='builtin.module(func.func(cse,canonicalize),symbol-dce)' -mlir-memory-report -o /dev/null 2>&1 | FileCheck %s
+// RUN: mlir-opt %s -mlir-disable-threading=false -pass-pipeline='builtin.module(func.func(cse,canonicalize),symbol-dce)' -mlir-memory-report -o /dev/null 2>&1 | FileCheck %s
+
+// The nested passes run once per function, and the adaptors are not reported.
+// CHECK: Pass Memory Report
+// CHECK: Malloc(KB) Attrs(KB) Locs(KB) Types(KB) Blobs(KB) Ops Runs Name
+// CHECK-NOT: Pipeline
+// CHECK: {{-?[0-9]+\.[0-9]}} {{-?[0-9]+\.[0-9]}} {{-?[0-9]+\.[0-9]}} {{-?[0-9]+\.[0-9]}} 0.0 -1 2 CSE
+// CHECK-NEXT: {{-?[0-9]+\.[0-9]}} {{-?[0-9]+\.[0-9]}} {{-?[0-9]+\.[0-9]}} {{-?[0-9]+\.[0-9]}} 0.0 0 2 Canonicalizer
+// CHECK-NEXT: {{-?[0-9]+\.[0-9]}} {{-?[0-9]+\.[0-9]}} {{-?[0-9]+\.[0-9]}} {{-?[0-9]+\.[0-9]}} 0.0 -2 1 SymbolDCE
+
+func.func @foo(%arg0: i32) -> i32 {
+  %0 = arith.addi %arg0, %arg0 : i32
+  %1 = arith.addi %arg0, %arg0 : i32
+  return %0 : i32
+}
+
+func.func private @bar() {
+  return
+}
@@ -2,6 +2,7 @@
 // RUN: mlir-opt %s -mlir-disable-threading=true -verify-each=true -pass-pipeline='builtin.module(func.func(cse,canonicalize,cse))' -mlir-timing -mlir-timing-display=tree 2>&1 | FileCheck -check-prefix=PIPELINE %s
 // RUN: mlir-opt %s -mlir-disable-threading=false -verify-each=true -pass-pipeline='builtin.module(func.func(cse,canonicalize,cse))' -mlir-timing -mlir-timing-display=list 2>&1 | FileCheck -check-prefix=MT_LIST %s
 // RUN: mlir-opt %s -mlir-disable-threading=false -verify-each=true -pass-pipeline='builtin.module(func.func(cse,canonicalize,cse))' -mlir-timing -mlir-timing-display=tree 2>&1 | FileCheck -check-prefix=MT_PIPELINE %s
+// RUN: mlir-opt %s -mlir-disable-threading=false -verify-each=true -pass-pipeline='builtin.module(func.func(cse,canonicalize,cse))' -mlir-timing -mlir-timing-display=trace 2>&1 | FileCheck -check-prefix=TRACE %s
 // RUN: mlir-opt %s -mlir-disable-threading=true -verify-each=false -test-pm-nested-pipeline -mlir-timing -mlir-timing-display=tree 2>&1 | FileCheck -check-prefix=NESTED_PIPELINE %s
 
 // LIST: Execution time report
@@ -48,6 +49,16 @@
 // MT_PIPELINE-NEXT: Rest
 // MT_PIPELINE-NEXT: Total
 
+// TRACE:      "traceEvents": [
+// TRACE-DAG:    "name": "Parser"
+// TRACE-DAG:    "name": "'func.func' Pipeline"
+// TRACE-DAG:    "name": "CSE"
+// TRACE-DAG:    "name": "Canonicalizer"
+// TRACE-DAG:    "name": "(A) DominanceInfo"
+// TRACE-DAG:    "ph": "X"
+// TRACE-DAG:    "tid":
+// TRACE:      "displayTimeUnit": "ms"
+
 // NESTED_PIPELINE: Execution time report
 // NESTED_PIPELINE: Total Execution Time:
 // NESTED_PIPELINE: Name
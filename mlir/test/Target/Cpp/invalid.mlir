@@ -57,3 +57,24 @@ func.func @non_static_shape(%arg0 : tensor<?xf32>) {
 func.func @unranked_tensor(%arg0 : tensor<*xf32>) {
   return
 }
+
+// -----
+
+func.func @parallel_reduction(%arg0: index, %arg1: f32) -> f32 {
+  // expected-error@+1 {{'scf.parallel' op with reductions is not supported}}
+  %0 = scf.parallel (%i) = (%arg0) to (%arg0) step (%arg0) init (%arg1) -> f32 {
+    scf.reduce(%arg1) : f32 {
+    ^bb0(%lhs: f32, %rhs: f32):
+      scf.reduce.return %lhs : f32
+    }
+    scf.yield
+  }
+  return %0 : f32
+}
+
+// -----
+
+// expected-error@+1 {{cannot emit vector type 'vector<4x4xf32>'}}
+func.func @multi_dimensional_vector_type(%arg0 : vector<4x4xf32>) {
+  return
+}
@@ -0,0 +1,48 @@
+// RUN: mlir-translate -mlir-to-cpp %s | FileCheck %s -check-prefix=CPP-DEFAULT
+// RUN: mlir-translate -mlir-to-cpp -declare-variables-at-top %s | FileCheck %s -check-prefix=CPP-DECLTOP
+
+func.func @restrict_aligned(%arg0: !emitc.ptr<f32> {llvm.noalias, llvm.align = 16 : i64},
+                            %arg1: !emitc.ptr<f32> {llvm.noalias},
+                            %arg2: i32 {llvm.noalias}) {
+  return
+}
+// CPP-DEFAULT: void restrict_aligned(float* __restrict [[V1:[^ ]*]], float* __restrict [[V2:[^ ]*]], int32_t [[V3:[^ ]*]]) {
+// CPP-DEFAULT-NEXT: [[V1]] = (float*) __builtin_assume_aligned([[V1]], 16);
+// CPP-DEFAULT-NEXT: return;
+
+func.func @parallel(%arg0: index, %arg1: index, %arg2: index) {
+  scf.parallel (%i, %j) = (%arg0, %arg0) to (%arg1, %arg1) step (%arg2, %arg2) {
+    %0 = emitc.call "f"(%i, %j) : (index, index) -> i32
+  }
+  return
+}
+// CPP-DEFAULT: void parallel(size_t [[START:[^ ]*]], size_t [[STOP:[^ ]*]], size_t [[STEP:[^ ]*]]) {
+// CPP-DEFAULT-NEXT: for (size_t [[I:[^ ]*]] = [[START]]; [[I]] < [[STOP]]; [[I]] += [[STEP]]) {
+// CPP-DEFAULT-NEXT: #pragma omp simd
+// CPP-DEFAULT-NEXT: for (size_t [[J:[^ ]*]] = [[START]]; [[J]] < [[STOP]]; [[J]] += [[STEP]]) {
+// CPP-DEFAULT-NEXT: int32_t [[V:[^ ]*]] = f([[I]], [[J]]);
+// CPP-DEFAULT-NEXT: }
+// CPP-DEFAULT-NEXT: }
+// CPP-DEFAULT-NEXT: return;
+
+// CPP-DECLTOP: void parallel(size_t [[START:[^ ]*]], size_t [[STOP:[^ ]*]], size_t [[STEP:[^ ]*]]) {
+// CPP-DECLTOP-NEXT: int32_t [[V:[^ ]*]];
+// CPP-DECLTOP-NEXT: for (size_t [[I:[^ ]*]] = [[START]]; [[I]] < [[STOP]]; [[I]] += [[STEP]]) {
+// CPP-DECLTOP-NEXT: #pragma omp simd
+// CPP-DECLTOP-NEXT: for (size_t [[J:[^ ]*]] = [[START]]; [[J]] < [[STOP]]; [[J]] += [[STEP]]) {
+// CPP-DECLTOP-NEXT: [[V]] = f([[I]], [[J]]);
+// CPP-DECLTOP-NEXT: }
+// CPP-DECLTOP-NEXT: }
+// CPP-DECLTOP-NEXT: return;
+
+func.func @vectors(%arg0: vector<4xf32>) -> vector<8xi16> {
+  %0 = arith.constant dense<[1.0, 2.0, 3.0, 4.0]> : vector<4xf32>
+  %1 = emitc.add %arg0, %0 : (vector<4xf32>, vector<4xf32>) -> vector<4xf32>
+  %2 = arith.constant dense<7> : vector<8xi16>
+  return %2 : vector<8xi16>
+}
+// CPP-DEFAULT: int16_t __attribute__((vector_size(16))) vectors(float __attribute__((vector_size(16))) [[V1:[^ ]*]]) {
+// CPP-DEFAULT-NEXT: float __attribute__((vector_size(16))) [[V2:[^ ]*]] = {(float)1.000000000e+00, (float)2.000000000e+00, (float)3.000000000e+00, (float)4.000000000e+00};
+// CPP-DEFAULT-NEXT: float __attribute__((vector_size(16))) [[V3:[^ ]*]] = [[V1]] + [[V2]];
+// CPP-DEFAULT-NEXT: int16_t __attribute__((vector_size(16))) [[V4:[^ ]*]] = {7, 7, 7, 7, 7, 7, 7, 7};
+// CPP-DEFAULT-NEXT: return [[V4]];
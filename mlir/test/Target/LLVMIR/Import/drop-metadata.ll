@@ -0,0 +1,46 @@
+; RUN: mlir-translate -import-llvm -mlir-print-debuginfo -drop-debug-info -drop-loop-annotations %s | FileCheck %s
+
+; The debug information and the loop annotations are dropped, while the other
+; metadata is still imported.
+
+; CHECK: llvm.metadata @__llvm_global_metadata
+; CHECK-NOT: llvm.access_group
+; CHECK: llvm.tbaa_root
+
+; CHECK-LABEL: llvm.func @drop_metadata
+; CHECK-NOT: llvm.intr.dbg.value
+; CHECK: llvm.load {{.*}}tbaa = [@__llvm_global_metadata::@{{.*}}]{{.*}} loc(#[[$MODULELOC:.*]])
+; CHECK: llvm.br ^{{.*}} loc(#[[$MODULELOC]])
+; CHECK-NOT: loop_annotation
+; CHECK-NOT: access_groups
+define void @drop_metadata(ptr %arg, i64 %n) !dbg !3 {
+entry:
+  call void @llvm.dbg.value(metadata ptr %arg, metadata !5, metadata !DIExpression()), !dbg !7
+  %0 = load i32, ptr %arg, !tbaa !10, !dbg !7
+  br label %loop, !dbg !7
+loop:
+  %1 = load i32, ptr %arg, !llvm.access.group !8, !dbg !7
+  br label %loop, !llvm.loop !9
+}
+
+; CHECK: #[[$MODULELOC]] = loc({{.*}}drop-metadata.ll{{.*}}:0:0)
+; CHECK-NOT: #llvm.di_
+
+declare void @llvm.dbg.value(metadata, metadata, metadata)
+
+!llvm.dbg.cu = !{!1}
+!llvm.module.flags = !{!0}
+!0 = !{i32 2, !"Debug Info Version", i32 3}
+!1 = distinct !DICompileUnit(language: DW_LANG_C, file: !2)
+!2 = !DIFile(filename: "debug-info.ll", directory: "/")
+!3 = distinct !DISubprogram(name: "drop_metadata", scope: !2, file: !2, spFlags: DISPFlagDefinition, unit: !1)
+!4 = !DIBasicType(name: "ptr", size: 64)
+!5 = !DILocalVariable(scope: !3, name: "arg", file: !2, line: 1, arg: 1, type: !4)
+!7 = !DILocation(line: 1, column: 2, scope: !3)
+!8 = distinct !{}
+!9 = distinct !{!9, !11, !12}
+!10 = !{!13, !13, i64 0}
+!11 = !{!"llvm.loop.disable_nonforced"}
+!12 = !{!"llvm.loop.parallel_accesses", !8}
+!13 = !{!"scalar type", !14, i64 0}
+!14 = !{!"Simple C/C++ TBAA"}
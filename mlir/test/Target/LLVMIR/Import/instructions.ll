@@ -1,4 +1,5 @@
 ; RUN: mlir-translate -import-llvm -split-input-file %s | FileCheck %s
+; RUN: mlir-translate -import-llvm -parallel-import -split-input-file %s | FileCheck %s
 
 ; CHECK-LABEL: @integer_arith
 ; CHECK-SAME:  %[[ARG1:[a-zA-Z0-9]+]]
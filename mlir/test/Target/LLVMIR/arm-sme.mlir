@@ -228,6 +228,21 @@ llvm.func @arm_sme_store(%nxv1i1  : vector<[1]xi1>,
 
 // -----
 
+// CHECK-LABEL: @arm_sme_tile_slice_moves
+llvm.func @arm_sme_tile_slice_moves(%nxv4f32 : vector<[4]xf32>,
+                                    %nxv4i1  : vector<[4]xi1>) {
+  %c0 = llvm.mlir.constant(0 : index) : i32
+  // CHECK: call void @llvm.aarch64.sme.write.horiz.nxv4f32
+  "arm_sme.intr.write.horiz"(%c0, %c0, %nxv4i1, %nxv4f32) :
+              (i32, i32, vector<[4]xi1>, vector<[4]xf32>) -> ()
+  // CHECK: call <vscale x 4 x float> @llvm.aarch64.sme.read.horiz.nxv4f32
+  %0 = "arm_sme.intr.read.horiz"(%nxv4f32, %nxv4i1, %c0, %c0) :
+              (vector<[4]xf32>, vector<[4]xi1>, i32, i32) -> vector<[4]xf32>
+  llvm.return
+}
+
+// -----
+
 // CHECK-LABEL: @arm_sme_toggle_za
 llvm.func @arm_sme_toggle_za() {
   // CHECK: call void @llvm.aarch64.sme.za.enable()
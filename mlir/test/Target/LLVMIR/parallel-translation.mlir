@@ -0,0 +1,68 @@
+// RUN: mlir-translate -mlir-to-llvmir -mlir-to-llvmir-shards=3 %s | FileCheck %s
+// RUN: mlir-translate -mlir-to-llvmir -mlir-to-llvmir-shards=3 %s | \
+// RUN:   FileCheck %s --check-prefix=DEFS
+
+// The definitions split over the shards are linked back into one module, and
+// reference the globals and the functions of the other shards.
+
+// CHECK: target datalayout = "e-i64:64"
+// CHECK: target triple = "x86_64-unknown-linux-gnu"
+// CHECK-DAG: @counter = global i32 0
+// CHECK-DAG: @table = internal constant [2 x i32] [i32 1, i32 2]
+// CHECK-DAG: @extern = external global i32
+module attributes {llvm.data_layout = "e-i64:64",
+                   llvm.target_triple = "x86_64-unknown-linux-gnu"} {
+  llvm.mlir.global external @counter(0 : i32) : i32
+  llvm.mlir.global internal constant @table(dense<[1, 2]> : vector<2xi32>) : !llvm.array<2 x i32>
+  llvm.mlir.global external @extern() : i32
+
+  llvm.func @callee(i32) -> i32
+
+  // CHECK-DAG: define i32 @increment(i32 %{{.*}})
+  // CHECK-DAG: load i32, ptr @counter
+  llvm.func @increment(%arg0: i32) -> i32 {
+    %0 = llvm.mlir.addressof @counter : !llvm.ptr
+    %1 = llvm.load %0 : !llvm.ptr -> i32
+    %2 = llvm.add %1, %arg0 : i32
+    llvm.store %2, %0 : i32, !llvm.ptr
+    llvm.return %2 : i32
+  }
+
+  // CHECK-DAG: define i32 @twice(i32 %{{.*}})
+  // CHECK-DAG: call i32 @increment(i32
+  llvm.func @twice(%arg0: i32) -> i32 {
+    %0 = llvm.call @increment(%arg0) : (i32) -> i32
+    %1 = llvm.call @increment(%0) : (i32) -> i32
+    llvm.return %1 : i32
+  }
+
+  // CHECK-DAG: define i32 @read_extern()
+  // CHECK-DAG: call i32 @callee(i32
+  llvm.func @read_extern() -> i32 {
+    %0 = llvm.mlir.addressof @extern : !llvm.ptr
+    %1 = llvm.load %0 : !llvm.ptr -> i32
+    %2 = llvm.call @callee(%1) : (i32) -> i32
+    llvm.return %2 : i32
+  }
+
+  // The definitions that reference internal symbols are kept in the first
+  // shard.
+  // CHECK-DAG: define i32 @read_table()
+  // CHECK-DAG: getelementptr {{.*}}@table
+  llvm.func @read_table() -> i32 {
+    %0 = llvm.mlir.addressof @table : !llvm.ptr
+    %1 = llvm.getelementptr %0[0, 1] : (!llvm.ptr) -> !llvm.ptr, !llvm.array<2 x i32>
+    %2 = llvm.load %1 : !llvm.ptr -> i32
+    llvm.return %2 : i32
+  }
+
+  // CHECK-DAG: define internal i32 @helper()
+  llvm.func internal @helper() -> i32 {
+    %0 = llvm.call @read_table() : () -> i32
+    llvm.return %0 : i32
+  }
+}
+
+// Every function is defined exactly once.
+// DEFS-COUNT-5: define
+// DEFS-NOT: define
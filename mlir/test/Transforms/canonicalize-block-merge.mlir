@@ -275,3 +275,29 @@ func.func @mismatch_dominance() -> i32 {
 ^bb4(%3: i32):
   return %3 : i32
 }
+
+// -----
+
+// Check that merging a pair of blocks revisits their predecessors, which may
+// become identical once they branch to the same block.
+
+// CHECK-LABEL: func @cascading_merge(
+func.func @cascading_merge(%cond : i1, %arg0 : i32) -> i32 {
+  // CHECK: %[[RES:.*]] = "foo.op"
+  // CHECK-NEXT: return %[[RES]]
+  cf.cond_br %cond, ^bb1, ^bb2
+
+^bb1:
+  cf.br ^bb3
+
+^bb2:
+  cf.br ^bb4
+
+^bb3:
+  %0 = "foo.op"(%arg0) : (i32) -> i32
+  return %0 : i32
+
+^bb4:
+  %1 = "foo.op"(%arg0) : (i32) -> i32
+  return %1 : i32
+}
@@ -0,0 +1,46 @@
+// RUN: mlir-opt %s -pass-pipeline='builtin.module(canonicalize{parallel-isolated-regions=true})' | FileCheck %s
+// RUN: mlir-opt %s -pass-pipeline='builtin.module(canonicalize{parallel-isolated-regions=true top-down=false})' | FileCheck %s
+// RUN: mlir-opt %s -pass-pipeline='builtin.module(canonicalize{parallel-isolated-regions=true})' -mlir-disable-threading | FileCheck %s
+
+// CHECK-LABEL: func @fold_add
+func.func @fold_add() -> i32 {
+  // CHECK-NEXT: %[[C:.*]] = arith.constant 3 : i32
+  // CHECK-NEXT: return %[[C]]
+  %0 = arith.constant 1 : i32
+  %1 = arith.constant 2 : i32
+  %2 = arith.addi %0, %1 : i32
+  return %2 : i32
+}
+
+// CHECK-LABEL: func @fold_mul
+func.func @fold_mul() -> i32 {
+  // CHECK-NEXT: %[[C:.*]] = arith.constant 6 : i32
+  // CHECK-NEXT: return %[[C]]
+  %0 = arith.constant 2 : i32
+  %1 = arith.constant 3 : i32
+  %2 = arith.muli %0, %1 : i32
+  return %2 : i32
+}
+
+// Ops nested in an isolated op that is itself nested are simplified too.
+// CHECK-LABEL: module @nested
+module @nested {
+  // CHECK-LABEL: func @fold_sub
+  func.func @fold_sub() -> i32 {
+    // CHECK-NEXT: %[[C:.*]] = arith.constant 1 : i32
+    // CHECK-NEXT: return %[[C]]
+    %0 = arith.constant 3 : i32
+    %1 = arith.constant 2 : i32
+    %2 = arith.subi %0, %1 : i32
+    return %2 : i32
+  }
+  // CHECK-LABEL: func @fold_xor
+  func.func @fold_xor() -> i32 {
+    // CHECK-NEXT: %[[C:.*]] = arith.constant 0 : i32
+    // CHECK-NEXT: return %[[C]]
+    %0 = arith.constant 5 : i32
+    %1 = arith.xori %0, %0 : i32
+    return %1 : i32
+  }
+}
+
@@ -0,0 +1,17 @@
+// RUN: mlir-opt %s -pass-pipeline='builtin.module(func.func(canonicalize{profile-patterns=true}))' -mlir-disable-threading -o /dev/null 2>&1 | FileCheck %s
+
+// CHECK: Pattern Application Profile
+// CHECK: Time (s)  Attempts  Successes  Name
+// CHECK: {{[0-9]+\.[0-9]+ +[0-9]+ +1}}  {{.*}}AddIAddConstant
+// CHECK: Fold Profile
+// CHECK: Time (s)  Attempts  Successes  Name
+// CHECK-DAG: {{[0-9]+\.[0-9]+ +[0-9]+ +[0-9]+}}  arith.addi
+// CHECK-DAG: {{[0-9]+\.[0-9]+ +[0-9]+ +[0-9]+}}  func.return
+
+func.func @add_add_constant(%arg0: i32) -> i32 {
+  %c1 = arith.constant 1 : i32
+  %c2 = arith.constant 2 : i32
+  %0 = arith.addi %arg0, %c1 : i32
+  %1 = arith.addi %0, %c2 : i32
+  return %1 : i32
+}
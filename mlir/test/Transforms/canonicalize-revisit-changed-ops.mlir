@@ -0,0 +1,34 @@
+// RUN: mlir-opt %s -pass-pipeline='builtin.module(func.func(canonicalize{revisit-changed-ops=true}))' | FileCheck %s
+// RUN: mlir-opt %s -pass-pipeline='builtin.module(func.func(canonicalize{revisit-changed-ops=true top-down=false}))' | FileCheck %s
+
+// CHECK-LABEL: func @fold_chain
+func.func @fold_chain(%arg0: i32) -> i32 {
+  // CHECK-NEXT: %[[C:.*]] = arith.constant 9 : i32
+  // CHECK-NEXT: %[[ADD:.*]] = arith.addi %{{.*}}, %[[C]] : i32
+  // CHECK-NEXT: return %[[ADD]]
+  %0 = arith.constant 1 : i32
+  %1 = arith.constant 2 : i32
+  %2 = arith.addi %0, %1 : i32
+  %3 = arith.muli %2, %2 : i32
+  %4 = arith.addi %arg0, %3 : i32
+  return %4 : i32
+}
+
+// The region simplification erases the unreachable block, which makes the
+// next iteration rescan the region.
+// CHECK-LABEL: func @simplify_region
+func.func @simplify_region(%arg0: i32) -> i32 {
+  // CHECK-NEXT: %[[C:.*]] = arith.constant 3 : i32
+  // CHECK-NEXT: %[[ADD:.*]] = arith.addi %{{.*}}, %[[C]] : i32
+  // CHECK-NEXT: return %[[ADD]]
+  %true = arith.constant true
+  %0 = arith.constant 1 : i32
+  %1 = arith.constant 2 : i32
+  cf.cond_br %true, ^bb1(%0 : i32), ^bb2
+^bb1(%2: i32):
+  %3 = arith.addi %2, %1 : i32
+  %4 = arith.addi %arg0, %3 : i32
+  return %4 : i32
+^bb2:
+  return %arg0 : i32
+}
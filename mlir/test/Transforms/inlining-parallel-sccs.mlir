@@ -0,0 +1,53 @@
+// RUN: mlir-opt %s -inline='parallel-sccs' | FileCheck %s
+// RUN: mlir-opt %s --mlir-disable-threading -inline='parallel-sccs' | FileCheck %s
+
+// Check that the SCCs are processed bottom up when independent SCCs of the
+// callgraph are processed together.
+
+// CHECK-NOT: func private @leaf_a
+func.func private @leaf_a() -> i32 {
+  %c1 = arith.constant 1 : i32
+  return %c1 : i32
+}
+
+// CHECK-NOT: func private @leaf_b
+func.func private @leaf_b() -> i32 {
+  %c2 = arith.constant 2 : i32
+  return %c2 : i32
+}
+
+// CHECK-NOT: func private @mid_a
+func.func private @mid_a() -> i32 {
+  %0 = call @leaf_a() : () -> i32
+  %1 = call @leaf_b() : () -> i32
+  %2 = arith.addi %0, %1 : i32
+  return %2 : i32
+}
+
+// CHECK-NOT: func private @mid_b
+func.func private @mid_b() -> i32 {
+  %0 = call @leaf_b() : () -> i32
+  %1 = arith.muli %0, %0 : i32
+  return %1 : i32
+}
+
+// CHECK-LABEL: func @root(
+// CHECK-NEXT:    %[[CST:.*]] = arith.constant 7 : i32
+// CHECK-NEXT:    return %[[CST]]
+func.func @root() -> i32 {
+  %0 = call @mid_a() : () -> i32
+  %1 = call @mid_b() : () -> i32
+  %2 = arith.addi %0, %1 : i32
+  return %2 : i32
+}
+
+// Recursive SCCs are not inlined into themselves.
+
+// CHECK-LABEL: func @recursive(
+// CHECK:         call @recursive
+func.func @recursive(%arg0 : i32) -> i32 {
+  %0 = call @recursive(%arg0) : (i32) -> i32
+  %1 = call @leaf_a() : () -> i32
+  %2 = arith.addi %0, %1 : i32
+  return %2 : i32
+}
@@ -0,0 +1,117 @@
+// RUN: mlir-opt %s -split-input-file -loop-invariant-code-motion="hoist-reads" | FileCheck %s
+
+// CHECK-LABEL: func @hoist_read_of_unwritten_memref
+func.func @hoist_read_of_unwritten_memref() {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  %a = memref.alloc() : memref<8xf32>
+  %b = memref.alloc() : memref<8xf32>
+  // CHECK: %[[A:.*]] = memref.alloc
+  // CHECK: memref.load %[[A]]
+  // CHECK-NEXT: scf.for
+  // CHECK-NOT: memref.load
+  // CHECK: memref.store
+  scf.for %i = %c0 to %c8 step %c1 {
+    %v = memref.load %a[%c0] : memref<8xf32>
+    memref.store %v, %b[%i] : memref<8xf32>
+  }
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @hoist_read_out_of_nested_loops
+func.func @hoist_read_out_of_nested_loops() {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  %a = memref.alloc() : memref<8xf32>
+  %b = memref.alloc() : memref<8x8xf32>
+  // CHECK: memref.load
+  // CHECK-NEXT: arith.addf
+  // CHECK-NEXT: scf.for
+  // CHECK-NEXT: scf.for
+  // CHECK-NEXT: memref.store
+  scf.for %i = %c0 to %c8 step %c1 {
+    scf.for %j = %c0 to %c8 step %c1 {
+      %v = memref.load %a[%c1] : memref<8xf32>
+      %w = arith.addf %v, %v : f32
+      memref.store %w, %b[%i, %j] : memref<8x8xf32>
+    }
+  }
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @no_hoist_read_of_written_memref
+func.func @no_hoist_read_of_written_memref() {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  %a = memref.alloc() : memref<8xf32>
+  // CHECK: scf.for
+  // CHECK-NEXT: memref.load
+  // CHECK-NEXT: memref.store
+  scf.for %i = %c0 to %c8 step %c1 {
+    %v = memref.load %a[%c0] : memref<8xf32>
+    memref.store %v, %a[%i] : memref<8xf32>
+  }
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @no_hoist_read_of_may_alias_memref
+func.func @no_hoist_read_of_may_alias_memref(%a: memref<8xf32>,
+                                             %b: memref<8xf32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  // CHECK: scf.for
+  // CHECK-NEXT: memref.load
+  scf.for %i = %c0 to %c8 step %c1 {
+    %v = memref.load %a[%c0] : memref<8xf32>
+    memref.store %v, %b[%i] : memref<8xf32>
+  }
+  return
+}
+
+// -----
+
+// CHECK-LABEL: func @no_hoist_read_with_unknown_effects
+func.func @no_hoist_read_with_unknown_effects() {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  %a = memref.alloc() : memref<8xf32>
+  // CHECK: scf.for
+  // CHECK-NEXT: memref.load
+  scf.for %i = %c0 to %c8 step %c1 {
+    %v = memref.load %a[%c0] : memref<8xf32>
+    func.call @external(%v) : (f32) -> ()
+  }
+  return
+}
+
+func.func private @external(f32)
+
+// -----
+
+// The loop may not execute, in which case the load may be out of bounds.
+
+// CHECK-LABEL: func @no_hoist_read_out_of_maybe_empty_loop
+func.func @no_hoist_read_out_of_maybe_empty_loop(%n: index) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %a = memref.alloc() : memref<8xf32>
+  %b = memref.alloc() : memref<8xf32>
+  // CHECK: scf.for
+  // CHECK-NEXT: memref.load
+  scf.for %i = %c0 to %n step %c1 {
+    %v = memref.load %a[%c0] : memref<8xf32>
+    memref.store %v, %b[%i] : memref<8xf32>
+  }
+  return
+}
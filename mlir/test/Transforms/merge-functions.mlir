@@ -0,0 +1,115 @@
+// RUN: mlir-opt -allow-unregistered-dialect %s -merge-functions -split-input-file | FileCheck %s
+
+// Check that identical private functions are merged into the first one.
+
+// CHECK-LABEL: func private @add_a
+// CHECK-NOT: func private @add_b
+// CHECK-LABEL: func @caller
+// CHECK: call @add_a
+// CHECK: call @add_a
+func.func private @add_a(%arg0: i32) -> i32 {
+  %0 = arith.addi %arg0, %arg0 : i32
+  return %0 : i32
+}
+func.func private @add_b(%arg0: i32) -> i32 {
+  %0 = arith.addi %arg0, %arg0 : i32
+  return %0 : i32
+}
+func.func @caller(%arg0: i32) -> (i32, i32) {
+  %0 = call @add_a(%arg0) : (i32) -> i32
+  %1 = call @add_b(%arg0) : (i32) -> i32
+  return %0, %1 : i32, i32
+}
+
+// -----
+
+// Check that public functions are kept, and preferred over private ones.
+
+// CHECK-NOT: func private @mul_private
+// CHECK-LABEL: func @mul_public_a
+// CHECK-LABEL: func @mul_public_b
+// CHECK-LABEL: func @caller
+// CHECK: call @mul_public_a
+func.func private @mul_private(%arg0: i32) -> i32 {
+  %0 = arith.muli %arg0, %arg0 : i32
+  return %0 : i32
+}
+func.func @mul_public_a(%arg0: i32) -> i32 {
+  %0 = arith.muli %arg0, %arg0 : i32
+  return %0 : i32
+}
+func.func @mul_public_b(%arg0: i32) -> i32 {
+  %0 = arith.muli %arg0, %arg0 : i32
+  return %0 : i32
+}
+func.func @caller(%arg0: i32) -> i32 {
+  %0 = call @mul_private(%arg0) : (i32) -> i32
+  return %0 : i32
+}
+
+// -----
+
+// Check that functions that differ in their bodies, signatures or attributes
+// aren't merged.
+
+// CHECK-LABEL: func private @sub
+// CHECK-LABEL: func private @add
+// CHECK-LABEL: func private @add_i64
+// CHECK-LABEL: func private @add_attr
+func.func private @sub(%arg0: i32) -> i32 {
+  %0 = arith.subi %arg0, %arg0 : i32
+  return %0 : i32
+}
+func.func private @add(%arg0: i32) -> i32 {
+  %0 = arith.addi %arg0, %arg0 : i32
+  return %0 : i32
+}
+func.func private @add_i64(%arg0: i64) -> i64 {
+  %0 = arith.addi %arg0, %arg0 : i64
+  return %0 : i64
+}
+func.func private @add_attr(%arg0: i32) -> i32 attributes {foo} {
+  %0 = arith.addi %arg0, %arg0 : i32
+  return %0 : i32
+}
+func.func @caller(%arg0: i32, %arg1: i64) {
+  %0 = call @sub(%arg0) : (i32) -> i32
+  %1 = call @add(%arg0) : (i32) -> i32
+  %2 = call @add_i64(%arg1) : (i64) -> i64
+  %3 = call @add_attr(%arg0) : (i32) -> i32
+  return
+}
+
+// -----
+
+// Check that callers that become identical after redirecting the uses of the
+// merged functions are merged as well.
+
+// CHECK-LABEL: func private @leaf_a
+// CHECK-NOT: func private @leaf_b
+// CHECK-LABEL: func private @mid_a
+// CHECK-NOT: func private @mid_b
+// CHECK-LABEL: func @caller
+// CHECK: call @mid_a
+// CHECK: call @mid_a
+func.func private @leaf_a() {
+  "foo.op"() : () -> ()
+  return
+}
+func.func private @leaf_b() {
+  "foo.op"() : () -> ()
+  return
+}
+func.func private @mid_a() {
+  call @leaf_a() : () -> ()
+  return
+}
+func.func private @mid_b() {
+  call @leaf_b() : () -> ()
+  return
+}
+func.func @caller() {
+  call @mid_a() : () -> ()
+  call @mid_b() : () -> ()
+  return
+}
@@ -0,0 +1,71 @@
+// RUN: mlir-opt -allow-unregistered-dialect %s -split-input-file \
+// RUN:   -affine-pipeline-data-transfer="max-buffers=3 fast-mem-capacity=1" | \
+// RUN:   FileCheck %s
+// RUN: mlir-opt -allow-unregistered-dialect %s -split-input-file \
+// RUN:   -affine-pipeline-data-transfer="max-buffers=4" | \
+// RUN:   FileCheck %s --check-prefix=DLTI
+
+// The explicit capacity of 1 KiB overrides the scratchpad size of the data
+// layout: the buffers and the tags get `max-buffers` buffers, and the DMAs are
+// started two iterations ahead.
+
+// CHECK-DAG: [[$MOD_3:#map[0-9a-zA-Z_]*]] = affine_map<(d0) -> (d0 mod 3)>
+// CHECK-LABEL: func @triple_buffer
+// CHECK:       memref.alloc() : memref<3x32xf32, 1>
+// CHECK-NEXT:  memref.alloc() : memref<3x1xf32>
+// CHECK:       affine.for %{{.*}} = 2 to 8 {
+// CHECK-NEXT:    affine.dma_start %{{.*}}[%{{.*}}], %{{.*}}[%{{.*}} mod 3, %{{.*}}], %{{.*}}[%{{.*}} mod 3, 0], %{{.*}} : memref<256xf32>, memref<3x32xf32, 1>, memref<3x1xf32>
+// CHECK:         affine.dma_wait %{{.*}}[%{{.*}} mod 3, 0], %{{.*}} : memref<3x1xf32>
+// CHECK-NEXT:    affine.load %{{.*}}[%{{.*}} mod 3, %{{.*}}] : memref<3x32xf32, 1>
+
+// The scratchpad of 256 bytes only fits two buffers of 128 bytes.
+
+// DLTI-LABEL: func @triple_buffer
+// DLTI:         memref.alloc() : memref<2x32xf32, 1>
+// DLTI-NEXT:    memref.alloc() : memref<2x1xf32>
+// DLTI:         affine.for %{{.*}} = 1 to 8 {
+module attributes { dlti.dl_spec = #dlti.dl_spec<
+    #dlti.dl_entry<"dlti.scratchpad_size_in_bytes", 256 : i64>>} {
+  func.func @triple_buffer() {
+    %A = memref.alloc() : memref<256 x f32>
+    %Ah = memref.alloc() : memref<32 x f32, 1>
+    %tag = memref.alloc() : memref<1 x f32>
+    %zero = arith.constant 0 : index
+    %num_elts = arith.constant 32 : index
+    affine.for %i = 0 to 8 {
+      affine.dma_start %A[%i], %Ah[%i], %tag[%zero], %num_elts : memref<256 x f32>, memref<32 x f32, 1>, memref<1 x f32>
+      affine.dma_wait %tag[%zero], %num_elts : memref<1 x f32>
+      %v = affine.load %Ah[%i] : memref<32 x f32, 1>
+      %r = "compute"(%v) : (f32) -> (f32)
+      affine.store %r, %Ah[%i] : memref<32 x f32, 1>
+    }
+    memref.dealloc %tag : memref<1 x f32>
+    memref.dealloc %Ah : memref<32 x f32, 1>
+    return
+  }
+}
+
+// -----
+
+// The number of buffers is bounded by the trip count.
+
+// CHECK-LABEL: func @short_loop
+// CHECK:       memref.alloc() : memref<2x32xf32, 1>
+// DLTI-LABEL: func @short_loop
+// DLTI:         memref.alloc() : memref<2x32xf32, 1>
+func.func @short_loop() {
+  %A = memref.alloc() : memref<256 x f32>
+  %Ah = memref.alloc() : memref<32 x f32, 1>
+  %tag = memref.alloc() : memref<1 x f32>
+  %zero = arith.constant 0 : index
+  %num_elts = arith.constant 32 : index
+  affine.for %i = 0 to 2 {
+    affine.dma_start %A[%i], %Ah[%i], %tag[%zero], %num_elts : memref<256 x f32>, memref<32 x f32, 1>, memref<1 x f32>
+    affine.dma_wait %tag[%zero], %num_elts : memref<1 x f32>
+    %v = affine.load %Ah[%i] : memref<32 x f32, 1>
+    "compute"(%v) : (f32) -> ()
+  }
+  memref.dealloc %tag : memref<1 x f32>
+  memref.dealloc %Ah : memref<32 x f32, 1>
+  return
+}
@@ -0,0 +1,27 @@
+// RUN: mlir-opt -allow-unregistered-dialect -split-input-file -test-legalize-patterns -test-legalize-allow-pattern-rollback=false -verify-diagnostics %s | FileCheck %s
+
+// Replacements that don't require rolling back in-place updates still work.
+// CHECK-LABEL: verifyDirectPattern
+func.func @verifyDirectPattern() -> i32 {
+  // CHECK-NEXT:  "test.legal_op_a"() <{status = "Success"}
+  %result = "test.illegal_op_a"() : () -> (i32)
+  // expected-remark@+1 {{op 'func.return' is not legalizable}}
+  return %result : i32
+}
+
+// -----
+
+// expected-remark@+1 {{applyPartialConversion failed}}
+builtin.module {
+
+  func.func @undo_block_arg_replace() {
+    // The pattern updates the op in place, but its result can't be legalized.
+    // expected-error@+1 {{failed to legalize operation 'test.undo_block_arg_replace': an in-place modification of 'test.undo_block_arg_replace' had to be rolled back, but pattern rollback is disabled}}
+    "test.undo_block_arg_replace"() ({
+    ^bb0(%arg0: i32):
+      "test.return"(%arg0) : (i32) -> ()
+    }) : () -> ()
+    return
+  }
+
+}
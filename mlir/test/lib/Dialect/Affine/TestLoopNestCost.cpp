@@ -0,0 +1,75 @@
+//===- TestLoopNestCost.cpp - Test the affine loop nest cost model --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass to test the affine loop nest cost model, by
+// emitting a remark with the estimated cost of every outermost loop nest.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Affine/Analysis/LoopAnalysis.h"
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Pass/Pass.h"
+
+#define PASS_NAME "test-affine-loop-nest-cost"
+
+using namespace mlir;
+using namespace mlir::affine;
+
+namespace {
+
+struct TestLoopNestCost
+    : public PassWrapper<TestLoopNestCost, OperationPass<>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(TestLoopNestCost)
+
+  StringRef getArgument() const final { return PASS_NAME; }
+  StringRef getDescription() const final {
+    return "Tests the affine loop nest cost model";
+  }
+  TestLoopNestCost() = default;
+  TestLoopNestCost(const TestLoopNestCost &pass) : PassWrapper(pass){};
+
+  void runOnOperation() override;
+
+private:
+  Option<uint64_t> cacheSize{*this, "cache-size",
+                             llvm::cl::desc("Cache size in KiB"),
+                             llvm::cl::init(512)};
+  Option<unsigned> issueWidth{
+      *this, "issue-width",
+      llvm::cl::desc("Number of operations issued per cycle"),
+      llvm::cl::init(4)};
+  Option<unsigned> memoryBandwidth{
+      *this, "memory-bandwidth",
+      llvm::cl::desc("Number of bytes transferred from memory per cycle"),
+      llvm::cl::init(16)};
+};
+
+} // namespace
+
+void TestLoopNestCost::runOnOperation() {
+  LoopNestCostParams params;
+  params.cacheSizeBytes = cacheSize * 1024;
+  params.issueWidth = issueWidth;
+  params.memoryBandwidth = memoryBandwidth;
+
+  getOperation()->walk([&](AffineForOp forOp) {
+    if (forOp->getParentOfType<AffineForOp>())
+      return;
+    std::optional<LoopNestCost> cost = getLoopNestCost(forOp, params);
+    if (!cost) {
+      forOp.emitRemark("unknown cost");
+      return;
+    }
+    forOp.emitRemark() << cost->numOps << " ops, " << cost->memoryTrafficBytes
+                       << " bytes, " << cost->cycles << " cycles";
+  });
+}
+
+namespace mlir {
+void registerTestLoopNestCostPass() { PassRegistration<TestLoopNestCost>(); }
+} // namespace mlir
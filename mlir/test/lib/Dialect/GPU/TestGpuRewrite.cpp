@@ -15,6 +15,7 @@
 #include "mlir/Dialect/GPU/Transforms/Passes.h"
 #include "mlir/Dialect/Index/IR/IndexDialect.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/Vector/IR/VectorOps.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
@@ -25,9 +26,12 @@ struct TestGpuRewritePass
     : public PassWrapper<TestGpuRewritePass, OperationPass<ModuleOp>> {
   MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(TestGpuRewritePass)
 
+  TestGpuRewritePass() = default;
+  TestGpuRewritePass(const TestGpuRewritePass &pass) : PassWrapper(pass) {}
+
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<arith::ArithDialect, func::FuncDialect, index::IndexDialect,
-                    memref::MemRefDialect>();
+                    memref::MemRefDialect, vector::VectorDialect>();
   }
   StringRef getArgument() const final { return "test-gpu-rewrite"; }
   StringRef getDescription() const final {
@@ -35,9 +39,15 @@ struct TestGpuRewritePass
   }
   void runOnOperation() override {
     RewritePatternSet patterns(&getContext());
-    populateGpuRewritePatterns(patterns);
+    populateGpuRewritePatterns(patterns, allReduceShuffleCombine);
     (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
   }
+
+  Option<bool> allReduceShuffleCombine{
+      *this, "all-reduce-shuffle-combine",
+      llvm::cl::desc("Combine the partial results of the all-reduce ops with "
+                     "shuffles in every subgroup"),
+      llvm::cl::init(false)};
 };
 } // namespace
 
@@ -0,0 +1,79 @@
+//===- TestStructTypes.cpp - Test the creation of LLVM struct types -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements a pass creating new identified LLVM struct types in the
+// functions it runs on, which may run on multiple threads. Running it with
+// `-mlir-timing` benchmarks the parallel creation of identified structs, e.g.
+//
+//   mlir-opt -pass-pipeline='builtin.module(func.func(
+//       test-llvm-new-identified-structs{num-structs=10000}))' -mlir-timing
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Pass/Pass.h"
+
+using namespace mlir;
+
+namespace {
+struct TestNewIdentifiedStructsPass
+    : public PassWrapper<TestNewIdentifiedStructsPass,
+                         OperationPass<func::FuncOp>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(TestNewIdentifiedStructsPass)
+
+  StringRef getArgument() const final {
+    return "test-llvm-new-identified-structs";
+  }
+  StringRef getDescription() const final {
+    return "Test the creation of new identified LLVM struct types, which "
+           "share their base name across the functions";
+  }
+  TestNewIdentifiedStructsPass() = default;
+  TestNewIdentifiedStructsPass(const TestNewIdentifiedStructsPass &pass)
+      : PassWrapper(pass) {}
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<LLVM::LLVMDialect>();
+  }
+
+  void runOnOperation() override {
+    func::FuncOp func = getOperation();
+    MLIRContext *ctx = &getContext();
+    Type body[] = {IntegerType::get(ctx, 32), Float32Type::get(ctx)};
+    SmallVector<Attribute> structs;
+    for (unsigned i = 0; i < numStructs; ++i) {
+      structs.push_back(TypeAttr::get(
+          LLVM::LLVMStructType::getNewIdentified(ctx, name, body)));
+    }
+    if (annotate)
+      func->setAttr("test.structs", ArrayAttr::get(ctx, structs));
+  }
+
+  Option<std::string> name{*this, "name",
+                           llvm::cl::desc("The base name of the structs"),
+                           llvm::cl::init("struct")};
+  Option<unsigned> numStructs{
+      *this, "num-structs",
+      llvm::cl::desc("The number of structs created in each function"),
+      llvm::cl::init(1)};
+  Option<bool> annotate{
+      *this, "annotate",
+      llvm::cl::desc("Attach the created structs to the functions"),
+      llvm::cl::init(true)};
+};
+} // namespace
+
+namespace mlir {
+namespace test {
+void registerTestNewIdentifiedStructsPass() {
+  PassRegistration<TestNewIdentifiedStructsPass>();
+}
+} // namespace test
+} // namespace mlir
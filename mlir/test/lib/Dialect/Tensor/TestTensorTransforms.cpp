@@ -67,6 +67,12 @@ struct TestTensorTransforms
       llvm::cl::desc("Test dropping redundant insert_slice rank expansions"),
       llvm::cl::init(false)};
 
+  Option<bool> testCoalesceInsertSliceChains{
+      *this, "test-coalesce-insert-slice-chains",
+      llvm::cl::desc("Test forwarding the disjoint reads of the destinations "
+                     "of tensor.insert_slice ops along their chains"),
+      llvm::cl::init(false)};
+
   Option<bool> testReassociativeReshapeFolding{
       *this, "test-reassociative-reshape-folding",
       llvm::cl::desc("Test folding of expand_shape/collapse_shape"),
@@ -137,6 +143,12 @@ applyDropRedundantInsertSliceRankExpansionPatterns(Operation *rootOp) {
   (void)applyPatternsAndFoldGreedily(rootOp, std::move(patterns));
 }
 
+static void applyCoalesceInsertSliceChainPatterns(Operation *rootOp) {
+  RewritePatternSet patterns(rootOp->getContext());
+  tensor::populateCoalesceInsertSliceChainPatterns(patterns);
+  (void)applyPatternsAndFoldGreedily(rootOp, std::move(patterns));
+}
+
 static void applySimplifyPackPatterns(Operation *rootOp) {
   RewritePatternSet patterns(rootOp->getContext());
   tensor::populateSimplifyTensorPack(patterns);
@@ -374,6 +386,8 @@ void TestTensorTransforms::runOnOperation() {
     applyFoldConsecutiveInsertExtractSlicePatterns(rootOp);
   if (testDropRedundantInsertSliceRankExpansion)
     applyDropRedundantInsertSliceRankExpansionPatterns(rootOp);
+  if (testCoalesceInsertSliceChains)
+    applyCoalesceInsertSliceChainPatterns(rootOp);
   if (testReassociativeReshapeFolding)
     applyReassociativeReshapeFoldingPatterns(rootOp);
   if (testFoldIntoPackAndUnpack)
@@ -921,7 +921,10 @@ struct TestLegalizePatternDriver
   /// The mode of conversion to use with the driver.
   enum class ConversionMode { Analysis, Full, Partial };
 
-  TestLegalizePatternDriver(ConversionMode mode) : mode(mode) {}
+  TestLegalizePatternDriver(ConversionMode mode, bool allowPatternRollback)
+      : mode(mode) {
+    config.allowPatternRollback = allowPatternRollback;
+  }
 
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<func::FuncDialect, test::TestDialect>();
@@ -976,6 +979,11 @@ struct TestLegalizePatternDriver
       return op.getOperand().getType().isF64();
     });
 
+    // The legality of these operations only depends on their types, so it can
+    // be cached.
+    target.markOpLegalityTypeBased<TestReturnOp, func::CallOp,
+                                   TestTypeProducerOp, TestTypeConsumerOp>();
+
     // Check support for marking certain operations as recursively legal.
     target.markOpRecursivelyLegal<func::FuncOp, ModuleOp>([](Operation *op) {
       return static_cast<bool>(
@@ -989,8 +997,9 @@ struct TestLegalizePatternDriver
     // Handle a partial conversion.
     if (mode == ConversionMode::Partial) {
       DenseSet<Operation *> unlegalizedOps;
-      if (failed(applyPartialConversion(
-              getOperation(), target, std::move(patterns), &unlegalizedOps))) {
+      if (failed(applyPartialConversion(getOperation(), target,
+                                        std::move(patterns), config,
+                                        &unlegalizedOps))) {
         getOperation()->emitRemark() << "applyPartialConversion failed";
       }
       // Emit remarks for each legalizable operation.
@@ -1007,7 +1016,7 @@ struct TestLegalizePatternDriver
       });
 
       if (failed(applyFullConversion(getOperation(), target,
-                                     std::move(patterns)))) {
+                                     std::move(patterns), config))) {
         getOperation()->emitRemark() << "applyFullConversion failed";
       }
       return;
@@ -1029,6 +1038,9 @@ struct TestLegalizePatternDriver
 
   /// The mode of conversion to use.
   ConversionMode mode;
+
+  /// The configuration of the conversion.
+  ConversionConfig config;
 };
 } // namespace
 
@@ -1045,6 +1057,11 @@ static llvm::cl::opt<TestLegalizePatternDriver::ConversionMode>
             clEnumValN(TestLegalizePatternDriver::ConversionMode::Partial,
                        "partial", "Perform a partial conversion")));
 
+static llvm::cl::opt<bool> legalizerAllowPatternRollback(
+    "test-legalize-allow-pattern-rollback",
+    llvm::cl::desc("Whether the test driver may roll back in-place updates"),
+    llvm::cl::init(true));
+
 //===----------------------------------------------------------------------===//
 // ConversionPatternRewriter::getRemappedValue testing. This method is used
 // to get the remapped value of an original value that was replaced using
@@ -1708,7 +1725,8 @@ void registerPatternsTestPass() {
   PassRegistration<TestStrictPatternDriver>();
 
   PassRegistration<TestLegalizePatternDriver>([] {
-    return std::make_unique<TestLegalizePatternDriver>(legalizerConversionMode);
+    return std::make_unique<TestLegalizePatternDriver>(
+        legalizerConversionMode, legalizerAllowPatternRollback);
   });
 
   PassRegistration<TestRemappedValue>();
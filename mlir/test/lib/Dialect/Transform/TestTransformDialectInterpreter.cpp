@@ -158,6 +158,17 @@ public:
     }
 
     options = options.enableExpensiveChecks(enableExpensiveChecks);
+    for (StringRef tunableValue : tunableValues) {
+      auto [name, valueStr] = tunableValue.split('=');
+      int64_t value;
+      if (valueStr.getAsInteger(10, value)) {
+        emitError(loc) << "expected 'name=integer' tunable value, got '"
+                       << tunableValue << "'";
+        return signalPassFailure();
+      }
+      options.setTunableValue(
+          name, IntegerAttr::get(IntegerType::get(&getContext(), 64), value));
+    }
     if (failed(transform::detail::interpreterBaseRunOnOperationImpl(
             getOperation(), getArgument(), getSharedTransformModule(),
             getTransformLibraryModule(), extraMapping, options,
@@ -222,6 +233,11 @@ public:
           "Optional name of the file containing transform dialect symbol "
           "definitions to be injected into the transform module.")};
 
+  ListOption<std::string> tunableValues{
+      *this, "tunable-values",
+      llvm::cl::desc("select the given integer values for the tunable "
+                     "parameters, as a list of 'name=value'")};
+
   Option<bool> testModuleGeneration{
       *this, "test-module-generation", llvm::cl::init(false),
       llvm::cl::desc("test the generation of the transform module during pass "
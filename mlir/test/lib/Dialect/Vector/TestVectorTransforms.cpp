@@ -159,6 +159,13 @@ struct TestVectorUnrollingPatterns
   void runOnOperation() override {
     MLIRContext *ctx = &getContext();
     RewritePatternSet patterns(ctx);
+    if (nativeShapeFromDataLayout) {
+      populateVectorUnrollPatterns(
+          patterns, UnrollVectorOptions().setNativeShapeFromDataLayout());
+      populateVectorToVectorCanonicalizationPatterns(patterns);
+      (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
+      return;
+    }
     populateVectorUnrollPatterns(
         patterns, UnrollVectorOptions()
                       .setNativeShape(ArrayRef<int64_t>{2, 2})
@@ -233,6 +240,12 @@ struct TestVectorUnrollingPatterns
       *this, "unroll-based-on-type",
       llvm::cl::desc("Set the unroll factor based on type of the operation"),
       llvm::cl::init(false)};
+
+  Option<bool> nativeShapeFromDataLayout{
+      *this, "native-shape-from-data-layout",
+      llvm::cl::desc("Unroll to the vector registers described by the data "
+                     "layout"),
+      llvm::cl::init(false)};
 };
 
 struct TestVectorTransferUnrollingPatterns
@@ -0,0 +1,61 @@
+//===- TestIRFootprint.cpp - Pass to measure the IR memory footprint ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/OperationArena.h"
+#include "mlir/Pass/Pass.h"
+
+using namespace mlir;
+
+namespace {
+/// This pass clones the IR into an operation arena and reports the memory
+/// allocated for the operations, i.e. the operations with their operands,
+/// results, successors, regions and properties. Attributes and types are
+/// uniqued in the context and are not accounted for.
+struct TestIRFootprintPass
+    : public PassWrapper<TestIRFootprintPass, OperationPass<>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(TestIRFootprintPass)
+
+  StringRef getArgument() const final { return "test-ir-footprint"; }
+  StringRef getDescription() const final {
+    return "Report the memory allocated for the operations of the IR.";
+  }
+
+  void runOnOperation() override {
+    Operation *op = getOperation();
+    size_t numOps = 0, numOpsWithoutRegions = 0, numOpsWithSmallOperands = 0;
+    op->walk([&](Operation *nestedOp) {
+      ++numOps;
+      if (nestedOp->getNumRegions() == 0)
+        ++numOpsWithoutRegions;
+      if (nestedOp->getNumOperands() <= 2)
+        ++numOpsWithSmallOperands;
+    });
+
+    OperationArena arena;
+    Operation *clone;
+    {
+      OperationArena::Scope scope(arena);
+      clone = op->clone();
+    }
+    size_t numBytes = arena.getBytesAllocated();
+    arena.destroyAndReset(clone);
+
+    llvm::outs() << "operations: " << numOps << "\n"
+                 << "operations without regions: " << numOpsWithoutRegions
+                 << "\n"
+                 << "operations with at most two operands: "
+                 << numOpsWithSmallOperands << "\n"
+                 << "bytes: " << numBytes << "\n"
+                 << "bytes per operation: " << numBytes / numOps << "\n";
+  }
+};
+} // namespace
+
+namespace mlir {
+void registerTestIRFootprintPass() { PassRegistration<TestIRFootprintPass>(); }
+} // namespace mlir
@@ -0,0 +1,48 @@
+// RUN: mlir-opt %s -test-affine-loop-nest-cost -o /dev/null 2>&1 | \
+// RUN:   FileCheck %s --check-prefix=COST
+// RUN: mlir-opt -pass-pipeline="builtin.module(func.func(lower-affine,convert-scf-to-cf,convert-arith-to-llvm),finalize-memref-to-llvm,convert-func-to-llvm,reconcile-unrealized-casts)" %s \
+// RUN: | mlir-cpu-runner -O3 -e main -entry-point-result=void \
+// RUN:   -benchmark-repetitions=3 2>&1 >/dev/null | FileCheck %s
+// RUN: mlir-opt -pass-pipeline="builtin.module(func.func(lower-affine,convert-scf-to-cf,convert-arith-to-llvm),finalize-memref-to-llvm,convert-func-to-llvm,reconcile-unrealized-casts)" %s \
+// RUN: | mlir-cpu-runner -O3 -e main -entry-point-result=void \
+// RUN:   -benchmark-repetitions=5 -benchmark-warmup=2 \
+// RUN:   -benchmark-flush-cache-bytes=1048576 -benchmark-flops=524288 \
+// RUN:   -benchmark-json | FileCheck %s --check-prefix=JSON
+
+// The estimate of the cost model and the measured execution time of the same
+// loop nest.
+
+// CHECK: benchmark: main: 3 repetitions, mean {{[0-9]+}} ns, min {{[0-9]+}} ns, median {{[0-9]+}} ns, p99 {{[0-9]+}} ns
+
+// JSON:      "entry_point": "main",
+// JSON-NEXT: "repetitions": 5,
+// JSON-NEXT: "warmup": 2,
+// JSON-NEXT: "mean_ns": {{[0-9]+}},
+// JSON-NEXT: "min_ns": {{[0-9]+}},
+// JSON-NEXT: "median_ns": {{[0-9]+}},
+// JSON-NEXT: "p99_ns": {{[0-9]+}},
+// JSON-NEXT: "max_ns": {{[0-9]+}},
+// JSON-NEXT: "gflops": {{[0-9.e+-]+}}
+
+func.func @main() {
+  %A = memref.alloc() : memref<64x64xf32>
+  %B = memref.alloc() : memref<64x64xf32>
+  %C = memref.alloc() : memref<64x64xf32>
+  // COST: remark: 1572864 ops, 49152 bytes, 393216 cycles
+  affine.for %i = 0 to 64 {
+    affine.for %j = 0 to 64 {
+      affine.for %k = 0 to 64 {
+        %a = affine.load %A[%i, %k] : memref<64x64xf32>
+        %b = affine.load %B[%k, %j] : memref<64x64xf32>
+        %c = affine.load %C[%i, %j] : memref<64x64xf32>
+        %p = arith.mulf %a, %b : f32
+        %s = arith.addf %c, %p : f32
+        affine.store %s, %C[%i, %j] : memref<64x64xf32>
+      }
+    }
+  }
+  memref.dealloc %A : memref<64x64xf32>
+  memref.dealloc %B : memref<64x64xf32>
+  memref.dealloc %C : memref<64x64xf32>
+  return
+}
@@ -0,0 +1,113 @@
+// RUN: mlir-opt %s -pass-pipeline="builtin.module(func.func(convert-scf-to-cf,convert-arith-to-llvm),finalize-memref-to-llvm,convert-func-to-llvm,reconcile-unrealized-casts)" \
+// RUN: | mlir-cpu-runner -e main -entry-point-result=void \
+// RUN: -shared-libs=%mlir_runner_utils,%mlir_c_runner_utils \
+// RUN: | FileCheck %s
+
+// The strided copies of memrefs, transposed through their layouts, round-trip
+// through the blocked and the parallel copy kernels.
+
+func.func private @printI64(i64)
+func.func private @printF32(f32)
+func.func private @printNewline()
+
+// Fills `%m` with the linear indices of its elements.
+func.func @fill(%m: memref<?x?x?xf32>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %d0 = memref.dim %m, %c0 : memref<?x?x?xf32>
+  %d1 = memref.dim %m, %c1 : memref<?x?x?xf32>
+  %d2 = memref.dim %m, %c2 : memref<?x?x?xf32>
+  scf.for %i = %c0 to %d0 step %c1 {
+    scf.for %j = %c0 to %d1 step %c1 {
+      scf.for %k = %c0 to %d2 step %c1 {
+        %0 = arith.muli %i, %d1 : index
+        %1 = arith.addi %0, %j : index
+        %2 = arith.muli %1, %d2 : index
+        %3 = arith.addi %2, %k : index
+        %4 = arith.index_cast %3 : index to i64
+        %5 = arith.sitofp %4 : i64 to f32
+        memref.store %5, %m[%i, %j, %k] : memref<?x?x?xf32>
+      }
+    }
+  }
+  return
+}
+
+// Returns the number of elements that differ in `%a` and `%b`.
+func.func @count_mismatches(%a: memref<?x?x?xf32>, %b: memref<?x?x?xf32>) -> i64 {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %zero = arith.constant 0 : i64
+  %one = arith.constant 1 : i64
+  %d0 = memref.dim %a, %c0 : memref<?x?x?xf32>
+  %d1 = memref.dim %a, %c1 : memref<?x?x?xf32>
+  %d2 = memref.dim %a, %c2 : memref<?x?x?xf32>
+  %r = scf.for %i = %c0 to %d0 step %c1 iter_args(%acc0 = %zero) -> (i64) {
+    %r1 = scf.for %j = %c0 to %d1 step %c1 iter_args(%acc1 = %acc0) -> (i64) {
+      %r2 = scf.for %k = %c0 to %d2 step %c1 iter_args(%acc2 = %acc1) -> (i64) {
+        %va = memref.load %a[%i, %j, %k] : memref<?x?x?xf32>
+        %vb = memref.load %b[%i, %j, %k] : memref<?x?x?xf32>
+        %ne = arith.cmpf une, %va, %vb : f32
+        %inc = arith.select %ne, %one, %zero : i64
+        %next = arith.addi %acc2, %inc : i64
+        scf.yield %next : i64
+      }
+      scf.yield %r2 : i64
+    }
+    scf.yield %r1 : i64
+  }
+  return %r : i64
+}
+
+func.func @main() {
+  %c2 = arith.constant 2 : index
+  %c5 = arith.constant 5 : index
+  %c7 = arith.constant 7 : index
+
+  // A 3-D transpose, across the tiles of the blocked kernel.
+  %a = memref.alloc() : memref<3x40x24xf32>
+  %a_dyn = memref.cast %a : memref<3x40x24xf32> to memref<?x?x?xf32>
+  call @fill(%a_dyn) : (memref<?x?x?xf32>) -> ()
+  %t = memref.alloc() : memref<24x40x3xf32>
+  %t_view = memref.reinterpret_cast %t to offset: [0], sizes: [3, 40, 24], strides: [1, 3, 120]
+    : memref<24x40x3xf32> to memref<3x40x24xf32, strided<[1, 3, 120]>>
+  memref.copy %a, %t_view : memref<3x40x24xf32> to memref<3x40x24xf32, strided<[1, 3, 120]>>
+  %b = memref.alloc() : memref<3x40x24xf32>
+  memref.copy %t_view, %b : memref<3x40x24xf32, strided<[1, 3, 120]>> to memref<3x40x24xf32>
+
+  // CHECK: 2093
+  %elem = memref.load %t[%c5, %c7, %c2] : memref<24x40x3xf32>
+  call @printF32(%elem) : (f32) -> ()
+  call @printNewline() : () -> ()
+  // CHECK-NEXT: 0
+  %b_dyn = memref.cast %b : memref<3x40x24xf32> to memref<?x?x?xf32>
+  %0 = call @count_mismatches(%a_dyn, %b_dyn) : (memref<?x?x?xf32>, memref<?x?x?xf32>) -> i64
+  call @printI64(%0) : (i64) -> ()
+  call @printNewline() : () -> ()
+
+  // A transpose large enough to be split between threads.
+  %l = memref.alloc() : memref<1x512x1024xf32>
+  %l_dyn = memref.cast %l : memref<1x512x1024xf32> to memref<?x?x?xf32>
+  call @fill(%l_dyn) : (memref<?x?x?xf32>) -> ()
+  %lt = memref.alloc() : memref<1024x512xf32>
+  %lt_view = memref.reinterpret_cast %lt to offset: [0], sizes: [1, 512, 1024], strides: [524288, 1, 512]
+    : memref<1024x512xf32> to memref<1x512x1024xf32, strided<[524288, 1, 512]>>
+  memref.copy %l, %lt_view : memref<1x512x1024xf32> to memref<1x512x1024xf32, strided<[524288, 1, 512]>>
+  %lb = memref.alloc() : memref<1x512x1024xf32>
+  memref.copy %lt_view, %lb : memref<1x512x1024xf32, strided<[524288, 1, 512]>> to memref<1x512x1024xf32>
+  // CHECK-NEXT: 0
+  %lb_dyn = memref.cast %lb : memref<1x512x1024xf32> to memref<?x?x?xf32>
+  %1 = call @count_mismatches(%l_dyn, %lb_dyn) : (memref<?x?x?xf32>, memref<?x?x?xf32>) -> i64
+  call @printI64(%1) : (i64) -> ()
+  call @printNewline() : () -> ()
+
+  memref.dealloc %a : memref<3x40x24xf32>
+  memref.dealloc %t : memref<24x40x3xf32>
+  memref.dealloc %b : memref<3x40x24xf32>
+  memref.dealloc %l : memref<1x512x1024xf32>
+  memref.dealloc %lt : memref<1024x512xf32>
+  memref.dealloc %lb : memref<1x512x1024xf32>
+  return
+}
@@ -0,0 +1,29 @@
+// RUN: mkdir -p %t && cd %t
+// RUN: %python -c "import struct, sys; sys.stdout.buffer.write(bytes(8) + struct.pack('<4f', 1, 2, 3, 4))" > weights.bin
+// RUN: mlir-opt %s -pass-pipeline="builtin.module(convert-ml-program-to-llvm,func.func(convert-arith-to-llvm),finalize-memref-to-llvm,convert-func-to-llvm,reconcile-unrealized-casts)" | mlir-cpu-runner -e main -entry-point-result=void -shared-libs=%mlir_runner_utils,%mlir_c_runner_utils | FileCheck %s
+
+// The globals are mapped from the file when the module is loaded.
+
+func.func private @printMemrefF32(memref<*xf32>) attributes { llvm.emit_c_interface }
+
+ml_program.global private @weights(#ml_program.external_storage<"weights.bin", offset = 8, size = 16> : memref<4xf32>) : memref<4xf32>
+ml_program.global private mutable @state(#ml_program.external_storage<"weights.bin", offset = 8, size = 16> : memref<4xf32>) : memref<4xf32>
+
+func.func @main() {
+  %weights = ml_program.global_load_const @weights : memref<4xf32>
+  %state = ml_program.global_load @state : memref<4xf32>
+
+  // The writes to the mutable global copy its pages, which leaves the file and
+  // the other mappings of the file alone.
+  %c0 = arith.constant 0 : index
+  %cst = arith.constant 10.0 : f32
+  memref.store %cst, %state[%c0] : memref<4xf32>
+
+  %0 = memref.cast %weights : memref<4xf32> to memref<*xf32>
+  // CHECK: [1,  2,  3,  4]
+  call @printMemrefF32(%0) : (memref<*xf32>) -> ()
+  %1 = memref.cast %state : memref<4xf32> to memref<*xf32>
+  // CHECK: [10,  2,  3,  4]
+  call @printMemrefF32(%1) : (memref<*xf32>) -> ()
+  return
+}
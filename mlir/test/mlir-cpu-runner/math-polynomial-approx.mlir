@@ -610,6 +610,57 @@ func.func @cbrt() {
   return
 }
 
+// -------------------------------------------------------------------------- //
+// Powf.
+// -------------------------------------------------------------------------- //
+func.func @powf_f32(%a : f32, %b : f32) {
+  %r = math.powf %a, %b : f32
+  vector.print %r : f32
+  return
+}
+
+func.func @powf_4xf32(%a : vector<4xf32>, %b : vector<4xf32>) {
+  %r = math.powf %a, %b : vector<4xf32>
+  vector.print %r : vector<4xf32>
+  return
+}
+
+func.func @powf() {
+  // CHECK: 8
+  %a = arith.constant 2.0 : f32
+  %b = arith.constant 3.0 : f32
+  call @powf_f32(%a, %b) : (f32, f32) -> ()
+
+  // CHECK: -8
+  %c = arith.constant -2.0 : f32
+  call @powf_f32(%c, %b) : (f32, f32) -> ()
+
+  // CHECK: 0.25
+  %d = arith.constant -2.0 : f32
+  call @powf_f32(%c, %d) : (f32, f32) -> ()
+
+  // CHECK: nan
+  %e = arith.constant 0.5 : f32
+  call @powf_f32(%c, %e) : (f32, f32) -> ()
+
+  // CHECK: 1
+  %zero = arith.constant 0.0 : f32
+  %nan = arith.constant 0x7fc00000 : f32
+  call @powf_f32(%nan, %zero) : (f32, f32) -> ()
+
+  // CHECK: -inf
+  %minus_one = arith.constant -1.0 : f32
+  %minus_zero = arith.constant -0.0 : f32
+  call @powf_f32(%minus_zero, %minus_one) : (f32, f32) -> ()
+
+  // CHECK: 1.41421, 0, inf, 1
+  %f = arith.constant dense<[2.0, 0.0, 0.0, -1.0]> : vector<4xf32>
+  %g = arith.constant dense<[0.5, 2.0, -2.0, 0x7f800000]> : vector<4xf32>
+  call @powf_4xf32(%f, %g) : (vector<4xf32>, vector<4xf32>) -> ()
+
+  return
+}
+
 // -------------------------------------------------------------------------- //
 // floor.
 // -------------------------------------------------------------------------- //
@@ -697,6 +748,7 @@ func.func @main() {
   call @atan() : () -> ()
   call @atan2() : () -> ()
   call @cbrt() : () -> ()
+  call @powf() : () -> ()
   call @floorf() : () -> ()
   call @ceilf() : () -> ()
   return
@@ -0,0 +1,39 @@
+// RUN: mlir-opt %s -pass-pipeline="builtin.module(convert-scf-to-cf,func.func(convert-arith-to-llvm),finalize-memref-to-llvm,convert-func-to-llvm,reconcile-unrealized-casts)" | mlir-cpu-runner -e main -entry-point-result=void -shared-libs=%mlir_runner_utils,%mlir_c_runner_utils | FileCheck %s
+
+// The module initializer runs once, when the module is loaded, before the
+// entry point.
+
+func.func private @printMemrefF32(memref<*xf32>) attributes { llvm.emit_c_interface }
+
+memref.global "private" @weights : memref<4xf32> = uninitialized
+
+func.func @__mlir_module_init() {
+  %0 = memref.get_global @weights : memref<4xf32>
+  %cst = arith.constant 1.0 : f32
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  scf.for %i = %c0 to %c4 step %c1 {
+    memref.store %cst, %0[%i] : memref<4xf32>
+  }
+  return
+}
+
+func.func @accumulate() {
+  %0 = memref.get_global @weights : memref<4xf32>
+  %c0 = arith.constant 0 : index
+  %v = memref.load %0[%c0] : memref<4xf32>
+  %sum = arith.addf %v, %v : f32
+  memref.store %sum, %0[%c0] : memref<4xf32>
+  return
+}
+
+func.func @main() {
+  call @accumulate() : () -> ()
+  call @accumulate() : () -> ()
+  %0 = memref.get_global @weights : memref<4xf32>
+  %U = memref.cast %0 : memref<4xf32> to memref<*xf32>
+  // CHECK: [4,  1,  1,  1]
+  call @printMemrefF32(%U) : (memref<*xf32>) -> ()
+  return
+}
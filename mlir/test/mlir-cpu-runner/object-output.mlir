@@ -0,0 +1,26 @@
+// RUN: mlir-opt %s -convert-arith-to-llvm \
+// RUN:   -convert-func-to-llvm="c-interface-header=%t.h" \
+// RUN:   -reconcile-unrealized-casts \
+// RUN: | mlir-cpu-runner -O2 -object-output=%t.o
+// RUN: llvm-nm %t.o | FileCheck %s
+// RUN: FileCheck %s --input-file=%t.h --check-prefix=HEADER
+
+// The functions are compiled with their C wrappers, which the header declares.
+
+// CHECK-DAG: T {{_?}}_mlir_ciface_add{{$}}
+// CHECK-DAG: T {{_?}}_mlir_ciface_identity{{$}}
+// CHECK-DAG: T {{_?}}add{{$}}
+// CHECK-DAG: T {{_?}}identity{{$}}
+
+// HEADER: int32_t _mlir_ciface_add(int32_t arg0, int32_t arg1);
+// HEADER: void _mlir_ciface_identity(mlir_memref_2d_f32 *result, mlir_memref_2d_f32 *arg0);
+
+func.func @add(%a: i32, %b: i32) -> i32 attributes {llvm.emit_c_interface} {
+  %0 = arith.addi %a, %b : i32
+  return %0 : i32
+}
+
+func.func @identity(%m: memref<?x4xf32>) -> memref<?x4xf32>
+    attributes {llvm.emit_c_interface} {
+  return %m : memref<?x4xf32>
+}
@@ -0,0 +1,47 @@
+// RUN: mlir-opt %s -pass-pipeline="builtin.module(convert-vector-to-llvm,func.func(convert-scf-to-cf,convert-arith-to-llvm),finalize-memref-to-llvm{use-generic-functions=1},convert-func-to-llvm,reconcile-unrealized-casts)" \
+// RUN: | mlir-cpu-runner -e main -entry-point-result=void -pooled-allocator \
+// RUN:   -shared-libs=%mlir_c_runner_utils \
+// RUN: | FileCheck %s
+
+// RUN: mlir-opt %s -pass-pipeline="builtin.module(convert-vector-to-llvm,func.func(convert-scf-to-cf,convert-arith-to-llvm),finalize-memref-to-llvm{use-generic-functions=1},convert-func-to-llvm,reconcile-unrealized-casts)" \
+// RUN: | mlir-cpu-runner -e main -entry-point-result=void -print-allocation-stats \
+// RUN:   -huge-allocation-threshold=65536 -shared-libs=%mlir_c_runner_utils \
+// RUN:   2>&1 >/dev/null | FileCheck %s --check-prefix=STATS
+
+// The generic allocation functions are only defined by the pooled allocator.
+
+func.func @main() {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c8 = arith.constant 8 : index
+  %zero = arith.constant 0.0 : f32
+  %one = arith.constant 1.0 : f32
+
+  // The small allocations are served from a size class, whose block is reused
+  // by every iteration.
+  %sum = scf.for %i = %c0 to %c8 step %c1 iter_args(%acc = %zero) -> f32 {
+    %small = memref.alloc() : memref<16xf32>
+    memref.store %one, %small[%i] : memref<16xf32>
+    %v = memref.load %small[%i] : memref<16xf32>
+    %next = arith.addf %acc, %v : f32
+    memref.dealloc %small : memref<16xf32>
+    scf.yield %next : f32
+  }
+  // CHECK: 8
+  vector.print %sum : f32
+
+  // The huge allocations are mapped directly.
+  %huge = memref.alloc() : memref<1048576xf32>
+  %last = arith.constant 1048575 : index
+  memref.store %one, %huge[%last] : memref<1048576xf32>
+  %w = memref.load %huge[%last] : memref<1048576xf32>
+  // CHECK-NEXT: 1
+  vector.print %w : f32
+  memref.dealloc %huge : memref<1048576xf32>
+  return
+}
+
+// STATS:      Pooled allocator statistics
+// STATS:      allocations frees allocated bytes live bytes peak live bytes call site
+// STATS-NEXT: {{^ +}}1{{ +}}1{{ +}}4194304{{ +}}0{{ +}}4194304  {{(0x)?[0-9a-fA-F]+$}}
+// STATS-NEXT: {{^ +}}8{{ +}}8{{ +}}512{{ +}}0{{ +}}64  {{(0x)?[0-9a-fA-F]+$}}
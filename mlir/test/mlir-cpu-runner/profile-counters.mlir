@@ -0,0 +1,26 @@
+// RUN: mlir-opt %s -llvm-add-profile-counters="instrument-loops=1" \
+// RUN:   -convert-scf-to-cf -convert-arith-to-llvm -convert-func-to-llvm \
+// RUN:   -reconcile-unrealized-casts \
+// RUN: | mlir-cpu-runner -e main -entry-point-result=void -print-profile-report \
+// RUN:   -shared-libs=%mlir_c_runner_utils 2>&1 | FileCheck %s
+
+// The regions are sorted by ticks, which include the time of the callees.
+
+// CHECK:      profile: region {{ *}}executions {{ *}}ticks {{ *}}ticks/exec
+// CHECK-NEXT: profile: main {{ *}}1 {{ *}}[[#]] {{ *}}[[#]]
+// CHECK-NEXT: profile: main:loop0 {{ *}}1 {{ *}}[[#]] {{ *}}[[#]]
+// CHECK-NEXT: profile: body {{ *}}16 {{ *}}[[#]] {{ *}}[[#]]
+
+func.func @body(%i: index) {
+  return
+}
+
+func.func @main() {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c16 = arith.constant 16 : index
+  scf.for %i = %c0 to %c16 step %c1 {
+    func.call @body(%i) : (index) -> ()
+  }
+  return
+}
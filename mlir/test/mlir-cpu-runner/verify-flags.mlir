@@ -1,6 +1,8 @@
 // REQUIRES: asserts
 // RUN: mlir-cpu-runner %s --debug-only=jit-runner -mattr=+foo_bar -e entry -entry-point-result=void 2>&1 | FileCheck %s --check-prefixes=MATTR
 // RUN: not mlir-cpu-runner %s --debug-only=jit-runner -march=bar_foo -e entry -entry-point-result=void 2>&1 | FileCheck %s --check-prefixes=MARCH
+// RUN: mlir-cpu-runner %s --debug-only=jit-runner -mcpu=generic -e entry -entry-point-result=void 2>&1 | FileCheck %s --check-prefixes=MCPU
+// RUN: not mlir-cpu-runner %s -O2 -profile-use=%t.missing.profdata -e entry -entry-point-result=void 2>&1 | FileCheck %s --check-prefixes=PROFILE
 
 // Verify that command line args do affect the configuration
 
@@ -10,6 +12,10 @@
 // MARCH: Failed to create a TargetMachine for the host
 // MARCH-NEXT: No available targets are compatible with triple "bar_foo-{{.*}}"
 
+// MCPU: CPU = {{"?}}generic
+
+// PROFILE: Error: profile file '{{.*}}.missing.profdata' not found
+
 llvm.func @entry() -> () {
   llvm.return
 }
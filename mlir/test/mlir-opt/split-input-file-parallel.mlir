@@ -0,0 +1,44 @@
+// RUN: mlir-opt %s -split-input-file -split-input-file-in-parallel -verify-diagnostics | FileCheck %s
+// RUN: not mlir-opt %s -split-input-file -split-input-file-in-parallel 2>&1 >/dev/null | FileCheck %s --check-prefix=DIAG
+
+// Check that the output and the diagnostics of the chunks are emitted in the
+// order of the chunks.
+
+// CHECK: func.func @first
+// CHECK: // -----
+// CHECK: func.func @second
+// CHECK: // -----
+// CHECK: func.func @third
+func.func @first() {
+  return
+}
+
+// -----
+
+// DIAG: error: redefinition of symbol named 'foo'
+// DIAG: note: see existing symbol definition here
+// expected-note @+1 {{see existing symbol definition here}}
+func.func @foo() { return }
+// expected-error @+1 {{redefinition of symbol named 'foo'}}
+func.func @foo() { return }
+
+// -----
+
+func.func @second() {
+  return
+}
+
+// -----
+
+// DIAG: error: redefinition of symbol named 'bar'
+// DIAG: note: see existing symbol definition here
+// expected-note @+1 {{see existing symbol definition here}}
+func.func @bar() { return }
+// expected-error @+1 {{redefinition of symbol named 'bar'}}
+func.func @bar() { return }
+
+// -----
+
+func.func @third() {
+  return
+}
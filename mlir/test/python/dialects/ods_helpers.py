@@ -208,3 +208,33 @@ def testOdsBuildDefaultCastError():
 
 
 run(testOdsBuildDefaultCastError)
+
+
+def testOdsBuildCachedClassInfo():
+    class TestOneRegionOp(OpView):
+        OPERATION_NAME = "custom.test_op"
+        _ODS_REGIONS = (1, True)
+
+    class TestTwoRegionsOp(OpView):
+        OPERATION_NAME = "custom.test_op"
+        _ODS_REGIONS = (2, True)
+
+    with Context() as ctx, Location.unknown():
+        ctx.allow_unregistered_dialects = True
+        m = Module.create()
+        with InsertionPoint(m.body):
+            # The construction metadata is cached per class, not per name.
+            for _ in range(2):
+                one = TestOneRegionOp.build_generic(results=[], operands=[])
+                two = TestTwoRegionsOp.build_generic(results=[], operands=[])
+            # CHECK: NUM_REGIONS: 1 2
+            print(f"NUM_REGIONS: {len(one.regions)} {len(two.regions)}")
+
+            op = TestOneRegionOp.build_generic(
+                results=[], operands=[], attributes={"foo": UnitAttr.get()}
+            )
+            # CHECK: HAS_FOO: True
+            print(f"HAS_FOO: {'foo' in op.attributes}")
+
+
+run(testOdsBuildCachedClassInfo)
@@ -1,6 +1,7 @@
 # RUN: %PYTHON %s | FileCheck %s
 
 from mlir.ir import *
+from mlir.dialects import func
 from mlir.dialects import sparse_tensor as st
 
 
@@ -106,3 +107,25 @@ def testEncodingAttrOnTensorType():
         # CHECK: #sparse_tensor.encoding<{ lvlTypes = [ "compressed" ], posWidth = 64, crdWidth = 32 }>
         print(tt.encoding)
         assert tt.encoding == encoding
+
+
+# CHECK-LABEL: TEST: testPackOp
+@run
+def testPackOp():
+    with Context() as ctx, Location.unknown():
+        encoding = st.EncodingAttr.get(
+            [st.DimLevelType.dense, st.DimLevelType.compressed], None, 0, 0
+        )
+        csr = RankedTensorType.get((2, 10), F64Type.get(), encoding=encoding)
+        values = RankedTensorType.get((6,), F64Type.get())
+        positions = RankedTensorType.get((3,), IndexType.get())
+        coordinates = RankedTensorType.get((6,), IndexType.get())
+        module = Module.create()
+        with InsertionPoint(module.body):
+
+            @func.FuncOp.from_py_func(values, positions, coordinates)
+            def sparse_pack(vals, pos, crd):
+                return st.PackOp(csr, vals, [pos, crd]).result
+
+        # CHECK: sparse_tensor.pack %arg0, %arg1, %arg2 : tensor<6xf64>, tensor<3xindex>, tensor<6xindex> to tensor<2x10xf64, #sparse_tensor.encoding<{ lvlTypes = [ "dense", "compressed" ] }>>
+        print(module)
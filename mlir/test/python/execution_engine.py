@@ -504,6 +504,42 @@ def testDynamicMemrefAdd2D():
 run(testDynamicMemrefAdd2D)
 
 
+#  Test prepared calls with numpy arrays and scalars
+# CHECK-LABEL: TEST: testPreparedCall
+def testPreparedCall():
+    with Context():
+        module = Module.parse(
+            """
+      module  {
+        func.func @load_add(%arg0: memref<?x?xf32>, %arg1: f32) -> f32 attributes {llvm.emit_c_interface} {
+          %c1 = arith.constant 1 : index
+          %0 = memref.load %arg0[%c1, %c1] : memref<?x?xf32>
+          %1 = arith.addf %0, %arg1 : f32
+          return %1 : f32
+        }
+      }
+        """
+        )
+        execution_engine = ExecutionEngine(lowerToLLVM(module))
+        load_add = execution_engine.prepare("load_add", [2, None, None])
+
+        # The strides of the transposed array are passed in the descriptor.
+        arg0 = np.arange(6, dtype=np.float32).reshape(2, 3).T
+        res = np.zeros(1, dtype=np.float32)
+        load_add(arg0, np.float32(2.0), res)
+        # CHECK: 6.0
+        log(res[0])
+
+        try:
+            load_add(res, np.float32(2.0), res)
+        except ValueError as e:
+            # CHECK: argument 0 is expected to have rank 2, got 1
+            log(e)
+
+
+run(testPreparedCall)
+
+
 #  Test loading of shared libraries.
 # CHECK-LABEL: TEST: testSharedLibLoad
 def testSharedLibLoad():
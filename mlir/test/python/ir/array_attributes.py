@@ -395,3 +395,26 @@ def testGetDenseElementsIndex():
         print(arr)
         # CHECK: True
         print(arr.dtype == np.int64)
+
+
+# CHECK-LABEL: TEST: testGetDenseResourceElementsFromBuffer
+@run
+def testGetDenseResourceElementsFromBuffer():
+    with Context():
+        array = np.arange(6, dtype=np.float32).reshape(2, 3)
+        tensor_type = RankedTensorType.get((2, 3), F32Type.get())
+        attr = DenseResourceElementsAttr.get_from_buffer(
+            array, "from_buffer", tensor_type
+        )
+        # CHECK: dense_resource<from_buffer> : tensor<2x3xf32>
+        print(attr)
+        # The attribute keeps the memory of the array alive, and exports it
+        # without copying.
+        del array
+        gc.collect()
+        exported = np.array(attr, copy=False)
+        # CHECK: {{\[}}[0. 1. 2.]
+        # CHECK: {{\[}}3. 4. 5.]]
+        print(exported)
+        # CHECK: True
+        print(DenseResourceElementsAttr.isinstance(attr))
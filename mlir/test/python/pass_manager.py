@@ -163,3 +163,42 @@ def testRunPipelineError():
             # CHECK:    note: "-":1:1: see current operation: "test.op"() : () -> ()
             # CHECK: >
             print(f"Exception: <{e}>")
+
+
+# Verify that pass managers can run concurrently from multiple threads, on
+# contexts sharing a thread pool.
+# CHECK-LABEL: TEST: testRunPipelinesConcurrently
+@run
+def testRunPipelinesConcurrently():
+    import threading
+
+    pool = ThreadPool(2)
+    results = [None] * 4
+
+    def compile(i):
+        with Context() as ctx:
+            ctx.set_thread_pool(pool)
+            assert ctx.num_threads == pool.max_concurrency
+            module = Module.parse(
+                f"""
+                func.func @f{i}(%x: i32) -> i32 {{
+                  %0 = arith.addi %x, %x : i32
+                  %1 = arith.addi %x, %x : i32
+                  %2 = arith.muli %0, %1 : i32
+                  return %2 : i32
+                }}
+                """
+            )
+            pm = PassManager.parse("builtin.module(func.func(cse))")
+            pm.run(module.operation)
+            results[i] = str(module)
+
+    threads = [threading.Thread(target=compile, args=(i,)) for i in range(4)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    # CHECK-COUNT-4: arith.addi
+    # CHECK-NOT: arith.addi
+    for result in results:
+        log(result)
@@ -98,6 +98,23 @@ static const char *const sameVariadicSizeValueRangeCalcCode = R"(
   return {{start, size};
 )";
 
+/// The logic to calculate the actual value range for a declared operand/result
+/// of an op with a single variadic operand/result. The position of the variadic
+/// operand/result is known statically, such that the range folds to constants
+/// when the accessors are inlined with a constant index.
+///
+/// {0}: The index of the variadic operand/result.
+/// {1}: The total number of non-variadic operands/results.
+/// {2}: The total number of actual values.
+static const char *const singleVariadicValueRangeCalcCode = R"(
+  if (index < {0})
+    return {{index, 1};
+  unsigned variadicSize = {2} - {1};
+  if (index == {0})
+    return {{index, variadicSize};
+  return {{index + variadicSize - 1, 1};
+)";
+
 /// The logic to calculate the actual value range for a declared operand/result
 /// of an op with variadic operands/results. Note that this logic is assumes
 /// the op has an attribute specifying the size of each operand/result segment
@@ -1620,6 +1637,17 @@ static void generateValueRangeStartAndEnd(
     body << "  return {index, 1};\n";
   } else if (hasAttrSegmentSize) {
     body << sizeAttrInit << attrSizedSegmentValueRangeCalcCode;
+  } else if (numVariadic == 1) {
+    // The position of the variadic value is known at generation time, such
+    // that the range is computed without a loop over the declared values.
+    unsigned variadicIndex = 0;
+    for (auto &it : odsValues) {
+      if (it.isVariableLength())
+        break;
+      ++variadicIndex;
+    }
+    body << formatv(singleVariadicValueRangeCalcCode, variadicIndex,
+                    numNonVariadic, rangeSizeCall);
   } else {
     // Because the op can have arbitrarily interleaved variadic and non-variadic
     // operands, we need to embed a list in the "sink" getter method for
@@ -14,11 +14,14 @@
 #include "VulkanRuntime.h"
 
 #include <chrono>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
 // TODO: It's generally bad to access stdout/stderr in a library.
 // Figure out a better way for error reporting.
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 
 inline void emitVulkanError(const char *api, VkResult error) {
   std::cerr << " failed with error code " << error << " when executing " << api;
@@ -115,32 +118,29 @@ LogicalResult VulkanRuntime::initRuntime() {
   if (failed(countDeviceMemorySize())) {
     return failure();
   }
+  if (failed(context.init()))
+    return failure();
+  device = context.device;
   return success();
 }
 
 LogicalResult VulkanRuntime::destroy() {
-  // According to Vulkan spec:
-  // "To ensure that no work is active on the device, vkDeviceWaitIdle can be
-  // used to gate the destruction of the device. Prior to destroying a device,
-  // an application is responsible for destroying/freeing any Vulkan objects
-  // that were created using that device as the first parameter of the
-  // corresponding vkCreate* or vkAllocate* command."
-  RETURN_ON_VULKAN_ERROR(vkDeviceWaitIdle(device), "vkDeviceWaitIdle");
-
-  // Free and destroy.
-  vkFreeCommandBuffers(device, commandPool, commandBuffers.size(),
+  if (device == VK_NULL_HANDLE)
+    return success();
+
+  // The submitted commands must complete before their resources are freed.
+  if (fence != VK_NULL_HANDLE) {
+    RETURN_ON_VULKAN_ERROR(
+        vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX),
+        "vkWaitForFences");
+  }
+
+  // Free and destroy. The descriptor sets are freed by the next reset of the
+  // descriptor pool, and the pipeline state is kept by the context.
+  vkDestroyFence(device, fence, nullptr);
+  vkFreeCommandBuffers(device, context.commandPool, commandBuffers.size(),
                        commandBuffers.data());
   vkDestroyQueryPool(device, queryPool, nullptr);
-  vkDestroyCommandPool(device, commandPool, nullptr);
-  vkFreeDescriptorSets(device, descriptorPool, descriptorSets.size(),
-                       descriptorSets.data());
-  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
-  vkDestroyPipeline(device, pipeline, nullptr);
-  vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
-  for (auto &descriptorSetLayout : descriptorSetLayouts) {
-    vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
-  }
-  vkDestroyShaderModule(device, shaderModule, nullptr);
 
   // For each descriptor set.
   for (auto &deviceMemoryBufferMapPair : deviceMemoryBufferMap) {
@@ -153,46 +153,38 @@ LogicalResult VulkanRuntime::destroy() {
       vkDestroyBuffer(device, memoryBuffer.deviceBuffer, nullptr);
     }
   }
-
-  vkDestroyDevice(device, nullptr);
-  vkDestroyInstance(instance, nullptr);
   return success();
 }
 
 LogicalResult VulkanRuntime::run() {
-  // Create logical device, shader module and memory buffers.
-  if (failed(createInstance()) || failed(createDevice()) ||
-      failed(createMemoryBuffers()) || failed(createShaderModule())) {
+  // Create memory buffers.
+  if (failed(selectMemoryTypes()) || failed(createMemoryBuffers()))
     return failure();
-  }
 
   // Descriptor bindings divided into sets. Each descriptor binding
   // must have a layout binding attached into a descriptor set layout.
-  // Each layout set must be binded into a pipeline layout.
+  // Each layout set must be binded into a pipeline layout. The pipeline state
+  // is reused across the runs of the same shader.
   initDescriptorSetLayoutBindingMap();
-  if (failed(createDescriptorSetLayout()) || failed(createPipelineLayout()) ||
+  if (failed(getOrCreatePipelineState()) ||
       // Each descriptor set must be allocated from a descriptor pool.
-      failed(createComputePipeline()) || failed(createDescriptorPool()) ||
       failed(allocateDescriptorSets()) || failed(setWriteDescriptors()) ||
       // Create command buffer.
-      failed(createCommandPool()) || failed(createQueryPool()) ||
-      failed(createComputeCommandBuffer())) {
+      failed(createQueryPool()) || failed(createComputeCommandBuffer())) {
     return failure();
   }
 
-  // Get working queue.
-  vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue);
-
-  if (failed(copyResource(/*deviceToHost=*/false)))
-    return failure();
-
   auto submitStart = std::chrono::high_resolution_clock::now();
-  // Submit command buffer into the queue.
+  // Submit command buffer into the queue. It copies the resources to the
+  // device, dispatches the shader and copies the resources back, so the run
+  // synchronizes with the device only once.
   if (failed(submitCommandBuffersToQueue()))
     return failure();
   auto submitEnd = std::chrono::high_resolution_clock::now();
 
-  RETURN_ON_VULKAN_ERROR(vkQueueWaitIdle(queue), "vkQueueWaitIdle");
+  RETURN_ON_VULKAN_ERROR(
+      vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX),
+      "vkWaitForFences");
   auto execEnd = std::chrono::high_resolution_clock::now();
 
   auto submitDuration = std::chrono::duration_cast<std::chrono::microseconds>(
@@ -210,7 +202,8 @@ LogicalResult VulkanRuntime::run() {
             /*stride=*/sizeof(uint64_t),
             VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT),
         "vkGetQueryPoolResults");
-    float microsec = (timestamps[1] - timestamps[0]) * timestampPeriod / 1000;
+    float microsec =
+        (timestamps[1] - timestamps[0]) * context.timestampPeriod / 1000;
     std::cout << "Compute shader execution time: " << std::setprecision(3)
               << microsec << "us\n";
   }
@@ -221,7 +214,123 @@ LogicalResult VulkanRuntime::run() {
   return success();
 }
 
-LogicalResult VulkanRuntime::createInstance() {
+//===----------------------------------------------------------------------===//
+// VulkanContext
+//===----------------------------------------------------------------------===//
+
+LogicalResult VulkanContext::init() {
+  if (device != VK_NULL_HANDLE)
+    return success();
+  if (failed(createInstance()) || failed(createDevice()) ||
+      failed(createCommandPool()) || failed(createPipelineCache()))
+    return failure();
+
+  // Get working queue.
+  vkGetDeviceQueue(device, queueFamilyIndex, 0, &queue);
+  return success();
+}
+
+LogicalResult VulkanContext::destroy() {
+  if (instance == VK_NULL_HANDLE)
+    return success();
+
+  if (device != VK_NULL_HANDLE) {
+    // According to Vulkan spec:
+    // "To ensure that no work is active on the device, vkDeviceWaitIdle can be
+    // used to gate the destruction of the device. Prior to destroying a
+    // device, an application is responsible for destroying/freeing any Vulkan
+    // objects that were created using that device as the first parameter of
+    // the corresponding vkCreate* or vkAllocate* command."
+    RETURN_ON_VULKAN_ERROR(vkDeviceWaitIdle(device), "vkDeviceWaitIdle");
+
+    for (auto &pipelineStatePair : pipelineStates) {
+      VulkanPipelineState &state = pipelineStatePair.second;
+      vkDestroyDescriptorPool(device, state.descriptorPool, nullptr);
+      vkDestroyPipeline(device, state.pipeline, nullptr);
+      vkDestroyPipelineLayout(device, state.pipelineLayout, nullptr);
+      for (auto &descriptorSetLayout : state.descriptorSetLayouts)
+        vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+      vkDestroyShaderModule(device, state.shaderModule, nullptr);
+    }
+    pipelineStates.clear();
+
+    savePipelineCache();
+    vkDestroyPipelineCache(device, pipelineCache, nullptr);
+    vkDestroyCommandPool(device, commandPool, nullptr);
+    vkDestroyDevice(device, nullptr);
+  }
+  vkDestroyInstance(instance, nullptr);
+  pipelineCache = VK_NULL_HANDLE;
+  commandPool = VK_NULL_HANDLE;
+  queue = VK_NULL_HANDLE;
+  device = VK_NULL_HANDLE;
+  instance = VK_NULL_HANDLE;
+  return success();
+}
+
+LogicalResult VulkanContext::createCommandPool() {
+  VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+  commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  commandPoolCreateInfo.pNext = nullptr;
+  commandPoolCreateInfo.flags = 0;
+  commandPoolCreateInfo.queueFamilyIndex = queueFamilyIndex;
+  RETURN_ON_VULKAN_ERROR(vkCreateCommandPool(device, &commandPoolCreateInfo,
+                                             /*pAllocator=*/nullptr,
+                                             &commandPool),
+                         "vkCreateCommandPool");
+  return success();
+}
+
+/// Returns the path of the file to load and save the pipeline cache from, or
+/// null if the pipeline cache is not persistent.
+static const char *getPipelineCachePath() {
+  return std::getenv("MLIR_VULKAN_PIPELINE_CACHE");
+}
+
+LogicalResult VulkanContext::createPipelineCache() {
+  // Load the initial data of the cache. The implementation validates it, and
+  // starts from an empty cache if it was created by another device or driver.
+  std::vector<char> initialData;
+  if (const char *path = getPipelineCachePath()) {
+    std::ifstream file(path, std::ios::binary);
+    if (file)
+      initialData.assign(std::istreambuf_iterator<char>(file),
+                         std::istreambuf_iterator<char>());
+  }
+
+  VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
+  pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  pipelineCacheCreateInfo.pNext = nullptr;
+  pipelineCacheCreateInfo.flags = 0;
+  pipelineCacheCreateInfo.initialDataSize = initialData.size();
+  pipelineCacheCreateInfo.pInitialData = initialData.data();
+  RETURN_ON_VULKAN_ERROR(vkCreatePipelineCache(device,
+                                               &pipelineCacheCreateInfo,
+                                               /*pAllocator=*/nullptr,
+                                               &pipelineCache),
+                         "vkCreatePipelineCache");
+  return success();
+}
+
+void VulkanContext::savePipelineCache() {
+  const char *path = getPipelineCachePath();
+  if (!path || pipelineCache == VK_NULL_HANDLE)
+    return;
+  size_t dataSize = 0;
+  if (vkGetPipelineCacheData(device, pipelineCache, &dataSize, nullptr) !=
+      VK_SUCCESS)
+    return;
+  std::vector<char> data(dataSize);
+  if (vkGetPipelineCacheData(device, pipelineCache, &dataSize, data.data()) !=
+      VK_SUCCESS)
+    return;
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(data.data(), dataSize);
+  if (!file)
+    std::cerr << "cannot save the pipeline cache to " << path;
+}
+
+LogicalResult VulkanContext::createInstance() {
   VkApplicationInfo applicationInfo = {};
   applicationInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
   applicationInfo.pNext = nullptr;
@@ -258,7 +367,7 @@ LogicalResult VulkanRuntime::createInstance() {
   return success();
 }
 
-LogicalResult VulkanRuntime::createDevice() {
+LogicalResult VulkanContext::createDevice() {
   uint32_t physicalDeviceCount = 0;
   RETURN_ON_VULKAN_ERROR(
       vkEnumeratePhysicalDevices(instance, &physicalDeviceCount, nullptr),
@@ -304,8 +413,20 @@ LogicalResult VulkanRuntime::createDevice() {
       vkCreateDevice(physicalDevice, &deviceCreateInfo, nullptr, &device),
       "vkCreateDevice");
 
-  VkPhysicalDeviceMemoryProperties properties = {};
-  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &properties);
+  vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+  // Get timestamp period for this physical device.
+  VkPhysicalDeviceProperties deviceProperties = {};
+  vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+  timestampPeriod = deviceProperties.limits.timestampPeriod;
+  return success();
+}
+
+LogicalResult VulkanRuntime::selectMemoryTypes() {
+  const VkPhysicalDeviceMemoryProperties &properties =
+      context.memoryProperties;
+  hostMemoryTypeIndex = VK_MAX_MEMORY_TYPES;
+  deviceMemoryTypeIndex = VK_MAX_MEMORY_TYPES;
 
   // Try to find memory type with following properties:
   // VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT bit specifies that memory allocated
@@ -347,7 +468,7 @@ LogicalResult VulkanRuntime::createDevice() {
   return success();
 }
 
-LogicalResult VulkanRuntime::getBestComputeQueue() {
+LogicalResult VulkanContext::getBestComputeQueue() {
   uint32_t queueFamilyPropertiesCount = 0;
   vkGetPhysicalDeviceQueueFamilyProperties(
       physicalDevice, &queueFamilyPropertiesCount, nullptr);
@@ -470,7 +591,7 @@ LogicalResult VulkanRuntime::createMemoryBuffers() {
                                VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
       bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
       bufferCreateInfo.queueFamilyIndexCount = 1;
-      bufferCreateInfo.pQueueFamilyIndices = &queueFamilyIndex;
+      bufferCreateInfo.pQueueFamilyIndices = &context.queueFamilyIndex;
       RETURN_ON_VULKAN_ERROR(vkCreateBuffer(device, &bufferCreateInfo, nullptr,
                                             &memoryBuffer.hostBuffer),
                              "vkCreateBuffer");
@@ -500,32 +621,9 @@ LogicalResult VulkanRuntime::createMemoryBuffers() {
   return success();
 }
 
-LogicalResult VulkanRuntime::copyResource(bool deviceToHost) {
-  VkCommandBufferAllocateInfo commandBufferAllocateInfo = {
-      VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-      nullptr,
-      commandPool,
-      VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-      1,
-  };
-  VkCommandBuffer commandBuffer;
-  RETURN_ON_VULKAN_ERROR(vkAllocateCommandBuffers(device,
-                                                  &commandBufferAllocateInfo,
-                                                  &commandBuffer),
-                         "vkAllocateCommandBuffers");
-
-  VkCommandBufferBeginInfo commandBufferBeginInfo = {
-      VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-      nullptr,
-      0,
-      nullptr,
-  };
-  RETURN_ON_VULKAN_ERROR(
-      vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo),
-      "vkBeginCommandBuffer");
-
+void VulkanRuntime::recordCopyResource(VkCommandBuffer commandBuffer,
+                                       bool deviceToHost) {
   for (const auto &deviceMemoryBufferMapPair : deviceMemoryBufferMap) {
-    std::vector<VkDescriptorSetLayoutBinding> descriptorSetLayoutBindings;
     const auto &deviceMemoryBuffers = deviceMemoryBufferMapPair.second;
     for (const auto &memBuffer : deviceMemoryBuffers) {
       VkBufferCopy copy = {0, 0, memBuffer.bufferSize};
@@ -537,26 +635,66 @@ LogicalResult VulkanRuntime::copyResource(bool deviceToHost) {
                         memBuffer.deviceBuffer, 1, &copy);
     }
   }
+}
 
-  RETURN_ON_VULKAN_ERROR(vkEndCommandBuffer(commandBuffer),
-                         "vkEndCommandBuffer");
-  VkSubmitInfo submitInfo = {
-      VK_STRUCTURE_TYPE_SUBMIT_INFO,
-      nullptr,
-      0,
-      nullptr,
-      nullptr,
-      1,
-      &commandBuffer,
-      0,
-      nullptr,
-  };
-  submitInfo.pCommandBuffers = &commandBuffer;
-  RETURN_ON_VULKAN_ERROR(vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE),
-                         "vkQueueSubmit");
-  RETURN_ON_VULKAN_ERROR(vkQueueWaitIdle(queue), "vkQueueWaitIdle");
+/// Records a barrier making the memory accesses of `srcStage` visible to the
+/// memory accesses of `dstStage`.
+static void recordMemoryBarrier(VkCommandBuffer commandBuffer,
+                                VkPipelineStageFlags srcStage,
+                                VkAccessFlags srcAccess,
+                                VkPipelineStageFlags dstStage,
+                                VkAccessFlags dstAccess) {
+  VkMemoryBarrier memoryBarrier = {};
+  memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+  memoryBarrier.pNext = nullptr;
+  memoryBarrier.srcAccessMask = srcAccess;
+  memoryBarrier.dstAccessMask = dstAccess;
+  vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, /*dependencyFlags=*/0,
+                       /*memoryBarrierCount=*/1, &memoryBarrier,
+                       /*bufferMemoryBarrierCount=*/0, nullptr,
+                       /*imageMemoryBarrierCount=*/0, nullptr);
+}
+
+LogicalResult VulkanRuntime::getOrCreatePipelineState() {
+  // The pipeline state depends on the shader and on the layouts of the
+  // descriptor sets, in the order they are created in.
+  std::string key(entryPoint);
+  key.push_back('\0');
+  key.append(reinterpret_cast<const char *>(binary), binarySize);
+  for (const auto &deviceMemoryBufferMapPair : deviceMemoryBufferMap) {
+    key += ";" + std::to_string(deviceMemoryBufferMapPair.first);
+    for (const auto &binding :
+         descriptorSetLayoutBindingMap[deviceMemoryBufferMapPair.first])
+      key += "," + std::to_string(binding.binding) + ":" +
+             std::to_string(binding.descriptorType);
+  }
+
+  auto pipelineStateIt = context.pipelineStates.find(key);
+  if (pipelineStateIt != context.pipelineStates.end()) {
+    pipelineState = &pipelineStateIt->second;
+    // The descriptor sets of the previous run are freed here.
+    RETURN_ON_VULKAN_ERROR(
+        vkResetDescriptorPool(device, pipelineState->descriptorPool, 0),
+        "vkResetDescriptorPool");
+    return success();
+  }
 
-  vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
+  pipelineState = &context.pipelineStates[key];
+  if (failed(createShaderModule()) || failed(createDescriptorSetLayout()) ||
+      failed(createPipelineLayout()) || failed(createComputePipeline()) ||
+      failed(createDescriptorPool())) {
+    // Drop the incomplete state, to recreate it on the next run.
+    VulkanPipelineState &state = *pipelineState;
+    vkDestroyDescriptorPool(device, state.descriptorPool, nullptr);
+    vkDestroyPipeline(device, state.pipeline, nullptr);
+    vkDestroyPipelineLayout(device, state.pipelineLayout, nullptr);
+    for (auto &descriptorSetLayout : state.descriptorSetLayouts)
+      vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+    vkDestroyShaderModule(device, state.shaderModule, nullptr);
+    context.pipelineStates.erase(key);
+    pipelineState = nullptr;
+    return failure();
+  }
   return success();
 }
 
@@ -570,7 +708,8 @@ LogicalResult VulkanRuntime::createShaderModule() {
   // Set pointer to the binary shader.
   shaderModuleCreateInfo.pCode = reinterpret_cast<uint32_t *>(binary);
   RETURN_ON_VULKAN_ERROR(vkCreateShaderModule(device, &shaderModuleCreateInfo,
-                                              nullptr, &shaderModule),
+                                              nullptr,
+                                              &pipelineState->shaderModule),
                          "vkCreateShaderModule");
   return success();
 }
@@ -633,8 +772,8 @@ LogicalResult VulkanRuntime::createDescriptorSetLayout() {
                                     nullptr, &descriptorSetLayout),
         "vkCreateDescriptorSetLayout");
 
-    descriptorSetLayouts.push_back(descriptorSetLayout);
-    descriptorSetInfoPool.push_back(
+    pipelineState->descriptorSetLayouts.push_back(descriptorSetLayout);
+    pipelineState->descriptorSetInfoPool.push_back(
         {descriptorSetIndex, descriptorSize, descriptorType});
   }
   return success();
@@ -647,13 +786,15 @@ LogicalResult VulkanRuntime::createPipelineLayout() {
       VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
   pipelineLayoutCreateInfo.pNext = nullptr;
   pipelineLayoutCreateInfo.flags = 0;
-  pipelineLayoutCreateInfo.setLayoutCount = descriptorSetLayouts.size();
-  pipelineLayoutCreateInfo.pSetLayouts = descriptorSetLayouts.data();
+  pipelineLayoutCreateInfo.setLayoutCount =
+      pipelineState->descriptorSetLayouts.size();
+  pipelineLayoutCreateInfo.pSetLayouts =
+      pipelineState->descriptorSetLayouts.data();
   pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
   pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
-  RETURN_ON_VULKAN_ERROR(vkCreatePipelineLayout(device,
-                                                &pipelineLayoutCreateInfo,
-                                                nullptr, &pipelineLayout),
+  RETURN_ON_VULKAN_ERROR(
+      vkCreatePipelineLayout(device, &pipelineLayoutCreateInfo, nullptr,
+                             &pipelineState->pipelineLayout),
                          "vkCreatePipelineLayout");
   return success();
 }
@@ -664,7 +805,7 @@ LogicalResult VulkanRuntime::createComputePipeline() {
   stageInfo.pNext = nullptr;
   stageInfo.flags = 0;
   stageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-  stageInfo.module = shaderModule;
+  stageInfo.module = pipelineState->shaderModule;
   // Set entry point.
   stageInfo.pName = entryPoint;
   stageInfo.pSpecializationInfo = nullptr;
@@ -675,19 +816,20 @@ LogicalResult VulkanRuntime::createComputePipeline() {
   computePipelineCreateInfo.pNext = nullptr;
   computePipelineCreateInfo.flags = 0;
   computePipelineCreateInfo.stage = stageInfo;
-  computePipelineCreateInfo.layout = pipelineLayout;
+  computePipelineCreateInfo.layout = pipelineState->pipelineLayout;
   computePipelineCreateInfo.basePipelineHandle = nullptr;
   computePipelineCreateInfo.basePipelineIndex = 0;
-  RETURN_ON_VULKAN_ERROR(vkCreateComputePipelines(device, nullptr, 1,
-                                                  &computePipelineCreateInfo,
-                                                  nullptr, &pipeline),
+  RETURN_ON_VULKAN_ERROR(
+      vkCreateComputePipelines(device, context.pipelineCache, 1,
+                               &computePipelineCreateInfo, nullptr,
+                               &pipelineState->pipeline),
                          "vkCreateComputePipelines");
   return success();
 }
 
 LogicalResult VulkanRuntime::createDescriptorPool() {
   std::vector<VkDescriptorPoolSize> descriptorPoolSizes;
-  for (const auto &descriptorSetInfo : descriptorSetInfoPool) {
+  for (const auto &descriptorSetInfo : pipelineState->descriptorSetInfoPool) {
     // For each descriptor set populate descriptor pool size.
     VkDescriptorPoolSize descriptorPoolSize = {};
     descriptorPoolSize.type = descriptorSetInfo.descriptorType;
@@ -703,9 +845,9 @@ LogicalResult VulkanRuntime::createDescriptorPool() {
   descriptorPoolCreateInfo.maxSets = descriptorPoolSizes.size();
   descriptorPoolCreateInfo.poolSizeCount = descriptorPoolSizes.size();
   descriptorPoolCreateInfo.pPoolSizes = descriptorPoolSizes.data();
-  RETURN_ON_VULKAN_ERROR(vkCreateDescriptorPool(device,
-                                                &descriptorPoolCreateInfo,
-                                                nullptr, &descriptorPool),
+  RETURN_ON_VULKAN_ERROR(
+      vkCreateDescriptorPool(device, &descriptorPoolCreateInfo, nullptr,
+                             &pipelineState->descriptorPool),
                          "vkCreateDescriptorPool");
   return success();
 }
@@ -713,11 +855,12 @@ LogicalResult VulkanRuntime::createDescriptorPool() {
 LogicalResult VulkanRuntime::allocateDescriptorSets() {
   VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {};
   // Size of descriptor sets and descriptor layout sets is the same.
+  const auto &descriptorSetLayouts = pipelineState->descriptorSetLayouts;
   descriptorSets.resize(descriptorSetLayouts.size());
   descriptorSetAllocateInfo.sType =
       VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
   descriptorSetAllocateInfo.pNext = nullptr;
-  descriptorSetAllocateInfo.descriptorPool = descriptorPool;
+  descriptorSetAllocateInfo.descriptorPool = pipelineState->descriptorPool;
   descriptorSetAllocateInfo.descriptorSetCount = descriptorSetLayouts.size();
   descriptorSetAllocateInfo.pSetLayouts = descriptorSetLayouts.data();
   RETURN_ON_VULKAN_ERROR(vkAllocateDescriptorSets(device,
@@ -728,6 +871,7 @@ LogicalResult VulkanRuntime::allocateDescriptorSets() {
 }
 
 LogicalResult VulkanRuntime::setWriteDescriptors() {
+  const auto &descriptorSetInfoPool = pipelineState->descriptorSetInfoPool;
   if (descriptorSets.size() != descriptorSetInfoPool.size()) {
     std::cerr << "Each descriptor set must have descriptor set information";
     return failure();
@@ -761,29 +905,11 @@ LogicalResult VulkanRuntime::setWriteDescriptors() {
   return success();
 }
 
-LogicalResult VulkanRuntime::createCommandPool() {
-  VkCommandPoolCreateInfo commandPoolCreateInfo = {};
-  commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-  commandPoolCreateInfo.pNext = nullptr;
-  commandPoolCreateInfo.flags = 0;
-  commandPoolCreateInfo.queueFamilyIndex = queueFamilyIndex;
-  RETURN_ON_VULKAN_ERROR(vkCreateCommandPool(device, &commandPoolCreateInfo,
-                                             /*pAllocator=*/nullptr,
-                                             &commandPool),
-                         "vkCreateCommandPool");
-  return success();
-}
-
 LogicalResult VulkanRuntime::createQueryPool() {
   // Return directly if timestamp query is not supported.
-  if (queueFamilyProperties.timestampValidBits == 0)
+  if (context.queueFamilyProperties.timestampValidBits == 0)
     return success();
 
-  // Get timestamp period for this physical device.
-  VkPhysicalDeviceProperties deviceProperties = {};
-  vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
-  timestampPeriod = deviceProperties.limits.timestampPeriod;
-
   // Create query pool.
   VkQueryPoolCreateInfo queryPoolCreateInfo = {};
   queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
@@ -804,7 +930,7 @@ LogicalResult VulkanRuntime::createComputeCommandBuffer() {
   commandBufferAllocateInfo.sType =
       VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
   commandBufferAllocateInfo.pNext = nullptr;
-  commandBufferAllocateInfo.commandPool = commandPool;
+  commandBufferAllocateInfo.commandPool = context.commandPool;
   commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
   commandBufferAllocateInfo.commandBufferCount = 1;
 
@@ -828,10 +954,19 @@ LogicalResult VulkanRuntime::createComputeCommandBuffer() {
   if (queryPool != VK_NULL_HANDLE)
     vkCmdResetQueryPool(commandBuffer, queryPool, 0, 2);
 
-  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+  // Copy the resources to the device before the shader accesses them.
+  recordCopyResource(commandBuffer, /*deviceToHost=*/false);
+  recordMemoryBarrier(
+      commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                    pipelineState->pipeline);
   vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
-                          pipelineLayout, 0, descriptorSets.size(),
-                          descriptorSets.data(), 0, nullptr);
+                          pipelineState->pipelineLayout, 0,
+                          descriptorSets.size(), descriptorSets.data(), 0,
+                          nullptr);
   // Get a timestamp before invoking the compute shader.
   if (queryPool != VK_NULL_HANDLE)
     vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
@@ -843,6 +978,17 @@ LogicalResult VulkanRuntime::createComputeCommandBuffer() {
     vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
                         queryPool, 1);
 
+  // Copy the resources back to the staging buffers once the shader is done,
+  // and make them visible to the host.
+  recordMemoryBarrier(
+      commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+      VK_ACCESS_TRANSFER_READ_BIT);
+  recordCopyResource(commandBuffer, /*deviceToHost=*/true);
+  recordMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                      VK_ACCESS_HOST_READ_BIT);
+
   // Commands end.
   RETURN_ON_VULKAN_ERROR(vkEndCommandBuffer(commandBuffer),
                          "vkEndCommandBuffer");
@@ -862,15 +1008,22 @@ LogicalResult VulkanRuntime::submitCommandBuffersToQueue() {
   submitInfo.pCommandBuffers = commandBuffers.data();
   submitInfo.signalSemaphoreCount = 0;
   submitInfo.pSignalSemaphores = nullptr;
-  RETURN_ON_VULKAN_ERROR(vkQueueSubmit(queue, 1, &submitInfo, nullptr),
+
+  VkFenceCreateInfo fenceCreateInfo = {};
+  fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+  fenceCreateInfo.pNext = nullptr;
+  fenceCreateInfo.flags = 0;
+  RETURN_ON_VULKAN_ERROR(
+      vkCreateFence(device, &fenceCreateInfo, /*pAllocator=*/nullptr, &fence),
+      "vkCreateFence");
+  RETURN_ON_VULKAN_ERROR(vkQueueSubmit(context.queue, 1, &submitInfo, fence),
                          "vkQueueSubmit");
   return success();
 }
 
 LogicalResult VulkanRuntime::updateHostMemoryBuffers() {
-  // First copy back the data to the staging buffer.
-  (void)copyResource(/*deviceToHost=*/true);
-
+  // The data was copied back to the staging buffers by the command buffer of
+  // the run.
   // For each descriptor set.
   for (auto &resourceDataMapPair : resourceData) {
     auto &resourceDataMap = resourceDataMapPair.second;
@@ -15,6 +15,9 @@
 
 #include "mlir/Support/LogicalResult.h"
 
+#include <map>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 #include <vulkan/vulkan.h>
@@ -81,9 +84,73 @@ using ResourceStorageClassBindingMap =
     std::unordered_map<DescriptorSetIndex,
                        std::unordered_map<BindingIndex, SPIRVStorageClass>>;
 
+/// Struct containing the Vulkan objects that only depend on a compute shader
+/// and on the layouts of its descriptor sets.
+struct VulkanPipelineState {
+  VkShaderModule shaderModule{VK_NULL_HANDLE};
+  std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
+  VkPipelineLayout pipelineLayout{VK_NULL_HANDLE};
+  VkPipeline pipeline{VK_NULL_HANDLE};
+  /// Information of the descriptor sets, in the order of the layouts.
+  std::vector<DescriptorSetInfo> descriptorSetInfoPool;
+  /// Pool of the descriptor sets of the pipeline, reset before each run.
+  VkDescriptorPool descriptorPool{VK_NULL_HANDLE};
+};
+
+/// Vulkan context.
+/// The Vulkan objects shared by the runtimes of a process: the instance, the
+/// device, the command pool, the pipeline cache and the pipeline states of the
+/// compute shaders that already ran. The repeated invocations of a shader thus
+/// only create its memory buffers and record its commands. If the
+/// `MLIR_VULKAN_PIPELINE_CACHE` environment variable is set, the pipeline cache
+/// is loaded from the file it names on creation, and saved to it on
+/// destruction.
+class VulkanContext {
+public:
+  VulkanContext() = default;
+  VulkanContext(const VulkanContext &) = delete;
+  VulkanContext &operator=(const VulkanContext &) = delete;
+  ~VulkanContext() { (void)destroy(); }
+
+  /// Creates the shared Vulkan objects, unless already created.
+  LogicalResult init();
+
+  /// Saves the pipeline cache and destroys all created vulkan objects.
+  LogicalResult destroy();
+
+  VkInstance instance{VK_NULL_HANDLE};
+  VkPhysicalDevice physicalDevice{VK_NULL_HANDLE};
+  VkDevice device{VK_NULL_HANDLE};
+  VkQueue queue{VK_NULL_HANDLE};
+  VkCommandPool commandPool{VK_NULL_HANDLE};
+  VkPipelineCache pipelineCache{VK_NULL_HANDLE};
+
+  uint32_t queueFamilyIndex{0};
+  VkQueueFamilyProperties queueFamilyProperties{};
+  VkPhysicalDeviceMemoryProperties memoryProperties{};
+  // Number of nonoseconds for timestamp to increase 1
+  float timestampPeriod{0.f};
+
+  /// Pipeline states keyed by the entry point, the binary shader and the
+  /// layouts of the descriptor sets.
+  std::map<std::string, VulkanPipelineState> pipelineStates;
+
+  /// Guards the shared objects, as the queue and the command pool must be
+  /// externally synchronized.
+  std::mutex mutex;
+
+private:
+  LogicalResult createInstance();
+  LogicalResult createDevice();
+  LogicalResult getBestComputeQueue();
+  LogicalResult createCommandPool();
+  LogicalResult createPipelineCache();
+  void savePipelineCache();
+};
+
 /// Vulkan runtime.
 /// The purpose of this class is to run SPIR-V compute shader on Vulkan
-/// device.
+/// device, using the objects of the given context.
 /// Before the run, user must provide and set resource data with descriptors,
 /// SPIR-V shader, number of work groups and entry point. After the creation of
 /// VulkanRuntime, special methods must be called in the following
@@ -92,7 +159,7 @@ using ResourceStorageClassBindingMap =
 /// result code.
 class VulkanRuntime {
 public:
-  explicit VulkanRuntime() = default;
+  explicit VulkanRuntime(VulkanContext &context) : context(context) {}
   VulkanRuntime(const VulkanRuntime &) = delete;
   VulkanRuntime &operator=(const VulkanRuntime &) = delete;
 
@@ -116,7 +183,8 @@ public:
   /// Updates host memory buffers.
   LogicalResult updateHostMemoryBuffers();
 
-  /// Destroys all created vulkan objects and resources.
+  /// Destroys the vulkan objects and resources created for the run. The
+  /// objects of the context are kept for the next runs.
   LogicalResult destroy();
 
 private:
@@ -124,25 +192,24 @@ private:
   // Pipeline creation methods.
   //===--------------------------------------------------------------------===//
 
-  LogicalResult createInstance();
-  LogicalResult createDevice();
-  LogicalResult getBestComputeQueue();
+  LogicalResult selectMemoryTypes();
   LogicalResult createMemoryBuffers();
-  LogicalResult createShaderModule();
   void initDescriptorSetLayoutBindingMap();
+  /// Looks up the pipeline state of the shader in the context, or creates it.
+  LogicalResult getOrCreatePipelineState();
+  LogicalResult createShaderModule();
   LogicalResult createDescriptorSetLayout();
   LogicalResult createPipelineLayout();
   LogicalResult createComputePipeline();
   LogicalResult createDescriptorPool();
   LogicalResult allocateDescriptorSets();
   LogicalResult setWriteDescriptors();
-  LogicalResult createCommandPool();
   LogicalResult createQueryPool();
   LogicalResult createComputeCommandBuffer();
   LogicalResult submitCommandBuffersToQueue();
-  // Copy resources from host (staging buffer) to device buffer or from device
-  // buffer to host buffer.
-  LogicalResult copyResource(bool deviceToHost);
+  // Record the copies of the resources from host (staging buffer) to device
+  // buffer or from device buffer to host buffer.
+  void recordCopyResource(VkCommandBuffer commandBuffer, bool deviceToHost);
 
   //===--------------------------------------------------------------------===//
   // Helper methods.
@@ -164,51 +231,37 @@ private:
   // Vulkan objects.
   //===--------------------------------------------------------------------===//
 
-  VkInstance instance{VK_NULL_HANDLE};
-  VkPhysicalDevice physicalDevice{VK_NULL_HANDLE};
+  /// The context holding the device and the pipeline states.
+  VulkanContext &context;
   VkDevice device{VK_NULL_HANDLE};
-  VkQueue queue{VK_NULL_HANDLE};
 
   /// Specifies VulkanDeviceMemoryBuffers divided into sets.
   std::unordered_map<DescriptorSetIndex, std::vector<VulkanDeviceMemoryBuffer>>
       deviceMemoryBufferMap;
 
-  /// Specifies shader module.
-  VkShaderModule shaderModule{VK_NULL_HANDLE};
-
   /// Specifies layout bindings.
   std::unordered_map<DescriptorSetIndex,
                      std::vector<VkDescriptorSetLayoutBinding>>
       descriptorSetLayoutBindingMap;
 
-  /// Specifies layouts of descriptor sets.
-  std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
-  VkPipelineLayout pipelineLayout{VK_NULL_HANDLE};
+  /// Specifies the shader module, the layouts of descriptor sets, the
+  /// computation pipeline and the descriptor pool, owned by the context.
+  VulkanPipelineState *pipelineState{nullptr};
 
   /// Specifies descriptor sets.
   std::vector<VkDescriptorSet> descriptorSets;
 
-  /// Specifies a pool of descriptor set info, each descriptor set must have
-  /// information such as type, index and amount of bindings.
-  std::vector<DescriptorSetInfo> descriptorSetInfoPool;
-  VkDescriptorPool descriptorPool{VK_NULL_HANDLE};
-
   /// Timestamp query.
   VkQueryPool queryPool{VK_NULL_HANDLE};
-  // Number of nonoseconds for timestamp to increase 1
-  float timestampPeriod{0.f};
 
-  /// Computation pipeline.
-  VkPipeline pipeline{VK_NULL_HANDLE};
-  VkCommandPool commandPool{VK_NULL_HANDLE};
+  /// Command buffers and the fence signaled when they complete.
   std::vector<VkCommandBuffer> commandBuffers;
+  VkFence fence{VK_NULL_HANDLE};
 
   //===--------------------------------------------------------------------===//
   // Vulkan memory context.
   //===--------------------------------------------------------------------===//
 
-  uint32_t queueFamilyIndex{0};
-  VkQueueFamilyProperties queueFamilyProperties{};
   uint32_t hostMemoryTypeIndex{VK_MAX_MEMORY_TYPES};
   uint32_t deviceMemoryTypeIndex{VK_MAX_MEMORY_TYPES};
   VkDeviceSize memorySize{0};
@@ -26,9 +26,16 @@
 
 namespace {
 
+/// Returns the Vulkan context shared by the runtime managers, which keeps the
+/// device and the pipelines of the shaders alive across the kernel launches.
+VulkanContext &getVulkanContext() {
+  static VulkanContext context;
+  return context;
+}
+
 class VulkanRuntimeManager {
 public:
-  VulkanRuntimeManager() = default;
+  VulkanRuntimeManager() : vulkanRuntime(getVulkanContext()) {}
   VulkanRuntimeManager(const VulkanRuntimeManager &) = delete;
   VulkanRuntimeManager operator=(const VulkanRuntimeManager &) = delete;
   ~VulkanRuntimeManager() = default;
@@ -56,6 +63,7 @@ public:
 
   void runOnVulkan() {
     std::lock_guard<std::mutex> lock(mutex);
+    std::lock_guard<std::mutex> contextLock(getVulkanContext().mutex);
     if (failed(vulkanRuntime.initRuntime()) || failed(vulkanRuntime.run()) ||
         failed(vulkanRuntime.updateHostMemoryBuffers()) ||
         failed(vulkanRuntime.destroy())) {
@@ -198,3 +198,23 @@ TYPED_TEST(IntTest, floorCeilModAbsLcmGcd) {
     EXPECT_EQ(lcm(15 * y, 6 * y), 30 * y);
   }
 }
+
+TEST(MPIntTest, addProduct) {
+  MPInt x(10);
+  x.addProduct(MPInt(3), MPInt(-4));
+  EXPECT_EQ(x, -2);
+
+  // The product and the sum overflow int64_t.
+  MPInt big(1ll << 62);
+  MPInt y(1);
+  y.addProduct(big, MPInt(4));
+  EXPECT_EQ(y, big * 4 + 1);
+  MPInt z(std::numeric_limits<int64_t>::max());
+  z.addProduct(MPInt(1), MPInt(1));
+  EXPECT_EQ(z, MPInt(std::numeric_limits<int64_t>::max()) + 1);
+
+  // Large values.
+  MPInt w = big * big;
+  w.addProduct(-big, big);
+  EXPECT_EQ(w, 0);
+}
@@ -193,6 +193,25 @@ TEST(MatrixTest, resize) {
       EXPECT_EQ(mat(row, col), row >= 3 || col >= 3 ? 0 : int(10 * row + col));
 }
 
+TEST(MatrixTest, rowOperations) {
+  Matrix mat = makeMatrix(2, 3, {{1, 2, 3}, {4, 5, 6}});
+  mat.addToRow(0, 1, -2);
+  mat.scaleRow(0, 3);
+  mat.addToColumn(0, 2, 1);
+  Matrix expected = makeMatrix(2, 3, {{3, 6, 12}, {2, 1, 2}});
+  for (unsigned row = 0; row < 2; ++row)
+    for (unsigned col = 0; col < 3; ++col)
+      EXPECT_EQ(mat(row, col), expected(row, col));
+
+  // The products overflow int64_t.
+  MPInt big(1ll << 62);
+  mat.scaleRow(1, big);
+  mat.addToRow(0, 1, big);
+  EXPECT_EQ(mat(1, 0), 5 * big);
+  EXPECT_EQ(mat(1, 1), 7 * big);
+  EXPECT_EQ(mat(1, 2), 14 * big);
+}
+
 static void checkHermiteNormalForm(const Matrix &mat,
                                    const Matrix &hermiteForm) {
   auto [h, u] = mat.computeHermiteNormalForm();
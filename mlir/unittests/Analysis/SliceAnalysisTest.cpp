@@ -0,0 +1,95 @@
+//===- SliceAnalysisTest.cpp - Unit Tests for Slice Analysis --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Analysis/SliceAnalysis.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Parser/Parser.h"
+
+#include <gtest/gtest.h>
+
+using namespace mlir;
+
+class SliceCacheTest : public testing::Test {
+protected:
+  void SetUp() override {
+    const char *ir = R"MLIR(
+      %0 = "test.a"() : () -> i32
+      %1 = "test.b"(%0) : (i32) -> i32
+      %2 = "test.c"(%0) : (i32) -> i32
+      %3 = "test.d"(%1, %2) : (i32, i32) -> i32
+      "test.e"(%3, %1) : (i32, i32) -> ()
+    )MLIR";
+
+    ctx.allowUnregisteredDialects();
+    module = parseSourceString<ModuleOp>(ir, &ctx);
+    ASSERT_TRUE(module);
+    for (Operation &op : *module->getBody())
+      ops.push_back(&op);
+  }
+
+  SetVector<Operation *> getBackwardSlice(Operation *op) {
+    SetVector<Operation *> slice;
+    mlir::getBackwardSlice(op, &slice);
+    return slice;
+  }
+
+  SetVector<Operation *> getForwardSlice(Operation *op) {
+    SetVector<Operation *> slice;
+    mlir::getForwardSlice(op, &slice);
+    return slice;
+  }
+
+  MLIRContext ctx;
+  OwningOpRef<ModuleOp> module;
+  SmallVector<Operation *> ops;
+};
+
+TEST_F(SliceCacheTest, MatchesUncachedSlices) {
+  SliceCache cache;
+  // Cache the slices of the intermediate ops first, for them to be reused by
+  // the slices of the other ops.
+  for (Operation *op : {ops[1], ops[2], ops[0], ops[3], ops[4]}) {
+    EXPECT_EQ(cache.getBackwardSlice(op),
+              ArrayRef<Operation *>(getBackwardSlice(op).getArrayRef()));
+    EXPECT_EQ(cache.getForwardSlice(op),
+              ArrayRef<Operation *>(getForwardSlice(op).getArrayRef()));
+  }
+}
+
+TEST_F(SliceCacheTest, FilteredSlices) {
+  SliceCache cache;
+  BackwardSliceOptions options;
+  options.filter = [&](Operation *op) { return op != ops[2]; };
+  SetVector<Operation *> slice;
+  mlir::getBackwardSlice(ops[4], &slice, options);
+
+  // The slices computed with other options are cached separately.
+  EXPECT_EQ(cache.getBackwardSlice(ops[4]).size(), 4u);
+  int optionsKey;
+  EXPECT_EQ(cache.getBackwardSlice(ops[4], options, &optionsKey),
+            ArrayRef<Operation *>(slice.getArrayRef()));
+  EXPECT_FALSE(cache.isInBackwardSlice(ops[2], ops[4], options, &optionsKey));
+  EXPECT_TRUE(cache.isInBackwardSlice(ops[2], ops[4]));
+}
+
+TEST_F(SliceCacheTest, Membership) {
+  SliceCache cache;
+  // The ops after the root in the block are not in its backward slice, and
+  // the ops before it are not in its forward slice.
+  EXPECT_FALSE(cache.isInBackwardSlice(ops[4], ops[1]));
+  EXPECT_FALSE(cache.isInForwardSlice(ops[0], ops[1]));
+  EXPECT_FALSE(cache.isInBackwardSlice(ops[1], ops[1]));
+
+  EXPECT_TRUE(cache.isInBackwardSlice(ops[0], ops[3]));
+  EXPECT_FALSE(cache.isInBackwardSlice(ops[2], ops[1]));
+  EXPECT_TRUE(cache.isInForwardSlice(ops[4], ops[2]));
+  EXPECT_FALSE(cache.isInForwardSlice(ops[2], ops[1]));
+
+  cache.clear();
+  EXPECT_TRUE(cache.isInForwardSlice(ops[3], ops[0]));
+}
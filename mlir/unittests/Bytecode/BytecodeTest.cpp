@@ -10,12 +10,20 @@
 #include "mlir/Bytecode/BytecodeWriter.h"
 #include "mlir/IR/AsmState.h"
 #include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
 #include "mlir/IR/OpImplementation.h"
 #include "mlir/IR/OwningOpRef.h"
 #include "mlir/Parser/Parser.h"
 
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/Endian.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/ToolOutputFile.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -80,3 +88,238 @@ TEST(Bytecode, MultiModuleWithResource) {
   checkResourceAttribute(*module);
   checkResourceAttribute(*roundTripModule);
 }
+
+TEST(Bytecode, StreamOutput) {
+  MLIRContext context;
+  ParserConfig parseConfig(&context);
+  OwningOpRef<Operation *> module =
+      parseSourceString<Operation *>(IRWithResources, parseConfig);
+  ASSERT_TRUE(module);
+
+  // Streaming the sections out should produce the same encoding.
+  std::string buffer, streamedBuffer;
+  llvm::raw_string_ostream ostream(buffer), streamedOstream(streamedBuffer);
+  ASSERT_TRUE(succeeded(writeBytecodeToFile(module.get(), ostream)));
+  BytecodeWriterConfig streamConfig;
+  streamConfig.setStreamOutput();
+  ASSERT_TRUE(succeeded(
+      writeBytecodeToFile(module.get(), streamedOstream, streamConfig)));
+  EXPECT_EQ(ostream.str(), streamedOstream.str());
+}
+
+TEST(Bytecode, MappedResourceIsNotCopied) {
+  // FIXME: Parsing external resources does not work on big-endian
+  // platforms currently.
+  if (llvm::support::endian::system_endianness() ==
+      llvm::support::endianness::big)
+    GTEST_SKIP();
+
+  MLIRContext context;
+  ParserConfig parseConfig(&context);
+  OwningOpRef<Operation *> module =
+      parseSourceString<Operation *>(IRWithResources, parseConfig);
+  ASSERT_TRUE(module);
+
+  // Write the module to a bytecode file.
+  SmallString<128> path;
+  ASSERT_FALSE(
+      llvm::sys::fs::createTemporaryFile("mlir-bytecode", "mlirbc", path));
+  llvm::FileRemover remover(path);
+  {
+    std::error_code ec;
+    llvm::ToolOutputFile output(path, ec, llvm::sys::fs::OF_None);
+    ASSERT_FALSE(ec);
+    ASSERT_TRUE(succeeded(writeBytecodeToFile(module.get(), output.os())));
+    output.keep();
+  }
+
+  // Parse it back through a shared source manager owning the file buffer.
+  std::unique_ptr<llvm::MemoryBuffer> file = openSourceFile(path);
+  ASSERT_TRUE(file);
+  StringRef fileData = file->getBuffer();
+  auto sourceMgr = std::make_shared<llvm::SourceMgr>();
+  sourceMgr->AddNewSourceBuffer(std::move(file), SMLoc());
+  OwningOpRef<Operation *> roundTripModule =
+      parseSourceFile<Operation *>(sourceMgr, parseConfig);
+  ASSERT_TRUE(roundTripModule);
+
+  // Check that the resource references the file buffer directly.
+  auto attr = roundTripModule->getAttrOfType<DenseI32ResourceElementsAttr>(
+      "bytecode.test");
+  ASSERT_TRUE(attr);
+  AsmResourceBlob *blob = attr.getRawHandle().getBlob();
+  ASSERT_TRUE(blob);
+  ArrayRef<char> blobData = blob->getData();
+  EXPECT_FALSE(blob->isMutable());
+  EXPECT_GE(blobData.data(), fileData.begin());
+  EXPECT_LE(blobData.data() + blobData.size(), fileData.end());
+  EXPECT_THAT(*attr.tryGetAsArrayRef(), ElementsAre(1, 2, 3, 4));
+}
+
+StringLiteral IRWithIsolatedRegions = R"(
+module {
+  module @a {
+    %0 = "test.producer"() : () -> i32
+    "test.consumer"(%0, %1) : (i32, i64) -> ()
+    %1 = "test.producer"() : () -> i64
+  }
+  module @b {
+    %0 = "test.producer"() : () -> f32
+    "test.consumer"(%0, %0) : (f32, f32) -> ()
+    module @c {
+      %1 = "test.producer"() : () -> index
+      "test.consumer"(%1) : (index) -> ()
+    }
+  }
+}
+)";
+
+TEST(Bytecode, ParallelRegionParsing) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  ParserConfig parseConfig(&context);
+  OwningOpRef<Operation *> module =
+      parseSourceString<Operation *>(IRWithIsolatedRegions, parseConfig);
+  ASSERT_TRUE(module);
+
+  std::string buffer;
+  llvm::raw_string_ostream ostream(buffer);
+  ASSERT_TRUE(succeeded(writeBytecodeToFile(module.get(), ostream)));
+
+  // Parse the bytecode back with isolated regions parsed in parallel, and
+  // check that the result is identical to the original module.
+  ParserConfig parallelConfig(&context);
+  parallelConfig.setParseInParallel();
+  OwningOpRef<Operation *> roundTripModule =
+      parseSourceString<Operation *>(ostream.str(), parallelConfig);
+  ASSERT_TRUE(roundTripModule);
+
+  std::string expected, actual;
+  llvm::raw_string_ostream expectedStream(expected), actualStream(actual);
+  module->print(expectedStream);
+  roundTripModule->print(actualStream);
+  EXPECT_EQ(expectedStream.str(), actualStream.str());
+}
+
+/// Returns a module with a resource of `numElements` i32 elements, which
+/// compresses well once shuffled.
+static std::string getIRWithLargeResource(int numElements) {
+  std::string ir;
+  llvm::raw_string_ostream os(ir);
+  os << "module @TestDialectResources attributes {\n"
+     << "  bytecode.test = dense_resource<resource> : tensor<" << numElements
+     << "xi32>\n} {}\n{-#\n  dialect_resources: {\n    builtin: {\n"
+     << "      resource: \"0x04000000";
+  for (int i = 0; i < numElements; ++i) {
+    uint32_t value = llvm::support::endian::byte_swap<uint32_t>(
+        i, llvm::support::big);
+    os << llvm::format_hex_no_prefix(value, 8, /*Upper=*/true);
+  }
+  os << "\"\n    }\n  }\n#-}\n";
+  return os.str();
+}
+
+/// Returns the compression available in this build, if any.
+static std::optional<BytecodeWriterConfig::Compression>
+getAvailableCompression() {
+  if (llvm::compression::zstd::isAvailable())
+    return BytecodeWriterConfig::Compression::Zstd;
+  if (llvm::compression::zlib::isAvailable())
+    return BytecodeWriterConfig::Compression::Zlib;
+  return std::nullopt;
+}
+
+TEST(Bytecode, CompressedSections) {
+  // FIXME: Parsing external resources does not work on big-endian
+  // platforms currently.
+  if (llvm::support::endian::system_endianness() ==
+      llvm::support::endianness::big)
+    GTEST_SKIP();
+  std::optional<BytecodeWriterConfig::Compression> compression =
+      getAvailableCompression();
+  if (!compression)
+    GTEST_SKIP();
+
+  MLIRContext context;
+  ParserConfig parseConfig(&context);
+  OwningOpRef<Operation *> module =
+      parseSourceString<Operation *>(getIRWithLargeResource(4096), parseConfig);
+  ASSERT_TRUE(module);
+
+  std::string buffer, compressedBuffer;
+  llvm::raw_string_ostream ostream(buffer), compressedOstream(compressedBuffer);
+  ASSERT_TRUE(succeeded(writeBytecodeToFile(module.get(), ostream)));
+  BytecodeWriterConfig compressedConfig;
+  compressedConfig.setIRCompression(*compression);
+  compressedConfig.setResourceCompression(*compression, /*shuffleWidth=*/4);
+  ASSERT_TRUE(succeeded(
+      writeBytecodeToFile(module.get(), compressedOstream, compressedConfig)));
+  EXPECT_LT(compressedOstream.str().size(), ostream.str().size() / 4);
+
+  // Compression is not supported by older bytecode versions.
+  std::string oldBuffer;
+  llvm::raw_string_ostream oldOstream(oldBuffer);
+  compressedConfig.setDesiredBytecodeVersion(5);
+  ScopedDiagnosticHandler handler(&context,
+                                  [](Diagnostic &) { return success(); });
+  EXPECT_TRUE(failed(
+      writeBytecodeToFile(module.get(), oldOstream, compressedConfig)));
+
+  // Parse it back in a fresh context through a source manager owning the
+  // buffer, such that the resource section is decompressed lazily.
+  MLIRContext roundTripContext;
+  ParserConfig roundTripConfig(&roundTripContext);
+  auto sourceMgr = std::make_shared<llvm::SourceMgr>();
+  sourceMgr->AddNewSourceBuffer(
+      llvm::MemoryBuffer::getMemBuffer(compressedOstream.str(), "",
+                                       /*RequiresNullTerminator=*/false),
+      SMLoc());
+  OwningOpRef<Operation *> roundTripModule =
+      parseSourceFile<Operation *>(sourceMgr, roundTripConfig);
+  ASSERT_TRUE(roundTripModule);
+
+  DialectResourceBlobManager &blobManager =
+      DenseResourceElementsHandle::getManagerInterface(&roundTripContext)
+          .getBlobManager();
+  EXPECT_EQ(blobManager.getTotalBlobSize(), 0u);
+
+  auto attr = roundTripModule->getAttrOfType<DenseI32ResourceElementsAttr>(
+      "bytecode.test");
+  ASSERT_TRUE(attr);
+  std::optional<ArrayRef<int32_t>> attrData = attr.tryGetAsArrayRef();
+  ASSERT_TRUE(attrData.has_value());
+  ASSERT_EQ(attrData->size(), static_cast<size_t>(4096));
+  for (int i = 0; i < 4096; ++i)
+    ASSERT_EQ((*attrData)[i], i);
+  EXPECT_EQ(blobManager.getTotalBlobSize(), 4096 * sizeof(int32_t));
+}
+
+TEST(Bytecode, DropLocations) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  ParserConfig parseConfig(&context);
+  OwningOpRef<Operation *> module =
+      parseSourceString<Operation *>(IRWithIsolatedRegions, parseConfig);
+  ASSERT_TRUE(module);
+
+  std::string buffer;
+  llvm::raw_string_ostream ostream(buffer);
+  ASSERT_TRUE(succeeded(writeBytecodeToFile(module.get(), ostream)));
+
+  // Parse the bytecode back with the locations dropped, and check that only
+  // the locations differ from the original module.
+  ParserConfig dropConfig(&context);
+  dropConfig.setDropLocations();
+  OwningOpRef<Operation *> roundTripModule =
+      parseSourceString<Operation *>(ostream.str(), dropConfig);
+  ASSERT_TRUE(roundTripModule);
+  roundTripModule->walk([](Operation *op) {
+    EXPECT_TRUE(isa<UnknownLoc>(op->getLoc()));
+  });
+
+  std::string expected, actual;
+  llvm::raw_string_ostream expectedStream(expected), actualStream(actual);
+  module->print(expectedStream);
+  roundTripModule->print(actualStream);
+  EXPECT_EQ(expectedStream.str(), actualStream.str());
+}
@@ -0,0 +1,118 @@
+//===- OneShotAnalysisTest.cpp - One-Shot Analysis unit tests -------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/Bufferization/Transforms/OneShotAnalysis.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Bufferization/IR/Bufferization.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Tensor/Transforms/BufferizableOpInterfaceImpl.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Parser/Parser.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <string>
+
+using namespace mlir;
+using namespace mlir::bufferization;
+
+namespace {
+
+class OneShotAnalysisTest : public ::testing::Test {
+protected:
+  OneShotAnalysisTest() {
+    DialectRegistry registry;
+    registry.insert<arith::ArithDialect, BufferizationDialect,
+                    func::FuncDialect, tensor::TensorDialect>();
+    tensor::registerBufferizableOpInterfaceExternalModels(registry);
+    context.appendDialectRegistry(registry);
+    context.loadAllAvailableDialects();
+  }
+
+  /// Returns a function of `numInserts` chained tensor.insert ops into a
+  /// single alias set, every 8th of which conflicts with a read of the tensor
+  /// it overwrites.
+  static std::string getInsertChain(int numInserts) {
+    std::string code = "func.func @chain(%t: tensor<?xf32>, %f: f32) -> f32 {\n"
+                       "  %c0 = arith.constant 0 : index\n"
+                       "  %t0 = bufferization.alloc_tensor(%c0) "
+                       ": tensor<?xf32>\n";
+    for (int i = 1; i <= numInserts; ++i) {
+      std::string prev = "%t" + std::to_string(i - 1);
+      code += "  %t" + std::to_string(i) + " = tensor.insert %f into " + prev +
+              "[%c0] : tensor<?xf32>\n";
+      if (i % 8 == 0)
+        code += "  %e" + std::to_string(i) + " = tensor.extract " + prev +
+                "[%c0] : tensor<?xf32>\n";
+    }
+    code += "  %r = tensor.extract %t" + std::to_string(numInserts) +
+            "[%c0] : tensor<?xf32>\n"
+            "  return %r : f32\n"
+            "}\n";
+    return code;
+  }
+
+  /// Analyzes `moduleOp` and returns the in-place decisions of its tensor
+  /// OpOperands, in the order of the walk.
+  static std::vector<bool> analyze(ModuleOp moduleOp,
+                                   bool incrementalConflictAnalysis) {
+    OneShotBufferizationOptions options;
+    options.incrementalConflictAnalysis = incrementalConflictAnalysis;
+    OneShotAnalysisState state(moduleOp, options);
+    EXPECT_TRUE(succeeded(analyzeOp(moduleOp, state)));
+    std::vector<bool> decisions;
+    moduleOp->walk([&](Operation *op) {
+      for (OpOperand &opOperand : op->getOpOperands())
+        if (isa<TensorType>(opOperand.get().getType()))
+          decisions.push_back(state.isInPlace(opOperand));
+    });
+    return decisions;
+  }
+
+  MLIRContext context;
+};
+
+} // namespace
+
+// The incremental conflict analysis makes the same decisions as the analysis
+// checking all the pairs of reads and writes of the alias sets.
+TEST_F(OneShotAnalysisTest, IncrementalConflictAnalysisDecisions) {
+  OwningOpRef<ModuleOp> moduleOp =
+      parseSourceString<ModuleOp>(getInsertChain(64), &context);
+  ASSERT_TRUE(moduleOp);
+  std::vector<bool> decisions = analyze(*moduleOp, false);
+  std::vector<bool> incrementalDecisions = analyze(*moduleOp, true);
+  EXPECT_EQ(decisions, incrementalDecisions);
+  // The inserts into the tensors that are read afterwards are out-of-place.
+  EXPECT_TRUE(llvm::is_contained(decisions, false));
+  EXPECT_TRUE(llvm::is_contained(decisions, true));
+}
+
+// Measures the time taken by both analyses on growing alias sets. The times,
+// in microseconds, are recorded as properties of the test, e.g. in the XML
+// output requested with `--gtest_output=xml`, and are not checked since they
+// depend on the machine.
+TEST_F(OneShotAnalysisTest, IncrementalConflictAnalysisScaling) {
+  for (int numInserts : {1000, 2000, 4000}) {
+    OwningOpRef<ModuleOp> moduleOp =
+        parseSourceString<ModuleOp>(getInsertChain(numInserts), &context);
+    ASSERT_TRUE(moduleOp);
+    for (bool incrementalConflictAnalysis : {false, true}) {
+      auto start = std::chrono::steady_clock::now();
+      analyze(*moduleOp, incrementalConflictAnalysis);
+      auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start);
+      std::string key = std::string(incrementalConflictAnalysis
+                                        ? "incremental_us_"
+                                        : "default_us_") +
+                        std::to_string(numInserts);
+      RecordProperty(key, std::to_string(duration.count()));
+    }
+  }
+}
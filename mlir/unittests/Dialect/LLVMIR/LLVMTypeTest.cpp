@@ -8,6 +8,8 @@
 
 #include "LLVMTestBase.h"
 #include "mlir/Dialect/LLVMIR/LLVMTypes.h"
+#include "mlir/IR/Threading.h"
+#include "llvm/ADT/StringSet.h"
 
 using namespace mlir;
 using namespace mlir::LLVM;
@@ -51,3 +53,29 @@ TEST_F(LLVMIRTest, MutualReferencedSubElementTypes) {
   ASSERT_TRUE(bool(structType));
   ASSERT_TRUE(structType.getName().equals("foo"));
 }
+
+TEST_F(LLVMIRTest, NewIdentifiedStructs) {
+  Type body[] = {IntegerType::get(&context, 32)};
+  auto existing = LLVMStructType::getIdentified(&context, "foo");
+
+  // The structs created concurrently have distinct names, and none of them
+  // takes the name of the existing struct.
+  constexpr unsigned kNumStructs = 256;
+  SmallVector<LLVMStructType> structs(kNumStructs);
+  parallelFor(&context, 0, kNumStructs, [&](size_t i) {
+    structs[i] = LLVMStructType::getNewIdentified(&context, "foo", body);
+  });
+  llvm::StringSet<> names;
+  for (LLVMStructType structTy : structs) {
+    ASSERT_TRUE(names.insert(structTy.getName()).second);
+    ASSERT_NE(structTy, existing);
+    ASSERT_TRUE(structTy.isInitialized());
+    ASSERT_EQ(structTy.getBody(), ArrayRef<Type>(body));
+    ASSERT_FALSE(structTy.isPacked());
+  }
+
+  // The body of a new struct cannot be changed.
+  Type otherBody[] = {IntegerType::get(&context, 64)};
+  ASSERT_TRUE(failed(structs.front().setBody(otherBody, /*isPacked=*/false)));
+  ASSERT_TRUE(succeeded(existing.setBody(otherBody, /*isPacked=*/false)));
+}
@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "mlir/Target/SPIRV/Serialization.h"
+#include "mlir/Target/SPIRV/Deserialization.h"
 #include "mlir/Dialect/SPIRV/IR/SPIRVAttributes.h"
 #include "mlir/Dialect/SPIRV/IR/SPIRVDialect.h"
 #include "mlir/Dialect/SPIRV/IR/SPIRVEnums.h"
@@ -229,3 +230,34 @@ TEST_F(SerializationTest, DoesNotContainSymbolName) {
   };
   EXPECT_FALSE(scanInstruction(hasVarName));
 }
+
+//===----------------------------------------------------------------------===//
+// Batch serialization
+//===----------------------------------------------------------------------===//
+
+TEST_F(SerializationTest, SerializesModulesInBatch) {
+  addGlobalVar(getFloatStructType(), "var0");
+  OwningOpRef<spirv::ModuleOp> firstModule = std::move(module);
+  initModuleOp();
+  addGlobalVar(IntegerType::get(&context, 32), "var1");
+
+  SmallVector<spirv::ModuleOp> modules = {firstModule.get(), module.get()};
+  SmallVector<SmallVector<uint32_t, 0>> binaries;
+  ASSERT_TRUE(succeeded(spirv::serialize(modules, binaries)));
+  ASSERT_EQ(binaries.size(), 2u);
+
+  // Each binary is the one of its module serialized alone.
+  for (auto [moduleOp, batchBinary] : llvm::zip(modules, binaries)) {
+    binary.clear();
+    ASSERT_TRUE(succeeded(spirv::serialize(moduleOp, binary)));
+    EXPECT_EQ(batchBinary, binary);
+  }
+
+  SmallVector<ArrayRef<uint32_t>> views(binaries.begin(), binaries.end());
+  SmallVector<OwningOpRef<spirv::ModuleOp>> deserialized;
+  ASSERT_TRUE(succeeded(spirv::deserialize(views, &context, deserialized)));
+  ASSERT_EQ(deserialized.size(), 2u);
+  for (OwningOpRef<spirv::ModuleOp> &moduleOp : deserialized)
+    EXPECT_TRUE(
+        llvm::hasSingleElement(moduleOp->getOps<spirv::GlobalVariableOp>()));
+}
@@ -26,11 +26,14 @@
 #include "mlir/Target/LLVMIR/Dialect/Builtin/BuiltinToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
 #include "mlir/Target/LLVMIR/Export.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include "gmock/gmock.h"
 
+#include <thread>
+
 // SPARC currently lacks JIT support.
 #ifdef __sparc__
 #define SKIP_WITHOUT_JIT(x) DISABLED_##x
@@ -88,6 +91,166 @@ TEST(MLIRExecutionEngine, SKIP_WITHOUT_JIT(AddInteger)) {
   ASSERT_EQ(result, 42 + 42);
 }
 
+TEST(MLIRExecutionEngine, SKIP_WITHOUT_JIT(PersistentObjectCache)) {
+  std::string moduleStr = R"mlir(
+  func.func @foo(%arg0 : i32) -> i32 attributes { llvm.emit_c_interface } {
+    %res = arith.muli %arg0, %arg0 : i32
+    return %res : i32
+  }
+  )mlir";
+  DialectRegistry registry;
+  registerAllDialects(registry);
+  registerBuiltinDialectTranslation(registry);
+  registerLLVMDialectTranslation(registry);
+  MLIRContext context(registry);
+  OwningOpRef<ModuleOp> module =
+      parseSourceString<ModuleOp>(moduleStr, &context);
+  ASSERT_TRUE(!!module);
+  ASSERT_TRUE(succeeded(lowerToLLVMDialect(*module)));
+
+  SmallString<128> cacheDir;
+  ASSERT_FALSE(
+      llvm::sys::fs::createUniqueDirectory("mlir-object-cache", cacheDir));
+  ExecutionEngineOptions options;
+  options.objectCacheDir = cacheDir;
+
+  auto countEntries = [&]() {
+    std::error_code ec;
+    int numEntries = 0;
+    for (llvm::sys::fs::directory_iterator it(cacheDir, ec), e;
+         it != e && !ec; it.increment(ec))
+      ++numEntries;
+    return numEntries;
+  };
+
+  // The first engine compiles the module and populates the cache, the second
+  // one loads the object from disk. Both must produce the same result.
+  for (int i = 0; i < 2; ++i) {
+    auto jitOrError = ExecutionEngine::create(*module, options);
+    ASSERT_TRUE(!!jitOrError);
+    std::unique_ptr<ExecutionEngine> jit = std::move(jitOrError.get());
+    int result = 0;
+    llvm::Error error =
+        jit->invoke("foo", 7, ExecutionEngine::Result<int>(result));
+    ASSERT_TRUE(!error);
+    ASSERT_EQ(result, 49);
+    ASSERT_EQ(countEntries(), 1);
+  }
+
+  ASSERT_FALSE(llvm::sys::fs::remove_directories(cacheDir));
+}
+
+static void checkConcurrentOrLazyCompilation(unsigned numCompileThreads,
+                                             bool enableLazyCompilation) {
+  std::string moduleStr = R"mlir(
+  func.func @double(%arg0 : i32) -> i32 {
+    %res = arith.addi %arg0, %arg0 : i32
+    return %res : i32
+  }
+  func.func @foo(%arg0 : i32) -> i32 attributes { llvm.emit_c_interface } {
+    %0 = call @double(%arg0) : (i32) -> i32
+    %res = arith.addi %0, %arg0 : i32
+    return %res : i32
+  }
+  func.func @bar(%arg0 : i32) -> i32 attributes { llvm.emit_c_interface } {
+    %res = arith.subi %arg0, %arg0 : i32
+    return %res : i32
+  }
+  )mlir";
+  DialectRegistry registry;
+  registerAllDialects(registry);
+  registerBuiltinDialectTranslation(registry);
+  registerLLVMDialectTranslation(registry);
+  MLIRContext context(registry);
+  OwningOpRef<ModuleOp> module =
+      parseSourceString<ModuleOp>(moduleStr, &context);
+  ASSERT_TRUE(!!module);
+  ASSERT_TRUE(succeeded(lowerToLLVMDialect(*module)));
+  ExecutionEngineOptions options;
+  options.numCompileThreads = numCompileThreads;
+  options.enableLazyCompilation = enableLazyCompilation;
+  auto jitOrError = ExecutionEngine::create(*module, options);
+  ASSERT_TRUE(!!jitOrError);
+  std::unique_ptr<ExecutionEngine> jit = std::move(jitOrError.get());
+  int result = 0;
+  llvm::Error error =
+      jit->invoke("foo", 14, ExecutionEngine::Result<int>(result));
+  ASSERT_TRUE(!error);
+  ASSERT_EQ(result, 42);
+  error = jit->invoke("bar", 14, ExecutionEngine::Result<int>(result));
+  ASSERT_TRUE(!error);
+  ASSERT_EQ(result, 0);
+}
+
+TEST(MLIRExecutionEngine, SKIP_WITHOUT_JIT(ConcurrentCompilation)) {
+  checkConcurrentOrLazyCompilation(/*numCompileThreads=*/2,
+                                   /*enableLazyCompilation=*/false);
+}
+
+TEST(MLIRExecutionEngine, SKIP_WITHOUT_JIT(LazyCompilation)) {
+  checkConcurrentOrLazyCompilation(/*numCompileThreads=*/0,
+                                   /*enableLazyCompilation=*/true);
+  checkConcurrentOrLazyCompilation(/*numCompileThreads=*/2,
+                                   /*enableLazyCompilation=*/true);
+}
+
+TEST(MLIRExecutionEngine, SKIP_WITHOUT_JIT(ConcurrentInvocation)) {
+  std::string moduleStr = R"mlir(
+  func.func @foo(%arg0 : i32) -> i32 attributes { llvm.emit_c_interface } {
+    %res = arith.addi %arg0, %arg0 : i32
+    return %res : i32
+  }
+  )mlir";
+  DialectRegistry registry;
+  registerAllDialects(registry);
+  registerBuiltinDialectTranslation(registry);
+  registerLLVMDialectTranslation(registry);
+  MLIRContext context(registry);
+  OwningOpRef<ModuleOp> module =
+      parseSourceString<ModuleOp>(moduleStr, &context);
+  ASSERT_TRUE(!!module);
+  ASSERT_TRUE(succeeded(lowerToLLVMDialect(*module)));
+  auto runtimeLibrariesOrError = SharedRuntimeLibraries::load({});
+  ASSERT_TRUE(!!runtimeLibrariesOrError);
+  ExecutionEngineOptions options;
+  options.runtimeLibraries = std::move(*runtimeLibrariesOrError);
+  auto jitOrError = ExecutionEngine::create(*module, options);
+  ASSERT_TRUE(!!jitOrError);
+  std::unique_ptr<ExecutionEngine> jit = std::move(jitOrError.get());
+
+  // Invoke the function from multiple threads, the first lookups racing.
+  constexpr int kNumThreads = 8;
+  std::vector<int> results(kNumThreads, 0);
+  std::vector<char> invoked(kNumThreads, false);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < 100; ++j) {
+        llvm::Error error =
+            jit->invoke("foo", i, ExecutionEngine::Result<int>(results[i]));
+        invoked[i] = !error;
+        if (error) {
+          llvm::consumeError(std::move(error));
+          return;
+        }
+      }
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+  for (int i = 0; i < kNumThreads; ++i) {
+    ASSERT_TRUE(invoked[i]);
+    ASSERT_EQ(results[i], i + i);
+  }
+}
+
+TEST(MLIRExecutionEngine, SharedRuntimeLibrariesLoadError) {
+  auto runtimeLibrariesOrError =
+      SharedRuntimeLibraries::load({"/nonexistent/libruntime.so"});
+  ASSERT_FALSE(!!runtimeLibrariesOrError);
+  llvm::consumeError(runtimeLibrariesOrError.takeError());
+}
+
 TEST(MLIRExecutionEngine, SKIP_WITHOUT_JIT(SubtractFloat)) {
   std::string moduleStr = R"mlir(
   func.func @foo(%arg0 : f32, %arg1 : f32) -> f32 attributes { llvm.emit_c_interface } {
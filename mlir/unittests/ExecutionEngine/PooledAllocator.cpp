@@ -0,0 +1,90 @@
+//===- PooledAllocator.cpp --------------------------------------*- C++ -*-===//
+//
+// This file is licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/ExecutionEngine/PooledAllocator.h"
+#include "llvm/ADT/STLExtras.h"
+
+#include "gmock/gmock.h"
+
+#include <cstring>
+#include <thread>
+
+using namespace ::mlir::runtime;
+using namespace ::testing;
+
+TEST(PooledAllocator, alignment) {
+  for (uint64_t alignment : {1, 16, 64, 4096}) {
+    for (uint64_t size : {0, 1, 100, 300000, 3000000}) {
+      void *ptr = pooledAlignedAlloc(alignment, size);
+      ASSERT_NE(ptr, nullptr);
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0u);
+      std::memset(ptr, 0xab, size);
+      pooledFree(ptr);
+    }
+  }
+  EXPECT_EQ(pooledAlignedAlloc(48, 16), nullptr);
+}
+
+TEST(PooledAllocator, reuse) {
+  // A freed block is handed out again by the cache of the thread.
+  void *first = pooledAlloc(64);
+  pooledFree(first);
+  void *second = pooledAlloc(64);
+  EXPECT_EQ(first, second);
+  pooledFree(second);
+}
+
+TEST(PooledAllocator, freeOnOtherThread) {
+  std::vector<void *> ptrs;
+  for (int i = 0; i < 1000; ++i)
+    ptrs.push_back(pooledAlloc(i));
+  std::thread thread([&]() {
+    for (void *ptr : ptrs)
+      pooledFree(ptr);
+  });
+  thread.join();
+  for (int i = 0; i < 1000; ++i)
+    pooledFree(pooledAlloc(i));
+}
+
+TEST(PooledAllocator, statistics) {
+  PooledAllocatorOptions options;
+  options.collectStatistics = true;
+  configurePooledAllocator(options);
+  resetPooledAllocatorStatistics();
+
+  void *kept = nullptr;
+  for (int i = 0; i < 4; ++i) {
+    void *ptr = pooledAlloc(100);
+    if (i == 0)
+      kept = ptr;
+    else
+      pooledFree(ptr);
+  }
+
+  configurePooledAllocator(PooledAllocatorOptions());
+  std::vector<AllocationSiteStatistics> sites = getPooledAllocatorStatistics();
+  ASSERT_THAT(sites, Not(IsEmpty()));
+  auto it = llvm::find_if(sites, [](const AllocationSiteStatistics &stats) {
+    return stats.numAllocations == 4;
+  });
+  ASSERT_NE(it, sites.end());
+  EXPECT_EQ(it->numFrees, 3u);
+  EXPECT_EQ(it->allocatedBytes, 400u);
+  EXPECT_EQ(it->liveBytes, 100u);
+  EXPECT_EQ(it->peakLiveBytes, 200u);
+
+  // The free of an allocation is recorded after the collection stopped.
+  pooledFree(kept);
+  sites = getPooledAllocatorStatistics();
+  it = llvm::find_if(sites, [](const AllocationSiteStatistics &stats) {
+    return stats.numAllocations == 4;
+  });
+  ASSERT_NE(it, sites.end());
+  EXPECT_EQ(it->liveBytes, 0u);
+}
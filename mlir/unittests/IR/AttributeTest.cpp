@@ -10,6 +10,8 @@
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
+#include "mlir/IR/Operation.h"
 #include "gtest/gtest.h"
 #include <optional>
 
@@ -335,6 +337,37 @@ TEST(DenseResourceElementsAttrTest, CheckNoCast) {
   EXPECT_FALSE(isa<DenseBoolResourceElementsAttr>(i32ResourceAttr));
 }
 
+TEST(DenseResourceElementsAttrTest, ReleaseUnreferenced) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  Builder builder(&context);
+
+  // Create two resources, only one of which is referenced by an operation.
+  float data[] = {0, 1, 2, 3};
+  auto type = RankedTensorType::get(4, builder.getF32Type());
+  auto liveAttr = DenseF32ResourceElementsAttr::get(
+      type, "live", HeapAsmResourceBlob::allocateAndCopyInferAlign(
+                        llvm::ArrayRef(data)));
+  auto deadAttr = DenseF32ResourceElementsAttr::get(
+      type, "dead", HeapAsmResourceBlob::allocateAndCopyInferAlign(
+                        llvm::ArrayRef(data)));
+  OperationState state(builder.getUnknownLoc(), "foo.op");
+  state.addAttribute("value", liveAttr);
+  Operation *op = Operation::create(state);
+
+  DialectResourceBlobManager &manager =
+      DenseResourceElementsHandle::getManagerInterface(&context)
+          .getBlobManager();
+  EXPECT_EQ(manager.getTotalBlobSize(), 2 * sizeof(data));
+
+  // Check that only the data of the unreferenced resource is released.
+  EXPECT_EQ(releaseUnreferencedDenseResources(&context, op), sizeof(data));
+  EXPECT_TRUE(liveAttr.tryGetAsArrayRef().has_value());
+  EXPECT_FALSE(deadAttr.tryGetAsArrayRef().has_value());
+  EXPECT_EQ(manager.getTotalBlobSize(), sizeof(data));
+  op->destroy();
+}
+
 TEST(DenseResourceElementsAttrTest, CheckInvalidData) {
   MLIRContext context;
   Builder builder(&context);
@@ -109,6 +109,19 @@ TEST(Dialect, DelayedInterfaceRegistration) {
   EXPECT_TRUE(secondTestDialectInterface != nullptr);
 }
 
+TEST(Dialect, SortedRegisteredOperations) {
+  MLIRContext context;
+
+  // The operations registered by the builtin dialect are returned sorted by
+  // name.
+  ArrayRef<RegisteredOperationName> ops = context.getRegisteredOperations();
+  ASSERT_GE(ops.size(), 2u);
+  EXPECT_TRUE(llvm::is_sorted(
+      ops, [](RegisteredOperationName lhs, RegisteredOperationName rhs) {
+        return lhs.getStringRef() < rhs.getStringRef();
+      }));
+}
+
 TEST(Dialect, RepeatedDelayedRegistration) {
   // Set up the delayed registration.
   DialectRegistry registry;
@@ -0,0 +1,92 @@
+//===- DominanceTest.cpp - Dominance unit tests ---------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/Dominance.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/IR/Operation.h"
+#include "mlir/IR/OwningOpRef.h"
+#include "mlir/Parser/Parser.h"
+#include "gtest/gtest.h"
+
+using namespace mlir;
+
+namespace {
+/// A diamond CFG: ^bb0 branches to ^bb1 and ^bb2, which both branch to ^bb3.
+constexpr StringLiteral kDiamondCFG = R"mlir(
+  "foo.region"() ({
+  ^bb0:
+    "foo.br"()[^bb1, ^bb2] : () -> ()
+  ^bb1:
+    "foo.br"()[^bb3] : () -> ()
+  ^bb2:
+    "foo.br"()[^bb3] : () -> ()
+  ^bb3:
+    "foo.return"() : () -> ()
+  }) : () -> ()
+)mlir";
+
+/// Replaces the terminator of `block` with a branch to `successors`.
+static void setSuccessors(Block *block, ArrayRef<Block *> successors) {
+  Operation *terminator = &block->back();
+  OperationState state(terminator->getLoc(), "foo.br");
+  state.addSuccessors(successors);
+  terminator->erase();
+  block->push_back(Operation::create(state));
+}
+
+/// Returns true if the dominance relations of `domInfo` on the blocks of
+/// `region` match those of a freshly computed dominance info.
+static bool matchesRecomputedDominance(DominanceInfo &domInfo,
+                                       Region &region) {
+  DominanceInfo recomputed;
+  for (Block &a : region)
+    for (Block &b : region)
+      if (domInfo.properlyDominates(&a, &b) !=
+          recomputed.properlyDominates(&a, &b))
+        return false;
+  return true;
+}
+
+TEST(DominanceTest, IncrementalEdgeUpdates) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  ParserConfig config(&context);
+  OwningOpRef<Operation *> op = parseSourceString(kDiamondCFG, config);
+  ASSERT_TRUE(op);
+  Region &region = op->getRegion(0);
+  Block *bb0 = &region.front();
+  Block *bb1 = bb0->getNextNode();
+  Block *bb2 = bb1->getNextNode();
+  Block *bb3 = bb2->getNextNode();
+
+  DominanceInfo domInfo;
+  EXPECT_FALSE(domInfo.properlyDominates(bb1, bb3));
+
+  // Remove the edge from ^bb0 to ^bb2, which becomes unreachable.
+  setSuccessors(bb0, {bb1});
+  domInfo.deleteEdge(bb0, bb2);
+  EXPECT_TRUE(domInfo.properlyDominates(bb1, bb3));
+  EXPECT_FALSE(domInfo.isReachableFromEntry(bb2));
+  EXPECT_TRUE(matchesRecomputedDominance(domInfo, region));
+
+  // Make ^bb2 reachable through ^bb1.
+  setSuccessors(bb1, {bb2, bb3});
+  domInfo.insertEdge(bb1, bb2);
+  EXPECT_TRUE(domInfo.properlyDominates(bb1, bb2));
+  EXPECT_TRUE(domInfo.isReachableFromEntry(bb2));
+  EXPECT_TRUE(matchesRecomputedDominance(domInfo, region));
+
+  // Restore the diamond in a single batch.
+  setSuccessors(bb0, {bb1, bb2});
+  setSuccessors(bb1, {bb3});
+  domInfo.applyUpdates(&region, {{llvm::cfg::UpdateKind::Insert, bb0, bb2},
+                                 {llvm::cfg::UpdateKind::Delete, bb1, bb2}});
+  EXPECT_FALSE(domInfo.properlyDominates(bb1, bb3));
+  EXPECT_TRUE(matchesRecomputedDominance(domInfo, region));
+}
+} // namespace
@@ -0,0 +1,58 @@
+//===- LocationTest.cpp - Location unit tests -----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Location.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/Support/StorageUniquer.h"
+#include "gtest/gtest.h"
+
+using namespace mlir;
+
+namespace {
+TEST(LocationTest, FusedLocPolicy) {
+  MLIRContext context;
+  Builder builder(&context);
+  Location a = FileLineColLoc::get(&context, "a.mlir", 1, 1);
+  Location b = FileLineColLoc::get(&context, "b.mlir", 2, 2);
+  Location c = FileLineColLoc::get(&context, "c.mlir", 3, 3);
+  Location callSite = CallSiteLoc::get(c, a);
+  Location tagged = builder.getFusedLoc({a, b}, builder.getStringAttr("tag"));
+
+  // By default, the fused locations with a different metadata are kept.
+  auto fusedLoc = dyn_cast<FusedLoc>(builder.getFusedLoc({tagged, callSite}));
+  ASSERT_TRUE(fusedLoc);
+  EXPECT_EQ(fusedLoc.getLocations(), ArrayRef<Location>({tagged, callSite}));
+
+  // Flattening drops the nested metadata.
+  context.setFusedLocPolicy(MLIRContext::FusedLocPolicy::Flatten);
+  fusedLoc = dyn_cast<FusedLoc>(builder.getFusedLoc({tagged, callSite}));
+  ASSERT_TRUE(fusedLoc);
+  EXPECT_EQ(fusedLoc.getLocations(), ArrayRef<Location>({a, b, callSite}));
+
+  // The call sites are reduced to their caller, which is deduplicated.
+  context.setFusedLocPolicy(MLIRContext::FusedLocPolicy::DropToCallSite);
+  fusedLoc = dyn_cast<FusedLoc>(builder.getFusedLoc({tagged, callSite}));
+  ASSERT_TRUE(fusedLoc);
+  EXPECT_EQ(fusedLoc.getLocations(), ArrayRef<Location>({a, b}));
+
+  // The first locations are kept when there are too many of them.
+  context.setFusedLocPolicy(MLIRContext::FusedLocPolicy::Default);
+  context.setMaxFusedLocations(2);
+  fusedLoc = dyn_cast<FusedLoc>(builder.getFusedLoc({a, b, c}));
+  ASSERT_TRUE(fusedLoc);
+  EXPECT_EQ(fusedLoc.getLocations(), ArrayRef<Location>({a, b}));
+  context.setMaxFusedLocations(1);
+  EXPECT_EQ(builder.getFusedLoc({a, b, c}), a);
+
+  // The storage of the fused locations is accounted for separately.
+  EXPECT_GT(context.getAttributeUniquer().getBytesAllocated(
+                TypeID::get<FusedLoc>()),
+            0u);
+}
+} // namespace
@@ -10,6 +10,8 @@
 #include "../../test/lib/Dialect/Test/TestDialect.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/OperationArena.h"
+#include "mlir/IR/OwningOpRef.h"
 #include "llvm/ADT/BitVector.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "gtest/gtest.h"
@@ -217,6 +219,132 @@ TEST(OperationOrderTest, OrderIsAlwaysValid) {
   containerOp->destroy();
 }
 
+TEST(OperationOrderTest, RepeatedInsertionsAtTheSamePoint) {
+  MLIRContext context;
+
+  Operation *containerOp = createOp(&context, /*operands=*/std::nullopt,
+                                    /*resultTypes=*/std::nullopt,
+                                    /*numRegions=*/1);
+  Block *block = new Block();
+  containerOp->getRegion(0).push_back(block);
+  for (int i = 0; i < 64; ++i)
+    block->push_back(createOp(&context));
+  Operation *pivotOp = &*std::next(block->begin(), 32);
+
+  // Alternate insertions right before the pivot, which exhaust the gaps
+  // between the indices of the operations around it, and at the front of the
+  // block, with queries in between.
+  int kNumOpsToInsert = 10000;
+  Operation *lastInsertedOp = nullptr;
+  for (int i = 0; i < kNumOpsToInsert; ++i) {
+    Operation *op = createOp(&context);
+    if (i % 2 == 0) {
+      block->getOperations().insert(pivotOp->getIterator(), op);
+      ASSERT_TRUE(op->isBeforeInBlock(pivotOp));
+      if (lastInsertedOp)
+        ASSERT_TRUE(lastInsertedOp->isBeforeInBlock(op));
+      lastInsertedOp = op;
+    } else {
+      block->push_front(op);
+      ASSERT_TRUE(op->isBeforeInBlock(lastInsertedOp));
+    }
+  }
+
+  // The order of all the operations matches their positions.
+  // Note verifyOpOrder() returns false if the order is valid.
+  ASSERT_FALSE(block->verifyOpOrder());
+  for (Operation *op = &block->front(); op != &block->back();
+       op = op->getNextNode())
+    ASSERT_TRUE(op->isBeforeInBlock(op->getNextNode()));
+
+  containerOp->destroy();
+}
+
+TEST(UseListTest, ReplaceAllUsesWith) {
+  MLIRContext context;
+  Builder builder(&context);
+
+  Type type = builder.getIntegerType(16);
+  Operation *fromOp = createOp(&context, /*operands=*/std::nullopt, type);
+  Operation *toOp = createOp(&context, /*operands=*/std::nullopt, type);
+  Value from = fromOp->getResult(0), to = toOp->getResult(0);
+  Operation *users[] = {createOp(&context, from), createOp(&context, to),
+                        createOp(&context, {from, from})};
+  EXPECT_TRUE(from.hasNUses(3));
+  EXPECT_FALSE(from.hasNUses(2));
+  EXPECT_TRUE(from.hasNUsesOrMore(2));
+  EXPECT_FALSE(to.hasNUsesOrMore(2));
+
+  // The uses are moved to the front of the use-list of `to`, in the reverse
+  // order, as when they are updated one by one.
+  SmallVector<OpOperand *> expectedUses;
+  for (OpOperand &use : from.getUses())
+    expectedUses.insert(expectedUses.begin(), &use);
+  for (OpOperand &use : to.getUses())
+    expectedUses.push_back(&use);
+  from.replaceAllUsesWith(to);
+  EXPECT_TRUE(from.use_empty());
+  EXPECT_TRUE(to.hasNUses(4));
+  SmallVector<OpOperand *> uses;
+  for (OpOperand &use : to.getUses()) {
+    EXPECT_EQ(use.get(), to);
+    uses.push_back(&use);
+  }
+  EXPECT_EQ(uses, expectedUses);
+
+  // Erasing the users must leave a valid use-list.
+  users[0]->destroy();
+  EXPECT_TRUE(to.hasNUses(3));
+  for (Operation *user : llvm::drop_begin(users))
+    user->destroy();
+  EXPECT_TRUE(to.use_empty());
+  fromOp->destroy();
+  toOp->destroy();
+}
+
+TEST(OpNameIndexTest, TracksInsertionsAndRemovals) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  auto createNamedOp = [&](StringRef name) {
+    return Operation::create(UnknownLoc::get(&context),
+                             OperationName(name, &context), std::nullopt,
+                             std::nullopt, std::nullopt, nullptr, std::nullopt,
+                             0);
+  };
+
+  Block block, otherBlock;
+  Operation *a0 = createNamedOp("foo.a");
+  Operation *b0 = createNamedOp("foo.b");
+  Operation *a1 = createNamedOp("foo.a");
+  block.push_back(a0);
+  block.push_back(b0);
+  block.push_back(a1);
+  EXPECT_EQ(block.getOpsWithName("foo.a"), ArrayRef<Operation *>({a0, a1}));
+  EXPECT_EQ(block.getOpsWithName("foo.b"), ArrayRef<Operation *>({b0}));
+  EXPECT_TRUE(block.getOpsWithName("foo.c").empty());
+
+  // Insertions before the indexed operations keep the block order.
+  Operation *a2 = createNamedOp("foo.a");
+  block.push_front(a2);
+  EXPECT_EQ(block.getOpsWithName("foo.a"),
+            ArrayRef<Operation *>({a2, a0, a1}));
+
+  // Moves within the block reorder the index.
+  a2->moveAfter(a1);
+  EXPECT_EQ(block.getOpsWithName("foo.a"),
+            ArrayRef<Operation *>({a0, a1, a2}));
+
+  // Removals and moves to another block update the index.
+  a0->erase();
+  otherBlock.getOperations().splice(otherBlock.end(), block.getOperations(),
+                                    Block::iterator(b0), block.end());
+  EXPECT_TRUE(block.getOpsWithName("foo.a").empty());
+  EXPECT_TRUE(block.getOpsWithName("foo.b").empty());
+  EXPECT_EQ(otherBlock.getOpsWithName("foo.a"),
+            ArrayRef<Operation *>({a1, a2}));
+  EXPECT_EQ(otherBlock.getOpsWithName("foo.b"), ArrayRef<Operation *>({b0}));
+}
+
 TEST(OperationFormatPrintTest, CanUseVariadicFormat) {
   MLIRContext context;
   Builder builder(&context);
@@ -312,4 +440,40 @@ TEST(OperationEquivalenceTest, HashWorksWithFlags) {
   op2->destroy();
 }
 
+TEST(OperationArenaTest, DestroyAndReset) {
+  MLIRContext context;
+  Builder builder(&context);
+  auto arena = std::make_unique<OperationArena>();
+
+  // Create a root operation with a use chain nested within it.
+  Operation *root, *producer, *consumer;
+  {
+    OperationArena::Scope scope(*arena);
+    root = createOp(&context, /*operands=*/std::nullopt,
+                    /*resultTypes=*/std::nullopt, /*numRegions=*/1);
+    Block *block = new Block();
+    root->getRegion(0).push_back(block);
+    Value arg = block->addArgument(builder.getI32Type(), root->getLoc());
+    producer = createOp(&context, arg, builder.getI32Type());
+    consumer = createOp(&context, {producer->getResult(0), arg});
+    block->push_back(producer);
+    block->push_back(consumer);
+
+    // Operations may still be erased eagerly.
+    Operation *erased = createOp(&context, arg);
+    block->push_back(erased);
+    erased->erase();
+  }
+  EXPECT_GT(arena->getBytesAllocated(), 0u);
+
+  // Operations created outside of the scope aren't allocated in the arena, but
+  // can still be nested within operations that are.
+  Operation *outsideOp = createOp(&context, producer->getResult(0));
+  consumer->getBlock()->push_back(outsideOp);
+  EXPECT_EQ(outsideOp->getOperand(0), producer->getResult(0));
+
+  // Destroy the whole tree along with the arena.
+  OwningOpRef<Operation *> rootRef(root, std::move(arena));
+}
+
 } // namespace
@@ -0,0 +1,79 @@
+//===- ThreadingTest.cpp - Threading utilities unit tests -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/Threading.h"
+#include "mlir/IR/MLIRContext.h"
+#include "gtest/gtest.h"
+
+using namespace mlir;
+using namespace mlir::detail;
+
+namespace {
+TEST(ThreadingTest, NestedParallelLoops) {
+  llvm::ThreadPool threadPool(llvm::hardware_concurrency(4));
+  MLIRContext context(MLIRContext::Threading::DISABLED);
+  context.setThreadPool(threadPool);
+
+  // The nested loops run on the same pool as the outer one.
+  std::atomic<unsigned> sum(0);
+  parallelFor(&context, 0, 16, [&](size_t i) {
+    parallelFor(&context, 0, 16, [&](size_t j) { sum += i * 16 + j; });
+  });
+  EXPECT_EQ(sum.load(), 256u * 255u / 2);
+}
+
+TEST(ThreadingTest, SharedThreadPool) {
+  MLIRContext first(MLIRContext::Threading::DISABLED);
+  MLIRContext second(MLIRContext::Threading::DISABLED);
+  first.setThreadPool(MLIRContext::getSharedThreadPool());
+  second.setThreadPool(MLIRContext::getSharedThreadPool());
+  EXPECT_EQ(&first.getThreadPool(), &second.getThreadPool());
+
+  std::atomic<unsigned> count(0);
+  parallelFor(&first, 0, 8, [&](size_t) {
+    parallelFor(&second, 0, 8, [&](size_t) { ++count; });
+  });
+  EXPECT_EQ(count.load(), 64u);
+}
+
+TEST(ThreadingTest, PriorityLevels) {
+  unsigned defaultLevel = ParallelTaskQueue::getCurrentLevel();
+  {
+    ParallelPriorityScope critical(ParallelPriority::Critical);
+    EXPECT_GT(ParallelTaskQueue::getCurrentLevel(), defaultLevel);
+    {
+      // The loops nested in a task have a higher level than the task.
+      unsigned criticalLevel = ParallelTaskQueue::getCurrentLevel();
+      ParallelTaskQueue::TaskScope task(criticalLevel);
+      EXPECT_GT(ParallelTaskQueue::getCurrentLevel(), criticalLevel);
+    }
+  }
+  EXPECT_EQ(ParallelTaskQueue::getCurrentLevel(), defaultLevel);
+
+  unsigned backgroundLevel;
+  {
+    ParallelPriorityScope background(ParallelPriority::Background);
+    backgroundLevel = ParallelTaskQueue::getCurrentLevel();
+    // Even nested deeply, background loops stay below the default ones.
+    ParallelTaskQueue::TaskScope task1(backgroundLevel);
+    ParallelTaskQueue::TaskScope task2(ParallelTaskQueue::getCurrentLevel());
+    ParallelTaskQueue::TaskScope task3(ParallelTaskQueue::getCurrentLevel());
+    ParallelTaskQueue::TaskScope task4(ParallelTaskQueue::getCurrentLevel());
+    EXPECT_LT(ParallelTaskQueue::getCurrentLevel(), defaultLevel);
+  }
+
+  // Tasks only yield to the tasks of higher levels.
+  llvm::ThreadPool threadPool(llvm::hardware_concurrency(1));
+  ParallelTaskQueue &queue = ParallelTaskQueue::get(threadPool);
+  queue.notifyQueued(defaultLevel);
+  EXPECT_TRUE(queue.shouldYield(backgroundLevel));
+  EXPECT_FALSE(queue.shouldYield(defaultLevel));
+  queue.notifyStarted(defaultLevel);
+  EXPECT_FALSE(queue.shouldYield(backgroundLevel));
+}
+} // namespace
@@ -0,0 +1,60 @@
+//===- VerifierTest.cpp - Verifier unit tests -----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/Verifier.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/ModifiedOpsListener.h"
+#include "gtest/gtest.h"
+
+using namespace mlir;
+
+namespace {
+TEST(VerifierTest, VerifyIncrementally) {
+  MLIRContext context;
+  OpBuilder builder(&context);
+  Location loc = builder.getUnknownLoc();
+
+  // Create a module holding two nested modules, each holding an operation of
+  // an unregistered dialect. These are invalid as the context doesn't allow
+  // unregistered dialects.
+  OwningOpRef<ModuleOp> module(ModuleOp::create(loc));
+  SmallVector<Operation *> invalidOps;
+  for (unsigned i = 0; i < 2; ++i) {
+    builder.setInsertionPointToEnd(module->getBody());
+    auto nested = builder.create<ModuleOp>(loc);
+    builder.setInsertionPointToEnd(nested.getBody());
+    invalidOps.push_back(builder.create(OperationState(loc, "foo.bar")));
+  }
+
+  // Record the modifications done through a rewriter.
+  ModifiedOpsListener listener;
+  IRRewriter rewriter(&context, &listener);
+  rewriter.updateRootInPlace(invalidOps[0], [&] {
+    invalidOps[0]->setAttr("modified", rewriter.getUnitAttr());
+  });
+  SmallVector<Operation *> modifiedOps = listener.getModifiedOps();
+  ASSERT_EQ(modifiedOps.size(), 1u);
+  EXPECT_EQ(modifiedOps.front(), invalidOps[0]);
+
+  ScopedDiagnosticHandler handler(&context, [](Diagnostic &) {});
+  EXPECT_TRUE(failed(verify(*module)));
+  EXPECT_TRUE(failed(verifyIncrementally(*module, modifiedOps)));
+
+  // Erasing the modified operation records its parent instead, which is now
+  // valid. The other invalid operation is not verified again.
+  Operation *parentOp = invalidOps[0]->getParentOp();
+  rewriter.eraseOp(invalidOps[0]);
+  modifiedOps = listener.getModifiedOps();
+  ASSERT_EQ(modifiedOps.size(), 1u);
+  EXPECT_EQ(modifiedOps.front(), parentOp);
+  EXPECT_TRUE(succeeded(verifyIncrementally(*module, modifiedOps)));
+  EXPECT_TRUE(failed(verify(*module)));
+}
+} // namespace
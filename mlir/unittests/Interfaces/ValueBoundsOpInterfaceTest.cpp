@@ -0,0 +1,89 @@
+//===- ValueBoundsOpInterfaceTest.cpp - Unit Tests for Value Bounds -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Interfaces/ValueBoundsOpInterface.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Arith/IR/ValueBoundsOpInterfaceImpl.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Parser/Parser.h"
+
+#include <gtest/gtest.h>
+
+using namespace mlir;
+
+class ValueBoundsCacheTest : public testing::Test {
+protected:
+  void SetUp() override {
+    const char *ir = R"MLIR(
+      func.func @bounds(%a: index, %b: index) {
+        %c4 = arith.constant 4 : index
+        %c5 = arith.constant 5 : index
+        %0 = arith.addi %a, %c4 : index
+        %1 = arith.subi %0, %a : index
+        %2 = arith.addi %b, %b : index
+        return
+      }
+    )MLIR";
+
+    registry.insert<func::FuncDialect, arith::ArithDialect>();
+    arith::registerValueBoundsOpInterfaceExternalModels(registry);
+    ctx.appendDialectRegistry(registry);
+    module = parseSourceString<ModuleOp>(ir, &ctx);
+    ASSERT_TRUE(module);
+    auto func = cast<func::FuncOp>(module->front());
+    for (Operation &op : func.getBody().front())
+      ops.push_back(&op);
+  }
+
+  DialectRegistry registry;
+  MLIRContext ctx;
+  OwningOpRef<ModuleOp> module;
+  SmallVector<Operation *> ops;
+};
+
+TEST_F(ValueBoundsCacheTest, InvalidatesModifiedSlice) {
+  Operation *c5 = ops[1], *add = ops[2], *sub = ops[3], *unrelated = ops[4];
+  ValueBoundsCache cache;
+  auto computeSize = [&]() {
+    return cache.computeConstantBound(presburger::BoundType::EQ,
+                                      sub->getResult(0));
+  };
+
+  FailureOr<int64_t> size = computeSize();
+  ASSERT_TRUE(succeeded(size));
+  EXPECT_EQ(*size, 4);
+  EXPECT_EQ(cache.getNumMisses(), 1u);
+
+  // A modification outside of the backward slice keeps the cached bound.
+  cache.notifyOperationModified(unrelated);
+  size = computeSize();
+  ASSERT_TRUE(succeeded(size));
+  EXPECT_EQ(*size, 4);
+  EXPECT_EQ(cache.getNumHits(), 1u);
+
+  // A modification of the backward slice recomputes it.
+  add->setOperand(1, c5->getResult(0));
+  cache.notifyOperationModified(add);
+  size = computeSize();
+  ASSERT_TRUE(succeeded(size));
+  EXPECT_EQ(*size, 5);
+  EXPECT_EQ(cache.getNumMisses(), 2u);
+
+  // An equality query is cached separately.
+  FailureOr<bool> equal =
+      cache.areEqual(sub->getResult(0), c5->getResult(0));
+  ASSERT_TRUE(succeeded(equal));
+  EXPECT_TRUE(*equal);
+  EXPECT_EQ(cache.getNumMisses(), 3u);
+
+  cache.clear();
+  size = computeSize();
+  ASSERT_TRUE(succeeded(size));
+  EXPECT_EQ(cache.getNumMisses(), 4u);
+}
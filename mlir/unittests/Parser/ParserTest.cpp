@@ -8,6 +8,8 @@
 
 #include "mlir/Parser/Parser.h"
 #include "mlir/AsmParser/AsmParser.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Verifier.h"
 
@@ -101,4 +103,144 @@ TEST(MLIRParser, ParseAttr) {
     EXPECT_EQ(attr, b.getI64IntegerAttr(9));
   }
 }
+
+TEST(MLIRParser, ParseLargeDenseElements) {
+  MLIRContext context;
+  constexpr int64_t numElements = 1 << 16;
+
+  // Build a literal of alternating positive and negative elements.
+  std::string intAsm = "dense<[", floatAsm = "dense<[";
+  for (int64_t i = 0; i < numElements; ++i) {
+    if (i != 0) {
+      intAsm += ", ";
+      floatAsm += ", ";
+    }
+    int64_t value = i % 2 ? -i : i;
+    intAsm += std::to_string(value);
+    floatAsm += std::to_string(value) + ".5";
+  }
+  std::string shape = "tensor<" + std::to_string(numElements);
+  intAsm += "]> : " + shape + "xi32>";
+  floatAsm += "]> : " + shape + "xf32>";
+
+  auto intAttr =
+      dyn_cast_or_null<DenseIntElementsAttr>(parseAttribute(intAsm, &context));
+  ASSERT_TRUE(intAttr);
+  auto floatAttr = dyn_cast_or_null<DenseFPElementsAttr>(
+      parseAttribute(floatAsm, &context));
+  ASSERT_TRUE(floatAttr);
+  int64_t index = 0;
+  for (auto [intValue, floatValue] : llvm::zip(intAttr.getValues<int32_t>(),
+                                               floatAttr.getValues<float>())) {
+    int64_t value = index % 2 ? -index : index;
+    EXPECT_EQ(intValue, value);
+    EXPECT_EQ(floatValue, value + (value < 0 ? -0.5f : 0.5f));
+    ++index;
+  }
+  EXPECT_EQ(index, numElements);
+}
+
+TEST(MLIRParser, ParseFunctionsInParallel) {
+  std::string moduleStr = R"mlir(
+    module {
+      func.func private @external(i32) -> i32
+      func.func @first(%arg0: i32) -> i32 {
+        %0 = func.call @external(%arg0) : (i32) -> i32 loc(#loc)
+        "test.br"(%0)[^bb1] : (i32) -> ()
+      ^bb1(%1: i32):
+        return %1 : i32
+      }
+      func.func @second(%arg0: i32) -> i32 {
+        %0 = "test.nested"() ({
+          %1 = "test.inner"(%arg0) : (i32) -> i32
+          "test.yield"(%1) : (i32) -> ()
+        }) : () -> i32
+        return %0 : i32
+      }
+    }
+    #loc = loc("callsite")
+  )mlir";
+
+  DialectRegistry registry;
+  registry.insert<func::FuncDialect>();
+  MLIRContext context(registry);
+  context.allowUnregisteredDialects();
+  OwningOpRef<ModuleOp> module =
+      parseSourceString<ModuleOp>(moduleStr, &context);
+  ASSERT_TRUE(module);
+
+  // The bodies of the functions parsed in parallel are identical to the ones
+  // parsed sequentially, including their locations.
+  ParserConfig parallelConfig(&context);
+  parallelConfig.setParseInParallel();
+  OwningOpRef<ModuleOp> parallelModule =
+      parseSourceString<ModuleOp>(moduleStr, parallelConfig);
+  ASSERT_TRUE(parallelModule);
+
+  std::string expected, actual;
+  llvm::raw_string_ostream expectedStream(expected), actualStream(actual);
+  OpPrintingFlags flags;
+  flags.enableDebugInfo();
+  module->print(expectedStream, flags);
+  parallelModule->print(actualStream, flags);
+  EXPECT_EQ(expectedStream.str(), actualStream.str());
+}
+
+TEST(MLIRParser, ParseFunctionsInParallelError) {
+  using namespace testing;
+  std::string moduleStr = R"mlir(
+    func.func @valid() {
+      return
+    }
+    func.func @invalid() {
+      "test.use"(%undefined) : (i32) -> ()
+      return
+    }
+  )mlir";
+
+  DialectRegistry registry;
+  registry.insert<func::FuncDialect>();
+  MLIRContext context(registry);
+  context.allowUnregisteredDialects();
+  std::vector<std::string> diagnostics;
+  ScopedDiagnosticHandler handler(&context, [&](Diagnostic &d) {
+    llvm::raw_string_ostream(diagnostics.emplace_back()) << d;
+  });
+
+  ParserConfig parallelConfig(&context);
+  parallelConfig.setParseInParallel();
+  EXPECT_FALSE(parseSourceString<ModuleOp>(moduleStr, parallelConfig));
+  EXPECT_THAT(diagnostics, ElementsAre("use of undeclared SSA value name"));
+}
+
+TEST(MLIRParser, RoundTripHexElements) {
+  MLIRContext context;
+  Builder builder(&context);
+  SmallVector<float> values;
+  for (int i = 0; i < 1024; ++i)
+    values.push_back(i * 0.5f);
+  auto attr = DenseElementsAttr::get(
+      RankedTensorType::get({1024}, builder.getF32Type()), ArrayRef(values));
+
+  OwningOpRef<ModuleOp> module = ModuleOp::create(builder.getUnknownLoc());
+  (*module)->setAttr("test.attr", attr);
+  std::string text;
+  llvm::raw_string_ostream os(text);
+  OpPrintingFlags flags;
+  flags.printElementsAttrWithHexIfLarger(16);
+  module->print(os, flags);
+  EXPECT_NE(os.str().find("dense<\"0x"), std::string::npos);
+
+  OwningOpRef<ModuleOp> parsed =
+      parseSourceString<ModuleOp>(os.str(), &context);
+  ASSERT_TRUE(parsed);
+  EXPECT_EQ((*parsed)->getAttr("test.attr"), attr);
+
+  // The hex form can be disabled.
+  flags.printElementsAttrWithHexIfLarger(-1);
+  std::string listText;
+  llvm::raw_string_ostream listOS(listText);
+  (*parsed)->print(listOS, flags);
+  EXPECT_EQ(listOS.str().find("0x"), std::string::npos);
+}
 } // namespace
@@ -13,6 +13,7 @@
 #include "mlir/Pass/Pass.h"
 #include "gtest/gtest.h"
 
+#include <atomic>
 #include <memory>
 
 using namespace mlir;
@@ -84,6 +85,60 @@ TEST(PassManagerTest, OpSpecificAnalysis) {
   }
 }
 
+namespace {
+/// Simple pass that counts the number of times it has been run.
+struct CountingPass
+    : public PassWrapper<CountingPass, OperationPass<func::FuncOp>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(CountingPass)
+
+  CountingPass(std::atomic<unsigned> &numRuns) : numRuns(numRuns) {}
+
+  void runOnOperation() override {
+    ++numRuns;
+    getOperation()->setAttr("counted", UnitAttr::get(&getContext()));
+  }
+
+  std::atomic<unsigned> &numRuns;
+};
+} // namespace
+
+TEST(PassManagerTest, PipelineCache) {
+  MLIRContext context;
+  context.loadDialect<func::FuncDialect>();
+  Builder builder(&context);
+
+  // Create a module with a single function.
+  auto createModule = [&] {
+    OwningOpRef<ModuleOp> module(ModuleOp::create(UnknownLoc::get(&context)));
+    auto func = func::FuncOp::create(
+        builder.getUnknownLoc(), "foo",
+        builder.getFunctionType(std::nullopt, std::nullopt));
+    func.setPrivate();
+    module->push_back(func);
+    return module;
+  };
+
+  std::atomic<unsigned> numRuns(0);
+  auto pm = PassManager::on<ModuleOp>(&context);
+  pm.addNestedPass<func::FuncOp>(std::make_unique<CountingPass>(numRuns));
+  pm.enablePipelineCache(createInMemoryPassPipelineCache());
+
+  // The first run populates the cache, and the second one reuses its result.
+  for (unsigned i = 0; i < 2; ++i) {
+    OwningOpRef<ModuleOp> module = createModule();
+    ASSERT_TRUE(succeeded(pm.run(module.get())));
+    EXPECT_EQ(numRuns.load(), 1u);
+    for (func::FuncOp func : module->getOps<func::FuncOp>())
+      EXPECT_TRUE(func->hasAttr("counted"));
+  }
+
+  // A different operation misses the cache.
+  OwningOpRef<ModuleOp> module = createModule();
+  (*module->getOps<func::FuncOp>().begin()).setSymName("bar");
+  ASSERT_TRUE(succeeded(pm.run(module.get())));
+  EXPECT_EQ(numRuns.load(), 2u);
+}
+
 namespace {
 struct InvalidPass : Pass {
   MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(InvalidPass)
@@ -77,4 +77,84 @@ TEST(PatternBenefitTest, BenefitOrder) {
   EXPECT_TRUE(called1);
   EXPECT_TRUE(called2);
 }
+
+TEST(PatternBenefitTest, DefaultCostModelOrder) {
+  // The candidate patterns resolved when freezing the pattern list must be
+  // attempted in the same order as with an explicit static benefit cost model.
+  MLIRContext context;
+
+  OpBuilder builder(&context);
+  OwningOpRef<ModuleOp> module = ModuleOp::create(builder.getUnknownLoc());
+
+  struct OpPattern : public OpRewritePattern<ModuleOp> {
+    OpPattern(MLIRContext *context, PatternBenefit benefit, int id,
+              SmallVectorImpl<int> &order)
+        : OpRewritePattern<ModuleOp>(context, benefit), id(id), order(order) {}
+
+    LogicalResult
+    matchAndRewrite(ModuleOp /*op*/,
+                    PatternRewriter & /*rewriter*/) const override {
+      order.push_back(id);
+      return failure();
+    }
+
+    int id;
+    SmallVectorImpl<int> &order;
+  };
+
+  struct AnyOpPattern : public RewritePattern {
+    AnyOpPattern(MLIRContext *context, PatternBenefit benefit, int id,
+                 SmallVectorImpl<int> &order)
+        : RewritePattern(MatchAnyOpTypeTag(), benefit, context), id(id),
+          order(order) {}
+
+    LogicalResult
+    matchAndRewrite(Operation * /*op*/,
+                    PatternRewriter & /*rewriter*/) const override {
+      order.push_back(id);
+      return failure();
+    }
+
+    int id;
+    SmallVectorImpl<int> &order;
+  };
+
+  SmallVector<int> order;
+  RewritePatternSet patterns(&context);
+  patterns.add<OpPattern>(&context, 1, 0, order);
+  patterns.add<AnyOpPattern>(&context, 2, 1, order);
+  patterns.add<OpPattern>(&context, 2, 2, order);
+  patterns.add<AnyOpPattern>(&context, 1, 3, order);
+  patterns.add<OpPattern>(&context, PatternBenefit::impossibleToMatch(), 4,
+                          order);
+  patterns.add<AnyOpPattern>(&context, 3, 5, order);
+  FrozenRewritePatternSet frozenPatterns(std::move(patterns));
+
+  class MyPatternRewriter : public PatternRewriter {
+  public:
+    MyPatternRewriter(MLIRContext *ctx) : PatternRewriter(ctx) {}
+  };
+  MyPatternRewriter rewriter(&context);
+
+  PatternApplicator pa(frozenPatterns);
+  pa.applyCostModel(
+      [](const Pattern &pattern) { return pattern.getBenefit(); });
+  (void)pa.matchAndRewrite(*module, rewriter);
+  SmallVector<int> expectedOrder = {5, 2, 1, 0, 3};
+  EXPECT_EQ(order, expectedOrder);
+
+  order.clear();
+  pa.applyDefaultCostModel();
+  (void)pa.matchAndRewrite(*module, rewriter);
+  EXPECT_EQ(order, expectedOrder);
+
+  // Operations without op specific patterns only get the "match any" ones.
+  Operation *unrelated = builder.create<UnrealizedConversionCastOp>(
+      builder.getUnknownLoc(), TypeRange(), ValueRange());
+  order.clear();
+  (void)pa.matchAndRewrite(unrelated, rewriter);
+  expectedOrder = {5, 1, 3};
+  EXPECT_EQ(order, expectedOrder);
+  unrelated->erase();
+}
 } // namespace
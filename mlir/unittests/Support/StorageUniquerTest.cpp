@@ -7,7 +7,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "mlir/Support/StorageUniquer.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gmock/gmock.h"
+#include <chrono>
 
 using namespace mlir;
 
@@ -58,3 +62,82 @@ TEST(StorageUniquerTest, NonTrivialDestructor) {
 
   EXPECT_TRUE(wasDestructed);
 }
+
+namespace {
+struct IntStorage : public SimpleStorage<IntStorage, int> {
+  using Base::Base;
+};
+} // namespace
+
+TEST(StorageUniquerTest, BytesAllocated) {
+  StorageUniquer uniquer;
+  uniquer.registerParametricStorageType<IntStorage>();
+  EXPECT_EQ(uniquer.getBytesAllocated(), 0u);
+
+  // Verify that only the new instances are accounted for.
+  IntStorage::get(uniquer, 1);
+  size_t numBytes = uniquer.getBytesAllocated();
+  EXPECT_GE(numBytes, sizeof(IntStorage));
+  IntStorage::get(uniquer, 1);
+  EXPECT_EQ(uniquer.getBytesAllocated(), numBytes);
+  IntStorage::get(uniquer, 2);
+  EXPECT_GE(uniquer.getBytesAllocated(), numBytes + sizeof(IntStorage));
+}
+
+/// Get or create `numKeys` instances from each of `numTasks` tasks run on
+/// `threadPool`. Each task walks the keys in a different order, so that tasks
+/// race on both the creation and the lookup of instances. The instances
+/// observed by each task are stored in `results`, indexed by key.
+static void
+getOrCreateConcurrently(StorageUniquer &uniquer, llvm::ThreadPool &threadPool,
+                        unsigned numTasks, int numKeys,
+                        std::vector<std::vector<IntStorage *>> &results) {
+  results.assign(numTasks, std::vector<IntStorage *>(numKeys));
+  for (unsigned task = 0; task != numTasks; ++task) {
+    threadPool.async([&, task] {
+      for (int i = 0; i != numKeys; ++i) {
+        int key = (i + task * 7919) % numKeys;
+        results[task][key] = IntStorage::get(uniquer, key);
+      }
+    });
+  }
+  threadPool.wait();
+}
+
+TEST(StorageUniquerTest, ConcurrentGetOrCreate) {
+  StorageUniquer uniquer;
+  uniquer.registerParametricStorageType<IntStorage>();
+
+  // Verify that every task observed the same unique instance for each key.
+  llvm::ThreadPool threadPool(llvm::hardware_concurrency(8));
+  std::vector<std::vector<IntStorage *>> results;
+  getOrCreateConcurrently(uniquer, threadPool, /*numTasks=*/8,
+                          /*numKeys=*/10000, results);
+  const std::vector<IntStorage *> &expected = results.front();
+  for (int key = 0; key != 10000; ++key)
+    EXPECT_EQ(std::get<0>(expected[key]->key), key);
+  for (const std::vector<IntStorage *> &result : results)
+    EXPECT_EQ(result, expected);
+}
+
+/// Measure the get-or-create throughput of the uniquer from 1 to 64 threads.
+/// This is a benchmark rather than a test, run it with
+/// `--gtest_also_run_disabled_tests`.
+TEST(StorageUniquerTest, DISABLED_GetOrCreateThroughput) {
+  constexpr int numKeys = 100000;
+  for (unsigned numThreads = 1; numThreads <= 64; numThreads *= 2) {
+    StorageUniquer uniquer;
+    uniquer.registerParametricStorageType<IntStorage>();
+    llvm::ThreadPool threadPool(llvm::hardware_concurrency(numThreads));
+
+    std::vector<std::vector<IntStorage *>> results;
+    auto start = std::chrono::steady_clock::now();
+    getOrCreateConcurrently(uniquer, threadPool, numThreads, numKeys, results);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    double opsPerSecond = double(numThreads) * numKeys / elapsed.count();
+    llvm::outs() << llvm::format("%2u threads: %12.0f get-or-create/s\n",
+                                 numThreads, opsPerSecond);
+  }
+}
@@ -8,7 +8,7 @@ import time
 import numpy as np
 
 from discovery import discover_benchmark_modules, get_benchmark_functions
-from stats import has_enough_measurements
+from stats import get_bandwidths_gbps, get_roofline_report, has_enough_measurements
 
 
 def main(top_level_path, stop_on_error):
@@ -25,6 +25,7 @@ def main(top_level_path, stop_on_error):
 
     modules = [module for module in discover_benchmark_modules(top_level_path)]
     benchmark_dicts = []
+    roofline_entries = []
     for module in modules:
         benchmark_functions = [
             function
@@ -96,12 +97,34 @@ def main(top_level_path, stop_on_error):
                 benchmark_identifier = ":".join(
                     [module.__name__, benchmark_function.__name__]
                 )
-                benchmark_dicts.append(
-                    {
-                        "name": benchmark_identifier,
-                        "compile_time": total_compile_time_s,
-                        "execution_time": list(measurements_s),
-                    }
-                )
+                benchmark_dict = {
+                    "name": benchmark_identifier,
+                    "compile_time": total_compile_time_s,
+                    "execution_time": list(measurements_s),
+                }
+                # Runners that know how much memory traffic a measurement
+                # incurs also get the achieved bandwidth reported as score.
+                bytes_moved = getattr(runner, "bytes_moved", None)
+                if bytes_moved is not None:
+                    bandwidths_gbps = get_bandwidths_gbps(bytes_moved, measurements_s)
+                    benchmark_dict["score"] = bandwidths_gbps
+                    roofline_group = getattr(runner, "roofline_group", None)
+                    if roofline_group is not None:
+                        roofline_entries.append(
+                            {
+                                "name": benchmark_identifier,
+                                "group": roofline_group,
+                                "baseline": getattr(runner, "roofline_baseline", False),
+                                "bandwidths_gbps": bandwidths_gbps,
+                            }
+                        )
+                # Runners that record the peak memory of the process get it
+                # reported too, to catch the memory regressions.
+                peak_memory_bytes = getattr(runner, "peak_memory_bytes", None)
+                if peak_memory_bytes is not None:
+                    benchmark_dict["mem_bytes"] = peak_memory_bytes
+                benchmark_dicts.append(benchmark_dict)
 
+    if roofline_entries:
+        print(get_roofline_report(roofline_entries), file=sys.stderr)
     return benchmark_dicts
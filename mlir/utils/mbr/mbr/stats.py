@@ -35,3 +35,36 @@ def has_enough_measurements(measurements):
         np.sum(measurements) >= stats_dict["max_time_for_a_benchmark_ns"]
         or np.size(measurements) >= stats_dict["max_number_of_measurements"]
     )
+
+
+def get_bandwidths_gbps(bytes_moved, measurements_s):
+    """Takes the number of bytes moved by each measurement and the list of
+    measurements in seconds, and returns the list of achieved bandwidths in
+    gigabytes per second.
+    """
+    return [bytes_moved / t * 1e-9 if t > 0 else 0.0 for t in measurements_s]
+
+
+def get_roofline_report(roofline_entries):
+    """Takes a list of dicts, each with the "name" of a benchmark, the "group"
+    it belongs to, whether it is the "baseline" of that group, and its
+    "bandwidths_gbps". Returns a table of the median bandwidth of each
+    benchmark, and of that bandwidth as a percentage of the median bandwidth
+    of the baseline of its group, e.g. a STREAM benchmark.
+    """
+    baselines = {
+        entry["group"]: np.median(entry["bandwidths_gbps"])
+        for entry in roofline_entries
+        if entry["baseline"]
+    }
+    name_width = max(len(entry["name"]) for entry in roofline_entries)
+    lines = [f"{'benchmark':<{name_width}}  {'GB/s':>10}  {'% baseline':>10}"]
+    for entry in roofline_entries:
+        bandwidth = np.median(entry["bandwidths_gbps"])
+        baseline = baselines.get(entry["group"])
+        if baseline:
+            relative = f"{100 * bandwidth / baseline:10.1f}"
+        else:
+            relative = f"{'n/a':>10}"
+        lines.append(f"{entry['name']:<{name_width}}  {bandwidth:10.2f}  {relative}")
+    return "\n".join(lines)